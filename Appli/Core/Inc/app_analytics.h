@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    app_analytics.h
+ * @author  Long Liangmao
+ * @brief   People counting and dwell analytics for STM32N6570-DK (ANALYTICS_ENABLE)
+ *          Counting lines, zones and time in view of the tracker's tracks,
+ *          sent as one compact summary per ANALYTICS_PERIOD_MS
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ANALYTICS_H
+#define APP_ANALYTICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Summary record payload (TELEMETRY_TYPE_ANALYTICS): the counts of one
+ * interval. Times in tenths of a second, counts saturated. Little endian,
+ * no padding */
+#define ANALYTICS_LINES_MAX 4U
+#define ANALYTICS_ZONES_MAX 3U
+
+typedef struct __attribute__((packed)) {
+  uint16_t entries;       /* Tracks that came in */
+  uint16_t occupancy_ds;  /* Track time inside, summed over the tracks */
+  uint16_t dwell_mean_ds; /* Of the visits that ended, 0: none did */
+} analytics_zone_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t interval;      /* Summaries since boot, this one included */
+  uint16_t period_ms;     /* Time it covers */
+  uint8_t nb_lines;
+  uint8_t nb_zones;
+  uint16_t new_tracks;    /* Tracks that appeared */
+  uint16_t left_tracks;   /* Tracks that were lost */
+  uint16_t dwell_mean_ds; /* Time in view of the lost tracks, 0: none was */
+  uint16_t dwell_max_ds;
+  uint8_t present;        /* Tracks in view at the end */
+  uint8_t peak;           /* Most tracks in view at once */
+  uint16_t update_max_ns; /* Longest per-frame update */
+  uint16_t line_in[ANALYTICS_LINES_MAX];
+  uint16_t line_out[ANALYTICS_LINES_MAX];
+  analytics_zone_t zones[ANALYTICS_ZONES_MAX];
+} analytics_record_t;
+
+#if ANALYTICS_ENABLE
+
+/**
+ * @brief  Create the analytics lock, set up the lines and zones and start
+ *         the first interval
+ * @note   Called from NN_Init(), after Tracker_Init()
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Analytics_Init(void);
+
+/**
+ * @brief  Follow the confirmed tracks through one tracker update
+ * @param  frame_cycles: DWT vsync stamp of the frame the tracker was updated on
+ * @note   Post-processing thread, after Tracker_Update(); bounded by
+ *         ANALYTICS_MAX_TRACKS tracks times the lines and zones
+ */
+void Analytics_Update(uint32_t frame_cycles);
+
+/**
+ * @brief  Send the summary once ANALYTICS_PERIOD_MS is over and start the
+ *         next interval
+ * @note   One thread (UI)
+ */
+void Analytics_Poll(void);
+
+#endif /* ANALYTICS_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ANALYTICS_H */
@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ * @file    app_arena.h
+ * @author  Long Liangmao
+ * @brief   Per-frame scratch arena for STM32N6570-DK
+ *          Bump allocation over one buffer, dropped whole at each frame
+ *          boundary. Stages run one after the other and give their scratch
+ *          back on exit, so the buffer is sized by the largest stage, not
+ *          the sum of them
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ARENA_H
+#define APP_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Every allocation starts on this boundary: any scalar, float or double */
+#define ARENA_ALIGN 8U
+
+/* Bytes n objects take in an arena, for sizing it at build time */
+#define ARENA_SIZE_OF(type, n) ((sizeof(type) * (n) + ARENA_ALIGN - 1U) & ~(ARENA_ALIGN - 1U))
+
+/* n objects of a type, uninitialized; fail-fast when the arena is full */
+#define ARENA_ALLOC(arena, type, n) ((type *)Arena_Alloc((arena), (uint32_t)(sizeof(type) * (n))))
+
+/**
+ * @brief  Arena over a caller buffer, owned by one thread
+ */
+typedef struct {
+  uint8_t *base;
+  uint32_t size;
+  uint32_t used;
+  uint32_t high; /* Highest used in the open stage */
+  uint32_t peak; /* Highest used since Arena_Init() */
+} arena_t;
+
+/**
+ * @brief  Scratch high-water mark of one stage
+ */
+typedef struct {
+  uint32_t mark; /* Arena used when the stage opened */
+  uint32_t peak; /* Most bytes the stage held at once, since boot */
+} arena_stage_t;
+
+/**
+ * @brief  Set an arena up over a buffer
+ * @param  base: ARENA_ALIGN aligned
+ */
+void Arena_Init(arena_t *arena, void *base, uint32_t size);
+
+/**
+ * @brief  Take size bytes, rounded up to ARENA_ALIGN
+ * @retval Uninitialized block, valid until its stage ends or the arena
+ *         is reset
+ * @note   Fail-fast: panics when the arena is full, sized at build time
+ */
+void *Arena_Alloc(arena_t *arena, uint32_t size);
+
+/**
+ * @brief  Drop every allocation: the frame boundary
+ */
+static inline void Arena_Reset(arena_t *arena) {
+  arena->used = 0;
+  arena->high = 0;
+}
+
+/**
+ * @brief  Open a stage: what it allocates goes back at Arena_EndStage()
+ * @note   Stages do not nest
+ */
+void Arena_BeginStage(arena_t *arena, arena_stage_t *stage);
+
+/**
+ * @brief  Close a stage, update its high-water mark and free its scratch
+ */
+void Arena_EndStage(arena_t *arena, arena_stage_t *stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ARENA_H */
@@ -0,0 +1,100 @@
+/**
+ ******************************************************************************
+ * @file    app_assets.h
+ * @author  Long Liangmao
+ * @brief   OctoFlash asset pack for STM32N6570-DK
+ *          LZ4-compressed glyph and image sets, read in place and
+ *          decompressed into RAM at first use
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ASSETS_H
+#define APP_ASSETS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Pack at ASSET_PACK_FLASH_ADDR, built by assets.ps1, little endian: a pack
+ * header, nb entries, then the LZ4 blocks (raw block format, no frame).
+ * Each entry holds the FNV-1a of its decompressed bytes */
+#define ASSET_PACK_MAGIC 0x4B505341U /* "ASPK" */
+
+typedef enum {
+  ASSET_TYPE_FONT = 1, /* UTIL_LCD 1-bpp table: count glyphs from ' ', rows of (width + 7) / 8 bytes */
+  ASSET_TYPE_A8 = 2,   /* count images of width x height 8-bit alpha */
+} asset_type_t;
+
+/* Entry ids, as assets.ps1 numbers them; images from ASSET_ID_IMAGE_FIRST */
+#define ASSET_ID_FONT16 1U
+#define ASSET_ID_FONT12 2U
+#define ASSET_ID_IMAGE_FIRST 0x100U
+
+typedef struct {
+  uint16_t id;     /* ASSET_ID_ */
+  uint8_t type;    /* asset_type_t */
+  uint8_t count;   /* Glyphs or images */
+  uint16_t width;  /* Pixels */
+  uint16_t height;
+  uint32_t offset; /* LZ4 block, bytes from the pack start */
+  uint32_t packed; /* Bytes of the LZ4 block */
+  uint32_t size;   /* Bytes once decompressed */
+  uint32_t check;  /* FNV-1a of the decompressed bytes */
+} asset_entry_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t nb;
+} asset_pack_t;
+
+#if ASSET_PACK_ENABLE
+
+/**
+ * @brief  Check the pack header and entry table, create the flash lock
+ * @note   Called from App_Init(), before the flash lock is used. Fail-fast: the pack must be flashed
+ *         (flash.ps1 $AssetPack) and fit ASSET_PACK_SIZE
+ */
+void Assets_Init(void);
+
+/**
+ * @brief  Entry of an asset
+ * @retval NULL when the pack has none with that id and type
+ */
+const asset_entry_t *Assets_Find(uint32_t id, asset_type_t type);
+
+/**
+ * @brief  Decompress an asset
+ * @param  dst: entry->size bytes, not overlapping the pack
+ * @note   Holds the flash lock while reading the octoFlash. Fail-fast: the
+ *         block must decode to entry->size bytes matching entry->check
+ */
+void Assets_Load(const asset_entry_t *entry, uint8_t *dst);
+
+/**
+ * @brief  Hold the octoFlash mapping: pack reads, and writers taking the
+ *         octoFlash out of memory-mapped mode, exclude each other
+ * @note   Thread context, after Assets_Init()
+ */
+void Assets_LockFlash(void);
+void Assets_UnlockFlash(void);
+
+#endif /* ASSET_PACK_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ASSETS_H */
@@ -0,0 +1,82 @@
+/**
+ ******************************************************************************
+ * @file    app_background.h
+ * @author  Long Liangmao
+ * @brief   Background jobs for STM32N6570-DK (BACKGROUND_ENABLE)
+ *          Deferrable work in cooperative slices, run just above idle and
+ *          only in the slack predicted before the next inference window
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_BACKGROUND_H
+#define APP_BACKGROUND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Jobs registered at once */
+#define BACKGROUND_MAX_JOBS 4
+
+/**
+ * @brief  One slice of a job: at most BACKGROUND_SLICE_US of CPU time
+ * @retval 1 while the pass goes on, 0 once it is done: the job is due again
+ *         a period later
+ */
+typedef int (*background_step_t)(void);
+
+/**
+ * @brief  Executor counters since boot
+ */
+typedef struct {
+  uint32_t slices;       /* Job slices run */
+  uint32_t deferred;     /* Slices held back: the next inference window too close */
+  uint32_t overruns;     /* Slices that ran into the predicted window */
+  uint32_t max_slice_us; /* Longest slice */
+  uint32_t passes;       /* Job passes completed */
+} background_stats_t;
+
+#if BACKGROUND_ENABLE
+
+/**
+ * @brief  Add a job
+ * @param  name: Job name (kept)
+ * @param  step: Slice function, called from the background thread only
+ * @param  period_ms: From the end of a pass to the start of the next
+ * @note   Before Thread_Background_Init(); fail-fast beyond
+ *         BACKGROUND_MAX_JOBS
+ */
+void Background_Register(const char *name, background_step_t step, uint32_t period_ms);
+
+/**
+ * @brief  Start the background thread; the jobs are first due at once
+ * @param  memory_ptr: Unused (static allocation)
+ */
+void Thread_Background_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Copy the executor counters
+ */
+void Background_GetStats(background_stats_t *stats);
+
+#endif /* BACKGROUND_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_BACKGROUND_H */
@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file    app_boottime.h
+ * @author  Long Liangmao
+ * @brief   Boot time profile for STM32N6570-DK
+ *          Phases from FSBL entry to the first frame on screen and the first
+ *          inference, continued from the record the FSBL hands over
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_BOOTTIME_H
+#define APP_BOOTTIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "boot_timeline.h"
+#include <stdint.h>
+
+/* Mark the end of a boot phase (boot_phase_t), compiled out without BOOT_PROFILER */
+#if BOOT_PROFILER
+#define BOOT_MARK(phase) BootTimeline_Mark(phase)
+#define BOOT_MARK_FIRST(phase) BootTime_MarkFirst(phase)
+#else
+#define BOOT_MARK(phase)
+#define BOOT_MARK_FIRST(phase)
+#endif
+
+/**
+ * @brief  Continue the FSBL record, or start one at application entry
+ * @note   First call of main(), before the clocks are configured. A record
+ *         is only continued when the FSBL handed it over on this boot; a
+ *         debugger load or a reset into the application starts at zero
+ */
+void BootTime_AppEntry(void);
+
+/**
+ * @brief  Mark a phase the first time it ends
+ * @param  phase: BOOT_PHASE_FIRST_FRAME or BOOT_PHASE_FIRST_INFERENCE
+ * @note   Callable from threads and interrupts; later calls are ignored
+ */
+void BootTime_MarkFirst(boot_phase_t phase);
+
+/**
+ * @brief  Once the first frame and the first inference are marked, print the
+ *         phase breakdown (BOOT_PROFILER_UART); nothing after the first time
+ * @note   Call periodically from a single thread (UI stats period)
+ */
+void BootTime_Update(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_BOOTTIME_H */
@@ -27,101 +27,441 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
+/* Memory banks application buffers are placed in (STM32N657XX_LRUN.ld) */
+typedef enum {
+  BUFFER_BANK_PSRAM = 0, /* xSPI1 PSRAM, see PSRAM_MPU_MODE */
+  BUFFER_BANK_AXISRAM6,  /* Free tail of AXISRAM6 after the NPU activations, cacheable */
+} buffer_bank_t;
+
+/* PSRAM_STREAM: the leading PSRAM sections, always mapped non-cacheable */
+#define BUFFER_BANK_PSRAM_STREAM BUFFER_BANK_PSRAM
+
+#define BUFFER_CACHEABLE_PSRAM_STREAM 0
+#define BUFFER_CACHEABLE_PSRAM (PSRAM_MPU_MODE == PSRAM_MPU_STREAMS_UNCACHED)
+#define BUFFER_CACHEABLE_AXISRAM6 1
+
+/* Hardware or thread producing the buffer contents */
+typedef enum {
+  BUFFER_OWNER_PIPE0 = 0, /* DCMIPP dump pipe (auxiliary stream) */
+  BUFFER_OWNER_PIPE1,     /* DCMIPP display pipe */
+  BUFFER_OWNER_PIPE2,     /* DCMIPP ML pipe */
+  BUFFER_OWNER_UI,        /* UI thread (UTIL_LCD + DMA2D overlay) */
+  BUFFER_OWNER_NN,        /* Inference thread (output copies) */
+  BUFFER_OWNER_ENCODER,   /* Video encoder (bitstream, reference frames) */
+  BUFFER_OWNER_SNAPSHOT,  /* JPEG snapshot thread and codec */
+  BUFFER_OWNER_SDLOG,     /* microSD log thread (telemetry segments) */
+} buffer_owner_t;
+
+typedef enum {
+  BUFFER_FORMAT_RAW = 0,
+  BUFFER_FORMAT_RGB565,
+  BUFFER_FORMAT_RGB888,
+  BUFFER_FORMAT_ARGB8888,
+  BUFFER_FORMAT_ARGB4444,
+  BUFFER_FORMAT_Y8,
+  BUFFER_FORMAT_YUV422,
+} buffer_format_t;
+
+#if UI_LAYER_ARGB4444
+#define BUFFER_UI_FORMAT ARGB4444
+#else
+#define BUFFER_UI_FORMAT ARGB8888
+#endif
+
+#if ML_GRAYSCALE
+#define BUFFER_ML_FORMAT Y8
+#elif ML_YUV422
+#define BUFFER_ML_FORMAT YUV422
+#else
+#define BUFFER_ML_FORMAT RGB888
+#endif
+
+#if NN_OUTPUT_INT8
+#define BUFFER_NN_BANK AXISRAM6
+#define BUFFER_NN_SECTION IN_AXISRAM6
+#else
+#define BUFFER_NN_BANK PSRAM
+#define BUFFER_NN_SECTION IN_PSRAM_NN
+#endif
+
+/* Bytes per slot: rounded up to a whole number of 32-byte cache lines so every
+ * slot starts on a line and maintenance never spills into a neighbour */
+#define BUFFER_SLOT_SIZE(pitch, height) ((((pitch) * (height)) + 31U) & ~31U)
+
+/* Line alignment per producer: the ML pipe may pad its lines
+ * (ML_PITCH_ALIGN), the others write them packed. The owner tokens are
+ * expanded by the table macros before they are pasted, so none may be a
+ * device macro (VENC is: the encoder owner is ENCODER) */
+#define BUFFER_PITCH_ALIGN_PIPE0 1U
+#define BUFFER_PITCH_ALIGN_PIPE1 1U
+#define BUFFER_PITCH_ALIGN_PIPE2 ML_PITCH_ALIGN
+#define BUFFER_PITCH_ALIGN_UI 1U
+#define BUFFER_PITCH_ALIGN_NN 1U
+#define BUFFER_PITCH_ALIGN_ENCODER 1U
+#define BUFFER_PITCH_ALIGN_SNAPSHOT 1U
+#define BUFFER_PITCH_ALIGN_SDLOG 1U
+
+/* Bytes per line of a table entry */
+#define BUFFER_PITCH(width, bpp, owner) \
+  ((((width) * (bpp)) + BUFFER_PITCH_ALIGN_##owner - 1U) & ~(BUFFER_PITCH_ALIGN_##owner - 1U))
+
+/* Pipe2 frame line: ML_WIDTH * ML_BPP unless ML_PITCH_ALIGN pads it */
+#define ML_PITCH BUFFER_PITCH(ML_WIDTH, ML_BPP, PIPE2)
+#define ML_PITCH_PADDED (ML_PITCH != ML_WIDTH * ML_BPP)
+
+/* Cascade crops (CPU-scaled, NPU-read) and second-stage outputs per output slot;
+ * both in PSRAM, too large for what the activations leave of AXISRAM6 */
+#if CASCADE_ENABLE
+#define BUFFER_TABLE_CASCADE(X)                                                             \
+  X(CASCADE_ROI, cascade_roi_buffers, CASCADE_TOP_K,                                        \
+    ML_WIDTH, ML_HEIGHT, ML_BPP,                                                            \
+    BUFFER_ML_FORMAT, PSRAM, IN_PSRAM_NN, NN)                                               \
+  X(CASCADE_OUTPUT, cascade_output_buffers, NN_OUTPUT_BUFFER_NB * CASCADE_TOP_K,            \
+    NN_OUTPUT_SIZE, 1, 1,                                                                   \
+    RAW, PSRAM, IN_PSRAM_NN, NN)
+#else
+#define BUFFER_TABLE_CASCADE(X)
+#endif
+
+/* Auxiliary stream: non-cacheable like the other DCMIPP rings, the CPU only
+ * samples it */
+#if AUX_STREAM_ENABLE
+#define BUFFER_TABLE_AUX(X)                                                                 \
+  X(AUX_STREAM, aux_stream_buffers, 2,                                                      \
+    AUX_WIDTH, AUX_HEIGHT, AUX_BPP,                                                         \
+    RAW, PSRAM_STREAM, IN_PSRAM_ML, PIPE0)
+#else
+#define BUFFER_TABLE_AUX(X)
+#endif
+
+/* Video encoder: the bitstream ring, the pool the encoder library takes its
+ * reference frames and tables from and, with VENC_OVERLAY, the frames the
+ * DMA2D composes. Non-cacheable: the VENC and DMA2D write them, the CPU
+ * only reads back access units and encoder tables */
+#if VENC_ENABLE && VENC_OVERLAY
+#define BUFFER_TABLE_VENC_INPUT(X)                                                          \
+  X(VENC_INPUT, venc_input_buffer, VENC_PIPELINE_DEPTH,                                     \
+    DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT, DISPLAY_BPP,                         \
+    RGB565, PSRAM_STREAM, IN_PSRAM_DISPLAY, ENCODER)
+#else
+#define BUFFER_TABLE_VENC_INPUT(X)
+#endif
+#if VENC_ENABLE
+#define BUFFER_TABLE_VENC(X)                                                                \
+  X(VENC_STREAM, venc_stream_buffer, 1,                                                     \
+    VENC_STREAM_SIZE, 1, 1,                                                                 \
+    RAW, PSRAM_STREAM, IN_PSRAM_DISPLAY, ENCODER)                                           \
+  X(VENC_EWL, venc_ewl_pool, 1,                                                             \
+    VENC_EWL_POOL_SIZE, 1, 1,                                                               \
+    RAW, PSRAM_STREAM, IN_PSRAM_DISPLAY, ENCODER)                                           \
+  BUFFER_TABLE_VENC_INPUT(X)
+#else
+#define BUFFER_TABLE_VENC(X)
+#endif
+
+/* JPEG snapshots: the MCU strips the CPU converts and the input DMA reads
+ * (double-buffered), the images the output DMA writes and, with
+ * SCREENSHOT_ENABLE, the screen the DMA2D composes. Non-cacheable: the CPU
+ * writes the strips once and only reads back finished images and screens */
+#if SNAPSHOT_ENABLE
+/* One row of 16x16 MCUs across the widest crop: 4 Y, 1 Cb and 1 Cr blocks of 64 bytes each */
+#define SNAPSHOT_MCU_SIZE 384U
+#if SCREENSHOT_ENABLE
+#define SNAPSHOT_MAX_WIDTH LCD_WIDTH
+#define BUFFER_TABLE_SCREENSHOT(X)                                                          \
+  X(SCREENSHOT, screenshot_buffers, 1,                                                      \
+    LCD_WIDTH, LCD_HEIGHT, DISPLAY_BPP,                                                     \
+    RGB565, PSRAM_STREAM, IN_PSRAM_DISPLAY, SNAPSHOT)
+#else
+#define SNAPSHOT_MAX_WIDTH DISPLAY_LETTERBOX_WIDTH
+#define BUFFER_TABLE_SCREENSHOT(X)
+#endif
+#define SNAPSHOT_STRIP_SIZE ((SNAPSHOT_MAX_WIDTH / 16U) * SNAPSHOT_MCU_SIZE)
+#define BUFFER_TABLE_SNAPSHOT(X)                                                            \
+  X(SNAPSHOT_MCU, snapshot_mcu_buffers, 2,                                                  \
+    SNAPSHOT_STRIP_SIZE, 1, 1,                                                              \
+    RAW, PSRAM_STREAM, IN_PSRAM_DISPLAY, SNAPSHOT)                                          \
+  X(SNAPSHOT_STORE, snapshot_store_buffers, SNAPSHOT_SLOTS,                                 \
+    SNAPSHOT_MAX_SIZE, 1, 1,                                                                \
+    RAW, PSRAM_STREAM, IN_PSRAM_DISPLAY, SNAPSHOT)                                          \
+  BUFFER_TABLE_SCREENSHOT(X)
+#else
+#define BUFFER_TABLE_SNAPSHOT(X)
+#endif
+
+/* microSD log: the two segments filled and written in turn. Non-cacheable:
+ * the CPU only writes them, the SDMMC IDMA reads them */
+#if SD_LOG
+#define BUFFER_TABLE_SDLOG(X)                                                               \
+  X(SDLOG_SEGMENT, sdlog_segment_buffers, 2,                                                \
+    SD_LOG_SEGMENT_SIZE, 1, 1,                                                              \
+    RAW, PSRAM_STREAM, IN_PSRAM_DISPLAY, SDLOG)
+#else
+#define BUFFER_TABLE_SDLOG(X)
+#endif
+
+/* Camera display ring: not allocated when LTDC scans the Pipe2 ring out */
+#if DISPLAY_SINGLE_PIPE
+#define BUFFER_TABLE_DISPLAY(X)
+#else
+#define BUFFER_TABLE_DISPLAY(X)                                                             \
+  X(CAMERA_DISPLAY, camera_display_buffers, DISPLAY_BUFFER_NB,                              \
+    DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT, DISPLAY_BPP,                         \
+    RGB565, PSRAM_STREAM, IN_PSRAM_DISPLAY, PIPE1)
+#endif
+
+/* Pipe2 ring: with ML_INPUT_ALIAS the slots keep their tags and states but
+ * all share the network input tensor (Buffer_MLCapture_SetAlias()) */
+#if ML_INPUT_ALIAS
+#define BUFFER_TABLE_ML(X)
+#else
+#define BUFFER_TABLE_ML(X)                                                                  \
+  X(ML_CAPTURE, ml_capture_buffers, ML_CAPTURE_BUFFER_NB,                                   \
+    ML_WIDTH, ML_HEIGHT, ML_BPP,                                                            \
+    BUFFER_ML_FORMAT, PSRAM_STREAM, IN_PSRAM_ML, PIPE2)
+#endif
+
+/* Buffer table: the arrays, their descriptors and the build-time checks are
+ * all generated from this list.
+ * X(id, array, slots, width, height, bpp, format, bank, section, owner) */
+#define BUFFER_TABLE(X)                                                                     \
+  BUFFER_TABLE_DISPLAY(X)                                                                   \
+  X(UI_DISPLAY, ui_display_buffers, UI_BUFFER_NB,                                           \
+    UI_LAYER_WIDTH, UI_LAYER_HEIGHT, UI_BPP,                                                \
+    BUFFER_UI_FORMAT, PSRAM, IN_PSRAM_UI, UI)                                               \
+  BUFFER_TABLE_ML(X)                                                                        \
+  X(NN_OUTPUT, nn_output_buffers, NN_OUTPUT_BUFFER_NB,                                      \
+    NN_OUTPUT_SIZE, 1, 1,                                                                   \
+    RAW, BUFFER_NN_BANK, BUFFER_NN_SECTION, NN)                                             \
+  BUFFER_TABLE_AUX(X)                                                                       \
+  BUFFER_TABLE_CASCADE(X)                                                                   \
+  BUFFER_TABLE_VENC(X)                                                                      \
+  BUFFER_TABLE_SNAPSHOT(X)                                                                  \
+  BUFFER_TABLE_SDLOG(X)
+
+typedef enum {
+#define BUFFER_ENUM(id, ...) BUFFER_ID_##id,
+  BUFFER_TABLE(BUFFER_ENUM)
+#undef BUFFER_ENUM
+  BUFFER_ID_NB,
+} buffer_id_t;
+
+/**
+ * @brief  Buffer descriptor: one per table entry, slots are contiguous
+ */
+typedef struct {
+  const char *name;
+  uint8_t *base;      /* Slot 0 */
+  uint32_t slot_size; /* Bytes per slot (cache-line multiple) */
+  uint32_t pitch;     /* Bytes per line, padding included */
+  uint32_t width;     /* Pixels per line (bytes for RAW) */
+  uint32_t height;
+  uint8_t slot_nb;
+  uint8_t bpp;        /* Bytes per pixel (1 for RAW) */
+  uint8_t format;     /* buffer_format_t */
+  uint8_t bank;       /* buffer_bank_t */
+  uint8_t owner;      /* buffer_owner_t */
+  uint8_t cacheable;  /* 0 when the bank is mapped non-cacheable: maintenance is skipped */
+} buffer_desc_t;
+
+#define BUFFER_EXTERN(id, array, slots, width, height, bpp, format, bank, section, owner) \
+  extern uint8_t array[slots][BUFFER_SLOT_SIZE(BUFFER_PITCH(width, bpp, owner), height)];
+BUFFER_TABLE(BUFFER_EXTERN)
+#undef BUFFER_EXTERN
+
+extern const buffer_desc_t buffer_registry[BUFFER_ID_NB];
+
 extern volatile int camera_display_idx;
 extern volatile int camera_capture_idx;
 extern volatile int ui_display_idx;
-extern uint8_t camera_display_buffers[DISPLAY_BUFFER_NB][DISPLAY_LETTERBOX_WIDTH * DISPLAY_LETTERBOX_HEIGHT * DISPLAY_BPP];
-extern uint8_t ui_display_buffers[2][LCD_WIDTH * LCD_HEIGHT * 4];
+extern volatile int ml_capture_idx;
 
 /**
- * @brief  Get current display buffer index
- * @retval Current display buffer index
+ * @brief  Get the descriptor of a buffer
+ * @param  id: Buffer identifier
+ * @retval Descriptor
  */
-#define Buffer_GetCameraDisplayIndex() (camera_display_idx)
+#define Buffer_GetDesc(id) (&buffer_registry[(id)])
 
 /**
- * @brief  Get current capture buffer index
- * @retval Current capture buffer index
+ * @brief  Get pointer to a slot of a buffer
+ * @param  id: Buffer identifier
+ * @param  idx: Slot index
+ * @retval Pointer to the slot, NULL if index is invalid
  */
-#define Buffer_GetCameraCaptureIndex() (camera_capture_idx)
+static inline uint8_t *Buffer_GetSlot(buffer_id_t id, int idx) {
+  const buffer_desc_t *desc = &buffer_registry[id];
+  return ((unsigned)idx >= desc->slot_nb) ? NULL : desc->base + (uint32_t)idx * desc->slot_size;
+}
 
 /**
- * @brief  Get next display buffer index (wraps around)
- * @retval Next display buffer index
+ * @brief  Capture tag shared by the Pipe1 and Pipe2 slots of one sensor frame
  */
-#define Buffer_GetNextCameraDisplayIndex() \
-  (((camera_display_idx) + 1) % DISPLAY_BUFFER_NB)
+typedef struct {
+  uint32_t frame_id;     /* Sensor frame sequence number, counted at Pipe1 vsync */
+  uint32_t vsync_cycles; /* DWT cycle stamp of that vsync */
+} buffer_frame_tag_t;
 
 /**
- * @brief  Get next capture buffer index (wraps around)
- * @retval Next capture buffer index
+ * @brief  Readers outside the camera display ring, one lent slot each
  */
-#define Buffer_GetNextCameraCaptureIndex() \
-  (((camera_capture_idx) + 1) % DISPLAY_BUFFER_NB)
+typedef enum {
+  BUFFER_LENDER_THUMBS = 0, /* Thumbnail panel's DMA2D crops */
+  BUFFER_LENDER_VENC,       /* Video encoder input or its DMA2D composition */
+  BUFFER_LENDER_SNAPSHOT,   /* JPEG snapshot MCU conversion */
+  BUFFER_LENDER_PREVIEW,    /* Telemetry preview thumbnail */
+  BUFFER_LENDER_NB,
+} buffer_lender_t;
 
+/**
+ * @brief  Camera display ring statistics (Pipe1 -> LTDC)
+ */
+typedef struct {
+  uint32_t front_frame_id;     /* Sensor frame currently scanned out (latched by LTDC) */
+  uint32_t front_vsync_cycles; /* DWT stamp of that frame's capture vsync */
+  uint32_t latest_frame_id;    /* Newest complete sensor frame */
+  uint32_t age_us;             /* Capture vsync to the vblank that latched it */
+  uint32_t dropped;            /* Complete frames that were never shown */
+  uint32_t repeated;           /* Frame events that kept the previous frame on screen */
+  uint32_t unpaired;           /* DISPLAY_POLICY_ALIGNED: frames the full ring showed without their boxes */
+} buffer_display_stats_t;
+
+/**
+ * @brief  ML capture ring statistics (Pipe2 -> inference)
+ */
+typedef struct {
+  uint32_t consumed; /* Complete frames taken by inference */
+  uint32_t skipped;  /* Complete frames overwritten before inference took them */
+} buffer_ml_stats_t;
+
+/**
+ * @brief  Get the slot currently scanned out by LTDC
+ * @retval Display buffer index (ML capture index with DISPLAY_SINGLE_PIPE),
+ *         -1 before the first frame
+ */
+#define Buffer_GetCameraDisplayIndex() (camera_display_idx)
+
+/**
+ * @brief  Get the slot last handed to DCMIPP Pipe1
+ * @retval Capture buffer index
+ */
+#define Buffer_GetCameraCaptureIndex() (camera_capture_idx)
+
+#if !DISPLAY_SINGLE_PIPE
 /**
  * @brief  Get pointer to a specific camera display buffer
  * @param  idx: Buffer index (0 to DISPLAY_BUFFER_NB-1)
  * @retval Pointer to the buffer, NULL if index is invalid
  */
-#define Buffer_GetCameraDisplayBuffer(idx)                                       \
-  ({                                                                             \
-    int _idx = (idx);                                                            \
-    ((unsigned)_idx >= DISPLAY_BUFFER_NB) ? NULL : camera_display_buffers[_idx]; \
-  })
+#define Buffer_GetCameraDisplayBuffer(idx) Buffer_GetSlot(BUFFER_ID_CAMERA_DISPLAY, (idx))
+#endif
 
 /**
- * @brief  Set camera display buffer index
- * @param  idx: New display buffer index
- * @retval 0 on success, -1 if index is invalid
+ * @brief  Count and timestamp a new sensor frame (ISR context, Pipe1 vsync)
+ * @note   The tag stamps both pipes' slots so a detection result can be
+ *         matched to the display frame it was computed on
  */
-#define Buffer_SetCameraDisplayIndex(idx)                      \
-  ({                                                           \
-    int _idx = (idx);                                          \
-    int _ret = ((unsigned)_idx >= DISPLAY_BUFFER_NB) ? -1 : 0; \
-    if (_ret == 0) {                                           \
-      camera_display_idx = _idx;                               \
-    }                                                          \
-    _ret;                                                      \
-  })
+void Buffer_Camera_FrameStart(void);
 
+#if !DISPLAY_SINGLE_PIPE
 /**
- * @brief  Set camera capture buffer index
- * @param  idx: New capture buffer index
- * @retval 0 on success, -1 if index is invalid
+ * @brief  Mark a camera capture slot complete and apply DISPLAY_POLICY
+ * @param  completed: Slot of the address register the frame was written through
+ * @retval Slot LTDC must show next, -1 to keep the current one on screen
+ * @note   Called from ISR context, before Buffer_CameraDisplay_NextCapture().
+ *         The slot it replaces is only released by Buffer_CameraDisplay_Shown()
+ */
+int Buffer_CameraDisplay_Complete(int completed);
+#endif
+
+/**
+ * @brief  Report the camera buffer a vblank latched: slots replaced before it
+ *         return to the ring, and the front statistics move to it
+ * @param  buffer: Camera display buffer now scanned out, an ML capture slot
+ *         with DISPLAY_SINGLE_PIPE
+ * @note   Called from the LTDC reload ISR, at the DCMIPP frame ISR priority
+ */
+void Buffer_CameraDisplay_Shown(const uint8_t *buffer);
+
+#if !DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Pick the slot for the DCMIPP Pipe1 address register just freed
+ * @retval Capture buffer index, written the frame after the current one
+ * @note   Called from ISR context; drops the oldest waiting frame if the ring is full.
+ *         Also picks the second slot when the pipe starts
+ */
+int Buffer_CameraDisplay_NextCapture(void);
+
+/**
+ * @brief  Lend the slot LTDC scans out to a reader outside the ring
+ * @param  lender: Reader taking it
+ * @param  tag: Capture tag of the lent slot
+ * @retval Slot index, -1 before the first frame (nothing is lent)
+ * @note   One slot per lender at a time; it is not recycled until
+ *         Buffer_CameraDisplay_Return(), even once off screen
+ */
+int Buffer_CameraDisplay_Lend(buffer_lender_t lender, buffer_frame_tag_t *tag);
+
+/**
+ * @brief  Return the slot lent by Buffer_CameraDisplay_Lend() to the ring
+ * @param  lender: Reader giving it back
+ */
+void Buffer_CameraDisplay_Return(buffer_lender_t lender);
+
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+/**
+ * @brief  Pick the frame to show with an overlay drawn from the detections
+ *         of frame_id: the newest waiting frame up to it
+ * @param  frame_id: Frame id of the result the overlay is drawn from
+ * @retval Slot the caller hands to LTDC, -1 to keep the current one
+ * @note   Called with CAM_IRQ_PRIORITY and LCD_IRQ_PRIORITY masked, the slot
+ *         and the overlay staged in the same section: one reload latches both
+ */
+int Buffer_CameraDisplay_Align(uint32_t frame_id);
+
+/**
+ * @brief  Give the held frames to Buffer_CameraDisplay_Align(), or back to
+ *         the Pipe1 frame ISR (DISPLAY_POLICY_SYNC_NN) while no overlay is drawn
+ */
+void Buffer_CameraDisplay_SetAligned(uint8_t aligned);
+#endif
+#endif
+
+/**
+ * @brief  Publish the sensor frame whose detections are now available
+ * @param  frame_id: Frame id from Buffer_MLCapture_GetTag()
+ * @note   Releases held frames up to frame_id under DISPLAY_POLICY_SYNC_NN
+ *         and DISPLAY_POLICY_ALIGNED; an older frame_id than the last one is
+ *         ignored
+ */
+void Buffer_CameraDisplay_SetSyncFrame(uint32_t frame_id);
+
+/**
+ * @brief  Copy the camera display ring statistics
+ * @param  stats: Output statistics
  */
-#define Buffer_SetCameraCaptureIndex(idx)                      \
-  ({                                                           \
-    int _idx = (idx);                                          \
-    int _ret = ((unsigned)_idx >= DISPLAY_BUFFER_NB) ? -1 : 0; \
-    if (_ret == 0) {                                           \
-      camera_capture_idx = _idx;                               \
-    }                                                          \
-    _ret;                                                      \
-  })
+void Buffer_CameraDisplay_GetStats(buffer_display_stats_t *stats);
 
 /**
- * @brief  Get current UI display buffer index
- * @retval Current UI display buffer index (0 or 1)
+ * @brief  Get the UI buffer index latched by the last vblank
+ * @retval Index of the UI buffer on screen
  */
 #define Buffer_GetUIDisplayIndex() (ui_display_idx)
 
 /**
- * @brief  Get next UI display buffer index (for double buffering)
- * @retval Next UI display buffer index (0 or 1)
+ * @brief  Get a UI buffer free for drawing
+ * @retval Index of a buffer neither on screen nor presented after it, -1 if
+ *         all are (double buffering before the last present was latched,
+ *         or an update outrunning the display)
  */
-#define Buffer_GetNextUIDisplayIndex() ((ui_display_idx) ^ 1)
+int Buffer_GetNextUIDisplayIndex(void);
 
 /**
- * @brief  Get pointer to a specific UI display buffer (ARGB8888)
- * @param  idx: Buffer index (0 or 1)
+ * @brief  Get pointer to a specific UI display buffer (UI_LAYER_FORMAT)
+ * @param  idx: Buffer index (0 to UI_BUFFER_NB - 1)
  * @retval Pointer to the UI buffer, NULL if index is invalid
  */
-#define Buffer_GetUIBuffer(idx)                              \
-  ({                                                         \
-    int _idx = (idx);                                        \
-    ((unsigned)_idx >= 2) ? NULL : ui_display_buffers[_idx]; \
-  })
+#define Buffer_GetUIBuffer(idx) Buffer_GetSlot(BUFFER_ID_UI_DISPLAY, (idx))
 
 /**
  * @brief  Get pointer to UI front buffer (currently displayed)
@@ -130,29 +470,207 @@ extern uint8_t ui_display_buffers[2][LCD_WIDTH * LCD_HEIGHT * 4];
 #define Buffer_GetUIFrontBuffer() (ui_display_buffers[ui_display_idx])
 
 /**
- * @brief  Get pointer to UI back buffer (for drawing)
- * @retval Pointer to the back UI buffer
+ * @brief  Present a drawn UI buffer
+ * @param  idx: Buffer from Buffer_GetNextUIDisplayIndex(), staged for LTDC
+ *         right after
+ * @retval 0 on success, -1 if index is invalid
+ * @note   Buffers presented before it are free again once a vblank latched
+ *         it, whether they reached the screen or were replaced while staged
  */
-#define Buffer_GetUIBackBuffer() (ui_display_buffers[ui_display_idx ^ 1])
+int Buffer_SetUIDisplayIndex(int idx);
 
 /**
- * @brief  Set UI display buffer index
- * @param  idx: New display buffer index (0 or 1)
- * @retval 0 on success, -1 if index is invalid
+ * @brief  Get the last presented UI buffer, the newest UI content
+ * @retval UI buffer index, the initial front before any present
+ */
+int Buffer_GetUILastIndex(void);
+
+/**
+ * @brief  Report the UI buffer a vblank latched: the ones presented before
+ *         it are off screen
+ * @param  buffer: UI buffer now scanned out
+ * @note   Called from the LTDC reload ISR
+ */
+void Buffer_UIDisplay_Shown(const uint8_t *buffer);
+
+/**
+ * @brief  Lend the UI buffer on screen to a reader outside the UI thread
+ * @retval UI buffer index
+ * @note   One at a time; Buffer_GetNextUIDisplayIndex() skips it until
+ *         Buffer_UIDisplay_Return(), even once off screen
+ */
+int Buffer_UIDisplay_Lend(void);
+
+/**
+ * @brief  Return the UI buffer lent by Buffer_UIDisplay_Lend()
+ */
+void Buffer_UIDisplay_Return(void);
+
+/**
+ * @brief  Get the slot last handed to DCMIPP Pipe2
+ * @retval ML capture buffer index
  */
-#define Buffer_SetUIDisplayIndex(idx)          \
-  ({                                           \
-    int _idx = (idx);                          \
-    int _ret = ((unsigned)_idx >= 2) ? -1 : 0; \
-    if (_ret == 0) {                           \
-      ui_display_idx = _idx;                   \
-    }                                          \
-    _ret;                                      \
-  })
+#define Buffer_GetMLCaptureIndex() (ml_capture_idx)
+
+/**
+ * @brief  Get pointer to a specific ML capture buffer
+ * @param  idx: Buffer index (0 to ML_CAPTURE_BUFFER_NB-1)
+ * @retval Pointer to the buffer, NULL if index is invalid
+ */
+#if ML_INPUT_ALIAS
+#define Buffer_GetMLCaptureBuffer(idx) Buffer_MLCapture_GetAlias(idx)
+#else
+#define Buffer_GetMLCaptureBuffer(idx) Buffer_GetSlot(BUFFER_ID_ML_CAPTURE, (idx))
+#endif
+
+#if AUX_STREAM_ENABLE
+/**
+ * @brief  Get pointer to an auxiliary stream buffer
+ * @param  idx: Buffer index (0 or 1)
+ * @retval Pointer to the buffer, NULL if index is invalid
+ */
+#define Buffer_GetAuxStreamBuffer(idx) Buffer_GetSlot(BUFFER_ID_AUX_STREAM, (idx))
+#endif
+
+/**
+ * @brief  Get pointer to a specific NN output buffer
+ * @param  idx: Buffer index (0 to NN_OUTPUT_BUFFER_NB-1)
+ * @retval Pointer to the buffer, NULL if index is invalid
+ */
+#define Buffer_GetNNOutputBuffer(idx) Buffer_GetSlot(BUFFER_ID_NN_OUTPUT, (idx))
+
+#if CASCADE_ENABLE
+/**
+ * @brief  Get pointer to a cascade crop buffer
+ * @param  idx: Buffer index (0 to CASCADE_TOP_K-1)
+ * @retval Pointer to the buffer, NULL if index is invalid
+ */
+#define Buffer_GetCascadeROIBuffer(idx) Buffer_GetSlot(BUFFER_ID_CASCADE_ROI, (idx))
+
+/**
+ * @brief  Get pointer to the second-stage outputs of one crop
+ * @param  slot: NN output slot the crop belongs to
+ * @param  roi: Crop index (0 to CASCADE_TOP_K-1)
+ * @retval Pointer to the buffer, NULL if an index is invalid
+ */
+#define Buffer_GetCascadeOutputBuffer(slot, roi) \
+  Buffer_GetSlot(BUFFER_ID_CASCADE_OUTPUT, (int)(slot) * CASCADE_TOP_K + (roi))
+#endif
+
+/**
+ * @brief  Write back one slot from the D-cache (before a DMA master reads it)
+ * @param  id: Buffer identifier
+ * @param  slot: Slot start address
+ * @note   No-op for non-cacheable banks; fail-fast if slot is not a slot of id
+ */
+void Buffer_Clean(buffer_id_t id, const void *slot);
+
+/**
+ * @brief  Drop one slot from the D-cache (after a DMA master wrote it)
+ * @param  id: Buffer identifier
+ * @param  slot: Slot start address
+ * @note   No-op for non-cacheable banks; fail-fast if slot is not a slot of id
+ */
+void Buffer_Invalidate(buffer_id_t id, const void *slot);
+
+/**
+ * @brief  Write back and drop one slot from the D-cache
+ * @param  id: Buffer identifier
+ * @param  slot: Slot start address
+ * @note   No-op for non-cacheable banks; fail-fast if slot is not a slot of id
+ */
+void Buffer_CleanInvalidate(buffer_id_t id, const void *slot);
+
+/**
+ * @brief  Mark an ML capture slot complete, now the latest frame
+ * @param  completed: Slot of the address register the frame was written through
+ * @note   Called from ISR context, before Buffer_MLCapture_NextCapture().
+ *         With DISPLAY_SINGLE_PIPE the slot is also the next preview frame,
+ *         kept from capture until Buffer_CameraDisplay_Shown() retires it
+ */
+void Buffer_MLCapture_Complete(int completed);
+
+/**
+ * @brief  Pick the slot for the DCMIPP Pipe2 address register just freed
+ * @param  capturing: Slot behind the other address register, being written;
+ *         -1 in ML_CAPTURE_SNAPSHOT mode
+ * @retval ML capture buffer index, written the frame after the current one
+ * @note   Called from ISR context; the latest, the NN-held and the
+ *         displayed slots are skipped. Also picks the second slot when the pipe starts
+ */
+int Buffer_MLCapture_NextCapture(int capturing);
+
+/**
+ * @brief  Take ownership of the latest completed ML capture slot
+ * @retval Slot index, -1 if no new frame is available
+ */
+int Buffer_MLCapture_Acquire(void);
+
+#if ML_INPUT_ALIAS
+/**
+ * @brief  Set the frame every ML capture slot is written to
+ * @param  frame: Network input tensor, ML_WIDTH x ML_HEIGHT x ML_BPP
+ * @note   NN_Init(), before the ML pipe starts
+ */
+void Buffer_MLCapture_SetAlias(uint8_t *frame);
+
+/**
+ * @brief  Get the frame an ML capture slot is written to
+ * @retval Network input tensor, NULL if index is invalid or before
+ *         Buffer_MLCapture_SetAlias()
+ */
+uint8_t *Buffer_MLCapture_GetAlias(int idx);
+#endif
+
+/**
+ * @brief  Copy the ML capture ring statistics
+ * @param  stats: Output statistics
+ */
+void Buffer_MLCapture_GetStats(buffer_ml_stats_t *stats);
+
+/**
+ * @brief  Get the capture tag an ML capture slot was stamped with
+ * @param  idx: Slot index returned by Buffer_MLCapture_Acquire()
+ * @retval Tag, frame id comparable with the camera display ring's
+ */
+buffer_frame_tag_t Buffer_MLCapture_GetTag(int idx);
+
+/**
+ * @brief  Return the slot taken by Buffer_MLCapture_Acquire() to the ring
+ */
+void Buffer_MLCapture_Release(void);
+
+/**
+ * @brief  Lend the newest complete ML capture slot to a reader outside the ring
+ * @retval Slot index, -1 before the first frame
+ * @note   Neither DCMIPP nor the NN thread writes the slot until
+ *         Buffer_MLCapture_Return(); the NN thread may still read it
+ */
+int Buffer_MLCapture_Lend(void);
+
+/**
+ * @brief  Return the slot lent by Buffer_MLCapture_Lend() to the ring
+ */
+void Buffer_MLCapture_Return(void);
+
+#if DATASET_ENABLE
+/**
+ * @brief  Keep the slot held by the NN thread out of the ring until
+ *         Buffer_MLCapture_Unkeep(), past Buffer_MLCapture_Release()
+ * @param  idx: Slot returned by Buffer_MLCapture_Acquire(), still held
+ * @note   Neither DCMIPP nor the NN thread writes a kept slot
+ */
+void Buffer_MLCapture_Keep(int idx);
+
+/**
+ * @brief  Give a slot kept by Buffer_MLCapture_Keep() back to the ring
+ */
+void Buffer_MLCapture_Unkeep(int idx);
+#endif
 
 /**
  * @brief  Initialize all buffers and cache
- * @note   Fail-fast: panics on unrecoverable issues (if any are added later)
+ * @note   Fail-fast: panics if two registry entries overlap
  */
 void Buffer_Init(void);
 
@@ -27,12 +27,75 @@ extern "C" {
 #include "tx_api.h"
 #include <stdint.h>
 
+/* DCMIPP pipes with frame counters (DCMIPP_PIPE0 to DCMIPP_PIPE2) */
+#define CAM_PIPE_NB 3U
+
+/**
+ * @brief  Frame counters of one DCMIPP pipe since boot
+ */
+typedef struct {
+  uint32_t frames;     /* Frame events */
+  uint32_t overruns;   /* Frames dropped by DCMIPP on an output overrun */
+  uint32_t limits;     /* Frames cut at the slot size (Pipe0 limit event) */
+  uint32_t late_swaps; /* Frame events that covered two frames: one address refill came late */
+  uint32_t restarts;   /* Stalls recovered by CAM_MLPipe_Restart() / CAM_DisplayPipe_Restart() */
+} cam_pipe_stats_t;
+
+#if NN_TILING != NN_TILING_CENTER
+/**
+ * @brief  Sensor area of one Pipe2 tile or window, normalized to the full
+ *         sensor FOV
+ */
+typedef struct {
+  float x0; /* Left edge */
+  float y0; /* Top edge */
+  float width;
+  float height;
+} cam_ml_tile_t;
+#endif
+
+/* Detection coordinates the display map takes: Q15, 1.0 is the frame edge */
+#define CAM_DISPLAY_MAP_ONE 32768
+#define CAM_DISPLAY_MAP_Q15(v) ((int32_t)((v) * (float)CAM_DISPLAY_MAP_ONE))
+
+/**
+ * @brief  Affine map from detection coordinates (ML frame, or sensor FOV
+ *         with NN_TILING_FULL_FOV and NN_TILING_ROI) to pixels of the camera
+ *         display frame, exact for the Pipe1 and Pipe2 crops and scalers.
+ *         The letterbox starts at DISPLAY_LETTERBOX_X0 on the LCD
+ */
+typedef struct {
+  int32_t scale_x;  /* Display pixels across the detection frame, Q16 */
+  int32_t scale_y;
+  int32_t offset_x; /* Display position of the detection frame origin, Q16 */
+  int32_t offset_y;
+  int32_t x0, y0;   /* Detection frame on the display, clipped to it */
+  int32_t x1, y1;   /* Ends excluded */
+} cam_display_map_t;
+
+/**
+ * @brief  Display pixel column of a detection x coordinate
+ * @param  x: Q15 (CAM_DISPLAY_MAP_Q15())
+ */
+static inline int32_t CAM_DisplayMap_X(const cam_display_map_t *map, int32_t x) {
+  return (int32_t)(((int64_t)x * map->scale_x + (int64_t)map->offset_x * CAM_DISPLAY_MAP_ONE) >> 31);
+}
+
+/**
+ * @brief  Display pixel row of a detection y coordinate
+ * @param  y: Q15 (CAM_DISPLAY_MAP_Q15())
+ */
+static inline int32_t CAM_DisplayMap_Y(const cam_display_map_t *map, int32_t y) {
+  return (int32_t)(((int64_t)y * map->scale_y + (int64_t)map->offset_y * CAM_DISPLAY_MAP_ONE) >> 31);
+}
+
 /**
  * @brief  Initialize the camera module
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void CAM_Init(void);
 
+#if !DISPLAY_SINGLE_PIPE
 /**
  * @brief  Start the display pipe capture
  * @param  cam_mode: Camera mode (CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT)
@@ -41,12 +104,209 @@ void CAM_Init(void);
 void CAM_DisplayPipe_Start(uint32_t cam_mode);
 
 /**
- * @brief  Start the neural network pipe capture
- * @param  ml_pipe_dst: Pointer to the NN buffer
+ * @brief  Stop and restart a stalled display pipe on the slots it holds
+ * @note   Sensor, CSI and ISP setup are kept. Fail-fast: panics when the
+ *         pipe cannot be stopped or started again
+ */
+void CAM_DisplayPipe_Restart(void);
+#endif
+
+/**
+ * @brief  Start the neural network pipe capture in ML_CAPTURE_MODE
+ * @retval None
+ * @note   ML_CAPTURE_SNAPSHOT: the first snapshot is armed right away
+ */
+void CAM_MLPipe_Start(void);
+
+/**
+ * @brief  Stop and restart a stalled neural network pipe
+ * @note   Continuous capture resumes on the slots it holds, a snapshot is
+ *         armed again into a free slot. Sensor, CSI and ISP setup are kept.
+ *         Fail-fast: panics when the pipe cannot be stopped or started again
+ */
+void CAM_MLPipe_Restart(void);
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  Request the next Pipe2 snapshot
+ * @param  deadline_cycles: DWT cycle stamp the frame is wanted by; arming
+ *         waits for the last Pipe1 vsync that still completes by then, an
+ *         unreachable deadline arms at once
+ * @note   Inference thread; ignored while a snapshot is armed
+ */
+void CAM_MLPipe_RequestSnapshot(uint32_t deadline_cycles);
+#endif
+
+#if AUX_STREAM_ENABLE
+/**
+ * @brief  Start the auxiliary motion stream capture (Pipe0)
  * @param  cam_mode: Camera mode (CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT)
  * @retval None
  */
-void CAM_MLPipe_Start(uint8_t *ml_pipe_dst, uint32_t cam_mode);
+void CAM_AuxPipe_Start(uint32_t cam_mode);
+
+/**
+ * @brief  Latest complete auxiliary motion frame
+ * @retval AUX_WIDTH x AUX_HEIGHT samples of AUX_BPP bytes, NULL before the
+ *         first frame or when the probed sensor has no auxiliary stream
+ * @note   Safe to sample for one auxiliary frame period after the call: the
+ *         other slot is being written meanwhile
+ */
+const uint8_t *CAM_AuxPipe_GetFrame(void);
+#endif
+
+#if NN_TILING == NN_TILING_FULL_FOV
+/**
+ * @brief  Number of Pipe2 tiles in a full-FOV sweep
+ */
+uint32_t CAM_MLTile_GetCount(void);
+
+/**
+ * @brief  Sensor area of a tile
+ * @param  tile: Tile index, below CAM_MLTile_GetCount()
+ */
+const cam_ml_tile_t *CAM_MLTile_Get(uint32_t tile);
+
+/**
+ * @brief  Tile an acquired Pipe2 capture slot was taken with
+ * @param  capture_idx: Slot index returned by Buffer_MLCapture_Acquire()
+ * @retval Tile index
+ * @note   Inference thread; the capture schedule moves on to the next tile
+ */
+uint32_t CAM_MLTile_Acquire(int capture_idx);
+#endif
+
+#if DUAL_STREAM_ENABLE
+/**
+ * @brief  Stream an acquired ML capture slot was written from
+ * @param  capture_idx: Slot index returned by Buffer_MLCapture_Acquire()
+ * @retval 0: main sensor (Pipe2), 1: second sensor (Pipe0, DUAL_STREAM_VC)
+ * @note   Inference thread
+ */
+uint32_t CAM_MLStream_Get(int capture_idx);
+
+/**
+ * @brief  Report the detections of a stream's frame: one with none for
+ *         DUAL_STREAM_IDLE_RUNS results in a row is idle, and loses turns
+ * @param  stream: Stream of the frame
+ * @param  nb_detect: Detections of the frame
+ * @note   Post-processing thread
+ */
+void CAM_MLStream_Report(uint32_t stream, uint32_t nb_detect);
+#endif
+
+#if NN_TILING == NN_TILING_ROI
+/**
+ * @brief  Steer the Pipe2 window to a sensor area
+ * @param  area: Area to frame, normalized to the sensor FOV; widened to the
+ *         smallest square of at least NN_ROI_MIN_SIDE containing it, then
+ *         moved inside the sensor
+ * @note   Post-processing thread; applies from the next Pipe2 frame started
+ */
+void CAM_MLRoi_Set(const cam_ml_tile_t *area);
+
+/**
+ * @brief  Steer the Pipe2 window back to the whole sensor
+ * @note   Post-processing thread; applies from the next Pipe2 frame started
+ */
+void CAM_MLRoi_SetFullFov(void);
+
+/**
+ * @brief  Window an acquired Pipe2 capture slot was taken with
+ * @param  capture_idx: Slot index returned by Buffer_MLCapture_Acquire()
+ * @retval Sensor area of the frame
+ * @note   Inference thread
+ */
+cam_ml_tile_t CAM_MLRoi_Acquire(int capture_idx);
+#endif
+
+#if NN_MULTIRES_ENABLE
+/**
+ * @brief  Resize the Pipe2 frame, over the same center crop
+ * @param  side: ML_WIDTH or NN_MULTIRES_SIDE
+ * @note   Any thread; applies from the next snapshot armed
+ */
+void CAM_MLRes_Set(uint32_t side);
+
+/**
+ * @brief  Side an acquired Pipe2 capture slot was written at
+ * @param  capture_idx: Slot index returned by Buffer_MLCapture_Acquire()
+ * @retval ML_WIDTH or NN_MULTIRES_SIDE; lines are ML_PITCH apart either way
+ * @note   Inference thread
+ */
+uint32_t CAM_MLRes_Acquire(int capture_idx);
+#endif
+
+/**
+ * @brief  Map from detection coordinates to the camera display frame on screen
+ * @note   Computed by CAM_Init() from the pipe configurations, constant after;
+ *         with DISPLAY_FOLLOW_ENABLE the map of the window that frame was
+ *         captured with
+ */
+const cam_display_map_t *CAM_GetDisplayMap(void);
+
+/**
+ * @brief  Map from detection coordinates to one camera display slot
+ * @param  slot: Display ring slot, e.g. from Buffer_CameraDisplay_Lend()
+ * @note   CAM_GetDisplayMap() whatever the slot without DISPLAY_FOLLOW_ENABLE
+ */
+const cam_display_map_t *CAM_GetSlotDisplayMap(int slot);
+
+#if DISPLAY_FOLLOW_ENABLE
+/**
+ * @brief  Move the Pipe1 window toward the primary track: the followed one
+ *         while it lives, else the largest; the full view once none was seen
+ *         for DISPLAY_FOLLOW_HOLD_FRAMES updates
+ * @note   UI thread, once per camera frame on screen; applies from the next
+ *         Pipe1 frame started
+ */
+void CAM_DisplayFollow_Update(void);
+#endif
+
+/**
+ * @brief  Change the sensor frame rate while streaming
+ * @param  fps: A rate the sensor supports (see CAMERA_FPS)
+ * @note   The ISP run rate and the snapshot timing follow it.
+ *         Fail-fast: panics on unrecoverable failures
+ */
+void CAM_SetFrameRate(int32_t fps);
+
+/**
+ * @brief  Sensor frame rate in use: the preset of the probed sensor until
+ *         CAM_SetFrameRate() changes it
+ */
+int32_t CAM_GetFrameRate(void);
+
+/**
+ * @brief  Change the ML decimation while streaming
+ * @param  decimation: Sensor frames per ML frame. ML_CAPTURE_SNAPSHOT: at
+ *         least, 1 to 8. ML_CAPTURE_CONTINUOUS: 1, 2, 4 or 8, the Pipe2
+ *         hardware frame divider, so skipped frames are neither written
+ *         nor interrupt
+ * @note   Any thread; applies from the next arming, or the next frame
+ */
+void CAM_SetMLDecimation(uint32_t decimation);
+
+/**
+ * @brief  Sensor frames per ML frame in use: NN_FRAME_DECIMATION until
+ *         CAM_SetMLDecimation() changes it
+ */
+uint32_t CAM_GetMLDecimation(void);
+
+/**
+ * @brief  Copy the frame counters of one pipe
+ * @param  pipe: DCMIPP_PIPE0 to DCMIPP_PIPE2
+ * @param  stats: Output counters
+ */
+void CAM_GetPipeStats(uint32_t pipe, cam_pipe_stats_t *stats);
+
+/**
+ * @brief  Get the pipes writing a frame right now
+ * @retval Bit n set while DCMIPP_PIPEn is between its start of frame and
+ *         frame complete
+ * @note   Safe from interrupts
+ */
+uint32_t CAM_GetCapturingPipes(void);
 
 /**
  * @brief  Update ISP parameters (call periodically for auto exposure/white
@@ -55,6 +315,18 @@ void CAM_MLPipe_Start(uint8_t *ml_pipe_dst, uint32_t cam_mode);
  */
 void CAM_IspUpdate(void);
 
+/**
+ * @brief  Hold back ISP runs during a latency-critical section
+ * @note   Thread context, nestable; a run due meanwhile starts at
+ *         CAM_IspDefer_End(), or after ISP_MAX_DEFER_FRAMES extra frames
+ */
+void CAM_IspDefer_Begin(void);
+
+/**
+ * @brief  End a section started by CAM_IspDefer_Begin()
+ */
+void CAM_IspDefer_End(void);
+
 /**
  * @brief  Initialize ISP semaphore for vsync callback
  * @note   Fail-fast: panics on unrecoverable failures
@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file    app_cascade.h
+ * @author  Long Liangmao
+ * @brief   Second-stage (cascade) inference for STM32N6570-DK
+ *          Crops around the top-K primary detections are run back-to-back on
+ *          the NPU after the primary network, within a per-frame time budget
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_CASCADE_H
+#define APP_CASCADE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#if CASCADE_ENABLE
+
+#include "app_arena.h"
+#include "app_npu_sched.h"
+#include "app_postprocess.h"
+#include "od_pp_output_if.h"
+
+/* Scratch Cascade_Decode() takes from its arena: the decoded candidates */
+#define CASCADE_SCRATCH_SIZE ARENA_SIZE_OF(od_pp_outBuffer_t, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB)
+
+/**
+ * @brief  Bind the second-stage network and its post-processing
+ * @param  scratch: Post-processing scratch for the bind only: each
+ *         Cascade_Decode() decodes into its own frame arena
+ * @param  scratch_nb: Entries of scratch
+ * @note   Called from NN_Init(); fail-fast if the network does not match the
+ *         ML frame size or the primary output layout
+ */
+void Cascade_Init(od_pp_outBuffer_t *scratch, uint32_t scratch_nb);
+
+/**
+ * @brief  Crop the candidates that fit the frame budget (inference thread)
+ * @param  slot: NN output slot of the current frame
+ * @param  frame: ML capture slot, still held by the inference thread
+ * @param  cands: Candidates, highest confidence first
+ * @param  nb_cand: Number of candidates (at most CASCADE_TOP_K)
+ * @param  primary_us: Expected primary inference time of this frame
+ */
+void Cascade_Prepare(uint32_t slot, const uint8_t *frame, const nn_detection_t *cands,
+                     uint32_t nb_cand, uint32_t primary_us);
+
+/**
+ * @brief  Run the prepared crops on the NPU (inference thread)
+ * @param  slot: NN output slot of the current frame
+ * @param  frame_us: NPU slot time already used by this frame
+ * @note   Call after the primary outputs are copied out: the second-stage
+ *         activations overlap the primary ones
+ */
+void Cascade_Run(uint32_t slot, uint32_t frame_us);
+
+#if NPU_SCHED_ENABLE
+/**
+ * @brief  Make the scheduler job running the prepared crops of a slot,
+ *         interleaved with the primary inference (inference thread)
+ * @param  slot: NN output slot of the current frame
+ * @param  frame_start: DWT cycles at the frame start; no crop is started
+ *         that would end past the frame budget, the job expires there
+ * @param  job: Output job, priority 1 (below the primary)
+ */
+void Cascade_InitJob(uint32_t slot, uint32_t frame_start, npu_sched_job_t *job);
+
+/**
+ * @brief  Account the prepared crops the job did not run (inference thread)
+ * @param  slot: NN output slot of the current frame
+ */
+void Cascade_EndJob(uint32_t slot);
+#endif
+
+/**
+ * @brief  Decode the second-stage outputs of one slot (post-processing thread)
+ * @param  slot: NN output slot received from the inference thread
+ * @param  result: Output results, ML frame coordinates
+ * @param  scratch: Frame arena, CASCADE_SCRATCH_SIZE bytes taken
+ */
+void Cascade_Decode(uint32_t slot, nn_cascade_t *result, arena_t *scratch);
+
+#endif /* CASCADE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_CASCADE_H */
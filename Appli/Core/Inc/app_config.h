@@ -18,12 +18,27 @@
 #ifndef APP_CONFIG
 #define APP_CONFIG
 
-/* Camera FPS configuration */
+/* Camera FPS configuration: sensor and display rate. The IMX335 runs 10, 15,
+ * 20, 25, 30, 50 or 60 fps; 60 with NN_FRAME_DECIMATION 2 is the
+ * low-latency mode, the display at 60 and inference fed at 30 */
 #define CAMERA_FPS 30
 
+/* The sensor is probed at init (cmw_camera_conf.h): IMX335, or the VD55G1
+ * (monochrome global shutter, up to 168 fps) and VD66GY (RGB global shutter,
+ * up to 88 fps) modules, run at their own rates */
+#define CAMERA_VD55G1_FPS 60
+#define CAMERA_VD66GY_FPS 30
+
 /* Define sensor orientation */
 #define CAMERA_FLIP CMW_MIRRORFLIP_MIRROR
 
+/* Sensor mode: CAM_Init picks the smallest readout serving every pipe at
+ * the sensor rate. Windowed readouts see less of the scene: CAMERA_MIN_FOV_PCT
+ * is the share of the full sensor width a mode must keep (100: full FOV).
+ * The auxiliary stream needs the full 2592x1944 IMX335 readout */
+#define CAMERA_MIN_FOV_PCT 100
+#define CAMERA_MAX_SENSOR_MODES 8
+
 /* Define display size */
 #define LCD_WIDTH 800
 #define LCD_HEIGHT 480
@@ -36,18 +51,1211 @@
 #define DISPLAY_LETTERBOX_X0 (LCD_WIDTH - DISPLAY_LETTERBOX_WIDTH) /* 160 - left margin for black bars */
 #define DISPLAY_LETTERBOX_X1 LCD_WIDTH                             /* 800 - right edge */
 
-/* Delay display by DISPLAY_DELAY frame number */
-#define DISPLAY_DELAY 1
-#define DISPLAY_BUFFER_NB (DISPLAY_DELAY + 2)
+/* UI layer (layer 1) window: from the left panel column to the right edge of
+ * the area detections are drawn on, the only areas the UI draws into: the
+ * centered ML frame square (720), or the whole letterbox with full-FOV tiling,
+ * the ROI window and the display follow zoom */
+#define UI_LAYER_WIDTH                                                                             \
+  (NN_TILING != NN_TILING_CENTER || DISPLAY_FOLLOW_ENABLE                                          \
+       ? LCD_WIDTH                                                                                 \
+       : DISPLAY_LETTERBOX_X0 + (DISPLAY_LETTERBOX_WIDTH + DISPLAY_LETTERBOX_HEIGHT) / 2)
+#define UI_LAYER_HEIGHT LCD_HEIGHT
+
+/* UI layer buffers, each UI_LAYER_WIDTH x UI_LAYER_HEIGHT:
+ * 2: double buffering, every UI update waits for its swap to be latched
+ * 3: the LTDC reload interrupt frees the buffers scanout left, so an update
+ *    draws into the spare one and returns after staging it; it only waits
+ *    when it outruns the display */
+#define UI_BUFFER_NB 2
+
+/* UI pixel format: ARGB4444 halves LTDC fetch and DMA2D traffic for the UI
+ * layer at the cost of 16 alpha/color levels per channel */
+#define UI_LAYER_ARGB4444 0
+#if UI_LAYER_ARGB4444
+#define UI_LAYER_FORMAT LCD_PIXEL_FORMAT_ARGB4444
+#define UI_BPP 2
+#else
+#define UI_LAYER_FORMAT LCD_PIXEL_FORMAT_ARGB8888
+#define UI_BPP 4
+#endif
+
+/* PSRAM MPU mapping (MPU_Config):
+ * PSRAM_MPU_ALL_UNCACHED: every PSRAM buffer non-cacheable
+ * PSRAM_MPU_STREAMS_UNCACHED: only the DMA streams (camera display ring and
+ *   ML capture ring: DCMIPP writes, LTDC/NPU read, the CPU never touches
+ *   them) are non-cacheable; the CPU-drawn UI buffers and the NN output
+ *   ring are cached write-back and flushed explicitly */
+#define PSRAM_MPU_ALL_UNCACHED 0
+#define PSRAM_MPU_STREAMS_UNCACHED 1
+#define PSRAM_MPU_MODE PSRAM_MPU_STREAMS_UNCACHED
+
+/* Camera display ring policy (Pipe1 -> LTDC):
+ * DISPLAY_POLICY_LATEST: show the newest complete frame, lowest latency
+ * DISPLAY_POLICY_SYNC_NN: hold the frame on screen until the detections of a
+ *   newer frame are published, then show that exact frame; falls back to the
+ *   oldest waiting frame when the ring fills (NN stalled or not started)
+ * DISPLAY_POLICY_ALIGNED: SYNC_NN, with the held frame handed to LTDC by the
+ *   UI thread together with the overlay drawn from its own detections, so
+ *   one reload latches both: boxes land on the pixels they were computed on,
+ *   tracked boxes are taken at that frame's capture, never extrapolated. The
+ *   display then runs at the inference and UI rates (NN_FRAME_DECIMATION,
+ *   UI_SetMinPeriod()) and trails the sensor by the inference latency; the
+ *   hidden overlay falls back to SYNC_NN */
+#define DISPLAY_POLICY_LATEST 0
+#define DISPLAY_POLICY_SYNC_NN 1
+#define DISPLAY_POLICY_ALIGNED 2
+#define DISPLAY_POLICY DISPLAY_POLICY_SYNC_NN
+
+/* DISPLAY_POLICY_ALIGNED: frames held for the inference latency, one
+ * DISPLAY_LETTERBOX_WIDTH x DISPLAY_LETTERBOX_HEIGHT RGB565 slot of PSRAM
+ * each. Deeper rides out slower inferences in step with their boxes; the
+ * waiting frames before the ring gives up and shows the oldest one unpaired
+ * (display.depth, PARAM_DISPLAY_DEPTH) bound the lag at run time */
+#define DISPLAY_ALIGN_DEPTH 3
+
+/* Ring depth: one slot scanned out, one retiring until the next vblank, two
+ * behind the Pipe1 double-buffer address registers; the rest hold frames
+ * waiting for the inference latency. UI_BOTTOM_PANEL_THUMBS adds the slot
+ * lent to the thumbnail crops, VENC_ENABLE the one lent to the encoder,
+ * SNAPSHOT_ENABLE the one lent to the JPEG snapshots and PREVIEW_ENABLE the
+ * one lent to the telemetry preview */
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+#define DISPLAY_HOLD_NB DISPLAY_ALIGN_DEPTH
+#else
+#define DISPLAY_HOLD_NB 1
+#endif
+#define DISPLAY_BUFFER_NB \
+  (4 + DISPLAY_HOLD_NB + (UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS) + VENC_ENABLE + SNAPSHOT_ENABLE + PREVIEW_ENABLE)
 
 /* Display format and bits per pixel */
 #define DISPLAY_FORMAT DCMIPP_PIXEL_PACKER_FORMAT_RGB565_1
 #define DISPLAY_BPP 2
 
+/* Single-pipe preview: LTDC layer 0 scans the Pipe2 RGB888 frames out
+ * directly, 1:1 at the ML square of the letterbox, and Pipe1 is left off.
+ * Halves the DCMIPP write traffic and drops the camera display ring from
+ * PSRAM; the preview shrinks to the center crop the network sees, at the
+ * Pipe2 rate. Needs continuous, undecimated RGB Pipe2 capture of the
+ * center crop and DISPLAY_POLICY_LATEST */
+#define DISPLAY_SINGLE_PIPE 0
+
 /* Machine Learning pipeline configuration for AI inference */
 #define ML_WIDTH 480
 #define ML_HEIGHT 480
+
+/* ML_GRAYSCALE: one 8-bit plane for a single-channel network, a third of
+ * the Pipe2 bandwidth; the luma of the monochrome VD55G1, the green
+ * channel of the color sensors */
+#define ML_GRAYSCALE 0
+
+/* ML_YUV422: Pipe2 packs 4:2:2, 2 bytes per pixel (YUYV), two thirds of
+ * the RGB888 bandwidth of the DCMIPP writes and the network input reads.
+ * Pipe2 has no color conversion of its own, so the components are the RGB
+ * of the ISP: the luma slot carries G at full resolution, the chroma slots
+ * B (U) and R (V) once per pixel pair. Needs a network regenerated for a
+ * 2-channel ML_WIDTH x ML_HEIGHT input, with the chroma upsampling and the
+ * color matrix folded into its first layer; fail-fast on any other input
+ * size. Not with ML_GRAYSCALE, DISPLAY_SINGLE_PIPE, CASCADE_ENABLE or
+ * DUAL_STREAM_ENABLE */
+#define ML_YUV422 0
+#if ML_GRAYSCALE
+#define ML_FORMAT DCMIPP_PIXEL_PACKER_FORMAT_MONO_Y8_G8_1
+#define ML_BPP 1
+#elif ML_YUV422
+#define ML_FORMAT DCMIPP_PIXEL_PACKER_FORMAT_YUV422_1
+#define ML_BPP 2
+#else
 #define ML_FORMAT DCMIPP_PIXEL_PACKER_FORMAT_RGB888_YUV444_1
 #define ML_BPP 3
+#endif
+
+/* Pipe2 line pitch rounded up to this power of two of bytes (16: packed
+ * lines, the DCMIPP minimum). 64 or 128 start every line on a hyperRAM burst
+ * and a cache line (480 RGB888 pixels: 1440 bytes, 1472 at 64). The network
+ * input tensor is compiled packed, so padded frames are gathered into it
+ * line by line instead of bound in place (zero-copy); not with
+ * ML_INPUT_ALIAS */
+#define ML_PITCH_ALIGN 16U
+
+/* Pipe2 capture mode:
+ * ML_CAPTURE_SNAPSHOT: one frame at a time, requested by the inference thread
+ *   as the NPU starts and armed at the Pipe1 vsync from which it completes
+ *   just as the inference is expected to end; no frame is captured unread
+ * ML_CAPTURE_CONTINUOUS: every sensor frame, double-buffered; the newest
+ *   complete one is taken */
+#define ML_CAPTURE_CONTINUOUS 0
+#define ML_CAPTURE_SNAPSHOT 1
+#define ML_CAPTURE_MODE ML_CAPTURE_SNAPSHOT
+
+/* Pipe2 frames per sensor frame, 1/N: 1, 2, 4 or 8. The display keeps
+ * CAMERA_FPS, the tracker predicting boxes between inferences. Continuous
+ * capture sets the Pipe2 hardware frame divider (CAM_SetMLDecimation()), so
+ * skipped frames are neither written nor interrupt */
+#define NN_FRAME_DECIMATION 1
+
+/* Remote ISP tuning over USB CDC (cmake -DISP_TUNING=ON): the ISP command
+ * parser runs in the ISP thread; statistics meta and frame dumps go out from a
+ * low-priority thread, a dump reading a lent Pipe2 slot in place */
+#ifndef ISP_TUNING_ENABLE
+#define ISP_TUNING_ENABLE 0
+#endif
+
+/* ISP run split in two threads: the analysis (statistics, AE/AWB, bad
+ * pixel, sensor delay) below post-processing, the sensor and ISP writes it
+ * computes held and applied at the next vsync at ISP_THREAD_PRIORITY
+ * (sensor I2C in thread context). 0: one run at ISP_THREAD_PRIORITY */
+#define ISP_SPLIT_APPLY 1
+
+/* Sensor register writes of the ISP apply queued and sent over the camera
+ * I2C by interrupts (app_sensor_cmd.h), the exposure and gain in one sensor
+ * hold group so they land on the same frame; the apply thread returns
+ * before the bus is done. Needs ISP_SPLIT_APPLY. 0: blocking writes */
+#define SENSOR_CMD_ENABLE 1
+#define SENSOR_CMD_QUEUE_LEN 16U /* Register writes in one batch */
+
+/* Hardware H.264 recording (cmake -DVIDEO_ENCODER=ON): one displayed Pipe1
+ * frame in VENC_FRAME_DECIMATION is lent to the VENC, or first composed with
+ * the UI layer by one DMA2D pass (VENC_OVERLAY), and encoded below the NN
+ * threads. Composition and encode are the DMA2D and VENC stages of a job
+ * pipeline (app_jobs.h): the next frame is composed while the VENC encodes
+ * one, VENC_PIPELINE_DEPTH frames in flight. The VENC pre-processor converts the RGB565 frames to
+ * YUV 4:2:0 itself: no CPU pass. Access units land in a ring read by a USB,
+ * Ethernet or SD consumer (Venc_Acquire); a frame is skipped, not encoded,
+ * while the ring lacks VENC_FRAME_MAX bytes */
+#ifndef VENC_ENABLE
+#define VENC_ENABLE 0
+#endif
+#define VENC_FRAME_DECIMATION 2               /* 15 fps at CAMERA_FPS 30 */
+#define VENC_OVERLAY 1                        /* Burn the detection overlay in */
+#define VENC_BITRATE 2000000                  /* Target, bits per second */
+#define VENC_GOP_LENGTH 30                    /* Encoded frames per IDR frame */
+#define VENC_STREAM_SIZE (2 * 1024 * 1024)    /* Bitstream ring */
+#define VENC_FRAME_MAX (192 * 1024)           /* Room required before each encode */
+#define VENC_AU_NB 32                         /* Access units queued in the ring */
+#define VENC_EWL_POOL_SIZE (2 * 1024 * 1024)  /* Encoder reference frames and tables */
+#define VENC_PIPELINE_DEPTH 2                 /* Frames composed ahead of the encoder (VENC_OVERLAY) */
+
+/* Pipe2 capture ring: two slots behind the DCMIPP double-buffer address registers (one
+ * armed snapshot), one latest-complete, one held by the NN thread, plus one lent to
+ * an ISP tuning dump. With user-allocated network inputs the held slot is the input
+ * tensor itself (zero-copy). DISPLAY_SINGLE_PIPE adds the slot scanned out and
+ * the one retiring until the next vblank, DATASET_ENABLE the slots lent to the
+ * dataset writer */
+#define ML_CAPTURE_BUFFER_NB (4 + ISP_TUNING_ENABLE + 2 * DISPLAY_SINGLE_PIPE + DATASET_ENABLE * DATASET_SLOTS)
+
+/* Pipe2 snapshots written into the network-allocated input tensor, in the
+ * activation pool, instead of a ring slot copied there: no ML capture ring
+ * (ML_CAPTURE_BUFFER_NB frames of PSRAM) and no input copy per frame. The
+ * activations are dead between inferences only, so a snapshot is armed once
+ * the outputs are copied out instead of ahead of the inference end: capture
+ * no longer overlaps the inference. Needs ML_CAPTURE_SNAPSHOT and a network
+ * generated with its input allocated */
+#define ML_INPUT_ALIAS 0
+
+/* Pipe2 snapshots ingested band by band: a Pipe2 line event every
+ * ML_SLICE_LINES lines (8 to 128, a power of two) wakes the inference
+ * thread, which copies the rows landed so far into the network input while
+ * the rest of the frame arrives, the NPU idle; at the frame event only the
+ * last band is left to copy. The network streams its whole input in its
+ * first epoch, so the NPU still starts at the frame event. Copy mode only:
+ * a network with user-allocated inputs or ML_INPUT_ALIAS reads the slot
+ * itself. Needs ML_CAPTURE_SNAPSHOT */
+#define ML_SLICE_INGEST 1
+#define ML_SLICE_LINES 32
+
+/* Pipe2 field of view:
+ * NN_TILING_CENTER: centered square crop of the sensor, every frame (N fps)
+ * NN_TILING_FULL_FOV: Pipe2 steps through overlapping square tiles covering
+ *   the whole sensor, one tile per inference, and the detections of a sweep
+ *   are merged by a cross-tile NMS. The coarse tiles have the side of the
+ *   center crop: 2 on the 4:3 IMX335, full FOV at N/2 fps. NN_TILING_FINE
+ *   adds tiles of half that side (3x3 on the IMX335) for small, far people
+ * NN_TILING_ROI: the Pipe2 window follows the detections, a square around
+ *   them padded by NN_ROI_MARGIN_PCT, so far people are seen at up to the
+ *   sensor resolution. Without detections, and every NN_ROI_DISCOVERY_PERIOD
+ *   frames, Pipe2 takes the whole sensor (stretched to the ML frame) to
+ *   pick up newcomers */
+#define NN_TILING_CENTER 0
+#define NN_TILING_FULL_FOV 1
+#define NN_TILING_ROI 2
+#define NN_TILING NN_TILING_CENTER
+#define NN_TILING_FINE 0
+#define NN_TILING_OVERLAP_PCT 10          /* Minimum overlap of neighbor tiles, share of the side */
+#define NN_TILING_MAX_TILES 16
+#define NN_TILING_CONTAIN_THRESHOLD 0.7f  /* Cross-tile: drop a box mostly inside a more confident one */
+#define NN_ROI_MARGIN_PCT 25              /* Padding around the detections, share of their extent */
+#define NN_ROI_MIN_SIDE ML_WIDTH          /* Smallest window, sensor pixels: the pipe only downscales */
+#define NN_ROI_DISCOVERY_PERIOD 8         /* Full-FOV frame every N windowed frames */
+
+/* Resolution-adaptive inference: while every person seen is large, the
+ * detector switches to NN_MULTIRES_NETWORK, the same model generated for an
+ * NN_MULTIRES_SIDE square input (with its input allocated, not
+ * --no-inputs-allocation), and Pipe2 downscales the same center crop to
+ * that side at the next snapshot. A small box, NN_MULTIRES_EMPTY_FRAMES
+ * results without any, or a probe every NN_MULTIRES_PROBE_PERIOD
+ * low-resolution results goes back to ML_WIDTH for the far field. Box
+ * sizes are the larger side, normalized to the frame; a frame captured at
+ * the other side is dropped. Needs ML_CAPTURE_SNAPSHOT and
+ * NN_TILING_CENTER; not with CASCADE, DATASET, DUAL_STREAM, ML_INPUT_ALIAS
+ * or PP_EXCLUDE, and the motion gate only on the auxiliary stream */
+#define NN_MULTIRES_ENABLE 0
+#define NN_MULTIRES_NETWORK MX_X_CUBE_AI_NET_OBJECT_DETECTION_YOLO_X
+#define NN_MULTIRES_SIDE 320           /* Low-resolution input, multiple of 32 (YOLOX strides) */
+#define NN_MULTIRES_DOWN_SIZE 0.25f    /* Smallest box that lets the network go down */
+#define NN_MULTIRES_UP_SIZE 0.15f      /* Box that brings it back up: below the down size */
+#define NN_MULTIRES_HOLD_FRAMES 5      /* Full-resolution results in a row before going down */
+#define NN_MULTIRES_EMPTY_FRAMES 3     /* Low-resolution results without detections before going up */
+#define NN_MULTIRES_PROBE_PERIOD 30    /* Low-resolution results between full-resolution probes */
+
+/* Motion gate: the NPU only runs on a Pipe2 frame when at least
+ * MOTION_MIN_BLOCKS of its MOTION_GRID x MOTION_GRID blocks changed mean luma
+ * by more than MOTION_BLOCK_THRESHOLD since the last run, while the last
+ * result had detections, or after MOTION_KEEPALIVE_FRAMES skipped frames.
+ * Skipped frames keep the last detections. Needs NN_TILING_CENTER; off
+ * with DUAL_STREAM_ENABLE (one reference frame for two scenes) */
+#define MOTION_GATE_ENABLE (!DUAL_STREAM_ENABLE)
+#define MOTION_GRID 16             /* Blocks per axis (30x30 pixels at 480x480) */
+#define MOTION_BLOCK_SAMPLES 4     /* Sampled pixels per block axis */
+#define MOTION_BLOCK_THRESHOLD 12  /* Mean luma change of a block, 0-255 */
+#define MOTION_MIN_BLOCKS 2        /* Changed blocks that trigger a run */
+#define MOTION_KEEPALIVE_FRAMES 15 /* Longest run of skipped frames (~0.5 s at 30 fps) */
+
+/* Auxiliary motion stream from DCMIPP Pipe0, the raw dump pipe (no ISP): one
+ * Bayer channel of every 2x2 sensor quad (1 line in 2, 1 sample in 2), as
+ * MSB-aligned 16-bit samples whose high byte is the 8-bit level, at
+ * AUX_FRAME_RATE of the sensor rate, double-buffered. No CPU copy: the motion
+ * gate samples it instead of the Pipe2 frame it is gating. Off with
+ * VENC_ENABLE: PSRAM does not hold both its ring and the encoder buffers,
+ * and with DUAL_STREAM_ENABLE, which takes Pipe0 */
+#define AUX_STREAM_ENABLE (!VENC_ENABLE && !DUAL_STREAM_ENABLE)
+#define AUX_WIDTH 1296 /* Half the IMX335 2592x1944 readout */
+#define AUX_HEIGHT 972
+#define AUX_BPP 2
+#define AUX_FRAME_RATE DCMIPP_FRAME_RATE_1_OVER_4 /* 7.5 fps, ~19 MB/s of PSRAM writes */
+
+/* Second camera on CSI-2 virtual channel DUAL_STREAM_VC, behind a serializer
+ * or aggregator bridge on the camera connector that sets its sensor up
+ * itself: a processed stream already at the network input size and in the
+ * ML format (RGB888 in Pipe2's byte order, or Y8 with ML_GRAYSCALE). The
+ * dump pipe (Pipe0) snapshots it into the ML capture ring, taking turns with
+ * the Pipe2 snapshots of the main sensor: one frame is requested at a time,
+ * from the stream picked by activity. Both active or both idle, the streams
+ * alternate; a stream whose last DUAL_STREAM_IDLE_RUNS results had no
+ * detection gets one pick in DUAL_STREAM_IDLE_PERIOD, so the active view
+ * keeps most of the inference rate. Results of the second stream go to
+ * telemetry only, tagged stream 1; the display, tracker and overlay follow
+ * the main sensor. Needs ML_CAPTURE_SNAPSHOT, NN_TILING_CENTER and unpadded
+ * ML lines (Pipe0 has no pitch); not with CASCADE_ENABLE, DISPLAY_SINGLE_PIPE,
+ * ML_INPUT_ALIAS or ML_YUV422 */
+#define DUAL_STREAM_ENABLE 0
+#define DUAL_STREAM_VC 1           /* DCMIPP_VIRTUAL_CHANNEL1 */
+#define DUAL_STREAM_IDLE_RUNS 3    /* Results without detections before a stream counts idle */
+#define DUAL_STREAM_IDLE_PERIOD 4  /* Picks per turn of an idle stream while the other is active */
+
+/* Multi-object tracker after post-processing: stable track IDs, and boxes
+ * predicted to the vsync of every displayed camera frame, so the overlay
+ * moves at display rate between inferences */
+#define TRACKER_ENABLE 1
+#define TRACKER_MAX_TRACKS AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT
+#define TRACKER_IOU_THRESHOLD 0.3f /* Predicted box vs detection to associate */
+#define TRACKER_MIN_HITS 2         /* Associated detections before a track is shown */
+#define TRACKER_MAX_MISSES 2       /* Inferences a confirmed track survives unmatched */
+
+/* Detection AE: while tracks are shown, the ISP statistics (AE and AWB) are
+ * measured on the union of the tracked boxes, and the exposure time is capped
+ * so the fastest track moves at most DETECTION_AE_MAX_BLUR_PCT of its height
+ * during the exposure, the gain making up for it. Back to the default area
+ * and the sensor exposure range once no track is left. Needs TRACKER_ENABLE */
+#define DETECTION_AE_ENABLE 1
+#define DETECTION_AE_MARGIN_PCT 25       /* Area grown past the boxes, % of their union */
+#define DETECTION_AE_MIN_AREA_PCT 25     /* Smallest area side, % of the frame side */
+#define DETECTION_AE_MAX_BLUR_PCT 5      /* Motion during the exposure, % of the box height */
+#define DETECTION_AE_MIN_EXPOSURE_US 2000 /* Lowest exposure cap */
+
+/* Display follow: Pipe1 crops and downsizes a window around the primary
+ * track instead of the whole FOV, so the DCMIPP scaler does the zoom at no
+ * CPU or bandwidth cost. The window is smoothed frame to frame and
+ * programmed at Pipe1 frame boundaries; each display slot keeps the map
+ * its boxes are drawn with. Pipe2 keeps inferring on its own crop. Needs
+ * TRACKER_ENABLE and the Pipe1 display ring (no DISPLAY_SINGLE_PIPE) */
+#define DISPLAY_FOLLOW_ENABLE 0
+#define DISPLAY_FOLLOW_MAX_ZOOM 4      /* Smallest window, 1/N of the full view width (at least the letterbox) */
+#define DISPLAY_FOLLOW_FILL_PCT 50     /* Primary box extent in the window, % of its side */
+#define DISPLAY_FOLLOW_SMOOTH_PCT 15   /* Step toward the target per frame, % of the gap */
+#define DISPLAY_FOLLOW_HOLD_FRAMES 60  /* Frames without a track before zooming back out */
+
+/* JPEG snapshot of every new confirmed track, for audits: the displayed frame
+ * is lent from the display ring, the crop around the box predicted at its
+ * vsync (or the whole frame) is converted to YCbCr 4:2:0 MCUs one 16-line
+ * strip at a time and fed to the JPEG codec by HPDMA, which writes the image
+ * to a queue read by a storage or link consumer (Snapshot_Acquire). A track
+ * is not photographed while the queue is full. Needs TRACKER_ENABLE */
+#define SNAPSHOT_ENABLE 1
+#define SNAPSHOT_CROP 1                  /* 0: the whole letterbox frame */
+#define SNAPSHOT_MARGIN_PCT 25           /* Crop grown past the box, % of its size per side */
+#define SNAPSHOT_QUALITY 80              /* JPEG quality, 1-100 */
+#define SNAPSHOT_SLOTS 4                 /* Images queued for the consumer */
+#define SNAPSHOT_MAX_SIZE (128 * 1024)   /* Largest image; a larger one is dropped */
+#define SNAPSHOT_PENDING 8               /* New-track events waiting for the codec */
+
+/* Screenshot (needs SNAPSHOT_ENABLE and TELEMETRY): on the 'C' host request
+ * the snapshot thread lends the camera slot and the UI buffer on screen
+ * from their presenters, the DMA2D blends the UI layer over the camera
+ * layer at DISPLAY_LETTERBOX_X0, as LCD_Init places them, into a
+ * LCD_WIDTH x LCD_HEIGHT RGB565 frame, and the JPEG codec encodes it into
+ * the snapshot queue (track ID SNAPSHOT_SCREENSHOT_ID). The camera slot
+ * comes from the ring's snapshot lender slot: no frame is dropped; the UI
+ * skips the updates that find no undisplayed buffer meanwhile. Follows
+ * SNAPSHOT_ENABLE; set it to 0 to keep the snapshots without it */
+#define SCREENSHOT_ENABLE SNAPSHOT_ENABLE
+
+/* People analytics on the tracker: the center of each confirmed track, at
+ * its box predicted to the frame it was detected on, is tested against the
+ * ANALYTICS_LINES counting lines (crossings each way) and the
+ * ANALYTICS_ZONES rectangles (entries, track time inside, dwell of the
+ * visits that ended), and its time in view is accumulated. Every
+ * ANALYTICS_PERIOD_MS the UI thread sends one TELEMETRY_TYPE_ANALYTICS
+ * summary, so the host needs neither the detection stream
+ * (TELEMETRY_DETECT_PERIOD_MS can go up) nor a tracker of its own.
+ * Coordinates are in thousandths of the network input frame: X(x0, y0, x1,
+ * y1), at most ANALYTICS_LINES_MAX lines and ANALYTICS_ZONES_MAX zones
+ * (app_analytics.h). A line counts "in" when crossed from the right of
+ * x0,y0 -> x1,y1 to its left, walking it on screen, once the center is
+ * ANALYTICS_LINE_MARGIN past it; a crossing beyond its ends is not counted.
+ * At most ANALYTICS_MAX_TRACKS tracks are followed at once. Needs
+ * TRACKER_ENABLE and TELEMETRY */
+#define ANALYTICS_ENABLE 0
+#define ANALYTICS_PERIOD_MS 10000
+#define ANALYTICS_LINES(X) X(500, 0, 500, 1000)
+#define ANALYTICS_ZONES(X) X(0, 0, 500, 1000) X(500, 0, 1000, 1000)
+#define ANALYTICS_LINE_MARGIN 20 /* Thousandths of the frame past a line before the side changes */
+#define ANALYTICS_MAX_TRACKS 32
+
+/* NN output ring: one slot filled by the NN thread while the other is post-processed */
+#define NN_OUTPUT_BUFFER_NB 2
+
+/* Raw int8 network outputs: requires a model generated without the trailing DequantizeLinear
+ * (stedgeai --output-data-type int8); post-processing then thresholds in the quantized domain.
+ * Leave at 0 for the float32-output model shipped in X-CUBE-AI/App */
+#define NN_OUTPUT_INT8 0
+
+/* Split YOLOX heads: requires a model exported with the box, objectness and class convolutions
+ * of each level as int8 outputs of their own. The software Concat that merged them per level
+ * and its DequantizeLinear (epochs 166/167, 194/195 and 225/226 of od_yolo_x_person) then leave
+ * the graph, with their activations; post-processing decodes the nine heads in place.
+ * Needs NN_OUTPUT_INT8 */
+#define NN_OUTPUT_HEADS 0
+
+/* od_yolo_x_person outputs: 15x15, 60x60 and 30x30 grids of 3 anchors x (4 box + obj + 1 class) */
+#if NN_OUTPUT_HEADS
+#define NN_OUTPUT_NB 9
+#else
+#define NN_OUTPUT_NB 3
+#endif
+#if NN_OUTPUT_INT8
+#define NN_OUTPUT_ELEM_SIZE 1
+#else
+#define NN_OUTPUT_ELEM_SIZE 4
+#endif
+#define NN_OUTPUT_SIZE ((15 * 15 + 60 * 60 + 30 * 30) * 18 * NN_OUTPUT_ELEM_SIZE)
+
+/* Cascade: run a second-stage network on crops around the top-K detections of
+ * the previous frame, back-to-back with the primary inference, as long as the
+ * frame still fits CASCADE_FRAME_BUDGET_US of NPU slot time. The second stage
+ * shares NN_OUTPUT_NB/NN_OUTPUT_SIZE and the post-processing of the primary */
+#define CASCADE_ENABLE 0
+#define CASCADE_NETWORK MX_X_CUBE_AI_NET_OBJECT_DETECTION_YOLO_X
+#define CASCADE_TOP_K 2
+#define CASCADE_MAX_DETECTIONS 4     /* Second-stage detections kept per crop */
+#define CASCADE_ROI_MARGIN_PCT 20    /* Crop side beyond the larger box side */
+#define CASCADE_FRAME_BUDGET_US (NN_FRAME_DECIMATION * 1000000U / CAMERA_FPS)
+#define CASCADE_BUDGET_MARGIN_US 1000U
+
+/* Dual-instance NPU scheduler (needs CASCADE_ENABLE): the second stage of a
+ * frame runs interleaved with the detector of the same frame instead of after
+ * it. At each epoch boundary the detector takes the NPU when it is free; the
+ * second stage runs its SW epochs while the detector holds the NPU, its HW
+ * epochs when the NPU is free, and is dropped at the frame budget. Both
+ * networks stay initialized, so their activation and I/O buffers must not
+ * overlap (fail-fast at init): the shipped pair shares the AXISRAM pools,
+ * regenerate CASCADE_NETWORK with pools of its own to use it */
+#define NPU_SCHED_ENABLE 0
+#define NPU_SCHED_JOBS_MAX 2
+
+/* Voltage and frequency governor: the core supply (external SMPS and
+ * internal regulator range) and the CPU and NPU clocks switch between the
+ * overdrive point the FSBL boots at (CPU 800 MHz, NPU 1 GHz) and the nominal
+ * one (CPU 400 MHz, NPU 800 MHz) at the inference thread's frame boundary.
+ * The frame work, inference plus any wait on post-processing, is measured
+ * against the frame period: down after DVFS_HOLD_FRAMES frames predicted
+ * under DVFS_DOWN_PCT of it at the nominal point, up on the first frame over
+ * DVFS_UP_PCT. The nominal slowdown is learned, DVFS_NOMINAL_SCALE_PCT until
+ * measured. Not with TRACE_ENABLE (timestamps in CPU cycles) */
+#define DVFS_ENABLE 0
+#define DVFS_DOWN_PCT 60          /* Predicted nominal work, % of the frame period */
+#define DVFS_UP_PCT 90            /* Measured nominal work, % of the frame period */
+#define DVFS_HOLD_FRAMES 30       /* ~1 s at 30 fps between two decisions down */
+#define DVFS_NOMINAL_SCALE_PCT 170 /* First guess: between the NPU 1.25 and CPU 2 ratios */
+
+/* Performance profiles: named sets of the speed and power settings, moved
+ * together at the inference thread's frame boundary without a restart: the
+ * operating point (core supply, CPU and NPU clocks, as DVFS_ENABLE switches
+ * them), the sensor frame rate, the ML decimation, the motion gate,
+ * the overlay refresh period and the QoS preset (QOS_ENABLE). max-fps runs every frame at overdrive,
+ * balanced and low-power run at the nominal point (app_profile.h). Started in
+ * PROFILE_DEFAULT (0 max-fps, 1 balanced, 2 low-power), then switched by the
+ * power.profile parameter (PARAMS_ENABLE). Every stats period a telemetry
+ * record gives, per profile, the inference rate measured and the power
+ * estimated from the CPU load and the NPU busy time over PROFILE_POWER_*,
+ * to be calibrated against a supply measurement. With ML_CAPTURE_CONTINUOUS
+ * the decimations are the Pipe2 frame divider: 1, 2, 4 or 8; not with
+ * DVFS_ENABLE, which would move the operating point under it */
+#define PROFILE_ENABLE 0
+#define PROFILE_DEFAULT 1
+#define PROFILE_BALANCED_DECIMATION 2    /* 15 inferences/s at CAMERA_FPS 30 */
+#define PROFILE_BALANCED_UI_PERIOD_MS 66 /* Overlay at most ~15 Hz */
+#define PROFILE_LOW_POWER_FPS 15
+#define PROFILE_LOW_POWER_DECIMATION 4    /* ~4 inferences/s */
+#define PROFILE_LOW_POWER_UI_PERIOD_MS 250
+#define PROFILE_POWER_BASE_MW 1100         /* Board, sensor and display, CPU idle at the nominal point */
+#define PROFILE_POWER_OVERDRIVE_MW 120     /* Added by the overdrive supply, idle */
+#define PROFILE_POWER_CPU_NOMINAL_MW 110   /* CPU busy, 400 MHz */
+#define PROFILE_POWER_CPU_OVERDRIVE_MW 290 /* CPU busy, 800 MHz */
+#define PROFILE_POWER_NPU_NOMINAL_MW 420   /* NPU busy, 800 MHz */
+#define PROFILE_POWER_NPU_OVERDRIVE_MW 650 /* NPU busy, 1 GHz */
+
+/* Thermal governor: both DTS sensors convert continuously and every
+ * THERMAL_PERIOD_MS the UI thread takes the hotter one. THERMAL_HOLD_SAMPLES
+ * in a row at or over THERMAL_LIMIT_C raise the profile floor one step
+ * (max-fps, balanced, low-power: off the NPU overdrive clock, then fewer
+ * inferences and a lower sensor rate); THERMAL_CRITICAL_C goes to
+ * low-power at once. THERMAL_RELEASE_SAMPLES in a row under
+ * THERMAL_LIMIT_C - THERMAL_HYST_C lower it one step. The floor caps the
+ * profile power.profile asks for. A TELEMETRY_TYPE_THERMAL record gives the
+ * temperature and the floor every sample. Needs PROFILE_ENABLE */
+#define THERMAL_ENABLE 0
+#define THERMAL_PERIOD_MS 1000
+#define THERMAL_LIMIT_C 95 /* Junction budget, under the 125 C maximum */
+#define THERMAL_HYST_C 10
+#define THERMAL_CRITICAL_C 110
+#define THERMAL_HOLD_SAMPLES 5     /* A step every ~5 s while over the budget */
+#define THERMAL_RELEASE_SAMPLES 30 /* ~30 s cool before a step back up */
+
+/* Interconnect QoS: the bus masters ranked display, camera, NPU, CPU.
+ * DCMIPP runs in dynamic QoS, its level rising with the fill of its output
+ * FIFOs; the NPU and CPU ports of the NPU interconnect (SYSCFG NPUNICQOSCR)
+ * are held under it at the levels of a preset: display (NPU low) or
+ * throughput (NPU higher, for max-fps), QOS_PRESET_DEFAULT or the one of
+ * the performance profile (PROFILE_ENABLE). LTDC and DMA2D have no QoS
+ * control: LTDC keeps its fixed level above the backed-off NPU. A stats
+ * period with an LTDC underrun or a DCMIPP overrun steps the NPU down one
+ * level, to QOS_NPU_FLOOR at most; QOS_RECOVER_PERIODS clean periods step
+ * it back up. The glitches are counted per preset (Qos_GetStats()). Needs
+ * LCD_ERROR_MONITOR */
+#define QOS_ENABLE 1
+#define QOS_PRESET_DEFAULT 0  /* 0 display, 1 throughput */
+#define QOS_DISPLAY_NPU 4
+#define QOS_THROUGHPUT_NPU 8
+#define QOS_CPU 0             /* Under every NPU level: DMA2D and CPU last */
+#define QOS_NPU_FLOOR 1
+#define QOS_RECOVER_PERIODS 10 /* ~10 s of clean stats periods per step up */
+
+/* NPU idle gating: the ATON units an epoch does not use are clock gated by
+ * the runtime (LL_ATON_ENABLE_CLOCK_GATING). On top of it, after
+ * NPU_IDLE_GATE_FRAMES frames in a row skipped by the motion gate, the NPU
+ * clock is stopped and the activation-only AXISRAM banks (3 to 5, and 6
+ * unless NN_OUTPUT_INT8 keeps the output slots there) shut down, until the
+ * next frame to infer. The wake-up is timed: gating is only entered while
+ * the worst wake-up seen plus the last inference fits the frame period */
+#define NPU_IDLE_GATE_ENABLE 0
+#define NPU_IDLE_GATE_FRAMES 5 /* Skipped frames in a row before suspending */
+
+/* AXISRAM bank power: of AXISRAM2-6, the banks neither the active network
+ * (nor the CASCADE_NETWORK second stage) places a buffer in, nor a CPU
+ * section (.axisram3_bss, .axisram6_bss) uses, are shut down and their
+ * clocks gated (app_mempower.c). A network switch powers the banks of the
+ * next network up before selecting it, and shuts the ones left unused
+ * after. AXISRAM has no ECC and no retention mode in RAMCFG: unused banks
+ * are off, the others fully on */
+#define MEMPOWER_ENABLE 0
+
+/* Relocatable network (cmake -DNN_RELOC=ON): a stedgeai --relocatable binary
+ * flashed in a model slot (boot_slots.h, slot A at 0x71800000 after the
+ * static weights blob) is installed at boot as registry entry
+ * MX_X_CUBE_AI_NET_RELOC, from the slot the FSBL picked (app_slots.c). Code
+ * and weights execute in place from octoFlash, only its data/bss is copied
+ * to NN_RELOC_EXEC_RAM_SIZE bytes of app RAM; activations must fit the
+ * AXISRAM reservations (generated with this project's memory pools) */
+#define NN_RELOC_EXEC_RAM_SIZE (64U * 1024U)
+
+/* Shared network layout (cmake -DNN_SHARED_LAYOUT=ON, the default): the two
+ * registered YOLOX networks are generated alike, so they share the
+ * od_yolo_x_person weights in the octoFlash and the AXISRAM activation
+ * reservations; CMake checks that object_detection_yolo_x.c differs only by
+ * its name and leaves it out, and its registry entry is a second instance of
+ * the od_yolo_x_person interface: one copy of the epoch code and buffer
+ * tables, and with WEIGHT_STAGE_ENABLE one hyperRAM copy of the weights */
+#ifndef NN_SHARED_LAYOUT
+#define NN_SHARED_LAYOUT 0
+#endif
+
+/* Epoch controller network (cmake -DNN_EPOCH_CONTROLLER=ON): the hardware
+ * epochs of od_yolo_x_person are one command blob the NPU epoch controller
+ * sequences by itself, instead of one CPU IRQ and stream engine setup per
+ * epoch. The blob holds the stream engine setups: the weight prefetch and the
+ * NPU cache policy, which rewrite them at run time, do not apply to it, and
+ * the epoch callbacks (profiler, bandwidth report) see the blob as one epoch
+ * block. Fail-fast: the network must carry at least one blob */
+#ifndef NN_EPOCH_CONTROLLER
+#define NN_EPOCH_CONTROLLER 0
+#endif
+
+/* Weight staging: at boot, HPDMA copies the octoFlash weights of every
+ * registered network (pool 8: 8-bit bus at 1/6 of the NPU clock) to a
+ * staging area of the hyperRAM (pool 7: 16-bit at 1/5), and every stream
+ * engine read of them is moved to the copy. ~15 ms of boot for 1.35 MB; the Firmware_Bench xip variant reads the
+ * weights in place for the per-inference gain. The weight prefetch then has
+ * nothing left to stage from flash and is off */
+#define WEIGHT_STAGE_ENABLE 0
+#define WEIGHT_STAGE_SIZE (2U * 1024U * 1024U) /* Registered networks, shared weights once */
+
+/* Weight prefetch: while epoch N runs, HPDMA copies the octoFlash weight
+ * tensors of epochs up to N+WEIGHT_PREFETCH_DEPTH into a staging ring in the
+ * free tail of AXISRAM3, and their stream engines are pointed at the copy.
+ * The first inference of each network records the schedule; tensors larger
+ * than a quarter of the ring, or not staged in time, are read from flash.
+ * Off with NN_EPOCH_CONTROLLER: the blob epochs set their own engines up */
+#define WEIGHT_PREFETCH_ENABLE (!NN_EPOCH_CONTROLLER && !WEIGHT_STAGE_ENABLE)
+#define WEIGHT_PREFETCH_STAGING_SIZE (64U * 1024U) /* Free AXISRAM3 tail is ~110 KB */
+#define WEIGHT_PREFETCH_DEPTH 4
+#define WEIGHT_PREFETCH_MAX_TENSORS 256 /* Schedule entries per network */
+
+/* Boot warm-up: NN_Init() runs NN_WARMUP_INFERENCES inferences of the boot
+ * network on a zeroed input and decodes the last one, while the camera
+ * thread still probes the sensor and its AE converges. The weight prefetch
+ * records its schedule, and the NPU cache and the CPU caches hold the epoch,
+ * decode and NMS code and tables, so the first frame runs at steady-state
+ * latency. Results are dropped and the epoch profiler window restarts after
+ * them; 0 = off */
+#define NN_WARMUP_INFERENCES 2
+
+/* Boot self-test: after the warm-up, NN_Init() runs the boot network once on
+ * the reference input of the golden vector at SELFTEST_FLASH_ADDR (built by
+ * selftest.ps1, flashed by flash.ps1 $SelfTestVector) and checks the FNV-1a
+ * of its output tensors, its detections and its inference time against the
+ * record and budget stored with it. PASS, DRIFT (outputs changed, detections
+ * within tolerance) or FAIL goes to the console and the UI panel; a vector
+ * without a record prints the values to record instead */
+#define SELFTEST_ENABLE 0
+#define SELFTEST_FLASH_ADDR 0x71D00000U /* 1 MB past the benchmark scenes, below the asset pack */
+#define SELFTEST_FLASH_SIZE (1024U * 1024U)
+#define SELFTEST_IOU_MIN_PCT 90        /* Detection vs its golden box */
+#define SELFTEST_CONF_TOLERANCE_PCT 5  /* Confidence vs the golden one, points */
+
+/* Encrypted weights: the network is generated with stedgeai
+ * --encrypt-weights, which ships the weights blob encrypted and sets the
+ * cipher bit of the stream engines reading it, so the NPU decrypts on the fly
+ * with no CPU pass or clear copy in RAM. The 128-bit key is read from four
+ * consecutive OTP words (least significant first) by the secure application
+ * and written to key NPU_WEIGHT_KEY_SEL of every NPU bus interface; it is
+ * never stored in flash. Fail-fast: the key must be provisioned, and no
+ * stream engine may read clear data from the octoFlash. Prefetch stages the
+ * ciphertext as is (the keystream follows the encryption ID and the stream,
+ * which a byte copy keeps); check with WEIGHT_PREFETCH_ENABLE 0 on a new tool
+ * version. Off by default: the shipped blob is not encrypted */
+#define NPU_WEIGHT_CIPHER 0
+#define NPU_WEIGHT_KEY_OTP_WORD 360U /* Fuse of bits 31:0, user area: program and lock at provisioning */
+#define NPU_WEIGHT_KEY_SEL 0         /* Bus interface key slot the network was generated with */
+
+/* Secure side of a secure/non-secure split: the camera, NPU and model stay in
+ * this secure image, a non-secure image runs the UI and telemetry. Each
+ * published result lands in a shared triple buffer the non-secure side reads
+ * in place, with no gateway call per frame; its controls arrive in batches
+ * and telemetry is fetched once per UI period through the Secure_nsclib
+ * entries. The shared block and the gateway veneers are made non-secure and
+ * non-secure callable in the SAU at init; the non-secure image, its memory
+ * and the jump to it come from its own project. Off: single secure image */
+#define NS_SPLIT 0
+#define NS_SPLIT_CMD_MAX 16 /* Commands per SECURE_NS_Submit() batch */
+
+/* NPU cache (CACHEAXI) policy per memory region, applied to every stream
+ * engine tensor over the compiler's setting. Only read-only memory may be
+ * forced cacheable: the generated cache maintenance only covers the writable
+ * buffers the compiler itself made cacheable */
+#define NPU_CACHE_KEEP 0  /* Keep the compiler's attributes */
+#define NPU_CACHE_ON 1    /* Cacheable, compiler's allocate hint */
+#define NPU_CACHE_ALLOC 2 /* Cacheable, allocate on miss */
+#define NPU_CACHE_OFF 3   /* Bypass the cache */
+#define NPU_CACHE_POLICY 1
+#define NPU_CACHE_POLICY_FLASH NPU_CACHE_ON    /* xSPI2 octoFlash weights */
+#define NPU_CACHE_POLICY_PSRAM NPU_CACHE_KEEP  /* xSPI1 PSRAM */
+#define NPU_CACHE_POLICY_AXISRAM NPU_CACHE_OFF /* On-chip activations */
+
+/* NPU bandwidth report: around every epoch block, the ATON debug and trace
+ * counters measure the cycles each stream engine moves data or stalls; the
+ * cycles are attributed to the memory pool the engine was set up on
+ * (AXISRAM, hyperRAM, octoFlash) and summed per inference */
+#define NPU_BW_REPORT 1
+
+/* Per-epoch NPU profiler: DWT stamps around every epoch block, shown on the diagnostics overlay */
+#define NN_EPOCH_PROFILER 1
+
+/* End-to-end latency histograms: capture vsync -> NPU done -> post-processing
+ * done -> UI layer latched at a vblank, tagged per sensor frame */
+#define LATENCY_PROFILER 1
+
+/* Per-thread CPU share and stack high-water marks from the ThreadX execution
+ * profile (needs TX_EXECUTION_PROFILE_ENABLE in tx_user.h), optionally
+ * streamed on the ST-LINK virtual COM port every UI stats period */
+#define THREAD_PROFILER 1
+#define THREAD_PROFILER_UART 1
+
+/* Binary telemetry on the ST-LINK virtual COM port (USART1): fixed-size
+ * records (console text, detections, per-stage latencies and CPU load)
+ * queued in a ring of TELEMETRY_RECORDS and sent by GPDMA in COBS frames, so
+ * a printf() or a publish costs the producer a slot reservation and a copy
+ * instead of about 10 us per byte in a blocking transmit. A full ring drops
+ * the record and counts it; detections are sent at most every
+ * TELEMETRY_DETECT_PERIOD_MS (0: every inference). printf() output, the UART
+ * reports above included, becomes text records: read the port with
+ * telemetry.ps1. The port is opened in App_Init(), so boot reports are kept */
+#define TELEMETRY 1
+#define TELEMETRY_RECORDS 128
+#define TELEMETRY_DETECT_PERIOD_MS 0
+
+/* Pipeline trace: TRACE_BEGIN/END/INSTANT/COUNTER probes (app_trace.h) at
+ * the DCMIPP interrupt, the ISP thread, the inference and, with
+ * TRACE_NPU_EPOCHS (needs NN_EPOCH_PROFILER), each NPU epoch block,
+ * post-processing, the LTDC reloads and the UI updates, so one timeline
+ * shows the whole pipeline. Each probe is a DWT stamp into a lock-free ring
+ * of 2^TRACE_EVENTS_LOG2 events; all compile to nothing when 0. With
+ * TRACE_DRAIN (needs TELEMETRY) the UI thread sends the events as telemetry
+ * records, at most TRACE_DRAIN_RECORDS of 4 per wake; without, the ring
+ * keeps the latest ones for the debugger. telemetry.ps1 exports either to
+ * Chrome trace JSON (chrome://tracing, Perfetto). Epochs are many: about
+ * 2 events per block, per inference, enough to fill the UART */
+#define TRACE_ENABLE 0
+#define TRACE_EVENTS_LOG2 10
+#define TRACE_DRAIN 1
+#define TRACE_DRAIN_RECORDS 16
+#define TRACE_NPU_EPOCHS 0
+
+/* TraceX kernel trace (cmake -DTRACEX=ON): ThreadX is built with
+ * TX_ENABLE_EVENT_TRACE (tx_user.h) and logs every context switch and every
+ * semaphore, queue, event flags and mutex call, suspensions and priority
+ * inheritance included, into the TRACEX_BUFFER_SIZE bytes of .psram_trace,
+ * laid out as the .trx file TraceX opens, DWT stamped. Each pipeline probe
+ * (TRACE_ENABLE) is also a user event, and begin/end probes in handler mode
+ * enter and leave the interrupt, so the ISRs that preempt show. On the 'X'
+ * host request tracing stops, the buffer goes out as TRACEX_DUMP_RECORDS
+ * telemetry records per UI wake and tracing restarts empty; telemetry.ps1
+ * writes the .trx. Without TELEMETRY, halt and dump the buffer */
+#ifndef TRACEX_ENABLE
+#define TRACEX_ENABLE 0
+#endif
+#define TRACEX_BUFFER_SIZE (128U * 1024U)
+#define TRACEX_REGISTRY_ENTRIES 64U /* Named objects: threads, queues, semaphores, mutexes, pools */
+#define TRACEX_DUMP_RECORDS 32
+
+/* SWO profiling build: the ITM/DWT stream on the SWO pin (PB5, to the
+ * ST-LINK) carries a DWT PC sample every SWO_PC_SAMPLE_CYCLES core cycles
+ * (64 x 1..16 or 1024 x 1..16), with SWO_EXCEPTION_TRACE every exception
+ * entry and exit, and with SWO_TRACE_EVENTS (needs TRACE_ENABLE) every trace
+ * probe as a word on ITM port SWO_TRACE_PORT, all stamped with ITM local
+ * timestamps in core cycles. The probe sets the SWO rate when it starts the
+ * capture (NRZ, formatter off); swo_profile.ps1 folds the PC samples taken
+ * inside the inferences into a flame graph and reports the time spent in
+ * each handler. A sample is 5 bytes: 16384 cycles at 800 MHz is about
+ * 2.4 Mbit/s before the exception trace */
+#define SWO_PROFILER 0
+#define SWO_PC_SAMPLE_CYCLES 16384
+#define SWO_EXCEPTION_TRACE 1
+#define SWO_TRACE_EVENTS 1
+#define SWO_TRACE_PORT 1
+
+/* Statistical profiler without a debugger (needs TELEMETRY): TIM2
+ * interrupts PC_PROFILER_HZ times a second, above every other interrupt,
+ * and counts the PC and LR of the exception frame in two histograms of
+ * PC_PROFILER_BUCKETS buckets over the application code (.isr_vector to
+ * _etext, the ITCM code at its load image; the XIPROM code of
+ * APP_SPLIT_XIP counts as outside). The period
+ * is dithered so the samples do not lock onto the frame or tick rates. A
+ * 'P' byte from the host (telemetry.ps1 $PcProfile) has the UI thread send
+ * the non-zero buckets, at most PC_PROFILER_DUMP_RECORDS records per wake,
+ * sampling paused meanwhile; each dump covers the time since the previous
+ * one, and telemetry.ps1 symbolizes it from the ELF. A sample is a few
+ * dozen cycles: cheap enough for release builds. Code running with
+ * interrupts masked is charged to the instruction unmasking them */
+#define PC_PROFILER 1
+#define PC_PROFILER_HZ 2000
+#define PC_PROFILER_BUCKETS 4096
+#define PC_PROFILER_DUMP_RECORDS 16
+
+/* Memory map and bandwidth budget (needs TELEMETRY): an 'M' byte from the
+ * host (telemetry.ps1 $MemMap) has the UI thread print every region (the
+ * linker reservations and NPU pools, the weights of each network, the
+ * buffer registry, the thread stacks with their high-water marks and the
+ * byte pools) with its owner, size and the cacheability the MPU gives it,
+ * then the bytes per camera frame and KB/s each consumer moved since the
+ * previous report: DCMIPP writes from the pipe counters, LTDC reads from the
+ * layer registers, NPU reads and writes per pool from the tensor geometry
+ * with the stall share (NPU_BW_REPORT), and the CPU output copy and decode.
+ * At most MEM_MAP_REPORT_LINES lines per wake, so the text records fit the
+ * ring */
+#define MEM_MAP_REPORT 1
+#define MEM_MAP_REPORT_LINES 8
+
+/* Telemetry preview (needs TELEMETRY and the Pipe1 display ring): every
+ * PREVIEW_PERIOD_MS the UI thread borrows the shown camera frame and box
+ * filters it down to a PREVIEW_WIDTH x PREVIEW_HEIGHT luma thumbnail of
+ * PREVIEW_BITS bits (4 or 8), one row of tiles per wake. Tiles are 8 pixels
+ * wide and 32 bytes; only those whose levels moved by more than
+ * PREVIEW_TILE_SAD in sum against the copy the host holds are sent, XORed
+ * over that copy and PackBits coded, several per TELEMETRY_TYPE_PREVIEW
+ * record, within PREVIEW_BUDGET_BPS bytes a second on the link. Each
+ * thumbnail also resends PREVIEW_REFRESH_TILES tiles whole in turn, so
+ * dropped records and late hosts heal; a 'K' byte from the host
+ * (telemetry.ps1 $PreviewFile) has the next one sent whole. A static scene
+ * costs the refresh tiles only */
+#define PREVIEW_ENABLE 1
+#define PREVIEW_WIDTH 160
+#define PREVIEW_HEIGHT 120
+#define PREVIEW_BITS 4
+#define PREVIEW_PERIOD_MS 1000
+#define PREVIEW_TILE_SAD 24      /* Sum of absolute level changes over a tile */
+#define PREVIEW_BUDGET_BPS 4096  /* Record bytes a second, headers included */
+#define PREVIEW_REFRESH_TILES 4
+
+/* Interrupt handler profile (needs TELEMETRY): the DCMIPP, CSI, LTDC and
+ * NPU handlers are bracketed with DWT cycle stamps and counted per handler:
+ * entries, longest run, self time and a log2 histogram of it (time spent in
+ * the other bracketed handlers nested over it taken out), how often it was
+ * preempted or preempted another one, and the deepest nesting. The LTDC
+ * line event also has its entry latency, from the scanout position at entry
+ * against the programmed line; the other sources have no hardware stamp of
+ * the request. The NPU vector lives in the AI runtime: the vector table is
+ * copied to RAM with the NPU entry sent through a bracketing wrapper. One
+ * isrprof_record_t (app_isrprof.h) per handler, every UI stats period */
+#define ISR_PROFILER 0
+
+/* Runtime parameters (needs TELEMETRY): the settings worth tuning on a
+ * running unit, in a typed table (app_params.h) starting from the values in
+ * this file: sensor frame rate, post-processing thresholds, the waiting
+ * frames before DISPLAY_POLICY_SYNC_NN falls back to a fixed delay and the
+ * pipeline thread priorities. The host sets them with framed commands on
+ * the telemetry RX line or the USB CDC port (telemetry.ps1 $SetParams) and
+ * reads each one back. Each applies at its own boundary: the thresholds at
+ * the next post-processing run, the display depth at the next frame, the
+ * frame rate and the priorities between two inferences. Sizes fixed by the
+ * network or the buffers (ML_WIDTH, DISPLAY_BUFFER_NB) stay compile-time.
+ * With PARAMS_FLASH a 'W' from the host stores the table in the octoFlash
+ * at PARAMS_FLASH_OFFSET, two alternating 4 KB copies, for the next boots:
+ * written by the inference thread between two inferences, the flash out of
+ * memory-mapped mode for the erase (25 ms typical, one frame late), so not
+ * with cmake -DAPP_SPLIT_XIP=ON */
+#define PARAMS_ENABLE 1
+#define PARAMS_FLASH 1
+#define PARAMS_FLASH_OFFSET 0x000E0000U /* 64 KB block below the slot table, past the FSBL */
+
+/* Console shell (needs TELEMETRY): a '>' byte on the telemetry RX line or
+ * the USB CDC port starts a command line, ended by CR or LF; the interrupt
+ * only queues it, and a thread just above the background jobs takes at
+ * most one every SHELL_PERIOD_MS and prints its answer as text records, at
+ * most SHELL_LINES_PER_WAKE lines a period, so the pipeline it observes and
+ * the telemetry ring are not perturbed. Commands: stats (inference rate,
+ * inference and post-processing time, detections, CPU load since the
+ * previous stats), epochs (the slowest epochs of the last profiler window,
+ * NN_EPOCH_PROFILER), mem (ThreadX byte and block pools), set [name value]
+ * (the runtime parameters by name: thresholds, frame rate, power profile;
+ * PARAMS_ENABLE) and help. telemetry.ps1 $Shell forwards the typed lines */
+#define SHELL_ENABLE 0
+#define SHELL_PERIOD_MS 50
+#define SHELL_LINES_PER_WAKE 4
+#define SHELL_QUEUE_LINES 4 /* Command lines waiting, a power of two */
+#define SHELL_EPOCHS_TOP 16
+
+/* Overlay fonts from the octoFlash asset pack: Font16 and Font12 are not
+ * linked; their LZ4 blocks (assets.ps1, flashed with flash.ps1 $AssetPack)
+ * are decompressed into the overlay glyph atlases the first time the font
+ * is drawn, read in place under a lock Params_Store also takes. Fail-fast:
+ * the pack must be flashed */
+#define ASSET_PACK_ENABLE 0
+#define ASSET_PACK_FLASH_ADDR 0x71F00000U /* Last MB below model slot B */
+#define ASSET_PACK_SIZE (1024U * 1024U)
+
+/* Telemetry over Ethernet (needs TELEMETRY): the same records, detections
+ * and system stats included, published as UDP datagrams of up to
+ * ETH_PUBLISH_BATCH records behind a unit header, so a site controller
+ * gathers many units on one network. Zero copy: the MAC DMA reads the
+ * records in the telemetry ring in place, after a per-datagram header, and
+ * inserts the IPv4 and UDP checksums. A minimal IPv4 layer (static or
+ * link-local address, ARP) stands in for a full stack; nothing else is
+ * answered. The ring waits for the Ethernet reader only while a link is up
+ * and the destination resolved. ETH_PUBLISH_LOCAL_IP 0.0.0.0: 169.254.x.y
+ * from the device UID; ETH_PUBLISH_DEST_IP 255.255.255.255: segment
+ * broadcast, no ARP */
+#define ETH_PUBLISH 1
+#define ETH_PUBLISH_LOCAL_IP {0, 0, 0, 0}
+#define ETH_PUBLISH_DEST_IP {255, 255, 255, 255}
+#define ETH_PUBLISH_PORT 47300        /* UDP, source and destination */
+#define ETH_PUBLISH_BATCH 16          /* Records per datagram: 1078-byte frames */
+#define ETH_PUBLISH_FLUSH_MS 20       /* Largest wait of a ready record */
+
+/* USB composite device on USB1 (cmake -DUSB_STREAM=ON, needs VENC_ENABLE and
+ * TELEMETRY): a UVC camera carrying the encoded annotated stream (H.264,
+ * frame-based payload) on a high-speed isochronous endpoint, and a CDC-ACM
+ * port carrying the telemetry records, unencoded, while the host holds DTR.
+ * Zero copy: the OTG DMA reads the access units and the records in their
+ * rings; each isochronous packet has its payload header written in place
+ * over the bytes the previous packet sent. Excludes ISP_TUNING (same port) */
+#ifndef USB_STREAM_ENABLE
+#define USB_STREAM_ENABLE 0
+#endif
+#define USB_UVC_PACKET_SIZE 1024 /* Per microframe, header included: 8 MB/s */
+#define USB_CDC_BATCH 16         /* Records per bulk transfer */
+#define USB_POLL_MS 5            /* Largest wait of a ready record or access unit */
+
+/* Append-only telemetry log on the microSD card (needs TELEMETRY): every
+ * record, for soak tests that keep each frame's timings. A low-priority
+ * thread copies the records into two segments of SD_LOG_SEGMENT_SIZE in
+ * turn; one fills while the SDMMC IDMA writes the other, aligned, in one
+ * multi-block command, so the pipeline never waits on the card. After each
+ * segment an index block is committed, alternating between two copies
+ * with a check word: a reset mid-write loses at most the segment in
+ * flight. An open segment is written after SD_LOG_COMMIT_MS partial.
+ * The card is used raw from SD_LOG_FIRST_BLOCK on: whatever file system it
+ * held there is overwritten, and the log wraps when the card is full.
+ * telemetry.ps1 decodes an image of the card */
+#define SD_LOG 0
+#define SD_LOG_FIRST_BLOCK 2048      /* 1 MiB in: keeps the partition table */
+#define SD_LOG_SEGMENT_SIZE 65536    /* Bytes per write, header record included */
+#define SD_LOG_COMMIT_MS 10000       /* Largest age of an unwritten record */
+#define SD_LOG_POLL_MS 20            /* Records copied out of the ring this often */
+
+/* Retraining dataset on the microSD card (app_dataset.h): while the
+ * pipeline runs at its rate, the Pipe2 frame of one inference in
+ * DATASET_EVERY, as the network read it, stays lent from the capture ring
+ * until post-processing has decided on it. Kept frames go to the card with
+ * their detections in network input coordinates and the ISP exposure, gain
+ * and color temperature, the frame in one multi-block IDMA write straight
+ * from the slot, the header block after it. DATASET_SAMPLE_UNCERTAIN keeps
+ * only frames holding a detection below DATASET_CONF_HIGH, the cases the
+ * model is least sure of. A frame offered while DATASET_SLOTS are lent is
+ * counted dropped, never waited for. The card is used raw from
+ * DATASET_FIRST_BLOCK on, as by SD_LOG (not built together); the records
+ * wrap when it is full. Not with ML_INPUT_ALIAS (no capture ring) */
+#define DATASET_ENABLE 0
+#define DATASET_SAMPLE_ALL 0
+#define DATASET_SAMPLE_UNCERTAIN 1
+#define DATASET_SAMPLE DATASET_SAMPLE_ALL
+#define DATASET_EVERY 1              /* Inferences per frame offered */
+#define DATASET_CONF_HIGH 0.75f      /* DATASET_SAMPLE_UNCERTAIN: confidence below which a detection is kept */
+#define DATASET_SLOTS 2              /* Capture slots lent to the writer at once */
+#define DATASET_FIRST_BLOCK 2048     /* 1 MiB in: keeps the partition table */
+#define DATASET_MAX_DETECTIONS 16    /* Per record; more are counted but not stored */
+
+/* Background jobs (BACKGROUND_ENABLE): deferrable work run by one thread
+ * below every other, in cooperative slices, only in the slack the last
+ * results predict: a slice starts when the next inference window (the
+ * capture vsync one inference period on, through its post-processing, as
+ * the last frame took) is at least BACKGROUND_SLICE_US plus
+ * BACKGROUND_GUARD_US away. Jobs: the weights of the bound model slot
+ * re-summed against their header, one BACKGROUND_VERIFY_CHUNK a slice, a
+ * pass every BACKGROUND_VERIFY_PERIOD_MS (the octoFlash reads stay off the
+ * NPU weight stream) */
+#define BACKGROUND_ENABLE 1
+#define BACKGROUND_SLICE_US 500U
+#define BACKGROUND_GUARD_US 1000U
+#define BACKGROUND_IDLE_MS 100      /* No job due: poll period */
+#define BACKGROUND_VERIFY_CHUNK 16384U
+#define BACKGROUND_VERIFY_PERIOD_MS 60000
+
+/* Weight scrubbing (needs BACKGROUND_ENABLE): the background weights job
+ * instead walks the binary of the bound model slot through the hardware
+ * CRC unit, one SCRUB_CHUNK a slice fed by an HPDMA channel at the lowest
+ * bus priority, so the flash is read as stored and not through a cache.
+ * The first pass builds the per-chunk CRC table and seals it when the
+ * software sum of the same pass matches the slot header; each later pass
+ * compares every chunk against it and reports a mismatch, with the chunk
+ * address, as a health event (a flip is reported, not repaired). A pass
+ * every BACKGROUND_VERIFY_PERIOD_MS */
+#define SCRUB_ENABLE 1
+#define SCRUB_CHUNK 16384U          /* Multiple of 4, at most 65532 (one DMA block) */
+#define SCRUB_DMA_TIMEOUT_MS 50
+
+/* Frame counters per DCMIPP pipe (frames, overruns, limit events, late
+ * buffer swaps), Pipe2 frames inferred or overwritten unread and display
+ * drops, per UI stats period; optionally streamed after the thread profile
+ * (FRAME_STATS_UART needs THREAD_PROFILER_UART, which opens the port) */
+#define FRAME_STATS 1
+#define FRAME_STATS_UART 1
+
+/* LTDC FIFO underrun and AXI transfer error counters: the interrupts are
+ * re-armed once per frame, so a frame counts once however many lines
+ * starved. Each event is stamped with the NPU epoch in progress (needs
+ * NN_EPOCH_PROFILER, else unknown) and the DCMIPP pipes capturing; reported
+ * with the frame counters (FRAME_STATS) */
+#define LCD_ERROR_MONITOR 1
+
+/* Boot time from FSBL entry to the first camera frame on screen and the
+ * first published inference, split into the FSBL and App_Init() phases
+ * (the FSBL always marks its phases into the shared record); printed once
+ * with BOOT_PROFILER_UART (needs THREAD_PROFILER_UART, which opens the port) */
+#define BOOT_PROFILER 1
+#define BOOT_PROFILER_UART 1
+
+/* Crash and performance record in the 8 KB backup SRAM, which keeps its
+ * content over every reset short of a power loss without VBAT: a ring of
+ * the last CRASH_LOG_ENTRIES panics (APP_REQUIRE location, or the fault and
+ * CFSR for an Error_Handler() without one) and a rolling snapshot of the
+ * inference rate and latency, CPU load, lowest stack headroom (needs
+ * THREAD_PROFILER), NPU stream engine cycles per memory pool (needs
+ * NPU_BW_REPORT) and stage recoveries (needs HEALTH_MONITOR), refreshed
+ * every stats period. An IWDG reset logs the last snapshot as its own
+ * entry. Entries from earlier boots are printed once with CRASH_LOG_UART
+ * (needs THREAD_PROFILER_UART, which opens the port) */
+#define CRASH_LOG 1
+#define CRASH_LOG_ENTRIES 8
+#define CRASH_LOG_UART 1
+
+/* External memory self-test at boot, before any buffer is used: sequential
+ * read and write throughput and dependent random read latency of the xSPI1
+ * PSRAM and the xSPI2 octoFlash, through the D-cache and with the cache
+ * bypassed (a temporary non-cacheable MPU region), next to the interface
+ * settings (kernel clock, prescaler, DTR, DQS, prefetch). The PSRAM window
+ * is written: it is a boot-only area of its own, outside the MPU regions;
+ * the octoFlash window is the weights, read only. Printed
+ * once with MEM_BENCH_UART (needs THREAD_PROFILER_UART, which opens the port),
+ * flagged when a cached sequential read falls below its minimum */
+#define MEM_BENCH 1
+#define MEM_BENCH_UART 1
+#define MEM_BENCH_FLASH_ADDR 0x71000000U
+#define MEM_BENCH_SEQ_BYTES (256U * 1024U)   /* Four times the D-cache */
+#define MEM_BENCH_RAND_WINDOW (1024U * 1024U) /* Power of two */
+#define MEM_BENCH_RAND_READS 4096U
+#define MEM_BENCH_PSRAM_MIN_KBS 200000U /* Cached sequential read, KB/s */
+#define MEM_BENCH_FLASH_MIN_KBS 100000U
+
+/* Pipeline health monitor: a supervisor thread restarts only the stage that
+ * stalled, in milliseconds, instead of a full reset through the FSBL. A
+ * pipe that delivers no frame for HEALTH_PIPE_TIMEOUT_MS (Pipe2 only while
+ * the inference thread waits for one) is stopped and restarted on its ring,
+ * keeping the sensor, CSI and ISP setup. An NPU epoch block that does not
+ * signal within HEALTH_NPU_TIMEOUT_MS resets the NPU and re-initializes the
+ * runtime and the active network in place; that frame is dropped. More than
+ * HEALTH_MAX_RECOVERIES in HEALTH_RECOVERY_WINDOW_MS panics. With HEALTH_IWDG
+ * the IWDG, fed by the supervisor while no stage is hung, resets the board
+ * when a recovery itself hangs or after a panic. The timeouts must cover a
+ * few frame periods at the lowest frame rate and the longest epoch block */
+#define HEALTH_MONITOR 1
+#define HEALTH_PERIOD_MS 20
+#define HEALTH_PIPE_TIMEOUT_MS 500
+#define HEALTH_NPU_TIMEOUT_MS 200
+#define HEALTH_MAX_RECOVERIES 5
+#define HEALTH_RECOVERY_WINDOW_MS 10000
+#define HEALTH_IWDG 1
+#define HEALTH_IWDG_TIMEOUT_MS 2000 /* At most 4095 (LSI / 32) */
+
+/* Thread priority plan (ThreadX, 0 most urgent), in deadline order: the
+ * supervisor, the camera bring-up (each sensor delay ahead of the NPU
+ * bring-up), the ISP (its statistics are stale a frame later; with
+ * ISP_SPLIT_APPLY the register apply only), inference (keeps the NPU fed,
+ * sleeps over each epoch block), post-processing (runs while inference
+ * waits on the NPU), the bring-up that creates them and the ISP analysis,
+ * the recorder and the engine lanes of its job pipeline (app_jobs.h), then the
+ * UI overlay, due by the next result. The capture hand-off, the DMA2D
+ * overlay and the telemetry DMA run in interrupts, not threads. Below the
+ * UI: snapshots, the USB and ISP tuning links (never built together), the
+ * Ethernet publisher, the microSD log or dataset writer and the console
+ * shell and, just above idle, the background jobs */
+#define HEALTH_THREAD_PRIORITY 3
+#define CAM_INIT_THREAD_PRIORITY 4
+#define ISP_THREAD_PRIORITY 5
+#define NN_THREAD_PRIORITY 6
+#define PP_THREAD_PRIORITY 7
+#define APP_INIT_THREAD_PRIORITY 8
+#define ISP_ANALYZE_THREAD_PRIORITY 8 /* ISP_SPLIT_APPLY */
+#define VENC_THREAD_PRIORITY 9
+#define JOBS_LANE_PRIORITY 9
+#define UI_THREAD_PRIORITY 10
+#define SNAPSHOT_THREAD_PRIORITY 11
+#define USB_THREAD_PRIORITY 12
+#define ISP_TOOL_THREAD_PRIORITY 12
+#define ETH_THREAD_PRIORITY 13
+#define SDLOG_THREAD_PRIORITY 14
+#define DATASET_THREAD_PRIORITY 14
+#define SHELL_THREAD_PRIORITY 14
+#define BACKGROUND_THREAD_PRIORITY 15
+/* Post-processing to overlay hand-off (publish, tracker, display sync frame,
+ * UI event) runs at this preemption threshold: the inference thread cannot
+ * split it, the ISP and the supervisor still can */
+#define PP_HANDOFF_THRESHOLD NN_THREAD_PRIORITY
+/* Worst-case CPU time per activation. Once the camera has picked its rate, a
+ * response-time analysis of the ISP (every frame), inference and
+ * post-processing (every NN_FRAME_DECIMATION frames) and the UI (every
+ * result) at the priorities above must meet each deadline, the next
+ * activation; inference also waits SCHED_NPU_BUDGET_US on the NPU.
+ * Priorities moved at runtime (Params prio.*) are not re-checked */
+#define SCHED_ISP_BUDGET_US 2000U
+#define SCHED_ISP_APPLY_BUDGET_US 300U /* ISP_SPLIT_APPLY: the analysis takes SCHED_ISP_BUDGET_US */
+#define SCHED_NN_BUDGET_US 3000U
+#define SCHED_NPU_BUDGET_US 20000U
+#define SCHED_PP_BUDGET_US 6000U
+#define SCHED_UI_BUDGET_US 6000U
+
+/* Interrupt priority plan (NVIC, 4 bits, 0 most urgent; ThreadX masks with
+ * PRIMASK, any level may call it). The PC sampler sees every handler; the
+ * NPU epoch interrupt comes next, so an epoch block is chained without
+ * waiting on the capture or display handlers; then the camera (DCMIPP
+ * frame and vsync, CSI) and the LTDC line and reload events, at one level
+ * so the camera ring is never updated from both at once. The DMA2D overlay,
+ * the weight prefetch and the USB device follow, then the sensor command
+ * I2C, the encoder, the JPEG snapshots, the Ethernet and telemetry links,
+ * the weight scrubbing DMA and the TIM5 timebase (TICK_INT_PRIORITY, stm32n6xx_hal_conf.h) last. State shared with the
+ * camera or display handlers is guarded with Irq_Lock() (app_irq.h) at
+ * their level, which masks them and everything below while the NPU and
+ * the sampler keep running. Checked once the pipeline is up */
+#define PCPROF_IRQ_PRIORITY 0x01
+#define NPU_IRQ_PRIORITY 0x04
+#define CAM_IRQ_PRIORITY 0x07
+#define LCD_IRQ_PRIORITY 0x07
+#define OVERLAY_IRQ_PRIORITY 0x0A
+#define PREFETCH_IRQ_PRIORITY 0x0A
+#define USB_IRQ_PRIORITY 0x0A
+#define SENSOR_CMD_IRQ_PRIORITY 0x0B
+#define VENC_IRQ_PRIORITY 0x0C
+#define SNAPSHOT_IRQ_PRIORITY 0x0D
+#define ETH_IRQ_PRIORITY 0x0E
+#define TELEMETRY_IRQ_PRIORITY 0x0E
+#define SCRUB_IRQ_PRIORITY 0x0E
+
+/* Post-processing benchmark image (Firmware_PPBench target, which sets
+ * PP_BENCH=1): instead of the camera pipeline, the object detection post
+ * processors replay the scenes recorded at PPBENCH_SCENES_FLASH_ADDR, or
+ * synthetic empty/sparse/crowded scenes when none are flashed, and print DWT
+ * cycles per stage, peak stack and scratch use on the ST-LINK virtual COM port,
+ * then sweep synthetic scenes up to max_boxes_limit objects, drawing the boxes
+ * kept with the DMA2D overlay */
+#ifndef PP_BENCH
+#define PP_BENCH 0
+#endif
+#define PPBENCH_SCENES_FLASH_ADDR 0x71C00000U /* After the relocatable network */
+#define PPBENCH_ITERATIONS 16
+/* Sweep deadline: worst post-processing plus overlay time of a frame with
+ * up to max_boxes_limit detections, what the frame period leaves after the
+ * inference */
+#define PPBENCH_DEADLINE_US 8000U
+
+/* Inference benchmark image (Firmware_Bench target, which sets NN_BENCH=1):
+ * instead of the camera pipeline, od_yolo_x_person runs on a fixed
+ * pseudo-random input, one cold inference (caches invalidated, network
+ * re-initialized) then NNBENCH_ITERATIONS warm ones per variant: NPU cache
+ * on, NPU cache off, and weights read in place when WEIGHT_PREFETCH_ENABLE
+ * stages them. DWT cycles per inference and per epoch, and the NPU cache
+ * hit rate, go to the ST-LINK virtual COM port as key=value lines */
+#ifndef NN_BENCH
+#define NN_BENCH 0
+#endif
+#define NNBENCH_ITERATIONS 16
+/* Activation placement experiment (Firmware_Bench): after the variants, the
+ * cache variant runs again for every combination of the AXISRAM banks in
+ * NNBENCH_POOL_MOVES (bit n: AXISRAMn) moved to a hyperRAM mirror of
+ * AXISRAM2-6, the stream engine tensors of a moved bank rebased on it. A
+ * layout counts when its outputs match the generated layout bit for bit (SW
+ * epochs still use the banks in place) and no tensor crosses into a kept
+ * bank; the fastest freeing at least NNBENCH_POOL_FREE_MIN bytes of AXISRAM
+ * is reported, for this board and clocks, as the pools to try to generate.
+ * Off with NN_EPOCH_CONTROLLER: the blob epochs set their own engines up */
+#define NNBENCH_POOL_MOVES 0x7CU /* AXISRAM2-6; 0: off */
+#define NNBENCH_POOL_FREE_MIN (512U * 1024U)
+#define NPU_PLACE_EXPERIMENT (NN_BENCH && !NN_EPOCH_CONTROLLER && NNBENCH_POOL_MOVES != 0U)
+
+/* End-to-end pipeline benchmark image (Firmware_PipeBench target, which sets
+ * PIPE_BENCH=1): the sensor streams its test pattern PIPE_BENCH_PATTERN
+ * (IMX335 TPG register value) through the full capture, inference,
+ * post-processing and overlay pipeline, the motion gate passing every frame.
+ * Every UI stats period: sustained result and pipe rates, p50/p99/max of each
+ * latency stage over the newest PIPE_BENCH_WINDOW results, CPU load and the
+ * NPU stream engine cycles per memory pool, as key=value lines on the ST-LINK
+ * virtual COM port. Needs LATENCY_PROFILER, FRAME_STATS, NPU_BW_REPORT and
+ * THREAD_PROFILER_UART */
+#ifndef PIPE_BENCH
+#define PIPE_BENCH 0
+#endif
+#define PIPE_BENCH_PATTERN 10 /* Color bars */
+#define PIPE_BENCH_WINDOW 512
+
+/* Bottom-left overlay panel: UI_BOTTOM_PANEL_EPOCHS needs NN_EPOCH_PROFILER,
+ * UI_BOTTOM_PANEL_LATENCY needs LATENCY_PROFILER, UI_BOTTOM_PANEL_THREADS
+ * needs THREAD_PROFILER, UI_BOTTOM_PANEL_BANDWIDTH needs NPU_BW_REPORT,
+ * UI_BOTTOM_PANEL_FRAMES needs FRAME_STATS. UI_BOTTOM_PANEL_THUMBS shows
+ * crops of the newest tracks, cut by the DMA2D from the frame on screen
+ * when the track IDs change; it needs TRACKER_ENABLE and the Pipe1 display
+ * ring (no DISPLAY_SINGLE_PIPE). UI_BOTTOM_PANEL_GRAPHS scrolls one sample
+ * per stats period of the inference rate, NPU, post-processing and
+ * capture-to-scanout times and hyperRAM traffic: the DMA2D shifts the
+ * history, only the new column is drawn. It needs LATENCY_PROFILER and
+ * NPU_BW_REPORT; samples above the full scale are clipped, drawn red */
+#define UI_BOTTOM_PANEL_NONE 0
+#define UI_BOTTOM_PANEL_EPOCHS 1
+#define UI_BOTTOM_PANEL_LATENCY 2
+#define UI_BOTTOM_PANEL_THREADS 3
+#define UI_BOTTOM_PANEL_BANDWIDTH 4
+#define UI_BOTTOM_PANEL_FRAMES 5
+#define UI_BOTTOM_PANEL_THUMBS 6
+#define UI_BOTTOM_PANEL_GRAPHS 7
+#define UI_BOTTOM_PANEL UI_BOTTOM_PANEL_LATENCY
+#define UI_GRAPH_FPS_MAX CAMERA_FPS
+#define UI_GRAPH_NPU_MAX_MS 50
+#define UI_GRAPH_PP_MAX_MS 10
+#define UI_GRAPH_E2E_MAX_MS 150
+#define UI_GRAPH_PSRAM_MAX_MBPS 400
+
+/* Post-processing configuration for od_yolo_x_person. The float or int8
+ * ST YOLOX post-processor is picked at runtime from each network's output
+ * tensor type (app_postprocess_od_st_yolox_select()) */
+#define AI_OD_ST_YOLOX_PP_NB_CLASSES 1
+#define AI_OD_ST_YOLOX_PP_NB_ANCHORS 3
+#define AI_OD_ST_YOLOX_PP_L_GRID_WIDTH 60
+#define AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT 60
+#define AI_OD_ST_YOLOX_PP_M_GRID_WIDTH 30
+#define AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT 30
+#define AI_OD_ST_YOLOX_PP_S_GRID_WIDTH 15
+#define AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT 15
+static const float AI_OD_ST_YOLOX_PP_L_ANCHORS[2 * AI_OD_ST_YOLOX_PP_NB_ANCHORS] = {30.0f, 30.0f, 4.2f, 15.0f, 13.8f, 42.0f};
+static const float AI_OD_ST_YOLOX_PP_M_ANCHORS[2 * AI_OD_ST_YOLOX_PP_NB_ANCHORS] = {15.0f, 15.0f, 2.1f, 7.5f, 6.9f, 21.0f};
+static const float AI_OD_ST_YOLOX_PP_S_ANCHORS[2 * AI_OD_ST_YOLOX_PP_NB_ANCHORS] = {7.5f, 7.5f, 1.05f, 3.75f, 3.45f, 10.5f};
+#define AI_OD_ST_YOLOX_PP_IOU_THRESHOLD 0.5f
+#define AI_OD_ST_YOLOX_PP_CONF_THRESHOLD 0.6f
+#define AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT 100
+/* Candidates kept ahead of NMS: a min-heap on confidence keeps the strongest
+ * ones, so a crowded frame costs NMS at most this many and the scratch arena
+ * shrinks to it. One heap for every class while NMS keeps the box limit per
+ * class: sized per class. The boxes match the unbounded store's only while
+ * at most this many cells pass the threshold; under NB_CLASSES x the box
+ * limit, a class can lose boxes NMS would keep. 0 keeps every cell above
+ * threshold */
+#define AI_OD_ST_YOLOX_PP_MAX_CANDIDATES (4 * AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT * AI_OD_ST_YOLOX_PP_NB_CLASSES)
+
+/* Decode exclusion: ML frame areas the detector never reports from (a
+ * ceiling, a window, a screen), as {x0, y0, x1, y1} fractions of the ML
+ * frame. The decode skips the grid cells of every level whose centre lies in
+ * one, before it reads their scores. Needs NN_TILING_CENTER: tiles and
+ * windows move over the scene */
+#define PP_EXCLUDE_ENABLE 0
+#define PP_EXCLUDE_RECTS {{0.0f, 0.0f, 1.0f, 0.2f}}
+
+/* Adaptive score threshold: each run decodes at the threshold the one before
+ * left. Over PP_CONF_ADAPT_BUDGET candidates ahead of NMS it rises by
+ * PP_CONF_ADAPT_STEP_UP, under half the budget it falls by
+ * PP_CONF_ADAPT_STEP_DOWN, between pp.conf less PP_CONF_ADAPT_RECALL and
+ * PP_CONF_ADAPT_MAX: quiet scenes gain recall, crowded ones bound NMS. In
+ * 1/255 steps, the unit telemetry reports it in. 0 decodes at pp.conf */
+#define PP_CONF_ADAPT_ENABLE 1
+#define PP_CONF_ADAPT_BUDGET 64   /* Below AI_OD_ST_YOLOX_PP_MAX_CANDIDATES, where the count saturates */
+#define PP_CONF_ADAPT_STEP_UP 8   /* Fast up: one crowded frame costs a few runs */
+#define PP_CONF_ADAPT_STEP_DOWN 1 /* Slow down: no hunting around the budget */
+#define PP_CONF_ADAPT_RECALL 25   /* Lowest threshold under pp.conf (~0.1) */
+#define PP_CONF_ADAPT_MAX 242     /* Highest threshold (~0.95), or pp.conf above it */
 
 #endif
@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ * @file    app_crashlog.h
+ * @author  Long Liangmao
+ * @brief   Crash and performance record kept over resets for STM32N6570-DK
+ *          Ring of the last panics and a rolling performance snapshot in the
+ *          backup SRAM, reported at the next boot (CRASH_LOG)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_CRASHLOG_H
+#define APP_CRASHLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if CRASH_LOG
+
+#define CRASHLOG_CAUSE_PANIC 1U    /* APP_REQUIRE() or assert_failed(): file and line */
+#define CRASHLOG_CAUSE_ERROR 2U    /* Error_Handler() from thread code, no location */
+#define CRASHLOG_CAUSE_FAULT 3U    /* Error_Handler() from an exception: line holds its number */
+#define CRASHLOG_CAUSE_WATCHDOG 4U /* IWDG reset with no panic logged before it */
+
+#define CRASHLOG_FILE_LEN 24U
+#define CRASHLOG_THREAD_LEN 16U
+#define CRASHLOG_POOL_NB 3U /* AXISRAM, PSRAM and flash (NPU_BW_POOL_ order) */
+
+/**
+ * @brief  Rolling performance snapshot, as of the last stats period
+ */
+typedef struct {
+  uint32_t uptime_ms;
+  uint32_t fps_tenths;      /* Inference rate, x10 */
+  uint32_t inference_us;
+  uint32_t cpu_load_pct;
+  uint32_t stack_free;      /* Lowest headroom in bytes over the threads (0: unknown) */
+  char stack_thread[CRASHLOG_THREAD_LEN];
+  uint32_t npu_block_cycles; /* Epoch blocks of the last inference, NPU clock */
+  uint32_t npu_active[CRASHLOG_POOL_NB]; /* Stream engine cycles moving data, per pool */
+  uint32_t npu_stall[CRASHLOG_POOL_NB];  /* Stream engine cycles stalled, per pool */
+  uint32_t recoveries;      /* Stages restarted since boot */
+} crashlog_perf_t;
+
+/**
+ * @brief  One logged crash
+ */
+typedef struct {
+  uint32_t boot;  /* Boot number the crash ended */
+  uint32_t cause; /* CRASHLOG_CAUSE_ */
+  uint32_t line;
+  uint32_t cfsr;  /* Configurable fault status at the time */
+  char file[CRASHLOG_FILE_LEN]; /* Base name of the source file, truncated */
+  crashlog_perf_t perf;
+  uint32_t checksum;
+} crashlog_entry_t;
+
+/**
+ * @brief  Open the record: validate or clear it, log an IWDG reset, count
+ *         this boot
+ * @note   Called from App_Init(), before the reset flags are cleared
+ */
+void CrashLog_Init(void);
+
+/**
+ * @brief  Log a crash with the last snapshot
+ * @param  file: APP_Panic() location, NULL when unknown
+ * @param  line: Line in file
+ * @note   Called from Error_Handler() with interrupts off; a no-op before
+ *         CrashLog_Init() and on a nested call
+ */
+void CrashLog_RecordPanic(const char *file, uint32_t line);
+
+/**
+ * @brief  Refresh the snapshot and, the first time, print the entries of
+ *         earlier boots (CRASH_LOG_UART)
+ * @param  inference_us: Last inference latency
+ * @param  frame_period_us: Last inference period
+ * @param  cpu_load_pct: CPU load over the stats period
+ * @note   Call periodically from a single thread (UI stats period)
+ */
+void CrashLog_Update(uint32_t inference_us, uint32_t frame_period_us, uint32_t cpu_load_pct);
+
+#endif /* CRASH_LOG */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_CRASHLOG_H */
@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file    app_dataset.h
+ * @author  Long Liangmao
+ * @brief   Retraining dataset capture for STM32N6570-DK (DATASET_ENABLE):
+ *          sampled Pipe2 frames, their detections and ISP state written
+ *          raw to the microSD card while the pipeline runs
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_DATASET_H
+#define APP_DATASET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if DATASET_ENABLE
+
+#include "od_pp_output_if.h"
+
+/* On the card, 512-byte blocks from DATASET_FIRST_BLOCK on: two copies of
+ * the index in the first two blocks, then, from the next record boundary,
+ * the records. Record n is at slot n % capacity: the frame as Pipe2 wrote
+ * it (ML_PITCH bytes per line), then its header block; a record slot is a
+ * whole number of 64 KB. Check words are FNV-1a. Little endian, no padding */
+#define DATASET_BLOCK_SIZE 512U
+#define DATASET_ALIGN_BLOCKS 128U /* 64 KB: record slots start on an erase-friendly boundary */
+#define DATASET_INDEX_MAGIC 0x4944364EU  /* "N6DI" */
+#define DATASET_RECORD_MAGIC 0x5244364EU /* "N6DR" */
+#define DATASET_VERSION 1U
+
+/* Index copy: the valid one with the highest generation is the dataset */
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_blocks; /* Blocks per record slot */
+  uint32_t generation;    /* One per commit, copy generation % 2 */
+  uint32_t records;       /* Records committed since the dataset was created */
+  uint32_t capacity;      /* Record slots on the card */
+  uint32_t boots;         /* Boots that appended to the dataset */
+  uint32_t first_block;   /* Block of index copy 0 */
+  uint32_t check;         /* Of the bytes above */
+} dataset_index_t;
+
+/* Detection in network input coordinates, normalized to the frame */
+typedef struct __attribute__((packed)) {
+  float x_center;
+  float y_center;
+  float width;
+  float height;
+  float conf;
+  int32_t class_index;
+} dataset_detection_t;
+
+/* Header block, written after the frame: a valid one has its frame whole */
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t nb;             /* Detections stored */
+  uint32_t seq;            /* Record number: slot seq % capacity */
+  uint32_t boot;           /* Index boots of the writer */
+  uint32_t frame_id;       /* Sensor frame sequence number */
+  uint32_t uptime_ms;      /* When the inference took the frame */
+  uint16_t width;          /* Pixels */
+  uint16_t height;
+  uint16_t pitch;          /* Bytes per line on the card */
+  uint8_t format;          /* buffer_format_t */
+  uint8_t reserved0;
+  uint32_t frame_blocks;   /* Blocks of the frame, before this one */
+  uint32_t exposure_us;    /* ISP state of the frame (ISP_MetaTypeDef) */
+  uint32_t gain_mdb;
+  uint32_t color_temp;     /* K, AWB reference */
+  uint8_t average_luma;
+  uint8_t luma_target;
+  uint16_t detected;       /* Detections of the frame, stored or not */
+  float conf_threshold;    /* Post-processing threshold of the detections */
+  uint32_t dropped;        /* Frames offered and dropped since boot: writer busy */
+  dataset_detection_t det[DATASET_MAX_DETECTIONS];
+  uint8_t reserved[DATASET_BLOCK_SIZE - 60U - DATASET_MAX_DETECTIONS * sizeof(dataset_detection_t) - 4U];
+  uint32_t check;          /* Of the bytes above */
+} dataset_header_t;
+
+_Static_assert(sizeof(dataset_header_t) == DATASET_BLOCK_SIZE, "Record header takes one block");
+
+/**
+ * @brief  Capture counters since boot
+ */
+typedef struct {
+  uint32_t offered;      /* Frames lent by the inference thread */
+  uint32_t dropped;      /* Frames not lent: every dataset slot busy */
+  uint32_t skipped;      /* Lent frames the sampling policy did not keep */
+  uint32_t written;      /* Records written and committed */
+  uint32_t errors;       /* Card writes failed: their record is lost */
+  uint32_t max_write_ms; /* Longest record and index write */
+} dataset_stats_t;
+
+/**
+ * @brief  Start the writer thread; it opens the card and its dataset
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   No card, or one the dataset cannot use, is not an error: no
+ *         frame is offered
+ */
+void Thread_Dataset_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Offer the Pipe2 frame of an inference, one in DATASET_EVERY
+ * @param  nn_slot: NN output slot the inference fills
+ * @param  capture_idx: ML capture slot the inference reads, still held
+ * @note   Inference thread, before Buffer_MLCapture_Release(). Never
+ *         waits: a frame offered while every dataset slot is busy is
+ *         counted dropped
+ */
+void Dataset_Offer(uint32_t nn_slot, int capture_idx);
+
+/**
+ * @brief  Keep or give back the frame offered with an NN output slot, by
+ *         the sampling policy on its detections
+ * @param  nn_slot: NN output slot being post-processed
+ * @param  dets: Detections, network input coordinates
+ * @param  nb: Detections
+ * @param  conf_threshold: Threshold they passed
+ * @note   Post-processing thread; nothing offered with the slot is a no-op
+ */
+void Dataset_Decide(uint32_t nn_slot, const od_pp_outBuffer_t *dets, uint32_t nb, float conf_threshold);
+
+/**
+ * @brief  Give back the frame offered with an NN output slot that will not
+ *         be post-processed (inference failed)
+ */
+void Dataset_Discard(uint32_t nn_slot);
+
+/**
+ * @brief  Copy the capture counters
+ */
+void Dataset_GetStats(dataset_stats_t *stats);
+
+/**
+ * @brief  SDMMC2 interrupt handler (called from SDMMC2_IRQHandler)
+ */
+void Dataset_IRQHandler(void);
+
+#endif /* DATASET_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_DATASET_H */
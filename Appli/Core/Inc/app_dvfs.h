@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file    app_dvfs.h
+ * @author  Long Liangmao
+ * @brief   Voltage and frequency governor for STM32N6570-DK (DVFS_ENABLE)
+ *          Switches the CPU and NPU between the overdrive and nominal
+ *          operating points at frame boundaries, from the measured slack;
+ *          the switch alone with PROFILE_ENABLE
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_DVFS_H
+#define APP_DVFS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+typedef enum {
+  DVFS_POINT_NOMINAL,   /* VOS low, SMPS nominal: CPU 400 MHz, NPU 800 MHz */
+  DVFS_POINT_OVERDRIVE, /* VOS high, SMPS overdrive: CPU 800 MHz, NPU 1 GHz (as booted) */
+  DVFS_POINT_NB,
+} dvfs_point_t;
+
+typedef struct {
+  dvfs_point_t point;
+  uint32_t switches;                  /* Operating point changes since boot */
+  uint32_t frames[DVFS_POINT_NB];     /* Frames run at each point */
+  uint32_t busy_us[DVFS_POINT_NB];    /* Filtered frame work at each point, 0: not measured */
+} dvfs_stats_t;
+
+#if DVFS_ENABLE || PROFILE_ENABLE
+
+/**
+ * @brief  Start at the overdrive point the FSBL set up
+ * @note   Called from App_Init(), after SMPS_Config()
+ */
+void DVFS_Init(void);
+
+/**
+ * @brief  Move to an operating point; the current one is a no-op
+ * @note   Inference thread, NPU idle (see DVFS_FrameBoundary())
+ */
+void DVFS_SetPoint(dvfs_point_t point);
+
+/**
+ * @brief  Copy the governor statistics
+ * @note   Any thread
+ */
+void DVFS_GetStats(dvfs_stats_t *stats);
+
+#endif /* DVFS_ENABLE || PROFILE_ENABLE */
+
+#if DVFS_ENABLE
+
+/**
+ * @brief  Frame boundary of the inference thread: account the last frame and
+ *         change the operating point when the slack asks for it
+ * @param  busy_us: Work of the last frame, inference and the wait for a free
+ *         output slot (post-processing back-pressure); 0 before the first
+ * @note   Inference thread, NPU idle. SystemCoreClock changes: DWT intervals
+ *         that straddle a switch in other threads are off for that interval
+ */
+void DVFS_FrameBoundary(uint32_t busy_us);
+
+#endif /* DVFS_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_DVFS_H */
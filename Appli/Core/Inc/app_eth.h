@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file    app_eth.h
+ * @author  Long Liangmao
+ * @brief   UDP telemetry publisher on Ethernet for STM32N6570-DK (ETH_PUBLISH)
+ *          Telemetry records sent in place from the telemetry ring by the
+ *          ETH1 MAC DMA, behind a per-datagram unit header
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ETH_H
+#define APP_ETH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if ETH_PUBLISH
+
+/* UDP payload: this header, then nb telemetry records of
+ * TELEMETRY_RECORD_SIZE bytes each, unencoded. Little endian, no padding */
+#define ETH_PUBLISH_MAGIC 0x4D54364EU /* "N6TM" */
+#define ETH_PUBLISH_VERSION 1U
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint32_t unit_id; /* Device UID hash: tells the units apart */
+  uint16_t seq;     /* One per datagram: a gap is a lost datagram */
+  uint8_t version;
+  uint8_t nb;       /* Records following */
+} eth_publish_header_t;
+
+/**
+ * @brief  Publisher counters since boot
+ */
+typedef struct {
+  uint32_t datagrams;  /* Datagrams queued to the MAC */
+  uint32_t records;    /* Records in them */
+  uint32_t links;      /* Link up events */
+  uint32_t arp_replies; /* Requests for our address answered */
+  uint32_t rx_frames;  /* Frames received, all types */
+  uint32_t errors;     /* MAC or DMA errors */
+} eth_stats_t;
+
+/**
+ * @brief  Start the publisher thread; it brings the PHY and MAC up
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   No PHY found or no link is not an error: nothing is sent and the
+ *         telemetry ring does not wait
+ */
+void Thread_Eth_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Copy the publisher counters
+ */
+void Eth_GetStats(eth_stats_t *stats);
+
+/**
+ * @brief  ETH1 interrupt handler (call from ETH1_IRQHandler)
+ */
+void Eth_IRQHandler(void);
+
+#endif /* ETH_PUBLISH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ETH_H */
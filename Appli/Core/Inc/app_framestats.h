@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ * @file    app_framestats.h
+ * @author  Long Liangmao
+ * @brief   Frame drop and overrun counters for STM32N6570-DK
+ *          Per DCMIPP pipe frame, overrun, limit and late buffer swap
+ *          counts, Pipe2 frames inferred or skipped, display drops and
+ *          LTDC errors, per UI stats period
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_FRAMESTATS_H
+#define APP_FRAMESTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_buffers.h"
+#include "app_cam.h"
+#include "app_config.h"
+#include "app_lcd.h"
+#include <stdint.h>
+
+/**
+ * @brief  Counters of one pipe
+ */
+typedef struct {
+  uint32_t fps_tenths;     /* Frame events per second over the window, x10 */
+  cam_pipe_stats_t window; /* Counts over the window */
+  cam_pipe_stats_t total;  /* Counts since boot */
+} framestats_pipe_t;
+
+/**
+ * @brief  Last published window
+ */
+typedef struct {
+  framestats_pipe_t pipes[CAM_PIPE_NB]; /* Indexed by DCMIPP_PIPEx */
+  buffer_ml_stats_t ml_window;          /* Pipe2 frames inferred / skipped over the window */
+  buffer_ml_stats_t ml_total;           /* Same, since boot */
+  uint32_t display_dropped;             /* Pipe1 frames never shown, over the window */
+  uint32_t display_repeated;            /* Pipe1 frame events that kept the previous frame */
+#if LCD_ERROR_MONITOR
+  lcd_error_stats_t lcd_window;         /* LTDC errors over the window (last_* since boot) */
+  lcd_error_stats_t lcd_total;          /* Same, since boot */
+#endif
+  uint32_t window_us;                   /* 0 before the first window completes */
+} framestats_report_t;
+
+/**
+ * @brief  Start the first window
+ * @note   Call once the pipes are started
+ */
+void FrameStats_Init(void);
+
+/**
+ * @brief  Close the current window: publish it and, with FRAME_STATS_UART,
+ *         stream it on the ST-LINK virtual COM port
+ * @note   Call periodically from a single thread (UI stats period)
+ */
+void FrameStats_Update(void);
+
+/**
+ * @brief  Get the last published window
+ * @param  report: Output report
+ * @note   Same thread as FrameStats_Update()
+ */
+void FrameStats_GetReport(framestats_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_FRAMESTATS_H */
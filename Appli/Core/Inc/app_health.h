@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file    app_health.h
+ * @author  Long Liangmao
+ * @brief   Pipeline health monitor for STM32N6570-DK
+ *          Detects a stalled Pipe1, Pipe2 or NPU epoch, restarts only that
+ *          stage, and feeds the IWDG while no stage is hung
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_HEALTH_H
+#define APP_HEALTH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if HEALTH_MONITOR
+
+/* Kernel ticks of a timeout, rounded up */
+#define HEALTH_MS_TO_TICKS(ms) (((ms) * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+/* Supervised stages. A stage is checked while armed: a pipe from its start,
+ * Pipe2 while the inference thread waits for a frame, the NPU during a run */
+typedef enum {
+  HEALTH_STAGE_PIPE1 = 0, /* Display capture (unused with DISPLAY_SINGLE_PIPE) */
+  HEALTH_STAGE_PIPE2,     /* ML capture */
+  HEALTH_STAGE_NPU,       /* Epoch blocks; recovered by the inference thread */
+  HEALTH_STAGE_NB
+} health_stage_t;
+
+typedef struct {
+  uint32_t recoveries[HEALTH_STAGE_NB];  /* Since boot */
+  uint32_t last_recovery_us[HEALTH_STAGE_NB]; /* Restart time of the last one */
+  uint8_t iwdg_reset;                    /* This boot follows an IWDG reset */
+  uint32_t weight_faults;                /* Weight chunks found changed (SCRUB_ENABLE) */
+  uint32_t last_weight_fault_addr;       /* Address of the last one */
+} health_stats_t;
+
+/**
+ * @brief  Start checking a stage; its stall timer starts now
+ * @note   Any thread
+ */
+void Health_Arm(uint32_t stage);
+
+/**
+ * @brief  Stop checking a stage
+ */
+void Health_Disarm(uint32_t stage);
+
+/**
+ * @brief  Record progress of an armed stage: its stall timer restarts
+ */
+void Health_Kick(uint32_t stage);
+
+/**
+ * @brief  Count a recovery done outside the supervisor (NPU, by the
+ *         inference thread); fail-fast past the recovery budget
+ * @param  us: Restart time
+ */
+void Health_RecordRecovery(uint32_t stage, uint32_t us);
+
+/**
+ * @brief  Count weights found changed in place; nothing restarts, the
+ *         network keeps running from them
+ * @param  addr: Start of the chunk that changed
+ * @note   Any thread
+ */
+void Health_RecordWeightFault(uint32_t addr);
+
+/**
+ * @brief  Copy the recovery counters
+ */
+void Health_GetStats(health_stats_t *stats);
+
+/**
+ * @brief  Create the supervisor thread and start the IWDG (HEALTH_IWDG)
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Called once every pipe is started. Fail-fast: panics on
+ *         unrecoverable failures
+ */
+void Thread_Health_Init(VOID *memory_ptr);
+
+#endif /* HEALTH_MONITOR */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_HEALTH_H */
@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file    app_irq.h
+ * @author  Long Liangmao
+ * @brief   Interrupt priority plan for STM32N6570-DK
+ *          BASEPRI critical sections that mask a level of the plan and
+ *          below, and the check of the priorities programmed
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_IRQ_H
+#define APP_IRQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "stm32n6xx_hal.h"
+#include <stdint.h>
+
+/**
+ * @brief  Mask the interrupts at a priority of the plan and below, and the
+ *         thread switches (PendSV, timebase); the more urgent ones still run
+ * @param  priority: Level of the handlers sharing the state, above 0
+ * @retval Mask to give back to Irq_Unlock()
+ * @note   Nests: the mask only ever rises. No ThreadX call may block inside
+ */
+static inline uint32_t Irq_Lock(uint32_t priority) {
+  const uint32_t basepri = __get_BASEPRI();
+
+  __set_BASEPRI_MAX(priority << (8U - __NVIC_PRIO_BITS));
+  return basepri;
+}
+
+/**
+ * @brief  End an Irq_Lock() section
+ * @param  basepri: Value Irq_Lock() returned
+ */
+static inline void Irq_Unlock(uint32_t basepri) {
+  __set_BASEPRI(basepri);
+}
+
+/**
+ * @brief  Check the camera, display and NPU interrupts against the plan
+ * @note   Once they are all set up; fail-fast: panics on a priority a
+ *         driver or middleware left at its own default
+ */
+void Irq_CheckPlan(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_IRQ_H */
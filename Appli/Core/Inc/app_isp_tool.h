@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file    app_isp_tool.h
+ * @author  Long Liangmao
+ * @brief   Remote ISP tuning link for STM32N6570-DK (ISP_TUNING_ENABLE)
+ *          Frame dumps and per-run metadata for the STM32 ISP IQTune tool
+ *          over the USB CDC device
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ISP_TOOL_H
+#define APP_ISP_TOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+
+#if ISP_TUNING_ENABLE
+/**
+ * @brief  Register the dump helpers with the camera middleware
+ * @note   Call before CAM_Init(): the helpers are copied into the ISP handle
+ *         when the sensor is probed. Fail-fast: panics on unrecoverable failures
+ */
+void IspTool_Init(void);
+
+/**
+ * @brief  Signal that an ISP run completed, so its metadata is output
+ * @note   ISP thread, after CMW_CAMERA_Run()
+ */
+void IspTool_NotifyRun(void);
+
+/**
+ * @brief  Initialize and start the tuning link thread
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Lowest application priority: dumps stream while nothing else runs.
+ *         Fail-fast: panics on unrecoverable failures
+ */
+void Thread_IspTool_Init(VOID *memory_ptr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ISP_TOOL_H */
@@ -0,0 +1,106 @@
+/**
+ ******************************************************************************
+ * @file    app_isrprof.h
+ * @author  Long Liangmao
+ * @brief   Interrupt handler profile for STM32N6570-DK (ISR_PROFILER)
+ *          Cycle stamps around the camera, display and NPU handlers: run
+ *          time, self time histogram, nesting and LTDC line event latency
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_ISRPROF_H
+#define APP_ISRPROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Profiled handlers */
+typedef enum {
+  ISRPROF_IRQ_DCMIPP,
+  ISRPROF_IRQ_CSI,
+  ISRPROF_IRQ_LTDC_LO,
+  ISRPROF_IRQ_LTDC_UP,
+  ISRPROF_IRQ_NPU,
+  ISRPROF_IRQ_NB
+} isrprof_irq_t;
+
+/* Self time histogram: bucket 0 below 2^ISRPROF_HIST_SHIFT cycles, bucket b
+ * [2^(ISRPROF_HIST_SHIFT + b - 1), 2^(ISRPROF_HIST_SHIFT + b)), the last one
+ * open ended */
+#define ISRPROF_HIST_BUCKETS 13U
+#define ISRPROF_HIST_SHIFT 7U
+
+/* Record payload (TELEMETRY_TYPE_ISR): one handler over the UI stats period
+ * ending at the record. Durations and latencies in CPU cycles. Little
+ * endian, no padding */
+typedef struct __attribute__((packed)) {
+  uint8_t irq;            /* isrprof_irq_t */
+  uint8_t max_depth;      /* Deepest nesting of bracketed handlers at its entries, itself included */
+  uint16_t mhz;           /* CPU clock at the record */
+  uint32_t count;         /* Entries */
+  uint32_t max_cycles;    /* Longest entry to exit, nested handlers included */
+  uint32_t self_cycles;   /* Total, the bracketed handlers nested over it excluded */
+  uint32_t latency_max;   /* Worst request to entry, over latency_nb entries */
+  uint32_t latency_total;
+  uint16_t preempted;     /* Entries a bracketed handler nested over */
+  uint16_t nested;        /* Entries over another bracketed handler */
+  uint16_t latency_nb;    /* Entries with a hardware request stamp (LTDC line event) */
+  uint16_t hist[ISRPROF_HIST_BUCKETS]; /* Self time, saturating */
+} isrprof_record_t;
+
+#if ISR_PROFILER
+
+/* Bracket a profiled handler, outermost */
+#define ISRPROF_ENTER(irq) IsrProf_Enter(irq)
+#define ISRPROF_EXIT(irq) IsrProf_Exit(irq)
+
+/**
+ * @brief  Clear the counters and route the NPU interrupt through its
+ *         bracketing wrapper (vector table copied to RAM)
+ * @note   Called from App_Init(), before the NPU interrupt is enabled
+ */
+void IsrProf_Init(void);
+
+/**
+ * @brief  Handler entry: stamp it and, for the LTDC, take the line event
+ *         latency from the scanout position
+ */
+void IsrProf_Enter(isrprof_irq_t irq);
+
+/**
+ * @brief  Handler exit: count the run and charge it to the enclosing handler
+ */
+void IsrProf_Exit(isrprof_irq_t irq);
+
+/**
+ * @brief  Send one record per handler and start a new window
+ * @note   One thread (UI), every stats period
+ */
+void IsrProf_Update(void);
+
+#else
+
+#define ISRPROF_ENTER(irq)
+#define ISRPROF_EXIT(irq)
+
+#endif /* ISR_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ISRPROF_H */
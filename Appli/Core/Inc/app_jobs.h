@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    app_jobs.h
+ * @author  Long Liangmao
+ * @brief   Engine job pipelines for STM32N6570-DK
+ *          A pipeline is a chain of stages, each bound to one engine (CPU,
+ *          NPU, DMA2D, HPDMA, JPEG, VENC). Every engine has one lane thread
+ *          that runs its stages in submission order; a stage that ends
+ *          hands its slot to the lane of the next one. While one engine
+ *          works on a frame the others take the frames before and after
+ *          it, so a pipeline sustains the rate of its slowest stage
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_JOBS_H
+#define APP_JOBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Pipelines registered, stages per pipeline, frames in flight per pipeline */
+#define JOBS_PIPELINES_MAX 2
+#define JOBS_STAGES_MAX 6
+#define JOBS_SLOTS_MAX 4
+
+/* Engines a stage runs on: one lane thread each */
+typedef enum {
+  JOBS_ENGINE_CPU,
+  JOBS_ENGINE_NPU,
+  JOBS_ENGINE_DMA2D,
+  JOBS_ENGINE_HPDMA,
+  JOBS_ENGINE_JPEG,
+  JOBS_ENGINE_VENC,
+  JOBS_ENGINE_NB
+} jobs_engine_t;
+
+/**
+ * @brief  One stage of a pipeline
+ * @note   run() starts the engine on the slot and returns once it is done,
+ *         blocked on the completion its interrupt signals (fence,
+ *         semaphore, event flags): the lane sleeps, the other engines go on
+ */
+typedef struct {
+  const char *name;
+  jobs_engine_t engine;
+  void (*run)(uint32_t slot);
+} jobs_stage_t;
+
+/**
+ * @brief  Chain of stages over a ring of slots, filled in by its owner
+ * @note   Slots go through the stages in order and come back in order:
+ *         the owner keeps the per-frame state in arrays of slot_nb
+ */
+typedef struct {
+  const char *name;
+  const jobs_stage_t *stages;
+  uint32_t stage_nb;
+  uint32_t slot_nb;
+
+  /* Private */
+  TX_SEMAPHORE free_sem; /* One count per slot out of the pipeline */
+  uint32_t next_slot;    /* Slot the next Jobs_Acquire() takes */
+  uint8_t id;
+} jobs_pipeline_t;
+
+/**
+ * @brief  Register a pipeline and start the lanes of its engines
+ * @note   From thread context, once per pipeline. The lanes run at
+ *         JOBS_LANE_PRIORITY. Fail-fast: panics on a malformed pipeline
+ *         or beyond JOBS_PIPELINES_MAX
+ */
+void Jobs_Register(jobs_pipeline_t *pipeline);
+
+/**
+ * @brief  Take the next free slot of a pipeline
+ * @param  slot: Output slot index, below slot_nb
+ * @param  wait_ticks: ThreadX wait option
+ * @retval 1 when a slot was taken, 0 on timeout (every slot in flight)
+ * @note   One producer per pipeline
+ */
+int Jobs_Acquire(jobs_pipeline_t *pipeline, uint32_t *slot, ULONG wait_ticks);
+
+/**
+ * @brief  Start a slot taken by Jobs_Acquire() through the stages
+ * @note   It is free again once the last stage returned
+ */
+void Jobs_Submit(jobs_pipeline_t *pipeline, uint32_t slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_JOBS_H */
@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file    app_latency.h
+ * @author  Long Liangmao
+ * @brief   End-to-end pipeline latency histograms for STM32N6570-DK
+ *          Capture vsync -> NPU done -> post-processing done -> UI scanout,
+ *          aggregated over a window of inferred frames
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_LATENCY_H
+#define APP_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+/* Log2 bins: bin b holds [LATENCY_BIN0_US << b, LATENCY_BIN0_US << (b + 1)),
+ * bin 0 also everything below and the last bin everything above */
+#define LATENCY_HIST_BINS 10
+#define LATENCY_BIN0_US 250U
+
+/* Inferred frames aggregated before histograms are published */
+#define LATENCY_WINDOW_FRAMES 60
+
+/* Pipeline stages */
+typedef enum {
+  LATENCY_STAGE_CAPTURE_NPU = 0, /* Pipe1 vsync -> NPU outputs copied out */
+  LATENCY_STAGE_NPU_POST,        /* NPU done -> detections published */
+  LATENCY_STAGE_POST_SCANOUT,    /* Published -> UI layer latched at a vblank */
+  LATENCY_STAGE_NB,
+} latency_stage_t;
+
+/**
+ * @brief  Latency histogram of one stage over the last window
+ */
+typedef struct {
+  uint16_t bins[LATENCY_HIST_BINS];
+  uint32_t avg_us;
+  uint32_t max_us;
+} latency_hist_t;
+
+/**
+ * @brief  Reset the histograms
+ */
+void Latency_Init(void);
+
+/**
+ * @brief  Record the stage latencies of a result once its overlay is scanned out
+ * @param  result: Result the overlay was drawn from
+ * @param  scanout_cycles: DWT stamp of the vblank that latched the UI buffer
+ * @note   UI thread context; a result is counted once however often it is redrawn
+ */
+void Latency_RecordScanout(const nn_result_t *result, uint32_t scanout_cycles);
+
+/**
+ * @brief  Get the histograms of the last published window
+ * @param  hist: Output array, one entry per latency_stage_t
+ * @retval Frames in the window, 0 before the first window completes
+ */
+uint32_t Latency_GetHistograms(latency_hist_t hist[LATENCY_STAGE_NB]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_LATENCY_H */
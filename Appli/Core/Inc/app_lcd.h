@@ -25,6 +25,7 @@
 extern "C" {
 #endif
 
+#include "app_cam.h"
 #include "app_config.h"
 #include <stdint.h>
 
@@ -47,56 +48,120 @@ void LCD_Init(void);
 void LCD_DeInit(void);
 
 /**
- * @brief  Reload Layer 0 with buffer address (buffering)
+ * @brief  Show a new Layer 0 buffer from the next vblank
  *         Called from frame event callback
  * @param  frame_buffer: Pointer to the next display buffer
+ * @note   Staged: the LTDC line event commits it ahead of the blanking, and
+ *         the reload that latches it hands the replaced slot back through
+ *         Buffer_CameraDisplay_Shown()
+ * @note   No cache maintenance: the camera ring is mapped non-cacheable
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void LCD_ReloadCameraLayer(uint8_t *frame_buffer);
 
 /**
- * @brief  Set UI layer buffer address for drawing (without reloading display)
- *         Use this before drawing to the back buffer
- * @param  frame_buffer: Pointer to the buffer to draw to
+ * @brief  Show a new Layer 1 (UI) buffer from the next vblank (double or
+ *         triple buffering)
+ *         Called after UI rendering is complete
+ * @param  frame_buffer: Pointer to the next UI display buffer
+ * @note   Staged: the LTDC line event commits it ahead of the blanking
+ * @note   Does not touch the D-cache: CPU-drawn regions must be flushed
+ *         with LCD_FlushUIRegion() first
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_SetUILayerAddress(uint8_t *frame_buffer);
+void LCD_ReloadUILayer(uint8_t *frame_buffer);
 
 /**
- * @brief  Reload Layer 1 (UI) with buffer address (double buffering)
- *         Called after UI rendering is complete
- * @param  frame_buffer: Pointer to the next UI display buffer
+ * @brief  Block until the last buffer passed to LCD_ReloadUILayer() is
+ *         scanned out, so that the buffers it replaced may be drawn
+ * @retval DWT cycle stamp of the vblank that latched it
+ * @note   Fail-fast: panics if no vblank latches it within a few frames
+ */
+uint32_t LCD_WaitUILayerShown(void);
+
+/**
+ * @brief  Get the UI buffer the last vblank latched, without waiting
+ * @param  shown_cycles: Output DWT cycle stamp of that vblank
+ * @retval UI buffer on screen
+ */
+const uint8_t *LCD_GetUILayerShown(uint32_t *shown_cycles);
+
+/**
+ * @brief  Write back and invalidate a rectangle of a UI buffer in the D-cache
+ *         Only the rows' [x, x + width) spans are maintained
+ * @param  frame_buffer: UI buffer (UI_LAYER_FORMAT, UI_LAYER_WIDTH stride)
+ * @param  x: Left column
+ * @param  y: Top row
+ * @param  width: Width in pixels
+ * @param  height: Height in rows
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_ReloadUILayer(uint8_t *frame_buffer);
+void LCD_FlushUIRegion(uint8_t *frame_buffer, uint32_t x, uint32_t y,
+                       uint32_t width, uint32_t height);
 
 /**
- * @brief  Set Layer 1 (UI) transparency/alpha
+ * @brief  Set Layer 1 (UI) transparency/alpha from the next vblank
  * @param  alpha: Alpha value (0-255, 0 = fully transparent, 255 = fully opaque)
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void LCD_SetUIAlpha(uint8_t alpha);
 
 /**
- * @brief  Enable or disable Layer 1 (UI)
+ * @brief  Restrict Layer 1 (UI) fetches to a rectangle, from the next vblank
+ *         Buffer and screen coordinates keep coinciding
+ * @param  x, y: Top-left corner
+ * @param  width, height: Size, within UI_LAYER_WIDTH x UI_LAYER_HEIGHT
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void LCD_SetUIWindow(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief  Set or clear the Layer 1 (UI) color key, from the next vblank
+ *         Pixels of that color are shown as transparent
+ * @param  enable: 1 to enable, 0 to disable
+ * @param  rgb: Key color (RGB888)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void LCD_SetUIColorKey(uint8_t enable, uint32_t rgb);
+
+/**
+ * @brief  Enable or disable Layer 1 (UI) from the next vblank
  * @param  enable: 1 to enable, 0 to disable
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void LCD_SetUILayerVisible(uint8_t enable);
 
+#if LCD_ERROR_MONITOR
+/**
+ * @brief  LTDC error counters since boot, one event per frame at most
+ */
+typedef struct {
+  uint32_t underruns;                /* Frames with a FIFO underrun */
+  uint32_t transfer_errors;          /* Frames with an AXI transfer error */
+  uint32_t during_npu;               /* Events while an inference ran */
+  uint32_t during_pipe[CAM_PIPE_NB]; /* Events while DCMIPP_PIPEn captured */
+  int16_t last_epoch;                /* NPU epoch at the last event, -1 if none or unknown */
+  uint32_t last_cycles;              /* DWT stamp of the last event, 0 if none */
+} lcd_error_stats_t;
+
 /**
- * @brief  Enable or disable Layer 0 (Camera)
+ * @brief  Copy the LTDC error counters
+ * @param  stats: Output counters
+ */
+void LCD_GetErrorStats(lcd_error_stats_t *stats);
+#endif
+
+/**
+ * @brief  Enable or disable Layer 0 (Camera) from the next vblank
  * @param  enable: 1 to enable, 0 to disable
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void LCD_SetCameraLayerVisible(uint8_t enable);
 
 /**
- * @brief  Handle LTDC reload (call after frame buffer updates)
- * @param  reload_type: BSP_LCD_RELOAD_IMMEDIATE or BSP_LCD_RELOAD_VERTICAL_BLANKING
- * @note   Fail-fast: panics on unrecoverable failures
+ * @brief  LTDC interrupt handler (call from the LTDC global IRQ handlers)
  */
-void LCD_Reload(uint32_t reload_type);
+void LCD_IRQHandler(void);
 
 #ifdef __cplusplus
 }
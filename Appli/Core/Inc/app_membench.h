@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file    app_membench.h
+ * @author  Long Liangmao
+ * @brief   External memory self-test for STM32N6570-DK
+ *          Throughput and latency of the xSPI1 PSRAM and the xSPI2 octoFlash,
+ *          cached and uncached, with the interface settings they ran at
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_MEMBENCH_H
+#define APP_MEMBENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if MEM_BENCH
+
+#define MEM_BENCH_PSRAM 0 /* xSPI1 */
+#define MEM_BENCH_FLASH 1 /* xSPI2 */
+#define MEM_BENCH_MEM_NB 2
+
+#define MEM_BENCH_CACHED 0 /* Through the D-cache, cold at the start */
+#define MEM_BENCH_BYPASS 1 /* Non-cacheable */
+#define MEM_BENCH_MODE_NB 2
+
+/* One memory in one mode */
+typedef struct {
+  uint32_t seq_read_kbs;  /* Sequential read, KB/s */
+  uint32_t seq_write_kbs; /* Sequential write incl. the write-back, KB/s; 0 read only */
+  uint32_t rand_read_ns;  /* Dependent reads a cache line apart in the window, ns each */
+} mem_bench_result_t;
+
+/* Interface settings in force during the run */
+typedef struct {
+  uint32_t kernel_hz; /* xSPI kernel clock */
+  uint8_t prescaler;  /* DCR2: memory clock = kernel clock / (prescaler + 1) */
+  uint8_t dtr;        /* Read data on both edges */
+  uint8_t dqs;        /* Read strobe from the memory */
+  uint8_t prefetch;   /* Memory-mapped prefetch (CR NOPREF clear) */
+  uint8_t sshift;     /* Sample shifted half a cycle */
+  uint8_t dhqc;       /* Output hold a quarter cycle */
+} mem_bench_xspi_t;
+
+typedef struct {
+  mem_bench_result_t results[MEM_BENCH_MEM_NB][MEM_BENCH_MODE_NB];
+  mem_bench_xspi_t xspi[MEM_BENCH_MEM_NB];
+  uint32_t cpu_hz;
+  uint8_t degraded[MEM_BENCH_MEM_NB]; /* Cached sequential read below its minimum */
+  uint8_t valid;
+} mem_bench_report_t;
+
+/**
+ * @brief  Run every measurement and keep the report
+ * @note   Called from App_Init() once the PSRAM is memory-mapped, before any
+ *         buffer or DMA uses it. Each measurement masks the interrupts (a few
+ *         ms at most); run on demand from a thread, the NPU and DMA traffic
+ *         of the moment is measured with it. Clobbers MEM_BENCH_PSRAM_ADDR
+ */
+void MemBench_Run(void);
+
+/**
+ * @brief  Copy the last report (valid clear before the first run)
+ */
+void MemBench_GetReport(mem_bench_report_t *report);
+
+/**
+ * @brief  Print the report once (MEM_BENCH_UART); nothing after the first time
+ * @note   Call periodically from a single thread (UI stats period), after the
+ *         port is opened
+ */
+void MemBench_Update(void);
+
+#endif /* MEM_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_MEMBENCH_H */
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file    app_memmap.h
+ * @author  Long Liangmao
+ * @brief   Runtime memory map and bandwidth budget for STM32N6570-DK
+ *          Every region with its owner, size and cacheability, and the
+ *          bytes per frame each memory consumer draws
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_MEMMAP_H
+#define APP_MEMMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if MEM_MAP_REPORT
+
+/**
+ * @brief  Print the memory map and the bandwidth budget when the host asked,
+ *         at most MEM_MAP_REPORT_LINES lines per call
+ * @note   One thread (UI). The rates are averaged since the previous report,
+ *         since boot for the first
+ */
+void MemMap_Poll(void);
+
+#endif /* MEM_MAP_REPORT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_MEMMAP_H */
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file    app_mempower.h
+ * @author  Long Liangmao
+ * @brief   AXISRAM bank power for STM32N6570-DK (MEMPOWER_ENABLE)
+ *          The AXISRAM2-6 banks no initialized network places a buffer in,
+ *          and no CPU section uses, are shut down and their clocks gated
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_MEMPOWER_H
+#define APP_MEMPOWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Bank masks: bit n is AXISRAMn, as NNBENCH_POOL_MOVES */
+typedef struct {
+  uint32_t pinned;  /* Banks with a CPU section (.axisram3_bss, .axisram6_bss) */
+  uint32_t off;     /* Banks shut down now */
+  uint32_t wakes;   /* Banks powered back up for a network switch */
+  uint32_t wake_max_us;
+} mempower_stats_t;
+
+#if MEMPOWER_ENABLE
+
+/**
+ * @brief  Shut down the banks the initialized networks leave unused
+ * @note   Called at the end of NN_Init(), every boot network bound.
+ *         Fail-fast: panics on unrecoverable failures
+ */
+void MemPower_Init(void);
+
+/**
+ * @brief  Power up the banks a registered network uses, ahead of its
+ *         MX_X_CUBE_AI_SelectNetwork(); returns with them accessible
+ * @param  id: Registered network (MX_X_CUBE_AI_Network_t)
+ * @note   One thread (inference), between inferences
+ */
+void MemPower_Wake(uint32_t id);
+
+/**
+ * @brief  Shut down again the banks the initialized networks leave unused:
+ *         after a switch, or MX_X_CUBE_AI_Resume() which powers them all
+ * @note   One thread (inference), between inferences
+ */
+void MemPower_Apply(void);
+
+/**
+ * @brief  Copy the bank power counters
+ */
+void MemPower_GetStats(mempower_stats_t *stats);
+
+#endif /* MEMPOWER_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_MEMPOWER_H */
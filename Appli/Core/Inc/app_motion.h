@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file    app_motion.h
+ * @author  Long Liangmao
+ * @brief   Motion gate for STM32N6570-DK
+ *          Skips the NPU on Pipe2 frames that did not change since its last
+ *          run, from the block luminance of a sparse sample grid
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_MOTION_H
+#define APP_MOTION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if MOTION_GATE_ENABLE
+
+/**
+ * @brief  Reset the reference so the next frame runs the network
+ */
+void Motion_Init(void);
+
+/**
+ * @brief  Decide whether a Pipe2 frame needs the network (inference thread)
+ * @param  frame: ML capture slot held by the caller, or the auxiliary frame
+ *         from CAM_AuxPipe_GetFrame() with AUX_STREAM_ENABLE
+ * @retval 1 to run the network (the frame becomes the reference), 0 to skip it
+ */
+int Motion_ShouldRun(const uint8_t *frame);
+
+/**
+ * @brief  Report whether the last published result had detections
+ * @note   Post-processing thread; frames are never skipped while tracking
+ */
+void Motion_SetTracking(uint32_t nb_detect);
+
+/**
+ * @brief  Turn the gate on or off at runtime; on at init
+ * @param  enabled: 0: every frame runs the network and is not sampled
+ * @note   Inference thread
+ */
+void Motion_SetEnabled(int enabled);
+
+#endif /* MOTION_GATE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_MOTION_H */
@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file    app_multires.h
+ * @author  Long Liangmao
+ * @brief   Resolution-adaptive inference for STM32N6570-DK (NN_MULTIRES_ENABLE)
+ *          The detector drops to its NN_MULTIRES_SIDE build while every
+ *          person seen is large, and comes back to ML_WIDTH for small or
+ *          lost ones and for periodic far-field probes
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_MULTIRES_H
+#define APP_MULTIRES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#if NN_MULTIRES_ENABLE
+
+/**
+ * @brief  Start at full resolution
+ * @param  full_network: Registered ML_WIDTH detector (MX_X_CUBE_AI_Network_t)
+ * @note   Fail-fast: panics if NN_MULTIRES_NETWORK is not registered
+ */
+void MultiRes_Init(uint32_t full_network);
+
+/**
+ * @brief  Pick the detector of the next frames from a published result
+ * @param  network: Network the result was inferred with
+ * @param  dets: Its detections, normalized to the frame
+ * @param  nb: Number of detections
+ * @note   Post-processing thread; a switch applies at the next frame
+ *         boundary, and results of any other network are left alone
+ */
+void MultiRes_Update(uint32_t network, const nn_detection_t *dets, uint32_t nb);
+
+#endif /* NN_MULTIRES_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_MULTIRES_H */
@@ -0,0 +1,170 @@
+/**
+ ******************************************************************************
+ * @file    app_nn.h
+ * @author  Long Liangmao
+ * @brief   Neural network inference pipeline for STM32N6570-DK
+ *          Pipe2 capture -> NPU inference -> CPU post-processing
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NN_H
+#define APP_NN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Maximum number of detections published per frame */
+#define NN_MAX_DETECTIONS AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT
+
+/**
+ * @brief  Single detection, coordinates normalized to the ML frame [0, 1],
+ *         or to the sensor field of view with NN_TILING_FULL_FOV and
+ *         NN_TILING_ROI
+ */
+typedef struct {
+  float x_center;
+  float y_center;
+  float width;
+  float height;
+  float conf;
+  int32_t class_index;
+} nn_detection_t;
+
+#if CASCADE_ENABLE
+/**
+ * @brief  Second-stage result on one crop
+ */
+typedef struct {
+  nn_detection_t roi; /* Crop window in ML frame coordinates, conf of the primary detection */
+  uint32_t nb_detect;
+  nn_detection_t detections[CASCADE_MAX_DETECTIONS]; /* Mapped back to ML frame coordinates */
+} nn_cascade_roi_t;
+
+/**
+ * @brief  Second-stage results of one frame
+ */
+typedef struct {
+  nn_cascade_roi_t rois[CASCADE_TOP_K];
+  uint32_t nb_roi;     /* Crops run on the NPU */
+  uint32_t nb_skipped; /* Candidates dropped to stay within the frame budget */
+  uint32_t npu_us;     /* Second-stage time, crops included */
+} nn_cascade_t;
+#endif
+
+/**
+ * @brief  Latest post-processed inference result and pipeline statistics
+ */
+typedef struct {
+  nn_detection_t detections[NN_MAX_DETECTIONS];
+  uint32_t nb_detect;        /* Valid entries in detections[] */
+  uint32_t frame_count;      /* Total frames inferred since start */
+  uint32_t network;          /* Network that produced the detections (MX_X_CUBE_AI_Network_t) */
+  uint32_t frame_id;         /* Sensor frame the detections were computed on */
+  uint32_t vsync_cycles;     /* DWT stamp of that frame's capture vsync */
+  uint32_t npu_done_cycles;  /* DWT stamp when the NPU outputs were copied out */
+  uint32_t post_done_cycles; /* DWT stamp when post-processing finished */
+  uint32_t inference_us;     /* NPU inference time of this frame */
+  uint32_t handoff_us;       /* Pipe2 frame event to the inference thread taking it, 0 if unknown */
+  uint32_t postprocess_us;   /* CPU post-processing time of this frame */
+  float conf_threshold;      /* Score threshold the frame was decoded at */
+  uint32_t frame_period_us;  /* Time between the last two inferences */
+#if MOTION_GATE_ENABLE
+  uint32_t gated_count;      /* Total frames skipped by the motion gate since start */
+#endif
+#if NPU_IDLE_GATE_ENABLE
+  uint32_t npu_suspend_count; /* NPU and activation banks suspended while idle, since start */
+  uint32_t npu_wake_max_us;   /* Slowest wake-up from it */
+#endif
+#if CASCADE_ENABLE
+  nn_cascade_t cascade;      /* Second stage, on the previous frame's detections */
+#endif
+#if DUAL_STREAM_ENABLE
+  uint32_t stream;           /* Sensor of the frame: 0 main, 1 second (CAM_MLStream_Get()) */
+#endif
+} nn_result_t;
+
+/**
+ * @brief  Initialize the inference pipeline (synchronization objects, result
+ *         pool, post-processing)
+ * @param  memory_ptr: Application byte pool the result pool is carved from
+ * @note   Must be called after MX_X_CUBE_AI_Init()
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void NN_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Signal that a new Pipe2 frame is ready (ISR context)
+ * @param  slot: ML capture slot just completed (Buffer_MLCapture_Complete())
+ * @note   Queues the frame event lock-free and sets one event flag: the
+ *         inference thread drains every event queued since it last woke
+ */
+void NN_SignalFrameReady(int slot);
+
+#if ML_SLICE_INGEST
+/**
+ * @brief  Signal the Pipe2 rows written so far into a snapshot (ISR context)
+ * @param  slot: ML capture slot being written
+ * @param  capture: Arming count of the snapshot, tells apart the captures of a slot
+ * @param  rows: Lines written, ML_HEIGHT at the frame event
+ * @note   The inference thread copies them into the network input while
+ *         it waits for the frame, the NPU idle
+ */
+void NN_SignalRows(int slot, uint32_t capture, uint32_t rows);
+#endif
+
+/**
+ * @brief  Request a network switch, applied at the next frame boundary
+ * @param  id: Registered network (MX_X_CUBE_AI_Network_t)
+ * @note   Any thread; the inference thread drains post-processing, selects
+ *         the network and re-validates its layout before the next inference
+ * @note   Fail-fast: panics on an unregistered id
+ */
+void NN_RequestNetwork(uint32_t id);
+
+/**
+ * @brief  Take a reference to the latest published result
+ * @retval Result, valid and unchanged until NN_ReleaseResult(); an empty
+ *         one before the first inference
+ * @note   Any thread; no copy: results are pool records handed over by
+ *         pointer, a pool of a few, so a reference is not kept for long
+ */
+const nn_result_t *NN_AcquireResult(void);
+
+/**
+ * @brief  Take one more reference to a result already held
+ */
+void NN_RetainResult(const nn_result_t *result);
+
+/**
+ * @brief  Drop a reference taken by NN_AcquireResult() or NN_RetainResult()
+ * @note   NULL is ignored
+ */
+void NN_ReleaseResult(const nn_result_t *result);
+
+/**
+ * @brief  Initialize and create the inference and post-processing threads
+ * @param  memory_ptr: Memory pointer (unused, threads use static allocation)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thread_NN_Init(VOID *memory_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NN_H */
@@ -0,0 +1,46 @@
+/**
+ ******************************************************************************
+ * @file    app_nnbench.h
+ * @author  Long Liangmao
+ * @brief   Inference latency benchmark for STM32N6570-DK
+ *          Runs od_yolo_x_person on a fixed input and reports cold and warm
+ *          latency, cycles per epoch and the NPU cache effect
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NNBENCH_H
+#define APP_NNBENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if NN_BENCH
+
+/**
+ * @brief  Start the benchmark thread in place of the camera pipeline
+ * @param  memory_ptr: ThreadX memory pool (unused, static stack)
+ */
+void NNBench_Init(VOID *memory_ptr);
+
+#endif /* NN_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NNBENCH_H */
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_bw.h
+ * @author  Long Liangmao
+ * @brief   NPU bandwidth report for STM32N6570-DK
+ *          Stream engine stall cycles per memory pool, from the ATON debug
+ *          and trace counters
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NPU_BW_H
+#define APP_NPU_BW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if NPU_BW_REPORT
+
+#include "ll_aton.h"
+
+/* Memory pools a stream engine tensor can live in */
+#define NPU_BW_POOL_AXISRAM 0 /* On-chip AXISRAM1-6 */
+#define NPU_BW_POOL_PSRAM 1   /* xSPI1 hyperRAM */
+#define NPU_BW_POOL_FLASH 2   /* xSPI2 octoFlash */
+#define NPU_BW_POOL_OTHER 3   /* Anything else, or not seen (epoch blobs) */
+#define NPU_BW_POOL_NB 4
+
+/* Stream engine cycles of one pool (NPU clock), summed over an inference.
+ * An engine is stalled while its stream switch link does not move data:
+ * waiting on memory or on the rest of the pipeline, or done early */
+typedef struct {
+  uint64_t in_active;       /* Input engines (memory reads) moving data */
+  uint64_t in_stall;        /* Input engines stalled */
+  uint64_t out_active;      /* Output engines (memory writes) moving data */
+  uint64_t out_stall;       /* Output engines stalled */
+  uint64_t in_bytes;        /* Bytes read, from the tensor geometry (repeats included) */
+  uint64_t out_bytes;       /* Bytes written, same */
+  uint64_t critical_cycles; /* Blocks whose busiest engine used this pool */
+  uint32_t critical_blocks;
+} npu_bw_pool_t;
+
+/* Last completed inference of a network */
+typedef struct {
+  uint64_t block_cycles; /* Armed epoch blocks, PRE_START to PRE_END */
+  uint32_t nb_blocks;
+  npu_bw_pool_t pools[NPU_BW_POOL_NB];
+} npu_bw_report_t;
+
+/**
+ * @brief  Hook every registered network
+ * @note   Called from NN_Init() after Prefetch_Init(): the epoch callback
+ *         already set on a network is chained, not replaced
+ */
+void NPUBw_Init(void);
+
+/**
+ * @brief  Record the memory pool of a stream engine tensor
+ * @param  id: Stream engine
+ * @param  conf: Tensor setup, after the cache policy and prefetch rebase
+ * @note   Stream engine hook, inference thread context
+ */
+void NPUBw_RecordTensor(int id, const LL_Streng_TensorInitTypeDef *conf);
+
+/**
+ * @brief  Copy the report of the last completed inference of the active network
+ */
+void NPUBw_GetReport(npu_bw_report_t *report);
+
+#endif /* NPU_BW_REPORT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NPU_BW_H */
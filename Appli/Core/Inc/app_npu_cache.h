@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_cache.h
+ * @author  Long Liangmao
+ * @brief   NPU cache (CACHEAXI) policy and statistics for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NPU_CACHE_H
+#define APP_NPU_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* CACHEAXI monitor counters (NPU accesses only). The hardware counters
+ * saturate: the epoch profiler resets them at the start of every inference */
+typedef struct {
+  uint32_t read_hits;
+  uint32_t read_misses;
+  uint32_t write_hits;
+  uint32_t write_misses;
+  uint32_t evictions;
+} npu_cache_counters_t;
+
+/**
+ * @brief  Start the CACHEAXI hit/miss monitors
+ * @note   Called from NN_Init(), after MX_X_CUBE_AI_Init() enabled the cache
+ */
+void NPUCache_Init(void);
+
+/**
+ * @brief  Read the monitor counters
+ */
+void NPUCache_GetCounters(npu_cache_counters_t *counters);
+
+/**
+ * @brief  Restart the monitor counters from zero
+ */
+void NPUCache_ResetCounters(void);
+
+/**
+ * @brief  Counters accumulated between two readings
+ * @param  acc: Accumulator, incremented by end - start
+ */
+void NPUCache_Accumulate(npu_cache_counters_t *acc, const npu_cache_counters_t *start,
+                         const npu_cache_counters_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NPU_CACHE_H */
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_cipher.h
+ * @author  Long Liangmao
+ * @brief   Encrypted weights for STM32N6570-DK
+ *          OTP key provisioning of the NPU bus interfaces, stream engine
+ *          on-the-fly decryption of the octoFlash weights
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NPU_CIPHER_H
+#define APP_NPU_CIPHER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if NPU_WEIGHT_CIPHER
+
+#include "ll_aton.h"
+
+/**
+ * @brief  Write the weights key from OTP to every NPU bus interface
+ * @note   Secure state only, after MX_X_CUBE_AI_Init() and before the first
+ *         inference (NN_Init()), and again after any NPU reset. Fail-fast on
+ *         an OTP read error or an unprovisioned (blank) key
+ */
+void NPUCipher_LoadKeys(void);
+
+/**
+ * @brief  Check that a stream engine read of the octoFlash is deciphered
+ * @param  conf: Tensor setup as generated (stream engine hook)
+ * @note   Fail-fast on clear reads: the network was not generated with
+ *         encrypted weights, or with the wrong key slot
+ */
+void NPUCipher_CheckTensor(const LL_Streng_TensorInitTypeDef *conf);
+
+#endif /* NPU_WEIGHT_CIPHER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NPU_CIPHER_H */
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_place.h
+ * @author  Long Liangmao
+ * @brief   NPU activation placement experiment for STM32N6570-DK
+ *          AXISRAM banks of the generated network moved to a hyperRAM
+ *          mirror at run time, for the inference benchmark
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NPU_PLACE_H
+#define APP_NPU_PLACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if NPU_PLACE_EXPERIMENT
+
+#include "ll_aton.h"
+
+/* Banks that may move: bit n of a mask is AXISRAMn */
+#define NPU_PLACE_BANK_FIRST 2U
+#define NPU_PLACE_BANK_LAST 6U
+
+/**
+ * @brief  Activation bytes the network reserves in a bank
+ * @param  bank: NPU_PLACE_BANK_FIRST to NPU_PLACE_BANK_LAST
+ */
+uint32_t NPUPlace_BankBytes(uint32_t bank);
+
+/**
+ * @brief  Banks read and written in the hyperRAM mirror from the next
+ *         stream engine setup on (0: as generated)
+ * @note   Between inferences
+ */
+void NPUPlace_SetMoved(uint32_t mask);
+
+/**
+ * @brief  Point a stream engine tensor of a moved bank at the mirror
+ * @param  conf: Tensor setup, rewritten in place (stream engine hook)
+ */
+void NPUPlace_Rebase(LL_Streng_TensorInitTypeDef *conf);
+
+/**
+ * @brief  Where a network buffer is with the current layout
+ */
+void *NPUPlace_Translate(void *addr);
+
+/**
+ * @brief  Tensors seen crossing from a moved bank to one kept in place, since
+ *         the last call; those stay where generated and void the layout
+ */
+uint32_t NPUPlace_TakeStraddles(void);
+
+#endif /* NPU_PLACE_EXPERIMENT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NPU_PLACE_H */
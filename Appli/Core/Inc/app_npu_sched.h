@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_sched.h
+ * @author  Long Liangmao
+ * @brief   Dual-instance NPU scheduler for STM32N6570-DK (NPU_SCHED_ENABLE)
+ *          Interleaves the epoch blocks of initialized networks at epoch
+ *          boundaries: the most urgent job takes the NPU when it is free, the
+ *          others run their SW epochs meanwhile
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NPU_SCHED_H
+#define APP_NPU_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if NPU_SCHED_ENABLE
+
+#include "ll_aton_runtime.h"
+
+typedef enum {
+  NPU_SCHED_PENDING,
+  NPU_SCHED_DONE,    /* Every inference asked for completed */
+  NPU_SCHED_EXPIRED, /* Dropped at its deadline, at an epoch boundary */
+  NPU_SCHED_FAILED,  /* NPU hung and recovered */
+} npu_sched_status_t;
+
+typedef struct npu_sched_job npu_sched_job_t;
+
+/**
+ * @brief  Job continuation: bind the input of the next inference
+ * @param  job: The job
+ * @param  completed: 0 before the first inference, 1 after each completed
+ *         one (its outputs are valid until the job runs again)
+ * @retval 1 to run one more inference, 0 when the job is done
+ */
+typedef int (*npu_sched_next_t)(npu_sched_job_t *job, int completed);
+
+struct npu_sched_job {
+  NN_Instance_TypeDef *instance; /* Initialized network */
+  uint32_t priority;             /* 0 most urgent; ties go to the earlier deadline */
+  uint32_t deadline;             /* DWT cycles, 0: none */
+  npu_sched_next_t next;         /* NULL: one inference on the bound input */
+  void *arg;
+
+  /* Set by NPUSched_Run() */
+  npu_sched_status_t status;
+  uint32_t runs;                 /* Inferences completed */
+  uint32_t done_cycles;          /* DWT cycles at the last completion */
+};
+
+/**
+ * @brief  Check that two networks can be in flight together
+ * @note   Fail-fast: panics if any activation, input or output buffer of
+ *         one overlaps a buffer of the other
+ */
+void NPUSched_CheckDisjoint(NN_Instance_TypeDef *a, NN_Instance_TypeDef *b);
+
+/**
+ * @brief  Run the jobs to completion, interleaved at epoch boundaries
+ * @param  jobs: Jobs, at most NPU_SCHED_JOBS_MAX, on distinct instances
+ *         whose buffers are disjoint (NPUSched_CheckDisjoint())
+ * @param  nb: Number of jobs
+ * @retval 0 when an epoch block timed out (HEALTH_MONITOR): the NPU was
+ *         reset, unfinished jobs are NPU_SCHED_FAILED; 1 otherwise
+ * @note   Inference thread: the only caller of the ATON runtime
+ */
+int NPUSched_Run(npu_sched_job_t *jobs, uint32_t nb);
+
+#endif /* NPU_SCHED_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NPU_SCHED_H */
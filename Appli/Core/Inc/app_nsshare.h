@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ * @file    app_nsshare.h
+ * @author  Long Liangmao
+ * @brief   Results shared with the non-secure image for STM32N6570-DK
+ *          Lock-free triple buffer written by the secure inference pipeline
+ *          and read in place by the non-secure UI (NS_SPLIT)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NSSHARE_H
+#define APP_NSSHARE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#define NS_SHARE_MAGIC 0x4853534EU /* "NSSH" */
+#define NS_SHARE_VERSION 1U
+#define NS_SHARE_SLOTS 3U
+
+/* state: index of the latest slot, with NS_SHARE_FRESH until the reader
+ * takes it. The writer owns one other slot and the reader the third, so a
+ * result read in place never changes under the reader */
+#define NS_SHARE_INDEX_MASK 0x3U
+#define NS_SHARE_FRESH 0x4U
+
+/* Layout both images build against: version and size are checked at attach.
+ * Non-cacheable on both sides: the secure and non-secure aliases of the same
+ * RAM are separate lines in the D-cache */
+typedef struct __attribute__((aligned(32))) {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  volatile uint32_t state;
+  uint32_t published; /* Results published since start */
+  uint32_t reserved[3];
+  nn_result_t slots[NS_SHARE_SLOTS];
+} ns_shared_t;
+
+/**
+ * @brief  Take the latest result, in place
+ * @param  shared: Block returned by SECURE_NS_Attach()
+ * @param  front: Reader's slot, kept by the caller between calls; start at 0
+ * @retval Result to read until the next call; the one before when nothing new
+ *         was published. Zero-filled before the first publish
+ * @note   Single reader. Runs on either side: no gateway call involved
+ */
+static inline const nn_result_t *NSShare_Acquire(ns_shared_t *shared, uint32_t *front) {
+  if (shared->state & NS_SHARE_FRESH) {
+    *front = __atomic_exchange_n(&shared->state, *front, __ATOMIC_ACQ_REL) & NS_SHARE_INDEX_MASK;
+  }
+  return &shared->slots[*front];
+}
+
+#if NS_SPLIT
+
+/**
+ * @brief  Prepare the shared block and open it and the gateways to the
+ *         non-secure side in the SAU
+ * @note   Called from App_Init() before the kernel starts
+ */
+void NSShare_Init(void);
+
+/**
+ * @brief  Publish a result to the non-secure side
+ * @param  result: Result just published by the post-processing thread
+ * @note   Single writer (post-processing thread); never blocks
+ */
+void NSShare_Publish(const nn_result_t *result);
+
+/**
+ * @brief  Non-secure alias of the shared block
+ */
+ns_shared_t *NSShare_GetNsAlias(void);
+
+#endif /* NS_SPLIT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_NSSHARE_H */
@@ -0,0 +1,249 @@
+/**
+ ******************************************************************************
+ * @file    app_overlay.h
+ * @author  Long Liangmao
+ * @brief   DMA2D command ring renderer for STM32N6570-DK
+ *          Box edges as register-to-memory fills, labels blended from an
+ *          A8 glyph atlases built once from Font16 and Font12, constant
+ *          labels from cached strips, UTIL_LCD panel drawing
+ *          queued behind them; the transfer-complete interrupt chains jobs
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_OVERLAY_H
+#define APP_OVERLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Command ring slots (power of two): 4 per box outline, 1 per glyph, 1 per
+ * label background, the erase of the boxes previously drawn into the same
+ * buffer and the UTIL_LCD panel drawing. A full ring drains before queuing */
+#define OVERLAY_MAX_CMDS 2048
+
+/* Staging arena for UTIL_LCD pixel rows (panel text, one glyph cell per
+ * character); a full arena drains the ring before it is reused */
+#define OVERLAY_STAGING_SIZE (32 * 1024)
+
+/* Entries of the DMA2D foreground CLUT */
+#define OVERLAY_CLUT_MAX 256
+
+/* Glyph cells of the atlases (Font16, Font12) */
+#define OVERLAY_GLYPH_WIDTH 11
+#define OVERLAY_GLYPH_HEIGHT 16
+#define OVERLAY_GLYPH12_WIDTH 7
+#define OVERLAY_GLYPH12_HEIGHT 12
+
+/* Constant labels kept as pre-rasterized A8 strips (Overlay_DrawLabel) */
+#define OVERLAY_LABEL_CACHE_NB 32
+#define OVERLAY_LABEL_ARENA_SIZE (24 * 1024)
+
+/* Threads that may block in Overlay_WaitFence() at the same time */
+#define OVERLAY_WAITERS_MAX 4
+
+/**
+ * @brief  Fonts with a glyph atlas
+ */
+typedef enum {
+  OVERLAY_FONT_16 = 0,
+  OVERLAY_FONT_12 = 1,
+  OVERLAY_FONT_NB,
+} overlay_font_t;
+
+/**
+ * @brief  Position in the command ring: the commands queued before it
+ */
+typedef uint32_t overlay_fence_t;
+
+/**
+ * @brief  Drawing context: a UI frame buffer and the rectangle drawn into
+ * @note   Owned by the caller. Contexts carry no other state, so threads
+ *         draw concurrently through their own (distinct regions or buffers);
+ *         their commands interleave on the one DMA2D ring
+ */
+typedef struct {
+  uint8_t *target; /* UI_LAYER_WIDTH x UI_LAYER_HEIGHT, UI_LAYER_FORMAT */
+  int16_t x0;      /* Clip rectangle in layer coordinates, x1/y1 exclusive */
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+} overlay_ctx_t;
+
+/**
+ * @brief  Build the glyph atlases, enable the DMA2D interrupt and route
+ *         UTIL_LCD drawing to the command ring
+ * @note   Must be called after LCD_Init(): replaces its UTIL_LCD driver. The
+ *         UTIL_LCD fills, lines, pixels and text rows are then queued like
+ *         the Overlay_* calls, into the Overlay_SetLcdContext() context
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Overlay_Init(void);
+
+/**
+ * @brief  Set up a drawing context
+ * @param  target: UI_LAYER_WIDTH x UI_LAYER_HEIGHT UI frame buffer (UI_LAYER_FORMAT)
+ * @param  x, y, width, height: Clip rectangle, within the UI layer
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Overlay_CtxInit(overlay_ctx_t *ctx, uint8_t *target, int32_t x, int32_t y,
+                     int32_t width, int32_t height);
+
+/**
+ * @brief  Select the context UTIL_LCD drawing is queued into
+ * @param  ctx: Kept by reference until replaced
+ * @note   UTIL_LCD keeps its colors, font and layer in globals: it stays a
+ *         single-thread API, the Overlay_* calls are the concurrent one
+ */
+void Overlay_SetLcdContext(const overlay_ctx_t *ctx);
+
+/**
+ * @brief  Queue a solid rectangle fill (clipped to the context)
+ */
+void Overlay_FillRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      uint32_t color);
+
+/**
+ * @brief  Queue a rectangle outline as four edge fills
+ * @param  thickness: Edge thickness in pixels, drawn inwards
+ */
+void Overlay_DrawRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      int32_t thickness, uint32_t color);
+
+/**
+ * @brief  Queue a text string blended over the target, one command per glyph
+ * @param  text: ASCII string (characters outside 0x20..0x7E are skipped)
+ * @param  font: Atlas to draw from
+ * @retval Width of the string in pixels
+ */
+int32_t Overlay_DrawText(const overlay_ctx_t *ctx, int32_t x, int32_t y, const char *text,
+                         overlay_font_t font, uint32_t color);
+
+/**
+ * @brief  Queue a constant label as one blend of its cached A8 strip
+ * @param  text: String that never changes for this address (a literal): the
+ *         strip is rasterized on first use and looked up by address after
+ * @param  font: Atlas to draw from
+ * @retval Width of the string in pixels
+ * @note   Falls back to Overlay_DrawText() once the cache is full
+ */
+int32_t Overlay_DrawLabel(const overlay_ctx_t *ctx, int32_t x, int32_t y, const char *text,
+                          overlay_font_t font, uint32_t color);
+
+/**
+ * @brief  Queue an L8 index map shown through a CLUT, blended over the target
+ * @param  index_map: width x height indices, packed rows, kept until Overlay_Wait()
+ * @param  clut: clut_nb ARGB8888 entries (e.g. sseg_deeplabv3_pp_build_clut()),
+ *         kept until Overlay_Wait(); the entry alpha blends each pixel
+ * @note   One DMA2D pass at 1 byte per source pixel: for segmentation class
+ *         maps, no RGB expansion on the CPU. Queued whole or not at all
+ */
+void Overlay_DrawIndexMap(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                          const uint8_t *index_map, const uint32_t *clut, uint32_t clut_nb);
+
+/**
+ * @brief  Queue a window of an RGB565 image converted over the target
+ * @param  image: First pixel of the window, read by the DMA2D until
+ *         Overlay_Wait(); the caller keeps it coherent (non-cacheable or
+ *         cleaned)
+ * @param  stride: Row pitch of the image in pixels
+ * @note   One DMA2D pass with pixel format conversion, 1:1: the DMA2D has no
+ *         scaler. For camera frame crops. Queued whole or not at all
+ */
+void Overlay_DrawRGB565(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                        const uint8_t *image, uint32_t stride);
+
+/**
+ * @brief  Queue the copy of a rectangle from another UI frame buffer
+ * @param  source: UI frame buffer (same layout as the target) holding the
+ *         rectangle at the same coordinates, e.g. the front buffer
+ * @note   Brings a stale back buffer up to date without redrawing: one DMA2D
+ *         pass. Reading the front buffer while it is scanned out is safe.
+ *         Queued whole or not at all
+ */
+void Overlay_CopyRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      const uint8_t *source);
+
+/**
+ * @brief  Queue the copy of a rectangle from another UI frame buffer, read
+ *         dx columns to the right of it: scrolls its content left
+ * @param  source: UI frame buffer (same layout as the target)
+ * @param  dx: Source column offset, the source rectangle inside the layer
+ * @note   A scrolling graph moves its history in one DMA2D pass and draws
+ *         only the new columns. Queued whole or not at all
+ */
+void Overlay_ScrollRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                        const uint8_t *source, int32_t dx);
+
+/**
+ * @brief  Queue the composition of a camera frame and the UI layer above it
+ *         into an RGB565 frame, outside the UI layer
+ * @param  dst: width x height RGB565 output, packed rows
+ * @param  camera: width x height RGB565 camera frame, packed rows, read by
+ *         the DMA2D until Overlay_Wait()
+ * @param  ui: UI frame buffer shown over the camera frame
+ * @param  ui_x: UI layer column over the first camera column; the columns
+ *         past UI_LAYER_WIDTH are copied as they are
+ * @note   One DMA2D blend pass, and a copy of the uncovered columns: burns
+ *         the display overlay into the video encoder input
+ */
+void Overlay_ComposeRGB565(uint8_t *dst, const uint8_t *camera, const uint8_t *ui, int32_t ui_x,
+                           int32_t width, int32_t height);
+
+/**
+ * @brief  Queue the composition of the screen as LTDC shows it into an
+ *         RGB565 frame: the UI layer over the camera layer
+ * @param  dst: LCD_WIDTH x LCD_HEIGHT RGB565 output, packed rows
+ * @param  camera: Letterbox frame on layer 0, at DISPLAY_LETTERBOX_X0 as
+ *         LCD_Init places it, read by the DMA2D until Overlay_Wait()
+ * @param  ui: UI frame buffer on layer 1 from the left edge, NULL when the
+ *         layer is hidden
+ * @note   Outside the camera window the UI layer blends over the black
+ *         background
+ */
+void Overlay_ComposeScreenRGB565(uint8_t *dst, const uint8_t *camera, const uint8_t *ui);
+
+/**
+ * @brief  Publish the queued commands to the DMA2D, which runs them in the
+ *         background from its transfer-complete interrupt
+ * @retval Fence after the published commands (Overlay_WaitFence)
+ * @note   Queuing may go on while they run; later commands wait for the next
+ *         submit. Publishes what every thread queued so far
+ */
+overlay_fence_t Overlay_Submit(void);
+
+/**
+ * @brief  Block until the commands before a fence have been drawn
+ * @param  fence: Value returned by Overlay_Submit()
+ * @note   Up to OVERLAY_WAITERS_MAX threads at once
+ */
+void Overlay_WaitFence(overlay_fence_t fence);
+
+/**
+ * @brief  Block until every submitted command has been drawn
+ */
+void Overlay_Wait(void);
+
+/**
+ * @brief  DMA2D interrupt handler (call from DMA2D_IRQHandler)
+ */
+void Overlay_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_OVERLAY_H */
@@ -0,0 +1,134 @@
+/**
+ ******************************************************************************
+ * @file    app_params.h
+ * @author  Long Liangmao
+ * @brief   Runtime parameters for STM32N6570-DK (PARAMS_ENABLE)
+ *          Typed table of the settings tuned on a running unit, set over
+ *          the telemetry link by telemetry.ps1 and stored in the octoFlash
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PARAMS_H
+#define APP_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#define PARAM_TYPE_INT 0U
+#define PARAM_TYPE_FLOAT 1U
+
+/* Thread priorities a parameter may ask for */
+#define PARAMS_PRIORITY_MAX 31
+
+/* Parameters: X(id, "name", type, min, max, step, default, keep). A value
+ * off the step grid from min is refused (step 0: any); keep 1 also accepts
+ * 0, which leaves the setting as built. telemetry.ps1 reads the names and
+ * types from this table; append, so stored ids keep their meaning */
+#define PARAMS_TABLE(X)                                                                                         \
+  X(CAM_FPS, "cam.fps", PARAM_TYPE_INT, 10, CAMERA_FPS, 5, 0, 1)                                                \
+  X(PP_CONF, "pp.conf", PARAM_TYPE_FLOAT, 0.05f, 0.99f, 0, AI_OD_ST_YOLOX_PP_CONF_THRESHOLD, 0)                 \
+  X(PP_IOU, "pp.iou", PARAM_TYPE_FLOAT, 0.05f, 0.95f, 0, AI_OD_ST_YOLOX_PP_IOU_THRESHOLD, 0)                    \
+  X(DISPLAY_DEPTH, "display.depth", PARAM_TYPE_INT, 1, DISPLAY_BUFFER_NB - 3, 1, DISPLAY_BUFFER_NB - 3, 0)      \
+  X(PRIO_ISP, "prio.isp", PARAM_TYPE_INT, 1, PARAMS_PRIORITY_MAX, 1, 0, 1)                                      \
+  X(PRIO_NN, "prio.nn", PARAM_TYPE_INT, 1, PARAMS_PRIORITY_MAX, 1, 0, 1)                                        \
+  X(PRIO_PP, "prio.pp", PARAM_TYPE_INT, 1, PARAMS_PRIORITY_MAX, 1, 0, 1)                                        \
+  X(PRIO_UI, "prio.ui", PARAM_TYPE_INT, 1, PARAMS_PRIORITY_MAX, 1, 0, 1)                                        \
+  X(POWER_PROFILE, "power.profile", PARAM_TYPE_INT, 0, 2, 1, PROFILE_DEFAULT, 0)
+
+typedef enum {
+#define PARAM_ENUM(id, name, type, min, max, step, def, keep) PARAM_##id,
+  PARAMS_TABLE(PARAM_ENUM)
+#undef PARAM_ENUM
+  PARAM_NB,
+} param_id_t;
+
+/* Parameter record payload (TELEMETRY_TYPE_PARAMS): one parameter, sent for
+ * a get request and after each set. Values are int32 or IEEE-754 float bits
+ * by type. Little endian, no padding */
+#define PARAMS_NAME_MAX 24U
+
+#define PARAMS_FLAG_KEEP 0x01U     /* 0 accepted: the setting as built */
+#define PARAMS_FLAG_REJECTED 0x02U /* The last set of it was refused */
+#define PARAMS_FLAG_DIRTY 0x04U    /* The table changed since it was stored */
+#define PARAMS_FLAG_STORED 0x08U   /* A stored table exists */
+
+typedef struct __attribute__((packed)) {
+  uint32_t generation; /* Accepted changes since boot */
+  uint8_t id;          /* param_id_t */
+  uint8_t nb;          /* PARAM_NB */
+  uint8_t type;        /* PARAM_TYPE_ */
+  uint8_t flags;       /* PARAMS_FLAG_ */
+  uint32_t value;
+  uint32_t min;
+  uint32_t max;
+  uint32_t step;
+  uint32_t def;
+  char name[PARAMS_NAME_MAX]; /* NUL padded */
+} params_record_t;
+
+#if PARAMS_ENABLE
+
+/**
+ * @brief  Start from the defaults, then from the newest valid stored table
+ * @note   Called from App_Init(), while the octoFlash is memory-mapped
+ */
+void Params_Init(void);
+
+/**
+ * @brief  Value of an integer parameter
+ * @note   Any context
+ */
+int32_t Params_GetInt(param_id_t id);
+
+/**
+ * @brief  Value of a float parameter
+ * @note   Any context
+ */
+float Params_GetFloat(param_id_t id);
+
+/**
+ * @brief  Set a parameter from the host; refused when out of its range or
+ *         step. Either way its record is sent back
+ * @param  id: param_id_t, unchecked
+ * @param  value: int32 or IEEE-754 float bits, by type
+ * @note   Any context (telemetry command bytes)
+ */
+void Params_Set(uint32_t id, uint32_t value);
+
+/**
+ * @brief  Frame boundary of the inference thread: apply the sensor frame
+ *         rate and thread priorities that changed and store the table when
+ *         the host asked
+ * @note   Inference thread, NPU idle: the octoFlash leaves memory-mapped
+ *         mode while it is written
+ */
+void Params_FrameBoundary(void);
+
+/**
+ * @brief  Serve the host requests for the table and send the records due,
+ *         restore the defaults when asked
+ * @note   One thread (UI)
+ */
+void Params_Poll(void);
+
+#endif /* PARAMS_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PARAMS_H */
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file    app_pcprof.h
+ * @author  Long Liangmao
+ * @brief   Statistical PC sampler for STM32N6570-DK (PC_PROFILER)
+ *          TIM2 interrupt counting the interrupted PC and LR per code
+ *          address range; dumped as telemetry records on request and
+ *          symbolized by telemetry.ps1
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PCPROF_H
+#define APP_PCPROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Histogram record payload (TELEMETRY_TYPE_PCPROF): the non-zero buckets of
+ * one dump, in address order, PC histogram first. Bucket b covers
+ * [base + (b << shift), base + ((b + 1) << shift)). Little endian, no
+ * padding */
+#define PCPROF_ENTRIES_PER_RECORD 7U
+
+#define PCPROF_FLAG_LR 0x01U   /* Entries of the LR histogram */
+#define PCPROF_FLAG_LAST 0x02U /* Last record of the dump */
+
+typedef struct __attribute__((packed)) {
+  uint16_t bucket;
+  uint32_t count;
+} pcprof_entry_t;
+
+typedef struct __attribute__((packed)) {
+  uint16_t dump;    /* Dumps since boot, this one included */
+  uint8_t nb;       /* Entries in this record */
+  uint8_t flags;    /* PCPROF_FLAG_ */
+  uint32_t base;    /* Address of bucket 0 */
+  uint32_t samples; /* Samples of the dump, outside the buckets included */
+  uint8_t shift;    /* Bucket size, log2 bytes */
+  uint8_t reserved;
+  pcprof_entry_t entries[PCPROF_ENTRIES_PER_RECORD];
+} pcprof_record_t;
+
+#if PC_PROFILER
+
+/**
+ * @brief  Size the buckets to the application code and start the sampler
+ * @note   Called from App_Init()
+ */
+void PcProf_Init(void);
+
+/**
+ * @brief  Count one sample (called from TIM2_IRQHandler)
+ * @param  frame: Stack pointer of the interrupted context, at the handler
+ *         entry
+ * @param  exc_return: EXC_RETURN of the handler
+ */
+void PcProf_IRQHandler(const uint32_t *frame, uint32_t exc_return);
+
+/**
+ * @brief  Send the histograms when the host asked, at most
+ *         PC_PROFILER_DUMP_RECORDS records per call, then restart them
+ * @note   One thread (UI)
+ */
+void PcProf_Poll(void);
+
+#endif /* PC_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PCPROF_H */
@@ -0,0 +1,56 @@
+/**
+ ******************************************************************************
+ * @file    app_periodic.h
+ * @author  Long Liangmao
+ * @brief   Periodic work service for STM32N6570-DK
+ *          One ThreadX application timer raises the periodic event flags of
+ *          every client, on tick multiples of each period, so clients with
+ *          commensurate periods wake on the same tick
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PERIODIC_H
+#define APP_PERIODIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Clients of the timer wheel */
+#define PERIODIC_MAX_CLIENTS 8
+
+/**
+ * @brief  Create the timer wheel
+ * @note   Before the first Periodic_Register(); fail-fast on failure
+ */
+void Periodic_Init(void);
+
+/**
+ * @brief  Set event flags of a group every period
+ * @param  group: Created event flags group the client waits on
+ * @param  flags: Flags to OR in
+ * @param  period_ms: Period, rounded up to whole ThreadX ticks
+ * @note   The flags are set from the ThreadX timer thread when the tick
+ *         count is a multiple of the period. Fail-fast beyond
+ *         PERIODIC_MAX_CLIENTS
+ */
+void Periodic_Register(TX_EVENT_FLAGS_GROUP *group, ULONG flags, uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PERIODIC_H */
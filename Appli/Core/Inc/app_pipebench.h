@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file    app_pipebench.h
+ * @author  Long Liangmao
+ * @brief   End-to-end pipeline benchmark for STM32N6570-DK (PIPE_BENCH)
+ *          The sensor test pattern feeds the full capture, inference,
+ *          post-processing and overlay pipeline at the sensor rate; sustained
+ *          rates, per-stage p50/p99 latency, CPU load and NPU memory traffic
+ *          are printed every UI stats period
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PIPEBENCH_H
+#define APP_PIPEBENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if PIPE_BENCH
+
+#include "app_latency.h"
+
+/**
+ * @brief  Switch the sensor to its test pattern and reset the sample windows
+ * @note   Called from CAM_Init() once the sensor is probed; fail-fast: panics
+ *         if the sensor has no pattern generator
+ */
+void PipeBench_Init(void);
+
+/**
+ * @brief  Record the stage latencies of one result scanned out
+ * @param  stage_us: Latency of each latency_stage_t, in microseconds
+ * @note   UI thread context (Latency_RecordScanout())
+ */
+void PipeBench_Record(const uint32_t stage_us[LATENCY_STAGE_NB]);
+
+/**
+ * @brief  Print the window since the last call and start the next one
+ * @param  cpu_load_pct: CPU load over the stats period
+ * @note   UI thread context, every UI stats period
+ */
+void PipeBench_Update(uint32_t cpu_load_pct);
+
+#endif /* PIPE_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PIPEBENCH_H */
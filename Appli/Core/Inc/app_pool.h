@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file    app_pool.h
+ * @author  Long Liangmao
+ * @brief   Reference-counted fixed-block pools for STM32N6570-DK
+ *          ThreadX block pools carved once from the application byte pool:
+ *          a record is filled in place by its producer and handed to the
+ *          consumers by pointer, each holding a reference until it is done
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_POOL_H
+#define APP_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+#include <stdint.h>
+
+/**
+ * @brief  Pool of same-size records
+ */
+typedef struct {
+  TX_BLOCK_POOL pool;
+  uint32_t record_size; /* Payload bytes of a record */
+} app_pool_t;
+
+/**
+ * @brief  Create a pool
+ * @param  pool: Pool to create
+ * @param  name: ThreadX object name
+ * @param  record_size: Record payload in bytes
+ * @param  nb_records: Records in the pool
+ * @param  memory_ptr: Application byte pool (App_ThreadX_Init() argument);
+ *         the storage is allocated once and never returned
+ * @note   Fail-fast: panics if the byte pool is too small
+ */
+void Pool_Create(app_pool_t *pool, CHAR *name, uint32_t record_size, uint32_t nb_records, VOID *memory_ptr);
+
+/**
+ * @brief  Take a record, holding one reference to it
+ * @param  pool: Pool
+ * @param  wait: ThreadX wait option
+ * @retval Record (content undefined), NULL if none freed up within wait
+ */
+void *Pool_Alloc(app_pool_t *pool, ULONG wait);
+
+/**
+ * @brief  Take one more reference to a record
+ * @note   Any thread; the caller must already hold or guard a reference
+ */
+void Pool_Retain(void *record);
+
+/**
+ * @brief  Drop a reference; the last one returns the record to its pool
+ * @note   Any thread; NULL is ignored
+ */
+void Pool_Release(void *record);
+
+/**
+ * @brief  Records free in the pool
+ */
+uint32_t Pool_Available(app_pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_POOL_H */
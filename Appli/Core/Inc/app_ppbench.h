@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * @file    app_ppbench.h
+ * @author  Long Liangmao
+ * @brief   Post-processing benchmark for STM32N6570-DK
+ *          Replays network output tensors through the object detection post
+ *          processors and reports cycles per stage, stack and scratch use
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PPBENCH_H
+#define APP_PPBENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if PP_BENCH
+
+/* Recorded scenes at PPBENCH_SCENES_FLASH_ADDR, little endian: a blob header,
+ * nb_scenes scene records, then the raw tensor bytes */
+#define PPBENCH_BLOB_MAGIC 0x53425050U /* "PPBS" */
+#define PPBENCH_SCENE_NAME_LEN 12
+#define PPBENCH_MAX_TENSORS 3
+
+/* One network output, as the NPU left it */
+typedef struct {
+  uint32_t offset;    /* Bytes from the blob start */
+  uint32_t size;      /* Bytes */
+  float scale;        /* Quantization of int8 outputs, unused for float ones */
+  int32_t zero_point;
+} ppbench_tensor_t;
+
+typedef struct {
+  char name[PPBENCH_SCENE_NAME_LEN]; /* NUL padded */
+  uint32_t type;                     /* POSTPROCESS_* the outputs are for */
+  uint32_t nb_tensors;               /* In network output order */
+  ppbench_tensor_t tensors[PPBENCH_MAX_TENSORS];
+} ppbench_scene_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t nb_scenes;
+} ppbench_blob_t;
+
+/**
+ * @brief  Start the benchmark thread in place of the camera pipeline
+ * @param  memory_ptr: ThreadX memory pool (unused, static stack)
+ */
+void PPBench_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Stamp the start of a post-processing stage
+ * @param  stage: AI_OD_POSTPROCESS_STAGE_*
+ * @note   AI_OD_POSTPROCESS_STAGE_HOOK of the benchmark image
+ */
+void PPBench_Stage(int32_t stage);
+
+#endif /* PP_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PPBENCH_H */
@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ * @file    app_prefetch.h
+ * @author  Long Liangmao
+ * @brief   NPU weight prefetch for STM32N6570-DK
+ *          Stages the octoFlash weight tensors of upcoming epochs into an
+ *          AXISRAM ring while the current epoch runs
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PREFETCH_H
+#define APP_PREFETCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if WEIGHT_PREFETCH_ENABLE
+
+#include "ll_aton.h"
+
+/* Last completed inference of the active network */
+typedef struct {
+  uint32_t nb_tensors; /* Weight tensors in the prefetch schedule */
+  uint32_t hits;       /* Tensors read from the staging ring */
+  uint32_t misses;     /* Tensors read from octoFlash (not staged in time) */
+  uint32_t bytes;      /* Bytes staged from octoFlash */
+} prefetch_stats_t;
+
+/**
+ * @brief  Set up the copy DMA and hook every registered network
+ * @note   Called from NN_Init() after Profiler_Init(): the epoch callback
+ *         already set on a network is chained, not replaced
+ */
+void Prefetch_Init(void);
+
+/**
+ * @brief  Point a stream engine read at its staged copy, if complete
+ * @param  conf: Tensor setup, rewritten in place (stream engine hook)
+ * @note   During the first inference of a network, records the tensor instead
+ */
+void Prefetch_Rebase(LL_Streng_TensorInitTypeDef *conf);
+
+/**
+ * @brief  Stage the weights (default) or leave them read in place from the
+ *         octoFlash; a learned schedule is kept
+ * @note   Between inferences
+ */
+void Prefetch_SetEnabled(int enable);
+
+/**
+ * @brief  Copy the statistics of the last completed inference
+ */
+void Prefetch_GetStats(prefetch_stats_t *stats);
+
+/**
+ * @brief  Copy DMA interrupt handler (called from HPDMA1_Channel12_IRQHandler)
+ */
+void Prefetch_IRQHandler(void);
+
+#endif /* WEIGHT_PREFETCH_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PREFETCH_H */
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    app_preview.h
+ * @author  Long Liangmao
+ * @brief   Telemetry preview thumbnail for STM32N6570-DK
+ *          Low-rate luma thumbnail of the shown camera frame, sent as the
+ *          changed tiles only, delta and run-length coded
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PREVIEW_H
+#define APP_PREVIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Tile: PREVIEW_TILE_WIDTH pixels wide, PREVIEW_TILE_BYTES bytes, its lines
+ * in order, the left pixel in the high nibble at 4 bits. Tiles are numbered
+ * row-major over the thumbnail */
+#define PREVIEW_TILE_WIDTH 8U
+#define PREVIEW_TILE_BYTES 32U
+#define PREVIEW_TILE_HEIGHT ((PREVIEW_TILE_BYTES * 8U) / (PREVIEW_TILE_WIDTH * PREVIEW_BITS))
+
+/* Record payload (TELEMETRY_TYPE_PREVIEW): tiles of one thumbnail, each a
+ * 16-bit tile number, a byte count and that many PackBits bytes decoding to
+ * PREVIEW_TILE_BYTES. A control byte c < 0x80 takes the next c + 1 bytes
+ * as they are, c >= 0x80 repeats the next byte c - 0x7E times. A tile with
+ * PREVIEW_TILE_WHOLE is the tile itself, any other is XORed over the copy
+ * the host holds. Little endian, no padding */
+#define PREVIEW_TILE_WHOLE 0x8000U
+#define PREVIEW_DATA_MAX 48U
+
+#define PREVIEW_FLAG_LAST 0x01U /* Last record of the thumbnail */
+
+typedef struct __attribute__((packed)) {
+  uint16_t thumb;  /* Thumbnails since boot, this one included */
+  uint8_t nb;      /* Tiles in this record */
+  uint8_t flags;   /* PREVIEW_FLAG_ */
+  uint8_t bits;    /* Bits per pixel */
+  uint8_t tiles_x; /* Tiles per thumbnail row */
+  uint8_t tiles_y;
+  uint8_t reserved;
+  uint8_t data[PREVIEW_DATA_MAX];
+} preview_record_t;
+
+#if PREVIEW_ENABLE
+
+/**
+ * @brief  Build the next tile row of a due thumbnail and send its changed
+ *         tiles within the byte budget
+ * @note   One thread (UI)
+ */
+void Preview_Poll(void);
+
+#endif /* PREVIEW_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PREVIEW_H */
@@ -0,0 +1,127 @@
+/**
+ ******************************************************************************
+ * @file    app_profile.h
+ * @author  Long Liangmao
+ * @brief   Performance profiles for STM32N6570-DK (PROFILE_ENABLE)
+ *          Named sets of the operating point, sensor rate, inference
+ *          decimation, motion gate and overlay rate, switched at runtime,
+ *          with the rate measured and the power estimated under each
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PROFILE_H
+#define APP_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_dvfs.h"
+#include "app_qos.h"
+#include <stdint.h>
+
+/* Profiles: X(id, "name", operating point, sensor fps (0: as booted), ML
+ * decimation, motion gate, overlay period ms (0: every event), QoS preset).
+ * The index is the power.profile parameter: append, so stored values keep
+ * their meaning */
+#define PROFILE_TABLE(X)                                                                                    \
+  X(MAX_FPS, "max-fps", DVFS_POINT_OVERDRIVE, 0, 1, 0, 0, QOS_PRESET_THROUGHPUT)                            \
+  X(BALANCED, "balanced", DVFS_POINT_NOMINAL, 0, PROFILE_BALANCED_DECIMATION, 1, PROFILE_BALANCED_UI_PERIOD_MS, \
+    QOS_PRESET_DISPLAY)                                                                                     \
+  X(LOW_POWER, "low-power", DVFS_POINT_NOMINAL, PROFILE_LOW_POWER_FPS, PROFILE_LOW_POWER_DECIMATION, 1,       \
+    PROFILE_LOW_POWER_UI_PERIOD_MS, QOS_PRESET_DISPLAY)
+
+typedef enum {
+#define PROFILE_ENUM(id, name, point, fps, decimation, gate, ui_period_ms, qos) PROFILE_##id,
+  PROFILE_TABLE(PROFILE_ENUM)
+#undef PROFILE_ENUM
+  PROFILE_NB,
+} profile_id_t;
+
+/* Measurements under one profile, filtered over the stats periods it ran */
+typedef struct __attribute__((packed)) {
+  uint16_t fps_tenths; /* Inference rate, x10; 0: never ran */
+  uint16_t power_mw;   /* Estimated board power */
+  uint32_t time_ms;    /* Time spent in it since boot */
+} profile_stats_t;
+
+/* Profile record payload (TELEMETRY_TYPE_PROFILE): every UI stats period.
+ * Little endian, no padding */
+typedef struct __attribute__((packed)) {
+  uint8_t profile;    /* Active profile_id_t */
+  uint8_t nb;         /* PROFILE_NB */
+  uint8_t opp;        /* dvfs_point_t in use */
+  uint8_t decimation; /* Sensor frames per ML frame in use */
+  uint16_t sensor_fps;
+  uint16_t switches;  /* Profile changes since boot */
+  profile_stats_t stats[PROFILE_NB];
+} profile_record_t;
+
+#if PROFILE_ENABLE
+
+/**
+ * @brief  Ask for PROFILE_DEFAULT, applied at the first frame boundary
+ * @note   Called from App_Init(), after DVFS_Init()
+ */
+void Profile_Init(void);
+
+/**
+ * @brief  Ask for a profile
+ * @param  profile: profile_id_t
+ * @note   Any thread; applies at the next Profile_FrameBoundary()
+ */
+void Profile_Select(uint32_t profile);
+
+/**
+ * @brief  Cap the profile asked for: run at most as fast as a profile
+ * @param  profile: profile_id_t, PROFILE_MAX_FPS: no cap
+ * @note   Any thread (thermal governor); applies at the next frame boundary
+ */
+void Profile_SetFloor(uint32_t profile);
+
+/**
+ * @brief  Override the sensor rate of every profile
+ * @param  fps: A rate the sensor supports; 0: the rate of the profile
+ * @note   Any thread (cam.fps parameter); applies at the next frame boundary
+ */
+void Profile_SetFrameRate(int32_t fps);
+
+/**
+ * @brief  Frame boundary of the inference thread: move every setting to the
+ *         profile asked for, when it changed
+ * @note   Inference thread, NPU idle: the operating point switches here
+ */
+void Profile_FrameBoundary(void);
+
+/**
+ * @brief  Account a stats period to the active profile and send its record
+ * @param  frame_period_us: Last inference period
+ * @param  inference_us: Last NPU inference time
+ * @param  cpu_load_pct: CPU load over the stats period
+ * @note   UI stats period
+ */
+void Profile_Update(uint32_t frame_period_us, uint32_t inference_us, uint32_t cpu_load_pct);
+
+/**
+ * @brief  Active profile
+ */
+profile_id_t Profile_GetActive(void);
+
+#endif /* PROFILE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PROFILE_H */
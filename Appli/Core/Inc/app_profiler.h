@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file    app_profiler.h
+ * @author  Long Liangmao
+ * @brief   Per-epoch NPU profiler for STM32N6570-DK
+ *          DWT cycle stamps at each epoch block start/end, aggregated per
+ *          epoch over a window of frames
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_PROFILER_H
+#define APP_PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_npu_cache.h"
+#include <stdint.h>
+
+/* Highest epoch number tracked (od_yolo_x_person ends at epoch 226) */
+#define PROFILER_MAX_EPOCHS 256
+
+/* Frames aggregated before statistics are published */
+#define PROFILER_WINDOW_FRAMES 30
+
+/* Epoch kinds */
+#define PROFILER_EPOCH_HW 'H'     /* Pure HW epoch */
+#define PROFILER_EPOCH_SW 'S'     /* Pure SW epoch (runs on the CPU) */
+#define PROFILER_EPOCH_HYBRID 'M' /* Mixed HW/SW epoch */
+
+/**
+ * @brief  Aggregated timing of one epoch over the last window
+ */
+typedef struct {
+  int16_t epoch;  /* Epoch number */
+  char kind;      /* PROFILER_EPOCH_HW / _SW / _HYBRID */
+  uint32_t min_us;
+  uint32_t avg_us;
+  uint32_t max_us;
+  uint16_t read_miss_permille; /* NPU cache read misses, share of the epoch's reads */
+} profiler_epoch_stat_t;
+
+/**
+ * @brief  Hook the profiler into the network epoch callbacks
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Profiler_Init(void);
+
+/**
+ * @brief  Drop the frames of the open window, the next one starts afresh
+ * @note   Inference thread context, between inferences
+ */
+void Profiler_ResetWindow(void);
+
+/**
+ * @brief  Get the slowest epochs of the last published window
+ * @param  stats: Output array, sorted by decreasing average time
+ * @param  max_nb: Capacity of stats
+ * @retval Number of entries written
+ */
+uint32_t Profiler_GetSlowest(profiler_epoch_stat_t *stats, uint32_t max_nb);
+
+/**
+ * @brief  Get the NPU cache counters of an epoch range, per inference
+ * @param  first: First epoch of the range
+ * @param  last: Last epoch of the range (PROFILER_MAX_EPOCHS - 1: whole network)
+ * @param  stats: Output counters, averaged over the last published window
+ * @retval Inferences in the window, 0 before the first window is published
+ */
+uint32_t Profiler_GetCacheStats(int16_t first, int16_t last, npu_cache_counters_t *stats);
+
+/**
+ * @brief  Get the epoch the NPU is on
+ * @retval Epoch of the block in progress, or of the last one while the CPU
+ *         sets up the next; -1 outside inferences
+ * @note   Safe from interrupts
+ */
+int16_t Profiler_GetRunningEpoch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PROFILER_H */
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file    app_qos.h
+ * @author  Long Liangmao
+ * @brief   Interconnect QoS policy for STM32N6570-DK (QOS_ENABLE)
+ *          Bus priorities ranked display, camera, NPU, CPU; the NPU backed
+ *          off while the display underruns or a DCMIPP pipe overruns
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_QOS_H
+#define APP_QOS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Presets: X(id, "name", NPU read/write QoS, CPU read/write QoS), AXI QoS
+ * 0 (lowest) to 15 on the NPU interconnect ports. The index is
+ * QOS_PRESET_DEFAULT: append, so stored values keep their meaning */
+#define QOS_PRESET_TABLE(X)                      \
+  X(DISPLAY, "display", QOS_DISPLAY_NPU, QOS_CPU) \
+  X(THROUGHPUT, "throughput", QOS_THROUGHPUT_NPU, QOS_CPU)
+
+typedef enum {
+#define QOS_PRESET_ENUM(id, name, npu, cpu) QOS_PRESET_##id,
+  QOS_PRESET_TABLE(QOS_PRESET_ENUM)
+#undef QOS_PRESET_ENUM
+  QOS_PRESET_NB,
+} qos_preset_t;
+
+/**
+ * @brief  Policy counters since boot
+ */
+typedef struct {
+  uint8_t preset;                     /* Active qos_preset_t */
+  uint8_t npu_qos;                    /* NPU QoS in use, after the back-off */
+  uint8_t backoff;                    /* Levels the NPU is held under its preset */
+  uint32_t backoffs;                  /* Stats periods that backed the NPU off */
+  uint32_t periods[QOS_PRESET_NB];    /* Stats periods run under each preset */
+  uint32_t underruns[QOS_PRESET_NB];  /* LTDC underrun frames under each preset */
+  uint32_t overruns[QOS_PRESET_NB];   /* DCMIPP overrun frames, all pipes, under each preset */
+} qos_stats_t;
+
+#if QOS_ENABLE
+
+/**
+ * @brief  Put DCMIPP in dynamic QoS and the NPU and CPU ports at
+ *         QOS_PRESET_DEFAULT
+ * @note   After CAM_Init(), before the pipes start: the DCMIPP IP-plug is
+ *         locked while it is idle. Fail-fast: panics if it never goes idle
+ */
+void Qos_Init(void);
+
+/**
+ * @brief  Move the NPU and CPU ports to a preset; the back-off carries over
+ * @param  preset: qos_preset_t
+ * @note   Any thread (performance profile switch)
+ */
+void Qos_SetPreset(uint32_t preset);
+
+/**
+ * @brief  Account the display underruns and camera overruns of the stats
+ *         period to the active preset: any backs the NPU off one level, down
+ *         to QOS_NPU_FLOOR; QOS_RECOVER_PERIODS clean periods undo one
+ * @note   UI stats period
+ */
+void Qos_Update(void);
+
+/**
+ * @brief  Copy the policy counters
+ */
+void Qos_GetStats(qos_stats_t *stats);
+
+#endif /* QOS_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_QOS_H */
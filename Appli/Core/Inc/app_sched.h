@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file    app_sched.h
+ * @author  Long Liangmao
+ * @brief   Thread priority plan check for STM32N6570-DK
+ *          Response-time analysis of the vision pipeline threads at their
+ *          configured priorities and CPU budgets
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SCHED_H
+#define APP_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/**
+ * @brief  Check that the priority plan meets every pipeline deadline
+ * @param  fps: Sensor frame rate the camera runs at
+ * @note   Fail-fast: panics when the worst-case response time of the ISP,
+ *         inference, post-processing or UI thread exceeds its period
+ */
+void Sched_CheckPlan(int32_t fps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SCHED_H */
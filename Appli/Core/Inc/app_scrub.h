@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file    app_scrub.h
+ * @author  Long Liangmao
+ * @brief   Weight scrubbing for STM32N6570-DK (SCRUB_ENABLE)
+ *          The bound model binary re-read in the background through the
+ *          hardware CRC unit, chunk by chunk, against a sealed CRC table
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SCRUB_H
+#define APP_SCRUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+typedef struct {
+  uint32_t passes;     /* Passes completed, the sealing ones included */
+  uint32_t chunks;     /* Chunks in the binary, 0 without a header */
+  uint32_t mismatches; /* Chunks whose CRC left the table */
+  uint32_t last_addr;  /* Start of the last one */
+  uint32_t max_us;     /* Longest chunk, DMA and CRC */
+  uint8_t sealed;      /* The table matched the header sum */
+} scrub_stats_t;
+
+#if SCRUB_ENABLE
+
+/**
+ * @brief  Set up the CRC unit and its DMA channel for the bound model binary
+ * @note   Called once the model slot is bound, before Thread_Background_Init().
+ *         Fail-fast: panics on unrecoverable failures
+ */
+void Scrub_Init(void);
+
+/**
+ * @brief  CRC of the next chunk: into the table on the first pass, checked
+ *         against it on the others
+ * @retval 1 while the pass goes on, 0 once it is done
+ * @note   Background job (app_background.h): blocks on the DMA, at most
+ *         SCRUB_DMA_TIMEOUT_MS
+ */
+int Scrub_Step(void);
+
+/**
+ * @brief  Copy the scrubbing counters
+ */
+void Scrub_GetStats(scrub_stats_t *stats);
+
+/**
+ * @brief  CRC DMA interrupt handler (called from HPDMA1_Channel14_IRQHandler)
+ */
+void Scrub_IRQHandler(void);
+
+#endif /* SCRUB_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SCRUB_H */
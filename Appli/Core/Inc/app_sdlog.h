@@ -0,0 +1,109 @@
+/**
+ ******************************************************************************
+ * @file    app_sdlog.h
+ * @author  Long Liangmao
+ * @brief   Append-only telemetry log on the microSD card for STM32N6570-DK
+ *          (SD_LOG): the records in 64 KB segments written by the SDMMC
+ *          IDMA, and an index committed after each one
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SDLOG_H
+#define APP_SDLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_telemetry.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if SD_LOG
+
+/* On the card, 512-byte blocks from SD_LOG_FIRST_BLOCK on: two copies of the
+ * index in the first two blocks, then, from the next segment boundary, the
+ * segments. Segment n is at slot n % capacity: each one a header, then up to
+ * SDLOG_SEGMENT_RECORDS telemetry records, unencoded. Check
+ * words are FNV-1a. Little endian, no padding */
+#define SDLOG_BLOCK_SIZE 512U
+#define SDLOG_SEGMENT_BLOCKS (SD_LOG_SEGMENT_SIZE / SDLOG_BLOCK_SIZE)
+#define SDLOG_SEGMENT_RECORDS ((SD_LOG_SEGMENT_SIZE / TELEMETRY_RECORD_SIZE) - 1U)
+#define SDLOG_INDEX_MAGIC 0x4953364EU   /* "N6SI" */
+#define SDLOG_SEGMENT_MAGIC 0x4C53364EU /* "N6SL" */
+#define SDLOG_VERSION 1U
+
+/* Index copy: the valid one with the highest generation is the log */
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t segment_blocks; /* Blocks per segment */
+  uint32_t generation;     /* One per commit, copy generation % 2 */
+  uint32_t segments;       /* Segments committed since the log was created */
+  uint32_t capacity;       /* Segment slots on the card */
+  uint32_t boots;          /* Boots that appended to the log */
+  uint32_t first_block;    /* Block of index copy 0 */
+  uint32_t check;          /* Of the bytes above */
+} sdlog_index_t;
+
+/* First 64 bytes of a segment, in place of a record */
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint32_t seq;       /* Segment number: slot seq % capacity */
+  uint32_t boot;      /* Index boots of the writer */
+  uint32_t uptime_ms; /* Of the writer, when sealed */
+  uint16_t nb;        /* Records following */
+  uint16_t version;
+  uint32_t check;     /* Of the nb records */
+  uint8_t reserved[40];
+} sdlog_segment_header_t;
+
+_Static_assert(sizeof(sdlog_segment_header_t) == TELEMETRY_RECORD_SIZE, "Segment header takes one record slot");
+
+/**
+ * @brief  Logger counters since boot
+ */
+typedef struct {
+  uint32_t segments;     /* Segments written and committed */
+  uint32_t partial;      /* Of them, written partial at SD_LOG_COMMIT_MS */
+  uint32_t records;      /* Records in them */
+  uint32_t errors;       /* Card writes failed: their segment is lost */
+  uint32_t max_write_ms; /* Longest segment and index write */
+} sdlog_stats_t;
+
+/**
+ * @brief  Start the logger thread; it opens the card and its log
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   No card, or one the log cannot use, is not an error: nothing is
+ *         logged and the telemetry ring does not wait
+ */
+void Thread_SdLog_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Copy the logger counters
+ */
+void SdLog_GetStats(sdlog_stats_t *stats);
+
+/**
+ * @brief  SDMMC2 interrupt handler (called from SDMMC2_IRQHandler)
+ */
+void SdLog_IRQHandler(void);
+
+#endif /* SD_LOG */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SDLOG_H */
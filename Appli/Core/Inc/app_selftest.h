@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ * @file    app_selftest.h
+ * @author  Long Liangmao
+ * @brief   Golden-vector boot self-test for STM32N6570-DK (SELFTEST_ENABLE)
+ *          One inference of the boot network on a stored reference input,
+ *          checked against the outputs, detections and inference time
+ *          recorded with it
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SELFTEST_H
+#define APP_SELFTEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Vector at SELFTEST_FLASH_ADDR, built by selftest.ps1, little endian: the
+ * header, then the input at input_offset. Check words are FNV-1a. No
+ * padding */
+#define SELFTEST_MAGIC 0x54534C47U /* "GLST" */
+#define SELFTEST_TOP_NB 4U
+#define SELFTEST_FLAG_RECORDED 0x01U /* The golden fields hold a run */
+
+typedef struct __attribute__((packed)) {
+  float x_center; /* Network input coordinates, normalized to the frame */
+  float y_center;
+  float width;
+  float height;
+  float conf;
+  int32_t class_index;
+} selftest_detection_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint32_t model_version; /* Model slot header version it was recorded on, 0: any */
+  uint32_t input_offset;  /* Bytes from the vector start */
+  uint32_t input_size;    /* The network input buffer, as the NPU reads it */
+  uint32_t input_check;
+  uint32_t flags;         /* SELFTEST_FLAG_ */
+
+  /* Golden record */
+  uint32_t output_check;  /* Of the output tensors, in network order */
+  uint32_t budget_us;     /* Inference time not to exceed */
+  uint32_t nb_detect;     /* Detections of the run */
+  selftest_detection_t top[SELFTEST_TOP_NB]; /* The first of them, in post-processing order */
+
+  uint32_t check; /* Of the bytes above */
+} selftest_vector_t;
+
+typedef enum {
+  SELFTEST_NOT_RUN = 0,
+  SELFTEST_PASS,       /* Outputs bit-exact, within budget */
+  SELFTEST_DRIFT,      /* Outputs changed, detections within tolerance, within budget */
+  SELFTEST_FAIL,       /* Detections differ or over budget */
+  SELFTEST_UNRECORDED, /* No golden record: the values to record were printed */
+  SELFTEST_NO_VECTOR,  /* Missing, damaged, or for another model or input */
+} selftest_verdict_t;
+
+#if SELFTEST_ENABLE
+
+#include "od_pp_output_if.h"
+
+/**
+ * @brief  Reference input of the flashed vector
+ * @param  in_len: Bytes of the network input buffer
+ * @retval Memory-mapped input, NULL when the vector does not fit this
+ *         network and model (verdict SELFTEST_NO_VECTOR, reason printed)
+ * @note   NN_Init(), while the octoFlash is memory-mapped
+ */
+const uint8_t *SelfTest_GetInput(uint32_t in_len);
+
+/**
+ * @brief  Check one run on the reference input against the golden record,
+ *         print the verdict and keep it for the UI
+ * @param  output_check: FNV-1a of the output tensors, in network order
+ * @param  dets: Post-processed detections
+ * @param  nb: Number of detections
+ * @param  inference_us: Time of the run
+ * @note   NN_Init(), after an input from SelfTest_GetInput()
+ */
+void SelfTest_Check(uint32_t output_check, const od_pp_outBuffer_t *dets, uint32_t nb, uint32_t inference_us);
+
+/**
+ * @brief  Verdict of the boot self-test
+ * @note   Any thread; SELFTEST_NOT_RUN before NN_Init() got to it
+ */
+selftest_verdict_t SelfTest_GetVerdict(void);
+
+#endif /* SELFTEST_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SELFTEST_H */
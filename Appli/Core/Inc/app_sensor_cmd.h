@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file    app_sensor_cmd.h
+ * @author  Long Liangmao
+ * @brief   Sensor command queue for STM32N6570-DK
+ *          Sensor register writes batched in a hold group and sent over the
+ *          camera I2C by interrupts while the caller goes on
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SENSOR_CMD_H
+#define APP_SENSOR_CMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if SENSOR_CMD_ENABLE
+
+/**
+ * @brief  Route the camera middleware register accesses through the queue,
+ *         enable the I2C interrupts
+ * @note   Before CAM_Init(): the sensor drivers copy the accessors at probe
+ */
+void SensorCmd_Init(void);
+
+/**
+ * @brief  Open a batch: the register writes of the calling thread are queued
+ *         until SensorCmd_Submit()
+ * @note   Thread context. Sleeps until the previous batch is sent.
+ *         Fail-fast: panics when it failed on the bus
+ */
+void SensorCmd_Begin(void);
+
+/**
+ * @brief  Send the queued batch by interrupts and return; the next access
+ *         waits for its completion
+ * @note   Thread that opened the batch
+ */
+void SensorCmd_Submit(void);
+
+/**
+ * @brief  Camera I2C interrupt handlers (I2C1_EV_IRQHandler, I2C1_ER_IRQHandler)
+ */
+void SensorCmd_EvIRQHandler(void);
+void SensorCmd_ErIRQHandler(void);
+
+#endif /* SENSOR_CMD_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SENSOR_CMD_H */
@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ * @file    app_shell.h
+ * @author  Long Liangmao
+ * @brief   Console shell for STM32N6570-DK (SHELL_ENABLE)
+ *          Command lines from the telemetry host, answered as text records
+ *          by a low-priority thread, paced so the pipeline is not perturbed
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SHELL_H
+#define APP_SHELL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Longest command line, terminator included; a longer one is dropped */
+#define SHELL_LINE_MAX 48U
+
+#if SHELL_ENABLE
+
+/**
+ * @brief  Take one byte of a command line from the host
+ * @param  byte: Line byte; CR or LF ends the line, which is queued for the
+ *         shell thread (dropped when SHELL_QUEUE_LINES are waiting)
+ * @retval 1 while the line goes on, 0 once it ended
+ * @note   Telemetry_Command() context: one source at a time
+ */
+int Shell_Receive(uint8_t byte);
+
+/**
+ * @brief  Start the shell thread
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thread_Shell_Init(VOID *memory_ptr);
+
+#endif /* SHELL_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SHELL_H */
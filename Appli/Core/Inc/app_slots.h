@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ * @file    app_slots.h
+ * @author  Long Liangmao
+ * @brief   A/B slots for STM32N6570-DK
+ *          Slots picked by the FSBL, model slot binding of the relocatable
+ *          network and confirmation of a trial update
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SLOTS_H
+#define APP_SLOTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "boot_slots.h"
+#include <stdint.h>
+
+typedef struct {
+  uint32_t generation;    /* Slot table generation, 0 without a table */
+  uint32_t app_version;   /* Version the table names for the running slot */
+  uint32_t model_version; /* Header version of the bound model slot */
+  uint8_t app_slot;       /* BOOT_SLOT_A / _B */
+  uint8_t model_slot;
+  uint8_t rolled_back;    /* The FSBL or Slots_GetModelAddress() fell back */
+  uint8_t trial;          /* Unconfirmed generation */
+  uint32_t verify_passes; /* Slots_VerifyStep() passes over the bound binary */
+  uint32_t verify_errors; /* Passes whose sum no longer matched its header */
+} slots_info_t;
+
+/**
+ * @brief  Read the slots the FSBL picked on this boot
+ * @note   Called from App_Init() while the octoFlash is memory-mapped. A
+ *         debugger load, without the FSBL, takes the slots of the table
+ */
+void Slots_Init(void);
+
+/**
+ * @brief  Relocatable network binary of the model slot of this boot
+ * @retval Memory-mapped address of the binary
+ * @note   A slot with a damaged header or binary falls back to the other
+ *         one; fail-fast when neither holds a network
+ */
+uintptr_t Slots_GetModelAddress(void);
+
+/**
+ * @brief  Confirm a trial update: the FSBL keeps booting its slots
+ * @note   Called after each published inference; only the first one writes
+ */
+void Slots_Confirm(void);
+
+/**
+ * @brief  Re-sum the binary of the bound model slot, one
+ *         BACKGROUND_VERIFY_CHUNK a call, against its header checksum
+ * @retval 1 while the pass goes on, 0 once the sum was compared
+ * @note   Background job (app_background.h); a binary without a header
+ *         (debugger load) has nothing to verify
+ */
+int Slots_VerifyStep(void);
+
+/**
+ * @brief  Binary of the bound model slot and its header checksum
+ * @param  binary: Memory-mapped address
+ * @param  checksum: BootSlots_Sum() of its bytes, from the header
+ * @retval Size in bytes, 0 without a header (debugger load)
+ */
+uint32_t Slots_GetModelBinary(uintptr_t *binary, uint32_t *checksum);
+
+/**
+ * @brief  Copy the slot state of this boot
+ */
+void Slots_GetInfo(slots_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SLOTS_H */
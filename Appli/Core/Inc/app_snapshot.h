@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file    app_snapshot.h
+ * @author  Long Liangmao
+ * @brief   Event-triggered JPEG snapshots for STM32N6570-DK (SNAPSHOT_ENABLE)
+ *          A new confirmed track has the displayed frame, or a crop around
+ *          it, encoded by the hardware JPEG codec into a queue of images
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SNAPSHOT_H
+#define APP_SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if SNAPSHOT_ENABLE
+
+/* Track ID of a screenshot (SCREENSHOT_ENABLE): tracker IDs start at 1 */
+#define SNAPSHOT_SCREENSHOT_ID 0U
+
+/**
+ * @brief  One queued JPEG image
+ */
+typedef struct {
+  const uint8_t *data; /* JFIF, headers included */
+  uint32_t size;
+  uint32_t track_id;   /* Track whose confirmation triggered it, or SNAPSHOT_SCREENSHOT_ID */
+  uint32_t frame_id;   /* Sensor frame it was encoded from (buffer_frame_tag_t) */
+  uint32_t time_us;    /* Time_GetUs() at the trigger, low 32 bits */
+  uint16_t x, y;       /* Crop origin in the letterbox frame (the screen for a screenshot) */
+  uint16_t width, height;
+} snapshot_t;
+
+/**
+ * @brief  Snapshot counters since boot
+ */
+typedef struct {
+  uint32_t taken;     /* Images queued */
+  uint32_t screens;   /* Of them, screenshots */
+  uint32_t dropped;   /* Events lost: event queue or image queue full */
+  uint32_t missed;    /* Track no longer predicted at the displayed frame */
+  uint32_t overflows; /* Images larger than SNAPSHOT_MAX_SIZE */
+  uint32_t errors;    /* Codec or DMA errors and timeouts */
+  uint32_t encode_us; /* Last image, conversion and encode */
+} snapshot_stats_t;
+
+/**
+ * @brief  Set up the JPEG codec and its DMAs and start the snapshot thread
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thread_Snapshot_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Request a snapshot of a newly confirmed track
+ * @param  track_id: Tracker ID
+ * @note   Post-processing thread (Tracker_Update), never blocks
+ */
+void Snapshot_Trigger(uint32_t track_id);
+
+#if SCREENSHOT_ENABLE
+/**
+ * @brief  Request a screenshot of both LTDC layers
+ * @note   Any thread, never blocks
+ */
+void Snapshot_Screenshot(void);
+
+/**
+ * @brief  Take the screenshot host request ('C')
+ * @note   UI thread, after each update
+ */
+void Snapshot_Poll(void);
+#endif
+
+/**
+ * @brief  Take the oldest queued image
+ * @param  snap: Output image, valid until Snapshot_Release()
+ * @param  wait_ticks: ThreadX wait option
+ * @retval 1 when an image was taken, 0 on timeout
+ * @note   Single consumer, one image at a time
+ */
+int Snapshot_Acquire(snapshot_t *snap, ULONG wait_ticks);
+
+/**
+ * @brief  Give the image taken by Snapshot_Acquire() back to the queue
+ */
+void Snapshot_Release(void);
+
+/**
+ * @brief  Copy the snapshot counters
+ */
+void Snapshot_GetStats(snapshot_stats_t *stats);
+
+/**
+ * @brief  JPEG codec interrupt handler (call from JPEG_IRQHandler)
+ */
+void Snapshot_IRQHandler(void);
+
+/**
+ * @brief  JPEG input DMA interrupt handler (call from HPDMA1_Channel10_IRQHandler)
+ */
+void Snapshot_DmaInIRQHandler(void);
+
+/**
+ * @brief  JPEG output DMA interrupt handler (call from HPDMA1_Channel11_IRQHandler)
+ */
+void Snapshot_DmaOutIRQHandler(void);
+
+#endif /* SNAPSHOT_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SNAPSHOT_H */
@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ * @file    app_spsc.h
+ * @author  Long Liangmao
+ * @brief   Lock-free single-producer single-consumer ring for STM32N6570-DK
+ *          Fixed-size records handed from one ISR to one thread (or back)
+ *          without masking interrupts
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SPSC_H
+#define APP_SPSC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_error.h"
+#include "stm32n6xx_hal.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief  Ring state; head is written by the producer only, tail by the
+ *         consumer only. Both run free and wrap at 2^32
+ */
+typedef struct {
+  volatile uint32_t head; /* Records pushed */
+  volatile uint32_t tail; /* Records popped */
+  uint32_t mask;          /* Capacity - 1 */
+  uint32_t size;          /* Record size in bytes */
+  uint8_t *items;
+} spsc_t;
+
+/**
+ * @brief  Bind a ring to its record storage
+ * @param  q: Ring
+ * @param  items: nb records of size bytes
+ * @param  size: Record size in bytes
+ * @param  nb: Capacity, a power of two
+ * @note   Before either side runs; fail-fast if nb is not a power of two
+ */
+static inline void SPSC_Init(spsc_t *q, void *items, uint32_t size, uint32_t nb) {
+  APP_REQUIRE(nb != 0 && (nb & (nb - 1U)) == 0 && size != 0);
+  q->head = 0;
+  q->tail = 0;
+  q->mask = nb - 1U;
+  q->size = size;
+  q->items = (uint8_t *)items;
+}
+
+/**
+ * @brief  Producer side: copy one record in
+ * @retval 1 if pushed, 0 if the ring is full (the record is dropped)
+ */
+static inline int SPSC_Push(spsc_t *q, const void *item) {
+  const uint32_t head = q->head;
+
+  if (head - q->tail > q->mask) {
+    return 0;
+  }
+  memcpy(&q->items[(head & q->mask) * q->size], item, q->size);
+  /* Record visible before the head that publishes it */
+  __DMB();
+  q->head = head + 1U;
+  return 1;
+}
+
+/**
+ * @brief  Consumer side: copy the oldest record out
+ * @retval 1 if popped, 0 if the ring is empty
+ */
+static inline int SPSC_Pop(spsc_t *q, void *item) {
+  const uint32_t tail = q->tail;
+
+  if (q->head == tail) {
+    return 0;
+  }
+  /* Head read before the record it publishes */
+  __DMB();
+  memcpy(item, &q->items[(tail & q->mask) * q->size], q->size);
+  /* Record read before the producer may overwrite it */
+  __DMB();
+  q->tail = tail + 1U;
+  return 1;
+}
+
+/**
+ * @brief  Records waiting: a lower bound from the consumer, an upper bound
+ *         from the producer
+ */
+static inline uint32_t SPSC_Count(const spsc_t *q) {
+  return q->head - q->tail;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SPSC_H */
@@ -0,0 +1,72 @@
+/**
+ ******************************************************************************
+ * @file    app_swo.h
+ * @author  Long Liangmao
+ * @brief   SWO profiling build for STM32N6570-DK (SWO_PROFILER)
+ *          ITM stimulus words for the trace probes, DWT PC sampling and
+ *          exception trace on the SWO pin; folded into a flame graph by
+ *          swo_profile.ps1
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_SWO_H
+#define APP_SWO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if SWO_PROFILER
+
+/* Trace probe word on ITM port SWO_TRACE_PORT, one 32-bit packet so probes
+ * from any context never interleave: bits 0-7 trace_id_t, 8-9 phase (0 'B',
+ * 1 'E', 2 'i', 3 'C'), 10-15 tid (TRACE_TID_INIT as 0x3F), 16-31 value,
+ * saturated to int16 */
+#define SWO_EVENT_PHASE_SHIFT 8U
+#define SWO_EVENT_TID_SHIFT 10U
+#define SWO_EVENT_VALUE_SHIFT 16U
+#define SWO_EVENT_TID_INIT 0x3FU
+
+/* ATB id of the ITM source, for a formatted capture */
+#define SWO_ATB_ID 1U
+
+/**
+ * @brief  Route the trace clock and the SWO pin, then start ITM local
+ *         timestamps, DWT PC sampling and, with SWO_EXCEPTION_TRACE, the
+ *         exception trace
+ * @note   Called from App_Init(); the probe sets the SWO rate itself
+ */
+void Swo_Init(void);
+
+#if SWO_TRACE_EVENTS
+/**
+ * @brief  Write one trace probe word
+ * @param  id: trace_id_t
+ * @param  phase: TRACE_PHASE_
+ * @param  tid: Trace event tid
+ * @param  value: Event value
+ * @note   Any context, never blocks: dropped when the port is not ready
+ */
+void Swo_Event(uint32_t id, uint32_t phase, uint32_t tid, int32_t value);
+#endif
+
+#endif /* SWO_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_SWO_H */
@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file    app_telemetry.h
+ * @author  Long Liangmao
+ * @brief   Binary telemetry stream for STM32N6570-DK (TELEMETRY)
+ *          Fixed-size records queued by any context into a ring, COBS framed
+ *          and sent on USART1 by GPDMA; decoded by telemetry.ps1, which
+ *          sends its requests back on the RX line
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TELEMETRY_H
+#define APP_TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#if TELEMETRY
+
+/* On the wire: each record, header and payload, COBS encoded and followed by
+ * a 0x00 delimiter. Little endian, no padding */
+#define TELEMETRY_RECORD_SIZE 64U
+#define TELEMETRY_HEADER_SIZE 8U
+#define TELEMETRY_PAYLOAD_MAX (TELEMETRY_RECORD_SIZE - TELEMETRY_HEADER_SIZE)
+
+#define TELEMETRY_TYPE_TEXT 1U       /* printf() output, chunked */
+#define TELEMETRY_TYPE_RESULT 2U     /* telemetry_result_t, every inference */
+#define TELEMETRY_TYPE_DETECTIONS 3U /* telemetry_detections_t, rate limited */
+#define TELEMETRY_TYPE_SYSTEM 4U     /* telemetry_system_t, every UI stats period */
+#define TELEMETRY_TYPE_TRACE 5U      /* trace_record_t (app_trace.h), TRACE_DRAIN */
+#define TELEMETRY_TYPE_PCPROF 6U     /* pcprof_record_t (app_pcprof.h), on request */
+#define TELEMETRY_TYPE_PARAMS 7U     /* params_record_t (app_params.h), on request */
+#define TELEMETRY_TYPE_ISR 8U        /* isrprof_record_t (app_isrprof.h), every UI stats period */
+#define TELEMETRY_TYPE_PREVIEW 9U    /* preview_record_t (app_preview.h), changed tiles */
+#define TELEMETRY_TYPE_PROFILE 10U   /* profile_record_t (app_profile.h), every UI stats period */
+#define TELEMETRY_TYPE_TRACEX 11U    /* tracex_record_t (app_tracex.h), on request */
+#define TELEMETRY_TYPE_ANALYTICS 12U /* analytics_record_t (app_analytics.h), every ANALYTICS_PERIOD_MS */
+#define TELEMETRY_TYPE_THERMAL 13U   /* thermal_record_t (app_thermal.h), every THERMAL_PERIOD_MS */
+#define TELEMETRY_TYPE_NB 14U
+
+/* Readers taking records in place, besides the UART: each one attached
+ * holds the slots it has not released */
+#define TELEMETRY_DMA_READERS (ETH_PUBLISH || USB_STREAM_ENABLE || SD_LOG)
+
+typedef enum {
+  TELEMETRY_READER_ETH, /* UDP publisher (app_eth.c) */
+  TELEMETRY_READER_USB, /* USB CDC port (app_usb.c) */
+  TELEMETRY_READER_SD,  /* microSD log, copies out (app_sdlog.c) */
+  TELEMETRY_READER_NB,
+} telemetry_reader_t;
+
+/* Host requests: one byte each, from the USART1 RX line or the USB CDC
+ * port, raised until the module serving it takes it */
+typedef enum {
+  TELEMETRY_REQUEST_PCPROF,          /* 'P': dump the PC sampler histograms (app_pcprof.c) */
+  TELEMETRY_REQUEST_PARAMS_GET,      /* 'G': send the parameter table (app_params.c) */
+  TELEMETRY_REQUEST_PARAMS_STORE,    /* 'W': store it in the octoFlash */
+  TELEMETRY_REQUEST_PARAMS_DEFAULTS, /* 'D': back to the built values */
+  TELEMETRY_REQUEST_MEMMAP,          /* 'M': print the memory map and bandwidth budget (app_memmap.c) */
+  TELEMETRY_REQUEST_PREVIEW_KEY,     /* 'K': send the next preview thumbnail whole (app_preview.c) */
+  TELEMETRY_REQUEST_SCREENSHOT,      /* 'C': queue a screenshot JPEG (app_snapshot.c) */
+  TELEMETRY_REQUEST_TRACEX,          /* 'X': dump the TraceX buffer (app_tracex.c) */
+  TELEMETRY_REQUEST_NB,
+} telemetry_request_t;
+
+#define TELEMETRY_REQUEST_BYTES "PGWDMKCX" /* Indexed by telemetry_request_t */
+
+/* Parameter set command: TELEMETRY_SET_BYTE, then the parameter id, its
+ * 32-bit value (little endian) and a check byte, 0xFF minus the sum of the
+ * five bytes before it. A frame that fails the check is dropped whole */
+#define TELEMETRY_SET_BYTE 'S'
+#define TELEMETRY_SET_SIZE 6U /* Bytes after TELEMETRY_SET_BYTE */
+
+/* Shell command line: TELEMETRY_SHELL_BYTE, then text up to CR or LF, all of
+ * it for app_shell.c (SHELL_ENABLE) */
+#define TELEMETRY_SHELL_BYTE '>'
+
+typedef struct __attribute__((packed)) {
+  uint8_t type;
+  uint8_t len;      /* Payload bytes */
+  uint16_t seq;     /* One per reserved record: a gap is a drop */
+  uint32_t time_us; /* Time_GetUs() at the reservation, low 32 bits */
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+} telemetry_record_t;
+
+/* Stage latencies of one inference */
+typedef struct __attribute__((packed)) {
+  uint32_t frame_id;
+  uint32_t frame_count;
+  uint32_t vsync_to_npu_us;    /* Capture vsync to NPU outputs copied out */
+  uint32_t inference_us;
+  uint32_t postprocess_us;
+  uint32_t vsync_to_result_us; /* Capture vsync to post-processing done */
+  uint32_t frame_period_us;
+  uint16_t nb_detect;
+  uint8_t network;
+  uint8_t conf_threshold; /* Score threshold of the decode, x255 */
+  uint8_t stream;         /* Sensor of the frame: 0 main, 1 second (DUAL_STREAM_ENABLE) */
+} telemetry_result_t;
+
+/* Box in ML frame fractions (x65535), confidence x255 */
+typedef struct __attribute__((packed)) {
+  uint16_t x_center;
+  uint16_t y_center;
+  uint16_t width;
+  uint16_t height;
+  uint8_t conf;
+  uint8_t class_index;
+} telemetry_box_t;
+
+#define TELEMETRY_BOXES_PER_RECORD 4U
+
+/* Part of the detections of one frame: as many records as needed */
+typedef struct __attribute__((packed)) {
+  uint32_t frame_id;
+  uint8_t first; /* Index of boxes[0] in the frame */
+  uint8_t nb;    /* Boxes in this record */
+  uint8_t total; /* Boxes of the frame */
+  uint8_t reserved;
+  telemetry_box_t boxes[TELEMETRY_BOXES_PER_RECORD];
+} telemetry_detections_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t uptime_ms;
+  uint16_t fps_tenths;  /* Inference rate, x10 */
+  uint8_t cpu_load_pct;
+  uint8_t opp;          /* DVFS operating point (dvfs_point_t), 0xFF: not switched */
+  uint32_t sent;        /* Records sent since boot */
+  uint16_t dropped[TELEMETRY_TYPE_NB - 1U]; /* Records dropped since boot, per type from TELEMETRY_TYPE_TEXT, saturated */
+} telemetry_system_t;
+
+_Static_assert(sizeof(telemetry_record_t) == TELEMETRY_RECORD_SIZE, "Telemetry record layout");
+_Static_assert(sizeof(telemetry_result_t) <= TELEMETRY_PAYLOAD_MAX, "Result record overflows");
+_Static_assert(sizeof(telemetry_detections_t) <= TELEMETRY_PAYLOAD_MAX, "Detections record overflows");
+_Static_assert(sizeof(telemetry_system_t) <= TELEMETRY_PAYLOAD_MAX, "System record overflows");
+
+/**
+ * @brief  Open USART1 and its TX DMA; records queued before are sent then
+ * @note   Called from App_Init(), before the kernel starts
+ */
+void Telemetry_Init(void);
+
+/**
+ * @brief  Queue one record
+ * @param  type: TELEMETRY_TYPE_
+ * @param  payload: len bytes, at most TELEMETRY_PAYLOAD_MAX
+ * @retval 1 when queued, 0 when dropped (ring full)
+ * @note   Any context, never blocks
+ */
+int Telemetry_Send(uint32_t type, const void *payload, uint32_t len);
+
+/**
+ * @brief  Queue console text as text records
+ */
+void Telemetry_Text(const char *text, uint32_t len);
+
+/**
+ * @brief  Queue the stage latencies of a published result and, within the
+ *         detection rate, its boxes
+ * @note   Post-processing thread
+ */
+void Telemetry_PublishResult(const nn_result_t *result);
+
+/**
+ * @brief  Queue the system record
+ * @param  frame_period_us: Last inference period
+ * @param  cpu_load_pct: CPU load over the stats period
+ * @note   UI stats period
+ */
+void Telemetry_PublishSystem(uint32_t frame_period_us, uint32_t cpu_load_pct);
+
+#if TELEMETRY_DMA_READERS
+/**
+ * @brief  Attach or detach an in-place reader of the ring
+ * @param  reader: Reader slot
+ * @param  attached: 1: records queued from now on are kept until it
+ *         releases them; 0: the ring no longer waits for it
+ * @note   Only with no record acquired and unreleased
+ */
+void Telemetry_ReaderAttach(telemetry_reader_t reader, int attached);
+
+/**
+ * @brief  Take the next run of committed records, in place, for a DMA reader
+ * @param  reader: Attached reader slot
+ * @param  records: Output first record, cleaned from the D-cache
+ * @param  max: Records wanted
+ * @retval Records taken, contiguous in memory; 0 when none is ready
+ * @note   One context per reader
+ */
+uint32_t Telemetry_ReaderAcquire(telemetry_reader_t reader, const telemetry_record_t **records, uint32_t max);
+
+/**
+ * @brief  Give the oldest records acquired by a reader back to the ring
+ * @param  reader: Reader slot
+ * @param  nb: Records, in acquisition order
+ * @note   Any context (transfer completion)
+ */
+void Telemetry_ReaderRelease(telemetry_reader_t reader, uint32_t nb);
+#endif /* TELEMETRY_DMA_READERS */
+
+/**
+ * @brief  Take one byte from the host: a request byte raises its request,
+ *         a set command is handed to Params_Set() once complete, any other
+ *         byte is ignored
+ * @note   Any context; bytes of one command from a single source
+ */
+void Telemetry_Command(uint8_t byte);
+
+/**
+ * @brief  Test and clear a host request
+ * @retval 1 when raised since the previous call
+ * @note   Any context
+ */
+int Telemetry_TakeRequest(telemetry_request_t request);
+
+/**
+ * @brief  USART1 interrupt handler (called from USART1_IRQHandler): host bytes
+ */
+void Telemetry_UartIRQHandler(void);
+
+/**
+ * @brief  TX DMA interrupt handler (called from GPDMA1_Channel0_IRQHandler);
+ *         also pended by producers to start a transfer
+ */
+void Telemetry_IRQHandler(void);
+
+#endif /* TELEMETRY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TELEMETRY_H */
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file    app_thermal.h
+ * @author  Long Liangmao
+ * @brief   Thermal governor for STM32N6570-DK (THERMAL_ENABLE)
+ *          Junction temperature from the digital temperature sensor, held
+ *          under THERMAL_LIMIT_C by a floor on the performance profile
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_THERMAL_H
+#define APP_THERMAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* No valid sample yet */
+#define THERMAL_TEMP_NONE INT16_MIN
+
+/* Thermal record payload (TELEMETRY_TYPE_THERMAL): every THERMAL_PERIOD_MS.
+ * Temperatures in tenths of a degree Celsius. Little endian, no padding */
+typedef struct __attribute__((packed)) {
+  int16_t temp_dc;       /* Hotter of the two sensors, THERMAL_TEMP_NONE: none read */
+  int16_t max_dc;        /* Hottest since boot */
+  int16_t limit_dc;      /* THERMAL_LIMIT_C */
+  uint8_t floor;         /* Throttle level: profile_id_t floor, 0: not throttled */
+  uint16_t steps;        /* Throttle steps down since boot */
+  uint16_t faults;       /* Samples the sensors flagged faulty */
+  uint32_t throttled_ms; /* Time spent with a floor since boot */
+} thermal_record_t;
+
+#if THERMAL_ENABLE
+
+/**
+ * @brief  Start both sensors in continuous acquisition
+ * @note   Called from App_Init(), after Profile_Init()
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thermal_Init(void);
+
+/**
+ * @brief  Once THERMAL_PERIOD_MS is over: read the sensors, move the profile
+ *         floor and send the thermal record
+ * @note   One thread (UI)
+ */
+void Thermal_Poll(void);
+
+/**
+ * @brief  Last temperature read, in tenths of a degree Celsius
+ * @retval THERMAL_TEMP_NONE before the first valid sample
+ */
+int32_t Thermal_GetTemperature(void);
+
+#endif /* THERMAL_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_THERMAL_H */
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    app_threadprof.h
+ * @author  Long Liangmao
+ * @brief   Per-thread CPU and stack usage profiler for STM32N6570-DK
+ *          ThreadX execution profile run time, ISR and idle shares, and
+ *          stack high-water marks of every created thread
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_THREADPROF_H
+#define APP_THREADPROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Threads tracked (application threads plus the ThreadX timer thread) */
+#define THREADPROF_MAX_THREADS 8
+
+/* Bracket an interrupt handler so its time is charged to ISRs, not to the
+ * thread it preempted (SysTick is bracketed in tx_initialize_low_level.S) */
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#define THREADPROF_ISR_ENTER() _tx_execution_isr_enter()
+#define THREADPROF_ISR_EXIT() _tx_execution_isr_exit()
+#else
+#define THREADPROF_ISR_ENTER()
+#define THREADPROF_ISR_EXIT()
+#endif
+
+/**
+ * @brief  CPU and stack usage of one thread over the last window
+ */
+typedef struct {
+  const char *name;
+  uint32_t cpu_permille; /* Share of the window wall time */
+  uint32_t run_us;       /* Run time in the window */
+  uint32_t stack_size;   /* Bytes */
+  uint32_t stack_used;   /* High-water mark in bytes, since thread creation */
+} threadprof_thread_t;
+
+/**
+ * @brief  Last published profiler window
+ */
+typedef struct {
+  threadprof_thread_t threads[THREADPROF_MAX_THREADS];
+  uint32_t nb_threads;
+  uint32_t isr_permille;  /* Bracketed interrupt handlers */
+  uint32_t idle_permille; /* No thread ready (scheduler WFI) */
+  uint32_t window_us;     /* 0 before the first window completes */
+} threadprof_report_t;
+
+/**
+ * @brief  Start the first window
+ * @note   Call once all threads are created
+ */
+void ThreadProf_Init(void);
+
+/**
+ * @brief  Close the current window: publish it and, with THREAD_PROFILER_UART,
+ *         stream it on the ST-LINK virtual COM port
+ * @note   Call periodically from a single thread (UI stats period)
+ */
+void ThreadProf_Update(void);
+
+/**
+ * @brief  Get the last published window
+ * @param  report: Output report
+ * @note   Same thread as ThreadProf_Update()
+ */
+void ThreadProf_GetReport(threadprof_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_THREADPROF_H */
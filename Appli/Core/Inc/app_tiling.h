@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ * @file    app_tiling.h
+ * @author  Long Liangmao
+ * @brief   Full-FOV tiled inference merge and ROI window for STM32N6570-DK
+ *          Detections of every Pipe2 tile of a sweep, mapped to the sensor
+ *          field of view and merged across tile borders
+ *          ROI window: detections mapped back from the window, which then
+ *          follows them
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TILING_H
+#define APP_TILING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#if NN_TILING == NN_TILING_FULL_FOV
+
+#include "app_arena.h"
+#include "od_pp_output_if.h"
+
+/* Candidates kept per sweep, and the scratch Tiling_Merge() takes from its
+ * arena */
+#define TILING_MAX_CANDIDATES (2 * NN_MAX_DETECTIONS)
+#define TILING_SCRATCH_SIZE ARENA_SIZE_OF(uint8_t, TILING_MAX_CANDIDATES)
+
+/**
+ * @brief  Add the detections of one tile to the current sweep
+ * @param  tile: Pipe2 tile the frame was captured with
+ * @param  dets: Detections, tile coordinates
+ * @param  nb: Number of detections
+ * @retval 1 once every tile of the sweep has been added, 0 otherwise
+ * @note   A tile seen twice replaces its earlier detections
+ */
+int Tiling_AddTile(uint32_t tile, const od_pp_outBuffer_t *dets, uint32_t nb);
+
+/**
+ * @brief  Merge the sweep across tiles and start the next one
+ * @param  out: Merged detections, sensor FOV coordinates, highest confidence first
+ * @param  max_nb: Capacity of out
+ * @param  scratch: Frame arena, TILING_SCRATCH_SIZE bytes taken
+ * @retval Number of merged detections
+ */
+uint32_t Tiling_Merge(nn_detection_t *out, uint32_t max_nb, arena_t *scratch);
+
+#elif NN_TILING == NN_TILING_ROI
+
+#include "app_cam.h"
+#include "od_pp_output_if.h"
+
+/**
+ * @brief  Map the detections of one Pipe2 window to the sensor FOV
+ * @param  area: Window the frame was captured with
+ * @param  dets: Detections, window coordinates
+ * @param  nb: Number of detections
+ * @param  out: Detections, sensor FOV coordinates
+ */
+void Tiling_MapWindow(const cam_ml_tile_t *area, const od_pp_outBuffer_t *dets, uint32_t nb,
+                      nn_detection_t *out);
+
+/**
+ * @brief  Steer the Pipe2 window from the latest detections
+ * @param  dets: Detections, sensor FOV coordinates
+ * @param  nb: Number of detections
+ * @note   Post-processing thread; every NN_ROI_DISCOVERY_PERIOD frames, and
+ *         without detections, the window goes back to the whole sensor
+ */
+void Tiling_UpdateRoi(const nn_detection_t *dets, uint32_t nb);
+
+#endif /* NN_TILING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TILING_H */
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ * @file    app_time.h
+ * @author  Long Liangmao
+ * @brief   64-bit monotonic timebase for STM32N6570-DK
+ *          TIM5 free-running at 1 MHz (HAL tick source) plus a 64-bit
+ *          extension of the DWT cycle counter
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TIME_H
+#define APP_TIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* TIM5 compare interval that keeps the DWT extension ahead of CYCCNT wrap
+ * (2^32 cycles: ~5.4 s at 800 MHz) */
+#define TIME_DWT_REFRESH_US 1000000U
+
+/**
+ * @brief  Start (or re-derive after a clock change) the timebase
+ * @param  irq_priority: TIM5 interrupt priority
+ * @note   Called through HAL_InitTick(); the count stays monotonic across calls
+ */
+void Time_Init(uint32_t irq_priority);
+
+/**
+ * @brief  Get microseconds since the first Time_Init()
+ * @retval 64-bit monotonic time in microseconds
+ * @note   Safe from thread and ISR context
+ */
+uint64_t Time_GetUs(void);
+
+/**
+ * @brief  Get the DWT cycle counter extended to 64 bits
+ * @retval 64-bit monotonic CPU cycle count
+ * @note   Safe from thread and ISR context
+ */
+uint64_t Time_GetCycles64(void);
+
+/**
+ * @brief  Arm the TIM5 wake-up compare
+ * @param  deadline_us: Time_GetUs() value to raise the interrupt at
+ * @note   Called with interrupts masked (tickless idle); fires at once if
+ *         the deadline has already passed
+ */
+void Time_SetWakeup(uint64_t deadline_us);
+
+/**
+ * @brief  Disarm the TIM5 wake-up compare
+ */
+void Time_CancelWakeup(void);
+
+/**
+ * @brief  TIM5 interrupt handler: overflow count, DWT extension refresh, wake-up
+ */
+void Time_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TIME_H */
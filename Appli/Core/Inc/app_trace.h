@@ -0,0 +1,152 @@
+/**
+ ******************************************************************************
+ * @file    app_trace.h
+ * @author  Long Liangmao
+ * @brief   Pipeline trace events for STM32N6570-DK (TRACE_ENABLE)
+ *          Begin/end, instant and counter probes stamped with the DWT cycle
+ *          counter into a lock-free ring; drained as telemetry records or
+ *          left for the debugger, exported to Chrome trace JSON by
+ *          telemetry.ps1
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TRACE_H
+#define APP_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Probes: X(id, "category.name"). telemetry.ps1 reads the names from this
+ * table; append, so recorded ids keep their meaning */
+#define TRACE_ID_TABLE(X)                      \
+  X(DCMIPP_IRQ, "cam.dcmipp_irq")              \
+  X(CAM_VSYNC, "cam.vsync")                    \
+  X(CAM_FRAME, "cam.frame")                    \
+  X(ISP_UPDATE, "isp.update")                  \
+  X(NN_INFERENCE, "nn.inference")              \
+  X(NN_COPY_OUTPUTS, "nn.copy_outputs")        \
+  X(NPU_EPOCH, "nn.epoch")                     \
+  X(PP_DECODE, "pp.decode_nms")                \
+  X(PP_TRACKER, "pp.tracker")                  \
+  X(PP_DETECTIONS, "pp.detections")            \
+  X(LTDC_RELOAD, "lcd.ltdc_reload")            \
+  X(UI_UPDATE, "ui.update")                    \
+  X(PP_CANDIDATES, "pp.candidates")          \
+  X(ISP_APPLY, "isp.apply")
+
+typedef enum {
+#define TRACE_ENUM(id, name) TRACE_ID_##id,
+  TRACE_ID_TABLE(TRACE_ENUM)
+#undef TRACE_ENUM
+  TRACE_ID_NB,
+} trace_id_t;
+
+#define TRACE_PHASE_BEGIN 'B'
+#define TRACE_PHASE_END 'E'
+#define TRACE_PHASE_INSTANT 'i'
+#define TRACE_PHASE_COUNTER 'C'
+
+#define TRACE_TID_ISR 0U     /* Handler mode: every interrupt, nested in order */
+#define TRACE_TID_INIT 0xFFU /* Before the kernel runs */
+
+/* One event: in the ring, in the trace records and in a debugger dump.
+ * Little endian, no padding */
+typedef struct __attribute__((packed)) {
+  uint32_t cycles; /* DWT cycle counter */
+  int32_t value;   /* Counter value, or slice/instant argument */
+  uint8_t id;      /* trace_id_t */
+  uint8_t phase;   /* TRACE_PHASE_ */
+  uint8_t tid;     /* TRACE_TID_ISR, thread priority + 1 or TRACE_TID_INIT */
+  uint8_t lap;     /* Ring lap of the writer + 1, stored last: the event is complete */
+} trace_event_t;
+
+#if TRACE_ENABLE
+
+#define TRACE_EVENTS (1U << TRACE_EVENTS_LOG2)
+
+/* The ring, global so the debugger finds it: halt and dump trace_ring.
+ * Event n (n < head) is events[n % TRACE_EVENTS], valid while its lap is
+ * n / TRACE_EVENTS + 1 (mod 256) */
+typedef struct {
+  uint32_t magic;   /* TRACE_RING_MAGIC */
+  uint32_t head;    /* Events reserved since boot */
+  uint32_t tail;    /* Events drained (TRACE_DRAIN) */
+  uint32_t lost;    /* Events dropped, ring full (TRACE_DRAIN) */
+  uint32_t cpu_hz;  /* DWT rate */
+  uint32_t nb;      /* TRACE_EVENTS */
+  trace_event_t events[TRACE_EVENTS];
+} trace_ring_t;
+
+#define TRACE_RING_MAGIC 0x5254364EU /* "N6TR" */
+
+extern trace_ring_t trace_ring;
+
+/* Trace record payload (TELEMETRY_TYPE_TRACE): drain_cycles is the DWT
+ * count at the record's time_us, so every event gets a timebase */
+#define TRACE_EVENTS_PER_RECORD 4U
+
+typedef struct __attribute__((packed)) {
+  uint8_t nb;
+  uint8_t lost;          /* Events dropped since the previous record, saturated */
+  uint16_t cpu_mhz;
+  uint32_t drain_cycles;
+  trace_event_t events[TRACE_EVENTS_PER_RECORD];
+} trace_record_t;
+
+#define TRACE_BEGIN(id) Trace_Record(TRACE_ID_##id, TRACE_PHASE_BEGIN, 0)
+#define TRACE_BEGIN_ARG(id, arg) Trace_Record(TRACE_ID_##id, TRACE_PHASE_BEGIN, (int32_t)(arg))
+#define TRACE_END(id) Trace_Record(TRACE_ID_##id, TRACE_PHASE_END, 0)
+#define TRACE_INSTANT(id, arg) Trace_Record(TRACE_ID_##id, TRACE_PHASE_INSTANT, (int32_t)(arg))
+#define TRACE_COUNTER(id, v) Trace_Record(TRACE_ID_##id, TRACE_PHASE_COUNTER, (int32_t)(v))
+
+/**
+ * @brief  Reset the ring
+ * @note   Called from App_Init(), before the first probe
+ */
+void Trace_Init(void);
+
+/**
+ * @brief  Stamp one event
+ * @note   Any context, lock-free, never blocks: use the TRACE_ macros
+ */
+void Trace_Record(uint32_t id, uint32_t phase, int32_t value);
+
+#if TRACE_DRAIN
+/**
+ * @brief  Send the events recorded so far as telemetry records, at most
+ *         TRACE_DRAIN_RECORDS of them
+ * @note   One thread (UI)
+ */
+void Trace_Drain(void);
+#endif
+
+#else
+
+/* Compiled out: arguments are not evaluated */
+#define TRACE_BEGIN(id) ((void)0)
+#define TRACE_BEGIN_ARG(id, arg) ((void)sizeof(arg))
+#define TRACE_END(id) ((void)0)
+#define TRACE_INSTANT(id, arg) ((void)sizeof(arg))
+#define TRACE_COUNTER(id, v) ((void)sizeof(v))
+
+#endif /* TRACE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TRACE_H */
@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ * @file    app_tracex.h
+ * @author  Long Liangmao
+ * @brief   ThreadX TraceX event trace for STM32N6570-DK (TRACEX_ENABLE)
+ *          Kernel events and the pipeline probes in one TraceX buffer,
+ *          dumped as telemetry records on request and written out as a
+ *          .trx file by telemetry.ps1
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TRACEX_H
+#define APP_TRACEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+/* Dump record payload (TELEMETRY_TYPE_TRACEX): the buffer in order, from
+ * offset 0 to size, the TraceX header and registry first. Little endian,
+ * no padding */
+#define TRACEX_BYTES_PER_RECORD 44U
+
+#define TRACEX_FLAG_LAST 0x01U /* Last record of the dump */
+
+typedef struct __attribute__((packed)) {
+  uint16_t dump;   /* Dumps since boot, this one included */
+  uint8_t nb;      /* Bytes in this record */
+  uint8_t flags;   /* TRACEX_FLAG_ */
+  uint32_t offset; /* Of data[0] in the buffer */
+  uint32_t size;   /* Buffer bytes, the .trx file */
+  uint8_t data[TRACEX_BYTES_PER_RECORD];
+} tracex_record_t;
+
+/* User events: TX_TRACE_USER_EVENT_START + probe id * 4 + phase index */
+#define TRACEX_PHASE_INDEX_BEGIN 0U
+#define TRACEX_PHASE_INDEX_END 1U
+#define TRACEX_PHASE_INDEX_INSTANT 2U
+#define TRACEX_PHASE_INDEX_COUNTER 3U
+
+#if TRACEX_ENABLE
+
+/**
+ * @brief  Hand the buffer to the kernel and start tracing
+ * @note   Called from App_Init(); objects created before are registered too
+ * @note   Fail-fast: panics if the kernel rejects the buffer
+ */
+void TraceX_Init(void);
+
+/**
+ * @brief  Log one pipeline probe as a TraceX user event
+ * @param  id: trace_id_t
+ * @param  phase: TRACE_PHASE_
+ * @param  tid: Context of the probe (trace_event_t tid)
+ * @param  value: Probe argument
+ * @note   Any context, from Trace_Record()
+ */
+void TraceX_Event(uint32_t id, uint32_t phase, uint32_t tid, int32_t value);
+
+#if TELEMETRY
+/**
+ * @brief  Take the dump request, then send up to TRACEX_DUMP_RECORDS records
+ *         of the dump in progress; tracing restarts once the last is sent
+ * @note   One thread (UI)
+ */
+void TraceX_Poll(void);
+#endif
+
+#endif /* TRACEX_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TRACEX_H */
@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file    app_tracker.h
+ * @author  Long Liangmao
+ * @brief   Multi-object tracker for STM32N6570-DK
+ *          SORT-style: constant-velocity Kalman filters on the box center and
+ *          size, greedy IoU association, stable track IDs; boxes are
+ *          predicted to the display frames between inferences
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TRACKER_H
+#define APP_TRACKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_arena.h"
+#include "app_config.h"
+#include "app_nn.h"
+#include <stdint.h>
+
+#if TRACKER_ENABLE
+
+/* Scratch Tracker_Update() takes from its arena */
+#define TRACKER_SCRATCH_SIZE                                                           \
+  (ARENA_SIZE_OF(uint8_t, NN_MAX_DETECTIONS) + ARENA_SIZE_OF(uint8_t, TRACKER_MAX_TRACKS) + \
+   ARENA_SIZE_OF(uint32_t, TRACKER_MAX_TRACKS))
+
+/**
+ * @brief  Create the tracker lock and drop every track
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Tracker_Init(void);
+
+/**
+ * @brief  Associate the detections of one frame with the tracks
+ * @param  dets: Published detections
+ * @param  nb: Number of detections
+ * @param  frame_cycles: DWT vsync stamp of the frame they were computed on
+ * @param  scratch: Frame arena, TRACKER_SCRATCH_SIZE bytes taken
+ * @note   Post-processing thread
+ */
+void Tracker_Update(const nn_detection_t *dets, uint32_t nb, uint32_t frame_cycles, arena_t *scratch);
+
+/**
+ * @brief  Predict the confirmed tracks at a point in time
+ * @param  out: Predicted boxes, conf of the last associated detection
+ * @param  ids: Track ID of each box, may be NULL
+ * @param  max_nb: Capacity of out (and ids)
+ * @param  cycles: DWT stamp to predict at (the vsync of the frame on screen)
+ * @retval Number of boxes
+ * @note   Any thread
+ */
+uint32_t Tracker_Predict(nn_detection_t *out, uint32_t *ids, uint32_t max_nb, uint32_t cycles);
+
+/**
+ * @brief  Predict the confirmed tracks at a point in time, with their motion
+ * @param  out: Predicted boxes, conf of the last associated detection
+ * @param  vel: Box center velocity of each box, frame widths and heights per second
+ * @param  max_nb: Capacity of out (and vel)
+ * @param  cycles: DWT stamp to predict at
+ * @retval Number of boxes
+ * @note   Any thread
+ */
+uint32_t Tracker_PredictMotion(nn_detection_t *out, float (*vel)[2], uint32_t max_nb, uint32_t cycles);
+
+#endif /* TRACKER_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TRACKER_H */
@@ -26,6 +26,13 @@ extern "C" {
 
 #include <stdint.h>
 
+/* UI thread events */
+#define UI_EVENT_DETECTIONS 0x1U /* New inference result published */
+#define UI_EVENT_STATS 0x2U      /* Diagnostics refresh period elapsed (app_periodic.c) */
+#define UI_EVENT_VISIBILITY 0x4U /* UI_SetVisible() called */
+#define UI_EVENT_FRAME 0x8U      /* New camera frame on screen (TRACKER_ENABLE) */
+#define UI_EVENT_ALL (UI_EVENT_DETECTIONS | UI_EVENT_STATS | UI_EVENT_VISIBILITY | UI_EVENT_FRAME)
+
 /* CPU load history depth for averaging */
 #define CPU_LOAD_HISTORY_DEPTH 8
 
@@ -34,8 +41,8 @@ extern "C" {
  */
 typedef struct {
   struct {
-    uint32_t total; /* Total execution cycles */
-    uint32_t idle;  /* Idle thread cycles */
+    uint64_t total; /* Elapsed time (us, Time_GetUs) */
+    uint64_t idle;  /* Time asleep in the scheduler idle loop (us) */
     uint32_t tick;  /* Timestamp (ms) */
   } history[CPU_LOAD_HISTORY_DEPTH];
 } cpuload_info_t;
@@ -64,17 +71,49 @@ void UI_CPULoad_GetInfo(cpuload_info_t *cpu_load,
                         float *cpu_load_last_second,
                         float *cpu_load_last_five_seconds);
 
+/**
+ * @brief  Time spent asleep in the idle loop since UI_CPULoad_Init()
+ * @retval Idle time (us), against Time_GetUs()
+ */
+uint64_t UI_CPULoad_GetIdleUs(void);
+
 /**
  * @brief  Initialize the UI diagnostic display
- * @note   Must be called after LCD_Init()
+ * @note   Must be called after LCD_Init(), from a thread: blocks until the
+ *         DMA2D has cleared the layer buffers
  */
 void UI_Init(void);
 
 /**
- * @brief  Update and render diagnostic display
- * @note   Call this periodically from the display thread
+ * @brief  Wait for the next UI event
+ * @retval UI_EVENT_* mask; UI_EVENT_STATS is raised by the periodic service
+ * @note   UI thread context
+ */
+uint32_t UI_WaitEvents(void);
+
+/**
+ * @brief  Limit the overlay refresh rate: UI_WaitEvents() returns at most
+ *         once a period, with the events posted meanwhile merged
+ * @param  period_ms: Shortest period, rounded up to whole ThreadX ticks;
+ *         0: every event (as booted)
+ * @note   Any thread
+ */
+void UI_SetMinPeriod(uint32_t period_ms);
+
+/**
+ * @brief  Post UI events
+ * @param  events: UI_EVENT_* mask
+ * @note   Thread or ISR context; ignored before UI_Init()
+ */
+void UI_PostEvent(uint32_t events);
+
+/**
+ * @brief  Update the widgets the events concern and show the result
+ * @param  events: UI_EVENT_* mask from UI_WaitEvents()
+ * @note   UI thread context: boxes on detections (and on camera frames with
+ *         TRACKER_ENABLE), panel text on stats
  */
-void UI_Update(void);
+void UI_Update(uint32_t events);
 
 /**
  * @brief  Show/hide the diagnostic overlay
@@ -89,14 +128,14 @@ void UI_SetVisible(uint8_t visible);
 uint8_t UI_IsVisible(void);
 
 /**
- * @brief  Idle thread entry hook - call at start of idle loop iteration
- * @note   Call this from tx_application_define or idle thread entry
+ * @brief  Idle entry hook - call on sleep entry
+ * @note   Called from tx_low_power_enter() with interrupts masked
  */
 void UI_IdleThread_Enter(void);
 
 /**
- * @brief  Idle thread exit hook - call at end of idle loop iteration
- * @note   Call this from idle thread before yielding
+ * @brief  Idle exit hook - call on sleep exit
+ * @note   Called from tx_low_power_exit() with interrupts masked
  */
 void UI_IdleThread_Exit(void);
 
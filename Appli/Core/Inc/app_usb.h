@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file    app_usb.h
+ * @author  Long Liangmao
+ * @brief   USB composite device for STM32N6570-DK (USB_STREAM_ENABLE)
+ *          UVC camera sending the H.264 access units and CDC port sending
+ *          the telemetry records, both read in place by the OTG DMA
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_USB_H
+#define APP_USB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if USB_STREAM_ENABLE
+
+/**
+ * @brief  USB device counters since boot
+ */
+typedef struct {
+  uint32_t frames;      /* Access units sent on the UVC endpoint */
+  uint32_t drained;     /* Access units released unsent: not streaming, or waiting for an IDR */
+  uint32_t aborted;     /* Frames cut by the host stopping the stream or a bus reset */
+  uint32_t incompletes; /* Isochronous packets missed and repeated */
+  uint32_t video_bytes; /* Payload bytes, headers excluded */
+  uint32_t records;     /* Telemetry records sent on the CDC port */
+} usb_stats_t;
+
+/**
+ * @brief  Start the USB device and the thread feeding its endpoints
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Call once the encoder runs: the thread is its access unit
+ *         consumer. Fail-fast: panics on unrecoverable failures
+ */
+void Thread_Usb_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Copy the USB device counters
+ */
+void Usb_GetStats(usb_stats_t *stats);
+
+#endif /* USB_STREAM_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_USB_H */
@@ -0,0 +1,108 @@
+/**
+ ******************************************************************************
+ * @file    app_venc.h
+ * @author  Long Liangmao
+ * @brief   Hardware H.264 recording for STM32N6570-DK (VENC_ENABLE)
+ *          Displayed camera frames, with the overlay burned in by the DMA2D,
+ *          encoded by the VENC into a ring of access units for a stream
+ *          consumer
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_VENC_H
+#define APP_VENC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include "tx_api.h"
+#include <stdint.h>
+
+#if VENC_ENABLE
+
+/* SPS and PPS of the running stream, kept for consumers joining late */
+#define VENC_HEADER_MAX 128U
+
+/**
+ * @brief  One access unit in the bitstream ring
+ */
+typedef struct {
+  const uint8_t *data; /* Annex B byte stream, start codes included */
+  uint32_t size;
+  uint32_t frame_id;   /* Sensor frame it was encoded from (buffer_frame_tag_t) */
+  uint32_t time_us;    /* Presentation time since the stream started, at CAMERA_FPS */
+  uint8_t keyframe;    /* IDR frame: a decoder starts here, after the header */
+  uint8_t header;      /* SPS and PPS only (stream start or encoder restart) */
+} venc_au_t;
+
+/**
+ * @brief  Encoder counters since boot
+ */
+typedef struct {
+  uint32_t encoded;     /* Access units queued */
+  uint32_t skipped;     /* Frames not encoded: the ring lacked VENC_FRAME_MAX bytes or the pipeline was full */
+  uint32_t overflows;   /* Frames larger than VENC_FRAME_MAX, lost (next one is an IDR) */
+  uint32_t restarts;    /* Encoder re-initializations after a hardware error */
+  uint32_t bytes;       /* Bitstream bytes queued */
+  uint32_t encode_us;   /* Last frame, submitted to encoded: composition, encode and the wait between */
+} venc_stats_t;
+
+/**
+ * @brief  Power the VENC, open the encoder and start the recording thread
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Call once the display pipe runs. Fail-fast: panics on
+ *         unrecoverable failures
+ */
+void Thread_Venc_Init(VOID *memory_ptr);
+
+/**
+ * @brief  Take the oldest access unit of the ring
+ * @param  au: Output access unit, valid until Venc_Release()
+ * @param  wait_ticks: ThreadX wait option
+ * @retval 1 when an access unit was taken, 0 on timeout
+ * @note   Single consumer, one access unit at a time. Until released its
+ *         bytes are the consumer's: it may overwrite those already sent
+ */
+int Venc_Acquire(venc_au_t *au, ULONG wait_ticks);
+
+/**
+ * @brief  Give the access unit taken by Venc_Acquire() back to the ring
+ */
+void Venc_Release(void);
+
+/**
+ * @brief  Get the SPS and PPS of the running stream
+ * @param  data: Output header bytes, Annex B
+ * @retval Header size, 0 before the encoder started
+ */
+uint32_t Venc_GetHeader(const uint8_t **data);
+
+/**
+ * @brief  Copy the encoder counters
+ */
+void Venc_GetStats(venc_stats_t *stats);
+
+/**
+ * @brief  VENC interrupt handler (call from VENC_IRQHandler)
+ */
+void Venc_IRQHandler(void);
+
+#endif /* VENC_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_VENC_H */
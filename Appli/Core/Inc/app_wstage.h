@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file    app_wstage.h
+ * @author  Long Liangmao
+ * @brief   Boot-time NPU weight staging for STM32N6570-DK
+ *          Copies the octoFlash weights of every registered network to the
+ *          hyperRAM once at boot and rebases the weight reads on the copy
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_WSTAGE_H
+#define APP_WSTAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "app_config.h"
+#include <stdint.h>
+
+#if WEIGHT_STAGE_ENABLE
+
+#include "ll_aton.h"
+
+/* Boot copy, fixed after WStage_Init() */
+typedef struct {
+  uint32_t nb_spans; /* Distinct octoFlash extents, networks sharing weights merged */
+  uint32_t bytes;    /* Bytes copied to the hyperRAM */
+  uint32_t shared;   /* Bytes common to several networks, copied once */
+  uint32_t us;       /* Boot time of the copy */
+} wstage_stats_t;
+
+/**
+ * @brief  Copy the octoFlash weights of every registered network to the
+ *         hyperRAM staging window, blocking
+ * @note   Called from NN_Init() before the first inference, after the
+ *         relocatable network is installed. Fail-fast: the weights must fit
+ *         WEIGHT_STAGE_SIZE, those of several networks counted once
+ */
+void WStage_Init(void);
+
+/**
+ * @brief  Point a stream engine read of staged weights at the copy
+ * @param  conf: Tensor setup, rewritten in place (stream engine hook)
+ */
+void WStage_Rebase(LL_Streng_TensorInitTypeDef *conf);
+
+/**
+ * @brief  Read the weights from the copy (default) or in place from the
+ *         octoFlash
+ * @note   Between inferences
+ */
+void WStage_SetEnabled(int enable);
+
+/**
+ * @brief  Copy the boot copy figures
+ */
+void WStage_GetStats(wstage_stats_t *stats);
+
+#endif /* WEIGHT_STAGE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_WSTAGE_H */
@@ -40,8 +40,11 @@ extern "C" {
 /* ########################## Module Selection ############################## */
 /**
   * @brief This is the list of modules to be used in the HAL driver
+  *        The connected sensor is probed at init among them
   */
 #define USE_IMX335_SENSOR
+#define USE_VD55G1_SENSOR
+#define USE_VD66GY_SENSOR
 
 #ifdef __cplusplus
 }
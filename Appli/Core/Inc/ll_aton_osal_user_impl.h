@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file    ll_aton_osal_user_impl.h
+ * @author  Long Liangmao
+ * @brief   ThreadX OSAL for the ll_aton runtime (LL_ATON_OSAL_USER_IMPL)
+ *          The inference thread blocks on a semaphore released by the ATON
+ *          IRQ instead of spinning in WFE between epoch blocks
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LL_ATON_OSAL_USER_IMPL_H
+#define LL_ATON_OSAL_USER_IMPL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief  Create the epoch event semaphore
+ * @note   Called from LL_ATON_RT_RuntimeInit(); fail-fast on failure
+ */
+void NPU_OSAL_Init(void);
+
+/**
+ * @brief  Delete the epoch event semaphore
+ */
+void NPU_OSAL_DeInit(void);
+
+/**
+ * @brief  Wait for the next ATON event
+ * @note   Suspends the calling thread; falls back to __WFE() outside thread context
+ */
+void NPU_OSAL_Wfe(void);
+
+/**
+ * @brief  Signal an ATON event (ATON IRQ context)
+ */
+void NPU_OSAL_SignalEvent(void);
+
+/**
+ * @brief  Report whether the last NPU_OSAL_Wfe() ran out of time, and clear it
+ * @retval 1 after HEALTH_NPU_TIMEOUT_MS without an event (HEALTH_MONITOR)
+ */
+uint8_t NPU_OSAL_TakeTimeout(void);
+
+#define LL_ATON_OSAL_INIT() NPU_OSAL_Init()
+#define LL_ATON_OSAL_DEINIT() NPU_OSAL_DeInit()
+
+/* Wait for / signal event from ATON runtime */
+#define LL_ATON_OSAL_WFE() NPU_OSAL_Wfe()
+#define LL_ATON_OSAL_SIGNAL_EVENT() NPU_OSAL_SignalEvent()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LL_ATON_OSAL_USER_IMPL_H */
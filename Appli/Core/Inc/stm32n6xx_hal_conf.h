@@ -35,14 +35,14 @@ extern "C" {
   */
 #define HAL_MODULE_ENABLED
 /*#define HAL_ADC_MODULE_ENABLED   */
-/*#define HAL_BSEC_MODULE_ENABLED   */
-/*#define HAL_CRC_MODULE_ENABLED   */
+#define HAL_BSEC_MODULE_ENABLED
+#define HAL_CRC_MODULE_ENABLED
 /*#define HAL_CRYP_MODULE_ENABLED   */
 /*#define HAL_DCMI_MODULE_ENABLED   */
 #define HAL_DCMIPP_MODULE_ENABLED
 #define HAL_DMA2D_MODULE_ENABLED
-/*#define HAL_DTS_MODULE_ENABLED   */
-/*#define HAL_ETH_MODULE_ENABLED   */
+#define HAL_DTS_MODULE_ENABLED
+#define HAL_ETH_MODULE_ENABLED
 /*#define HAL_EXTI_MODULE_ENABLED   */
 /*#define HAL_FDCAN_MODULE_ENABLED   */
 /*#define HAL_GFXMMU_MODULE_ENABLED   */
@@ -54,8 +54,8 @@ extern "C" {
 /*#define HAL_I3C_MODULE_ENABLED   */
 /*#define HAL_ICACHE_MODULE_ENABLED   */
 /*#define HAL_IRDA_MODULE_ENABLED   */
-/*#define HAL_IWDG_MODULE_ENABLED   */
-/*#define HAL_JPEG_MODULE_ENABLED   */
+#define HAL_IWDG_MODULE_ENABLED
+#define HAL_JPEG_MODULE_ENABLED
 /*#define HAL_LPTIM_MODULE_ENABLED   */
 #define HAL_LTDC_MODULE_ENABLED
 /*#define HAL_MCE_MODULE_ENABLED   */
@@ -64,6 +64,11 @@ extern "C" {
 /*#define HAL_NAND_MODULE_ENABLED   */
 /*#define HAL_NOR_MODULE_ENABLED   */
 /*#define HAL_PCD_MODULE_ENABLED   */
+/* USB device of the remote ISP tuning link (cmake -DISP_TUNING=ON) or of
+ * the composite video and telemetry device (cmake -DUSB_STREAM=ON) */
+#if (defined(ISP_TUNING_ENABLE) && ISP_TUNING_ENABLE) || (defined(USB_STREAM_ENABLE) && USB_STREAM_ENABLE)
+#define HAL_PCD_MODULE_ENABLED
+#endif
 /*#define HAL_PKA_MODULE_ENABLED   */
 /*#define HAL_PSSI_MODULE_ENABLED   */
 #define HAL_RAMCFG_MODULE_ENABLED
@@ -71,7 +76,7 @@ extern "C" {
 /*#define HAL_RNG_MODULE_ENABLED   */
 /*#define HAL_RTC_MODULE_ENABLED   */
 /*#define HAL_SAI_MODULE_ENABLED   */
-/*#define HAL_SD_MODULE_ENABLED   */
+#define HAL_SD_MODULE_ENABLED
 /*#define HAL_SDIO_MODULE_ENABLED   */
 /*#define HAL_SDRAM_MODULE_ENABLED   */
 /*#define HAL_SMARTCARD_MODULE_ENABLED   */
@@ -57,6 +57,7 @@ void DCMIPP_IRQHandler(void);
 void CSI_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 void IAC_IRQHandler(void);
+void TIM5_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
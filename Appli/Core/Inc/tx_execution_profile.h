@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ * @file    tx_execution_profile.h
+ * @author  Long Liangmao
+ * @brief   ThreadX execution profile types for STM32N6570-DK
+ *          Pulled in by tx_api.h when TX_EXECUTION_PROFILE_ENABLE is set;
+ *          the port hooks are implemented in app_threadprof.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef TX_EXECUTION_PROFILE_H
+#define TX_EXECUTION_PROFILE_H
+
+/* Accumulated run time (CPU cycles) and its 32-bit source, the DWT cycle
+ * counter; per-run deltas stay well below one CYCCNT wrap */
+typedef unsigned long long EXECUTION_TIME;
+typedef unsigned long EXECUTION_TIME_SOURCE_TYPE;
+
+#define TX_EXECUTION_TIME_SOURCE (*(volatile EXECUTION_TIME_SOURCE_TYPE *)0xE0001004UL)
+
+/* Called by the port: kernel start, PendSV switch-in/out, ISR brackets */
+void _tx_execution_initialize(void);
+void _tx_execution_thread_enter(void);
+void _tx_execution_thread_exit(void);
+void _tx_execution_isr_enter(void);
+void _tx_execution_isr_exit(void);
+
+#endif /* TX_EXECUTION_PROFILE_H */
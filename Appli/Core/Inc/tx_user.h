@@ -156,7 +156,7 @@
    enabled. If the application does not use preemption-threshold, it may be disabled to reduce
    code size and improve performance.  */
 
-#define TX_DISABLE_PREEMPTION_THRESHOLD
+/*#define TX_DISABLE_PREEMPTION_THRESHOLD*/
 
 /* Determine if global ThreadX variables should be cleared. If the compiler startup code clears
    the .bss section prior to ThreadX running, the define can be used to eliminate unnecessary
@@ -269,6 +269,21 @@
 /* Define the user extension field of the thread control block.*/
 /*#define TX_THREAD_USER_EXTENSION                ????*/
 
+/* Sleep in WFI when no thread is ready, with the tick suppressed until the
+   next ThreadX timer (tx_low_power_enter/exit in app_threadx.c). */
+#define TX_LOW_POWER
+#define TX_ENABLE_WFI
+
+/* Per-thread run time for the thread profiler (THREAD_PROFILER in app_config.h):
+   PendSV and the SysTick handler call the hooks in app_threadprof.c. */
+#define TX_EXECUTION_PROFILE_ENABLE
+
+/* TraceX event trace (TRACEX_ENABLE in app_config.h, cmake -DTRACEX=ON):
+   the buffer is handed over by tx_trace_enable in app_tracex.c. */
+#if defined(TRACEX_ENABLE) && TRACEX_ENABLE
+#define TX_ENABLE_EVENT_TRACE
+#endif
+
 /* USER CODE END 2 */
 
 #endif
@@ -0,0 +1,96 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_conf.h
+  * @version        : v2.0_Cube
+  * @brief          : Header for usbd_conf.c file.
+  *                   USB device library configuration of the remote ISP
+  *                   tuning link (ISP_TUNING_ENABLE) or of the composite
+  *                   video and telemetry device (USB_STREAM_ENABLE)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 Long Liangmao.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_CONF__H__
+#define __USBD_CONF__H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_config.h"
+#include "main.h"
+#include "stm32n6xx.h"
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#if USB_STREAM_ENABLE
+#define USBD_MAX_NUM_INTERFACES     4U
+#else
+#define USBD_MAX_NUM_INTERFACES     1U
+#endif
+#define USBD_MAX_NUM_CONFIGURATION  1U
+#define USBD_MAX_STR_DESC_SIZ       512U
+#define USBD_DEBUG_LEVEL            0U
+#define USBD_LPM_ENABLED            0U
+#define USBD_SELF_POWERED           1U
+
+/* #define for FS and HS identification */
+#define DEVICE_FS                   0
+#define DEVICE_HS                   1
+
+/* Exported macro ------------------------------------------------------------*/
+/* Memory management macros: one class instance, statically allocated */
+#define USBD_malloc         (void *)USBD_static_malloc
+#define USBD_free           USBD_static_free
+#define USBD_memset         memset
+#define USBD_memcpy         memcpy
+
+/* DEBUG macros */
+#if (USBD_DEBUG_LEVEL > 0)
+#define USBD_UsrLog(...)    printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_UsrLog(...)
+#endif
+
+#if (USBD_DEBUG_LEVEL > 1)
+#define USBD_ErrLog(...)    printf("ERROR: ");\
+                            printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_ErrLog(...)
+#endif
+
+#if (USBD_DEBUG_LEVEL > 2)
+#define USBD_DbgLog(...)    printf("DEBUG : ");\
+                            printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_DbgLog(...)
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+void *USBD_static_malloc(uint32_t size);
+void USBD_static_free(void *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_CONF__H__ */
@@ -20,8 +20,51 @@
 #define UTILS
 
 #define ALIGN_32 __attribute__((aligned(32)))
+
+/* Cortex-M55 D-cache line: the unit of every SCB_*DCache_by_Addr() */
+#define CACHE_LINE_SIZE 32U
+
+/* State written from more than one context (threads, ISRs, idle hooks):
+ * grouped in .shared_state, whose ends the linker script aligns to cache
+ * lines, so no DMA buffer can share a line with it and an invalidate with
+ * loose bounds never discards a CPU write */
+#define SHARED_STATE __attribute__((section(".shared_state")))
+
+/* Build-time check on an object a bus master reads or writes behind the
+ * D-cache: it starts a line and fills its last one, so its maintenance
+ * covers it exactly */
+#define CACHE_LINES_CHECK(obj)                                                                  \
+  _Static_assert(__alignof__(obj) >= CACHE_LINE_SIZE && sizeof(obj) % CACHE_LINE_SIZE == 0, \
+                 #obj " does not own its cache lines")
 #define IN_PSRAM __attribute__((section(".psram_bss")))
 
+/* hyperRAM row (APS256XX): a burst crossing one pays the row latency again.
+ * PSRAM buffers start a row, so the bursts of buffers the DCMIPP, LTDC and
+ * DMA2D stream at the same time never share a row with a neighbour's tail */
+#define PSRAM_ROW_SIZE 2048U
+#define ALIGN_PSRAM_ROW __attribute__((aligned(PSRAM_ROW_SIZE)))
+
+/* Explicit buffer placement (see STM32N657XX_LRUN.ld) */
+#define IN_PSRAM_DISPLAY __attribute__((section(".psram_display")))
+#define IN_PSRAM_ML __attribute__((section(".psram_ml")))
+#define IN_PSRAM_UI __attribute__((section(".psram_ui")))
+#define IN_PSRAM_NN __attribute__((section(".psram_nn")))
+#define IN_PSRAM_STAGE __attribute__((section(".psram_stage"))) /* Boot DMA only, outside the MPU regions */
+#define IN_PSRAM_TRACE __attribute__((section(".psram_trace"))) /* Bounded by __psram_trace_start/_end */
+#define IN_AXISRAM3 __attribute__((section(".axisram3_bss")))
+#define IN_AXISRAM6 __attribute__((section(".axisram6_bss")))
+
+/* Hot code and data in the Cortex-M55 tightly coupled memories
+ * (STM32N657XX_LRUN.ld): single cycle, outside the caches. DTCM is for the
+ * CPU only: no DMA buffer there. IN_DTCM is zeroed at startup */
+#define IN_ITCM __attribute__((section(".itcm_text")))
+#define IN_DTCM __attribute__((section(".dtcm_bss")))
+#define IN_DTCM_DATA __attribute__((section(".dtcm_data")))
+
+/* Cold code executed in place from the octoFlash with APP_SPLIT_XIP
+ * (STM32N657XX_XIP.ld), otherwise in .text with the rest */
+#define IN_XIP __attribute__((section(".text.xip")))
+
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
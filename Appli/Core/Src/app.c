@@ -17,11 +17,52 @@
  */
 
 #include "app.h"
+#include "app_analytics.h"
+#include "app_assets.h"
+#include "app_background.h"
+#include "app_boottime.h"
 #include "app_buffers.h"
 #include "app_cam.h"
 #include "app_config.h"
+#include "app_crashlog.h"
+#include "app_dataset.h"
+#include "app_dvfs.h"
+#include "app_error.h"
+#include "app_eth.h"
+#include "app_framestats.h"
+#include "app_health.h"
+#include "app_irq.h"
+#include "app_isp_tool.h"
+#include "app_isrprof.h"
 #include "app_lcd.h"
+#include "app_membench.h"
+#include "app_memmap.h"
+#include "app_nn.h"
+#include "app_nnbench.h"
+#include "app_nsshare.h"
+#include "app_params.h"
+#include "app_pcprof.h"
+#include "app_periodic.h"
+#include "app_ppbench.h"
+#include "app_preview.h"
+#include "app_profile.h"
+#include "app_qos.h"
+#include "app_sched.h"
+#include "app_scrub.h"
+#include "app_sdlog.h"
+#include "app_sensor_cmd.h"
+#include "app_shell.h"
+#include "app_slots.h"
+#include "app_snapshot.h"
+#include "app_swo.h"
+#include "app_telemetry.h"
+#include "app_thermal.h"
+#include "app_threadprof.h"
+#include "app_trace.h"
+#include "app_tracex.h"
 #include "app_ui.h"
+#include "app_usb.h"
+#include "app_venc.h"
 #include "app_x-cube-ai.h"
 #include "cmw_camera.h"
 #include "main.h"
@@ -34,11 +75,6 @@
 
 /* UI thread configuration */
 #define UI_THREAD_STACK_SIZE 2048
-#define UI_THREAD_PRIORITY 10  /* Low priority for UI updates */
-
-/* Idle measurement thread configuration */
-#define IDLE_THREAD_STACK_SIZE 512
-#define IDLE_THREAD_PRIORITY 31  /* Lowest priority (runs when truly idle) */
 
 /* UI thread resources */
 static struct {
@@ -46,11 +82,17 @@ static struct {
   UCHAR stack[UI_THREAD_STACK_SIZE];
 } ui_ctx;
 
-/* Idle measurement thread resources */
+/* Bring-up threads: App_Init() only does what the later steps need before
+ * the kernel starts; the pre-kernel stack was 2 KB */
+#define INIT_THREAD_STACK_SIZE 4096
+
 static struct {
-  TX_THREAD thread;
-  UCHAR stack[IDLE_THREAD_STACK_SIZE];
-} idle_ctx;
+  TX_THREAD cam_thread;
+  TX_THREAD app_thread;
+  TX_SEMAPHORE cam_ready;
+  UCHAR cam_stack[INIT_THREAD_STACK_SIZE];
+  UCHAR app_stack[INIT_THREAD_STACK_SIZE];
+} init_ctx;
 
 
 static void XSPI_Config(void);
@@ -85,72 +127,273 @@ static void LED_Config(void) {
   BSP_LED_Off(LED_RED);
 }
 
+static void SleepClocks_Config(void) {
+  /* The scheduler sleeps in WFI when idle (TX_LOW_POWER): memories, xSPI and
+   * the NPU are kept clocked by set_clk_sleep_mode() in MX_X_CUBE_AI_Init(),
+   * the camera and display pipeline (and TIM5, see Time_Init()) here */
+  __HAL_RCC_CSI_CLK_SLEEP_ENABLE();
+  __HAL_RCC_DCMIPP_CLK_SLEEP_ENABLE();
+  __HAL_RCC_LTDC_CLK_SLEEP_ENABLE();
+  __HAL_RCC_DMA2D_CLK_SLEEP_ENABLE();
+}
+
 /**
- * @brief  Idle measurement thread entry
- *         Runs at lowest priority to measure idle time via DWT cycle counter
+ * @brief  UI update thread entry
+ *         Redraws the diagnostic overlay on detections, stats period and visibility events
  */
-static void idle_measure_thread_entry(ULONG arg) {
+static void ui_thread_entry(ULONG arg) {
   UNUSED(arg);
 
   while (1) {
-    /* Mark entry into idle state */
-    UI_IdleThread_Enter();
-
-    /* Yield to higher priority threads */
-    tx_thread_relinquish();
+    uint32_t events = UI_WaitEvents();
 
-    /* Mark exit from idle state */
-    UI_IdleThread_Exit();
+    TRACE_BEGIN(UI_UPDATE);
+    UI_Update(events);
+    TRACE_END(UI_UPDATE);
+#if TRACE_ENABLE && TRACE_DRAIN
+    /* Woken every inference: the trace keeps its pace */
+    Trace_Drain();
+#endif
+#if PC_PROFILER
+    PcProf_Poll();
+#endif
+#if TRACEX_ENABLE && TELEMETRY
+    TraceX_Poll();
+#endif
+#if PARAMS_ENABLE
+    Params_Poll();
+#endif
+#if MEM_MAP_REPORT
+    MemMap_Poll();
+#endif
+#if PREVIEW_ENABLE
+    Preview_Poll();
+#endif
+#if SNAPSHOT_ENABLE && SCREENSHOT_ENABLE
+    Snapshot_Poll();
+#endif
+#if ANALYTICS_ENABLE
+    Analytics_Poll();
+#endif
+#if THERMAL_ENABLE
+    Thermal_Poll();
+#endif
   }
 }
 
 /**
- * @brief  UI update thread entry
- *         Periodically updates the diagnostic overlay
+ * @brief  Camera bring-up thread entry
+ *         Probes and programs the sensor and configures the pipes; its
+ *         I2C delays sleep, so the NPU bring-up runs meanwhile
  */
-static void ui_thread_entry(ULONG arg) {
+IN_XIP static void cam_init_thread_entry(ULONG arg) {
   UNUSED(arg);
 
-  while (1) {
-    UI_Update();
-    tx_thread_sleep(10);
-  }
-}
+  CAM_InitIspSemaphore();
+#if ISP_TUNING_ENABLE
+  /* Dump helpers are copied into the ISP handle when the sensor is probed */
+  IspTool_Init();
+#endif
+#if SENSOR_CMD_ENABLE
+  /* Register accessors are copied into the sensor driver when it is probed */
+  SensorCmd_Init();
+#endif
+  CAM_Init();
+  BOOT_MARK(BOOT_PHASE_APP_CAMERA);
 
-void App_Init(VOID *memory_ptr) {
-  UINT tx_status;
+  APP_REQUIRE_EQ(tx_semaphore_put(&init_ctx.cam_ready), TX_SUCCESS);
+}
 
-  SMPS_Config();
-  LED_Config();
-  XSPI_Config();
-  IAC_Config();
-  Buffer_Init();
-  MX_X_CUBE_AI_Init();
+/**
+ * @brief  Bring-up thread entry
+ *         Display first, then the camera thread is released and the NPU and
+ *         UI come up alongside it; the pipes start once both are done
+ */
+IN_XIP static void app_init_thread_entry(ULONG arg) {
+  VOID *memory_ptr = (VOID *)arg;
 
+  /* Before the camera thread runs: both reconfigure RCC kernel clocks */
   LCD_Init();
+  BOOT_MARK(BOOT_PHASE_APP_LCD);
+  APP_REQUIRE_EQ(tx_thread_resume(&init_ctx.cam_thread), TX_SUCCESS);
+
+  MX_X_CUBE_AI_Init();
+  SleepClocks_Config();
+  NN_Init(memory_ptr);
+  BOOT_MARK(BOOT_PHASE_APP_NPU);
 
   /* Initialize UI diagnostic overlay */
   UI_Init();
   LCD_SetUIAlpha(255);  /* Make UI layer visible */
 
-  /* Create idle measurement thread (lowest priority) */
-  tx_status = tx_thread_create(&idle_ctx.thread, "idle_measure",
-                               idle_measure_thread_entry, 0,
-                               idle_ctx.stack, IDLE_THREAD_STACK_SIZE,
-                               IDLE_THREAD_PRIORITY, IDLE_THREAD_PRIORITY,
-                               TX_NO_TIME_SLICE, TX_AUTO_START);
-  assert(tx_status == TX_SUCCESS);
-
   /* Create UI update thread */
-  tx_status = tx_thread_create(&ui_ctx.thread, "ui_update",
-                               ui_thread_entry, 0,
-                               ui_ctx.stack, UI_THREAD_STACK_SIZE,
-                               UI_THREAD_PRIORITY, UI_THREAD_PRIORITY,
-                               TX_NO_TIME_SLICE, TX_AUTO_START);
-  assert(tx_status == TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&ui_ctx.thread, "ui_update",
+                                  ui_thread_entry, 0,
+                                  ui_ctx.stack, UI_THREAD_STACK_SIZE,
+                                  UI_THREAD_PRIORITY, UI_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+  BOOT_MARK(BOOT_PHASE_APP_UI);
+
+  /* Join the camera bring-up; it has returned, free its slot */
+  APP_REQUIRE_EQ(tx_semaphore_get(&init_ctx.cam_ready, TX_WAIT_FOREVER), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_terminate(&init_ctx.cam_thread), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_delete(&init_ctx.cam_thread), TX_SUCCESS);
+  /* The sensor rate is known: the priority plan must meet its deadlines */
+  Sched_CheckPlan(CAM_GetFrameRate());
+  /* Camera, display and NPU interrupts are all set up */
+  Irq_CheckPlan();
+#if QOS_ENABLE
+  /* DCMIPP is configured and its pipes still stopped */
+  Qos_Init();
+#endif
 
-  CAM_InitIspSemaphore();
-  CAM_Init();
   Thread_IspUpdate_Init(memory_ptr);
+#if ISP_TUNING_ENABLE
+  Thread_IspTool_Init(memory_ptr);
+#endif
+#if SNAPSHOT_ENABLE
+  /* Before post-processing can report a new track */
+  Thread_Snapshot_Init(memory_ptr);
+#endif
+  Thread_NN_Init(memory_ptr);
+#if !DISPLAY_SINGLE_PIPE
   CAM_DisplayPipe_Start(CMW_MODE_CONTINUOUS);
+#endif
+  CAM_MLPipe_Start();
+#if AUX_STREAM_ENABLE
+  CAM_AuxPipe_Start(CMW_MODE_CONTINUOUS);
+#endif
+#if VENC_ENABLE
+  /* Display pipe runs: record what it shows */
+  Thread_Venc_Init(memory_ptr);
+#endif
+#if ETH_PUBLISH
+  Thread_Eth_Init(memory_ptr);
+#endif
+#if USB_STREAM_ENABLE
+  Thread_Usb_Init(memory_ptr);
+#endif
+#if SD_LOG
+  Thread_SdLog_Init(memory_ptr);
+#endif
+#if DATASET_ENABLE
+  Thread_Dataset_Init(memory_ptr);
+#endif
+#if SHELL_ENABLE
+  Thread_Shell_Init(memory_ptr);
+#endif
+#if BACKGROUND_ENABLE
+  /* The model slot is bound: its binary can be verified */
+#if SCRUB_ENABLE
+  Scrub_Init();
+  Background_Register("weights", Scrub_Step, BACKGROUND_VERIFY_PERIOD_MS);
+#else
+  Background_Register("weights", Slots_VerifyStep, BACKGROUND_VERIFY_PERIOD_MS);
+#endif
+  Thread_Background_Init(memory_ptr);
+#endif
+#if HEALTH_MONITOR
+  /* Pipes run: supervise them from here on */
+  Thread_Health_Init(memory_ptr);
+#endif
+
+#if THREAD_PROFILER
+  /* All threads exist: start the first profiler window */
+  ThreadProf_Init();
+#endif
+#if FRAME_STATS
+  /* All pipes run: start the first frame counter window */
+  FrameStats_Init();
+#endif
+  BOOT_MARK(BOOT_PHASE_APP_PIPES);
+}
+
+void App_Init(VOID *memory_ptr) {
+  SMPS_Config();
+#if DVFS_ENABLE || PROFILE_ENABLE
+  DVFS_Init();
+#endif
+#if PROFILE_ENABLE
+  Profile_Init();
+#endif
+#if THERMAL_ENABLE
+  Thermal_Init();
+#endif
+  LED_Config();
+  XSPI_Config();
+  IAC_Config();
+  Slots_Init();
+  /* Before any thread registers its periodic work */
+  Periodic_Init();
+#if CRASH_LOG
+  /* Before anything that can panic past the early init */
+  CrashLog_Init();
+#endif
+#if TELEMETRY
+  /* Before the first boot report */
+  Telemetry_Init();
+#endif
+#if TRACE_ENABLE
+  Trace_Init();
+#endif
+#if TRACEX_ENABLE
+  /* PSRAM buffer: after XSPI_Config(); before the threads, so the kernel
+   * trace starts with them */
+  TraceX_Init();
+#endif
+#if SWO_PROFILER
+  Swo_Init();
+#endif
+#if PC_PROFILER
+  PcProf_Init();
+#endif
+#if ISR_PROFILER
+  /* Before MX_X_CUBE_AI_Init() enables the NPU interrupt */
+  IsrProf_Init();
+#endif
+#if ASSET_PACK_ENABLE
+  /* Before Params_Init() may store, and any overlay text */
+  Assets_Init();
+#endif
+#if PARAMS_ENABLE
+  /* Before the pipes read any of them */
+  Params_Init();
+#endif
+#if NS_SPLIT
+  NSShare_Init();
+#endif
+#if MEM_BENCH
+  /* Before any buffer or DMA: the PSRAM window is overwritten */
+  MemBench_Run();
+#endif
+
+#if PP_BENCH
+  /* Benchmark image: post processing on recorded outputs, no camera or NPU */
+  PPBench_Init(memory_ptr);
+  return;
+#endif
+#if NN_BENCH
+  /* Benchmark image: the network on a fixed input, no camera or display */
+  NNBench_Init(memory_ptr);
+  return;
+#endif
+
+  Buffer_Init();
+  BOOT_MARK(BOOT_PHASE_APP_BUFFERS);
+
+  /* The rest once the kernel runs, so that sensor delays sleep */
+  APP_REQUIRE_EQ(tx_semaphore_create(&init_ctx.cam_ready, "cam_ready", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&init_ctx.cam_thread, "cam_init",
+                                  cam_init_thread_entry, 0,
+                                  init_ctx.cam_stack, INIT_THREAD_STACK_SIZE,
+                                  CAM_INIT_THREAD_PRIORITY, CAM_INIT_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_DONT_START),
+                 TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&init_ctx.app_thread, "app_init",
+                                  app_init_thread_entry, (ULONG)memory_ptr,
+                                  init_ctx.app_stack, INIT_THREAD_STACK_SIZE,
+                                  APP_INIT_THREAD_PRIORITY, APP_INIT_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
 }
@@ -0,0 +1,358 @@
+/**
+ ******************************************************************************
+ * @file    app_analytics.c
+ * @author  Long Liangmao
+ * @brief   People counting and dwell analytics for STM32N6570-DK (ANALYTICS_ENABLE)
+ *
+ *          Each followed track keeps its side of every line and the zones
+ *          it is in; times are summed from the frame stamps of the updates
+ *          that saw it, so the 32-bit DWT counter never wraps in between.
+ *          The interval sums are shared with the UI thread under a mutex.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_analytics.h"
+
+#if ANALYTICS_ENABLE
+
+#include "app_error.h"
+#include "app_nn.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "app_tracker.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+#if !TRACKER_ENABLE || !TELEMETRY
+#error "ANALYTICS_ENABLE follows the tracker's tracks and sends summaries: TRACKER_ENABLE and TELEMETRY"
+#endif
+
+#define ANALYTICS_COUNT(x0, y0, x1, y1) +1U
+#define ANALYTICS_NB_LINES (0U ANALYTICS_LINES(ANALYTICS_COUNT))
+#define ANALYTICS_NB_ZONES (0U ANALYTICS_ZONES(ANALYTICS_COUNT))
+
+#if ANALYTICS_NB_LINES > ANALYTICS_LINES_MAX || ANALYTICS_NB_ZONES > ANALYTICS_ZONES_MAX
+#error "ANALYTICS_LINES and ANALYTICS_ZONES overflow the summary record"
+#endif
+#if ANALYTICS_PERIOD_MS < 1000 || ANALYTICS_PERIOD_MS > 65535
+#error "ANALYTICS_PERIOD_MS from 1000 to 65535"
+#endif
+
+_Static_assert(sizeof(analytics_record_t) <= TELEMETRY_PAYLOAD_MAX, "Analytics record overflows");
+_Static_assert(ANALYTICS_MAX_TRACKS <= 255U, "Track counts are 8-bit in the summary");
+
+/* Thousandths of the frame, as configured */
+#define ANALYTICS_COORDS(x0, y0, x1, y1) {(x0), (y0), (x1), (y1)},
+static const int16_t analytics_lines[ANALYTICS_LINES_MAX][4] = {ANALYTICS_LINES(ANALYTICS_COORDS)};
+static const int16_t analytics_zones[ANALYTICS_ZONES_MAX][4] = {ANALYTICS_ZONES(ANALYTICS_COORDS)};
+
+typedef struct {
+  float x0, y0;
+  float dx, dy;  /* End minus start */
+  float len2;    /* Squared length */
+  float margin;  /* ANALYTICS_LINE_MARGIN times the length, in cross product units */
+} analytics_line_t;
+
+typedef struct {
+  float x0, y0, x1, y1;
+} analytics_rect_t;
+
+typedef struct {
+  uint32_t id;          /* Track ID, 0: free slot (the tracker starts at 1) */
+  uint32_t seen_cycles; /* Frame stamp of the last update that saw it */
+  uint32_t view_us;     /* Time in view */
+  uint32_t zone_us[ANALYTICS_ZONES_MAX]; /* Time in the current visit of each zone */
+  int8_t side[ANALYTICS_LINES_MAX];      /* 1: left of the line, -1: right, 0: not past the margin yet */
+  uint8_t zones;        /* Zones it is in, one bit each */
+  uint8_t absent;       /* Updates since it was last seen */
+  uint8_t seen;         /* Seen by the update in progress */
+} analytics_track_t;
+
+/* Interval sums, under the mutex */
+typedef struct {
+  uint32_t new_tracks;
+  uint32_t left_tracks;
+  uint64_t left_us;
+  uint32_t left_max_us;
+  uint32_t present;
+  uint32_t peak;
+  uint32_t update_max_cycles;
+  uint32_t line_in[ANALYTICS_LINES_MAX];
+  uint32_t line_out[ANALYTICS_LINES_MAX];
+  uint32_t zone_entries[ANALYTICS_ZONES_MAX];
+  uint64_t zone_occupancy_us[ANALYTICS_ZONES_MAX];
+  uint32_t zone_visits[ANALYTICS_ZONES_MAX];
+  uint64_t zone_visit_us[ANALYTICS_ZONES_MAX];
+} analytics_sums_t;
+
+static struct {
+  /* Post-processing thread */
+  analytics_line_t lines[ANALYTICS_LINES_MAX];
+  analytics_rect_t zones[ANALYTICS_ZONES_MAX];
+  analytics_track_t tracks[ANALYTICS_MAX_TRACKS];
+  nn_detection_t boxes[TRACKER_MAX_TRACKS];
+  uint32_t ids[TRACKER_MAX_TRACKS];
+  uint32_t cursor; /* Slot after the last one found */
+
+  TX_MUTEX mutex;
+  analytics_sums_t sums;
+
+  /* UI thread */
+  uint64_t interval_start_us;
+  uint32_t interval;
+} an_ctx;
+
+static uint16_t Analytics_Sat16(uint64_t value) {
+  return (uint16_t)MIN(value, 0xFFFFU);
+}
+
+static uint32_t Analytics_AddUs(uint32_t total, uint32_t us) {
+  return total > UINT32_MAX - us ? UINT32_MAX : total + us;
+}
+
+/**
+ * @brief  Followed track of an ID, a free slot for a new one
+ * @retval NULL when the ID is new and every slot is taken
+ * @note   Tracks come back in the tracker's slot order: the search starts
+ *         after the previous match, so a frame is about one step per track
+ */
+static analytics_track_t *Analytics_Find(uint32_t id, uint32_t frame_cycles) {
+  analytics_track_t *free_slot = NULL;
+
+  for (uint32_t k = 0; k < ANALYTICS_MAX_TRACKS; k++) {
+    uint32_t i = (an_ctx.cursor + k) % ANALYTICS_MAX_TRACKS;
+    analytics_track_t *track = &an_ctx.tracks[i];
+
+    if (track->id == id) {
+      an_ctx.cursor = i + 1U;
+      return track;
+    }
+    if (track->id == 0U && free_slot == NULL) {
+      free_slot = track;
+    }
+  }
+
+  if (free_slot != NULL) {
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->id = id;
+    free_slot->seen_cycles = frame_cycles;
+    an_ctx.sums.new_tracks++;
+  }
+  return free_slot;
+}
+
+/**
+ * @brief  Count the lines the center crossed since its last committed side
+ */
+static void Analytics_Lines(analytics_track_t *track, float cx, float cy) {
+  for (uint32_t l = 0; l < ANALYTICS_NB_LINES; l++) {
+    const analytics_line_t *line = &an_ctx.lines[l];
+    float rx = cx - line->x0;
+    float ry = cy - line->y0;
+    /* y down: negative on the left of the line walked on screen */
+    float cross = line->dx * ry - line->dy * rx;
+    float t = (line->dx * rx + line->dy * ry) / line->len2;
+    int8_t side;
+
+    if (cross > -line->margin && cross < line->margin) {
+      continue;
+    }
+    side = cross < 0.0f ? 1 : -1;
+    if (track->side[l] != 0 && side != track->side[l] && t >= 0.0f && t <= 1.0f) {
+      if (side > 0) {
+        an_ctx.sums.line_in[l]++;
+      } else {
+        an_ctx.sums.line_out[l]++;
+      }
+    }
+    track->side[l] = side;
+  }
+}
+
+/**
+ * @brief  Close a visit of a zone
+ */
+static void Analytics_ZoneExit(analytics_track_t *track, uint32_t z) {
+  an_ctx.sums.zone_visits[z]++;
+  an_ctx.sums.zone_visit_us[z] += track->zone_us[z];
+  track->zones &= (uint8_t)~(1U << z);
+}
+
+/**
+ * @brief  Enter, stay in or leave each zone
+ * @param  dt_us: Time since the update that last saw the track
+ */
+static void Analytics_Zones(analytics_track_t *track, float cx, float cy, uint32_t dt_us) {
+  for (uint32_t z = 0; z < ANALYTICS_NB_ZONES; z++) {
+    const analytics_rect_t *zone = &an_ctx.zones[z];
+    int inside = cx >= zone->x0 && cx < zone->x1 && cy >= zone->y0 && cy < zone->y1;
+
+    if (track->zones & (1U << z)) {
+      /* The time since the last sighting is spent where it was */
+      track->zone_us[z] = Analytics_AddUs(track->zone_us[z], dt_us);
+      an_ctx.sums.zone_occupancy_us[z] += dt_us;
+      if (!inside) {
+        Analytics_ZoneExit(track, z);
+      }
+    } else if (inside) {
+      an_ctx.sums.zone_entries[z]++;
+      track->zone_us[z] = 0;
+      track->zones |= (uint8_t)(1U << z);
+    }
+  }
+}
+
+/**
+ * @brief  The track is lost: close its visits, count its time in view and
+ *         free the slot
+ */
+static void Analytics_Leave(analytics_track_t *track) {
+  for (uint32_t z = 0; z < ANALYTICS_NB_ZONES; z++) {
+    if (track->zones & (1U << z)) {
+      Analytics_ZoneExit(track, z);
+    }
+  }
+  an_ctx.sums.left_tracks++;
+  an_ctx.sums.left_us += track->view_us;
+  an_ctx.sums.left_max_us = MAX(an_ctx.sums.left_max_us, track->view_us);
+  track->id = 0;
+}
+
+void Analytics_Update(uint32_t frame_cycles) {
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  uint32_t present = 0;
+  uint32_t nb;
+
+  /* Positions at the frame the tracker just associated */
+  nb = Tracker_Predict(an_ctx.boxes, an_ctx.ids, TRACKER_MAX_TRACKS, frame_cycles);
+
+  tx_mutex_get(&an_ctx.mutex, TX_WAIT_FOREVER);
+
+  for (uint32_t t = 0; t < ANALYTICS_MAX_TRACKS; t++) {
+    an_ctx.tracks[t].seen = 0;
+  }
+
+  for (uint32_t n = 0; n < nb; n++) {
+    analytics_track_t *track = Analytics_Find(an_ctx.ids[n], frame_cycles);
+    float cx = an_ctx.boxes[n].x_center;
+    float cy = an_ctx.boxes[n].y_center;
+    uint32_t dt_us;
+
+    if (track == NULL) {
+      /* Every slot taken: not counted until one frees up */
+      continue;
+    }
+    dt_us = (frame_cycles - track->seen_cycles) / cycles_per_us;
+    track->view_us = Analytics_AddUs(track->view_us, dt_us);
+    track->seen_cycles = frame_cycles;
+    track->seen = 1;
+    track->absent = 0;
+    Analytics_Lines(track, cx, cy);
+    Analytics_Zones(track, cx, cy, dt_us);
+    present++;
+  }
+
+  /* A confirmed track the tracker missed is only lost once its misses are
+   * over: the same ID would come back */
+  for (uint32_t t = 0; t < ANALYTICS_MAX_TRACKS; t++) {
+    analytics_track_t *track = &an_ctx.tracks[t];
+
+    if (track->id != 0U && !track->seen && ++track->absent > TRACKER_MAX_MISSES) {
+      Analytics_Leave(track);
+    }
+  }
+
+  an_ctx.sums.present = present;
+  an_ctx.sums.peak = MAX(an_ctx.sums.peak, present);
+  an_ctx.sums.update_max_cycles = MAX(an_ctx.sums.update_max_cycles, DWT->CYCCNT - start);
+
+  tx_mutex_put(&an_ctx.mutex);
+}
+
+void Analytics_Poll(void) {
+  uint64_t now_us = Time_GetUs();
+  analytics_record_t rec;
+  analytics_sums_t sums;
+
+  if (now_us - an_ctx.interval_start_us < (uint64_t)ANALYTICS_PERIOD_MS * 1000U) {
+    return;
+  }
+
+  tx_mutex_get(&an_ctx.mutex, TX_WAIT_FOREVER);
+  sums = an_ctx.sums;
+  memset(&an_ctx.sums, 0, sizeof(an_ctx.sums));
+  /* Still in view: the next interval starts from them */
+  an_ctx.sums.present = sums.present;
+  an_ctx.sums.peak = sums.present;
+  tx_mutex_put(&an_ctx.mutex);
+
+  memset(&rec, 0, sizeof(rec));
+  rec.interval = ++an_ctx.interval;
+  rec.period_ms = Analytics_Sat16((now_us - an_ctx.interval_start_us) / 1000U);
+  rec.nb_lines = (uint8_t)ANALYTICS_NB_LINES;
+  rec.nb_zones = (uint8_t)ANALYTICS_NB_ZONES;
+  rec.new_tracks = Analytics_Sat16(sums.new_tracks);
+  rec.left_tracks = Analytics_Sat16(sums.left_tracks);
+  rec.dwell_mean_ds = sums.left_tracks ? Analytics_Sat16(sums.left_us / sums.left_tracks / 100000U) : 0;
+  rec.dwell_max_ds = Analytics_Sat16(sums.left_max_us / 100000U);
+  rec.present = (uint8_t)sums.present;
+  rec.peak = (uint8_t)sums.peak;
+  rec.update_max_ns = Analytics_Sat16((uint64_t)sums.update_max_cycles * 1000U / (SystemCoreClock / 1000000U));
+  for (uint32_t l = 0; l < ANALYTICS_NB_LINES; l++) {
+    rec.line_in[l] = Analytics_Sat16(sums.line_in[l]);
+    rec.line_out[l] = Analytics_Sat16(sums.line_out[l]);
+  }
+  for (uint32_t z = 0; z < ANALYTICS_NB_ZONES; z++) {
+    rec.zones[z].entries = Analytics_Sat16(sums.zone_entries[z]);
+    rec.zones[z].occupancy_ds = Analytics_Sat16(sums.zone_occupancy_us[z] / 100000U);
+    rec.zones[z].dwell_mean_ds =
+        sums.zone_visits[z] ? Analytics_Sat16(sums.zone_visit_us[z] / sums.zone_visits[z] / 100000U) : 0;
+  }
+  /* A full ring drops it, counted in the system record */
+  (void)Telemetry_Send(TELEMETRY_TYPE_ANALYTICS, &rec, sizeof(rec));
+
+  an_ctx.interval_start_us = now_us;
+}
+
+void Analytics_Init(void) {
+  memset(&an_ctx, 0, sizeof(an_ctx));
+
+  for (uint32_t l = 0; l < ANALYTICS_NB_LINES; l++) {
+    analytics_line_t *line = &an_ctx.lines[l];
+
+    line->x0 = analytics_lines[l][0] / 1000.0f;
+    line->y0 = analytics_lines[l][1] / 1000.0f;
+    line->dx = analytics_lines[l][2] / 1000.0f - line->x0;
+    line->dy = analytics_lines[l][3] / 1000.0f - line->y0;
+    line->len2 = line->dx * line->dx + line->dy * line->dy;
+    APP_REQUIRE(line->len2 > 0.0f);
+    line->margin = ANALYTICS_LINE_MARGIN / 1000.0f * sqrtf(line->len2);
+  }
+  for (uint32_t z = 0; z < ANALYTICS_NB_ZONES; z++) {
+    an_ctx.zones[z] = (analytics_rect_t){
+        .x0 = analytics_zones[z][0] / 1000.0f,
+        .y0 = analytics_zones[z][1] / 1000.0f,
+        .x1 = analytics_zones[z][2] / 1000.0f,
+        .y1 = analytics_zones[z][3] / 1000.0f,
+    };
+  }
+
+  APP_REQUIRE_EQ(tx_mutex_create(&an_ctx.mutex, "analytics", TX_INHERIT), TX_SUCCESS);
+  an_ctx.interval_start_us = Time_GetUs();
+}
+
+#endif /* ANALYTICS_ENABLE */
@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ * @file    app_arena.c
+ * @author  Long Liangmao
+ * @brief   Per-frame scratch arena for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_arena.h"
+#include "app_error.h"
+#include "utils.h"
+#include <stddef.h>
+
+void Arena_Init(arena_t *arena, void *base, uint32_t size) {
+  APP_REQUIRE(arena != NULL && base != NULL);
+  APP_REQUIRE(((uintptr_t)base % ARENA_ALIGN) == 0);
+
+  arena->base = base;
+  arena->size = size & ~(ARENA_ALIGN - 1U);
+  arena->used = 0;
+  arena->high = 0;
+  arena->peak = 0;
+}
+
+void *Arena_Alloc(arena_t *arena, uint32_t size) {
+  void *block;
+
+  size = (size + ARENA_ALIGN - 1U) & ~(ARENA_ALIGN - 1U);
+  APP_REQUIRE(size <= arena->size - arena->used);
+
+  block = arena->base + arena->used;
+  arena->used += size;
+  arena->high = MAX(arena->high, arena->used);
+  arena->peak = MAX(arena->peak, arena->used);
+  return block;
+}
+
+void Arena_BeginStage(arena_t *arena, arena_stage_t *stage) {
+  stage->mark = arena->used;
+  arena->high = arena->used;
+}
+
+void Arena_EndStage(arena_t *arena, arena_stage_t *stage) {
+  APP_REQUIRE(arena->used >= stage->mark);
+
+  stage->peak = MAX(stage->peak, arena->high - stage->mark);
+  arena->used = stage->mark;
+  arena->high = arena->used;
+}
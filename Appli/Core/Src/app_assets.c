@@ -0,0 +1,162 @@
+/**
+ ******************************************************************************
+ * @file    app_assets.c
+ * @author  Long Liangmao
+ * @brief   OctoFlash asset pack implementation for STM32N6570-DK
+ *
+ *          The pack is read in place through the xSPI2 memory mapping the
+ *          FSBL leaves on. Blocks are LZ4 raw blocks: a token of literal
+ *          and match lengths (15 extended by bytes up to a non-255 one),
+ *          the literals, a 16-bit back offset; the last sequence has
+ *          literals only. Decoded byte by byte, so overlapping matches
+ *          repeat as they should.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_assets.h"
+
+#if ASSET_PACK_ENABLE
+
+#include "app_error.h"
+#include "tx_api.h"
+#include <string.h>
+
+#define ASSETS_CHECK_SEED 2166136261U /* FNV-1a offset basis */
+
+static struct {
+  const asset_pack_t *pack;
+  const asset_entry_t *entries;
+  TX_MUTEX lock; /* Held while the pack is read or the octoFlash unmapped */
+} assets_ctx;
+
+static uint32_t Assets_Check(const uint8_t *data, uint32_t len) {
+  uint32_t hash = ASSETS_CHECK_SEED;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+/**
+ * @brief  Extended LZ4 length: 255 bytes add up until a smaller one
+ */
+static uint32_t Assets_Lz4Length(const uint8_t **src, const uint8_t *end, uint32_t len) {
+  uint32_t b;
+
+  if (len != 15U) {
+    return len;
+  }
+  do {
+    APP_REQUIRE(*src < end);
+    b = *(*src)++;
+    len += b;
+  } while (b == 255U);
+  return len;
+}
+
+/**
+ * @brief  Decode one LZ4 raw block
+ * @retval Bytes written, at most cap
+ */
+static uint32_t Assets_Lz4Decode(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap) {
+  const uint8_t *end = src + len;
+  uint32_t n = 0;
+
+  while (src < end) {
+    uint32_t token = *src++;
+    uint32_t literals = Assets_Lz4Length(&src, end, token >> 4);
+    uint32_t offset;
+    uint32_t match;
+
+    APP_REQUIRE(literals <= (uint32_t)(end - src) && literals <= cap - n);
+    memcpy(&dst[n], src, literals);
+    src += literals;
+    n += literals;
+    if (src == end) {
+      break; /* Last sequence */
+    }
+
+    APP_REQUIRE(end - src >= 2);
+    offset = (uint32_t)src[0] | ((uint32_t)src[1] << 8);
+    src += 2;
+    match = Assets_Lz4Length(&src, end, token & 0x0FU) + 4U;
+    APP_REQUIRE(offset != 0U && offset <= n && match <= cap - n);
+    for (uint32_t i = 0; i < match; i++, n++) {
+      dst[n] = dst[n - offset];
+    }
+  }
+  return n;
+}
+
+/**
+ * @brief  Check the pack, create the flash lock
+ */
+void Assets_Init(void) {
+  const asset_pack_t *pack = (const asset_pack_t *)ASSET_PACK_FLASH_ADDR;
+
+  APP_REQUIRE_EQ(pack->magic, ASSET_PACK_MAGIC);
+  APP_REQUIRE(pack->nb <= (ASSET_PACK_SIZE - sizeof(*pack)) / sizeof(asset_entry_t));
+
+  assets_ctx.pack = pack;
+  assets_ctx.entries = (const asset_entry_t *)(pack + 1);
+  for (uint32_t i = 0; i < pack->nb; i++) {
+    const asset_entry_t *entry = &assets_ctx.entries[i];
+
+    APP_REQUIRE(entry->offset <= ASSET_PACK_SIZE && entry->packed <= ASSET_PACK_SIZE - entry->offset);
+  }
+
+  APP_REQUIRE_EQ(tx_mutex_create(&assets_ctx.lock, "assets_lock", TX_INHERIT), TX_SUCCESS);
+}
+
+/**
+ * @brief  Entry of an asset
+ */
+const asset_entry_t *Assets_Find(uint32_t id, asset_type_t type) {
+  for (uint32_t i = 0; i < assets_ctx.pack->nb; i++) {
+    const asset_entry_t *entry = &assets_ctx.entries[i];
+
+    if (entry->id == id && entry->type == (uint8_t)type) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Decompress an asset
+ */
+void Assets_Load(const asset_entry_t *entry, uint8_t *dst) {
+  uint32_t n;
+
+  Assets_LockFlash();
+  n = Assets_Lz4Decode((const uint8_t *)assets_ctx.pack + entry->offset, entry->packed, dst, entry->size);
+  Assets_UnlockFlash();
+
+  APP_REQUIRE_EQ(n, entry->size);
+  APP_REQUIRE_EQ(Assets_Check(dst, n), entry->check);
+}
+
+/**
+ * @brief  Hold the octoFlash mapping
+ */
+void Assets_LockFlash(void) {
+  APP_REQUIRE_EQ(tx_mutex_get(&assets_ctx.lock, TX_WAIT_FOREVER), TX_SUCCESS);
+}
+
+void Assets_UnlockFlash(void) {
+  APP_REQUIRE_EQ(tx_mutex_put(&assets_ctx.lock), TX_SUCCESS);
+}
+
+#endif /* ASSET_PACK_ENABLE */
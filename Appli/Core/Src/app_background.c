@@ -0,0 +1,195 @@
+/**
+ ******************************************************************************
+ * @file    app_background.c
+ * @author  Long Liangmao
+ * @brief   Background jobs for STM32N6570-DK (BACKGROUND_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_background.h"
+
+#if BACKGROUND_ENABLE
+
+#include "app_error.h"
+#include "app_nn.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stddef.h>
+
+#if BACKGROUND_THREAD_PRIORITY <= SDLOG_THREAD_PRIORITY || BACKGROUND_THREAD_PRIORITY <= DATASET_THREAD_PRIORITY || \
+    BACKGROUND_THREAD_PRIORITY <= SHELL_THREAD_PRIORITY
+#error "BACKGROUND_THREAD_PRIORITY must be below every other thread"
+#endif
+#if BACKGROUND_THREAD_PRIORITY >= TX_MAX_PRIORITIES - 1
+#error "BACKGROUND_THREAD_PRIORITY must stay above the lowest ThreadX priority"
+#endif
+
+#define BACKGROUND_THREAD_STACK_SIZE 1024
+
+#define BACKGROUND_IDLE_TICKS ((BACKGROUND_IDLE_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+typedef struct {
+  const char *name;
+  background_step_t step;
+  uint32_t period_ms;
+  uint32_t due_ms; /* HAL_GetTick() the next pass may start at */
+} background_job_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[BACKGROUND_THREAD_STACK_SIZE];
+  background_job_t jobs[BACKGROUND_MAX_JOBS];
+  uint32_t nb;
+  uint32_t next; /* Round-robin start of the due scan */
+  uint32_t running; /* Job with a pass in progress, nb when none */
+  background_stats_t stats;
+} bg_ctx;
+
+static uint32_t Background_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+static ULONG Background_Ticks(uint32_t us) {
+  ULONG ticks = (ULONG)(((uint64_t)us * TX_TIMER_TICKS_PER_SECOND + 999999U) / 1000000U);
+
+  return MAX(ticks, 1U);
+}
+
+/**
+ * @brief  Slack before the next predicted inference window
+ * @param  resume_us: Set when the slack is short: to the end of that window
+ * @retval Microseconds a slice may take from now
+ * @note   The window opens BACKGROUND_GUARD_US before the capture vsync one
+ *         inference period after the last inferred frame and lasts as long
+ *         as that frame took to its post-processing, plus the guard. Before
+ *         the second inference nothing is predicted
+ */
+static uint32_t Background_Slack(uint32_t *resume_us) {
+  const nn_result_t *result = NN_AcquireResult();
+  uint32_t period = result->frame_period_us;
+  uint32_t busy = Background_CyclesToUs(result->post_done_cycles - result->vsync_cycles) + BACKGROUND_GUARD_US;
+  uint32_t elapsed = Background_CyclesToUs(DWT->CYCCNT - result->vsync_cycles);
+  uint32_t phase;
+
+  NN_ReleaseResult(result);
+  if (period == 0U) {
+    return UINT32_MAX;
+  }
+  /* A pipeline busy a whole period leaves no slack */
+  if (busy + BACKGROUND_GUARD_US >= period) {
+    *resume_us = period;
+    return 0;
+  }
+
+  phase = elapsed % period;
+  if (phase < busy) {
+    *resume_us = busy - phase;
+    return 0;
+  }
+  *resume_us = period - phase + busy;
+  return (period - phase > BACKGROUND_GUARD_US) ? period - phase - BACKGROUND_GUARD_US : 0;
+}
+
+/**
+ * @brief  Job to run a slice of: the one with a pass in progress, else the
+ *         next due in round-robin order
+ * @retval Job index, bg_ctx.nb when none is due
+ */
+static uint32_t Background_NextJob(uint32_t now) {
+  if (bg_ctx.running < bg_ctx.nb) {
+    return bg_ctx.running;
+  }
+  for (uint32_t i = 0; i < bg_ctx.nb; i++) {
+    uint32_t n = (bg_ctx.next + i) % bg_ctx.nb;
+
+    if ((int32_t)(now - bg_ctx.jobs[n].due_ms) >= 0) {
+      bg_ctx.next = (n + 1U) % bg_ctx.nb;
+      return n;
+    }
+  }
+  return bg_ctx.nb;
+}
+
+static void background_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  for (;;) {
+    uint32_t n = Background_NextJob(HAL_GetTick());
+    uint32_t resume_us = 0;
+    uint32_t slack;
+    uint32_t start;
+    uint32_t slice_us;
+    int more;
+
+    if (n == bg_ctx.nb) {
+      tx_thread_sleep(BACKGROUND_IDLE_TICKS);
+      continue;
+    }
+    slack = Background_Slack(&resume_us);
+    if (slack < BACKGROUND_SLICE_US) {
+      bg_ctx.stats.deferred++;
+      tx_thread_sleep(Background_Ticks(resume_us));
+      continue;
+    }
+
+    start = DWT->CYCCNT;
+    more = bg_ctx.jobs[n].step();
+    slice_us = Background_CyclesToUs(DWT->CYCCNT - start);
+
+    bg_ctx.stats.slices++;
+    bg_ctx.stats.max_slice_us = MAX(bg_ctx.stats.max_slice_us, slice_us);
+    if (slice_us > slack) {
+      bg_ctx.stats.overruns++;
+    }
+    if (more) {
+      bg_ctx.running = n;
+    } else {
+      bg_ctx.running = bg_ctx.nb;
+      bg_ctx.jobs[n].due_ms = HAL_GetTick() + bg_ctx.jobs[n].period_ms;
+      bg_ctx.stats.passes++;
+    }
+  }
+}
+
+void Background_Register(const char *name, background_step_t step, uint32_t period_ms) {
+  APP_REQUIRE(name != NULL && step != NULL);
+  APP_REQUIRE(bg_ctx.nb < BACKGROUND_MAX_JOBS);
+
+  bg_ctx.jobs[bg_ctx.nb] = (background_job_t){
+      .name = name,
+      .step = step,
+      .period_ms = period_ms,
+      .due_ms = HAL_GetTick(),
+  };
+  bg_ctx.nb++;
+}
+
+void Thread_Background_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  bg_ctx.running = bg_ctx.nb;
+  APP_REQUIRE_EQ(tx_thread_create(&bg_ctx.thread, "background",
+                                  background_thread_entry, 0,
+                                  bg_ctx.stack, BACKGROUND_THREAD_STACK_SIZE,
+                                  BACKGROUND_THREAD_PRIORITY, BACKGROUND_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+void Background_GetStats(background_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = bg_ctx.stats;
+}
+
+#endif /* BACKGROUND_ENABLE */
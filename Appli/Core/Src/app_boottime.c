@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * @file    app_boottime.c
+ * @author  Long Liangmao
+ * @brief   Boot time profile for STM32N6570-DK
+ *          Phases from FSBL entry to the first frame on screen and the first
+ *          inference, continued from the record the FSBL hands over
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_boottime.h"
+
+#if BOOT_PROFILER_UART && !THREAD_PROFILER_UART
+#error "BOOT_PROFILER_UART prints on the COM port opened by THREAD_PROFILER_UART"
+#endif
+
+#if BOOT_PROFILER
+
+#include "stm32n6xx_hal.h"
+
+#if BOOT_PROFILER_UART
+#include <stdio.h>
+#endif
+
+#define BOOTTIME_FIRST_MASK ((1U << BOOT_PHASE_FIRST_FRAME) | (1U << BOOT_PHASE_FIRST_INFERENCE))
+
+static const char *const boot_phase_names[BOOT_PHASE_NB] = {
+    [BOOT_PHASE_FSBL_ENTRY] = "fsbl entry",
+    [BOOT_PHASE_FSBL_CLOCKS] = "fsbl clocks",
+    [BOOT_PHASE_FSBL_XSPI] = "fsbl xspi",
+    [BOOT_PHASE_FSBL_COPY] = "fsbl copy",
+    [BOOT_PHASE_APP_ENTRY] = "app startup",
+    [BOOT_PHASE_APP_CLOCKS] = "app clocks",
+    [BOOT_PHASE_APP_HAL] = "app hal",
+    [BOOT_PHASE_APP_BUFFERS] = "buffers",
+    [BOOT_PHASE_APP_LCD] = "lcd",
+    [BOOT_PHASE_APP_NPU] = "npu",
+    [BOOT_PHASE_APP_UI] = "ui",
+    [BOOT_PHASE_APP_CAMERA] = "camera",
+    [BOOT_PHASE_APP_PIPES] = "pipes",
+    [BOOT_PHASE_FIRST_FRAME] = "first frame",
+    [BOOT_PHASE_FIRST_INFERENCE] = "first inference",
+};
+
+static struct {
+  volatile uint32_t marked; /* BOOTTIME_FIRST_MASK bits marked */
+  uint8_t reported;
+  uint8_t from_fsbl;
+} bt_ctx;
+
+void BootTime_AppEntry(void) {
+  boot_timeline_t *tl = BootTimeline_Get();
+
+  /* The variable still holds HSI_VALUE: read back the clock the FSBL set */
+  SystemCoreClockUpdate();
+
+  bt_ctx.from_fsbl = tl->magic == BOOT_TIMELINE_MAGIC && tl->state == BOOT_TIMELINE_HANDOFF &&
+                     tl->nb <= BOOT_TIMELINE_MAX_MARKS;
+  if (bt_ctx.from_fsbl) {
+    tl->state = BOOT_TIMELINE_APP;
+    BootTimeline_Mark(BOOT_PHASE_APP_ENTRY);
+  } else {
+    BootTimeline_Start(BOOT_TIMELINE_APP, BOOT_PHASE_APP_ENTRY);
+  }
+}
+
+void BootTime_MarkFirst(boot_phase_t phase) {
+  uint32_t bit = 1U << phase;
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if ((bt_ctx.marked & bit) == 0U) {
+    bt_ctx.marked |= bit;
+    BootTimeline_Mark(phase);
+  }
+  __set_PRIMASK(primask);
+}
+
+#if BOOT_PROFILER_UART
+/**
+ * @brief  Print the phases: end time since time zero and duration of each
+ */
+static void BootTime_Print(const boot_timeline_t *tl) {
+  uint32_t prev_us = 0;
+
+  printf("boot %lu us to first frame and inference, from %s (boot ROM not included)\r\n",
+         (unsigned long)tl->us, bt_ctx.from_fsbl ? "FSBL entry" : "application entry");
+  for (uint32_t i = 0; i < tl->nb; i++) {
+    const boot_mark_t *mark = &tl->marks[i];
+    const char *name = mark->phase < BOOT_PHASE_NB ? boot_phase_names[mark->phase] : "?";
+
+    printf("  %-16s %8lu us +%8lu us\r\n", name, (unsigned long)mark->us,
+           (unsigned long)(mark->us - prev_us));
+    prev_us = mark->us;
+  }
+}
+#endif
+
+void BootTime_Update(void) {
+  if (bt_ctx.reported || (bt_ctx.marked & BOOTTIME_FIRST_MASK) != BOOTTIME_FIRST_MASK) {
+    return;
+  }
+  bt_ctx.reported = 1;
+
+#if BOOT_PROFILER_UART
+  BootTime_Print(BootTimeline_Get());
+#endif
+}
+
+#endif /* BOOT_PROFILER */
@@ -17,29 +17,788 @@
  */
 
 #include "app_buffers.h"
+#include "app_error.h"
+#include "app_irq.h"
+#include "app_params.h"
 #include "stm32n6xx_hal.h"
 #include "utils.h"
 #include <string.h>
 
-uint8_t camera_display_buffers[DISPLAY_BUFFER_NB][DISPLAY_LETTERBOX_WIDTH * DISPLAY_LETTERBOX_HEIGHT * DISPLAY_BPP] ALIGN_32 IN_PSRAM;
-uint8_t ui_display_buffers[2][LCD_WIDTH * LCD_HEIGHT * 4] ALIGN_32 IN_PSRAM;
+/* Bank capacities available to the table (mirror STM32N657XX_LRUN.ld); the
+ * link also fits the NPU pool and the staging areas into the hyperRAM */
+#define BUFFER_CAPACITY_PSRAM (32U * 1024U * 1024U)
+#define BUFFER_CAPACITY_AXISRAM6 (448U * 1024U - 0x38C00U) /* After the NPU activations */
+
+#define BUFFER_CAT_(a, b) a##b
+#define BUFFER_CAT(a, b) BUFFER_CAT_(a, b)
+
+/* Entry alignment per bank: PSRAM entries start a hyperRAM row */
+#define BUFFER_ALIGN_PSRAM PSRAM_ROW_SIZE
+#define BUFFER_ALIGN_PSRAM_STREAM PSRAM_ROW_SIZE
+#define BUFFER_ALIGN_AXISRAM6 32U
+
+/* Placement: the streams DCMIPP writes and LTDC reads stay in PSRAM, away
+ * from the AXISRAM2-6 banks the NPU owns. The int8 output ring is small
+ * enough for the free tail of AXISRAM6, where post-processing reads it
+ * without PSRAM latency; the float ring is not. */
+#define BUFFER_DEFINE(id, array, slots, width, height, bpp, format, bank, section, owner) \
+  uint8_t array[slots][BUFFER_SLOT_SIZE(BUFFER_PITCH(width, bpp, owner), height)]        \
+      __attribute__((aligned(BUFFER_CAT(BUFFER_ALIGN_, bank)))) section;
+BUFFER_TABLE(BUFFER_DEFINE)
+#undef BUFFER_DEFINE
+
+#define BUFFER_DESC(id, array, slots, w, h, px, fmt, mem, section, own)  \
+  [BUFFER_ID_##id] = {                                                   \
+      .name = #id,                                                       \
+      .base = &array[0][0],                                              \
+      .slot_size = sizeof(array[0]),                                     \
+      .pitch = BUFFER_PITCH(w, px, own),                                 \
+      .width = (w),                                                      \
+      .height = (h),                                                     \
+      .slot_nb = (slots),                                                \
+      .bpp = (px),                                                       \
+      .format = BUFFER_CAT(BUFFER_FORMAT_, fmt),                         \
+      .bank = BUFFER_CAT(BUFFER_BANK_, mem),                             \
+      .owner = BUFFER_OWNER_##own,                                       \
+      .cacheable = BUFFER_CAT(BUFFER_CACHEABLE_, mem),                   \
+  },
+const buffer_desc_t buffer_registry[BUFFER_ID_NB] = {BUFFER_TABLE(BUFFER_DESC)};
+#undef BUFFER_DESC
+
+/* Build-time layout checks: cache-line slots, descriptor ranges, bank capacity.
+ * Entries are distinct objects so they cannot overlap each other; overlap with
+ * the NPU activations is excluded by the linker reservations. */
+#define BUFFER_CHECK(id, array, slots, width, height, bpp, format, bank, section, owner) \
+  _Static_assert(sizeof(array[0]) % 32U == 0, #id " slot is not a cache-line multiple"); \
+  _Static_assert(__alignof__(array) >= 32U, #id " is not cache-line aligned");           \
+  _Static_assert((slots) > 0 && (slots) <= UINT8_MAX, #id " slot count does not fit its descriptor");
+BUFFER_TABLE(BUFFER_CHECK)
+#undef BUFFER_CHECK
+
+#define BUFFER_BYTES_IN(target)                                                              \
+  (0 BUFFER_TABLE(BUFFER_BYTES_IN_##target))
+#define BUFFER_BYTES_IN_PSRAM(id, array, slots, width, height, bpp, format, bank, ...) \
+  + (BUFFER_CAT(BUFFER_BANK_, bank) == BUFFER_BANK_PSRAM ? sizeof(array) : 0U)
+#define BUFFER_BYTES_IN_AXISRAM6(id, array, slots, width, height, bpp, format, bank, ...) \
+  + (BUFFER_CAT(BUFFER_BANK_, bank) == BUFFER_BANK_AXISRAM6 ? sizeof(array) : 0U)
+_Static_assert(BUFFER_BYTES_IN(PSRAM) <= BUFFER_CAPACITY_PSRAM, "PSRAM buffers exceed the bank");
+_Static_assert(BUFFER_BYTES_IN(AXISRAM6) <= BUFFER_CAPACITY_AXISRAM6,
+               "AXISRAM6 buffers exceed the space left by the NPU activations");
+
+#if DISPLAY_SINGLE_PIPE
+_Static_assert(ML_CAPTURE_BUFFER_NB >= 6 + ISP_TUNING_ENABLE + DATASET_ENABLE * DATASET_SLOTS,
+               "ML capture ring needs held, ready, two capture slots, the lent dump slot, front and retiring "
+               "and the dataset slots");
+#else
+_Static_assert(DISPLAY_BUFFER_NB >=
+                   4 + (UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS) + VENC_ENABLE + SNAPSHOT_ENABLE + PREVIEW_ENABLE,
+               "Camera display ring needs front, retiring, two capture slots and the thumbnail, encoder, "
+               "snapshot and preview lent slots");
+_Static_assert(ML_CAPTURE_BUFFER_NB >= 4 + ISP_TUNING_ENABLE + DATASET_ENABLE * DATASET_SLOTS,
+               "ML capture ring needs held, ready, two capture slots, the lent dump slot and the dataset slots");
+#endif
+_Static_assert(UI_BUFFER_NB == 2 || UI_BUFFER_NB == 3, "UI layer is double or triple buffered");
+
+/* Camera display slot states. A slot leaving the front stays RETIRING until
+ * the LTDC reports a vblank that latched another slot: until then it may
+ * still be scanned out. */
+typedef enum {
+  CAMERA_SLOT_FREE = 0,
+  CAMERA_SLOT_CAPTURE,  /* Behind a DCMIPP Pipe1 address register: being or next written */
+  CAMERA_SLOT_READY,    /* Complete, waiting to be shown */
+  CAMERA_SLOT_FRONT,    /* Handed to LTDC, scanned out from the next vblank */
+  CAMERA_SLOT_RETIRING, /* Replaced at the front, possibly still scanned out */
+} camera_slot_state_t;
 
 /* Accessed from ISR context */
-volatile int camera_display_idx = 1;
-volatile int camera_capture_idx = 0;
-volatile int ui_display_idx = 0;
+volatile int camera_display_idx SHARED_STATE = -1;
+volatile int camera_capture_idx SHARED_STATE = 0;
+volatile int ui_display_idx SHARED_STATE = 0; /* Latched by the last vblank, set by the LTDC ISR */
+static int ui_last_idx;            /* Last presented, possibly not latched yet */
+static uint32_t ui_swap_count;     /* Presents since Buffer_Init(), 1 for the initial front */
+static uint32_t ui_present_swap[UI_BUFFER_NB]; /* Present that staged each UI buffer, 0 if never */
+static volatile int ui_lent_idx = -1;          /* Lent UI buffer, -1 if none */
+volatile int ml_capture_idx SHARED_STATE = 0;
+static volatile int ml_ready_idx SHARED_STATE = -1; /* Latest complete frame, -1 if none */
+static volatile int ml_held_idx SHARED_STATE = -1;  /* Slot owned by the NN thread, -1 if none */
+static buffer_ml_stats_t ml_stats SHARED_STATE;
+#if ML_INPUT_ALIAS
+static uint8_t *ml_alias; /* Network input tensor, every slot's frame */
+#endif
+static volatile int ml_lent_idx SHARED_STATE = -1;  /* Slot read by an ISP tuning dump, -1 if none */
+#if DATASET_ENABLE
+static volatile uint32_t ml_kept_mask SHARED_STATE; /* Slots the dataset writer has not written yet */
+#endif
+static buffer_frame_tag_t ml_tag[ML_CAPTURE_BUFFER_NB] SHARED_STATE;
+#if DISPLAY_SINGLE_PIPE
+/* ML slots LTDC owns: the front and, until a vblank latched another one,
+ * every slot it replaced (Pipe2 frame ISR and LTDC reload ISR) */
+static volatile int ml_front_idx SHARED_STATE = -1;
+static volatile uint32_t ml_display_mask SHARED_STATE;
+#endif
+
+/* Camera display ring; every transition runs in the Pipe1 frame ISR or the
+ * LTDC reload ISR (same priority, never nested), or under Irq_Lock() at that
+ * priority (Buffer_CameraDisplay_Align()), except sync_frame (NN threads) and
+ * the statistics reader */
+static struct {
+  uint8_t state[DISPLAY_BUFFER_NB];
+  int front; /* Slot last handed to LTDC, -1 before the first frame */
+  int lent[BUFFER_LENDER_NB]; /* Slot read by each reader outside the ring, -1 if none */
+  buffer_frame_tag_t tag[DISPLAY_BUFFER_NB];
+  buffer_frame_tag_t sensor;    /* Frame being captured, updated at each Pipe1 vsync */
+  volatile uint32_t sync_frame; /* Newest frame with published detections */
+  volatile uint8_t sync_valid;
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+  volatile uint8_t aligned; /* The UI thread shows the held frames (Buffer_CameraDisplay_Align()) */
+#endif
+  buffer_display_stats_t stats;
+} camera_ring SHARED_STATE;
+
+/**
+ * @brief  Frame id ordering that survives counter wrap-around
+ */
+static inline int Buffer_FrameBefore(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief  Count and timestamp a new sensor frame (ISR context, Pipe1 vsync,
+ *         Pipe2 with DISPLAY_SINGLE_PIPE)
+ */
+void Buffer_Camera_FrameStart(void) {
+  camera_ring.sensor.vsync_cycles = DWT->CYCCNT;
+  camera_ring.sensor.frame_id++;
+}
+
+/**
+ * @brief  Move the front statistics to the frame a vblank latched
+ */
+static void Buffer_CameraDisplay_SetFront(const buffer_frame_tag_t *tag) {
+  camera_ring.stats.front_frame_id = tag->frame_id;
+  camera_ring.stats.front_vsync_cycles = tag->vsync_cycles;
+  camera_ring.stats.age_us = (DWT->CYCCNT - tag->vsync_cycles) / (SystemCoreClock / 1000000U);
+}
+
+#if DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Release the ML slots a vblank took off screen
+ */
+void Buffer_CameraDisplay_Shown(const uint8_t *buffer) {
+  int shown = -1;
+
+  for (int i = 0; i < ML_CAPTURE_BUFFER_NB; i++) {
+    if (Buffer_GetMLCaptureBuffer(i) == buffer) {
+      shown = i;
+    }
+  }
+  APP_REQUIRE(shown >= 0 && ml_front_idx >= 0);
+
+  /* The front may be staged for the next vblank already: keep it too */
+  ml_display_mask &= (1U << shown) | (1U << ml_front_idx);
+  camera_display_idx = shown;
+
+  Buffer_CameraDisplay_SetFront(&ml_tag[shown]);
+}
+#else
+/**
+ * @brief  Hand a slot to LTDC: waiting frames older than it can never be
+ *         shown, the one it replaces retires
+ */
+static void Buffer_CameraDisplay_SetShow(int show) {
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    if (camera_ring.state[i] == CAMERA_SLOT_READY &&
+        Buffer_FrameBefore(camera_ring.tag[i].frame_id, camera_ring.tag[show].frame_id)) {
+      camera_ring.state[i] = CAMERA_SLOT_FREE;
+      camera_ring.stats.dropped++;
+    }
+  }
+
+  if (camera_ring.front >= 0) {
+    camera_ring.state[camera_ring.front] = CAMERA_SLOT_RETIRING;
+  }
+  camera_ring.state[show] = CAMERA_SLOT_FRONT;
+  camera_ring.front = show;
+}
+
+/**
+ * @brief  Mark a camera capture slot complete and apply DISPLAY_POLICY
+ */
+int Buffer_CameraDisplay_Complete(int completed) {
+  int newest = -1, oldest = -1, show = -1;
+  int nb_ready = 0;
+
+  APP_REQUIRE((unsigned)completed < DISPLAY_BUFFER_NB);
+  APP_REQUIRE(camera_ring.state[completed] == CAMERA_SLOT_CAPTURE);
+
+  camera_ring.state[completed] = CAMERA_SLOT_READY;
+  camera_ring.tag[completed] = camera_ring.sensor;
+  camera_ring.stats.latest_frame_id = camera_ring.sensor.frame_id;
+
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    if (camera_ring.state[i] != CAMERA_SLOT_READY) {
+      continue;
+    }
+    nb_ready++;
+    if (oldest < 0 || Buffer_FrameBefore(camera_ring.tag[i].frame_id, camera_ring.tag[oldest].frame_id)) {
+      oldest = i;
+    }
+#if DISPLAY_POLICY != DISPLAY_POLICY_LATEST
+    if (!camera_ring.sync_valid || Buffer_FrameBefore(camera_ring.sync_frame, camera_ring.tag[i].frame_id)) {
+      continue;
+    }
+#endif
+    if (newest < 0 || Buffer_FrameBefore(camera_ring.tag[newest].frame_id, camera_ring.tag[i].frame_id)) {
+      newest = i;
+    }
+  }
+
+  show = newest;
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+  /* The UI thread shows the frames it drew the boxes of */
+  if (camera_ring.aligned) {
+    show = -1;
+  }
+#endif
+#if DISPLAY_POLICY != DISPLAY_POLICY_LATEST
+  /* No detections to wait for: degrade to a fixed delay rather than freeze */
+#if PARAMS_ENABLE
+  if (show < 0 && nb_ready >= Params_GetInt(PARAM_DISPLAY_DEPTH)) {
+#else
+  if (show < 0 && nb_ready >= DISPLAY_BUFFER_NB - 3) {
+#endif
+    show = oldest;
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+    if (camera_ring.aligned) {
+      camera_ring.stats.unpaired++;
+    }
+#endif
+  }
+#endif
+
+  if (show < 0) {
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+    /* Not repeated yet: the UI thread may show a newer frame */
+    if (!camera_ring.aligned) {
+      camera_ring.stats.repeated++;
+    }
+#else
+    camera_ring.stats.repeated++;
+#endif
+    return -1;
+  }
+
+  Buffer_CameraDisplay_SetShow(show);
+  return show;
+}
+
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+/**
+ * @brief  Hand LTDC the newest waiting frame up to the one the overlay is drawn for
+ */
+int Buffer_CameraDisplay_Align(uint32_t frame_id) {
+  int show = -1;
+
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    if (camera_ring.state[i] != CAMERA_SLOT_READY || Buffer_FrameBefore(frame_id, camera_ring.tag[i].frame_id)) {
+      continue;
+    }
+    if (show < 0 || Buffer_FrameBefore(camera_ring.tag[show].frame_id, camera_ring.tag[i].frame_id)) {
+      show = i;
+    }
+  }
+
+  /* Already on screen, or dropped by the fallback: the front stays */
+  if (show >= 0) {
+    Buffer_CameraDisplay_SetShow(show);
+  }
+  return show;
+}
+
+/**
+ * @brief  Switch the display between the UI thread and the Pipe1 frame ISR
+ */
+void Buffer_CameraDisplay_SetAligned(uint8_t aligned) {
+  camera_ring.aligned = aligned ? 1 : 0;
+}
+#endif
+
+/**
+ * @brief  Tell whether a reader outside the ring holds a slot
+ */
+static int Buffer_CameraDisplay_IsLent(int idx) {
+  for (int l = 0; l < BUFFER_LENDER_NB; l++) {
+    if (camera_ring.lent[l] == idx) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief  Release the slots a vblank took off screen
+ */
+void Buffer_CameraDisplay_Shown(const uint8_t *buffer) {
+  int shown = -1;
+
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    if (Buffer_GetCameraDisplayBuffer(i) == buffer) {
+      shown = i;
+    }
+  }
+  APP_REQUIRE(shown >= 0);
+
+  /* The latched slot stays with LTDC even if the ring already moved past
+   * it; every other replaced slot is off screen now */
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    if (i != shown && !Buffer_CameraDisplay_IsLent(i) && camera_ring.state[i] == CAMERA_SLOT_RETIRING) {
+      camera_ring.state[i] = CAMERA_SLOT_FREE;
+    }
+  }
+  camera_display_idx = shown;
+
+  Buffer_CameraDisplay_SetFront(&camera_ring.tag[shown]);
+}
+
+/**
+ * @brief  Pick the slot DCMIPP Pipe1 writes the next frame to
+ */
+int Buffer_CameraDisplay_NextCapture(void) {
+  int next = -1;
+
+  for (int i = 0; i < DISPLAY_BUFFER_NB && next < 0; i++) {
+    if (camera_ring.state[i] == CAMERA_SLOT_FREE) {
+      next = i;
+    }
+  }
+
+  /* Ring full: overwrite the oldest waiting frame */
+  if (next < 0) {
+    for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+      if (camera_ring.state[i] == CAMERA_SLOT_READY &&
+          (next < 0 || Buffer_FrameBefore(camera_ring.tag[i].frame_id, camera_ring.tag[next].frame_id))) {
+        next = i;
+      }
+    }
+    APP_REQUIRE(next >= 0);
+    camera_ring.stats.dropped++;
+  }
+
+  camera_ring.state[next] = CAMERA_SLOT_CAPTURE;
+  camera_capture_idx = next;
+  return next;
+}
+
+/**
+ * @brief  Lend the slot scanned out to a reader outside the ring
+ */
+int Buffer_CameraDisplay_Lend(buffer_lender_t lender, buffer_frame_tag_t *tag) {
+  int idx;
+  uint32_t basepri;
+
+  APP_REQUIRE((unsigned)lender < BUFFER_LENDER_NB && tag != NULL);
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  APP_REQUIRE(camera_ring.lent[lender] < 0);
+  idx = camera_display_idx;
+  camera_ring.lent[lender] = idx;
+  if (idx >= 0) {
+    *tag = camera_ring.tag[idx];
+  }
+  Irq_Unlock(basepri);
+
+  return idx;
+}
+
+/**
+ * @brief  Return the slot lent by Buffer_CameraDisplay_Lend() to the ring
+ */
+void Buffer_CameraDisplay_Return(buffer_lender_t lender) {
+  APP_REQUIRE((unsigned)lender < BUFFER_LENDER_NB);
+
+  /* A slot replaced meanwhile stays RETIRING: the next vblank frees it */
+  camera_ring.lent[lender] = -1;
+}
+#endif /* DISPLAY_SINGLE_PIPE */
+
+/**
+ * @brief  Publish the sensor frame whose detections are now available
+ */
+void Buffer_CameraDisplay_SetSyncFrame(uint32_t frame_id) {
+  uint32_t basepri;
+
+  /* Both NN threads publish (the motion gate skips frames): never go back */
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  if (!camera_ring.sync_valid || Buffer_FrameBefore(camera_ring.sync_frame, frame_id)) {
+    camera_ring.sync_frame = frame_id;
+    camera_ring.sync_valid = 1;
+  }
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Copy the camera display ring statistics
+ */
+void Buffer_CameraDisplay_GetStats(buffer_display_stats_t *stats) {
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  *stats = camera_ring.stats;
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Mark an ML capture slot complete, now the latest frame
+ */
+void Buffer_MLCapture_Complete(int completed) {
+  APP_REQUIRE((unsigned)completed < ML_CAPTURE_BUFFER_NB);
+
+  /* Any older ready frame is dropped in favour of the newest one */
+  if (ml_ready_idx >= 0) {
+    ml_stats.skipped++;
+  }
+  ml_tag[completed] = camera_ring.sensor;
+  ml_ready_idx = completed;
+
+#if DISPLAY_SINGLE_PIPE
+  /* Every Pipe2 frame is the next preview frame: a front no vblank latched
+   * yet is never shown */
+  if (ml_front_idx >= 0 && ml_front_idx != camera_display_idx) {
+    camera_ring.stats.dropped++;
+  }
+  ml_display_mask |= 1U << completed;
+  ml_front_idx = completed;
+  camera_ring.stats.latest_frame_id = camera_ring.sensor.frame_id;
+#endif
+}
+
+/**
+ * @brief  Pick the slot DCMIPP Pipe2 writes the frame after the current one to
+ */
+int Buffer_MLCapture_NextCapture(int capturing) {
+  int next;
+
+  for (next = 0; next < ML_CAPTURE_BUFFER_NB; next++) {
+    if (next != capturing && next != ml_ready_idx && next != ml_held_idx && next != ml_lent_idx) {
+#if DATASET_ENABLE
+      if (ml_kept_mask & (1U << next)) {
+        continue;
+      }
+#endif
+#if DISPLAY_SINGLE_PIPE
+      if (ml_display_mask & (1U << next)) {
+        continue;
+      }
+#endif
+      break;
+    }
+  }
+
+  APP_REQUIRE(next < ML_CAPTURE_BUFFER_NB);
+  ml_capture_idx = next;
+  return next;
+}
+
+#if ML_INPUT_ALIAS
+/**
+ * @brief  Set the frame every ML capture slot is written to
+ */
+void Buffer_MLCapture_SetAlias(uint8_t *frame) {
+  APP_REQUIRE(frame != NULL && ((uint32_t)frame & 31U) == 0);
+  ml_alias = frame;
+}
+
+/**
+ * @brief  Get the frame an ML capture slot is written to
+ */
+uint8_t *Buffer_MLCapture_GetAlias(int idx) {
+  return ((unsigned)idx < ML_CAPTURE_BUFFER_NB) ? ml_alias : NULL;
+}
+#endif
+
+/**
+ * @brief  Take ownership of the latest completed ML capture slot
+ */
+int Buffer_MLCapture_Acquire(void) {
+  int idx;
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  idx = ml_ready_idx;
+  ml_ready_idx = -1;
+  ml_held_idx = idx;
+  if (idx >= 0) {
+    ml_stats.consumed++;
+  }
+  Irq_Unlock(basepri);
+
+#if ML_INPUT_ALIAS
+  /* Cacheable activation RAM: lines fetched while Pipe2 wrote it are stale */
+  if (idx >= 0) {
+    SCB_InvalidateDCache_by_Addr((void *)ml_alias, (int32_t)(ML_WIDTH * ML_HEIGHT * ML_BPP));
+  }
+#endif
+  return idx;
+}
+
+/**
+ * @brief  Return the slot taken by Buffer_MLCapture_Acquire() to the ring
+ */
+void Buffer_MLCapture_Release(void) {
+  ml_held_idx = -1;
+}
+
+/**
+ * @brief  Lend the newest complete ML capture slot to a reader outside the ring
+ */
+int Buffer_MLCapture_Lend(void) {
+  int idx;
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  idx = ml_ready_idx >= 0 ? ml_ready_idx : ml_held_idx;
+  ml_lent_idx = idx;
+  Irq_Unlock(basepri);
+
+  return idx;
+}
+
+/**
+ * @brief  Return the slot lent by Buffer_MLCapture_Lend() to the ring
+ */
+void Buffer_MLCapture_Return(void) {
+  ml_lent_idx = -1;
+#if DISPLAY_SINGLE_PIPE
+  ml_front_idx = -1;
+  ml_display_mask = 0;
+#endif
+}
+
+#if DATASET_ENABLE
+/**
+ * @brief  Keep the held ML capture slot out of the ring past its release
+ */
+void Buffer_MLCapture_Keep(int idx) {
+  uint32_t basepri;
+
+  APP_REQUIRE(idx >= 0 && idx == ml_held_idx);
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  ml_kept_mask |= 1U << idx;
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Give a slot kept by Buffer_MLCapture_Keep() back to the ring
+ */
+void Buffer_MLCapture_Unkeep(int idx) {
+  uint32_t basepri;
+
+  APP_REQUIRE((unsigned)idx < ML_CAPTURE_BUFFER_NB);
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  ml_kept_mask &= ~(1U << idx);
+  Irq_Unlock(basepri);
+}
+#endif
+
+/**
+ * @brief  Copy the ML capture ring statistics
+ */
+void Buffer_MLCapture_GetStats(buffer_ml_stats_t *stats) {
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  *stats = ml_stats;
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Get the capture tag an ML capture slot was stamped with
+ */
+buffer_frame_tag_t Buffer_MLCapture_GetTag(int idx) {
+  APP_REQUIRE((unsigned)idx < ML_CAPTURE_BUFFER_NB);
+  return ml_tag[idx];
+}
+
+/**
+ * @brief  Get a UI buffer neither on screen nor staged for it
+ */
+int Buffer_GetNextUIDisplayIndex(void) {
+  /* Read once: a vblank latching a newer buffer only frees more of them */
+  uint32_t front_swap = ui_present_swap[ui_display_idx];
+
+  for (int i = 0; i < UI_BUFFER_NB; i++) {
+    if (ui_present_swap[i] < front_swap && i != ui_lent_idx) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Present a drawn UI buffer
+ */
+int Buffer_SetUIDisplayIndex(int idx) {
+  if ((unsigned)idx >= UI_BUFFER_NB) {
+    return -1;
+  }
+
+  ui_present_swap[idx] = ++ui_swap_count;
+  ui_last_idx = idx;
+  return 0;
+}
+
+/**
+ * @brief  Get the last presented UI buffer
+ */
+int Buffer_GetUILastIndex(void) {
+  return ui_last_idx;
+}
+
+/**
+ * @brief  Report the UI buffer a vblank latched
+ */
+void Buffer_UIDisplay_Shown(const uint8_t *buffer) {
+  int shown = -1;
+
+  for (int i = 0; i < UI_BUFFER_NB; i++) {
+    if (Buffer_GetUIBuffer(i) == buffer) {
+      shown = i;
+    }
+  }
+  APP_REQUIRE(shown >= 0);
+
+  ui_display_idx = shown;
+}
+
+/**
+ * @brief  Lend the UI buffer on screen
+ */
+int Buffer_UIDisplay_Lend(void) {
+  uint32_t basepri;
+  int idx;
+
+  /* Against a vblank latching another buffer, and the UI thread picking
+   * this one, between the read and the lend */
+  basepri = Irq_Lock(LCD_IRQ_PRIORITY);
+  APP_REQUIRE(ui_lent_idx < 0);
+  idx = ui_display_idx;
+  ui_lent_idx = idx;
+  Irq_Unlock(basepri);
+
+  return idx;
+}
+
+/**
+ * @brief  Return the UI buffer lent by Buffer_UIDisplay_Lend()
+ */
+void Buffer_UIDisplay_Return(void) {
+  ui_lent_idx = -1;
+}
+
+/**
+ * @brief  Resolve a slot pointer against its descriptor
+ * @retval Descriptor, fail-fast if slot is not the start of a slot of id
+ */
+static const buffer_desc_t *Buffer_CheckSlot(buffer_id_t id, const void *slot) {
+  const buffer_desc_t *desc;
+  uint32_t offset;
+
+  APP_REQUIRE((unsigned)id < BUFFER_ID_NB);
+  desc = &buffer_registry[id];
+  offset = (uint32_t)((const uint8_t *)slot - desc->base);
+  APP_REQUIRE((const uint8_t *)slot >= desc->base);
+  APP_REQUIRE(offset % desc->slot_size == 0 && offset / desc->slot_size < desc->slot_nb);
+
+  return desc;
+}
+
+/**
+ * @brief  Write back one slot from the D-cache
+ */
+void Buffer_Clean(buffer_id_t id, const void *slot) {
+  const buffer_desc_t *desc = Buffer_CheckSlot(id, slot);
+
+  if (desc->cacheable) {
+    SCB_CleanDCache_by_Addr((void *)slot, (int32_t)desc->slot_size);
+  }
+}
+
+/**
+ * @brief  Drop one slot from the D-cache
+ */
+void Buffer_Invalidate(buffer_id_t id, const void *slot) {
+  const buffer_desc_t *desc = Buffer_CheckSlot(id, slot);
+
+  if (desc->cacheable) {
+    SCB_InvalidateDCache_by_Addr((void *)slot, (int32_t)desc->slot_size);
+  }
+}
+
+/**
+ * @brief  Write back and drop one slot from the D-cache
+ */
+void Buffer_CleanInvalidate(buffer_id_t id, const void *slot) {
+  const buffer_desc_t *desc = Buffer_CheckSlot(id, slot);
+
+  if (desc->cacheable) {
+    SCB_CleanInvalidateDCache_by_Addr((void *)slot, (int32_t)desc->slot_size);
+  }
+}
+
+/**
+ * @brief  Clear one slot of a buffer and push it out of the D-cache
+ */
+static void Buffer_ClearSlot(buffer_id_t id, int idx) {
+  uint8_t *slot = Buffer_GetSlot(id, idx);
+
+  memset(slot, 0, buffer_registry[id].slot_size);
+  Buffer_CleanInvalidate(id, slot);
+}
 
 /**
  * @brief  Initialize all buffers and cache
  */
 void Buffer_Init(void) {
-  memset(camera_display_buffers, 0, sizeof(camera_display_buffers));
-  SCB_CleanInvalidateDCache_by_Addr((void *)camera_display_buffers, sizeof(camera_display_buffers));
+  /* Cheap run-time complement to the build-time checks: linker placement */
+  for (int a = 0; a < BUFFER_ID_NB; a++) {
+    const uint8_t *a_end = buffer_registry[a].base + buffer_registry[a].slot_nb * buffer_registry[a].slot_size;
+
+    APP_REQUIRE(((uint32_t)buffer_registry[a].base & 31U) == 0);
+    for (int b = a + 1; b < BUFFER_ID_NB; b++) {
+      const uint8_t *b_end = buffer_registry[b].base + buffer_registry[b].slot_nb * buffer_registry[b].slot_size;
+      APP_REQUIRE(a_end <= buffer_registry[b].base || b_end <= buffer_registry[a].base);
+    }
+  }
 
-  memset(ui_display_buffers, 0, sizeof(ui_display_buffers));
-  SCB_CleanInvalidateDCache_by_Addr((void *)ui_display_buffers, sizeof(ui_display_buffers));
+  /* Only the slot the camera layer scans out until the first frame: the
+   * pipes write whole slots before anything reads them, the UI buffers are
+   * cleared by the DMA2D in UI_Init(). The NN output ring may sit in
+   * AXISRAM6, powered later by MX_X_CUBE_AI_Init() */
+#if DISPLAY_SINGLE_PIPE
+  Buffer_ClearSlot(BUFFER_ID_ML_CAPTURE, 0);
+#else
+  Buffer_ClearSlot(BUFFER_ID_CAMERA_DISPLAY, 0);
+#endif
 
-  camera_display_idx = 1;
+  memset(&camera_ring, 0, sizeof(camera_ring));
+  camera_ring.front = -1;
+  for (int l = 0; l < BUFFER_LENDER_NB; l++) {
+    camera_ring.lent[l] = -1;
+  }
+  camera_ring.state[0] = CAMERA_SLOT_CAPTURE;
+  camera_display_idx = -1;
   camera_capture_idx = 0;
   ui_display_idx = 0;
+  ui_last_idx = 0;
+  ui_lent_idx = -1;
+  ui_swap_count = 1;
+  memset(ui_present_swap, 0, sizeof(ui_present_swap));
+  ui_present_swap[0] = 1;
+  ml_capture_idx = 0;
+  ml_ready_idx = -1;
+  ml_held_idx = -1;
+  ml_lent_idx = -1;
+#if DATASET_ENABLE
+  ml_kept_mask = 0;
+#endif
 }
@@ -3,7 +3,9 @@
  * @file    app_cam.c
  * @author  Long Liangmao
  * @brief   Camera application implementation for STM32N6570-DK
- *          Dual DCMIPP pipe configuration: Pipe1 for display, Pipe2 for ML
+ *          Dual DCMIPP pipe configuration: Pipe1 for display, Pipe2 for ML,
+ *          Pipe0 for the auxiliary motion stream (AUX_STREAM_ENABLE).
+ *          The sensor is probed: IMX335, VD55G1 or VD66GY
  ******************************************************************************
  * @attention
  *
@@ -21,23 +23,343 @@
 #include "app_buffers.h"
 #include "app_config.h"
 #include "app_error.h"
+#include "app_irq.h"
+#include "app_isp_tool.h"
 #include "app_lcd.h"
+#include "app_nn.h"
+#include "app_pipebench.h"
+#include "app_sensor_cmd.h"
+#include "app_trace.h"
+#include "app_tracker.h"
+#include "app_ui.h"
 #include "cmw_camera.h"
+#include "cmw_utils.h"
+#include "isp_api.h"
+#include "isp_core.h"
 #include "main.h"
 #include "stm32n6xx_hal.h"
 #include "utils.h"
 #include <assert.h>
+#include <math.h>
+#include <string.h>
 
 /* ISP update thread configuration */
 #define ISP_THREAD_STACK_SIZE 2048
-#define ISP_THREAD_PRIORITY 5
+#define ISP_APPLY_STACK_SIZE 1024 /* ISP_SPLIT_APPLY */
+
+/* Adaptive ISP rate: every vsync while AE/AWB converge, every
+ * ISP_STABLE_PERIOD vsyncs once ISP_STABLE_RUNS runs in a row were stable.
+ * Above ISP_MAX_RATE_FPS both scale with the frame rate: AE/AWB converge
+ * per run, not per frame, and a 60 fps sensor needs no more runs than 30 */
+#define ISP_STABLE_PERIOD 4
+#define ISP_MAX_RATE_FPS 30
+#define ISP_BASE_PERIOD(fps) ((fps) > ISP_MAX_RATE_FPS ? (uint32_t)(fps) / ISP_MAX_RATE_FPS : 1U)
+#define ISP_STABLE_RUNS 8
+#define ISP_AEC_TOLERANCE 4 /* |average luma - exposure target| considered converged */
+
+/* Frames a due run may be held back by CAM_IspDefer_Begin() */
+#define ISP_MAX_DEFER_FRAMES 2
+
+/* Continuous capture: the Pipe2 hardware frame divider takes the decimation */
+#if NN_FRAME_DECIMATION != 1 && NN_FRAME_DECIMATION != 2 && NN_FRAME_DECIMATION != 4 && NN_FRAME_DECIMATION != 8
+#error "NN_FRAME_DECIMATION must be 1, 2, 4 or 8"
+#endif
+
+/* Single-pipe preview: every Pipe2 frame is shown, so Pipe2 has to run
+ * continuously at the sensor rate over the center crop the UI is laid out
+ * for, and the newest frame is always the one shown */
+#if DISPLAY_SINGLE_PIPE
+#if ML_CAPTURE_MODE != ML_CAPTURE_CONTINUOUS || NN_FRAME_DECIMATION != 1
+#error "DISPLAY_SINGLE_PIPE needs ML_CAPTURE_CONTINUOUS without NN_FRAME_DECIMATION"
+#endif
+#if NN_TILING != NN_TILING_CENTER
+#error "DISPLAY_SINGLE_PIPE shows the Pipe2 frame: NN_TILING_CENTER only"
+#endif
+#if DISPLAY_POLICY != DISPLAY_POLICY_LATEST
+#error "DISPLAY_SINGLE_PIPE has no display ring to hold frames: DISPLAY_POLICY_LATEST only"
+#endif
+/* Pipe1 is not started: Pipe2 paces the frame tags and the ISP */
+#define CAM_VSYNC_PIPE DCMIPP_PIPE2
+#else
+#define CAM_VSYNC_PIPE DCMIPP_PIPE1
+#endif
+
+#if ML_PITCH_ALIGN < 16 || (ML_PITCH_ALIGN & (ML_PITCH_ALIGN - 1)) != 0
+#error "ML_PITCH_ALIGN must be a power of two of at least 16 bytes (DCMIPP pitch)"
+#endif
+
+/* 4:2:2 ML frames: pixel pairs share their chroma, and the R/B swap that
+ * puts RGB888 in the network's byte order would swap U and V */
+#if ML_YUV422
+#if ML_GRAYSCALE
+#error "ML_YUV422 and ML_GRAYSCALE are two ML formats: pick one"
+#endif
+#if (ML_WIDTH % 2) != 0
+#error "ML_YUV422 packs pixel pairs: ML_WIDTH must be even"
+#endif
+#define CAM_ML_SWAP 0
+#else
+#define CAM_ML_SWAP 1
+#endif
+
+#if DUAL_STREAM_ENABLE
+#if ML_CAPTURE_MODE != ML_CAPTURE_SNAPSHOT || NN_TILING != NN_TILING_CENTER
+#error "DUAL_STREAM_ENABLE takes turns of fixed-crop snapshots: ML_CAPTURE_SNAPSHOT and NN_TILING_CENTER"
+#endif
+#if ML_PITCH_PADDED
+#error "DUAL_STREAM_ENABLE dumps the second stream through Pipe0, which has no line pitch: unpadded ML lines only"
+#endif
+#if AUX_STREAM_ENABLE || MOTION_GATE_ENABLE || CASCADE_ENABLE || ML_INPUT_ALIAS
+#error "DUAL_STREAM_ENABLE takes Pipe0 and mixes two scenes: not with AUX_STREAM, MOTION_GATE, CASCADE or ML_INPUT_ALIAS"
+#endif
+#define CAM_STREAM_NB 2U
+/* CSI-2 data type of the second stream: the ML format, 8-bit words */
+#if ML_GRAYSCALE
+#define DUAL_STREAM_DT DCMIPP_DT_RAW8
+#elif ML_YUV422
+#error "DUAL_STREAM_ENABLE dumps RGB888 or Y8 words through Pipe0: not ML_YUV422"
+#else
+#define DUAL_STREAM_DT DCMIPP_DT_RGB888
+#endif
+#endif
+
+#if ML_SLICE_INGEST
+#if ML_CAPTURE_MODE != ML_CAPTURE_SNAPSHOT || ML_INPUT_ALIAS
+#error "ML_SLICE_INGEST copies snapshots into the network input: ML_CAPTURE_SNAPSHOT without ML_INPUT_ALIAS"
+#endif
+#if ML_SLICE_LINES < 8 || ML_SLICE_LINES > 128 || (ML_SLICE_LINES & (ML_SLICE_LINES - 1)) != 0
+#error "ML_SLICE_LINES must be a power of two from 8 to 128 (DCMIPP multi-line event)"
+#endif
+#define CAM_SLICE_LINEMULT ((uint32_t)__builtin_ctz(ML_SLICE_LINES) << DCMIPP_P2PPCR_LINEMULT_Pos)
+#define CAM_SLICE_LINE_IT DCMIPP_IT_PIPE2_LINE
+#else
+#define CAM_SLICE_LINE_IT 0U
+#endif
+
+/* AE/AWB outputs of the last ISP_Algo_Process() (isp_algo.c) */
+extern ISP_MetaTypeDef Meta;
+
+#if DETECTION_AE_ENABLE && !TRACKER_ENABLE
+#error "DETECTION_AE_ENABLE needs TRACKER_ENABLE"
+#endif
+#define DETECTION_AE_GRID 16 /* Stat area edges snap to 1/16 of the frame: no churn on jitter */
+
+#if NN_TILING != NN_TILING_CENTER
+#if ML_WIDTH != ML_HEIGHT
+#error "NN_TILING_FULL_FOV tiles and NN_TILING_ROI windows are square"
+#endif
+
+/* Pipe2 tile or window: sensor area and the DCMIPP setup scaling it to the ML frame */
+typedef struct {
+  cam_ml_tile_t area;
+  DCMIPP_CropConfTypeDef crop;
+  DCMIPP_DecimationConfTypeDef dec;
+  DCMIPP_DownsizeTypeDef down;
+} cam_tile_conf_t;
+#endif
+
+#if NN_TILING == NN_TILING_FULL_FOV
+static struct {
+  cam_tile_conf_t tiles[NN_TILING_MAX_TILES];
+  uint32_t nb;
+  uint8_t slot_tile[ML_CAPTURE_BUFFER_NB]; /* Tile each capture slot is written with (ML pipe ISR) */
+  volatile uint32_t acquired;              /* Last tile taken by the inference thread */
+} tile_ctx;
+#elif NN_TILING == NN_TILING_ROI
+#if NN_ROI_MIN_SIDE < ML_WIDTH
+#error "NN_ROI_MIN_SIDE below the ML frame: the pipe only downscales"
+#endif
+
+static struct {
+  cam_tile_conf_t next;                          /* Window requested by the post-processing thread */
+  volatile uint8_t dirty;                        /* next not programmed yet */
+  cam_ml_tile_t programmed;                      /* Area in the Pipe2 registers (ML pipe ISR) */
+  cam_ml_tile_t slot_area[ML_CAPTURE_BUFFER_NB]; /* Area each capture slot is written with */
+  uint32_t sensor_w;
+  uint32_t sensor_h;
+} roi_ctx;
+#endif
+
+#if NN_MULTIRES_ENABLE
+#if ML_CAPTURE_MODE != ML_CAPTURE_SNAPSHOT || NN_TILING != NN_TILING_CENTER
+#error "NN_MULTIRES_ENABLE resizes Pipe2 between snapshots of the center crop: ML_CAPTURE_SNAPSHOT and NN_TILING_CENTER"
+#endif
+#if DUAL_STREAM_ENABLE || DISPLAY_SINGLE_PIPE
+#error "NN_MULTIRES_ENABLE resizes the Pipe2 frame: not with DUAL_STREAM_ENABLE or DISPLAY_SINGLE_PIPE"
+#endif
+#if ML_WIDTH != ML_HEIGHT || NN_MULTIRES_SIDE >= ML_WIDTH || (NN_MULTIRES_SIDE % 32) != 0
+#error "NN_MULTIRES_SIDE must be a multiple of 32 below a square ML frame"
+#endif
+
+/* Pipe2 scaler for one side of the ML frame, over the same center crop */
+typedef struct {
+  DCMIPP_CropConfTypeDef crop;
+  DCMIPP_DecimationConfTypeDef dec;
+  DCMIPP_DownsizeTypeDef down;
+} cam_res_conf_t;
+
+static struct {
+  cam_res_conf_t res[2];                     /* ML_WIDTH, then NN_MULTIRES_SIDE */
+  volatile uint16_t requested;               /* Side asked for by the inference thread */
+  uint16_t programmed;                       /* Side in the Pipe2 registers (ML pipe ISR) */
+  uint16_t slot_side[ML_CAPTURE_BUFFER_NB];  /* Side each capture slot is written at */
+} res_ctx;
+#endif
+
+/* Pipe in hardware double-buffer mode: DCMIPP alternates between its two
+ * address registers, the frame ISR refills the one just completed */
+typedef struct {
+  uint32_t lstfrm_mask; /* CMSR1 last-frame bit of the pipe */
+  uint32_t pipe;        /* DCMIPP_PIPEx, for the frame counters */
+  int8_t slot[2];       /* Ring slot behind DCMIPP_MEMORY_ADDRESS_0 and _1 */
+  uint8_t parity;       /* LSTFRM of a frame written through address 0 */
+  uint8_t synced;       /* parity sampled at the first frame event */
+  uint8_t last_bank;    /* Bank of the previous frame event */
+} cam_dbm_t;
+
+/* Frame counters per pipe, indexed by DCMIPP_PIPEx (ISR context) */
+static volatile cam_pipe_stats_t cam_pipe_stats[CAM_PIPE_NB];
+
+/* Detection coordinates to display pixels (CAM_Init) */
+static cam_display_map_t cam_display_map;
+
+#if !DISPLAY_SINGLE_PIPE
+static cam_dbm_t display_dbm = {.lstfrm_mask = DCMIPP_CMSR1_P1LSTFRM, .pipe = DCMIPP_PIPE1};
+#endif
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/* Pipe2 snapshot scheduling, shared by the inference thread and the ISRs */
+static struct {
+  volatile uint32_t deadline; /* DWT cycle the requested frame is due by */
+  volatile uint8_t requested; /* Waiting for the Pipe1 vsync it is armed at */
+  volatile uint8_t armed;     /* Capture requested, not complete yet */
+  volatile int8_t slot;       /* Slot the armed capture is written to */
+  volatile uint8_t pipe;      /* Pipe of the armed capture: Pipe0 for the second stream */
+  volatile uint32_t since_arm; /* Pipe1 vsyncs since the last arming */
+  volatile uint32_t decimation; /* Pipe1 vsyncs between two armings, at least */
+  volatile uint8_t capture;   /* Armings, wrapping: tells apart the captures of a slot */
+  volatile uint32_t rows;     /* ML_SLICE_INGEST: Pipe2 lines of the armed capture written */
+} ml_snap = {.pipe = DCMIPP_PIPE2, .since_arm = NN_FRAME_DECIMATION, .decimation = NN_FRAME_DECIMATION};
+#else
+static cam_dbm_t ml_dbm = {.lstfrm_mask = DCMIPP_CMSR1_P2LSTFRM, .pipe = DCMIPP_PIPE2};
+/* Sensor frames per Pipe2 frame, the Pipe2 frame divider */
+static volatile uint32_t ml_decimation = NN_FRAME_DECIMATION;
+#endif
+
+#if DUAL_STREAM_ENABLE
+/* Stream picked at each arming (ML pipe ISR), activity reported by
+ * post-processing */
+static struct {
+  uint8_t slot_stream[ML_CAPTURE_BUFFER_NB]; /* Stream each capture slot is written from */
+  volatile uint8_t misses[CAM_STREAM_NB];    /* Results in a row without detections */
+  uint8_t last;                              /* Stream of the last arming */
+  uint32_t turns;                            /* Armings while exactly one stream is idle */
+} stream_ctx;
+#endif
+
+#if AUX_STREAM_ENABLE
+static cam_dbm_t aux_dbm = {.lstfrm_mask = DCMIPP_CMSR1_P0LSTFRM, .pipe = DCMIPP_PIPE0};
+static volatile int aux_latest = -1; /* Latest complete auxiliary slot, -1 before the first */
+static uint8_t aux_active;           /* The probed sensor feeds the stream */
+#endif
+
+/* What differs between the sensors CMW_CAMERA_Init() may probe */
+typedef struct {
+  CMW_Sensor_Name_t sensor;
+  int32_t fps;
+  uint8_t aux; /* Pipe0 stream: one Bayer channel of a RAW10 2 x AUX readout */
+} cam_sensor_preset_t;
+
+static const cam_sensor_preset_t cam_sensor_presets[] = {
+    {CMW_IMX335_Sensor, CAMERA_FPS, AUX_STREAM_ENABLE},
+    {CMW_VD55G1_Sensor, CAMERA_VD55G1_FPS, 0},
+    {CMW_VD66GY_Sensor, CAMERA_VD66GY_FPS, 0},
+};
+
+/* Sensor frame rate, changed at runtime by CAM_SetFrameRate() */
+static volatile int32_t cam_fps = CAMERA_FPS;
 
 /* ISP thread resources */
 static struct {
   TX_SEMAPHORE vsync_sem;
   TX_THREAD thread;
   UCHAR stack[ISP_THREAD_STACK_SIZE];
-} isp_ctx;
+
+  /* Run scheduling, shared with the vsync ISR */
+  volatile uint32_t period;      /* Vsyncs per run */
+  volatile uint32_t base_period; /* period while AE/AWB converge, from the frame rate */
+  volatile uint32_t frames;      /* Vsyncs since the last run was posted */
+  volatile uint32_t defer_depth; /* Nested CAM_IspDefer_Begin() calls */
+  volatile uint8_t pending;      /* A run fell due while deferred */
+
+  /* Stability tracking (ISP thread) */
+  uint32_t stable_runs;
+  uint32_t last_color_temp;
+
+#if ISP_SPLIT_APPLY
+  /* Register apply, latched at vsync */
+  TX_SEMAPHORE apply_sem;
+  TX_THREAD apply_thread;
+  UCHAR apply_stack[ISP_APPLY_STACK_SIZE];
+  TX_MUTEX staged_lock;
+  ISP_PendingTypeDef staged;     /* Computed by the ISP thread, not applied yet (staged_lock) */
+  volatile uint8_t staged_ready; /* staged holds writes for the next vsync */
+#endif
+} isp_ctx = {.period = ISP_BASE_PERIOD(CAMERA_FPS), .base_period = ISP_BASE_PERIOD(CAMERA_FPS)};
+
+#if DETECTION_AE_ENABLE
+/* Detection AE state (ISP thread) */
+static struct {
+  nn_detection_t boxes[TRACKER_MAX_TRACKS];
+  float vel[TRACKER_MAX_TRACKS][2];
+  CMW_Manual_roi_area_t frame;      /* Sensor area the detections are normalized to */
+  ISP_StatAreaTypeDef default_area; /* Stat area of the IQ parameters */
+  ISP_StatAreaTypeDef area;         /* Stat area programmed */
+  uint32_t exposure_max;            /* Exposure cap programmed (us), 0 for none */
+  uint8_t started;
+} dae_ctx;
+#endif
+
+#if DISPLAY_FOLLOW_ENABLE
+#if DISPLAY_SINGLE_PIPE || !TRACKER_ENABLE
+#error "DISPLAY_FOLLOW_ENABLE zooms the Pipe1 frames on a track: TRACKER_ENABLE, not DISPLAY_SINGLE_PIPE"
+#endif
+#if DISPLAY_FOLLOW_MAX_ZOOM < 1 || DISPLAY_FOLLOW_FILL_PCT < 1 || DISPLAY_FOLLOW_FILL_PCT > 100 || \
+    DISPLAY_FOLLOW_SMOOTH_PCT < 1 || DISPLAY_FOLLOW_SMOOTH_PCT > 100
+#error "DISPLAY_FOLLOW_MAX_ZOOM at least 1, DISPLAY_FOLLOW_FILL_PCT and DISPLAY_FOLLOW_SMOOTH_PCT from 1 to 100"
+#endif
+
+/* Pipe1 window: DCMIPP setup scaling a sensor area to the letterbox, and
+ * the detections mapped onto it */
+typedef struct {
+  DCMIPP_CropConfTypeDef crop;
+  DCMIPP_DecimationConfTypeDef dec;
+  DCMIPP_DownsizeTypeDef down;
+  cam_display_map_t map;
+} cam_follow_conf_t;
+
+static struct {
+  /* Handed to the display pipe ISR */
+  cam_follow_conf_t next;                        /* Window requested by the UI thread */
+  volatile uint8_t dirty;                        /* next not programmed yet */
+  cam_display_map_t programmed;                  /* Map of the window in the Pipe1 registers (display pipe ISR) */
+  cam_display_map_t slot_map[DISPLAY_BUFFER_NB]; /* Map each display slot is written with */
+
+  /* Set by CAM_Init() */
+  CMW_Manual_roi_area_t full; /* Pipe1 area without zoom */
+  CMW_Manual_roi_area_t det;  /* Sensor area the detections are normalized to */
+  uint32_t sensor_w;
+  uint32_t sensor_h;
+
+  /* UI thread */
+  nn_detection_t boxes[TRACKER_MAX_TRACKS];
+  uint32_t ids[TRACKER_MAX_TRACKS];
+  uint32_t track_id;           /* Followed track, 0 for none */
+  uint32_t lost;               /* Updates since it was last seen */
+  float cx, cy, width;         /* Smoothed window center and width, sensor pixels */
+  float target_cx, target_cy, target_width;
+  CMW_Manual_roi_area_t shown; /* Window last requested */
+} follow_ctx;
+#endif
 
 /**
  * @brief  Calculate centered crop ROI maintaining aspect ratio
@@ -63,6 +385,40 @@ static void CAM_CalcCropRoi(CMW_Manual_roi_area_t *roi,
   roi->offset_y = (sensor_h - roi->height) / 2;
 }
 
+/**
+ * @brief  Map the detection frame onto the camera display frame
+ * @param  map: Map to fill
+ * @param  det: Sensor area the detections are normalized to
+ * @param  disp: Sensor area Pipe1 scales to the letterbox
+ * @note   Fixed point from the integer crops, so the boxes land on the pixels
+ *         the pipes put the scene on
+ */
+static void CAM_DisplayMap_Init(cam_display_map_t *map, const CMW_Manual_roi_area_t *det,
+                                const CMW_Manual_roi_area_t *disp) {
+#if DISPLAY_SINGLE_PIPE
+  /* The Pipe2 frame is scanned out 1:1, centered in the letterbox */
+  UNUSED(det);
+  UNUSED(disp);
+  map->scale_x = ML_WIDTH << 16;
+  map->scale_y = ML_HEIGHT << 16;
+  map->offset_x = ((DISPLAY_LETTERBOX_WIDTH - ML_WIDTH) / 2) << 16;
+  map->offset_y = ((DISPLAY_LETTERBOX_HEIGHT - ML_HEIGHT) / 2) << 16;
+#else
+  map->scale_x = (int32_t)(((uint64_t)det->width * DISPLAY_LETTERBOX_WIDTH << 16) / disp->width);
+  map->scale_y = (int32_t)(((uint64_t)det->height * DISPLAY_LETTERBOX_HEIGHT << 16) / disp->height);
+  map->offset_x = (int32_t)(((int64_t)det->offset_x - (int64_t)disp->offset_x) * DISPLAY_LETTERBOX_WIDTH * 65536 /
+                            (int64_t)disp->width);
+  map->offset_y = (int32_t)(((int64_t)det->offset_y - (int64_t)disp->offset_y) * DISPLAY_LETTERBOX_HEIGHT * 65536 /
+                            (int64_t)disp->height);
+#endif
+
+  map->x0 = MAX(CAM_DisplayMap_X(map, 0), 0);
+  map->y0 = MAX(CAM_DisplayMap_Y(map, 0), 0);
+  map->x1 = MIN(CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_ONE), DISPLAY_LETTERBOX_WIDTH);
+  map->y1 = MIN(CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_ONE), DISPLAY_LETTERBOX_HEIGHT);
+  APP_REQUIRE(map->x0 < map->x1 && map->y0 < map->y1);
+}
+
 /**
  * @brief  Configure DCMIPP pipe with common settings
  * @param  pipe: DCMIPP pipe number (DCMIPP_PIPE1 or DCMIPP_PIPE2)
@@ -73,13 +429,14 @@ static void CAM_CalcCropRoi(CMW_Manual_roi_area_t *roi,
  * @param  format: Output pixel format
  * @param  bpp: Bytes per pixel
  * @param  swap_enabled: Enable byte swap (for RGB888)
+ * @param  pitch: Bytes per line of the ring the pipe writes
  * @note   Fail-fast: panics on unrecoverable failures
  */
 static void CAM_ConfigPipe(uint32_t pipe,
                           uint32_t sensor_w, uint32_t sensor_h,
                           uint32_t out_w, uint32_t out_h,
                           uint32_t format, uint32_t bpp,
-                          int swap_enabled) {
+                          int swap_enabled, uint32_t pitch) {
   CMW_DCMIPP_Conf_t conf = {
       .output_width = out_w,
       .output_height = out_h,
@@ -88,6 +445,7 @@ static void CAM_ConfigPipe(uint32_t pipe,
       .mode = CMW_Aspect_ratio_manual_roi,
       .enable_swap = swap_enabled,
       .enable_gamma_conversion = 0,
+      .output_pitch = pitch,
   };
   uint32_t hw_pitch;
 
@@ -95,170 +453,1873 @@ static void CAM_ConfigPipe(uint32_t pipe,
 
   APP_REQUIRE_EQ(CMW_CAMERA_SetPipeConfig(pipe, &conf, &hw_pitch), HAL_OK);
 
-  assert(hw_pitch == out_w * bpp);
+  assert(hw_pitch == pitch);
 }
 
+#if NN_TILING != NN_TILING_CENTER || NN_MULTIRES_ENABLE || DISPLAY_FOLLOW_ENABLE
 /**
- * @brief  DCMIPP clock configuration callback
+ * @brief  Point the crop and scaler of a pipe at a new setup
+ * @note   Shadowed registers: applies from the next frame, pipe ISR or
+ *         before the pipe starts
  */
-HAL_StatusTypeDef MX_DCMIPP_ClockConfig(DCMIPP_HandleTypeDef *hdcmipp) {
-  UNUSED(hdcmipp);
-  RCC_PeriphCLKInitTypeDef clk = {0};
+static void CAM_PipeScaler_Program(uint32_t pipe, const DCMIPP_CropConfTypeDef *crop,
+                                   const DCMIPP_DecimationConfTypeDef *dec, const DCMIPP_DownsizeTypeDef *down) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
 
-  clk.PeriphClockSelection = RCC_PERIPHCLK_DCMIPP;
-  clk.DcmippClockSelection = RCC_DCMIPPCLKSOURCE_IC17;
-  clk.ICSelection[RCC_IC17].ClockSelection = RCC_ICCLKSOURCE_PLL2;
-  clk.ICSelection[RCC_IC17].ClockDivider = 3;
-  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK) {
-    return HAL_ERROR;
+  APP_REQUIRE(hdcmipp != NULL);
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetCropConfig(hdcmipp, pipe, crop), HAL_OK);
+  if (dec->VRatio != 0 || dec->HRatio != 0) {
+    APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetDecimationConfig(hdcmipp, pipe, dec), HAL_OK);
+    APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_EnableDecimation(hdcmipp, pipe), HAL_OK);
+  } else {
+    APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_DisableDecimation(hdcmipp, pipe), HAL_OK);
   }
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetDownsizeConfig(hdcmipp, pipe, down), HAL_OK);
+}
+#endif
 
-  clk.PeriphClockSelection = RCC_PERIPHCLK_CSI;
-  clk.ICSelection[RCC_IC18].ClockSelection = RCC_ICCLKSOURCE_PLL1;
-  clk.ICSelection[RCC_IC18].ClockDivider = 40;
-  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK) {
-    return HAL_ERROR;
+#if NN_TILING != NN_TILING_CENTER
+/**
+ * @brief  Set up a Pipe2 window scaling a sensor area to the ML frame
+ * @param  win: Window to fill
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
+ * @param  x: Left edge in sensor pixels, even
+ * @param  y: Top edge in sensor pixels, even
+ * @param  width: Area width in sensor pixels
+ * @param  height: Area height in sensor pixels
+ */
+static void CAM_MLWindow_Setup(cam_tile_conf_t *win, uint32_t sensor_w, uint32_t sensor_h,
+                               uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+  CMW_DCMIPP_Conf_t conf = {
+      .output_width = ML_WIDTH,
+      .output_height = ML_HEIGHT,
+      .output_format = ML_FORMAT,
+      .output_bpp = ML_BPP,
+      .mode = CMW_Aspect_ratio_manual_roi,
+      .enable_swap = CAM_ML_SWAP,
+      .enable_gamma_conversion = 0,
+      .manual_conf = {.width = width, .height = height, .offset_x = x, .offset_y = y},
+  };
+
+  /* The pipe only downscales */
+  APP_REQUIRE(width >= ML_WIDTH && height >= ML_HEIGHT);
+  APP_REQUIRE(x + width <= sensor_w && y + height <= sensor_h);
+
+  CMW_UTILS_GetPipeConfig(sensor_w, sensor_h, &conf, &win->crop, &win->dec, &win->down);
+  win->area = (cam_ml_tile_t){
+      .x0 = (float)x / sensor_w,
+      .y0 = (float)y / sensor_h,
+      .width = (float)width / sensor_w,
+      .height = (float)height / sensor_h,
+  };
+}
+
+/**
+ * @brief  Point the Pipe2 crop and scaler at a window
+ * @note   Shadowed registers: applies from the next frame, ML pipe ISR or
+ *         before the pipe starts
+ */
+static void CAM_MLWindow_Program(const cam_tile_conf_t *conf) {
+  CAM_PipeScaler_Program(DCMIPP_PIPE2, &conf->crop, &conf->dec, &conf->down);
+}
+#endif
+
+#if NN_TILING == NN_TILING_FULL_FOV
+/**
+ * @brief  Tiles of a given side needed along one sensor axis
+ * @param  length: Sensor size along the axis
+ * @param  side: Tile side
+ * @param  overlap: Minimum overlap of neighbor tiles
+ */
+static uint32_t CAM_MLTile_GridSize(uint32_t length, uint32_t side, uint32_t overlap) {
+  if (side >= length) {
+    return 1;
   }
+  return (length - overlap + (side - overlap) - 1) / (side - overlap);
+}
 
-  return HAL_OK;
+/**
+ * @brief  Add a grid of evenly spread square tiles covering the sensor
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
+ * @param  side: Tile side in sensor pixels
+ * @note   Fail-fast: panics beyond NN_TILING_MAX_TILES
+ */
+static void CAM_MLTile_AddScale(uint32_t sensor_w, uint32_t sensor_h, uint32_t side) {
+  const uint32_t overlap = side * NN_TILING_OVERLAP_PCT / 100U;
+  const uint32_t nx = CAM_MLTile_GridSize(sensor_w, side, overlap);
+  const uint32_t ny = CAM_MLTile_GridSize(sensor_h, side, overlap);
+
+  for (uint32_t y = 0; y < ny; y++) {
+    for (uint32_t x = 0; x < nx; x++) {
+      APP_REQUIRE(tile_ctx.nb < NN_TILING_MAX_TILES);
+
+      /* Even offsets, first and last tiles on the sensor edges */
+      CAM_MLWindow_Setup(&tile_ctx.tiles[tile_ctx.nb++], sensor_w, sensor_h,
+                         nx > 1 ? (x * (sensor_w - side) / (nx - 1)) & ~1U : (sensor_w - side) / 2,
+                         ny > 1 ? (y * (sensor_h - side) / (ny - 1)) & ~1U : (sensor_h - side) / 2,
+                         side, side);
+    }
+  }
 }
 
 /**
- * @brief  Initialize the camera module
+ * @brief  Point the Pipe2 crop and scaler at a tile
+ * @note   Shadowed registers: applies from the next frame, ML pipe ISR or
+ *         before the pipe starts
+ */
+static void CAM_MLTile_Program(uint32_t tile) {
+  CAM_MLWindow_Program(&tile_ctx.tiles[tile]);
+}
+
+/**
+ * @brief  Build the tile sweep and program its first tile
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void CAM_Init(void) {
-  CMW_CameraInit_t cam_conf = {
-      .width = 0, /* Let sensor driver choose */
-      .height = 0,
-      .fps = CAMERA_FPS,
-      .pixel_format = 0,
-      .anti_flicker = 0,
-      .mirror_flip = CAMERA_FLIP,
-  };
+static void CAM_MLTile_Init(uint32_t sensor_w, uint32_t sensor_h) {
+  const uint32_t side = MIN(sensor_w, sensor_h);
 
-  APP_REQUIRE(CMW_CAMERA_Init(&cam_conf, NULL) == CMW_ERROR_NONE);
+  tile_ctx.nb = 0;
+  CAM_MLTile_AddScale(sensor_w, sensor_h, side);
+#if NN_TILING_FINE
+  CAM_MLTile_AddScale(sensor_w, sensor_h, side / 2);
+#endif
 
-  /* Configure display pipe (Pipe1) */
-  CAM_ConfigPipe(DCMIPP_PIPE1,
-                 cam_conf.width, cam_conf.height,
-                 DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT,
-                 DISPLAY_FORMAT, DISPLAY_BPP, 0);
+  /* The first frame goes to slot 0 with tile 0 */
+  memset(tile_ctx.slot_tile, 0, sizeof(tile_ctx.slot_tile));
+  tile_ctx.acquired = tile_ctx.nb - 1;
+  CAM_MLTile_Program(0);
+}
 
-  /* Configure ML pipe (Pipe2) */
-  CAM_ConfigPipe(DCMIPP_PIPE2,
-                 cam_conf.width, cam_conf.height,
-                 ML_WIDTH, ML_HEIGHT,
-                 ML_FORMAT, ML_BPP, 1);
+#if ML_CAPTURE_MODE == ML_CAPTURE_CONTINUOUS
+/**
+ * @brief  Pick and program the tile of the next Pipe2 frame (ISR context)
+ * @param  completed: Slot just completed, now the latest frame
+ * @param  next: Slot the next frame is written to
+ * @note   Stays one tile ahead of the inference thread: frames are skipped
+ *         whenever it is slower than the sensor, tiles never are
+ */
+static void CAM_MLTile_Schedule(int completed, int next) {
+  uint32_t tile = (tile_ctx.acquired + 1) % tile_ctx.nb;
+
+  if (tile_ctx.slot_tile[completed] == tile) {
+    tile = (tile + 1) % tile_ctx.nb;
+  }
+
+  CAM_MLTile_Program(tile);
+  tile_ctx.slot_tile[next] = (uint8_t)tile;
 }
+#endif
 
 /**
- * @brief  Start the display pipe capture
- * @param  cam_mode: CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT
+ * @brief  Number of Pipe2 tiles in a full-FOV sweep
  */
-void CAM_DisplayPipe_Start(uint32_t cam_mode) {
-  uint8_t *buffer;
+uint32_t CAM_MLTile_GetCount(void) {
+  return tile_ctx.nb;
+}
 
-  buffer = Buffer_GetCameraDisplayBuffer(Buffer_GetCameraCaptureIndex());
-  APP_REQUIRE(buffer != NULL);
+/**
+ * @brief  Sensor area of a tile
+ */
+const cam_ml_tile_t *CAM_MLTile_Get(uint32_t tile) {
+  APP_REQUIRE(tile < tile_ctx.nb);
+  return &tile_ctx.tiles[tile].area;
+}
+
+/**
+ * @brief  Tile an acquired Pipe2 capture slot was taken with
+ */
+uint32_t CAM_MLTile_Acquire(int capture_idx) {
+  uint32_t tile;
+
+  APP_REQUIRE((unsigned)capture_idx < ML_CAPTURE_BUFFER_NB);
+
+  /* The held slot is never the next capture: its tag is stable */
+  tile = tile_ctx.slot_tile[capture_idx];
+  tile_ctx.acquired = tile;
+  return tile;
+}
+#elif NN_TILING == NN_TILING_ROI
+/**
+ * @brief  Hand a window to the ML pipe ISR
+ */
+static void CAM_MLRoi_Request(const cam_tile_conf_t *win) {
+  uint32_t basepri;
 
-  APP_REQUIRE(CMW_CAMERA_Start(DCMIPP_PIPE1, buffer, cam_mode) == CMW_ERROR_NONE);
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  roi_ctx.next = *win;
+  roi_ctx.dirty = 1;
+  Irq_Unlock(basepri);
 }
 
 /**
- * @brief  Start the ML pipe capture
- * @param  ml_buffer: Pointer to the ML output buffer
- * @param  cam_mode: CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT
+ * @brief  Program a requested window for the Pipe2 frame starting now and
+ *         tag its slot (ISR context, or under Irq_Lock(CAM_IRQ_PRIORITY))
+ * @param  slot: Slot the frame is written to
  */
-void CAM_MLPipe_Start(uint8_t *ml_buffer, uint32_t cam_mode) {
-  APP_REQUIRE(ml_buffer != NULL);
-  APP_REQUIRE(CMW_CAMERA_Start(DCMIPP_PIPE2, ml_buffer, cam_mode) == CMW_ERROR_NONE);
+static void CAM_MLRoi_Schedule(int slot) {
+  if (roi_ctx.dirty) {
+    CAM_MLWindow_Program(&roi_ctx.next);
+    roi_ctx.programmed = roi_ctx.next.area;
+    roi_ctx.dirty = 0;
+  }
+  roi_ctx.slot_area[slot] = roi_ctx.programmed;
 }
 
 /**
- * @brief  Update ISP parameters (auto exposure, white balance)
+ * @brief  Start on the whole sensor
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
  */
-void CAM_IspUpdate(void) {
-  APP_REQUIRE(CMW_CAMERA_Run() == CMW_ERROR_NONE);
+static void CAM_MLRoi_Init(uint32_t sensor_w, uint32_t sensor_h) {
+  cam_tile_conf_t win;
+
+  roi_ctx.sensor_w = sensor_w;
+  roi_ctx.sensor_h = sensor_h;
+  CAM_MLWindow_Setup(&win, sensor_w, sensor_h, 0, 0, sensor_w, sensor_h);
+  CAM_MLWindow_Program(&win);
+
+  roi_ctx.dirty = 0;
+  roi_ctx.programmed = win.area;
+  for (int i = 0; i < ML_CAPTURE_BUFFER_NB; i++) {
+    roi_ctx.slot_area[i] = win.area;
+  }
 }
 
 /**
- * @brief  Frame event callback (ISR context) - handles buffering
- * @param  pipe: Pipe that triggered the event
- * @retval HAL_OK
+ * @brief  Steer the Pipe2 window to a sensor area
  */
-int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe) {
-  if (pipe != DCMIPP_PIPE1) {
-    return HAL_OK;
+void CAM_MLRoi_Set(const cam_ml_tile_t *area) {
+  const float sw = (float)roi_ctx.sensor_w;
+  const float sh = (float)roi_ctx.sensor_h;
+  const uint32_t max_side = MIN(roi_ctx.sensor_w, roi_ctx.sensor_h);
+  uint32_t side;
+  float x;
+  float y;
+  cam_tile_conf_t win;
+
+  APP_REQUIRE(area != NULL);
+
+  side = (uint32_t)MAX(area->width * sw, area->height * sh);
+  side = MIN(MAX(side, NN_ROI_MIN_SIDE), max_side) & ~1U;
+
+  /* Same center, pushed back inside the sensor */
+  x = (area->x0 + area->width / 2.0f) * sw - side / 2.0f;
+  y = (area->y0 + area->height / 2.0f) * sh - side / 2.0f;
+  x = MIN(MAX(x, 0.0f), (float)(roi_ctx.sensor_w - side));
+  y = MIN(MAX(y, 0.0f), (float)(roi_ctx.sensor_h - side));
+
+  CAM_MLWindow_Setup(&win, roi_ctx.sensor_w, roi_ctx.sensor_h,
+                     (uint32_t)x & ~1U, (uint32_t)y & ~1U, side, side);
+  CAM_MLRoi_Request(&win);
+}
+
+/**
+ * @brief  Steer the Pipe2 window back to the whole sensor
+ */
+void CAM_MLRoi_SetFullFov(void) {
+  cam_tile_conf_t win;
+
+  CAM_MLWindow_Setup(&win, roi_ctx.sensor_w, roi_ctx.sensor_h, 0, 0, roi_ctx.sensor_w, roi_ctx.sensor_h);
+  CAM_MLRoi_Request(&win);
+}
+
+/**
+ * @brief  Window an acquired Pipe2 capture slot was taken with
+ */
+cam_ml_tile_t CAM_MLRoi_Acquire(int capture_idx) {
+  APP_REQUIRE((unsigned)capture_idx < ML_CAPTURE_BUFFER_NB);
+
+  /* The held slot is never the next capture: its tag is stable */
+  return roi_ctx.slot_area[capture_idx];
+}
+#endif
+
+#if NN_MULTIRES_ENABLE
+/**
+ * @brief  Set up the Pipe2 scalers of both sides; Pipe2 is at ML_WIDTH
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
+ * @note   The line pitch stays ML_PITCH: a smaller frame leaves the end of
+ *         each line unwritten
+ */
+static void CAM_MLRes_Init(uint32_t sensor_w, uint32_t sensor_h) {
+  static const uint32_t sides[2] = {ML_WIDTH, NN_MULTIRES_SIDE};
+
+  for (uint32_t i = 0; i < 2; i++) {
+    CMW_DCMIPP_Conf_t conf = {
+        .output_width = sides[i],
+        .output_height = sides[i],
+        .output_format = ML_FORMAT,
+        .output_bpp = ML_BPP,
+        .mode = CMW_Aspect_ratio_manual_roi,
+        .enable_swap = CAM_ML_SWAP,
+        .enable_gamma_conversion = 0,
+    };
+    cam_res_conf_t *res = &res_ctx.res[i];
+
+    /* The crop of the ML_WIDTH frame: the detections keep their frame */
+    CAM_CalcCropRoi(&conf.manual_conf, sensor_w, sensor_h, ML_WIDTH, ML_HEIGHT);
+    CMW_UTILS_GetPipeConfig(sensor_w, sensor_h, &conf, &res->crop, &res->dec, &res->down);
   }
 
-  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
-  int next_disp = Buffer_GetNextCameraDisplayIndex();
-  int next_capt = Buffer_GetNextCameraCaptureIndex();
+  res_ctx.requested = ML_WIDTH;
+  res_ctx.programmed = ML_WIDTH;
+  for (int i = 0; i < ML_CAPTURE_BUFFER_NB; i++) {
+    res_ctx.slot_side[i] = ML_WIDTH;
+  }
+}
 
-  /* Update DCMIPP to capture into next buffer */
-  if (hdcmipp != NULL) {
-    uint8_t *next_capt_buf = Buffer_GetCameraDisplayBuffer(next_capt);
-    APP_REQUIRE(next_capt_buf != NULL);
-    HAL_DCMIPP_PIPE_SetMemoryAddress(hdcmipp, DCMIPP_PIPE1,
-                                     DCMIPP_MEMORY_ADDRESS_0,
-                                     (uint32_t)next_capt_buf);
+/**
+ * @brief  Program the requested side for the Pipe2 frame starting now and
+ *         tag its slot (ISR context, or under Irq_Lock(CAM_IRQ_PRIORITY))
+ * @param  slot: Slot the frame is written to
+ */
+static void CAM_MLRes_Schedule(int slot) {
+  uint32_t side = res_ctx.requested;
+
+  if (side != res_ctx.programmed) {
+    const cam_res_conf_t *res = &res_ctx.res[side == ML_WIDTH ? 0 : 1];
+
+    CAM_PipeScaler_Program(DCMIPP_PIPE2, &res->crop, &res->dec, &res->down);
+    res_ctx.programmed = (uint16_t)side;
   }
+  res_ctx.slot_side[slot] = res_ctx.programmed;
+}
 
-  /* Update LCD to display completed buffer */
-  LCD_ReloadCameraLayer(Buffer_GetCameraDisplayBuffer(next_disp));
+/**
+ * @brief  Side of the Pipe2 frames from the next snapshot armed
+ */
+void CAM_MLRes_Set(uint32_t side) {
+  APP_REQUIRE(side == ML_WIDTH || side == NN_MULTIRES_SIDE);
+  res_ctx.requested = (uint16_t)side;
+}
 
-  /* Advance buffer indices */
-  Buffer_SetCameraDisplayIndex(next_disp);
-  Buffer_SetCameraCaptureIndex(next_capt);
+/**
+ * @brief  Side an acquired Pipe2 capture slot was written at
+ */
+uint32_t CAM_MLRes_Acquire(int capture_idx) {
+  APP_REQUIRE((unsigned)capture_idx < ML_CAPTURE_BUFFER_NB);
 
-  return HAL_OK;
+  /* The held slot is never the next capture: its tag is stable */
+  return res_ctx.slot_side[capture_idx];
 }
 
+/* Rows of the armed snapshot (ISR context) */
+#define CAM_ML_ROWS ((uint32_t)res_ctx.slot_side[ml_snap.slot])
+#else
+#define CAM_ML_ROWS ((uint32_t)ML_HEIGHT)
+#endif
+
+#if DISPLAY_FOLLOW_ENABLE
 /**
- * @brief  Vsync event callback (ISR context) - triggers ISP update
- * @param  pipe: Pipe that triggered the event
- * @retval HAL_OK
+ * @brief  Set up a Pipe1 window scaling a sensor area to the letterbox
+ * @param  conf: Window to fill
+ * @param  area: Sensor area, even offsets, inside the sensor
  */
-int CMW_CAMERA_PIPE_VsyncEventCallback(uint32_t pipe) {
-  if (pipe == DCMIPP_PIPE1) {
-    tx_semaphore_put(&isp_ctx.vsync_sem);
+static void CAM_DisplayFollow_Setup(cam_follow_conf_t *conf, const CMW_Manual_roi_area_t *area) {
+  CMW_DCMIPP_Conf_t pipe_conf = {
+      .output_width = DISPLAY_LETTERBOX_WIDTH,
+      .output_height = DISPLAY_LETTERBOX_HEIGHT,
+      .output_format = DISPLAY_FORMAT,
+      .output_bpp = DISPLAY_BPP,
+      .mode = CMW_Aspect_ratio_manual_roi,
+      .enable_swap = 0,
+      .enable_gamma_conversion = 0,
+      .manual_conf = *area,
+  };
+
+  /* The pipe only downscales */
+  APP_REQUIRE(area->width >= DISPLAY_LETTERBOX_WIDTH && area->height >= DISPLAY_LETTERBOX_HEIGHT);
+  APP_REQUIRE(area->offset_x + area->width <= follow_ctx.sensor_w &&
+              area->offset_y + area->height <= follow_ctx.sensor_h);
+
+  CMW_UTILS_GetPipeConfig(follow_ctx.sensor_w, follow_ctx.sensor_h, &pipe_conf, &conf->crop, &conf->dec, &conf->down);
+  CAM_DisplayMap_Init(&conf->map, &follow_ctx.det, area);
+}
+
+/**
+ * @brief  Start on the full view CAM_ConfigPipe() programmed
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
+ * @param  det: Sensor area the detections are normalized to
+ * @param  full: Pipe1 area of the full view
+ */
+static void CAM_DisplayFollow_Init(uint32_t sensor_w, uint32_t sensor_h, const CMW_Manual_roi_area_t *det,
+                                   const CMW_Manual_roi_area_t *full) {
+  follow_ctx.sensor_w = sensor_w;
+  follow_ctx.sensor_h = sensor_h;
+  follow_ctx.det = *det;
+  follow_ctx.full = *full;
+  follow_ctx.shown = *full;
+
+  follow_ctx.cx = full->offset_x + full->width / 2.0f;
+  follow_ctx.cy = full->offset_y + full->height / 2.0f;
+  follow_ctx.width = (float)full->width;
+  follow_ctx.target_cx = follow_ctx.cx;
+  follow_ctx.target_cy = follow_ctx.cy;
+  follow_ctx.target_width = follow_ctx.width;
+
+  follow_ctx.programmed = cam_display_map;
+  for (int i = 0; i < DISPLAY_BUFFER_NB; i++) {
+    follow_ctx.slot_map[i] = cam_display_map;
   }
-  return HAL_OK;
 }
 
 /**
- * @brief  ISP update thread entry
+ * @brief  Program a requested window for the Pipe1 frame starting now and
+ *         tag its slot (ISR context, or under Irq_Lock(CAM_IRQ_PRIORITY))
+ * @param  slot: Slot the frame is written to
  */
-static void isp_thread_entry(ULONG arg) {
-  UNUSED(arg);
+static void CAM_DisplayFollow_Schedule(int slot) {
+  if (follow_ctx.dirty) {
+    CAM_PipeScaler_Program(DCMIPP_PIPE1, &follow_ctx.next.crop, &follow_ctx.next.dec, &follow_ctx.next.down);
+    follow_ctx.programmed = follow_ctx.next.map;
+    follow_ctx.dirty = 0;
+  }
+  follow_ctx.slot_map[slot] = follow_ctx.programmed;
+}
 
-  while (1) {
-    tx_semaphore_get(&isp_ctx.vsync_sem, TX_WAIT_FOREVER);
-    CAM_IspUpdate();
+/**
+ * @brief  Box to follow: the followed track while it lives, else the
+ *         largest one
+ * @param  nb: Boxes in follow_ctx.boxes
+ * @retval Box index, -1 without tracks
+ */
+static int CAM_DisplayFollow_Pick(uint32_t nb) {
+  int largest = -1;
+  float largest_area = 0.0f;
+
+  for (uint32_t i = 0; i < nb; i++) {
+    float area = follow_ctx.boxes[i].width * follow_ctx.boxes[i].height;
+
+    if (follow_ctx.ids[i] == follow_ctx.track_id) {
+      return (int)i;
+    }
+    if (area > largest_area) {
+      largest = (int)i;
+      largest_area = area;
+    }
   }
+  return largest;
 }
 
 /**
- * @brief  Initialize ISP semaphore
- * @note   Fail-fast: panics on unrecoverable failures
+ * @brief  Step the window toward the primary track and hand it to the
+ *         display pipe ISR when it moved
  */
-void CAM_InitIspSemaphore(void) {
-  APP_REQUIRE_EQ(tx_semaphore_create(&isp_ctx.vsync_sem, "isp_vsync", 0), TX_SUCCESS);
+void CAM_DisplayFollow_Update(void) {
+  const CMW_Manual_roi_area_t *full = &follow_ctx.full;
+  const float aspect = (float)full->height / full->width;
+  const float min_width = MAX((float)full->width / DISPLAY_FOLLOW_MAX_ZOOM, (float)DISPLAY_LETTERBOX_WIDTH);
+  /* The boxes a little ahead, at the frame the window lands on */
+  uint32_t nb = Tracker_Predict(follow_ctx.boxes, follow_ctx.ids, TRACKER_MAX_TRACKS, DWT->CYCCNT);
+  int pick = CAM_DisplayFollow_Pick(nb);
+  CMW_Manual_roi_area_t area;
+  cam_follow_conf_t conf;
+  uint32_t basepri;
+
+  if (pick >= 0) {
+    const nn_detection_t *box = &follow_ctx.boxes[pick];
+    float box_w = box->width * follow_ctx.det.width;
+    float box_h = box->height * follow_ctx.det.height;
+
+    follow_ctx.track_id = follow_ctx.ids[pick];
+    follow_ctx.lost = 0;
+    follow_ctx.target_cx = follow_ctx.det.offset_x + box->x_center * follow_ctx.det.width;
+    follow_ctx.target_cy = follow_ctx.det.offset_y + box->y_center * follow_ctx.det.height;
+    follow_ctx.target_width = MAX(box_w, box_h / aspect) * 100.0f / DISPLAY_FOLLOW_FILL_PCT;
+  } else if (++follow_ctx.lost >= DISPLAY_FOLLOW_HOLD_FRAMES) {
+    /* Zoom back out to the full view */
+    follow_ctx.track_id = 0;
+    follow_ctx.target_cx = full->offset_x + full->width / 2.0f;
+    follow_ctx.target_cy = full->offset_y + full->height / 2.0f;
+    follow_ctx.target_width = (float)full->width;
+  }
+
+  /* First-order smoothing: no jump on a jittery box or a new track */
+  follow_ctx.cx += (follow_ctx.target_cx - follow_ctx.cx) * (DISPLAY_FOLLOW_SMOOTH_PCT / 100.0f);
+  follow_ctx.cy += (follow_ctx.target_cy - follow_ctx.cy) * (DISPLAY_FOLLOW_SMOOTH_PCT / 100.0f);
+  follow_ctx.width += (follow_ctx.target_width - follow_ctx.width) * (DISPLAY_FOLLOW_SMOOTH_PCT / 100.0f);
+  follow_ctx.width = MIN(MAX(follow_ctx.width, min_width), (float)full->width);
+
+  /* Even edges, the aspect of the letterbox, inside the full view */
+  area.width = (uint32_t)follow_ctx.width & ~1U;
+  area.height = MIN(MAX((uint32_t)(area.width * aspect) & ~1U, (uint32_t)DISPLAY_LETTERBOX_HEIGHT), full->height);
+  area.offset_x = (uint32_t)MIN(MAX(follow_ctx.cx - area.width / 2.0f, (float)full->offset_x),
+                                (float)(full->offset_x + full->width - area.width)) & ~1U;
+  area.offset_y = (uint32_t)MIN(MAX(follow_ctx.cy - area.height / 2.0f, (float)full->offset_y),
+                                (float)(full->offset_y + full->height - area.height)) & ~1U;
+  if (memcmp(&area, &follow_ctx.shown, sizeof(area)) == 0) {
+    return;
+  }
+  follow_ctx.shown = area;
+
+  CAM_DisplayFollow_Setup(&conf, &area);
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  follow_ctx.next = conf;
+  follow_ctx.dirty = 1;
+  Irq_Unlock(basepri);
 }
+#endif
 
 /**
- * @brief  Initialize and start the ISP update thread
- * @param  memory_ptr: Unused (static allocation)
+ * @brief  Leave the vsync interrupt to CAM_VSYNC_PIPE once a pipe is started
+ * @note   Every pipe takes the same sensor frame: their vsync events land
+ *         together and only CAM_VSYNC_PIPE's does any work, the others only
+ *         bump frame counters of the ISP library nothing reads. One vsync
+ *         callback per frame instead of one per pipe
+ */
+static void CAM_CoalesceVsync(uint32_t pipe) {
+  static const uint32_t vsync_it[CAM_PIPE_NB] = {DCMIPP_IT_PIPE0_VSYNC, DCMIPP_IT_PIPE1_VSYNC,
+                                                 DCMIPP_IT_PIPE2_VSYNC};
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t basepri;
+
+  APP_REQUIRE(hdcmipp != NULL && pipe < CAM_PIPE_NB);
+  if (pipe == CAM_VSYNC_PIPE) {
+    return;
+  }
+
+  /* CMIER is also written from the DCMIPP interrupt */
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  __HAL_DCMIPP_DISABLE_IT(hdcmipp, vsync_it[pipe]);
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Start a pipe in double-buffer mode on two ring slots
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void Thread_IspUpdate_Init(VOID *memory_ptr) {
-  UNUSED(memory_ptr);
+static void CAM_Dbm_Start(cam_dbm_t *dbm, uint32_t pipe, uint8_t *buf0, int slot0,
+                          uint8_t *buf1, int slot1, uint32_t cam_mode) {
+  APP_REQUIRE(buf0 != NULL && buf1 != NULL);
+
+  dbm->slot[0] = (int8_t)slot0;
+  dbm->slot[1] = (int8_t)slot1;
+  dbm->synced = 0;
+
+  APP_REQUIRE(CMW_CAMERA_DoubleBufferStart(pipe, buf0, buf1, cam_mode) == CMW_ERROR_NONE);
+  CAM_CoalesceVsync(pipe);
+}
+
+/**
+ * @brief  Address register a pipe's last frame was written through (ISR context)
+ * @note   LSTFRM toggles with the register in use; a frame event served more
+ *         than a frame late still names the newest frame, never a torn one.
+ *         The same bank twice in a row means one event covered two frames:
+ *         the address of the skipped one was refilled late, counted as such
+ */
+static uint32_t CAM_Dbm_CompletedBank(cam_dbm_t *dbm, const DCMIPP_HandleTypeDef *hdcmipp) {
+  uint8_t lstfrm = (READ_REG(hdcmipp->Instance->CMSR1) & dbm->lstfrm_mask) != 0U;
+  uint8_t bank;
 
+  /* The first frame goes through address 0 */
+  if (!dbm->synced) {
+    dbm->parity = lstfrm;
+    dbm->synced = 1;
+    dbm->last_bank = 1;
+  }
+
+  bank = lstfrm ^ dbm->parity;
+  if (bank == dbm->last_bank) {
+    cam_pipe_stats[dbm->pipe].late_swaps++;
+  }
+  dbm->last_bank = bank;
+
+  return bank;
+}
+
+/**
+ * @brief  Refill a pipe's completed address register (ISR context)
+ * @note   DCMIPP is writing through the other register: the new address is
+ *         only used once the current frame completes
+ */
+static void CAM_Dbm_Queue(cam_dbm_t *dbm, DCMIPP_HandleTypeDef *hdcmipp, uint32_t pipe,
+                          uint32_t bank, int slot, const uint8_t *buffer) {
+  APP_REQUIRE(buffer != NULL);
+
+  dbm->slot[bank] = (int8_t)slot;
+  HAL_DCMIPP_PIPE_SetMemoryAddress(hdcmipp, pipe,
+                                   bank ? DCMIPP_MEMORY_ADDRESS_1 : DCMIPP_MEMORY_ADDRESS_0,
+                                   (uint32_t)buffer);
+}
+
+#if DUAL_STREAM_ENABLE
+/**
+ * @brief  Configure the dump pipe (Pipe0) for the second sensor stream
+ * @note   Fail-fast: panics on unrecoverable failures. The stream comes in
+ *         processed at the ML size on its own virtual channel: Pipe0 only
+ *         filters it from the CSI-2 link and writes it
+ */
+static void CAM_DualPipe_Config(void) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  DCMIPP_PipeConfTypeDef pipe_conf = {.FrameRate = DCMIPP_FRAME_RATE_ALL};
+
+  APP_REQUIRE(hdcmipp != NULL);
+  APP_REQUIRE_EQ(CMW_CAMERA_SetPipeSource(DCMIPP_PIPE0, DUAL_STREAM_VC, DUAL_STREAM_DT, DCMIPP_CSI_DT_BPP8),
+                 CMW_ERROR_NONE);
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetConfig(hdcmipp, DCMIPP_PIPE0, &pipe_conf), HAL_OK);
+
+  /* A stream larger than the ML frame can never spill past a slot */
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_EnableLimitEvent(hdcmipp, DCMIPP_PIPE0,
+                                                  Buffer_GetDesc(BUFFER_ID_ML_CAPTURE)->slot_size / 4U),
+                 HAL_OK);
+}
+
+/**
+ * @brief  Stream of the next ML snapshot (ISR context)
+ * @note   Turns alternate while both streams are active, or both idle;
+ *         otherwise the active one takes them, the idle one one in
+ *         DUAL_STREAM_IDLE_PERIOD
+ */
+static uint32_t CAM_MLStream_Pick(void) {
+  uint32_t idle0 = stream_ctx.misses[0] >= DUAL_STREAM_IDLE_RUNS;
+  uint32_t idle1 = stream_ctx.misses[1] >= DUAL_STREAM_IDLE_RUNS;
+  uint32_t stream;
+
+  if (idle0 == idle1) {
+    stream = stream_ctx.last ^ 1U;
+  } else if (++stream_ctx.turns % DUAL_STREAM_IDLE_PERIOD == 0U) {
+    stream = idle0 ? 0U : 1U;
+  } else {
+    stream = idle0 ? 1U : 0U;
+  }
+  stream_ctx.last = (uint8_t)stream;
+  return stream;
+}
+
+/**
+ * @brief  Stream an acquired ML capture slot was written from
+ */
+uint32_t CAM_MLStream_Get(int capture_idx) {
+  APP_REQUIRE((unsigned)capture_idx < ML_CAPTURE_BUFFER_NB);
+
+  /* The held slot is never the next capture: its tag is stable */
+  return stream_ctx.slot_stream[capture_idx];
+}
+
+/**
+ * @brief  Activity of a stream, from the detections of one of its frames
+ */
+void CAM_MLStream_Report(uint32_t stream, uint32_t nb_detect) {
+  APP_REQUIRE(stream < CAM_STREAM_NB);
+
+  if (nb_detect != 0U) {
+    stream_ctx.misses[stream] = 0;
+  } else if (stream_ctx.misses[stream] < UINT8_MAX) {
+    stream_ctx.misses[stream]++;
+  }
+}
+#endif
+
+#if AUX_STREAM_ENABLE
+/**
+ * @brief  Configure the dump pipe (Pipe0) for the auxiliary motion stream
+ * @param  sensor_w: Sensor width
+ * @param  sensor_h: Sensor height
+ * @note   Fail-fast: panics on unrecoverable failures. Pipe0 has no crop to
+ *         scale or pixel pipeline: CMW_CAMERA_SetPipeConfig() leaves its
+ *         decimation unset, so the HAL is programmed directly
+ */
+static void CAM_AuxPipe_Config(uint32_t sensor_w, uint32_t sensor_h) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  DCMIPP_PipeConfTypeDef pipe_conf = {.FrameRate = AUX_FRAME_RATE};
+
+  APP_REQUIRE(hdcmipp != NULL);
+  APP_REQUIRE(sensor_w == 2U * AUX_WIDTH && sensor_h == 2U * AUX_HEIGHT);
+
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetConfig(hdcmipp, DCMIPP_PIPE0, &pipe_conf), HAL_OK);
+
+  /* First sample of each pair on every second line: one Bayer channel */
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetBytesDecimationConfig(hdcmipp, DCMIPP_PIPE0,
+                                                          DCMIPP_OEBS_ODD, DCMIPP_BSM_DATA_OUT_2),
+                 HAL_OK);
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetLinesDecimationConfig(hdcmipp, DCMIPP_PIPE0,
+                                                          DCMIPP_OELS_EVEN, DCMIPP_LSM_ALTERNATE_2),
+                 HAL_OK);
+
+  /* RAW10 unpacked MSB-aligned: the high byte of a sample is its 8 MSBs */
+  SET_BIT(hdcmipp->Instance->P0PPCR, DCMIPP_P0PPCR_PAD);
+
+  /* A sensor mode change can never spill past a slot */
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_EnableLimitEvent(hdcmipp, DCMIPP_PIPE0,
+                                                  Buffer_GetDesc(BUFFER_ID_AUX_STREAM)->slot_size / 4U),
+                 HAL_OK);
+}
+
+/**
+ * @brief  Start the auxiliary motion stream capture
+ * @param  cam_mode: CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT
+ */
+void CAM_AuxPipe_Start(uint32_t cam_mode) {
+  aux_latest = -1;
+  if (!aux_active) {
+    return;
+  }
+  CAM_Dbm_Start(&aux_dbm, DCMIPP_PIPE0,
+                Buffer_GetAuxStreamBuffer(0), 0,
+                Buffer_GetAuxStreamBuffer(1), 1, cam_mode);
+}
+
+/**
+ * @brief  Latest complete auxiliary motion frame
+ */
+const uint8_t *CAM_AuxPipe_GetFrame(void) {
+  int slot = aux_latest;
+
+  return slot < 0 ? NULL : Buffer_GetAuxStreamBuffer(slot);
+}
+#endif
+
+/**
+ * @brief  DCMIPP clock configuration callback
+ */
+HAL_StatusTypeDef MX_DCMIPP_ClockConfig(DCMIPP_HandleTypeDef *hdcmipp) {
+  UNUSED(hdcmipp);
+  RCC_PeriphCLKInitTypeDef clk = {0};
+
+  clk.PeriphClockSelection = RCC_PERIPHCLK_DCMIPP;
+  clk.DcmippClockSelection = RCC_DCMIPPCLKSOURCE_IC17;
+  clk.ICSelection[RCC_IC17].ClockSelection = RCC_ICCLKSOURCE_PLL2;
+  clk.ICSelection[RCC_IC17].ClockDivider = 3;
+  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK) {
+    return HAL_ERROR;
+  }
+
+  clk.PeriphClockSelection = RCC_PERIPHCLK_CSI;
+  clk.ICSelection[RCC_IC18].ClockSelection = RCC_ICCLKSOURCE_PLL1;
+  clk.ICSelection[RCC_IC18].ClockDivider = 40;
+  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK) {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+ * @brief  Preset of the connected sensor
+ * @note   Fail-fast: panics on a sensor without a preset
+ */
+static const cam_sensor_preset_t *CAM_GetSensorPreset(void) {
+  CMW_Sensor_Name_t sensor = CMW_NOTKNOWN_Sensor;
+
+  APP_REQUIRE_EQ(CMW_CAMERA_GetSensorName(&sensor), CMW_ERROR_NONE);
+  for (uint32_t i = 0; i < sizeof(cam_sensor_presets) / sizeof(cam_sensor_presets[0]); i++) {
+    if (cam_sensor_presets[i].sensor == sensor) {
+      return &cam_sensor_presets[i];
+    }
+  }
+
+  APP_REQUIRE(0);
+  return NULL;
+}
+
+/**
+ * @brief  Whether a sensor mode serves every pipe
+ * @param  mode: Sensor readout mode
+ * @param  full_fov_width: Widest field of view among the modes
+ * @param  preset: Preset of the sensor
+ */
+static int CAM_SensorModeFits(const CMW_Sensor_Mode_t *mode, uint32_t full_fov_width,
+                              const cam_sensor_preset_t *preset) {
+  const uint32_t side = MIN(mode->width, mode->height);
+
+  if (mode->max_fps < preset->fps || mode->fov_width * 100U < full_fov_width * CAMERA_MIN_FOV_PCT) {
+    return 0;
+  }
+
+  /* Pipes only downscale: the letterbox, then the smallest Pipe2 window */
+  if (mode->width < DISPLAY_LETTERBOX_WIDTH || mode->height < DISPLAY_LETTERBOX_HEIGHT) {
+    return 0;
+  }
+#if NN_TILING == NN_TILING_FULL_FOV && NN_TILING_FINE
+  if (side / 2U < ML_WIDTH) {
+    return 0;
+  }
+#elif NN_TILING == NN_TILING_ROI
+  if (side < NN_ROI_MIN_SIDE) {
+    return 0;
+  }
+#else
+  if (side < ML_WIDTH) {
+    return 0;
+  }
+#endif
+
+#if AUX_STREAM_ENABLE
+  /* Pipe0 keeps one Bayer channel of the readout */
+  if (preset->aux && (mode->width != 2U * AUX_WIDTH || mode->height != 2U * AUX_HEIGHT)) {
+    return 0;
+  }
+#endif
+
+  return 1;
+}
+
+/**
+ * @brief  Pick the smallest sensor mode serving every pipe at the sensor rate
+ * @param  preset: Preset of the probed sensor
+ * @param  width: Mode width, 0 to let the sensor driver choose
+ * @param  height: Mode height, 0 to let the sensor driver choose
+ * @note   Fail-fast: panics when no mode fits
+ */
+static void CAM_SelectSensorMode(const cam_sensor_preset_t *preset, uint32_t *width, uint32_t *height) {
+  CMW_Sensor_Mode_t modes[CAMERA_MAX_SENSOR_MODES];
+  uint32_t nb = CAMERA_MAX_SENSOR_MODES;
+  uint32_t full_fov_width = 0;
+  int best = -1;
+
+  *width = 0;
+  *height = 0;
+  if (CMW_CAMERA_GetSensorModes(modes, &nb) != CMW_ERROR_NONE) {
+    /* No mode table: full array */
+    return;
+  }
+
+  for (uint32_t i = 0; i < nb; i++) {
+    full_fov_width = MAX(full_fov_width, modes[i].fov_width);
+  }
+  for (uint32_t i = 0; i < nb; i++) {
+    if (CAM_SensorModeFits(&modes[i], full_fov_width, preset) &&
+        (best < 0 || modes[i].width * modes[i].height < modes[best].width * modes[best].height)) {
+      best = (int)i;
+    }
+  }
+
+  APP_REQUIRE(best >= 0);
+  *width = modes[best].width;
+  *height = modes[best].height;
+}
+
+/**
+ * @brief  Follow a new sensor frame rate: snapshot timing and ISP run rate
+ * @param  fps: Sensor frame rate
+ */
+static void CAM_FrameRate_Apply(int32_t fps) {
+  uint32_t basepri;
+
+  cam_fps = fps;
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  isp_ctx.base_period = ISP_BASE_PERIOD(fps);
+  isp_ctx.period = isp_ctx.base_period;
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Initialize the camera module
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+IN_XIP void CAM_Init(void) {
+  /* Probe first: the sensor decides the rate and the readout modes */
+  const cam_sensor_preset_t *preset = CAM_GetSensorPreset();
+  CMW_CameraInit_t cam_conf = {
+      .fps = preset->fps,
+      .pixel_format = 0,
+      .anti_flicker = 0,
+      .mirror_flip = CAMERA_FLIP,
+  };
+  CMW_Manual_roi_area_t display_area, det_area;
+
+  CAM_SelectSensorMode(preset, &cam_conf.width, &cam_conf.height);
+  APP_REQUIRE(CMW_CAMERA_Init(&cam_conf, NULL) == CMW_ERROR_NONE);
+  /* The middleware enables DCMIPP and CSI at its own level: move them to the
+   * plan's before the first capture */
+  HAL_NVIC_SetPriority(DCMIPP_IRQn, CAM_IRQ_PRIORITY, 0);
+  HAL_NVIC_SetPriority(CSI_IRQn, CAM_IRQ_PRIORITY, 0);
+  CAM_FrameRate_Apply(preset->fps);
+#if PIPE_BENCH
+  PipeBench_Init();
+#endif
+
+  /* Configure display pipe (Pipe1). Left stopped with DISPLAY_SINGLE_PIPE,
+   * but still configured: Pipe2 taps its ISP */
+  CAM_ConfigPipe(DCMIPP_PIPE1,
+                 cam_conf.width, cam_conf.height,
+                 DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT,
+                 DISPLAY_FORMAT, DISPLAY_BPP, 0, BUFFER_PITCH(DISPLAY_LETTERBOX_WIDTH, DISPLAY_BPP, PIPE1));
+
+  /* Configure ML pipe (Pipe2) */
+  CAM_ConfigPipe(DCMIPP_PIPE2,
+                 cam_conf.width, cam_conf.height,
+                 ML_WIDTH, ML_HEIGHT,
+                 ML_FORMAT, ML_BPP, CAM_ML_SWAP, ML_PITCH);
+#if ML_CAPTURE_MODE == ML_CAPTURE_CONTINUOUS
+  /* The middleware configures every frame: skipped ones are never written */
+  CAM_SetMLDecimation(ml_decimation);
+#endif
+
+  /* Detections to display pixels, from the crops CAM_ConfigPipe() programmed */
+  CAM_CalcCropRoi(&display_area, cam_conf.width, cam_conf.height, DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT);
+#if NN_TILING == NN_TILING_CENTER
+  CAM_CalcCropRoi(&det_area, cam_conf.width, cam_conf.height, ML_WIDTH, ML_HEIGHT);
+#else
+  det_area = (CMW_Manual_roi_area_t){.width = cam_conf.width, .height = cam_conf.height};
+#endif
+  CAM_DisplayMap_Init(&cam_display_map, &det_area, &display_area);
+#if DISPLAY_FOLLOW_ENABLE
+  /* Then zoomed on the primary track */
+  CAM_DisplayFollow_Init(cam_conf.width, cam_conf.height, &det_area, &display_area);
+#endif
+
+#if DETECTION_AE_ENABLE
+  /* Pipe2 area: the detections and tracks are normalized to it */
+  dae_ctx.frame = det_area;
+#endif
+
+#if NN_TILING == NN_TILING_FULL_FOV
+  /* Then moved from tile to tile, frame by frame */
+  CAM_MLTile_Init(cam_conf.width, cam_conf.height);
+#elif NN_TILING == NN_TILING_ROI
+  /* Then steered by the detections */
+  CAM_MLRoi_Init(cam_conf.width, cam_conf.height);
+#endif
+#if NN_MULTIRES_ENABLE
+  /* Then resized with the active network */
+  CAM_MLRes_Init(cam_conf.width, cam_conf.height);
+#endif
+
+#if DUAL_STREAM_ENABLE
+  /* Second sensor stream (Pipe0), from the CSI-2 bridge */
+  CAM_DualPipe_Config();
+#endif
+
+#if AUX_STREAM_ENABLE
+  /* Auxiliary motion stream (Pipe0), when the sensor provides it */
+  aux_active = preset->aux;
+  if (aux_active) {
+    CAM_AuxPipe_Config(cam_conf.width, cam_conf.height);
+  }
+#endif
+}
+
+#if !DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Start the display pipe capture
+ * @param  cam_mode: CMW_MODE_CONTINUOUS or CMW_MODE_SNAPSHOT
+ */
+void CAM_DisplayPipe_Start(uint32_t cam_mode) {
+  int slot0 = Buffer_GetCameraCaptureIndex();
+  int slot1 = Buffer_CameraDisplay_NextCapture();
+#if DISPLAY_FOLLOW_ENABLE
+  uint32_t basepri;
+#endif
+
+#if DISPLAY_FOLLOW_ENABLE
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  CAM_DisplayFollow_Schedule(slot0);
+  Irq_Unlock(basepri);
+#endif
+
+  CAM_Dbm_Start(&display_dbm, DCMIPP_PIPE1,
+                Buffer_GetCameraDisplayBuffer(slot0), slot0,
+                Buffer_GetCameraDisplayBuffer(slot1), slot1, cam_mode);
+}
+#endif
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  Raise the Pipe2 line event every ML_SLICE_LINES lines
+ * @param  pipe: Pipe of the snapshot; Pipe0 (second stream) has no band
+ */
+static void CAM_MLPipe_EnableRows(uint32_t pipe) {
+#if ML_SLICE_INGEST
+  if (pipe == DCMIPP_PIPE2) {
+    APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_EnableLineEvent(CMW_CAMERA_GetDCMIPPHandle(), DCMIPP_PIPE2, CAM_SLICE_LINEMULT),
+                   HAL_OK);
+  }
+#else
+  UNUSED(pipe);
+#endif
+}
+
+/**
+ * @brief  Arm a Pipe2 snapshot into a free ring slot
+ * @note   ISR context or Irq_Lock(CAM_IRQ_PRIORITY): the pipe is idle
+ *         between snapshots, so address and tile or window are programmed
+ *         before the capture request
+ */
+static void CAM_MLPipe_Arm(DCMIPP_HandleTypeDef *hdcmipp) {
+  int slot = Buffer_MLCapture_NextCapture(-1);
+#if DUAL_STREAM_ENABLE
+  uint32_t stream = CAM_MLStream_Pick();
+  uint32_t pipe = stream == 0U ? DCMIPP_PIPE2 : DCMIPP_PIPE0;
+
+  stream_ctx.slot_stream[slot] = (uint8_t)stream;
+  if ((hdcmipp->Instance->P2FSCR & DCMIPP_P2FSCR_PIPEN) == 0U && pipe == DCMIPP_PIPE2) {
+    /* First main-sensor snapshot: Pipe1 keeps its virtual channel running,
+     * so the HAL start does not wait */
+    ml_snap.slot = (int8_t)slot;
+    ml_snap.pipe = DCMIPP_PIPE2;
+    ml_snap.requested = 0;
+    ml_snap.armed = 1;
+    ml_snap.capture++;
+    ml_snap.rows = 0;
+    ml_snap.since_arm = 0;
+    APP_REQUIRE_EQ(HAL_DCMIPP_CSI_PIPE_Start(hdcmipp, DCMIPP_PIPE2, DCMIPP_VIRTUAL_CHANNEL0,
+                                             (uint32_t)Buffer_GetMLCaptureBuffer(slot), DCMIPP_MODE_SNAPSHOT),
+                   HAL_OK);
+    __HAL_DCMIPP_DISABLE_IT(hdcmipp, DCMIPP_IT_PIPE2_VSYNC);
+    CAM_MLPipe_EnableRows(DCMIPP_PIPE2);
+    return;
+  }
+#else
+  uint32_t pipe = DCMIPP_PIPE2;
+#endif
+
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetMemoryAddress(hdcmipp, pipe, DCMIPP_MEMORY_ADDRESS_0,
+                                                  (uint32_t)Buffer_GetMLCaptureBuffer(slot)),
+                 HAL_OK);
+#if NN_TILING == NN_TILING_FULL_FOV
+  /* Every snapshot is read: simply the tile after the one being inferred */
+  tile_ctx.slot_tile[slot] = (uint8_t)((tile_ctx.acquired + 1) % tile_ctx.nb);
+  CAM_MLTile_Program(tile_ctx.slot_tile[slot]);
+#elif NN_TILING == NN_TILING_ROI
+  CAM_MLRoi_Schedule(slot);
+#endif
+#if NN_MULTIRES_ENABLE
+  CAM_MLRes_Schedule(slot);
+#endif
+
+  ml_snap.slot = (int8_t)slot;
+  ml_snap.pipe = (uint8_t)pipe;
+  ml_snap.requested = 0;
+  ml_snap.armed = 1;
+  ml_snap.capture++;
+  ml_snap.rows = 0;
+  ml_snap.since_arm = 0;
+
+  /* The HAL closes a snapshot by masking the pipe interrupts */
+  hdcmipp->PipeState[pipe] = HAL_DCMIPP_PIPE_STATE_BUSY;
+#if DUAL_STREAM_ENABLE
+  if (pipe == DCMIPP_PIPE0) {
+    __HAL_DCMIPP_ENABLE_IT(hdcmipp, DCMIPP_IT_PIPE0_FRAME | DCMIPP_IT_PIPE0_OVR);
+  } else
+#endif
+  {
+    __HAL_DCMIPP_ENABLE_IT(hdcmipp, DCMIPP_IT_PIPE2_FRAME | DCMIPP_IT_PIPE2_OVR | CAM_SLICE_LINE_IT |
+                                        (CAM_VSYNC_PIPE == DCMIPP_PIPE2 ? DCMIPP_IT_PIPE2_VSYNC : 0U));
+  }
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_EnableCapture(hdcmipp, pipe), HAL_OK);
+}
+
+/**
+ * @brief  An armed snapshot completes within two frame periods: the rest of
+ *         the current frame, then the captured one. At most one snapshot
+ *         every CAM_GetMLDecimation() sensor frames
+ */
+static inline int CAM_MLPipe_SnapshotDue(uint32_t now) {
+  return ml_snap.since_arm >= ml_snap.decimation &&
+         (int32_t)(now + 2U * (SystemCoreClock / (uint32_t)cam_fps) - ml_snap.deadline) >= 0;
+}
+
+/**
+ * @brief  Request the next Pipe2 frame, due by a DWT cycle stamp
+ */
+void CAM_MLPipe_RequestSnapshot(uint32_t deadline_cycles) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t basepri;
+
+  APP_REQUIRE(hdcmipp != NULL);
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  if (!ml_snap.armed) {
+    ml_snap.deadline = deadline_cycles;
+    if (CAM_MLPipe_SnapshotDue(DWT->CYCCNT)) {
+      CAM_MLPipe_Arm(hdcmipp);
+    } else {
+      ml_snap.requested = 1;
+    }
+  }
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Start the ML pipe capture with a first snapshot
+ * @note   DUAL_STREAM_ENABLE: the second stream's, so that Pipe0 starts its
+ *         virtual channel from this thread; Pipe2 joins at its first arming
+ */
+void CAM_MLPipe_Start(void) {
+  int slot = Buffer_GetMLCaptureIndex();
+  uint8_t *buffer = Buffer_GetMLCaptureBuffer(slot);
+
+  APP_REQUIRE(buffer != NULL);
+
+#if DUAL_STREAM_ENABLE
+  ml_snap.pipe = DCMIPP_PIPE0;
+  stream_ctx.slot_stream[slot] = 1;
+  stream_ctx.last = 1;
+#endif
+#if NN_MULTIRES_ENABLE
+  CAM_MLRes_Schedule(slot);
+#endif
+  ml_snap.slot = (int8_t)slot;
+  ml_snap.requested = 0;
+  ml_snap.armed = 1;
+  ml_snap.capture++;
+  ml_snap.rows = 0;
+  ml_snap.since_arm = 0;
+  APP_REQUIRE(CMW_CAMERA_Start(ml_snap.pipe, buffer, CMW_MODE_SNAPSHOT) == CMW_ERROR_NONE);
+  CAM_CoalesceVsync(ml_snap.pipe);
+  CAM_MLPipe_EnableRows(ml_snap.pipe);
+}
+#else
+/**
+ * @brief  Start the ML pipe capture
+ */
+void CAM_MLPipe_Start(void) {
+  int slot0 = Buffer_GetMLCaptureIndex();
+  int slot1 = Buffer_MLCapture_NextCapture(slot0);
+
+  CAM_Dbm_Start(&ml_dbm, DCMIPP_PIPE2,
+                Buffer_GetMLCaptureBuffer(slot0), slot0,
+                Buffer_GetMLCaptureBuffer(slot1), slot1, CMW_MODE_CONTINUOUS);
+}
+#endif
+
+/**
+ * @brief  Stop a pipe that stopped delivering frames, before its restart
+ */
+static void CAM_StopStalledPipe(uint32_t pipe) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+
+  APP_REQUIRE(hdcmipp != NULL);
+  APP_REQUIRE_EQ(HAL_DCMIPP_CSI_PIPE_Stop(hdcmipp, pipe, CMW_CAMERA_GetPipeVirtualChannel(pipe)), HAL_OK);
+  cam_pipe_stats[pipe].restarts++;
+}
+
+#if !DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Restart the display pipe on the two slots it was capturing into
+ */
+void CAM_DisplayPipe_Restart(void) {
+  int slot0 = display_dbm.slot[0];
+  int slot1 = display_dbm.slot[1];
+#if DISPLAY_FOLLOW_ENABLE
+  uint32_t basepri;
+#endif
+
+  CAM_StopStalledPipe(DCMIPP_PIPE1);
+#if DISPLAY_FOLLOW_ENABLE
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  CAM_DisplayFollow_Schedule(slot0);
+  Irq_Unlock(basepri);
+#endif
+  CAM_Dbm_Start(&display_dbm, DCMIPP_PIPE1,
+                Buffer_GetCameraDisplayBuffer(slot0), slot0,
+                Buffer_GetCameraDisplayBuffer(slot1), slot1, CMW_MODE_CONTINUOUS);
+}
+#endif
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  Restart the ML pipe with a snapshot armed at once
+ * @note   DUAL_STREAM_ENABLE: the pipe of the stalled snapshot, which the
+ *         new one is taken from
+ */
+void CAM_MLPipe_Restart(void) {
+  uint32_t pipe = ml_snap.pipe;
+  int slot;
+  uint8_t *buffer;
+  uint32_t basepri;
+
+  CAM_StopStalledPipe(pipe);
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  slot = Buffer_MLCapture_NextCapture(-1);
+#if DUAL_STREAM_ENABLE
+  stream_ctx.slot_stream[slot] = pipe == DCMIPP_PIPE0 ? 1U : 0U;
+#endif
+#if NN_MULTIRES_ENABLE
+  CAM_MLRes_Schedule(slot);
+#endif
+  ml_snap.slot = (int8_t)slot;
+  ml_snap.requested = 0;
+  ml_snap.armed = 1;
+  ml_snap.capture++;
+  ml_snap.rows = 0;
+  ml_snap.since_arm = 0;
+  Irq_Unlock(basepri);
+
+  buffer = Buffer_GetMLCaptureBuffer(slot);
+  APP_REQUIRE(buffer != NULL);
+  APP_REQUIRE(CMW_CAMERA_Start(pipe, buffer, CMW_MODE_SNAPSHOT) == CMW_ERROR_NONE);
+  CAM_CoalesceVsync(pipe);
+  CAM_MLPipe_EnableRows(pipe);
+}
+#else
+/**
+ * @brief  Restart the ML pipe on the two slots it was capturing into
+ */
+void CAM_MLPipe_Restart(void) {
+  int slot0 = ml_dbm.slot[0];
+  int slot1 = ml_dbm.slot[1];
+
+  CAM_StopStalledPipe(DCMIPP_PIPE2);
+  CAM_Dbm_Start(&ml_dbm, DCMIPP_PIPE2,
+                Buffer_GetMLCaptureBuffer(slot0), slot0,
+                Buffer_GetMLCaptureBuffer(slot1), slot1, CMW_MODE_CONTINUOUS);
+}
+#endif
+
+#if DETECTION_AE_ENABLE
+/**
+ * @brief  Snap a frame span to the grid and map it to sensor pixels
+ * @param  lo: Span start, fraction of the frame side
+ * @param  hi: Span end, fraction of the frame side
+ * @param  offset: Frame start on the sensor
+ * @param  length: Frame side on the sensor
+ * @param  start: Span start on the sensor
+ * @param  size: Span size on the sensor
+ */
+static void CAM_DetectionAE_Span(float lo, float hi, uint32_t offset, uint32_t length,
+                                 uint32_t *start, uint32_t *size) {
+  const float min_span = DETECTION_AE_MIN_AREA_PCT / 100.0f;
+  float grow = (hi - lo) * (DETECTION_AE_MARGIN_PCT / 200.0f);
+  uint32_t g0, g1;
+
+  lo -= grow;
+  hi += grow;
+  if (hi - lo < min_span) {
+    grow = 0.5f * (min_span - (hi - lo));
+    lo -= grow;
+    hi += grow;
+  }
+  /* Slide back into the frame before clamping, keeping the span */
+  if (lo < 0.0f) {
+    hi -= lo;
+    lo = 0.0f;
+  }
+  if (hi > 1.0f) {
+    lo -= hi - 1.0f;
+    hi = 1.0f;
+  }
+
+  g0 = (uint32_t)MAX(floorf(lo * DETECTION_AE_GRID), 0.0f);
+  g1 = (uint32_t)MIN(ceilf(hi * DETECTION_AE_GRID), (float)DETECTION_AE_GRID);
+  *start = offset + g0 * length / DETECTION_AE_GRID;
+  *size = (g1 - g0) * length / DETECTION_AE_GRID;
+}
+
+/**
+ * @brief  Measure AE/AWB on the tracked objects and cap the exposure time
+ *         to their motion
+ * @note   ISP thread, before the ISP run. Fail-fast: panics on an area the
+ *         ISP rejects
+ */
+static void CAM_DetectionAE_Update(void) {
+  ISP_HandleTypeDef *isp = CMW_CAMERA_GetISPHandle();
+  const float fw = (float)dae_ctx.frame.width;
+  const float fh = (float)dae_ctx.frame.height;
+  ISP_StatAreaTypeDef area;
+  uint32_t exposure_max = 0;
+  uint32_t nb;
+
+  if (isp == NULL) {
+    return;
+  }
+  if (!dae_ctx.started) {
+    APP_REQUIRE_EQ(ISP_GetStatArea(isp, &dae_ctx.default_area), ISP_OK);
+    dae_ctx.area = dae_ctx.default_area;
+    dae_ctx.started = 1;
+  }
+
+  nb = Tracker_PredictMotion(dae_ctx.boxes, dae_ctx.vel, TRACKER_MAX_TRACKS, DWT->CYCCNT);
+  area = dae_ctx.default_area;
+
+  if (nb > 0) {
+    float x0 = 1.0f, y0 = 1.0f, x1 = 0.0f, y1 = 0.0f;
+    float cap_us = (float)UINT32_MAX;
+
+    for (uint32_t i = 0; i < nb; i++) {
+      const nn_detection_t *box = &dae_ctx.boxes[i];
+      /* Pixels per second, against the blur budget in pixels */
+      float speed = hypotf(dae_ctx.vel[i][0] * fw, dae_ctx.vel[i][1] * fh);
+      float blur = box->height * fh * (DETECTION_AE_MAX_BLUR_PCT / 100.0f);
+
+      x0 = MIN(x0, box->x_center - 0.5f * box->width);
+      y0 = MIN(y0, box->y_center - 0.5f * box->height);
+      x1 = MAX(x1, box->x_center + 0.5f * box->width);
+      y1 = MAX(y1, box->y_center + 0.5f * box->height);
+      if (speed * cap_us > blur * 1e6f) {
+        cap_us = blur * 1e6f / speed;
+      }
+    }
+
+    CAM_DetectionAE_Span(x0, x1, dae_ctx.frame.offset_x, dae_ctx.frame.width, &area.X0, &area.XSize);
+    CAM_DetectionAE_Span(y0, y1, dae_ctx.frame.offset_y, dae_ctx.frame.height, &area.Y0, &area.YSize);
+    if (cap_us < (float)UINT32_MAX) {
+      exposure_max = (uint32_t)MAX(cap_us, (float)DETECTION_AE_MIN_EXPOSURE_US);
+    }
+  }
+
+  if (memcmp(&area, &dae_ctx.area, sizeof(area)) != 0) {
+    APP_REQUIRE_EQ(ISP_SetStatArea(isp, &area), ISP_OK);
+    dae_ctx.area = area;
+  }
+  if (exposure_max != dae_ctx.exposure_max) {
+    APP_REQUIRE_EQ(ISP_SetAECExposureMax(isp, exposure_max), ISP_OK);
+    dae_ctx.exposure_max = exposure_max;
+  }
+}
+#endif
+
+#if ISP_SPLIT_APPLY
+/**
+ * @brief  Hand the writes of the last ISP run to the apply thread
+ * @note   ISP thread
+ */
+static void CAM_IspStage(void) {
+  ISP_HandleTypeDef *isp = CMW_CAMERA_GetISPHandle();
+
+  if (isp == NULL) {
+    return;
+  }
+
+  APP_REQUIRE_EQ(tx_mutex_get(&isp_ctx.staged_lock, TX_WAIT_FOREVER), TX_SUCCESS);
+  APP_REQUIRE_EQ(ISP_TakePending(isp, &isp_ctx.staged), ISP_OK);
+  if (isp_ctx.staged.valid != 0U) {
+    isp_ctx.staged_ready = 1;
+  }
+  APP_REQUIRE_EQ(tx_mutex_put(&isp_ctx.staged_lock), TX_SUCCESS);
+}
+
+/**
+ * @brief  Write the staged sensor and ISP settings
+ * @note   ISP apply thread, after a vsync
+ */
+static void CAM_IspApply(void) {
+  ISP_PendingTypeDef pending;
+
+  APP_REQUIRE_EQ(tx_mutex_get(&isp_ctx.staged_lock, TX_WAIT_FOREVER), TX_SUCCESS);
+  pending = isp_ctx.staged;
+  isp_ctx.staged.valid = 0;
+  APP_REQUIRE_EQ(tx_mutex_put(&isp_ctx.staged_lock), TX_SUCCESS);
+
+  if (pending.valid == 0U) {
+    return;
+  }
+#if SENSOR_CMD_ENABLE
+  /* Queued in one hold group: exposure and gain latch on the same frame.
+   * The ISP writes are memory-mapped and done here; the I2C goes on after */
+  SensorCmd_Begin();
+  int hold = CMW_CAMERA_SetHold(1) == CMW_ERROR_NONE;
+  APP_REQUIRE_EQ(ISP_ApplyPending(CMW_CAMERA_GetISPHandle(), &pending), ISP_OK);
+  if (hold) {
+    APP_REQUIRE_EQ(CMW_CAMERA_SetHold(0), CMW_ERROR_NONE);
+  }
+  SensorCmd_Submit();
+#else
+  APP_REQUIRE_EQ(ISP_ApplyPending(CMW_CAMERA_GetISPHandle(), &pending), ISP_OK);
+#endif
+}
+#endif
+
+/**
+ * @brief  Update ISP parameters (auto exposure, white balance)
+ */
+void CAM_IspUpdate(void) {
+#if DETECTION_AE_ENABLE
+  CAM_DetectionAE_Update();
+#endif
+  APP_REQUIRE(CMW_CAMERA_Run() == CMW_ERROR_NONE);
+#if ISP_SPLIT_APPLY
+  CAM_IspStage();
+#endif
+#if ISP_TUNING_ENABLE
+  IspTool_NotifyRun();
+#endif
+}
+
+/**
+ * @brief  Pick the ISP run period from the last AE/AWB outputs
+ */
+static void CAM_IspAdaptRate(void) {
+  int32_t luma_error = (int32_t)Meta.averageL - (int32_t)Meta.exposureTarget;
+  uint8_t stable = luma_error >= -ISP_AEC_TOLERANCE && luma_error <= ISP_AEC_TOLERANCE &&
+                   Meta.colorTemp == isp_ctx.last_color_temp;
+
+  isp_ctx.last_color_temp = Meta.colorTemp;
+
+  if (!stable) {
+    /* Back to full rate on the first sign of a scene change */
+    isp_ctx.stable_runs = 0;
+    isp_ctx.period = isp_ctx.base_period;
+  } else if (++isp_ctx.stable_runs >= ISP_STABLE_RUNS) {
+    isp_ctx.period = isp_ctx.base_period * ISP_STABLE_PERIOD;
+  }
+}
+
+/**
+ * @brief  Change the sensor frame rate while streaming
+ * @param  fps: A rate the sensor supports (see CAMERA_FPS)
+ * @note   Display and inference follow the sensor, the inference still
+ *         fed one frame in NN_FRAME_DECIMATION. The ISP restarts at its
+ *         converging rate for the new frame length.
+ *         Fail-fast: panics on unrecoverable failures
+ */
+void CAM_SetFrameRate(int32_t fps) {
+  APP_REQUIRE(fps > 0);
+  APP_REQUIRE_EQ(CMW_CAMERA_SetFramerate(fps), CMW_ERROR_NONE);
+  CAM_FrameRate_Apply(fps);
+}
+
+/**
+ * @brief  Sensor frame rate in use
+ */
+int32_t CAM_GetFrameRate(void) {
+  return cam_fps;
+}
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  Change the ML snapshot decimation
+ */
+void CAM_SetMLDecimation(uint32_t decimation) {
+  APP_REQUIRE(decimation >= 1U && decimation <= 8U);
+  ml_snap.decimation = decimation;
+}
+#else
+/**
+ * @brief  Change the Pipe2 frame divider
+ */
+void CAM_SetMLDecimation(uint32_t decimation) {
+  static const uint32_t frame_rate[9] = {
+      [1] = DCMIPP_FRAME_RATE_ALL,
+      [2] = DCMIPP_FRAME_RATE_1_OVER_2,
+      [4] = DCMIPP_FRAME_RATE_1_OVER_4,
+      [8] = DCMIPP_FRAME_RATE_1_OVER_8,
+  };
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t basepri;
+
+  APP_REQUIRE(hdcmipp != NULL);
+  APP_REQUIRE(decimation == 1U || decimation == 2U || decimation == 4U || decimation == 8U);
+  /* Every Pipe2 frame is the preview */
+  APP_REQUIRE(!DISPLAY_SINGLE_PIPE || decimation == 1U);
+
+  /* FCTCR is shared with the capture request the ISRs re-arm */
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  APP_REQUIRE_EQ(HAL_DCMIPP_PIPE_SetFrameRate(hdcmipp, DCMIPP_PIPE2, frame_rate[decimation]), HAL_OK);
+  ml_decimation = decimation;
+  Irq_Unlock(basepri);
+}
+#endif
+
+/**
+ * @brief  Sensor frames per ML frame in use
+ */
+uint32_t CAM_GetMLDecimation(void) {
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  return ml_snap.decimation;
+#else
+  return ml_decimation;
+#endif
+}
+
+/**
+ * @brief  Hold back ISP runs during a latency-critical section
+ */
+void CAM_IspDefer_Begin(void) {
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  isp_ctx.defer_depth++;
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  End a latency-critical section; a run held back meanwhile starts now
+ */
+void CAM_IspDefer_End(void) {
+  uint8_t run = 0;
+  uint32_t basepri;
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  if (isp_ctx.defer_depth > 0 && --isp_ctx.defer_depth == 0 && isp_ctx.pending) {
+    isp_ctx.pending = 0;
+    isp_ctx.frames = 0;
+    run = 1;
+  }
+  Irq_Unlock(basepri);
+
+  if (run) {
+    tx_semaphore_put(&isp_ctx.vsync_sem);
+  }
+}
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  ML pipe frame event (ISR context) - publishes the snapshot and
+ *         wakes the inference thread
+ */
+static void CAM_MLPipe_FrameEvent(DCMIPP_HandleTypeDef *hdcmipp) {
+  UNUSED(hdcmipp);
+
+  Buffer_MLCapture_Complete(ml_snap.slot);
+  ml_snap.armed = 0;
+
+#if ML_SLICE_INGEST
+  /* The last band, or the whole frame of a Pipe0 snapshot */
+  NN_SignalRows(ml_snap.slot, ml_snap.capture, CAM_ML_ROWS);
+#endif
+  NN_SignalFrameReady(ml_snap.slot);
+}
+#else
+/**
+ * @brief  ML pipe frame event (ISR context) - publishes the completed slot
+ *         and wakes the inference thread
+ */
+static void CAM_MLPipe_FrameEvent(DCMIPP_HandleTypeDef *hdcmipp) {
+  uint32_t bank = CAM_Dbm_CompletedBank(&ml_dbm, hdcmipp);
+  int completed = ml_dbm.slot[bank];
+  int capturing = ml_dbm.slot[bank ^ 1U];
+  int next;
+
+  Buffer_MLCapture_Complete(completed);
+  next = Buffer_MLCapture_NextCapture(capturing);
+  CAM_Dbm_Queue(&ml_dbm, hdcmipp, DCMIPP_PIPE2, bank, next, Buffer_GetMLCaptureBuffer(next));
+
+#if NN_TILING == NN_TILING_FULL_FOV
+  /* Shadowed: the tile applies to the frame starting now, in capturing */
+  CAM_MLTile_Schedule(completed, capturing);
+#elif NN_TILING == NN_TILING_ROI
+  CAM_MLRoi_Schedule(capturing);
+#endif
+
+#if DISPLAY_SINGLE_PIPE
+  /* The same frame is the preview: LTDC scans it out from the next vblank */
+  LCD_ReloadCameraLayer(Buffer_GetMLCaptureBuffer(completed));
+#if TRACKER_ENABLE
+  UI_PostEvent(UI_EVENT_FRAME);
+#endif
+#endif
+
+  NN_SignalFrameReady(completed);
+}
+#endif
+
+#if !DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Display pipe frame event (ISR context) - publishes the completed
+ *         slot and reloads the LCD camera layer
+ */
+static void CAM_DisplayPipe_FrameEvent(DCMIPP_HandleTypeDef *hdcmipp) {
+  uint32_t bank = CAM_Dbm_CompletedBank(&display_dbm, hdcmipp);
+  int show = Buffer_CameraDisplay_Complete(display_dbm.slot[bank]);
+  int next = Buffer_CameraDisplay_NextCapture();
+
+  CAM_Dbm_Queue(&display_dbm, hdcmipp, DCMIPP_PIPE1, bank, next, Buffer_GetCameraDisplayBuffer(next));
+#if DISPLAY_FOLLOW_ENABLE
+  /* Shadowed: the window applies to the frame starting now */
+  CAM_DisplayFollow_Schedule(display_dbm.slot[bank ^ 1U]);
+#endif
+
+  /* Update LCD to display the frame picked by DISPLAY_POLICY, if any */
+  if (show >= 0) {
+    LCD_ReloadCameraLayer(Buffer_GetCameraDisplayBuffer(show));
+#if TRACKER_ENABLE
+    /* Tracked boxes follow every new camera frame */
+    UI_PostEvent(UI_EVENT_FRAME);
+#endif
+  }
+}
+#endif
+
+/**
+ * @brief  Frame event callback (ISR context) - handles buffering
+ * @param  pipe: Pipe that triggered the event
+ * @retval HAL_OK
+ */
+int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+
+  APP_REQUIRE(hdcmipp != NULL);
+
+  TRACE_INSTANT(CAM_FRAME, pipe);
+  if (pipe < CAM_PIPE_NB) {
+    cam_pipe_stats[pipe].frames++;
+  }
+
+#if !DISPLAY_SINGLE_PIPE
+  if (pipe == DCMIPP_PIPE1) {
+    CAM_DisplayPipe_FrameEvent(hdcmipp);
+  }
+#endif
+  if (pipe == DCMIPP_PIPE2) {
+    CAM_MLPipe_FrameEvent(hdcmipp);
+  }
+#if DUAL_STREAM_ENABLE
+  else if (pipe == DCMIPP_PIPE0) {
+    /* Second stream snapshot, into the same ring */
+    CAM_MLPipe_FrameEvent(hdcmipp);
+  }
+#endif
+#if AUX_STREAM_ENABLE
+  else if (pipe == DCMIPP_PIPE0) {
+    /* Both slots stay programmed: only publish the one just completed */
+    aux_latest = aux_dbm.slot[CAM_Dbm_CompletedBank(&aux_dbm, hdcmipp)];
+  }
+#endif
+
+  return HAL_OK;
+}
+
+#if ML_SLICE_INGEST
+/**
+ * @brief  Pipe2 line event (ISR context) - hands the rows landed so far to
+ *         the inference thread
+ * @note   HAL weak callback: the camera middleware does not dispatch it
+ */
+void HAL_DCMIPP_PIPE_LineEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t Pipe) {
+  UNUSED(hdcmipp);
+
+  if (Pipe != DCMIPP_PIPE2 || !ml_snap.armed || ml_snap.pipe != DCMIPP_PIPE2) {
+    return;
+  }
+  ml_snap.rows = MIN(ml_snap.rows + ML_SLICE_LINES, CAM_ML_ROWS);
+  NN_SignalRows(ml_snap.slot, ml_snap.capture, ml_snap.rows);
+}
+#endif
+
+/**
+ * @brief  Error callback (ISR context) - counts an overrun and re-arms it
+ * @param  pipe: Pipe that overran
+ * @retval HAL_OK
+ * @note   The HAL masks the overrun interrupt and flags the pipe in error;
+ *         DCMIPP drops the frame and carries on with the next one
+ */
+int CMW_CAMERA_PIPE_ErrorCallback(uint32_t pipe) {
+  static const uint32_t ovr_it[CAM_PIPE_NB] = {DCMIPP_IT_PIPE0_OVR, DCMIPP_IT_PIPE1_OVR, DCMIPP_IT_PIPE2_OVR};
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t fctcr;
+
+  APP_REQUIRE(hdcmipp != NULL && pipe < CAM_PIPE_NB);
+
+  cam_pipe_stats[pipe].overruns++;
+
+  fctcr = pipe == DCMIPP_PIPE0   ? hdcmipp->Instance->P0FCTCR
+          : pipe == DCMIPP_PIPE1 ? hdcmipp->Instance->P1FCTCR
+                                 : hdcmipp->Instance->P2FCTCR;
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  /* The armed snapshot is lost: let the next request arm another one */
+  if (pipe == ml_snap.pipe) {
+    ml_snap.armed = 0;
+  }
+#endif
+
+  /* FCTCR bits sit alike in every pipe. A continuous capture goes on:
+   * re-arm the overrun interrupt for the next frame. A snapshot is
+   * re-armed with its next request */
+  if ((fctcr & DCMIPP_P1FCTCR_CPTMODE) == DCMIPP_MODE_CONTINUOUS && (fctcr & DCMIPP_P1FCTCR_CPTREQ) != 0U) {
+    hdcmipp->PipeState[pipe] = HAL_DCMIPP_PIPE_STATE_BUSY;
+    __HAL_DCMIPP_ENABLE_IT(hdcmipp, ovr_it[pipe]);
+  }
+
+  return HAL_OK;
+}
+
+/**
+ * @brief  Limit event callback (ISR context) - counts a frame cut at its slot
+ * @param  pipe: Pipe whose frame reached the limit (Pipe0 only)
+ * @retval HAL_OK
+ */
+int CMW_CAMERA_PIPE_LimitEventCallback(uint32_t pipe) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+
+  APP_REQUIRE(hdcmipp != NULL && pipe < CAM_PIPE_NB);
+
+  cam_pipe_stats[pipe].limits++;
+  __HAL_DCMIPP_ENABLE_IT(hdcmipp, DCMIPP_IT_PIPE0_LIMIT);
+
+  return HAL_OK;
+}
+
+const cam_display_map_t *CAM_GetDisplayMap(void) {
+#if DISPLAY_FOLLOW_ENABLE
+  return CAM_GetSlotDisplayMap(Buffer_GetCameraDisplayIndex());
+#else
+  return &cam_display_map;
+#endif
+}
+
+/**
+ * @brief  Map from detection coordinates to one camera display slot
+ */
+const cam_display_map_t *CAM_GetSlotDisplayMap(int slot) {
+#if DISPLAY_FOLLOW_ENABLE
+  /* Before the first frame on screen: the full view */
+  if ((unsigned)slot >= DISPLAY_BUFFER_NB) {
+    return &cam_display_map;
+  }
+  /* A slot off the capture keeps its tag */
+  return &follow_ctx.slot_map[slot];
+#else
+  UNUSED(slot);
+  return &cam_display_map;
+#endif
+}
+
+/**
+ * @brief  Copy the frame counters of one pipe
+ */
+void CAM_GetPipeStats(uint32_t pipe, cam_pipe_stats_t *stats) {
+  uint32_t basepri;
+
+  APP_REQUIRE(pipe < CAM_PIPE_NB);
+
+  basepri = Irq_Lock(CAM_IRQ_PRIORITY);
+  *stats = *(const cam_pipe_stats_t *)&cam_pipe_stats[pipe];
+  Irq_Unlock(basepri);
+}
+
+/**
+ * @brief  Get the pipes writing a frame right now
+ */
+uint32_t CAM_GetCapturingPipes(void) {
+  DCMIPP_HandleTypeDef *hdcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t cmsr1;
+  uint32_t pipes = 0;
+
+  if (hdcmipp == NULL) {
+    return 0;
+  }
+
+  cmsr1 = hdcmipp->Instance->CMSR1;
+  pipes |= (cmsr1 & DCMIPP_CMSR1_P0CPTACT) ? 1U << DCMIPP_PIPE0 : 0U;
+  pipes |= (cmsr1 & DCMIPP_CMSR1_P1CPTACT) ? 1U << DCMIPP_PIPE1 : 0U;
+  pipes |= (cmsr1 & DCMIPP_CMSR1_P2CPTACT) ? 1U << DCMIPP_PIPE2 : 0U;
+  return pipes;
+}
+
+/**
+ * @brief  Vsync event callback (ISR context) - counts sensor frames, arms
+ *         a requested Pipe2 snapshot and triggers the ISP update when one is due
+ * @param  pipe: Pipe that triggered the event
+ * @retval HAL_OK
+ */
+int CMW_CAMERA_PIPE_VsyncEventCallback(uint32_t pipe) {
+  if (pipe != CAM_VSYNC_PIPE) {
+    return HAL_OK;
+  }
+
+  TRACE_INSTANT(CAM_VSYNC, pipe);
+  Buffer_Camera_FrameStart();
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  /* Frame start: the latest arming point completing by the deadline */
+  if (ml_snap.since_arm < ml_snap.decimation) {
+    ml_snap.since_arm++;
+  }
+  if (ml_snap.requested && CAM_MLPipe_SnapshotDue(DWT->CYCCNT)) {
+    CAM_MLPipe_Arm(CMW_CAMERA_GetDCMIPPHandle());
+  }
+#endif
+
+#if ISP_SPLIT_APPLY
+  /* Latch the settings the last run computed */
+  if (isp_ctx.staged_ready) {
+    isp_ctx.staged_ready = 0;
+    tx_semaphore_put(&isp_ctx.apply_sem);
+  }
+#endif
+
+  /* Wake the ISP thread only when a run is due and no deferral holds it,
+   * so a skipped frame costs no context switch */
+  if (++isp_ctx.frames < isp_ctx.period) {
+    return HAL_OK;
+  }
+  if (isp_ctx.defer_depth > 0 && isp_ctx.frames < isp_ctx.period + ISP_MAX_DEFER_FRAMES) {
+    isp_ctx.pending = 1;
+    return HAL_OK;
+  }
+
+  isp_ctx.pending = 0;
+  isp_ctx.frames = 0;
+  tx_semaphore_put(&isp_ctx.vsync_sem);
+  return HAL_OK;
+}
+
+/**
+ * @brief  ISP update thread entry
+ */
+static void isp_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+#if ISP_SPLIT_APPLY
+  if (CMW_CAMERA_GetISPHandle() != NULL) {
+    APP_REQUIRE_EQ(ISP_SetDeferredApply(CMW_CAMERA_GetISPHandle(), 1), ISP_OK);
+  }
+#endif
+
+  while (1) {
+    tx_semaphore_get(&isp_ctx.vsync_sem, TX_WAIT_FOREVER);
+    TRACE_BEGIN(ISP_UPDATE);
+    CAM_IspUpdate();
+    CAM_IspAdaptRate();
+    TRACE_END(ISP_UPDATE);
+  }
+}
+
+#if ISP_SPLIT_APPLY
+/**
+ * @brief  ISP apply thread entry
+ */
+static void isp_apply_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  while (1) {
+    tx_semaphore_get(&isp_ctx.apply_sem, TX_WAIT_FOREVER);
+    TRACE_BEGIN(ISP_APPLY);
+    CAM_IspApply();
+    TRACE_END(ISP_APPLY);
+  }
+}
+#endif
+
+/**
+ * @brief  Initialize ISP semaphore
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void CAM_InitIspSemaphore(void) {
+  APP_REQUIRE_EQ(tx_semaphore_create(&isp_ctx.vsync_sem, "isp_vsync", 0), TX_SUCCESS);
+#if ISP_SPLIT_APPLY
+  APP_REQUIRE_EQ(tx_semaphore_create(&isp_ctx.apply_sem, "isp_apply", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_mutex_create(&isp_ctx.staged_lock, "isp_staged", TX_INHERIT), TX_SUCCESS);
+#endif
+}
+
+/**
+ * @brief  Initialize and start the ISP update thread
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thread_IspUpdate_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+#if ISP_SPLIT_APPLY
+  APP_REQUIRE_EQ(tx_thread_create(&isp_ctx.apply_thread, "isp_apply",
+                                 isp_apply_thread_entry, 0,
+                                 isp_ctx.apply_stack, ISP_APPLY_STACK_SIZE,
+                                 ISP_THREAD_PRIORITY, ISP_THREAD_PRIORITY,
+                                 TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&isp_ctx.thread, "isp_update",
+                                 isp_thread_entry, 0,
+                                 isp_ctx.stack, ISP_THREAD_STACK_SIZE,
+                                 ISP_ANALYZE_THREAD_PRIORITY, ISP_ANALYZE_THREAD_PRIORITY,
+                                 TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+#else
   APP_REQUIRE_EQ(tx_thread_create(&isp_ctx.thread, "isp_update",
                                  isp_thread_entry, 0,
                                  isp_ctx.stack, ISP_THREAD_STACK_SIZE,
                                  ISP_THREAD_PRIORITY, ISP_THREAD_PRIORITY,
                                  TX_NO_TIME_SLICE, TX_AUTO_START),
                  TX_SUCCESS);
+#endif
 }
@@ -0,0 +1,448 @@
+/**
+ ******************************************************************************
+ * @file    app_cascade.c
+ * @author  Long Liangmao
+ * @brief   Second-stage (cascade) inference implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_cascade.h"
+
+#if CASCADE_ENABLE
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "app_postprocess.h"
+#include "app_ui.h"
+#include "app_x-cube-ai.h"
+#include "stm32n6xx_hal.h"
+#include <string.h>
+
+#if CASCADE_TOP_K < 1 || CASCADE_MAX_DETECTIONS < 1
+#error "CASCADE_TOP_K and CASCADE_MAX_DETECTIONS must be at least 1"
+#endif
+#if ML_YUV422
+#error "CASCADE_ENABLE resamples whole pixels: RGB888 or Y8 ML frames, not the pixel pairs of ML_YUV422"
+#endif
+
+/* Smallest crop side, in ML frame pixels */
+#define CASCADE_MIN_SIDE 32U
+
+#define CASCADE_ML_SIDE (ML_WIDTH < ML_HEIGHT ? ML_WIDTH : ML_HEIGHT)
+
+/* Square crop window in ML frame pixels */
+typedef struct {
+  uint16_t x;
+  uint16_t y;
+  uint16_t side;
+} cascade_rect_t;
+
+/* Crops of one output slot: written by the inference thread before the slot
+ * is queued, read by the post-processing thread after it is received */
+typedef struct {
+  cascade_rect_t rect[CASCADE_TOP_K];
+  nn_detection_t roi[CASCADE_TOP_K];
+  uint32_t nb_prepared;
+  uint32_t nb_run;
+  uint32_t nb_skipped;
+  uint32_t npu_us;
+} cascade_plan_t;
+
+static struct {
+  NN_Instance_TypeDef *instance;
+  app_postprocess_t pp;
+  app_postprocess_od_st_yolox_state_t pp_state;
+  uint8_t zero_copy; /* Crops are bound directly as the second-stage input */
+  uint8_t *in_buf;   /* Network-allocated input buffer (copy mode) */
+  uint32_t in_len;
+  uint32_t out_offset[NN_OUTPUT_NB];
+  uint32_t out_len[NN_OUTPUT_NB];
+
+  /* Running estimates, inference thread only */
+  uint32_t crop_us;
+  uint32_t infer_us;
+
+  cascade_plan_t plan[NN_OUTPUT_BUFFER_NB];
+
+#if NPU_SCHED_ENABLE
+  /* Scheduler job in flight, inference thread only */
+  uint32_t job_slot;
+  uint32_t job_start;
+#endif
+
+  /* Crop scratch, inference thread only */
+  uint16_t x_offset[ML_WIDTH];
+  uint8_t line[ML_WIDTH * ML_BPP];
+} cascade_ctx;
+
+/**
+ * @brief  Convert a DWT cycle delta to microseconds
+ */
+static uint32_t Cascade_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief  Fold a sample into a running estimate (1/8 weight, seeded by the first)
+ */
+static uint32_t Cascade_Filter(uint32_t estimate, uint32_t sample) {
+  return estimate ? (7U * estimate + sample) / 8U : sample;
+}
+
+/**
+ * @brief  Square crop around a detection, enlarged by the margin and clamped to the frame
+ */
+static cascade_rect_t Cascade_RoiRect(const nn_detection_t *det) {
+  float size = (det->width * ML_WIDTH > det->height * ML_HEIGHT) ? det->width * ML_WIDTH
+                                                                  : det->height * ML_HEIGHT;
+  float side_f = size * (100 + CASCADE_ROI_MARGIN_PCT) / 100.0f;
+  uint32_t side = (side_f < CASCADE_MIN_SIDE)  ? CASCADE_MIN_SIDE
+                  : (side_f > CASCADE_ML_SIDE) ? CASCADE_ML_SIDE
+                                               : (uint32_t)side_f;
+  float x0 = det->x_center * ML_WIDTH - side / 2.0f;
+  float y0 = det->y_center * ML_HEIGHT - side / 2.0f;
+
+  x0 = (x0 < 0.0f) ? 0.0f : (x0 > (float)(ML_WIDTH - side)) ? (float)(ML_WIDTH - side) : x0;
+  y0 = (y0 < 0.0f) ? 0.0f : (y0 > (float)(ML_HEIGHT - side)) ? (float)(ML_HEIGHT - side) : y0;
+
+  return (cascade_rect_t){.x = (uint16_t)x0, .y = (uint16_t)y0, .side = (uint16_t)side};
+}
+
+/**
+ * @brief  Nearest-neighbour scale of a crop window to the network input size
+ * @param  frame: ML capture slot (ML_FORMAT, non-cacheable)
+ * @param  rect: Crop window
+ * @param  dst: Crop buffer
+ */
+static void Cascade_Crop(const uint8_t *frame, const cascade_rect_t *rect, uint8_t *dst) {
+  const uint32_t pitch = ML_WIDTH * ML_BPP;
+  int32_t last_sy = -1;
+
+  for (uint32_t dx = 0; dx < ML_WIDTH; dx++) {
+    cascade_ctx.x_offset[dx] = (uint16_t)((dx * rect->side / ML_WIDTH) * ML_BPP);
+  }
+
+  for (uint32_t dy = 0; dy < ML_HEIGHT; dy++) {
+    int32_t sy = rect->y + (int32_t)(dy * rect->side / ML_HEIGHT);
+    uint8_t *row = dst + dy * pitch;
+
+    if (sy == last_sy) {
+      memcpy(row, row - pitch, pitch);
+      continue;
+    }
+
+    /* One burst read per source line: the capture ring is not cached */
+    memcpy(cascade_ctx.line, frame + (uint32_t)sy * ML_PITCH + rect->x * ML_BPP, rect->side * ML_BPP);
+    for (uint32_t dx = 0; dx < ML_WIDTH; dx++) {
+      const uint8_t *px = &cascade_ctx.line[cascade_ctx.x_offset[dx]];
+      for (uint32_t c = 0; c < ML_BPP; c++) {
+        row[dx * ML_BPP + c] = px[c];
+      }
+    }
+    last_sy = sy;
+  }
+}
+
+/**
+ * @brief  Insert a detection into a confidence-sorted list of CASCADE_MAX_DETECTIONS
+ */
+static void Cascade_Keep(nn_cascade_roi_t *roi, const nn_detection_t *det) {
+  uint32_t pos = roi->nb_detect;
+
+  if (pos == CASCADE_MAX_DETECTIONS && det->conf <= roi->detections[pos - 1].conf) {
+    return;
+  }
+  if (pos == CASCADE_MAX_DETECTIONS) {
+    pos--;
+  } else {
+    roi->nb_detect++;
+  }
+  while (pos > 0 && roi->detections[pos - 1].conf < det->conf) {
+    roi->detections[pos] = roi->detections[pos - 1];
+    pos--;
+  }
+  roi->detections[pos] = *det;
+}
+
+/**
+ * @brief  Bind the second-stage network and its post-processing
+ */
+void Cascade_Init(od_pp_outBuffer_t *scratch, uint32_t scratch_nb) {
+  const LL_Buffer_InfoTypeDef *in_info;
+  const LL_Buffer_InfoTypeDef *out_info;
+  LL_ATON_User_IO_Result_t ret;
+  uint32_t offset = 0;
+
+  memset(&cascade_ctx, 0, sizeof(cascade_ctx));
+  cascade_ctx.instance = MX_X_CUBE_AI_GetNetwork(CASCADE_NETWORK);
+  APP_REQUIRE(cascade_ctx.instance != NULL);
+
+  in_info = LL_ATON_Input_Buffers_Info(cascade_ctx.instance);
+  APP_REQUIRE(in_info != NULL);
+  cascade_ctx.in_buf = LL_Buffer_addr_start(&in_info[0]);
+  cascade_ctx.in_len = LL_Buffer_len(&in_info[0]);
+  APP_REQUIRE_EQ(cascade_ctx.in_len, ML_WIDTH * ML_HEIGHT * ML_BPP);
+
+  ret = LL_ATON_Set_User_Input_Buffer(cascade_ctx.instance, 0, Buffer_GetCascadeROIBuffer(0),
+                                      cascade_ctx.in_len);
+  APP_REQUIRE(ret == LL_ATON_User_IO_NOERROR || ret == LL_ATON_User_IO_WRONG_INDEX);
+  cascade_ctx.zero_copy = (ret == LL_ATON_User_IO_NOERROR);
+
+  /* Same layout as the primary: decoded by the same post-processing */
+  out_info = LL_ATON_Output_Buffers_Info(cascade_ctx.instance);
+  APP_REQUIRE(out_info != NULL);
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    APP_REQUIRE(out_info[i].name != NULL);
+    cascade_ctx.out_offset[i] = offset;
+    cascade_ctx.out_len[i] = LL_Buffer_len(&out_info[i]);
+    offset += cascade_ctx.out_len[i];
+  }
+  APP_REQUIRE(out_info[NN_OUTPUT_NB].name == NULL);
+  APP_REQUIRE_EQ(offset, NN_OUTPUT_SIZE);
+
+  cascade_ctx.pp_state.pOutBuff = scratch;
+  cascade_ctx.pp_state.out_nb = scratch_nb;
+  APP_REQUIRE_EQ(app_postprocess_instance_init(&cascade_ctx.pp, app_postprocess_od_st_yolox_select(cascade_ctx.instance),
+                                               &cascade_ctx.pp_state, cascade_ctx.instance),
+                 AI_OD_POSTPROCESS_ERROR_NO);
+}
+
+/**
+ * @brief  Crop the candidates that fit the frame budget
+ */
+void Cascade_Prepare(uint32_t slot, const uint8_t *frame, const nn_detection_t *cands,
+                     uint32_t nb_cand, uint32_t primary_us) {
+  const uint32_t budget = CASCADE_FRAME_BUDGET_US - CASCADE_BUDGET_MARGIN_US;
+  uint32_t used = primary_us;
+  uint32_t start = UI_GetCycleCount();
+  cascade_plan_t *plan;
+
+  APP_REQUIRE(slot < NN_OUTPUT_BUFFER_NB && nb_cand <= CASCADE_TOP_K);
+  plan = &cascade_ctx.plan[slot];
+
+  /* Until measured, a crop costs about as much as the primary inference */
+  if (cascade_ctx.infer_us == 0) {
+    cascade_ctx.infer_us = primary_us;
+  }
+
+  plan->nb_prepared = 0;
+  plan->nb_run = 0;
+  plan->npu_us = 0;
+
+  for (uint32_t k = 0; k < nb_cand; k++) {
+    uint32_t cost = cascade_ctx.crop_us + cascade_ctx.infer_us;
+    uint8_t *dst = Buffer_GetCascadeROIBuffer(k);
+    uint32_t crop_start = UI_GetCycleCount();
+
+    if (used + cost > budget) {
+      break;
+    }
+    used += cost;
+
+    plan->rect[k] = Cascade_RoiRect(&cands[k]);
+    plan->roi[k] = (nn_detection_t){
+        .x_center = (plan->rect[k].x + plan->rect[k].side / 2.0f) / ML_WIDTH,
+        .y_center = (plan->rect[k].y + plan->rect[k].side / 2.0f) / ML_HEIGHT,
+        .width = (float)plan->rect[k].side / ML_WIDTH,
+        .height = (float)plan->rect[k].side / ML_HEIGHT,
+        .conf = cands[k].conf,
+        .class_index = cands[k].class_index,
+    };
+    Cascade_Crop(frame, &plan->rect[k], dst);
+    Buffer_Clean(BUFFER_ID_CASCADE_ROI, dst);
+    plan->nb_prepared++;
+
+    cascade_ctx.crop_us = Cascade_Filter(cascade_ctx.crop_us,
+                                         Cascade_CyclesToUs(UI_GetCycleCount() - crop_start));
+  }
+
+  plan->nb_skipped = nb_cand - plan->nb_prepared;
+  plan->npu_us = Cascade_CyclesToUs(UI_GetCycleCount() - start);
+}
+
+/**
+ * @brief  Bind crop k as the second-stage input
+ */
+static void Cascade_BindCrop(uint32_t k) {
+  uint8_t *roi = Buffer_GetCascadeROIBuffer(k);
+
+  if (cascade_ctx.zero_copy) {
+    APP_REQUIRE_EQ(LL_ATON_Set_User_Input_Buffer(cascade_ctx.instance, 0, roi, cascade_ctx.in_len),
+                   LL_ATON_User_IO_NOERROR);
+  } else {
+    memcpy(cascade_ctx.in_buf, roi, cascade_ctx.in_len);
+    SCB_CleanDCache_by_Addr((void *)cascade_ctx.in_buf, cascade_ctx.in_len);
+  }
+}
+
+/**
+ * @brief  Copy out the outputs of crop k and account its run
+ * @param  start: DWT cycles when the crop was bound
+ * @retval Time of the crop, microseconds
+ */
+static uint32_t Cascade_CompleteCrop(uint32_t slot, uint32_t k, uint32_t start) {
+  const LL_Buffer_InfoTypeDef *out_info = LL_ATON_Output_Buffers_Info(cascade_ctx.instance);
+  cascade_plan_t *plan = &cascade_ctx.plan[slot];
+  uint8_t *out = Buffer_GetCascadeOutputBuffer(slot, k);
+  uint32_t elapsed_us;
+
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    uint8_t *src = LL_Buffer_addr_start(&out_info[i]);
+
+    SCB_InvalidateDCache_by_Addr((void *)src, cascade_ctx.out_len[i]);
+    memcpy(out + cascade_ctx.out_offset[i], src, cascade_ctx.out_len[i]);
+  }
+
+  elapsed_us = Cascade_CyclesToUs(UI_GetCycleCount() - start);
+  cascade_ctx.infer_us = Cascade_Filter(cascade_ctx.infer_us, elapsed_us);
+  plan->npu_us += elapsed_us;
+  plan->nb_run++;
+  return elapsed_us;
+}
+
+/**
+ * @brief  Run the prepared crops on the NPU
+ */
+void Cascade_Run(uint32_t slot, uint32_t frame_us) {
+  const uint32_t budget = CASCADE_FRAME_BUDGET_US - CASCADE_BUDGET_MARGIN_US;
+  const uint32_t primary = MX_X_CUBE_AI_GetActiveNetwork();
+  uint32_t used = frame_us;
+  cascade_plan_t *plan = &cascade_ctx.plan[slot];
+
+  if (plan->nb_prepared == 0) {
+    return;
+  }
+
+  MX_X_CUBE_AI_SelectNetwork(CASCADE_NETWORK);
+
+  for (uint32_t k = 0; k < plan->nb_prepared; k++) {
+    uint32_t start;
+
+    /* The primary may have run long: re-check with the measured time */
+    if (used + cascade_ctx.infer_us > budget) {
+      plan->nb_skipped += plan->nb_prepared - k;
+      break;
+    }
+
+    start = UI_GetCycleCount();
+    Cascade_BindCrop(k);
+
+    if (!MX_X_CUBE_AI_Run()) {
+      /* NPU hung and recovered: the remaining crops are dropped */
+      plan->nb_skipped += plan->nb_prepared - k;
+      break;
+    }
+
+    used += Cascade_CompleteCrop(slot, k, start);
+  }
+
+  MX_X_CUBE_AI_SelectNetwork(primary);
+}
+
+#if NPU_SCHED_ENABLE
+/**
+ * @brief  Job continuation: the next crop that still fits before the deadline
+ */
+static int Cascade_JobNext(npu_sched_job_t *job, int completed) {
+  const uint32_t slot = cascade_ctx.job_slot;
+  cascade_plan_t *plan = &cascade_ctx.plan[slot];
+  uint32_t now;
+
+  if (completed) {
+    (void)Cascade_CompleteCrop(slot, plan->nb_run, cascade_ctx.job_start);
+  }
+  if (plan->nb_run >= plan->nb_prepared) {
+    return 0;
+  }
+
+  now = UI_GetCycleCount();
+  if ((int32_t)(now + cascade_ctx.infer_us * (SystemCoreClock / 1000000U) - job->deadline) > 0) {
+    return 0;
+  }
+  cascade_ctx.job_start = now;
+  Cascade_BindCrop(plan->nb_run);
+  return 1;
+}
+
+/**
+ * @brief  Make the scheduler job running the prepared crops of a slot
+ */
+void Cascade_InitJob(uint32_t slot, uint32_t frame_start, npu_sched_job_t *job) {
+  const uint32_t budget = CASCADE_FRAME_BUDGET_US - CASCADE_BUDGET_MARGIN_US;
+
+  APP_REQUIRE(slot < NN_OUTPUT_BUFFER_NB);
+  cascade_ctx.job_slot = slot;
+  *job = (npu_sched_job_t){
+      .instance = cascade_ctx.instance,
+      .priority = 1,
+      /* Never 0, which means no deadline */
+      .deadline = (frame_start + budget * (SystemCoreClock / 1000000U)) | 1U,
+      .next = Cascade_JobNext,
+  };
+}
+
+/**
+ * @brief  Account the crops the job did not run
+ */
+void Cascade_EndJob(uint32_t slot) {
+  cascade_plan_t *plan = &cascade_ctx.plan[slot];
+
+  plan->nb_skipped += plan->nb_prepared - plan->nb_run;
+}
+#endif
+
+/**
+ * @brief  Decode the second-stage outputs of one slot
+ */
+void Cascade_Decode(uint32_t slot, nn_cascade_t *result, arena_t *scratch) {
+  const cascade_plan_t *plan = &cascade_ctx.plan[slot];
+
+  /* Every crop decodes into the same candidates */
+  cascade_ctx.pp_state.pOutBuff = ARENA_ALLOC(scratch, od_pp_outBuffer_t, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB);
+
+  result->nb_roi = plan->nb_run;
+  result->nb_skipped = plan->nb_skipped;
+  result->npu_us = plan->npu_us;
+
+  for (uint32_t k = 0; k < plan->nb_run; k++) {
+    const cascade_rect_t *rect = &plan->rect[k];
+    uint8_t *out = Buffer_GetCascadeOutputBuffer(slot, k);
+    nn_cascade_roi_t *roi = &result->rois[k];
+    void *pp_input[NN_OUTPUT_NB];
+    od_pp_out_t pp_output;
+
+    for (int i = 0; i < NN_OUTPUT_NB; i++) {
+      pp_input[i] = out + cascade_ctx.out_offset[i];
+    }
+    APP_REQUIRE_EQ(app_postprocess_instance_run(&cascade_ctx.pp, pp_input, NN_OUTPUT_NB, &pp_output),
+                   AI_OD_POSTPROCESS_ERROR_NO);
+
+    roi->roi = plan->roi[k];
+    roi->nb_detect = 0;
+    for (int32_t i = 0; i < pp_output.nb_detect; i++) {
+      const od_pp_outBuffer_t *det = &pp_output.pOutBuff[i];
+      const nn_detection_t mapped = {
+          .x_center = (rect->x + det->x_center * rect->side) / ML_WIDTH,
+          .y_center = (rect->y + det->y_center * rect->side) / ML_HEIGHT,
+          .width = det->width * rect->side / ML_WIDTH,
+          .height = det->height * rect->side / ML_HEIGHT,
+          .conf = det->conf,
+          .class_index = det->class_index,
+      };
+
+      Cascade_Keep(roi, &mapped);
+    }
+  }
+}
+
+#endif /* CASCADE_ENABLE */
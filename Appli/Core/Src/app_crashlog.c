@@ -0,0 +1,309 @@
+/**
+ ******************************************************************************
+ * @file    app_crashlog.c
+ * @author  Long Liangmao
+ * @brief   Crash and performance record kept over resets for STM32N6570-DK
+ *          Ring of the last panics and a rolling performance snapshot in the
+ *          backup SRAM, reported at the next boot (CRASH_LOG)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_crashlog.h"
+
+#if CRASH_LOG_UART && !THREAD_PROFILER_UART
+#error "CRASH_LOG_UART prints on the COM port opened by THREAD_PROFILER_UART"
+#endif
+
+#if CRASH_LOG
+
+#include "app_health.h"
+#include "app_npu_bw.h"
+#include "app_threadprof.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stddef.h>
+#include <string.h>
+
+#if CRASH_LOG_UART
+#include <stdio.h>
+#endif
+
+#if CRASH_LOG_ENTRIES < 1
+#error "CRASH_LOG_ENTRIES must be at least 1"
+#endif
+
+#define CRASHLOG_MAGIC 0x48535243U /* "CRSH" */
+#define CRASHLOG_VERSION 1U
+
+/* Whole record; every field is rewritten or checked at CrashLog_Init() */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t boot_count; /* Boots since the record was cleared, this one included */
+  uint32_t logged;     /* Entries logged since cleared; the ring holds the last ones */
+  uint32_t reported;   /* logged at the last report */
+  uint32_t perf_boot;  /* Boot the snapshot belongs to */
+  crashlog_perf_t perf;
+  uint32_t perf_checksum;
+  crashlog_entry_t entries[CRASH_LOG_ENTRIES];
+} crashlog_block_t;
+
+_Static_assert(sizeof(crashlog_block_t) <= BKPSRAM_SIZE, "Crash log overflows the backup SRAM");
+
+/* Backup SRAM, secure alias. Default (cacheable) memory map: every update is
+ * cleaned to the SRAM at once, a reset drops the D-cache */
+#define CRASHLOG_BLOCK ((crashlog_block_t *)BKPSRAM_BASE_S)
+
+static struct {
+  uint8_t ready;     /* Backup SRAM clocked and the record valid */
+  uint8_t in_panic;  /* A fault while logging must not log again */
+  uint8_t reported;
+} crashlog_ctx;
+
+static uint32_t CrashLog_Sum(const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t sum = 0;
+
+  for (uint32_t i = 0; i < len; i++) {
+    sum += bytes[i];
+  }
+  return sum;
+}
+
+static void CrashLog_Flush(const void *data, uint32_t len) {
+  SCB_CleanDCache_by_Addr((void *)data, (int32_t)len);
+}
+
+/**
+ * @brief  Append an entry with the last snapshot, if it is from the boot
+ *         that ended
+ */
+static void CrashLog_Append(crashlog_block_t *log, uint32_t boot, uint32_t cause, const char *file,
+                            uint32_t line) {
+  crashlog_entry_t *entry = &log->entries[log->logged % CRASH_LOG_ENTRIES];
+
+  memset(entry, 0, sizeof(*entry));
+  entry->boot = boot;
+  entry->cause = cause;
+  entry->line = line;
+  entry->cfsr = SCB->CFSR;
+  if (file != NULL) {
+    const char *base = file;
+
+    for (const char *p = file; *p != '\0'; p++) {
+      if (*p == '/' || *p == '\\') {
+        base = p + 1;
+      }
+    }
+    strncpy(entry->file, base, CRASHLOG_FILE_LEN - 1U);
+  }
+  if (log->perf_boot == boot && log->perf_checksum == CrashLog_Sum(&log->perf, sizeof(log->perf))) {
+    entry->perf = log->perf;
+  }
+  entry->checksum = CrashLog_Sum(entry, offsetof(crashlog_entry_t, checksum));
+  log->logged++;
+
+  CrashLog_Flush(entry, sizeof(*entry));
+  CrashLog_Flush(log, offsetof(crashlog_block_t, perf));
+}
+
+void CrashLog_Init(void) {
+  crashlog_block_t *log = CRASHLOG_BLOCK;
+
+  __HAL_RCC_BKPSRAM_MEM_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  if (log->magic != CRASHLOG_MAGIC || log->version != CRASHLOG_VERSION || log->size != sizeof(*log) ||
+      log->reported > log->logged) {
+    /* First boot, power loss without VBAT or another layout */
+    memset(log, 0, sizeof(*log));
+    log->magic = CRASHLOG_MAGIC;
+    log->version = CRASHLOG_VERSION;
+    log->size = sizeof(*log);
+  }
+
+  /* A panic spins until the IWDG fires: that reset is already logged */
+  if (LL_RCC_IsActiveFlag_IWDGRST() && log->boot_count != 0 &&
+      (log->logged == 0 || log->entries[(log->logged - 1U) % CRASH_LOG_ENTRIES].boot != log->boot_count)) {
+    CrashLog_Append(log, log->boot_count, CRASHLOG_CAUSE_WATCHDOG, NULL, 0);
+  }
+#if !HEALTH_MONITOR
+  /* Else cleared by Thread_Health_Init(), which reads them too */
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+#endif
+
+  log->boot_count++;
+  CrashLog_Flush(log, sizeof(*log));
+  crashlog_ctx.ready = 1;
+}
+
+void CrashLog_RecordPanic(const char *file, uint32_t line) {
+  uint32_t vect = SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk;
+  uint32_t cause = CRASHLOG_CAUSE_PANIC;
+
+  if (!crashlog_ctx.ready || crashlog_ctx.in_panic) {
+    return;
+  }
+  crashlog_ctx.in_panic = 1;
+
+  if (file == NULL) {
+    cause = vect ? CRASHLOG_CAUSE_FAULT : CRASHLOG_CAUSE_ERROR;
+    line = vect;
+  }
+  CrashLog_Append(CRASHLOG_BLOCK, CRASHLOG_BLOCK->boot_count, cause, file, line);
+}
+
+/**
+ * @brief  Fill a snapshot from the profilers that are built in
+ */
+static void CrashLog_Snapshot(crashlog_perf_t *perf, uint32_t inference_us, uint32_t frame_period_us,
+                              uint32_t cpu_load_pct) {
+  memset(perf, 0, sizeof(*perf));
+  perf->uptime_ms = HAL_GetTick();
+  perf->fps_tenths = frame_period_us ? 10000000U / frame_period_us : 0;
+  perf->inference_us = inference_us;
+  perf->cpu_load_pct = cpu_load_pct;
+
+#if THREAD_PROFILER
+  {
+    threadprof_report_t report;
+
+    ThreadProf_GetReport(&report);
+    for (uint32_t i = 0; i < report.nb_threads; i++) {
+      const threadprof_thread_t *thread = &report.threads[i];
+      uint32_t free = thread->stack_size - thread->stack_used;
+
+      if (i == 0 || free < perf->stack_free) {
+        perf->stack_free = free;
+        strncpy(perf->stack_thread, thread->name ? thread->name : "?", CRASHLOG_THREAD_LEN - 1U);
+        perf->stack_thread[CRASHLOG_THREAD_LEN - 1U] = '\0';
+      }
+    }
+  }
+#endif
+
+#if NPU_BW_REPORT
+  {
+    npu_bw_report_t report;
+
+    NPUBw_GetReport(&report);
+    perf->npu_block_cycles = (uint32_t)MIN(report.block_cycles, UINT32_MAX);
+    for (uint32_t i = 0; i < CRASHLOG_POOL_NB; i++) {
+      const npu_bw_pool_t *pool = &report.pools[i];
+
+      perf->npu_active[i] = (uint32_t)MIN(pool->in_active + pool->out_active, UINT32_MAX);
+      perf->npu_stall[i] = (uint32_t)MIN(pool->in_stall + pool->out_stall, UINT32_MAX);
+    }
+  }
+#endif
+
+#if HEALTH_MONITOR
+  {
+    health_stats_t stats;
+
+    Health_GetStats(&stats);
+    for (uint32_t i = 0; i < HEALTH_STAGE_NB; i++) {
+      perf->recoveries += stats.recoveries[i];
+    }
+  }
+#endif
+}
+
+#if CRASH_LOG_UART
+static const char *CrashLog_CauseName(uint32_t cause) {
+  switch (cause) {
+  case CRASHLOG_CAUSE_PANIC:
+    return "panic";
+  case CRASHLOG_CAUSE_ERROR:
+    return "error";
+  case CRASHLOG_CAUSE_FAULT:
+    return "fault";
+  case CRASHLOG_CAUSE_WATCHDOG:
+    return "watchdog";
+  default:
+    return "?";
+  }
+}
+
+/**
+ * @brief  Print the entries logged before this boot and not printed yet
+ */
+static void CrashLog_Print(const crashlog_block_t *log) {
+  uint32_t first = log->reported;
+
+  if (log->logged - first > CRASH_LOG_ENTRIES) {
+    first = log->logged - CRASH_LOG_ENTRIES;
+  }
+  printf("crash log: %lu new, %lu since cleared, boot %lu\r\n", (unsigned long)(log->logged - log->reported),
+         (unsigned long)log->logged, (unsigned long)log->boot_count);
+
+  for (uint32_t n = first; n < log->logged; n++) {
+    const crashlog_entry_t *entry = &log->entries[n % CRASH_LOG_ENTRIES];
+    const crashlog_perf_t *perf = &entry->perf;
+
+    if (entry->checksum != CrashLog_Sum(entry, offsetof(crashlog_entry_t, checksum))) {
+      printf("  entry %lu corrupt\r\n", (unsigned long)n);
+      continue;
+    }
+    printf("  boot %lu %s %.*s:%lu cfsr 0x%08lx after %lu s\r\n", (unsigned long)entry->boot,
+           CrashLog_CauseName(entry->cause), (int)CRASHLOG_FILE_LEN, entry->file, (unsigned long)entry->line,
+           (unsigned long)entry->cfsr, (unsigned long)(perf->uptime_ms / 1000U));
+    if (perf->uptime_ms == 0) {
+      continue; /* No snapshot taken in that boot */
+    }
+    printf("    %lu.%lu fps, inference %lu us, cpu %lu%%, stack %lu B free (%.*s), %lu recoveries\r\n",
+           (unsigned long)(perf->fps_tenths / 10U), (unsigned long)(perf->fps_tenths % 10U),
+           (unsigned long)perf->inference_us, (unsigned long)perf->cpu_load_pct, (unsigned long)perf->stack_free,
+           (int)CRASHLOG_THREAD_LEN, perf->stack_thread, (unsigned long)perf->recoveries);
+    printf("    npu %lu kcyc, active/stalled kcyc: axisram %lu/%lu psram %lu/%lu flash %lu/%lu\r\n",
+           (unsigned long)(perf->npu_block_cycles / 1000U),
+           (unsigned long)(perf->npu_active[0] / 1000U), (unsigned long)(perf->npu_stall[0] / 1000U),
+           (unsigned long)(perf->npu_active[1] / 1000U), (unsigned long)(perf->npu_stall[1] / 1000U),
+           (unsigned long)(perf->npu_active[2] / 1000U), (unsigned long)(perf->npu_stall[2] / 1000U));
+  }
+}
+#endif
+
+void CrashLog_Update(uint32_t inference_us, uint32_t frame_period_us, uint32_t cpu_load_pct) {
+  crashlog_block_t *log = CRASHLOG_BLOCK;
+  crashlog_perf_t perf;
+  uint32_t checksum;
+
+  if (!crashlog_ctx.ready) {
+    return;
+  }
+
+#if CRASH_LOG_UART
+  if (!crashlog_ctx.reported) {
+    crashlog_ctx.reported = 1;
+    if (log->logged != log->reported) {
+      CrashLog_Print(log);
+      log->reported = log->logged;
+    }
+  }
+#endif
+
+  CrashLog_Snapshot(&perf, inference_us, frame_period_us, cpu_load_pct);
+  checksum = CrashLog_Sum(&perf, sizeof(perf));
+
+  /* A panic in between would log a half-written snapshot */
+  __disable_irq();
+  log->perf = perf;
+  log->perf_checksum = checksum;
+  log->perf_boot = log->boot_count;
+  CrashLog_Flush(log, sizeof(*log) - sizeof(log->entries));
+  __enable_irq();
+}
+
+#endif /* CRASH_LOG */
@@ -0,0 +1,497 @@
+/**
+ ******************************************************************************
+ * @file    app_dataset.c
+ * @author  Long Liangmao
+ * @brief   Retraining dataset capture for STM32N6570-DK (DATASET_ENABLE):
+ *          SDMMC2 through the BSP driver, each frame by IDMA straight from
+ *          its capture slot
+ *
+ *          A frame offered by the inference thread takes a dataset entry
+ *          and stays kept out of the capture ring (Buffer_MLCapture_Keep).
+ *          Post-processing fills the entry's detections and queues it for
+ *          the writer, or gives the slot back at once. Entries go around
+ *          two queues, free and written, like the NN output slots.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_dataset.h"
+
+#if DATASET_ENABLE
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "isp_core.h"
+#include "stm32n6570_discovery_sd.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if SD_LOG
+#error "DATASET_ENABLE and SD_LOG both own the microSD card"
+#endif
+#if ML_INPUT_ALIAS
+#error "DATASET_ENABLE lends Pipe2 slots: ML_INPUT_ALIAS has no capture ring"
+#endif
+#if DUAL_STREAM_ENABLE
+#error "DATASET_ENABLE records the main sensor's ISP state: not with DUAL_STREAM_ENABLE"
+#endif
+#ifndef HAL_SD_MODULE_ENABLED
+#error "DATASET_ENABLE needs HAL_SD_MODULE_ENABLED in stm32n6xx_hal_conf.h"
+#endif
+#if ((ML_PITCH * ML_HEIGHT) % DATASET_BLOCK_SIZE) != 0
+#error "DATASET_ENABLE writes whole Pipe2 frames: ML_PITCH * ML_HEIGHT must be whole 512-byte blocks"
+#endif
+#if (DATASET_FIRST_BLOCK % DATASET_ALIGN_BLOCKS) != 0
+#error "DATASET_FIRST_BLOCK must be on a 64 KB boundary: every record slot stays aligned"
+#endif
+#if DATASET_SAMPLE != DATASET_SAMPLE_ALL && DATASET_SAMPLE != DATASET_SAMPLE_UNCERTAIN
+#error "DATASET_SAMPLE must be DATASET_SAMPLE_ALL or DATASET_SAMPLE_UNCERTAIN"
+#endif
+#if DATASET_EVERY < 1 || DATASET_SLOTS < 1
+#error "DATASET_EVERY and DATASET_SLOTS must be at least 1"
+#endif
+
+/* Below every pipeline thread and the publishers: the writer takes idle time */
+#define DATASET_THREAD_STACK_SIZE 2048
+
+#define DATASET_INSTANCE 0U /* SDMMC2, the microSD slot */
+#define DATASET_FRAME_BLOCKS ((ML_PITCH * ML_HEIGHT) / DATASET_BLOCK_SIZE)
+#define DATASET_RECORD_BLOCKS \
+  (((DATASET_FRAME_BLOCKS + 1U + DATASET_ALIGN_BLOCKS - 1U) / DATASET_ALIGN_BLOCKS) * DATASET_ALIGN_BLOCKS)
+#define DATASET_WRITE_TICKS ((DATASET_STUCK_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+#define DATASET_STUCK_MS 5000U   /* Write never completed: the card is gone */
+#define DATASET_MAX_FAILURES 3U  /* Writes failed in a row: the card is given up */
+#define DATASET_NO_ENTRY 0xFFU
+
+#define DATASET_EVENT_DONE 0x01U
+#define DATASET_EVENT_ERROR 0x02U
+
+#define DATASET_CHECK_SEED 2166136261U /* FNV-1a offset basis */
+
+/* Last ISP run, from isp_algo.c */
+extern ISP_MetaTypeDef Meta;
+
+_Static_assert(sizeof(dataset_index_t) <= DATASET_BLOCK_SIZE, "Index copy overflows its block");
+_Static_assert(DATASET_RECORD_BLOCKS <= UINT16_MAX, "Record slot does not fit the index");
+_Static_assert(DATASET_SLOTS < DATASET_NO_ENTRY, "Entry index does not fit the NN slot map");
+
+typedef struct {
+  int capture_idx;         /* Kept ML capture slot */
+  dataset_header_t header; /* Filled by the offer and the decision, sealed by the writer */
+} dataset_entry_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[DATASET_THREAD_STACK_SIZE];
+  TX_EVENT_FLAGS_GROUP events;
+  TX_QUEUE free_queue;      /* Entries not offered */
+  TX_QUEUE write_queue;     /* Entries kept, oldest first */
+  ULONG free_storage[DATASET_SLOTS];
+  ULONG write_storage[DATASET_SLOTS];
+  dataset_entry_t entries[DATASET_SLOTS];
+  uint8_t offered[NN_OUTPUT_BUFFER_NB]; /* Entry offered with each NN output slot */
+  volatile uint8_t running; /* Card open: frames are offered */
+  uint32_t countdown;       /* Inferences until the next offer */
+  dataset_index_t index;    /* Last committed, or being committed */
+  uint32_t data_block;      /* Block of record slot 0 */
+  uint32_t failures;        /* Writes failed in a row */
+  dataset_stats_t stats;
+} ds_ctx;
+
+/* Index copies and the header block in flight. IDMA-read, CPU-written once
+ * per record */
+static uint8_t ds_index_block[2][DATASET_BLOCK_SIZE] __attribute__((section(".noncacheable"), aligned(32)));
+static dataset_header_t ds_header_block __attribute__((section(".noncacheable"), aligned(32)));
+
+static uint32_t Dataset_Check(uint32_t hash, const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+static int Dataset_WaitReady(void) {
+  uint32_t start = HAL_GetTick();
+
+  /* Programming of the previous write: CMD13 until the card is back in
+   * transfer state */
+  while (BSP_SD_GetCardState(DATASET_INSTANCE) != SD_TRANSFER_OK) {
+    if (HAL_GetTick() - start >= SD_WRITE_TIMEOUT) {
+      return 0;
+    }
+    tx_thread_sleep(1);
+  }
+  return 1;
+}
+
+/**
+ * @brief  Wait for the transfer just started
+ */
+static int Dataset_WaitTransfer(void) {
+  ULONG flags = 0;
+
+  if (tx_event_flags_get(&ds_ctx.events, DATASET_EVENT_DONE | DATASET_EVENT_ERROR, TX_OR_CLEAR, &flags,
+                         DATASET_WRITE_TICKS) != TX_SUCCESS) {
+    return 0;
+  }
+  return (flags & DATASET_EVENT_ERROR) == 0U;
+}
+
+static int Dataset_Write(const void *data, uint32_t block, uint32_t nb) {
+  return Dataset_WaitReady() &&
+         BSP_SD_WriteBlocks_DMA(DATASET_INSTANCE, (uint32_t *)data, block, nb) == BSP_ERROR_NONE &&
+         Dataset_WaitTransfer();
+}
+
+/**
+ * @brief  Commit the next index generation, in the copy that does not hold
+ *         the last committed one
+ */
+static int Dataset_CommitIndex(void) {
+  dataset_index_t *index = &ds_ctx.index;
+
+  index->generation++;
+  index->check = Dataset_Check(DATASET_CHECK_SEED, index, offsetof(dataset_index_t, check));
+  memset(ds_index_block[0], 0, DATASET_BLOCK_SIZE);
+  memcpy(ds_index_block[0], index, sizeof(*index));
+
+  if (!Dataset_Write(ds_index_block[0], index->first_block + (index->generation % 2U), 1)) {
+    /* Its copy is torn: the next commit rewrites it, never the other one */
+    index->generation--;
+    return 0;
+  }
+  return 1;
+}
+
+static int Dataset_IndexValid(const dataset_index_t *index, uint32_t capacity) {
+  return index->magic == DATASET_INDEX_MAGIC && index->version == DATASET_VERSION &&
+         index->check == Dataset_Check(DATASET_CHECK_SEED, index, offsetof(dataset_index_t, check)) &&
+         index->record_blocks == DATASET_RECORD_BLOCKS && index->first_block == DATASET_FIRST_BLOCK &&
+         index->capacity == capacity;
+}
+
+/**
+ * @brief  Open the card and its dataset, resume after the last committed
+ *         record and commit this boot
+ * @retval 1 when capturing, 0 when the card cannot be used
+ */
+static int Dataset_Open(void) {
+  BSP_SD_CardInfo info;
+  dataset_index_t copy[2];
+  uint32_t capacity;
+  int valid[2];
+
+  if (BSP_SD_Init(DATASET_INSTANCE) != BSP_ERROR_NONE) {
+    printf("dataset: no card, capture off\r\n");
+    return 0;
+  }
+  APP_REQUIRE_EQ(BSP_SD_GetCardInfo(DATASET_INSTANCE, &info), BSP_ERROR_NONE);
+  if (info.LogBlockSize != DATASET_BLOCK_SIZE ||
+      info.LogBlockNbr < DATASET_FIRST_BLOCK + DATASET_ALIGN_BLOCKS + DATASET_RECORD_BLOCKS) {
+    printf("dataset: card of %lu blocks of %lu bytes unusable, capture off\r\n", (unsigned long)info.LogBlockNbr,
+           (unsigned long)info.LogBlockSize);
+    return 0;
+  }
+  /* The index takes the first 64 KB */
+  ds_ctx.data_block = DATASET_FIRST_BLOCK + DATASET_ALIGN_BLOCKS;
+  capacity = (info.LogBlockNbr - ds_ctx.data_block) / DATASET_RECORD_BLOCKS;
+
+  if (!Dataset_WaitReady() ||
+      BSP_SD_ReadBlocks_DMA(DATASET_INSTANCE, (uint32_t *)ds_index_block, DATASET_FIRST_BLOCK, 2) != BSP_ERROR_NONE ||
+      !Dataset_WaitTransfer()) {
+    printf("dataset: index read failed, capture off\r\n");
+    return 0;
+  }
+  for (uint32_t i = 0; i < 2U; i++) {
+    memcpy(&copy[i], ds_index_block[i], sizeof(copy[i]));
+    valid[i] = Dataset_IndexValid(&copy[i], capacity);
+  }
+
+  /* A copy torn by a reset fails its check: the other is the dataset */
+  if (valid[0] && (!valid[1] || (int32_t)(copy[0].generation - copy[1].generation) > 0)) {
+    ds_ctx.index = copy[0];
+  } else if (valid[1]) {
+    ds_ctx.index = copy[1];
+  } else {
+    ds_ctx.index = (dataset_index_t){
+        .magic = DATASET_INDEX_MAGIC,
+        .version = DATASET_VERSION,
+        .record_blocks = DATASET_RECORD_BLOCKS,
+        .capacity = capacity,
+        .first_block = DATASET_FIRST_BLOCK,
+    };
+  }
+
+  ds_ctx.index.boots++;
+  if (!Dataset_CommitIndex()) {
+    printf("dataset: index write failed, capture off\r\n");
+    return 0;
+  }
+  printf("dataset: %lu of %lu records of %u KB captured, boot %lu\r\n", (unsigned long)ds_ctx.index.records,
+         (unsigned long)capacity, (unsigned)(DATASET_RECORD_BLOCKS * DATASET_BLOCK_SIZE / 1024U),
+         (unsigned long)ds_ctx.index.boots);
+  return 1;
+}
+
+/**
+ * @brief  Give an entry's slot back to the capture ring and the entry back
+ *         to the free queue
+ */
+static void Dataset_Free(ULONG entry) {
+  if (ds_ctx.entries[entry].capture_idx >= 0) {
+    Buffer_MLCapture_Unkeep(ds_ctx.entries[entry].capture_idx);
+    ds_ctx.entries[entry].capture_idx = -1;
+  }
+  APP_REQUIRE_EQ(tx_queue_send(&ds_ctx.free_queue, &entry, TX_NO_WAIT), TX_SUCCESS);
+}
+
+/**
+ * @brief  Write one record: the frame from its slot, which then goes back
+ *         to the ring, the header block, then the index commit
+ */
+static void Dataset_WriteRecord(ULONG entry) {
+  dataset_entry_t *e = &ds_ctx.entries[entry];
+  uint32_t seq = ds_ctx.index.records;
+  uint32_t block = ds_ctx.data_block + (seq % ds_ctx.index.capacity) * DATASET_RECORD_BLOCKS;
+  uint32_t start = HAL_GetTick();
+  int ok;
+
+  ok = Dataset_Write(Buffer_GetMLCaptureBuffer(e->capture_idx), block, DATASET_FRAME_BLOCKS);
+  Buffer_MLCapture_Unkeep(e->capture_idx);
+  e->capture_idx = -1;
+
+  if (ok) {
+    e->header.seq = seq;
+    e->header.boot = ds_ctx.index.boots;
+    e->header.check = Dataset_Check(DATASET_CHECK_SEED, &e->header, offsetof(dataset_header_t, check));
+    ds_header_block = e->header;
+    ok = Dataset_Write(&ds_header_block, block + DATASET_FRAME_BLOCKS, 1);
+  }
+  if (ok) {
+    ds_ctx.index.records++;
+    ok = Dataset_CommitIndex();
+    if (!ok) {
+      ds_ctx.index.records--;
+    }
+  }
+
+  if (!ok) {
+    ds_ctx.stats.errors++;
+    ds_ctx.failures++;
+    return;
+  }
+  ds_ctx.stats.written++;
+  ds_ctx.stats.max_write_ms = MAX(ds_ctx.stats.max_write_ms, HAL_GetTick() - start);
+  ds_ctx.failures = 0;
+}
+
+static void dataset_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  ds_ctx.running = (uint8_t)Dataset_Open();
+
+  for (;;) {
+    ULONG entry;
+
+    APP_REQUIRE_EQ(tx_queue_receive(&ds_ctx.write_queue, &entry, TX_WAIT_FOREVER), TX_SUCCESS);
+    if (ds_ctx.running) {
+      Dataset_WriteRecord(entry);
+      if (ds_ctx.failures >= DATASET_MAX_FAILURES) {
+        /* Entries still queued or being decided drain through here */
+        ds_ctx.running = 0;
+        printf("dataset: card failing, capture off\r\n");
+      }
+    }
+    Dataset_Free(entry);
+  }
+}
+
+void Thread_Dataset_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  memset(ds_ctx.offered, DATASET_NO_ENTRY, sizeof(ds_ctx.offered));
+  APP_REQUIRE_EQ(tx_event_flags_create(&ds_ctx.events, "dataset"), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_queue_create(&ds_ctx.free_queue, "dataset_free", TX_1_ULONG, ds_ctx.free_storage,
+                                 sizeof(ds_ctx.free_storage)),
+                 TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_queue_create(&ds_ctx.write_queue, "dataset_write", TX_1_ULONG, ds_ctx.write_storage,
+                                 sizeof(ds_ctx.write_storage)),
+                 TX_SUCCESS);
+  for (ULONG i = 0; i < DATASET_SLOTS; i++) {
+    ds_ctx.entries[i].capture_idx = -1;
+    APP_REQUIRE_EQ(tx_queue_send(&ds_ctx.free_queue, &i, TX_NO_WAIT), TX_SUCCESS);
+  }
+  APP_REQUIRE_EQ(tx_thread_create(&ds_ctx.thread, "dataset",
+                                  dataset_thread_entry, 0,
+                                  ds_ctx.stack, DATASET_THREAD_STACK_SIZE,
+                                  DATASET_THREAD_PRIORITY, DATASET_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+/**
+ * @brief  Offer the frame of an inference; stamps its ISP state
+ */
+void Dataset_Offer(uint32_t nn_slot, int capture_idx) {
+  dataset_entry_t *e;
+  ULONG entry;
+
+  APP_REQUIRE(nn_slot < NN_OUTPUT_BUFFER_NB && ds_ctx.offered[nn_slot] == DATASET_NO_ENTRY);
+
+  if (!ds_ctx.running) {
+    return;
+  }
+  if (ds_ctx.countdown > 0U) {
+    ds_ctx.countdown--;
+    return;
+  }
+  ds_ctx.countdown = DATASET_EVERY - 1U;
+
+  if (tx_queue_receive(&ds_ctx.free_queue, &entry, TX_NO_WAIT) != TX_SUCCESS) {
+    ds_ctx.stats.dropped++;
+    return;
+  }
+  ds_ctx.stats.offered++;
+  Buffer_MLCapture_Keep(capture_idx);
+
+  e = &ds_ctx.entries[entry];
+  e->capture_idx = capture_idx;
+  memset(&e->header, 0, sizeof(e->header));
+  e->header.magic = DATASET_RECORD_MAGIC;
+  e->header.version = DATASET_VERSION;
+  e->header.frame_id = Buffer_MLCapture_GetTag(capture_idx).frame_id;
+  e->header.uptime_ms = HAL_GetTick();
+  e->header.width = ML_WIDTH;
+  e->header.height = ML_HEIGHT;
+  e->header.pitch = ML_PITCH;
+  e->header.format = buffer_registry[BUFFER_ID_ML_CAPTURE].format;
+  e->header.frame_blocks = DATASET_FRAME_BLOCKS;
+  /* Last ISP run: the AE/AWB state the frame was exposed with */
+  e->header.exposure_us = Meta.exposure;
+  e->header.gain_mdb = Meta.gain;
+  e->header.color_temp = Meta.colorTemp;
+  e->header.average_luma = Meta.averageL;
+  e->header.luma_target = (uint8_t)Meta.exposureTarget;
+  e->header.dropped = ds_ctx.stats.dropped;
+  ds_ctx.offered[nn_slot] = (uint8_t)entry;
+}
+
+/**
+ * @brief  Sampling policy
+ */
+static int Dataset_Keep(const od_pp_outBuffer_t *dets, uint32_t nb) {
+#if DATASET_SAMPLE == DATASET_SAMPLE_UNCERTAIN
+  for (uint32_t i = 0; i < nb; i++) {
+    if (dets[i].conf < DATASET_CONF_HIGH) {
+      return 1;
+    }
+  }
+  return 0;
+#else
+  UNUSED(dets);
+  UNUSED(nb);
+  return 1;
+#endif
+}
+
+/**
+ * @brief  Keep the frame offered with an NN output slot, or give it back
+ */
+void Dataset_Decide(uint32_t nn_slot, const od_pp_outBuffer_t *dets, uint32_t nb, float conf_threshold) {
+  dataset_header_t *header;
+  ULONG entry;
+
+  APP_REQUIRE(nn_slot < NN_OUTPUT_BUFFER_NB);
+  entry = ds_ctx.offered[nn_slot];
+  if (entry == DATASET_NO_ENTRY) {
+    return;
+  }
+  ds_ctx.offered[nn_slot] = DATASET_NO_ENTRY;
+
+  if (!Dataset_Keep(dets, nb)) {
+    ds_ctx.stats.skipped++;
+    Dataset_Free(entry);
+    return;
+  }
+
+  header = &ds_ctx.entries[entry].header;
+  header->detected = (uint16_t)MIN(nb, UINT16_MAX);
+  header->nb = (uint16_t)MIN(nb, DATASET_MAX_DETECTIONS);
+  header->conf_threshold = conf_threshold;
+  for (uint32_t i = 0; i < header->nb; i++) {
+    header->det[i] = (dataset_detection_t){
+        .x_center = dets[i].x_center,
+        .y_center = dets[i].y_center,
+        .width = dets[i].width,
+        .height = dets[i].height,
+        .conf = dets[i].conf,
+        .class_index = dets[i].class_index,
+    };
+  }
+  /* Never full: it holds at most every entry */
+  APP_REQUIRE_EQ(tx_queue_send(&ds_ctx.write_queue, &entry, TX_NO_WAIT), TX_SUCCESS);
+}
+
+/**
+ * @brief  Give back the frame offered with an NN output slot
+ */
+void Dataset_Discard(uint32_t nn_slot) {
+  ULONG entry;
+
+  APP_REQUIRE(nn_slot < NN_OUTPUT_BUFFER_NB);
+  entry = ds_ctx.offered[nn_slot];
+  if (entry == DATASET_NO_ENTRY) {
+    return;
+  }
+  ds_ctx.offered[nn_slot] = DATASET_NO_ENTRY;
+  Dataset_Free(entry);
+}
+
+void Dataset_GetStats(dataset_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = ds_ctx.stats;
+}
+
+void Dataset_IRQHandler(void) {
+  BSP_SD_IRQHandler(DATASET_INSTANCE);
+}
+
+/* BSP completion callbacks (HAL_SD_TxCpltCallback and HAL_SD_RxCpltCallback
+ * in stm32n6570_discovery_sd.c) */
+void BSP_SD_WriteCpltCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&ds_ctx.events, DATASET_EVENT_DONE, TX_OR);
+}
+
+void BSP_SD_ReadCpltCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&ds_ctx.events, DATASET_EVENT_DONE, TX_OR);
+}
+
+void BSP_SD_AbortCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&ds_ctx.events, DATASET_EVENT_ERROR, TX_OR);
+}
+
+void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd) {
+  UNUSED(hsd);
+  tx_event_flags_set(&ds_ctx.events, DATASET_EVENT_ERROR, TX_OR);
+}
+
+#endif /* DATASET_ENABLE */
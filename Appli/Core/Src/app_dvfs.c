@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ * @file    app_dvfs.c
+ * @author  Long Liangmao
+ * @brief   Voltage and frequency governor for STM32N6570-DK (DVFS_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_dvfs.h"
+
+#if DVFS_ENABLE || PROFILE_ENABLE
+
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_time.h"
+#include "stm32n6570_discovery.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6xx_ll_rcc.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if TRACE_ENABLE
+#error "DVFS_ENABLE and PROFILE_ENABLE change the CPU clock: TRACE_ENABLE timestamps assume a fixed cycle rate"
+#endif
+#if DVFS_DOWN_PCT >= DVFS_UP_PCT || DVFS_UP_PCT > 100
+#error "DVFS_DOWN_PCT must be below DVFS_UP_PCT, at most 100"
+#endif
+#if DVFS_NOMINAL_SCALE_PCT < 100
+#error "DVFS_NOMINAL_SCALE_PCT below 100: the nominal point is the slower one"
+#endif
+
+/* SMPS at 1 mV/us over the nominal to overdrive step, with margin */
+#define DVFS_RAMP_US 200U
+
+/* Operating points over the PLLs the FSBL leaves: PLL1 800 MHz, PLL2 1 GHz.
+ * The AXI (IC2, PLL1/2) and the NPU RAMs (IC11, PLL3) stay within the
+ * nominal limits at both points and are left alone */
+typedef struct {
+  uint32_t cpu_div;  /* IC1 from PLL1 */
+  uint32_t npu_src;  /* IC6 */
+  uint32_t npu_div;
+  uint32_t vos;
+  SMPSVoltage_TypeDef smps;
+} dvfs_opp_t;
+
+static const dvfs_opp_t dvfs_opp[DVFS_POINT_NB] = {
+    [DVFS_POINT_NOMINAL] = {2, LL_RCC_ICCLKSOURCE_PLL1, 1, PWR_REGULATOR_VOLTAGE_SCALE1, SMPS_VOLTAGE_NOMINAL},
+    [DVFS_POINT_OVERDRIVE] = {1, LL_RCC_ICCLKSOURCE_PLL2, 1, PWR_REGULATOR_VOLTAGE_SCALE0, SMPS_VOLTAGE_OVERDRIVE},
+};
+
+static struct {
+  dvfs_stats_t stats;
+  uint32_t ratio_pct;   /* Nominal over overdrive frame work */
+  uint32_t calm_frames; /* Consecutive frames predicted to fit at the nominal point */
+} dvfs_ctx;
+
+#if DVFS_ENABLE
+/**
+ * @brief  Exponential moving average, 1/8 weight for the new sample
+ */
+static uint32_t DVFS_Filter(uint32_t avg, uint32_t sample) {
+  return (avg == 0) ? sample : avg - avg / 8U + sample / 8U;
+}
+#endif
+
+/**
+ * @brief  Switch the CPU and NPU clocks, keeping the ThreadX tick period
+ */
+static void DVFS_SetClocks(const dvfs_opp_t *opp) {
+  uint32_t primask = __get_PRIMASK();
+  uint32_t old_hz, remain;
+
+  __disable_irq();
+  old_hz = SystemCoreClock;
+  LL_RCC_IC6_SetSource(opp->npu_src);
+  LL_RCC_IC6_SetDivider(opp->npu_div);
+  LL_RCC_IC1_SetDivider(opp->cpu_div);
+  SystemCoreClockUpdate();
+
+  /* SysTick counts CPU cycles: the rest of this tick at the new rate, then
+   * the nominal period, as tx_low_power_exit() restarts it */
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  remain = (uint32_t)(((uint64_t)SysTick->VAL * SystemCoreClock) / old_hz);
+  SysTick->LOAD = MAX(remain, 2U) - 1U;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  while (SysTick->VAL == 0) {
+  }
+  SysTick->LOAD = SystemCoreClock / TX_TIMER_TICKS_PER_SECOND - 1U;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Set the core supply: external SMPS and internal regulator range
+ */
+static void DVFS_SetVoltage(const dvfs_opp_t *opp) {
+  HAL_GPIO_WritePin(SMPS_GPIO_PORT, SMPS_GPIO_PIN, (GPIO_PinState)opp->smps);
+  if (opp->smps == SMPS_VOLTAGE_OVERDRIVE) {
+    uint64_t start = Time_GetUs();
+
+    while (Time_GetUs() - start < DVFS_RAMP_US) {
+    }
+  }
+  APP_REQUIRE_EQ(HAL_PWREx_ControlVoltageScaling(opp->vos), HAL_OK);
+}
+
+/**
+ * @brief  Move to an operating point: voltage before the clocks going up,
+ *         after them going down
+ */
+static void DVFS_Switch(dvfs_point_t point) {
+  const dvfs_opp_t *opp = &dvfs_opp[point];
+  TX_INTERRUPT_SAVE_AREA
+
+  if (point == DVFS_POINT_OVERDRIVE) {
+    DVFS_SetVoltage(opp);
+    DVFS_SetClocks(opp);
+  } else {
+    DVFS_SetClocks(opp);
+    DVFS_SetVoltage(opp);
+  }
+
+  TX_DISABLE
+  dvfs_ctx.stats.point = point;
+  dvfs_ctx.stats.switches++;
+  TX_RESTORE
+  dvfs_ctx.calm_frames = 0;
+  printf("DVFS: %s, CPU %lu MHz, NPU %lu MHz\r\n", (point == DVFS_POINT_OVERDRIVE) ? "overdrive" : "nominal",
+         (unsigned long)(SystemCoreClock / 1000000U), (unsigned long)(HAL_RCC_GetNPUClockFreq() / 1000000U));
+}
+
+void DVFS_Init(void) {
+  const dvfs_opp_t *opp = &dvfs_opp[DVFS_POINT_OVERDRIVE];
+
+  /* Fail-fast: the table assumes the FSBL clock tree */
+  APP_REQUIRE_EQ(LL_RCC_IC1_GetSource(), LL_RCC_ICCLKSOURCE_PLL1);
+  APP_REQUIRE_EQ(LL_RCC_IC1_GetDivider(), opp->cpu_div);
+  APP_REQUIRE_EQ(LL_RCC_IC6_GetSource(), opp->npu_src);
+  APP_REQUIRE_EQ(LL_RCC_IC6_GetDivider(), opp->npu_div);
+
+  memset(&dvfs_ctx, 0, sizeof(dvfs_ctx));
+  dvfs_ctx.stats.point = DVFS_POINT_OVERDRIVE;
+  dvfs_ctx.ratio_pct = DVFS_NOMINAL_SCALE_PCT;
+}
+
+void DVFS_SetPoint(dvfs_point_t point) {
+  APP_REQUIRE(point < DVFS_POINT_NB);
+
+  if (point != dvfs_ctx.stats.point) {
+    DVFS_Switch(point);
+  }
+}
+
+void DVFS_GetStats(dvfs_stats_t *stats) {
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  *stats = dvfs_ctx.stats;
+  TX_RESTORE
+}
+
+#if DVFS_ENABLE
+void DVFS_FrameBoundary(uint32_t busy_us) {
+  const uint32_t budget = CAM_GetMLDecimation() * 1000000U / (uint32_t)CAM_GetFrameRate();
+  dvfs_stats_t *stats = &dvfs_ctx.stats;
+  const dvfs_point_t point = stats->point;
+  TX_INTERRUPT_SAVE_AREA
+
+  if (busy_us == 0) {
+    return;
+  }
+
+  TX_DISABLE
+  stats->frames[point]++;
+  stats->busy_us[point] = DVFS_Filter(stats->busy_us[point], busy_us);
+  TX_RESTORE
+
+  if (point == DVFS_POINT_NOMINAL) {
+    /* Learn the slowdown for the next decision down */
+    if (stats->busy_us[DVFS_POINT_OVERDRIVE] != 0) {
+      dvfs_ctx.ratio_pct = MAX(stats->busy_us[DVFS_POINT_NOMINAL] * 100U / stats->busy_us[DVFS_POINT_OVERDRIVE], 100U);
+    }
+    /* Late or about to be: back up at once */
+    if (busy_us > budget * DVFS_UP_PCT / 100U) {
+      DVFS_Switch(DVFS_POINT_OVERDRIVE);
+    }
+    return;
+  }
+
+  /* Down only after a run of frames that would fit with room to spare */
+  if (stats->busy_us[DVFS_POINT_OVERDRIVE] * dvfs_ctx.ratio_pct / 100U < budget * DVFS_DOWN_PCT / 100U) {
+    if (++dvfs_ctx.calm_frames >= DVFS_HOLD_FRAMES) {
+      DVFS_Switch(DVFS_POINT_NOMINAL);
+    }
+  } else {
+    dvfs_ctx.calm_frames = 0;
+  }
+}
+#endif
+
+#endif /* DVFS_ENABLE || PROFILE_ENABLE */
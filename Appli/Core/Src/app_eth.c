@@ -0,0 +1,633 @@
+/**
+ ******************************************************************************
+ * @file    app_eth.c
+ * @author  Long Liangmao
+ * @brief   UDP telemetry publisher on Ethernet for STM32N6570-DK (ETH_PUBLISH)
+ *          ETH1 in RGMII with the RTL8211 PHY; a minimal IPv4 layer (one
+ *          static or link-local address, ARP) instead of a network stack.
+ *          Each datagram is two TX buffers: its headers, then a run of
+ *          records read in place from the telemetry ring
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_eth.h"
+
+#if ETH_PUBLISH
+
+#include "app_error.h"
+#include "app_periodic.h"
+#include "app_telemetry.h"
+#include "rtl8211.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6xx_hal_rif.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if !TELEMETRY
+#error "ETH_PUBLISH sends the telemetry records: it needs TELEMETRY"
+#endif
+#ifndef HAL_ETH_MODULE_ENABLED
+#error "ETH_PUBLISH needs HAL_ETH_MODULE_ENABLED in stm32n6xx_hal_conf.h"
+#endif
+
+/* Publisher thread: the lowest, records only wait in the ring */
+#define ETH_THREAD_STACK_SIZE 2048
+
+#define ETH_LINK_POLL_MS 500U
+#define ETH_ARP_RETRY_MS 1000U
+
+#define ETH_EVENT_RX 0x01U
+#define ETH_EVENT_FLUSH 0x02U /* Every ETH_PUBLISH_FLUSH_MS (app_periodic.c) */
+
+/* Frame layout */
+#define ETH_MAC_HDR_SIZE 14U
+#define ETH_IP_HDR_SIZE 20U
+#define ETH_UDP_HDR_SIZE 8U
+#define ETH_ARP_SIZE 28U
+#define ETH_IP_OFFSET ETH_MAC_HDR_SIZE
+#define ETH_UDP_OFFSET (ETH_IP_OFFSET + ETH_IP_HDR_SIZE)
+#define ETH_PUB_OFFSET (ETH_UDP_OFFSET + ETH_UDP_HDR_SIZE)
+#define ETH_FRAME_HDR_SIZE (ETH_PUB_OFFSET + sizeof(eth_publish_header_t))
+#define ETH_TYPE_IPV4 0x0800U
+#define ETH_TYPE_ARP 0x0806U
+#define ETH_ARP_REQUEST 1U
+#define ETH_ARP_REPLY 2U
+#define ETH_IP_PROTO_UDP 17U
+#define ETH_IP_TTL 64U
+#define ETH_MTU 1500U
+
+_Static_assert(ETH_PUBLISH_BATCH >= 1 &&
+                   ETH_IP_HDR_SIZE + ETH_UDP_HDR_SIZE + sizeof(eth_publish_header_t) +
+                           ETH_PUBLISH_BATCH * TELEMETRY_RECORD_SIZE <= ETH_MTU,
+               "A datagram is one unfragmented frame: ETH_PUBLISH_BATCH is 1 to 22");
+
+/* RX: one frame per buffer, so frames longer than the MTU are not kept.
+ * HAL_ETH_Start_IT() fills the descriptors of both DMA channels */
+#define ETH_RX_BUFFER_SIZE 1536U
+#define ETH_RX_BUFFER_NB (ETH_DMA_RX_CH_CNT * ETH_RX_DESC_CNT)
+
+/* TX: one frame per descriptor, its buffer 1 from here */
+#define ETH_TX_SLOTS ETH_TX_DESC_CNT
+#define ETH_TX_SLOT_SIZE 64U
+
+_Static_assert(ETH_FRAME_HDR_SIZE <= ETH_TX_SLOT_SIZE && ETH_MAC_HDR_SIZE + ETH_ARP_SIZE <= ETH_TX_SLOT_SIZE,
+               "TX slot too small");
+
+/* ETH1 RGMII pins of the STM32N6570-DK (MB1939), all on AF11 */
+static const struct {
+  GPIO_TypeDef *port;
+  uint16_t pin;
+} eth_pins[] = {
+    {GPIOD, GPIO_PIN_1},  /* MDC */
+    {GPIOD, GPIO_PIN_12}, /* MDIO */
+    {GPIOF, GPIO_PIN_2},  /* CLK125, from the PHY */
+    {GPIOF, GPIO_PIN_0},  /* GTX_CLK */
+    {GPIOF, GPIO_PIN_11}, /* TX_CTL */
+    {GPIOF, GPIO_PIN_12}, /* TXD0 */
+    {GPIOF, GPIO_PIN_13}, /* TXD1 */
+    {GPIOG, GPIO_PIN_3},  /* TXD2 */
+    {GPIOG, GPIO_PIN_4},  /* TXD3 */
+    {GPIOF, GPIO_PIN_7},  /* RX_CLK */
+    {GPIOF, GPIO_PIN_10}, /* RX_CTL */
+    {GPIOF, GPIO_PIN_14}, /* RXD0 */
+    {GPIOF, GPIO_PIN_15}, /* RXD1 */
+    {GPIOG, GPIO_PIN_1},  /* RXD2 */
+    {GPIOG, GPIO_PIN_2},  /* RXD3 */
+};
+
+typedef struct {
+  uint8_t frame[ETH_TX_SLOT_SIZE]; /* Headers of a datagram, or a whole ARP frame */
+  uint32_t nb;                     /* Records released on completion */
+} eth_tx_slot_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[ETH_THREAD_STACK_SIZE];
+  TX_EVENT_FLAGS_GROUP events;
+
+  ETH_HandleTypeDef heth;
+  rtl8211_Object_t phy;
+  uint8_t started; /* MAC and DMA running */
+  uint8_t link;
+  uint8_t attached; /* Telemetry ring reader */
+
+  uint8_t mac[6];
+  uint8_t ip[4];
+  uint8_t dest_ip[4];
+  uint8_t dest_mac[6];
+  uint8_t dest_resolved;
+  uint32_t unit_id;
+  uint16_t seq;
+  uint16_t ip_id;
+  uint32_t last_link_ms;
+  uint32_t last_arp_ms;
+
+  /* Frames queued by the thread, completed in order by the interrupt */
+  uint32_t tx_next;
+  volatile uint32_t tx_done;
+
+  /* Free RX buffers: HAL allocation and release both run in the thread */
+  uint8_t rx_free[ETH_RX_BUFFER_NB];
+  uint32_t rx_free_nb;
+  uint16_t rx_len[ETH_RX_BUFFER_NB];
+
+  eth_stats_t stats;
+} eth_ctx;
+
+/* Read by the MAC DMA: section covered by the non-cacheable MPU region 0 */
+static ETH_DMADescTypeDef eth_tx_desc[ETH_DMA_TX_CH_CNT][ETH_TX_DESC_CNT]
+    __attribute__((section(".noncacheable"), aligned(32)));
+static ETH_DMADescTypeDef eth_rx_desc[ETH_DMA_RX_CH_CNT][ETH_RX_DESC_CNT]
+    __attribute__((section(".noncacheable"), aligned(32)));
+static eth_tx_slot_t eth_tx[ETH_TX_SLOTS] __attribute__((section(".noncacheable"), aligned(32)));
+
+/* Written by the MAC DMA: invalidated per received frame, one buffer at a
+ * time, so each owns its cache lines */
+static uint8_t eth_rx_buf[ETH_RX_BUFFER_NB][ETH_RX_BUFFER_SIZE] __attribute__((aligned(32)));
+CACHE_LINES_CHECK(eth_rx_buf);
+_Static_assert(ETH_RX_BUFFER_SIZE % CACHE_LINE_SIZE == 0, "Ethernet RX buffers share cache lines");
+
+static const uint8_t eth_broadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static void Eth_Put16(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 8);
+  p[1] = (uint8_t)v;
+}
+
+static uint32_t Eth_Get16(const uint8_t *p) {
+  return ((uint32_t)p[0] << 8) | p[1];
+}
+
+/* PHY register access for the RTL8211 driver, over the MAC MDIO */
+static int32_t Eth_PhyIoInit(void) {
+  return RTL8211_STATUS_OK;
+}
+
+static int32_t Eth_PhyRead(uint32_t addr, uint32_t reg, uint32_t *value) {
+  return HAL_ETH_ReadPHYRegister(&eth_ctx.heth, addr, reg, value) == HAL_OK ? 0 : -1;
+}
+
+static int32_t Eth_PhyWrite(uint32_t addr, uint32_t reg, uint32_t value) {
+  return HAL_ETH_WritePHYRegister(&eth_ctx.heth, addr, reg, value) == HAL_OK ? 0 : -1;
+}
+
+static int32_t Eth_PhyTick(void) {
+  return (int32_t)HAL_GetTick();
+}
+
+/**
+ * @brief  Unit identity from the device UID: ID, MAC and, without a
+ *         configured one, a link-local address (RFC 3927 range)
+ */
+static void Eth_Identity(void) {
+  static const uint8_t local_ip[4] = ETH_PUBLISH_LOCAL_IP;
+  static const uint8_t dest_ip[4] = ETH_PUBLISH_DEST_IP;
+  uint32_t uid[3] = {HAL_GetUIDw0(), HAL_GetUIDw1(), HAL_GetUIDw2()};
+  const uint8_t *bytes = (const uint8_t *)uid;
+  uint32_t hash = 2166136261U; /* FNV-1a */
+
+  for (uint32_t i = 0; i < sizeof(uid); i++) {
+    hash = (hash ^ bytes[i]) * 16777619U;
+  }
+  eth_ctx.unit_id = hash;
+
+  /* Locally administered, unicast */
+  eth_ctx.mac[0] = 0x02;
+  eth_ctx.mac[1] = (uint8_t)(uid[0] >> 8);
+  eth_ctx.mac[2] = (uint8_t)(hash >> 24);
+  eth_ctx.mac[3] = (uint8_t)(hash >> 16);
+  eth_ctx.mac[4] = (uint8_t)(hash >> 8);
+  eth_ctx.mac[5] = (uint8_t)hash;
+
+  memcpy(eth_ctx.ip, local_ip, sizeof(eth_ctx.ip));
+  if ((local_ip[0] | local_ip[1] | local_ip[2] | local_ip[3]) == 0) {
+    eth_ctx.ip[0] = 169;
+    eth_ctx.ip[1] = 254;
+    eth_ctx.ip[2] = (uint8_t)(1U + (hash >> 8) % 254U);
+    eth_ctx.ip[3] = (uint8_t)hash;
+  }
+
+  memcpy(eth_ctx.dest_ip, dest_ip, sizeof(eth_ctx.dest_ip));
+  if ((dest_ip[0] & dest_ip[1] & dest_ip[2] & dest_ip[3]) == 0xFF) {
+    memcpy(eth_ctx.dest_mac, eth_broadcast, sizeof(eth_ctx.dest_mac));
+    eth_ctx.dest_resolved = 1;
+  }
+}
+
+static uint32_t Eth_TxInFlight(void) {
+  return eth_ctx.tx_next - eth_ctx.tx_done;
+}
+
+/**
+ * @brief  Queue one frame: buffer 1 from its TX slot, then an optional run
+ *         of records
+ * @note   Publisher thread, with a free slot (Eth_TxInFlight() < ETH_TX_SLOTS)
+ */
+static void Eth_Transmit(eth_tx_slot_t *slot, uint32_t hdr_len, const telemetry_record_t *records, uint32_t nb,
+                         uint32_t attributes) {
+  ETH_BufferTypeDef buffers[2] = {
+      {.buffer = slot->frame, .len = hdr_len, .next = NULL},
+      {.buffer = (uint8_t *)(uintptr_t)records, .len = nb * TELEMETRY_RECORD_SIZE, .next = NULL},
+  };
+  ETH_TxPacketConfigTypeDef tx = {
+      .TxDMACh = ETH_DMA_CH0_IDX,
+      .Attributes = ETH_TX_PACKETS_FEATURES_CRCPAD | attributes,
+      .Length = hdr_len + nb * TELEMETRY_RECORD_SIZE,
+      .TxBuffer = buffers,
+      .CRCPadCtrl = ETH_CRC_PAD_INSERT,
+      .ChecksumCtrl = ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC,
+      .pData = slot,
+  };
+
+  if (nb > 0) {
+    buffers[0].next = &buffers[1];
+  }
+  slot->nb = nb;
+  eth_ctx.tx_next++;
+  /* One descriptor per frame and as many slots: a descriptor is free */
+  APP_REQUIRE_EQ(HAL_ETH_Transmit_IT(&eth_ctx.heth, &tx), HAL_OK);
+}
+
+static void Eth_SendArp(uint32_t op, const uint8_t *target_mac, const uint8_t *target_ip) {
+  eth_tx_slot_t *slot = &eth_tx[eth_ctx.tx_next % ETH_TX_SLOTS];
+  uint8_t *f = slot->frame;
+  uint8_t *arp = f + ETH_MAC_HDR_SIZE;
+
+  memcpy(f, op == ETH_ARP_REQUEST ? eth_broadcast : target_mac, 6);
+  memcpy(f + 6, eth_ctx.mac, 6);
+  Eth_Put16(f + 12, ETH_TYPE_ARP);
+
+  Eth_Put16(arp, 1);              /* Ethernet */
+  Eth_Put16(arp + 2, ETH_TYPE_IPV4);
+  arp[4] = 6;
+  arp[5] = 4;
+  Eth_Put16(arp + 6, op);
+  memcpy(arp + 8, eth_ctx.mac, 6);
+  memcpy(arp + 14, eth_ctx.ip, 4);
+  memcpy(arp + 18, op == ETH_ARP_REQUEST ? (const uint8_t[6]){0} : target_mac, 6);
+  memcpy(arp + 24, target_ip, 4);
+
+  /* Padded to the 60-byte minimum by the MAC */
+  Eth_Transmit(slot, ETH_MAC_HDR_SIZE + ETH_ARP_SIZE, NULL, 0, 0);
+}
+
+/**
+ * @brief  Send a run of records as one datagram
+ */
+static void Eth_SendRecords(const telemetry_record_t *records, uint32_t nb) {
+  eth_tx_slot_t *slot = &eth_tx[eth_ctx.tx_next % ETH_TX_SLOTS];
+  uint32_t udp_len = ETH_UDP_HDR_SIZE + sizeof(eth_publish_header_t) + nb * TELEMETRY_RECORD_SIZE;
+  eth_publish_header_t pub = {
+      .magic = ETH_PUBLISH_MAGIC,
+      .unit_id = eth_ctx.unit_id,
+      .seq = eth_ctx.seq++,
+      .version = ETH_PUBLISH_VERSION,
+      .nb = (uint8_t)nb,
+  };
+  uint8_t *f = slot->frame;
+  uint8_t *ip = f + ETH_IP_OFFSET;
+  uint8_t *udp = f + ETH_UDP_OFFSET;
+
+  memcpy(f, eth_ctx.dest_mac, 6);
+  memcpy(f + 6, eth_ctx.mac, 6);
+  Eth_Put16(f + 12, ETH_TYPE_IPV4);
+
+  /* Header and UDP checksums left zero: inserted by the MAC */
+  memset(ip, 0, ETH_IP_HDR_SIZE + ETH_UDP_HDR_SIZE);
+  ip[0] = 0x45;
+  Eth_Put16(ip + 2, ETH_IP_HDR_SIZE + udp_len);
+  Eth_Put16(ip + 4, eth_ctx.ip_id++);
+  Eth_Put16(ip + 6, 0x4000); /* Don't fragment */
+  ip[8] = ETH_IP_TTL;
+  ip[9] = ETH_IP_PROTO_UDP;
+  memcpy(ip + 12, eth_ctx.ip, 4);
+  memcpy(ip + 16, eth_ctx.dest_ip, 4);
+
+  Eth_Put16(udp, ETH_PUBLISH_PORT);
+  Eth_Put16(udp + 2, ETH_PUBLISH_PORT);
+  Eth_Put16(udp + 4, udp_len);
+
+  memcpy(f + ETH_PUB_OFFSET, &pub, sizeof(pub));
+
+  eth_ctx.stats.datagrams++;
+  eth_ctx.stats.records += nb;
+  Eth_Transmit(slot, ETH_FRAME_HDR_SIZE, records, nb, ETH_TX_PACKETS_FEATURES_CSUM);
+}
+
+/**
+ * @brief  Handle one received frame: ARP only
+ */
+static void Eth_Input(const uint8_t *f, uint32_t len) {
+  const uint8_t *arp = f + ETH_MAC_HDR_SIZE;
+  const uint8_t *sender_mac = arp + 8;
+  const uint8_t *sender_ip = arp + 14;
+  uint32_t op;
+
+  eth_ctx.stats.rx_frames++;
+  if (len < ETH_MAC_HDR_SIZE + ETH_ARP_SIZE || Eth_Get16(f + 12) != ETH_TYPE_ARP) {
+    return;
+  }
+  if (Eth_Get16(arp) != 1 || Eth_Get16(arp + 2) != ETH_TYPE_IPV4 || arp[4] != 6 || arp[5] != 4) {
+    return;
+  }
+  op = Eth_Get16(arp + 6);
+
+  /* The destination announces itself in its requests and replies alike */
+  if (!eth_ctx.dest_resolved && memcmp(sender_ip, eth_ctx.dest_ip, 4) == 0) {
+    memcpy(eth_ctx.dest_mac, sender_mac, 6);
+    eth_ctx.dest_resolved = 1;
+  }
+
+  if (op == ETH_ARP_REQUEST && memcmp(arp + 24, eth_ctx.ip, 4) == 0 && Eth_TxInFlight() < ETH_TX_SLOTS) {
+    Eth_SendArp(ETH_ARP_REPLY, sender_mac, sender_ip);
+    eth_ctx.stats.arp_replies++;
+  }
+}
+
+static void Eth_Receive(void) {
+  void *frame;
+
+  while (HAL_ETH_ReadData(&eth_ctx.heth, &frame) == HAL_OK) {
+    uint32_t idx = (uint32_t)((uint8_t(*)[ETH_RX_BUFFER_SIZE])frame - eth_rx_buf);
+
+    Eth_Input(frame, eth_ctx.rx_len[idx]);
+    eth_ctx.rx_free[eth_ctx.rx_free_nb++] = (uint8_t)idx;
+  }
+}
+
+/**
+ * @brief  Follow the PHY link; (re)configure the MAC speed on link up
+ * @note   A change waits for the frames in flight
+ */
+static void Eth_CheckLink(void) {
+  ETH_MACConfigTypeDef mac_cfg;
+  int32_t state = RTL8211_GetLinkState(&eth_ctx.phy);
+  uint32_t speed;
+  uint32_t duplex;
+
+  switch (state) {
+  case RTL8211_STATUS_1000MBITS_FULLDUPLEX:
+  case RTL8211_STATUS_1000MBITS_HALFDUPLEX:
+    speed = ETH_SPEED_1000M;
+    break;
+  case RTL8211_STATUS_100MBITS_FULLDUPLEX:
+  case RTL8211_STATUS_100MBITS_HALFDUPLEX:
+    speed = ETH_SPEED_100M;
+    break;
+  case RTL8211_STATUS_10MBITS_FULLDUPLEX:
+  case RTL8211_STATUS_10MBITS_HALFDUPLEX:
+    speed = ETH_SPEED_10M;
+    break;
+  default:
+    /* Down, negotiating or unreadable */
+    eth_ctx.link = 0;
+    return;
+  }
+  duplex = (state == RTL8211_STATUS_1000MBITS_FULLDUPLEX || state == RTL8211_STATUS_100MBITS_FULLDUPLEX ||
+            state == RTL8211_STATUS_10MBITS_FULLDUPLEX)
+               ? ETH_FULLDUPLEX_MODE
+               : ETH_HALFDUPLEX_MODE;
+
+  if (eth_ctx.link || Eth_TxInFlight() != 0) {
+    return;
+  }
+
+  APP_REQUIRE_EQ(HAL_ETH_GetMACConfig(&eth_ctx.heth, &mac_cfg), HAL_OK);
+  mac_cfg.Speed = speed;
+  mac_cfg.DuplexMode = duplex;
+  mac_cfg.PortSelect = speed == ETH_SPEED_1000M ? DISABLE : ENABLE;
+  APP_REQUIRE_EQ(HAL_ETH_SetMACConfig(&eth_ctx.heth, &mac_cfg), HAL_OK);
+  if (!eth_ctx.started) {
+    APP_REQUIRE_EQ(HAL_ETH_Start_IT(&eth_ctx.heth), HAL_OK);
+    eth_ctx.started = 1;
+  }
+  eth_ctx.link = 1;
+  eth_ctx.stats.links++;
+}
+
+/**
+ * @brief  Hold the telemetry ring only while datagrams can leave
+ */
+static void Eth_UpdateAttach(void) {
+  int want = eth_ctx.link && eth_ctx.dest_resolved;
+
+  if (want && !eth_ctx.attached) {
+    Telemetry_ReaderAttach(TELEMETRY_READER_ETH, 1);
+    eth_ctx.attached = 1;
+  } else if (!want && eth_ctx.attached && Eth_TxInFlight() == 0) {
+    Telemetry_ReaderAttach(TELEMETRY_READER_ETH, 0);
+    eth_ctx.attached = 0;
+  }
+}
+
+static void eth_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  for (;;) {
+    ULONG flags;
+    uint32_t now = HAL_GetTick();
+
+    tx_event_flags_get(&eth_ctx.events, ETH_EVENT_RX | ETH_EVENT_FLUSH, TX_OR_CLEAR, &flags, TX_WAIT_FOREVER);
+    if (eth_ctx.started) {
+      Eth_Receive();
+    }
+
+    if (now - eth_ctx.last_link_ms >= ETH_LINK_POLL_MS) {
+      eth_ctx.last_link_ms = now;
+      Eth_CheckLink();
+    }
+
+    if (eth_ctx.link && !eth_ctx.dest_resolved && now - eth_ctx.last_arp_ms >= ETH_ARP_RETRY_MS &&
+        Eth_TxInFlight() < ETH_TX_SLOTS) {
+      eth_ctx.last_arp_ms = now;
+      Eth_SendArp(ETH_ARP_REQUEST, NULL, eth_ctx.dest_ip);
+    }
+
+    Eth_UpdateAttach();
+
+    /* Whatever is ready, ETH_PUBLISH_BATCH records per datagram */
+    while (eth_ctx.attached && eth_ctx.link && Eth_TxInFlight() < ETH_TX_SLOTS) {
+      const telemetry_record_t *records;
+      uint32_t nb = Telemetry_ReaderAcquire(TELEMETRY_READER_ETH, &records, ETH_PUBLISH_BATCH);
+
+      if (nb == 0) {
+        break;
+      }
+      Eth_SendRecords(records, nb);
+    }
+  }
+}
+
+/**
+ * @brief  Bring the MAC and the PHY up, then publish
+ */
+static void eth_init_thread_entry(ULONG arg) {
+  rtl8211_IOCtx_t io = {
+      .Init = Eth_PhyIoInit,
+      .DeInit = Eth_PhyIoInit,
+      .WriteReg = Eth_PhyWrite,
+      .ReadReg = Eth_PhyRead,
+      .GetTick = Eth_PhyTick,
+  };
+
+  Eth_Identity();
+
+  eth_ctx.heth.Instance = ETH1;
+  eth_ctx.heth.Init.MACAddr = eth_ctx.mac;
+  eth_ctx.heth.Init.MediaInterface = HAL_ETH_RGMII_MODE;
+  for (uint32_t ch = 0; ch < ETH_DMA_TX_CH_CNT; ch++) {
+    eth_ctx.heth.Init.TxDesc[ch] = eth_tx_desc[ch];
+  }
+  for (uint32_t ch = 0; ch < ETH_DMA_RX_CH_CNT; ch++) {
+    eth_ctx.heth.Init.RxDesc[ch] = eth_rx_desc[ch];
+  }
+  eth_ctx.heth.Init.RxBuffLen = ETH_RX_BUFFER_SIZE;
+  for (uint32_t i = 0; i < ETH_RX_BUFFER_NB; i++) {
+    eth_ctx.rx_free[i] = (uint8_t)i;
+  }
+  eth_ctx.rx_free_nb = ETH_RX_BUFFER_NB;
+  APP_REQUIRE_EQ(HAL_ETH_Init(&eth_ctx.heth), HAL_OK);
+
+  /* A board without the PHY, or an unplugged one, only loses the output.
+   * RTL8211_Init() spins 2 s: at this priority, idle time */
+  APP_REQUIRE_EQ(RTL8211_RegisterBusIO(&eth_ctx.phy, &io), RTL8211_STATUS_OK);
+  if (RTL8211_Init(&eth_ctx.phy) != RTL8211_STATUS_OK) {
+    printf("eth: no PHY, publisher off\r\n");
+    return;
+  }
+  printf("eth: %u.%u.%u.%u -> %u.%u.%u.%u:%u, unit 0x%08lx\r\n", eth_ctx.ip[0], eth_ctx.ip[1], eth_ctx.ip[2],
+         eth_ctx.ip[3], eth_ctx.dest_ip[0], eth_ctx.dest_ip[1], eth_ctx.dest_ip[2], eth_ctx.dest_ip[3],
+         ETH_PUBLISH_PORT, (unsigned long)eth_ctx.unit_id);
+
+  eth_thread_entry(arg);
+}
+
+void Thread_Eth_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&eth_ctx.events, "eth"), TX_SUCCESS);
+  Periodic_Register(&eth_ctx.events, ETH_EVENT_FLUSH, ETH_PUBLISH_FLUSH_MS);
+  APP_REQUIRE_EQ(tx_thread_create(&eth_ctx.thread, "eth",
+                                  eth_init_thread_entry, 0,
+                                  eth_ctx.stack, ETH_THREAD_STACK_SIZE,
+                                  ETH_THREAD_PRIORITY, ETH_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+void Eth_GetStats(eth_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = eth_ctx.stats;
+}
+
+void Eth_IRQHandler(void) {
+  HAL_ETH_IRQHandler(&eth_ctx.heth);
+}
+
+/**
+ * @brief  Clocks, pins, bus attributes and interrupt of ETH1
+ * @note   Called by HAL_ETH_Init()
+ */
+void HAL_ETH_MspInit(ETH_HandleTypeDef *heth) {
+  RCC_PeriphCLKInitTypeDef clk = {0};
+  GPIO_InitTypeDef gpio = {
+      .Mode = GPIO_MODE_AF_PP,
+      .Pull = GPIO_NOPULL,
+      .Speed = GPIO_SPEED_FREQ_VERY_HIGH,
+      .Alternate = GPIO_AF11_ETH1,
+  };
+  RIMC_MasterConfig_t master = {0};
+
+  UNUSED(heth);
+
+  /* MAC clocked from the bus; RGMII TX and RX clocks from the PHY side */
+  clk.PeriphClockSelection = RCC_PERIPHCLK_ETH1 | RCC_PERIPHCLK_ETH1PHY | RCC_PERIPHCLK_ETH1RX | RCC_PERIPHCLK_ETH1TX;
+  clk.Eth1ClockSelection = RCC_ETH1CLKSOURCE_HCLK;
+  clk.Eth1PhyInterfaceSelection = RCC_ETH1PHYIF_RGMII;
+  clk.Eth1RxClockSelection = RCC_ETH1RXCLKSOURCE_EXT;
+  clk.Eth1TxClockSelection = RCC_ETH1TXCLKSOURCE_EXT;
+  APP_REQUIRE_EQ(HAL_RCCEx_PeriphCLKConfig(&clk), HAL_OK);
+
+  __HAL_RCC_ETH1_CLK_ENABLE();
+  __HAL_RCC_ETH1MAC_CLK_ENABLE();
+  __HAL_RCC_ETH1TX_CLK_ENABLE();
+  __HAL_RCC_ETH1RX_CLK_ENABLE();
+  __HAL_RCC_ETH1_FORCE_RESET();
+  __HAL_RCC_ETH1_RELEASE_RESET();
+
+  __HAL_RCC_GPIOD_CLK_ENABLE();
+  __HAL_RCC_GPIOF_CLK_ENABLE();
+  __HAL_RCC_GPIOG_CLK_ENABLE();
+  for (uint32_t i = 0; i < sizeof(eth_pins) / sizeof(eth_pins[0]); i++) {
+    gpio.Pin = eth_pins[i].pin;
+    HAL_GPIO_Init(eth_pins[i].port, &gpio);
+  }
+
+  /* Reads the telemetry ring and its own descriptors: secure privileged */
+  master.MasterCID = RIF_CID_1;
+  master.SecPriv = RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV;
+  HAL_RIF_RIMC_ConfigMasterAttributes(RIF_MASTER_INDEX_ETH1, &master);
+  HAL_RIF_RISC_SetSlaveSecureAttributes(RIF_RISC_PERIPH_INDEX_ETH1, RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV);
+
+  HAL_NVIC_SetPriority(ETH1_IRQn, ETH_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(ETH1_IRQn);
+}
+
+/* HAL RX buffer management (USE_HAL_ETH_REGISTER_CALLBACKS 0): publisher thread */
+void HAL_ETH_RxAllocateCallback(uint8_t **buff) {
+  /* NULL: the descriptor is rebuilt by the next HAL_ETH_ReadData() */
+  *buff = eth_ctx.rx_free_nb > 0 ? eth_rx_buf[eth_ctx.rx_free[--eth_ctx.rx_free_nb]] : NULL;
+}
+
+void HAL_ETH_RxLinkCallback(void **pStart, void **pEnd, uint8_t *buff, uint16_t Length) {
+  uint32_t idx = (uint32_t)((uint8_t(*)[ETH_RX_BUFFER_SIZE])buff - eth_rx_buf);
+
+  if (*pStart != NULL) {
+    /* Longer than one buffer: not ours, keep the first part only */
+    eth_ctx.rx_free[eth_ctx.rx_free_nb++] = (uint8_t)idx;
+    return;
+  }
+  SCB_InvalidateDCache_by_Addr(buff, (int32_t)ETH_RX_BUFFER_SIZE);
+  eth_ctx.rx_len[idx] = Length;
+  *pStart = buff;
+  *pEnd = buff;
+}
+
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth) {
+  UNUSED(heth);
+
+  tx_event_flags_set(&eth_ctx.events, ETH_EVENT_RX, TX_OR);
+}
+
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth) {
+  HAL_ETH_ReleaseTxPacket(heth);
+}
+
+void HAL_ETH_TxFreeCallback(uint32_t *buff) {
+  eth_tx_slot_t *slot = (eth_tx_slot_t *)(void *)buff;
+
+  if (slot->nb > 0) {
+    Telemetry_ReaderRelease(TELEMETRY_READER_ETH, slot->nb);
+  }
+  eth_ctx.tx_done++;
+}
+
+void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth) {
+  UNUSED(heth);
+
+  eth_ctx.stats.errors++;
+}
+
+#endif /* ETH_PUBLISH */
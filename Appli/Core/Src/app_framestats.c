@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file    app_framestats.c
+ * @author  Long Liangmao
+ * @brief   Frame drop and overrun counters for STM32N6570-DK
+ *          Windows over the counters the camera ISRs and the capture rings
+ *          keep since boot
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_framestats.h"
+
+#if FRAME_STATS_UART && !THREAD_PROFILER_UART
+#error "FRAME_STATS_UART streams on the COM port opened by THREAD_PROFILER_UART"
+#endif
+
+#if FRAME_STATS
+
+#include "app_time.h"
+#include <string.h>
+
+#if FRAME_STATS_UART
+#include <stdio.h>
+#endif
+
+/* Totals at the start of the current window, and the last window */
+static struct {
+  cam_pipe_stats_t pipes[CAM_PIPE_NB];
+  buffer_ml_stats_t ml;
+  buffer_display_stats_t display;
+#if LCD_ERROR_MONITOR
+  lcd_error_stats_t lcd;
+#endif
+  uint64_t window_start_us;
+  framestats_report_t report;
+} fs_ctx;
+
+/**
+ * @brief  Difference of two counter snapshots, field by field
+ */
+static cam_pipe_stats_t FrameStats_PipeDelta(const cam_pipe_stats_t *now, const cam_pipe_stats_t *last) {
+  cam_pipe_stats_t delta = {
+      .frames = now->frames - last->frames,
+      .overruns = now->overruns - last->overruns,
+      .limits = now->limits - last->limits,
+      .late_swaps = now->late_swaps - last->late_swaps,
+      .restarts = now->restarts - last->restarts,
+  };
+
+  return delta;
+}
+
+#if LCD_ERROR_MONITOR
+/**
+ * @brief  Difference of two LTDC error snapshots, keeping the last event
+ */
+static lcd_error_stats_t FrameStats_LcdDelta(const lcd_error_stats_t *now, const lcd_error_stats_t *last) {
+  lcd_error_stats_t delta = *now;
+
+  delta.underruns -= last->underruns;
+  delta.transfer_errors -= last->transfer_errors;
+  delta.during_npu -= last->during_npu;
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    delta.during_pipe[i] -= last->during_pipe[i];
+  }
+
+  return delta;
+}
+#endif
+
+/**
+ * @brief  Take the current totals, publishing the window they close
+ */
+static void FrameStats_Sample(uint8_t publish) {
+  cam_pipe_stats_t pipes[CAM_PIPE_NB];
+  buffer_ml_stats_t ml;
+  buffer_display_stats_t display;
+#if LCD_ERROR_MONITOR
+  lcd_error_stats_t lcd;
+#endif
+  uint64_t now_us = Time_GetUs();
+  uint64_t window_us = now_us - fs_ctx.window_start_us;
+
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    CAM_GetPipeStats(i, &pipes[i]);
+  }
+  Buffer_MLCapture_GetStats(&ml);
+  Buffer_CameraDisplay_GetStats(&display);
+#if LCD_ERROR_MONITOR
+  LCD_GetErrorStats(&lcd);
+#endif
+
+  if (publish && window_us > 0) {
+    framestats_report_t *report = &fs_ctx.report;
+
+    for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+      framestats_pipe_t *pipe = &report->pipes[i];
+
+      pipe->window = FrameStats_PipeDelta(&pipes[i], &fs_ctx.pipes[i]);
+      pipe->total = pipes[i];
+      pipe->fps_tenths = (uint32_t)((uint64_t)pipe->window.frames * 10000000U / window_us);
+    }
+    report->ml_window.consumed = ml.consumed - fs_ctx.ml.consumed;
+    report->ml_window.skipped = ml.skipped - fs_ctx.ml.skipped;
+    report->ml_total = ml;
+    report->display_dropped = display.dropped - fs_ctx.display.dropped;
+    report->display_repeated = display.repeated - fs_ctx.display.repeated;
+#if LCD_ERROR_MONITOR
+    report->lcd_window = FrameStats_LcdDelta(&lcd, &fs_ctx.lcd);
+    report->lcd_total = lcd;
+#endif
+    report->window_us = (uint32_t)window_us;
+  }
+
+  memcpy(fs_ctx.pipes, pipes, sizeof(pipes));
+  fs_ctx.ml = ml;
+  fs_ctx.display = display;
+#if LCD_ERROR_MONITOR
+  fs_ctx.lcd = lcd;
+#endif
+  fs_ctx.window_start_us = now_us;
+}
+
+#if FRAME_STATS_UART
+/**
+ * @brief  Print the last window, one line per pipe
+ */
+static void FrameStats_Stream(const framestats_report_t *report) {
+  printf("frames %lu us: nn %lu inferred %lu skipped, display %lu dropped %lu repeated\r\n",
+         (unsigned long)report->window_us,
+         (unsigned long)report->ml_window.consumed, (unsigned long)report->ml_window.skipped,
+         (unsigned long)report->display_dropped, (unsigned long)report->display_repeated);
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    const framestats_pipe_t *p = &report->pipes[i];
+    printf("  pipe%lu %3lu.%lu fps ovr %lu/%lu limit %lu/%lu late %lu/%lu restart %lu\r\n", (unsigned long)i,
+           (unsigned long)p->fps_tenths / 10, (unsigned long)p->fps_tenths % 10,
+           (unsigned long)p->window.overruns, (unsigned long)p->total.overruns,
+           (unsigned long)p->window.limits, (unsigned long)p->total.limits,
+           (unsigned long)p->window.late_swaps, (unsigned long)p->total.late_swaps,
+           (unsigned long)p->total.restarts);
+  }
+#if LCD_ERROR_MONITOR
+  {
+    const lcd_error_stats_t *w = &report->lcd_window;
+
+    printf("  ltdc underrun %lu/%lu te %lu/%lu, during npu %lu p0 %lu p1 %lu p2 %lu, last epoch %d\r\n",
+           (unsigned long)w->underruns, (unsigned long)report->lcd_total.underruns,
+           (unsigned long)w->transfer_errors, (unsigned long)report->lcd_total.transfer_errors,
+           (unsigned long)w->during_npu, (unsigned long)w->during_pipe[0],
+           (unsigned long)w->during_pipe[1], (unsigned long)w->during_pipe[2], (int)w->last_epoch);
+  }
+#endif
+}
+#endif
+
+void FrameStats_Init(void) {
+  memset(&fs_ctx, 0, sizeof(fs_ctx));
+  FrameStats_Sample(0);
+}
+
+void FrameStats_Update(void) {
+  FrameStats_Sample(1);
+
+#if FRAME_STATS_UART
+  FrameStats_Stream(&fs_ctx.report);
+#endif
+}
+
+void FrameStats_GetReport(framestats_report_t *report) {
+  *report = fs_ctx.report;
+}
+
+#endif /* FRAME_STATS */
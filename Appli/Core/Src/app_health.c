@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file    app_health.c
+ * @author  Long Liangmao
+ * @brief   Pipeline health monitor for STM32N6570-DK (HEALTH_MONITOR)
+ *          A supervisor thread above the pipeline watches the pipe frame
+ *          counters and the NPU epoch waits, restarts a stalled pipe in
+ *          place and feeds the IWDG while no stage is hung
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_health.h"
+
+#if HEALTH_MONITOR
+
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_periodic.h"
+#include "app_time.h"
+#include "stm32n6xx_hal.h"
+
+#if HEALTH_IWDG && (HEALTH_IWDG_TIMEOUT_MS < 1 || HEALTH_IWDG_TIMEOUT_MS > 4095)
+#error "HEALTH_IWDG_TIMEOUT_MS must be within 1..4095"
+#endif
+#if HEALTH_IWDG && HEALTH_IWDG_TIMEOUT_MS <= HEALTH_PIPE_TIMEOUT_MS
+#error "HEALTH_IWDG_TIMEOUT_MS must exceed HEALTH_PIPE_TIMEOUT_MS"
+#endif
+
+/* Supervisor thread configuration: above the camera init thread, so a pipe
+ * is restarted whatever the pipeline threads are doing */
+#define HEALTH_THREAD_STACK_SIZE 1024
+
+/* An armed NPU stage silent this long means the epoch wait timed out and
+ * the recovery itself hung: stop feeding the IWDG */
+#define HEALTH_NPU_HUNG_MS (2U * HEALTH_NPU_TIMEOUT_MS)
+
+#define HEALTH_EVENT_CHECK 0x01U /* Every HEALTH_PERIOD_MS (app_periodic.c) */
+
+static struct {
+  TX_THREAD thread;
+  TX_EVENT_FLAGS_GROUP events;
+  UCHAR stack[HEALTH_THREAD_STACK_SIZE];
+
+  /* Per stage, written by any thread: checked while armed, since_ms restarts
+   * on every kick */
+  volatile uint8_t armed[HEALTH_STAGE_NB];
+  volatile uint32_t since_ms[HEALTH_STAGE_NB];
+
+  /* Pipe frame counters at the previous check; the supervisor's alone */
+  uint32_t frames[HEALTH_STAGE_NB];
+
+  /* Recovery budget, under interrupt lock */
+  uint32_t window_start_ms;
+  uint32_t window_count;
+  health_stats_t stats;
+
+#if HEALTH_IWDG
+  IWDG_HandleTypeDef hiwdg;
+#endif
+} health_ctx;
+
+void Health_Arm(uint32_t stage) {
+  APP_REQUIRE(stage < HEALTH_STAGE_NB);
+
+  health_ctx.since_ms[stage] = HAL_GetTick();
+  health_ctx.armed[stage] = 1;
+}
+
+void Health_Disarm(uint32_t stage) {
+  APP_REQUIRE(stage < HEALTH_STAGE_NB);
+
+  health_ctx.armed[stage] = 0;
+}
+
+void Health_Kick(uint32_t stage) {
+  health_ctx.since_ms[stage] = HAL_GetTick();
+}
+
+void Health_RecordRecovery(uint32_t stage, uint32_t us) {
+  uint32_t now = HAL_GetTick();
+  uint32_t count;
+
+  APP_REQUIRE(stage < HEALTH_STAGE_NB);
+
+  __disable_irq();
+  if (health_ctx.window_count == 0 || now - health_ctx.window_start_ms >= HEALTH_RECOVERY_WINDOW_MS) {
+    health_ctx.window_start_ms = now;
+    health_ctx.window_count = 0;
+  }
+  count = ++health_ctx.window_count;
+  health_ctx.stats.recoveries[stage]++;
+  health_ctx.stats.last_recovery_us[stage] = us;
+  __enable_irq();
+
+  /* Recoveries that keep coming do not fix the fault: give up */
+  APP_REQUIRE(count <= HEALTH_MAX_RECOVERIES);
+}
+
+void Health_RecordWeightFault(uint32_t addr) {
+  __disable_irq();
+  health_ctx.stats.weight_faults++;
+  health_ctx.stats.last_weight_fault_addr = addr;
+  __enable_irq();
+}
+
+void Health_GetStats(health_stats_t *stats) {
+  __disable_irq();
+  *stats = health_ctx.stats;
+  __enable_irq();
+}
+
+/**
+ * @brief  Check one pipe: any new frame is progress, a stall past the
+ *         timeout restarts it
+ * @param  restart: CAM_MLPipe_Restart() or CAM_DisplayPipe_Restart()
+ */
+static void Health_CheckPipe(uint32_t stage, uint32_t pipe, void (*restart)(void), uint32_t now) {
+  cam_pipe_stats_t stats;
+  uint64_t start_us;
+
+  CAM_GetPipeStats(pipe, &stats);
+  if (stats.frames != health_ctx.frames[stage]) {
+    health_ctx.frames[stage] = stats.frames;
+    Health_Kick(stage);
+    return;
+  }
+  if (!health_ctx.armed[stage] || now - health_ctx.since_ms[stage] < HEALTH_PIPE_TIMEOUT_MS) {
+    return;
+  }
+
+  start_us = Time_GetUs();
+  restart();
+  Health_Kick(stage);
+  Health_RecordRecovery(stage, (uint32_t)(Time_GetUs() - start_us));
+}
+
+#if HEALTH_IWDG
+/**
+ * @brief  Start the IWDG; it cannot be stopped until the next reset
+ * @note   Frozen while the core is halted by a debugger
+ */
+static void Health_StartIwdg(void) {
+  __HAL_RCC_DBGMCU_CLK_ENABLE();
+  __HAL_DBGMCU_FREEZE_IWDG();
+
+  health_ctx.hiwdg.Instance = IWDG;
+  health_ctx.hiwdg.Init.Prescaler = IWDG_PRESCALER_32; /* 1 ms per count at 32 kHz LSI */
+  health_ctx.hiwdg.Init.Reload = HEALTH_IWDG_TIMEOUT_MS;
+  health_ctx.hiwdg.Init.Window = IWDG_WINDOW_DISABLE;
+  health_ctx.hiwdg.Init.EWI = IWDG_EWI_DISABLE;
+  APP_REQUIRE_EQ(HAL_IWDG_Init(&health_ctx.hiwdg), HAL_OK);
+}
+#endif
+
+static void health_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  while (1) {
+    ULONG events;
+    uint32_t now;
+
+    APP_REQUIRE_EQ(tx_event_flags_get(&health_ctx.events, HEALTH_EVENT_CHECK, TX_OR_CLEAR, &events, TX_WAIT_FOREVER),
+                   TX_SUCCESS);
+    now = HAL_GetTick();
+
+    Health_CheckPipe(HEALTH_STAGE_PIPE2, DCMIPP_PIPE2, CAM_MLPipe_Restart, now);
+#if !DISPLAY_SINGLE_PIPE
+    Health_CheckPipe(HEALTH_STAGE_PIPE1, DCMIPP_PIPE1, CAM_DisplayPipe_Restart, now);
+#endif
+
+#if HEALTH_IWDG
+    /* The NPU is recovered by the inference thread on its own epoch wait
+     * timeout; only a recovery that never returns is left to the IWDG */
+    if (health_ctx.armed[HEALTH_STAGE_NPU] && now - health_ctx.since_ms[HEALTH_STAGE_NPU] >= HEALTH_NPU_HUNG_MS) {
+      continue;
+    }
+    APP_REQUIRE_EQ(HAL_IWDG_Refresh(&health_ctx.hiwdg), HAL_OK);
+#endif
+  }
+}
+
+void Thread_Health_Init(VOID *memory_ptr) {
+  cam_pipe_stats_t stats;
+
+  UNUSED(memory_ptr);
+
+  /* Boot cause, before the flags are cleared for the next one */
+  health_ctx.stats.iwdg_reset = (uint8_t)LL_RCC_IsActiveFlag_IWDGRST();
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+
+  CAM_GetPipeStats(DCMIPP_PIPE2, &stats);
+  health_ctx.frames[HEALTH_STAGE_PIPE2] = stats.frames;
+#if ML_CAPTURE_MODE != ML_CAPTURE_SNAPSHOT
+  /* A continuous Pipe2 always runs; snapshots only while a frame is awaited */
+  Health_Arm(HEALTH_STAGE_PIPE2);
+#endif
+#if !DISPLAY_SINGLE_PIPE
+  CAM_GetPipeStats(DCMIPP_PIPE1, &stats);
+  health_ctx.frames[HEALTH_STAGE_PIPE1] = stats.frames;
+  Health_Arm(HEALTH_STAGE_PIPE1);
+#endif
+
+#if HEALTH_IWDG
+  Health_StartIwdg();
+#endif
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&health_ctx.events, "health"), TX_SUCCESS);
+  Periodic_Register(&health_ctx.events, HEALTH_EVENT_CHECK, HEALTH_PERIOD_MS);
+  APP_REQUIRE_EQ(tx_thread_create(&health_ctx.thread, "health",
+                                 health_thread_entry, 0,
+                                 health_ctx.stack, HEALTH_THREAD_STACK_SIZE,
+                                 HEALTH_THREAD_PRIORITY, HEALTH_THREAD_PRIORITY,
+                                 TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+#endif /* HEALTH_MONITOR */
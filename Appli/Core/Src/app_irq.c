@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * @file    app_irq.c
+ * @author  Long Liangmao
+ * @brief   Interrupt priority plan check for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_irq.h"
+#include "app_error.h"
+
+#if !(PCPROF_IRQ_PRIORITY > 0 && PCPROF_IRQ_PRIORITY < NPU_IRQ_PRIORITY && NPU_IRQ_PRIORITY < CAM_IRQ_PRIORITY && \
+      CAM_IRQ_PRIORITY < OVERLAY_IRQ_PRIORITY && OVERLAY_IRQ_PRIORITY < TICK_INT_PRIORITY)
+#error "Interrupt priority plan: PC sampler, NPU, camera, overlay, timebase, most urgent first"
+#endif
+#if LCD_IRQ_PRIORITY != CAM_IRQ_PRIORITY
+#error "LCD_IRQ_PRIORITY must be CAM_IRQ_PRIORITY: both handlers update the camera ring"
+#endif
+#if PREFETCH_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || USB_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || \
+    VENC_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || SNAPSHOT_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || \
+    ETH_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || TELEMETRY_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || \
+    SENSOR_CMD_IRQ_PRIORITY <= CAM_IRQ_PRIORITY || SCRUB_IRQ_PRIORITY <= CAM_IRQ_PRIORITY
+#error "Interrupt priority plan: the peripheral links stay below the camera and display"
+#endif
+#if TICK_INT_PRIORITY >= (1 << __NVIC_PRIO_BITS)
+#error "TICK_INT_PRIORITY out of the NVIC range"
+#endif
+
+typedef struct {
+  IRQn_Type irq;
+  uint32_t priority;
+} irq_plan_t;
+
+static const irq_plan_t irq_plan[] = {
+    {NPU0_IRQn, NPU_IRQ_PRIORITY},
+    {DCMIPP_IRQn, CAM_IRQ_PRIORITY},
+    {CSI_IRQn, CAM_IRQ_PRIORITY},
+    {LTDC_LO_IRQn, LCD_IRQ_PRIORITY},
+    {LTDC_UP_IRQn, LCD_IRQ_PRIORITY},
+    {DMA2D_IRQn, OVERLAY_IRQ_PRIORITY},
+#if SENSOR_CMD_ENABLE
+    {I2C1_EV_IRQn, SENSOR_CMD_IRQ_PRIORITY},
+    {I2C1_ER_IRQn, SENSOR_CMD_IRQ_PRIORITY},
+#endif
+};
+
+void Irq_CheckPlan(void) {
+  for (uint32_t i = 0; i < sizeof(irq_plan) / sizeof(irq_plan[0]); i++) {
+    APP_REQUIRE_EQ(NVIC_GetPriority(irq_plan[i].irq), irq_plan[i].priority);
+  }
+}
@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ * @file    app_isp_tool.c
+ * @author  Long Liangmao
+ * @brief   Remote ISP tuning link for STM32N6570-DK (ISP_TUNING_ENABLE)
+ *          The ISP library parses the tool commands from the ISP thread;
+ *          dumps lend a Pipe2 slot in place and are streamed, with the
+ *          metadata of every run, from a low-priority thread
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_isp_tool.h"
+#include "app_buffers.h"
+#include "app_config.h"
+#include "app_error.h"
+#include "cmw_camera.h"
+#include "isp_api.h"
+#include "isp_core.h"
+#include "isp_tool_com.h"
+#include "stm32n6xx_hal.h"
+
+#if ISP_TUNING_ENABLE
+
+/* Tuning link thread configuration: below every other application thread */
+#define ISP_TOOL_THREAD_STACK_SIZE 2048
+
+#define ISP_TOOL_EVENT_DUMP (1U << 0) /* A dump was queued by the command parser */
+#define ISP_TOOL_EVENT_META (1U << 1) /* An ISP run completed */
+#define ISP_TOOL_EVENT_ALL (ISP_TOOL_EVENT_DUMP | ISP_TOOL_EVENT_META)
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[ISP_TOOL_THREAD_STACK_SIZE];
+  TX_EVENT_FLAGS_GROUP events;
+
+  /* Dump queued to the thread, set by the ISP thread before EVENT_DUMP */
+  uint8_t *dump_buffer;
+  uint32_t dump_size;
+} isp_tool_ctx;
+
+/**
+ * @brief  DumpFrame helper: lend the newest Pipe2 frame, no copy
+ * @note   Only the live stream dump is served: Pipe2 is the one RGB888 pipe
+ *         and no full-size or RAW pipe is kept running for the tool
+ */
+static ISP_StatusTypeDef IspTool_DumpFrame(void *pHdcmipp, uint32_t Pipe, ISP_DumpCfgTypeDef Config,
+                                           uint32_t **pBuffer, ISP_DumpFrameMetaTypeDef *pMeta) {
+  int idx;
+
+  UNUSED(pHdcmipp);
+
+#if ML_GRAYSCALE || ML_YUV422
+  UNUSED(Pipe);
+  UNUSED(Config);
+  UNUSED(pBuffer);
+  UNUSED(pMeta);
+  return ISP_ERR_EINVAL;
+#else
+  if (Pipe != DCMIPP_PIPE2 || Config != ISP_DUMP_CFG_DEFAULT) {
+    return ISP_ERR_EINVAL;
+  }
+
+  idx = Buffer_MLCapture_Lend();
+  if (idx < 0) {
+    return ISP_ERR_EINVAL;
+  }
+
+  /* Written by DCMIPP: drop stale lines before the CPU streams it */
+  Buffer_Invalidate(BUFFER_ID_ML_CAPTURE, Buffer_GetMLCaptureBuffer(idx));
+
+  *pBuffer = (uint32_t *)Buffer_GetMLCaptureBuffer(idx);
+  pMeta->width = ML_WIDTH;
+  pMeta->height = ML_HEIGHT;
+  pMeta->pitch = ML_PITCH;
+  pMeta->size = pMeta->pitch * ML_HEIGHT;
+  pMeta->format = ISP_FORMAT_RGB888;
+
+  return ISP_OK;
+#endif
+}
+
+/**
+ * @brief  SendDump helper: hand the dump to the tuning link thread
+ * @note   ISP thread, from the command parser
+ */
+static ISP_StatusTypeDef IspTool_SendDump(uint8_t *pBuffer, uint32_t Size) {
+  isp_tool_ctx.dump_buffer = pBuffer;
+  isp_tool_ctx.dump_size = Size;
+
+  if (tx_event_flags_set(&isp_tool_ctx.events, ISP_TOOL_EVENT_DUMP, TX_OR) != TX_SUCCESS) {
+    return ISP_ERR_EINVAL;
+  }
+
+  return ISP_OK;
+}
+
+/**
+ * @brief  Register the dump helpers with the camera middleware
+ */
+void IspTool_Init(void) {
+  ISP_AppliHelpersTypeDef helpers = {0};
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&isp_tool_ctx.events, "isp_tool_events"), TX_SUCCESS);
+
+  helpers.DumpFrame = IspTool_DumpFrame;
+  helpers.SendDump = IspTool_SendDump;
+  APP_REQUIRE_EQ(CMW_CAMERA_SetISPAppliHelpers(&helpers), CMW_ERROR_NONE);
+}
+
+/**
+ * @brief  Signal that an ISP run completed
+ */
+void IspTool_NotifyRun(void) {
+  tx_event_flags_set(&isp_tool_ctx.events, ISP_TOOL_EVENT_META, TX_OR);
+}
+
+/**
+ * @brief  Tuning link thread: stream queued dumps and run metadata
+ * @param  arg: Unused
+ */
+static void isp_tool_thread_entry(ULONG arg) {
+  ULONG events;
+
+  UNUSED(arg);
+
+  while (1) {
+    APP_REQUIRE_EQ(tx_event_flags_get(&isp_tool_ctx.events, ISP_TOOL_EVENT_ALL, TX_OR_CLEAR, &events,
+                                      TX_WAIT_FOREVER),
+                   TX_SUCCESS);
+
+    if (events & ISP_TOOL_EVENT_DUMP) {
+      ISP_ToolCom_SendDump(isp_tool_ctx.dump_buffer, isp_tool_ctx.dump_size);
+      Buffer_MLCapture_Return();
+    }
+
+    if (events & ISP_TOOL_EVENT_META) {
+      ISP_OutputMeta(CMW_CAMERA_GetISPHandle());
+    }
+  }
+}
+
+/**
+ * @brief  Initialize and start the tuning link thread
+ */
+void Thread_IspTool_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  APP_REQUIRE_EQ(tx_thread_create(&isp_tool_ctx.thread, "isp_tool",
+                                 isp_tool_thread_entry, 0,
+                                 isp_tool_ctx.stack, ISP_TOOL_THREAD_STACK_SIZE,
+                                 ISP_TOOL_THREAD_PRIORITY, ISP_TOOL_THREAD_PRIORITY,
+                                 TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+#endif /* ISP_TUNING_ENABLE */
@@ -0,0 +1,231 @@
+/**
+ ******************************************************************************
+ * @file    app_isrprof.c
+ * @author  Long Liangmao
+ * @brief   Interrupt handler profile for STM32N6570-DK (ISR_PROFILER)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_isrprof.h"
+
+#if ISR_PROFILER
+
+#include "app_error.h"
+#include "app_telemetry.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+#if !TELEMETRY
+#error "ISR_PROFILER sends its counters as telemetry records: it needs TELEMETRY"
+#endif
+
+_Static_assert(sizeof(isrprof_record_t) <= TELEMETRY_PAYLOAD_MAX, "ISR profile record overflows");
+
+/* Every profiled handler at once, nested by priority */
+#define ISRPROF_DEPTH_MAX ISRPROF_IRQ_NB
+
+/* Exceptions, then IRQ 0 to LTDC_UP_ERR_IRQn, the last one; VTOR takes the
+ * table size rounded up to a power of two as alignment */
+#define ISRPROF_VECTOR_NB (16U + (uint32_t)LTDC_UP_ERR_IRQn + 1U)
+#define ISRPROF_VECTOR_ALIGN 1024U
+
+_Static_assert(ISRPROF_VECTOR_NB * 4U <= ISRPROF_VECTOR_ALIGN, "Vector table outgrows its alignment");
+
+/* Startup vector table and the AI runtime handler it points at
+ * (ll_aton_runtime.c) */
+extern const uint32_t g_pfnVectors[];
+void NPU0_IRQHandler(void);
+
+typedef struct {
+  uint32_t count;
+  uint32_t max_cycles;
+  uint32_t self_cycles;
+  uint32_t latency_max;
+  uint32_t latency_total;
+  uint16_t preempted;
+  uint16_t nested;
+  uint16_t latency_nb;
+  uint8_t max_depth;
+  uint16_t hist[ISRPROF_HIST_BUCKETS];
+} isrprof_stats_t;
+
+/* One open handler: its entry stamp and the time of the bracketed handlers
+ * nested over it so far */
+typedef struct {
+  uint32_t start;
+  uint32_t nested_cycles;
+  isrprof_irq_t irq;
+} isrprof_frame_t;
+
+static struct {
+  isrprof_stats_t stats[ISRPROF_IRQ_NB];
+  isrprof_frame_t stack[ISRPROF_DEPTH_MAX];
+  uint32_t depth;
+  uint32_t ltdc_hz; /* Pixel clock, read at the first line event */
+} isrprof_ctx;
+
+static uint32_t isrprof_vectors[ISRPROF_VECTOR_NB] __attribute__((aligned(ISRPROF_VECTOR_ALIGN)));
+
+static inline uint16_t IsrProf_Inc16(uint16_t v) {
+  return (v == UINT16_MAX) ? v : (uint16_t)(v + 1U);
+}
+
+/**
+ * @brief  Cycles since the LTDC reached the programmed line, 0 when no line
+ *         event is pending
+ * @note   The line counter and the scanout position count from the same
+ *         vertical sync; the resolution is one pixel clock
+ */
+static uint32_t IsrProf_LineLatency(void) {
+  uint32_t cpsr, line, cy, pixels;
+
+  if ((LTDC->ISR & LTDC_ISR_LIF) == 0 || (LTDC->IER & LTDC_IER_LIE) == 0) {
+    return 0;
+  }
+  cpsr = LTDC->CPSR;
+  line = (LTDC->LIPCR & LTDC_LIPCR_LIPOS_Msk) >> LTDC_LIPCR_LIPOS_Pos;
+  cy = (cpsr & LTDC_CPSR_CYPOS_Msk) >> LTDC_CPSR_CYPOS_Pos;
+  if (cy < line) {
+    /* Past the end of the frame: a stale flag, not a latency */
+    return 0;
+  }
+  if (isrprof_ctx.ltdc_hz == 0) {
+    isrprof_ctx.ltdc_hz = (uint32_t)HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_LTDC);
+    APP_REQUIRE(isrprof_ctx.ltdc_hz != 0);
+  }
+  pixels = (cy - line) * (((LTDC->TWCR & LTDC_TWCR_TOTALW_Msk) >> LTDC_TWCR_TOTALW_Pos) + 1U) +
+           ((cpsr & LTDC_CPSR_CXPOS_Msk) >> LTDC_CPSR_CXPOS_Pos);
+  return (uint32_t)(((uint64_t)pixels * SystemCoreClock) / isrprof_ctx.ltdc_hz);
+}
+
+/**
+ * @brief  NPU vector of the RAM table: the AI runtime handler, bracketed
+ */
+static void IsrProf_NpuIRQHandler(void) {
+  IsrProf_Enter(ISRPROF_IRQ_NPU);
+  NPU0_IRQHandler();
+  IsrProf_Exit(ISRPROF_IRQ_NPU);
+}
+
+void IsrProf_Init(void) {
+  uint32_t primask = __get_PRIMASK();
+
+  memset(&isrprof_ctx, 0, sizeof(isrprof_ctx));
+
+  /* CYCCNT is not reset: the other users keep their stamps */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  APP_REQUIRE_EQ(SCB->VTOR, (uint32_t)g_pfnVectors);
+
+  __disable_irq();
+  memcpy(isrprof_vectors, g_pfnVectors, sizeof(isrprof_vectors));
+  isrprof_vectors[16U + (uint32_t)NPU0_IRQn] = (uint32_t)IsrProf_NpuIRQHandler;
+  SCB_CleanDCache_by_Addr(isrprof_vectors, sizeof(isrprof_vectors));
+  SCB->VTOR = (uint32_t)isrprof_vectors;
+  __DSB();
+  __ISB();
+  __set_PRIMASK(primask);
+}
+
+void IsrProf_Enter(isrprof_irq_t irq) {
+  const uint32_t now = DWT->CYCCNT;
+  uint32_t primask = __get_PRIMASK();
+  isrprof_stats_t *stats = &isrprof_ctx.stats[irq];
+  uint32_t latency = 0;
+
+  if (irq == ISRPROF_IRQ_LTDC_LO || irq == ISRPROF_IRQ_LTDC_UP) {
+    latency = IsrProf_LineLatency();
+  }
+
+  __disable_irq();
+  APP_REQUIRE(isrprof_ctx.depth < ISRPROF_DEPTH_MAX);
+  if (isrprof_ctx.depth > 0) {
+    isrprof_stats_t *outer = &isrprof_ctx.stats[isrprof_ctx.stack[isrprof_ctx.depth - 1U].irq];
+
+    outer->preempted = IsrProf_Inc16(outer->preempted);
+    stats->nested = IsrProf_Inc16(stats->nested);
+  }
+  isrprof_ctx.stack[isrprof_ctx.depth].irq = irq;
+  isrprof_ctx.stack[isrprof_ctx.depth].start = now;
+  isrprof_ctx.stack[isrprof_ctx.depth].nested_cycles = 0;
+  isrprof_ctx.depth++;
+  if (isrprof_ctx.depth > stats->max_depth) {
+    stats->max_depth = (uint8_t)isrprof_ctx.depth;
+  }
+  if (latency != 0) {
+    stats->latency_nb = IsrProf_Inc16(stats->latency_nb);
+    stats->latency_total += latency;
+    stats->latency_max = MAX(stats->latency_max, latency);
+  }
+  __set_PRIMASK(primask);
+}
+
+void IsrProf_Exit(isrprof_irq_t irq) {
+  uint32_t primask = __get_PRIMASK();
+  isrprof_stats_t *stats = &isrprof_ctx.stats[irq];
+  const isrprof_frame_t *frame;
+  uint32_t run, self, bucket;
+
+  __disable_irq();
+  APP_REQUIRE(isrprof_ctx.depth > 0);
+  frame = &isrprof_ctx.stack[--isrprof_ctx.depth];
+  run = DWT->CYCCNT - frame->start;
+  self = run - frame->nested_cycles;
+  if (isrprof_ctx.depth > 0) {
+    isrprof_frame_t *outer = &isrprof_ctx.stack[isrprof_ctx.depth - 1U];
+
+    outer->nested_cycles += run;
+  }
+
+  stats->count++;
+  stats->max_cycles = MAX(stats->max_cycles, run);
+  stats->self_cycles += self;
+  bucket = 32U - __CLZ(self);
+  bucket = (bucket > ISRPROF_HIST_SHIFT) ? MIN(bucket - ISRPROF_HIST_SHIFT, ISRPROF_HIST_BUCKETS - 1U) : 0;
+  stats->hist[bucket] = IsrProf_Inc16(stats->hist[bucket]);
+  __set_PRIMASK(primask);
+}
+
+void IsrProf_Update(void) {
+  isrprof_stats_t stats[ISRPROF_IRQ_NB];
+  isrprof_record_t rec;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  memcpy(stats, isrprof_ctx.stats, sizeof(stats));
+  memset(isrprof_ctx.stats, 0, sizeof(isrprof_ctx.stats));
+  TX_RESTORE
+
+  for (uint32_t irq = 0; irq < ISRPROF_IRQ_NB; irq++) {
+    const isrprof_stats_t *s = &stats[irq];
+
+    memset(&rec, 0, sizeof(rec));
+    rec.irq = (uint8_t)irq;
+    rec.max_depth = s->max_depth;
+    rec.mhz = (uint16_t)(SystemCoreClock / 1000000U);
+    rec.count = s->count;
+    rec.max_cycles = s->max_cycles;
+    rec.self_cycles = s->self_cycles;
+    rec.latency_max = s->latency_max;
+    rec.latency_total = s->latency_total;
+    rec.preempted = s->preempted;
+    rec.nested = s->nested;
+    rec.latency_nb = s->latency_nb;
+    memcpy(rec.hist, s->hist, sizeof(rec.hist));
+    Telemetry_Send(TELEMETRY_TYPE_ISR, &rec, sizeof(rec));
+  }
+}
+
+#endif /* ISR_PROFILER */
@@ -0,0 +1,159 @@
+/**
+ ******************************************************************************
+ * @file    app_jobs.c
+ * @author  Long Liangmao
+ * @brief   Engine job pipelines for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_jobs.h"
+#include "app_config.h"
+#include "app_error.h"
+
+#if JOBS_LANE_PRIORITY <= PP_THREAD_PRIORITY || JOBS_LANE_PRIORITY >= UI_THREAD_PRIORITY
+#error "JOBS_LANE_PRIORITY: the lanes run below post-processing and above the UI overlay"
+#endif
+
+/* The H.264 encoder library runs in its lane */
+#define JOBS_LANE_STACK_SIZE 4096
+
+/* Every slot of every pipeline waiting on one lane at once */
+#define JOBS_QUEUE_DEPTH (JOBS_PIPELINES_MAX * JOBS_SLOTS_MAX)
+
+/* Queued job: pipeline, stage and slot in one message word */
+#define JOBS_PACK(pipeline, stage, slot) (((ULONG)(pipeline) << 16) | ((ULONG)(stage) << 8) | (ULONG)(slot))
+#define JOBS_PIPELINE(job) (((job) >> 16) & 0xFFU)
+#define JOBS_STAGE(job) (((job) >> 8) & 0xFFU)
+#define JOBS_SLOT(job) ((job) & 0xFFU)
+
+_Static_assert(JOBS_STAGES_MAX <= 0xFF && JOBS_SLOTS_MAX <= 0xFF, "Jobs do not fit their message word");
+
+typedef struct {
+  TX_THREAD thread;
+  TX_QUEUE queue;
+  ULONG queue_storage[JOBS_QUEUE_DEPTH];
+  UCHAR stack[JOBS_LANE_STACK_SIZE];
+  uint8_t started;
+} jobs_lane_t;
+
+static const char *const jobs_lane_names[JOBS_ENGINE_NB] = {
+    [JOBS_ENGINE_CPU] = "jobs_cpu",
+    [JOBS_ENGINE_NPU] = "jobs_npu",
+    [JOBS_ENGINE_DMA2D] = "jobs_dma2d",
+    [JOBS_ENGINE_HPDMA] = "jobs_hpdma",
+    [JOBS_ENGINE_JPEG] = "jobs_jpeg",
+    [JOBS_ENGINE_VENC] = "jobs_venc",
+};
+
+static struct {
+  jobs_lane_t lanes[JOBS_ENGINE_NB];
+  jobs_pipeline_t *pipelines[JOBS_PIPELINES_MAX];
+  uint32_t pipeline_nb;
+} jobs_ctx;
+
+/**
+ * @brief  Queue a slot on the lane of a stage, or free it past the last one
+ */
+static void Jobs_Post(jobs_pipeline_t *pipeline, uint32_t stage, uint32_t slot) {
+  ULONG job;
+
+  if (stage == pipeline->stage_nb) {
+    APP_REQUIRE_EQ(tx_semaphore_put(&pipeline->free_sem), TX_SUCCESS);
+    return;
+  }
+  /* Never full: the lane holds at most every slot of every pipeline */
+  job = JOBS_PACK(pipeline->id, stage, slot);
+  APP_REQUIRE_EQ(tx_queue_send(&jobs_ctx.lanes[pipeline->stages[stage].engine].queue, &job, TX_NO_WAIT),
+                 TX_SUCCESS);
+}
+
+/**
+ * @brief  Lane thread: run the stages of one engine in the order queued
+ * @param  engine: jobs_engine_t of the lane
+ */
+static void Jobs_LaneEntry(ULONG engine) {
+  jobs_lane_t *lane = &jobs_ctx.lanes[engine];
+
+  while (1) {
+    jobs_pipeline_t *pipeline;
+    uint32_t stage, slot;
+    ULONG job;
+
+    APP_REQUIRE_EQ(tx_queue_receive(&lane->queue, &job, TX_WAIT_FOREVER), TX_SUCCESS);
+    pipeline = jobs_ctx.pipelines[JOBS_PIPELINE(job)];
+    stage = JOBS_STAGE(job);
+    slot = JOBS_SLOT(job);
+
+    pipeline->stages[stage].run(slot);
+    Jobs_Post(pipeline, stage + 1U, slot);
+  }
+}
+
+/**
+ * @brief  Create and start the lane of an engine, once
+ */
+static void Jobs_StartLane(jobs_engine_t engine) {
+  jobs_lane_t *lane = &jobs_ctx.lanes[engine];
+
+  if (lane->started) {
+    return;
+  }
+  APP_REQUIRE_EQ(tx_queue_create(&lane->queue, (CHAR *)jobs_lane_names[engine], TX_1_ULONG, lane->queue_storage,
+                                 sizeof(lane->queue_storage)),
+                 TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&lane->thread, (CHAR *)jobs_lane_names[engine],
+                                  Jobs_LaneEntry, (ULONG)engine,
+                                  lane->stack, JOBS_LANE_STACK_SIZE,
+                                  JOBS_LANE_PRIORITY, JOBS_LANE_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+  lane->started = 1;
+}
+
+void Jobs_Register(jobs_pipeline_t *pipeline) {
+  APP_REQUIRE(pipeline != NULL && pipeline->stages != NULL);
+  APP_REQUIRE(pipeline->stage_nb > 0 && pipeline->stage_nb <= JOBS_STAGES_MAX);
+  APP_REQUIRE(pipeline->slot_nb > 0 && pipeline->slot_nb <= JOBS_SLOTS_MAX);
+  APP_REQUIRE(jobs_ctx.pipeline_nb < JOBS_PIPELINES_MAX);
+
+  for (uint32_t i = 0; i < pipeline->stage_nb; i++) {
+    APP_REQUIRE((unsigned)pipeline->stages[i].engine < JOBS_ENGINE_NB && pipeline->stages[i].run != NULL);
+  }
+
+  APP_REQUIRE_EQ(tx_semaphore_create(&pipeline->free_sem, (CHAR *)pipeline->name, pipeline->slot_nb), TX_SUCCESS);
+  pipeline->next_slot = 0;
+  pipeline->id = (uint8_t)jobs_ctx.pipeline_nb;
+  jobs_ctx.pipelines[jobs_ctx.pipeline_nb++] = pipeline;
+
+  for (uint32_t i = 0; i < pipeline->stage_nb; i++) {
+    Jobs_StartLane(pipeline->stages[i].engine);
+  }
+}
+
+int Jobs_Acquire(jobs_pipeline_t *pipeline, uint32_t *slot, ULONG wait_ticks) {
+  APP_REQUIRE(pipeline != NULL && slot != NULL);
+
+  if (tx_semaphore_get(&pipeline->free_sem, wait_ticks) != TX_SUCCESS) {
+    return 0;
+  }
+  /* Slots leave the last stage in the order they entered the first */
+  *slot = pipeline->next_slot;
+  pipeline->next_slot = (pipeline->next_slot + 1U) % pipeline->slot_nb;
+  return 1;
+}
+
+void Jobs_Submit(jobs_pipeline_t *pipeline, uint32_t slot) {
+  APP_REQUIRE(pipeline != NULL && slot < pipeline->slot_nb);
+
+  Jobs_Post(pipeline, 0, slot);
+}
@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * @file    app_latency.c
+ * @author  Long Liangmao
+ * @brief   End-to-end pipeline latency histograms implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_latency.h"
+
+#if LATENCY_PROFILER
+
+#include "app_pipebench.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <string.h>
+
+/* Per-stage accumulator (microseconds) */
+typedef struct {
+  uint16_t bins[LATENCY_HIST_BINS];
+  uint32_t sum;
+  uint32_t max;
+} latency_acc_t;
+
+/* Recorded and read by the UI thread only: no locking */
+static struct {
+  latency_acc_t window[LATENCY_STAGE_NB];
+  uint32_t window_frames;
+  latency_acc_t published[LATENCY_STAGE_NB];
+  uint32_t published_frames;
+  uint32_t last_frame_count; /* Result already recorded */
+} lat_ctx;
+
+/**
+ * @brief  Convert a DWT cycle delta to microseconds
+ */
+static uint32_t Latency_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief  Fold one sample into a stage accumulator
+ */
+static void Latency_Add(latency_acc_t *acc, uint32_t us) {
+  uint32_t q = us / LATENCY_BIN0_US;
+  uint32_t bin = (q == 0) ? 0 : 31U - __CLZ(q);
+
+  acc->bins[MIN(bin, LATENCY_HIST_BINS - 1U)]++;
+  acc->sum += us;
+  if (us > acc->max) {
+    acc->max = us;
+  }
+}
+
+/**
+ * @brief  Record the stage latencies of a result once its overlay is scanned out
+ */
+void Latency_RecordScanout(const nn_result_t *result, uint32_t scanout_cycles) {
+  uint32_t stage_us[LATENCY_STAGE_NB];
+
+  if (result->frame_count == 0 || result->frame_count == lat_ctx.last_frame_count) {
+    return;
+  }
+  lat_ctx.last_frame_count = result->frame_count;
+
+  stage_us[LATENCY_STAGE_CAPTURE_NPU] = Latency_CyclesToUs(result->npu_done_cycles - result->vsync_cycles);
+  stage_us[LATENCY_STAGE_NPU_POST] = Latency_CyclesToUs(result->post_done_cycles - result->npu_done_cycles);
+  stage_us[LATENCY_STAGE_POST_SCANOUT] = Latency_CyclesToUs(scanout_cycles - result->post_done_cycles);
+  for (int s = 0; s < LATENCY_STAGE_NB; s++) {
+    Latency_Add(&lat_ctx.window[s], stage_us[s]);
+  }
+#if PIPE_BENCH
+  PipeBench_Record(stage_us);
+#endif
+
+  if (++lat_ctx.window_frames < LATENCY_WINDOW_FRAMES) {
+    return;
+  }
+
+  memcpy(lat_ctx.published, lat_ctx.window, sizeof(lat_ctx.published));
+  lat_ctx.published_frames = lat_ctx.window_frames;
+  memset(lat_ctx.window, 0, sizeof(lat_ctx.window));
+  lat_ctx.window_frames = 0;
+}
+
+/**
+ * @brief  Get the histograms of the last published window
+ */
+uint32_t Latency_GetHistograms(latency_hist_t hist[LATENCY_STAGE_NB]) {
+  if (lat_ctx.published_frames == 0) {
+    return 0;
+  }
+
+  for (int s = 0; s < LATENCY_STAGE_NB; s++) {
+    memcpy(hist[s].bins, lat_ctx.published[s].bins, sizeof(hist[s].bins));
+    hist[s].avg_us = lat_ctx.published[s].sum / lat_ctx.published_frames;
+    hist[s].max_us = lat_ctx.published[s].max;
+  }
+
+  return lat_ctx.published_frames;
+}
+
+/**
+ * @brief  Reset the histograms
+ */
+void Latency_Init(void) {
+  memset(&lat_ctx, 0, sizeof(lat_ctx));
+}
+
+#endif /* LATENCY_PROFILER */
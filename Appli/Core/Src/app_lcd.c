@@ -3,8 +3,9 @@
  * @file    app_lcd.c
  * @author  Long Liangmao
  * @brief   LTDC display pipeline implementation for STM32N6570-DK
- *          Layer 0: Live DCMI/camera preview (RGB565)
- *          Layer 1: UI (ARGB8888 with alpha blending)
+ *          Layer 0: Live DCMI/camera preview (RGB565, or the Pipe2 RGB888
+ *                   frames with DISPLAY_SINGLE_PIPE)
+ *          Layer 1: UI (ARGB8888 or ARGB4444 with alpha blending)
  ******************************************************************************
  * @attention
  *
@@ -19,10 +20,88 @@
  */
 
 #include "app_lcd.h"
+#include "app_boottime.h"
 #include "app_buffers.h"
 #include "app_error.h"
+#include "app_irq.h"
+#include "app_trace.h"
 #include "stm32_lcd.h"
 #include "stm32n6570_discovery_lcd.h"
+#include "tx_api.h"
+#include "utils.h"
+
+#if LCD_ERROR_MONITOR && NN_EPOCH_PROFILER
+#include "app_profiler.h"
+#endif
+
+/* Staged state is committed this many lines before the vertical blanking
+ * latches it: shadow registers may be written at any point of the active
+ * area, the margin only has to cover the interrupt latency */
+#define LCD_COMMIT_LEAD_LINES 16U
+
+/* Upper bound for a staged UI address to reach the screen (a few frames) */
+#define LCD_SHOWN_TIMEOUT_MS 100U
+
+#define LCD_LAYER_NB 2U
+
+#if DISPLAY_SINGLE_PIPE
+#if ML_GRAYSCALE || ML_YUV422
+#error "DISPLAY_SINGLE_PIPE scans out the RGB888 Pipe2 frames"
+#endif
+#if ML_WIDTH > DISPLAY_LETTERBOX_WIDTH || ML_HEIGHT > DISPLAY_LETTERBOX_HEIGHT
+#error "DISPLAY_SINGLE_PIPE shows the ML frame 1:1 inside the letterbox"
+#endif
+/* ML frame centered in the letterbox, where the UI draws the ML square */
+#define LCD_CAMERA_X0 (DISPLAY_LETTERBOX_X0 + (DISPLAY_LETTERBOX_WIDTH - ML_WIDTH) / 2)
+#define LCD_CAMERA_Y0 ((DISPLAY_LETTERBOX_HEIGHT - ML_HEIGHT) / 2)
+#endif
+
+#define LCD_EVENT_SHOWN (1U << 0) /* A vblank latched committed layer state */
+
+/**
+ * @brief  Layer state staged for the next vblank
+ * @note   Single-word items (address, alpha, visibility) are lock-free: the
+ *         owner writes the value, then raises its pending flag; the commit
+ *         drops the flag before reading the value, so an update racing with
+ *         it is applied now or at the next frame, never lost. The window and
+ *         color key span several words and are staged with interrupts
+ *         masked; they are configuration, never per frame
+ */
+typedef struct {
+  volatile uint32_t address;
+  volatile uint8_t alpha;
+  volatile uint8_t visible;
+  uint16_t window[4];   /* x, y, width, height */
+  uint32_t color_key;   /* RGB888 */
+  uint8_t color_keying; /* 0 = disabled */
+
+  volatile uint8_t address_pending;
+  volatile uint8_t alpha_pending;
+  volatile uint8_t visible_pending;
+  volatile uint8_t window_pending;
+  volatile uint8_t color_key_pending;
+
+  /* Buffer geometry, fixed at init */
+  uint16_t origin[2]; /* Screen position of the buffer's first pixel */
+  uint32_t pitch;     /* Bytes per buffer row */
+  uint32_t bpp;
+
+  /* Commit and reload interrupts only */
+  uint32_t committed_address;
+  uint8_t committed_pending;       /* Address written, not latched yet */
+  volatile uint32_t shown_address; /* Address latched by the last reload */
+  volatile uint32_t shown_cycles;  /* DWT stamp of that reload */
+} lcd_layer_stage_t;
+
+static struct {
+  lcd_layer_stage_t layers[LCD_LAYER_NB];
+  TX_EVENT_FLAGS_GROUP events;
+  uint32_t commit_line;
+  uint8_t reload_pending;
+#if LCD_ERROR_MONITOR
+  lcd_error_stats_t errors; /* LTDC interrupt only */
+#endif
+} lcd_ctx;
 
 static uint8_t lcd_initialized = 0;
 
@@ -33,11 +112,14 @@ static uint8_t lcd_initialized = 0;
  * @param  x1, y1: Bottom-right corner
  * @param  format: Pixel format
  * @param  buffer: Frame buffer address
+ * @param  desc: Descriptor of the buffers the layer scans out
  * @note   Fail-fast: panics on unrecoverable failures
  */
 static void LCD_ConfigLayer(uint32_t layer, uint16_t x0, uint16_t y0,
                             uint16_t x1, uint16_t y1,
-                            uint32_t format, void *buffer) {
+                            uint32_t format, void *buffer,
+                            const buffer_desc_t *desc) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[layer];
   BSP_LCD_LayerConfig_t config = {
       .X0 = x0,
       .Y0 = y0,
@@ -48,13 +130,252 @@ static void LCD_ConfigLayer(uint32_t layer, uint16_t x0, uint16_t y0,
   };
 
   APP_REQUIRE(BSP_LCD_ConfigLayer(0, layer, &config) == BSP_ERROR_NONE);
+
+  /* Staged state starts as what the BSP programmed */
+  stage->address = (uint32_t)buffer;
+  stage->committed_address = (uint32_t)buffer;
+  stage->shown_address = (uint32_t)buffer;
+  stage->visible = 1;
+  stage->window[0] = x0;
+  stage->window[1] = y0;
+  stage->window[2] = x1 - x0;
+  stage->window[3] = y1 - y0;
+  stage->origin[0] = x0;
+  stage->origin[1] = y0;
+  stage->pitch = desc->pitch;
+  stage->bpp = desc->bpp;
+}
+
+#if DISPLAY_SINGLE_PIPE
+/**
+ * @brief  Switch a layer configured as RGB888 to the R, G, B byte order the
+ *         DCMIPP Pipe2 byte swap writes
+ * @param  layer: Layer index
+ * @note   Fail-fast: panics on unrecoverable failures. Later window changes
+ *         keep the flexible format: the HAL leaves its registers alone
+ */
+static void LCD_ConfigLayerRGBOrder(uint32_t layer) {
+  const LTDC_LayerCfgTypeDef *cfg = &hlcd_ltdc.LayerCfg[layer];
+  LTDC_LayerFlexARGBTypeDef flex = {0};
+
+  /* Window and composition as the BSP programmed them */
+  flex.Layer.WindowX0 = cfg->WindowX0;
+  flex.Layer.WindowX1 = cfg->WindowX1;
+  flex.Layer.WindowY0 = cfg->WindowY0;
+  flex.Layer.WindowY1 = cfg->WindowY1;
+  flex.Layer.Alpha = cfg->Alpha;
+  flex.Layer.Alpha0 = cfg->Alpha0;
+  flex.Layer.BlendingFactor1 = cfg->BlendingFactor1;
+  flex.Layer.BlendingFactor2 = cfg->BlendingFactor2;
+  flex.Layer.ImageWidth = cfg->ImageWidth;
+  flex.Layer.ImageHeight = cfg->ImageHeight;
+  flex.Layer.Backcolor = cfg->Backcolor;
+  flex.ARGBAddress = cfg->FBStartAdress;
+  flex.FlexARGB.PixelSize = LTDC_ARGB_PIXEL_SIZE_3_BYTES;
+  flex.FlexARGB.RedPos = 0U;
+  flex.FlexARGB.GreenPos = 8U;
+  flex.FlexARGB.BluePos = 16U;
+  flex.FlexARGB.RedWidth = 8U;
+  flex.FlexARGB.GreenWidth = 8U;
+  flex.FlexARGB.BlueWidth = 8U;
+
+  APP_REQUIRE_EQ(HAL_LTDC_ConfigLayerFlexARGB(&hlcd_ltdc, &flex, layer), HAL_OK);
+}
+#endif
+
+/**
+ * @brief  Write one layer's staged state to the LTDC shadow registers
+ * @param  layer: Layer index
+ * @retval 1 if a register changed, 0 otherwise
+ * @note   LTDC interrupt. The per-frame items are single register writes;
+ *         only a window change goes through the HAL, which rebuilds every
+ *         register of the layer from the handle, so the handle is kept in
+ *         sync and the other items are re-applied after it
+ */
+static uint32_t LCD_CommitLayer(uint32_t layer) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[layer];
+  LTDC_LayerCfgTypeDef *cfg = &hlcd_ltdc.LayerCfg[layer];
+  LTDC_Layer_TypeDef *regs = LTDC_LAYER(&hlcd_ltdc, layer);
+  uint32_t rebuilt = 0;
+  uint32_t changed = 0;
+
+  if (stage->window_pending) {
+    stage->window_pending = 0;
+    APP_REQUIRE_EQ(HAL_LTDC_SetWindowSize_NoReload(&hlcd_ltdc, stage->window[2], stage->window[3], layer),
+                   HAL_OK);
+    APP_REQUIRE_EQ(HAL_LTDC_SetWindowPosition_NoReload(&hlcd_ltdc, stage->window[0], stage->window[1], layer),
+                   HAL_OK);
+    /* The window is a view into the full buffer: keep its row pitch */
+    APP_REQUIRE_EQ(HAL_LTDC_SetPitch_NoReload(&hlcd_ltdc, stage->pitch / stage->bpp, layer), HAL_OK);
+    rebuilt = 1;
+  }
+
+  if (stage->address_pending || rebuilt) {
+    uint32_t address;
+
+    stage->address_pending = 0;
+    address = stage->address;
+
+    /* Fetch starts at the window's first pixel: buffer and screen
+     * coordinates keep coinciding */
+    cfg->FBStartAdress = address + (stage->window[1] - stage->origin[1]) * stage->pitch +
+                         (stage->window[0] - stage->origin[0]) * stage->bpp;
+    WRITE_REG(regs->CFBAR, cfg->FBStartAdress);
+    stage->committed_address = address;
+    stage->committed_pending = 1;
+    changed = 1;
+  }
+
+  if (stage->alpha_pending) {
+    stage->alpha_pending = 0;
+    cfg->Alpha = stage->alpha;
+    WRITE_REG(regs->CACR, cfg->Alpha);
+    changed = 1;
+  }
+
+  if (stage->visible_pending || rebuilt) {
+    stage->visible_pending = 0;
+    if (stage->visible) {
+      __HAL_LTDC_LAYER_ENABLE(&hlcd_ltdc, layer);
+    } else {
+      __HAL_LTDC_LAYER_DISABLE(&hlcd_ltdc, layer);
+    }
+    changed = 1;
+  }
+
+  if (stage->color_key_pending) {
+    stage->color_key_pending = 0;
+    WRITE_REG(regs->CKCR, stage->color_key & (LTDC_LxCKCR_CKBLUE | LTDC_LxCKCR_CKGREEN | LTDC_LxCKCR_CKRED));
+    if (stage->color_keying) {
+      SET_BIT(regs->CR, LTDC_LxCR_CKEN);
+    } else {
+      CLEAR_BIT(regs->CR, LTDC_LxCR_CKEN);
+    }
+    changed = 1;
+  }
+
+  return changed;
+}
+
+/**
+ * @brief  LTDC line event: commit the staged state of both layers, latched
+ *         together by one reload at the coming vertical blanking
+ */
+void HAL_LTDC_LineEventCallback(LTDC_HandleTypeDef *hltdc) {
+  uint32_t changed = 0;
+
+  for (uint32_t layer = 0; layer < LCD_LAYER_NB; layer++) {
+    changed |= LCD_CommitLayer(layer);
+  }
+
+  if (changed) {
+    lcd_ctx.reload_pending = 1;
+    APP_REQUIRE_EQ(HAL_LTDC_Reload(hltdc, LTDC_RELOAD_VERTICAL_BLANKING), HAL_OK);
+  }
+
+  /* The HAL disarms the line event on every hit */
+  APP_REQUIRE_EQ(HAL_LTDC_ProgramLineEvent(hltdc, lcd_ctx.commit_line), HAL_OK);
+
+#if LCD_ERROR_MONITOR
+  /* The HAL disarms them too: one event per frame at most */
+  __HAL_LTDC_ENABLE_IT(hltdc, LTDC_IT_FU | LTDC_IT_TE);
+#endif
+}
+
+#if LCD_ERROR_MONITOR
+/**
+ * @brief  LTDC FIFO underrun or transfer error: count it with what the
+ *         NPU and DCMIPP were doing
+ * @note   The layers keep scanning out; only the HAL error state is reset
+ */
+void HAL_LTDC_ErrorCallback(LTDC_HandleTypeDef *hltdc) {
+  lcd_error_stats_t *errors = &lcd_ctx.errors;
+  uint32_t pipes = CAM_GetCapturingPipes();
+
+  if (hltdc->ErrorCode & HAL_LTDC_ERROR_FU) {
+    errors->underruns++;
+  }
+  if (hltdc->ErrorCode & HAL_LTDC_ERROR_TE) {
+    errors->transfer_errors++;
+  }
+
+#if NN_EPOCH_PROFILER
+  errors->last_epoch = Profiler_GetRunningEpoch();
+#endif
+  if (errors->last_epoch >= 0) {
+    errors->during_npu++;
+  }
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    if (pipes & (1U << i)) {
+      errors->during_pipe[i]++;
+    }
+  }
+  errors->last_cycles = DWT->CYCCNT;
+
+  hltdc->ErrorCode = HAL_LTDC_ERROR_NONE;
+  hltdc->State = HAL_LTDC_STATE_READY;
+}
+
+/**
+ * @brief  Copy the LTDC error counters
+ */
+void LCD_GetErrorStats(lcd_error_stats_t *stats) {
+  uint32_t basepri;
+
+  basepri = Irq_Lock(LCD_IRQ_PRIORITY);
+  *stats = lcd_ctx.errors;
+  Irq_Unlock(basepri);
+}
+#endif
+
+/**
+ * @brief  LTDC register reload: the committed state is now on screen, the
+ *         buffers it replaced go back to their producers
+ */
+void HAL_LTDC_ReloadEventCallback(LTDC_HandleTypeDef *hltdc) {
+  uint32_t now = DWT->CYCCNT;
+
+  UNUSED(hltdc);
+
+  if (!lcd_ctx.reload_pending) {
+    return;
+  }
+  lcd_ctx.reload_pending = 0;
+  TRACE_INSTANT(LTDC_RELOAD, 0);
+
+  for (uint32_t layer = 0; layer < LCD_LAYER_NB; layer++) {
+    lcd_layer_stage_t *stage = &lcd_ctx.layers[layer];
+
+    if (!stage->committed_pending) {
+      continue;
+    }
+    stage->committed_pending = 0;
+    stage->shown_cycles = now;
+    stage->shown_address = stage->committed_address;
+
+    /* Both rings free the buffers the latched one replaced */
+    if (layer == LCD_LAYER_0_CAMERA) {
+      BOOT_MARK_FIRST(BOOT_PHASE_FIRST_FRAME);
+      Buffer_CameraDisplay_Shown((const uint8_t *)stage->shown_address);
+    } else {
+      Buffer_UIDisplay_Shown((const uint8_t *)stage->shown_address);
+    }
+  }
+  tx_event_flags_set(&lcd_ctx.events, LCD_EVENT_SHOWN, TX_OR);
+}
+
+/**
+ * @brief  LTDC interrupt handler (call from the LTDC global IRQ handlers)
+ */
+void LCD_IRQHandler(void) {
+  HAL_LTDC_IRQHandler(&hlcd_ltdc);
 }
 
 /**
  * @brief  Initialize LTDC with dual-layer configuration
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_Init(void) {
+IN_XIP void LCD_Init(void) {
   uint8_t *camera_buf, *ui_buf;
 
   if (lcd_initialized) {
@@ -65,21 +386,43 @@ void LCD_Init(void) {
                              LCD_PIXEL_FORMAT_RGB565,
                              LCD_WIDTH, LCD_HEIGHT) == BSP_ERROR_NONE);
 
-  /* Configure Layer 0: Camera preview (letterboxed) */
+#if DISPLAY_SINGLE_PIPE
+  /* Configure Layer 0: Pipe2 frames, 1:1 at the ML square of the letterbox;
+   * the bars around it are the LTDC background. Same non-cacheable ring the
+   * NPU reads; until the first frame completes the layer shows the slot
+   * being captured */
+  camera_buf = Buffer_GetMLCaptureBuffer(0);
+  APP_REQUIRE(camera_buf != NULL);
+  APP_REQUIRE(!Buffer_GetDesc(BUFFER_ID_ML_CAPTURE)->cacheable);
+  LCD_ConfigLayer(LCD_LAYER_0_CAMERA,
+                  LCD_CAMERA_X0, LCD_CAMERA_Y0,
+                  LCD_CAMERA_X0 + ML_WIDTH, LCD_CAMERA_Y0 + ML_HEIGHT,
+                  LCD_PIXEL_FORMAT_RGB888, camera_buf,
+                  Buffer_GetDesc(BUFFER_ID_ML_CAPTURE));
+  LCD_ConfigLayerRGBOrder(LCD_LAYER_0_CAMERA);
+#else
+  /* Configure Layer 0: Camera preview (letterboxed). DCMIPP writes and LTDC
+   * reads the ring through a non-cacheable mapping: no per-frame maintenance */
   camera_buf = Buffer_GetCameraDisplayBuffer(0);
   APP_REQUIRE(camera_buf != NULL);
+  APP_REQUIRE(!Buffer_GetDesc(BUFFER_ID_CAMERA_DISPLAY)->cacheable);
   LCD_ConfigLayer(LCD_LAYER_0_CAMERA,
                   DISPLAY_LETTERBOX_X0, 0,
                   DISPLAY_LETTERBOX_X1, LCD_HEIGHT,
-                  LCD_PIXEL_FORMAT_RGB565, camera_buf);
+                  LCD_PIXEL_FORMAT_RGB565, camera_buf,
+                  Buffer_GetDesc(BUFFER_ID_CAMERA_DISPLAY));
+#endif
 
-  /* Configure Layer 1: UI overlay (top half) */
+  /* Configure Layer 1: UI overlay (panel column + ML frame square). Pixels
+   * right of the window are never fetched; the window starts at x = 0 so
+   * layer and screen coordinates coincide */
   ui_buf = Buffer_GetUIFrontBuffer();
   APP_REQUIRE(ui_buf != NULL);
   LCD_ConfigLayer(LCD_LAYER_1_UI,
                   0, 0,
-                  LCD_WIDTH, LCD_HEIGHT / 2,
-                  LCD_PIXEL_FORMAT_ARGB8888, ui_buf);
+                  UI_LAYER_WIDTH, UI_LAYER_HEIGHT,
+                  UI_LAYER_FORMAT, ui_buf,
+                  Buffer_GetDesc(BUFFER_ID_UI_DISPLAY));
 
   /* Enable layers, set UI transparent initially */
   BSP_LCD_SetLayerVisible(0, LCD_LAYER_0_CAMERA, ENABLE);
@@ -90,6 +433,23 @@ void LCD_Init(void) {
 
   UTIL_LCD_SetFuncDriver(&LCD_Driver);
 
+  /* From here on the LTDC registers are only written by the line event:
+   * every later layer change is staged and committed once per frame */
+  APP_REQUIRE_EQ(tx_event_flags_create(&lcd_ctx.events, "lcd_events"), TX_SUCCESS);
+  lcd_ctx.commit_line = hlcd_ltdc.Init.AccumulatedActiveH - LCD_COMMIT_LEAD_LINES;
+  APP_REQUIRE_EQ(HAL_LTDC_ProgramLineEvent(&hlcd_ltdc, lcd_ctx.commit_line), HAL_OK);
+#if LCD_ERROR_MONITOR
+  lcd_ctx.errors.last_epoch = -1;
+  __HAL_LTDC_ENABLE_IT(&hlcd_ltdc, LTDC_IT_FU | LTDC_IT_TE);
+#endif
+
+  /* Both global lines reach the HAL handler, which reads the interrupt
+   * register set of the security state it runs in */
+  HAL_NVIC_SetPriority(LTDC_LO_IRQn, LCD_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(LTDC_LO_IRQn);
+  HAL_NVIC_SetPriority(LTDC_UP_IRQn, LCD_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(LTDC_UP_IRQn);
+
   lcd_initialized = 1;
 }
 
@@ -98,100 +458,186 @@ void LCD_Init(void) {
  */
 void LCD_DeInit(void) {
   if (lcd_initialized) {
+    HAL_NVIC_DisableIRQ(LTDC_LO_IRQn);
+    HAL_NVIC_DisableIRQ(LTDC_UP_IRQn);
+    __HAL_LTDC_DISABLE_IT(&hlcd_ltdc, LTDC_IT_LI | LTDC_IT_RR | LTDC_IT_FU | LTDC_IT_TE);
     BSP_LCD_DisplayOff(0);
     BSP_LCD_DeInit(0);
+    tx_event_flags_delete(&lcd_ctx.events);
     lcd_initialized = 0;
   }
 }
 
 /**
- * @brief  Reload Layer 0 (Camera) with new buffer address (buffering)
+ * @brief  Stage a layer's buffer address
+ */
+static void LCD_StageAddress(uint32_t layer, uint8_t *frame_buffer) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[layer];
+
+  APP_REQUIRE(lcd_initialized);
+  APP_REQUIRE(frame_buffer != NULL);
+
+  stage->address = (uint32_t)frame_buffer;
+  stage->address_pending = 1;
+}
+
+/**
+ * @brief  Show a new Layer 0 (Camera) buffer from the next vblank
  * @param  frame_buffer: Pointer to the next display buffer
  * @note   Fail-fast: panics on unrecoverable failures
  */
 void LCD_ReloadCameraLayer(uint8_t *frame_buffer) {
-  HAL_StatusTypeDef status;
-  
+  LCD_StageAddress(LCD_LAYER_0_CAMERA, frame_buffer);
+}
+
+/**
+ * @brief  Show a new Layer 1 (UI) buffer from the next vblank
+ * @param  frame_buffer: Pointer to the next UI display buffer
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void LCD_ReloadUILayer(uint8_t *frame_buffer) {
+  LCD_StageAddress(LCD_LAYER_1_UI, frame_buffer);
+}
+
+/**
+ * @brief  Block until the last buffer passed to LCD_ReloadUILayer() is
+ *         scanned out
+ * @retval DWT cycle stamp of the vblank that latched it
+ * @note   Fail-fast: panics if no vblank latches it within a few frames
+ */
+uint32_t LCD_WaitUILayerShown(void) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[LCD_LAYER_1_UI];
+  ULONG timeout = (LCD_SHOWN_TIMEOUT_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U;
+  ULONG events;
+
   APP_REQUIRE(lcd_initialized);
-  APP_REQUIRE(frame_buffer != NULL);
 
-  SCB_CleanDCache_by_Addr((void *)frame_buffer,
-                          DISPLAY_LETTERBOX_WIDTH * DISPLAY_LETTERBOX_HEIGHT * DISPLAY_BPP);
+  while (stage->shown_address != stage->address) {
+    APP_REQUIRE_EQ(tx_event_flags_get(&lcd_ctx.events, LCD_EVENT_SHOWN, TX_OR_CLEAR, &events, timeout),
+                   TX_SUCCESS);
+  }
 
-  status = HAL_LTDC_SetAddress_NoReload(&hlcd_ltdc, (uint32_t)frame_buffer,
-                                        LCD_LAYER_0_CAMERA);
-  APP_REQUIRE_EQ(status, HAL_OK);
+  return stage->shown_cycles;
+}
 
-  status = HAL_LTDC_ReloadLayer(&hlcd_ltdc, LTDC_RELOAD_VERTICAL_BLANKING,
-                                LCD_LAYER_0_CAMERA);
-  APP_REQUIRE_EQ(status, HAL_OK);
+/**
+ * @brief  Get the UI buffer the last vblank latched, without waiting
+ */
+const uint8_t *LCD_GetUILayerShown(uint32_t *shown_cycles) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[LCD_LAYER_1_UI];
+  uint32_t address;
+
+  /* The reload ISR writes the stamp first: a pair read around it is retried */
+  do {
+    address = stage->shown_address;
+    *shown_cycles = stage->shown_cycles;
+  } while (address != stage->shown_address);
+
+  return (const uint8_t *)address;
 }
 
 /**
- * @brief  Set UI layer buffer address for drawing (without reloading display)
- * @param  frame_buffer: Pointer to the buffer to draw to
+ * @brief  Write back and invalidate a rectangle of a UI buffer in the D-cache
+ * @param  frame_buffer: UI buffer (UI_LAYER_FORMAT, UI_LAYER_WIDTH stride)
+ * @param  x: Left column
+ * @param  y: Top row
+ * @param  width: Width in pixels
+ * @param  height: Height in rows
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_SetUILayerAddress(uint8_t *frame_buffer) {
-  HAL_StatusTypeDef status;
-  
-  APP_REQUIRE(lcd_initialized);
+void LCD_FlushUIRegion(uint8_t *frame_buffer, uint32_t x, uint32_t y,
+                       uint32_t width, uint32_t height) {
+  const buffer_desc_t *desc = Buffer_GetDesc(BUFFER_ID_UI_DISPLAY);
+  const uint32_t bpp = desc->bpp;
+
   APP_REQUIRE(frame_buffer != NULL);
+  APP_REQUIRE(x + width <= desc->width && y + height <= desc->height);
+
+  if (!desc->cacheable) {
+    return;
+  }
+
+  if (width == desc->width) {
+    SCB_CleanInvalidateDCache_by_Addr((void *)(frame_buffer + y * desc->pitch),
+                                      (int32_t)(height * desc->pitch));
+    return;
+  }
 
-  __disable_irq();
-  status = HAL_LTDC_SetAddress_NoReload(&hlcd_ltdc, (uint32_t)frame_buffer,
-                                        LCD_LAYER_1_UI);
-  __enable_irq();
-  APP_REQUIRE_EQ(status, HAL_OK);
+  for (uint32_t row = y; row < y + height; row++) {
+    SCB_CleanInvalidateDCache_by_Addr((void *)(frame_buffer + row * desc->pitch + x * bpp),
+                                      (int32_t)(width * bpp));
+  }
 }
 
 /**
- * @brief  Reload Layer 1 (UI) with new buffer address (buffering)
- * @param  frame_buffer: Pointer to the next UI display buffer
+ * @brief  Set Layer 1 (UI) transparency from the next vblank
+ * @param  alpha: 0 = transparent, 255 = opaque
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_ReloadUILayer(uint8_t *frame_buffer) {
-  HAL_StatusTypeDef status;
-  
+void LCD_SetUIAlpha(uint8_t alpha) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[LCD_LAYER_1_UI];
+
   APP_REQUIRE(lcd_initialized);
-  APP_REQUIRE(frame_buffer != NULL);
 
-  SCB_CleanDCache_by_Addr((void *)frame_buffer, LCD_WIDTH * LCD_HEIGHT * 4);
+  stage->alpha = alpha;
+  stage->alpha_pending = 1;
+}
+
+/**
+ * @brief  Restrict Layer 1 (UI) fetches to a rectangle, from the next vblank
+ * @param  x, y: Top-left corner
+ * @param  width, height: Size
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void LCD_SetUIWindow(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[LCD_LAYER_1_UI];
+  TX_INTERRUPT_SAVE_AREA
 
-  __disable_irq();
-  status = HAL_LTDC_SetAddress_NoReload(&hlcd_ltdc, (uint32_t)frame_buffer,
-                                        LCD_LAYER_1_UI);
-  __enable_irq();
-  APP_REQUIRE_EQ(status, HAL_OK);
+  APP_REQUIRE(lcd_initialized);
+  APP_REQUIRE(width > 0 && height > 0);
+  APP_REQUIRE(x + width <= UI_LAYER_WIDTH && y + height <= UI_LAYER_HEIGHT);
 
-  __disable_irq();
-  status = HAL_LTDC_ReloadLayer(&hlcd_ltdc, LTDC_RELOAD_VERTICAL_BLANKING,
-                                LCD_LAYER_1_UI);
-  __enable_irq();
-  APP_REQUIRE_EQ(status, HAL_OK);
+  TX_DISABLE
+  stage->window[0] = x;
+  stage->window[1] = y;
+  stage->window[2] = width;
+  stage->window[3] = height;
+  stage->window_pending = 1;
+  TX_RESTORE
 }
 
 /**
- * @brief  Set Layer 1 (UI) transparency
- * @param  alpha: 0 = transparent, 255 = opaque
+ * @brief  Set or clear the Layer 1 (UI) color key, from the next vblank
+ * @param  enable: 1 to enable, 0 to disable
+ * @param  rgb: Key color (RGB888)
  * @note   Fail-fast: panics on unrecoverable failures
  */
-void LCD_SetUIAlpha(uint8_t alpha) {
+void LCD_SetUIColorKey(uint8_t enable, uint32_t rgb) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[LCD_LAYER_1_UI];
+  TX_INTERRUPT_SAVE_AREA
+
   APP_REQUIRE(lcd_initialized);
-  APP_REQUIRE(BSP_LCD_SetTransparency(0, LCD_LAYER_1_UI, alpha) == BSP_ERROR_NONE);
-  APP_REQUIRE(BSP_LCD_Reload(0, BSP_LCD_RELOAD_VERTICAL_BLANKING) == BSP_ERROR_NONE);
+
+  TX_DISABLE
+  stage->color_key = rgb;
+  stage->color_keying = enable ? 1 : 0;
+  stage->color_key_pending = 1;
+  TX_RESTORE
 }
 
 /**
- * @brief  Set layer visibility
+ * @brief  Set layer visibility from the next vblank
  * @param  layer: Layer index
  * @param  enable: 1 to enable, 0 to disable
  * @note   Fail-fast: panics on unrecoverable failures
  */
 static void LCD_SetLayerVisible(uint32_t layer, uint8_t enable) {
+  lcd_layer_stage_t *stage = &lcd_ctx.layers[layer];
+
   APP_REQUIRE(lcd_initialized);
-  APP_REQUIRE(BSP_LCD_SetLayerVisible(0, layer, enable ? ENABLE : DISABLE) == BSP_ERROR_NONE);
-  APP_REQUIRE(BSP_LCD_Reload(0, BSP_LCD_RELOAD_VERTICAL_BLANKING) == BSP_ERROR_NONE);
+
+  stage->visible = enable ? 1 : 0;
+  stage->visible_pending = 1;
 }
 
 /**
@@ -211,13 +657,3 @@ void LCD_SetUILayerVisible(uint8_t enable) {
 void LCD_SetCameraLayerVisible(uint8_t enable) {
   LCD_SetLayerVisible(LCD_LAYER_0_CAMERA, enable);
 }
-
-/**
- * @brief  Trigger LTDC reload
- * @param  reload_type: BSP_LCD_RELOAD_IMMEDIATE or BSP_LCD_RELOAD_VERTICAL_BLANKING
- * @note   Fail-fast: panics on unrecoverable failures
- */
-void LCD_Reload(uint32_t reload_type) {
-  APP_REQUIRE(lcd_initialized);
-  APP_REQUIRE(BSP_LCD_Reload(0, reload_type) == BSP_ERROR_NONE);
-}
@@ -0,0 +1,252 @@
+/**
+ ******************************************************************************
+ * @file    app_membench.c
+ * @author  Long Liangmao
+ * @brief   External memory self-test for STM32N6570-DK
+ *          Throughput and latency of the xSPI1 PSRAM and the xSPI2 octoFlash,
+ *          cached and uncached, with the interface settings they ran at
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_membench.h"
+
+#if MEM_BENCH_UART && !THREAD_PROFILER_UART
+#error "MEM_BENCH_UART prints on the COM port opened by THREAD_PROFILER_UART"
+#endif
+
+#if MEM_BENCH
+
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <string.h>
+
+#if MEM_BENCH_UART
+#include <stdio.h>
+#endif
+
+#if (MEM_BENCH_RAND_WINDOW & (MEM_BENCH_RAND_WINDOW - 1U)) != 0U
+#error "MEM_BENCH_RAND_WINDOW must be a power of two"
+#endif
+#if MEM_BENCH_SEQ_BYTES > MEM_BENCH_RAND_WINDOW
+#error "MEM_BENCH_SEQ_BYTES must fit in MEM_BENCH_RAND_WINDOW"
+#endif
+
+#define MEM_BENCH_LINE 32U
+
+/* Free slot above the MPU_Config() regions; attribute 0 is non-cacheable.
+ * Both windows lie outside every region MPU_Config() sets up */
+#define MEM_BENCH_MPU_REGION MPU_REGION_NUMBER7
+
+/* PSRAM window, in the boot-only hyperRAM area (STM32N657XX_LRUN.ld) */
+static uint8_t mb_psram_window[MEM_BENCH_RAND_WINDOW] ALIGN_PSRAM_ROW IN_PSRAM_STAGE;
+
+static struct {
+  mem_bench_report_t report;
+  volatile uint32_t sink; /* Keeps the read loops */
+  uint8_t reported;
+} mb_ctx;
+
+/**
+ * @brief  Cover the window with a non-cacheable region, or remove it
+ * @note   The window is cleaned and invalidated first, so neither dirty
+ *         lines nor stale ones outlive the attribute change
+ */
+static void MemBench_SetBypass(uintptr_t base, uint8_t bypass) {
+  MPU_Region_InitTypeDef region = {0};
+
+  SCB_CleanInvalidateDCache_by_Addr((void *)base, (int32_t)MEM_BENCH_RAND_WINDOW);
+
+  HAL_MPU_Disable();
+  if (bypass) {
+    region.Enable = MPU_REGION_ENABLE;
+    region.Number = MEM_BENCH_MPU_REGION;
+    region.BaseAddress = base;
+    region.LimitAddress = base + MEM_BENCH_RAND_WINDOW - 1U;
+    region.AttributesIndex = MPU_ATTRIBUTES_NUMBER0;
+    region.AccessPermission = MPU_REGION_ALL_RW;
+    region.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    region.DisablePrivExec = MPU_PRIV_INSTRUCTION_ACCESS_DISABLE;
+    region.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+    HAL_MPU_ConfigRegion(&region);
+  } else {
+    HAL_MPU_DisableRegion(MEM_BENCH_MPU_REGION);
+  }
+  HAL_MPU_Enable(MPU_HFNMI_PRIVDEF);
+}
+
+static uint32_t MemBench_Kbs(uint32_t bytes, uint32_t cycles) {
+  return cycles == 0U ? 0U : (uint32_t)(((uint64_t)bytes * mb_ctx.report.cpu_hz) / ((uint64_t)cycles * 1024U));
+}
+
+/**
+ * @brief  Sequential 64-bit reads of MEM_BENCH_SEQ_BYTES
+ * @retval CPU cycles
+ */
+static uint32_t MemBench_SeqRead(uintptr_t base) {
+  const uint64_t *p = (const uint64_t *)base;
+  uint64_t acc = 0;
+  uint32_t start;
+
+  start = DWT->CYCCNT;
+  for (uint32_t i = 0; i < MEM_BENCH_SEQ_BYTES / 8U; i += 4U) {
+    acc ^= p[i] ^ p[i + 1U] ^ p[i + 2U] ^ p[i + 3U];
+  }
+  __DSB();
+  start = DWT->CYCCNT - start;
+
+  mb_ctx.sink = (uint32_t)acc ^ (uint32_t)(acc >> 32);
+  return start;
+}
+
+/**
+ * @brief  Sequential 64-bit writes of MEM_BENCH_SEQ_BYTES, drained to memory
+ * @retval CPU cycles, the cache clean included when cached
+ */
+static uint32_t MemBench_SeqWrite(uintptr_t base, uint8_t cached) {
+  uint64_t *p = (uint64_t *)base;
+  uint32_t start;
+
+  start = DWT->CYCCNT;
+  for (uint32_t i = 0; i < MEM_BENCH_SEQ_BYTES / 8U; i++) {
+    p[i] = 0x5AA5F00F0FF0A55AULL ^ i;
+  }
+  if (cached) {
+    SCB_CleanDCache_by_Addr((void *)base, (int32_t)MEM_BENCH_SEQ_BYTES);
+  }
+  __DSB();
+  return DWT->CYCCNT - start;
+}
+
+/**
+ * @brief  Random reads, each address derived from the previous value read
+ * @retval CPU cycles per read; the address arithmetic adds a few
+ */
+static uint32_t MemBench_RandRead(uintptr_t base) {
+  uint32_t x = 0x2545F491U, v = 0;
+  uint32_t start;
+
+  start = DWT->CYCCNT;
+  for (uint32_t i = 0; i < MEM_BENCH_RAND_READS; i++) {
+    x = x * 1664525U + 1013904223U + v;
+    v = *(volatile const uint32_t *)(base + ((x >> 8) & (MEM_BENCH_RAND_WINDOW - MEM_BENCH_LINE)));
+  }
+  start = DWT->CYCCNT - start;
+
+  mb_ctx.sink = v;
+  return start / MEM_BENCH_RAND_READS;
+}
+
+/**
+ * @brief  Measure one memory in one mode
+ * @param  writable: Also measure the sequential write
+ */
+static void MemBench_Measure(mem_bench_result_t *result, uintptr_t base, uint8_t mode, uint8_t writable) {
+  uint32_t primask = __get_PRIMASK();
+  uint32_t cycles;
+
+  __disable_irq();
+  MemBench_SetBypass(base, mode == MEM_BENCH_BYPASS);
+
+  if (writable) {
+    result->seq_write_kbs = MemBench_Kbs(MEM_BENCH_SEQ_BYTES, MemBench_SeqWrite(base, mode == MEM_BENCH_CACHED));
+    SCB_InvalidateDCache_by_Addr((void *)base, (int32_t)MEM_BENCH_RAND_WINDOW);
+  }
+
+  result->seq_read_kbs = MemBench_Kbs(MEM_BENCH_SEQ_BYTES, MemBench_SeqRead(base));
+
+  /* The read above left a quarter of the window in the cache */
+  SCB_InvalidateDCache_by_Addr((void *)base, (int32_t)MEM_BENCH_RAND_WINDOW);
+  cycles = MemBench_RandRead(base);
+  result->rand_read_ns = (uint32_t)(((uint64_t)cycles * 1000000000U) / mb_ctx.report.cpu_hz);
+
+  if (mode == MEM_BENCH_BYPASS) {
+    MemBench_SetBypass(base, 0);
+  }
+  __set_PRIMASK(primask);
+}
+
+static void MemBench_ReadXspi(mem_bench_xspi_t *xspi, XSPI_TypeDef *regs, uint64_t periph_clk) {
+  xspi->kernel_hz = HAL_RCCEx_GetPeriphCLKFreq(periph_clk);
+  xspi->prescaler = (uint8_t)((regs->DCR2 & XSPI_DCR2_PRESCALER) >> XSPI_DCR2_PRESCALER_Pos);
+  xspi->dtr = (regs->CCR & XSPI_CCR_DDTR) != 0U;
+  xspi->dqs = (regs->CCR & XSPI_CCR_DQSE) != 0U;
+  xspi->prefetch = (regs->CR & XSPI_CR_NOPREF) == 0U;
+  xspi->sshift = (regs->TCR & XSPI_TCR_SSHIFT) != 0U;
+  xspi->dhqc = (regs->TCR & XSPI_TCR_DHQC) != 0U;
+}
+
+void MemBench_Run(void) {
+  mem_bench_report_t *report = &mb_ctx.report;
+
+  memset(report, 0, sizeof(*report));
+  report->cpu_hz = SystemCoreClock;
+
+  /* CYCCNT is not reset: Time_GetCycles64() extends it */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  MemBench_ReadXspi(&report->xspi[MEM_BENCH_PSRAM], XSPI1, RCC_PERIPHCLK_XSPI1);
+  MemBench_ReadXspi(&report->xspi[MEM_BENCH_FLASH], XSPI2, RCC_PERIPHCLK_XSPI2);
+
+  for (uint8_t mode = 0; mode < MEM_BENCH_MODE_NB; mode++) {
+    MemBench_Measure(&report->results[MEM_BENCH_PSRAM][mode], (uintptr_t)mb_psram_window, mode, 1);
+    MemBench_Measure(&report->results[MEM_BENCH_FLASH][mode], MEM_BENCH_FLASH_ADDR, mode, 0);
+  }
+
+  report->degraded[MEM_BENCH_PSRAM] =
+      report->results[MEM_BENCH_PSRAM][MEM_BENCH_CACHED].seq_read_kbs < MEM_BENCH_PSRAM_MIN_KBS;
+  report->degraded[MEM_BENCH_FLASH] =
+      report->results[MEM_BENCH_FLASH][MEM_BENCH_CACHED].seq_read_kbs < MEM_BENCH_FLASH_MIN_KBS;
+  report->valid = 1;
+}
+
+void MemBench_GetReport(mem_bench_report_t *report) {
+  *report = mb_ctx.report;
+}
+
+#if MEM_BENCH_UART
+static void MemBench_Print(const mem_bench_report_t *report) {
+  static const char *const mem_names[MEM_BENCH_MEM_NB] = {"psram", "flash"};
+  static const char *const mode_names[MEM_BENCH_MODE_NB] = {"cached", "bypass"};
+
+  printf("membench cpu %lu MHz, %lu KB sequential, %lu reads in %lu KB\r\n",
+         (unsigned long)(report->cpu_hz / 1000000U), (unsigned long)(MEM_BENCH_SEQ_BYTES / 1024U),
+         (unsigned long)MEM_BENCH_RAND_READS, (unsigned long)(MEM_BENCH_RAND_WINDOW / 1024U));
+  for (uint32_t m = 0; m < MEM_BENCH_MEM_NB; m++) {
+    const mem_bench_xspi_t *xspi = &report->xspi[m];
+
+    printf("  %s %lu MHz /%u dtr %u dqs %u prefetch %u sshift %u dhqc %u%s\r\n", mem_names[m],
+           (unsigned long)(xspi->kernel_hz / 1000000U), xspi->prescaler + 1U, xspi->dtr, xspi->dqs,
+           xspi->prefetch, xspi->sshift, xspi->dhqc, report->degraded[m] ? " DEGRADED" : "");
+    for (uint32_t mode = 0; mode < MEM_BENCH_MODE_NB; mode++) {
+      const mem_bench_result_t *r = &report->results[m][mode];
+
+      printf("    %-6s read %7lu KB/s write %7lu KB/s random %5lu ns\r\n", mode_names[mode],
+             (unsigned long)r->seq_read_kbs, (unsigned long)r->seq_write_kbs, (unsigned long)r->rand_read_ns);
+    }
+  }
+}
+#endif
+
+void MemBench_Update(void) {
+  if (mb_ctx.reported || !mb_ctx.report.valid) {
+    return;
+  }
+  mb_ctx.reported = 1;
+
+#if MEM_BENCH_UART
+  MemBench_Print(&mb_ctx.report);
+#endif
+}
+
+#endif /* MEM_BENCH */
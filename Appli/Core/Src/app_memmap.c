@@ -0,0 +1,571 @@
+/**
+ ******************************************************************************
+ * @file    app_memmap.c
+ * @author  Long Liangmao
+ * @brief   Runtime memory map and bandwidth budget for STM32N6570-DK
+ *          (MEM_MAP_REPORT)
+ *
+ *          The map walks the linker reservations, the NPU weights of every
+ *          registered network, the buffer registry, the ThreadX stacks and
+ *          byte pools; the cacheability of each region is read back from
+ *          the MPU, so it shows what the CPU really gets. The budget lists
+ *          the bytes each consumer moved over the window: DCMIPP writes from
+ *          the pipe frame counters, LTDC reads from the layer registers and
+ *          the pixel clock, NPU reads and writes from the tensor geometry
+ *          (NPU_BW_REPORT), the CPU output copy from NN_OUTPUT_SIZE.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_memmap.h"
+
+#if MEM_MAP_REPORT
+
+#include "app_buffers.h"
+#include "app_cam.h"
+#include "app_nn.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "app_x-cube-ai.h"
+#include "stm32n6xx_hal.h"
+#include "tx_byte_pool.h"
+#include "tx_thread.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if NPU_BW_REPORT
+#include "app_npu_bw.h"
+#endif
+
+#if !TELEMETRY
+#error "MEM_MAP_REPORT is requested and printed over telemetry: it needs TELEMETRY"
+#endif
+#if MEM_MAP_REPORT_LINES < 1
+#error "MEM_MAP_REPORT_LINES must be at least 1"
+#endif
+
+/* ThreadX fills every stack with TX_STACK_FILL at creation: the first word
+ * that changed is the deepest the thread has been */
+#define MEMMAP_STACK_FILL 0xEFEFEFEFUL
+
+/* Name, base, bytes, cacheability, owner */
+#define MEMMAP_REGION_FMT "  %-20.20s %08lx %9lu %-5s %-8s"
+
+/* Consumer rows of the budget: pipes, layers, NPU pools both ways, CPU */
+#define MEMMAP_CONSUMER_MAX (CAM_PIPE_NB + 2U + 2U * 4U + 1U)
+#define MEMMAP_NO_STALL 0xFFU
+
+typedef enum {
+  MEMMAP_SECTION_IDLE = 0,
+  MEMMAP_SECTION_LINKED,
+  MEMMAP_SECTION_WEIGHTS,
+  MEMMAP_SECTION_BUFFERS,
+  MEMMAP_SECTION_STACKS,
+  MEMMAP_SECTION_POOLS,
+  MEMMAP_SECTION_BANDWIDTH,
+  MEMMAP_SECTION_TOTALS,
+  MEMMAP_SECTION_NB,
+} memmap_section_t;
+
+/* Memories a consumer draws on, in the order of the NPU_BW_POOL_ indexes */
+typedef enum {
+  MEMMAP_MEM_AXISRAM = 0,
+  MEMMAP_MEM_PSRAM,
+  MEMMAP_MEM_FLASH,
+  MEMMAP_MEM_OTHER,
+  MEMMAP_MEM_NB,
+} memmap_mem_t;
+
+typedef struct {
+  const char *name;
+  const uint8_t *start;
+  const uint8_t *end;
+  const char *owner;
+} memmap_region_t;
+
+typedef struct {
+  const char *name;
+  uint8_t mem;       /* memmap_mem_t */
+  uint8_t stall_pct; /* NPU engines stalled, MEMMAP_NO_STALL for the others */
+  uint64_t bytes;    /* Over the window */
+} memmap_consumer_t;
+
+/* Linked regions (STM32N657XX_LRUN.ld); the non-cacheable section bounds
+ * come from stm32n6xx_hal_def.h */
+extern uint8_t __itcm_start[], __itcm_end[];
+extern uint8_t __dtcm_data_start[], __dtcm_bss_end[];
+extern uint8_t _sdata[], _ebss[];
+extern uint8_t __axisram2_npu_start[], __axisram2_npu_end[];
+extern uint8_t __axisram3_npu_start[], __axisram3_npu_end[];
+extern uint8_t __axisram4_npu_start[], __axisram4_npu_end[];
+extern uint8_t __axisram5_npu_start[], __axisram5_npu_end[];
+extern uint8_t __axisram6_npu_start[], __axisram6_npu_end[];
+extern uint8_t __psram_npu_start[], __psram_npu_end[];
+extern uint8_t __psram_trace_start[], __psram_trace_end[];
+
+static const memmap_region_t memmap_linked[] = {
+    {"itcm code", __itcm_start, __itcm_end, "cpu"},
+    {"dtcm data+bss", __dtcm_data_start, __dtcm_bss_end, "cpu"},
+    {"ram data+bss", _sdata, _ebss, "cpu"},
+    {"ram noncacheable", (const uint8_t *)&__snoncacheable, (const uint8_t *)&__enoncacheable, "dma"},
+    {"npu axisram2", __axisram2_npu_start, __axisram2_npu_end, "npu"},
+    {"npu axisram3", __axisram3_npu_start, __axisram3_npu_end, "npu"},
+    {"npu axisram4", __axisram4_npu_start, __axisram4_npu_end, "npu"},
+    {"npu axisram5", __axisram5_npu_start, __axisram5_npu_end, "npu"},
+    {"npu axisram6", __axisram6_npu_start, __axisram6_npu_end, "npu"},
+    {"npu psram", __psram_npu_start, __psram_npu_end, "npu"},
+    {"tracex psram", __psram_trace_start, __psram_trace_end, "cpu"},
+};
+
+static const char *const memmap_mem_names[MEMMAP_MEM_NB] = {"axisram", "psram", "flash", "other"};
+
+#if NPU_BW_REPORT
+_Static_assert(NPU_BW_POOL_AXISRAM == MEMMAP_MEM_AXISRAM && NPU_BW_POOL_PSRAM == MEMMAP_MEM_PSRAM &&
+                   NPU_BW_POOL_FLASH == MEMMAP_MEM_FLASH && NPU_BW_POOL_OTHER == MEMMAP_MEM_OTHER,
+               "NPU pools index the memories");
+#endif
+
+/* Indexed by buffer_owner_t */
+static const char *const memmap_owner_names[] = {"pipe0", "pipe1", "pipe2", "ui", "nn", "venc", "snapshot", "sdlog"};
+
+_Static_assert(sizeof(memmap_owner_names) / sizeof(memmap_owner_names[0]) == BUFFER_OWNER_SDLOG + 1,
+               "One name per buffer owner");
+
+static struct {
+  uint8_t section; /* memmap_section_t, MEMMAP_SECTION_IDLE between reports */
+  uint32_t row;
+
+  /* Window of the report being printed */
+  uint32_t window_us;
+  uint32_t frames; /* Camera frames: the busiest pipe */
+  uint32_t inferences;
+  memmap_consumer_t consumers[MEMMAP_CONSUMER_MAX];
+  uint32_t nb_consumers;
+
+  /* End of the previous window */
+  uint64_t last_us;
+  uint32_t last_pipe_frames[CAM_PIPE_NB];
+  uint32_t last_inferences;
+} mm_ctx;
+
+/**
+ * @brief  Memory an address lies in
+ */
+static uint8_t MemMap_MemOf(const void *ptr) {
+  uint32_t addr = (uint32_t)ptr;
+
+  if ((addr >= 0x24000000U && addr < 0x24400000U) || (addr >= 0x34000000U && addr < 0x34400000U)) {
+    return MEMMAP_MEM_AXISRAM;
+  }
+  if (addr >= 0x90000000U && addr < 0xA0000000U) {
+    return MEMMAP_MEM_PSRAM;
+  }
+  if (addr >= 0x70000000U && addr < 0x80000000U) {
+    return MEMMAP_MEM_FLASH;
+  }
+  return MEMMAP_MEM_OTHER;
+}
+
+/**
+ * @brief  Cacheability the CPU gets at an address: the MPU region covering
+ *         it, else the default memory map (MPU_HFNMI_PRIVDEF)
+ * @retval "wb" write-back, "wt" write-through, "nc" non-cacheable, "dev" device
+ */
+static const char *MemMap_CacheOf(const void *ptr) {
+  uint32_t addr = (uint32_t)ptr;
+  uint32_t regions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+  uint32_t primask = __get_PRIMASK();
+  int32_t attr = -1;
+  uint32_t outer;
+
+  if ((SCB->CCR & SCB_CCR_DC_Msk) == 0U) {
+    return "nc";
+  }
+
+  /* RNR selects the region the other registers show */
+  __disable_irq();
+  if (MPU->CTRL & MPU_CTRL_ENABLE_Msk) {
+    for (uint32_t r = 0; r < regions && attr < 0; r++) {
+      uint32_t rbar, rlar;
+
+      MPU->RNR = r;
+      rbar = MPU->RBAR;
+      rlar = MPU->RLAR;
+      if ((rlar & MPU_RLAR_EN_Msk) && addr >= (rbar & MPU_RBAR_BASE_Msk) &&
+          addr <= ((rlar & MPU_RLAR_LIMIT_Msk) | 0x1FU)) {
+        uint32_t idx = (rlar & MPU_RLAR_AttrIndx_Msk) >> MPU_RLAR_AttrIndx_Pos;
+
+        attr = (int32_t)(((idx < 4U ? MPU->MAIR0 : MPU->MAIR1) >> (8U * (idx & 3U))) & 0xFFU);
+      }
+    }
+  }
+  __set_PRIMASK(primask);
+
+  if (attr < 0) {
+    switch (addr >> 29) {
+    case 0: /* Code */
+    case 4: /* External RAM, upper half */
+      return "wt";
+    case 1: /* SRAM */
+    case 3: /* External RAM, lower half */
+      return "wb";
+    default:
+      return "dev";
+    }
+  }
+
+  /* Outer attribute: 0000 device, 0100 non-cacheable, 01RW and 11RW
+   * write-back, 00RW and 10RW write-through */
+  outer = ((uint32_t)attr >> 4) & 0xFU;
+  if (outer == 0U) {
+    return "dev";
+  }
+  if (outer == 0x4U) {
+    return "nc";
+  }
+  return (outer & 0x4U) ? "wb" : "wt";
+}
+
+static int MemMap_PrintLinked(uint32_t row) {
+  const memmap_region_t *region;
+
+  if (row >= sizeof(memmap_linked) / sizeof(memmap_linked[0])) {
+    return 0;
+  }
+  region = &memmap_linked[row];
+  printf(MEMMAP_REGION_FMT "\r\n", region->name, (unsigned long)(uint32_t)region->start,
+         (unsigned long)(region->end - region->start), MemMap_CacheOf(region->start), region->owner);
+  return 1;
+}
+
+/**
+ * @brief  Extent of the weights of one registered network, wherever they are
+ */
+static int MemMap_PrintWeights(uint32_t row) {
+  NN_Instance_TypeDef *instance;
+  const LL_Buffer_InfoTypeDef *info;
+  uint32_t lo = UINT32_MAX, hi = 0;
+
+  if (row >= MX_X_CUBE_AI_NET_NB) {
+    return 0;
+  }
+  instance = MX_X_CUBE_AI_GetNetwork(row);
+  info = (instance != NULL) ? LL_ATON_Internal_Buffers_Info(instance) : NULL;
+  if (info == NULL) {
+    return 1;
+  }
+
+  for (; info->name != NULL; info++) {
+    if (info->is_param) {
+      lo = MIN(lo, (uint32_t)LL_Buffer_addr_start(info));
+      hi = MAX(hi, (uint32_t)LL_Buffer_addr_end(info));
+    }
+  }
+  if (lo < hi) {
+    printf(MEMMAP_REGION_FMT " net %lu%s%s\r\n", "npu weights", (unsigned long)lo, (unsigned long)(hi - lo),
+           MemMap_CacheOf((const void *)lo), "npu", (unsigned long)row,
+           row == MX_X_CUBE_AI_GetActiveNetwork() ? " active" : "",
+           (row > 0U && MX_X_CUBE_AI_GetNetwork(row - 1U) != NULL &&
+            MX_X_CUBE_AI_GetNetwork(row - 1U)->network == instance->network)
+               ? " shared"
+               : "");
+  }
+  return 1;
+}
+
+static int MemMap_PrintBuffer(uint32_t row) {
+  const buffer_desc_t *desc;
+
+  if (row >= BUFFER_ID_NB) {
+    return 0;
+  }
+  desc = Buffer_GetDesc(row);
+  printf(MEMMAP_REGION_FMT " %u x %lu\r\n", desc->name, (unsigned long)(uint32_t)desc->base,
+         (unsigned long)desc->slot_nb * desc->slot_size, MemMap_CacheOf(desc->base), memmap_owner_names[desc->owner],
+         desc->slot_nb, (unsigned long)desc->slot_size);
+  return 1;
+}
+
+/**
+ * @brief  Stack of the thread created row-th, with its high-water mark
+ */
+static int MemMap_PrintStack(uint32_t row) {
+  TX_THREAD *thread;
+  const ULONG *start, *deepest, *limit;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if (row >= _tx_thread_created_count) {
+    TX_RESTORE
+    return 0;
+  }
+  thread = _tx_thread_created_ptr;
+  for (uint32_t i = 0; i < row; i++) {
+    thread = thread->tx_thread_created_next;
+  }
+  TX_RESTORE
+
+  /* Threads are never deleted: the stack stays theirs */
+  start = (const ULONG *)thread->tx_thread_stack_start;
+  limit = start + thread->tx_thread_stack_size / sizeof(ULONG);
+  deepest = start;
+#ifndef TX_DISABLE_STACK_FILLING
+  while (deepest < limit && *deepest == MEMMAP_STACK_FILL) {
+    deepest++;
+  }
+#endif
+  printf(MEMMAP_REGION_FMT " used %lu\r\n", thread->tx_thread_name, (unsigned long)(uint32_t)start,
+         (unsigned long)thread->tx_thread_stack_size, MemMap_CacheOf(start), "stack",
+         (unsigned long)((limit - deepest) * sizeof(ULONG)));
+  return 1;
+}
+
+static int MemMap_PrintPool(uint32_t row) {
+  TX_BYTE_POOL *pool;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if (row >= _tx_byte_pool_created_count) {
+    TX_RESTORE
+    return 0;
+  }
+  pool = _tx_byte_pool_created_ptr;
+  for (uint32_t i = 0; i < row; i++) {
+    pool = pool->tx_byte_pool_created_next;
+  }
+  TX_RESTORE
+
+  printf(MEMMAP_REGION_FMT " free %lu\r\n", pool->tx_byte_pool_name, (unsigned long)(uint32_t)pool->tx_byte_pool_start,
+         (unsigned long)pool->tx_byte_pool_size, MemMap_CacheOf(pool->tx_byte_pool_start), "pool",
+         (unsigned long)pool->tx_byte_pool_available);
+  return 1;
+}
+
+static uint32_t MemMap_PerFrame(uint64_t bytes) {
+  return mm_ctx.frames == 0U ? 0U : (uint32_t)(bytes / mm_ctx.frames);
+}
+
+static uint32_t MemMap_Kbs(uint64_t bytes) {
+  return mm_ctx.window_us == 0U ? 0U : (uint32_t)((bytes * 1000000U) / ((uint64_t)mm_ctx.window_us * 1024U));
+}
+
+static int MemMap_PrintConsumer(uint32_t row) {
+  const memmap_consumer_t *c;
+
+  if (row >= mm_ctx.nb_consumers) {
+    return 0;
+  }
+  c = &mm_ctx.consumers[row];
+  if (c->stall_pct == MEMMAP_NO_STALL) {
+    printf("  %-20s %-7s %9lu B/frame %8lu KB/s\r\n", c->name, memmap_mem_names[c->mem],
+           (unsigned long)MemMap_PerFrame(c->bytes), (unsigned long)MemMap_Kbs(c->bytes));
+  } else {
+    printf("  %-20s %-7s %9lu B/frame %8lu KB/s stall %u%%\r\n", c->name, memmap_mem_names[c->mem],
+           (unsigned long)MemMap_PerFrame(c->bytes), (unsigned long)MemMap_Kbs(c->bytes), c->stall_pct);
+  }
+  return 1;
+}
+
+static int MemMap_PrintTotal(uint32_t row) {
+  uint64_t bytes = 0;
+
+  if (row >= MEMMAP_MEM_NB) {
+    return 0;
+  }
+  for (uint32_t i = 0; i < mm_ctx.nb_consumers; i++) {
+    if (mm_ctx.consumers[i].mem == row) {
+      bytes += mm_ctx.consumers[i].bytes;
+    }
+  }
+  if (bytes != 0U) {
+    printf("  %-20s %-7s %9lu B/frame %8lu KB/s\r\n", "total", memmap_mem_names[row],
+           (unsigned long)MemMap_PerFrame(bytes), (unsigned long)MemMap_Kbs(bytes));
+  }
+  return 1;
+}
+
+static void MemMap_AddConsumer(const char *name, uint8_t mem, uint64_t bytes, uint8_t stall_pct) {
+  memmap_consumer_t *c;
+
+  if (bytes == 0U || mm_ctx.nb_consumers == MEMMAP_CONSUMER_MAX) {
+    return;
+  }
+  c = &mm_ctx.consumers[mm_ctx.nb_consumers++];
+  c->name = name;
+  c->mem = mem;
+  c->stall_pct = stall_pct;
+  c->bytes = bytes;
+}
+
+/**
+ * @brief  Bytes the enabled LTDC layers read over the window
+ */
+static void MemMap_AddLtdc(void) {
+  static const char *const names[] = {"ltdc layer1 read", "ltdc layer2 read"};
+  LTDC_Layer_TypeDef *const layers[] = {LTDC_Layer1, LTDC_Layer2};
+  uint32_t total_w = ((LTDC->TWCR & LTDC_TWCR_TOTALW_Msk) >> LTDC_TWCR_TOTALW_Pos) + 1U;
+  uint32_t total_h = ((LTDC->TWCR & LTDC_TWCR_TOTALH_Msk) >> LTDC_TWCR_TOTALH_Pos) + 1U;
+  uint64_t refreshes;
+
+  if ((LTDC->GCR & LTDC_GCR_LTDCEN) == 0U) {
+    return;
+  }
+  refreshes = ((uint64_t)HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_LTDC) * mm_ctx.window_us) /
+              ((uint64_t)total_w * total_h * 1000000U);
+
+  for (uint32_t l = 0; l < sizeof(layers) / sizeof(layers[0]); l++) {
+    uint32_t line, lines;
+
+    if ((layers[l]->CR & LTDC_LxCR_LEN) == 0U) {
+      continue;
+    }
+    /* The line length register holds the bytes of a line plus 7 */
+    line = ((layers[l]->CFBLR & LTDC_LxCFBLR_CFBLL_Msk) >> LTDC_LxCFBLR_CFBLL_Pos) - 7U;
+    lines = (layers[l]->CFBLNR & LTDC_LxCFBLNR_CFBLNBR_Msk) >> LTDC_LxCFBLNR_CFBLNBR_Pos;
+    MemMap_AddConsumer(names[l], MemMap_MemOf((const void *)layers[l]->CFBAR), (uint64_t)line * lines * refreshes,
+                       MEMMAP_NO_STALL);
+  }
+}
+
+#if NPU_BW_REPORT
+/**
+ * @brief  NPU reads and writes of each pool: the last inference, times the
+ *         inferences of the window
+ */
+static void MemMap_AddNpu(void) {
+  npu_bw_report_t report;
+
+  NPUBw_GetReport(&report);
+  for (uint32_t p = 0; p < NPU_BW_POOL_NB; p++) {
+    const npu_bw_pool_t *pool = &report.pools[p];
+    uint64_t in_cycles = pool->in_active + pool->in_stall;
+    uint64_t out_cycles = pool->out_active + pool->out_stall;
+
+    MemMap_AddConsumer("npu read", (uint8_t)p, pool->in_bytes * mm_ctx.inferences,
+                       in_cycles == 0U ? 0U : (uint8_t)((pool->in_stall * 100U) / in_cycles));
+    MemMap_AddConsumer("npu write", (uint8_t)p, pool->out_bytes * mm_ctx.inferences,
+                       out_cycles == 0U ? 0U : (uint8_t)((pool->out_stall * 100U) / out_cycles));
+  }
+}
+#endif
+
+/**
+ * @brief  Close the window and measure what each consumer moved over it
+ */
+static void MemMap_Snapshot(void) {
+  const nn_result_t *result = NN_AcquireResult();
+  uint64_t now_us = Time_GetUs();
+  uint32_t pipe_frames[CAM_PIPE_NB];
+
+  mm_ctx.window_us = (uint32_t)(now_us - mm_ctx.last_us);
+  mm_ctx.last_us = now_us;
+  mm_ctx.inferences = result->frame_count - mm_ctx.last_inferences;
+  mm_ctx.last_inferences = result->frame_count;
+  NN_ReleaseResult(result);
+
+  mm_ctx.frames = 0;
+  for (uint32_t p = 0; p < CAM_PIPE_NB; p++) {
+    cam_pipe_stats_t stats;
+
+    CAM_GetPipeStats(p, &stats);
+    pipe_frames[p] = stats.frames - mm_ctx.last_pipe_frames[p];
+    mm_ctx.last_pipe_frames[p] = stats.frames;
+    mm_ctx.frames = MAX(mm_ctx.frames, pipe_frames[p]);
+  }
+
+  mm_ctx.nb_consumers = 0;
+#if AUX_STREAM_ENABLE
+  {
+    const buffer_desc_t *desc = Buffer_GetDesc(BUFFER_ID_AUX_STREAM);
+
+    MemMap_AddConsumer("dcmipp pipe0 write", MemMap_MemOf(desc->base),
+                       (uint64_t)desc->pitch * desc->height * pipe_frames[DCMIPP_PIPE0], MEMMAP_NO_STALL);
+  }
+#endif
+#if !DISPLAY_SINGLE_PIPE
+  {
+    const buffer_desc_t *desc = Buffer_GetDesc(BUFFER_ID_CAMERA_DISPLAY);
+
+    MemMap_AddConsumer("dcmipp pipe1 write", MemMap_MemOf(desc->base),
+                       (uint64_t)desc->pitch * desc->height * pipe_frames[DCMIPP_PIPE1], MEMMAP_NO_STALL);
+  }
+#endif
+  MemMap_AddConsumer("dcmipp pipe2 write", MemMap_MemOf(Buffer_GetMLCaptureBuffer(0)),
+                     (uint64_t)ML_WIDTH * ML_HEIGHT * ML_BPP * pipe_frames[DCMIPP_PIPE2], MEMMAP_NO_STALL);
+  MemMap_AddLtdc();
+#if NPU_BW_REPORT
+  MemMap_AddNpu();
+#endif
+  /* Output copy (read and write) and the decode reading the copy back */
+  MemMap_AddConsumer("cpu nn outputs", MemMap_MemOf(Buffer_GetDesc(BUFFER_ID_NN_OUTPUT)->base),
+                     3ULL * NN_OUTPUT_SIZE * mm_ctx.inferences, MEMMAP_NO_STALL);
+}
+
+/**
+ * @brief  Print one row of the current section
+ * @retval 0 past the last row of the section
+ */
+static int MemMap_PrintRow(uint8_t section, uint32_t row) {
+  switch (section) {
+  case MEMMAP_SECTION_LINKED:
+    return MemMap_PrintLinked(row);
+  case MEMMAP_SECTION_WEIGHTS:
+    return MemMap_PrintWeights(row);
+  case MEMMAP_SECTION_BUFFERS:
+    return MemMap_PrintBuffer(row);
+  case MEMMAP_SECTION_STACKS:
+    return MemMap_PrintStack(row);
+  case MEMMAP_SECTION_POOLS:
+    return MemMap_PrintPool(row);
+  case MEMMAP_SECTION_BANDWIDTH:
+    if (row == 0U) {
+      printf("memmap budget over %lu ms: %lu camera frames, %lu inferences\r\n",
+             (unsigned long)(mm_ctx.window_us / 1000U), (unsigned long)mm_ctx.frames,
+             (unsigned long)mm_ctx.inferences);
+      return 1;
+    }
+    return MemMap_PrintConsumer(row - 1U);
+  case MEMMAP_SECTION_TOTALS:
+    return MemMap_PrintTotal(row);
+  default:
+    return 0;
+  }
+}
+
+void MemMap_Poll(void) {
+  if (mm_ctx.section == MEMMAP_SECTION_IDLE) {
+    if (!Telemetry_TakeRequest(TELEMETRY_REQUEST_MEMMAP)) {
+      return;
+    }
+    /* Measured first: the map takes a few wakes to print */
+    MemMap_Snapshot();
+    printf("memmap %-16s %-8s %9s %-5s %-8s\r\n", "region", "base", "bytes", "cache", "owner");
+    mm_ctx.section = MEMMAP_SECTION_LINKED;
+    mm_ctx.row = 0;
+    return;
+  }
+
+  for (uint32_t lines = 0; lines < MEM_MAP_REPORT_LINES;) {
+    if (!MemMap_PrintRow(mm_ctx.section, mm_ctx.row)) {
+      mm_ctx.row = 0;
+      if (++mm_ctx.section == MEMMAP_SECTION_NB) {
+        mm_ctx.section = MEMMAP_SECTION_IDLE;
+        return;
+      }
+      continue;
+    }
+    mm_ctx.row++;
+    lines++;
+  }
+}
+
+#endif /* MEM_MAP_REPORT */
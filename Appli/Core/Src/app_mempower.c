@@ -0,0 +1,209 @@
+/**
+ ******************************************************************************
+ * @file    app_mempower.c
+ * @author  Long Liangmao
+ * @brief   AXISRAM bank power for STM32N6570-DK (MEMPOWER_ENABLE)
+ *
+ *          MX_X_CUBE_AI_Init() powers AXISRAM2-6 for whichever network
+ *          runs. The banks a network needs are those its activation, input
+ *          and output buffers lie in; with the CPU sections after the
+ *          reservations (prefetch ring, output slots), the others are shut
+ *          down through RAMCFG and their clocks gated. A switch wakes the
+ *          banks of the next network before it is selected, and shuts the
+ *          ones only the previous one used after. Shutdown loses the
+ *          contents: activations are not live between inferences.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_mempower.h"
+
+#if MEMPOWER_ENABLE
+
+#include "app_error.h"
+#include "app_x-cube-ai.h"
+#include "ramcfg.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if NN_BENCH
+#error "MEMPOWER_ENABLE follows the pipeline networks: the benchmark image keeps every bank up"
+#endif
+
+/* AXISRAM2 then AXISRAM3-6, secure alias as generated (STM32N657XX_LRUN.ld) */
+#define MEMPOWER_WINDOW_START 0x34100000U
+#define MEMPOWER_WINDOW_END 0x343C0000U
+#define MEMPOWER_BANK2_END 0x34200000U
+#define MEMPOWER_BANK_SIZE 0x70000U /* AXISRAM3-6 */
+#define MEMPOWER_BANK_FIRST 2U
+#define MEMPOWER_BANK_LAST 6U
+#define MEMPOWER_BANKS_ALL 0x7CU
+
+/* CPU sections after the activation reservations */
+extern uint8_t __axisram3_bss_start[], __axisram3_bss_end[];
+extern uint8_t __axisram6_bss_start[], __axisram6_bss_end[];
+
+static const struct {
+  RAMCFG_HandleTypeDef *hramcfg;
+  uint32_t clock; /* LL_MEM_AXISRAMn */
+} mempower_banks[MEMPOWER_BANK_LAST - MEMPOWER_BANK_FIRST + 1U] = {
+    {&hramcfg_SRAM2, LL_MEM_AXISRAM2},
+    {&hramcfg_SRAM3, LL_MEM_AXISRAM3},
+    {&hramcfg_SRAM4, LL_MEM_AXISRAM4},
+    {&hramcfg_SRAM5, LL_MEM_AXISRAM5},
+    {&hramcfg_SRAM6, LL_MEM_AXISRAM6},
+};
+
+static mempower_stats_t mempower_ctx;
+
+/**
+ * @brief  Bank of an AXISRAM2-6 address
+ */
+static uint32_t MemPower_Bank(uint32_t addr) {
+  if (addr < MEMPOWER_BANK2_END) {
+    return 2U;
+  }
+  return 3U + (addr - MEMPOWER_BANK2_END) / MEMPOWER_BANK_SIZE;
+}
+
+static uint32_t MemPower_BankStart(uint32_t bank) {
+  return (bank == 2U) ? MEMPOWER_WINDOW_START : MEMPOWER_BANK2_END + (bank - 3U) * MEMPOWER_BANK_SIZE;
+}
+
+static uint32_t MemPower_BankEnd(uint32_t bank) {
+  return (bank == 2U) ? MEMPOWER_BANK2_END : MemPower_BankStart(bank) + MEMPOWER_BANK_SIZE;
+}
+
+/**
+ * @brief  Banks a range overlaps, 0 outside AXISRAM2-6
+ */
+static uint32_t MemPower_RangeMask(uint32_t start, uint32_t end) {
+  uint32_t mask = 0;
+
+  if (end <= start || start < MEMPOWER_WINDOW_START || end > MEMPOWER_WINDOW_END) {
+    return 0;
+  }
+  for (uint32_t b = MemPower_Bank(start); b <= MemPower_Bank(end - 1U); b++) {
+    mask |= 1U << b;
+  }
+  return mask;
+}
+
+static uint32_t MemPower_ListMask(const LL_Buffer_InfoTypeDef *info) {
+  uint32_t mask = 0;
+
+  if (info == NULL) {
+    return 0;
+  }
+  for (; info->name != NULL; info++) {
+    /* User-allocated buffers are CPU memory, pinned or outside the banks */
+    if (info->is_user_allocated) {
+      continue;
+    }
+    mask |= MemPower_RangeMask((uint32_t)LL_Buffer_addr_start(info), (uint32_t)LL_Buffer_addr_end(info));
+  }
+  return mask;
+}
+
+/**
+ * @brief  Banks a registered network places a buffer in
+ */
+static uint32_t MemPower_NetworkMask(uint32_t id) {
+  NN_Instance_TypeDef *instance = MX_X_CUBE_AI_GetNetwork(id);
+
+  APP_REQUIRE(instance != NULL);
+  return MemPower_ListMask(LL_ATON_Internal_Buffers_Info(instance)) |
+         MemPower_ListMask(LL_ATON_Input_Buffers_Info(instance)) |
+         MemPower_ListMask(LL_ATON_Output_Buffers_Info(instance));
+}
+
+/**
+ * @brief  Banks kept up: the active network, the second stage the cascade
+ *         selects per frame (and runs beside it with NPU_SCHED_ENABLE), the
+ *         CPU sections
+ */
+static uint32_t MemPower_Required(void) {
+  uint32_t mask = mempower_ctx.pinned | MemPower_NetworkMask(MX_X_CUBE_AI_GetActiveNetwork());
+
+#if CASCADE_ENABLE
+  mask |= MemPower_NetworkMask(CASCADE_NETWORK);
+#endif
+  return mask;
+}
+
+static int MemPower_IsOn(uint32_t bank) {
+  return (mempower_banks[bank - MEMPOWER_BANK_FIRST].hramcfg->Instance->CR & RAMCFG_CR_SRAMSD) == 0U;
+}
+
+void MemPower_Wake(uint32_t id) {
+  uint32_t mask = MemPower_NetworkMask(id) & mempower_ctx.off;
+  uint32_t start = DWT->CYCCNT;
+  uint32_t us;
+
+  if (mask == 0U) {
+    return;
+  }
+  for (uint32_t b = MEMPOWER_BANK_FIRST; b <= MEMPOWER_BANK_LAST; b++) {
+    if ((mask & (1U << b)) == 0U) {
+      continue;
+    }
+    LL_MEM_EnableClock(mempower_banks[b - MEMPOWER_BANK_FIRST].clock);
+    HAL_RAMCFG_EnableAXISRAM(mempower_banks[b - MEMPOWER_BANK_FIRST].hramcfg);
+    /* Read back: the bank is powered before the NPU can reach it */
+    (void)mempower_banks[b - MEMPOWER_BANK_FIRST].hramcfg->Instance->CR;
+    mempower_ctx.wakes++;
+  }
+  __DSB();
+  mempower_ctx.off &= ~mask;
+
+  us = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000U);
+  mempower_ctx.wake_max_us = MAX(mempower_ctx.wake_max_us, us);
+}
+
+void MemPower_Apply(void) {
+  uint32_t off = ~MemPower_Required() & MEMPOWER_BANKS_ALL;
+
+  for (uint32_t b = MEMPOWER_BANK_FIRST; b <= MEMPOWER_BANK_LAST; b++) {
+    if ((off & (1U << b)) == 0U || !MemPower_IsOn(b)) {
+      continue;
+    }
+    /* A bank in use until now may have dirty lines: written back before
+     * the clock goes, an eviction to a gated bank would fault. One already
+     * off, powered again by MX_X_CUBE_AI_Resume(), was not written since */
+    if ((mempower_ctx.off & (1U << b)) == 0U) {
+      SCB_CleanInvalidateDCache_by_Addr((void *)MemPower_BankStart(b),
+                                        (int32_t)(MemPower_BankEnd(b) - MemPower_BankStart(b)));
+    }
+    HAL_RAMCFG_DisableAXISRAM(mempower_banks[b - MEMPOWER_BANK_FIRST].hramcfg);
+    LL_MEM_DisableClock(mempower_banks[b - MEMPOWER_BANK_FIRST].clock);
+  }
+
+  if (off != mempower_ctx.off) {
+    printf("MemPower: AXISRAM banks off 0x%02lx\r\n", (unsigned long)off);
+  }
+  mempower_ctx.off = off;
+}
+
+void MemPower_Init(void) {
+  mempower_ctx.pinned = MemPower_RangeMask((uint32_t)__axisram3_bss_start, (uint32_t)__axisram3_bss_end) |
+                        MemPower_RangeMask((uint32_t)__axisram6_bss_start, (uint32_t)__axisram6_bss_end);
+  /* As MX_X_CUBE_AI_Init() left them */
+  mempower_ctx.off = 0;
+  MemPower_Apply();
+}
+
+void MemPower_GetStats(mempower_stats_t *stats) {
+  *stats = mempower_ctx;
+}
+
+#endif /* MEMPOWER_ENABLE */
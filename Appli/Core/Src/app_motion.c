@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ * @file    app_motion.c
+ * @author  Long Liangmao
+ * @brief   Motion gate implementation for STM32N6570-DK
+ *
+ *          The ML frame, or its field of view on the auxiliary Pipe0 stream
+ *          (AUX_STREAM_ENABLE), is split into MOTION_GRID x MOTION_GRID blocks, each
+ *          reduced to the mean luma of MOTION_BLOCK_SAMPLES^2 pixels. A frame
+ *          runs the network when enough blocks moved away from the frame of
+ *          the last run: comparing to that reference rather than to the
+ *          previous frame also catches a slow entry, one small step a frame.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_motion.h"
+
+#if MOTION_GATE_ENABLE
+
+#include "app_buffers.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if NN_TILING != NN_TILING_CENTER
+#error "MOTION_GATE_ENABLE compares whole ML frames of a fixed crop: needs NN_TILING_CENTER"
+#endif
+
+#if AUX_STREAM_ENABLE
+/* Sampled window of the auxiliary frame: the centered crop Pipe2 sees */
+#define MOTION_FRAME_WIDTH (AUX_HEIGHT * ML_WIDTH / ML_HEIGHT < AUX_WIDTH ? AUX_HEIGHT * ML_WIDTH / ML_HEIGHT : AUX_WIDTH)
+#define MOTION_FRAME_HEIGHT (AUX_WIDTH * ML_HEIGHT / ML_WIDTH < AUX_HEIGHT ? AUX_WIDTH * ML_HEIGHT / ML_WIDTH : AUX_HEIGHT)
+#define MOTION_FRAME_X0 ((AUX_WIDTH - MOTION_FRAME_WIDTH) / 2)
+#define MOTION_FRAME_Y0 ((AUX_HEIGHT - MOTION_FRAME_HEIGHT) / 2)
+#define MOTION_FRAME_PITCH (AUX_WIDTH * AUX_BPP)
+#define MOTION_FRAME_BPP AUX_BPP
+#else
+#define MOTION_FRAME_WIDTH ML_WIDTH
+#define MOTION_FRAME_HEIGHT ML_HEIGHT
+#define MOTION_FRAME_X0 0
+#define MOTION_FRAME_Y0 0
+#define MOTION_FRAME_PITCH ML_PITCH
+#define MOTION_FRAME_BPP ML_BPP
+#endif
+
+#define MOTION_BLOCK_WIDTH (MOTION_FRAME_WIDTH / MOTION_GRID)
+#define MOTION_BLOCK_HEIGHT (MOTION_FRAME_HEIGHT / MOTION_GRID)
+#define MOTION_SAMPLE_STEP_X (MOTION_BLOCK_WIDTH / MOTION_BLOCK_SAMPLES)
+#define MOTION_SAMPLE_STEP_Y (MOTION_BLOCK_HEIGHT / MOTION_BLOCK_SAMPLES)
+
+#if MOTION_SAMPLE_STEP_X == 0 || MOTION_SAMPLE_STEP_Y == 0
+#error "MOTION_GRID x MOTION_BLOCK_SAMPLES exceeds the sampled frame"
+#endif
+
+static struct {
+  uint8_t reference[MOTION_GRID * MOTION_GRID]; /* Block luma of the last run */
+  uint8_t valid;                                /* reference holds a frame */
+  uint32_t since_run;                           /* Frames skipped since the last run */
+  volatile uint8_t tracking;                    /* Last result had detections */
+  volatile uint8_t disabled;                    /* Every frame runs (Motion_SetEnabled()) */
+} motion_ctx;
+
+/**
+ * @brief  Luma of one sampled pixel
+ */
+static inline uint32_t Motion_Luma(const uint8_t *px) {
+#if AUX_STREAM_ENABLE
+  /* High byte of the little-endian, MSB-aligned raw sample */
+  return px[1];
+#elif ML_BPP == 1 || ML_YUV422
+  /* Y8, or the luma slot of the YUYV pair */
+  return px[0];
+#else
+  /* (R + 2G + B) / 4: independent of the R/B swap */
+  return ((uint32_t)px[0] + 2U * px[1] + px[2]) >> 2;
+#endif
+}
+
+/**
+ * @brief  Mean luma of every block of a frame
+ * @note   The capture rings are non-cacheable: only the sampled pixels are read
+ */
+static void Motion_Sample(const uint8_t *frame, uint8_t *blocks) {
+  for (uint32_t by = 0; by < MOTION_GRID; by++) {
+    for (uint32_t bx = 0; bx < MOTION_GRID; bx++) {
+      uint32_t sum = 0;
+
+      for (uint32_t sy = 0; sy < MOTION_BLOCK_SAMPLES; sy++) {
+        uint32_t y = MOTION_FRAME_Y0 + by * MOTION_BLOCK_HEIGHT + sy * MOTION_SAMPLE_STEP_Y + MOTION_SAMPLE_STEP_Y / 2;
+        const uint8_t *row = frame + y * MOTION_FRAME_PITCH;
+
+        for (uint32_t sx = 0; sx < MOTION_BLOCK_SAMPLES; sx++) {
+          uint32_t x = MOTION_FRAME_X0 + bx * MOTION_BLOCK_WIDTH + sx * MOTION_SAMPLE_STEP_X + MOTION_SAMPLE_STEP_X / 2;
+
+          sum += Motion_Luma(row + x * MOTION_FRAME_BPP);
+        }
+      }
+      blocks[by * MOTION_GRID + bx] = (uint8_t)(sum / (MOTION_BLOCK_SAMPLES * MOTION_BLOCK_SAMPLES));
+    }
+  }
+}
+
+/**
+ * @brief  Reset the reference so the next frame runs the network
+ */
+void Motion_Init(void) {
+  memset(&motion_ctx, 0, sizeof(motion_ctx));
+}
+
+/**
+ * @brief  Decide whether a Pipe2 frame needs the network (inference thread)
+ */
+int Motion_ShouldRun(const uint8_t *frame) {
+  uint8_t blocks[MOTION_GRID * MOTION_GRID];
+  uint32_t changed = 0;
+
+  /* Not even sampled: the reference is taken again once enabled */
+  if (motion_ctx.disabled) {
+    motion_ctx.valid = 0;
+    return 1;
+  }
+
+  Motion_Sample(frame, blocks);
+
+  for (uint32_t i = 0; i < MOTION_GRID * MOTION_GRID; i++) {
+    if (abs((int)blocks[i] - (int)motion_ctx.reference[i]) > MOTION_BLOCK_THRESHOLD) {
+      changed++;
+    }
+  }
+
+  if (motion_ctx.valid && !motion_ctx.tracking && changed < MOTION_MIN_BLOCKS &&
+      motion_ctx.since_run + 1U < MOTION_KEEPALIVE_FRAMES) {
+    motion_ctx.since_run++;
+    return 0;
+  }
+
+  memcpy(motion_ctx.reference, blocks, sizeof(blocks));
+  motion_ctx.valid = 1;
+  motion_ctx.since_run = 0;
+  return 1;
+}
+
+/**
+ * @brief  Report whether the last published result had detections
+ */
+void Motion_SetTracking(uint32_t nb_detect) {
+  motion_ctx.tracking = (nb_detect > 0);
+}
+
+/**
+ * @brief  Turn the gate on or off at runtime
+ */
+void Motion_SetEnabled(int enabled) {
+  motion_ctx.disabled = !enabled;
+}
+
+#endif /* MOTION_GATE_ENABLE */
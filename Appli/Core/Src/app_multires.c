@@ -0,0 +1,98 @@
+/**
+ ******************************************************************************
+ * @file    app_multires.c
+ * @author  Long Liangmao
+ * @brief   Resolution-adaptive inference for STM32N6570-DK (NN_MULTIRES_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_multires.h"
+
+#if NN_MULTIRES_ENABLE
+
+#include "app_error.h"
+#include "app_x-cube-ai.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if NN_MULTIRES_HOLD_FRAMES < 1 || NN_MULTIRES_EMPTY_FRAMES < 1 || NN_MULTIRES_PROBE_PERIOD < 1
+#error "NN_MULTIRES_HOLD_FRAMES, NN_MULTIRES_EMPTY_FRAMES and NN_MULTIRES_PROBE_PERIOD count results: at least 1"
+#endif
+
+/* Post-processing thread only */
+static struct {
+  uint32_t full_network;
+  uint32_t large_run; /* Full-resolution results in a row with only large boxes */
+  uint32_t empty_run; /* Low-resolution results in a row without detections */
+  uint32_t low_run;   /* Low-resolution results since the last switch */
+  uint8_t probing;    /* Up for a probe: its first result decides */
+} mr_ctx;
+
+/**
+ * @brief  Larger side of the smallest box, 1 without detections
+ */
+static float MultiRes_SmallestBox(const nn_detection_t *dets, uint32_t nb) {
+  float smallest = 1.0f;
+
+  for (uint32_t i = 0; i < nb; i++) {
+    smallest = MIN(smallest, MAX(dets[i].width, dets[i].height));
+  }
+  return smallest;
+}
+
+/**
+ * @brief  Ask for a detector; the counters restart with it
+ */
+static void MultiRes_Switch(uint32_t network, uint32_t side) {
+  mr_ctx.large_run = 0;
+  mr_ctx.empty_run = 0;
+  mr_ctx.low_run = 0;
+  NN_RequestNetwork(network);
+  printf("Multires: %lu px%s\r\n", (unsigned long)side, mr_ctx.probing ? " (probe)" : "");
+}
+
+void MultiRes_Init(uint32_t full_network) {
+  APP_REQUIRE(MX_X_CUBE_AI_GetNetwork(NN_MULTIRES_NETWORK) != NULL);
+  APP_REQUIRE(full_network != NN_MULTIRES_NETWORK);
+  /* Hysteresis: a box between the two sizes keeps the detector it has */
+  APP_REQUIRE(NN_MULTIRES_UP_SIZE < NN_MULTIRES_DOWN_SIZE);
+
+  mr_ctx.full_network = full_network;
+}
+
+void MultiRes_Update(uint32_t network, const nn_detection_t *dets, uint32_t nb) {
+  float smallest = MultiRes_SmallestBox(dets, nb);
+
+  if (network == mr_ctx.full_network) {
+    uint32_t large = nb > 0 && smallest >= NN_MULTIRES_DOWN_SIZE;
+    uint32_t probe = mr_ctx.probing;
+
+    mr_ctx.probing = 0;
+    mr_ctx.large_run = large ? mr_ctx.large_run + 1U : 0U;
+    /* A probe that finds the same near scene goes back down at once */
+    if ((probe && large) || mr_ctx.large_run >= NN_MULTIRES_HOLD_FRAMES) {
+      MultiRes_Switch(NN_MULTIRES_NETWORK, NN_MULTIRES_SIDE);
+    }
+  } else if (network == NN_MULTIRES_NETWORK) {
+    mr_ctx.empty_run = (nb == 0) ? mr_ctx.empty_run + 1U : 0U;
+    if (smallest < NN_MULTIRES_UP_SIZE || mr_ctx.empty_run >= NN_MULTIRES_EMPTY_FRAMES) {
+      MultiRes_Switch(mr_ctx.full_network, ML_WIDTH);
+    } else if (++mr_ctx.low_run >= NN_MULTIRES_PROBE_PERIOD) {
+      /* Far people the small input cannot resolve */
+      mr_ctx.probing = 1;
+      MultiRes_Switch(mr_ctx.full_network, ML_WIDTH);
+    }
+  }
+}
+
+#endif /* NN_MULTIRES_ENABLE */
@@ -0,0 +1,1621 @@
+/**
+ ******************************************************************************
+ * @file    app_nn.c
+ * @author  Long Liangmao
+ * @brief   Neural network inference pipeline for STM32N6570-DK
+ *          Three-stage pipeline: while the NPU runs frame N, DCMIPP Pipe2
+ *          captures frame N+1 and the CPU post-processes frame N-1
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nn.h"
+#include "app_analytics.h"
+#include "app_arena.h"
+#include "app_boottime.h"
+#include "app_buffers.h"
+#include "app_cam.h"
+#include "app_cascade.h"
+#include "app_config.h"
+#include "app_dataset.h"
+#include "app_dvfs.h"
+#include "app_error.h"
+#include "app_health.h"
+#include "app_mempower.h"
+#include "app_motion.h"
+#include "app_multires.h"
+#include "app_npu_bw.h"
+#include "app_npu_cache.h"
+#include "app_npu_cipher.h"
+#include "app_npu_sched.h"
+#include "app_nsshare.h"
+#include "app_params.h"
+#include "app_pool.h"
+#include "app_postprocess.h"
+#include "app_prefetch.h"
+#include "app_profile.h"
+#include "app_profiler.h"
+#include "app_selftest.h"
+#include "app_slots.h"
+#include "app_spsc.h"
+#include "app_telemetry.h"
+#include "app_trace.h"
+#include "app_tracker.h"
+#include "app_tiling.h"
+#include "app_ui.h"
+#include "app_wstage.h"
+#include "app_x-cube-ai.h"
+#include "nn_output_params.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+#if NPU_IDLE_GATE_ENABLE && !MOTION_GATE_ENABLE
+#error "NPU_IDLE_GATE_ENABLE suspends the NPU over motion-gated frames: it needs MOTION_GATE_ENABLE"
+#endif
+
+#if PP_EXCLUDE_ENABLE && NN_TILING != NN_TILING_CENTER
+#error "PP_EXCLUDE_ENABLE masks ML frame areas: it needs NN_TILING_CENTER"
+#endif
+
+#if ML_INPUT_ALIAS && ML_CAPTURE_MODE != ML_CAPTURE_SNAPSHOT
+#error "ML_INPUT_ALIAS captures between inferences: it needs ML_CAPTURE_SNAPSHOT"
+#endif
+#if ML_INPUT_ALIAS && (DISPLAY_SINGLE_PIPE || ISP_TUNING_ENABLE)
+#error "ML_INPUT_ALIAS frames live until the next inference: no LTDC scan-out or tuning dump can read them"
+#endif
+#if ML_INPUT_ALIAS && ML_PITCH_PADDED
+#error "ML_INPUT_ALIAS has Pipe2 write the packed input tensor: it needs unpadded lines (ML_PITCH_ALIGN)"
+#endif
+
+#if NN_MULTIRES_ENABLE && (CASCADE_ENABLE || DATASET_ENABLE || ML_INPUT_ALIAS || PP_EXCLUDE_ENABLE)
+#error "NN_MULTIRES_ENABLE changes the ML frame and output grids: not with CASCADE, DATASET, ML_INPUT_ALIAS or PP_EXCLUDE"
+#endif
+#if NN_MULTIRES_ENABLE && MOTION_GATE_ENABLE && !AUX_STREAM_ENABLE
+#error "NN_MULTIRES_ENABLE changes the ML frame: the motion gate must sample the auxiliary stream"
+#endif
+
+#if NN_MULTIRES_ENABLE
+/* YOLOX grids of the NN_MULTIRES_SIDE detector: same strides, fewer cells */
+#define PP_MULTIRES_GRID(lvl) (AI_OD_ST_YOLOX_PP_##lvl##_GRID_WIDTH * NN_MULTIRES_SIDE / ML_WIDTH)
+#define PP_MULTIRES_OUTPUT_SIZE                                                                     \
+  ((PP_MULTIRES_GRID(S) * PP_MULTIRES_GRID(S) + PP_MULTIRES_GRID(L) * PP_MULTIRES_GRID(L) +         \
+    PP_MULTIRES_GRID(M) * PP_MULTIRES_GRID(M)) * NN_GEN_OUTPUT_0_CHANNELS * NN_OUTPUT_ELEM_SIZE)
+#if (AI_OD_ST_YOLOX_PP_S_GRID_WIDTH * NN_MULTIRES_SIDE) % ML_WIDTH != 0
+#error "NN_MULTIRES_SIDE must give the coarsest YOLOX grid a whole number of cells"
+#endif
+#endif
+
+/* Input frame of the active network: square and one of two sides with
+ * NN_MULTIRES_ENABLE */
+#if NN_MULTIRES_ENABLE
+#define NN_IN_WIDTH nn_ctx.in_side
+#define NN_IN_HEIGHT nn_ctx.in_side
+#else
+#define NN_IN_WIDTH ((uint32_t)ML_WIDTH)
+#define NN_IN_HEIGHT ((uint32_t)ML_HEIGHT)
+#endif
+
+/* Snapshot requested as the inference starts, due when it is expected to end */
+#define NN_SNAPSHOT_AHEAD (ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT && !ML_INPUT_ALIAS)
+
+/* app_config.h against the outputs of the generated network (nn_output_params.h) */
+#if NN_OUTPUT_NB != NN_GEN_OUTPUT_NB || NN_OUTPUT_SIZE != NN_GEN_OUTPUT_SIZE
+#error "NN_OUTPUT_NB/NN_OUTPUT_SIZE do not match the outputs of the generated network"
+#endif
+#if NN_OUTPUT_INT8 != NN_GEN_OUTPUT_INT8
+#error "NN_OUTPUT_INT8 does not match the output type of the generated network"
+#endif
+#if NN_OUTPUT_HEADS && !NN_OUTPUT_INT8
+#error "NN_OUTPUT_HEADS decodes the heads in the quantized domain: it needs NN_OUTPUT_INT8"
+#endif
+#if NN_OUTPUT_HEADS && NN_MULTIRES_ENABLE
+#error "NN_OUTPUT_HEADS: the NN_MULTIRES_ENABLE output size assumes concatenated levels"
+#endif
+/* Split heads are matched to the levels per tensor, at post-processing init */
+#if !NN_OUTPUT_HEADS
+#if AI_OD_ST_YOLOX_PP_S_GRID_WIDTH != NN_GEN_OUTPUT_0_GRID_WIDTH ||   \
+    AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT != NN_GEN_OUTPUT_0_GRID_HEIGHT || \
+    AI_OD_ST_YOLOX_PP_L_GRID_WIDTH != NN_GEN_OUTPUT_1_GRID_WIDTH ||   \
+    AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT != NN_GEN_OUTPUT_1_GRID_HEIGHT || \
+    AI_OD_ST_YOLOX_PP_M_GRID_WIDTH != NN_GEN_OUTPUT_2_GRID_WIDTH ||   \
+    AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT != NN_GEN_OUTPUT_2_GRID_HEIGHT
+#error "AI_OD_ST_YOLOX_PP_*_GRID_* do not match the output grids of the generated network (S, L, M)"
+#endif
+#if NN_GEN_OUTPUT_0_CHANNELS != AI_OD_ST_YOLOX_PP_NB_ANCHORS * (5 + AI_OD_ST_YOLOX_PP_NB_CLASSES)
+#error "AI_OD_ST_YOLOX_PP_NB_ANCHORS/NB_CLASSES do not match the output channels of the generated network"
+#endif
+#endif
+
+/* Inference thread configuration */
+#define NN_THREAD_STACK_SIZE 4096
+
+/* Post-processing thread configuration */
+#define PP_THREAD_STACK_SIZE 8192 /* NMS keeps its kept-box SoA on the stack */
+
+/* NPU activation reservations (STM32N657XX_LRUN.ld) */
+extern uint8_t __axisram2_npu_start[], __axisram2_npu_end[];
+extern uint8_t __axisram3_npu_start[], __axisram3_npu_end[];
+extern uint8_t __axisram4_npu_start[], __axisram4_npu_end[];
+extern uint8_t __axisram5_npu_start[], __axisram5_npu_end[];
+extern uint8_t __axisram6_npu_start[], __axisram6_npu_end[];
+extern uint8_t __psram_npu_start[], __psram_npu_end[];
+
+/* Pipe2 frame events queued ahead of the inference thread (a power of two);
+ * one more is dropped, only its hand-off stamp is lost */
+#define NN_FRAME_QUEUE_NB 8
+
+#define NN_EVENT_FRAME 0x1U /* Pipe2 frame descriptors queued */
+#define NN_EVENT_ROWS 0x2U  /* ML_SLICE_INGEST: Pipe2 rows landed */
+
+/* ML_SLICE_INGEST progress word: slot (31:24), capture (23:16), rows (15:0),
+ * written whole by the ISR */
+#define NN_ROWS_KEY(word) ((word) >> 16)
+#define NN_ROWS_SLOT(word) ((int)((word) >> 24))
+#define NN_ROWS_NB(word) ((word) & 0xFFFFU)
+#define NN_ROWS_NONE 0xFFFFFFFFU
+
+/* Pipe2 frame completion, ISR to inference thread. Slot ownership stays
+ * with the ML capture ring: the descriptor only tells which frame landed when */
+typedef struct {
+  int32_t slot;
+  uint32_t frame_id;
+  uint32_t cycles; /* DWT stamp at the frame event */
+} nn_frame_desc_t;
+
+/* Inference thread resources */
+static struct {
+  TX_EVENT_FLAGS_GROUP events; /* NN_EVENT_FRAME: one set per ISR, drained in batches */
+  spsc_t frame_queue;          /* Frame event ISR to inference thread, lock-free */
+  nn_frame_desc_t frame_queue_storage[NN_FRAME_QUEUE_NB];
+  TX_QUEUE free_queue;    /* Output slots available to the inference thread */
+  TX_QUEUE ready_queue;   /* Output slots waiting for post-processing */
+  ULONG free_queue_storage[NN_OUTPUT_BUFFER_NB];
+  ULONG ready_queue_storage[NN_OUTPUT_BUFFER_NB];
+  volatile uint32_t requested_network; /* Applied by the inference thread at a frame boundary */
+  uint8_t zero_copy;                 /* Pipe2 slots are bound directly as the network input */
+  uint8_t *in_buf;                   /* Network-allocated input buffer (copy mode) */
+  uint32_t in_len;
+#if NN_MULTIRES_ENABLE
+  uint32_t in_side;                  /* ML_WIDTH or NN_MULTIRES_SIDE */
+#endif
+#if ML_SLICE_INGEST
+  struct {
+    volatile uint32_t landed; /* Progress word of the last Pipe2 rows event */
+    uint32_t key;             /* Capture the input holds rows of, NN_ROWS_NONE */
+    uint32_t copied;          /* Its rows copied */
+  } rows;
+#endif
+#if MOTION_GATE_ENABLE
+  volatile uint32_t gated_count; /* Frames skipped by the motion gate */
+#endif
+#if NPU_IDLE_GATE_ENABLE
+  struct {
+    uint32_t gated_run;            /* Frames skipped in a row */
+    uint32_t inference_us;         /* Last inference, for the wake-up slack */
+    uint8_t suspended;
+    volatile uint32_t suspend_count;
+    volatile uint32_t wake_max_us; /* Slowest wake-up seen */
+  } idle;
+#endif
+  uint32_t out_offset[NN_OUTPUT_NB]; /* Offset of each output tensor within a slot */
+  uint32_t out_len[NN_OUTPUT_NB];
+  struct {
+    uint32_t inference_us;
+    uint32_t handoff_us;
+    uint32_t frame_period_us;
+    uint32_t frame_count;
+    uint32_t done_cycles;
+    uint32_t network;
+    buffer_frame_tag_t tag;
+#if NN_TILING == NN_TILING_FULL_FOV
+    uint32_t tile; /* Pipe2 tile of the frame */
+#elif NN_TILING == NN_TILING_ROI
+    cam_ml_tile_t area; /* Pipe2 window of the frame */
+#endif
+#if DUAL_STREAM_ENABLE
+    uint32_t stream; /* Sensor of the frame */
+#endif
+  } slot_stats[NN_OUTPUT_BUFFER_NB];
+  TX_THREAD thread;
+  UCHAR stack[NN_THREAD_STACK_SIZE];
+} nn_ctx;
+
+/* Post-processing frame arena, reset for each output slot: the cascade
+ * decode, the detector decode (its candidates before NMS and the tile merge)
+ * and the tracker take turns in it, so it holds the largest of them. In
+ * DTCM: the NMS passes over the candidates stay out of the D-cache */
+#define PP_ARENA_DECODE_SIZE \
+  (ARENA_SIZE_OF(od_pp_outBuffer_t, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB) + PP_ARENA_TILING_SIZE)
+#if NN_TILING == NN_TILING_FULL_FOV
+#define PP_ARENA_TILING_SIZE TILING_SCRATCH_SIZE
+#else
+#define PP_ARENA_TILING_SIZE 0U
+#endif
+#if CASCADE_ENABLE
+#define PP_ARENA_CASCADE_SIZE CASCADE_SCRATCH_SIZE
+#else
+#define PP_ARENA_CASCADE_SIZE 0U
+#endif
+#if TRACKER_ENABLE
+#define PP_ARENA_TRACKER_SIZE TRACKER_SCRATCH_SIZE
+#else
+#define PP_ARENA_TRACKER_SIZE 0U
+#endif
+#define PP_ARENA_SIZE MAX(MAX(PP_ARENA_DECODE_SIZE, PP_ARENA_CASCADE_SIZE), PP_ARENA_TRACKER_SIZE)
+
+static uint8_t pp_arena_storage[PP_ARENA_SIZE] IN_DTCM __attribute__((aligned(ARENA_ALIGN)));
+
+#if PP_EXCLUDE_ENABLE
+/* Decode exclusion masks per YOLOX level, cells then their per-anchor copies */
+#define PP_EXCLUDE_CELLS(lvl) \
+  AI_OD_ST_YOLOX_PP_CELL_MASK_BYTES(AI_OD_ST_YOLOX_PP_##lvl##_GRID_WIDTH, AI_OD_ST_YOLOX_PP_##lvl##_GRID_HEIGHT)
+#define PP_EXCLUDE_ANCHORS(lvl)                                                                            \
+  AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB(AI_OD_ST_YOLOX_PP_##lvl##_GRID_WIDTH, AI_OD_ST_YOLOX_PP_##lvl##_GRID_HEIGHT, \
+                                   AI_OD_ST_YOLOX_PP_NB_ANCHORS)
+
+static const float pp_exclude_rects[][4] = PP_EXCLUDE_RECTS;
+
+static struct {
+  uint8_t cells_l[PP_EXCLUDE_CELLS(L)];
+  uint8_t cells_m[PP_EXCLUDE_CELLS(M)];
+  uint8_t cells_s[PP_EXCLUDE_CELLS(S)];
+  uint16_t anchors_l[PP_EXCLUDE_ANCHORS(L)];
+  uint16_t anchors_m[PP_EXCLUDE_ANCHORS(M)];
+  uint16_t anchors_s[PP_EXCLUDE_ANCHORS(S)];
+} pp_exclude;
+#endif
+
+/* Result records: the one published, the one being filled, the UI's
+ * current and presented ones and the cascade's read of the last one, so
+ * publishing never waits on a reader */
+#define NN_RESULT_POOL_NB 5
+
+/* Post-processing thread resources */
+static struct {
+  app_postprocess_t pp;                      /* Bound to the active network */
+  app_postprocess_od_st_yolox_state_t state; /* State of pp */
+  app_pool_t results; /* NN_RESULT_POOL_NB records */
+  nn_result_t *latest; /* Published result, one reference held; swapped with interrupts off */
+  arena_t arena;       /* Over pp_arena_storage, this thread only */
+  arena_stage_t decode_stage;
+#if CASCADE_ENABLE
+  arena_stage_t cascade_stage;
+#endif
+#if TRACKER_ENABLE
+  arena_stage_t tracker_stage;
+#endif
+#if PP_CONF_ADAPT_ENABLE
+  int32_t conf_level;  /* Score threshold of the last run, 1/255; 0 before the first */
+  uint32_t candidates; /* Candidates ahead of NMS in the last run */
+#endif
+  TX_THREAD thread;
+  UCHAR stack[PP_THREAD_STACK_SIZE];
+} pp_ctx;
+
+/**
+ * @brief  Convert a DWT cycle delta to microseconds
+ */
+static uint32_t NN_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+#if PP_EXCLUDE_ENABLE
+/**
+ * @brief  Set the cells of one level whose centre lies in an excluded area
+ * @param  cells: Cell mask, one bit per cell in output tensor order
+ */
+static void PP_ExcludeLevel(uint8_t *cells, int32_t grid_width, int32_t grid_height) {
+  for (int32_t row = 0; row < grid_height; row++) {
+    for (int32_t col = 0; col < grid_width; col++) {
+      float x = (col + 0.5f) / grid_width;
+      float y = (row + 0.5f) / grid_height;
+
+      for (uint32_t i = 0; i < sizeof(pp_exclude_rects) / sizeof(pp_exclude_rects[0]); i++) {
+        const float *r = pp_exclude_rects[i];
+
+        if (x >= r[0] && x < r[2] && y >= r[1] && y < r[3]) {
+          int32_t cell = row * grid_width + col;
+
+          cells[cell >> 3] |= (uint8_t)(1U << (cell & 7));
+          break;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Build the exclusion masks and hand them to the post-processing
+ *         state; every network bind builds the per-anchor copies from them
+ */
+static void PP_ExcludeInit(void) {
+  PP_ExcludeLevel(pp_exclude.cells_l, AI_OD_ST_YOLOX_PP_L_GRID_WIDTH, AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT);
+  PP_ExcludeLevel(pp_exclude.cells_m, AI_OD_ST_YOLOX_PP_M_GRID_WIDTH, AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT);
+  PP_ExcludeLevel(pp_exclude.cells_s, AI_OD_ST_YOLOX_PP_S_GRID_WIDTH, AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT);
+
+  pp_ctx.state.pCellMask[AI_OD_ST_YOLOX_PP_LEVEL_L] = pp_exclude.cells_l;
+  pp_ctx.state.pCellMask[AI_OD_ST_YOLOX_PP_LEVEL_M] = pp_exclude.cells_m;
+  pp_ctx.state.pCellMask[AI_OD_ST_YOLOX_PP_LEVEL_S] = pp_exclude.cells_s;
+  pp_ctx.state.pAnchorMask[AI_OD_ST_YOLOX_PP_LEVEL_L] = pp_exclude.anchors_l;
+  pp_ctx.state.pAnchorMask[AI_OD_ST_YOLOX_PP_LEVEL_M] = pp_exclude.anchors_m;
+  pp_ctx.state.pAnchorMask[AI_OD_ST_YOLOX_PP_LEVEL_S] = pp_exclude.anchors_s;
+}
+#endif
+
+#if PP_CONF_ADAPT_ENABLE
+/**
+ * @brief  Score threshold of the next run, from the candidates of the last
+ * @param  base: pp.conf, the threshold the controller starts from and
+ *         returns to within PP_CONF_ADAPT_RECALL
+ * @retval Threshold, a multiple of 1/255
+ */
+static float PP_AdaptConf(float base) {
+  int32_t base_level = (int32_t)(base * 255.0f + 0.5f);
+  int32_t lo = MAX(base_level - PP_CONF_ADAPT_RECALL, 1);
+  int32_t hi = MAX(base_level, PP_CONF_ADAPT_MAX);
+  int32_t level = pp_ctx.conf_level;
+
+  if (level == 0) {
+    level = base_level;
+  } else if (pp_ctx.candidates > PP_CONF_ADAPT_BUDGET) {
+    level += PP_CONF_ADAPT_STEP_UP;
+  } else if (pp_ctx.candidates < PP_CONF_ADAPT_BUDGET / 2) {
+    level -= PP_CONF_ADAPT_STEP_DOWN;
+  }
+  /* Clamped after the step: a new pp.conf moves the range at once */
+  pp_ctx.conf_level = MIN(MAX(level, lo), hi);
+  return pp_ctx.conf_level / 255.0f;
+}
+#endif
+
+#if NN_MULTIRES_ENABLE
+/* Anchors of the NN_MULTIRES_SIDE detector, in its grid units */
+static float pp_multires_anchors[AI_OD_ST_YOLOX_PP_NB_LEVELS][2 * AI_OD_ST_YOLOX_PP_NB_ANCHORS];
+
+/**
+ * @brief  Fit the bound decode to the NN_MULTIRES_SIDE detector: its grids,
+ *         and the anchors scaled alike
+ * @note   The configured anchors are in cells of the ML_WIDTH grids. No
+ *         cell masks: the reset only rebuilds the int8 tables
+ */
+static void PP_FitMultiRes(void) {
+  od_st_yolox_pp_static_param_t *params = &pp_ctx.state.params;
+  const float scale = (float)NN_MULTIRES_SIDE / ML_WIDTH;
+
+  for (uint32_t i = 0; i < 2 * AI_OD_ST_YOLOX_PP_NB_ANCHORS; i++) {
+    pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_L][i] = AI_OD_ST_YOLOX_PP_L_ANCHORS[i] * scale;
+    pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_M][i] = AI_OD_ST_YOLOX_PP_M_ANCHORS[i] * scale;
+    pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_S][i] = AI_OD_ST_YOLOX_PP_S_ANCHORS[i] * scale;
+  }
+  params->grid_width_L = params->grid_height_L = PP_MULTIRES_GRID(L);
+  params->grid_width_M = params->grid_height_M = PP_MULTIRES_GRID(M);
+  params->grid_width_S = params->grid_height_S = PP_MULTIRES_GRID(S);
+  params->pAnchors_L = pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_L];
+  params->pAnchors_M = pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_M];
+  params->pAnchors_S = pp_multires_anchors[AI_OD_ST_YOLOX_PP_LEVEL_S];
+  APP_REQUIRE_EQ(app_postprocess_instance_reset(&pp_ctx.pp), AI_OD_POSTPROCESS_ERROR_NO);
+}
+#endif
+
+/**
+ * @brief  Record output tensor layout and check it fits an output slot
+ * @note   Fail-fast: panics if the network does not match NN_OUTPUT_SIZE
+ */
+static void NN_InitOutputLayout(void) {
+  const LL_Buffer_InfoTypeDef *out_info = LL_ATON_Output_Buffers_Info(MX_X_CUBE_AI_GetInstance());
+  uint32_t offset = 0;
+
+  APP_REQUIRE(out_info != NULL);
+
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    APP_REQUIRE(out_info[i].name != NULL);
+#if NN_OUTPUT_INT8
+    /* Quantized post-processing needs per-tensor scale and zero point */
+    APP_REQUIRE_EQ(out_info[i].type, DataType_INT8);
+    APP_REQUIRE(out_info[i].scale != NULL && out_info[i].offset != NULL);
+#else
+    APP_REQUIRE_EQ(out_info[i].type, DataType_FLOAT);
+#endif
+    nn_ctx.out_offset[i] = offset;
+    nn_ctx.out_len[i] = LL_Buffer_len(&out_info[i]);
+    offset += nn_ctx.out_len[i];
+  }
+
+  APP_REQUIRE(out_info[NN_OUTPUT_NB].name == NULL);
+#if NN_MULTIRES_ENABLE
+  APP_REQUIRE_EQ(offset, (nn_ctx.in_side == ML_WIDTH) ? NN_OUTPUT_SIZE : PP_MULTIRES_OUTPUT_SIZE);
+#else
+  APP_REQUIRE_EQ(offset, NN_OUTPUT_SIZE);
+#endif
+}
+
+/**
+ * @brief  Check every activation buffer lies inside a linker reservation
+ * @param  instance: Registered network instance
+ * @note   Fail-fast: panics if the reservations in the linker script are
+ *         stale for this network (activations would overlap linked data)
+ */
+static void NN_CheckActivationPlacement(NN_Instance_TypeDef *instance) {
+  const uint8_t *const banks[][2] = {
+      {__axisram2_npu_start, __axisram2_npu_end},
+      {__axisram3_npu_start, __axisram3_npu_end},
+      {__axisram4_npu_start, __axisram4_npu_end},
+      {__axisram5_npu_start, __axisram5_npu_end},
+      {__axisram6_npu_start, __axisram6_npu_end},
+      {__psram_npu_start, __psram_npu_end},
+  };
+  const LL_Buffer_InfoTypeDef *info = LL_ATON_Internal_Buffers_Info(instance);
+
+  APP_REQUIRE(info != NULL);
+
+  for (; info->name != NULL; info++) {
+    const uint8_t *start = LL_Buffer_addr_start(info);
+    const uint8_t *end = LL_Buffer_addr_end(info);
+    uint8_t placed = 0;
+
+    if (info->is_param || info->is_user_allocated) {
+      continue;
+    }
+    for (uint32_t b = 0; b < sizeof(banks) / sizeof(banks[0]); b++) {
+      if (start >= banks[b][0] && end <= banks[b][1]) {
+        placed = 1;
+        break;
+      }
+    }
+    APP_REQUIRE(placed);
+  }
+}
+
+#if ML_INPUT_ALIAS
+/**
+ * @brief  Make the input tensor of the active network the Pipe2 frame
+ * @note   Fail-fast: every network must read its input from the same
+ *         window, and nothing the runtime keeps across inferences may lie
+ *         in it. Between inferences only parameters placed in the pools
+ *         are live (the outputs are copied out before the next snapshot)
+ */
+static void NN_InitInputAlias(void) {
+  const LL_Buffer_InfoTypeDef *info = LL_ATON_Internal_Buffers_Info(MX_X_CUBE_AI_GetInstance());
+  const uint8_t *end = nn_ctx.in_buf + nn_ctx.in_len;
+
+  if (Buffer_GetMLCaptureBuffer(0) == NULL) {
+    Buffer_MLCapture_SetAlias(nn_ctx.in_buf);
+  }
+  APP_REQUIRE(Buffer_GetMLCaptureBuffer(0) == nn_ctx.in_buf);
+
+  APP_REQUIRE(info != NULL);
+  for (; info->name != NULL; info++) {
+    APP_REQUIRE(!info->is_param || LL_Buffer_addr_start(info) >= end ||
+                LL_Buffer_addr_end(info) <= nn_ctx.in_buf);
+  }
+}
+#endif
+
+/**
+ * @brief  Detect whether the network accepts user-allocated inputs
+ * @note   Requires a network generated with user-allocated inputs
+ *         (stedgeai --no-inputs-allocation); otherwise the setter reports
+ *         LL_ATON_User_IO_WRONG_INDEX and frames are copied instead
+ */
+static void NN_InitInputMode(void) {
+#if ML_PITCH_PADDED
+  /* The tensor is compiled packed: padded frames are gathered into it */
+  nn_ctx.zero_copy = 0;
+#else
+  LL_ATON_User_IO_Result_t ret;
+
+#if NN_MULTIRES_ENABLE
+  /* Smaller frames keep the ML_PITCH lines of the ring: gathered too */
+  if (nn_ctx.in_side != ML_WIDTH) {
+    nn_ctx.zero_copy = 0;
+    return;
+  }
+#endif
+  ret = LL_ATON_Set_User_Input_Buffer(MX_X_CUBE_AI_GetInstance(), 0,
+                                      Buffer_GetMLCaptureBuffer(0),
+                                      ML_WIDTH * ML_HEIGHT * ML_BPP);
+  APP_REQUIRE(ret == LL_ATON_User_IO_NOERROR || ret == LL_ATON_User_IO_WRONG_INDEX);
+
+  nn_ctx.zero_copy = (ret == LL_ATON_User_IO_NOERROR);
+#endif
+}
+
+/**
+ * @brief  Copy Pipe2 frame rows into the network-allocated input
+ * @param  frame: Capture slot
+ * @param  nn_in: Input tensor, packed lines
+ * @param  first: First row
+ * @param  last: Row after the last one
+ */
+static void NN_CopyRows(const uint8_t *frame, uint8_t *nn_in, uint32_t first, uint32_t last) {
+  const uint32_t line = NN_IN_WIDTH * ML_BPP;
+  uint8_t *dst = nn_in + first * line;
+
+  /* Padded lines, or a frame narrower than the ring's lines: gathered */
+  if (line != ML_PITCH) {
+    for (uint32_t y = first; y < last; y++) {
+      memcpy(nn_in + y * line, frame + y * ML_PITCH, line);
+    }
+  } else {
+    memcpy(dst, frame + first * line, (last - first) * line);
+  }
+  SCB_CleanDCache_by_Addr((void *)dst, (int32_t)((last - first) * line));
+}
+
+/**
+ * @brief  Bind a Pipe2 capture slot as the network input
+ * @param  capture_idx: ML capture slot index
+ * @param  nn_in: Network-allocated input buffer (copy mode only)
+ * @param  nn_in_len: Input size in bytes
+ */
+static void NN_BindInput(int capture_idx, uint8_t *nn_in, uint32_t nn_in_len) {
+  uint8_t *frame = Buffer_GetMLCaptureBuffer(capture_idx);
+
+  if (frame == nn_in) {
+    /* ML_INPUT_ALIAS: Pipe2 wrote the input tensor itself */
+    return;
+  }
+
+  if (nn_ctx.zero_copy) {
+    /* Capture ring is non-cacheable PSRAM: no cache maintenance needed */
+    APP_REQUIRE_EQ(LL_ATON_Set_User_Input_Buffer(MX_X_CUBE_AI_GetInstance(), 0, frame, nn_in_len),
+                   LL_ATON_User_IO_NOERROR);
+    return;
+  }
+
+  UNUSED(nn_in_len);
+  NN_CopyRows(frame, nn_in, 0, NN_IN_HEIGHT);
+}
+
+#if ML_SLICE_INGEST
+/**
+ * @brief  Copy the Pipe2 rows landed since the last call into the input
+ * @note   Inference thread, NPU idle: the input tensor shares the
+ *         activation pool of the running inference. A new capture restarts
+ *         from its first row
+ */
+static void NN_IngestRows(void) {
+  uint32_t landed = nn_ctx.rows.landed;
+  /* A capture at the other side is dropped at its frame event */
+  uint32_t rows = MIN(NN_ROWS_NB(landed), NN_IN_HEIGHT);
+
+  if (nn_ctx.zero_copy || landed == NN_ROWS_NONE) {
+    return;
+  }
+  if (NN_ROWS_KEY(landed) != nn_ctx.rows.key) {
+    nn_ctx.rows.key = NN_ROWS_KEY(landed);
+    nn_ctx.rows.copied = 0;
+  }
+  if (rows > nn_ctx.rows.copied) {
+    NN_CopyRows(Buffer_GetMLCaptureBuffer(NN_ROWS_SLOT(landed)), nn_ctx.in_buf, nn_ctx.rows.copied, rows);
+    nn_ctx.rows.copied = rows;
+  }
+}
+
+/**
+ * @brief  Whether the input already holds the whole frame of a slot
+ * @note   After NN_IngestRows() at its frame event: the acquired slot is
+ *         the capture of the last rows event, no newer one is armed yet
+ */
+static int NN_IngestedFrame(int capture_idx) {
+  uint32_t landed = nn_ctx.rows.landed;
+
+  return !nn_ctx.zero_copy && landed != NN_ROWS_NONE && NN_ROWS_SLOT(landed) == capture_idx &&
+         NN_ROWS_KEY(landed) == nn_ctx.rows.key && nn_ctx.rows.copied == NN_IN_HEIGHT;
+}
+#endif
+
+#if NPU_IDLE_GATE_ENABLE
+/**
+ * @brief  Suspend the NPU after a long enough run of skipped frames, if the
+ *         slowest wake-up seen still leaves the next inference on time
+ */
+static void NN_IdleSuspend(void) {
+  const uint32_t budget = CAM_GetMLDecimation() * 1000000U / (uint32_t)CAM_GetFrameRate();
+
+  if (nn_ctx.idle.suspended || ++nn_ctx.idle.gated_run < NPU_IDLE_GATE_FRAMES ||
+      nn_ctx.idle.inference_us + nn_ctx.idle.wake_max_us > budget) {
+    return;
+  }
+  MX_X_CUBE_AI_Suspend();
+  nn_ctx.idle.suspended = 1;
+  nn_ctx.idle.suspend_count++;
+}
+
+/**
+ * @brief  Bring the NPU back before an inference, timing the wake-up
+ */
+static void NN_IdleResume(void) {
+  uint32_t wake_start;
+
+  nn_ctx.idle.gated_run = 0;
+  if (!nn_ctx.idle.suspended) {
+    return;
+  }
+  wake_start = UI_GetCycleCount();
+  MX_X_CUBE_AI_Resume();
+#if MEMPOWER_ENABLE
+  /* The resume powers every activation bank */
+  MemPower_Apply();
+#endif
+  nn_ctx.idle.wake_max_us = MAX(nn_ctx.idle.wake_max_us, NN_CyclesToUs(UI_GetCycleCount() - wake_start));
+  nn_ctx.idle.suspended = 0;
+}
+#endif
+
+#if NN_MULTIRES_ENABLE
+/**
+ * @brief  Check an acquired ML capture slot is at the side of the network
+ * @retval 1 to infer the frame, 0 if it was captured before a switch and
+ *         released
+ */
+static int NN_MatchRes(int capture_idx) {
+  if (CAM_MLRes_Acquire(capture_idx) == nn_ctx.in_side) {
+    return 1;
+  }
+
+  Buffer_CameraDisplay_SetSyncFrame(Buffer_MLCapture_GetTag(capture_idx).frame_id);
+  Buffer_MLCapture_Release();
+  CAM_MLPipe_RequestSnapshot(UI_GetCycleCount());
+  return 0;
+}
+#endif
+
+#if MOTION_GATE_ENABLE
+/**
+ * @brief  Run the motion gate on an acquired ML capture slot
+ * @retval 1 to infer the frame, 0 if it was skipped and released
+ */
+static int NN_GateFrame(int capture_idx) {
+#if PIPE_BENCH
+  /* The test pattern never moves: every frame goes through the network */
+  (void)capture_idx;
+  return 1;
+#endif
+#if AUX_STREAM_ENABLE
+  /* The auxiliary stream shows the same scene: the ML slot is never read */
+  const uint8_t *frame = CAM_AuxPipe_GetFrame();
+
+  if (frame == NULL || Motion_ShouldRun(frame)) {
+    return 1;
+  }
+#else
+  if (Motion_ShouldRun(Buffer_GetMLCaptureBuffer(capture_idx))) {
+    return 1;
+  }
+#endif
+
+  /* Static scene: the last detections still hold, show the frame with them */
+  Buffer_CameraDisplay_SetSyncFrame(Buffer_MLCapture_GetTag(capture_idx).frame_id);
+  Buffer_MLCapture_Release();
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  /* The NPU stays idle: next frame as soon as possible */
+  CAM_MLPipe_RequestSnapshot(UI_GetCycleCount());
+#endif
+  nn_ctx.gated_count++;
+#if NPU_IDLE_GATE_ENABLE
+  NN_IdleSuspend();
+#endif
+  return 0;
+}
+#endif
+
+/**
+ * @brief  Copy the network outputs into an output slot
+ * @param  slot: Output slot pointer
+ */
+static void NN_CopyOutputs(uint8_t *slot) {
+  const LL_Buffer_InfoTypeDef *out_info = LL_ATON_Output_Buffers_Info(MX_X_CUBE_AI_GetInstance());
+
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    uint8_t *src = LL_Buffer_addr_start(&out_info[i]);
+
+    SCB_InvalidateDCache_by_Addr((void *)src, nn_ctx.out_len[i]);
+    memcpy(slot + nn_ctx.out_offset[i], src, nn_ctx.out_len[i]);
+  }
+}
+
+/**
+ * @brief  Check that Pipe2 pixel codes are the network input as captured
+ * @note   Fail-fast: Pipe2 has crop, scaler and gamma stages but no color
+ *         conversion (only Pipe1 has one; the ISP conversion feeds both
+ *         pipes), so it cannot add an offset: the input must be uint8 pixel
+ *         codes on [0, 1], scale 1/255 and zero point 0 on every channel. A
+ *         network regenerated with an int8 input (no conversion_0 QUANTIZE
+ *         epoch) would see every pixel off by 128
+ */
+static void NN_CheckInputQuant(const LL_Buffer_InfoTypeDef *in_info) {
+  const uint32_t nb = in_info->per_channel ? ML_BPP : 1U;
+
+  APP_REQUIRE(in_info->type == DataType_UINT8 && in_info->Qunsigned);
+  APP_REQUIRE(in_info->scale != NULL && in_info->offset != NULL);
+  for (uint32_t c = 0; c < nb; c++) {
+    APP_REQUIRE(fabsf(in_info->scale[c] * 255.0f - 1.0f) < 1e-3f);
+    APP_REQUIRE_EQ(in_info->offset[c], 0);
+  }
+}
+
+#if NN_EPOCH_CONTROLLER
+/**
+ * @brief  Check the network runs its hardware epochs as epoch controller blobs
+ * @note   Fail-fast: a network generated without --enable-epoch-controller
+ *         would run epoch by epoch, silently
+ */
+static void NN_CheckEpochBlob(NN_Instance_TypeDef *instance) {
+  const EpochBlock_ItemTypeDef *eb = instance->network->epoch_block_items();
+  uint32_t blobs = 0;
+
+  APP_REQUIRE(eb != NULL);
+  for (; !EpochBlock_IsLastEpochBlock(eb); eb++) {
+    APP_REQUIRE(EpochBlock_IsEpochBlob(eb) || EpochBlock_IsEpochPureSW(eb));
+    blobs += EpochBlock_IsEpochBlob(eb);
+  }
+  APP_REQUIRE(blobs > 0);
+}
+#endif
+
+/**
+ * @brief  Resolve everything that depends on the active network
+ * @note   Fail-fast: panics if the network does not fit the pipeline
+ *         (activation reservations, input size and quantization, output
+ *         slot layout)
+ */
+static void NN_BindNetwork(void) {
+  const LL_Buffer_InfoTypeDef *in_info = LL_ATON_Input_Buffers_Info(MX_X_CUBE_AI_GetInstance());
+
+  APP_REQUIRE(in_info != NULL);
+  nn_ctx.in_buf = LL_Buffer_addr_start(&in_info[0]);
+  nn_ctx.in_len = LL_Buffer_len(&in_info[0]);
+#if NN_MULTIRES_ENABLE
+  nn_ctx.in_side = (nn_ctx.in_len == NN_MULTIRES_SIDE * NN_MULTIRES_SIDE * ML_BPP) ? NN_MULTIRES_SIDE : ML_WIDTH;
+  /* Gathered into: the network must have its own input tensor */
+  APP_REQUIRE(nn_ctx.in_side == ML_WIDTH || !in_info[0].is_user_allocated);
+  CAM_MLRes_Set(nn_ctx.in_side);
+#endif
+  APP_REQUIRE_EQ(nn_ctx.in_len, NN_IN_WIDTH * NN_IN_HEIGHT * ML_BPP);
+  NN_CheckInputQuant(&in_info[0]);
+
+  NN_CheckActivationPlacement(MX_X_CUBE_AI_GetInstance());
+#if ML_INPUT_ALIAS
+  NN_InitInputAlias();
+#endif
+  NN_InitInputMode();
+#if ML_SLICE_INGEST
+  /* Rows copied so far went to the input of the previous network */
+  nn_ctx.rows.key = NN_ROWS_NONE;
+#endif
+#if ML_INPUT_ALIAS
+  /* A user-allocated input has no tensor of its own to capture into */
+  APP_REQUIRE(!nn_ctx.zero_copy);
+#endif
+  NN_InitOutputLayout();
+
+  /* For the bind: every run decodes into the frame arena */
+  pp_ctx.state.pOutBuff = (od_pp_outBuffer_t *)(void *)pp_arena_storage;
+  pp_ctx.state.out_nb = APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB;
+  APP_REQUIRE_EQ(app_postprocess_instance_init(&pp_ctx.pp, app_postprocess_od_st_yolox_select(MX_X_CUBE_AI_GetInstance()),
+                                               &pp_ctx.state, MX_X_CUBE_AI_GetInstance()),
+                 AI_OD_POSTPROCESS_ERROR_NO);
+#if NN_MULTIRES_ENABLE
+  if (nn_ctx.in_side != ML_WIDTH) {
+    PP_FitMultiRes();
+  }
+#endif
+}
+
+/**
+ * @brief  Switch the active network (inference thread, between inferences)
+ * @param  id: Registered network (MX_X_CUBE_AI_Network_t)
+ * @note   Waits for the post-processing thread to drain every slot in flight:
+ *         output layout and quantization parameters change with the network
+ */
+static void NN_SwitchNetwork(uint32_t id) {
+  ULONG held[NN_OUTPUT_BUFFER_NB - 1];
+
+#if MEMPOWER_ENABLE
+  /* Up before the runtime sets the network up on them */
+  MemPower_Wake(id);
+#endif
+
+  /* The caller already holds one slot */
+  for (uint32_t i = 0; i < NN_OUTPUT_BUFFER_NB - 1; i++) {
+    APP_REQUIRE_EQ(tx_queue_receive(&nn_ctx.free_queue, &held[i], TX_WAIT_FOREVER), TX_SUCCESS);
+  }
+
+  MX_X_CUBE_AI_SelectNetwork(id);
+  NN_BindNetwork();
+#if NPU_SCHED_ENABLE
+  NPUSched_CheckDisjoint(MX_X_CUBE_AI_GetInstance(), MX_X_CUBE_AI_GetNetwork(CASCADE_NETWORK));
+#endif
+#if MEMPOWER_ENABLE
+  MemPower_Apply();
+#endif
+
+  for (uint32_t i = 0; i < NN_OUTPUT_BUFFER_NB - 1; i++) {
+    APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &held[i], TX_NO_WAIT), TX_SUCCESS);
+  }
+}
+
+#if NN_WARMUP_INFERENCES || SELFTEST_ENABLE
+/**
+ * @brief  Output tensors of a boot run, where the CPU reads them
+ * @param  pp_input: NN_OUTPUT_NB tensors, in network order
+ */
+static void NN_BootOutputs(void **pp_input) {
+  const LL_Buffer_InfoTypeDef *out_info = LL_ATON_Output_Buffers_Info(MX_X_CUBE_AI_GetInstance());
+
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    pp_input[i] = LL_Buffer_addr_start(&out_info[i]);
+    SCB_InvalidateDCache_by_Addr(pp_input[i], nn_ctx.out_len[i]);
+  }
+}
+
+/**
+ * @brief  Decode the outputs of a boot run in place, through the arena
+ * @note   The detections live in the arena until its next reset
+ */
+static void NN_BootDecode(void **pp_input, od_pp_out_t *pp_output) {
+  Arena_Reset(&pp_ctx.arena);
+  pp_ctx.state.pOutBuff = ARENA_ALLOC(&pp_ctx.arena, od_pp_outBuffer_t, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB);
+  APP_REQUIRE_EQ(app_postprocess_instance_run(&pp_ctx.pp, pp_input, NN_OUTPUT_NB, pp_output),
+                 AI_OD_POSTPROCESS_ERROR_NO);
+}
+#endif
+
+#if NN_WARMUP_INFERENCES
+/**
+ * @brief  Run the boot network on a zeroed input and decode it, dropped
+ * @note   NN_Init(), pipes stopped: the input and the post-processing arena
+ *         are not in use yet. A run that timed out (HEALTH_MONITOR) has
+ *         recovered the NPU and is just one warm-up less
+ */
+static void NN_Warmup(void) {
+  uint8_t *in = nn_ctx.zero_copy ? Buffer_GetMLCaptureBuffer(0) : nn_ctx.in_buf;
+  void *pp_input[NN_OUTPUT_NB];
+  od_pp_out_t pp_output;
+
+  memset(in, 0, nn_ctx.in_len);
+  SCB_CleanDCache_by_Addr((void *)in, (int32_t)nn_ctx.in_len);
+  for (uint32_t i = 0; i < NN_WARMUP_INFERENCES; i++) {
+    (void)MX_X_CUBE_AI_Run();
+  }
+
+  /* Decoded in place: an output slot holds the same bytes */
+  NN_BootOutputs(pp_input);
+  NN_BootDecode(pp_input, &pp_output);
+  Arena_Reset(&pp_ctx.arena);
+}
+#endif
+
+#if SELFTEST_ENABLE
+/**
+ * @brief  Run the boot network once on the golden vector input and check
+ *         the run against its record
+ * @note   NN_Init(), after the warm-up: the time is a steady-state one
+ */
+static void NN_SelfTest(void) {
+  const uint8_t *golden = SelfTest_GetInput(nn_ctx.in_len);
+  uint8_t *in = nn_ctx.zero_copy ? Buffer_GetMLCaptureBuffer(0) : nn_ctx.in_buf;
+  void *pp_input[NN_OUTPUT_NB];
+  od_pp_out_t pp_output;
+  uint32_t check = 2166136261U; /* FNV-1a */
+  uint32_t start;
+  uint32_t cycles;
+
+  if (golden == NULL) {
+    return;
+  }
+
+  memcpy(in, golden, nn_ctx.in_len);
+  SCB_CleanDCache_by_Addr((void *)in, (int32_t)nn_ctx.in_len);
+  start = DWT->CYCCNT;
+  (void)MX_X_CUBE_AI_Run();
+  cycles = DWT->CYCCNT - start;
+
+  /* Hashed before the decode reads them */
+  NN_BootOutputs(pp_input);
+  for (int i = 0; i < NN_OUTPUT_NB; i++) {
+    const uint8_t *out = pp_input[i];
+
+    for (uint32_t b = 0; b < nn_ctx.out_len[i]; b++) {
+      check ^= out[b];
+      check *= 16777619U;
+    }
+  }
+  NN_BootDecode(pp_input, &pp_output);
+  SelfTest_Check(check, pp_output.pOutBuff, (uint32_t)MAX(pp_output.nb_detect, 0), NN_CyclesToUs(cycles));
+  Arena_Reset(&pp_ctx.arena);
+}
+#endif
+
+/**
+ * @brief  Initialize the inference pipeline
+ */
+IN_XIP void NN_Init(VOID *memory_ptr) {
+  SPSC_Init(&nn_ctx.frame_queue, nn_ctx.frame_queue_storage, sizeof(nn_frame_desc_t), NN_FRAME_QUEUE_NB);
+#if ML_SLICE_INGEST
+  nn_ctx.rows.landed = NN_ROWS_NONE;
+#endif
+  APP_REQUIRE_EQ(tx_event_flags_create(&nn_ctx.events, "nn_events"), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_queue_create(&nn_ctx.free_queue, "nn_free", TX_1_ULONG,
+                                 nn_ctx.free_queue_storage, sizeof(nn_ctx.free_queue_storage)),
+                 TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_queue_create(&nn_ctx.ready_queue, "nn_ready", TX_1_ULONG,
+                                 nn_ctx.ready_queue_storage, sizeof(nn_ctx.ready_queue_storage)),
+                 TX_SUCCESS);
+  Pool_Create(&pp_ctx.results, "nn_results", sizeof(nn_result_t), NN_RESULT_POOL_NB, memory_ptr);
+  Arena_Init(&pp_ctx.arena, pp_arena_storage, sizeof(pp_arena_storage));
+  /* Readers always find a result: an empty one until the first inference */
+  pp_ctx.latest = Pool_Alloc(&pp_ctx.results, TX_NO_WAIT);
+  APP_REQUIRE(pp_ctx.latest != NULL);
+  memset(pp_ctx.latest, 0, sizeof(*pp_ctx.latest));
+
+  for (ULONG slot = 0; slot < NN_OUTPUT_BUFFER_NB; slot++) {
+    APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &slot, TX_NO_WAIT), TX_SUCCESS);
+  }
+
+#if NPU_WEIGHT_CIPHER
+  /* Before the first inference: the weights are read through the cipher */
+  NPUCipher_LoadKeys();
+#endif
+
+#if defined(LL_ATON_RT_RELOC)
+  /* Fail-fast: NN_RELOC builds expect a valid binary in a model slot */
+  APP_REQUIRE_EQ(MX_X_CUBE_AI_InstallReloc(Slots_GetModelAddress()), AI_RELOC_RT_ERR_NONE);
+  NN_CheckActivationPlacement(MX_X_CUBE_AI_GetNetwork(MX_X_CUBE_AI_NET_RELOC));
+#endif
+
+#if WEIGHT_STAGE_ENABLE
+  /* After the relocatable network: its weights are staged too */
+  WStage_Init();
+#endif
+#if NN_EPOCH_CONTROLLER
+  NN_CheckEpochBlob(MX_X_CUBE_AI_GetNetwork(MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON));
+#endif
+
+  nn_ctx.requested_network = MX_X_CUBE_AI_GetActiveNetwork();
+#if NN_MULTIRES_ENABLE
+  /* Boot network: the ML_WIDTH detector */
+  MultiRes_Init(nn_ctx.requested_network);
+#endif
+#if PP_EXCLUDE_ENABLE
+  PP_ExcludeInit();
+#endif
+  NN_BindNetwork();
+
+#if CASCADE_ENABLE
+  Cascade_Init((od_pp_outBuffer_t *)(void *)pp_arena_storage, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB);
+  NN_CheckActivationPlacement(MX_X_CUBE_AI_GetNetwork(CASCADE_NETWORK));
+#if NPU_SCHED_ENABLE
+  /* In flight together with the detector: fail-fast on shared activations */
+  MX_X_CUBE_AI_SetCompanion(CASCADE_NETWORK);
+  NPUSched_CheckDisjoint(MX_X_CUBE_AI_GetInstance(), MX_X_CUBE_AI_GetNetwork(CASCADE_NETWORK));
+#endif
+#endif
+
+#if MEMPOWER_ENABLE
+  /* Every boot network bound: the boot runs below use the final layout */
+  MemPower_Init();
+#endif
+
+#if MOTION_GATE_ENABLE
+  Motion_Init();
+#endif
+#if TRACKER_ENABLE
+  Tracker_Init();
+#endif
+#if ANALYTICS_ENABLE
+  Analytics_Init();
+#endif
+
+  NPUCache_Init();
+
+#if NN_EPOCH_PROFILER
+  Profiler_Init();
+#endif
+
+#if WEIGHT_PREFETCH_ENABLE
+  /* After the profiler: chains its epoch callback */
+  Prefetch_Init();
+#endif
+
+#if NN_WARMUP_INFERENCES
+  /* Every hook but the bandwidth report sees the cold runs */
+  NN_Warmup();
+#endif
+#if SELFTEST_ENABLE
+  NN_SelfTest();
+#endif
+#if NN_EPOCH_PROFILER && (NN_WARMUP_INFERENCES || SELFTEST_ENABLE)
+  /* Boot runs: not part of the first published window */
+  Profiler_ResetWindow();
+#endif
+
+#if NPU_BW_REPORT
+  /* Last: arms the counters before the other callbacks run */
+  NPUBw_Init();
+#endif
+}
+
+/**
+ * @brief  Signal that a new Pipe2 frame is ready (ISR context)
+ */
+void NN_SignalFrameReady(int slot) {
+  const nn_frame_desc_t desc = {
+      .slot = slot,
+      .frame_id = Buffer_MLCapture_GetTag(slot).frame_id,
+      .cycles = UI_GetCycleCount(),
+  };
+
+  (void)SPSC_Push(&nn_ctx.frame_queue, &desc);
+  tx_event_flags_set(&nn_ctx.events, NN_EVENT_FRAME, TX_OR);
+}
+
+#if ML_SLICE_INGEST
+/**
+ * @brief  Signal the Pipe2 rows written so far into a snapshot (ISR context)
+ */
+void NN_SignalRows(int slot, uint32_t capture, uint32_t rows) {
+  nn_ctx.rows.landed = ((uint32_t)slot << 24) | ((capture & 0xFFU) << 16) | rows;
+  tx_event_flags_set(&nn_ctx.events, NN_EVENT_ROWS, TX_OR);
+}
+#endif
+
+/**
+ * @brief  Drain the frame events queued since the last wake-up
+ * @param  capture_idx: Slot just acquired, -1 if none
+ * @retval Frame event to now, in us, for that frame; 0 if its event was
+ *         dropped or no slot was acquired
+ * @note   The ISR queues a frame's event before the slot can be acquired,
+ *         so the event of the acquired frame is always in this batch
+ */
+static uint32_t NN_DrainFrameEvents(int capture_idx) {
+  const uint32_t frame_id = (capture_idx >= 0) ? Buffer_MLCapture_GetTag(capture_idx).frame_id : 0;
+  nn_frame_desc_t desc;
+  uint32_t handoff_us = 0;
+
+  while (SPSC_Pop(&nn_ctx.frame_queue, &desc)) {
+    if (desc.slot == capture_idx && desc.frame_id == frame_id) {
+      handoff_us = NN_CyclesToUs(UI_GetCycleCount() - desc.cycles);
+    }
+  }
+  return handoff_us;
+}
+
+/**
+ * @brief  Request a network switch, applied before the next inference
+ */
+void NN_RequestNetwork(uint32_t id) {
+  APP_REQUIRE(MX_X_CUBE_AI_GetNetwork(id) != NULL);
+#if NPU_SCHED_ENABLE
+  /* Owned by the interleaved second stage */
+  if (id == CASCADE_NETWORK) {
+    return;
+  }
+#endif
+  nn_ctx.requested_network = id;
+}
+
+/**
+ * @brief  Take a reference to the latest published result
+ */
+const nn_result_t *NN_AcquireResult(void) {
+  nn_result_t *result;
+  TX_INTERRUPT_SAVE_AREA
+
+  /* The publisher drops its reference only after the swap */
+  TX_DISABLE
+  result = pp_ctx.latest;
+  Pool_Retain(result);
+  TX_RESTORE
+
+  return result;
+}
+
+/**
+ * @brief  Take one more reference to a result already held
+ */
+void NN_RetainResult(const nn_result_t *result) {
+  Pool_Retain((void *)result);
+}
+
+/**
+ * @brief  Drop a reference taken by NN_AcquireResult() or NN_RetainResult()
+ */
+void NN_ReleaseResult(const nn_result_t *result) {
+  Pool_Release((void *)result);
+}
+
+/**
+ * @brief  Make a filled result the latest, dropping the reference to the
+ *         previous one (post-processing thread)
+ */
+static void NN_PublishResult(nn_result_t *result) {
+  nn_result_t *previous;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  previous = pp_ctx.latest;
+  pp_ctx.latest = result;
+  TX_RESTORE
+
+  Pool_Release(previous);
+}
+
+#if CASCADE_ENABLE
+/**
+ * @brief  Take the most confident detections of the last published result
+ * @param  cands: Output candidates, highest confidence first
+ * @retval Number of candidates (at most CASCADE_TOP_K)
+ */
+static uint32_t NN_CascadeCandidates(nn_detection_t *cands) {
+  const nn_result_t *result = NN_AcquireResult();
+  uint32_t nb = 0;
+
+  for (uint32_t i = 0; i < result->nb_detect; i++) {
+    const nn_detection_t *det = &result->detections[i];
+    uint32_t pos = nb;
+
+    if (nb == CASCADE_TOP_K && det->conf <= cands[nb - 1].conf) {
+      continue;
+    }
+    if (nb < CASCADE_TOP_K) {
+      nb++;
+    } else {
+      pos--;
+    }
+    while (pos > 0 && cands[pos - 1].conf < det->conf) {
+      cands[pos] = cands[pos - 1];
+      pos--;
+    }
+    cands[pos] = *det;
+  }
+  NN_ReleaseResult(result);
+
+  return nb;
+}
+#endif
+
+#if ML_INPUT_ALIAS
+/**
+ * @brief  Request the next Pipe2 frame into the input tensor, the NPU done
+ *         with the activations
+ * @note   Their dirty lines over the tensor are dropped first: written back
+ *         later, they would land over the frame being captured
+ */
+static void NN_RequestAliasSnapshot(void) {
+  SCB_InvalidateDCache_by_Addr((void *)nn_ctx.in_buf, (int32_t)nn_ctx.in_len);
+  CAM_MLPipe_RequestSnapshot(UI_GetCycleCount());
+}
+#endif
+
+/**
+ * @brief  Inference thread entry
+ *         Takes the newest Pipe2 frame, runs the network and hands the
+ *         outputs to the post-processing thread
+ */
+static void nn_thread_entry(ULONG arg) {
+  UNUSED(arg);
+  uint32_t frame_count = 0;
+  uint32_t last_done = 0;
+  uint32_t start = 0;
+#if NN_SNAPSHOT_AHEAD
+  uint32_t busy_cycles = 0; /* Frame taken to ready for the next one, last frame */
+#endif
+#if CASCADE_ENABLE
+  nn_detection_t cands[CASCADE_TOP_K];
+  uint32_t nb_cand;
+  uint32_t last_inference_us = 0;
+#endif
+#if NPU_SCHED_ENABLE
+  npu_sched_job_t jobs[2];
+#endif
+#if DVFS_ENABLE
+  uint32_t busy_us = 0; /* Last frame, taken to outputs copied */
+#endif
+
+  while (1) {
+    ULONG slot;
+    int capture_idx;
+    uint32_t handoff_us;
+    uint32_t done;
+    uint32_t network;
+    int ran;
+
+#if DVFS_ENABLE
+    uint32_t slot_wait = UI_GetCycleCount();
+#endif
+    /* Reserve an output slot first so the frame taken below is the freshest */
+    APP_REQUIRE_EQ(tx_queue_receive(&nn_ctx.free_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+#if NN_SNAPSHOT_AHEAD
+    /* Waits for the frame itself excluded: they follow the arming point */
+    busy_cycles = (frame_count > 0) ? UI_GetCycleCount() - start : 0;
+#endif
+
+    /* Frame boundary: no capture slot is held and the NPU is idle */
+    network = nn_ctx.requested_network;
+    if (network != MX_X_CUBE_AI_GetActiveNetwork()) {
+      NN_SwitchNetwork(network);
+    }
+#if PARAMS_ENABLE
+    Params_FrameBoundary();
+#endif
+#if PROFILE_ENABLE
+    Profile_FrameBoundary();
+#endif
+#if DVFS_ENABLE
+    /* A post-processing backlog holds the slot: that wait is work too */
+    DVFS_FrameBoundary(busy_us ? busy_us + NN_CyclesToUs(UI_GetCycleCount() - slot_wait) : 0);
+#endif
+    nn_ctx.slot_stats[slot].network = network;
+
+#if HEALTH_MONITOR && ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+    /* A snapshot is owed from here on; a continuous Pipe2 is always checked */
+    Health_Arm(HEALTH_STAGE_PIPE2);
+#endif
+    do {
+      ULONG events;
+
+#if ML_SLICE_INGEST
+      APP_REQUIRE_EQ(tx_event_flags_get(&nn_ctx.events, NN_EVENT_FRAME | NN_EVENT_ROWS, TX_OR_CLEAR, &events,
+                                        TX_WAIT_FOREVER),
+                     TX_SUCCESS);
+      /* Bands landed while the previous inference ran, then one per event */
+      NN_IngestRows();
+      if ((events & NN_EVENT_FRAME) == 0U) {
+        capture_idx = -1;
+        continue;
+      }
+#else
+      APP_REQUIRE_EQ(tx_event_flags_get(&nn_ctx.events, NN_EVENT_FRAME, TX_OR_CLEAR, &events, TX_WAIT_FOREVER),
+                     TX_SUCCESS);
+#endif
+      capture_idx = Buffer_MLCapture_Acquire();
+      handoff_us = NN_DrainFrameEvents(capture_idx);
+#if NN_MULTIRES_ENABLE && MOTION_GATE_ENABLE
+    } while (capture_idx < 0 || !NN_MatchRes(capture_idx) || !NN_GateFrame(capture_idx));
+#elif NN_MULTIRES_ENABLE
+    } while (capture_idx < 0 || !NN_MatchRes(capture_idx));
+#elif MOTION_GATE_ENABLE
+    } while (capture_idx < 0 || !NN_GateFrame(capture_idx));
+#else
+    } while (capture_idx < 0);
+#endif
+#if HEALTH_MONITOR && ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+    Health_Disarm(HEALTH_STAGE_PIPE2);
+#endif
+#if NPU_IDLE_GATE_ENABLE
+    NN_IdleResume();
+#endif
+
+    start = UI_GetCycleCount();
+    nn_ctx.slot_stats[slot].tag = Buffer_MLCapture_GetTag(capture_idx);
+    nn_ctx.slot_stats[slot].handoff_us = handoff_us;
+#if NN_TILING == NN_TILING_FULL_FOV
+    nn_ctx.slot_stats[slot].tile = CAM_MLTile_Acquire(capture_idx);
+#elif NN_TILING == NN_TILING_ROI
+    nn_ctx.slot_stats[slot].area = CAM_MLRoi_Acquire(capture_idx);
+#endif
+#if DUAL_STREAM_ENABLE
+    nn_ctx.slot_stats[slot].stream = CAM_MLStream_Get(capture_idx);
+#endif
+
+    /* In zero-copy mode the slot stays held until the NPU has read it */
+#if ML_SLICE_INGEST
+    if (!NN_IngestedFrame(capture_idx)) {
+      NN_BindInput(capture_idx, nn_ctx.in_buf, nn_ctx.in_len);
+    }
+    nn_ctx.rows.key = NN_ROWS_NONE;
+#else
+    NN_BindInput(capture_idx, nn_ctx.in_buf, nn_ctx.in_len);
+#endif
+#if DATASET_ENABLE
+    /* Kept past the release when taken: post-processing decides */
+    Dataset_Offer(slot, capture_idx);
+#endif
+#if CASCADE_ENABLE
+    /* Crops use the previous frame's boxes and must be taken while the slot is held */
+    nb_cand = NN_CascadeCandidates(cands);
+    /* Interleaved, the crops are needed before the detector starts */
+    if (!nn_ctx.zero_copy || NPU_SCHED_ENABLE) {
+      Cascade_Prepare(slot, Buffer_GetMLCaptureBuffer(capture_idx), cands, nb_cand, last_inference_us);
+    }
+#endif
+    if (!nn_ctx.zero_copy) {
+      Buffer_MLCapture_Release();
+    }
+
+#if NN_SNAPSHOT_AHEAD
+    /* Next frame, due when this one is expected to be done with */
+    CAM_MLPipe_RequestSnapshot(start + busy_cycles);
+#endif
+    TRACE_BEGIN_ARG(NN_INFERENCE, nn_ctx.slot_stats[slot].tag.frame_id);
+#if NPU_SCHED_ENABLE
+    /* Second stage alongside the detector, in its SW epochs and the NPU gaps */
+    jobs[0] = (npu_sched_job_t){.instance = MX_X_CUBE_AI_GetInstance(), .priority = 0};
+    Cascade_InitJob(slot, start, &jobs[1]);
+    ran = NPUSched_Run(jobs, 2) && jobs[0].status == NPU_SCHED_DONE;
+    Cascade_EndJob(slot);
+#else
+    ran = MX_X_CUBE_AI_Run();
+#endif
+    TRACE_END(NN_INFERENCE);
+    if (!ran) {
+      /* NPU hung and recovered: drop the frame, which is still shown */
+      if (nn_ctx.zero_copy) {
+        Buffer_MLCapture_Release();
+      }
+#if DATASET_ENABLE
+      Dataset_Discard(slot);
+#endif
+      Buffer_CameraDisplay_SetSyncFrame(nn_ctx.slot_stats[slot].tag.frame_id);
+#if ML_INPUT_ALIAS
+      NN_RequestAliasSnapshot();
+#endif
+      APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+      continue;
+    }
+
+    if (nn_ctx.zero_copy) {
+#if CASCADE_ENABLE && !NPU_SCHED_ENABLE
+      Cascade_Prepare(slot, Buffer_GetMLCaptureBuffer(capture_idx), cands, nb_cand, last_inference_us);
+#endif
+      Buffer_MLCapture_Release();
+    }
+
+    TRACE_BEGIN(NN_COPY_OUTPUTS);
+    NN_CopyOutputs(Buffer_GetNNOutputBuffer(slot));
+    TRACE_END(NN_COPY_OUTPUTS);
+    done = UI_GetCycleCount();
+
+#if CASCADE_ENABLE
+    /* Second stage in the rest of the frame budget; reuses the activations */
+#if NPU_SCHED_ENABLE
+    /* The detector alone: the crops ran alongside it */
+    last_inference_us = NN_CyclesToUs(jobs[0].done_cycles - start);
+#else
+    last_inference_us = NN_CyclesToUs(done - start);
+    Cascade_Run(slot, last_inference_us);
+#endif
+#endif
+
+    frame_count++;
+    nn_ctx.slot_stats[slot].inference_us = NN_CyclesToUs(done - start);
+#if DVFS_ENABLE
+    busy_us = nn_ctx.slot_stats[slot].inference_us;
+#endif
+#if NPU_IDLE_GATE_ENABLE
+    nn_ctx.idle.inference_us = nn_ctx.slot_stats[slot].inference_us;
+#endif
+    nn_ctx.slot_stats[slot].frame_period_us = (frame_count > 1) ? NN_CyclesToUs(done - last_done) : 0;
+    nn_ctx.slot_stats[slot].frame_count = frame_count;
+    nn_ctx.slot_stats[slot].done_cycles = done;
+    last_done = done;
+#if ML_INPUT_ALIAS
+    /* The outputs are out and the second stage is done with the activations */
+    NN_RequestAliasSnapshot();
+#endif
+
+    APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.ready_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+  }
+}
+
+/**
+ * @brief  Post-processing thread entry
+ *         Decodes YOLOX outputs, runs NMS and publishes the detections
+ */
+static void pp_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  while (1) {
+    ULONG slot;
+    uint8_t *out_buf;
+    void *pp_input[NN_OUTPUT_NB];
+    od_pp_out_t pp_output;
+#if CASCADE_ENABLE
+    nn_cascade_t cascade;
+#endif
+    uint32_t start, done, elapsed_us;
+    uint32_t nb_detect;
+    nn_result_t *result;
+    UINT threshold;
+
+    APP_REQUIRE_EQ(tx_queue_receive(&nn_ctx.ready_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+    Arena_Reset(&pp_ctx.arena);
+
+    out_buf = Buffer_GetNNOutputBuffer(slot);
+    for (int i = 0; i < NN_OUTPUT_NB; i++) {
+      pp_input[i] = out_buf + nn_ctx.out_offset[i];
+    }
+
+    /* Keep the priority-5 ISP thread from preempting decode and NMS */
+    CAM_IspDefer_Begin();
+#if CASCADE_ENABLE
+    /* First: its candidates go back to the arena before the detector's */
+    Arena_BeginStage(&pp_ctx.arena, &pp_ctx.cascade_stage);
+    Cascade_Decode(slot, &cascade, &pp_ctx.arena);
+    Arena_EndStage(&pp_ctx.arena, &pp_ctx.cascade_stage);
+#endif
+#if PARAMS_ENABLE
+    /* Read every run: a change applies from the next frame and outlives
+     * the re-init of a network switch */
+    pp_ctx.state.params.conf_threshold = Params_GetFloat(PARAM_PP_CONF);
+    pp_ctx.state.params.iou_threshold = Params_GetFloat(PARAM_PP_IOU);
+#endif
+#if PP_CONF_ADAPT_ENABLE
+#if PARAMS_ENABLE
+    pp_ctx.state.params.conf_threshold = PP_AdaptConf(Params_GetFloat(PARAM_PP_CONF));
+#else
+    pp_ctx.state.params.conf_threshold = PP_AdaptConf(AI_OD_ST_YOLOX_PP_CONF_THRESHOLD);
+#endif
+#endif
+    Arena_BeginStage(&pp_ctx.arena, &pp_ctx.decode_stage);
+    pp_ctx.state.pOutBuff = ARENA_ALLOC(&pp_ctx.arena, od_pp_outBuffer_t, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB);
+    start = UI_GetCycleCount();
+    TRACE_BEGIN(PP_DECODE);
+    APP_REQUIRE_EQ(app_postprocess_instance_run(&pp_ctx.pp, pp_input, NN_OUTPUT_NB, &pp_output),
+                   AI_OD_POSTPROCESS_ERROR_NO);
+    TRACE_END(PP_DECODE);
+    done = UI_GetCycleCount();
+    CAM_IspDefer_End();
+    elapsed_us = NN_CyclesToUs(done - start);
+#if PP_CONF_ADAPT_ENABLE
+    /* The decode leaves its candidate count ahead of NMS in the params */
+    pp_ctx.candidates = (uint32_t)pp_ctx.state.params.nb_detect;
+    TRACE_COUNTER(PP_CANDIDATES, pp_ctx.candidates);
+#endif
+
+    nb_detect = MIN((uint32_t)pp_output.nb_detect, NN_MAX_DETECTIONS);
+    TRACE_COUNTER(PP_DETECTIONS, nb_detect);
+#if DATASET_ENABLE
+    Dataset_Decide(slot, pp_output.pOutBuff, nb_detect, pp_ctx.state.params.conf_threshold);
+#endif
+
+#if NN_TILING == NN_TILING_FULL_FOV
+    /* Results are published once per sweep; the frame is still shown */
+    if (!Tiling_AddTile(nn_ctx.slot_stats[slot].tile, pp_output.pOutBuff, nb_detect)) {
+      Arena_EndStage(&pp_ctx.arena, &pp_ctx.decode_stage);
+      Buffer_CameraDisplay_SetSyncFrame(nn_ctx.slot_stats[slot].tag.frame_id);
+      APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+      continue;
+    }
+#endif
+
+    /* Filled in place, then handed over by pointer; one record is always
+     * free (NN_RESULT_POOL_NB) */
+    result = Pool_Alloc(&pp_ctx.results, TX_WAIT_FOREVER);
+#if NN_TILING == NN_TILING_FULL_FOV
+    nb_detect = Tiling_Merge(result->detections, NN_MAX_DETECTIONS, &pp_ctx.arena);
+#elif NN_TILING == NN_TILING_ROI
+    Tiling_MapWindow(&nn_ctx.slot_stats[slot].area, pp_output.pOutBuff, nb_detect, result->detections);
+    Tiling_UpdateRoi(result->detections, nb_detect);
+#else
+    for (uint32_t i = 0; i < nb_detect; i++) {
+      const od_pp_outBuffer_t *det = &pp_output.pOutBuff[i];
+      result->detections[i] = (nn_detection_t){
+          .x_center = det->x_center,
+          .y_center = det->y_center,
+          .width = det->width,
+          .height = det->height,
+          .conf = det->conf,
+          .class_index = det->class_index,
+      };
+    }
+#endif
+    /* The candidates are copied out */
+    Arena_EndStage(&pp_ctx.arena, &pp_ctx.decode_stage);
+    result->nb_detect = nb_detect;
+    result->frame_count = nn_ctx.slot_stats[slot].frame_count;
+    result->inference_us = nn_ctx.slot_stats[slot].inference_us;
+    result->handoff_us = nn_ctx.slot_stats[slot].handoff_us;
+    result->frame_period_us = nn_ctx.slot_stats[slot].frame_period_us;
+    result->network = nn_ctx.slot_stats[slot].network;
+    result->frame_id = nn_ctx.slot_stats[slot].tag.frame_id;
+    result->vsync_cycles = nn_ctx.slot_stats[slot].tag.vsync_cycles;
+    result->npu_done_cycles = nn_ctx.slot_stats[slot].done_cycles;
+    result->post_done_cycles = done;
+    result->postprocess_us = elapsed_us;
+    result->conf_threshold = pp_ctx.state.params.conf_threshold;
+#if MOTION_GATE_ENABLE
+    result->gated_count = nn_ctx.gated_count;
+#endif
+#if NPU_IDLE_GATE_ENABLE
+    result->npu_suspend_count = nn_ctx.idle.suspend_count;
+    result->npu_wake_max_us = nn_ctx.idle.wake_max_us;
+#endif
+#if CASCADE_ENABLE
+    result->cascade = cascade;
+#endif
+#if DUAL_STREAM_ENABLE
+    result->stream = nn_ctx.slot_stats[slot].stream;
+    CAM_MLStream_Report(result->stream, nb_detect);
+    if (result->stream != 0U) {
+      /* Second sensor: reported, not shown nor tracked. Its frame still
+       * releases the display frames captured before it */
+#if TELEMETRY
+      Telemetry_PublishResult(result);
+#endif
+      NN_ReleaseResult(result);
+      Buffer_CameraDisplay_SetSyncFrame(nn_ctx.slot_stats[slot].tag.frame_id);
+      APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+      continue;
+    }
+#endif
+    /* Hand-off to the overlay: the inference thread waits for the UI event,
+     * so the display sync frame never lags the published result */
+    APP_REQUIRE_EQ(tx_thread_preemption_change(&pp_ctx.thread,
+                                               MIN(PP_HANDOFF_THRESHOLD, pp_ctx.thread.tx_thread_user_priority),
+                                               &threshold),
+                   TX_SUCCESS);
+    NN_PublishResult(result);
+#if NS_SPLIT
+    /* Published: read back through this thread's own pointer */
+    NSShare_Publish(result);
+#endif
+#if TELEMETRY
+    Telemetry_PublishResult(result);
+#endif
+    BOOT_MARK_FIRST(BOOT_PHASE_FIRST_INFERENCE);
+    /* The update in trial reached a published inference */
+    Slots_Confirm();
+
+#if MOTION_GATE_ENABLE
+    Motion_SetTracking(nb_detect);
+#endif
+#if NN_MULTIRES_ENABLE
+    MultiRes_Update(result->network, result->detections, nb_detect);
+#endif
+#if TRACKER_ENABLE
+    /* Only this thread releases the latest result: it stays valid here */
+    TRACE_BEGIN(PP_TRACKER);
+    Arena_BeginStage(&pp_ctx.arena, &pp_ctx.tracker_stage);
+    Tracker_Update(result->detections, nb_detect, result->vsync_cycles, &pp_ctx.arena);
+    Arena_EndStage(&pp_ctx.arena, &pp_ctx.tracker_stage);
+#if ANALYTICS_ENABLE
+    Analytics_Update(result->vsync_cycles);
+#endif
+    TRACE_END(PP_TRACKER);
+#endif
+
+    /* Release the display frame these detections belong to */
+    Buffer_CameraDisplay_SetSyncFrame(result->frame_id);
+    UI_PostEvent(UI_EVENT_DETECTIONS);
+    APP_REQUIRE_EQ(tx_thread_preemption_change(&pp_ctx.thread, threshold, &threshold), TX_SUCCESS);
+
+    APP_REQUIRE_EQ(tx_queue_send(&nn_ctx.free_queue, &slot, TX_WAIT_FOREVER), TX_SUCCESS);
+  }
+}
+
+/**
+ * @brief  Initialize and start the inference and post-processing threads
+ * @param  memory_ptr: Unused (static allocation)
+ * @note   Fail-fast: panics on unrecoverable failures
+ */
+void Thread_NN_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  APP_REQUIRE_EQ(tx_thread_create(&nn_ctx.thread, "nn_inference",
+                                  nn_thread_entry, 0,
+                                  nn_ctx.stack, NN_THREAD_STACK_SIZE,
+                                  NN_THREAD_PRIORITY, NN_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+
+  APP_REQUIRE_EQ(tx_thread_create(&pp_ctx.thread, "nn_postprocess",
+                                  pp_thread_entry, 0,
+                                  pp_ctx.stack, PP_THREAD_STACK_SIZE,
+                                  PP_THREAD_PRIORITY, PP_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
@@ -0,0 +1,471 @@
+/**
+ ******************************************************************************
+ * @file    app_nnbench.c
+ * @author  Long Liangmao
+ * @brief   Inference latency benchmark implementation for STM32N6570-DK
+ *
+ *          Built as Firmware_Bench: the camera pipeline never starts, one
+ *          thread brings the NPU up and runs od_yolo_x_person on a fixed
+ *          pseudo-random input. Each variant starts with a cold inference
+ *          (network re-initialized, NPU cache and CPU caches invalidated),
+ *          then NNBENCH_ITERATIONS warm ones; the epoch callback stamps the
+ *          DWT cycle counter around every epoch block and the CACHEAXI
+ *          monitors count the NPU cache hits. Variants: NPU cache on, NPU
+ *          cache off and, with WEIGHT_STAGE_ENABLE or WEIGHT_PREFETCH_ENABLE,
+ *          weights read in place instead of staged; the first cold inference
+ *          also learns the prefetch schedule. The boot copy of the weight
+ *          staging is timed once, before the variants. Overlapped SW epochs (LL_ATON_RT_SW_OVERLAP)
+ *          count in the HW epoch they ran under. With NPU_PLACE_EXPERIMENT
+ *          the cache variant then runs once per activation layout, AXISRAM
+ *          banks moved to the hyperRAM (app_npu_place.c), its outputs
+ *          checked against the generated layout. key=value lines go to the
+ *          ST-LINK virtual COM port.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nnbench.h"
+
+#if NN_BENCH
+
+#include "app_error.h"
+#include "app_npu_cache.h"
+#include "app_npu_cipher.h"
+#include "app_npu_place.h"
+#include "app_prefetch.h"
+#include "app_profiler.h"
+#include "app_wstage.h"
+#include "app_x-cube-ai.h"
+#include "ll_aton_osal_user_impl.h"
+#include "stm32n6570_discovery.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if PP_BENCH
+#error "NN_BENCH and PP_BENCH are separate images (Firmware_Bench, Firmware_PPBench)"
+#endif
+
+#define NNBENCH_THREAD_STACK_SIZE 4096
+#define NNBENCH_THREAD_PRIORITY 5
+#define NNBENCH_UART_BAUDRATE 921600U /* As THREAD_PROFILER_UART */
+#define NNBENCH_INPUT_SEED 1U         /* The same input on every build */
+
+typedef enum {
+  NNBENCH_VARIANT_CACHE = 0, /* As the application runs */
+  NNBENCH_VARIANT_NOCACHE,   /* NPU cache disabled */
+  NNBENCH_VARIANT_XIP,       /* Weights read in place from the octoFlash */
+  NNBENCH_VARIANT_NB,
+} nnbench_variant_t;
+
+static const char *const nnbench_variant_names[NNBENCH_VARIANT_NB] = {
+    [NNBENCH_VARIANT_CACHE] = "cache",
+    [NNBENCH_VARIANT_NOCACHE] = "nocache",
+    [NNBENCH_VARIANT_XIP] = "xip",
+};
+
+typedef struct {
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} nnbench_stat_t;
+
+static struct {
+  TX_THREAD thread;
+  ULONG stack[NNBENCH_THREAD_STACK_SIZE / sizeof(ULONG)];
+
+  /* Epochs of the warm inferences of the running variant */
+  uint8_t measuring;
+  uint32_t block_start;
+  int16_t last_epoch;
+  char kind[PROFILER_MAX_EPOCHS];
+  uint64_t epoch_cycles[PROFILER_MAX_EPOCHS];
+} bench_ctx;
+
+/* Fixed input when the network takes user-allocated inputs */
+static uint8_t bench_input[ML_WIDTH * ML_HEIGHT * ML_BPP] ALIGN_32 IN_PSRAM;
+
+/**
+ * @brief  Epoch block callback (benchmark thread context)
+ */
+static void NNBench_EpochCallback(LL_ATON_RT_Callbacktype_t ctype, const NN_Instance_TypeDef *nn_instance,
+                                  const EpochBlock_ItemTypeDef *eb) {
+  int16_t epoch;
+
+  UNUSED(nn_instance);
+
+  if (eb == NULL) {
+    return;
+  }
+  if (ctype == LL_ATON_RT_Callbacktype_PRE_START) {
+    bench_ctx.block_start = DWT->CYCCNT;
+    return;
+  }
+  if (ctype != LL_ATON_RT_Callbacktype_POST_END) {
+    return;
+  }
+
+  epoch = eb->epoch_num;
+  if (!bench_ctx.measuring || epoch < 0 || epoch >= PROFILER_MAX_EPOCHS) {
+    return;
+  }
+  bench_ctx.epoch_cycles[epoch] += DWT->CYCCNT - bench_ctx.block_start;
+  if (bench_ctx.kind[epoch] == 0) {
+    bench_ctx.kind[epoch] = EpochBlock_IsEpochPureSW(eb)   ? PROFILER_EPOCH_SW
+                            : EpochBlock_IsEpochHybrid(eb) ? PROFILER_EPOCH_HYBRID
+                                                           : PROFILER_EPOCH_HW;
+  }
+  bench_ctx.last_epoch = MAX(bench_ctx.last_epoch, epoch);
+}
+
+/**
+ * @brief  Write the fixed input and bind it as the network input
+ * @note   After every network initialization: the binding is part of it
+ */
+static void NNBench_BindInput(NN_Instance_TypeDef *instance) {
+  const LL_Buffer_InfoTypeDef *in_info = LL_ATON_Input_Buffers_Info(instance);
+  uint8_t *in = bench_input;
+  uint32_t len;
+  uint32_t seed = NNBENCH_INPUT_SEED;
+  LL_ATON_User_IO_Result_t ret;
+
+  APP_REQUIRE(in_info != NULL);
+  len = LL_Buffer_len(&in_info[0]);
+  APP_REQUIRE_EQ(len, sizeof(bench_input));
+
+  /* Network-allocated input: written in place, as the copy mode does */
+  ret = LL_ATON_Set_User_Input_Buffer(instance, 0, bench_input, len);
+  APP_REQUIRE(ret == LL_ATON_User_IO_NOERROR || ret == LL_ATON_User_IO_WRONG_INDEX);
+  if (ret == LL_ATON_User_IO_WRONG_INDEX) {
+    in = LL_Buffer_addr_start(&in_info[0]);
+#if NPU_PLACE_EXPERIMENT
+    in = NPUPlace_Translate(in);
+#endif
+  }
+
+  for (uint32_t i = 0; i < len; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    in[i] = (uint8_t)(seed >> 24);
+  }
+  SCB_CleanDCache_by_Addr((void *)in, (int32_t)len);
+}
+
+/**
+ * @brief  One inference on the bound input
+ * @retval DWT cycles, first epoch block started to last one done
+ */
+static uint32_t NNBench_Infer(NN_Instance_TypeDef *instance) {
+  LL_ATON_RT_RetValues_t ret;
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles;
+
+  do {
+    ret = LL_ATON_RT_RunEpochBlock(instance);
+    if (ret == LL_ATON_RT_WFE) {
+      LL_ATON_OSAL_WFE();
+#if HEALTH_MONITOR
+      /* No recovery: a hung epoch block voids the figures */
+      APP_REQUIRE(!NPU_OSAL_TakeTimeout());
+#endif
+    }
+  } while (ret != LL_ATON_RT_DONE);
+  cycles = DWT->CYCCNT - start;
+
+  LL_ATON_RT_Reset_Network(instance);
+  return cycles;
+}
+
+static void NNBench_Accumulate(nnbench_stat_t *stat, uint32_t cycles) {
+  stat->min = MIN(stat->min, cycles);
+  stat->max = MAX(stat->max, cycles);
+  stat->sum += cycles;
+}
+
+static uint32_t NNBench_Us(uint64_t cycles) {
+  return (uint32_t)(cycles / (SystemCoreClock / 1000000U));
+}
+
+static uint32_t NNBench_Permille(uint32_t part, uint32_t total) {
+  return total ? (uint32_t)(((uint64_t)part * 1000U) / total) : 0;
+}
+
+/**
+ * @brief  Cold inference then NNBENCH_ITERATIONS warm ones, printed
+ */
+static void NNBench_RunVariant(NN_Instance_TypeDef *instance, nnbench_variant_t variant) {
+  const char *name = nnbench_variant_names[variant];
+  nnbench_stat_t warm = {.min = UINT32_MAX};
+  npu_cache_counters_t cold_cache, cache, total;
+  uint32_t cold;
+
+  if (variant == NNBENCH_VARIANT_NOCACHE) {
+    npu_cache_disable();
+  } else {
+    npu_cache_enable();
+  }
+#if WEIGHT_STAGE_ENABLE
+  WStage_SetEnabled(variant != NNBENCH_VARIANT_XIP);
+#endif
+#if WEIGHT_PREFETCH_ENABLE
+  Prefetch_SetEnabled(variant != NNBENCH_VARIANT_XIP);
+#endif
+
+  /* Cold: fresh network state, nothing of the weights or code in a cache */
+  LL_ATON_RT_DeInit_Network(instance);
+  LL_ATON_RT_Init_Network(instance);
+  NNBench_BindInput(instance);
+  npu_cache_invalidate();
+  SCB_CleanInvalidateDCache();
+  SCB_InvalidateICache();
+
+  NPUCache_ResetCounters();
+  cold = NNBench_Infer(instance);
+  NPUCache_GetCounters(&cold_cache);
+
+  memset(&total, 0, sizeof(total));
+  memset(bench_ctx.epoch_cycles, 0, sizeof(bench_ctx.epoch_cycles));
+  bench_ctx.measuring = 1;
+  for (int it = 0; it < NNBENCH_ITERATIONS; it++) {
+    npu_cache_counters_t start;
+
+    /* The monitors saturate: restart them for every inference */
+    NPUCache_ResetCounters();
+    NPUCache_GetCounters(&start);
+    NNBench_Accumulate(&warm, NNBench_Infer(instance));
+    NPUCache_GetCounters(&cache);
+    NPUCache_Accumulate(&total, &start, &cache);
+  }
+  bench_ctx.measuring = 0;
+
+  printf("nnbench variant=%s cold_cycles=%lu cold_us=%lu cold_read_hit_permille=%lu "
+         "warm_mean_cycles=%lu warm_min_cycles=%lu warm_max_cycles=%lu warm_mean_us=%lu "
+         "warm_read_hit_permille=%lu warm_read_misses=%lu warm_evictions=%lu\r\n",
+         name, (unsigned long)cold, (unsigned long)NNBench_Us(cold),
+         (unsigned long)NNBench_Permille(cold_cache.read_hits, cold_cache.read_hits + cold_cache.read_misses),
+         (unsigned long)(warm.sum / NNBENCH_ITERATIONS), (unsigned long)warm.min, (unsigned long)warm.max,
+         (unsigned long)NNBench_Us(warm.sum / NNBENCH_ITERATIONS),
+         (unsigned long)NNBench_Permille(total.read_hits, total.read_hits + total.read_misses),
+         (unsigned long)(total.read_misses / NNBENCH_ITERATIONS),
+         (unsigned long)(total.evictions / NNBENCH_ITERATIONS));
+
+  for (int e = 0; e <= bench_ctx.last_epoch; e++) {
+    if (bench_ctx.kind[e] == 0) {
+      continue;
+    }
+    printf("nnbench variant=%s epoch=%d kind=%c mean_cycles=%lu\r\n", name, e, bench_ctx.kind[e],
+           (unsigned long)(bench_ctx.epoch_cycles[e] / NNBENCH_ITERATIONS));
+  }
+}
+
+#if NPU_PLACE_EXPERIMENT
+/**
+ * @brief  FNV-1a of the output tensors, where the layout put them
+ */
+static uint32_t NNBench_OutputCheck(NN_Instance_TypeDef *instance) {
+  const LL_Buffer_InfoTypeDef *out_info = LL_ATON_Output_Buffers_Info(instance);
+  uint32_t hash = 2166136261U;
+
+  APP_REQUIRE(out_info != NULL);
+  for (; out_info->name != NULL; out_info++) {
+    const uint8_t *out = NPUPlace_Translate(LL_Buffer_addr_start(out_info));
+    uint32_t len = LL_Buffer_len(out_info);
+
+    SCB_InvalidateDCache_by_Addr((void *)out, (int32_t)len);
+    for (uint32_t i = 0; i < len; i++) {
+      hash ^= out[i];
+      hash *= 16777619U;
+    }
+  }
+  return hash;
+}
+
+/**
+ * @brief  NNBENCH_ITERATIONS warm inferences with the moved banks in the
+ *         hyperRAM mirror, after one to settle the caches
+ * @retval Mean warm cycles
+ */
+static uint32_t NNBench_RunLayout(NN_Instance_TypeDef *instance, uint32_t moved, uint32_t *check,
+                                  uint32_t *straddles) {
+  nnbench_stat_t warm = {.min = UINT32_MAX};
+
+  NPUPlace_SetMoved(moved);
+  LL_ATON_RT_DeInit_Network(instance);
+  LL_ATON_RT_Init_Network(instance);
+  NNBench_BindInput(instance);
+  (void)NPUPlace_TakeStraddles();
+
+  (void)NNBench_Infer(instance);
+  for (int it = 0; it < NNBENCH_ITERATIONS; it++) {
+    NNBench_Accumulate(&warm, NNBench_Infer(instance));
+  }
+  *check = NNBench_OutputCheck(instance);
+  *straddles = NPUPlace_TakeStraddles();
+  return (uint32_t)(warm.sum / NNBENCH_ITERATIONS);
+}
+
+/**
+ * @brief  Every combination of the NNBENCH_POOL_MOVES banks the network
+ *         uses, as the cache variant, then the fastest valid one freeing at
+ *         least NNBENCH_POOL_FREE_MIN bytes
+ */
+static void NNBench_RunLayouts(NN_Instance_TypeDef *instance) {
+  uint32_t in_use = 0;
+  uint32_t ref_check = 0;
+  uint32_t base = 0;
+  uint32_t best = UINT32_MAX;
+  uint32_t best_cycles = UINT32_MAX;
+  uint32_t best_freed = 0;
+
+  npu_cache_enable();
+#if WEIGHT_STAGE_ENABLE
+  WStage_SetEnabled(1);
+#endif
+#if WEIGHT_PREFETCH_ENABLE
+  Prefetch_SetEnabled(1);
+#endif
+  for (uint32_t bank = NPU_PLACE_BANK_FIRST; bank <= NPU_PLACE_BANK_LAST; bank++) {
+    if ((NNBENCH_POOL_MOVES & (1U << bank)) != 0U && NPUPlace_BankBytes(bank) != 0U) {
+      in_use |= 1U << bank;
+    }
+  }
+
+  /* Moved 0 first: the generated layout is the reference */
+  for (uint32_t moved = 0; moved <= in_use; moved++) {
+    uint32_t freed = 0;
+    uint32_t check;
+    uint32_t straddles;
+    uint32_t cycles;
+    int valid;
+
+    if ((moved & ~in_use) != 0U) {
+      continue;
+    }
+    for (uint32_t bank = NPU_PLACE_BANK_FIRST; bank <= NPU_PLACE_BANK_LAST; bank++) {
+      if ((moved & (1U << bank)) != 0U) {
+        freed += NPUPlace_BankBytes(bank);
+      }
+    }
+
+    cycles = NNBench_RunLayout(instance, moved, &check, &straddles);
+    if (moved == 0U) {
+      ref_check = check;
+      base = cycles;
+    }
+    valid = check == ref_check && straddles == 0U;
+    printf("nnbench layout moved=0x%02lx freed_bytes=%lu warm_mean_cycles=%lu warm_mean_us=%lu "
+           "delta_permille=%ld straddles=%lu valid=%d\r\n",
+           (unsigned long)moved, (unsigned long)freed, (unsigned long)cycles, (unsigned long)NNBench_Us(cycles),
+           (long)(((int64_t)cycles - base) * 1000 / base), (unsigned long)straddles, valid);
+
+    if (valid && freed >= NNBENCH_POOL_FREE_MIN && cycles < best_cycles) {
+      best = moved;
+      best_cycles = cycles;
+      best_freed = freed;
+    }
+  }
+  NPUPlace_SetMoved(0);
+
+  if (best == UINT32_MAX) {
+    printf("nnbench layout_best none free_min=%lu\r\n", (unsigned long)NNBENCH_POOL_FREE_MIN);
+    return;
+  }
+  printf("nnbench layout_best moved=0x%02lx freed_bytes=%lu warm_mean_us=%lu delta_permille=%ld\r\n",
+         (unsigned long)best, (unsigned long)best_freed, (unsigned long)NNBench_Us(best_cycles),
+         (long)(((int64_t)best_cycles - base) * 1000 / base));
+}
+#endif
+
+static void NNBench_ThreadEntry(ULONG arg) {
+  NN_Instance_TypeDef *instance;
+
+  UNUSED(arg);
+
+  /* As the application brings the NPU up, less the pipeline */
+  MX_X_CUBE_AI_Init();
+  NPUCache_Init();
+#if NPU_WEIGHT_CIPHER
+  NPUCipher_LoadKeys();
+#endif
+  MX_X_CUBE_AI_SelectNetwork(MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON);
+  instance = MX_X_CUBE_AI_GetNetwork(MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON);
+  APP_REQUIRE(instance != NULL);
+#if WEIGHT_STAGE_ENABLE
+  WStage_Init();
+#endif
+
+  /* First: the prefetch chains the callback it finds */
+  bench_ctx.last_epoch = -1;
+  LL_ATON_RT_SetEpochCallback(NNBench_EpochCallback, instance);
+#if WEIGHT_PREFETCH_ENABLE
+  Prefetch_Init();
+#endif
+
+  printf("nnbench network=od_yolo_x_person cpu_mhz=%lu npu_mhz=%lu iterations=%d "
+         "weight_prefetch=%d npu_cache_policy=%d\r\n",
+         (unsigned long)(SystemCoreClock / 1000000U), (unsigned long)(HAL_RCC_GetNPUClockFreq() / 1000000U),
+         NNBENCH_ITERATIONS, WEIGHT_PREFETCH_ENABLE, NPU_CACHE_POLICY);
+#if WEIGHT_STAGE_ENABLE
+  wstage_stats_t stage;
+
+  WStage_GetStats(&stage);
+  printf("nnbench weight_stage spans=%lu bytes=%lu shared=%lu boot_us=%lu\r\n", (unsigned long)stage.nb_spans,
+         (unsigned long)stage.bytes, (unsigned long)stage.shared, (unsigned long)stage.us);
+#endif
+
+  for (uint32_t v = 0; v < NNBENCH_VARIANT_NB; v++) {
+    if (v == NNBENCH_VARIANT_XIP && !WEIGHT_PREFETCH_ENABLE && !WEIGHT_STAGE_ENABLE) {
+      /* Already in place: the cache variant is it */
+      continue;
+    }
+    NNBench_RunVariant(instance, (nnbench_variant_t)v);
+  }
+#if NPU_PLACE_EXPERIMENT
+  NNBench_RunLayouts(instance);
+#endif
+  npu_cache_enable();
+  printf("nnbench done\r\n");
+
+  BSP_LED_On(LED_GREEN);
+  tx_thread_suspend(tx_thread_identify());
+}
+
+void NNBench_Init(VOID *memory_ptr) {
+  /* With TELEMETRY the port is already open, its TX owned by the DMA */
+#if !TELEMETRY
+  COM_InitTypeDef com_init = {
+      .BaudRate = NNBENCH_UART_BAUDRATE,
+      .WordLength = COM_WORDLENGTH_8B,
+      .StopBits = COM_STOPBITS_1,
+      .Parity = COM_PARITY_NONE,
+      .HwFlowCtl = COM_HWCONTROL_NONE,
+  };
+
+#endif
+
+  UNUSED(memory_ptr);
+
+#if !TELEMETRY
+  APP_REQUIRE_EQ(BSP_COM_Init(COM1, &com_init), BSP_ERROR_NONE);
+#endif
+
+  /* The UI, which would enable the cycle counter, never starts */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  APP_REQUIRE_EQ(tx_thread_create(&bench_ctx.thread, "nnbench", NNBench_ThreadEntry, 0, bench_ctx.stack,
+                                  sizeof(bench_ctx.stack), NNBENCH_THREAD_PRIORITY, NNBENCH_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+#endif /* NN_BENCH */
@@ -0,0 +1,294 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_bw.c
+ * @author  Long Liangmao
+ * @brief   NPU bandwidth report implementation for STM32N6570-DK
+ *
+ *          Around every epoch block, one debug and trace counter runs per
+ *          stream engine of the block, counting the cycles its stream switch
+ *          link moves data, and one counts the block cycles. The stream
+ *          engine hook tells which memory pool each engine was set up on.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_npu_bw.h"
+
+#if NPU_BW_REPORT
+
+#include "app_error.h"
+#include "app_x-cube-ai.h"
+#include "ll_aton_dbgtrc.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+#ifndef LL_ATON_EB_DBG_INFO
+#error "NPU_BW_REPORT needs the stream engine masks of LL_ATON_EB_DBG_INFO"
+#endif
+
+/* Debug and trace unit 0: 16 event counters. Counter 0 times the block,
+ * counter 1 + n follows stream engine n */
+#define NPU_BW_DBGTRC 0
+#define NPU_BW_COUNTERS 16
+#define NPU_BW_WINDOW_COUNTER 0
+#define NPU_BW_ENGINE_COUNTER(n) (1 + (n))
+
+#if ATON_STRENG_NUM + 1 > NPU_BW_COUNTERS
+#error "Not enough debug and trace counters for every stream engine"
+#endif
+
+/* Memory pool address ranges, matched on the first byte of a tensor */
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+  uint8_t pool;
+} npu_bw_range_t;
+
+static const npu_bw_range_t npu_bw_ranges[] = {
+    {0x24000000U, 0x24400000U, NPU_BW_POOL_AXISRAM}, /* AXISRAM1-6, non-secure alias */
+    {0x34000000U, 0x34400000U, NPU_BW_POOL_AXISRAM}, /* AXISRAM1-6, secure alias */
+    {0x90000000U, 0xA0000000U, NPU_BW_POOL_PSRAM},   /* xSPI1 hyperRAM */
+    {0x70000000U, 0x80000000U, NPU_BW_POOL_FLASH},   /* xSPI2 octoFlash */
+};
+
+static struct {
+  struct {
+    NN_Instance_TypeDef *instance;
+    TraceEpochBlock_FuncPtr_t chained; /* Callback set before NPUBw_Init() */
+  } nets[MX_X_CUBE_AI_NET_NB];
+
+  /* Running inference, inference thread */
+  const NN_Instance_TypeDef *running;
+  uint32_t in_mask; /* Engines of the armed block, 0 when not armed */
+  uint32_t out_mask;
+  uint8_t pool[ATON_STRENG_NUM];
+  npu_bw_report_t frame;
+
+  /* Last completed inference per network, guarded by mutex */
+  TX_MUTEX mutex;
+  npu_bw_report_t published[MX_X_CUBE_AI_NET_NB];
+} bw_ctx;
+
+/**
+ * @brief  Registry index of a hooked network
+ */
+static int NPUBw_FindNetwork(const NN_Instance_TypeDef *instance) {
+  for (int id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    if (bw_ctx.nets[id].instance == instance) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Set up and start the counters of an epoch block
+ */
+static void NPUBw_Arm(const EpochBlock_ItemTypeDef *eb) {
+  LL_Dbgtrc_Counter_InitTypdef counter = {
+      .signal = DBGTRC_VDD,
+      .evt_type = DBGTRC_EVT_HI,
+      .int_disable = 1,
+  };
+
+  bw_ctx.in_mask = eb->in_streng_mask;
+  bw_ctx.out_mask = eb->out_streng_mask;
+  memset(bw_ctx.pool, NPU_BW_POOL_OTHER, sizeof(bw_ctx.pool));
+
+  /* Pure SW epochs: no stream engine to follow */
+  if ((bw_ctx.in_mask | bw_ctx.out_mask) == 0) {
+    return;
+  }
+
+  LL_Dbgtrc_Counter_Init(NPU_BW_DBGTRC, NPU_BW_WINDOW_COUNTER, &counter);
+
+  /* A stall signal is high while its link is stalled or idle: count it low.
+   * Input engines feed the switch (its output links), output engines drain it */
+  counter.evt_type = DBGTRC_EVT_LOW;
+  for (int n = 0; n < ATON_STRENG_NUM; n++) {
+    if (bw_ctx.in_mask & (1U << n)) {
+      counter.signal = SWITCH_OSTRX_STALL + n;
+    } else if (bw_ctx.out_mask & (1U << n)) {
+      counter.signal = SWITCH_ISTRX_STALL + n;
+    } else {
+      continue;
+    }
+    LL_Dbgtrc_Counter_Init(NPU_BW_DBGTRC, NPU_BW_ENGINE_COUNTER(n), &counter);
+  }
+
+  /* Engines are enabled last by the block start: nothing runs uncounted */
+  LL_Dbgtrc_Counter_Start(NPU_BW_DBGTRC, NPU_BW_WINDOW_COUNTER);
+  for (int n = 0; n < ATON_STRENG_NUM; n++) {
+    if ((bw_ctx.in_mask | bw_ctx.out_mask) & (1U << n)) {
+      LL_Dbgtrc_Counter_Start(NPU_BW_DBGTRC, NPU_BW_ENGINE_COUNTER(n));
+    }
+  }
+}
+
+/**
+ * @brief  Stop the counters of the armed block and attribute them to the pools
+ */
+static void NPUBw_Collect(void) {
+  uint32_t engines = bw_ctx.in_mask | bw_ctx.out_mask;
+  uint32_t window, critical_active = 0;
+  int critical_pool = NPU_BW_POOL_OTHER;
+
+  if (engines == 0) {
+    return;
+  }
+
+  LL_Dbgtrc_Counter_Stop(NPU_BW_DBGTRC, NPU_BW_WINDOW_COUNTER);
+  for (int n = 0; n < ATON_STRENG_NUM; n++) {
+    if (engines & (1U << n)) {
+      LL_Dbgtrc_Counter_Stop(NPU_BW_DBGTRC, NPU_BW_ENGINE_COUNTER(n));
+    }
+  }
+
+  window = LL_Dbgtrc_Counter_Read(NPU_BW_DBGTRC, NPU_BW_WINDOW_COUNTER);
+  for (int n = 0; n < ATON_STRENG_NUM; n++) {
+    npu_bw_pool_t *pool = &bw_ctx.frame.pools[bw_ctx.pool[n]];
+    uint32_t active;
+
+    if (!(engines & (1U << n))) {
+      continue;
+    }
+
+    active = MIN(LL_Dbgtrc_Counter_Read(NPU_BW_DBGTRC, NPU_BW_ENGINE_COUNTER(n)), window);
+    if (bw_ctx.in_mask & (1U << n)) {
+      pool->in_active += active;
+      pool->in_stall += window - active;
+    } else {
+      pool->out_active += active;
+      pool->out_stall += window - active;
+    }
+
+    /* The block lasts as long as its busiest engine */
+    if (active > critical_active) {
+      critical_active = active;
+      critical_pool = bw_ctx.pool[n];
+    }
+  }
+
+  bw_ctx.frame.pools[critical_pool].critical_cycles += window;
+  bw_ctx.frame.pools[critical_pool].critical_blocks++;
+  bw_ctx.frame.block_cycles += window;
+  bw_ctx.frame.nb_blocks++;
+  bw_ctx.in_mask = 0;
+  bw_ctx.out_mask = 0;
+}
+
+/**
+ * @brief  Epoch block callback (inference thread context)
+ */
+static void NPUBw_EpochCallback(LL_ATON_RT_Callbacktype_t ctype,
+                                const NN_Instance_TypeDef *nn_instance,
+                                const EpochBlock_ItemTypeDef *eb) {
+  int id = NPUBw_FindNetwork(nn_instance);
+
+  APP_REQUIRE(id >= 0);
+
+  if (ctype == LL_ATON_RT_Callbacktype_PRE_START && eb != NULL) {
+    if (bw_ctx.running == NULL) {
+      /* LL_ATON_Init() gates the unit clock off with clock gating on */
+      LL_Dbgtrc_Init(NPU_BW_DBGTRC);
+      memset(&bw_ctx.frame, 0, sizeof(bw_ctx.frame));
+      bw_ctx.running = nn_instance;
+    }
+    NPUBw_Arm(eb);
+  } else if (ctype == LL_ATON_RT_Callbacktype_PRE_END && eb != NULL && bw_ctx.running == nn_instance) {
+    NPUBw_Collect();
+  } else if (ctype == LL_ATON_RT_Callbacktype_POST_END && eb != NULL && bw_ctx.running == nn_instance &&
+             EpochBlock_IsLastEpochBlock(eb)) {
+    bw_ctx.running = NULL;
+    tx_mutex_get(&bw_ctx.mutex, TX_WAIT_FOREVER);
+    bw_ctx.published[id] = bw_ctx.frame;
+    tx_mutex_put(&bw_ctx.mutex);
+  }
+
+  if (bw_ctx.nets[id].chained != NULL) {
+    bw_ctx.nets[id].chained(ctype, nn_instance, eb);
+  }
+}
+
+/**
+ * @brief  Bytes a stream engine moves for one tensor setup, as LL_Streng_TensorInit()
+ *         sizes its frame, times the frames up to its frame limit
+ */
+static uint64_t NPUBw_TensorBytes(const LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t nbits = (conf->dir == 0) ? conf->nbits_in : conf->nbits_out;
+  uint64_t frame;
+
+  if (conf->raw) {
+    frame = (conf->frame_count != 0) ? ((uint64_t)conf->frame_count * nbits) / 8U : LL_Streng_len(conf);
+  } else {
+    frame = ((uint64_t)conf->fwidth * conf->fheight * MAX(conf->batch_depth, 1U) * nbits) / 8U;
+  }
+  return frame * MAX(conf->frame_tot_cnt, 1U);
+}
+
+/**
+ * @brief  Record the memory pool of a stream engine tensor (inference thread context)
+ */
+void NPUBw_RecordTensor(int id, const LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t addr = conf->addr_base.i + conf->offset_start;
+  uint8_t pool = NPU_BW_POOL_OTHER;
+
+  if (bw_ctx.running == NULL || id < 0 || id >= ATON_STRENG_NUM) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < sizeof(npu_bw_ranges) / sizeof(npu_bw_ranges[0]); i++) {
+    if (addr >= npu_bw_ranges[i].start && addr < npu_bw_ranges[i].end) {
+      pool = npu_bw_ranges[i].pool;
+      break;
+    }
+  }
+  bw_ctx.pool[id] = pool;
+
+  if (conf->dir == 0) {
+    bw_ctx.frame.pools[pool].in_bytes += NPUBw_TensorBytes(conf);
+  } else {
+    bw_ctx.frame.pools[pool].out_bytes += NPUBw_TensorBytes(conf);
+  }
+}
+
+/**
+ * @brief  Chain the epoch callback of every network
+ */
+void NPUBw_Init(void) {
+  memset(&bw_ctx, 0, sizeof(bw_ctx));
+
+  APP_REQUIRE_EQ(tx_mutex_create(&bw_ctx.mutex, "npu_bw", TX_INHERIT), TX_SUCCESS);
+
+  /* Every registered network, so the report follows a network switch */
+  for (uint32_t id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    NN_Instance_TypeDef *instance = MX_X_CUBE_AI_GetNetwork(id);
+
+    if (instance != NULL) {
+      bw_ctx.nets[id].instance = instance;
+      bw_ctx.nets[id].chained = instance->exec_state.epoch_callback_function;
+      LL_ATON_RT_SetEpochCallback(NPUBw_EpochCallback, instance);
+    }
+  }
+}
+
+/**
+ * @brief  Copy the report of the last completed inference of the active network
+ */
+void NPUBw_GetReport(npu_bw_report_t *report) {
+  tx_mutex_get(&bw_ctx.mutex, TX_WAIT_FOREVER);
+  *report = bw_ctx.published[MX_X_CUBE_AI_GetActiveNetwork()];
+  tx_mutex_put(&bw_ctx.mutex);
+}
+
+#endif /* NPU_BW_REPORT */
@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_cache.c
+ * @author  Long Liangmao
+ * @brief   NPU cache (CACHEAXI) policy and statistics implementation for
+ *          STM32N6570-DK
+ *
+ *          The generated epochs choose the cache attributes of each stream
+ *          engine tensor. The link wraps LL_Streng_TensorInit() so a
+ *          per-region policy can override that choice, so the weight
+ *          staging and prefetch can rebase flash reads on their copies, so
+ *          the placement experiment can move activation banks, and so the
+ *          bandwidth report learns the memory pool of every engine.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_npu_cache.h"
+#include "app_error.h"
+#include "app_npu_bw.h"
+#include "app_npu_cipher.h"
+#include "app_npu_place.h"
+#include "app_prefetch.h"
+#include "app_wstage.h"
+#include "cacheaxi.h"
+#include "ll_aton.h"
+
+#if NPU_CACHE_POLICY_PSRAM == NPU_CACHE_ON || NPU_CACHE_POLICY_PSRAM == NPU_CACHE_ALLOC || \
+    NPU_CACHE_POLICY_AXISRAM == NPU_CACHE_ON || NPU_CACHE_POLICY_AXISRAM == NPU_CACHE_ALLOC
+#error "Only read-only regions may be forced cacheable: the generated cache maintenance covers the compiler's choice"
+#endif
+
+#define NPU_CACHE_MONITORS                                                                         \
+  (CACHEAXI_MONITOR_READ_HIT | CACHEAXI_MONITOR_READ_MISS | CACHEAXI_MONITOR_WRITE_HIT |           \
+   CACHEAXI_MONITOR_WRITE_MISS | CACHEAXI_MONITOR_EVICTION)
+
+int __real_LL_Streng_TensorInit(int id, const LL_Streng_TensorInitTypeDef *conf, int n);
+int __wrap_LL_Streng_TensorInit(int id, const LL_Streng_TensorInitTypeDef *conf, int n);
+
+#if NPU_CACHE_POLICY
+/* Cache policy region, matched on the first byte of a tensor */
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+  uint8_t policy; /* NPU_CACHE_KEEP / _ON / _ALLOC / _OFF */
+} npu_cache_region_t;
+
+static const npu_cache_region_t npu_cache_regions[] = {
+    {0x70000000U, 0x80000000U, NPU_CACHE_POLICY_FLASH},   /* xSPI2 octoFlash */
+    {0x90000000U, 0xA0000000U, NPU_CACHE_POLICY_PSRAM},   /* xSPI1 PSRAM */
+    {0x24000000U, 0x24400000U, NPU_CACHE_POLICY_AXISRAM}, /* AXISRAM1-6, non-secure alias */
+    {0x34000000U, 0x34400000U, NPU_CACHE_POLICY_AXISRAM}, /* AXISRAM1-6, secure alias */
+};
+
+/**
+ * @brief  Override the cache attributes of a tensor with its region policy
+ */
+static void NPUCache_ApplyPolicy(LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t addr = conf->addr_base.i + conf->offset_start;
+
+  for (uint32_t i = 0; i < sizeof(npu_cache_regions) / sizeof(npu_cache_regions[0]); i++) {
+    const npu_cache_region_t *region = &npu_cache_regions[i];
+
+    if (addr < region->start || addr >= region->end) {
+      continue;
+    }
+
+    switch (region->policy) {
+    case NPU_CACHE_ON:
+      conf->cacheable = 1;
+      break;
+    case NPU_CACHE_ALLOC:
+      conf->cacheable = 1;
+      conf->cache_allocate = 1;
+      break;
+    case NPU_CACHE_OFF:
+      conf->cacheable = 0;
+      conf->cache_allocate = 0;
+      break;
+    default:
+      break;
+    }
+    return;
+  }
+}
+#endif
+
+/**
+ * @brief  Stream engine setup, wrapped at link time (inference thread context)
+ */
+int __wrap_LL_Streng_TensorInit(int id, const LL_Streng_TensorInitTypeDef *conf, int n) {
+#if NPU_CACHE_POLICY || WEIGHT_STAGE_ENABLE || WEIGHT_PREFETCH_ENABLE || NPU_BW_REPORT || NPU_WEIGHT_CIPHER || \
+    NPU_PLACE_EXPERIMENT
+  LL_Streng_TensorInitTypeDef local;
+
+  /* The runtime rejects anything else; let it */
+  if (n != 1) {
+    return __real_LL_Streng_TensorInit(id, conf, n);
+  }
+
+  local = *conf;
+#if NPU_WEIGHT_CIPHER
+  /* On the generated setup: a staged copy keeps the cipher bit */
+  NPUCipher_CheckTensor(&local);
+#endif
+#if NPU_PLACE_EXPERIMENT
+  /* Before the policy: a moved bank is cached as the hyperRAM it is in */
+  NPUPlace_Rebase(&local);
+#endif
+#if NPU_CACHE_POLICY
+  NPUCache_ApplyPolicy(&local);
+#endif
+#if WEIGHT_STAGE_ENABLE
+  /* After the policy: the copy is read-only, cached as the flash it mirrors */
+  WStage_Rebase(&local);
+#endif
+#if WEIGHT_PREFETCH_ENABLE
+  Prefetch_Rebase(&local);
+#endif
+#if NPU_BW_REPORT
+  NPUBw_RecordTensor(id, &local);
+#endif
+  return __real_LL_Streng_TensorInit(id, &local, n);
+#else
+  return __real_LL_Streng_TensorInit(id, conf, n);
+#endif
+}
+
+/**
+ * @brief  Start the CACHEAXI hit/miss monitors
+ */
+void NPUCache_Init(void) {
+  NPUCache_ResetCounters();
+  APP_REQUIRE_EQ(HAL_CACHEAXI_Monitor_Start(&hcacheaxi, NPU_CACHE_MONITORS), HAL_OK);
+}
+
+/**
+ * @brief  Restart the monitor counters from zero
+ */
+void NPUCache_ResetCounters(void) {
+  APP_REQUIRE_EQ(HAL_CACHEAXI_Monitor_Reset(&hcacheaxi, NPU_CACHE_MONITORS), HAL_OK);
+}
+
+/**
+ * @brief  Read the monitor counters
+ */
+void NPUCache_GetCounters(npu_cache_counters_t *counters) {
+  counters->read_hits = HAL_CACHEAXI_Monitor_GetReadHitValue(&hcacheaxi);
+  counters->read_misses = HAL_CACHEAXI_Monitor_GetReadMissValue(&hcacheaxi);
+  counters->write_hits = HAL_CACHEAXI_Monitor_GetWriteHitValue(&hcacheaxi);
+  counters->write_misses = HAL_CACHEAXI_Monitor_GetWriteMissValue(&hcacheaxi);
+  counters->evictions = HAL_CACHEAXI_Monitor_GetEvictionValue(&hcacheaxi);
+}
+
+/**
+ * @brief  Add the counts between two readings to an accumulator
+ */
+void NPUCache_Accumulate(npu_cache_counters_t *acc, const npu_cache_counters_t *start,
+                         const npu_cache_counters_t *end) {
+  acc->read_hits += end->read_hits - start->read_hits;
+  acc->read_misses += end->read_misses - start->read_misses;
+  acc->write_hits += end->write_hits - start->write_hits;
+  acc->write_misses += end->write_misses - start->write_misses;
+  acc->evictions += end->evictions - start->evictions;
+}
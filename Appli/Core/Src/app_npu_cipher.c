@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_cipher.c
+ * @author  Long Liangmao
+ * @brief   Encrypted weights for STM32N6570-DK
+ *          OTP key provisioning of the NPU bus interfaces, stream engine
+ *          on-the-fly decryption of the octoFlash weights
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_npu_cipher.h"
+
+#if NPU_WEIGHT_CIPHER
+
+#include "app_error.h"
+#include "ll_aton_cipher.h"
+#include "stm32n6xx_hal.h"
+
+#if !defined(HAL_BSEC_MODULE_ENABLED)
+#error "NPU_WEIGHT_CIPHER reads its key from OTP (HAL_BSEC_MODULE_ENABLED)"
+#endif
+
+/* Stream engine reads of this range must be deciphered */
+#define NPU_CIPHER_FLASH_START 0x70000000U
+#define NPU_CIPHER_FLASH_END 0x80000000U
+
+#define NPU_CIPHER_KEY_WORDS 4U
+
+/**
+ * @brief  Clear key material; the stores are not optimised away
+ */
+static void NPUCipher_Wipe(volatile uint32_t *words, uint32_t nb) {
+  for (uint32_t i = 0; i < nb; i++) {
+    words[i] = 0;
+  }
+}
+
+void NPUCipher_LoadKeys(void) {
+  BSEC_HandleTypeDef hbsec = {.Instance = BSEC};
+  uint32_t key[NPU_CIPHER_KEY_WORDS];
+  uint32_t blank_low = 0, blank_high = ~0U;
+  uint64_t key_low, key_high;
+
+  __HAL_RCC_BSEC_CLK_ENABLE();
+  for (uint32_t i = 0; i < NPU_CIPHER_KEY_WORDS; i++) {
+    APP_REQUIRE_EQ(HAL_BSEC_OTP_Read(&hbsec, NPU_WEIGHT_KEY_OTP_WORD + i, &key[i]), HAL_OK);
+    blank_low |= key[i];
+    blank_high &= key[i];
+  }
+  /* Virgin fuses read as zero; all ones is not a key either */
+  APP_REQUIRE(blank_low != 0U && blank_high != ~0U);
+
+  key_low = ((uint64_t)key[1] << 32) | key[0];
+  key_high = ((uint64_t)key[3] << 32) | key[2];
+  NPUCipher_Wipe(key, NPU_CIPHER_KEY_WORDS);
+
+  for (int busif = 0; busif < ATON_BUSIF_NUM; busif++) {
+    APP_REQUIRE_EQ(LL_Busif_SetKeys(busif, NPU_WEIGHT_KEY_SEL, key_low, key_high), 0);
+  }
+  NPUCipher_Wipe((volatile uint32_t *)&key_low, 2U);
+  NPUCipher_Wipe((volatile uint32_t *)&key_high, 2U);
+}
+
+void NPUCipher_CheckTensor(const LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t addr = conf->addr_base.i + conf->offset_start;
+
+  if (conf->dir != 0 || addr < NPU_CIPHER_FLASH_START || addr >= NPU_CIPHER_FLASH_END) {
+    return;
+  }
+  APP_REQUIRE(conf->cipher_en && conf->key_sel == NPU_WEIGHT_KEY_SEL);
+}
+
+#endif /* NPU_WEIGHT_CIPHER */
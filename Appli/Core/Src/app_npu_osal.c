@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_osal.c
+ * @author  Long Liangmao
+ * @brief   ThreadX OSAL for the ll_aton runtime (LL_ATON_OSAL_USER_IMPL)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "ll_aton_osal_user_impl.h"
+#include "app_config.h"
+#include "app_error.h"
+#include "app_health.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+
+/* Single network, single owner: only the inference thread waits on this */
+static TX_SEMAPHORE npu_event_sem;
+
+#if HEALTH_MONITOR
+/* Set when a wait ran out: the epoch block never signalled */
+static uint8_t npu_timed_out;
+#endif
+
+/**
+ * @brief  Create the epoch event semaphore, set the epoch interrupt level
+ */
+void NPU_OSAL_Init(void) {
+  APP_REQUIRE_EQ(tx_semaphore_create(&npu_event_sem, "npu_event", 0), TX_SUCCESS);
+  /* The runtime enables the epoch interrupt next, at its reset level (0)
+   * otherwise */
+  HAL_NVIC_SetPriority(NPU0_IRQn, NPU_IRQ_PRIORITY, 0);
+}
+
+/**
+ * @brief  Delete the epoch event semaphore
+ */
+void NPU_OSAL_DeInit(void) {
+  APP_REQUIRE_EQ(tx_semaphore_delete(&npu_event_sem), TX_SUCCESS);
+}
+
+/**
+ * @brief  Wait for the next ATON event
+ */
+void NPU_OSAL_Wfe(void) {
+  if (tx_thread_identify() == TX_NULL) {
+    __WFE();
+    return;
+  }
+
+#if HEALTH_MONITOR
+  if (tx_semaphore_get(&npu_event_sem, HEALTH_MS_TO_TICKS(HEALTH_NPU_TIMEOUT_MS)) != TX_SUCCESS) {
+    npu_timed_out = 1;
+    return;
+  }
+  Health_Kick(HEALTH_STAGE_NPU);
+#else
+  tx_semaphore_get(&npu_event_sem, TX_WAIT_FOREVER);
+#endif
+}
+
+#if HEALTH_MONITOR
+/**
+ * @brief  Report and clear a timed-out wait
+ */
+uint8_t NPU_OSAL_TakeTimeout(void) {
+  uint8_t timed_out = npu_timed_out;
+
+  npu_timed_out = 0;
+  return timed_out;
+}
+#endif
+
+/**
+ * @brief  Signal an ATON event (ATON IRQ context)
+ * @note   Ceiling of 1: the runtime re-checks its state after each wake-up,
+ *         so events raised before the wait are latched but never pile up
+ */
+void NPU_OSAL_SignalEvent(void) {
+  tx_semaphore_ceiling_put(&npu_event_sem, 1);
+}
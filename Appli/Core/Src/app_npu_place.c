@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_place.c
+ * @author  Long Liangmao
+ * @brief   NPU activation placement experiment implementation for
+ *          STM32N6570-DK
+ *
+ *          The generated epochs program absolute AXISRAM addresses, and the
+ *          relocatable installer only moves the weight and external pools,
+ *          so a bank is moved where the weight staging moves the weights:
+ *          from the stream engine hook (app_npu_cache.c), every tensor
+ *          within moved banks is rebased on a hyperRAM mirror of
+ *          AXISRAM2-6. The mirror keeps the offsets, so tensors crossing
+ *          between two moved banks stay whole. CPU code (SW epochs) still
+ *          reads the banks in place: the benchmark compares the outputs.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_npu_place.h"
+
+#if NPU_PLACE_EXPERIMENT
+
+#include "app_error.h"
+#include "utils.h"
+
+#if (NNBENCH_POOL_MOVES & ~(((1U << (NPU_PLACE_BANK_LAST + 1U)) - 1U) & ~((1U << NPU_PLACE_BANK_FIRST) - 1U))) != 0
+#error "NNBENCH_POOL_MOVES names banks outside AXISRAM2-6"
+#endif
+
+/* AXISRAM2 then AXISRAM3-6, secure alias as generated (STM32N657XX_LRUN.ld) */
+#define NPU_PLACE_WINDOW_START 0x34100000U
+#define NPU_PLACE_WINDOW_END 0x343C0000U
+#define NPU_PLACE_BANK2_END 0x34200000U
+#define NPU_PLACE_BANK_SIZE 0x70000U /* AXISRAM3-6 */
+
+/* Activation reservations, from npu_mpools.ld */
+extern uint8_t _npu_act_axisram2_start[], _npu_act_axisram2_end[];
+extern uint8_t _npu_act_axisram3_start[], _npu_act_axisram3_end[];
+extern uint8_t _npu_act_axisram4_start[], _npu_act_axisram4_end[];
+extern uint8_t _npu_act_axisram5_start[], _npu_act_axisram5_end[];
+extern uint8_t _npu_act_axisram6_start[], _npu_act_axisram6_end[];
+
+static const struct {
+  const uint8_t *start;
+  const uint8_t *end;
+} npu_place_reserved[NPU_PLACE_BANK_LAST - NPU_PLACE_BANK_FIRST + 1U] = {
+    {_npu_act_axisram2_start, _npu_act_axisram2_end},
+    {_npu_act_axisram3_start, _npu_act_axisram3_end},
+    {_npu_act_axisram4_start, _npu_act_axisram4_end},
+    {_npu_act_axisram5_start, _npu_act_axisram5_end},
+    {_npu_act_axisram6_start, _npu_act_axisram6_end},
+};
+
+/* Only the NPU touches it: no CPU cache maintenance */
+static uint8_t npu_place_mirror[NPU_PLACE_WINDOW_END - NPU_PLACE_WINDOW_START] ALIGN_PSRAM_ROW IN_PSRAM;
+
+static struct {
+  uint32_t moved;
+  uint32_t straddles;
+} place_ctx;
+
+/**
+ * @brief  Bank of an AXISRAM2-6 address
+ */
+static uint32_t NPUPlace_Bank(uint32_t addr) {
+  if (addr < NPU_PLACE_BANK2_END) {
+    return 2U;
+  }
+  return 3U + (addr - NPU_PLACE_BANK2_END) / NPU_PLACE_BANK_SIZE;
+}
+
+static int NPUPlace_IsMoved(uint32_t addr) {
+  return addr - NPU_PLACE_WINDOW_START < NPU_PLACE_WINDOW_END - NPU_PLACE_WINDOW_START &&
+         (place_ctx.moved & (1U << NPUPlace_Bank(addr))) != 0U;
+}
+
+/**
+ * @brief  Activation bytes the network reserves in a bank
+ */
+uint32_t NPUPlace_BankBytes(uint32_t bank) {
+  APP_REQUIRE(bank >= NPU_PLACE_BANK_FIRST && bank <= NPU_PLACE_BANK_LAST);
+  return (uint32_t)(npu_place_reserved[bank - NPU_PLACE_BANK_FIRST].end -
+                    npu_place_reserved[bank - NPU_PLACE_BANK_FIRST].start);
+}
+
+/**
+ * @brief  Banks in the mirror from the next stream engine setup on
+ */
+void NPUPlace_SetMoved(uint32_t mask) {
+  APP_REQUIRE((mask & ~NNBENCH_POOL_MOVES) == 0U);
+  place_ctx.moved = mask;
+}
+
+/**
+ * @brief  Point a stream engine tensor of a moved bank at the mirror
+ */
+void NPUPlace_Rebase(LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t first = conf->addr_base.i + conf->offset_start;
+  uint32_t last = conf->addr_base.i + MAX(conf->offset_end, conf->offset_limit) - 1U;
+  int moved;
+
+  if (place_ctx.moved == 0U) {
+    return;
+  }
+  moved = NPUPlace_IsMoved(first);
+  if (moved != NPUPlace_IsMoved(last)) {
+    place_ctx.straddles++;
+    return;
+  }
+  if (!moved) {
+    return;
+  }
+  conf->addr_base.i += (uint32_t)npu_place_mirror - NPU_PLACE_WINDOW_START;
+}
+
+/**
+ * @brief  Where a network buffer is with the current layout
+ */
+void *NPUPlace_Translate(void *addr) {
+  if (!NPUPlace_IsMoved((uint32_t)addr)) {
+    return addr;
+  }
+  return &npu_place_mirror[(uint32_t)addr - NPU_PLACE_WINDOW_START];
+}
+
+/**
+ * @brief  Tensors crossing from a moved bank to a kept one, since the last call
+ */
+uint32_t NPUPlace_TakeStraddles(void) {
+  uint32_t straddles = place_ctx.straddles;
+
+  place_ctx.straddles = 0;
+  return straddles;
+}
+
+#endif /* NPU_PLACE_EXPERIMENT */
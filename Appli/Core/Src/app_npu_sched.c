@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * @file    app_npu_sched.c
+ * @author  Long Liangmao
+ * @brief   Dual-instance NPU scheduler for STM32N6570-DK (NPU_SCHED_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_npu_sched.h"
+
+#if NPU_SCHED_ENABLE
+
+#include "app_error.h"
+#include "app_health.h"
+#include "app_ui.h"
+#include "app_x-cube-ai.h"
+#include "ll_aton_osal_user_impl.h"
+
+#if !CASCADE_ENABLE
+#error "NPU_SCHED_ENABLE interleaves the second stage with the detector: it needs CASCADE_ENABLE"
+#endif
+#if NPU_SCHED_JOBS_MAX < 2
+#error "NPU_SCHED_JOBS_MAX must be at least 2"
+#endif
+#if NN_SHARED_LAYOUT && CASCADE_NETWORK == MX_X_CUBE_AI_NET_OBJECT_DETECTION_YOLO_X
+#error "NPU_SCHED_ENABLE needs a second stage with pools of its own: configure with -DNN_SHARED_LAYOUT=OFF"
+#endif
+
+/* ATON IP lock holder (ll_aton_runtime.c): the instance in a HW, hybrid or
+ * library-inserted epoch block, NULL when the NPU is free */
+extern NN_Instance_TypeDef *volatile __ll_current_aton_ip_owner;
+
+/**
+ * @brief  Fail if a buffer of list a overlaps a buffer of list b
+ * @note   Weights (read only) and user-allocated buffers (bound per
+ *         inference) are left out
+ */
+static void NPUSched_CheckLists(const LL_Buffer_InfoTypeDef *a, const LL_Buffer_InfoTypeDef *b) {
+  if (a == NULL || b == NULL) {
+    return;
+  }
+  for (; a->name != NULL; a++) {
+    if (a->is_param || a->is_user_allocated) {
+      continue;
+    }
+    for (const LL_Buffer_InfoTypeDef *o = b; o->name != NULL; o++) {
+      if (o->is_param || o->is_user_allocated) {
+        continue;
+      }
+      APP_REQUIRE(LL_Buffer_addr_end(a) <= LL_Buffer_addr_start(o) ||
+                  LL_Buffer_addr_end(o) <= LL_Buffer_addr_start(a));
+    }
+  }
+}
+
+void NPUSched_CheckDisjoint(NN_Instance_TypeDef *a, NN_Instance_TypeDef *b) {
+  const LL_Buffer_InfoTypeDef *la[3];
+  const LL_Buffer_InfoTypeDef *lb[3];
+
+  APP_REQUIRE(a != NULL && b != NULL && a != b);
+  la[0] = LL_ATON_Internal_Buffers_Info(a);
+  la[1] = LL_ATON_Input_Buffers_Info(a);
+  la[2] = LL_ATON_Output_Buffers_Info(a);
+  lb[0] = LL_ATON_Internal_Buffers_Info(b);
+  lb[1] = LL_ATON_Input_Buffers_Info(b);
+  lb[2] = LL_ATON_Output_Buffers_Info(b);
+  /* Activations are checked against the bank reservations elsewhere, they
+   * must be listed here */
+  APP_REQUIRE(la[0] != NULL && lb[0] != NULL);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    for (uint32_t j = 0; j < 3; j++) {
+      NPUSched_CheckLists(la[i], lb[j]);
+    }
+  }
+}
+
+/**
+ * @brief  Whether job a goes before job b: lower priority value, then the
+ *         earlier deadline (none last)
+ */
+static int NPUSched_Before(const npu_sched_job_t *a, const npu_sched_job_t *b) {
+  if (a->priority != b->priority) {
+    return a->priority < b->priority;
+  }
+  if (a->deadline == 0U || b->deadline == 0U) {
+    return b->deadline == 0U && a->deadline != 0U;
+  }
+  return (int32_t)(a->deadline - b->deadline) < 0;
+}
+
+/**
+ * @brief  Whether the job's instance is between epoch blocks of its own
+ *         list (not in a started block nor in a library-inserted array)
+ */
+static int NPUSched_AtBoundary(const npu_sched_job_t *job) {
+  const NN_Instance_TypeDef *inst = job->instance;
+
+  return __ll_current_aton_ip_owner != inst && !inst->exec_state.current_epoch_block_started &&
+         inst->exec_state.saved_current_epoch_block == NULL;
+}
+
+/**
+ * @brief  Whether stepping the job now cannot contend for the NPU: it holds
+ *         the NPU, the NPU is free, or its next block is CPU only
+ */
+static int NPUSched_CanStep(const npu_sched_job_t *job) {
+  NN_Instance_TypeDef *owner = __ll_current_aton_ip_owner;
+  const LL_ATON_RT_EpochBlockItem_t *eb = job->instance->exec_state.current_epoch_block;
+
+  if (owner == NULL || owner == job->instance || job->instance->exec_state.current_epoch_block_started) {
+    return 1;
+  }
+  return EpochBlock_IsEpochPureSW(eb) || EpochBlock_IsLastEpochBlock(eb);
+}
+
+int NPUSched_Run(npu_sched_job_t *jobs, uint32_t nb) {
+  npu_sched_job_t *order[NPU_SCHED_JOBS_MAX];
+
+  APP_REQUIRE(nb >= 1 && nb <= NPU_SCHED_JOBS_MAX);
+
+  /* Most urgent first; insertion sort, a handful of jobs */
+  for (uint32_t i = 0; i < nb; i++) {
+    npu_sched_job_t *job = &jobs[i];
+    uint32_t pos = i;
+
+    APP_REQUIRE(job->instance != NULL);
+    job->runs = 0;
+    job->done_cycles = 0;
+    job->status = (job->next == NULL || job->next(job, 0)) ? NPU_SCHED_PENDING : NPU_SCHED_DONE;
+    while (pos > 0 && NPUSched_Before(job, order[pos - 1])) {
+      order[pos] = order[pos - 1];
+      pos--;
+    }
+    order[pos] = job;
+  }
+
+#if HEALTH_MONITOR
+  Health_Arm(HEALTH_STAGE_NPU);
+#endif
+  while (1) {
+    int pending = 0;
+    int progressed = 0;
+
+    for (uint32_t i = 0; i < nb && !progressed; i++) {
+      npu_sched_job_t *job = order[i];
+      LL_ATON_RT_RetValues_t ret;
+
+      if (job->status != NPU_SCHED_PENDING) {
+        continue;
+      }
+      pending = 1;
+
+      /* Late: dropped once it no longer holds the NPU mid-block */
+      if (job->deadline != 0U && (int32_t)(UI_GetCycleCount() - job->deadline) >= 0 && NPUSched_AtBoundary(job)) {
+        LL_ATON_RT_Reset_Network(job->instance);
+        job->status = NPU_SCHED_EXPIRED;
+        progressed = 1;
+        continue;
+      }
+      if (!NPUSched_CanStep(job)) {
+        continue;
+      }
+
+      ret = LL_ATON_RT_RunEpochBlock(job->instance);
+      if (ret == LL_ATON_RT_DONE) {
+        LL_ATON_RT_Reset_Network(job->instance);
+        job->runs++;
+        job->done_cycles = UI_GetCycleCount();
+        if (job->next == NULL || !job->next(job, 1)) {
+          job->status = NPU_SCHED_DONE;
+        }
+        progressed = 1;
+      } else if (ret == LL_ATON_RT_NO_WFE) {
+        /* Back to the most urgent job: it may take the NPU just released */
+        progressed = 1;
+      }
+    }
+
+    if (!pending) {
+      break;
+    }
+    if (progressed) {
+      continue;
+    }
+
+    /* Every pending job waits on the NPU holder */
+    LL_ATON_OSAL_WFE();
+#if HEALTH_MONITOR
+    if (NPU_OSAL_TakeTimeout()) {
+      MX_X_CUBE_AI_RecoverNPU();
+      for (uint32_t i = 0; i < nb; i++) {
+        if (jobs[i].status == NPU_SCHED_PENDING) {
+          jobs[i].status = NPU_SCHED_FAILED;
+        }
+      }
+      Health_Disarm(HEALTH_STAGE_NPU);
+      return 0;
+    }
+#endif
+  }
+#if HEALTH_MONITOR
+  Health_Disarm(HEALTH_STAGE_NPU);
+#endif
+  return 1;
+}
+
+#endif /* NPU_SCHED_ENABLE */
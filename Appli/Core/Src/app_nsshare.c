@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file    app_nsshare.c
+ * @author  Long Liangmao
+ * @brief   Results shared with the non-secure image for STM32N6570-DK
+ *          Lock-free triple buffer written by the secure inference pipeline
+ *          and read in place by the non-secure UI (NS_SPLIT)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nsshare.h"
+
+#if NS_SPLIT
+
+#include "app_error.h"
+#include "stm32n6xx_hal.h"
+#include <string.h>
+
+/* AXISRAM: the non-secure alias sits 0x10000000 below the secure one */
+#define NS_SHARE_NS_ALIAS_OFFSET 0x10000000U
+
+/* SAU regions; everything outside them stays secure, as with the SAU off */
+#define NS_SHARE_SAU_BLOCK 0U   /* Shared block, non-secure alias */
+#define NS_SHARE_SAU_VENEERS 1U /* .gnu.sgstubs, non-secure callable */
+
+_Static_assert(sizeof(ns_shared_t) % 32U == 0U, "Shared block must fill whole SAU granules");
+
+/* Section covered by the non-cacheable MPU region 0 (MPU_Config()) */
+static ns_shared_t ns_shared __attribute__((section(".noncacheable")));
+
+/* Slot the writer fills next; the post-processing thread's alone */
+static uint32_t ns_back;
+
+extern uint32_t _sNSCVeneer[];
+extern uint32_t _eNSCVeneer[];
+
+static void NSShare_SauRegion(uint32_t region, uint32_t base, uint32_t end, uint32_t nsc) {
+  SAU->RNR = region;
+  SAU->RBAR = base & SAU_RBAR_BADDR_Msk;
+  SAU->RLAR = ((end - 1U) & SAU_RLAR_LADDR_Msk) | (nsc ? SAU_RLAR_NSC_Msk : 0U) | SAU_RLAR_ENABLE_Msk;
+}
+
+void NSShare_Init(void) {
+  uint32_t base = (uint32_t)&ns_shared;
+
+  memset(&ns_shared, 0, sizeof(ns_shared));
+  ns_shared.magic = NS_SHARE_MAGIC;
+  ns_shared.version = NS_SHARE_VERSION;
+  ns_shared.size = sizeof(ns_shared);
+  /* Reader starts on slot 0, the writer on 1; 2 stands as the latest */
+  ns_shared.state = 2U;
+  ns_back = 1U;
+
+  APP_REQUIRE(((SAU->TYPE & SAU_TYPE_SREGION_Msk) >> SAU_TYPE_SREGION_Pos) > NS_SHARE_SAU_VENEERS);
+  APP_REQUIRE((base & 31U) == 0U);
+
+  NSShare_SauRegion(NS_SHARE_SAU_BLOCK, base - NS_SHARE_NS_ALIAS_OFFSET,
+                    base - NS_SHARE_NS_ALIAS_OFFSET + sizeof(ns_shared), 0);
+  NSShare_SauRegion(NS_SHARE_SAU_VENEERS, (uint32_t)_sNSCVeneer, (uint32_t)_eNSCVeneer, 1);
+  SAU->CTRL = SAU_CTRL_ENABLE_Msk;
+  __DSB();
+  __ISB();
+}
+
+void NSShare_Publish(const nn_result_t *result) {
+  ns_shared.slots[ns_back] = *result;
+  ns_shared.published++;
+  ns_back = __atomic_exchange_n(&ns_shared.state, ns_back | NS_SHARE_FRESH, __ATOMIC_ACQ_REL) & NS_SHARE_INDEX_MASK;
+}
+
+ns_shared_t *NSShare_GetNsAlias(void) {
+  return (ns_shared_t *)((uint32_t)&ns_shared - NS_SHARE_NS_ALIAS_OFFSET);
+}
+
+#endif /* NS_SPLIT */
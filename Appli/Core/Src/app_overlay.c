@@ -0,0 +1,914 @@
+/**
+ ******************************************************************************
+ * @file    app_overlay.c
+ * @author  Long Liangmao
+ * @brief   DMA2D command ring renderer implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_overlay.h"
+#include "app_assets.h"
+#include "app_buffers.h"
+#include "app_error.h"
+#include "stm32_lcd.h"
+#include "stm32n6570_discovery_lcd.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+/* Printable ASCII range covered by the atlas */
+#define OVERLAY_GLYPH_FIRST ' '
+#define OVERLAY_GLYPH_LAST '~'
+#define OVERLAY_GLYPH_NB (OVERLAY_GLYPH_LAST - OVERLAY_GLYPH_FIRST + 1)
+#define OVERLAY_GLYPH_SIZE (OVERLAY_GLYPH_WIDTH * OVERLAY_GLYPH_HEIGHT)
+#define OVERLAY_GLYPH12_SIZE (OVERLAY_GLYPH12_WIDTH * OVERLAY_GLYPH12_HEIGHT)
+
+/* UI frame buffer layout, shared with the LTDC UI layer */
+#define OVERLAY_BPP UI_BPP
+#define OVERLAY_STRIDE UI_LAYER_WIDTH
+#if UI_LAYER_ARGB4444
+#define OVERLAY_DMA2D_OUTPUT DMA2D_OUTPUT_ARGB4444
+#define OVERLAY_DMA2D_INPUT DMA2D_INPUT_ARGB4444
+#else
+#define OVERLAY_DMA2D_OUTPUT DMA2D_OUTPUT_ARGB8888
+#define OVERLAY_DMA2D_INPUT DMA2D_INPUT_ARGB8888
+#endif
+
+#if (OVERLAY_MAX_CMDS & (OVERLAY_MAX_CMDS - 1)) != 0
+#error "OVERLAY_MAX_CMDS must be a power of two (command ring index mask)"
+#endif
+
+typedef enum {
+  OVERLAY_CMD_FILL = 0,   /* Register-to-memory */
+  OVERLAY_CMD_GLYPH = 1,  /* A8 glyph or label strip blended over the target */
+  OVERLAY_CMD_L8 = 2,     /* L8 image through a CLUT, blended over the target */
+  OVERLAY_CMD_COPY = 3,   /* Staged UI_LAYER_FORMAT pixels copied over the target */
+  OVERLAY_CMD_RGB565 = 4, /* RGB565 image converted over the target */
+  OVERLAY_CMD_BLIT = 5,   /* Rectangle of another UI frame buffer copied over the target */
+  OVERLAY_CMD_COMPOSE = 6, /* UI layer window over a camera frame (or black) into an RGB565 frame */
+} overlay_cmd_type_t;
+
+typedef struct {
+  uint8_t type;
+  uint16_t x; /* Output pixels per line for OVERLAY_CMD_COMPOSE */
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+  uint32_t color; /* CLUT entries for OVERLAY_CMD_L8, source stride for OVERLAY_CMD_RGB565 and
+                   * OVERLAY_CMD_COMPOSE, source column offset for OVERLAY_CMD_BLIT */
+  const uint8_t *glyph; /* Camera frame window for OVERLAY_CMD_COMPOSE, NULL for black */
+  const uint32_t *clut; /* UI layer window for OVERLAY_CMD_COMPOSE, NULL for a plain copy */
+  uint8_t *target;      /* First output pixel for OVERLAY_CMD_COMPOSE */
+} overlay_cmd_t;
+
+/* Command ring: sequence numbers run freely, slots are seq & (MAX - 1).
+ * Threads queue at head and publish up to submit under the lock; the DMA2D
+ * interrupt runs tail up to submit */
+static struct {
+  overlay_cmd_t cmds[OVERLAY_MAX_CMDS];
+  uint32_t head;
+  volatile uint32_t submit;
+  volatile uint32_t tail;
+  volatile uint8_t running;
+  const uint32_t *clut; /* Table in the foreground CLUT RAM */
+  const overlay_ctx_t *lcd; /* UTIL_LCD drawing context */
+  uint32_t staging_used;  /* Bytes of the staging arena queued since it drained */
+  uint32_t staging_clean; /* Bytes already pushed out of the D-cache */
+  TX_MUTEX lock;
+
+  /* Threads blocked in Overlay_WaitFence(), woken by the interrupt */
+  struct {
+    TX_SEMAPHORE sem;
+    overlay_fence_t fence;
+    volatile uint8_t active;
+  } waiters[OVERLAY_WAITERS_MAX];
+} ovl_ctx;
+
+/* One A8 cell per printable character, rows packed at the glyph width */
+static uint8_t glyph_atlas16[OVERLAY_GLYPH_NB][OVERLAY_GLYPH_SIZE] ALIGN_32;
+static uint8_t glyph_atlas12[OVERLAY_GLYPH_NB][OVERLAY_GLYPH12_SIZE] ALIGN_32;
+
+typedef struct {
+#if ASSET_PACK_ENABLE
+  uint32_t asset; /* 1-bpp table in the asset pack, not linked */
+#else
+  const sFONT *font;
+#endif
+  uint8_t *atlas;
+  uint8_t width;
+  uint8_t height;
+} overlay_font_desc_t;
+
+static const overlay_font_desc_t overlay_fonts[OVERLAY_FONT_NB] = {
+#if ASSET_PACK_ENABLE
+    [OVERLAY_FONT_16] = {ASSET_ID_FONT16, glyph_atlas16[0], OVERLAY_GLYPH_WIDTH, OVERLAY_GLYPH_HEIGHT},
+    [OVERLAY_FONT_12] = {ASSET_ID_FONT12, glyph_atlas12[0], OVERLAY_GLYPH12_WIDTH, OVERLAY_GLYPH12_HEIGHT},
+#else
+    [OVERLAY_FONT_16] = {&Font16, glyph_atlas16[0], OVERLAY_GLYPH_WIDTH, OVERLAY_GLYPH_HEIGHT},
+    [OVERLAY_FONT_12] = {&Font12, glyph_atlas12[0], OVERLAY_GLYPH12_WIDTH, OVERLAY_GLYPH12_HEIGHT},
+#endif
+};
+
+/* Atlases built, at init or, from the asset pack, at the first text */
+static volatile uint8_t atlas_ready[OVERLAY_FONT_NB];
+
+/* Labels rasterized once into A8 strips, looked up by string address */
+static struct {
+  struct {
+    const char *text;
+    uint8_t *strip;
+    uint16_t width;
+    uint8_t font;
+  } entries[OVERLAY_LABEL_CACHE_NB];
+  uint32_t nb;
+  uint32_t arena_used;
+} label_cache;
+
+static uint8_t label_arena[OVERLAY_LABEL_ARENA_SIZE] ALIGN_32;
+
+/* UTIL_LCD pixel rows (text), read by the DMA2D after the caller returns */
+static uint8_t staging[OVERLAY_STAGING_SIZE] ALIGN_32;
+CACHE_LINES_CHECK(staging);
+
+/**
+ * @brief  Expand the 1-bpp bitmaps of a font into its A8 atlas
+ */
+IN_XIP static void Overlay_BuildAtlas(const overlay_font_desc_t *desc) {
+  const uint32_t row_bytes = (desc->width + 7U) / 8U;
+  const uint32_t pad = 8 * row_bytes - desc->width;
+  const uint32_t cell = desc->width * desc->height;
+  const uint8_t *table;
+
+#if ASSET_PACK_ENABLE
+  const asset_entry_t *entry = Assets_Find(desc->asset, ASSET_TYPE_FONT);
+
+  APP_REQUIRE(entry != NULL);
+  APP_REQUIRE_EQ(entry->width, desc->width);
+  APP_REQUIRE_EQ(entry->height, desc->height);
+  APP_REQUIRE_EQ(entry->count, OVERLAY_GLYPH_NB);
+  APP_REQUIRE_EQ(entry->size, OVERLAY_GLYPH_NB * desc->height * row_bytes);
+
+  /* Decompressed into the tail of the atlas and expanded forward: the A8
+   * rows written never reach the 1-bpp rows still to be read */
+  table = &desc->atlas[OVERLAY_GLYPH_NB * cell - entry->size];
+  Assets_Load(entry, (uint8_t *)table);
+#else
+  APP_REQUIRE_EQ(desc->font->Width, desc->width);
+  APP_REQUIRE_EQ(desc->font->Height, desc->height);
+  table = desc->font->table;
+#endif
+
+  for (uint32_t g = 0; g < OVERLAY_GLYPH_NB; g++) {
+    const uint8_t *src = &table[g * desc->height * row_bytes];
+    uint8_t *dst = &desc->atlas[g * cell];
+
+    for (uint32_t row = 0; row < desc->height; row++) {
+      uint32_t line = 0;
+
+      for (uint32_t b = 0; b < row_bytes; b++) {
+        line = (line << 8) | src[row * row_bytes + b];
+      }
+      for (uint32_t col = 0; col < desc->width; col++) {
+        uint32_t bit = desc->width - col + pad - 1;
+        dst[row * desc->width + col] = (line & (1U << bit)) ? 0xFF : 0x00;
+      }
+    }
+  }
+
+  SCB_CleanDCache_by_Addr((void *)desc->atlas, OVERLAY_GLYPH_NB * cell);
+}
+
+/**
+ * @brief  Program and start a composition: outside the UI layer, RGB565 out
+ */
+static void Overlay_StartCompose(const overlay_cmd_t *cmd) {
+  uint32_t line_offset = cmd->color - cmd->width;
+
+  DMA2D->OPFCCR = DMA2D_OUTPUT_RGB565;
+  DMA2D->OMAR = (uint32_t)cmd->target;
+  DMA2D->OOR = cmd->x - cmd->width;
+  DMA2D->NLR = ((uint32_t)cmd->width << DMA2D_NLR_PL_Pos) | cmd->height;
+
+  if (cmd->clut == NULL && cmd->glyph == NULL) {
+    /* Neither layer: the LTDC background */
+    DMA2D->OCOLR = 0;
+    DMA2D->CR = DMA2D_R2M | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+
+  if (cmd->clut == NULL) {
+    /* Columns the UI layer does not cover */
+    DMA2D->FGMAR = (uint32_t)cmd->glyph;
+    DMA2D->FGOR = line_offset;
+    DMA2D->FGPFCCR = DMA2D_INPUT_RGB565;
+    DMA2D->CR = DMA2D_M2M | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+
+  /* Foreground: the UI layer pixels with their own alpha */
+  DMA2D->FGMAR = (uint32_t)cmd->clut;
+  DMA2D->FGOR = OVERLAY_STRIDE - cmd->width;
+  DMA2D->FGPFCCR = OVERLAY_DMA2D_INPUT;
+
+  if (cmd->glyph == NULL) {
+    /* Background: opaque black, outside the camera window */
+    DMA2D->BGCOLR = 0;
+    DMA2D->BGPFCCR = DMA2D_INPUT_RGB565 | (1U << DMA2D_BGPFCCR_AM_Pos) | (0xFFU << DMA2D_BGPFCCR_ALPHA_Pos);
+    DMA2D->CR = DMA2D_M2M_BLEND_BG | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+
+  /* Background: the camera frame */
+  DMA2D->BGMAR = (uint32_t)cmd->glyph;
+  DMA2D->BGOR = line_offset;
+  DMA2D->BGPFCCR = DMA2D_INPUT_RGB565;
+
+  DMA2D->CR = DMA2D_M2M_BLEND | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+}
+
+/**
+ * @brief  Program and start one DMA2D command
+ */
+static void Overlay_StartCmd(const overlay_cmd_t *cmd) {
+  uint32_t dst = (uint32_t)cmd->target + (cmd->y * OVERLAY_STRIDE + cmd->x) * OVERLAY_BPP;
+  uint32_t line_offset = OVERLAY_STRIDE - cmd->width;
+
+  if (cmd->type == OVERLAY_CMD_COMPOSE) {
+    Overlay_StartCompose(cmd);
+    return;
+  }
+
+  DMA2D->OPFCCR = OVERLAY_DMA2D_OUTPUT;
+  DMA2D->OMAR = dst;
+  DMA2D->OOR = line_offset;
+  DMA2D->NLR = ((uint32_t)cmd->width << DMA2D_NLR_PL_Pos) | cmd->height;
+
+  if (cmd->type == OVERLAY_CMD_FILL) {
+    /* R2M takes the color in the output format */
+#if UI_LAYER_ARGB4444
+    DMA2D->OCOLR = ((cmd->color >> 16) & 0xF000U) | ((cmd->color >> 12) & 0x0F00U) |
+                   ((cmd->color >> 8) & 0x00F0U) | ((cmd->color >> 4) & 0x000FU);
+#else
+    DMA2D->OCOLR = cmd->color;
+#endif
+    DMA2D->CR = DMA2D_R2M | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+
+  if (cmd->type == OVERLAY_CMD_BLIT) {
+    /* Both buffers share the layout: same offset, shifted by the source
+     * columns, and same line offset */
+    DMA2D->FGMAR = (uint32_t)cmd->glyph + (dst - (uint32_t)cmd->target) + cmd->color * OVERLAY_BPP;
+    DMA2D->FGOR = line_offset;
+    DMA2D->FGPFCCR = OVERLAY_DMA2D_INPUT;
+    DMA2D->CR = DMA2D_M2M | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+
+  DMA2D->FGMAR = (uint32_t)cmd->glyph;
+  DMA2D->FGOR = 0;
+  if (cmd->type == OVERLAY_CMD_COPY) {
+    /* Same format in and out: a plain copy, overwriting the target */
+    DMA2D->FGPFCCR = OVERLAY_DMA2D_INPUT;
+    DMA2D->CR = DMA2D_M2M | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+  if (cmd->type == OVERLAY_CMD_RGB565) {
+    /* A window of a larger image, opaque: converted, overwriting the target */
+    DMA2D->FGOR = cmd->color - cmd->width;
+    DMA2D->FGPFCCR = DMA2D_INPUT_RGB565;
+    DMA2D->CR = DMA2D_M2M_PFC | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+    return;
+  }
+  if (cmd->type == OVERLAY_CMD_L8) {
+    /* Foreground: L8 indices through the ARGB8888 CLUT. The DMA2D is idle
+     * between commands: the table is written straight into its CLUT RAM */
+    if (ovl_ctx.clut != cmd->clut) {
+      for (uint32_t i = 0; i < cmd->color; i++) {
+        DMA2D->FGCLUT[i] = cmd->clut[i];
+      }
+      ovl_ctx.clut = cmd->clut;
+    }
+    DMA2D->FGPFCCR = DMA2D_INPUT_L8 | ((cmd->color - 1) << DMA2D_FGPFCCR_CS_Pos) |
+                     (DMA2D_NO_MODIF_ALPHA << DMA2D_FGPFCCR_AM_Pos);
+  } else {
+    /* Foreground: A8 glyph tinted by FGCOLR, alpha scaled by the color alpha */
+    DMA2D->FGCOLR = cmd->color & 0x00FFFFFFU;
+    DMA2D->FGPFCCR = DMA2D_INPUT_A8 | (DMA2D_COMBINE_ALPHA << DMA2D_FGPFCCR_AM_Pos) |
+                     ((cmd->color >> 24) << DMA2D_FGPFCCR_ALPHA_Pos);
+  }
+
+  /* Background: the target itself */
+  DMA2D->BGMAR = dst;
+  DMA2D->BGOR = line_offset;
+  DMA2D->BGPFCCR = OVERLAY_DMA2D_INPUT;
+
+  DMA2D->CR = DMA2D_M2M_BLEND | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+}
+
+static void Overlay_Lock(void) {
+  APP_REQUIRE_EQ(tx_mutex_get(&ovl_ctx.lock, TX_WAIT_FOREVER), TX_SUCCESS);
+}
+
+static void Overlay_Unlock(void) {
+  APP_REQUIRE_EQ(tx_mutex_put(&ovl_ctx.lock), TX_SUCCESS);
+}
+
+/**
+ * @brief  A8 atlas of a font, built on first use
+ */
+static const uint8_t *Overlay_GetAtlas(overlay_font_t font) {
+  if (!atlas_ready[font]) {
+    Overlay_Lock();
+    if (!atlas_ready[font]) {
+      Overlay_BuildAtlas(&overlay_fonts[font]);
+      atlas_ready[font] = 1;
+    }
+    Overlay_Unlock();
+  }
+  return overlay_fonts[font].atlas;
+}
+
+/**
+ * @brief  Append a command to the ring
+ * @note   A full ring is drained first (blocks until the DMA2D is idle)
+ */
+static void Overlay_Append(overlay_cmd_type_t type, int32_t x, int32_t y, int32_t width, int32_t height,
+                           uint32_t color, const uint8_t *glyph, const uint32_t *clut, uint8_t *target) {
+  overlay_cmd_t *cmd;
+
+  Overlay_Lock();
+
+  if (ovl_ctx.head - ovl_ctx.tail >= OVERLAY_MAX_CMDS) {
+    Overlay_Submit();
+    Overlay_Wait();
+  }
+
+  cmd = &ovl_ctx.cmds[ovl_ctx.head & (OVERLAY_MAX_CMDS - 1)];
+  cmd->type = (uint8_t)type;
+  cmd->x = (uint16_t)x;
+  cmd->y = (uint16_t)y;
+  cmd->width = (uint16_t)width;
+  cmd->height = (uint16_t)height;
+  cmd->color = color;
+  cmd->glyph = glyph;
+  cmd->clut = clut;
+  cmd->target = target;
+  ovl_ctx.head++;
+
+  Overlay_Unlock();
+}
+
+/**
+ * @brief  Append a command, clipped to the context rectangle
+ */
+static void Overlay_Push(const overlay_ctx_t *ctx, overlay_cmd_type_t type, int32_t x, int32_t y,
+                         int32_t width, int32_t height, uint32_t color,
+                         const uint8_t *glyph, const uint32_t *clut) {
+  APP_REQUIRE(ctx != NULL && ctx->target != NULL);
+
+  /* Images are queued whole or not at all (their source stride is fixed) */
+  if (type != OVERLAY_CMD_FILL) {
+    if (x < ctx->x0 || y < ctx->y0 || x + width > ctx->x1 || y + height > ctx->y1) {
+      return;
+    }
+  } else {
+    if (x < ctx->x0) {
+      width -= ctx->x0 - x;
+      x = ctx->x0;
+    }
+    if (y < ctx->y0) {
+      height -= ctx->y0 - y;
+      y = ctx->y0;
+    }
+    width = MIN(width, ctx->x1 - x);
+    height = MIN(height, ctx->y1 - y);
+  }
+
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  Overlay_Append(type, x, y, width, height, color, glyph, clut, ctx->target);
+}
+
+/**
+ * @brief  UI_LAYER_FORMAT color (as UTIL_LCD hands it to the driver) to ARGB8888
+ */
+static uint32_t Overlay_LcdColor(uint32_t color) {
+#if UI_LAYER_ARGB4444
+  return ((((color >> 12) & 0xFU) * 17U) << 24) | ((((color >> 8) & 0xFU) * 17U) << 16) |
+         ((((color >> 4) & 0xFU) * 17U) << 8) | ((color & 0xFU) * 17U);
+#else
+  return color;
+#endif
+}
+
+/**
+ * @brief  UTIL_LCD FillRGBRect: stage the pixels and queue their copy
+ * @note   UTIL_LCD draws a character as one call per glyph row: rows that
+ *         continue the last queued copy extend it, one command per glyph
+ */
+static int32_t Overlay_LcdFillRGBRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pData,
+                                      uint32_t Width, uint32_t Height) {
+  const overlay_ctx_t *ctx = ovl_ctx.lcd;
+  uint32_t bytes = Width * Height * OVERLAY_BPP;
+  uint8_t *dst;
+
+  UNUSED(Instance);
+  APP_REQUIRE(ctx != NULL);
+  APP_REQUIRE(bytes <= OVERLAY_STAGING_SIZE);
+
+  if (bytes == 0 || (int32_t)Xpos < ctx->x0 || (int32_t)Ypos < ctx->y0 ||
+      (int32_t)(Xpos + Width) > ctx->x1 || (int32_t)(Ypos + Height) > ctx->y1) {
+    return BSP_ERROR_NONE;
+  }
+
+  Overlay_Lock();
+
+  /* Arena full: let the queued copies finish before reusing it */
+  if (ovl_ctx.staging_used + bytes > OVERLAY_STAGING_SIZE) {
+    Overlay_Submit();
+    Overlay_Wait();
+    ovl_ctx.staging_used = 0;
+    ovl_ctx.staging_clean = 0;
+  }
+
+  dst = &staging[ovl_ctx.staging_used];
+  memcpy(dst, pData, bytes);
+  ovl_ctx.staging_used += bytes;
+
+  /* Not yet published: the interrupt cannot be running it */
+  if (ovl_ctx.head != ovl_ctx.submit) {
+    overlay_cmd_t *last = &ovl_ctx.cmds[(ovl_ctx.head - 1) & (OVERLAY_MAX_CMDS - 1)];
+
+    if (last->type == OVERLAY_CMD_COPY && last->target == ctx->target && last->x == Xpos &&
+        last->width == Width && last->y + last->height == Ypos && last->height + Height <= UINT16_MAX &&
+        last->glyph + last->width * last->height * OVERLAY_BPP == dst) {
+      last->height += (uint16_t)Height;
+      Overlay_Unlock();
+      return BSP_ERROR_NONE;
+    }
+  }
+
+  Overlay_Push(ctx, OVERLAY_CMD_COPY, Xpos, Ypos, Width, Height, 0, dst, NULL);
+  Overlay_Unlock();
+  return BSP_ERROR_NONE;
+}
+
+static int32_t Overlay_LcdDrawHLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length,
+                                    uint32_t Color) {
+  UNUSED(Instance);
+  Overlay_FillRect(ovl_ctx.lcd, Xpos, Ypos, Length, 1, Overlay_LcdColor(Color));
+  return BSP_ERROR_NONE;
+}
+
+static int32_t Overlay_LcdDrawVLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length,
+                                    uint32_t Color) {
+  UNUSED(Instance);
+  Overlay_FillRect(ovl_ctx.lcd, Xpos, Ypos, 1, Length, Overlay_LcdColor(Color));
+  return BSP_ERROR_NONE;
+}
+
+static int32_t Overlay_LcdFillRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Width,
+                                   uint32_t Height, uint32_t Color) {
+  UNUSED(Instance);
+  Overlay_FillRect(ovl_ctx.lcd, Xpos, Ypos, Width, Height, Overlay_LcdColor(Color));
+  return BSP_ERROR_NONE;
+}
+
+static int32_t Overlay_LcdSetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color) {
+  UNUSED(Instance);
+  Overlay_FillRect(ovl_ctx.lcd, Xpos, Ypos, 1, 1, Overlay_LcdColor(Color));
+  return BSP_ERROR_NONE;
+}
+
+/**
+ * @brief  UTIL_LCD GetPixel: a full fence, then a CPU read of the target
+ */
+static int32_t Overlay_LcdGetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t *Color) {
+  uint8_t *pixel;
+
+  UNUSED(Instance);
+  APP_REQUIRE(ovl_ctx.lcd != NULL);
+  APP_REQUIRE(Xpos < UI_LAYER_WIDTH && Ypos < UI_LAYER_HEIGHT);
+
+  Overlay_Submit();
+  Overlay_Wait();
+
+  pixel = ovl_ctx.lcd->target + (Ypos * OVERLAY_STRIDE + Xpos) * OVERLAY_BPP;
+  if (Buffer_GetDesc(BUFFER_ID_UI_DISPLAY)->cacheable) {
+    SCB_InvalidateDCache_by_Addr((void *)pixel, OVERLAY_BPP);
+  }
+#if UI_LAYER_ARGB4444
+  *Color = *(uint16_t *)pixel;
+#else
+  *Color = *(uint32_t *)pixel;
+#endif
+  return BSP_ERROR_NONE;
+}
+
+/**
+ * @brief  UTIL_LCD DrawBitmap: left to the polling BSP once the ring is idle
+ */
+static int32_t Overlay_LcdDrawBitmap(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pBmp) {
+  int32_t ret;
+
+  /* Nothing may start on the DMA2D until the BSP is done polling it */
+  Overlay_Lock();
+  Overlay_Submit();
+  Overlay_Wait();
+  ovl_ctx.clut = NULL;
+  ret = BSP_LCD_DrawBitmap(Instance, Xpos, Ypos, pBmp);
+  Overlay_Unlock();
+  return ret;
+}
+
+/* UTIL_LCD drawing queued on the ring; geometry queries stay with the BSP */
+static const LCD_UTILS_Drv_t overlay_lcd_driver = {
+    Overlay_LcdDrawBitmap,
+    Overlay_LcdFillRGBRect,
+    Overlay_LcdDrawHLine,
+    Overlay_LcdDrawVLine,
+    Overlay_LcdFillRect,
+    Overlay_LcdGetPixel,
+    Overlay_LcdSetPixel,
+    BSP_LCD_GetXSize,
+    BSP_LCD_GetYSize,
+    BSP_LCD_SetActiveLayer,
+    BSP_LCD_GetPixelFormat,
+};
+
+/**
+ * @brief  Build the glyph atlases, enable the DMA2D interrupt and route
+ *         UTIL_LCD drawing to the command ring
+ */
+IN_XIP void Overlay_Init(void) {
+  memset(&ovl_ctx, 0, sizeof(ovl_ctx));
+
+  memset(&label_cache, 0, sizeof(label_cache));
+#if !ASSET_PACK_ENABLE
+  for (uint32_t i = 0; i < OVERLAY_FONT_NB; i++) {
+    Overlay_BuildAtlas(&overlay_fonts[i]);
+    atlas_ready[i] = 1;
+  }
+#endif
+
+  APP_REQUIRE_EQ(tx_mutex_create(&ovl_ctx.lock, "overlay_lock", TX_INHERIT), TX_SUCCESS);
+  for (uint32_t i = 0; i < OVERLAY_WAITERS_MAX; i++) {
+    APP_REQUIRE_EQ(tx_semaphore_create(&ovl_ctx.waiters[i].sem, "overlay_wait", 0), TX_SUCCESS);
+  }
+
+  HAL_NVIC_SetPriority(DMA2D_IRQn, OVERLAY_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+
+  UTIL_LCD_SetFuncDriver(&overlay_lcd_driver);
+}
+
+/**
+ * @brief  Set up a drawing context on a UI frame buffer
+ */
+void Overlay_CtxInit(overlay_ctx_t *ctx, uint8_t *target, int32_t x, int32_t y,
+                     int32_t width, int32_t height) {
+  APP_REQUIRE(ctx != NULL && target != NULL);
+  APP_REQUIRE(x >= 0 && y >= 0 && width > 0 && height > 0);
+  APP_REQUIRE(x + width <= UI_LAYER_WIDTH && y + height <= UI_LAYER_HEIGHT);
+
+  ctx->target = target;
+  ctx->x0 = (int16_t)x;
+  ctx->y0 = (int16_t)y;
+  ctx->x1 = (int16_t)(x + width);
+  ctx->y1 = (int16_t)(y + height);
+}
+
+/**
+ * @brief  Select the context UTIL_LCD drawing is queued into
+ */
+void Overlay_SetLcdContext(const overlay_ctx_t *ctx) {
+  ovl_ctx.lcd = ctx;
+}
+
+/**
+ * @brief  Queue a solid rectangle fill (clipped to the UI layer)
+ */
+void Overlay_FillRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      uint32_t color) {
+  Overlay_Push(ctx, OVERLAY_CMD_FILL, x, y, width, height, color, NULL, NULL);
+}
+
+/**
+ * @brief  Queue a rectangle outline as four edge fills
+ */
+void Overlay_DrawRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      int32_t thickness, uint32_t color) {
+  if (width <= 2 * thickness || height <= 2 * thickness) {
+    Overlay_FillRect(ctx, x, y, width, height, color);
+    return;
+  }
+
+  Overlay_FillRect(ctx, x, y, width, thickness, color);
+  Overlay_FillRect(ctx, x, y + height - thickness, width, thickness, color);
+  Overlay_FillRect(ctx, x, y + thickness, thickness, height - 2 * thickness, color);
+  Overlay_FillRect(ctx, x + width - thickness, y + thickness, thickness, height - 2 * thickness, color);
+}
+
+/**
+ * @brief  Queue a text string blended over the target, one command per glyph
+ */
+int32_t Overlay_DrawText(const overlay_ctx_t *ctx, int32_t x, int32_t y, const char *text,
+                         overlay_font_t font, uint32_t color) {
+  const overlay_font_desc_t *desc;
+  const uint8_t *atlas;
+  int32_t x0 = x;
+
+  APP_REQUIRE(font < OVERLAY_FONT_NB);
+  desc = &overlay_fonts[font];
+  atlas = Overlay_GetAtlas(font);
+
+  for (; *text != '\0'; text++) {
+    uint8_t c = (uint8_t)*text;
+
+    if (c < OVERLAY_GLYPH_FIRST || c > OVERLAY_GLYPH_LAST) {
+      continue;
+    }
+    if (c != ' ') {
+      Overlay_Push(ctx, OVERLAY_CMD_GLYPH, x, y, desc->width, desc->height, color,
+                   &atlas[(c - OVERLAY_GLYPH_FIRST) * desc->width * desc->height], NULL);
+    }
+    x += desc->width;
+  }
+
+  return x - x0;
+}
+
+/**
+ * @brief  Rasterize a label into a new A8 strip of the cache
+ * @retval Cache entry index, -1 when the cache or its arena is full
+ */
+static int32_t Overlay_CacheLabel(const char *text, overlay_font_t font) {
+  const overlay_font_desc_t *desc = &overlay_fonts[font];
+  const uint8_t *atlas = Overlay_GetAtlas(font);
+  uint32_t len = strlen(text);
+  uint32_t width = len * desc->width;
+  uint32_t size = width * desc->height;
+  uint8_t *strip;
+
+  if (len == 0 || width > UI_LAYER_WIDTH || label_cache.nb >= OVERLAY_LABEL_CACHE_NB ||
+      label_cache.arena_used + size > OVERLAY_LABEL_ARENA_SIZE) {
+    return -1;
+  }
+
+  strip = &label_arena[label_cache.arena_used];
+  for (uint32_t row = 0; row < desc->height; row++) {
+    for (uint32_t i = 0; i < len; i++) {
+      uint8_t c = (uint8_t)text[i];
+      uint8_t *dst = &strip[row * width + i * desc->width];
+
+      if (c < OVERLAY_GLYPH_FIRST || c > OVERLAY_GLYPH_LAST) {
+        c = ' ';
+      }
+      memcpy(dst, &atlas[(c - OVERLAY_GLYPH_FIRST) * desc->width * desc->height + row * desc->width],
+             desc->width);
+    }
+  }
+  SCB_CleanDCache_by_Addr((void *)strip, size);
+
+  label_cache.entries[label_cache.nb].text = text;
+  label_cache.entries[label_cache.nb].strip = strip;
+  label_cache.entries[label_cache.nb].width = (uint16_t)width;
+  label_cache.entries[label_cache.nb].font = (uint8_t)font;
+  label_cache.arena_used += size;
+
+  return (int32_t)label_cache.nb++;
+}
+
+/**
+ * @brief  Queue a constant label as one blend of its cached strip
+ */
+int32_t Overlay_DrawLabel(const overlay_ctx_t *ctx, int32_t x, int32_t y, const char *text,
+                          overlay_font_t font, uint32_t color) {
+  int32_t idx = -1;
+
+  APP_REQUIRE(font < OVERLAY_FONT_NB);
+
+  Overlay_Lock();
+  for (uint32_t i = 0; i < label_cache.nb; i++) {
+    if (label_cache.entries[i].text == text && label_cache.entries[i].font == font) {
+      idx = (int32_t)i;
+      break;
+    }
+  }
+  if (idx < 0) {
+    idx = Overlay_CacheLabel(text, font);
+  }
+  Overlay_Unlock();
+
+  /* Cache exhausted: glyph by glyph */
+  if (idx < 0) {
+    return Overlay_DrawText(ctx, x, y, text, font, color);
+  }
+
+  /* Entries are never evicted: the strip stays valid outside the lock */
+  Overlay_Push(ctx, OVERLAY_CMD_GLYPH, x, y, label_cache.entries[idx].width, overlay_fonts[font].height,
+               color, label_cache.entries[idx].strip, NULL);
+  return label_cache.entries[idx].width;
+}
+
+/**
+ * @brief  Queue an L8 index map shown through a CLUT, blended over the target
+ */
+void Overlay_DrawIndexMap(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                          const uint8_t *index_map, const uint32_t *clut, uint32_t clut_nb) {
+  APP_REQUIRE(clut_nb > 0 && clut_nb <= OVERLAY_CLUT_MAX);
+
+  /* The DMA2D reads the map from memory: push the CPU-written indices out */
+  SCB_CleanDCache_by_Addr((void *)index_map, width * height);
+  Overlay_Push(ctx, OVERLAY_CMD_L8, x, y, width, height, clut_nb, index_map, clut);
+}
+
+/**
+ * @brief  Queue a window of an RGB565 image converted over the target
+ */
+void Overlay_DrawRGB565(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                        const uint8_t *image, uint32_t stride) {
+  APP_REQUIRE(image != NULL && stride >= (uint32_t)width);
+
+  Overlay_Push(ctx, OVERLAY_CMD_RGB565, x, y, width, height, stride, image, NULL);
+}
+
+/**
+ * @brief  Queue the copy of a rectangle from another UI frame buffer
+ */
+void Overlay_CopyRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                      const uint8_t *source) {
+  APP_REQUIRE(source != NULL && source != ctx->target);
+
+  Overlay_Push(ctx, OVERLAY_CMD_BLIT, x, y, width, height, 0, source, NULL);
+}
+
+/**
+ * @brief  Queue the copy of a rectangle from another UI frame buffer, read
+ *         further right in it
+ */
+void Overlay_ScrollRect(const overlay_ctx_t *ctx, int32_t x, int32_t y, int32_t width, int32_t height,
+                        const uint8_t *source, int32_t dx) {
+  APP_REQUIRE(source != NULL && source != ctx->target);
+  APP_REQUIRE(dx >= 0 && x + dx + width <= UI_LAYER_WIDTH);
+
+  Overlay_Push(ctx, OVERLAY_CMD_BLIT, x, y, width, height, (uint32_t)dx, source, NULL);
+}
+
+/**
+ * @brief  Queue a UI layer window over camera columns into RGB565 columns
+ * @param  dst_stride: Output pixels per line
+ * @param  camera: Camera window, NULL for black
+ * @param  camera_stride: Camera pixels per line
+ * @param  ui: UI frame buffer, NULL for none
+ */
+static void Overlay_QueueCompose(uint8_t *dst, uint32_t dst_stride, const uint8_t *camera,
+                                 uint32_t camera_stride, const uint8_t *ui, int32_t ui_x, int32_t width,
+                                 int32_t height) {
+  int32_t covered = (ui != NULL) ? MIN(MAX(UI_LAYER_WIDTH - ui_x, 0), width) : 0;
+
+  APP_REQUIRE(ui_x >= 0 && width > 0 && height > 0 && height <= UI_LAYER_HEIGHT);
+
+  if (covered > 0) {
+    Overlay_Append(OVERLAY_CMD_COMPOSE, (int32_t)dst_stride, 0, covered, height, camera_stride, camera,
+                   (const uint32_t *)(const void *)(ui + ui_x * OVERLAY_BPP), dst);
+  }
+  if (covered < width) {
+    Overlay_Append(OVERLAY_CMD_COMPOSE, (int32_t)dst_stride, 0, width - covered, height, camera_stride,
+                   (camera != NULL) ? camera + covered * 2 : NULL, NULL, dst + covered * 2);
+  }
+}
+
+/**
+ * @brief  Queue the composition of a camera frame and the UI layer above it
+ */
+void Overlay_ComposeRGB565(uint8_t *dst, const uint8_t *camera, const uint8_t *ui, int32_t ui_x,
+                           int32_t width, int32_t height) {
+  APP_REQUIRE(dst != NULL && camera != NULL && ui != NULL);
+
+  Overlay_QueueCompose(dst, (uint32_t)width, camera, (uint32_t)width, ui, ui_x, width, height);
+}
+
+/**
+ * @brief  Queue the composition of the screen as LTDC shows it
+ */
+void Overlay_ComposeScreenRGB565(uint8_t *dst, const uint8_t *camera, const uint8_t *ui) {
+  APP_REQUIRE(dst != NULL && camera != NULL);
+
+  /* Left of the camera window: the UI layer over the background */
+  Overlay_QueueCompose(dst, LCD_WIDTH, NULL, LCD_WIDTH, ui, 0, DISPLAY_LETTERBOX_X0, LCD_HEIGHT);
+  Overlay_QueueCompose(dst + DISPLAY_LETTERBOX_X0 * 2, LCD_WIDTH, camera, DISPLAY_LETTERBOX_WIDTH, ui,
+                       DISPLAY_LETTERBOX_X0, DISPLAY_LETTERBOX_WIDTH, DISPLAY_LETTERBOX_HEIGHT);
+}
+
+/**
+ * @brief  Publish the queued commands to the DMA2D; start it if idle
+ */
+overlay_fence_t Overlay_Submit(void) {
+  TX_INTERRUPT_SAVE_AREA
+  overlay_fence_t fence;
+
+  Overlay_Lock();
+
+  /* The DMA2D reads the staged rows from memory. The targets themselves are
+   * only written by the DMA2D */
+  if (ovl_ctx.staging_used > ovl_ctx.staging_clean) {
+    SCB_CleanDCache_by_Addr((void *)&staging[ovl_ctx.staging_clean],
+                            ovl_ctx.staging_used - ovl_ctx.staging_clean);
+    ovl_ctx.staging_clean = ovl_ctx.staging_used;
+  }
+
+  TX_DISABLE
+  ovl_ctx.submit = ovl_ctx.head;
+  if (!ovl_ctx.running && ovl_ctx.tail != ovl_ctx.submit) {
+    ovl_ctx.running = 1;
+    Overlay_StartCmd(&ovl_ctx.cmds[ovl_ctx.tail & (OVERLAY_MAX_CMDS - 1)]);
+  }
+  TX_RESTORE
+  fence = ovl_ctx.head;
+
+  Overlay_Unlock();
+  return fence;
+}
+
+/**
+ * @brief  Block until the commands before a fence have been drawn
+ */
+void Overlay_WaitFence(overlay_fence_t fence) {
+  TX_INTERRUPT_SAVE_AREA
+  int32_t slot = -1;
+
+  APP_REQUIRE((int32_t)(ovl_ctx.submit - fence) >= 0);
+
+  /* Checked and registered with the interrupt masked: no wake-up is lost */
+  TX_DISABLE
+  if ((int32_t)(ovl_ctx.tail - fence) >= 0) {
+    TX_RESTORE
+    return;
+  }
+  for (uint32_t i = 0; i < OVERLAY_WAITERS_MAX; i++) {
+    if (!ovl_ctx.waiters[i].active) {
+      ovl_ctx.waiters[i].fence = fence;
+      ovl_ctx.waiters[i].active = 1;
+      slot = (int32_t)i;
+      break;
+    }
+  }
+  TX_RESTORE
+
+  APP_REQUIRE(slot >= 0);
+  APP_REQUIRE_EQ(tx_semaphore_get(&ovl_ctx.waiters[slot].sem, TX_WAIT_FOREVER), TX_SUCCESS);
+}
+
+/**
+ * @brief  Block until every submitted command has been drawn
+ */
+void Overlay_Wait(void) {
+  Overlay_WaitFence(ovl_ctx.submit);
+}
+
+/**
+ * @brief  DMA2D interrupt handler: wake the waiters reached, chain to the
+ *         next submitted command
+ */
+void Overlay_IRQHandler(void) {
+  uint32_t isr = DMA2D->ISR;
+
+  DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+  APP_REQUIRE((isr & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)) == 0);
+
+  if (!ovl_ctx.running) {
+    return;
+  }
+
+  ovl_ctx.tail++;
+  for (uint32_t i = 0; i < OVERLAY_WAITERS_MAX; i++) {
+    if (ovl_ctx.waiters[i].active && (int32_t)(ovl_ctx.tail - ovl_ctx.waiters[i].fence) >= 0) {
+      ovl_ctx.waiters[i].active = 0;
+      tx_semaphore_put(&ovl_ctx.waiters[i].sem);
+    }
+  }
+
+  if (ovl_ctx.tail != ovl_ctx.submit) {
+    Overlay_StartCmd(&ovl_ctx.cmds[ovl_ctx.tail & (OVERLAY_MAX_CMDS - 1)]);
+    return;
+  }
+
+  /* Leave interrupts off: a BSP fallback (DrawBitmap) polls the same DMA2D */
+  DMA2D->CR = 0;
+  ovl_ctx.running = 0;
+}
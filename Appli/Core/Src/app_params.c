@@ -0,0 +1,465 @@
+/**
+ ******************************************************************************
+ * @file    app_params.c
+ * @author  Long Liangmao
+ * @brief   Runtime parameters for STM32N6570-DK (PARAMS_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_params.h"
+
+#if PARAMS_ENABLE
+
+#include "app_assets.h"
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_profile.h"
+#include "app_telemetry.h"
+#include "boot_slots.h"
+#include "stm32n6570_discovery_xspi.h"
+#include "stm32n6xx_hal.h"
+#include "tx_thread.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !TELEMETRY
+#error "PARAMS_ENABLE is set and read back over the telemetry link: it needs TELEMETRY"
+#endif
+#if PARAMS_FLASH && defined(APP_SPLIT_XIP)
+#error "PARAMS_FLASH takes the octoFlash out of memory-mapped mode: not with code executing in place from it"
+#endif
+
+#define PARAMS_NOR_INSTANCE 0U
+#define PARAMS_SECTOR_SIZE 4096U /* One erase per stored copy */
+#define PARAMS_COPIES 2U
+#define PARAMS_STORE_MAX 32U
+#define PARAMS_STORE_MAGIC 0x5250364EU /* "N6PR" */
+#define PARAMS_CHECK_SEED 2166136261U  /* FNV-1a offset basis */
+#define PARAMS_PRIORITY_UNSET 0xFFFFFFFFU
+
+#if (PARAMS_FLASH_OFFSET % PARAMS_SECTOR_SIZE) != 0
+#error "PARAMS_FLASH_OFFSET must be on a 4 KB sector"
+#endif
+
+_Static_assert(sizeof(params_record_t) <= TELEMETRY_PAYLOAD_MAX, "Parameter record overflows");
+_Static_assert(PARAM_NB <= PARAMS_STORE_MAX && PARAM_NB <= 32U, "Parameters overflow the store and masks");
+_Static_assert(PARAMS_PRIORITY_MAX < TX_MAX_PRIORITIES, "Priority parameters beyond TX_MAX_PRIORITIES");
+_Static_assert(PARAMS_FLASH_OFFSET + PARAMS_COPIES * PARAMS_SECTOR_SIZE <= BOOT_SLOTS_TABLE_OFFSET ||
+                   PARAMS_FLASH_OFFSET >= BOOT_SLOTS_TABLE_OFFSET + PARAMS_SECTOR_SIZE,
+               "Stored parameters overlap the slot table");
+
+#define PARAM_NAME_CHECK(id, name, type, min, max, step, def, keep) \
+  _Static_assert(sizeof(name) <= PARAMS_NAME_MAX, "Parameter name too long: " name);
+PARAMS_TABLE(PARAM_NAME_CHECK)
+#undef PARAM_NAME_CHECK
+
+typedef struct {
+  const char *name;
+  uint8_t type; /* PARAM_TYPE_ */
+  uint8_t keep;
+  float min;
+  float max;
+  float step;
+  float def;
+} param_desc_t;
+
+static const param_desc_t params_desc[PARAM_NB] = {
+#define PARAM_DESC(id, name, type, min, max, step, def, keep) {name, type, keep, min, max, step, def},
+    PARAMS_TABLE(PARAM_DESC)
+#undef PARAM_DESC
+};
+
+/* Priority parameters, by the name their thread was created with; threads
+ * not built in are skipped */
+static const struct {
+  param_id_t id;
+  const char *thread;
+} params_threads[] = {
+    {PARAM_PRIO_ISP, "isp_update"},
+    {PARAM_PRIO_NN, "nn_inference"},
+    {PARAM_PRIO_PP, "nn_postprocess"},
+    {PARAM_PRIO_UI, "ui_update"},
+};
+
+#define PARAMS_THREAD_NB (sizeof(params_threads) / sizeof(params_threads[0]))
+
+/* One stored copy, at the start of its sector. The two copies alternate:
+ * the valid one of the higher generation wins, so a store cut short by a
+ * reset leaves the previous table */
+typedef struct {
+  uint32_t magic;      /* PARAMS_STORE_MAGIC */
+  uint32_t generation; /* Stores since the first */
+  uint32_t nb;         /* Values stored: parameters appended since start from their defaults */
+  uint32_t values[PARAMS_STORE_MAX];
+  uint32_t check;      /* FNV-1a of the above */
+} params_store_t;
+
+static struct {
+  volatile uint32_t values[PARAM_NB];
+  volatile uint32_t generation; /* Accepted changes since boot */
+  volatile uint32_t report;     /* Bit per parameter: its record is due */
+  volatile uint32_t rejected;   /* Bit per parameter: its last set was refused */
+  uint32_t saved;               /* generation when the table was loaded or stored */
+  uint32_t applied;             /* generation applied at the frame boundary */
+
+  /* As built, taken before the first change: 0 (unset) asks for them back */
+  int32_t built_fps;
+  uint32_t built_priority[PARAMS_THREAD_NB];
+
+  /* Newest stored copy */
+  uint8_t stored;
+  uint8_t copy;
+  uint32_t store_generation;
+#if PARAMS_FLASH
+  uint8_t nor_ready;
+  params_store_t image;
+#endif
+} params_ctx;
+
+static uint32_t Params_Check(const void *data, uint32_t len) {
+  const uint8_t *p = data;
+  uint32_t hash = PARAMS_CHECK_SEED;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= p[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+/**
+ * @brief  Stored form of a table bound
+ */
+static uint32_t Params_Raw(uint8_t type, float x) {
+  uint32_t raw;
+
+  if (type == PARAM_TYPE_INT) {
+    return (uint32_t)(int32_t)x;
+  }
+  memcpy(&raw, &x, sizeof(raw));
+  return raw;
+}
+
+/**
+ * @brief  Test a value against the range and step of its parameter
+ * @retval 1 when the parameter may take it
+ */
+static int Params_Valid(uint32_t id, uint32_t value) {
+  const param_desc_t *desc = &params_desc[id];
+  int32_t v = (int32_t)value;
+  float f;
+
+  if (desc->type == PARAM_TYPE_FLOAT) {
+    memcpy(&f, &value, sizeof(f));
+    /* Written so NaN fails */
+    return f >= desc->min && f <= desc->max;
+  }
+  if (v == 0 && desc->keep) {
+    return 1;
+  }
+  if (v < (int32_t)desc->min || v > (int32_t)desc->max) {
+    return 0;
+  }
+  return desc->step == 0.0f || (v - (int32_t)desc->min) % (int32_t)desc->step == 0;
+}
+
+static const params_store_t *Params_StoredCopy(uint32_t copy) {
+  return (const params_store_t *)(BOOT_SLOTS_FLASH_BASE + PARAMS_FLASH_OFFSET + copy * PARAMS_SECTOR_SIZE);
+}
+
+static int Params_StoreValid(const params_store_t *store) {
+  return store->magic == PARAMS_STORE_MAGIC && store->nb <= PARAMS_STORE_MAX &&
+         store->check == Params_Check(store, offsetof(params_store_t, check));
+}
+
+void Params_Init(void) {
+  const params_store_t *store = NULL;
+  uint32_t nb, loaded = 0;
+
+  memset(&params_ctx, 0, sizeof(params_ctx));
+  for (uint32_t id = 0; id < PARAM_NB; id++) {
+    params_ctx.values[id] = Params_Raw(params_desc[id].type, params_desc[id].def);
+  }
+  for (uint32_t i = 0; i < PARAMS_THREAD_NB; i++) {
+    params_ctx.built_priority[i] = PARAMS_PRIORITY_UNSET;
+  }
+  /* Everything not as built is applied at the first frame boundary */
+  params_ctx.applied = params_ctx.generation - 1U;
+
+  for (uint32_t copy = 0; copy < PARAMS_COPIES; copy++) {
+    const params_store_t *s = Params_StoredCopy(copy);
+
+    if (Params_StoreValid(s) && (store == NULL || (int32_t)(s->generation - store->generation) > 0)) {
+      store = s;
+      params_ctx.copy = (uint8_t)copy;
+    }
+  }
+  if (store == NULL) {
+    printf("Params: defaults (none stored)\r\n");
+    return;
+  }
+
+  params_ctx.stored = 1;
+  params_ctx.store_generation = store->generation;
+  /* A value the table no longer allows keeps its default */
+  nb = MIN(store->nb, (uint32_t)PARAM_NB);
+  for (uint32_t id = 0; id < nb; id++) {
+    if (Params_Valid(id, store->values[id])) {
+      params_ctx.values[id] = store->values[id];
+      loaded++;
+    }
+  }
+  printf("Params: %lu of %lu loaded (store %lu)\r\n", (unsigned long)loaded, (unsigned long)PARAM_NB,
+         (unsigned long)store->generation);
+}
+
+int32_t Params_GetInt(param_id_t id) {
+  APP_REQUIRE(id < PARAM_NB && params_desc[id].type == PARAM_TYPE_INT);
+
+  return (int32_t)params_ctx.values[id];
+}
+
+float Params_GetFloat(param_id_t id) {
+  uint32_t raw;
+  float f;
+
+  APP_REQUIRE(id < PARAM_NB && params_desc[id].type == PARAM_TYPE_FLOAT);
+  raw = params_ctx.values[id];
+  memcpy(&f, &raw, sizeof(f));
+  return f;
+}
+
+void Params_Set(uint32_t id, uint32_t value) {
+  if (id >= PARAM_NB) {
+    return;
+  }
+  if (Params_Valid(id, value)) {
+    params_ctx.values[id] = value;
+    __atomic_fetch_and(&params_ctx.rejected, ~(1UL << id), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&params_ctx.generation, 1U, __ATOMIC_RELEASE);
+  } else {
+    __atomic_fetch_or(&params_ctx.rejected, 1UL << id, __ATOMIC_RELAXED);
+  }
+  __atomic_fetch_or(&params_ctx.report, 1UL << id, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief  Sensor frame rate from cam.fps
+ */
+static void Params_ApplyFrameRate(void) {
+  int32_t fps = Params_GetInt(PARAM_CAM_FPS);
+
+#if PROFILE_ENABLE
+  /* The profile owns the rate; a set one overrides it */
+  Profile_SetFrameRate(fps);
+#else
+  if (fps == 0) {
+    if (params_ctx.built_fps == 0) {
+      return;
+    }
+    fps = params_ctx.built_fps;
+  } else if (params_ctx.built_fps == 0) {
+    params_ctx.built_fps = CAM_GetFrameRate();
+  }
+  if (fps != CAM_GetFrameRate()) {
+    CAM_SetFrameRate(fps);
+    printf("Params: %ld fps\r\n", (long)fps);
+  }
+#endif
+}
+
+/**
+ * @brief  Created thread of a name
+ * @retval NULL when not built in
+ * @note   Threads are created and deleted during the bring-up only
+ */
+static TX_THREAD *Params_FindThread(const char *name) {
+  TX_THREAD *thread = _tx_thread_created_ptr;
+
+  for (ULONG i = 0; i < _tx_thread_created_count; i++) {
+    if (strcmp(thread->tx_thread_name, name) == 0) {
+      return thread;
+    }
+    thread = thread->tx_thread_created_next;
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Pipeline thread priorities from prio.*
+ */
+static void Params_ApplyPriorities(void) {
+  for (uint32_t i = 0; i < PARAMS_THREAD_NB; i++) {
+    TX_THREAD *thread = Params_FindThread(params_threads[i].thread);
+    uint32_t priority = (uint32_t)Params_GetInt(params_threads[i].id);
+    UINT old;
+
+    if (thread == NULL) {
+      continue;
+    }
+    if (priority == 0U) {
+      if (params_ctx.built_priority[i] == PARAMS_PRIORITY_UNSET) {
+        continue;
+      }
+      priority = params_ctx.built_priority[i];
+    } else if (params_ctx.built_priority[i] == PARAMS_PRIORITY_UNSET) {
+      params_ctx.built_priority[i] = thread->tx_thread_user_priority;
+    }
+    /* Preemption threshold follows: every thread is created with it equal */
+    if (priority != thread->tx_thread_user_priority) {
+      APP_REQUIRE_EQ(tx_thread_priority_change(thread, priority, &old), TX_SUCCESS);
+      printf("Params: %s at priority %lu\r\n", params_threads[i].thread, (unsigned long)priority);
+    }
+  }
+}
+
+#if PARAMS_FLASH
+/**
+ * @brief  Write the table to the older copy, then map the octoFlash back
+ * @note   Nothing may read the octoFlash meanwhile: NPU idle, no code or
+ *         constants executed in place. Fail-fast: panics when it cannot be
+ *         mapped back
+ */
+static void Params_Store(void) {
+  params_store_t *image = &params_ctx.image;
+  uint32_t copy = params_ctx.stored ? 1U - params_ctx.copy : 0U;
+  uint32_t offset = PARAMS_FLASH_OFFSET + copy * PARAMS_SECTOR_SIZE;
+  uint32_t generation = params_ctx.generation;
+  uint32_t start = HAL_GetTick();
+  int32_t ret;
+
+  memset(image, 0, sizeof(*image));
+  image->magic = PARAMS_STORE_MAGIC;
+  image->generation = params_ctx.stored ? params_ctx.store_generation + 1U : 1U;
+  image->nb = PARAM_NB;
+  for (uint32_t id = 0; id < PARAM_NB; id++) {
+    image->values[id] = params_ctx.values[id];
+  }
+  image->check = Params_Check(image, offsetof(params_store_t, check));
+
+#if ASSET_PACK_ENABLE
+  Assets_LockFlash();
+#endif
+  if (!params_ctx.nor_ready) {
+    BSP_XSPI_NOR_Init_t init = {
+        .InterfaceMode = BSP_XSPI_NOR_OPI_MODE,
+        .TransferRate = BSP_XSPI_NOR_DTR_TRANSFER,
+    };
+
+    /* Takes xSPI2 over from the memory-mapped setup the FSBL left */
+    APP_REQUIRE_EQ(BSP_XSPI_NOR_Init(PARAMS_NOR_INSTANCE, &init), BSP_ERROR_NONE);
+    params_ctx.nor_ready = 1;
+  } else {
+    APP_REQUIRE_EQ(BSP_XSPI_NOR_DisableMemoryMappedMode(PARAMS_NOR_INSTANCE), BSP_ERROR_NONE);
+  }
+  ret = BSP_XSPI_NOR_Erase_Block(PARAMS_NOR_INSTANCE, offset, BSP_XSPI_NOR_ERASE_4K);
+  if (ret == BSP_ERROR_NONE) {
+    ret = BSP_XSPI_NOR_Write(PARAMS_NOR_INSTANCE, (const uint8_t *)image, offset, sizeof(*image));
+  }
+  APP_REQUIRE_EQ(BSP_XSPI_NOR_EnableMemoryMappedMode(PARAMS_NOR_INSTANCE), BSP_ERROR_NONE);
+#if ASSET_PACK_ENABLE
+  Assets_UnlockFlash();
+#endif
+  SCB_InvalidateDCache_by_Addr((void *)Params_StoredCopy(copy), (int32_t)sizeof(*image));
+
+  if (ret != BSP_ERROR_NONE || !Params_StoreValid(Params_StoredCopy(copy))) {
+    printf("Params: store failed (%ld)\r\n", (long)ret);
+    return;
+  }
+  params_ctx.stored = 1;
+  params_ctx.copy = (uint8_t)copy;
+  params_ctx.store_generation = image->generation;
+  params_ctx.saved = generation;
+  /* The dirty flag of every record changed */
+  __atomic_fetch_or(&params_ctx.report, (uint32_t)((1ULL << PARAM_NB) - 1U), __ATOMIC_RELAXED);
+  printf("Params: stored (copy %lu, store %lu, %lu ms)\r\n", (unsigned long)copy, (unsigned long)image->generation,
+         (unsigned long)(HAL_GetTick() - start));
+}
+#endif /* PARAMS_FLASH */
+
+void Params_FrameBoundary(void) {
+  uint32_t generation = __atomic_load_n(&params_ctx.generation, __ATOMIC_ACQUIRE);
+
+  if (generation != params_ctx.applied) {
+    params_ctx.applied = generation;
+#if PROFILE_ENABLE
+    Profile_Select((uint32_t)Params_GetInt(PARAM_POWER_PROFILE));
+#endif
+    Params_ApplyFrameRate();
+    Params_ApplyPriorities();
+  }
+#if PARAMS_FLASH
+  if (Telemetry_TakeRequest(TELEMETRY_REQUEST_PARAMS_STORE)) {
+    Params_Store();
+  }
+#endif
+}
+
+/**
+ * @brief  Send the record of one parameter
+ * @retval 1 when sent, 0 when the telemetry ring is full
+ */
+static int Params_SendRecord(uint32_t id) {
+  const param_desc_t *desc = &params_desc[id];
+  uint32_t generation = params_ctx.generation;
+  params_record_t rec = {
+      .generation = generation,
+      .id = (uint8_t)id,
+      .nb = PARAM_NB,
+      .type = desc->type,
+      .value = params_ctx.values[id],
+      .min = Params_Raw(desc->type, desc->min),
+      .max = Params_Raw(desc->type, desc->max),
+      .step = Params_Raw(desc->type, desc->step),
+      .def = Params_Raw(desc->type, desc->def),
+  };
+
+  rec.flags = (desc->keep ? PARAMS_FLAG_KEEP : 0U) | (((params_ctx.rejected >> id) & 1U) ? PARAMS_FLAG_REJECTED : 0U) |
+              ((generation != params_ctx.saved) ? PARAMS_FLAG_DIRTY : 0U) | (params_ctx.stored ? PARAMS_FLAG_STORED : 0U);
+  strncpy(rec.name, desc->name, sizeof(rec.name));
+  return Telemetry_Send(TELEMETRY_TYPE_PARAMS, &rec, sizeof(rec));
+}
+
+void Params_Poll(void) {
+  const uint32_t all = (uint32_t)((1ULL << PARAM_NB) - 1U);
+  uint32_t due;
+
+  if (Telemetry_TakeRequest(TELEMETRY_REQUEST_PARAMS_DEFAULTS)) {
+    for (uint32_t id = 0; id < PARAM_NB; id++) {
+      params_ctx.values[id] = Params_Raw(params_desc[id].type, params_desc[id].def);
+    }
+    __atomic_fetch_and(&params_ctx.rejected, 0U, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&params_ctx.generation, 1U, __ATOMIC_RELEASE);
+    __atomic_fetch_or(&params_ctx.report, all, __ATOMIC_RELAXED);
+  }
+  if (Telemetry_TakeRequest(TELEMETRY_REQUEST_PARAMS_GET)) {
+    __atomic_fetch_or(&params_ctx.report, all, __ATOMIC_RELAXED);
+  }
+
+  /* Taken before sent: a set meanwhile gets its own record */
+  due = __atomic_exchange_n(&params_ctx.report, 0U, __ATOMIC_RELAXED);
+  while (due != 0U) {
+    uint32_t id = (uint32_t)__builtin_ctz(due);
+
+    if (!Params_SendRecord(id)) {
+      /* Ring full: the rest on the next wake */
+      __atomic_fetch_or(&params_ctx.report, due, __ATOMIC_RELAXED);
+      return;
+    }
+    due &= due - 1U;
+  }
+}
+
+#endif /* PARAMS_ENABLE */
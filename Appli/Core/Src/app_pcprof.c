@@ -0,0 +1,238 @@
+/**
+ ******************************************************************************
+ * @file    app_pcprof.c
+ * @author  Long Liangmao
+ * @brief   Statistical PC sampler for STM32N6570-DK (PC_PROFILER)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_pcprof.h"
+
+#if PC_PROFILER
+
+#include "app_error.h"
+#include "app_telemetry.h"
+#include "stm32n6xx_hal.h"
+#include <string.h>
+
+#if !TELEMETRY
+#error "PC_PROFILER sends its histograms as telemetry records: it needs TELEMETRY"
+#endif
+#if PC_PROFILER_BUCKETS < 64 || PC_PROFILER_BUCKETS > 65536 || (PC_PROFILER_BUCKETS & (PC_PROFILER_BUCKETS - 1)) != 0
+#error "PC_PROFILER_BUCKETS must be a power of two, 64 to 65536"
+#endif
+#if PC_PROFILER_HZ < 100 || PC_PROFILER_HZ > 20000
+#error "PC_PROFILER_HZ out of range"
+#endif
+
+_Static_assert(sizeof(pcprof_record_t) <= TELEMETRY_PAYLOAD_MAX, "PC profile record overflows");
+
+#define PCPROF_TIM TIM2
+#define PCPROF_TIM_IRQn TIM2_IRQn
+#define PCPROF_TIM_HZ 1000000U
+
+/* Period dithered over +-1/8 so the samples do not beat with the frame,
+ * tick or NPU epoch rates */
+#define PCPROF_PERIOD_US (PCPROF_TIM_HZ / PC_PROFILER_HZ)
+#define PCPROF_DITHER_US (PCPROF_PERIOD_US / 4U)
+
+/* Basic exception frame: r0-r3, r12, lr, pc, xpsr. The callee registers
+ * and the integrity signature come first when stacked for a Non-secure
+ * background (EXC_RETURN.DCRS clear) */
+#define PCPROF_FRAME_LR 5U
+#define PCPROF_FRAME_PC 6U
+#define PCPROF_FRAME_CALLEE_WORDS 10U
+
+typedef enum {
+  PCPROF_STATE_SAMPLING,
+  PCPROF_STATE_DUMP_PC, /* Sampling paused while the histograms are sent */
+  PCPROF_STATE_DUMP_LR,
+} pcprof_state_t;
+
+/* First and last word of the application code (linker script and startup) */
+extern const uint32_t g_pfnVectors[];
+extern const uint32_t _etext[];
+
+/* ITCM code and its load image, between the two (STM32N657XX_LRUN.ld) */
+extern const uint32_t __itcm_start[];
+extern const uint32_t __itcm_end[];
+extern const uint32_t __itcm_load[];
+
+static struct {
+  uint32_t pc[PC_PROFILER_BUCKETS];
+  uint32_t lr[PC_PROFILER_BUCKETS];
+  uint32_t base;
+  uint32_t limit;
+  uint32_t shift;
+  volatile uint32_t samples; /* Since the last dump, outside the buckets included */
+  volatile uint8_t paused;
+  uint32_t dither;           /* xorshift32 state */
+
+  pcprof_state_t state;
+  uint32_t next_bucket;      /* Dump position */
+  uint32_t dump_samples;
+  uint16_t dumps;
+} pcprof_ctx;
+
+void PcProf_Init(void) {
+  uint32_t timg_hz = HAL_RCCEx_GetTIMGFreq();
+
+  memset(&pcprof_ctx, 0, sizeof(pcprof_ctx));
+  pcprof_ctx.base = (uint32_t)g_pfnVectors;
+  pcprof_ctx.limit = (uint32_t)_etext;
+  APP_REQUIRE(pcprof_ctx.limit > pcprof_ctx.base);
+  /* Smallest buckets covering the code */
+  while (((pcprof_ctx.limit - pcprof_ctx.base - 1U) >> pcprof_ctx.shift) >= PC_PROFILER_BUCKETS) {
+    pcprof_ctx.shift++;
+  }
+  pcprof_ctx.dither = 0x2545F491U;
+  pcprof_ctx.state = PCPROF_STATE_SAMPLING;
+
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  __HAL_RCC_TIM2_CLK_SLEEP_ENABLE();
+  PCPROF_TIM->CR1 = 0;
+  PCPROF_TIM->PSC = timg_hz / PCPROF_TIM_HZ - 1U;
+  PCPROF_TIM->ARR = PCPROF_PERIOD_US - 1U;
+  PCPROF_TIM->EGR = TIM_EGR_UG; /* Load PSC, clear CNT */
+  PCPROF_TIM->SR = 0;
+  PCPROF_TIM->DIER = TIM_DIER_UIE;
+
+  HAL_NVIC_SetPriority(PCPROF_TIM_IRQn, PCPROF_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(PCPROF_TIM_IRQn);
+  PCPROF_TIM->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Bucket of a code address
+ * @retval PC_PROFILER_BUCKETS when outside the application code
+ */
+static inline uint32_t PcProf_Bucket(uint32_t addr) {
+  addr &= ~1U; /* Thumb bit of a return address */
+  /* ITCM code counts at its load image; telemetry.ps1 maps it back */
+  if (addr >= (uint32_t)__itcm_start && addr < (uint32_t)__itcm_end) {
+    addr += (uint32_t)__itcm_load - (uint32_t)__itcm_start;
+  }
+  if (addr < pcprof_ctx.base || addr >= pcprof_ctx.limit) {
+    return PC_PROFILER_BUCKETS;
+  }
+  return (addr - pcprof_ctx.base) >> pcprof_ctx.shift;
+}
+
+void PcProf_IRQHandler(const uint32_t *frame, uint32_t exc_return) {
+  uint32_t x = pcprof_ctx.dither;
+  uint32_t b;
+
+  PCPROF_TIM->SR = (uint32_t)~TIM_SR_UIF;
+  /* Next period: the counter restarted at the update, ARR applies now */
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  pcprof_ctx.dither = x;
+  PCPROF_TIM->ARR = PCPROF_PERIOD_US - PCPROF_DITHER_US / 2U + x % (PCPROF_DITHER_US + 1U) - 1U;
+
+  if (pcprof_ctx.paused) {
+    return;
+  }
+  pcprof_ctx.samples++;
+
+  /* A Non-secure background stacked on its own stacks: outside */
+  if ((exc_return & EXC_RETURN_S) == 0U) {
+    return;
+  }
+  if ((exc_return & EXC_RETURN_DCRS) == 0U) {
+    frame += PCPROF_FRAME_CALLEE_WORDS;
+  }
+
+  b = PcProf_Bucket(frame[PCPROF_FRAME_PC]);
+  if (b < PC_PROFILER_BUCKETS) {
+    pcprof_ctx.pc[b]++;
+  }
+  b = PcProf_Bucket(frame[PCPROF_FRAME_LR]);
+  if (b < PC_PROFILER_BUCKETS) {
+    pcprof_ctx.lr[b]++;
+  }
+}
+
+/**
+ * @brief  Send the next record of the dump
+ * @retval 1 when sent, 0 when the telemetry ring is full
+ */
+static int PcProf_SendRecord(void) {
+  const uint32_t *hist = (pcprof_ctx.state == PCPROF_STATE_DUMP_LR) ? pcprof_ctx.lr : pcprof_ctx.pc;
+  pcprof_record_t rec = {
+      .dump = pcprof_ctx.dumps,
+      .flags = (pcprof_ctx.state == PCPROF_STATE_DUMP_LR) ? PCPROF_FLAG_LR : 0U,
+      .base = pcprof_ctx.base,
+      .samples = pcprof_ctx.dump_samples,
+      .shift = (uint8_t)pcprof_ctx.shift,
+  };
+  uint32_t b = pcprof_ctx.next_bucket;
+
+  while (b < PC_PROFILER_BUCKETS && rec.nb < PCPROF_ENTRIES_PER_RECORD) {
+    if (hist[b] != 0U) {
+      rec.entries[rec.nb].bucket = (uint16_t)b;
+      rec.entries[rec.nb].count = hist[b];
+      rec.nb++;
+    }
+    b++;
+  }
+  /* The rest of the histogram empty: this record ends it */
+  while (b < PC_PROFILER_BUCKETS && hist[b] == 0U) {
+    b++;
+  }
+  if (b == PC_PROFILER_BUCKETS && pcprof_ctx.state == PCPROF_STATE_DUMP_LR) {
+    rec.flags |= PCPROF_FLAG_LAST;
+  }
+  if (!Telemetry_Send(TELEMETRY_TYPE_PCPROF, &rec, sizeof(rec))) {
+    return 0;
+  }
+
+  pcprof_ctx.next_bucket = b;
+  if (b == PC_PROFILER_BUCKETS) {
+    pcprof_ctx.next_bucket = 0;
+    pcprof_ctx.state = (pcprof_ctx.state == PCPROF_STATE_DUMP_PC) ? PCPROF_STATE_DUMP_LR : PCPROF_STATE_SAMPLING;
+  }
+  return 1;
+}
+
+void PcProf_Poll(void) {
+  if (pcprof_ctx.state == PCPROF_STATE_SAMPLING) {
+    if (!Telemetry_TakeRequest(TELEMETRY_REQUEST_PCPROF)) {
+      return;
+    }
+    /* Frozen while sent: the records of one dump add up */
+    pcprof_ctx.paused = 1;
+    __DSB();
+    pcprof_ctx.dump_samples = pcprof_ctx.samples;
+    pcprof_ctx.dumps++;
+    pcprof_ctx.next_bucket = 0;
+    pcprof_ctx.state = PCPROF_STATE_DUMP_PC;
+  }
+
+  for (uint32_t r = 0; r < PC_PROFILER_DUMP_RECORDS; r++) {
+    if (!PcProf_SendRecord()) {
+      return;
+    }
+    if (pcprof_ctx.state == PCPROF_STATE_SAMPLING) {
+      /* Each dump covers the time since the previous one */
+      memset(pcprof_ctx.pc, 0, sizeof(pcprof_ctx.pc));
+      memset(pcprof_ctx.lr, 0, sizeof(pcprof_ctx.lr));
+      pcprof_ctx.samples = 0;
+      __DSB();
+      pcprof_ctx.paused = 0;
+      return;
+    }
+  }
+}
+
+#endif /* PC_PROFILER */
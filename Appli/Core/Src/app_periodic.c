@@ -0,0 +1,108 @@
+/**
+ ******************************************************************************
+ * @file    app_periodic.c
+ * @author  Long Liangmao
+ * @brief   Periodic work service for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_periodic.h"
+#include "app_error.h"
+#include "stm32n6xx_hal.h"
+
+typedef struct {
+  TX_EVENT_FLAGS_GROUP *group;
+  ULONG flags;
+  ULONG period; /* Ticks */
+  ULONG due;    /* Tick of the next expiry, a multiple of period */
+} periodic_client_t;
+
+static struct {
+  TX_TIMER timer; /* One-shot, re-armed at the earliest due client */
+  periodic_client_t clients[PERIODIC_MAX_CLIENTS];
+  uint32_t nb;
+} periodic_ctx;
+
+/**
+ * @brief  Next multiple of period strictly after now
+ */
+static ULONG Periodic_NextDue(ULONG now, ULONG period) {
+  return (now / period + 1U) * period;
+}
+
+/**
+ * @brief  Arm the timer at the earliest due client
+ * @note   Timer inactive; interrupts masked or the timer thread
+ */
+static void Periodic_Arm(ULONG now) {
+  ULONG wait = 0;
+
+  for (uint32_t i = 0; i < periodic_ctx.nb; i++) {
+    ULONG left = periodic_ctx.clients[i].due - now;
+
+    if (wait == 0 || left < wait) {
+      wait = left;
+    }
+  }
+  if (wait != 0) {
+    APP_REQUIRE_EQ(tx_timer_change(&periodic_ctx.timer, wait, 0), TX_SUCCESS);
+    APP_REQUIRE_EQ(tx_timer_activate(&periodic_ctx.timer), TX_SUCCESS);
+  }
+}
+
+/**
+ * @brief  Timer expiry (ThreadX timer thread): wake every due client
+ */
+static void Periodic_Expire(ULONG arg) {
+  const ULONG now = tx_time_get();
+
+  UNUSED(arg);
+
+  for (uint32_t i = 0; i < periodic_ctx.nb; i++) {
+    periodic_client_t *client = &periodic_ctx.clients[i];
+
+    if ((LONG)(now - client->due) >= 0) {
+      tx_event_flags_set(client->group, client->flags, TX_OR);
+      client->due = Periodic_NextDue(now, client->period);
+    }
+  }
+  Periodic_Arm(now);
+}
+
+void Periodic_Init(void) {
+  APP_REQUIRE_EQ(tx_timer_create(&periodic_ctx.timer, "periodic", Periodic_Expire, 0, 1, 0, TX_NO_ACTIVATE),
+                 TX_SUCCESS);
+}
+
+void Periodic_Register(TX_EVENT_FLAGS_GROUP *group, ULONG flags, uint32_t period_ms) {
+  ULONG period = ((ULONG)period_ms * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U;
+  TX_INTERRUPT_SAVE_AREA
+
+  APP_REQUIRE(group != NULL && flags != 0);
+  if (period == 0) {
+    period = 1;
+  }
+
+  /* The timer thread preempts any caller: hold it off while re-arming */
+  TX_DISABLE
+  APP_REQUIRE(periodic_ctx.nb < PERIODIC_MAX_CLIENTS);
+  (void)tx_timer_deactivate(&periodic_ctx.timer);
+  periodic_ctx.clients[periodic_ctx.nb++] = (periodic_client_t){
+      .group = group,
+      .flags = flags,
+      .period = period,
+      .due = Periodic_NextDue(tx_time_get(), period),
+  };
+  Periodic_Arm(tx_time_get());
+  TX_RESTORE
+}
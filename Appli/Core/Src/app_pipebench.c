@@ -0,0 +1,152 @@
+/**
+ ******************************************************************************
+ * @file    app_pipebench.c
+ * @author  Long Liangmao
+ * @brief   End-to-end pipeline benchmark for STM32N6570-DK (PIPE_BENCH)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_pipebench.h"
+
+#if PIPE_BENCH
+
+#include "app_error.h"
+#include "app_framestats.h"
+#include "app_npu_bw.h"
+#include "app_time.h"
+#include "cmw_camera.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !LATENCY_PROFILER
+#error "PIPE_BENCH takes its stage latencies from LATENCY_PROFILER"
+#endif
+#if !FRAME_STATS
+#error "PIPE_BENCH takes the pipe rates from FRAME_STATS"
+#endif
+#if !NPU_BW_REPORT
+#error "PIPE_BENCH takes the NPU memory traffic from NPU_BW_REPORT"
+#endif
+#if !THREAD_PROFILER_UART
+#error "PIPE_BENCH prints on the COM port opened by THREAD_PROFILER_UART"
+#endif
+
+/* Stage samples plus the end-to-end one, vsync to scanout */
+#define PIPEBENCH_SERIES_NB (LATENCY_STAGE_NB + 1)
+
+static const char *const pipebench_series_names[PIPEBENCH_SERIES_NB] = {
+    "capture_npu", "npu_post", "post_scanout", "total",
+};
+
+/* Recorded and read by the UI thread only: no locking */
+static struct {
+  uint32_t samples[PIPEBENCH_SERIES_NB][PIPE_BENCH_WINDOW]; /* Ring, newest PIPE_BENCH_WINDOW results */
+  uint32_t head;
+  uint32_t count;          /* Valid samples, at most PIPE_BENCH_WINDOW */
+  uint32_t window_results; /* Results scanned out since the last report */
+  uint32_t sorted[PIPE_BENCH_WINDOW];
+  uint64_t window_start_us;
+} pb_ctx;
+
+static int PipeBench_CompareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief  Nearest-rank percentile of the sorted samples
+ */
+static uint32_t PipeBench_Percentile(const uint32_t *sorted, uint32_t count, uint32_t pct) {
+  uint32_t rank = (count * pct + 99U) / 100U;
+
+  return sorted[(rank == 0) ? 0 : rank - 1U];
+}
+
+void PipeBench_Init(void) {
+  memset(&pb_ctx, 0, sizeof(pb_ctx));
+  APP_REQUIRE(CMW_CAMERA_SetTestPattern(PIPE_BENCH_PATTERN) == CMW_ERROR_NONE);
+  /* Nothing printed here: the COM port opens with the profiler, later */
+  pb_ctx.window_start_us = Time_GetUs();
+}
+
+void PipeBench_Record(const uint32_t stage_us[LATENCY_STAGE_NB]) {
+  uint32_t total = 0;
+
+  for (uint32_t s = 0; s < LATENCY_STAGE_NB; s++) {
+    pb_ctx.samples[s][pb_ctx.head] = stage_us[s];
+    total += stage_us[s];
+  }
+  pb_ctx.samples[LATENCY_STAGE_NB][pb_ctx.head] = total;
+
+  pb_ctx.head = (pb_ctx.head + 1U) % PIPE_BENCH_WINDOW;
+  if (pb_ctx.count < PIPE_BENCH_WINDOW) {
+    pb_ctx.count++;
+  }
+  pb_ctx.window_results++;
+}
+
+void PipeBench_Update(uint32_t cpu_load_pct) {
+  const uint64_t now_us = Time_GetUs();
+  const uint32_t window_us = (uint32_t)(now_us - pb_ctx.window_start_us);
+  framestats_report_t frames;
+  npu_bw_report_t bw;
+  uint32_t results_tenths;
+
+  if (window_us == 0) {
+    return;
+  }
+
+  FrameStats_GetReport(&frames);
+  results_tenths = (uint32_t)((uint64_t)pb_ctx.window_results * 10000000U / window_us);
+  printf("pipebench pattern=%d window_us=%lu results=%lu fps=%lu.%lu pipe1_fps=%lu.%lu pipe2_fps=%lu.%lu "
+         "inferred=%lu skipped=%lu dropped=%lu cpu_pct=%lu\r\n",
+         (int)PIPE_BENCH_PATTERN, (unsigned long)window_us, (unsigned long)pb_ctx.window_results,
+         (unsigned long)results_tenths / 10, (unsigned long)results_tenths % 10,
+         (unsigned long)frames.pipes[DCMIPP_PIPE1].fps_tenths / 10,
+         (unsigned long)frames.pipes[DCMIPP_PIPE1].fps_tenths % 10,
+         (unsigned long)frames.pipes[DCMIPP_PIPE2].fps_tenths / 10,
+         (unsigned long)frames.pipes[DCMIPP_PIPE2].fps_tenths % 10,
+         (unsigned long)frames.ml_window.consumed, (unsigned long)frames.ml_window.skipped,
+         (unsigned long)frames.display_dropped, (unsigned long)cpu_load_pct);
+
+  /* Percentiles over the newest PIPE_BENCH_WINDOW results, not only this
+   * period: p99 needs more samples than a second holds */
+  for (uint32_t s = 0; pb_ctx.count > 0 && s < PIPEBENCH_SERIES_NB; s++) {
+    memcpy(pb_ctx.sorted, pb_ctx.samples[s], pb_ctx.count * sizeof(pb_ctx.sorted[0]));
+    qsort(pb_ctx.sorted, pb_ctx.count, sizeof(pb_ctx.sorted[0]), PipeBench_CompareU32);
+    printf("pipebench stage=%s n=%lu p50_us=%lu p99_us=%lu max_us=%lu\r\n", pipebench_series_names[s],
+           (unsigned long)pb_ctx.count, (unsigned long)PipeBench_Percentile(pb_ctx.sorted, pb_ctx.count, 50),
+           (unsigned long)PipeBench_Percentile(pb_ctx.sorted, pb_ctx.count, 99),
+           (unsigned long)pb_ctx.sorted[pb_ctx.count - 1U]);
+  }
+
+  /* Memory traffic of the last inference: stream engine cycles moving data
+   * per pool, NPU clock */
+  NPUBw_GetReport(&bw);
+  for (uint32_t i = 0; bw.nb_blocks > 0 && i < NPU_BW_POOL_NB; i++) {
+    static const char *const pool_names[NPU_BW_POOL_NB] = {"axisram", "psram", "flash", "other"};
+    const npu_bw_pool_t *p = &bw.pools[i];
+
+    printf("pipebench pool=%s read_kcyc=%lu read_stall_kcyc=%lu write_kcyc=%lu write_stall_kcyc=%lu\r\n",
+           pool_names[i], (unsigned long)(p->in_active / 1000U), (unsigned long)(p->in_stall / 1000U),
+           (unsigned long)(p->out_active / 1000U), (unsigned long)(p->out_stall / 1000U));
+  }
+
+  pb_ctx.window_results = 0;
+  pb_ctx.window_start_us = now_us;
+}
+
+#endif /* PIPE_BENCH */
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file    app_pool.c
+ * @author  Long Liangmao
+ * @brief   Reference-counted fixed-block pools for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_pool.h"
+#include "app_error.h"
+
+/* Ahead of each record: 8 bytes keep the payload 8-byte aligned */
+typedef struct {
+  uint32_t refs;
+  uint32_t reserved;
+} pool_header_t;
+
+/**
+ * @brief  Header of a record
+ */
+static pool_header_t *Pool_Header(void *record) {
+  return (pool_header_t *)record - 1;
+}
+
+void Pool_Create(app_pool_t *pool, CHAR *name, uint32_t record_size, uint32_t nb_records, VOID *memory_ptr) {
+  const ULONG block_size = (sizeof(pool_header_t) + record_size + 7U) & ~7U;
+  /* ThreadX links every block through a pointer ahead of it */
+  const ULONG pool_size = nb_records * (block_size + sizeof(UCHAR *));
+  VOID *storage;
+
+  APP_REQUIRE(memory_ptr != NULL && nb_records > 0);
+  APP_REQUIRE_EQ(tx_byte_allocate((TX_BYTE_POOL *)memory_ptr, &storage, pool_size, TX_NO_WAIT), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_block_pool_create(&pool->pool, name, block_size, storage, pool_size), TX_SUCCESS);
+  APP_REQUIRE_EQ(pool->pool.tx_block_pool_total, nb_records);
+  pool->record_size = record_size;
+}
+
+void *Pool_Alloc(app_pool_t *pool, ULONG wait) {
+  VOID *block;
+
+  if (tx_block_allocate(&pool->pool, &block, wait) != TX_SUCCESS) {
+    return NULL;
+  }
+  ((pool_header_t *)block)->refs = 1;
+  return (pool_header_t *)block + 1;
+}
+
+void Pool_Retain(void *record) {
+  pool_header_t *hdr = Pool_Header(record);
+  uint32_t refs;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  refs = hdr->refs++;
+  TX_RESTORE
+
+  /* A released record may already be someone else's */
+  APP_REQUIRE(refs > 0);
+}
+
+void Pool_Release(void *record) {
+  pool_header_t *hdr;
+  uint32_t refs;
+  TX_INTERRUPT_SAVE_AREA
+
+  if (record == NULL) {
+    return;
+  }
+  hdr = Pool_Header(record);
+
+  TX_DISABLE
+  refs = hdr->refs;
+  hdr->refs = refs - 1U;
+  TX_RESTORE
+
+  /* Released more often than retained */
+  APP_REQUIRE(refs > 0);
+  if (refs == 1U) {
+    APP_REQUIRE_EQ(tx_block_release(hdr), TX_SUCCESS);
+  }
+}
+
+uint32_t Pool_Available(app_pool_t *pool) {
+  return pool->pool.tx_block_pool_available;
+}
@@ -0,0 +1,756 @@
+/**
+ ******************************************************************************
+ * @file    app_ppbench.c
+ * @author  Long Liangmao
+ * @brief   Post-processing benchmark implementation for STM32N6570-DK
+ *
+ *          Built as Firmware_PPBench: the camera pipeline never starts, one
+ *          thread feeds each object detection post processor the scenes
+ *          recorded at PPBENCH_SCENES_FLASH_ADDR or, when none are flashed,
+ *          deterministic empty, sparse and crowded scenes shaped like the
+ *          configured networks. The library stage hook stamps the DWT cycle
+ *          counter as decode, NMS and score filtering start; the thread stack
+ *          is painted before each run for its peak, and the candidates kept
+ *          ahead of NMS give the scratch use. One line per post processor and
+ *          scene goes to the ST-LINK virtual COM port. A sweep then grows the
+ *          number of objects up to the max_boxes_limit of each post processor
+ *          and draws the boxes it keeps with the DMA2D overlay, for the time
+ *          against candidates and the check against PPBENCH_DEADLINE_US.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_ppbench.h"
+
+#if PP_BENCH
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "app_overlay.h"
+#include "app_postprocess.h"
+#include "od_pp_loc.h"
+#include "stm32n6570_discovery.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef AI_OD_POSTPROCESS_STAGE_HOOK
+#error "PP_BENCH needs AI_OD_POSTPROCESS_STAGE_HOOK=PPBench_Stage (Firmware_PPBench target)"
+#endif
+
+#define PPBENCH_THREAD_STACK_SIZE 8192
+#define PPBENCH_THREAD_PRIORITY 5
+#define PPBENCH_STACK_FILL 0xEFEFEFEFU /* TX_STACK_FILL */
+#define PPBENCH_UART_BAUDRATE 921600U  /* As THREAD_PROFILER_UART */
+
+/* ST YoloX outputs of the configured network, S/L/M in network output order */
+#define PPBENCH_ST_YOLOX_STRIDE (AI_OD_ST_YOLOX_PP_NB_CLASSES + AI_YOLOV2_PP_CLASSPROB)
+#define PPBENCH_ST_YOLOX_VALUES(w, h) ((w) * (h) * AI_OD_ST_YOLOX_PP_NB_ANCHORS * PPBENCH_ST_YOLOX_STRIDE)
+#define PPBENCH_ST_YOLOX_TOTAL_VALUES                                                              \
+  (PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_S_GRID_WIDTH, AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT) +      \
+   PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_L_GRID_WIDTH, AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT) +      \
+   PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_M_GRID_WIDTH, AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT))
+
+/* YOLOv8 head benchmarked (no such network in the registry): 256x256 input,
+ * strides 8/16/32, COCO classes. Recorded YOLOv8 scenes must have this shape */
+#define PPBENCH_YOLOV8_INPUT 256
+#define PPBENCH_YOLOV8_NB_CLASSES 80
+#define PPBENCH_YOLOV8_GRID(stride) (PPBENCH_YOLOV8_INPUT / (stride))
+#define PPBENCH_YOLOV8_NB_BOXES                                                                    \
+  (PPBENCH_YOLOV8_GRID(8) * PPBENCH_YOLOV8_GRID(8) + PPBENCH_YOLOV8_GRID(16) * PPBENCH_YOLOV8_GRID(16) + \
+   PPBENCH_YOLOV8_GRID(32) * PPBENCH_YOLOV8_GRID(32))
+#define PPBENCH_YOLOV8_TOTAL_VALUES ((AI_YOLOV8_PP_CLASSPROB + PPBENCH_YOLOV8_NB_CLASSES) * PPBENCH_YOLOV8_NB_BOXES)
+#define PPBENCH_YOLOV8_CONF_THRESHOLD 0.5f
+#define PPBENCH_YOLOV8_IOU_THRESHOLD 0.5f
+#define PPBENCH_YOLOV8_MAX_BOXES_LIMIT 100
+
+/* Quantization of the synthetic int8 outputs */
+#define PPBENCH_ST_YOLOX_SCALE 0.0625f /* Logits in [-8, 8) */
+#define PPBENCH_ST_YOLOX_ZERO_POINT 0
+#define PPBENCH_YOLOV8_SCALE (1.0f / 255.0f) /* Boxes and scores in [0, 1] */
+#define PPBENCH_YOLOV8_ZERO_POINT (-128)
+
+/* Largest float scene, and the largest candidate buffer */
+#define PPBENCH_TENSOR_BYTES (MAX(PPBENCH_ST_YOLOX_TOTAL_VALUES, PPBENCH_YOLOV8_TOTAL_VALUES) * sizeof(float))
+#define PPBENCH_OUT_NB MAX(APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB, PPBENCH_YOLOV8_NB_BOXES)
+
+#define PPBENCH_MAX_OBJECTS 48
+
+/* Sweep: objects on a regular grid, up to the largest max_boxes_limit */
+#define PPBENCH_SWEEP_MAX_OBJECTS MAX(AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT, PPBENCH_YOLOV8_MAX_BOXES_LIMIT)
+
+/* Boxes drawn as UI_DrawDetections() does: outline, label tab, two digits */
+#define PPBENCH_BOX_THICKNESS 2
+#define PPBENCH_LABEL_WIDTH (3 * OVERLAY_GLYPH_WIDTH + 2)
+#define PPBENCH_COLOR_BOX 0xFFFF4040
+#define PPBENCH_COLOR_LABEL 0xFFFFFFFF
+
+/* Synthetic scenes, the same objects for every post processor */
+static const struct {
+  const char *name;
+  uint32_t nb_objects;
+} ppbench_synth_scenes[] = {
+    {"empty", 0},
+    {"sparse", 4},
+    {"crowded", PPBENCH_MAX_OBJECTS},
+};
+
+static const uint32_t ppbench_sweep_objects[] = {0, 1, 2, 4, 8, 16, 32, 64, PPBENCH_SWEEP_MAX_OBJECTS};
+
+static const uint32_t ppbench_types[] = {
+    POSTPROCESS_OD_ST_YOLOX_UF,
+    POSTPROCESS_OD_ST_YOLOX_UI,
+    POSTPROCESS_OD_YOLO_V8_UF,
+    POSTPROCESS_OD_YOLO_V8_UI,
+};
+
+typedef struct {
+  float x, y, w, h; /* Normalized */
+  uint32_t class_index;
+} ppbench_object_t;
+
+/* Network outputs of one scene, in the tensor arena */
+typedef struct {
+  uint32_t type; /* POSTPROCESS_* */
+  uint32_t nb_tensors;
+  void *data[PPBENCH_MAX_TENSORS];
+  ppbench_tensor_t tensors[PPBENCH_MAX_TENSORS]; /* Offsets unused */
+} ppbench_input_t;
+
+typedef struct {
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} ppbench_stat_t;
+
+/* Per stage, AI_OD_POSTPROCESS_STAGE_END holding the whole call */
+typedef struct {
+  ppbench_stat_t cycles[AI_OD_POSTPROCESS_STAGE_NB];
+  uint32_t stack_bytes;   /* Peak below the post processor call */
+  uint32_t scratch_bytes; /* Peak candidates ahead of NMS */
+  uint32_t arena_bytes;   /* Candidate buffer the application reserves */
+  int32_t nb_detect;
+  ppbench_stat_t render_cycles; /* Boxes queued and drawn by the DMA2D */
+} ppbench_result_t;
+
+static struct {
+  TX_THREAD thread;
+  ULONG stack[PPBENCH_THREAD_STACK_SIZE / sizeof(ULONG)];
+  volatile uint32_t stamps[AI_OD_POSTPROCESS_STAGE_NB];
+} bench_ctx;
+
+/* Outputs the NPU would leave in external memory */
+static uint8_t bench_tensors[PPBENCH_TENSOR_BYTES] ALIGN_32 IN_PSRAM;
+static od_pp_outBuffer_t bench_out[PPBENCH_OUT_NB];
+static ppbench_object_t bench_sweep_objects[PPBENCH_SWEEP_MAX_OBJECTS];
+/* int8 YOLOX decode tables, rebuilt by the reset ahead of the timed stages */
+static od_st_yolox_pp_lut_is8_t bench_lut[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+
+/**
+ * @brief  Stamp the start of a post-processing stage (benchmark thread context)
+ */
+void PPBench_Stage(int32_t stage) {
+  bench_ctx.stamps[stage] = DWT->CYCCNT;
+}
+
+static const char *PPBench_TypeName(uint32_t type) {
+  switch (type) {
+  case POSTPROCESS_OD_ST_YOLOX_UF:
+    return "od_st_yolox_uf";
+  case POSTPROCESS_OD_ST_YOLOX_UI:
+    return "od_st_yolox_ui";
+  case POSTPROCESS_OD_YOLO_V8_UF:
+    return "od_yolov8_uf";
+  case POSTPROCESS_OD_YOLO_V8_UI:
+    return "od_yolov8_ui";
+  default:
+    return "?";
+  }
+}
+
+/**
+ * @brief  Place the outputs of a post processor in the tensor arena
+ * @retval 0 when the post processor is not benchmarked
+ */
+static int PPBench_Setup(ppbench_input_t *in, uint32_t type) {
+  uint32_t elem = (type == POSTPROCESS_OD_ST_YOLOX_UF || type == POSTPROCESS_OD_YOLO_V8_UF) ? sizeof(float) : 1;
+  uint32_t offset = 0;
+
+  memset(in, 0, sizeof(*in));
+  in->type = type;
+
+  switch (type) {
+  case POSTPROCESS_OD_ST_YOLOX_UF:
+  case POSTPROCESS_OD_ST_YOLOX_UI:
+    in->nb_tensors = 3;
+    in->tensors[0].size = PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_S_GRID_WIDTH, AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT) * elem;
+    in->tensors[1].size = PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_L_GRID_WIDTH, AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT) * elem;
+    in->tensors[2].size = PPBENCH_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_M_GRID_WIDTH, AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT) * elem;
+    for (uint32_t t = 0; t < in->nb_tensors; t++) {
+      in->tensors[t].scale = PPBENCH_ST_YOLOX_SCALE;
+      in->tensors[t].zero_point = PPBENCH_ST_YOLOX_ZERO_POINT;
+    }
+    break;
+  case POSTPROCESS_OD_YOLO_V8_UF:
+  case POSTPROCESS_OD_YOLO_V8_UI:
+    in->nb_tensors = 1;
+    in->tensors[0].size = PPBENCH_YOLOV8_TOTAL_VALUES * elem;
+    in->tensors[0].scale = PPBENCH_YOLOV8_SCALE;
+    in->tensors[0].zero_point = PPBENCH_YOLOV8_ZERO_POINT;
+    break;
+  default:
+    return 0;
+  }
+
+  for (uint32_t t = 0; t < in->nb_tensors; t++) {
+    in->data[t] = &bench_tensors[offset];
+    offset += (in->tensors[t].size + 31U) & ~31U;
+  }
+  APP_REQUIRE(offset <= sizeof(bench_tensors));
+  return 1;
+}
+
+/**
+ * @brief  Store a value of a synthetic output, quantized for int8 post processors
+ */
+static void PPBench_Put(const ppbench_input_t *in, uint32_t t, uint32_t index, float value) {
+  if (in->type == POSTPROCESS_OD_ST_YOLOX_UF || in->type == POSTPROCESS_OD_YOLO_V8_UF) {
+    ((float *)in->data[t])[index] = value;
+  } else {
+    int32_t q = (int32_t)lrintf(value / in->tensors[t].scale) + in->tensors[t].zero_point;
+    ((int8_t *)in->data[t])[index] = (int8_t)MIN(MAX(q, -128), 127);
+  }
+}
+
+static uint32_t PPBench_Random(uint32_t *seed) {
+  *seed = *seed * 1664525U + 1013904223U;
+  return *seed >> 8; /* 24 bits */
+}
+
+static float PPBench_Uniform(uint32_t *seed, float lo, float hi) {
+  return lo + (hi - lo) * (float)PPBench_Random(seed) * (1.0f / 16777216.0f);
+}
+
+static void PPBench_Objects(uint32_t scene, uint32_t nb_classes, ppbench_object_t *objects, uint32_t nb) {
+  uint32_t seed = 1U + scene;
+
+  for (uint32_t i = 0; i < nb; i++) {
+    objects[i].x = PPBench_Uniform(&seed, 0.05f, 0.95f);
+    objects[i].y = PPBench_Uniform(&seed, 0.05f, 0.95f);
+    objects[i].w = PPBench_Uniform(&seed, 0.05f, 0.3f);
+    objects[i].h = PPBench_Uniform(&seed, 0.05f, 0.3f);
+    objects[i].class_index = PPBench_Random(&seed) % nb_classes;
+  }
+}
+
+/**
+ * @brief  Objects on a regular grid, one per cell and 70% of it: they never
+ *         overlap, so NMS keeps every one the decode finds
+ */
+static void PPBench_GridObjects(uint32_t nb_classes, ppbench_object_t *objects, uint32_t nb) {
+  uint32_t cols = 1;
+  float cell;
+
+  while (cols * cols < nb) {
+    cols++;
+  }
+  cell = 0.9f / (float)cols;
+
+  for (uint32_t i = 0; i < nb; i++) {
+    objects[i].x = 0.05f + ((float)(i % cols) + 0.5f) * cell;
+    objects[i].y = 0.05f + ((float)(i / cols) + 0.5f) * cell;
+    objects[i].w = 0.7f * cell;
+    objects[i].h = 0.7f * cell;
+    objects[i].class_index = i % nb_classes;
+  }
+}
+
+/**
+ * @brief  One ST YoloX level: background logits, then every object lighting
+ *         up the anchors of its cell and of the 8 around it
+ */
+static void PPBench_SynthStYoloxLevel(const ppbench_input_t *in, uint32_t t, int32_t grid_width,
+                                      int32_t grid_height, const ppbench_object_t *objects, uint32_t nb) {
+  uint32_t nb_values = in->tensors[t].size /
+                       ((in->type == POSTPROCESS_OD_ST_YOLOX_UF) ? sizeof(float) : 1);
+
+  for (uint32_t i = 0; i < nb_values; i += PPBENCH_ST_YOLOX_STRIDE) {
+    PPBench_Put(in, t, i + AI_YOLOV2_PP_XCENTER, 0.0f);
+    PPBench_Put(in, t, i + AI_YOLOV2_PP_YCENTER, 0.0f);
+    PPBench_Put(in, t, i + AI_YOLOV2_PP_WIDTHREL, 0.0f);
+    PPBench_Put(in, t, i + AI_YOLOV2_PP_HEIGHTREL, 0.0f);
+    PPBench_Put(in, t, i + AI_YOLOV2_PP_OBJECTNESS, -8.0f);
+    for (int32_t c = 0; c < AI_OD_ST_YOLOX_PP_NB_CLASSES; c++) {
+      PPBench_Put(in, t, i + AI_YOLOV2_PP_CLASSPROB + c, -4.0f);
+    }
+  }
+
+  for (uint32_t n = 0; n < nb; n++) {
+    int32_t row0 = (int32_t)(objects[n].y * grid_height);
+    int32_t col0 = (int32_t)(objects[n].x * grid_width);
+
+    for (int32_t row = row0 - 1; row <= row0 + 1; row++) {
+      for (int32_t col = col0 - 1; col <= col0 + 1; col++) {
+        if (row < 0 || row >= grid_height || col < 0 || col >= grid_width) {
+          continue;
+        }
+        for (int32_t anch = 0; anch < AI_OD_ST_YOLOX_PP_NB_ANCHORS; anch++) {
+          uint32_t i = ((row * grid_width + col) * AI_OD_ST_YOLOX_PP_NB_ANCHORS + anch) * PPBENCH_ST_YOLOX_STRIDE;
+          float logit = (row == row0 && col == col0) ? ((anch == 0) ? 4.0f : 2.0f) : 1.0f;
+
+          PPBench_Put(in, t, i + AI_YOLOV2_PP_OBJECTNESS, logit);
+          PPBench_Put(in, t, i + AI_YOLOV2_PP_CLASSPROB + objects[n].class_index, 4.0f);
+        }
+      }
+    }
+  }
+}
+
+static void PPBench_SynthStYolox(const ppbench_input_t *in, const ppbench_object_t *objects, uint32_t nb) {
+  PPBench_SynthStYoloxLevel(in, 0, AI_OD_ST_YOLOX_PP_S_GRID_WIDTH, AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT, objects, nb);
+  PPBench_SynthStYoloxLevel(in, 1, AI_OD_ST_YOLOX_PP_L_GRID_WIDTH, AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT, objects, nb);
+  PPBench_SynthStYoloxLevel(in, 2, AI_OD_ST_YOLOX_PP_M_GRID_WIDTH, AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT, objects, nb);
+}
+
+/**
+ * @brief  YOLOv8 channel-major output: cell boxes and background scores, then
+ *         every object scoring its class on its cell and the 8 around it, per stride
+ */
+static void PPBench_SynthYolov8(const ppbench_input_t *in, const ppbench_object_t *objects, uint32_t nb) {
+  static const int32_t strides[] = {8, 16, 32};
+  const uint32_t nb_boxes = PPBENCH_YOLOV8_NB_BOXES;
+  uint32_t base = 0;
+
+  for (uint32_t s = 0; s < sizeof(strides) / sizeof(strides[0]); s++) {
+    int32_t grid = PPBENCH_YOLOV8_GRID(strides[s]);
+
+    for (int32_t row = 0; row < grid; row++) {
+      for (int32_t col = 0; col < grid; col++) {
+        uint32_t box = base + row * grid + col;
+
+        PPBench_Put(in, 0, AI_YOLOV8_PP_XCENTER * nb_boxes + box, (col + 0.5f) / grid);
+        PPBench_Put(in, 0, AI_YOLOV8_PP_YCENTER * nb_boxes + box, (row + 0.5f) / grid);
+        PPBench_Put(in, 0, AI_YOLOV8_PP_WIDTHREL * nb_boxes + box, 1.0f / grid);
+        PPBench_Put(in, 0, AI_YOLOV8_PP_HEIGHTREL * nb_boxes + box, 1.0f / grid);
+        for (int32_t c = 0; c < PPBENCH_YOLOV8_NB_CLASSES; c++) {
+          PPBench_Put(in, 0, (AI_YOLOV8_PP_CLASSPROB + c) * nb_boxes + box, 0.01f);
+        }
+      }
+    }
+
+    for (uint32_t n = 0; n < nb; n++) {
+      int32_t row0 = (int32_t)(objects[n].y * grid);
+      int32_t col0 = (int32_t)(objects[n].x * grid);
+
+      for (int32_t row = row0 - 1; row <= row0 + 1; row++) {
+        for (int32_t col = col0 - 1; col <= col0 + 1; col++) {
+          uint32_t box;
+
+          if (row < 0 || row >= grid || col < 0 || col >= grid) {
+            continue;
+          }
+          box = base + row * grid + col;
+          PPBench_Put(in, 0, AI_YOLOV8_PP_WIDTHREL * nb_boxes + box, objects[n].w);
+          PPBench_Put(in, 0, AI_YOLOV8_PP_HEIGHTREL * nb_boxes + box, objects[n].h);
+          PPBench_Put(in, 0, (AI_YOLOV8_PP_CLASSPROB + objects[n].class_index) * nb_boxes + box,
+                      (row == row0 && col == col0) ? 0.9f : 0.7f);
+        }
+      }
+    }
+    base += grid * grid;
+  }
+}
+
+/**
+ * @brief  Run a post processor once
+ * @param  nb_candidates: Candidates kept ahead of NMS
+ * @retval Detections
+ */
+static int32_t PPBench_Process(const ppbench_input_t *in, int32_t *nb_candidates) {
+  od_pp_out_t out = {.pOutBuff = bench_out, .nb_detect = 0};
+
+  switch (in->type) {
+  case POSTPROCESS_OD_ST_YOLOX_UF:
+  case POSTPROCESS_OD_ST_YOLOX_UI: {
+    od_st_yolox_pp_static_param_t params = {
+        .nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES,
+        .nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS,
+        .grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH,
+        .grid_height_L = AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT,
+        .grid_width_M = AI_OD_ST_YOLOX_PP_M_GRID_WIDTH,
+        .grid_height_M = AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT,
+        .grid_width_S = AI_OD_ST_YOLOX_PP_S_GRID_WIDTH,
+        .grid_height_S = AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT,
+        .max_boxes_limit = AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT,
+        .max_candidates = AI_OD_ST_YOLOX_PP_MAX_CANDIDATES,
+        .conf_threshold = AI_OD_ST_YOLOX_PP_CONF_THRESHOLD,
+        .iou_threshold = AI_OD_ST_YOLOX_PP_IOU_THRESHOLD,
+        .pAnchors_L = AI_OD_ST_YOLOX_PP_L_ANCHORS,
+        .pAnchors_M = AI_OD_ST_YOLOX_PP_M_ANCHORS,
+        .pAnchors_S = AI_OD_ST_YOLOX_PP_S_ANCHORS,
+        .raw_s_scale = in->tensors[0].scale,
+        .raw_s_zero_point = (int8_t)in->tensors[0].zero_point,
+        .raw_l_scale = in->tensors[1].scale,
+        .raw_l_zero_point = (int8_t)in->tensors[1].zero_point,
+        .raw_m_scale = in->tensors[2].scale,
+        .raw_m_zero_point = (int8_t)in->tensors[2].zero_point,
+        .pLut = (in->type == POSTPROCESS_OD_ST_YOLOX_UI) ? bench_lut : NULL,
+    };
+    od_st_yolox_pp_in_t pp_in = {
+        .pRaw_detections_S = in->data[0],
+        .pRaw_detections_L = in->data[1],
+        .pRaw_detections_M = in->data[2],
+    };
+
+    APP_REQUIRE_EQ(od_st_yolox_pp_reset(&params), AI_OD_POSTPROCESS_ERROR_NO);
+    params.nb_detect = 0;
+    if (in->type == POSTPROCESS_OD_ST_YOLOX_UF) {
+      APP_REQUIRE_EQ(od_st_yolox_pp_process(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+    } else {
+      APP_REQUIRE_EQ(od_st_yolox_pp_process_int8(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+    }
+    *nb_candidates = params.nb_detect;
+    break;
+  }
+  case POSTPROCESS_OD_YOLO_V8_UF:
+  case POSTPROCESS_OD_YOLO_V8_UI: {
+    od_yolov8_pp_static_param_t params = {
+        .nb_classes = PPBENCH_YOLOV8_NB_CLASSES,
+        .nb_total_boxes = PPBENCH_YOLOV8_NB_BOXES,
+        .max_boxes_limit = PPBENCH_YOLOV8_MAX_BOXES_LIMIT,
+        .conf_threshold = PPBENCH_YOLOV8_CONF_THRESHOLD,
+        .iou_threshold = PPBENCH_YOLOV8_IOU_THRESHOLD,
+        .raw_output_scale = in->tensors[0].scale,
+        .raw_output_zero_point = (int8_t)in->tensors[0].zero_point,
+        .pScratchBuff = NULL,
+    };
+    od_yolov8_pp_in_centroid_t pp_in = {.pRaw_detections = in->data[0]};
+
+    APP_REQUIRE_EQ(od_yolov8_pp_reset(&params), AI_OD_POSTPROCESS_ERROR_NO);
+    params.nb_detect = 0;
+    if (in->type == POSTPROCESS_OD_YOLO_V8_UF) {
+      APP_REQUIRE_EQ(od_yolov8_pp_process(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+    } else {
+      APP_REQUIRE_EQ(od_yolov8_pp_process_int8(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+    }
+    *nb_candidates = params.nb_detect;
+    break;
+  }
+  default:
+    APP_REQUIRE(0);
+    break;
+  }
+
+  return out.nb_detect;
+}
+
+/**
+ * @brief  Fill the free part of the benchmark stack with TX_STACK_FILL
+ * @retval Stack pointer of the caller
+ */
+static __attribute__((noinline)) uint32_t *PPBench_PaintStack(void) {
+  uint32_t *sp = (uint32_t *)__get_PSP();
+  uint32_t *p = (uint32_t *)bench_ctx.stack;
+
+  /* Leave this frame alone */
+  while (p < sp - 16) {
+    *p++ = PPBENCH_STACK_FILL;
+  }
+  return sp;
+}
+
+static uint32_t PPBench_StackUsed(const uint32_t *sp) {
+  const uint32_t *p = (const uint32_t *)bench_ctx.stack;
+
+  while (p < sp && *p == PPBENCH_STACK_FILL) {
+    p++;
+  }
+  return (uint32_t)((const uint8_t *)sp - (const uint8_t *)p);
+}
+
+static void PPBench_Accumulate(ppbench_stat_t *stat, uint32_t cycles) {
+  stat->min = MIN(stat->min, cycles);
+  stat->max = MAX(stat->max, cycles);
+  stat->sum += cycles;
+}
+
+/**
+ * @brief  Draw the detections over a cleared UI buffer, as the UI thread would
+ * @retval DWT cycles from the first command queued to the DMA2D done
+ */
+static uint32_t PPBench_Render(int32_t nb_detect) {
+  overlay_ctx_t ctx;
+  uint32_t start;
+  char label[4] = {'0', '0', '%', '\0'};
+
+  Overlay_CtxInit(&ctx, Buffer_GetUIBuffer(0), 0, 0, UI_LAYER_WIDTH, UI_LAYER_HEIGHT);
+  Overlay_FillRect(&ctx, 0, 0, UI_LAYER_WIDTH, UI_LAYER_HEIGHT, 0x00000000);
+  Overlay_Submit();
+  Overlay_Wait();
+
+  start = DWT->CYCCNT;
+  for (int32_t i = 0; i < nb_detect; i++) {
+    const od_pp_outBuffer_t *det = &bench_out[i];
+    int32_t box_w = (int32_t)(det->width * UI_LAYER_WIDTH);
+    int32_t box_h = (int32_t)(det->height * UI_LAYER_HEIGHT);
+    int32_t box_x = (int32_t)(det->x_center * UI_LAYER_WIDTH) - box_w / 2;
+    int32_t box_y = (int32_t)(det->y_center * UI_LAYER_HEIGHT) - box_h / 2;
+    uint32_t pct = MIN((uint32_t)(det->conf * 100.0f + 0.5f), 99U);
+
+    label[0] = '0' + pct / 10;
+    label[1] = '0' + pct % 10;
+    Overlay_DrawRect(&ctx, box_x, box_y, box_w, box_h, PPBENCH_BOX_THICKNESS, PPBENCH_COLOR_BOX);
+    Overlay_FillRect(&ctx, box_x, box_y - OVERLAY_GLYPH_HEIGHT, PPBENCH_LABEL_WIDTH, OVERLAY_GLYPH_HEIGHT,
+                     PPBENCH_COLOR_BOX);
+    Overlay_DrawText(&ctx, box_x + 1, box_y - OVERLAY_GLYPH_HEIGHT, label, OVERLAY_FONT_16, PPBENCH_COLOR_LABEL);
+  }
+  Overlay_Submit();
+  Overlay_Wait();
+  return DWT->CYCCNT - start;
+}
+
+/**
+ * @brief  Run a scene PPBENCH_ITERATIONS times, from cold caches each time
+ * @param  render: Also draw the detections of each run (PPBench_Render())
+ */
+static void PPBench_Measure(const ppbench_input_t *in, ppbench_result_t *res, int render) {
+  memset(res, 0, sizeof(*res));
+  for (int s = 0; s < AI_OD_POSTPROCESS_STAGE_NB; s++) {
+    res->cycles[s].min = UINT32_MAX;
+  }
+  res->render_cycles.min = UINT32_MAX;
+  res->arena_bytes = ((in->type == POSTPROCESS_OD_ST_YOLOX_UF || in->type == POSTPROCESS_OD_ST_YOLOX_UI)
+                          ? APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB
+                          : PPBENCH_YOLOV8_NB_BOXES) *
+                     sizeof(od_pp_outBuffer_t);
+
+  for (int it = 0; it < PPBENCH_ITERATIONS; it++) {
+    int32_t nb_candidates = 0;
+    const uint32_t *sp;
+
+    /* As after an inference: the NPU writes its outputs behind the D-cache */
+    for (uint32_t t = 0; t < in->nb_tensors; t++) {
+      SCB_CleanInvalidateDCache_by_Addr(in->data[t], (int32_t)in->tensors[t].size);
+    }
+
+    sp = PPBench_PaintStack();
+    res->nb_detect = PPBench_Process(in, &nb_candidates);
+    res->stack_bytes = MAX(res->stack_bytes, PPBench_StackUsed(sp));
+    res->scratch_bytes = MAX(res->scratch_bytes, (uint32_t)nb_candidates * sizeof(od_pp_outBuffer_t));
+
+    for (int s = 0; s < AI_OD_POSTPROCESS_STAGE_END; s++) {
+      PPBench_Accumulate(&res->cycles[s], bench_ctx.stamps[s + 1] - bench_ctx.stamps[s]);
+    }
+    PPBench_Accumulate(&res->cycles[AI_OD_POSTPROCESS_STAGE_END],
+                       bench_ctx.stamps[AI_OD_POSTPROCESS_STAGE_END] -
+                           bench_ctx.stamps[AI_OD_POSTPROCESS_STAGE_DECODE]);
+    if (render) {
+      PPBench_Accumulate(&res->render_cycles, PPBench_Render(res->nb_detect));
+    }
+  }
+}
+
+/**
+ * @brief  One line per post processor and scene: mean cycles per stage, then
+ *         the spread of the whole call
+ */
+static void PPBench_Print(const char *scene, uint32_t type, const ppbench_result_t *res) {
+  const ppbench_stat_t *total = &res->cycles[AI_OD_POSTPROCESS_STAGE_END];
+
+  printf("ppbench %-14s %-11s decode %8lu nms %8lu score %6lu total %8lu min %8lu max %8lu "
+         "stack %5lu scratch %6lu/%6lu det %3ld\r\n",
+         PPBench_TypeName(type), scene,
+         (unsigned long)(res->cycles[AI_OD_POSTPROCESS_STAGE_DECODE].sum / PPBENCH_ITERATIONS),
+         (unsigned long)(res->cycles[AI_OD_POSTPROCESS_STAGE_NMS].sum / PPBENCH_ITERATIONS),
+         (unsigned long)(res->cycles[AI_OD_POSTPROCESS_STAGE_SCORE].sum / PPBENCH_ITERATIONS),
+         (unsigned long)(total->sum / PPBENCH_ITERATIONS), (unsigned long)total->min,
+         (unsigned long)total->max, (unsigned long)res->stack_bytes, (unsigned long)res->scratch_bytes,
+         (unsigned long)res->arena_bytes, (long)res->nb_detect);
+}
+
+/**
+ * @brief  Scenes recorded at PPBENCH_SCENES_FLASH_ADDR, each on the post
+ *         processor it was recorded for
+ * @retval Scenes found
+ */
+static uint32_t PPBench_RunRecorded(void) {
+  const ppbench_blob_t *blob = (const ppbench_blob_t *)PPBENCH_SCENES_FLASH_ADDR;
+  const ppbench_scene_t *scenes = (const ppbench_scene_t *)(blob + 1);
+  ppbench_input_t in;
+  ppbench_result_t res;
+
+  if (blob->magic != PPBENCH_BLOB_MAGIC) {
+    return 0;
+  }
+
+  for (uint32_t i = 0; i < blob->nb_scenes; i++) {
+    const ppbench_scene_t *scene = &scenes[i];
+    char name[PPBENCH_SCENE_NAME_LEN + 1];
+
+    memcpy(name, scene->name, PPBENCH_SCENE_NAME_LEN);
+    name[PPBENCH_SCENE_NAME_LEN] = '\0';
+
+    if (!PPBench_Setup(&in, scene->type)) {
+      printf("ppbench %s: post processor %lu not benchmarked\r\n", name, (unsigned long)scene->type);
+      continue;
+    }
+
+    /* Recorded with another network shape: fail fast */
+    APP_REQUIRE_EQ(scene->nb_tensors, in.nb_tensors);
+    for (uint32_t t = 0; t < in.nb_tensors; t++) {
+      APP_REQUIRE_EQ(scene->tensors[t].size, in.tensors[t].size);
+      memcpy(in.data[t], (const uint8_t *)blob + scene->tensors[t].offset, in.tensors[t].size);
+      in.tensors[t].scale = scene->tensors[t].scale;
+      in.tensors[t].zero_point = scene->tensors[t].zero_point;
+    }
+
+    PPBench_Measure(&in, &res, 0);
+    PPBench_Print(name, scene->type, &res);
+  }
+  return blob->nb_scenes;
+}
+
+/**
+ * @brief  Every benchmarked post processor on every synthetic scene
+ */
+static void PPBench_RunSynthetic(void) {
+  ppbench_object_t objects[PPBENCH_MAX_OBJECTS];
+  ppbench_input_t in;
+  ppbench_result_t res;
+
+  for (uint32_t p = 0; p < sizeof(ppbench_types) / sizeof(ppbench_types[0]); p++) {
+    uint32_t type = ppbench_types[p];
+    int is_yolov8 = (type == POSTPROCESS_OD_YOLO_V8_UF || type == POSTPROCESS_OD_YOLO_V8_UI);
+
+    for (uint32_t s = 0; s < sizeof(ppbench_synth_scenes) / sizeof(ppbench_synth_scenes[0]); s++) {
+      uint32_t nb = ppbench_synth_scenes[s].nb_objects;
+
+      APP_REQUIRE(PPBench_Setup(&in, type));
+      PPBench_Objects(s, is_yolov8 ? PPBENCH_YOLOV8_NB_CLASSES : AI_OD_ST_YOLOX_PP_NB_CLASSES, objects, nb);
+      if (is_yolov8) {
+        PPBench_SynthYolov8(&in, objects, nb);
+      } else {
+        PPBench_SynthStYolox(&in, objects, nb);
+      }
+
+      PPBench_Measure(&in, &res, 0);
+      PPBench_Print(ppbench_synth_scenes[s].name, type, &res);
+    }
+  }
+}
+
+/**
+ * @brief  Worst case growth: every benchmarked post processor on 0 up to
+ *         max_boxes_limit objects, the boxes kept drawn each run
+ * @retval 1 if the worst post-processing plus overlay time of every step is
+ *         within PPBENCH_DEADLINE_US
+ */
+static int PPBench_RunSweep(void) {
+  const uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  ppbench_input_t in;
+  ppbench_result_t res;
+  int met = 1;
+
+  for (uint32_t p = 0; p < sizeof(ppbench_types) / sizeof(ppbench_types[0]); p++) {
+    uint32_t type = ppbench_types[p];
+    int is_yolov8 = (type == POSTPROCESS_OD_YOLO_V8_UF || type == POSTPROCESS_OD_YOLO_V8_UI);
+    uint32_t limit = is_yolov8 ? PPBENCH_YOLOV8_MAX_BOXES_LIMIT : AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT;
+
+    for (uint32_t s = 0; s < sizeof(ppbench_sweep_objects) / sizeof(ppbench_sweep_objects[0]); s++) {
+      uint32_t nb = MIN(ppbench_sweep_objects[s], limit);
+      uint32_t worst_us;
+
+      if (s > 0 && nb == MIN(ppbench_sweep_objects[s - 1], limit)) {
+        continue;
+      }
+      APP_REQUIRE(PPBench_Setup(&in, type));
+      PPBench_GridObjects(is_yolov8 ? PPBENCH_YOLOV8_NB_CLASSES : AI_OD_ST_YOLOX_PP_NB_CLASSES,
+                          bench_sweep_objects, nb);
+      if (is_yolov8) {
+        PPBench_SynthYolov8(&in, bench_sweep_objects, nb);
+      } else {
+        PPBench_SynthStYolox(&in, bench_sweep_objects, nb);
+      }
+
+      PPBench_Measure(&in, &res, 1);
+      /* Both worst cases in the same frame: the bound the budget must hold */
+      worst_us = (res.cycles[AI_OD_POSTPROCESS_STAGE_END].max + res.render_cycles.max) / cycles_per_us;
+      met &= (worst_us <= PPBENCH_DEADLINE_US);
+      printf("ppbench sweep %-14s objects %3lu det %3ld pp_us %6lu render_us %6lu worst_us %6lu %s\r\n",
+             PPBench_TypeName(type), (unsigned long)nb, (long)res.nb_detect,
+             (unsigned long)(res.cycles[AI_OD_POSTPROCESS_STAGE_END].sum / PPBENCH_ITERATIONS / cycles_per_us),
+             (unsigned long)(res.render_cycles.sum / PPBENCH_ITERATIONS / cycles_per_us), (unsigned long)worst_us,
+             (worst_us <= PPBENCH_DEADLINE_US) ? "ok" : "MISS");
+    }
+  }
+  return met;
+}
+
+static void PPBench_ThreadEntry(ULONG arg) {
+  UNUSED(arg);
+
+  printf("ppbench: %lu MHz, %d runs per scene, mean cycles per stage\r\n",
+         (unsigned long)(SystemCoreClock / 1000000U), PPBENCH_ITERATIONS);
+  if (PPBench_RunRecorded() == 0) {
+    printf("ppbench: no scenes at 0x%08lx, synthetic scenes\r\n", (unsigned long)PPBENCH_SCENES_FLASH_ADDR);
+    PPBench_RunSynthetic();
+  }
+  printf("ppbench: sweep, mean us per run, worst of post-processing plus overlay against %lu us\r\n",
+         (unsigned long)PPBENCH_DEADLINE_US);
+  if (!PPBench_RunSweep()) {
+    printf("ppbench: deadline missed\r\n");
+    BSP_LED_On(LED_RED);
+  }
+  printf("ppbench: done\r\n");
+
+  BSP_LED_On(LED_GREEN);
+  tx_thread_suspend(tx_thread_identify());
+}
+
+void PPBench_Init(VOID *memory_ptr) {
+  /* With TELEMETRY the port is already open, its TX owned by the DMA */
+#if !TELEMETRY
+  COM_InitTypeDef com_init = {
+      .BaudRate = PPBENCH_UART_BAUDRATE,
+      .WordLength = COM_WORDLENGTH_8B,
+      .StopBits = COM_STOPBITS_1,
+      .Parity = COM_PARITY_NONE,
+      .HwFlowCtl = COM_HWCONTROL_NONE,
+  };
+
+#endif
+
+  UNUSED(memory_ptr);
+
+#if !TELEMETRY
+  APP_REQUIRE_EQ(BSP_COM_Init(COM1, &com_init), BSP_ERROR_NONE);
+#endif
+
+  /* The UI, which would enable the cycle counter, never starts */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  /* Nor does the display, which would clock the DMA2D the sweep draws with */
+  __HAL_RCC_DMA2D_CLK_ENABLE();
+  __HAL_RCC_DMA2D_FORCE_RESET();
+  __HAL_RCC_DMA2D_RELEASE_RESET();
+  Overlay_Init();
+
+  APP_REQUIRE_EQ(tx_thread_create(&bench_ctx.thread, "ppbench", PPBench_ThreadEntry, 0, bench_ctx.stack,
+                                  sizeof(bench_ctx.stack), PPBENCH_THREAD_PRIORITY, PPBENCH_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+#endif /* PP_BENCH */
@@ -0,0 +1,431 @@
+/**
+ ******************************************************************************
+ * @file    app_prefetch.c
+ * @author  Long Liangmao
+ * @brief   NPU weight prefetch implementation for STM32N6570-DK
+ *
+ *          The generated epochs program every weight read as a stream engine
+ *          tensor at a fixed octoFlash address. From the stream engine hook
+ *          (app_npu_cache.c), the first inference of a network records the
+ *          flash tensors of each epoch; later inferences copy them ahead of
+ *          time with HPDMA and hand the stream engine the staged copy.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_prefetch.h"
+
+#if WEIGHT_PREFETCH_ENABLE
+
+#include "app_error.h"
+#include "app_x-cube-ai.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+/* Copy DMA: one HPDMA channel, memory to memory, unused by the BSP */
+#define PREFETCH_DMA_CHANNEL HPDMA1_Channel12
+#define PREFETCH_DMA_IRQn HPDMA1_Channel12_IRQn
+
+/* xSPI2 memory-mapped window, holding the octoFlash pool of the network */
+#define PREFETCH_FLASH_START 0x70000000U
+#define PREFETCH_FLASH_END 0x80000000U
+
+/* Copies keep the 32-byte phase of their flash source (stream engine bursts) */
+#define PREFETCH_ALIGN 32U
+#define PREFETCH_MAX_TENSOR (WEIGHT_PREFETCH_STAGING_SIZE / 4U)
+
+#if (WEIGHT_PREFETCH_STAGING_SIZE % PREFETCH_ALIGN) != 0
+#error "WEIGHT_PREFETCH_STAGING_SIZE must be a multiple of 32 bytes"
+#endif
+#if WEIGHT_PREFETCH_STAGING_SIZE >= (256U * 1024U)
+#error "WEIGHT_PREFETCH_STAGING_SIZE / 4 must fit one HPDMA block (64 KB)"
+#endif
+
+/* Schedule entry state, per inference */
+#define PREFETCH_IDLE 0    /* Not in the ring */
+#define PREFETCH_PENDING 1 /* In the ring, copy queued or running */
+#define PREFETCH_DONE 2    /* Copy complete */
+
+/* One octoFlash weight tensor of the schedule */
+typedef struct {
+  uint32_t src;      /* First staged flash byte, 32-byte aligned */
+  uint32_t len;      /* Staged bytes, 32-byte multiple */
+  uint32_t stage;    /* Offset of the copy in the staging ring */
+  uint32_t ring_end; /* Ring head after this entry; the tail moves here on release */
+  int16_t epoch;
+  volatile uint8_t state;
+} prefetch_entry_t;
+
+/* Per-network schedule, in the order the epochs program their tensors */
+typedef struct {
+  NN_Instance_TypeDef *instance;
+  TraceEpochBlock_FuncPtr_t chained; /* Callback set before Prefetch_Init() */
+  prefetch_entry_t entries[WEIGHT_PREFETCH_MAX_TENSORS];
+  uint16_t nb;
+  uint8_t learned;
+} prefetch_plan_t;
+
+/* Staging ring, after the NPU activations in AXISRAM3 (STM32N657XX_LRUN.ld) */
+static uint8_t staging[WEIGHT_PREFETCH_STAGING_SIZE] ALIGN_32 IN_AXISRAM3;
+
+static struct {
+  DMA_HandleTypeDef hdma;
+  prefetch_plan_t plans[MX_X_CUBE_AI_NET_NB];
+  uint8_t disabled; /* Weights read in place, see Prefetch_SetEnabled() */
+
+  /* Running inference: inference thread, dma_* shared with the DMA ISR */
+  prefetch_plan_t *plan;
+  int16_t epoch;
+  volatile uint16_t issue;    /* Next entry to place in the ring */
+  uint16_t use;               /* Next entry expected by the stream engines */
+  uint16_t release;           /* Next entry to free */
+  volatile uint16_t dma_next; /* Entry being, or next to be, copied */
+  volatile uint8_t dma_busy;
+  uint32_t head; /* Running ring offsets: [tail, head) is in use */
+  uint32_t tail;
+  prefetch_stats_t frame;
+
+  /* Last completed inference, guarded by mutex */
+  TX_MUTEX mutex;
+  prefetch_stats_t published;
+} pf_ctx;
+
+/**
+ * @brief  Start the next queued copy, or go idle (DMA ISR or interrupts masked)
+ */
+static void Prefetch_DmaKick(void) {
+  const prefetch_plan_t *plan = pf_ctx.plan;
+  const prefetch_entry_t *entry;
+
+  /* Entries skipped by the ring (read from flash) were never queued */
+  while (pf_ctx.dma_next < pf_ctx.issue && plan->entries[pf_ctx.dma_next].state != PREFETCH_PENDING) {
+    pf_ctx.dma_next++;
+  }
+  if (pf_ctx.dma_next >= pf_ctx.issue) {
+    pf_ctx.dma_busy = 0;
+    return;
+  }
+
+  entry = &plan->entries[pf_ctx.dma_next];
+  pf_ctx.dma_busy = 1;
+  APP_REQUIRE_EQ(HAL_DMA_Start_IT(&pf_ctx.hdma, entry->src, (uint32_t)&staging[entry->stage], entry->len),
+                 HAL_OK);
+}
+
+/**
+ * @brief  Copy complete (DMA ISR)
+ */
+static void Prefetch_DmaComplete(DMA_HandleTypeDef *hdma) {
+  UNUSED(hdma);
+
+  pf_ctx.plan->entries[pf_ctx.dma_next].state = PREFETCH_DONE;
+  pf_ctx.dma_next++;
+  Prefetch_DmaKick();
+}
+
+/**
+ * @brief  Copy failed (DMA ISR): a bus error on flash or AXISRAM is fatal
+ */
+static void Prefetch_DmaError(DMA_HandleTypeDef *hdma) {
+  APP_REQUIRE_EQ(hdma->ErrorCode, HAL_DMA_ERROR_NONE);
+}
+
+/**
+ * @brief  Find the schedule of a hooked network
+ */
+static prefetch_plan_t *Prefetch_FindPlan(const NN_Instance_TypeDef *instance) {
+  for (uint32_t id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    if (pf_ctx.plans[id].instance == instance) {
+      return &pf_ctx.plans[id];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Reset the ring for a new inference of a network
+ */
+static void Prefetch_Begin(prefetch_plan_t *plan) {
+  for (uint32_t i = 0; i < plan->nb; i++) {
+    plan->entries[i].state = PREFETCH_IDLE;
+  }
+
+  pf_ctx.issue = 0;
+  pf_ctx.use = 0;
+  pf_ctx.release = 0;
+  pf_ctx.dma_next = 0;
+  pf_ctx.head = 0;
+  pf_ctx.tail = 0;
+  memset(&pf_ctx.frame, 0, sizeof(pf_ctx.frame));
+  pf_ctx.plan = plan;
+}
+
+/**
+ * @brief  Place the tensors of the next WEIGHT_PREFETCH_DEPTH epochs in the ring
+ */
+static void Prefetch_Issue(void) {
+  TX_INTERRUPT_SAVE_AREA
+  prefetch_plan_t *plan = pf_ctx.plan;
+  uint16_t issue = pf_ctx.issue;
+
+  /* Tensors the stream engines already passed are not worth copying */
+  if (issue < pf_ctx.use) {
+    issue = pf_ctx.use;
+  }
+
+  while (issue < plan->nb && plan->entries[issue].epoch <= pf_ctx.epoch + WEIGHT_PREFETCH_DEPTH) {
+    prefetch_entry_t *entry = &plan->entries[issue];
+    uint32_t start = pf_ctx.head;
+
+    /* A copy never wraps: skip the end of the ring if it does not fit */
+    if (start % WEIGHT_PREFETCH_STAGING_SIZE + entry->len > WEIGHT_PREFETCH_STAGING_SIZE) {
+      start += WEIGHT_PREFETCH_STAGING_SIZE - start % WEIGHT_PREFETCH_STAGING_SIZE;
+    }
+    if (start + entry->len - pf_ctx.tail > WEIGHT_PREFETCH_STAGING_SIZE) {
+      break; /* Ring full, retried at the next epoch */
+    }
+
+    entry->stage = start % WEIGHT_PREFETCH_STAGING_SIZE;
+    entry->ring_end = start + entry->len;
+    entry->state = PREFETCH_PENDING;
+    pf_ctx.head = entry->ring_end;
+    pf_ctx.frame.bytes += entry->len;
+    issue++;
+  }
+
+  TX_DISABLE
+  pf_ctx.issue = issue;
+  if (!pf_ctx.dma_busy) {
+    Prefetch_DmaKick();
+  }
+  TX_RESTORE
+}
+
+/**
+ * @brief  Free the ring space of the tensors consumed up to a finished epoch
+ * @note   A stream engine reads its copy until the end of its epoch block; a
+ *         copy still in flight for a released entry is harmless, later copies
+ *         that reuse the space are queued behind it
+ */
+static void Prefetch_Release(int16_t epoch) {
+  prefetch_plan_t *plan = pf_ctx.plan;
+
+  while (pf_ctx.release < pf_ctx.use && plan->entries[pf_ctx.release].epoch <= epoch) {
+    const prefetch_entry_t *entry = &plan->entries[pf_ctx.release];
+
+    if (entry->state != PREFETCH_IDLE) {
+      pf_ctx.tail = entry->ring_end;
+    }
+    pf_ctx.release++;
+  }
+}
+
+/**
+ * @brief  Finish an inference: drop queued copies, publish the statistics
+ */
+static void Prefetch_End(void) {
+  TX_INTERRUPT_SAVE_AREA
+  prefetch_plan_t *plan = pf_ctx.plan;
+
+  /* The running copy completes on its own, then the DMA goes idle */
+  TX_DISABLE
+  pf_ctx.issue = pf_ctx.dma_next;
+  TX_RESTORE
+  while (pf_ctx.dma_busy) {
+  }
+
+  plan->learned = 1;
+  pf_ctx.frame.nb_tensors = plan->nb;
+  pf_ctx.plan = NULL;
+
+  tx_mutex_get(&pf_ctx.mutex, TX_WAIT_FOREVER);
+  pf_ctx.published = pf_ctx.frame;
+  tx_mutex_put(&pf_ctx.mutex);
+}
+
+/**
+ * @brief  Epoch block callback (inference thread context)
+ */
+static void Prefetch_EpochCallback(LL_ATON_RT_Callbacktype_t ctype,
+                                   const NN_Instance_TypeDef *nn_instance,
+                                   const EpochBlock_ItemTypeDef *eb) {
+  prefetch_plan_t *plan = Prefetch_FindPlan(nn_instance);
+
+  APP_REQUIRE(plan != NULL);
+
+  if (ctype == LL_ATON_RT_Callbacktype_PRE_START && eb != NULL && !pf_ctx.disabled) {
+    if (pf_ctx.plan == NULL) {
+      Prefetch_Begin(plan);
+    }
+    pf_ctx.epoch = eb->epoch_num;
+    if (plan->learned) {
+      Prefetch_Issue();
+    }
+  } else if (ctype == LL_ATON_RT_Callbacktype_POST_END && eb != NULL && pf_ctx.plan == plan) {
+    Prefetch_Release(eb->epoch_num);
+    if (EpochBlock_IsLastEpochBlock(eb)) {
+      Prefetch_End();
+    }
+  }
+
+  if (plan->chained != NULL) {
+    plan->chained(ctype, nn_instance, eb);
+  }
+}
+
+/**
+ * @brief  Next schedule entry of the running epoch matching a flash tensor
+ */
+static prefetch_entry_t *Prefetch_Match(prefetch_plan_t *plan, uint32_t src, uint32_t len) {
+  for (uint16_t i = pf_ctx.use; i < plan->nb && plan->entries[i].epoch <= pf_ctx.epoch; i++) {
+    prefetch_entry_t *entry = &plan->entries[i];
+
+    if (entry->epoch == pf_ctx.epoch && entry->src == src && entry->len == len) {
+      pf_ctx.use = i + 1;
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Point a stream engine read at its staged copy (inference thread context)
+ */
+void Prefetch_Rebase(LL_Streng_TensorInitTypeDef *conf) {
+  prefetch_plan_t *plan = pf_ctx.plan;
+  prefetch_entry_t *entry;
+  uint32_t lo, hi, src, len, delta;
+
+  if (plan == NULL || conf->dir != 0) {
+    return;
+  }
+
+  /* Only reads with a known extent: the address limiter, or one raw pass */
+  if (conf->offset_limit != 0) {
+    hi = conf->addr_base.i + conf->offset_limit;
+  } else if (conf->raw && conf->frame_loop_cnt == 0 && conf->frame_tot_cnt <= 1) {
+    hi = conf->addr_base.i + conf->offset_end;
+  } else {
+    return;
+  }
+  lo = conf->addr_base.i + conf->offset_start;
+  if (lo < PREFETCH_FLASH_START || hi > PREFETCH_FLASH_END) {
+    return;
+  }
+
+  src = lo & ~(PREFETCH_ALIGN - 1U);
+  len = ((hi + PREFETCH_ALIGN - 1U) & ~(PREFETCH_ALIGN - 1U)) - src;
+
+  if (!plan->learned) {
+    if (len <= PREFETCH_MAX_TENSOR && plan->nb < WEIGHT_PREFETCH_MAX_TENSORS) {
+      entry = &plan->entries[plan->nb++];
+      entry->src = src;
+      entry->len = len;
+      entry->epoch = pf_ctx.epoch;
+    }
+    return;
+  }
+
+  entry = Prefetch_Match(plan, src, len);
+  if (entry == NULL) {
+    return;
+  }
+  if (entry->state != PREFETCH_DONE) {
+    pf_ctx.frame.misses++;
+    return;
+  }
+
+  /* Same tensor, rebased on the copy; on-chip RAM bypasses the NPU cache */
+  delta = src - conf->addr_base.i;
+  conf->addr_base.p = &staging[entry->stage];
+  conf->offset_start -= delta;
+  conf->offset_end -= delta;
+  if (conf->offset_limit != 0) {
+    conf->offset_limit -= delta;
+  }
+  conf->cacheable = 0;
+  conf->cache_allocate = 0;
+  pf_ctx.frame.hits++;
+}
+
+/**
+ * @brief  Set up the copy DMA and chain the epoch callback of every network
+ */
+void Prefetch_Init(void) {
+  memset(&pf_ctx, 0, sizeof(pf_ctx));
+
+  APP_REQUIRE_EQ(tx_mutex_create(&pf_ctx.mutex, "prefetch", TX_INHERIT), TX_SUCCESS);
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  pf_ctx.hdma.Instance = PREFETCH_DMA_CHANNEL;
+  pf_ctx.hdma.Init.Request = DMA_REQUEST_SW;
+  pf_ctx.hdma.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  pf_ctx.hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  pf_ctx.hdma.Init.SrcInc = DMA_SINC_INCREMENTED;
+  pf_ctx.hdma.Init.DestInc = DMA_DINC_INCREMENTED;
+  pf_ctx.hdma.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_DOUBLEWORD;
+  pf_ctx.hdma.Init.DestDataWidth = DMA_DEST_DATAWIDTH_DOUBLEWORD;
+  pf_ctx.hdma.Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT; /* The NPU keeps the bus */
+  pf_ctx.hdma.Init.SrcBurstLength = 4;                    /* 4 x 64-bit: one 32-byte line */
+  pf_ctx.hdma.Init.DestBurstLength = 4;
+  pf_ctx.hdma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  pf_ctx.hdma.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  pf_ctx.hdma.Init.Mode = DMA_NORMAL;
+  APP_REQUIRE_EQ(HAL_DMA_Init(&pf_ctx.hdma), HAL_OK);
+  APP_REQUIRE_EQ(HAL_DMA_ConfigChannelAttributes(&pf_ctx.hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                                   DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC),
+                 HAL_OK);
+  pf_ctx.hdma.XferCpltCallback = Prefetch_DmaComplete;
+  pf_ctx.hdma.XferErrorCallback = Prefetch_DmaError;
+
+  HAL_NVIC_SetPriority(PREFETCH_DMA_IRQn, PREFETCH_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(PREFETCH_DMA_IRQn);
+
+  /* Every registered network, so the schedule follows a network switch */
+  for (uint32_t id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    NN_Instance_TypeDef *instance = MX_X_CUBE_AI_GetNetwork(id);
+
+    if (instance != NULL) {
+      pf_ctx.plans[id].instance = instance;
+      pf_ctx.plans[id].chained = instance->exec_state.epoch_callback_function;
+      LL_ATON_RT_SetEpochCallback(Prefetch_EpochCallback, instance);
+    }
+  }
+}
+
+/**
+ * @brief  Stage the weights or leave them to be read in place
+ */
+void Prefetch_SetEnabled(int enable) {
+  pf_ctx.disabled = !enable;
+}
+
+/**
+ * @brief  Copy the statistics of the last completed inference
+ */
+void Prefetch_GetStats(prefetch_stats_t *stats) {
+  tx_mutex_get(&pf_ctx.mutex, TX_WAIT_FOREVER);
+  *stats = pf_ctx.published;
+  tx_mutex_put(&pf_ctx.mutex);
+}
+
+/**
+ * @brief  Copy DMA interrupt handler
+ */
+void Prefetch_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&pf_ctx.hdma);
+}
+
+#endif /* WEIGHT_PREFETCH_ENABLE */
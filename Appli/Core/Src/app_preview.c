@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file    app_preview.c
+ * @author  Long Liangmao
+ * @brief   Telemetry preview thumbnail implementation for STM32N6570-DK
+ *
+ *          The shown camera display slot is lent for one thumbnail and box
+ *          filtered by the CPU, one tile row per UI wake: each thumbnail
+ *          pixel is the mean of the 2 x 2 pixels at the center of its
+ *          scale x scale block (two 32-bit reads of the non-cacheable ring).
+ *          The tiles are then compared with the copy the host holds and the
+ *          due ones are sent, as many per record as fit.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_preview.h"
+
+#if PREVIEW_ENABLE
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !TELEMETRY
+#error "PREVIEW_ENABLE sends its tiles as telemetry records: it needs TELEMETRY"
+#endif
+#if DISPLAY_SINGLE_PIPE
+#error "PREVIEW_ENABLE lends a slot of the Pipe1 display ring: it needs !DISPLAY_SINGLE_PIPE"
+#endif
+#if PREVIEW_BITS != 4 && PREVIEW_BITS != 8
+#error "PREVIEW_BITS must be 4 or 8"
+#endif
+#if (PREVIEW_WIDTH % 8) != 0 || (PREVIEW_HEIGHT % ((32 * 8) / (8 * PREVIEW_BITS))) != 0
+#error "PREVIEW_WIDTH must be a multiple of the tile width, PREVIEW_HEIGHT of the tile height"
+#endif
+#if (DISPLAY_LETTERBOX_WIDTH % PREVIEW_WIDTH) != 0 || \
+    (DISPLAY_LETTERBOX_WIDTH / PREVIEW_WIDTH) != (DISPLAY_LETTERBOX_HEIGHT / PREVIEW_HEIGHT) || \
+    (DISPLAY_LETTERBOX_HEIGHT % PREVIEW_HEIGHT) != 0 || ((DISPLAY_LETTERBOX_WIDTH / PREVIEW_WIDTH) % 2) != 0
+#error "The letterbox must be an even integer multiple of the preview size"
+#endif
+
+_Static_assert(sizeof(preview_record_t) <= TELEMETRY_PAYLOAD_MAX, "Preview record overflows");
+
+#define PREVIEW_SCALE (DISPLAY_LETTERBOX_WIDTH / PREVIEW_WIDTH)
+#define PREVIEW_TILES_X (PREVIEW_WIDTH / PREVIEW_TILE_WIDTH)
+#define PREVIEW_TILES_Y (PREVIEW_HEIGHT / PREVIEW_TILE_HEIGHT)
+#define PREVIEW_TILES (PREVIEW_TILES_X * PREVIEW_TILES_Y)
+#define PREVIEW_LINE_BYTES (PREVIEW_TILE_WIDTH * PREVIEW_BITS / 8U) /* One tile line */
+
+_Static_assert(PREVIEW_TILES < PREVIEW_TILE_WHOLE, "Preview tile numbers overflow");
+_Static_assert(PREVIEW_REFRESH_TILES <= PREVIEW_TILES, "More refresh tiles than tiles");
+
+/* Tile entry: number, byte count, PackBits bytes (at most one control byte
+ * per 128 literals) */
+#define PREVIEW_ENTRY_HEADER 3U
+#define PREVIEW_PACKED_MAX (PREVIEW_TILE_BYTES + (PREVIEW_TILE_BYTES + 127U) / 128U)
+#define PREVIEW_RECORD_TILES (PREVIEW_DATA_MAX / (PREVIEW_ENTRY_HEADER + 2U))
+
+_Static_assert(PREVIEW_ENTRY_HEADER + PREVIEW_PACKED_MAX <= PREVIEW_DATA_MAX, "Preview tile overflows a record");
+
+/* Record bytes on the link: telemetry header, preview header, tiles */
+#define PREVIEW_RECORD_COST(used) (TELEMETRY_HEADER_SIZE + offsetof(preview_record_t, data) + (used))
+
+_Static_assert(PREVIEW_RECORD_COST(PREVIEW_DATA_MAX) <= PREVIEW_BUDGET_BPS, "PREVIEW_BUDGET_BPS under one record");
+
+typedef enum {
+  PREVIEW_STATE_IDLE,
+  PREVIEW_STATE_BUILD, /* Display slot lent, one tile row per wake */
+  PREVIEW_STATE_SEND,
+} preview_state_t;
+
+static struct {
+  uint8_t cur[PREVIEW_TILES][PREVIEW_TILE_BYTES]; /* Thumbnail being sent */
+  uint8_t ref[PREVIEW_TILES][PREVIEW_TILE_BYTES]; /* Copy the host holds */
+  preview_state_t state;
+  int slot;
+  uint32_t row;          /* Next tile row to build */
+  uint32_t cursor;       /* Next tile to consider */
+  uint32_t refresh;      /* First tile resent whole this thumbnail */
+  uint16_t thumb;
+  uint8_t whole;         /* Every tile of this thumbnail whole */
+  uint8_t sent;          /* A tile of this thumbnail went out */
+  uint64_t start_us;     /* Of the last thumbnail */
+  uint64_t budget_us;    /* Budget refilled up to */
+  uint32_t budget;       /* Record bytes allowed now */
+} pv_ctx = {
+    .whole = 1, /* Nothing the host holds yet */
+};
+
+/**
+ * @brief  Luma level of the 2 x 2 pixels at the center of a block
+ */
+static uint32_t Preview_Sample(const uint8_t *frame, uint32_t pitch, uint32_t lx, uint32_t ly) {
+  const uint32_t x = lx * PREVIEW_SCALE + ((PREVIEW_SCALE / 2U) & ~1U);
+  const uint32_t y = ly * PREVIEW_SCALE + PREVIEW_SCALE / 2U - 1U;
+  const uint32_t *line0 = (const uint32_t *)(frame + y * pitch + x * DISPLAY_BPP);
+  const uint32_t *line1 = (const uint32_t *)((const uint8_t *)line0 + pitch);
+  const uint32_t words[2] = {*line0, *line1};
+  uint32_t sum = 0;
+
+  for (uint32_t w = 0; w < 2U; w++) {
+    for (uint32_t shift = 0; shift < 32U; shift += 16U) {
+      uint32_t px = (words[w] >> shift) & 0xFFFFU;
+
+      /* BT.601 weights over the RGB565 fields: 8-bit luma x 256 */
+      sum += ((px >> 11) & 0x1FU) * 616U + ((px >> 5) & 0x3FU) * 600U + (px & 0x1FU) * 232U;
+    }
+  }
+  return (sum >> 10) >> (8U - PREVIEW_BITS);
+}
+
+/**
+ * @brief  Filter one tile row of the lent slot into the thumbnail
+ */
+static void Preview_BuildRow(const uint8_t *frame, uint32_t pitch, uint32_t row) {
+  for (uint32_t line = 0; line < PREVIEW_TILE_HEIGHT; line++) {
+    uint32_t ly = row * PREVIEW_TILE_HEIGHT + line;
+
+    for (uint32_t lx = 0; lx < PREVIEW_WIDTH; lx++) {
+      uint8_t *tile = pv_ctx.cur[row * PREVIEW_TILES_X + lx / PREVIEW_TILE_WIDTH];
+      uint32_t px = lx % PREVIEW_TILE_WIDTH;
+      uint32_t level = Preview_Sample(frame, pitch, lx, ly);
+
+#if PREVIEW_BITS == 4
+      uint8_t *byte = &tile[line * PREVIEW_LINE_BYTES + px / 2U];
+
+      *byte = (px & 1U) ? (uint8_t)((*byte & 0xF0U) | level) : (uint8_t)((*byte & 0x0FU) | (level << 4));
+#else
+      tile[line * PREVIEW_LINE_BYTES + px] = (uint8_t)level;
+#endif
+    }
+  }
+}
+
+/**
+ * @brief  Sum of the level changes of a tile against the host copy
+ */
+static uint32_t Preview_TileSad(uint32_t t) {
+  uint32_t sad = 0;
+
+  for (uint32_t i = 0; i < PREVIEW_TILE_BYTES; i++) {
+    int32_t a = pv_ctx.cur[t][i];
+    int32_t b = pv_ctx.ref[t][i];
+
+#if PREVIEW_BITS == 4
+    sad += (uint32_t)abs((a >> 4) - (b >> 4)) + (uint32_t)abs((a & 0x0F) - (b & 0x0F));
+#else
+    sad += (uint32_t)abs(a - b);
+#endif
+  }
+  return sad;
+}
+
+/**
+ * @brief  PackBits code of one tile
+ * @retval Bytes written, at most PREVIEW_PACKED_MAX
+ */
+static uint32_t Preview_Pack(const uint8_t *src, uint8_t *dst) {
+  uint32_t n = 0;
+  uint32_t i = 0;
+
+  while (i < PREVIEW_TILE_BYTES) {
+    uint32_t run = 1;
+    uint32_t j;
+
+    while (i + run < PREVIEW_TILE_BYTES && run < 129U && src[i + run] == src[i]) {
+      run++;
+    }
+    if (run >= 3U) {
+      dst[n++] = (uint8_t)(0x7EU + run);
+      dst[n++] = src[i];
+      i += run;
+      continue;
+    }
+
+    /* Literals up to the next run of three */
+    for (j = i; j < PREVIEW_TILE_BYTES && j - i < 128U; j++) {
+      if (j + 2U < PREVIEW_TILE_BYTES && src[j] == src[j + 1U] && src[j] == src[j + 2U]) {
+        break;
+      }
+    }
+    dst[n++] = (uint8_t)(j - i - 1U);
+    memcpy(&dst[n], &src[i], j - i);
+    n += j - i;
+    i = j;
+  }
+  return n;
+}
+
+/**
+ * @brief  Resent whole this thumbnail, in turn
+ */
+static int Preview_IsRefresh(uint32_t t) {
+  return ((t + PREVIEW_TILES - pv_ctx.refresh) % PREVIEW_TILES) < PREVIEW_REFRESH_TILES;
+}
+
+/**
+ * @brief  Send the due tiles from the cursor on, one record, within budget
+ * @retval 1 once the thumbnail is through
+ */
+static int Preview_SendRecord(uint64_t now_us) {
+  preview_record_t rec = {
+      .thumb = pv_ctx.thumb,
+      .bits = PREVIEW_BITS,
+      .tiles_x = PREVIEW_TILES_X,
+      .tiles_y = PREVIEW_TILES_Y,
+  };
+  uint16_t tiles[PREVIEW_RECORD_TILES];
+  uint32_t cursor = pv_ctx.cursor;
+  uint32_t used = 0;
+
+  for (; cursor < PREVIEW_TILES && rec.nb < PREVIEW_RECORD_TILES; cursor++) {
+    uint8_t delta[PREVIEW_TILE_BYTES];
+    uint8_t packed[PREVIEW_PACKED_MAX];
+    const uint8_t *src = pv_ctx.cur[cursor];
+    uint16_t number = (uint16_t)cursor;
+    uint32_t len;
+
+    if (pv_ctx.whole || Preview_IsRefresh(cursor)) {
+      number |= PREVIEW_TILE_WHOLE;
+    } else if (Preview_TileSad(cursor) > PREVIEW_TILE_SAD) {
+      for (uint32_t i = 0; i < PREVIEW_TILE_BYTES; i++) {
+        delta[i] = pv_ctx.cur[cursor][i] ^ pv_ctx.ref[cursor][i];
+      }
+      src = delta;
+    } else {
+      continue;
+    }
+
+    len = Preview_Pack(src, packed);
+    if (used + PREVIEW_ENTRY_HEADER + len > PREVIEW_DATA_MAX) {
+      break;
+    }
+    rec.data[used] = (uint8_t)(number & 0xFFU);
+    rec.data[used + 1U] = (uint8_t)(number >> 8);
+    rec.data[used + 2U] = (uint8_t)len;
+    memcpy(&rec.data[used + PREVIEW_ENTRY_HEADER], packed, len);
+    used += PREVIEW_ENTRY_HEADER + len;
+    tiles[rec.nb++] = (uint16_t)cursor;
+  }
+
+  if (cursor >= PREVIEW_TILES) {
+    if (rec.nb == 0U && !pv_ctx.sent) {
+      return 1; /* Nothing moved and nothing to refresh */
+    }
+    rec.flags |= PREVIEW_FLAG_LAST;
+  }
+
+  /* Token bucket, up to one second of budget */
+  pv_ctx.budget += (uint32_t)MIN((now_us - pv_ctx.budget_us) * PREVIEW_BUDGET_BPS / 1000000U, PREVIEW_BUDGET_BPS);
+  pv_ctx.budget = MIN(pv_ctx.budget, PREVIEW_BUDGET_BPS);
+  pv_ctx.budget_us = now_us;
+  if (pv_ctx.budget < PREVIEW_RECORD_COST(used)) {
+    return 0;
+  }
+  if (!Telemetry_Send(TELEMETRY_TYPE_PREVIEW, &rec, offsetof(preview_record_t, data) + used)) {
+    return 0; /* Ring full: the same tiles next wake */
+  }
+  pv_ctx.budget -= PREVIEW_RECORD_COST(used);
+
+  for (uint32_t i = 0; i < rec.nb; i++) {
+    memcpy(pv_ctx.ref[tiles[i]], pv_ctx.cur[tiles[i]], PREVIEW_TILE_BYTES);
+  }
+  pv_ctx.sent |= (rec.nb != 0U);
+  pv_ctx.cursor = cursor;
+  return (rec.flags & PREVIEW_FLAG_LAST) != 0U;
+}
+
+/**
+ * @brief  Build or send the current thumbnail, start the next when due
+ */
+void Preview_Poll(void) {
+  uint64_t now_us = Time_GetUs();
+
+  switch (pv_ctx.state) {
+  case PREVIEW_STATE_IDLE: {
+    buffer_frame_tag_t tag;
+
+    if (Telemetry_TakeRequest(TELEMETRY_REQUEST_PREVIEW_KEY)) {
+      pv_ctx.whole = 1;
+    } else if (pv_ctx.thumb != 0U && now_us - pv_ctx.start_us < PREVIEW_PERIOD_MS * 1000ULL) {
+      return;
+    }
+    pv_ctx.slot = Buffer_CameraDisplay_Lend(BUFFER_LENDER_PREVIEW, &tag);
+    if (pv_ctx.slot < 0) {
+      return; /* No frame yet */
+    }
+    pv_ctx.start_us = now_us;
+    pv_ctx.row = 0;
+    pv_ctx.state = PREVIEW_STATE_BUILD;
+    break;
+  }
+
+  case PREVIEW_STATE_BUILD: {
+    const buffer_desc_t *desc = Buffer_GetDesc(BUFFER_ID_CAMERA_DISPLAY);
+
+    Preview_BuildRow(Buffer_GetCameraDisplayBuffer(pv_ctx.slot), desc->pitch, pv_ctx.row);
+    if (++pv_ctx.row < PREVIEW_TILES_Y) {
+      break;
+    }
+    Buffer_CameraDisplay_Return(BUFFER_LENDER_PREVIEW);
+    pv_ctx.thumb++;
+    pv_ctx.cursor = 0;
+    pv_ctx.sent = 0;
+    pv_ctx.state = PREVIEW_STATE_SEND;
+    break;
+  }
+
+  case PREVIEW_STATE_SEND:
+    if (!Preview_SendRecord(now_us)) {
+      break;
+    }
+    pv_ctx.whole = 0;
+    pv_ctx.refresh = (pv_ctx.refresh + PREVIEW_REFRESH_TILES) % PREVIEW_TILES;
+    pv_ctx.state = PREVIEW_STATE_IDLE;
+    break;
+  }
+}
+
+#endif /* PREVIEW_ENABLE */
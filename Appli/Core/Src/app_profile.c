@@ -0,0 +1,214 @@
+/**
+ ******************************************************************************
+ * @file    app_profile.c
+ * @author  Long Liangmao
+ * @brief   Performance profiles for STM32N6570-DK (PROFILE_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_profile.h"
+
+#if PROFILE_ENABLE
+
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_motion.h"
+#include "app_telemetry.h"
+#include "app_ui.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if DVFS_ENABLE
+#error "PROFILE_ENABLE sets the operating point itself: not with the DVFS_ENABLE governor"
+#endif
+#if ML_CAPTURE_MODE == ML_CAPTURE_CONTINUOUS &&                                                       \
+    ((PROFILE_BALANCED_DECIMATION & (PROFILE_BALANCED_DECIMATION - 1)) != 0 ||                          \
+     (PROFILE_LOW_POWER_DECIMATION & (PROFILE_LOW_POWER_DECIMATION - 1)) != 0 || DISPLAY_SINGLE_PIPE)
+#error "PROFILE_ENABLE in ML_CAPTURE_CONTINUOUS sets the Pipe2 frame divider: decimations 1, 2, 4 or 8, not DISPLAY_SINGLE_PIPE"
+#endif
+#if PROFILE_DEFAULT < 0 || PROFILE_DEFAULT > 2
+#error "PROFILE_DEFAULT must be 0 (max-fps), 1 (balanced) or 2 (low-power)"
+#endif
+
+_Static_assert(sizeof(profile_record_t) <= TELEMETRY_PAYLOAD_MAX, "Profile record overflows");
+_Static_assert(PROFILE_NB == 3, "PROFILE_DEFAULT and the power.profile range assume three profiles");
+
+#define PROFILE_APPLIED_NONE 0xFFFFFFFFU
+
+typedef struct {
+  const char *name;
+  dvfs_point_t point;
+  int32_t fps; /* 0: as booted */
+  uint32_t decimation;
+  uint8_t gate;
+  uint32_t ui_period_ms;
+  qos_preset_t qos;
+} profile_desc_t;
+
+static const profile_desc_t profile_desc[PROFILE_NB] = {
+#define PROFILE_DESC(id, name, point, fps, decimation, gate, ui_period_ms, qos) \
+  {name, point, fps, decimation, gate, ui_period_ms, qos},
+    PROFILE_TABLE(PROFILE_DESC)
+#undef PROFILE_DESC
+};
+
+/* Power model terms per operating point */
+static const uint32_t profile_cpu_mw[DVFS_POINT_NB] = {
+    [DVFS_POINT_NOMINAL] = PROFILE_POWER_CPU_NOMINAL_MW,
+    [DVFS_POINT_OVERDRIVE] = PROFILE_POWER_CPU_OVERDRIVE_MW,
+};
+static const uint32_t profile_npu_mw[DVFS_POINT_NB] = {
+    [DVFS_POINT_NOMINAL] = PROFILE_POWER_NPU_NOMINAL_MW,
+    [DVFS_POINT_OVERDRIVE] = PROFILE_POWER_NPU_OVERDRIVE_MW,
+};
+
+static struct {
+  volatile uint32_t requested;  /* profile_id_t asked for */
+  volatile uint32_t floor;      /* Lowest-power profile_id_t allowed above it (THERMAL_ENABLE) */
+  volatile int32_t fps_override; /* cam.fps, 0: none */
+  uint32_t applied;             /* PROFILE_APPLIED_NONE before the first boundary */
+  int32_t applied_override;
+  int32_t booted_fps;           /* Sensor rate before any profile */
+  volatile uint32_t active;     /* Profile the settings are at */
+  volatile uint32_t switches;
+  /* UI thread */
+  profile_stats_t stats[PROFILE_NB];
+  uint32_t seen_switches; /* Switches at the last stats period */
+  uint32_t last_ms;
+} profile_ctx;
+
+/**
+ * @brief  Exponential moving average, 1/4 weight for the new sample
+ */
+static uint32_t Profile_Filter(uint32_t avg, uint32_t sample) {
+  return (avg == 0) ? sample : avg - avg / 4U + sample / 4U;
+}
+
+void Profile_Init(void) {
+  profile_ctx.requested = PROFILE_DEFAULT;
+  profile_ctx.applied = PROFILE_APPLIED_NONE;
+  profile_ctx.active = PROFILE_DEFAULT;
+  profile_ctx.last_ms = HAL_GetTick();
+}
+
+void Profile_Select(uint32_t profile) {
+  APP_REQUIRE(profile < PROFILE_NB);
+  profile_ctx.requested = profile;
+}
+
+void Profile_SetFloor(uint32_t profile) {
+  APP_REQUIRE(profile < PROFILE_NB);
+  profile_ctx.floor = profile;
+}
+
+void Profile_SetFrameRate(int32_t fps) {
+  APP_REQUIRE(fps >= 0);
+  profile_ctx.fps_override = fps;
+}
+
+void Profile_FrameBoundary(void) {
+  /* Profiles are ordered by power: the floor caps the one asked for */
+  uint32_t profile = MAX(profile_ctx.requested, profile_ctx.floor);
+  int32_t override = profile_ctx.fps_override;
+  const profile_desc_t *desc = &profile_desc[profile];
+  int32_t fps;
+
+  if (profile == profile_ctx.applied && override == profile_ctx.applied_override) {
+    return;
+  }
+  if (profile_ctx.applied == PROFILE_APPLIED_NONE) {
+    profile_ctx.booted_fps = CAM_GetFrameRate();
+  }
+  fps = override ? override : (desc->fps ? desc->fps : profile_ctx.booted_fps);
+
+  /* Clocks up before the load grows, down after it shrank */
+  if (desc->point == DVFS_POINT_OVERDRIVE) {
+    DVFS_SetPoint(desc->point);
+  }
+  if (fps != CAM_GetFrameRate()) {
+    CAM_SetFrameRate(fps);
+  }
+  CAM_SetMLDecimation(desc->decimation);
+#if MOTION_GATE_ENABLE
+  Motion_SetEnabled(desc->gate);
+#endif
+  UI_SetMinPeriod(desc->ui_period_ms);
+#if QOS_ENABLE
+  Qos_SetPreset(desc->qos);
+#endif
+  if (desc->point != DVFS_POINT_OVERDRIVE) {
+    DVFS_SetPoint(desc->point);
+  }
+
+  if (profile != profile_ctx.applied) {
+    if (profile_ctx.applied != PROFILE_APPLIED_NONE) {
+      profile_ctx.switches++;
+    }
+    printf("Profile: %s, %ld fps, 1/%lu inferred\r\n", desc->name, (long)fps, (unsigned long)desc->decimation);
+  }
+  profile_ctx.applied = profile;
+  profile_ctx.applied_override = override;
+  profile_ctx.active = profile;
+}
+
+void Profile_Update(uint32_t frame_period_us, uint32_t inference_us, uint32_t cpu_load_pct) {
+  uint32_t active = profile_ctx.active;
+  uint32_t switches = profile_ctx.switches;
+  uint32_t now = HAL_GetTick();
+  profile_stats_t *stats = &profile_ctx.stats[active];
+  dvfs_stats_t dvfs;
+#if TELEMETRY
+  profile_record_t rec;
+#endif
+
+  DVFS_GetStats(&dvfs);
+  stats->time_ms += now - profile_ctx.last_ms;
+  profile_ctx.last_ms = now;
+
+  /* A period that straddles a switch measures neither profile */
+  if (switches == profile_ctx.seen_switches && frame_period_us != 0U) {
+    uint32_t npu_pct = MIN(inference_us * 100U / frame_period_us, 100U);
+    uint32_t mw = PROFILE_POWER_BASE_MW + profile_cpu_mw[dvfs.point] * MIN(cpu_load_pct, 100U) / 100U +
+                  profile_npu_mw[dvfs.point] * npu_pct / 100U;
+
+    if (dvfs.point == DVFS_POINT_OVERDRIVE) {
+      mw += PROFILE_POWER_OVERDRIVE_MW;
+    }
+    stats->fps_tenths = (uint16_t)Profile_Filter(stats->fps_tenths, 10000000U / frame_period_us);
+    stats->power_mw = (uint16_t)Profile_Filter(stats->power_mw, MIN(mw, 0xFFFFU));
+  }
+  profile_ctx.seen_switches = switches;
+
+#if TELEMETRY
+  rec = (profile_record_t){
+      .profile = (uint8_t)active,
+      .nb = PROFILE_NB,
+      .opp = (uint8_t)dvfs.point,
+      .decimation = (uint8_t)CAM_GetMLDecimation(),
+      .sensor_fps = (uint16_t)CAM_GetFrameRate(),
+      .switches = (uint16_t)switches,
+  };
+  for (uint32_t i = 0; i < PROFILE_NB; i++) {
+    rec.stats[i] = profile_ctx.stats[i];
+  }
+  Telemetry_Send(TELEMETRY_TYPE_PROFILE, &rec, sizeof(rec));
+#endif
+}
+
+profile_id_t Profile_GetActive(void) {
+  return (profile_id_t)profile_ctx.active;
+}
+
+#endif /* PROFILE_ENABLE */
@@ -0,0 +1,288 @@
+/**
+ ******************************************************************************
+ * @file    app_profiler.c
+ * @author  Long Liangmao
+ * @brief   Per-epoch NPU profiler implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_profiler.h"
+
+#if NN_EPOCH_PROFILER
+
+#include "app_error.h"
+#include "app_npu_cache.h"
+#include "app_trace.h"
+#include "app_ui.h"
+#include "app_x-cube-ai.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+/* Per-epoch accumulator (cycles) */
+typedef struct {
+  uint32_t sum;
+  uint32_t min;
+  uint32_t max;
+} profiler_acc_t;
+
+static struct {
+  /* Written by the inference thread from the epoch callback */
+  uint32_t block_start;                         /* Cycle stamp of the running epoch block */
+  uint32_t frame_cycles[PROFILER_MAX_EPOCHS];   /* Current frame, summed over blocks */
+  profiler_acc_t window[PROFILER_MAX_EPOCHS];   /* Current window */
+  char kind[PROFILER_MAX_EPOCHS];
+  int16_t last_epoch;                           /* Highest epoch seen */
+  uint32_t window_frames;
+  uint8_t in_inference;                         /* Between the first and last epoch block */
+  volatile int16_t running_epoch;               /* Read from interrupts, -1 outside inferences */
+  npu_cache_counters_t block_cache;             /* NPU cache counters at the block start */
+  npu_cache_counters_t window_cache[PROFILER_MAX_EPOCHS];
+
+  /* Published window, guarded by mutex */
+  TX_MUTEX mutex;
+  profiler_acc_t published[PROFILER_MAX_EPOCHS];
+  npu_cache_counters_t published_cache[PROFILER_MAX_EPOCHS];
+  uint32_t published_frames;
+} prof_ctx;
+
+/**
+ * @brief  Convert a DWT cycle count to microseconds
+ */
+static uint32_t Profiler_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief  Fold the finished frame into the window and publish full windows
+ */
+static void Profiler_EndFrame(void) {
+  for (int e = 0; e <= prof_ctx.last_epoch; e++) {
+    uint32_t cycles = prof_ctx.frame_cycles[e];
+    profiler_acc_t *acc = &prof_ctx.window[e];
+
+    if (prof_ctx.kind[e] == 0) {
+      continue;
+    }
+
+    acc->sum += cycles;
+    if (prof_ctx.window_frames == 0 || cycles < acc->min) {
+      acc->min = cycles;
+    }
+    if (cycles > acc->max) {
+      acc->max = cycles;
+    }
+  }
+
+  memset(prof_ctx.frame_cycles, 0, sizeof(prof_ctx.frame_cycles));
+
+  if (++prof_ctx.window_frames < PROFILER_WINDOW_FRAMES) {
+    return;
+  }
+
+  tx_mutex_get(&prof_ctx.mutex, TX_WAIT_FOREVER);
+  memcpy(prof_ctx.published, prof_ctx.window, sizeof(prof_ctx.published));
+  memcpy(prof_ctx.published_cache, prof_ctx.window_cache, sizeof(prof_ctx.published_cache));
+  prof_ctx.published_frames = prof_ctx.window_frames;
+  tx_mutex_put(&prof_ctx.mutex);
+
+  memset(prof_ctx.window, 0, sizeof(prof_ctx.window));
+  memset(prof_ctx.window_cache, 0, sizeof(prof_ctx.window_cache));
+  prof_ctx.window_frames = 0;
+}
+
+/**
+ * @brief  Epoch block callback (inference thread context)
+ */
+static void Profiler_EpochCallback(LL_ATON_RT_Callbacktype_t ctype,
+                                   const NN_Instance_TypeDef *nn_instance,
+                                   const EpochBlock_ItemTypeDef *eb) {
+  UNUSED(nn_instance);
+
+  if (ctype == LL_ATON_RT_Callbacktype_PRE_START) {
+    /* The monitor counters saturate: restart them with every inference */
+    if (!prof_ctx.in_inference) {
+      NPUCache_ResetCounters();
+      prof_ctx.in_inference = 1;
+    }
+    NPUCache_GetCounters(&prof_ctx.block_cache);
+    if (eb != NULL) {
+      prof_ctx.running_epoch = eb->epoch_num;
+#if TRACE_NPU_EPOCHS
+      TRACE_BEGIN_ARG(NPU_EPOCH, eb->epoch_num);
+#endif
+    }
+    prof_ctx.block_start = UI_GetCycleCount();
+    return;
+  }
+
+  if (ctype != LL_ATON_RT_Callbacktype_POST_END || eb == NULL) {
+    return;
+  }
+#if TRACE_NPU_EPOCHS
+  TRACE_END(NPU_EPOCH);
+#endif
+
+  int16_t epoch = eb->epoch_num;
+  if (epoch >= 0 && epoch < PROFILER_MAX_EPOCHS) {
+    npu_cache_counters_t cache;
+
+    prof_ctx.frame_cycles[epoch] += UI_GetCycleCount() - prof_ctx.block_start;
+    NPUCache_GetCounters(&cache);
+    NPUCache_Accumulate(&prof_ctx.window_cache[epoch], &prof_ctx.block_cache, &cache);
+    if (prof_ctx.kind[epoch] == 0) {
+      prof_ctx.kind[epoch] = EpochBlock_IsEpochPureSW(eb)   ? PROFILER_EPOCH_SW
+                             : EpochBlock_IsEpochHybrid(eb) ? PROFILER_EPOCH_HYBRID
+                                                            : PROFILER_EPOCH_HW;
+    }
+    if (epoch > prof_ctx.last_epoch) {
+      prof_ctx.last_epoch = epoch;
+    }
+  }
+
+  if (EpochBlock_IsLastEpochBlock(eb)) {
+    prof_ctx.in_inference = 0;
+    prof_ctx.running_epoch = -1;
+    Profiler_EndFrame();
+  }
+}
+
+/**
+ * @brief  Hook the profiler into the network epoch callbacks
+ */
+void Profiler_Init(void) {
+  memset(&prof_ctx, 0, sizeof(prof_ctx));
+  prof_ctx.last_epoch = -1;
+  prof_ctx.running_epoch = -1;
+
+  APP_REQUIRE_EQ(tx_mutex_create(&prof_ctx.mutex, "profiler", TX_INHERIT), TX_SUCCESS);
+
+  /* Every registered network, so the profile follows a network switch */
+  for (uint32_t id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    NN_Instance_TypeDef *instance = MX_X_CUBE_AI_GetNetwork(id);
+
+    if (instance != NULL) {
+      LL_ATON_RT_SetEpochCallback(Profiler_EpochCallback, instance);
+    }
+  }
+}
+
+void Profiler_ResetWindow(void) {
+  /* Epoch kinds and the published window are kept */
+  memset(prof_ctx.window, 0, sizeof(prof_ctx.window));
+  memset(prof_ctx.window_cache, 0, sizeof(prof_ctx.window_cache));
+  prof_ctx.window_frames = 0;
+}
+
+/**
+ * @brief  Get the slowest epochs of the last published window
+ */
+uint32_t Profiler_GetSlowest(profiler_epoch_stat_t *stats, uint32_t max_nb) {
+  uint32_t nb = 0;
+
+  tx_mutex_get(&prof_ctx.mutex, TX_WAIT_FOREVER);
+
+  if (prof_ctx.published_frames > 0) {
+    /* Insertion into a short sorted list: max_nb is small (panel size) */
+    for (int e = 0; e <= prof_ctx.last_epoch; e++) {
+      const profiler_acc_t *acc = &prof_ctx.published[e];
+      uint32_t avg = acc->sum / prof_ctx.published_frames;
+      uint32_t pos = nb;
+
+      if (prof_ctx.kind[e] == 0) {
+        continue;
+      }
+
+      while (pos > 0 && stats[pos - 1].avg_us < avg) {
+        if (pos < max_nb) {
+          stats[pos] = stats[pos - 1];
+        }
+        pos--;
+      }
+      if (pos >= max_nb) {
+        continue;
+      }
+
+      const npu_cache_counters_t *cache = &prof_ctx.published_cache[e];
+      uint32_t reads = cache->read_hits + cache->read_misses;
+
+      stats[pos] = (profiler_epoch_stat_t){
+          .epoch = (int16_t)e,
+          .kind = prof_ctx.kind[e],
+          .min_us = acc->min,
+          .avg_us = avg,
+          .max_us = acc->max,
+          .read_miss_permille = reads ? (uint16_t)((uint64_t)cache->read_misses * 1000U / reads) : 0,
+      };
+      if (nb < max_nb) {
+        nb++;
+      }
+    }
+  }
+
+  tx_mutex_put(&prof_ctx.mutex);
+
+  /* Sorting is done on cycles; convert once for the selected entries */
+  for (uint32_t i = 0; i < nb; i++) {
+    stats[i].min_us = Profiler_CyclesToUs(stats[i].min_us);
+    stats[i].avg_us = Profiler_CyclesToUs(stats[i].avg_us);
+    stats[i].max_us = Profiler_CyclesToUs(stats[i].max_us);
+  }
+
+  return nb;
+}
+
+/**
+ * @brief  NPU cache counters of an epoch range in the last published window
+ */
+uint32_t Profiler_GetCacheStats(int16_t first, int16_t last, npu_cache_counters_t *stats) {
+  uint32_t frames;
+
+  memset(stats, 0, sizeof(*stats));
+  first = MAX(first, 0);
+  last = MIN(last, PROFILER_MAX_EPOCHS - 1);
+
+  tx_mutex_get(&prof_ctx.mutex, TX_WAIT_FOREVER);
+  frames = prof_ctx.published_frames;
+  for (int e = first; e <= last; e++) {
+    const npu_cache_counters_t *cache = &prof_ctx.published_cache[e];
+
+    stats->read_hits += cache->read_hits;
+    stats->read_misses += cache->read_misses;
+    stats->write_hits += cache->write_hits;
+    stats->write_misses += cache->write_misses;
+    stats->evictions += cache->evictions;
+  }
+  tx_mutex_put(&prof_ctx.mutex);
+
+  /* Per inference */
+  if (frames > 0) {
+    stats->read_hits /= frames;
+    stats->read_misses /= frames;
+    stats->write_hits /= frames;
+    stats->write_misses /= frames;
+    stats->evictions /= frames;
+  }
+
+  return frames;
+}
+
+/**
+ * @brief  Get the epoch the NPU is on
+ */
+int16_t Profiler_GetRunningEpoch(void) {
+  return prof_ctx.running_epoch;
+}
+
+#endif /* NN_EPOCH_PROFILER */
@@ -0,0 +1,195 @@
+/**
+ ******************************************************************************
+ * @file    app_qos.c
+ * @author  Long Liangmao
+ * @brief   Interconnect QoS policy for STM32N6570-DK (QOS_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_qos.h"
+
+#if QOS_ENABLE
+
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_lcd.h"
+#include "cmw_camera.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#if !LCD_ERROR_MONITOR
+#error "QOS_ENABLE backs the NPU off on the LTDC underruns: needs LCD_ERROR_MONITOR"
+#endif
+#if QOS_DISPLAY_NPU > 15 || QOS_THROUGHPUT_NPU > 15 || QOS_CPU > 15
+#error "QoS levels are 4-bit: 0 to 15"
+#endif
+#if QOS_CPU >= QOS_NPU_FLOOR || QOS_NPU_FLOOR > QOS_DISPLAY_NPU || QOS_DISPLAY_NPU > QOS_THROUGHPUT_NPU
+#error "QoS must rank the CPU under QOS_NPU_FLOOR, itself at most QOS_DISPLAY_NPU, itself at most QOS_THROUGHPUT_NPU"
+#endif
+#if QOS_PRESET_DEFAULT < 0 || QOS_PRESET_DEFAULT > 1
+#error "QOS_PRESET_DEFAULT must be 0 (display) or 1 (throughput)"
+#endif
+
+_Static_assert(QOS_PRESET_NB == 2, "QOS_PRESET_DEFAULT assumes two presets");
+
+/* Polls of the IP-plug idle flag, ~1 ms at 800 MHz: the pipes are stopped */
+#define QOS_IPPLUG_IDLE_POLLS 100000U
+
+typedef struct {
+  const char *name;
+  uint8_t npu;
+  uint8_t cpu;
+} qos_desc_t;
+
+static const qos_desc_t qos_desc[QOS_PRESET_NB] = {
+#define QOS_PRESET_DESC(id, name, npu, cpu) {name, npu, cpu},
+    QOS_PRESET_TABLE(QOS_PRESET_DESC)
+#undef QOS_PRESET_DESC
+};
+
+static struct {
+  qos_stats_t stats;
+  /* UI thread */
+  uint32_t clean_periods; /* Since the last glitch */
+  uint32_t last_underruns;
+  uint32_t last_overruns;
+} qos_ctx;
+
+/**
+ * @brief  NPUNIC QoS register value: both NPU ports at one level, the CPU
+ *         subsystem port at another, reads and writes alike
+ */
+static uint32_t Qos_Register(uint32_t npu, uint32_t cpu) {
+  return (npu << SYSCFG_NPUNICQOSCR_NPU1_ARQOSR_Pos) | (npu << SYSCFG_NPUNICQOSCR_NPU1_ARQOSW_Pos) |
+         (npu << SYSCFG_NPUNICQOSCR_NPU2_ARQOSR_Pos) | (npu << SYSCFG_NPUNICQOSCR_NPU2_ARQOSW_Pos) |
+         (cpu << SYSCFG_NPUNICQOSCR_CPUSS_ARQOSR_Pos) | (cpu << SYSCFG_NPUNICQOSCR_CPUSS_ARQOSW_Pos);
+}
+
+/**
+ * @brief  Write the NPU and CPU levels of the active preset and back-off
+ * @note   Interrupts masked: the preset and the back-off move from two
+ *         threads
+ */
+static void Qos_Apply(void) {
+  qos_stats_t *stats = &qos_ctx.stats;
+  const qos_desc_t *desc;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  desc = &qos_desc[stats->preset];
+  stats->backoff = (uint8_t)MIN(stats->backoff, desc->npu - QOS_NPU_FLOOR);
+  stats->npu_qos = (uint8_t)(desc->npu - stats->backoff);
+  SYSCFG->NPUNICQOSCR = Qos_Register(stats->npu_qos, desc->cpu);
+  TX_RESTORE
+}
+
+/**
+ * @brief  DCMIPP requests in dynamic QoS: their level rises with the fill of
+ *         the IP-plug FIFOs, so a pipe near overrun passes the NPU
+ * @note   IPGR1 only changes with the IP-plug locked, once idle
+ */
+static void Qos_SetDcmippDynamic(void) {
+  DCMIPP_TypeDef *dcmipp = CMW_CAMERA_GetDCMIPPHandle()->Instance;
+  uint32_t polls = 0;
+
+  SET_BIT(dcmipp->IPGR2, DCMIPP_IPGR2_PSTART);
+  while ((dcmipp->IPGR3 & DCMIPP_IPGR3_IDLE) == 0U) {
+    APP_REQUIRE(++polls < QOS_IPPLUG_IDLE_POLLS);
+  }
+  SET_BIT(dcmipp->IPGR1, DCMIPP_IPGR1_QOS_MODE);
+  CLEAR_BIT(dcmipp->IPGR2, DCMIPP_IPGR2_PSTART);
+}
+
+/**
+ * @brief  Display underruns and camera overruns since boot
+ */
+static void Qos_Glitches(uint32_t *underruns, uint32_t *overruns) {
+  lcd_error_stats_t lcd;
+  cam_pipe_stats_t pipe;
+
+  LCD_GetErrorStats(&lcd);
+  *underruns = lcd.underruns;
+  *overruns = 0;
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    CAM_GetPipeStats(i, &pipe);
+    *overruns += pipe.overruns;
+  }
+}
+
+void Qos_Init(void) {
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  Qos_SetDcmippDynamic();
+
+  qos_ctx.stats.preset = QOS_PRESET_DEFAULT;
+  Qos_Apply();
+  Qos_Glitches(&qos_ctx.last_underruns, &qos_ctx.last_overruns);
+  printf("QoS: %s, NPU %u, CPU %u, DCMIPP dynamic\r\n", qos_desc[QOS_PRESET_DEFAULT].name,
+         (unsigned)qos_ctx.stats.npu_qos, (unsigned)qos_desc[QOS_PRESET_DEFAULT].cpu);
+}
+
+void Qos_SetPreset(uint32_t preset) {
+  APP_REQUIRE(preset < QOS_PRESET_NB);
+
+  if (preset != qos_ctx.stats.preset) {
+    qos_ctx.stats.preset = (uint8_t)preset;
+    Qos_Apply();
+  }
+}
+
+void Qos_Update(void) {
+  qos_stats_t *stats = &qos_ctx.stats;
+  uint32_t preset = stats->preset;
+  uint32_t underruns;
+  uint32_t overruns;
+  uint32_t new_underruns;
+  uint32_t new_overruns;
+
+  Qos_Glitches(&underruns, &overruns);
+  new_underruns = underruns - qos_ctx.last_underruns;
+  new_overruns = overruns - qos_ctx.last_overruns;
+  qos_ctx.last_underruns = underruns;
+  qos_ctx.last_overruns = overruns;
+
+  stats->periods[preset]++;
+  stats->underruns[preset] += new_underruns;
+  stats->overruns[preset] += new_overruns;
+
+  if (new_underruns != 0U || new_overruns != 0U) {
+    qos_ctx.clean_periods = 0;
+    if (stats->npu_qos > QOS_NPU_FLOOR) {
+      stats->backoff++;
+      stats->backoffs++;
+      Qos_Apply();
+      printf("QoS: %lu underruns, %lu overruns, NPU down to %u\r\n", (unsigned long)new_underruns,
+             (unsigned long)new_overruns, (unsigned)stats->npu_qos);
+    }
+  } else if (stats->backoff != 0U && ++qos_ctx.clean_periods >= QOS_RECOVER_PERIODS) {
+    qos_ctx.clean_periods = 0;
+    stats->backoff--;
+    Qos_Apply();
+  }
+}
+
+void Qos_GetStats(qos_stats_t *stats) {
+  TX_INTERRUPT_SAVE_AREA
+
+  APP_REQUIRE(stats != NULL);
+  TX_DISABLE
+  *stats = qos_ctx.stats;
+  TX_RESTORE
+}
+
+#endif /* QOS_ENABLE */
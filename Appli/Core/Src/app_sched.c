@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file    app_sched.c
+ * @author  Long Liangmao
+ * @brief   Thread priority plan check for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_sched.h"
+#include "app_error.h"
+
+#if !(HEALTH_THREAD_PRIORITY < ISP_THREAD_PRIORITY && ISP_THREAD_PRIORITY < NN_THREAD_PRIORITY && \
+      NN_THREAD_PRIORITY < PP_THREAD_PRIORITY && PP_THREAD_PRIORITY < UI_THREAD_PRIORITY)
+#error "Thread priority plan: supervisor, ISP, inference, post-processing, UI, most urgent first"
+#endif
+#if PP_HANDOFF_THRESHOLD > PP_THREAD_PRIORITY || PP_HANDOFF_THRESHOLD <= ISP_THREAD_PRIORITY
+#error "PP_HANDOFF_THRESHOLD must be at or above the post-processing priority, below the ISP"
+#endif
+
+/* Periodic pipeline thread; its deadline is its period */
+typedef struct {
+  uint32_t priority;
+  uint32_t budget_us;  /* CPU time per activation */
+  uint32_t suspend_us; /* Own blocking per activation (NPU), no CPU */
+  uint32_t period_us;
+} sched_task_t;
+
+/**
+ * @brief  Worst-case response time of a task: its own time plus every
+ *         activation of the tasks at its priority or above meanwhile
+ * @retval Response time in us, above the period when it cannot be met
+ */
+static uint32_t Sched_ResponseTime(const sched_task_t *tasks, uint32_t nb, uint32_t i) {
+  const sched_task_t *task = &tasks[i];
+  uint32_t response = task->budget_us + task->suspend_us;
+
+  while (response <= task->period_us) {
+    uint32_t next = task->budget_us + task->suspend_us;
+
+    for (uint32_t j = 0; j < nb; j++) {
+      /* Same priority, no time slicing: one may run first */
+      if (j != i && tasks[j].priority <= task->priority) {
+        next += (response + tasks[j].period_us - 1U) / tasks[j].period_us * tasks[j].budget_us;
+      }
+    }
+    if (next == response) {
+      break;
+    }
+    response = next;
+  }
+  return response;
+}
+
+void Sched_CheckPlan(int32_t fps) {
+  uint32_t frame_us;
+  uint32_t result_us;
+
+  APP_REQUIRE(fps > 0);
+  frame_us = 1000000U / (uint32_t)fps;
+  result_us = frame_us * NN_FRAME_DECIMATION;
+
+  const sched_task_t tasks[] = {
+#if ISP_SPLIT_APPLY
+      {ISP_THREAD_PRIORITY, SCHED_ISP_APPLY_BUDGET_US, 0, frame_us},
+      {ISP_ANALYZE_THREAD_PRIORITY, SCHED_ISP_BUDGET_US, 0, frame_us},
+#else
+      {ISP_THREAD_PRIORITY, SCHED_ISP_BUDGET_US, 0, frame_us},
+#endif
+      {NN_THREAD_PRIORITY, SCHED_NN_BUDGET_US, SCHED_NPU_BUDGET_US, result_us},
+      {PP_THREAD_PRIORITY, SCHED_PP_BUDGET_US, 0, result_us},
+      {UI_THREAD_PRIORITY, SCHED_UI_BUDGET_US, 0, result_us},
+  };
+
+  const uint32_t nb = sizeof(tasks) / sizeof(tasks[0]);
+
+  for (uint32_t i = 0; i < nb; i++) {
+    APP_REQUIRE(Sched_ResponseTime(tasks, nb, i) <= tasks[i].period_us);
+  }
+}
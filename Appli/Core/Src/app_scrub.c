@@ -0,0 +1,207 @@
+/**
+ ******************************************************************************
+ * @file    app_scrub.c
+ * @author  Long Liangmao
+ * @brief   Weight scrubbing for STM32N6570-DK (SCRUB_ENABLE)
+ *
+ *          Each slice streams one chunk of the bound model binary from the
+ *          octoFlash into the CRC data register by HPDMA, at the lowest
+ *          bus priority, while the background thread sleeps on the
+ *          transfer. The DMA reads the flash as stored: a line the NPU or
+ *          CPU cache still holds cannot hide a flip.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_scrub.h"
+
+#if SCRUB_ENABLE
+
+#include "app_error.h"
+#include "app_health.h"
+#include "app_slots.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if !BACKGROUND_ENABLE
+#error "SCRUB_ENABLE runs as a background job: it needs BACKGROUND_ENABLE"
+#endif
+#if SCRUB_CHUNK % 4U != 0U || SCRUB_CHUNK > 65532U
+#error "SCRUB_CHUNK must be a multiple of 4, at most 65532"
+#endif
+
+#define SCRUB_DMA_CHANNEL HPDMA1_Channel14
+#define SCRUB_DMA_IRQn HPDMA1_Channel14_IRQn
+
+#define SCRUB_CHUNKS_MAX ((BOOT_SLOTS_MODEL_SIZE + SCRUB_CHUNK - 1U) / SCRUB_CHUNK)
+
+#define SCRUB_DMA_TIMEOUT_TICKS ((SCRUB_DMA_TIMEOUT_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+static struct {
+  CRC_HandleTypeDef hcrc;
+  DMA_HandleTypeDef hdma;
+  TX_SEMAPHORE done;
+
+  /* Bound binary, fixed after Scrub_Init() */
+  uintptr_t binary;
+  uint32_t size;
+  uint32_t checksum;
+
+  /* Pass in progress; the table is the reference once sealed */
+  uint32_t chunk;
+  uint32_t sum; /* Unsealed pass: software sum, to match the header */
+  uint32_t table[SCRUB_CHUNKS_MAX];
+  scrub_stats_t stats;
+} scrub_ctx;
+
+static void Scrub_DmaComplete(DMA_HandleTypeDef *hdma) {
+  UNUSED(hdma);
+
+  tx_semaphore_put(&scrub_ctx.done);
+}
+
+static void Scrub_DmaError(DMA_HandleTypeDef *hdma) {
+  APP_REQUIRE_EQ(hdma->ErrorCode, HAL_DMA_ERROR_NONE);
+}
+
+/**
+ * @brief  CRC of one chunk: its words by DMA, its last bytes (end of the
+ *         binary only) by the CPU
+ * @param  sum: Unsealed pass: the chunk's software sum is added, computed
+ *         while the DMA runs; NULL otherwise
+ */
+static uint32_t Scrub_Crc(uintptr_t addr, uint32_t len, uint32_t *sum) {
+  uint32_t words = len & ~3U;
+
+  __HAL_CRC_DR_RESET(&scrub_ctx.hcrc);
+  if (words > 0U) {
+    APP_REQUIRE_EQ(HAL_DMA_Start_IT(&scrub_ctx.hdma, addr, (uint32_t)&scrub_ctx.hcrc.Instance->DR, words), HAL_OK);
+  }
+  if (sum != NULL) {
+    *sum += BootSlots_Sum((const void *)addr, len);
+  }
+  if (words > 0U) {
+    APP_REQUIRE_EQ(tx_semaphore_get(&scrub_ctx.done, MAX(SCRUB_DMA_TIMEOUT_TICKS, 1U)), TX_SUCCESS);
+  }
+  for (uint32_t i = words; i < len; i++) {
+    *(__IO uint8_t *)&scrub_ctx.hcrc.Instance->DR = ((const uint8_t *)addr)[i];
+  }
+  return scrub_ctx.hcrc.Instance->DR;
+}
+
+int Scrub_Step(void) {
+  uintptr_t addr = scrub_ctx.binary + scrub_ctx.chunk * SCRUB_CHUNK;
+  uint32_t len;
+  uint32_t start;
+  uint32_t crc;
+  uint32_t us;
+
+  if (scrub_ctx.size == 0U) {
+    return 0;
+  }
+  len = MIN(scrub_ctx.size - scrub_ctx.chunk * SCRUB_CHUNK, SCRUB_CHUNK);
+
+  start = DWT->CYCCNT;
+  crc = Scrub_Crc(addr, len, scrub_ctx.stats.sealed ? NULL : &scrub_ctx.sum);
+  us = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000U);
+  scrub_ctx.stats.max_us = MAX(scrub_ctx.stats.max_us, us);
+
+  if (!scrub_ctx.stats.sealed) {
+    scrub_ctx.table[scrub_ctx.chunk] = crc;
+  } else if (crc != scrub_ctx.table[scrub_ctx.chunk]) {
+    /* The network runs from these bytes: a flip is reported, not repaired */
+    scrub_ctx.stats.mismatches++;
+    scrub_ctx.stats.last_addr = (uint32_t)addr;
+    printf("Scrub: weights at 0x%08lx (%lu bytes) CRC 0x%08lx, sealed 0x%08lx\r\n", (unsigned long)addr,
+           (unsigned long)len, (unsigned long)crc, (unsigned long)scrub_ctx.table[scrub_ctx.chunk]);
+#if HEALTH_MONITOR
+    Health_RecordWeightFault((uint32_t)addr);
+#endif
+  }
+
+  if (++scrub_ctx.chunk < scrub_ctx.stats.chunks) {
+    return 1;
+  }
+
+  if (!scrub_ctx.stats.sealed) {
+    if (scrub_ctx.sum == scrub_ctx.checksum) {
+      scrub_ctx.stats.sealed = 1;
+    } else {
+      /* Built from changed bytes: not a reference, built again next pass */
+      printf("Scrub: binary sum 0x%08lx, header 0x%08lx: CRC table not sealed\r\n", (unsigned long)scrub_ctx.sum,
+             (unsigned long)scrub_ctx.checksum);
+#if HEALTH_MONITOR
+      Health_RecordWeightFault((uint32_t)scrub_ctx.binary);
+#endif
+    }
+  }
+  scrub_ctx.stats.passes++;
+  scrub_ctx.chunk = 0;
+  scrub_ctx.sum = 0;
+  return 0;
+}
+
+void Scrub_Init(void) {
+  scrub_ctx.size = Slots_GetModelBinary(&scrub_ctx.binary, &scrub_ctx.checksum);
+  APP_REQUIRE(scrub_ctx.size <= BOOT_SLOTS_MODEL_SIZE);
+  scrub_ctx.stats.chunks = (scrub_ctx.size + SCRUB_CHUNK - 1U) / SCRUB_CHUNK;
+
+  APP_REQUIRE_EQ(tx_semaphore_create(&scrub_ctx.done, "scrub", 0), TX_SUCCESS);
+
+  /* CRC-32 (Ethernet polynomial), fed 32-bit words */
+  __HAL_RCC_CRC_CLK_ENABLE();
+  scrub_ctx.hcrc.Instance = CRC;
+  scrub_ctx.hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_ENABLE;
+  scrub_ctx.hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_ENABLE;
+  scrub_ctx.hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_NONE;
+  scrub_ctx.hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_DISABLE;
+  scrub_ctx.hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_WORDS;
+  APP_REQUIRE_EQ(HAL_CRC_Init(&scrub_ctx.hcrc), HAL_OK);
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  scrub_ctx.hdma.Instance = SCRUB_DMA_CHANNEL;
+  scrub_ctx.hdma.Init.Request = DMA_REQUEST_SW;
+  scrub_ctx.hdma.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  scrub_ctx.hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  scrub_ctx.hdma.Init.SrcInc = DMA_SINC_INCREMENTED;
+  scrub_ctx.hdma.Init.DestInc = DMA_DINC_FIXED; /* The CRC data register */
+  scrub_ctx.hdma.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_WORD;
+  scrub_ctx.hdma.Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+  scrub_ctx.hdma.Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT; /* The NPU keeps the bus */
+  scrub_ctx.hdma.Init.SrcBurstLength = 8;                     /* 8 x 32-bit: one 32-byte line */
+  scrub_ctx.hdma.Init.DestBurstLength = 1;
+  scrub_ctx.hdma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1; /* AHB: the CRC */
+  scrub_ctx.hdma.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  scrub_ctx.hdma.Init.Mode = DMA_NORMAL;
+  APP_REQUIRE_EQ(HAL_DMA_Init(&scrub_ctx.hdma), HAL_OK);
+  APP_REQUIRE_EQ(HAL_DMA_ConfigChannelAttributes(&scrub_ctx.hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                                      DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC),
+                 HAL_OK);
+  scrub_ctx.hdma.XferCpltCallback = Scrub_DmaComplete;
+  scrub_ctx.hdma.XferErrorCallback = Scrub_DmaError;
+
+  HAL_NVIC_SetPriority(SCRUB_DMA_IRQn, SCRUB_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(SCRUB_DMA_IRQn);
+}
+
+void Scrub_GetStats(scrub_stats_t *stats) {
+  *stats = scrub_ctx.stats;
+}
+
+void Scrub_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&scrub_ctx.hdma);
+}
+
+#endif /* SCRUB_ENABLE */
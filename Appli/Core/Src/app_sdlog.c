@@ -0,0 +1,403 @@
+/**
+ ******************************************************************************
+ * @file    app_sdlog.c
+ * @author  Long Liangmao
+ * @brief   Append-only telemetry log on the microSD card for STM32N6570-DK
+ *          (SD_LOG): SDMMC2 through the BSP driver, whole segments by IDMA
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_sdlog.h"
+
+#if SD_LOG
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "stm32n6570_discovery_sd.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !TELEMETRY
+#error "SD_LOG writes the telemetry records: it needs TELEMETRY"
+#endif
+#ifndef HAL_SD_MODULE_ENABLED
+#error "SD_LOG needs HAL_SD_MODULE_ENABLED in stm32n6xx_hal_conf.h"
+#endif
+#if (SD_LOG_SEGMENT_SIZE % SDLOG_BLOCK_SIZE) != 0 || SD_LOG_SEGMENT_SIZE < SDLOG_BLOCK_SIZE
+#error "SD_LOG_SEGMENT_SIZE must be a whole number of 512-byte blocks"
+#endif
+#if (SD_LOG_FIRST_BLOCK % SDLOG_SEGMENT_BLOCKS) != 0
+#error "SD_LOG_FIRST_BLOCK must be on a segment boundary: every write stays aligned"
+#endif
+
+/* Below every pipeline thread and the publishers: the log takes idle time */
+#define SDLOG_THREAD_STACK_SIZE 2048
+
+#define SDLOG_INSTANCE 0U /* SDMMC2, the microSD slot */
+#define SDLOG_POLL_TICKS ((SD_LOG_POLL_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+#define SDLOG_OPEN_TICKS ((SD_READ_TIMEOUT * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+#define SDLOG_STUCK_MS 5000U /* Segment and index write never completed: the card is gone */
+#define SDLOG_MAX_FAILURES 3U /* Writes failed in a row: the card is given up */
+
+#define SDLOG_EVENT_DONE 0x01U
+#define SDLOG_EVENT_ERROR 0x02U
+
+#define SDLOG_CHECK_SEED 2166136261U /* FNV-1a offset basis */
+
+typedef struct {
+  sdlog_segment_header_t header;
+  telemetry_record_t records[SDLOG_SEGMENT_RECORDS];
+} sdlog_segment_t;
+
+_Static_assert(sizeof(sdlog_segment_t) == SD_LOG_SEGMENT_SIZE, "Segment layout");
+_Static_assert(sizeof(sdlog_index_t) <= SDLOG_BLOCK_SIZE, "Index copy overflows its block");
+
+typedef enum {
+  SDLOG_IDLE = 0,
+  SDLOG_DATA,  /* Segment write in flight */
+  SDLOG_INDEX, /* Index commit of that segment in flight */
+} sdlog_state_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[SDLOG_THREAD_STACK_SIZE];
+  TX_EVENT_FLAGS_GROUP events;
+  sdlog_index_t index;     /* Last committed, or being committed */
+  uint32_t data_block;     /* Block of segment slot 0 */
+  sdlog_state_t state;
+  uint32_t fill;           /* Segment buffer taking the records */
+  uint32_t fill_nb;
+  uint32_t fill_check;     /* Check word of its records so far */
+  uint32_t fill_since_ms;  /* Its first record copied */
+  uint32_t write_nb;       /* Records of the segment in flight */
+  uint32_t write_start_ms;
+  uint32_t failures;       /* Writes failed in a row */
+  sdlog_stats_t stats;
+} sdlog_ctx;
+
+/* Both index copies, read at once when the log is opened; copy 0 carries
+ * the commits. IDMA-read, CPU-written once per segment */
+static uint8_t sdlog_index_block[2][SDLOG_BLOCK_SIZE] __attribute__((section(".noncacheable"), aligned(32)));
+
+static uint32_t SdLog_Check(uint32_t hash, const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+static int SdLog_WaitReady(void) {
+  uint32_t start = HAL_GetTick();
+
+  /* Programming of the previous write: CMD13 until the card is back in
+   * transfer state */
+  while (BSP_SD_GetCardState(SDLOG_INSTANCE) != SD_TRANSFER_OK) {
+    if (HAL_GetTick() - start >= SD_WRITE_TIMEOUT) {
+      return 0;
+    }
+    tx_thread_sleep(1);
+  }
+  return 1;
+}
+
+static int SdLog_StartWrite(const void *data, uint32_t block, uint32_t nb) {
+  return SdLog_WaitReady() &&
+         BSP_SD_WriteBlocks_DMA(SDLOG_INSTANCE, (uint32_t *)data, block, nb) == BSP_ERROR_NONE;
+}
+
+/**
+ * @brief  Wait for the transfer in flight, for the log opening only
+ */
+static int SdLog_WaitTransfer(void) {
+  ULONG flags = 0;
+
+  if (tx_event_flags_get(&sdlog_ctx.events, SDLOG_EVENT_DONE | SDLOG_EVENT_ERROR, TX_OR_CLEAR, &flags,
+                         SDLOG_OPEN_TICKS) != TX_SUCCESS) {
+    return 0;
+  }
+  return (flags & SDLOG_EVENT_ERROR) == 0U;
+}
+
+/**
+ * @brief  Start the commit of the next index generation, in the copy that
+ *         does not hold the last committed one
+ */
+static int SdLog_CommitIndex(void) {
+  sdlog_index_t *index = &sdlog_ctx.index;
+
+  index->generation++;
+  index->check = SdLog_Check(SDLOG_CHECK_SEED, index, offsetof(sdlog_index_t, check));
+  memset(sdlog_index_block[0], 0, SDLOG_BLOCK_SIZE);
+  memcpy(sdlog_index_block[0], index, sizeof(*index));
+
+  return SdLog_StartWrite(sdlog_index_block[0], index->first_block + (index->generation % 2U), 1);
+}
+
+static int SdLog_IndexValid(const sdlog_index_t *index, uint32_t capacity) {
+  return index->magic == SDLOG_INDEX_MAGIC && index->version == SDLOG_VERSION &&
+         index->check == SdLog_Check(SDLOG_CHECK_SEED, index, offsetof(sdlog_index_t, check)) &&
+         index->segment_blocks == SDLOG_SEGMENT_BLOCKS && index->first_block == SD_LOG_FIRST_BLOCK &&
+         index->capacity == capacity;
+}
+
+/**
+ * @brief  Open the card and its log, resume after the last committed
+ *         segment and commit this boot
+ * @retval 1 when logging, 0 when the card cannot be used
+ */
+static int SdLog_Open(void) {
+  BSP_SD_CardInfo info;
+  sdlog_index_t copy[2];
+  uint32_t capacity;
+  int valid[2];
+
+  if (BSP_SD_Init(SDLOG_INSTANCE) != BSP_ERROR_NONE) {
+    printf("sdlog: no card, logger off\r\n");
+    return 0;
+  }
+  APP_REQUIRE_EQ(BSP_SD_GetCardInfo(SDLOG_INSTANCE, &info), BSP_ERROR_NONE);
+  if (info.LogBlockSize != SDLOG_BLOCK_SIZE || info.LogBlockNbr < SD_LOG_FIRST_BLOCK + 2U * SDLOG_SEGMENT_BLOCKS) {
+    printf("sdlog: card of %lu blocks of %lu bytes unusable, logger off\r\n", (unsigned long)info.LogBlockNbr,
+           (unsigned long)info.LogBlockSize);
+    return 0;
+  }
+  /* The first segment slot holds the index */
+  capacity = (info.LogBlockNbr - SD_LOG_FIRST_BLOCK) / SDLOG_SEGMENT_BLOCKS - 1U;
+  sdlog_ctx.data_block = SD_LOG_FIRST_BLOCK + SDLOG_SEGMENT_BLOCKS;
+
+  if (!SdLog_WaitReady() ||
+      BSP_SD_ReadBlocks_DMA(SDLOG_INSTANCE, (uint32_t *)sdlog_index_block, SD_LOG_FIRST_BLOCK, 2) != BSP_ERROR_NONE ||
+      !SdLog_WaitTransfer()) {
+    printf("sdlog: index read failed, logger off\r\n");
+    return 0;
+  }
+  for (uint32_t i = 0; i < 2U; i++) {
+    memcpy(&copy[i], sdlog_index_block[i], sizeof(copy[i]));
+    valid[i] = SdLog_IndexValid(&copy[i], capacity);
+  }
+
+  /* A copy torn by a reset fails its check: the other is the log */
+  if (valid[0] && (!valid[1] || (int32_t)(copy[0].generation - copy[1].generation) > 0)) {
+    sdlog_ctx.index = copy[0];
+  } else if (valid[1]) {
+    sdlog_ctx.index = copy[1];
+  } else {
+    sdlog_ctx.index = (sdlog_index_t){
+        .magic = SDLOG_INDEX_MAGIC,
+        .version = SDLOG_VERSION,
+        .segment_blocks = SDLOG_SEGMENT_BLOCKS,
+        .capacity = capacity,
+        .first_block = SD_LOG_FIRST_BLOCK,
+    };
+  }
+
+  sdlog_ctx.index.boots++;
+  if (!SdLog_CommitIndex() || !SdLog_WaitTransfer()) {
+    printf("sdlog: index write failed, logger off\r\n");
+    return 0;
+  }
+  printf("sdlog: %lu of %lu segments of %u KB logged, boot %lu\r\n", (unsigned long)sdlog_ctx.index.segments,
+         (unsigned long)capacity, (unsigned)(SD_LOG_SEGMENT_SIZE / 1024U), (unsigned long)sdlog_ctx.index.boots);
+  return 1;
+}
+
+static void SdLog_Fail(void) {
+  sdlog_ctx.stats.errors++;
+  sdlog_ctx.failures++;
+  /* A failed commit leaves its copy torn: the next one rewrites that copy,
+   * never the one still holding the last committed generation */
+  if (sdlog_ctx.state == SDLOG_INDEX) {
+    sdlog_ctx.index.generation--;
+  }
+  sdlog_ctx.state = SDLOG_IDLE;
+}
+
+/**
+ * @brief  Advance the write in flight: segment written, commit it; commit
+ *         written, the segment buffer is free
+ */
+static void SdLog_Complete(ULONG flags) {
+  if ((flags & SDLOG_EVENT_ERROR) != 0U) {
+    SdLog_Fail();
+    return;
+  }
+
+  if (sdlog_ctx.state == SDLOG_DATA) {
+    sdlog_ctx.index.segments++;
+    sdlog_ctx.state = SDLOG_INDEX;
+    if (!SdLog_CommitIndex()) {
+      SdLog_Fail();
+    }
+  } else if (sdlog_ctx.state == SDLOG_INDEX) {
+    uint32_t elapsed = HAL_GetTick() - sdlog_ctx.write_start_ms;
+
+    sdlog_ctx.stats.segments++;
+    sdlog_ctx.stats.records += sdlog_ctx.write_nb;
+    if (sdlog_ctx.write_nb < SDLOG_SEGMENT_RECORDS) {
+      sdlog_ctx.stats.partial++;
+    }
+    sdlog_ctx.stats.max_write_ms = MAX(sdlog_ctx.stats.max_write_ms, elapsed);
+    sdlog_ctx.failures = 0;
+    sdlog_ctx.state = SDLOG_IDLE;
+  }
+}
+
+/**
+ * @brief  Copy whatever the ring holds into the segment being filled
+ */
+static void SdLog_Fill(void) {
+  sdlog_segment_t *seg = (sdlog_segment_t *)sdlog_segment_buffers[sdlog_ctx.fill];
+
+  while (sdlog_ctx.fill_nb < SDLOG_SEGMENT_RECORDS) {
+    const telemetry_record_t *records;
+    uint32_t nb = Telemetry_ReaderAcquire(TELEMETRY_READER_SD, &records, SDLOG_SEGMENT_RECORDS - sdlog_ctx.fill_nb);
+
+    if (nb == 0) {
+      break;
+    }
+    if (sdlog_ctx.fill_nb == 0) {
+      sdlog_ctx.fill_since_ms = HAL_GetTick();
+      sdlog_ctx.fill_check = SDLOG_CHECK_SEED;
+    }
+    memcpy(&seg->records[sdlog_ctx.fill_nb], records, nb * sizeof(*records));
+    sdlog_ctx.fill_check = SdLog_Check(sdlog_ctx.fill_check, records, nb * sizeof(*records));
+    Telemetry_ReaderRelease(TELEMETRY_READER_SD, nb);
+    sdlog_ctx.fill_nb += nb;
+  }
+}
+
+/**
+ * @brief  Close the segment being filled and start its write; the records
+ *         go to the other buffer meanwhile
+ */
+static void SdLog_Seal(void) {
+  sdlog_segment_t *seg = (sdlog_segment_t *)sdlog_segment_buffers[sdlog_ctx.fill];
+  uint32_t seq = sdlog_ctx.index.segments;
+  uint32_t nb = sdlog_ctx.fill_nb;
+
+  /* No stale records of two segments ago past the count */
+  memset(&seg->records[nb], 0, (SDLOG_SEGMENT_RECORDS - nb) * sizeof(telemetry_record_t));
+  seg->header = (sdlog_segment_header_t){
+      .magic = SDLOG_SEGMENT_MAGIC,
+      .seq = seq,
+      .boot = sdlog_ctx.index.boots,
+      .uptime_ms = HAL_GetTick(),
+      .nb = (uint16_t)nb,
+      .version = SDLOG_VERSION,
+      .check = sdlog_ctx.fill_check,
+  };
+
+  sdlog_ctx.write_nb = nb;
+  sdlog_ctx.write_start_ms = HAL_GetTick();
+  sdlog_ctx.fill ^= 1U;
+  sdlog_ctx.fill_nb = 0;
+  sdlog_ctx.state = SDLOG_DATA;
+  if (!SdLog_StartWrite(seg, sdlog_ctx.data_block + (seq % sdlog_ctx.index.capacity) * SDLOG_SEGMENT_BLOCKS,
+                        SDLOG_SEGMENT_BLOCKS)) {
+    SdLog_Fail();
+  }
+}
+
+static void SdLog_Stop(const char *reason) {
+  Telemetry_ReaderAttach(TELEMETRY_READER_SD, 0);
+  printf("sdlog: %s, logger off\r\n", reason);
+}
+
+static void sdlog_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  if (!SdLog_Open()) {
+    return;
+  }
+  Telemetry_ReaderAttach(TELEMETRY_READER_SD, 1);
+
+  for (;;) {
+    ULONG flags = 0;
+    uint32_t now;
+
+    (void)tx_event_flags_get(&sdlog_ctx.events, SDLOG_EVENT_DONE | SDLOG_EVENT_ERROR, TX_OR_CLEAR, &flags,
+                             SDLOG_POLL_TICKS);
+    if (flags != 0U) {
+      SdLog_Complete(flags);
+    }
+
+    /* A card gone or failing must not hold the ring the other readers share */
+    now = HAL_GetTick();
+    if (sdlog_ctx.state != SDLOG_IDLE && now - sdlog_ctx.write_start_ms >= SDLOG_STUCK_MS) {
+      SdLog_Stop("write stuck");
+      return;
+    }
+    if (sdlog_ctx.failures >= SDLOG_MAX_FAILURES) {
+      SdLog_Stop("card failing");
+      return;
+    }
+
+    SdLog_Fill();
+    if (sdlog_ctx.state == SDLOG_IDLE && sdlog_ctx.fill_nb > 0 &&
+        (sdlog_ctx.fill_nb == SDLOG_SEGMENT_RECORDS || now - sdlog_ctx.fill_since_ms >= SD_LOG_COMMIT_MS)) {
+      SdLog_Seal();
+    }
+  }
+}
+
+void Thread_SdLog_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&sdlog_ctx.events, "sdlog"), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_thread_create(&sdlog_ctx.thread, "sdlog",
+                                  sdlog_thread_entry, 0,
+                                  sdlog_ctx.stack, SDLOG_THREAD_STACK_SIZE,
+                                  SDLOG_THREAD_PRIORITY, SDLOG_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+void SdLog_GetStats(sdlog_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = sdlog_ctx.stats;
+}
+
+void SdLog_IRQHandler(void) {
+  BSP_SD_IRQHandler(SDLOG_INSTANCE);
+}
+
+/* BSP completion callbacks (HAL_SD_TxCpltCallback and HAL_SD_RxCpltCallback
+ * in stm32n6570_discovery_sd.c) */
+void BSP_SD_WriteCpltCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&sdlog_ctx.events, SDLOG_EVENT_DONE, TX_OR);
+}
+
+void BSP_SD_ReadCpltCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&sdlog_ctx.events, SDLOG_EVENT_DONE, TX_OR);
+}
+
+void BSP_SD_AbortCallback(uint32_t Instance) {
+  UNUSED(Instance);
+  tx_event_flags_set(&sdlog_ctx.events, SDLOG_EVENT_ERROR, TX_OR);
+}
+
+void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd) {
+  UNUSED(hsd);
+  tx_event_flags_set(&sdlog_ctx.events, SDLOG_EVENT_ERROR, TX_OR);
+}
+
+#endif /* SD_LOG */
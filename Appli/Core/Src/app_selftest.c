@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * @file    app_selftest.c
+ * @author  Long Liangmao
+ * @brief   Golden-vector boot self-test for STM32N6570-DK (SELFTEST_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_selftest.h"
+
+#if SELFTEST_ENABLE
+
+#include "app_slots.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SELFTEST_CHECK_SEED 2166136261U /* FNV-1a offset basis */
+
+#if SELFTEST_IOU_MIN_PCT < 1 || SELFTEST_IOU_MIN_PCT > 100 || SELFTEST_CONF_TOLERANCE_PCT < 0
+#error "SELFTEST_IOU_MIN_PCT from 1 to 100, SELFTEST_CONF_TOLERANCE_PCT not negative"
+#endif
+
+_Static_assert(sizeof(selftest_detection_t) == 24U, "Vector layout is shared with selftest.ps1");
+_Static_assert(sizeof(selftest_vector_t) == 136U, "Vector layout is shared with selftest.ps1");
+
+/* Written once by NN_Init(), read by the UI */
+static volatile selftest_verdict_t selftest_verdict = SELFTEST_NOT_RUN;
+
+static uint32_t SelfTest_Hash(const uint8_t *data, uint32_t len) {
+  uint32_t hash = SELFTEST_CHECK_SEED;
+
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+static const selftest_vector_t *SelfTest_GetVector(void) {
+  return (const selftest_vector_t *)SELFTEST_FLASH_ADDR;
+}
+
+/**
+ * @brief  Give up on the vector: the verdict says why there is none
+ */
+static const uint8_t *SelfTest_Reject(const char *reason) {
+  printf("selftest: no vector (%s)\r\n", reason);
+  selftest_verdict = SELFTEST_NO_VECTOR;
+  return NULL;
+}
+
+const uint8_t *SelfTest_GetInput(uint32_t in_len) {
+  const selftest_vector_t *vec = SelfTest_GetVector();
+  const uint8_t *input;
+  slots_info_t slots;
+
+  if (vec->magic != SELFTEST_MAGIC ||
+      vec->check != SelfTest_Hash((const uint8_t *)vec, offsetof(selftest_vector_t, check))) {
+    return SelfTest_Reject("not flashed or damaged header");
+  }
+  if (vec->input_size != in_len || vec->input_offset < sizeof(*vec) ||
+      vec->input_offset > SELFTEST_FLASH_SIZE - vec->input_size) {
+    return SelfTest_Reject("input size differs from the network's");
+  }
+  Slots_GetInfo(&slots);
+  if (vec->model_version != 0U && vec->model_version != slots.model_version) {
+    return SelfTest_Reject("recorded on another model version");
+  }
+
+  input = (const uint8_t *)SELFTEST_FLASH_ADDR + vec->input_offset;
+  if (SelfTest_Hash(input, vec->input_size) != vec->input_check) {
+    return SelfTest_Reject("damaged input");
+  }
+  return input;
+}
+
+/**
+ * @brief  Intersection over union of a detection and its golden box
+ */
+static float SelfTest_Iou(const od_pp_outBuffer_t *det, const selftest_detection_t *ref) {
+  float x0 = MAX(det->x_center - det->width / 2.0f, ref->x_center - ref->width / 2.0f);
+  float y0 = MAX(det->y_center - det->height / 2.0f, ref->y_center - ref->height / 2.0f);
+  float x1 = MIN(det->x_center + det->width / 2.0f, ref->x_center + ref->width / 2.0f);
+  float y1 = MIN(det->y_center + det->height / 2.0f, ref->y_center + ref->height / 2.0f);
+  float inter = MAX(x1 - x0, 0.0f) * MAX(y1 - y0, 0.0f);
+  float uni = det->width * det->height + ref->width * ref->height - inter;
+
+  return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+/**
+ * @brief  Every golden box has a detection of its class at its place and
+ *         confidence, and the count matches
+ */
+static int SelfTest_DetectionsMatch(const selftest_vector_t *vec, const od_pp_outBuffer_t *dets, uint32_t nb) {
+  if (nb != vec->nb_detect) {
+    return 0;
+  }
+
+  for (uint32_t g = 0; g < MIN(vec->nb_detect, SELFTEST_TOP_NB); g++) {
+    const selftest_detection_t *ref = &vec->top[g];
+    int found = 0;
+
+    /* Any order: NMS may reorder equal scores */
+    for (uint32_t i = 0; i < nb && !found; i++) {
+      float dconf = dets[i].conf - ref->conf;
+
+      found = dets[i].class_index == ref->class_index &&
+              SelfTest_Iou(&dets[i], ref) >= SELFTEST_IOU_MIN_PCT / 100.0f &&
+              dconf <= SELFTEST_CONF_TOLERANCE_PCT / 100.0f && dconf >= -SELFTEST_CONF_TOLERANCE_PCT / 100.0f;
+    }
+    if (!found) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief  Print the run as selftest.ps1 -Record takes it; floats as their bits
+ */
+static void SelfTest_PrintRecord(uint32_t output_check, const od_pp_outBuffer_t *dets, uint32_t nb,
+                                 uint32_t inference_us) {
+  printf("selftest: record check=0x%08lX us=%lu nb=%lu", (unsigned long)output_check, (unsigned long)inference_us,
+         (unsigned long)nb);
+  for (uint32_t i = 0; i < MIN(nb, SELFTEST_TOP_NB); i++) {
+    uint32_t bits[5];
+
+    memcpy(&bits[0], &dets[i].x_center, sizeof(bits[0]));
+    memcpy(&bits[1], &dets[i].y_center, sizeof(bits[1]));
+    memcpy(&bits[2], &dets[i].width, sizeof(bits[2]));
+    memcpy(&bits[3], &dets[i].height, sizeof(bits[3]));
+    memcpy(&bits[4], &dets[i].conf, sizeof(bits[4]));
+    printf(" det=%ld:%08lX,%08lX,%08lX,%08lX,%08lX", (long)dets[i].class_index, (unsigned long)bits[0],
+           (unsigned long)bits[1], (unsigned long)bits[2], (unsigned long)bits[3], (unsigned long)bits[4]);
+  }
+  printf("\r\n");
+}
+
+void SelfTest_Check(uint32_t output_check, const od_pp_outBuffer_t *dets, uint32_t nb, uint32_t inference_us) {
+  const selftest_vector_t *vec = SelfTest_GetVector();
+  int exact;
+  int matched;
+  int in_budget;
+
+  if (!(vec->flags & SELFTEST_FLAG_RECORDED)) {
+    SelfTest_PrintRecord(output_check, dets, nb, inference_us);
+    selftest_verdict = SELFTEST_UNRECORDED;
+    return;
+  }
+
+  exact = output_check == vec->output_check;
+  matched = exact || SelfTest_DetectionsMatch(vec, dets, nb);
+  in_budget = inference_us <= vec->budget_us;
+  if (!matched || !in_budget) {
+    selftest_verdict = SELFTEST_FAIL;
+  } else {
+    selftest_verdict = exact ? SELFTEST_PASS : SELFTEST_DRIFT;
+  }
+
+  printf("selftest: %s outputs=%s detections=%lu/%lu%s inference=%lu/%lu us\r\n",
+         selftest_verdict == SELFTEST_PASS ? "PASS" : selftest_verdict == SELFTEST_DRIFT ? "DRIFT" : "FAIL",
+         exact ? "exact" : "changed", (unsigned long)nb, (unsigned long)vec->nb_detect,
+         matched ? "" : " mismatch", (unsigned long)inference_us, (unsigned long)vec->budget_us);
+  if (!exact) {
+    /* The values a new golden record would take, once the change is accepted */
+    SelfTest_PrintRecord(output_check, dets, nb, inference_us);
+  }
+}
+
+selftest_verdict_t SelfTest_GetVerdict(void) {
+  return selftest_verdict;
+}
+
+#endif /* SELFTEST_ENABLE */
@@ -0,0 +1,196 @@
+/**
+ ******************************************************************************
+ * @file    app_sensor_cmd.c
+ * @author  Long Liangmao
+ * @brief   Sensor command queue implementation for STM32N6570-DK
+ *
+ *          Every camera middleware register access comes through here.
+ *          Between SensorCmd_Begin() and SensorCmd_Submit() the writes of
+ *          the opening thread are copied into the queue; the submit sends
+ *          them one memory write after the other from the I2C completion
+ *          interrupt, and the last one gives the bus back. Accesses from any
+ *          other thread, or outside a batch, stay blocking once the bus is
+ *          free. Reads inside a batch go out at once: the bus is idle until
+ *          the submit, and they see none of the queued writes.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_sensor_cmd.h"
+
+#if SENSOR_CMD_ENABLE
+
+#include "app_error.h"
+#include "cmw_camera.h"
+#include "stm32n6570_discovery_bus.h"
+#include "tx_api.h"
+#include <string.h>
+
+#if !ISP_SPLIT_APPLY
+#error "SENSOR_CMD_ENABLE batches the writes of the ISP apply thread (ISP_SPLIT_APPLY)"
+#endif
+#ifdef STM32N6570_NUCLEO_REV
+#error "SENSOR_CMD_ENABLE drives the discovery board camera bus (I2C1)"
+#endif
+
+#define SENSOR_CMD_DATA_MAX 4U /* Bytes per register write: the IMX335 shutter takes 3 */
+
+typedef struct {
+  uint16_t addr;
+  uint16_t reg;
+  uint16_t len;
+  uint8_t data[SENSOR_CMD_DATA_MAX];
+} sensor_cmd_t;
+
+static struct {
+  sensor_cmd_t queue[SENSOR_CMD_QUEUE_LEN];
+  uint32_t nb;            /* Commands in the batch */
+  volatile uint32_t next; /* Command on the bus (ISR) */
+  TX_THREAD *owner;       /* Thread filling the batch, NULL when none is open */
+  TX_SEMAPHORE bus_sem;   /* 1 while no batch is open or in flight */
+  volatile uint8_t failed;
+} cmd_ctx;
+
+static HAL_StatusTypeDef SensorCmd_Send(uint32_t i) {
+  sensor_cmd_t *cmd = &cmd_ctx.queue[i];
+
+  return HAL_I2C_Mem_Write_IT(&hbus_i2c1, cmd->addr, cmd->reg, I2C_MEMADD_SIZE_16BIT, cmd->data, cmd->len);
+}
+
+static int SensorCmd_IsOwner(void) {
+  return cmd_ctx.owner != NULL && cmd_ctx.owner == tx_thread_identify();
+}
+
+static int32_t SensorCmd_ReadReg(uint16_t addr, uint16_t reg, uint8_t *data, uint16_t len) {
+  int32_t ret;
+
+  if (SensorCmd_IsOwner()) {
+    return BSP_I2C1_ReadReg16(addr, reg, data, len);
+  }
+
+  APP_REQUIRE_EQ(tx_semaphore_get(&cmd_ctx.bus_sem, TX_WAIT_FOREVER), TX_SUCCESS);
+  ret = BSP_I2C1_ReadReg16(addr, reg, data, len);
+  APP_REQUIRE_EQ(tx_semaphore_put(&cmd_ctx.bus_sem), TX_SUCCESS);
+  return ret;
+}
+
+static int32_t SensorCmd_WriteReg(uint16_t addr, uint16_t reg, uint8_t *data, uint16_t len) {
+  int32_t ret;
+
+  if (SensorCmd_IsOwner()) {
+    sensor_cmd_t *cmd;
+
+    APP_REQUIRE(cmd_ctx.nb < SENSOR_CMD_QUEUE_LEN && len <= SENSOR_CMD_DATA_MAX);
+    cmd = &cmd_ctx.queue[cmd_ctx.nb++];
+    cmd->addr = addr;
+    cmd->reg = reg;
+    cmd->len = len;
+    memcpy(cmd->data, data, len);
+    return BSP_ERROR_NONE;
+  }
+
+  APP_REQUIRE_EQ(tx_semaphore_get(&cmd_ctx.bus_sem, TX_WAIT_FOREVER), TX_SUCCESS);
+  ret = BSP_I2C1_WriteReg16(addr, reg, data, len);
+  APP_REQUIRE_EQ(tx_semaphore_put(&cmd_ctx.bus_sem), TX_SUCCESS);
+  return ret;
+}
+
+/**
+ * @brief  Route the camera register accesses through the queue
+ */
+void SensorCmd_Init(void) {
+  APP_REQUIRE_EQ(tx_semaphore_create(&cmd_ctx.bus_sem, "sensor_cmd", 1), TX_SUCCESS);
+  APP_REQUIRE_EQ(CMW_CAMERA_SetRegisterIO(SensorCmd_ReadReg, SensorCmd_WriteReg), CMW_ERROR_NONE);
+
+  HAL_NVIC_SetPriority(I2C1_EV_IRQn, SENSOR_CMD_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+  HAL_NVIC_SetPriority(I2C1_ER_IRQn, SENSOR_CMD_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+}
+
+/**
+ * @brief  Open a batch for the calling thread
+ */
+void SensorCmd_Begin(void) {
+  APP_REQUIRE(!SensorCmd_IsOwner());
+  APP_REQUIRE_EQ(tx_semaphore_get(&cmd_ctx.bus_sem, TX_WAIT_FOREVER), TX_SUCCESS);
+  APP_REQUIRE(!cmd_ctx.failed);
+
+  cmd_ctx.nb = 0;
+  cmd_ctx.owner = tx_thread_identify();
+}
+
+/**
+ * @brief  Send the batch by interrupts
+ */
+void SensorCmd_Submit(void) {
+  APP_REQUIRE(SensorCmd_IsOwner());
+  cmd_ctx.owner = NULL;
+
+  if (cmd_ctx.nb == 0U) {
+    APP_REQUIRE_EQ(tx_semaphore_put(&cmd_ctx.bus_sem), TX_SUCCESS);
+    return;
+  }
+
+  cmd_ctx.next = 0;
+  if (SensorCmd_Send(0) != HAL_OK) {
+    cmd_ctx.failed = 1;
+    APP_REQUIRE_EQ(tx_semaphore_put(&cmd_ctx.bus_sem), TX_SUCCESS);
+  }
+}
+
+/**
+ * @brief  A write of the batch is on the sensor: the next one, or the bus back
+ */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  uint32_t next;
+
+  if (hi2c != &hbus_i2c1) {
+    return;
+  }
+
+  next = cmd_ctx.next + 1U;
+  cmd_ctx.next = next;
+  if (next < cmd_ctx.nb) {
+    if (SensorCmd_Send(next) == HAL_OK) {
+      return;
+    }
+    cmd_ctx.failed = 1;
+  }
+  tx_semaphore_put(&cmd_ctx.bus_sem);
+}
+
+/**
+ * @brief  Bus error or NACK: the rest of the batch is dropped, the next
+ *         SensorCmd_Begin() panics
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+  if (hi2c != &hbus_i2c1) {
+    return;
+  }
+
+  cmd_ctx.failed = 1;
+  tx_semaphore_put(&cmd_ctx.bus_sem);
+}
+
+/**
+ * @brief  Camera I2C interrupt handlers
+ */
+void SensorCmd_EvIRQHandler(void) {
+  HAL_I2C_EV_IRQHandler(&hbus_i2c1);
+}
+
+void SensorCmd_ErIRQHandler(void) {
+  HAL_I2C_ER_IRQHandler(&hbus_i2c1);
+}
+
+#endif /* SENSOR_CMD_ENABLE */
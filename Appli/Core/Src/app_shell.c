@@ -0,0 +1,425 @@
+/**
+ ******************************************************************************
+ * @file    app_shell.c
+ * @author  Long Liangmao
+ * @brief   Console shell for STM32N6570-DK (SHELL_ENABLE)
+ *
+ *          Lines arrive byte by byte in the telemetry command context and
+ *          wait in an SPSC ring. Each command is a row printer: the thread
+ *          wakes every SHELL_PERIOD_MS, starts at most one command and
+ *          prints at most SHELL_LINES_PER_WAKE of its rows, so a long
+ *          answer is spread over many periods.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_shell.h"
+
+#if SHELL_ENABLE
+
+#include "app_error.h"
+#include "app_nn.h"
+#include "app_params.h"
+#include "app_profile.h"
+#include "app_profiler.h"
+#include "app_spsc.h"
+#include "app_time.h"
+#include "app_ui.h"
+#include "stm32n6xx_hal.h"
+#include "tx_block_pool.h"
+#include "tx_byte_pool.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !TELEMETRY
+#error "SHELL_ENABLE reads its lines from and prints over telemetry: it needs TELEMETRY"
+#endif
+#if SHELL_LINES_PER_WAKE < 1 || SHELL_PERIOD_MS < 1
+#error "SHELL_LINES_PER_WAKE and SHELL_PERIOD_MS must be at least 1"
+#endif
+
+#define SHELL_THREAD_STACK_SIZE 2048
+
+#define SHELL_COMMAND_NB (sizeof(shell_commands) / sizeof(shell_commands[0]))
+
+#define SHELL_PERIOD_TICKS ((SHELL_PERIOD_MS * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+/* Prints one row of the command in progress
+ * @retval 1 when printed, 0 past the last row (nothing printed) */
+typedef int (*shell_row_t)(uint32_t row);
+
+typedef struct {
+  const char *name;
+  const char *help;
+  shell_row_t start; /* Parses the arguments, then prints row 0 onward */
+} shell_command_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[SHELL_THREAD_STACK_SIZE];
+
+  /* Command context */
+  char line[SHELL_LINE_MAX];
+  uint32_t len;
+  uint8_t overflow; /* The line outgrew SHELL_LINE_MAX: dropped at its end */
+  spsc_t queue;
+  char queued[SHELL_QUEUE_LINES][SHELL_LINE_MAX];
+  uint32_t dropped; /* Lines lost to a full queue or their length */
+
+  /* Shell thread */
+  char args[SHELL_LINE_MAX]; /* Arguments of the command in progress */
+  shell_row_t row_fn;
+  uint32_t row;
+  uint64_t stats_us;      /* Time and idle time at the previous stats */
+  uint64_t stats_idle_us;
+#if NN_EPOCH_PROFILER
+  profiler_epoch_stat_t epochs[SHELL_EPOCHS_TOP];
+  uint32_t nb_epochs;
+#endif
+} shell_ctx;
+
+/* Fixed point for the console: printf() has no floats */
+static void Shell_Fixed(char *buf, uint32_t size, float x, uint32_t decimals) {
+  uint32_t scale = 1;
+  uint32_t v;
+
+  for (uint32_t i = 0; i < decimals; i++) {
+    scale *= 10U;
+  }
+  v = (uint32_t)((x < 0.0f ? -x : x) * (float)scale + 0.5f);
+  snprintf(buf, size, "%s%lu.%0*lu", x < 0.0f ? "-" : "", (unsigned long)(v / scale), (int)decimals,
+           (unsigned long)(v % scale));
+}
+
+int Shell_Receive(uint8_t byte) {
+  if (byte == '\r' || byte == '\n') {
+    if (shell_ctx.overflow) {
+      shell_ctx.dropped++;
+    } else if (shell_ctx.len > 0U) {
+      shell_ctx.line[shell_ctx.len] = '\0';
+      if (!SPSC_Push(&shell_ctx.queue, shell_ctx.line)) {
+        shell_ctx.dropped++;
+      }
+    }
+    shell_ctx.len = 0;
+    shell_ctx.overflow = 0;
+    return 0;
+  }
+
+  if (shell_ctx.len < SHELL_LINE_MAX - 1U) {
+    shell_ctx.line[shell_ctx.len++] = (char)byte;
+  } else {
+    shell_ctx.overflow = 1;
+  }
+  return 1;
+}
+
+/**
+ * @brief  stats: rates and times of the last result, CPU load since the previous stats
+ */
+static int Shell_Stats(uint32_t row) {
+  const nn_result_t *result;
+  uint64_t now_us;
+  uint64_t idle_us;
+  uint32_t load_permille = 0;
+  uint32_t fps_tenths;
+
+  if (row > 0U) {
+    return 0;
+  }
+
+  now_us = Time_GetUs();
+  idle_us = UI_CPULoad_GetIdleUs();
+  if (now_us > shell_ctx.stats_us) {
+    uint64_t busy_us = (now_us - shell_ctx.stats_us) - MIN(idle_us - shell_ctx.stats_idle_us, now_us - shell_ctx.stats_us);
+
+    load_permille = (uint32_t)(busy_us * 1000U / (now_us - shell_ctx.stats_us));
+  }
+
+  result = NN_AcquireResult();
+  fps_tenths = result->frame_period_us ? 10000000U / result->frame_period_us : 0U;
+  printf("stats: %lu.%lu fps, inference %lu us, postprocess %lu us, %lu detections, frames %lu, cpu %lu.%lu%% over %lu ms\r\n",
+         (unsigned long)(fps_tenths / 10U), (unsigned long)(fps_tenths % 10U), (unsigned long)result->inference_us,
+         (unsigned long)result->postprocess_us, (unsigned long)result->nb_detect, (unsigned long)result->frame_count,
+         (unsigned long)(load_permille / 10U), (unsigned long)(load_permille % 10U),
+         (unsigned long)((now_us - shell_ctx.stats_us) / 1000U));
+  NN_ReleaseResult(result);
+
+  shell_ctx.stats_us = now_us;
+  shell_ctx.stats_idle_us = idle_us;
+  return 1;
+}
+
+/**
+ * @brief  epochs: slowest epochs of the last profiler window, taken at row 0
+ */
+static int Shell_Epochs(uint32_t row) {
+#if NN_EPOCH_PROFILER
+  const profiler_epoch_stat_t *e;
+
+  if (row == 0U) {
+    shell_ctx.nb_epochs = Profiler_GetSlowest(shell_ctx.epochs, SHELL_EPOCHS_TOP);
+    printf("epochs: %lu slowest of the last %u-frame window\r\n", (unsigned long)shell_ctx.nb_epochs,
+           PROFILER_WINDOW_FRAMES);
+    return 1;
+  }
+  if (row > shell_ctx.nb_epochs) {
+    return 0;
+  }
+  e = &shell_ctx.epochs[row - 1U];
+  printf("  epoch %3d %c avg %6lu us min %6lu max %6lu read miss %u.%u%%\r\n", e->epoch, e->kind,
+         (unsigned long)e->avg_us, (unsigned long)e->min_us, (unsigned long)e->max_us,
+         e->read_miss_permille / 10U, e->read_miss_permille % 10U);
+  return 1;
+#else
+  if (row > 0U) {
+    return 0;
+  }
+  printf("epochs: built without NN_EPOCH_PROFILER\r\n");
+  return 1;
+#endif
+}
+
+/**
+ * @brief  mem: the ThreadX byte pools, then the block pools
+ */
+static int Shell_Mem(uint32_t row) {
+  TX_INTERRUPT_SAVE_AREA
+  uint32_t nb_byte;
+
+  TX_DISABLE
+  nb_byte = _tx_byte_pool_created_count;
+  if (row < nb_byte) {
+    TX_BYTE_POOL *pool = _tx_byte_pool_created_ptr;
+    uint32_t size, available, fragments;
+    const char *name;
+
+    for (uint32_t i = 0; i < row; i++) {
+      pool = pool->tx_byte_pool_created_next;
+    }
+    name = pool->tx_byte_pool_name;
+    size = pool->tx_byte_pool_size;
+    available = pool->tx_byte_pool_available;
+    fragments = pool->tx_byte_pool_fragments;
+    TX_RESTORE
+    printf("mem: byte pool  %-16.16s %8lu bytes, %8lu used, %8lu free in %lu fragments\r\n", name,
+           (unsigned long)size, (unsigned long)(size - available), (unsigned long)available, (unsigned long)fragments);
+    return 1;
+  }
+  if (row < nb_byte + _tx_block_pool_created_count) {
+    TX_BLOCK_POOL *pool = _tx_block_pool_created_ptr;
+    uint32_t total, available, block_size;
+    const char *name;
+
+    for (uint32_t i = nb_byte; i < row; i++) {
+      pool = pool->tx_block_pool_created_next;
+    }
+    name = pool->tx_block_pool_name;
+    total = pool->tx_block_pool_total;
+    available = pool->tx_block_pool_available;
+    block_size = pool->tx_block_pool_block_size;
+    TX_RESTORE
+    printf("mem: block pool %-16.16s %8lu-byte blocks, %lu of %lu in use\r\n", name, (unsigned long)block_size,
+           (unsigned long)(total - available), (unsigned long)total);
+    return 1;
+  }
+  TX_RESTORE
+  return 0;
+}
+
+#if PARAMS_ENABLE
+static const struct {
+  const char *name;
+  uint8_t type;
+} shell_params[PARAM_NB] = {
+#define SHELL_PARAM(id, name, type, min, max, step, def, keep) {name, type},
+    PARAMS_TABLE(SHELL_PARAM)
+#undef SHELL_PARAM
+};
+
+static void Shell_PrintParam(uint32_t id, const char *note) {
+  char value[16];
+
+  if (shell_params[id].type == PARAM_TYPE_FLOAT) {
+    Shell_Fixed(value, sizeof(value), Params_GetFloat((param_id_t)id), 4);
+  } else {
+    snprintf(value, sizeof(value), "%ld", (long)Params_GetInt((param_id_t)id));
+  }
+  printf("set: %s = %s%s\r\n", shell_params[id].name, value, note);
+}
+
+/**
+ * @brief  Value of an argument for a parameter: a number by its type, or a
+ *         power profile name for power.profile
+ * @retval 1 when parsed
+ */
+static int Shell_ParseValue(uint32_t id, const char *text, uint32_t *value) {
+  char *end;
+
+  if (shell_params[id].type == PARAM_TYPE_FLOAT) {
+    float f = strtof(text, &end);
+
+    memcpy(value, &f, sizeof(*value));
+    return end != text && *end == '\0';
+  }
+#define SHELL_PROFILE_NAME(pid, name, point, fps, decimation, gate, ui_period_ms, qos) \
+  if (id == PARAM_POWER_PROFILE && strcmp(text, name) == 0) {                            \
+    *value = (uint32_t)PROFILE_##pid;                                                    \
+    return 1;                                                                            \
+  }
+  PROFILE_TABLE(SHELL_PROFILE_NAME)
+#undef SHELL_PROFILE_NAME
+  *value = (uint32_t)(int32_t)strtol(text, &end, 0);
+  return end != text && *end == '\0';
+}
+
+/**
+ * @brief  set: every parameter, or set one by name and read it back
+ */
+static int Shell_Set(uint32_t row) {
+  char *name = strtok(shell_ctx.args, " ");
+  char *text = strtok(NULL, " ");
+  uint32_t now, value;
+
+  if (name == NULL) {
+    if (row >= PARAM_NB) {
+      return 0;
+    }
+    Shell_PrintParam(row, "");
+    return 1;
+  }
+  if (row > 0U) {
+    return 0;
+  }
+
+  for (uint32_t id = 0; id < PARAM_NB; id++) {
+    if (strcmp(name, shell_params[id].name) != 0) {
+      continue;
+    }
+    if (text == NULL || !Shell_ParseValue(id, text, &value)) {
+      printf("set: %s takes a %s value\r\n", name, shell_params[id].type == PARAM_TYPE_FLOAT ? "decimal" : "integer");
+      return 1;
+    }
+    Params_Set(id, value);
+    /* Refused leaves the value as it was: read it back */
+    if (shell_params[id].type == PARAM_TYPE_FLOAT) {
+      float f = Params_GetFloat((param_id_t)id);
+
+      memcpy(&now, &f, sizeof(now));
+    } else {
+      now = (uint32_t)Params_GetInt((param_id_t)id);
+    }
+    Shell_PrintParam(id, now == value ? "" : " (refused: out of range or step)");
+    return 1;
+  }
+  printf("set: no parameter %s\r\n", name);
+  return 1;
+}
+#else
+static int Shell_Set(uint32_t row) {
+  if (row > 0U) {
+    return 0;
+  }
+  printf("set: built without PARAMS_ENABLE\r\n");
+  return 1;
+}
+#endif /* PARAMS_ENABLE */
+
+static int Shell_Help(uint32_t row);
+
+static const shell_command_t shell_commands[] = {
+    {"stats", "inference rate and times, CPU load since the previous stats", Shell_Stats},
+    {"epochs", "slowest epochs of the last profiler window", Shell_Epochs},
+    {"mem", "ThreadX byte and block pools", Shell_Mem},
+    {"set", "[name value]: list or set the runtime parameters", Shell_Set},
+    {"help", "this list", Shell_Help},
+};
+
+static int Shell_Help(uint32_t row) {
+  if (row >= SHELL_COMMAND_NB) {
+    return 0;
+  }
+  printf("  %-7s %s\r\n", shell_commands[row].name, shell_commands[row].help);
+  return 1;
+}
+
+/**
+ * @brief  Look the command up and make it the one in progress
+ */
+static void Shell_Start(char *line) {
+  char *name = line;
+  char *args;
+
+  while (*name == ' ') {
+    name++;
+  }
+  args = strchr(name, ' ');
+  if (args != NULL) {
+    *args++ = '\0';
+  }
+  strcpy(shell_ctx.args, args != NULL ? args : "");
+
+  for (uint32_t c = 0; c < SHELL_COMMAND_NB; c++) {
+    if (strcmp(name, shell_commands[c].name) == 0) {
+      shell_ctx.row_fn = shell_commands[c].start;
+      shell_ctx.row = 0;
+      return;
+    }
+  }
+  printf("shell: unknown command '%s', try help\r\n", name);
+}
+
+static void shell_thread_entry(ULONG arg) {
+  char line[SHELL_LINE_MAX];
+  uint32_t dropped = 0;
+  UNUSED(arg);
+
+  while (1) {
+    tx_thread_sleep(SHELL_PERIOD_TICKS);
+
+    if (shell_ctx.dropped != dropped) {
+      dropped = shell_ctx.dropped;
+      printf("shell: %lu lines dropped (queue full or longer than %lu)\r\n", (unsigned long)dropped,
+             (unsigned long)(SHELL_LINE_MAX - 1U));
+    }
+    if (shell_ctx.row_fn == NULL && SPSC_Pop(&shell_ctx.queue, line)) {
+      Shell_Start(line);
+    }
+    for (uint32_t n = 0; n < SHELL_LINES_PER_WAKE && shell_ctx.row_fn != NULL; n++) {
+      /* The row may tokenize args: it is parsed again for each row */
+      char args[SHELL_LINE_MAX];
+
+      memcpy(args, shell_ctx.args, sizeof(args));
+      if (!shell_ctx.row_fn(shell_ctx.row++)) {
+        shell_ctx.row_fn = NULL;
+      }
+      memcpy(shell_ctx.args, args, sizeof(args));
+    }
+  }
+}
+
+void Thread_Shell_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  SPSC_Init(&shell_ctx.queue, shell_ctx.queued, SHELL_LINE_MAX, SHELL_QUEUE_LINES);
+  shell_ctx.stats_us = Time_GetUs();
+  shell_ctx.stats_idle_us = UI_CPULoad_GetIdleUs();
+
+  APP_REQUIRE_EQ(tx_thread_create(&shell_ctx.thread, "shell", shell_thread_entry, 0, shell_ctx.stack,
+                                  SHELL_THREAD_STACK_SIZE, SHELL_THREAD_PRIORITY, SHELL_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+#endif /* SHELL_ENABLE */
@@ -0,0 +1,159 @@
+/**
+ ******************************************************************************
+ * @file    app_slots.c
+ * @author  Long Liangmao
+ * @brief   A/B slots for STM32N6570-DK
+ *          Slots picked by the FSBL, model slot binding of the relocatable
+ *          network and confirmation of a trial update
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_slots.h"
+#include "app_config.h"
+#include "app_error.h"
+#include "utils.h"
+#include <stdio.h>
+
+static struct {
+  slots_info_t info;
+  uint8_t confirmed;
+  /* Bound binary and its header checksum, size 0 without a header */
+  uintptr_t binary;
+  uint32_t size;
+  uint32_t checksum;
+  uint32_t verify_offset; /* Pass in progress */
+  uint32_t verify_sum;
+} slots_ctx;
+
+void Slots_Init(void) {
+  const boot_slots_table_t *table = BootSlots_GetTable();
+  uint32_t selected;
+  uint8_t table_valid = BootSlots_TableValid(table);
+
+  BootSlots_BkpEnable();
+  selected = *BootSlots_Bkp(BOOT_SLOTS_BKP_SELECTED);
+  /* Consumed: a later reset into the application without the FSBL must not
+   * see a stale pick */
+  *BootSlots_Bkp(BOOT_SLOTS_BKP_SELECTED) = 0;
+
+  if ((selected & 0xFF000000U) == BOOT_SLOTS_SELECTED_TAG) {
+    slots_ctx.info.app_slot = (uint8_t)(selected & 0xFFU) % BOOT_SLOT_NB;
+    slots_ctx.info.model_slot = (uint8_t)((selected >> 8) & 0xFFU) % BOOT_SLOT_NB;
+    slots_ctx.info.rolled_back = (selected & BOOT_SLOTS_ROLLED_BACK) != 0U;
+  } else if (table_valid) {
+    slots_ctx.info.app_slot = table->app_slot;
+    slots_ctx.info.model_slot = table->model_slot;
+  }
+
+  if (table_valid) {
+    slots_ctx.info.generation = table->generation;
+    slots_ctx.info.app_version = table->app_version[slots_ctx.info.app_slot];
+    slots_ctx.info.trial = !table->confirmed && !slots_ctx.info.rolled_back &&
+                           *BootSlots_Bkp(BOOT_SLOTS_BKP_CONFIRM) != table->generation;
+  }
+}
+
+/**
+ * @brief  Binary of a model slot, after its header and checksum
+ * @retval Address, 0 when the slot holds no valid header
+ */
+static uintptr_t Slots_ModelBinary(uint32_t slot, uint32_t *version) {
+  uintptr_t base = BOOT_SLOTS_FLASH_BASE + BOOT_SLOTS_MODEL_OFFSET(slot);
+  const boot_model_header_t *hdr = (const boot_model_header_t *)base;
+
+  if (hdr->magic != BOOT_SLOTS_MODEL_MAGIC ||
+      hdr->header_checksum != BootSlots_Sum(hdr, offsetof(boot_model_header_t, header_checksum)) ||
+      hdr->weights_offset < sizeof(*hdr) || hdr->weights_offset > BOOT_SLOTS_MODEL_SIZE ||
+      hdr->size == 0 || hdr->size > BOOT_SLOTS_MODEL_SIZE - hdr->weights_offset ||
+      hdr->checksum != BootSlots_Sum((const void *)(base + hdr->weights_offset), hdr->size)) {
+    return 0;
+  }
+  *version = hdr->version;
+  return base + hdr->weights_offset;
+}
+
+uintptr_t Slots_GetModelAddress(void) {
+  uint32_t slot = slots_ctx.info.model_slot;
+  uint32_t other = slot ^ 1U;
+  uint32_t version = 0;
+  uintptr_t binary = Slots_ModelBinary(slot, &version);
+  const boot_model_header_t *hdr;
+
+  if (binary == 0) {
+    binary = Slots_ModelBinary(other, &version);
+    if (binary != 0) {
+      slots_ctx.info.model_slot = (uint8_t)other;
+      slots_ctx.info.rolled_back = 1;
+    }
+  }
+  if (binary == 0) {
+    /* Flashed before the slotted layout: the bare binary at slot A */
+    APP_REQUIRE(slots_ctx.info.generation == 0);
+    slots_ctx.info.model_slot = BOOT_SLOT_A;
+    return BOOT_SLOTS_FLASH_BASE + BOOT_SLOTS_MODEL_OFFSET(BOOT_SLOT_A);
+  }
+
+  slots_ctx.info.model_version = version;
+  slots_ctx.binary = binary;
+  hdr = (const boot_model_header_t *)(BOOT_SLOTS_FLASH_BASE + BOOT_SLOTS_MODEL_OFFSET(slots_ctx.info.model_slot));
+  slots_ctx.size = hdr->size;
+  slots_ctx.checksum = hdr->checksum;
+  return binary;
+}
+
+void Slots_Confirm(void) {
+  if (slots_ctx.confirmed) {
+    return;
+  }
+  slots_ctx.confirmed = 1;
+
+  /* A rolled-back boot is not the trial: its generation stays unconfirmed */
+  if (slots_ctx.info.trial) {
+    *BootSlots_Bkp(BOOT_SLOTS_BKP_CONFIRM) = slots_ctx.info.generation;
+    slots_ctx.info.trial = 0;
+  }
+}
+
+int Slots_VerifyStep(void) {
+  uint32_t len = MIN(slots_ctx.size - slots_ctx.verify_offset, BACKGROUND_VERIFY_CHUNK);
+
+  if (slots_ctx.size == 0) {
+    return 0;
+  }
+  slots_ctx.verify_sum += BootSlots_Sum((const void *)(slots_ctx.binary + slots_ctx.verify_offset), len);
+  slots_ctx.verify_offset += len;
+  if (slots_ctx.verify_offset < slots_ctx.size) {
+    return 1;
+  }
+
+  /* The network runs from these bytes: a flip is reported, not repaired */
+  if (slots_ctx.verify_sum != slots_ctx.checksum) {
+    slots_ctx.info.verify_errors++;
+    printf("Slots: model slot %u binary sum 0x%08lx, header 0x%08lx\r\n", (unsigned)slots_ctx.info.model_slot,
+           (unsigned long)slots_ctx.verify_sum, (unsigned long)slots_ctx.checksum);
+  }
+  slots_ctx.info.verify_passes++;
+  slots_ctx.verify_offset = 0;
+  slots_ctx.verify_sum = 0;
+  return 0;
+}
+
+uint32_t Slots_GetModelBinary(uintptr_t *binary, uint32_t *checksum) {
+  *binary = slots_ctx.binary;
+  *checksum = slots_ctx.checksum;
+  return slots_ctx.size;
+}
+
+void Slots_GetInfo(slots_info_t *info) {
+  *info = slots_ctx.info;
+}
@@ -0,0 +1,599 @@
+/**
+ ******************************************************************************
+ * @file    app_snapshot.c
+ * @author  Long Liangmao
+ * @brief   Event-triggered JPEG snapshots for STM32N6570-DK (SNAPSHOT_ENABLE)
+ *          The snapshot thread lends the displayed Pipe1 frame, converts the
+ *          crop one 16-line MCU strip at a time while the HPDMA feeds the
+ *          previous strip to the JPEG codec and drains its output
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_snapshot.h"
+
+#if SCREENSHOT_ENABLE && !SNAPSHOT_ENABLE
+#error "SCREENSHOT_ENABLE encodes through the snapshot queue: it needs SNAPSHOT_ENABLE"
+#endif
+
+#if SNAPSHOT_ENABLE
+
+#include "app_buffers.h"
+#include "app_cam.h"
+#include "app_error.h"
+#include "app_overlay.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "app_tracker.h"
+#include "app_ui.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+
+#if !TRACKER_ENABLE
+#error "SNAPSHOT_ENABLE is triggered by the tracker: it needs TRACKER_ENABLE"
+#endif
+
+#if DISPLAY_SINGLE_PIPE
+#error "SNAPSHOT_ENABLE encodes the Pipe1 display frames: not available with DISPLAY_SINGLE_PIPE"
+#endif
+
+#if SCREENSHOT_ENABLE && !TELEMETRY
+#error "SCREENSHOT_ENABLE is requested by the host: it needs TELEMETRY"
+#endif
+
+_Static_assert(DISPLAY_LETTERBOX_WIDTH % 16 == 0 && DISPLAY_LETTERBOX_HEIGHT % 16 == 0,
+               "Letterbox frame is not a whole number of MCUs");
+#if SCREENSHOT_ENABLE
+_Static_assert(LCD_WIDTH % 16 == 0 && LCD_HEIGHT % 16 == 0, "Screen is not a whole number of MCUs");
+_Static_assert(DISPLAY_LETTERBOX_X1 == LCD_WIDTH && DISPLAY_LETTERBOX_HEIGHT == LCD_HEIGHT,
+               "Screenshot composes the camera layer out to the right and bottom edges");
+#endif
+_Static_assert(SNAPSHOT_MAX_SIZE % 4 == 0, "JPEG output DMA moves 32-bit words");
+_Static_assert(SNAPSHOT_QUALITY >= 1 && SNAPSHOT_QUALITY <= 100, "JPEG quality is 1 to 100");
+
+/* Snapshot thread: below the UI, above the ISP tuning link */
+#define SNAPSHOT_THREAD_STACK_SIZE 2048
+
+/* Two HPDMA1 channels unused by the BSP and the weight prefetch (channel 12) */
+#define SNAPSHOT_DMA_IN_CHANNEL HPDMA1_Channel10
+#define SNAPSHOT_DMA_IN_IRQn HPDMA1_Channel10_IRQn
+#define SNAPSHOT_DMA_OUT_CHANNEL HPDMA1_Channel11
+#define SNAPSHOT_DMA_OUT_IRQn HPDMA1_Channel11_IRQn
+
+/* A strip encodes in well under a ms: this means the codec hung */
+#define SNAPSHOT_TIMEOUT_TICKS ((100U * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+typedef struct {
+  uint32_t track_id;
+  uint32_t time_us;
+} snapshot_event_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[SNAPSHOT_THREAD_STACK_SIZE];
+  TX_QUEUE events;
+  ULONG events_mem[SNAPSHOT_PENDING * sizeof(snapshot_event_t) / sizeof(ULONG)];
+
+  JPEG_HandleTypeDef hjpeg;
+  DMA_HandleTypeDef hdma_in;
+  DMA_HandleTypeDef hdma_out;
+
+  /* One encode: the thread converts strips, the input DMA callback consumes
+   * them; both strip buffers start free */
+  TX_SEMAPHORE strip_sem; /* One count per free strip buffer */
+  TX_SEMAPHORE done_sem;  /* Encode complete, overflow or error */
+  uint32_t nb_strips;
+  uint32_t strip_size;
+  volatile uint32_t ready;    /* Strips converted */
+  volatile uint32_t consumed; /* Strips read by the input DMA */
+  volatile uint8_t paused;    /* Input paused waiting for a strip */
+  volatile uint8_t failed;    /* Overflow or codec error */
+  volatile uint32_t out_size;
+
+  /* Image queue: the snapshot thread fills at head, the consumer releases at tail */
+  snapshot_t images[SNAPSHOT_SLOTS];
+  uint32_t head;
+  volatile uint32_t tail;
+  TX_SEMAPHORE image_sem; /* One count per queued image */
+
+  nn_detection_t boxes[TRACKER_MAX_TRACKS];
+  uint32_t box_ids[TRACKER_MAX_TRACKS];
+  snapshot_stats_t stats;
+} snap_ctx;
+
+/**
+ * @brief  Crop around a predicted box, in letterbox pixels
+ * @note   Whole MCUs, inside the frame; the whole frame without SNAPSHOT_CROP
+ */
+static void Snapshot_CropRect(const nn_detection_t *det, int slot, snapshot_t *snap) {
+#if SNAPSHOT_CROP
+  const cam_display_map_t *map = CAM_GetSlotDisplayMap(slot);
+  float half_w = det->width * (0.5f + SNAPSHOT_MARGIN_PCT / 100.0f);
+  float half_h = det->height * (0.5f + SNAPSHOT_MARGIN_PCT / 100.0f);
+  uint32_t w = (uint32_t)MAX(CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center + half_w)) -
+                                 CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center - half_w)),
+                             0);
+  uint32_t h = (uint32_t)MAX(CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center + half_h)) -
+                                 CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center - half_h)),
+                             0);
+  int32_t x, y;
+
+  w = MIN(MAX((w + 15U) & ~15U, 16U), (uint32_t)DISPLAY_LETTERBOX_WIDTH);
+  h = MIN(MAX((h + 15U) & ~15U, 16U), (uint32_t)DISPLAY_LETTERBOX_HEIGHT);
+  x = CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center)) - (int32_t)w / 2;
+  y = CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center)) - (int32_t)h / 2;
+  x = MIN(MAX(x, 0), DISPLAY_LETTERBOX_WIDTH - (int32_t)w);
+  y = MIN(MAX(y, 0), DISPLAY_LETTERBOX_HEIGHT - (int32_t)h);
+
+  snap->x = (uint16_t)x;
+  snap->y = (uint16_t)y;
+  snap->width = (uint16_t)w;
+  snap->height = (uint16_t)h;
+#else
+  UNUSED(det);
+  UNUSED(slot);
+  snap->x = 0;
+  snap->y = 0;
+  snap->width = DISPLAY_LETTERBOX_WIDTH;
+  snap->height = DISPLAY_LETTERBOX_HEIGHT;
+#endif
+}
+
+/**
+ * @brief  Convert 16 lines of RGB565 to a row of YCbCr 4:2:0 MCUs
+ * @param  src: Top-left pixel of the strip in the frame
+ * @param  stride: Frame pixels per line
+ * @param  width: Strip width, a multiple of 16
+ * @param  dst: MCUs in codec order: Y0 Y1 Y2 Y3 Cb Cr, 8x8 bytes each
+ * @note   Full-range BT.601 (JFIF); chroma averaged over each 2x2 quad
+ */
+static void Snapshot_ConvertStrip(const uint16_t *src, uint32_t stride, uint32_t width, uint8_t *dst) {
+  for (uint32_t mx = 0; mx < width; mx += 16U, dst += SNAPSHOT_MCU_SIZE) {
+    for (uint32_t r = 0; r < 16U; r += 2U) {
+      const uint16_t *row0 = src + r * stride + mx;
+      const uint16_t *row1 = row0 + stride;
+
+      for (uint32_t c = 0; c < 16U; c += 2U) {
+        int32_t rs = 0, gs = 0, bs = 0;
+
+        for (uint32_t q = 0; q < 4U; q++) {
+          uint32_t pr = r + (q >> 1);
+          uint32_t pc = c + (q & 1U);
+          uint16_t px = ((q >> 1) ? row1 : row0)[c + (q & 1U)];
+          int32_t rr = ((px >> 11) << 3) | (px >> 13);
+          int32_t gg = (((px >> 5) & 0x3F) << 2) | ((px >> 9) & 0x03);
+          int32_t bb = ((px & 0x1F) << 3) | ((px >> 2) & 0x07);
+          uint32_t block = (pr >> 3) * 2U + (pc >> 3);
+
+          dst[block * 64U + (pr & 7U) * 8U + (pc & 7U)] = (uint8_t)((77 * rr + 150 * gg + 29 * bb + 128) >> 8);
+          rs += rr;
+          gs += gg;
+          bs += bb;
+        }
+
+        /* Sums of four pixels: one more factor of 4 in the shift */
+        dst[256U + (r >> 1) * 8U + (c >> 1)] = (uint8_t)(((-43 * rs - 85 * gs + 128 * bs + 512) >> 10) + 128);
+        dst[320U + (r >> 1) * 8U + (c >> 1)] = (uint8_t)(((128 * rs - 107 * gs - 21 * bs + 512) >> 10) + 128);
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Encode a crop of a frame into an image slot
+ * @param  frame: Letterbox frame or screenshot, RGB565
+ * @param  stride: Frame pixels per line
+ * @param  snap: Crop rectangle in, image size out
+ * @param  out: Image slot, SNAPSHOT_MAX_SIZE bytes
+ * @retval 1 when encoded, 0 on overflow, error or timeout (codec aborted)
+ */
+static int Snapshot_Encode(const uint8_t *frame, uint32_t stride, snapshot_t *snap, uint8_t *out) {
+  const uint16_t *src = (const uint16_t *)(const void *)frame + snap->y * stride + snap->x;
+  JPEG_ConfTypeDef conf;
+  uint32_t primask;
+  int ok = 1;
+
+  conf.ColorSpace = JPEG_YCBCR_COLORSPACE;
+  conf.ChromaSubsampling = JPEG_420_SUBSAMPLING;
+  conf.ImageWidth = snap->width;
+  conf.ImageHeight = snap->height;
+  conf.ImageQuality = SNAPSHOT_QUALITY;
+  APP_REQUIRE_EQ(HAL_JPEG_ConfigEncoding(&snap_ctx.hjpeg, &conf), HAL_OK);
+
+  snap_ctx.nb_strips = snap->height / 16U;
+  snap_ctx.strip_size = (snap->width / 16U) * SNAPSHOT_MCU_SIZE;
+  snap_ctx.ready = 0;
+  snap_ctx.consumed = 0;
+  snap_ctx.paused = 0;
+  snap_ctx.failed = 0;
+  snap_ctx.out_size = 0;
+  while (tx_semaphore_get(&snap_ctx.strip_sem, TX_NO_WAIT) == TX_SUCCESS) {
+  }
+  while (tx_semaphore_get(&snap_ctx.done_sem, TX_NO_WAIT) == TX_SUCCESS) {
+  }
+  APP_REQUIRE_EQ(tx_semaphore_put(&snap_ctx.strip_sem), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_semaphore_put(&snap_ctx.strip_sem), TX_SUCCESS);
+
+  for (uint32_t s = 0; s < snap_ctx.nb_strips && ok; s++) {
+    uint8_t *strip = snapshot_mcu_buffers[s & 1U];
+
+    /* The strip buffer the input DMA read two strips ago */
+    if (tx_semaphore_get(&snap_ctx.strip_sem, SNAPSHOT_TIMEOUT_TICKS) != TX_SUCCESS || snap_ctx.failed) {
+      ok = 0;
+      break;
+    }
+    Snapshot_ConvertStrip(src + s * 16U * stride, stride, snap->width, strip);
+
+    if (s == 0) {
+      snap_ctx.ready = 1;
+      if (HAL_JPEG_Encode_DMA(&snap_ctx.hjpeg, strip, snap_ctx.strip_size, out, SNAPSHOT_MAX_SIZE) != HAL_OK) {
+        ok = 0;
+      }
+      continue;
+    }
+
+    /* Against the input DMA callback deciding to pause meanwhile */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    snap_ctx.ready = s + 1U;
+    if (snap_ctx.paused) {
+      snap_ctx.paused = 0;
+      HAL_JPEG_ConfigInputBuffer(&snap_ctx.hjpeg, strip, snap_ctx.strip_size);
+      if (HAL_JPEG_Resume(&snap_ctx.hjpeg, JPEG_PAUSE_RESUME_INPUT) != HAL_OK) {
+        ok = 0;
+      }
+    }
+    __set_PRIMASK(primask);
+  }
+
+  if (ok && (tx_semaphore_get(&snap_ctx.done_sem, SNAPSHOT_TIMEOUT_TICKS) != TX_SUCCESS || snap_ctx.failed)) {
+    ok = 0;
+  }
+
+  if (!ok) {
+    if (snap_ctx.out_size >= SNAPSHOT_MAX_SIZE) {
+      snap_ctx.stats.overflows++;
+    } else {
+      snap_ctx.stats.errors++;
+    }
+    (void)HAL_JPEG_Abort(&snap_ctx.hjpeg);
+    return 0;
+  }
+
+  snap->size = snap_ctx.out_size;
+  return 1;
+}
+
+#if SCREENSHOT_ENABLE
+/**
+ * @brief  Compose the screen from the lent camera slot and the UI buffer on screen
+ * @param  slot: Lent camera display slot
+ * @param  snap: Whole screen out
+ * @note   The UI buffer is lent from the presenter for the blend only: the
+ *         UI thread draws into the others meanwhile
+ */
+static void Snapshot_ComposeScreen(int slot, snapshot_t *snap) {
+  const uint8_t *ui = NULL;
+
+  if (UI_IsVisible()) {
+    ui = Buffer_GetUIBuffer(Buffer_UIDisplay_Lend());
+  }
+  Overlay_ComposeScreenRGB565(screenshot_buffers[0], Buffer_GetCameraDisplayBuffer(slot), ui);
+  Overlay_WaitFence(Overlay_Submit());
+  if (ui != NULL) {
+    Buffer_UIDisplay_Return();
+  }
+
+  snap->x = 0;
+  snap->y = 0;
+  snap->width = LCD_WIDTH;
+  snap->height = LCD_HEIGHT;
+}
+#endif
+
+/**
+ * @brief  Photograph one new track on the displayed frame, or the screen
+ */
+static void Snapshot_Take(const snapshot_event_t *event) {
+  snapshot_t *snap = &snap_ctx.images[snap_ctx.head % SNAPSHOT_SLOTS];
+  uint8_t *out = snapshot_store_buffers[snap_ctx.head % SNAPSHOT_SLOTS];
+  uint64_t start_us = Time_GetUs();
+  buffer_frame_tag_t tag;
+  uint32_t nb;
+  int slot;
+  int found = 0;
+
+  if (snap_ctx.head - snap_ctx.tail >= SNAPSHOT_SLOTS) {
+    snap_ctx.stats.dropped++;
+    return;
+  }
+
+  slot = Buffer_CameraDisplay_Lend(BUFFER_LENDER_SNAPSHOT, &tag);
+  if (slot < 0) {
+    snap_ctx.stats.missed++;
+    return;
+  }
+
+#if SCREENSHOT_ENABLE
+  if (event->track_id == SNAPSHOT_SCREENSHOT_ID) {
+    /* The slot goes back once composed: the encode reads the copy */
+    Snapshot_ComposeScreen(slot, snap);
+    Buffer_CameraDisplay_Return(BUFFER_LENDER_SNAPSHOT);
+    found = Snapshot_Encode(screenshot_buffers[0], LCD_WIDTH, snap, out);
+  } else
+#endif
+  {
+    /* The track's box at the capture of that very slot */
+    nb = Tracker_Predict(snap_ctx.boxes, snap_ctx.box_ids, TRACKER_MAX_TRACKS, tag.vsync_cycles);
+    for (uint32_t b = 0; b < nb; b++) {
+      if (snap_ctx.box_ids[b] == event->track_id) {
+        Snapshot_CropRect(&snap_ctx.boxes[b], slot, snap);
+        found = 1;
+        break;
+      }
+    }
+    if (!found) {
+      Buffer_CameraDisplay_Return(BUFFER_LENDER_SNAPSHOT);
+      snap_ctx.stats.missed++;
+      return;
+    }
+
+    found = Snapshot_Encode(Buffer_GetCameraDisplayBuffer(slot), DISPLAY_LETTERBOX_WIDTH, snap, out);
+    Buffer_CameraDisplay_Return(BUFFER_LENDER_SNAPSHOT);
+  }
+  snap_ctx.stats.encode_us = (uint32_t)(Time_GetUs() - start_us);
+  if (!found) {
+    return;
+  }
+
+  snap->data = out;
+  snap->track_id = event->track_id;
+  snap->frame_id = tag.frame_id;
+  snap->time_us = event->time_us;
+  snap_ctx.stats.taken++;
+  if (event->track_id == SNAPSHOT_SCREENSHOT_ID) {
+    snap_ctx.stats.screens++;
+  }
+
+  /* Descriptor complete before the consumer can see it */
+  __DMB();
+  snap_ctx.head++;
+  APP_REQUIRE_EQ(tx_semaphore_put(&snap_ctx.image_sem), TX_SUCCESS);
+}
+
+/**
+ * @brief  Snapshot thread: one image per new-track event
+ * @param  arg: Unused
+ */
+static void snapshot_thread_entry(ULONG arg) {
+  snapshot_event_t event;
+
+  UNUSED(arg);
+
+  while (1) {
+    APP_REQUIRE_EQ(tx_queue_receive(&snap_ctx.events, &event, TX_WAIT_FOREVER), TX_SUCCESS);
+    Snapshot_Take(&event);
+  }
+}
+
+/**
+ * @brief  Input strip consumed: hand over the next one, or pause until converted
+ * @note   JPEG input DMA interrupt context
+ */
+void HAL_JPEG_GetDataCallback(JPEG_HandleTypeDef *hjpeg, uint32_t NbDecodedData) {
+  uint32_t next;
+
+  UNUSED(NbDecodedData);
+
+  next = ++snap_ctx.consumed;
+  tx_semaphore_put(&snap_ctx.strip_sem);
+
+  if (next >= snap_ctx.nb_strips) {
+    /* Zero length: end of the input */
+    HAL_JPEG_ConfigInputBuffer(hjpeg, snapshot_mcu_buffers[0], 0);
+  } else if (snap_ctx.ready > next) {
+    HAL_JPEG_ConfigInputBuffer(hjpeg, snapshot_mcu_buffers[next & 1U], snap_ctx.strip_size);
+  } else {
+    (void)HAL_JPEG_Pause(hjpeg, JPEG_PAUSE_RESUME_INPUT);
+    snap_ctx.paused = 1;
+  }
+}
+
+/**
+ * @brief  Output chunk written: the whole image slot is one chunk
+ * @note   Filling it before the end of the image is an overflow
+ */
+void HAL_JPEG_DataReadyCallback(JPEG_HandleTypeDef *hjpeg, uint8_t *pDataOut, uint32_t OutDataLength) {
+  UNUSED(pDataOut);
+
+  snap_ctx.out_size += OutDataLength;
+  if (snap_ctx.out_size >= SNAPSHOT_MAX_SIZE) {
+    (void)HAL_JPEG_Pause(hjpeg, JPEG_PAUSE_RESUME_OUTPUT);
+    snap_ctx.failed = 1;
+    /* Wake the thread whether it converts strips or waits for the end */
+    tx_semaphore_put(&snap_ctx.strip_sem);
+    tx_semaphore_put(&snap_ctx.done_sem);
+  }
+}
+
+void HAL_JPEG_EncodeCpltCallback(JPEG_HandleTypeDef *hjpeg) {
+  UNUSED(hjpeg);
+  tx_semaphore_put(&snap_ctx.done_sem);
+}
+
+void HAL_JPEG_ErrorCallback(JPEG_HandleTypeDef *hjpeg) {
+  UNUSED(hjpeg);
+  snap_ctx.failed = 1;
+  tx_semaphore_put(&snap_ctx.strip_sem);
+  tx_semaphore_put(&snap_ctx.done_sem);
+}
+
+/**
+ * @brief  Set up one JPEG FIFO DMA channel
+ */
+static void Snapshot_DmaInit(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *channel, uint32_t request,
+                             uint32_t direction) {
+  hdma->Instance = channel;
+  hdma->Init.Request = request;
+  hdma->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma->Init.Direction = direction;
+  hdma->Init.SrcInc = (direction == DMA_MEMORY_TO_PERIPH) ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+  hdma->Init.DestInc = (direction == DMA_MEMORY_TO_PERIPH) ? DMA_DINC_FIXED : DMA_DINC_INCREMENTED;
+  hdma->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_WORD;
+  hdma->Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+  hdma->Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT; /* The camera and the NPU keep the bus */
+  hdma->Init.SrcBurstLength = 8;                    /* Half the 32-byte codec FIFO threshold */
+  hdma->Init.DestBurstLength = 8;
+  hdma->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma->Init.Mode = DMA_NORMAL;
+  APP_REQUIRE_EQ(HAL_DMA_Init(hdma), HAL_OK);
+  APP_REQUIRE_EQ(HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                           DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC),
+                 HAL_OK);
+}
+
+/**
+ * @brief  Set up the JPEG codec and its DMAs and start the snapshot thread
+ */
+void Thread_Snapshot_Init(VOID *memory_ptr) {
+  UNUSED(memory_ptr);
+
+  __HAL_RCC_JPEG_CLK_ENABLE();
+  __HAL_RCC_JPEG_FORCE_RESET();
+  __HAL_RCC_JPEG_RELEASE_RESET();
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  Snapshot_DmaInit(&snap_ctx.hdma_in, SNAPSHOT_DMA_IN_CHANNEL, HPDMA1_REQUEST_JPEG_RX, DMA_MEMORY_TO_PERIPH);
+  Snapshot_DmaInit(&snap_ctx.hdma_out, SNAPSHOT_DMA_OUT_CHANNEL, HPDMA1_REQUEST_JPEG_TX, DMA_PERIPH_TO_MEMORY);
+
+  snap_ctx.hjpeg.Instance = JPEG;
+  __HAL_LINKDMA(&snap_ctx.hjpeg, hdmain, snap_ctx.hdma_in);
+  __HAL_LINKDMA(&snap_ctx.hjpeg, hdmaout, snap_ctx.hdma_out);
+  APP_REQUIRE_EQ(HAL_JPEG_Init(&snap_ctx.hjpeg), HAL_OK);
+
+  HAL_NVIC_SetPriority(JPEG_IRQn, SNAPSHOT_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(JPEG_IRQn);
+  HAL_NVIC_SetPriority(SNAPSHOT_DMA_IN_IRQn, SNAPSHOT_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(SNAPSHOT_DMA_IN_IRQn);
+  HAL_NVIC_SetPriority(SNAPSHOT_DMA_OUT_IRQn, SNAPSHOT_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(SNAPSHOT_DMA_OUT_IRQn);
+
+  APP_REQUIRE_EQ(tx_semaphore_create(&snap_ctx.strip_sem, "snapshot_strip", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_semaphore_create(&snap_ctx.done_sem, "snapshot_done", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_semaphore_create(&snap_ctx.image_sem, "snapshot_image", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_queue_create(&snap_ctx.events, "snapshot_events", sizeof(snapshot_event_t) / sizeof(ULONG),
+                                 snap_ctx.events_mem, sizeof(snap_ctx.events_mem)),
+                 TX_SUCCESS);
+
+  APP_REQUIRE_EQ(tx_thread_create(&snap_ctx.thread, "snapshot",
+                                  snapshot_thread_entry, 0,
+                                  snap_ctx.stack, SNAPSHOT_THREAD_STACK_SIZE,
+                                  SNAPSHOT_THREAD_PRIORITY, SNAPSHOT_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+/**
+ * @brief  Request a snapshot of a newly confirmed track
+ */
+void Snapshot_Trigger(uint32_t track_id) {
+  snapshot_event_t event = {
+      .track_id = track_id,
+      .time_us = (uint32_t)Time_GetUs(),
+  };
+
+  if (tx_queue_send(&snap_ctx.events, &event, TX_NO_WAIT) != TX_SUCCESS) {
+    snap_ctx.stats.dropped++;
+  }
+}
+
+#if SCREENSHOT_ENABLE
+/**
+ * @brief  Request a screenshot of both LTDC layers
+ */
+void Snapshot_Screenshot(void) {
+  snapshot_event_t event = {
+      .track_id = SNAPSHOT_SCREENSHOT_ID,
+      .time_us = (uint32_t)Time_GetUs(),
+  };
+
+  if (tx_queue_send(&snap_ctx.events, &event, TX_NO_WAIT) != TX_SUCCESS) {
+    snap_ctx.stats.dropped++;
+  }
+}
+
+/**
+ * @brief  Take the screenshot host request
+ */
+void Snapshot_Poll(void) {
+  if (Telemetry_TakeRequest(TELEMETRY_REQUEST_SCREENSHOT)) {
+    Snapshot_Screenshot();
+  }
+}
+#endif
+
+/**
+ * @brief  Take the oldest queued image
+ */
+int Snapshot_Acquire(snapshot_t *snap, ULONG wait_ticks) {
+  APP_REQUIRE(snap != NULL);
+
+  if (tx_semaphore_get(&snap_ctx.image_sem, wait_ticks) != TX_SUCCESS) {
+    return 0;
+  }
+  *snap = snap_ctx.images[snap_ctx.tail % SNAPSHOT_SLOTS];
+  return 1;
+}
+
+/**
+ * @brief  Give the image taken by Snapshot_Acquire() back to the queue
+ */
+void Snapshot_Release(void) {
+  APP_REQUIRE(snap_ctx.tail != snap_ctx.head);
+
+  /* Done reading before the snapshot thread may overwrite it */
+  __DMB();
+  snap_ctx.tail++;
+}
+
+/**
+ * @brief  Copy the snapshot counters
+ */
+void Snapshot_GetStats(snapshot_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = snap_ctx.stats;
+}
+
+/**
+ * @brief  JPEG codec interrupt handler
+ */
+void Snapshot_IRQHandler(void) {
+  HAL_JPEG_IRQHandler(&snap_ctx.hjpeg);
+}
+
+/**
+ * @brief  JPEG input DMA interrupt handler
+ */
+void Snapshot_DmaInIRQHandler(void) {
+  HAL_DMA_IRQHandler(&snap_ctx.hdma_in);
+}
+
+/**
+ * @brief  JPEG output DMA interrupt handler
+ */
+void Snapshot_DmaOutIRQHandler(void) {
+  HAL_DMA_IRQHandler(&snap_ctx.hdma_out);
+}
+
+#endif /* SNAPSHOT_ENABLE */
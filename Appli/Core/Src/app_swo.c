@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file    app_swo.c
+ * @author  Long Liangmao
+ * @brief   SWO profiling build for STM32N6570-DK (SWO_PROFILER)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_swo.h"
+
+#if SWO_PROFILER
+
+#include "app_trace.h"
+#include "stm32n6xx_hal.h"
+
+#if SWO_TRACE_EVENTS && !TRACE_ENABLE
+#error "SWO_TRACE_EVENTS writes the trace probes: it needs TRACE_ENABLE"
+#endif
+#if SWO_TRACE_PORT < 1 || SWO_TRACE_PORT > 31
+#error "SWO_TRACE_PORT out of range (port 0 is left to the console)"
+#endif
+
+/* PC sample period: (POSTPRESET + 1) taps of CYCCNT bit 6 or bit 10 */
+#if (SWO_PC_SAMPLE_CYCLES % 1024U) == 0 && SWO_PC_SAMPLE_CYCLES >= 1024U && SWO_PC_SAMPLE_CYCLES <= 16384U
+#define SWO_CYCTAP 1U
+#define SWO_POSTPRESET (SWO_PC_SAMPLE_CYCLES / 1024U - 1U)
+#elif (SWO_PC_SAMPLE_CYCLES % 64U) == 0 && SWO_PC_SAMPLE_CYCLES >= 64U && SWO_PC_SAMPLE_CYCLES <= 1024U
+#define SWO_CYCTAP 0U
+#define SWO_POSTPRESET (SWO_PC_SAMPLE_CYCLES / 64U - 1U)
+#else
+#error "SWO_PC_SAMPLE_CYCLES must be 64 x 1..16 or 1024 x 1..16"
+#endif
+
+/* Synchronization packets every 2^24 cycles, so a capture started late
+ * locks on within about 20 ms */
+#define SWO_SYNCTAP 1U
+
+void Swo_Init(void) {
+  GPIO_InitTypeDef gpio = {0};
+  uint32_t ctrl;
+
+  /* Trace clock and TRACESWO on PB5, towards the ST-LINK */
+  __HAL_RCC_DBG_CLK_ENABLE();
+  DBGMCU->CR |= DBGMCU_CR_DBGCLKEN | DBGMCU_CR_TRACECLKEN;
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  gpio.Pin = GPIO_PIN_5;
+  gpio.Mode = GPIO_MODE_AF_PP;
+  gpio.Pull = GPIO_NOPULL;
+  gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  gpio.Alternate = GPIO_AF0_TRACE;
+  HAL_GPIO_Init(GPIOB, &gpio);
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+  /* ITM: stimulus port for the probes, the DWT packets forwarded, local
+   * timestamps in core cycles (no prescaler) */
+  ITM->TCR = 0;
+  while ((ITM->TCR & ITM_TCR_BUSY_Msk) != 0U) {
+  }
+  ITM->TPR = 0;
+  ITM->TER = 1UL << SWO_TRACE_PORT;
+  ITM->TCR = (SWO_ATB_ID << ITM_TCR_TRACEBUSID_Pos) | ITM_TCR_DWTENA_Msk | ITM_TCR_SYNCENA_Msk |
+             ITM_TCR_TSENA_Msk | ITM_TCR_ITMENA_Msk;
+
+  /* DWT: CYCCNT kept running (Time_GetCycles64() extends it), PC sampling
+   * from its taps, exception entries and exits */
+  ctrl = DWT->CTRL;
+  ctrl &= ~(DWT_CTRL_POSTPRESET_Msk | DWT_CTRL_POSTINIT_Msk | DWT_CTRL_CYCTAP_Msk | DWT_CTRL_SYNCTAP_Msk |
+            DWT_CTRL_PCSAMPLENA_Msk | DWT_CTRL_EXCTRCENA_Msk);
+  ctrl |= (SWO_POSTPRESET << DWT_CTRL_POSTPRESET_Pos) | (SWO_POSTPRESET << DWT_CTRL_POSTINIT_Pos) |
+          (SWO_CYCTAP << DWT_CTRL_CYCTAP_Pos) | (SWO_SYNCTAP << DWT_CTRL_SYNCTAP_Pos) | DWT_CTRL_CYCCNTENA_Msk;
+  DWT->CTRL = ctrl;
+  ctrl |= DWT_CTRL_PCSAMPLENA_Msk;
+#if SWO_EXCEPTION_TRACE
+  ctrl |= DWT_CTRL_EXCTRCENA_Msk;
+#endif
+  DWT->CTRL = ctrl;
+}
+
+#if SWO_TRACE_EVENTS
+/* Probe words dropped, the stimulus FIFO full: read with the debugger */
+static uint32_t swo_lost;
+
+void Swo_Event(uint32_t id, uint32_t phase, uint32_t tid, int32_t value) {
+  uint32_t code;
+
+  switch (phase) {
+  case TRACE_PHASE_BEGIN:
+    code = 0U;
+    break;
+  case TRACE_PHASE_END:
+    code = 1U;
+    break;
+  case TRACE_PHASE_INSTANT:
+    code = 2U;
+    break;
+  default:
+    code = 3U;
+    break;
+  }
+  if (tid == TRACE_TID_INIT || tid > SWO_EVENT_TID_INIT) {
+    tid = SWO_EVENT_TID_INIT;
+  }
+  value = (value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : value;
+
+  /* FIFO ready bit: a full FIFO drops the word rather than stall the
+   * caller; a preempting writer may still fill it between the test and the
+   * store, then the ITM overflow packet tells the host */
+  if ((ITM->PORT[SWO_TRACE_PORT].u32 & 1U) == 0U) {
+    __atomic_fetch_add(&swo_lost, 1U, __ATOMIC_RELAXED);
+    return;
+  }
+  ITM->PORT[SWO_TRACE_PORT].u32 = (id & 0xFFU) | (code << SWO_EVENT_PHASE_SHIFT) |
+                                  (tid << SWO_EVENT_TID_SHIFT) | ((uint32_t)(uint16_t)value << SWO_EVENT_VALUE_SHIFT);
+}
+#endif /* SWO_TRACE_EVENTS */
+
+#endif /* SWO_PROFILER */
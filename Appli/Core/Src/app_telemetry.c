@@ -0,0 +1,495 @@
+/**
+ ******************************************************************************
+ * @file    app_telemetry.c
+ * @author  Long Liangmao
+ * @brief   Binary telemetry stream for STM32N6570-DK (TELEMETRY)
+ *          Fixed-size records queued by any context into a ring, COBS framed
+ *          and sent on USART1 by GPDMA; decoded by telemetry.ps1, which
+ *          sends its requests back on the RX line
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_telemetry.h"
+
+#if TELEMETRY
+
+#include "app_dvfs.h"
+#include "app_error.h"
+#include "app_params.h"
+#include "app_shell.h"
+#include "app_time.h"
+#include "stm32n6570_discovery.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <string.h>
+
+#if TELEMETRY_RECORDS < 2 || (TELEMETRY_RECORDS & (TELEMETRY_RECORDS - 1)) != 0
+#error "TELEMETRY_RECORDS must be a power of two"
+#endif
+
+/* As THREAD_PROFILER_UART: the host side does not change baud rate */
+#define TELEMETRY_UART_BAUDRATE 921600U
+
+/* TX DMA: one GPDMA channel, memory to USART1 TDR, unused by the BSP */
+#define TELEMETRY_DMA_CHANNEL GPDMA1_Channel0
+#define TELEMETRY_DMA_IRQn GPDMA1_Channel0_IRQn
+
+/* Records encoded per transfer: 8 x 67 bytes, 5.8 ms of line time */
+#define TELEMETRY_TX_BATCH 8U
+#define TELEMETRY_COBS_MAX (TELEMETRY_RECORD_SIZE + 2U) /* Code bytes and delimiter */
+
+static struct {
+  /* Line aligned: the Ethernet MAC DMA reads records in place */
+  telemetry_record_t ring[TELEMETRY_RECORDS] __attribute__((aligned(32)));
+  volatile uint8_t ready[TELEMETRY_RECORDS]; /* Filled by its producer */
+
+  /* Reservations under interrupt lock: producers advance head, the DMA
+   * interrupt tail as it encodes */
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  uint16_t seq;
+
+#if TELEMETRY_DMA_READERS
+  /* In-place readers: a slot is reused once every attached tail passed it */
+  struct {
+    volatile uint8_t attached;
+    uint32_t next;          /* Next record to acquire */
+    volatile uint32_t tail; /* Next record to release */
+  } reader[TELEMETRY_READER_NB];
+#endif
+
+  volatile uint8_t started;
+  volatile uint8_t busy; /* A transfer is in flight */
+
+  uint32_t sent;
+  uint32_t dropped[TELEMETRY_TYPE_NB];
+  uint32_t requests; /* Bit per telemetry_request_t, raised by the host */
+  uint8_t set[TELEMETRY_SET_SIZE]; /* Set command being received */
+  uint8_t set_len;                 /* 1 + its bytes so far, 0: none started */
+#if SHELL_ENABLE
+  uint8_t shell; /* A shell line is being received */
+#endif
+  uint32_t last_detect_ms;
+
+  DMA_HandleTypeDef hdma;
+} tm_ctx;
+
+CACHE_LINES_CHECK(tm_ctx.ring);
+
+_Static_assert(sizeof(TELEMETRY_REQUEST_BYTES) - 1U == TELEMETRY_REQUEST_NB, "One byte per request");
+_Static_assert(TELEMETRY_REQUEST_NB <= 32U, "Requests overflow their mask");
+
+/* DMA source: section covered by the non-cacheable MPU region 0 */
+static uint8_t tm_tx[TELEMETRY_TX_BATCH * TELEMETRY_COBS_MAX] __attribute__((section(".noncacheable"), aligned(32)));
+
+/**
+ * @brief  COBS-encode a record and append the frame delimiter
+ * @retval Bytes written, at most len + 2 for len < 254
+ */
+static uint32_t Telemetry_Cobs(const uint8_t *src, uint32_t len, uint8_t *dst) {
+  uint32_t code_pos = 0;
+  uint32_t out = 1;
+  uint8_t code = 1;
+
+  for (uint32_t i = 0; i < len; i++) {
+    if (src[i] == 0) {
+      dst[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+      continue;
+    }
+    dst[out++] = src[i];
+    if (++code == 0xFF) {
+      dst[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+    }
+  }
+  dst[code_pos] = code;
+  dst[out++] = 0;
+  return out;
+}
+
+/**
+ * @brief  Encode the records ready at the tail and start sending them
+ * @note   DMA interrupt context only: the single consumer
+ */
+static void Telemetry_Kick(void) {
+  uint32_t nb = 0;
+  uint32_t len = 0;
+
+  if (!tm_ctx.started || tm_ctx.busy) {
+    return;
+  }
+
+  /* A slot still being filled stops the batch; its commit pends us again */
+  while (nb < TELEMETRY_TX_BATCH && tm_ctx.tail != tm_ctx.head && tm_ctx.ready[tm_ctx.tail % TELEMETRY_RECORDS]) {
+    uint32_t idx = tm_ctx.tail % TELEMETRY_RECORDS;
+    const telemetry_record_t *rec = &tm_ctx.ring[idx];
+
+    len += Telemetry_Cobs((const uint8_t *)rec, TELEMETRY_HEADER_SIZE + rec->len, &tm_tx[len]);
+    tm_ctx.tail++;
+    nb++;
+  }
+  if (nb == 0) {
+    return;
+  }
+
+  tm_ctx.sent += nb;
+  tm_ctx.busy = 1;
+  APP_REQUIRE_EQ(HAL_DMA_Start_IT(&tm_ctx.hdma, (uint32_t)tm_tx, (uint32_t)&hcom_uart[COM1].Instance->TDR, len),
+                 HAL_OK);
+}
+
+static void Telemetry_DmaComplete(DMA_HandleTypeDef *hdma) {
+  UNUSED(hdma);
+
+  tm_ctx.busy = 0;
+  Telemetry_Kick();
+}
+
+static void Telemetry_DmaError(DMA_HandleTypeDef *hdma) {
+  APP_REQUIRE_EQ(hdma->ErrorCode, HAL_DMA_ERROR_NONE);
+}
+
+/**
+ * @brief  Records not yet released by the slowest reader
+ * @note   Under the reservation lock
+ */
+static uint32_t Telemetry_Used(void) {
+  uint32_t used = tm_ctx.head - tm_ctx.tail;
+
+#if TELEMETRY_DMA_READERS
+  for (uint32_t r = 0; r < TELEMETRY_READER_NB; r++) {
+    if (tm_ctx.reader[r].attached) {
+      used = MAX(used, tm_ctx.head - tm_ctx.reader[r].tail);
+    }
+  }
+#endif
+  return used;
+}
+
+int Telemetry_Send(uint32_t type, const void *payload, uint32_t len) {
+  uint32_t primask = __get_PRIMASK();
+  telemetry_record_t *rec;
+  uint32_t idx;
+  uint16_t seq;
+
+  APP_REQUIRE(type < TELEMETRY_TYPE_NB && len <= TELEMETRY_PAYLOAD_MAX);
+
+  __disable_irq();
+  if (Telemetry_Used() >= TELEMETRY_RECORDS) {
+    tm_ctx.dropped[type]++;
+    __set_PRIMASK(primask);
+    return 0;
+  }
+  idx = tm_ctx.head++ % TELEMETRY_RECORDS;
+  seq = tm_ctx.seq++;
+  /* Set by the previous lap: readers stop at it until this commit */
+  tm_ctx.ready[idx] = 0;
+  __set_PRIMASK(primask);
+
+  /* The slot is this producer's until ready is set */
+  rec = &tm_ctx.ring[idx];
+  rec->type = (uint8_t)type;
+  rec->len = (uint8_t)len;
+  rec->seq = seq;
+  rec->time_us = (uint32_t)Time_GetUs();
+  memcpy(rec->payload, payload, len);
+  __DMB();
+  tm_ctx.ready[idx] = 1;
+
+  if (tm_ctx.started && !tm_ctx.busy) {
+    NVIC_SetPendingIRQ(TELEMETRY_DMA_IRQn);
+  }
+  return 1;
+}
+
+void Telemetry_Text(const char *text, uint32_t len) {
+  while (len > 0) {
+    uint32_t chunk = MIN(len, TELEMETRY_PAYLOAD_MAX);
+
+    Telemetry_Send(TELEMETRY_TYPE_TEXT, text, chunk);
+    text += chunk;
+    len -= chunk;
+  }
+}
+
+static uint16_t Telemetry_Fraction(float value) {
+  value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+  return (uint16_t)(value * 65535.0f + 0.5f);
+}
+
+static uint32_t Telemetry_CyclesToUs(uint32_t cycles) {
+  return (uint32_t)(((uint64_t)cycles * 1000000U) / SystemCoreClock);
+}
+
+void Telemetry_PublishResult(const nn_result_t *result) {
+  telemetry_result_t rec = {
+      .frame_id = result->frame_id,
+      .frame_count = result->frame_count,
+      .vsync_to_npu_us = Telemetry_CyclesToUs(result->npu_done_cycles - result->vsync_cycles),
+      .inference_us = result->inference_us,
+      .postprocess_us = result->postprocess_us,
+      .vsync_to_result_us = Telemetry_CyclesToUs(result->post_done_cycles - result->vsync_cycles),
+      .frame_period_us = result->frame_period_us,
+      .nb_detect = (uint16_t)result->nb_detect,
+      .network = (uint8_t)result->network,
+      .conf_threshold = (uint8_t)(MIN(MAX(result->conf_threshold, 0.0f), 1.0f) * 255.0f + 0.5f),
+#if DUAL_STREAM_ENABLE
+      .stream = (uint8_t)result->stream,
+#endif
+  };
+  uint32_t total = MIN(result->nb_detect, 255U);
+
+  Telemetry_Send(TELEMETRY_TYPE_RESULT, &rec, sizeof(rec));
+
+#if TELEMETRY_DETECT_PERIOD_MS > 0
+  if (HAL_GetTick() - tm_ctx.last_detect_ms < TELEMETRY_DETECT_PERIOD_MS) {
+    return;
+  }
+  tm_ctx.last_detect_ms = HAL_GetTick();
+#endif
+
+  for (uint32_t first = 0; first < total; first += TELEMETRY_BOXES_PER_RECORD) {
+    telemetry_detections_t det = {
+        .frame_id = result->frame_id,
+        .first = (uint8_t)first,
+        .nb = (uint8_t)MIN(total - first, TELEMETRY_BOXES_PER_RECORD),
+        .total = (uint8_t)total,
+    };
+
+    for (uint32_t i = 0; i < det.nb; i++) {
+      const nn_detection_t *src = &result->detections[first + i];
+
+      det.boxes[i] = (telemetry_box_t){
+          .x_center = Telemetry_Fraction(src->x_center),
+          .y_center = Telemetry_Fraction(src->y_center),
+          .width = Telemetry_Fraction(src->width),
+          .height = Telemetry_Fraction(src->height),
+          .conf = (uint8_t)(Telemetry_Fraction(src->conf) >> 8),
+          .class_index = (uint8_t)src->class_index,
+      };
+    }
+    /* Fixed 48-byte payload: unused boxes are sent zeroed */
+    if (!Telemetry_Send(TELEMETRY_TYPE_DETECTIONS, &det, sizeof(det))) {
+      break;
+    }
+  }
+}
+
+void Telemetry_PublishSystem(uint32_t frame_period_us, uint32_t cpu_load_pct) {
+  telemetry_system_t rec = {
+      .uptime_ms = HAL_GetTick(),
+      .fps_tenths = (uint16_t)(frame_period_us ? 10000000U / frame_period_us : 0),
+      .cpu_load_pct = (uint8_t)cpu_load_pct,
+      .opp = 0xFF,
+  };
+  uint32_t primask = __get_PRIMASK();
+#if DVFS_ENABLE || PROFILE_ENABLE
+  dvfs_stats_t dvfs;
+
+  DVFS_GetStats(&dvfs);
+  rec.opp = (uint8_t)dvfs.point;
+#endif
+
+  __disable_irq();
+  rec.sent = tm_ctx.sent;
+  for (uint32_t t = 0; t < TELEMETRY_TYPE_NB - 1U; t++) {
+    rec.dropped[t] = (uint16_t)MIN(tm_ctx.dropped[TELEMETRY_TYPE_TEXT + t], 0xFFFFU);
+  }
+  __set_PRIMASK(primask);
+
+  Telemetry_Send(TELEMETRY_TYPE_SYSTEM, &rec, sizeof(rec));
+}
+
+void Telemetry_Init(void) {
+  COM_InitTypeDef com_init = {
+      .BaudRate = TELEMETRY_UART_BAUDRATE,
+      .WordLength = COM_WORDLENGTH_8B,
+      .StopBits = COM_STOPBITS_1,
+      .Parity = COM_PARITY_NONE,
+      .HwFlowCtl = COM_HWCONTROL_NONE,
+  };
+
+  APP_REQUIRE_EQ(BSP_COM_Init(COM1, &com_init), BSP_ERROR_NONE);
+  SET_BIT(hcom_uart[COM1].Instance->CR3, USART_CR3_DMAT);
+  /* Host requests: a byte at a time, by interrupt */
+  SET_BIT(hcom_uart[COM1].Instance->CR1, USART_CR1_RXNEIE_RXFNEIE);
+
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+  tm_ctx.hdma.Instance = TELEMETRY_DMA_CHANNEL;
+  tm_ctx.hdma.Init.Request = GPDMA1_REQUEST_USART1_TX;
+  tm_ctx.hdma.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  tm_ctx.hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  tm_ctx.hdma.Init.SrcInc = DMA_SINC_INCREMENTED;
+  tm_ctx.hdma.Init.DestInc = DMA_DINC_FIXED;
+  tm_ctx.hdma.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+  tm_ctx.hdma.Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+  tm_ctx.hdma.Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+  tm_ctx.hdma.Init.SrcBurstLength = 1;
+  tm_ctx.hdma.Init.DestBurstLength = 1;
+  tm_ctx.hdma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1;
+  tm_ctx.hdma.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  tm_ctx.hdma.Init.Mode = DMA_NORMAL;
+  APP_REQUIRE_EQ(HAL_DMA_Init(&tm_ctx.hdma), HAL_OK);
+  APP_REQUIRE_EQ(HAL_DMA_ConfigChannelAttributes(&tm_ctx.hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                                   DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC),
+                 HAL_OK);
+  tm_ctx.hdma.XferCpltCallback = Telemetry_DmaComplete;
+  tm_ctx.hdma.XferErrorCallback = Telemetry_DmaError;
+
+  HAL_NVIC_SetPriority(TELEMETRY_DMA_IRQn, TELEMETRY_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(TELEMETRY_DMA_IRQn);
+  HAL_NVIC_SetPriority(USART1_IRQn, TELEMETRY_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+  /* Text queued since reset goes out first */
+  tm_ctx.started = 1;
+  NVIC_SetPendingIRQ(TELEMETRY_DMA_IRQn);
+}
+
+#if TELEMETRY_DMA_READERS
+void Telemetry_ReaderAttach(telemetry_reader_t reader, int attached) {
+  uint32_t primask = __get_PRIMASK();
+
+  APP_REQUIRE(reader < TELEMETRY_READER_NB);
+
+  __disable_irq();
+  /* Records queued while detached are not kept for it */
+  tm_ctx.reader[reader].next = tm_ctx.head;
+  tm_ctx.reader[reader].tail = tm_ctx.head;
+  tm_ctx.reader[reader].attached = attached ? 1U : 0U;
+  __set_PRIMASK(primask);
+}
+
+uint32_t Telemetry_ReaderAcquire(telemetry_reader_t reader, const telemetry_record_t **records, uint32_t max) {
+  uint32_t head = tm_ctx.head;
+  uint32_t next;
+  uint32_t idx;
+  uint32_t nb = 0;
+
+  APP_REQUIRE(reader < TELEMETRY_READER_NB && tm_ctx.reader[reader].attached && records != NULL);
+  next = tm_ctx.reader[reader].next;
+  idx = next % TELEMETRY_RECORDS;
+
+  /* Contiguous records only: a run stops at the end of the ring */
+  max = MIN(max, TELEMETRY_RECORDS - idx);
+  while (nb < max && next + nb != head && tm_ctx.ready[idx + nb]) {
+    nb++;
+  }
+  if (nb == 0) {
+    return 0;
+  }
+
+  /* Read ready before the records, then push them out of the D-cache */
+  __DMB();
+  SCB_CleanDCache_by_Addr((void *)&tm_ctx.ring[idx], (int32_t)(nb * TELEMETRY_RECORD_SIZE));
+  *records = &tm_ctx.ring[idx];
+  tm_ctx.reader[reader].next = next + nb;
+  return nb;
+}
+
+void Telemetry_ReaderRelease(telemetry_reader_t reader, uint32_t nb) {
+  APP_REQUIRE(reader < TELEMETRY_READER_NB &&
+              tm_ctx.reader[reader].next - tm_ctx.reader[reader].tail >= nb);
+
+  tm_ctx.reader[reader].tail += nb;
+}
+#endif /* TELEMETRY_DMA_READERS */
+
+void Telemetry_Command(uint8_t byte) {
+#if SHELL_ENABLE
+  if (tm_ctx.shell) {
+    tm_ctx.shell = (uint8_t)Shell_Receive(byte);
+    return;
+  }
+  if (byte == (uint8_t)TELEMETRY_SHELL_BYTE) {
+    tm_ctx.shell = 1;
+    return;
+  }
+#endif
+#if PARAMS_ENABLE
+  if (tm_ctx.set_len > 0U) {
+    /* The command bytes are data: nothing in them is a request */
+    tm_ctx.set[tm_ctx.set_len++ - 1U] = byte;
+    if (tm_ctx.set_len > TELEMETRY_SET_SIZE) {
+      uint8_t check = 0xFF;
+
+      tm_ctx.set_len = 0;
+      for (uint32_t i = 0; i < TELEMETRY_SET_SIZE - 1U; i++) {
+        check -= tm_ctx.set[i];
+      }
+      if (check == tm_ctx.set[TELEMETRY_SET_SIZE - 1U]) {
+        Params_Set(tm_ctx.set[0], (uint32_t)tm_ctx.set[1] | ((uint32_t)tm_ctx.set[2] << 8) |
+                                      ((uint32_t)tm_ctx.set[3] << 16) | ((uint32_t)tm_ctx.set[4] << 24));
+      }
+    }
+    return;
+  }
+  if (byte == (uint8_t)TELEMETRY_SET_BYTE) {
+    tm_ctx.set_len = 1;
+    return;
+  }
+#endif
+  for (uint32_t r = 0; r < TELEMETRY_REQUEST_NB; r++) {
+    if (byte == (uint8_t)TELEMETRY_REQUEST_BYTES[r]) {
+      __atomic_fetch_or(&tm_ctx.requests, 1UL << r, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+int Telemetry_TakeRequest(telemetry_request_t request) {
+  APP_REQUIRE(request < TELEMETRY_REQUEST_NB);
+
+  return (__atomic_fetch_and(&tm_ctx.requests, ~(1UL << request), __ATOMIC_RELAXED) >> request) & 1U;
+}
+
+/**
+ * @brief  USART1 interrupt handler: received bytes only, TX is the DMA's
+ */
+void Telemetry_UartIRQHandler(void) {
+  USART_TypeDef *uart = hcom_uart[COM1].Instance;
+  uint32_t isr = uart->ISR;
+
+  /* A line error loses the byte: the host sends its request again */
+  if (isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE | USART_ISR_PE)) {
+    uart->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF | USART_ICR_PECF;
+  }
+  if (isr & USART_ISR_RXNE_RXFNE) {
+    Telemetry_Command((uint8_t)uart->RDR);
+  }
+}
+
+/**
+ * @brief  TX DMA interrupt handler
+ */
+void Telemetry_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&tm_ctx.hdma);
+  /* Pended by a producer with no transfer in flight */
+  Telemetry_Kick();
+}
+
+/**
+ * @brief  Console output: every printf() becomes text records
+ * @note   Replaces the weak byte-by-byte _write() of syscalls.c
+ */
+int _write(int file, char *ptr, int len) {
+  UNUSED(file);
+
+  Telemetry_Text(ptr, (uint32_t)len);
+  return len;
+}
+
+#endif /* TELEMETRY */
@@ -0,0 +1,194 @@
+/**
+ ******************************************************************************
+ * @file    app_thermal.c
+ * @author  Long Liangmao
+ * @brief   Thermal governor for STM32N6570-DK (THERMAL_ENABLE)
+ *
+ *          The two DTS sensors convert continuously; every THERMAL_PERIOD_MS
+ *          the hotter one is compared with the budget. Each step down raises
+ *          the profile floor by one: max-fps, then balanced (nominal point,
+ *          NPU off its 1 GHz overdrive, half the inferences), then low-power
+ *          (lower sensor rate, a quarter of the inferences).
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_thermal.h"
+
+#if THERMAL_ENABLE
+
+#include "app_error.h"
+#include "app_profile.h"
+#include "app_telemetry.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stdio.h>
+
+#if !PROFILE_ENABLE
+#error "THERMAL_ENABLE throttles through the performance profiles: it needs PROFILE_ENABLE"
+#endif
+#if THERMAL_HYST_C <= 0 || THERMAL_HYST_C >= THERMAL_LIMIT_C
+#error "THERMAL_HYST_C must be above 0 and under THERMAL_LIMIT_C"
+#endif
+#if THERMAL_CRITICAL_C <= THERMAL_LIMIT_C || THERMAL_CRITICAL_C > 125
+#error "THERMAL_CRITICAL_C must be above THERMAL_LIMIT_C, at most 125 (junction maximum)"
+#endif
+#if THERMAL_HOLD_SAMPLES < 1 || THERMAL_RELEASE_SAMPLES < 1
+#error "THERMAL_HOLD_SAMPLES and THERMAL_RELEASE_SAMPLES must be at least 1"
+#endif
+
+_Static_assert(sizeof(thermal_record_t) <= TELEMETRY_PAYLOAD_MAX, "Thermal record overflows");
+
+#define THERMAL_FLOOR_MAX (PROFILE_NB - 1U)
+
+static struct {
+  DTS_HandleTypeDef hdts;
+  uint32_t last_ms;
+  int32_t temp_dc; /* THERMAL_TEMP_NONE before the first valid sample */
+  int32_t max_dc;
+  uint32_t floor;  /* profile_id_t the profile is held at or under */
+  uint32_t hot;    /* Consecutive samples at or over the limit */
+  uint32_t cool;   /* Consecutive samples under the limit minus the hysteresis */
+  uint32_t steps;
+  uint32_t faults;
+  uint32_t throttled_ms;
+} thermal_ctx;
+
+/**
+ * @brief  Hotter of the two sensors' last conversions
+ * @retval 1 with *temp_dc set, 0 when neither has a valid one
+ */
+static int Thermal_Read(int32_t *temp_dc) {
+  int valid = 0;
+
+  for (uint32_t s = 0; s < 2U; s++) {
+    float_t celsius;
+
+    if (HAL_DTS_GetTemperature(&thermal_ctx.hdts, (HAL_DTS_Sensor)s, &celsius) != HAL_OK) {
+      /* No conversion yet is not a fault */
+      if (thermal_ctx.hdts.ErrorCode & HAL_DTS_ERROR_FAULT) {
+        thermal_ctx.faults++;
+      }
+      thermal_ctx.hdts.ErrorCode = HAL_DTS_ERROR_NONE;
+      continue;
+    }
+    if (!valid || (int32_t)(celsius * 10.0f) > *temp_dc) {
+      *temp_dc = (int32_t)(celsius * 10.0f);
+    }
+    valid = 1;
+  }
+  return valid;
+}
+
+/**
+ * @brief  Move the floor one way on a sample, with hysteresis
+ */
+static void Thermal_Govern(int32_t temp_dc) {
+  uint32_t floor = thermal_ctx.floor;
+
+  if (temp_dc >= THERMAL_CRITICAL_C * 10) {
+    /* No time for steps: straight to the lowest profile */
+    thermal_ctx.hot = 0;
+    thermal_ctx.cool = 0;
+    floor = THERMAL_FLOOR_MAX;
+  } else if (temp_dc >= THERMAL_LIMIT_C * 10) {
+    thermal_ctx.cool = 0;
+    if (++thermal_ctx.hot >= THERMAL_HOLD_SAMPLES && floor < THERMAL_FLOOR_MAX) {
+      /* The next step waits as long: the last one needs time to show */
+      thermal_ctx.hot = 0;
+      floor++;
+    }
+  } else if (temp_dc < (THERMAL_LIMIT_C - THERMAL_HYST_C) * 10) {
+    thermal_ctx.hot = 0;
+    if (++thermal_ctx.cool >= THERMAL_RELEASE_SAMPLES && floor > 0U) {
+      thermal_ctx.cool = 0;
+      floor--;
+    }
+  } else {
+    thermal_ctx.hot = 0;
+    thermal_ctx.cool = 0;
+  }
+
+  if (floor == thermal_ctx.floor) {
+    return;
+  }
+  if (floor > thermal_ctx.floor) {
+    thermal_ctx.steps++;
+  }
+  printf("Thermal: %ld.%ld C, profile floor %lu\r\n", (long)(temp_dc / 10),
+         (long)((temp_dc < 0) ? -(temp_dc % 10) : temp_dc % 10), (unsigned long)floor);
+  thermal_ctx.floor = floor;
+  Profile_SetFloor(floor);
+}
+
+void Thermal_Init(void) {
+  DTS_SensorConfigTypeDef config = {
+      .Mode = DTS_SENSOR_MODE_CONTINUOUS,
+      .Resolution = DTS_SENSOR_RESOLUTION_12BITS,
+      .Trigger = 0,
+  };
+
+  thermal_ctx.temp_dc = THERMAL_TEMP_NONE;
+  thermal_ctx.max_dc = THERMAL_TEMP_NONE;
+  thermal_ctx.last_ms = HAL_GetTick();
+
+  __HAL_RCC_DTS_CLK_ENABLE();
+  thermal_ctx.hdts.Instance = DTS;
+  APP_REQUIRE_EQ(HAL_DTS_Init(&thermal_ctx.hdts), HAL_OK);
+  for (uint32_t s = 0; s < 2U; s++) {
+    APP_REQUIRE_EQ(HAL_DTS_ConfigSensor(&thermal_ctx.hdts, (HAL_DTS_Sensor)s, &config), HAL_OK);
+    APP_REQUIRE_EQ(HAL_DTS_Start(&thermal_ctx.hdts, (HAL_DTS_Sensor)s), HAL_OK);
+  }
+}
+
+void Thermal_Poll(void) {
+  uint32_t now = HAL_GetTick();
+  int32_t temp_dc;
+#if TELEMETRY
+  thermal_record_t rec;
+#endif
+
+  if (now - thermal_ctx.last_ms < THERMAL_PERIOD_MS) {
+    return;
+  }
+  if (thermal_ctx.floor != 0U) {
+    thermal_ctx.throttled_ms += now - thermal_ctx.last_ms;
+  }
+  thermal_ctx.last_ms = now;
+
+  /* Unreadable sensors hold the floor where it is */
+  if (Thermal_Read(&temp_dc)) {
+    thermal_ctx.temp_dc = temp_dc;
+    thermal_ctx.max_dc = MAX(thermal_ctx.max_dc, temp_dc);
+    Thermal_Govern(temp_dc);
+  }
+
+#if TELEMETRY
+  rec = (thermal_record_t){
+      .temp_dc = (int16_t)thermal_ctx.temp_dc,
+      .max_dc = (int16_t)thermal_ctx.max_dc,
+      .limit_dc = (int16_t)(THERMAL_LIMIT_C * 10),
+      .floor = (uint8_t)thermal_ctx.floor,
+      .steps = (uint16_t)MIN(thermal_ctx.steps, 0xFFFFU),
+      .faults = (uint16_t)MIN(thermal_ctx.faults, 0xFFFFU),
+      .throttled_ms = thermal_ctx.throttled_ms,
+  };
+  /* A full ring drops it, counted in the system record */
+  (void)Telemetry_Send(TELEMETRY_TYPE_THERMAL, &rec, sizeof(rec));
+#endif
+}
+
+int32_t Thermal_GetTemperature(void) {
+  return thermal_ctx.temp_dc;
+}
+
+#endif /* THERMAL_ENABLE */
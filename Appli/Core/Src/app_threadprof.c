@@ -0,0 +1,280 @@
+/**
+ ******************************************************************************
+ * @file    app_threadprof.c
+ * @author  Long Liangmao
+ * @brief   Per-thread CPU and stack usage profiler implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_threadprof.h"
+
+#if THREAD_PROFILER && !defined(TX_EXECUTION_PROFILE_ENABLE)
+#error "THREAD_PROFILER requires TX_EXECUTION_PROFILE_ENABLE in tx_user.h"
+#endif
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+#include "tx_thread.h"
+
+/* ISR time, in the same units as the per-thread totals (cycles) */
+static struct {
+  EXECUTION_TIME total;
+  EXECUTION_TIME_SOURCE_TYPE start;
+  uint32_t nesting;
+} isr_ctx;
+
+/*
+ * Port hooks. A thread accumulates from switch-in (or the end of the ISR that
+ * preempted it) to switch-out (or the next bracketed ISR); last_start == 0
+ * marks a thread that is not being charged.
+ */
+
+void _tx_execution_initialize(void) {
+  isr_ctx.total = 0;
+  isr_ctx.nesting = 0;
+}
+
+void _tx_execution_thread_enter(void) {
+  TX_INTERRUPT_SAVE_AREA
+  TX_THREAD *thread;
+
+  TX_DISABLE
+  thread = _tx_thread_current_ptr;
+  if (thread != TX_NULL && isr_ctx.nesting == 0) {
+    thread->tx_thread_execution_time_last_start = TX_EXECUTION_TIME_SOURCE;
+  }
+  TX_RESTORE
+}
+
+void _tx_execution_thread_exit(void) {
+  TX_INTERRUPT_SAVE_AREA
+  TX_THREAD *thread;
+
+  TX_DISABLE
+  thread = _tx_thread_current_ptr;
+  if (thread != TX_NULL && thread->tx_thread_execution_time_last_start != 0) {
+    thread->tx_thread_execution_time_total +=
+        (EXECUTION_TIME_SOURCE_TYPE)(TX_EXECUTION_TIME_SOURCE - thread->tx_thread_execution_time_last_start);
+    thread->tx_thread_execution_time_last_start = 0;
+  }
+  TX_RESTORE
+}
+
+void _tx_execution_isr_enter(void) {
+  TX_INTERRUPT_SAVE_AREA
+  EXECUTION_TIME_SOURCE_TYPE now;
+  TX_THREAD *thread;
+
+  TX_DISABLE
+  if (isr_ctx.nesting++ == 0) {
+    now = TX_EXECUTION_TIME_SOURCE;
+    thread = _tx_thread_current_ptr;
+    if (thread != TX_NULL && thread->tx_thread_execution_time_last_start != 0) {
+      thread->tx_thread_execution_time_total +=
+          (EXECUTION_TIME_SOURCE_TYPE)(now - thread->tx_thread_execution_time_last_start);
+      thread->tx_thread_execution_time_last_start = 0;
+    }
+    isr_ctx.start = now;
+  }
+  TX_RESTORE
+}
+
+void _tx_execution_isr_exit(void) {
+  TX_INTERRUPT_SAVE_AREA
+  EXECUTION_TIME_SOURCE_TYPE now;
+  TX_THREAD *thread;
+
+  TX_DISABLE
+  if (isr_ctx.nesting > 0 && --isr_ctx.nesting == 0) {
+    now = TX_EXECUTION_TIME_SOURCE;
+    isr_ctx.total += (EXECUTION_TIME_SOURCE_TYPE)(now - isr_ctx.start);
+    thread = _tx_thread_current_ptr;
+    if (thread != TX_NULL) {
+      thread->tx_thread_execution_time_last_start = now;
+    }
+  }
+  TX_RESTORE
+}
+
+#endif /* TX_EXECUTION_PROFILE_ENABLE */
+
+#if THREAD_PROFILER
+
+#include "app_time.h"
+#include "stm32n6xx_hal.h"
+#include <string.h>
+
+#if THREAD_PROFILER_UART
+#include "app_error.h"
+#include "stm32n6570_discovery.h"
+#include <stdio.h>
+
+/* ST-LINK virtual COM port; the report is ~0.5 KB, ~5 ms of polled output */
+#define THREADPROF_UART_BAUDRATE 921600U
+#endif
+
+/* Totals at the start of the current window */
+static struct {
+  struct {
+    TX_THREAD *thread;
+    EXECUTION_TIME total;
+  } last[THREADPROF_MAX_THREADS];
+  uint32_t nb_last;
+  EXECUTION_TIME last_isr;
+  uint64_t window_start_us;
+
+  threadprof_report_t report;
+} tp_ctx;
+
+/**
+ * @brief  Bytes of a thread stack ever written (ThreadX fills stacks with TX_STACK_FILL)
+ */
+static uint32_t ThreadProf_StackUsed(const TX_THREAD *thread) {
+  const ULONG *word = (const ULONG *)thread->tx_thread_stack_start;
+  const ULONG *end = (const ULONG *)((UCHAR *)thread->tx_thread_stack_start + thread->tx_thread_stack_size);
+
+  /* Stacks grow down: the high-water mark is the lowest overwritten word */
+  while (word < end && *word == TX_STACK_FILL) {
+    word++;
+  }
+  return (uint32_t)((const UCHAR *)end - (const UCHAR *)word);
+}
+
+/**
+ * @brief  Share of the window, in permille
+ */
+static uint32_t ThreadProf_Permille(uint64_t us, uint64_t window_us) {
+  return window_us ? (uint32_t)((us * 1000U + window_us / 2) / window_us) : 0;
+}
+
+/**
+ * @brief  Sample all thread totals and, when publish is set, close the window
+ */
+static void ThreadProf_Sample(uint8_t publish) {
+  TX_INTERRUPT_SAVE_AREA
+  TX_THREAD *threads[THREADPROF_MAX_THREADS];
+  EXECUTION_TIME totals[THREADPROF_MAX_THREADS];
+  EXECUTION_TIME isr_total;
+  uint64_t now_us, window_us, busy_us = 0;
+  uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  uint32_t nb = 0;
+
+  /* Consistent snapshot; the caller is the running thread, charge it up to now */
+  TX_DISABLE
+  EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+  TX_THREAD *thread = _tx_thread_created_ptr;
+  for (ULONG i = 0; i < _tx_thread_created_count && nb < THREADPROF_MAX_THREADS; i++) {
+    /* The bring-up thread returns once the pipes run */
+    if (thread->tx_thread_state == TX_COMPLETED) {
+      thread = thread->tx_thread_created_next;
+      continue;
+    }
+    totals[nb] = thread->tx_thread_execution_time_total;
+    if (thread == _tx_thread_current_ptr && thread->tx_thread_execution_time_last_start != 0) {
+      totals[nb] += (EXECUTION_TIME_SOURCE_TYPE)(now - thread->tx_thread_execution_time_last_start);
+    }
+    threads[nb++] = thread;
+    thread = thread->tx_thread_created_next;
+  }
+  isr_total = isr_ctx.total;
+  now_us = Time_GetUs();
+  TX_RESTORE
+
+  window_us = now_us - tp_ctx.window_start_us;
+
+  if (publish) {
+    threadprof_report_t *report = &tp_ctx.report;
+
+    for (uint32_t i = 0; i < nb; i++) {
+      EXECUTION_TIME last_total = 0;
+      threadprof_thread_t *stat = &report->threads[i];
+
+      for (uint32_t j = 0; j < tp_ctx.nb_last; j++) {
+        if (tp_ctx.last[j].thread == threads[i]) {
+          last_total = tp_ctx.last[j].total;
+          break;
+        }
+      }
+
+      stat->name = threads[i]->tx_thread_name;
+      stat->run_us = (uint32_t)((totals[i] - last_total) / cycles_per_us);
+      stat->cpu_permille = ThreadProf_Permille(stat->run_us, window_us);
+      stat->stack_size = threads[i]->tx_thread_stack_size;
+      stat->stack_used = ThreadProf_StackUsed(threads[i]);
+      busy_us += stat->run_us;
+    }
+    busy_us += (isr_total - tp_ctx.last_isr) / cycles_per_us;
+
+    report->nb_threads = nb;
+    report->isr_permille = ThreadProf_Permille((isr_total - tp_ctx.last_isr) / cycles_per_us, window_us);
+    report->idle_permille = ThreadProf_Permille(busy_us < window_us ? window_us - busy_us : 0, window_us);
+    report->window_us = (uint32_t)window_us;
+  }
+
+  for (uint32_t i = 0; i < nb; i++) {
+    tp_ctx.last[i].thread = threads[i];
+    tp_ctx.last[i].total = totals[i];
+  }
+  tp_ctx.nb_last = nb;
+  tp_ctx.last_isr = isr_total;
+  tp_ctx.window_start_us = now_us;
+}
+
+#if THREAD_PROFILER_UART
+/**
+ * @brief  Print the last window, one line per thread
+ */
+static void ThreadProf_Stream(const threadprof_report_t *report) {
+  printf("threads %lu us: idle %lu.%lu%% isr %lu.%lu%%\r\n", (unsigned long)report->window_us,
+         (unsigned long)report->idle_permille / 10, (unsigned long)report->idle_permille % 10,
+         (unsigned long)report->isr_permille / 10, (unsigned long)report->isr_permille % 10);
+  for (uint32_t i = 0; i < report->nb_threads; i++) {
+    const threadprof_thread_t *t = &report->threads[i];
+    printf("  %-20s %3lu.%lu%% %8lu us stack %5lu/%5lu\r\n", t->name,
+           (unsigned long)t->cpu_permille / 10, (unsigned long)t->cpu_permille % 10,
+           (unsigned long)t->run_us, (unsigned long)t->stack_used, (unsigned long)t->stack_size);
+  }
+}
+#endif
+
+void ThreadProf_Init(void) {
+  /* With TELEMETRY the port is already open, its TX owned by the DMA */
+#if THREAD_PROFILER_UART && !TELEMETRY
+  COM_InitTypeDef com_init = {
+      .BaudRate = THREADPROF_UART_BAUDRATE,
+      .WordLength = COM_WORDLENGTH_8B,
+      .StopBits = COM_STOPBITS_1,
+      .Parity = COM_PARITY_NONE,
+      .HwFlowCtl = COM_HWCONTROL_NONE,
+  };
+
+  APP_REQUIRE_EQ(BSP_COM_Init(COM1, &com_init), BSP_ERROR_NONE);
+#endif
+
+  memset(&tp_ctx, 0, sizeof(tp_ctx));
+  ThreadProf_Sample(0);
+}
+
+void ThreadProf_Update(void) {
+  ThreadProf_Sample(1);
+
+#if THREAD_PROFILER_UART
+  ThreadProf_Stream(&tp_ctx.report);
+#endif
+}
+
+void ThreadProf_GetReport(threadprof_report_t *report) {
+  *report = tp_ctx.report;
+}
+
+#endif /* THREAD_PROFILER */
@@ -24,6 +24,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "app.h"
+#include "app_time.h"
+#include "app_ui.h"
+#include "tx_timer.h"
 #include <assert.h>
 #include "utils.h"
 /* USER CODE END Includes */
@@ -35,6 +38,10 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define TICK_US (1000000U / TX_TIMER_TICKS_PER_SECOND)
+
+/* Longest tickless sleep: bounds how far the ThreadX clock is advanced at once */
+#define TICKLESS_MAX_TICKS TX_TIMER_TICKS_PER_SECOND
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -44,7 +51,15 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
-
+#ifdef TX_LOW_POWER
+/* Tickless sleep in progress, set and cleared by the scheduler idle hooks */
+static struct {
+  uint8_t active;
+  ULONG skippable;    /* Empty timer slots ahead at sleep entry */
+  uint64_t start_us;
+  uint32_t to_tick_us; /* Time left to the next tick boundary at sleep entry */
+} tickless;
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -91,33 +106,146 @@ void MX_ThreadX_Init(void)
 }
 
 /* USER CODE BEGIN 1 */
+#ifdef TX_LOW_POWER
+/**
+ * @brief  Count ticks that can pass without any ThreadX timer work
+ * @retval Empty timer-list slots ahead of the one the next tick processes
+ */
+static ULONG Tickless_EmptySlotsAhead(void) {
+  TX_TIMER_INTERNAL **slot = _tx_timer_current_ptr;
+  ULONG n;
+
+  /* A running time-slice is decremented every tick */
+  if (_tx_timer_time_slice != 0) {
+    return 0;
+  }
+
+  for (n = 0; n < TICKLESS_MAX_TICKS && n < TX_TIMER_ENTRIES; n++) {
+    if (*slot != TX_NULL) {
+      break;
+    }
+    if (++slot == _tx_timer_list_end) {
+      slot = _tx_timer_list_start;
+    }
+  }
+
+  /* Timers further out than the list length sit in a slot: only reached if the list is empty */
+  return (n == TX_TIMER_ENTRIES) ? TICKLESS_MAX_TICKS : n;
+}
+
 /**
- * @brief  HAL tick override for ThreadX
+ * @brief  Scheduler idle hook, entered with interrupts masked before WFI
+ *         Stops SysTick and arms the TIM5 wake-up at the next tick with timer work
+ */
+void tx_low_power_enter(void) {
+  UI_IdleThread_Enter();
+
+  tickless.skippable = Tickless_EmptySlotsAhead();
+  if (tickless.skippable == 0) {
+    return;
+  }
+
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  tickless.start_us = Time_GetUs();
+  tickless.to_tick_us = SysTick->VAL / (SystemCoreClock / 1000000U);
+  tickless.active = 1;
+
+  Time_SetWakeup(tickless.start_us + tickless.to_tick_us + tickless.skippable * TICK_US);
+}
+
+/**
+ * @brief  Scheduler idle hook, after WFI with interrupts still masked
+ *         Advances the ThreadX clock over the ticks slept and restarts SysTick
+ *         on the original tick phase
+ */
+void tx_low_power_exit(void) {
+  const uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  uint32_t elapsed_us, passed, remain_us, skip;
+
+  if (tickless.active) {
+    tickless.active = 0;
+    Time_CancelWakeup();
+    elapsed_us = (uint32_t)(Time_GetUs() - tickless.start_us);
+
+    if (elapsed_us < tickless.to_tick_us) {
+      passed = 0;
+      remain_us = tickless.to_tick_us - elapsed_us;
+    } else {
+      passed = 1 + (elapsed_us - tickless.to_tick_us) / TICK_US;
+      remain_us = TICK_US - (elapsed_us - tickless.to_tick_us) % TICK_US;
+    }
+
+    /* An ISR may have activated a timer meanwhile: never skip its slot */
+    skip = MIN(passed, MIN(tickless.skippable, Tickless_EmptySlotsAhead()));
+    _tx_timer_system_clock += skip;
+    for (uint32_t i = 0; i < skip; i++) {
+      if (++_tx_timer_current_ptr == _tx_timer_list_end) {
+        _tx_timer_current_ptr = _tx_timer_list_start;
+      }
+    }
+
+    /* The tick with timer work is due: let SysTick_Handler process it on unmask */
+    if (passed > skip) {
+      SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+      remain_us = TICK_US;
+    }
+
+    /* First period is the remainder of the interrupted one, then the nominal period */
+    SysTick->LOAD = MAX(remain_us * cycles_per_us, 2U) - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    while (SysTick->VAL == 0) {
+    }
+    SysTick->LOAD = SystemCoreClock / TX_TIMER_TICKS_PER_SECOND - 1U;
+  }
+
+  UI_IdleThread_Exit();
+}
+#endif /* TX_LOW_POWER */
+
+/**
+ * @brief  HAL tick override: millisecond view of the TIM5 timebase
  * @retval Current tick value in milliseconds
  */
- uint32_t HAL_GetTick(void) {
-  return (tx_time_get() * 1000) / TX_TIMER_TICKS_PER_SECOND;
+uint32_t HAL_GetTick(void) {
+  return (uint32_t)(Time_GetUs() / 1000U);
 }
 
 /**
  * @brief  HAL delay override for ThreadX
  * @param  Delay: Delay in milliseconds
  * @retval None
+ * @note   Sleeps whole ThreadX ticks (rounded up) from a thread, busy-waits
+ *         on the timebase before the kernel runs
  */
 void HAL_Delay(uint32_t Delay) {
   assert(!IS_IRQ_MODE());
 
-  uint32_t ticks = (Delay * TX_TIMER_TICKS_PER_SECOND) / 1000;
+  if (tx_thread_identify() == TX_NULL) {
+    uint64_t start = Time_GetUs();
+    while (Time_GetUs() - start < (uint64_t)Delay * 1000U) {
+    }
+    return;
+  }
+
+  uint32_t ticks = (Delay * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U;
   tx_thread_sleep(ticks);
 }
 
 /**
- * @brief  HAL tick initialization override for ThreadX
- * @param  TickPriority: Tick priority (unused)
+ * @brief  HAL tick initialization override: starts the TIM5 timebase
+ * @param  TickPriority: TIM5 interrupt priority
  * @retval HAL status
+ * @note   Also re-entered by HAL_RCC_ClockConfig() after every clock change
  */
 HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority) {
-  UNUSED(TickPriority);
+  /* First call from SystemClock_Config() precedes HAL_Init(): no priority yet */
+  if (TickPriority >= (1UL << __NVIC_PRIO_BITS)) {
+    TickPriority = TICK_INT_PRIORITY;
+  }
+
+  Time_Init(TickPriority);
+  uwTickPrio = TickPriority;
   return HAL_OK;
 }
 /* USER CODE END 1 */
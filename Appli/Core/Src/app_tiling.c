@@ -0,0 +1,255 @@
+/**
+ ******************************************************************************
+ * @file    app_tiling.c
+ * @author  Long Liangmao
+ * @brief   Full-FOV tiled inference merge and ROI window implementation for
+ *          STM32N6570-DK
+ *
+ *          Tiles overlap, so an object on a border is found by two or more
+ *          of them; at the fine scale it is also found by a coarse tile. The
+ *          merge runs a class-aware NMS on the whole sweep that suppresses a
+ *          box on IoU, as the per-tile NMS does, or when it is mostly inside
+ *          a stronger one (the cut-off half of a border object).
+ *
+ *          With the steered ROI window, detections are mapped back from the
+ *          window they were found in, and their padded extent picks the
+ *          window of the following frames.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_tiling.h"
+
+#if NN_TILING == NN_TILING_FULL_FOV
+
+#include "app_cam.h"
+#include "app_error.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if CASCADE_ENABLE
+#error "CASCADE_ENABLE crops the ML frame: not supported with NN_TILING_FULL_FOV"
+#endif
+
+#if NN_TILING_MAX_TILES >= 32
+#error "NN_TILING_MAX_TILES exceeds the sweep mask"
+#endif
+
+typedef struct {
+  nn_detection_t det; /* Sensor FOV coordinates */
+  uint32_t tile;
+} tiling_cand_t;
+
+/* Post-processing thread only */
+static struct {
+  tiling_cand_t cands[TILING_MAX_CANDIDATES];
+  uint32_t nb;
+  uint32_t seen; /* Tiles added to the sweep, one bit each */
+} tiling_ctx;
+
+/**
+ * @brief  Drop the candidates of one tile
+ */
+static void Tiling_RemoveTile(uint32_t tile) {
+  uint32_t nb = 0;
+
+  for (uint32_t i = 0; i < tiling_ctx.nb; i++) {
+    if (tiling_ctx.cands[i].tile != tile) {
+      tiling_ctx.cands[nb++] = tiling_ctx.cands[i];
+    }
+  }
+  tiling_ctx.nb = nb;
+}
+
+/**
+ * @brief  Store a candidate, replacing the weakest one when full
+ */
+static void Tiling_Store(const tiling_cand_t *cand) {
+  uint32_t weakest = 0;
+
+  if (tiling_ctx.nb < TILING_MAX_CANDIDATES) {
+    tiling_ctx.cands[tiling_ctx.nb++] = *cand;
+    return;
+  }
+
+  for (uint32_t i = 1; i < tiling_ctx.nb; i++) {
+    if (tiling_ctx.cands[i].det.conf < tiling_ctx.cands[weakest].det.conf) {
+      weakest = i;
+    }
+  }
+  if (cand->det.conf > tiling_ctx.cands[weakest].det.conf) {
+    tiling_ctx.cands[weakest] = *cand;
+  }
+}
+
+/**
+ * @brief  Highest confidence first
+ */
+static int Tiling_CompareConf(const void *a, const void *b) {
+  float ca = ((const tiling_cand_t *)a)->det.conf;
+  float cb = ((const tiling_cand_t *)b)->det.conf;
+
+  return (ca < cb) - (ca > cb);
+}
+
+/**
+ * @brief  Whether a weaker box duplicates a stronger one
+ */
+static int Tiling_Overlaps(const nn_detection_t *strong, const nn_detection_t *weak) {
+  float ix0 = MAX(strong->x_center - strong->width / 2, weak->x_center - weak->width / 2);
+  float iy0 = MAX(strong->y_center - strong->height / 2, weak->y_center - weak->height / 2);
+  float ix1 = MIN(strong->x_center + strong->width / 2, weak->x_center + weak->width / 2);
+  float iy1 = MIN(strong->y_center + strong->height / 2, weak->y_center + weak->height / 2);
+  float inter, strong_area, weak_area;
+
+  if (ix1 <= ix0 || iy1 <= iy0) {
+    return 0;
+  }
+
+  inter = (ix1 - ix0) * (iy1 - iy0);
+  strong_area = strong->width * strong->height;
+  weak_area = weak->width * weak->height;
+
+  if (inter > AI_OD_ST_YOLOX_PP_IOU_THRESHOLD * (strong_area + weak_area - inter)) {
+    return 1;
+  }
+  return inter > NN_TILING_CONTAIN_THRESHOLD * MIN(strong_area, weak_area);
+}
+
+/**
+ * @brief  Add the detections of one tile to the current sweep
+ */
+int Tiling_AddTile(uint32_t tile, const od_pp_outBuffer_t *dets, uint32_t nb) {
+  const cam_ml_tile_t *area = CAM_MLTile_Get(tile);
+
+  Tiling_RemoveTile(tile);
+
+  for (uint32_t i = 0; i < nb; i++) {
+    const tiling_cand_t cand = {
+        .det =
+            {
+                .x_center = area->x0 + dets[i].x_center * area->width,
+                .y_center = area->y0 + dets[i].y_center * area->height,
+                .width = dets[i].width * area->width,
+                .height = dets[i].height * area->height,
+                .conf = dets[i].conf,
+                .class_index = dets[i].class_index,
+            },
+        .tile = tile,
+    };
+
+    Tiling_Store(&cand);
+  }
+
+  tiling_ctx.seen |= 1U << tile;
+  return tiling_ctx.seen == (1U << CAM_MLTile_GetCount()) - 1U;
+}
+
+/**
+ * @brief  Merge the sweep across tiles and start the next one
+ */
+uint32_t Tiling_Merge(nn_detection_t *out, uint32_t max_nb, arena_t *scratch) {
+  uint8_t *suppressed = ARENA_ALLOC(scratch, uint8_t, TILING_MAX_CANDIDATES);
+  uint32_t nb_out = 0;
+
+  qsort(tiling_ctx.cands, tiling_ctx.nb, sizeof(tiling_ctx.cands[0]), Tiling_CompareConf);
+  memset(suppressed, 0, tiling_ctx.nb);
+
+  for (uint32_t i = 0; i < tiling_ctx.nb && nb_out < max_nb; i++) {
+    const nn_detection_t *det = &tiling_ctx.cands[i].det;
+
+    if (suppressed[i]) {
+      continue;
+    }
+    out[nb_out++] = *det;
+
+    for (uint32_t j = i + 1; j < tiling_ctx.nb; j++) {
+      if (!suppressed[j] && tiling_ctx.cands[j].det.class_index == det->class_index &&
+          Tiling_Overlaps(det, &tiling_ctx.cands[j].det)) {
+        suppressed[j] = 1;
+      }
+    }
+  }
+
+  tiling_ctx.nb = 0;
+  tiling_ctx.seen = 0;
+  return nb_out;
+}
+
+#elif NN_TILING == NN_TILING_ROI
+
+#include "app_cam.h"
+#include "utils.h"
+
+#if CASCADE_ENABLE
+#error "CASCADE_ENABLE crops the ML frame: not supported with NN_TILING_ROI"
+#endif
+
+/* Post-processing thread only */
+static struct {
+  uint32_t windowed; /* Windowed frames requested since the last full-FOV one */
+} roi_ctx;
+
+/**
+ * @brief  Map the detections of one Pipe2 window to the sensor FOV
+ */
+void Tiling_MapWindow(const cam_ml_tile_t *area, const od_pp_outBuffer_t *dets, uint32_t nb,
+                      nn_detection_t *out) {
+  for (uint32_t i = 0; i < nb; i++) {
+    out[i] = (nn_detection_t){
+        .x_center = area->x0 + dets[i].x_center * area->width,
+        .y_center = area->y0 + dets[i].y_center * area->height,
+        .width = dets[i].width * area->width,
+        .height = dets[i].height * area->height,
+        .conf = dets[i].conf,
+        .class_index = dets[i].class_index,
+    };
+  }
+}
+
+/**
+ * @brief  Steer the Pipe2 window from the latest detections
+ */
+void Tiling_UpdateRoi(const nn_detection_t *dets, uint32_t nb) {
+  float x0 = 1.0f;
+  float y0 = 1.0f;
+  float x1 = 0.0f;
+  float y1 = 0.0f;
+  float pad_x;
+  float pad_y;
+
+  if (nb == 0 || ++roi_ctx.windowed >= NN_ROI_DISCOVERY_PERIOD) {
+    roi_ctx.windowed = 0;
+    CAM_MLRoi_SetFullFov();
+    return;
+  }
+
+  for (uint32_t i = 0; i < nb; i++) {
+    x0 = MIN(x0, dets[i].x_center - dets[i].width / 2.0f);
+    y0 = MIN(y0, dets[i].y_center - dets[i].height / 2.0f);
+    x1 = MAX(x1, dets[i].x_center + dets[i].width / 2.0f);
+    y1 = MAX(y1, dets[i].y_center + dets[i].height / 2.0f);
+  }
+
+  /* Room for the people to move until the window catches up */
+  pad_x = (x1 - x0) * (NN_ROI_MARGIN_PCT / 100.0f);
+  pad_y = (y1 - y0) * (NN_ROI_MARGIN_PCT / 100.0f);
+  CAM_MLRoi_Set(&(const cam_ml_tile_t){
+      .x0 = x0 - pad_x,
+      .y0 = y0 - pad_y,
+      .width = x1 - x0 + 2.0f * pad_x,
+      .height = y1 - y0 + 2.0f * pad_y,
+  });
+}
+
+#endif /* NN_TILING */
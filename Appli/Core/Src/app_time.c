@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ * @file    app_time.c
+ * @author  Long Liangmao
+ * @brief   64-bit monotonic timebase implementation for STM32N6570-DK
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_time.h"
+#include "stm32n6xx_hal.h"
+
+#define TIME_TIM TIM5
+#define TIME_TIM_IRQn TIM5_IRQn
+#define TIME_TIM_HZ 1000000U
+
+static struct {
+  uint64_t base_us;          /* Time accumulated before the last re-init */
+  volatile uint32_t tim_hi;  /* TIM5 overflows since the last re-init */
+  uint32_t cycles_hi;        /* DWT extension */
+  uint32_t cycles_last;      /* CYCCNT at the previous read */
+  uint8_t initialized;
+} time_ctx;
+
+/**
+ * @brief  Get microseconds since the first Time_Init()
+ */
+uint64_t Time_GetUs(void) {
+  uint32_t primask = __get_PRIMASK();
+  uint32_t hi, cnt;
+
+  __disable_irq();
+  hi = time_ctx.tim_hi;
+  cnt = TIME_TIM->CNT;
+  /* Overflow not serviced yet: CNT has already wrapped */
+  if ((TIME_TIM->SR & TIM_SR_UIF) && cnt < 0x80000000U) {
+    hi++;
+  }
+  __set_PRIMASK(primask);
+
+  return time_ctx.base_us + (((uint64_t)hi << 32) | cnt);
+}
+
+/**
+ * @brief  Get the DWT cycle counter extended to 64 bits
+ */
+uint64_t Time_GetCycles64(void) {
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now;
+  uint64_t cycles;
+
+  __disable_irq();
+  now = DWT->CYCCNT;
+  if (now < time_ctx.cycles_last) {
+    time_ctx.cycles_hi++;
+  }
+  time_ctx.cycles_last = now;
+  cycles = ((uint64_t)time_ctx.cycles_hi << 32) | now;
+  __set_PRIMASK(primask);
+
+  return cycles;
+}
+
+/**
+ * @brief  Arm the TIM5 wake-up compare
+ */
+void Time_SetWakeup(uint64_t deadline_us) {
+  uint64_t now = Time_GetUs();
+
+  TIME_TIM->CCR2 = (uint32_t)(deadline_us - time_ctx.base_us);
+  TIME_TIM->SR = (uint32_t)~TIM_SR_CC2IF;
+  TIME_TIM->DIER |= TIM_DIER_CC2IE;
+  if (deadline_us <= now + 1U) {
+    TIME_TIM->EGR = TIM_EGR_CC2G;
+  }
+}
+
+/**
+ * @brief  Disarm the TIM5 wake-up compare
+ */
+void Time_CancelWakeup(void) {
+  TIME_TIM->DIER &= ~TIM_DIER_CC2IE;
+  TIME_TIM->SR = (uint32_t)~TIM_SR_CC2IF;
+}
+
+/**
+ * @brief  Start (or re-derive after a clock change) the timebase
+ */
+void Time_Init(uint32_t irq_priority) {
+  uint32_t timg_hz = HAL_RCCEx_GetTIMGFreq();
+
+  /* HAL_RCC_ClockConfig() re-enters here: fold the elapsed time into the
+   * base so the prescaler can be reloaded without going backwards */
+  if (time_ctx.initialized) {
+    time_ctx.base_us = Time_GetUs();
+  } else {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    time_ctx.cycles_last = DWT->CYCCNT;
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    __HAL_RCC_TIM5_CLK_SLEEP_ENABLE();
+  }
+
+  HAL_NVIC_DisableIRQ(TIME_TIM_IRQn);
+
+  TIME_TIM->CR1 = 0;
+  TIME_TIM->PSC = timg_hz / TIME_TIM_HZ - 1U;
+  TIME_TIM->ARR = 0xFFFFFFFFU;
+  TIME_TIM->EGR = TIM_EGR_UG; /* Load PSC, clear CNT */
+  TIME_TIM->SR = 0;
+  TIME_TIM->CCR1 = TIME_DWT_REFRESH_US;
+  TIME_TIM->DIER = TIM_DIER_UIE | TIM_DIER_CC1IE;
+  time_ctx.tim_hi = 0;
+  time_ctx.initialized = 1;
+
+  HAL_NVIC_SetPriority(TIME_TIM_IRQn, irq_priority, 0);
+  HAL_NVIC_EnableIRQ(TIME_TIM_IRQn);
+  TIME_TIM->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief  TIM5 interrupt handler: overflow count, DWT extension refresh, wake-up
+ */
+void Time_IRQHandler(void) {
+  uint32_t sr = TIME_TIM->SR;
+
+  if (sr & TIM_SR_UIF) {
+    TIME_TIM->SR = (uint32_t)~TIM_SR_UIF;
+    time_ctx.tim_hi++;
+  }
+
+  if (sr & TIM_SR_CC1IF) {
+    TIME_TIM->SR = (uint32_t)~TIM_SR_CC1IF;
+    TIME_TIM->CCR1 += TIME_DWT_REFRESH_US;
+    (void)Time_GetCycles64();
+  }
+
+  /* Wake-up compare: leaving WFI is all it is for */
+  if ((sr & TIM_SR_CC2IF) && (TIME_TIM->DIER & TIM_DIER_CC2IE)) {
+    Time_CancelWakeup();
+  }
+}
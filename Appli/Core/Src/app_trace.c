@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ * @file    app_trace.c
+ * @author  Long Liangmao
+ * @brief   Pipeline trace events for STM32N6570-DK (TRACE_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_trace.h"
+
+#if TRACE_ENABLE
+
+#include "app_swo.h"
+#include "app_telemetry.h"
+#include "app_tracex.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+#if TRACE_DRAIN && !TELEMETRY
+#error "TRACE_DRAIN sends the events as telemetry records: it needs TELEMETRY"
+#endif
+#if TRACE_NPU_EPOCHS && !NN_EPOCH_PROFILER
+#error "TRACE_NPU_EPOCHS probes the epoch callback of the profiler: it needs NN_EPOCH_PROFILER"
+#endif
+#if TRACE_EVENTS_LOG2 < 4 || TRACE_EVENTS_LOG2 > 16
+#error "TRACE_EVENTS_LOG2 out of range"
+#endif
+
+_Static_assert(sizeof(trace_event_t) == 12U, "Trace event layout");
+_Static_assert(TRACE_ID_NB <= UINT8_MAX, "Trace ids overflow the event");
+#if TRACE_DRAIN
+_Static_assert(sizeof(trace_record_t) <= TELEMETRY_PAYLOAD_MAX, "Trace record overflows");
+#endif
+
+/* Single core: one ring for every context. A writer reserves its slot with
+ * one atomic increment of head, fills it, then stores the lap byte; the
+ * drain stops at the first slot whose lap is not the expected one, so a
+ * reservation preempted before its store is waited for, never read torn */
+trace_ring_t trace_ring;
+
+#if TRACE_DRAIN
+static uint32_t trace_lost_sent;
+#endif
+
+static inline uint8_t Trace_Lap(uint32_t n) {
+  return (uint8_t)((n >> TRACE_EVENTS_LOG2) + 1U);
+}
+
+static inline uint8_t Trace_Tid(void) {
+  TX_THREAD *thread;
+
+  if (__get_IPSR() != 0U) {
+    return TRACE_TID_ISR;
+  }
+  thread = tx_thread_identify();
+  return (thread != NULL) ? (uint8_t)(thread->tx_thread_priority + 1U) : TRACE_TID_INIT;
+}
+
+void Trace_Init(void) {
+  memset(&trace_ring, 0, sizeof(trace_ring));
+  trace_ring.cpu_hz = SystemCoreClock;
+  trace_ring.nb = TRACE_EVENTS;
+  trace_ring.magic = TRACE_RING_MAGIC;
+}
+
+void Trace_Record(uint32_t id, uint32_t phase, int32_t value) {
+  trace_event_t *ev;
+  uint32_t tid = Trace_Tid();
+  uint32_t n;
+
+#if SWO_PROFILER && SWO_TRACE_EVENTS
+  /* Live on the SWO pin too, ITM timestamped */
+  Swo_Event(id, phase, tid, value);
+#endif
+#if TRACEX_ENABLE
+  /* On the kernel timeline too */
+  TraceX_Event(id, phase, tid, value);
+#endif
+
+#if TRACE_DRAIN
+  /* Full: drop the new event, the drained ones keep their order */
+  n = __atomic_load_n(&trace_ring.head, __ATOMIC_RELAXED);
+  do {
+    if (n - __atomic_load_n(&trace_ring.tail, __ATOMIC_ACQUIRE) >= TRACE_EVENTS) {
+      __atomic_fetch_add(&trace_ring.lost, 1U, __ATOMIC_RELAXED);
+      return;
+    }
+  } while (!__atomic_compare_exchange_n(&trace_ring.head, &n, n + 1U, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+  /* Flight recorder: the oldest events are overwritten */
+  n = __atomic_fetch_add(&trace_ring.head, 1U, __ATOMIC_RELAXED);
+#endif
+
+  ev = &trace_ring.events[n & (TRACE_EVENTS - 1U)];
+  ev->cycles = DWT->CYCCNT;
+  ev->value = value;
+  ev->id = (uint8_t)id;
+  ev->phase = (uint8_t)phase;
+  ev->tid = (uint8_t)tid;
+  __atomic_store_n(&ev->lap, Trace_Lap(n), __ATOMIC_RELEASE);
+}
+
+#if TRACE_DRAIN
+void Trace_Drain(void) {
+  for (uint32_t r = 0; r < TRACE_DRAIN_RECORDS; r++) {
+    trace_record_t rec = {0};
+    uint32_t tail = trace_ring.tail;
+    uint32_t lost;
+
+    while (rec.nb < TRACE_EVENTS_PER_RECORD) {
+      const trace_event_t *ev = &trace_ring.events[(tail + rec.nb) & (TRACE_EVENTS - 1U)];
+
+      if (tail + rec.nb == __atomic_load_n(&trace_ring.head, __ATOMIC_ACQUIRE) ||
+          __atomic_load_n(&ev->lap, __ATOMIC_ACQUIRE) != Trace_Lap(tail + rec.nb)) {
+        break;
+      }
+      rec.events[rec.nb++] = *ev;
+    }
+    if (rec.nb == 0) {
+      return;
+    }
+
+    lost = __atomic_load_n(&trace_ring.lost, __ATOMIC_RELAXED);
+    rec.lost = (uint8_t)MIN(lost - trace_lost_sent, UINT8_MAX);
+    rec.cpu_mhz = (uint16_t)(trace_ring.cpu_hz / 1000000U);
+    rec.drain_cycles = DWT->CYCCNT;
+    /* A full telemetry ring keeps the events for the next drain */
+    if (!Telemetry_Send(TELEMETRY_TYPE_TRACE, &rec, sizeof(rec))) {
+      return;
+    }
+    trace_lost_sent = lost;
+    __atomic_store_n(&trace_ring.tail, tail + rec.nb, __ATOMIC_RELEASE);
+  }
+}
+#endif /* TRACE_DRAIN */
+
+#endif /* TRACE_ENABLE */
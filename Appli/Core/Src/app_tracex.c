@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file    app_tracex.c
+ * @author  Long Liangmao
+ * @brief   ThreadX TraceX event trace for STM32N6570-DK (TRACEX_ENABLE)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_tracex.h"
+
+#if TRACEX_ENABLE
+
+#include "app_error.h"
+#include "app_telemetry.h"
+#include "app_trace.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+#ifndef TX_ENABLE_EVENT_TRACE
+#error "TRACEX_ENABLE needs ThreadX built with TX_ENABLE_EVENT_TRACE: configure with cmake -DTRACEX=ON"
+#endif
+#if TRACEX_BUFFER_SIZE % 4U != 0U
+#error "TRACEX_BUFFER_SIZE holds whole TraceX words"
+#endif
+
+#if TELEMETRY
+_Static_assert(sizeof(tracex_record_t) <= TELEMETRY_PAYLOAD_MAX, "TraceX record overflows");
+#endif
+_Static_assert(TRACE_ID_NB * 4U <= TX_TRACE_USER_EVENT_END - TX_TRACE_USER_EVENT_START, "Probes overflow the user events");
+
+/* Global, so the debugger finds it: halt and dump tracex_buffer as the .trx */
+uint8_t tracex_buffer[TRACEX_BUFFER_SIZE] IN_PSRAM_TRACE __attribute__((aligned(32)));
+
+#if TELEMETRY
+/* UI thread only */
+static struct {
+  uint32_t offset; /* Next byte of the dump in progress */
+  uint16_t dumps;
+  uint8_t dumping;
+} tracex_ctx;
+#endif
+
+void TraceX_Init(void) {
+  APP_REQUIRE_EQ(tx_trace_enable(tracex_buffer, TRACEX_BUFFER_SIZE, TRACEX_REGISTRY_ENTRIES), TX_SUCCESS);
+}
+
+void TraceX_Event(uint32_t id, uint32_t phase, uint32_t tid, int32_t value) {
+  uint32_t index;
+
+  switch (phase) {
+  case TRACE_PHASE_BEGIN:
+    index = TRACEX_PHASE_INDEX_BEGIN;
+    /* Shown as an interrupt: the vector, as the port would number it */
+    if (tid == TRACE_TID_ISR) {
+      tx_trace_isr_enter_insert(__get_IPSR());
+    }
+    break;
+  case TRACE_PHASE_END:
+    index = TRACEX_PHASE_INDEX_END;
+    break;
+  case TRACE_PHASE_INSTANT:
+    index = TRACEX_PHASE_INDEX_INSTANT;
+    break;
+  default:
+    index = TRACEX_PHASE_INDEX_COUNTER;
+    break;
+  }
+
+  /* Stopped during a dump: the kernel drops the event */
+  (void)tx_trace_user_event_insert(TX_TRACE_USER_EVENT_START + id * 4U + index, (ULONG)value, tid, 0, 0);
+  if (phase == TRACE_PHASE_END && tid == TRACE_TID_ISR) {
+    tx_trace_isr_exit_insert(__get_IPSR());
+  }
+}
+
+#if TELEMETRY
+/**
+ * @brief  Send the next record of the dump
+ * @retval 1 when sent, 0 when the telemetry ring is full
+ */
+static int TraceX_SendRecord(void) {
+  tracex_record_t rec = {
+      .dump = tracex_ctx.dumps,
+      .offset = tracex_ctx.offset,
+      .size = TRACEX_BUFFER_SIZE,
+  };
+
+  rec.nb = (uint8_t)MIN(TRACEX_BUFFER_SIZE - tracex_ctx.offset, TRACEX_BYTES_PER_RECORD);
+  memcpy(rec.data, &tracex_buffer[tracex_ctx.offset], rec.nb);
+  if (tracex_ctx.offset + rec.nb == TRACEX_BUFFER_SIZE) {
+    rec.flags |= TRACEX_FLAG_LAST;
+  }
+  if (!Telemetry_Send(TELEMETRY_TYPE_TRACEX, &rec, sizeof(rec))) {
+    return 0;
+  }
+
+  tracex_ctx.offset += rec.nb;
+  return 1;
+}
+
+void TraceX_Poll(void) {
+  if (!tracex_ctx.dumping) {
+    if (!Telemetry_TakeRequest(TELEMETRY_REQUEST_TRACEX)) {
+      return;
+    }
+    /* Frozen while sent: the header pointers match the entries */
+    APP_REQUIRE_EQ(tx_trace_disable(), TX_SUCCESS);
+    tracex_ctx.dumps++;
+    tracex_ctx.offset = 0;
+    tracex_ctx.dumping = 1;
+  }
+
+  for (uint32_t r = 0; r < TRACEX_DUMP_RECORDS; r++) {
+    if (!TraceX_SendRecord()) {
+      return;
+    }
+    if (tracex_ctx.offset == TRACEX_BUFFER_SIZE) {
+      /* Each dump covers the time since the previous one */
+      tracex_ctx.dumping = 0;
+      TraceX_Init();
+      return;
+    }
+  }
+}
+#endif /* TELEMETRY */
+
+#endif /* TRACEX_ENABLE */
@@ -0,0 +1,369 @@
+/**
+ ******************************************************************************
+ * @file    app_tracker.c
+ * @author  Long Liangmao
+ * @brief   Multi-object tracker implementation for STM32N6570-DK
+ *
+ *          Each of the box center and size coordinates has its own
+ *          position/velocity Kalman filter (white-noise acceleration): four
+ *          2x2 filters instead of one 8x8, the same estimate since the
+ *          coordinates are modeled independently. Tracks live in a fixed
+ *          arena of TRACKER_MAX_TRACKS entries.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_tracker.h"
+
+#if TRACKER_ENABLE
+
+#include "app_error.h"
+#include "app_snapshot.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include "utils.h"
+#include <string.h>
+
+/* Filter tuning, normalized frame units and seconds */
+#define TRACKER_ACCEL_NOISE 1.0f      /* Acceleration variance, (frame/s^2)^2 */
+#define TRACKER_MEAS_NOISE 1.0e-4f    /* Detection variance: about 1 % of the frame */
+#define TRACKER_INIT_VEL_VAR 0.25f    /* Velocity variance of a new track, (frame/s)^2 */
+#define TRACKER_MAX_PREDICT_S 0.5f    /* Predictions are held beyond this */
+#define TRACKER_MIN_SIZE 0.005f       /* Predicted sizes never collapse below this */
+
+/* Coordinates of a box state */
+#define TRACKER_CX 0
+#define TRACKER_CY 1
+#define TRACKER_W 2
+#define TRACKER_H 3
+#define TRACKER_COORDS 4
+
+typedef struct {
+  float pos;
+  float vel;
+  float p00, p01, p11; /* Covariance */
+} tracker_kf_t;
+
+typedef struct {
+  tracker_kf_t kf[TRACKER_COORDS];
+  uint32_t id;
+  uint32_t stamp;   /* DWT stamp of the filter state */
+  float conf;
+  int32_t class_index;
+  uint16_t hits;    /* Associated detections */
+  uint8_t misses;   /* Consecutive updates without one */
+  uint8_t active;
+  uint8_t announced; /* Confirmation reported (new-track event) */
+} tracker_track_t;
+
+static struct {
+  tracker_track_t tracks[TRACKER_MAX_TRACKS];
+  nn_detection_t predicted[TRACKER_MAX_TRACKS]; /* Boxes at the frame being associated */
+  uint32_t next_id;
+  TX_MUTEX mutex;
+} trk_ctx;
+
+/**
+ * @brief  Seconds from a filter stamp to a DWT stamp, 0 if earlier
+ */
+static float Tracker_Elapsed(uint32_t from, uint32_t to) {
+  int32_t cycles = (int32_t)(to - from);
+
+  if (cycles <= 0) {
+    return 0.0f;
+  }
+  return MIN((float)cycles / (float)SystemCoreClock, TRACKER_MAX_PREDICT_S);
+}
+
+/**
+ * @brief  Propagate one coordinate filter by dt
+ */
+static void Tracker_KfPredict(tracker_kf_t *kf, float dt) {
+  float dt2 = dt * dt;
+
+  kf->pos += kf->vel * dt;
+  kf->p00 += dt * (2.0f * kf->p01 + dt * kf->p11) + 0.25f * dt2 * dt2 * TRACKER_ACCEL_NOISE;
+  kf->p01 += dt * kf->p11 + 0.5f * dt2 * dt * TRACKER_ACCEL_NOISE;
+  kf->p11 += dt2 * TRACKER_ACCEL_NOISE;
+}
+
+/**
+ * @brief  Correct one coordinate filter with a measurement
+ */
+static void Tracker_KfUpdate(tracker_kf_t *kf, float z) {
+  float s = kf->p00 + TRACKER_MEAS_NOISE;
+  float k0 = kf->p00 / s;
+  float k1 = kf->p01 / s;
+  float y = z - kf->pos;
+
+  kf->pos += k0 * y;
+  kf->vel += k1 * y;
+  kf->p11 -= k1 * kf->p01;
+  kf->p00 -= k0 * kf->p00;
+  kf->p01 -= k0 * kf->p01;
+}
+
+/**
+ * @brief  Box of a detection as filter coordinates
+ */
+static void Tracker_Coords(const nn_detection_t *det, float *z) {
+  z[TRACKER_CX] = det->x_center;
+  z[TRACKER_CY] = det->y_center;
+  z[TRACKER_W] = det->width;
+  z[TRACKER_H] = det->height;
+}
+
+/**
+ * @brief  Filter coordinates as a detection box
+ */
+static void Tracker_ToBox(const float *z, const tracker_track_t *track, nn_detection_t *det) {
+  det->x_center = z[TRACKER_CX];
+  det->y_center = z[TRACKER_CY];
+  det->width = MAX(z[TRACKER_W], TRACKER_MIN_SIZE);
+  det->height = MAX(z[TRACKER_H], TRACKER_MIN_SIZE);
+  det->conf = track->conf;
+  det->class_index = track->class_index;
+}
+
+/**
+ * @brief  Intersection over union of two boxes
+ */
+static float Tracker_IoU(const nn_detection_t *a, const nn_detection_t *b) {
+  float ix = MIN(a->x_center + a->width / 2, b->x_center + b->width / 2) -
+             MAX(a->x_center - a->width / 2, b->x_center - b->width / 2);
+  float iy = MIN(a->y_center + a->height / 2, b->y_center + b->height / 2) -
+             MAX(a->y_center - a->height / 2, b->y_center - b->height / 2);
+  float inter;
+
+  if (ix <= 0.0f || iy <= 0.0f) {
+    return 0.0f;
+  }
+  inter = ix * iy;
+  return inter / (a->width * a->height + b->width * b->height - inter);
+}
+
+/**
+ * @brief  Start a track on an unmatched detection
+ * @retval Track index, -1 when the arena is full
+ */
+static int32_t Tracker_Spawn(const nn_detection_t *det, uint32_t frame_cycles) {
+  float z[TRACKER_COORDS];
+
+  Tracker_Coords(det, z);
+
+  for (uint32_t t = 0; t < TRACKER_MAX_TRACKS; t++) {
+    tracker_track_t *track = &trk_ctx.tracks[t];
+
+    if (track->active) {
+      continue;
+    }
+
+    for (int c = 0; c < TRACKER_COORDS; c++) {
+      track->kf[c] = (tracker_kf_t){
+          .pos = z[c],
+          .vel = 0.0f,
+          .p00 = TRACKER_MEAS_NOISE,
+          .p01 = 0.0f,
+          .p11 = TRACKER_INIT_VEL_VAR,
+      };
+    }
+    track->id = trk_ctx.next_id++;
+    track->stamp = frame_cycles;
+    track->conf = det->conf;
+    track->class_index = det->class_index;
+    track->hits = 1;
+    track->misses = 0;
+    track->active = 1;
+    track->announced = 0;
+    return (int32_t)t;
+  }
+  /* Arena full: the detection stays untracked this frame */
+  return -1;
+}
+
+/**
+ * @brief  Associate the detections of one frame with the tracks
+ */
+void Tracker_Update(const nn_detection_t *dets, uint32_t nb, uint32_t frame_cycles, arena_t *scratch) {
+  nn_detection_t *predicted = trk_ctx.predicted;
+  uint8_t *det_used = ARENA_ALLOC(scratch, uint8_t, NN_MAX_DETECTIONS);
+  uint8_t *track_used = ARENA_ALLOC(scratch, uint8_t, TRACKER_MAX_TRACKS);
+#if SNAPSHOT_ENABLE
+  uint32_t *confirmed = ARENA_ALLOC(scratch, uint32_t, TRACKER_MAX_TRACKS);
+  uint32_t nb_confirmed = 0;
+#endif
+
+  nb = MIN(nb, (uint32_t)NN_MAX_DETECTIONS);
+  memset(det_used, 0, NN_MAX_DETECTIONS);
+  memset(track_used, 0, TRACKER_MAX_TRACKS);
+
+  tx_mutex_get(&trk_ctx.mutex, TX_WAIT_FOREVER);
+
+  /* Every track to the frame time */
+  for (uint32_t t = 0; t < TRACKER_MAX_TRACKS; t++) {
+    tracker_track_t *track = &trk_ctx.tracks[t];
+    float dt, z[TRACKER_COORDS];
+
+    if (!track->active) {
+      continue;
+    }
+    dt = Tracker_Elapsed(track->stamp, frame_cycles);
+    for (int c = 0; c < TRACKER_COORDS; c++) {
+      Tracker_KfPredict(&track->kf[c], dt);
+      z[c] = track->kf[c].pos;
+    }
+    track->stamp = frame_cycles;
+    Tracker_ToBox(z, track, &predicted[t]);
+  }
+
+  /* Greedy association, strongest detections first: O(tracks x detections) */
+  for (uint32_t n = 0; n < nb; n++) {
+    uint32_t best_det = 0;
+    int32_t best_track = -1;
+    float best_iou = TRACKER_IOU_THRESHOLD;
+    float best_conf = -1.0f;
+    float z[TRACKER_COORDS];
+    tracker_track_t *track;
+
+    for (uint32_t d = 0; d < nb; d++) {
+      if (!det_used[d] && dets[d].conf > best_conf) {
+        best_conf = dets[d].conf;
+        best_det = d;
+      }
+    }
+    det_used[best_det] = 1;
+
+    for (uint32_t t = 0; t < TRACKER_MAX_TRACKS; t++) {
+      float iou;
+
+      if (!trk_ctx.tracks[t].active || track_used[t] ||
+          trk_ctx.tracks[t].class_index != dets[best_det].class_index) {
+        continue;
+      }
+      iou = Tracker_IoU(&predicted[t], &dets[best_det]);
+      if (iou > best_iou) {
+        best_iou = iou;
+        best_track = (int32_t)t;
+      }
+    }
+
+    if (best_track < 0) {
+      best_track = Tracker_Spawn(&dets[best_det], frame_cycles);
+      if (best_track >= 0) {
+        track_used[best_track] = 1;
+      }
+      continue;
+    }
+
+    track = &trk_ctx.tracks[best_track];
+    track_used[best_track] = 1;
+    Tracker_Coords(&dets[best_det], z);
+    for (int c = 0; c < TRACKER_COORDS; c++) {
+      Tracker_KfUpdate(&track->kf[c], z[c]);
+    }
+    track->conf = dets[best_det].conf;
+    track->hits = (uint16_t)MIN(track->hits + 1U, 0xFFFFU);
+    track->misses = 0;
+  }
+
+  /* Age out the tracks no detection was associated with; a tentative
+   * track dies on its first miss */
+  for (uint32_t t = 0; t < TRACKER_MAX_TRACKS; t++) {
+    tracker_track_t *track = &trk_ctx.tracks[t];
+
+    if (track->active && !track_used[t] &&
+        ++track->misses > (track->hits < TRACKER_MIN_HITS ? 0 : TRACKER_MAX_MISSES)) {
+      track->active = 0;
+    }
+
+    /* New-track event: once per track, when it is first shown */
+    if (track->active && !track->announced && track->hits >= TRACKER_MIN_HITS) {
+      track->announced = 1;
+#if SNAPSHOT_ENABLE
+      confirmed[nb_confirmed++] = track->id;
+#endif
+    }
+  }
+
+  tx_mutex_put(&trk_ctx.mutex);
+
+#if SNAPSHOT_ENABLE
+  /* Outside the lock: the snapshot thread predicts the tracks itself */
+  for (uint32_t i = 0; i < nb_confirmed; i++) {
+    Snapshot_Trigger(confirmed[i]);
+  }
+#endif
+}
+
+/**
+ * @brief  Predict the confirmed tracks, with their IDs and center velocities
+ *         when asked for
+ */
+static uint32_t Tracker_PredictTracks(nn_detection_t *out, uint32_t *ids, float (*vel)[2],
+                                      uint32_t max_nb, uint32_t cycles) {
+  uint32_t nb = 0;
+
+  tx_mutex_get(&trk_ctx.mutex, TX_WAIT_FOREVER);
+
+  for (uint32_t t = 0; t < TRACKER_MAX_TRACKS && nb < max_nb; t++) {
+    const tracker_track_t *track = &trk_ctx.tracks[t];
+    float dt, z[TRACKER_COORDS];
+
+    /* Confirmed and seen by the last update: missed tracks are kept for
+     * association only, not shown */
+    if (!track->active || track->hits < TRACKER_MIN_HITS || track->misses > 0) {
+      continue;
+    }
+
+    dt = Tracker_Elapsed(track->stamp, cycles);
+    for (int c = 0; c < TRACKER_COORDS; c++) {
+      z[c] = track->kf[c].pos + track->kf[c].vel * dt;
+    }
+    Tracker_ToBox(z, track, &out[nb]);
+    if (ids != NULL) {
+      ids[nb] = track->id;
+    }
+    if (vel != NULL) {
+      vel[nb][0] = track->kf[TRACKER_CX].vel;
+      vel[nb][1] = track->kf[TRACKER_CY].vel;
+    }
+    nb++;
+  }
+
+  tx_mutex_put(&trk_ctx.mutex);
+  return nb;
+}
+
+/**
+ * @brief  Predict the confirmed tracks at a point in time
+ */
+uint32_t Tracker_Predict(nn_detection_t *out, uint32_t *ids, uint32_t max_nb, uint32_t cycles) {
+  return Tracker_PredictTracks(out, ids, NULL, max_nb, cycles);
+}
+
+/**
+ * @brief  Predict the confirmed tracks at a point in time, with their motion
+ */
+uint32_t Tracker_PredictMotion(nn_detection_t *out, float (*vel)[2], uint32_t max_nb, uint32_t cycles) {
+  return Tracker_PredictTracks(out, NULL, vel, max_nb, cycles);
+}
+
+/**
+ * @brief  Create the tracker lock and drop every track
+ */
+void Tracker_Init(void) {
+  memset(&trk_ctx, 0, sizeof(trk_ctx));
+  trk_ctx.next_id = 1;
+  APP_REQUIRE_EQ(tx_mutex_create(&trk_ctx.mutex, "tracker", TX_INHERIT), TX_SUCCESS);
+}
+
+#endif /* TRACKER_ENABLE */
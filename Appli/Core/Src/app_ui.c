@@ -18,16 +18,42 @@
  */
 
 #include "app_ui.h"
+#include "app_boottime.h"
 #include "app_buffers.h"
+#include "app_cam.h"
 #include "app_config.h"
+#include "app_crashlog.h"
+#include "app_error.h"
+#include "app_framestats.h"
+#include "app_irq.h"
+#include "app_isrprof.h"
+#include "app_latency.h"
 #include "app_lcd.h"
-#include "stm32_lcd.h"
+#include "app_membench.h"
+#include "app_nn.h"
+#include "app_npu_bw.h"
+#include "app_overlay.h"
+#include "app_periodic.h"
+#include "app_pipebench.h"
+#include "app_prefetch.h"
+#include "app_profile.h"
+#include "app_profiler.h"
+#include "app_qos.h"
+#include "app_selftest.h"
+#include "app_telemetry.h"
+#include "app_threadprof.h"
+#include "app_time.h"
+#include "app_tracker.h"
 #include "stm32n6570_discovery_lcd.h"
 #include "stm32n6xx_hal.h"
+#include "utils.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
+/* Diagnostics text refresh period; detection boxes follow every inference */
+#define UI_STATS_PERIOD_MS 1000
+
 /* UI panel configuration - left side of screen */
 #define UI_PANEL_X0 0
 #define UI_PANEL_Y0 0
@@ -47,6 +73,87 @@
 #define UI_COLOR_VALUE 0xFFFFFFFF  /* White for values */
 #define UI_COLOR_BAR_BG 0xFF202020 /* Dark gray bar background */
 #define UI_COLOR_BAR_FG 0xFF00CC00 /* Green bar fill */
+#define UI_COLOR_BOX 0xFFFF4040    /* Red detection boxes */
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_EPOCHS && !NN_EPOCH_PROFILER
+#error "UI_BOTTOM_PANEL_EPOCHS requires NN_EPOCH_PROFILER"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_LATENCY && !LATENCY_PROFILER
+#error "UI_BOTTOM_PANEL_LATENCY requires LATENCY_PROFILER"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THREADS && !THREAD_PROFILER
+#error "UI_BOTTOM_PANEL_THREADS requires THREAD_PROFILER"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_BANDWIDTH && !NPU_BW_REPORT
+#error "UI_BOTTOM_PANEL_BANDWIDTH requires NPU_BW_REPORT"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_FRAMES && !FRAME_STATS
+#error "UI_BOTTOM_PANEL_FRAMES requires FRAME_STATS"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS && (!TRACKER_ENABLE || DISPLAY_SINGLE_PIPE)
+#error "UI_BOTTOM_PANEL_THUMBS requires TRACKER_ENABLE and the Pipe1 display ring"
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS && (!LATENCY_PROFILER || !NPU_BW_REPORT)
+#error "UI_BOTTOM_PANEL_GRAPHS requires LATENCY_PROFILER and NPU_BW_REPORT"
+#endif
+
+#if UI_BOTTOM_PANEL != UI_BOTTOM_PANEL_NONE
+/* Profiler panel: bottom-left column, below the diagnostics panel */
+#define UI_PROF_X0 0
+#define UI_PROF_Y0 UI_PANEL_HEIGHT
+#define UI_PROF_WIDTH UI_PANEL_WIDTH
+#define UI_PROF_HEIGHT (UI_LAYER_HEIGHT - UI_PANEL_HEIGHT)
+#define UI_PROF_TOP_NB 10
+#define UI_PROF_FONT_HEIGHT 12 /* Cache Font12.Height */
+#define UI_PROF_LINE_HEIGHT (UI_PROF_FONT_HEIGHT + 2)
+#define UI_PROF_ROW_Y(n) (UI_PROF_Y0 + UI_TEXT_MARGIN_Y + 2 * UI_LINE_HEIGHT + (n) * UI_PROF_LINE_HEIGHT)
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_LATENCY
+/* Latency panel: per stage a text row and a bar per histogram bin */
+#define UI_LAT_BAR_HEIGHT 20
+#define UI_LAT_BIN_WIDTH ((UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X) / LATENCY_HIST_BINS)
+#define UI_LAT_BLOCK_HEIGHT (UI_PROF_LINE_HEIGHT + UI_LAT_BAR_HEIGHT + 6)
+#define UI_LAT_BLOCK_Y(n) (UI_PROF_ROW_Y(1) + (n) * UI_LAT_BLOCK_HEIGHT)
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THREADS
+/* Thread panel: stack usage at or above this share is highlighted */
+#define UI_THREADS_STACK_WARN_PCT 90
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+/* Thumbnail panel: 2 x 2 tiles with an ID caption each. The DMA2D does not
+ * scale: a tile is a 1:1 window of the frame on the top of the box, where
+ * the head is */
+#define UI_THUMB_NB 4
+#define UI_THUMB_COLS 2
+#define UI_THUMB_GAP 4
+#define UI_THUMB_WIDTH ((UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X - (UI_THUMB_COLS - 1) * UI_THUMB_GAP) / UI_THUMB_COLS)
+#define UI_THUMB_CELL_HEIGHT ((UI_PROF_Y0 + UI_PROF_HEIGHT - UI_PROF_ROW_Y(0)) / (UI_THUMB_NB / UI_THUMB_COLS))
+#define UI_THUMB_HEIGHT (UI_THUMB_CELL_HEIGHT - UI_PROF_LINE_HEIGHT)
+#define UI_THUMB_X(n) (UI_TEXT_MARGIN_X + ((n) % UI_THUMB_COLS) * (UI_THUMB_WIDTH + UI_THUMB_GAP))
+#define UI_THUMB_Y(n) (UI_PROF_ROW_Y(0) + ((n) / UI_THUMB_COLS) * UI_THUMB_CELL_HEIGHT)
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+/* Graph panel: per series a text row with the latest sample, then a strip
+ * of one column per sample, the newest on the right */
+#define UI_GRAPH_NB 5
+#define UI_GRAPH_X UI_TEXT_MARGIN_X
+#define UI_GRAPH_WIDTH (UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X)
+#define UI_GRAPH_BLOCK_HEIGHT ((UI_PROF_Y0 + UI_PROF_HEIGHT - UI_PROF_ROW_Y(0)) / UI_GRAPH_NB)
+#define UI_GRAPH_HEIGHT (UI_GRAPH_BLOCK_HEIGHT - UI_PROF_LINE_HEIGHT - 2)
+#define UI_GRAPH_BLOCK_Y(n) (UI_PROF_ROW_Y(0) + (n) * UI_GRAPH_BLOCK_HEIGHT)
+#define UI_GRAPH_Y(n) (UI_GRAPH_BLOCK_Y(n) + UI_PROF_LINE_HEIGHT)
+#endif
+
+/* Detection box outline thickness and label tab width ("NN%") */
+#define UI_BOX_THICKNESS 2
+#define UI_LABEL_WIDTH (3 * OVERLAY_GLYPH_WIDTH + 2)
+
+/* Damage record: one box outline and one label tab per detection */
+#define UI_DAMAGE_MAX (2 * NN_MAX_DETECTIONS)
 
 /* Maximum text buffer size */
 #define UI_TEXT_BUFFER_SIZE 48
@@ -61,18 +168,145 @@ static const uint16_t g_line_y[] = {
     UI_TEXT_MARGIN_Y + 4 * UI_LINE_HEIGHT,  /* Line 4: CPU Bar */
     UI_TEXT_MARGIN_Y + 6 * UI_LINE_HEIGHT,  /* Line 6: Runtime Label */
     UI_TEXT_MARGIN_Y + 7 * UI_LINE_HEIGHT,  /* Line 7: Runtime Value */
+    UI_TEXT_MARGIN_Y + 8 * UI_LINE_HEIGHT,  /* Line 8: Inference Label */
+    UI_TEXT_MARGIN_Y + 9 * UI_LINE_HEIGHT,  /* Line 9: Inference Value */
+    UI_TEXT_MARGIN_Y + 10 * UI_LINE_HEIGHT, /* Line 10: Rate, Detection Count */
 };
 
 /* Global CPU load tracker */
 static cpuload_info_t g_cpu_load;
 
-/* Idle time accumulator (updated from idle thread hooks) */
-static volatile uint32_t g_idle_cycles_total = 0;
-static volatile uint32_t g_idle_enter_cycle = 0;
-static volatile uint8_t g_in_idle = 0;
+/* Latest inference result, one reference held from UI_Init() on */
+static const nn_result_t *g_nn_result;
+
+#if UI_BUFFER_NB > 2 && LATENCY_PROFILER
+/* Result of the last present, referenced until a vblank latches its buffer */
+static struct {
+  const nn_result_t *result;
+  const uint8_t *buffer; /* NULL once recorded */
+} g_ui_presented;
+#endif
+
+#if TRACKER_ENABLE
+/* Tracked boxes predicted at the camera frame on screen */
+static nn_detection_t g_ui_tracks[TRACKER_MAX_TRACKS];
+#endif
+
+/* Sleep time accumulator (us, updated from the scheduler idle hooks, 64-bit: read masked).
+ * Time_GetUs() keeps counting through WFI, the DWT cycle counter may not. */
+static volatile uint64_t g_idle_us_total SHARED_STATE = 0;
+static volatile uint64_t g_idle_enter_us SHARED_STATE = 0;
+static volatile uint8_t g_in_idle SHARED_STATE = 0;
+
+/**
+ * @brief  Rectangle drawn into a UI buffer, erased when that buffer is reused
+ */
+typedef struct {
+  int16_t x;
+  int16_t y;
+  int16_t width;
+  int16_t height;
+  uint8_t thickness; /* Outline thickness, 0 for a filled rectangle */
+} ui_damage_rect_t;
+
+/* Per-buffer damage lists, indexed like ui_display_buffers. Everything outside
+ * the panel column and these rectangles stays transparent across frames. */
+static struct {
+  ui_damage_rect_t rects[UI_DAMAGE_MAX];
+  uint32_t nb;
+} g_ui_damage[UI_BUFFER_NB];
+
+/**
+ * @brief  Panel column region: redrawn in one buffer when its content
+ *         changes, copied forward into the others by the next updates
+ */
+typedef struct {
+  ui_damage_rect_t rect;
+  uint32_t version[UI_BUFFER_NB]; /* Content version each UI buffer holds, 0 = none */
+} ui_region_t;
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+/* Track thumbnails: the newest track IDs, their windows in the display slot
+ * lent until both UI buffers hold them */
+static struct {
+  uint32_t track_ids[TRACKER_MAX_TRACKS]; /* IDs of g_ui_tracks */
+  nn_detection_t boxes[TRACKER_MAX_TRACKS];
+  uint32_t box_ids[TRACKER_MAX_TRACKS];
+  uint32_t ids[UI_THUMB_NB]; /* Newest first */
+  const uint8_t *src[UI_THUMB_NB];
+  uint32_t nb;
+  uint8_t lent;
+  uint32_t generation; /* Incremented when the IDs change */
+  ui_region_t region;  /* Versioned by generation */
+} g_ui_thumbs = {
+    .region = {.rect = {UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0}},
+};
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+/* Graph series: name, full scale and whether samples are tenths */
+typedef struct {
+  const char *name;
+  uint32_t full_scale;
+  uint8_t tenths;
+} ui_graph_desc_t;
+
+static const ui_graph_desc_t g_ui_graph_desc[UI_GRAPH_NB] = {
+    {"FPS", 10U * UI_GRAPH_FPS_MAX, 1},
+    {"NPU ms", 10U * UI_GRAPH_NPU_MAX_MS, 1},
+    {"PP ms", 10U * UI_GRAPH_PP_MAX_MS, 1},
+    {"E2E ms", 10U * UI_GRAPH_E2E_MAX_MS, 1},
+    {"HYP MB/s", UI_GRAPH_PSRAM_MAX_MBPS, 0},
+};
+
+/* Graph history: one ring of a sample per stats snapshot per series. The
+ * region is versioned by the snapshot generation: a back buffer one sample
+ * behind the last presented one scrolls it instead of redrawing */
+static struct {
+  uint16_t samples[UI_GRAPH_NB][UI_GRAPH_WIDTH];
+  uint32_t head;  /* Next column written */
+  uint32_t count; /* Samples held, UI_GRAPH_WIDTH at most */
+  ui_region_t region;
+} g_ui_graphs = {
+    .region = {.rect = {UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0}},
+};
+#endif
+
+/* Panel values, refreshed on UI_EVENT_STATS only */
+static struct {
+  float cpu_load_pct;
+  uint32_t tick;
+  uint32_t inference_us;
+  uint32_t frame_period_us;
+  uint32_t nb_detect;
+#if MOTION_GATE_ENABLE
+  uint32_t gated_pct;     /* Frames skipped by the motion gate over the stats period */
+  uint32_t last_frames;   /* Inferred and skipped totals of the previous snapshot */
+  uint32_t last_gated;
+#endif
+  uint32_t generation; /* Incremented per snapshot, 0 = never drawn */
+} g_ui_stats;
+
+/* Diagnostics panel (and profiler panel below it), versioned by the stats
+ * snapshot generation */
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_NONE || UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS || \
+    UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+#define UI_PANEL_REGION_HEIGHT UI_PANEL_HEIGHT
+#else
+#define UI_PANEL_REGION_HEIGHT UI_LAYER_HEIGHT
+#endif
+static ui_region_t g_ui_panel_region = {
+    .rect = {UI_PANEL_X0, UI_PANEL_Y0, UI_PANEL_WIDTH, UI_PANEL_REGION_HEIGHT, 0},
+};
+
+/* UI events (UI_EVENT_*) */
+static TX_EVENT_FLAGS_GROUP g_ui_events;
+/* Shortest time between two wake-ups, ticks; events meanwhile coalesce */
+static volatile ULONG g_ui_min_period_ticks = 0;
+static ULONG g_ui_last_wake = 0;
 
 /* UI state */
-static uint8_t g_ui_visible = 1;
+static volatile uint8_t g_ui_visible SHARED_STATE = 1;
 static uint8_t g_ui_initialized = 0;
 
 /* Cached last history update tick to avoid unnecessary shifts */
@@ -82,9 +316,9 @@ static uint32_t g_last_history_update_tick = 0;
  * @brief  Initialize DWT cycle counter for profiling
  */
 void UI_InitCycleCounter(void) {
-  /* Enable DWT and cycle counter */
+  /* Enable DWT and cycle counter; CYCCNT is not reset, Time_GetCycles64()
+   * extends it */
   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-  DWT->CYCCNT = 0;
   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
@@ -100,23 +334,21 @@ uint32_t UI_GetCycleCount(void) {
 #define GET_CYCLE_COUNT() (DWT->CYCCNT)
 
 /**
- * @brief  Idle thread entry hook
+ * @brief  Idle entry hook (sleep entry, interrupts masked)
  */
 void UI_IdleThread_Enter(void) {
   if (!g_in_idle) {
-    g_idle_enter_cycle = GET_CYCLE_COUNT();
+    g_idle_enter_us = Time_GetUs();
     g_in_idle = 1;
   }
 }
 
 /**
- * @brief  Idle thread exit hook
+ * @brief  Idle exit hook (sleep exit, interrupts masked)
  */
 void UI_IdleThread_Exit(void) {
   if (g_in_idle) {
-    uint32_t exit_cycle = GET_CYCLE_COUNT();
-    uint32_t elapsed = exit_cycle - g_idle_enter_cycle;
-    g_idle_cycles_total += elapsed;
+    g_idle_us_total += Time_GetUs() - g_idle_enter_us;
     g_in_idle = 0;
   }
 }
@@ -126,7 +358,7 @@ void UI_IdleThread_Exit(void) {
  */
 void UI_CPULoad_Init(cpuload_info_t *cpu_load) {
   memset(cpu_load, 0, sizeof(cpuload_info_t));
-  g_idle_cycles_total = 0;
+  g_idle_us_total = 0;
   g_last_history_update_tick = 0;
 }
 
@@ -135,8 +367,12 @@ void UI_CPULoad_Init(cpuload_info_t *cpu_load) {
  */
 void UI_CPULoad_Update(cpuload_info_t *cpu_load) {
   uint32_t current_tick = HAL_GetTick();
-  uint32_t current_total = GET_CYCLE_COUNT();
-  uint32_t current_idle = g_idle_cycles_total;
+  uint64_t current_total = Time_GetUs();
+  uint64_t current_idle;
+
+  __disable_irq();
+  current_idle = g_idle_us_total;
+  __enable_irq();
 
   cpu_load->history[1] = cpu_load->history[0];
   cpu_load->history[0].total = current_total;
@@ -152,17 +388,29 @@ void UI_CPULoad_Update(cpuload_info_t *cpu_load) {
   }
 }
 
+/**
+ * @brief  Idle time since UI_CPULoad_Init()
+ */
+uint64_t UI_CPULoad_GetIdleUs(void) {
+  uint64_t idle;
+
+  __disable_irq();
+  idle = g_idle_us_total;
+  __enable_irq();
+  return idle;
+}
+
 /**
  * @brief  Get instantaneous CPU load percentage
  * @param  cpu_load: Pointer to CPU load info structure
  * @retval CPU load percentage (0.0 - 100.0)
  */
 __STATIC_FORCEINLINE float UI_CPULoad_GetInstant(const cpuload_info_t *cpu_load) {
-  uint32_t total_delta = cpu_load->history[0].total - cpu_load->history[1].total;
+  uint64_t total_delta = cpu_load->history[0].total - cpu_load->history[1].total;
   if (total_delta == 0) {
     return 0.0f;
   }
-  uint32_t idle_delta = cpu_load->history[0].idle - cpu_load->history[1].idle;
+  uint64_t idle_delta = cpu_load->history[0].idle - cpu_load->history[1].idle;
   return 100.0f * (1.0f - (float)idle_delta / (float)total_delta);
 }
 
@@ -173,7 +421,7 @@ void UI_CPULoad_GetInfo(cpuload_info_t *cpu_load,
                         float *cpu_load_last,
                         float *cpu_load_last_second,
                         float *cpu_load_last_five_seconds) {
-  uint32_t total_delta, idle_delta;
+  uint64_t total_delta, idle_delta;
 
   if (cpu_load_last) {
     *cpu_load_last = UI_CPULoad_GetInstant(cpu_load);
@@ -273,10 +521,839 @@ static char *UI_FormatPercent(char *buf, float value) {
   return buf;
 }
 
+/**
+ * @brief  Fast fixed-point-to-string with one decimal and a suffix
+ * @param  buf: Output buffer (must be at least 8 bytes + suffix length)
+ * @param  tenths: Value in tenths (clamped to 9999.9)
+ * @param  suffix: Unit suffix appended after the value
+ * @retval Pointer to formatted string
+ */
+static char *UI_FormatTenths(char *buf, uint32_t tenths, const char *suffix) {
+  char digits[4];
+  char *p = buf;
+  uint32_t integer_part;
+  int n = 0;
+
+  if (tenths > 99999)
+    tenths = 99999;
+
+  integer_part = tenths / 10;
+  do {
+    digits[n++] = '0' + (integer_part % 10);
+    integer_part /= 10;
+  } while (integer_part > 0);
+
+  while (n > 0) {
+    *p++ = digits[--n];
+  }
+  *p++ = '.';
+  *p++ = '0' + (tenths % 10);
+  while (*suffix) {
+    *p++ = *suffix++;
+  }
+  *p = '\0';
+  return buf;
+}
+
+/**
+ * @brief  Record a rectangle drawn into the back buffer
+ */
+static void UI_AddDamage(uint32_t buffer_idx, int32_t x, int32_t y,
+                         int32_t width, int32_t height, uint8_t thickness) {
+  ui_damage_rect_t *rect;
+
+  if (g_ui_damage[buffer_idx].nb >= UI_DAMAGE_MAX) {
+    return;
+  }
+
+  rect = &g_ui_damage[buffer_idx].rects[g_ui_damage[buffer_idx].nb++];
+  rect->x = (int16_t)x;
+  rect->y = (int16_t)y;
+  rect->width = (int16_t)width;
+  rect->height = (int16_t)height;
+  rect->thickness = thickness;
+}
+
+/**
+ * @brief  Queue the erase of everything drawn the last time this buffer was used
+ * @param  ctx: Frame area context of the back buffer
+ * @param  buffer_idx: Back buffer index
+ * @note   Queued ahead of the new detections on the overlay ring
+ */
+static void UI_EraseDamage(const overlay_ctx_t *ctx, uint32_t buffer_idx) {
+  for (uint32_t i = 0; i < g_ui_damage[buffer_idx].nb; i++) {
+    const ui_damage_rect_t *rect = &g_ui_damage[buffer_idx].rects[i];
+
+    if (rect->thickness > 0) {
+      Overlay_DrawRect(ctx, rect->x, rect->y, rect->width, rect->height,
+                       rect->thickness, 0x00000000);
+    } else {
+      Overlay_FillRect(ctx, rect->x, rect->y, rect->width, rect->height, 0x00000000);
+    }
+  }
+  g_ui_damage[buffer_idx].nb = 0;
+}
+
+/**
+ * @brief  Bring a panel region of the back buffer to a content version
+ * @param  region: Region and the versions the buffers hold
+ * @param  ctx: Panel column context of the back buffer
+ * @param  buffer_idx: Back buffer index
+ * @param  version: Content version to hold
+ * @retval 1 if the caller must redraw the region, 0 if it is up to date
+ * @note   The last presented buffer holds what the previous update redrew:
+ *         the DMA2D copies it forward instead of drawing it a second time
+ */
+static uint8_t UI_UpdateRegion(ui_region_t *region, const overlay_ctx_t *ctx, uint32_t buffer_idx,
+                               uint32_t version) {
+  uint32_t last = (uint32_t)Buffer_GetUILastIndex();
+
+  if (region->version[buffer_idx] == version) {
+    return 0;
+  }
+  region->version[buffer_idx] = version;
+
+  if (last != buffer_idx && region->version[last] == version) {
+    Overlay_CopyRect(ctx, region->rect.x, region->rect.y, region->rect.width, region->rect.height,
+                     Buffer_GetUIBuffer(last));
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief  Queue detection boxes and confidence labels over the ML frame area
+ * @param  ctx: Frame area context of the back buffer
+ * @param  dets: Boxes, published detections or predicted tracks
+ * @param  nb: Number of boxes
+ * @param  buffer_idx: Back buffer index (damage is recorded against it)
+ */
+static void UI_DrawDetections(const overlay_ctx_t *ctx, const nn_detection_t *dets, uint32_t nb,
+                              uint32_t buffer_idx) {
+  const cam_display_map_t *map = CAM_GetDisplayMap();
+  char label[4];
+
+  for (uint32_t i = 0; i < nb; i++) {
+    const nn_detection_t *det = &dets[i];
+    int32_t x0 = CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center - 0.5f * det->width));
+    int32_t y0 = CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center - 0.5f * det->height));
+    int32_t x1 = CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center + 0.5f * det->width));
+    int32_t y1 = CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center + 0.5f * det->height));
+    uint32_t pct;
+    int32_t box_x, box_y, box_w, box_h;
+    int32_t label_y;
+
+    /* Clip to the detection frame on the display */
+    x0 = MAX(x0, map->x0);
+    y0 = MAX(y0, map->y0);
+    x1 = MIN(x1, map->x1 - 1);
+    y1 = MIN(y1, map->y1 - 1);
+    if (x1 - x0 < 2 || y1 - y0 < 2) {
+      continue;
+    }
+
+    box_x = DISPLAY_LETTERBOX_X0 + x0;
+    box_y = y0;
+    box_w = x1 - x0;
+    box_h = y1 - y0;
+    Overlay_DrawRect(ctx, box_x, box_y, box_w, box_h, UI_BOX_THICKNESS, UI_COLOR_BOX);
+    UI_AddDamage(buffer_idx, box_x, box_y, box_w, box_h, UI_BOX_THICKNESS);
+
+    /* Confidence label on a solid tab above the box, or just inside it at the frame top */
+    pct = (uint32_t)(det->conf * 100.0f + 0.5f);
+    pct = MIN(pct, 99U);
+    label[0] = '0' + pct / 10;
+    label[1] = '0' + pct % 10;
+    label[2] = '%';
+    label[3] = '\0';
+
+    label_y = box_y - OVERLAY_GLYPH_HEIGHT;
+    if (label_y < map->y0) {
+      label_y = box_y;
+    }
+    Overlay_FillRect(ctx, box_x, label_y, UI_LABEL_WIDTH, OVERLAY_GLYPH_HEIGHT, UI_COLOR_BOX);
+    Overlay_DrawText(ctx, box_x + 1, label_y, label, OVERLAY_FONT_16, UI_COLOR_VALUE);
+    UI_AddDamage(buffer_idx, box_x, label_y, UI_LABEL_WIDTH, OVERLAY_GLYPH_HEIGHT, 0);
+  }
+}
+
+#if UI_BOTTOM_PANEL != UI_BOTTOM_PANEL_NONE
+/**
+ * @brief  Right-align an unsigned value in a fixed-width field
+ * @param  p: Output position (width characters written, no terminator)
+ * @param  value: Value (clamped to the field width)
+ * @param  width: Field width in characters (max 9)
+ * @retval Position after the field
+ */
+static char *UI_FormatField(char *p, uint32_t value, int width) {
+  uint32_t limit = 1;
+
+  for (int i = 0; i < width; i++) {
+    limit *= 10;
+  }
+  if (value >= limit)
+    value = limit - 1;
+
+  for (int i = width - 1; i >= 0; i--) {
+    p[i] = (value > 0 || i == width - 1) ? '0' + (value % 10) : ' ';
+    value /= 10;
+  }
+  return p + width;
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+/**
+ * @brief  Pick the newest track IDs, newest first
+ * @retval Number of IDs written to out (UI_THUMB_NB at most)
+ */
+static uint32_t UI_NewestTracks(const uint32_t *ids, uint32_t nb, uint32_t *out) {
+  uint32_t nb_out = 0;
+
+  for (uint32_t i = 0; i < nb; i++) {
+    uint32_t pos = nb_out;
+
+    /* Insertion into the short sorted list, the oldest falls off */
+    while (pos > 0 && ids[i] > out[pos - 1]) {
+      if (pos < UI_THUMB_NB) {
+        out[pos] = out[pos - 1];
+      }
+      pos--;
+    }
+    if (pos < UI_THUMB_NB) {
+      out[pos] = ids[i];
+      nb_out = MIN(nb_out + 1, (uint32_t)UI_THUMB_NB);
+    }
+  }
+
+  return nb_out;
+}
+
+/**
+ * @brief  Re-cut the thumbnails when the newest track IDs changed
+ * @param  nb: Number of tracks in g_ui_tracks / g_ui_thumbs.track_ids
+ * @note   The crops come from the display slot on screen, lent until both
+ *         UI buffers copied them: the DMA2D reads it in place, no CPU copy
+ */
+static void UI_UpdateThumbs(uint32_t nb) {
+  uint32_t ids[UI_THUMB_NB];
+  uint32_t nb_ids = UI_NewestTracks(g_ui_thumbs.track_ids, nb, ids);
+  const cam_display_map_t *map;
+  buffer_frame_tag_t tag;
+  uint32_t nb_boxes;
+  uint8_t *frame;
+  int slot;
+
+  if (nb_ids == g_ui_thumbs.nb && memcmp(ids, g_ui_thumbs.ids, nb_ids * sizeof(ids[0])) == 0) {
+    return;
+  }
+
+  if (g_ui_thumbs.lent) {
+    Buffer_CameraDisplay_Return(BUFFER_LENDER_THUMBS);
+    g_ui_thumbs.lent = 0;
+  }
+  g_ui_thumbs.nb = 0;
+  g_ui_thumbs.generation++;
+
+  if (nb_ids == 0) {
+    return;
+  }
+  slot = Buffer_CameraDisplay_Lend(BUFFER_LENDER_THUMBS, &tag);
+  if (slot < 0) {
+    return;
+  }
+  g_ui_thumbs.lent = 1;
+  frame = Buffer_GetCameraDisplayBuffer(slot);
+  map = CAM_GetSlotDisplayMap(slot);
+
+  /* The boxes at the capture of that very slot */
+  nb_boxes = Tracker_Predict(g_ui_thumbs.boxes, g_ui_thumbs.box_ids, TRACKER_MAX_TRACKS, tag.vsync_cycles);
+
+  for (uint32_t i = 0; i < nb_ids; i++) {
+    for (uint32_t b = 0; b < nb_boxes; b++) {
+      const nn_detection_t *det = &g_ui_thumbs.boxes[b];
+      int32_t x, y;
+
+      if (g_ui_thumbs.box_ids[b] != ids[i]) {
+        continue;
+      }
+
+      /* Centered on the box, from its top edge, inside the detection frame
+       * on the camera display buffer */
+      x = CAM_DisplayMap_X(map, CAM_DISPLAY_MAP_Q15(det->x_center)) - UI_THUMB_WIDTH / 2;
+      y = CAM_DisplayMap_Y(map, CAM_DISPLAY_MAP_Q15(det->y_center - 0.5f * det->height));
+      x = MIN(MAX(x, map->x0), map->x1 - UI_THUMB_WIDTH);
+      y = MIN(MAX(y, map->y0), map->y1 - UI_THUMB_HEIGHT);
+
+      g_ui_thumbs.ids[g_ui_thumbs.nb] = ids[i];
+      g_ui_thumbs.src[g_ui_thumbs.nb] = frame + (y * DISPLAY_LETTERBOX_WIDTH + x) * DISPLAY_BPP;
+      g_ui_thumbs.nb++;
+      break;
+    }
+  }
+}
+
+/**
+ * @brief  Draw the thumbnails of the current generation
+ * @param  ctx: Panel column context of the back buffer
+ */
+static void UI_DrawThumbs(const overlay_ctx_t *ctx) {
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "TRACKS", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  for (uint32_t i = 0; i < g_ui_thumbs.nb; i++) {
+    char *p = text_buf;
+
+    Overlay_DrawRGB565(ctx, UI_THUMB_X(i), UI_THUMB_Y(i), UI_THUMB_WIDTH, UI_THUMB_HEIGHT,
+                       g_ui_thumbs.src[i], DISPLAY_LETTERBOX_WIDTH);
+
+    /* Caption: "ID    42" */
+    strcpy(p, "ID");
+    p = UI_FormatField(p + 2, g_ui_thumbs.ids[i], 6);
+    *p = '\0';
+    Overlay_DrawText(ctx, UI_THUMB_X(i), UI_THUMB_Y(i) + UI_THUMB_HEIGHT + 1,
+                     text_buf, OVERLAY_FONT_12, UI_COLOR_VALUE);
+  }
+}
+
+/**
+ * @brief  Give the lent display slot back once both UI buffers hold the crops
+ * @note   After Overlay_Wait(): the DMA2D is done reading it. The second
+ *         buffer normally gets them copied from the first, but a redraw
+ *         still needs the slot until then
+ */
+static void UI_ReleaseThumbs(void) {
+  if (!g_ui_thumbs.lent) {
+    return;
+  }
+  for (uint32_t i = 0; i < UI_BUFFER_NB; i++) {
+    if (g_ui_thumbs.region.version[i] != g_ui_thumbs.generation) {
+      return;
+    }
+  }
+  Buffer_CameraDisplay_Return(BUFFER_LENDER_THUMBS);
+  g_ui_thumbs.lent = 0;
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+/**
+ * @brief  Append the samples of a stats snapshot to the graph rings
+ * @note   After the snapshot: constant work per sample whatever the history
+ */
+static void UI_SampleGraphs(void) {
+  latency_hist_t hist[LATENCY_STAGE_NB];
+  npu_bw_report_t report;
+  uint32_t period_us = g_ui_stats.frame_period_us;
+  uint32_t latency_us = 0;
+  uint32_t values[UI_GRAPH_NB];
+
+  if (Latency_GetHistograms(hist) > 0) {
+    for (uint32_t s = 0; s < LATENCY_STAGE_NB; s++) {
+      latency_us += hist[s].avg_us;
+    }
+  }
+  NPUBw_GetReport(&report);
+
+  /* Same order as g_ui_graph_desc */
+  values[0] = period_us ? 10000000U / period_us : 0;
+  values[1] = g_ui_stats.inference_us / 100U;
+  values[2] = g_nn_result->postprocess_us / 100U;
+  values[3] = latency_us / 100U;
+  /* Bytes of an inference over its period: bytes per us is MB/s */
+  values[4] = period_us ? (uint32_t)MIN((report.pools[NPU_BW_POOL_PSRAM].in_bytes +
+                                         report.pools[NPU_BW_POOL_PSRAM].out_bytes) / period_us, 0xFFFFU)
+                        : 0;
+
+  for (uint32_t g = 0; g < UI_GRAPH_NB; g++) {
+    g_ui_graphs.samples[g][g_ui_graphs.head] = (uint16_t)MIN(values[g], 0xFFFFU);
+  }
+  g_ui_graphs.head = (g_ui_graphs.head + 1) % UI_GRAPH_WIDTH;
+  g_ui_graphs.count = MIN(g_ui_graphs.count + 1, (uint32_t)UI_GRAPH_WIDTH);
+}
+
+/**
+ * @brief  Newest sample of a series, 0 before the first snapshot
+ */
+static uint32_t UI_GraphLatest(uint32_t g) {
+  return g_ui_graphs.samples[g][(g_ui_graphs.head + UI_GRAPH_WIDTH - 1) % UI_GRAPH_WIDTH];
+}
+
+/**
+ * @brief  Draw one sample column over the strip background
+ * @param  g: Series
+ * @param  x: Column
+ * @param  value: Sample, clipped to the full scale and then drawn red
+ */
+static void UI_DrawGraphColumn(const overlay_ctx_t *ctx, uint32_t g, int32_t x, uint32_t value) {
+  uint32_t full = g_ui_graph_desc[g].full_scale;
+  uint32_t h = (MIN(value, full) * UI_GRAPH_HEIGHT + full - 1) / full;
+
+  if (h > 0) {
+    Overlay_FillRect(ctx, x, UI_GRAPH_Y(g) + UI_GRAPH_HEIGHT - h, 1, h,
+                     value > full ? UI_COLOR_BOX : UI_COLOR_BAR_FG);
+  }
+}
+
+/**
+ * @brief  Draw the text row of a series: "NPU ms      23.4"
+ */
+static void UI_DrawGraphRow(const overlay_ctx_t *ctx, uint32_t g) {
+  uint32_t value = UI_GraphLatest(g);
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+
+  Overlay_FillRect(ctx, UI_GRAPH_X, UI_GRAPH_BLOCK_Y(g), UI_GRAPH_WIDTH, UI_PROF_LINE_HEIGHT, 0x00000000);
+  Overlay_DrawLabel(ctx, UI_GRAPH_X, UI_GRAPH_BLOCK_Y(g), g_ui_graph_desc[g].name, OVERLAY_FONT_12,
+                    UI_COLOR_LABEL);
+
+  if (g_ui_graph_desc[g].tenths) {
+    UI_FormatTenths(text_buf, value, "");
+  } else {
+    *UI_FormatField(text_buf, value, 5) = '\0';
+  }
+  Overlay_DrawText(ctx, UI_GRAPH_X + UI_GRAPH_WIDTH - strlen(text_buf) * OVERLAY_GLYPH12_WIDTH,
+                   UI_GRAPH_BLOCK_Y(g), text_buf, OVERLAY_FONT_12, UI_COLOR_VALUE);
+}
+
+/**
+ * @brief  Draw the whole graph panel from the rings
+ */
+static void UI_DrawGraphs(const overlay_ctx_t *ctx) {
+  int32_t x0 = UI_GRAPH_X + UI_GRAPH_WIDTH - (int32_t)g_ui_graphs.count;
+  uint32_t first = (g_ui_graphs.head + UI_GRAPH_WIDTH - g_ui_graphs.count) % UI_GRAPH_WIDTH;
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "GRAPHS", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  for (uint32_t g = 0; g < UI_GRAPH_NB; g++) {
+    UI_DrawGraphRow(ctx, g);
+    Overlay_FillRect(ctx, UI_GRAPH_X, UI_GRAPH_Y(g), UI_GRAPH_WIDTH, UI_GRAPH_HEIGHT, UI_COLOR_BAR_BG);
+    for (uint32_t i = 0; i < g_ui_graphs.count; i++) {
+      UI_DrawGraphColumn(ctx, g, x0 + (int32_t)i, g_ui_graphs.samples[g][(first + i) % UI_GRAPH_WIDTH]);
+    }
+  }
+}
+
+/**
+ * @brief  Bring the graph panel of the back buffer to the current snapshot
+ * @param  ctx: Panel column context of the back buffer
+ * @param  buffer_idx: Back buffer index
+ * @note   One sample behind the last presented buffer: the DMA2D copies its
+ *         strips one column left, then only the new column and the text
+ *         rows are drawn. Otherwise copied whole or redrawn from the rings
+ */
+static void UI_UpdateGraphs(const overlay_ctx_t *ctx, uint32_t buffer_idx) {
+  ui_region_t *region = &g_ui_graphs.region;
+  uint32_t version = g_ui_stats.generation;
+  uint32_t last = (uint32_t)Buffer_GetUILastIndex();
+  const uint8_t *source;
+
+  if (last == buffer_idx || region->version[buffer_idx] == version || region->version[last] == 0 ||
+      region->version[last] + 1 != version) {
+    if (UI_UpdateRegion(region, ctx, buffer_idx, version)) {
+      UI_DrawGraphs(ctx);
+    }
+    return;
+  }
+  region->version[buffer_idx] = version;
+  source = Buffer_GetUIBuffer(last);
+
+  /* Title and separator never change */
+  Overlay_CopyRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_ROW_Y(0) - UI_PROF_Y0, source);
+  for (uint32_t g = 0; g < UI_GRAPH_NB; g++) {
+    int32_t x = UI_GRAPH_X + UI_GRAPH_WIDTH - 1;
+
+    UI_DrawGraphRow(ctx, g);
+    Overlay_ScrollRect(ctx, UI_GRAPH_X, UI_GRAPH_Y(g), UI_GRAPH_WIDTH - 1, UI_GRAPH_HEIGHT, source, 1);
+    Overlay_FillRect(ctx, x, UI_GRAPH_Y(g), 1, UI_GRAPH_HEIGHT, UI_COLOR_BAR_BG);
+    UI_DrawGraphColumn(ctx, g, x, UI_GraphLatest(g));
+  }
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_EPOCHS
+/**
+ * @brief  Draw the slowest NPU epochs of the last profiler window
+ */
+static void UI_DrawEpochProfile(const overlay_ctx_t *ctx) {
+  profiler_epoch_stat_t stats[UI_PROF_TOP_NB];
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+  uint32_t nb;
+
+  nb = Profiler_GetSlowest(stats, UI_PROF_TOP_NB);
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "NPU EPOCHS", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(0),
+                    "EP    AVG   MAX us  M%", OVERLAY_FONT_12, UI_COLOR_LABEL);
+
+  /* Row: "226S  1234  5678  12%", SW/hybrid epochs tagged after the number,
+   * then the NPU cache read miss share */
+  for (uint32_t i = 0; i < nb; i++) {
+    char *p = UI_FormatField(text_buf, (uint32_t)stats[i].epoch, 3);
+    *p++ = stats[i].kind == PROFILER_EPOCH_HW ? ' ' : stats[i].kind;
+    *p++ = ' ';
+    p = UI_FormatField(p, stats[i].avg_us, 5);
+    *p++ = ' ';
+    p = UI_FormatField(p, stats[i].max_us, 5);
+    *p++ = ' ';
+    p = UI_FormatField(p, (stats[i].read_miss_permille + 5U) / 10U, 3);
+    *p++ = '%';
+    *p = '\0';
+
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + i),
+                     text_buf, OVERLAY_FONT_12,
+                     stats[i].kind == PROFILER_EPOCH_HW ? UI_COLOR_VALUE : UI_COLOR_BOX);
+  }
+
+#if WEIGHT_PREFETCH_ENABLE
+  /* Footer: "PF  180 HIT  12 MISS", staged weight tensors of the last inference */
+  prefetch_stats_t pf;
+  Prefetch_GetStats(&pf);
+
+  char *p = text_buf;
+  *p++ = 'P';
+  *p++ = 'F';
+  p = UI_FormatField(p, pf.hits, 5);
+  strcpy(p, " HIT");
+  p += 4;
+  p = UI_FormatField(p, pf.misses, 4);
+  strcpy(p, " MISS");
+
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + UI_PROF_TOP_NB),
+                   text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+#endif
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_LATENCY
+/**
+ * @brief  Draw the per-stage latency histograms of the last window
+ */
+static void UI_DrawLatencyProfile(const overlay_ctx_t *ctx) {
+  static const char *const stage_names[LATENCY_STAGE_NB] = {"CAP>NPU", "NPU>PP ", "PP>SCAN"};
+  latency_hist_t hist[LATENCY_STAGE_NB];
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+  uint32_t frames;
+
+  frames = Latency_GetHistograms(hist);
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "LATENCY", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(0),
+                    "STAGE   AVG  MAX ms", OVERLAY_FONT_12, UI_COLOR_LABEL);
+
+  for (uint32_t s = 0; frames > 0 && s < LATENCY_STAGE_NB; s++) {
+    uint32_t peak = 1;
+    char *p;
+
+    /* Row: "CAP>NPU   38   52", then the histogram scaled to its fullest bin */
+    p = text_buf;
+    for (const char *n = stage_names[s]; *n; n++) {
+      *p++ = *n;
+    }
+    p = UI_FormatField(p, (hist[s].avg_us + 500) / 1000, 4);
+    *p++ = ' ';
+    p = UI_FormatField(p, (hist[s].max_us + 500) / 1000, 4);
+    *p = '\0';
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_LAT_BLOCK_Y(s),
+                     text_buf, OVERLAY_FONT_12, UI_COLOR_VALUE);
+
+    for (uint32_t b = 0; b < LATENCY_HIST_BINS; b++) {
+      peak = MAX(peak, (uint32_t)hist[s].bins[b]);
+    }
+    for (uint32_t b = 0; b < LATENCY_HIST_BINS; b++) {
+      uint32_t x = UI_TEXT_MARGIN_X + b * UI_LAT_BIN_WIDTH;
+      uint32_t y = UI_LAT_BLOCK_Y(s) + UI_PROF_LINE_HEIGHT;
+      uint32_t h = (hist[s].bins[b] * UI_LAT_BAR_HEIGHT + peak - 1) / peak;
+
+      Overlay_FillRect(ctx, x, y, UI_LAT_BIN_WIDTH - 2, UI_LAT_BAR_HEIGHT, UI_COLOR_BAR_BG);
+      if (h > 0) {
+        Overlay_FillRect(ctx, x, y + UI_LAT_BAR_HEIGHT - h, UI_LAT_BIN_WIDTH - 2, h, UI_COLOR_BAR_FG);
+      }
+    }
+  }
+
+  /* Bin axis: first and last bin edges */
+  UI_FormatTenths(text_buf, 2U * LATENCY_BIN0_US / 100U, "ms");
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_LAT_BLOCK_Y(LATENCY_STAGE_NB),
+                   text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+  UI_FormatTenths(text_buf, (LATENCY_BIN0_US << (LATENCY_HIST_BINS - 1)) / 100U, "ms");
+  Overlay_DrawText(ctx, UI_PROF_WIDTH - UI_TEXT_MARGIN_X - strlen(text_buf) * OVERLAY_GLYPH12_WIDTH,
+                   UI_LAT_BLOCK_Y(LATENCY_STAGE_NB), text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THREADS
+/**
+ * @brief  Format one thread panel row: "nn_post  38.5%  45%"
+ * @param  p: Output buffer
+ * @param  name: Row name (truncated to 7 characters)
+ * @param  cpu_permille: CPU share
+ * @param  stack_pct: Stack high-water mark, or -1 for none
+ */
+static void UI_FormatThreadRow(char *p, const char *name, uint32_t cpu_permille, int32_t stack_pct) {
+  int i;
+
+  for (i = 0; i < 7 && name[i]; i++) {
+    *p++ = name[i];
+  }
+  for (; i < 8; i++) {
+    *p++ = ' ';
+  }
+  p = UI_FormatField(p, cpu_permille / 10, 3);
+  *p++ = '.';
+  *p++ = '0' + cpu_permille % 10;
+  *p++ = '%';
+  if (stack_pct >= 0) {
+    *p++ = ' ';
+    p = UI_FormatField(p, (uint32_t)stack_pct, 3);
+    *p++ = '%';
+  }
+  *p = '\0';
+}
+
+/**
+ * @brief  Draw the per-thread CPU share and stack high-water marks of the last window
+ */
+static void UI_DrawThreadProfile(const overlay_ctx_t *ctx) {
+  threadprof_report_t report;
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+  uint32_t row = 1;
+
+  ThreadProf_GetReport(&report);
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "THREADS", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(0),
+                    "NAME      CPU  STK", OVERLAY_FONT_12, UI_COLOR_LABEL);
+
+  /* Rows in creation order, then ISR and idle shares */
+  for (uint32_t i = 0; report.window_us > 0 && i < report.nb_threads; i++) {
+    const threadprof_thread_t *t = &report.threads[i];
+    int32_t stack_pct = t->stack_size ? (int32_t)(t->stack_used * 100U / t->stack_size) : 0;
+
+    UI_FormatThreadRow(text_buf, t->name, t->cpu_permille, stack_pct);
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(row++),
+                     text_buf, OVERLAY_FONT_12,
+                     stack_pct >= UI_THREADS_STACK_WARN_PCT ? UI_COLOR_BOX : UI_COLOR_VALUE);
+  }
+
+  if (report.window_us > 0) {
+    UI_FormatThreadRow(text_buf, "ISR", report.isr_permille, -1);
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(row++),
+                     text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+    UI_FormatThreadRow(text_buf, "IDLE", report.idle_permille, -1);
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(row),
+                     text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+  }
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_BANDWIDTH
+/**
+ * @brief  Format NPU cycles as millions with one decimal ("1234.5", 6 characters)
+ */
+static char *UI_FormatMcycles(char *p, uint64_t cycles) {
+  uint32_t tenths = (uint32_t)MIN(cycles / 100000U, 99999U);
+
+  p = UI_FormatField(p, tenths / 10, 4);
+  *p++ = '.';
+  *p++ = '0' + tenths % 10;
+  return p;
+}
+
+/**
+ * @brief  Draw the stream engine stall cycles per memory pool of the last inference
+ */
+static void UI_DrawBandwidthProfile(const overlay_ctx_t *ctx) {
+  static const char *const pool_names[NPU_BW_POOL_NB] = {"AXI", "HYP", "FLS", "OTH"};
+  npu_bw_report_t report;
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+  uint32_t bottleneck = 0;
+
+  NPUBw_GetReport(&report);
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "NPU BANDWIDTH", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(0),
+                    "MEM  IN Mc OUT Mc  BN%", OVERLAY_FONT_12, UI_COLOR_LABEL);
+
+  for (uint32_t i = 1; i < NPU_BW_POOL_NB; i++) {
+    if (report.pools[i].critical_cycles > report.pools[bottleneck].critical_cycles) {
+      bottleneck = i;
+    }
+  }
+
+  /* Row: "AXI   12.3   45.6   80%", input and output stall cycles, then the
+   * share of NPU time the pool held the busiest engine; the largest is red */
+  for (uint32_t i = 0; report.nb_blocks > 0 && i < NPU_BW_POOL_NB; i++) {
+    const npu_bw_pool_t *pool = &report.pools[i];
+    char *p = text_buf;
+
+    memcpy(p, pool_names[i], 3);
+    p += 3;
+    *p++ = ' ';
+    p = UI_FormatMcycles(p, pool->in_stall);
+    *p++ = ' ';
+    p = UI_FormatMcycles(p, pool->out_stall);
+    *p++ = ' ';
+    p = UI_FormatField(p, (uint32_t)(pool->critical_cycles * 100U / MAX(report.block_cycles, 1U)), 3);
+    *p++ = '%';
+    *p = '\0';
+
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + i),
+                     text_buf, OVERLAY_FONT_12,
+                     i == bottleneck && pool->critical_cycles > 0 ? UI_COLOR_BOX : UI_COLOR_VALUE);
+  }
+
+  /* Footer: "EB  227  NPU   23.4 Mc", armed epoch blocks and their cycles */
+  if (report.nb_blocks > 0) {
+    char *p = text_buf;
+
+    *p++ = 'E';
+    *p++ = 'B';
+    p = UI_FormatField(p, report.nb_blocks, 5);
+    strcpy(p, "  NPU");
+    p += 5;
+    p = UI_FormatMcycles(p, report.block_cycles);
+    strcpy(p, " Mc");
+
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + NPU_BW_POOL_NB),
+                     text_buf, OVERLAY_FONT_12, UI_COLOR_LABEL);
+  }
+}
+#endif
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_FRAMES
+/**
+ * @brief  Draw the per-pipe frame rates and drop counters of the last window
+ */
+static void UI_DrawFrameStats(const overlay_ctx_t *ctx) {
+  framestats_report_t report;
+  char text_buf[UI_TEXT_BUFFER_SIZE];
+  char *p;
+
+  FrameStats_GetReport(&report);
+
+  Overlay_FillRect(ctx, UI_PROF_X0, UI_PROF_Y0, UI_PROF_WIDTH, UI_PROF_HEIGHT, 0x00000000);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y,
+                    "FRAMES", OVERLAY_FONT_16, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, UI_PROF_Y0 + UI_TEXT_MARGIN_Y + UI_LINE_HEIGHT,
+                   UI_PROF_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
+
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(0),
+                    "P    FPS   OVR  LATE", OVERLAY_FONT_12, UI_COLOR_LABEL);
+
+  if (report.window_us == 0) {
+    return;
+  }
+
+  /* Row: "P1  30.0     0     0", window rate then overruns and late swaps
+   * since boot; red when the window lost a frame */
+  for (uint32_t i = 0; i < CAM_PIPE_NB; i++) {
+    const framestats_pipe_t *pipe = &report.pipes[i];
+    uint8_t lost = pipe->window.overruns + pipe->window.limits + pipe->window.late_swaps > 0;
+
+    p = text_buf;
+    *p++ = 'P';
+    *p++ = '0' + i;
+    *p++ = ' ';
+    p = UI_FormatField(p, pipe->fps_tenths / 10, 3);
+    *p++ = '.';
+    *p++ = '0' + pipe->fps_tenths % 10;
+    *p++ = ' ';
+    p = UI_FormatField(p, pipe->total.overruns + pipe->total.limits, 5);
+    *p++ = ' ';
+    p = UI_FormatField(p, pipe->total.late_swaps, 5);
+    *p = '\0';
+
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + i),
+                     text_buf, OVERLAY_FONT_12, lost ? UI_COLOR_BOX : UI_COLOR_VALUE);
+  }
+
+  /* Pipe2 frames inferred and overwritten unread, Pipe1 frames never shown
+   * and repeated, over the window */
+  p = text_buf;
+  strcpy(p, "INF");
+  p = UI_FormatField(p + 3, report.ml_window.consumed, 5);
+  strcpy(p, " SKIP");
+  p = UI_FormatField(p + 5, report.ml_window.skipped, 5);
+  *p = '\0';
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(1 + CAM_PIPE_NB),
+                   text_buf, OVERLAY_FONT_12, UI_COLOR_VALUE);
+
+  p = text_buf;
+  strcpy(p, "DROP");
+  p = UI_FormatField(p + 4, report.display_dropped, 4);
+  strcpy(p, "  REP");
+  p = UI_FormatField(p + 5, report.display_repeated, 5);
+  *p = '\0';
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(2 + CAM_PIPE_NB),
+                   text_buf, OVERLAY_FONT_12, UI_COLOR_VALUE);
+
+#if LCD_ERROR_MONITOR
+  /* LTDC underruns and transfer errors since boot, with the NPU epoch of
+   * the last one; red when the window had one */
+  {
+    const lcd_error_stats_t *lcd = &report.lcd_total;
+    uint8_t hit = report.lcd_window.underruns + report.lcd_window.transfer_errors > 0;
+
+    p = text_buf;
+    strcpy(p, "UND");
+    p = UI_FormatField(p + 3, lcd->underruns, 5);
+    strcpy(p, " TE");
+    p = UI_FormatField(p + 3, lcd->transfer_errors, 3);
+    strcpy(p, " E");
+    if (lcd->last_epoch >= 0) {
+      p = UI_FormatField(p + 2, (uint32_t)lcd->last_epoch, 3);
+    } else {
+      strcpy(p + 2, "  -");
+      p += 5;
+    }
+    *p = '\0';
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, UI_PROF_ROW_Y(3 + CAM_PIPE_NB),
+                     text_buf, OVERLAY_FONT_12, hit ? UI_COLOR_BOX : UI_COLOR_VALUE);
+  }
+#endif
+}
+#endif
+
 /**
  * @brief  Draw a horizontal progress bar
  */
-static void UI_DrawProgressBar(uint32_t x, uint32_t y,
+static void UI_DrawProgressBar(const overlay_ctx_t *ctx, uint32_t x, uint32_t y,
                                uint32_t width, uint32_t height,
                                float percentage) {
   uint32_t fill_width;
@@ -290,21 +1367,21 @@ static void UI_DrawProgressBar(uint32_t x, uint32_t y,
   fill_width = (uint32_t)((width - 2) * percentage * 0.01f);
 
   /* Draw background (includes border area) */
-  UTIL_LCD_FillRect(x, y, width, height, UI_COLOR_BAR_BG);
+  Overlay_FillRect(ctx, x, y, width, height, UI_COLOR_BAR_BG);
 
   /* Draw fill */
   if (fill_width > 0) {
-    UTIL_LCD_FillRect(x + 1, y + 1, fill_width, height - 2, UI_COLOR_BAR_FG);
+    Overlay_FillRect(ctx, x + 1, y + 1, fill_width, height - 2, UI_COLOR_BAR_FG);
   }
 
   /* Draw border */
-  UTIL_LCD_DrawRect(x, y, width, height, UI_COLOR_TEXT);
+  Overlay_DrawRect(ctx, x, y, width, height, 1, UI_COLOR_TEXT);
 }
 
 /**
  * @brief  Initialize the UI diagnostic display
  */
-void UI_Init(void) {
+IN_XIP void UI_Init(void) {
   if (g_ui_initialized) {
     return;
   }
@@ -315,88 +1392,423 @@ void UI_Init(void) {
   /* Initialize CPU load tracker */
   UI_CPULoad_Init(&g_cpu_load);
 
+  /* DMA2D overlay renderer */
+  Overlay_Init();
+
+  /* Transparent layer buffers: the DMA2D clears them while the sensor is
+   * probed. Waited for here, the layer is made visible after UI_Init() */
+  for (int i = 0; i < UI_BUFFER_NB; i++) {
+    overlay_ctx_t ctx;
+
+    Overlay_CtxInit(&ctx, Buffer_GetUIBuffer(i), 0, 0, UI_LAYER_WIDTH, UI_LAYER_HEIGHT);
+    Overlay_FillRect(&ctx, 0, 0, UI_LAYER_WIDTH, UI_LAYER_HEIGHT, 0x00000000);
+  }
+  Overlay_Submit();
+  Overlay_Wait();
+
+#if LATENCY_PROFILER
+  Latency_Init();
+#endif
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&g_ui_events, "ui_events"), TX_SUCCESS);
+  Periodic_Register(&g_ui_events, UI_EVENT_STATS, UI_STATS_PERIOD_MS);
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+  /* First update draws the empty panel into both buffers */
+  g_ui_thumbs.generation = 1;
+#endif
+
+  /* NN_Init() ran: an empty result until the first inference */
+  g_nn_result = NN_AcquireResult();
+
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+  Buffer_CameraDisplay_SetAligned(g_ui_visible);
+#endif
   g_ui_initialized = 1;
 }
 
 /**
- * @brief  Update and render diagnostic display (optimized)
+ * @brief  Take the values the diagnostics panel shows until the next stats event
  */
-void UI_Update(void) {
-  float cpu_load_pct;
-  uint8_t *ui_buffer;
-  char text_buf[16];
-  uint32_t tick, sec, min;
-  uint32_t bar_width;
-
-  if (!g_ui_initialized || !g_ui_visible) {
-    return;
-  }
-
-  /* Update CPU load measurement */
+static void UI_SnapshotStats(void) {
   UI_CPULoad_Update(&g_cpu_load);
-  cpu_load_pct = UI_CPULoad_GetInstant(&g_cpu_load);
+  g_ui_stats.cpu_load_pct = UI_CPULoad_GetInstant(&g_cpu_load);
+  g_ui_stats.tick = HAL_GetTick();
+  g_ui_stats.inference_us = g_nn_result->inference_us;
+  g_ui_stats.frame_period_us = g_nn_result->frame_period_us;
+  g_ui_stats.nb_detect = g_nn_result->nb_detect;
+#if MOTION_GATE_ENABLE
+  {
+    uint32_t frames = g_nn_result->frame_count - g_ui_stats.last_frames;
+    uint32_t gated = g_nn_result->gated_count - g_ui_stats.last_gated;
 
-  /* Get back buffer for drawing (double buffering) */
-  ui_buffer = Buffer_GetUIBackBuffer();
-  if (ui_buffer == NULL) {
-    return;
+    g_ui_stats.gated_pct = (frames + gated) ? 100U * gated / (frames + gated) : 0;
+    g_ui_stats.last_frames = g_nn_result->frame_count;
+    g_ui_stats.last_gated = g_nn_result->gated_count;
   }
+#endif
+  g_ui_stats.generation++;
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+  UI_SampleGraphs();
+#endif
 
-  /* Set layer buffer address to back buffer for drawing */
-  LCD_SetUILayerAddress(ui_buffer);
-
-  /* Set active layer to UI layer (Layer 1) */
-  UTIL_LCD_SetLayer(LCD_LAYER_1_UI);
+#if THREAD_PROFILER
+  /* Thread windows follow the stats period */
+  ThreadProf_Update();
+#endif
+#if FRAME_STATS
+  FrameStats_Update();
+#endif
+#if BOOT_PROFILER
+  BootTime_Update();
+#endif
+#if MEM_BENCH
+  MemBench_Update();
+#endif
+#if PIPE_BENCH
+  /* After FrameStats_Update(): the pipe rates of this period */
+  PipeBench_Update(g_ui_stats.cpu_load_pct);
+#endif
+#if CRASH_LOG
+  CrashLog_Update(g_ui_stats.inference_us, g_ui_stats.frame_period_us, g_ui_stats.cpu_load_pct);
+#endif
+#if ISR_PROFILER
+  IsrProf_Update();
+#endif
+#if QOS_ENABLE
+  Qos_Update();
+#endif
+#if PROFILE_ENABLE
+  Profile_Update(g_ui_stats.frame_period_us, g_ui_stats.inference_us, g_ui_stats.cpu_load_pct);
+#endif
+#if TELEMETRY
+  Telemetry_PublishSystem(g_ui_stats.frame_period_us, g_ui_stats.cpu_load_pct);
+#endif
+}
 
-  /* Configure LCD drawing context once */
-  UTIL_LCD_SetFont(&Font16);
-  UTIL_LCD_SetBackColor(0x00000000); /* Transparent background */
+/**
+ * @brief  Draw the diagnostics panel column from the last stats snapshot
+ * @param  ctx: Panel column context of the back buffer
+ */
+static void UI_DrawPanel(const overlay_ctx_t *ctx) {
+  char text_buf[16];
+  uint32_t sec, min;
+  uint32_t bar_width;
 
-  /* Clear panel area to fully transparent */
-  UTIL_LCD_FillRect(UI_PANEL_X0, UI_PANEL_Y0,
+  /* Clear the panel to fully transparent. The ML frame area is only erased
+   * where the last detections in this buffer were drawn. */
+  Overlay_FillRect(ctx, UI_PANEL_X0, UI_PANEL_Y0,
                     UI_PANEL_WIDTH, UI_PANEL_HEIGHT, 0x00000000);
 
   /* --- Draw UI elements with minimized state changes --- */
 
   /* Green text group: Title */
-  UTIL_LCD_SetTextColor(UI_COLOR_TEXT);
-  UTIL_LCD_DisplayStringAt(UI_TEXT_MARGIN_X, g_line_y[0],
-                           (uint8_t *)"DIAGNOSTICS", LEFT_MODE);
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, g_line_y[0], "DIAGNOSTICS", OVERLAY_FONT_16, UI_COLOR_TEXT);
 
   /* Separator line (same color) */
-  UTIL_LCD_DrawHLine(UI_TEXT_MARGIN_X, g_line_y[1],
-                     UI_PANEL_WIDTH - 2 * UI_TEXT_MARGIN_X, UI_COLOR_TEXT);
+  Overlay_FillRect(ctx, UI_TEXT_MARGIN_X, g_line_y[1],
+                   UI_PANEL_WIDTH - 2 * UI_TEXT_MARGIN_X, 1, UI_COLOR_TEXT);
 
   /* Gray label group */
-  UTIL_LCD_SetTextColor(UI_COLOR_LABEL);
-  UTIL_LCD_DisplayStringAt(UI_TEXT_MARGIN_X, g_line_y[2],
-                           (uint8_t *)"CPU Load", LEFT_MODE);
-  UTIL_LCD_DisplayStringAt(UI_TEXT_MARGIN_X, g_line_y[5],
-                           (uint8_t *)"Runtime", LEFT_MODE);
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, g_line_y[2], "CPU Load", OVERLAY_FONT_16, UI_COLOR_LABEL);
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, g_line_y[5], "Runtime", OVERLAY_FONT_16, UI_COLOR_LABEL);
+  Overlay_DrawLabel(ctx, UI_TEXT_MARGIN_X, g_line_y[7], "Inference", OVERLAY_FONT_16, UI_COLOR_LABEL);
 
   /* White value group */
-  UTIL_LCD_SetTextColor(UI_COLOR_VALUE);
 
   /* CPU load value */
-  UI_FormatPercent(text_buf, cpu_load_pct);
-  UTIL_LCD_DisplayStringAt(UI_TEXT_MARGIN_X, g_line_y[3],
-                           (uint8_t *)text_buf, LEFT_MODE);
+  UI_FormatPercent(text_buf, g_ui_stats.cpu_load_pct);
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, g_line_y[3], text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
 
   /* Runtime value */
-  tick = HAL_GetTick();
-  sec = tick / 1000;
+  sec = g_ui_stats.tick / 1000;
   min = sec / 60;
   sec = sec % 60;
   UI_FormatRuntime(text_buf, min, sec);
-  UTIL_LCD_DisplayStringAt(UI_TEXT_MARGIN_X, g_line_y[6],
-                           (uint8_t *)text_buf, LEFT_MODE);
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, g_line_y[6], text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
+
+  /* Inference time and rate */
+  UI_FormatTenths(text_buf, g_ui_stats.inference_us / 100, "ms");
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, g_line_y[8], text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
+  UI_FormatTenths(text_buf,
+                  g_ui_stats.frame_period_us ? 10000000U / g_ui_stats.frame_period_us : 0,
+                  "fps");
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X, g_line_y[9], text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
+
+  /* Detection count */
+  text_buf[0] = 'P';
+  text_buf[1] = ':';
+  text_buf[2] = ' ';
+  text_buf[3] = '0' + (g_ui_stats.nb_detect / 10) % 10;
+  text_buf[4] = '0' + g_ui_stats.nb_detect % 10;
+  text_buf[5] = '\0';
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X + UI_PANEL_WIDTH / 2 + 8, g_line_y[9],
+                   text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
+
+#if MOTION_GATE_ENABLE
+  /* Motion gate share of skipped frames, 99 at most */
+  text_buf[0] = 'G';
+  text_buf[1] = ':';
+  text_buf[2] = ' ';
+  text_buf[3] = '0' + MIN(g_ui_stats.gated_pct, 99U) / 10;
+  text_buf[4] = '0' + MIN(g_ui_stats.gated_pct, 99U) % 10;
+  text_buf[5] = '%';
+  text_buf[6] = '\0';
+  Overlay_DrawText(ctx, UI_TEXT_MARGIN_X + UI_PANEL_WIDTH / 2 + 8, g_line_y[8],
+                   text_buf, OVERLAY_FONT_16, UI_COLOR_VALUE);
+#endif
+
+#if SELFTEST_ENABLE
+  {
+    /* Boot self-test verdict, by selftest_verdict_t */
+    static const char *const verdicts[] = {"T: ..", "T:PASS", "T:DRFT", "T:FAIL", "T:NEW", "T: -"};
+    selftest_verdict_t verdict = SelfTest_GetVerdict();
+
+    Overlay_DrawText(ctx, UI_TEXT_MARGIN_X + UI_PANEL_WIDTH / 2 + 8, g_line_y[6], verdicts[verdict],
+                     OVERLAY_FONT_16,
+                     verdict == SELFTEST_FAIL   ? UI_COLOR_BOX
+                     : verdict == SELFTEST_PASS ? UI_COLOR_TEXT
+                                                : UI_COLOR_VALUE);
+  }
+#endif
 
   /* CPU load bar */
   bar_width = UI_PANEL_WIDTH - 2 * UI_TEXT_MARGIN_X;
-  UI_DrawProgressBar(UI_TEXT_MARGIN_X, g_line_y[4], bar_width, 12, cpu_load_pct);
+  UI_DrawProgressBar(ctx, UI_TEXT_MARGIN_X, g_line_y[4], bar_width, 12, g_ui_stats.cpu_load_pct);
+
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_EPOCHS
+  /* Slowest epochs panel */
+  UI_DrawEpochProfile(ctx);
+#elif UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_LATENCY
+  /* Pipeline latency panel */
+  UI_DrawLatencyProfile(ctx);
+#elif UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THREADS
+  /* Per-thread CPU and stack panel */
+  UI_DrawThreadProfile(ctx);
+#elif UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_BANDWIDTH
+  /* NPU stall cycles per memory pool panel */
+  UI_DrawBandwidthProfile(ctx);
+#elif UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_FRAMES
+  /* Frame rate and drop counters per pipe panel */
+  UI_DrawFrameStats(ctx);
+#endif
+}
+
+/**
+ * @brief  Wait for the next UI event
+ */
+uint32_t UI_WaitEvents(void) {
+  ULONG period = g_ui_min_period_ticks;
+  ULONG events;
+
+  if (period != 0) {
+    ULONG since = tx_time_get() - g_ui_last_wake;
+
+    if (since < period) {
+      tx_thread_sleep(period - since);
+    }
+  }
+  APP_REQUIRE_EQ(tx_event_flags_get(&g_ui_events, UI_EVENT_ALL, TX_OR_CLEAR, &events, TX_WAIT_FOREVER), TX_SUCCESS);
+  g_ui_last_wake = tx_time_get();
+  return (uint32_t)events;
+}
+
+/**
+ * @brief  Limit the overlay refresh rate
+ */
+void UI_SetMinPeriod(uint32_t period_ms) {
+  g_ui_min_period_ticks = (period_ms * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U;
+}
+
+/**
+ * @brief  Post UI events (thread or ISR context)
+ */
+void UI_PostEvent(uint32_t events) {
+  if (g_ui_initialized) {
+    tx_event_flags_set(&g_ui_events, events, TX_OR);
+  }
+}
 
-  Buffer_SetUIDisplayIndex(Buffer_GetNextUIDisplayIndex());
+#if UI_BUFFER_NB > 2 && LATENCY_PROFILER
+/**
+ * @brief  Record the scanout latency of the last present once it is latched
+ * @note   A present replaced before any vblank latched it never reached the
+ *         screen and is not recorded
+ */
+static void UI_RecordPresented(void) {
+  uint32_t shown_cycles;
+
+  if (g_ui_presented.buffer != NULL && LCD_GetUILayerShown(&shown_cycles) == g_ui_presented.buffer) {
+    Latency_RecordScanout(g_ui_presented.result, shown_cycles);
+    NN_ReleaseResult(g_ui_presented.result);
+    g_ui_presented.result = NULL;
+    g_ui_presented.buffer = NULL;
+  }
+}
+#endif
+
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+/**
+ * @brief  Stage the overlay and the camera frame its boxes were computed on
+ *         in one section: the line event commits both for the same reload
+ */
+static void UI_PresentAligned(uint8_t *ui_buffer, uint32_t frame_id) {
+  uint32_t basepri = Irq_Lock(MIN(CAM_IRQ_PRIORITY, LCD_IRQ_PRIORITY));
+  int show = Buffer_CameraDisplay_Align(frame_id);
+
+  if (show >= 0) {
+    LCD_ReloadCameraLayer(Buffer_GetCameraDisplayBuffer(show));
+  }
   LCD_ReloadUILayer(ui_buffer);
+  Irq_Unlock(basepri);
+}
+#endif
+
+/**
+ * @brief  Update the widgets the events concern and show the result
+ */
+void UI_Update(uint32_t events) {
+  overlay_ctx_t panel_ctx, frame_ctx;
+  uint8_t *ui_buffer;
+  int buffer_idx;
+#if UI_BUFFER_NB == 2
+  uint32_t scanout_cycles;
+#endif
+
+  if (!g_ui_initialized) {
+    return;
+  }
+
+#if DISPLAY_FOLLOW_ENABLE
+  /* The zoom follows whether the boxes are shown or not */
+  if (events & UI_EVENT_FRAME) {
+    CAM_DisplayFollow_Update();
+  }
+#endif
+
+  /* Hiding only drops the layer: the buffers keep their content and
+   * damage lists, so showing it again redraws in place */
+  if (events & UI_EVENT_VISIBILITY) {
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+    /* No overlay to pair: the frame ISR shows the held frames */
+    Buffer_CameraDisplay_SetAligned(g_ui_visible);
+#endif
+    if (!g_ui_visible) {
+      LCD_SetUILayerVisible(0);
+      return;
+    }
+    events |= UI_EVENT_STATS | UI_EVENT_DETECTIONS;
+  }
+
+  if (!g_ui_visible || (events & (UI_EVENT_STATS | UI_EVENT_DETECTIONS | UI_EVENT_FRAME)) == 0) {
+    return;
+  }
+
+  /* Move to the latest detections; the panel values only move on stats events */
+  NN_ReleaseResult(g_nn_result);
+  g_nn_result = NN_AcquireResult();
+  if (events & UI_EVENT_STATS) {
+    UI_SnapshotStats();
+  }
+
+#if UI_BUFFER_NB > 2 && LATENCY_PROFILER
+  UI_RecordPresented();
+#endif
+
+  /* Get a buffer scanout is done with. Double buffering waited for the last
+   * swap already; a triple-buffered update only waits here when it outran
+   * the display */
+  buffer_idx = Buffer_GetNextUIDisplayIndex();
+  if (buffer_idx < 0) {
+    LCD_WaitUILayerShown();
+    buffer_idx = Buffer_GetNextUIDisplayIndex();
+  }
+  ui_buffer = Buffer_GetUIBuffer(buffer_idx);
+  if (ui_buffer == NULL) {
+    return;
+  }
+
+  /* Panel column and frame area: separate contexts on the same back buffer */
+  Overlay_CtxInit(&panel_ctx, ui_buffer, UI_PANEL_X0, UI_PANEL_Y0, UI_PANEL_WIDTH, UI_LAYER_HEIGHT);
+  Overlay_CtxInit(&frame_ctx, ui_buffer, UI_PANEL_X0 + UI_PANEL_WIDTH, 0,
+                  UI_LAYER_WIDTH - UI_PANEL_X0 - UI_PANEL_WIDTH, UI_LAYER_HEIGHT);
+
+  /* The panel is drawn once per snapshot and copied into the other buffers,
+   * so they never alternate between old and new text. The DMA2D starts on
+   * it while the detections are queued */
+  if (UI_UpdateRegion(&g_ui_panel_region, &panel_ctx, buffer_idx, g_ui_stats.generation)) {
+    UI_DrawPanel(&panel_ctx);
+  }
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_GRAPHS
+  UI_UpdateGraphs(&panel_ctx, buffer_idx);
+#endif
+  Overlay_Submit();
+
+  /* Detection boxes and labels: queued after the erase of the previous ones
+   * in this buffer, drawn while this thread blocks */
+  UI_EraseDamage(&frame_ctx, buffer_idx);
+#if TRACKER_ENABLE
+  {
+    uint32_t at_cycles;
+    uint32_t nb;
+
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+    /* The tracks as of the frame shown with them: no extrapolation */
+    at_cycles = g_nn_result->vsync_cycles;
+#else
+    buffer_display_stats_t display;
+
+    Buffer_CameraDisplay_GetStats(&display);
+    at_cycles = display.front_vsync_cycles;
+#endif
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+    nb = Tracker_Predict(g_ui_tracks, g_ui_thumbs.track_ids, TRACKER_MAX_TRACKS, at_cycles);
+    UI_UpdateThumbs(nb);
+    if (UI_UpdateRegion(&g_ui_thumbs.region, &panel_ctx, buffer_idx, g_ui_thumbs.generation)) {
+      UI_DrawThumbs(&panel_ctx);
+    }
+#else
+    nb = Tracker_Predict(g_ui_tracks, NULL, TRACKER_MAX_TRACKS, at_cycles);
+#endif
+    UI_DrawDetections(&frame_ctx, g_ui_tracks, nb, buffer_idx);
+  }
+#else
+  UI_DrawDetections(&frame_ctx, g_nn_result->detections, g_nn_result->nb_detect, buffer_idx);
+#endif
+  Overlay_Submit();
+  Overlay_Wait();
+#if UI_BOTTOM_PANEL == UI_BOTTOM_PANEL_THUMBS
+  UI_ReleaseThumbs();
+#endif
+
+  Buffer_SetUIDisplayIndex(buffer_idx);
+#if DISPLAY_POLICY == DISPLAY_POLICY_ALIGNED
+  UI_PresentAligned(ui_buffer, g_nn_result->frame_id);
+#else
+  LCD_ReloadUILayer(ui_buffer);
+#endif
+  if (events & UI_EVENT_VISIBILITY) {
+    /* Staged with the buffer: the stale one never reaches the screen */
+    LCD_SetUILayerVisible(1);
+  }
+
+#if UI_BUFFER_NB == 2
+  /* The previous buffer is scanned out until the vblank latches this one:
+   * only then may the next update draw into it */
+  scanout_cycles = LCD_WaitUILayerShown();
+
+#if LATENCY_PROFILER
+  Latency_RecordScanout(g_nn_result, scanout_cycles);
+#else
+  UNUSED(scanout_cycles);
+#endif
+#elif LATENCY_PROFILER
+  /* Scanout is stamped by the next update, once a vblank latched it */
+  NN_ReleaseResult(g_ui_presented.result);
+  NN_RetainResult(g_nn_result);
+  g_ui_presented.result = g_nn_result;
+  g_ui_presented.buffer = ui_buffer;
+#endif
 }
 
 /**
@@ -405,16 +1817,8 @@ void UI_Update(void) {
 void UI_SetVisible(uint8_t visible) {
   g_ui_visible = visible;
 
-  if (!visible) {
-    uint8_t *ui_buffer = Buffer_GetUIBackBuffer();
-    if (ui_buffer != NULL) {
-      LCD_SetUILayerAddress(ui_buffer);
-      memset(ui_buffer, 0, LCD_WIDTH * LCD_HEIGHT * 4);
-      SCB_CleanDCache_by_Addr((void *)ui_buffer, LCD_WIDTH * LCD_HEIGHT * 4);
-      Buffer_SetUIDisplayIndex(Buffer_GetNextUIDisplayIndex());
-      LCD_ReloadUILayer(ui_buffer);
-    }
-  }
+  /* Drawing stays on the UI thread */
+  UI_PostEvent(UI_EVENT_VISIBILITY);
 }
 
 /**
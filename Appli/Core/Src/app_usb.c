@@ -0,0 +1,779 @@
+/**
+ ******************************************************************************
+ * @file    app_usb.c
+ * @author  Long Liangmao
+ * @brief   USB composite device for STM32N6570-DK (USB_STREAM_ENABLE)
+ *          One class of its own on the USB device library core: CDC-ACM
+ *          (interfaces 0 and 1) and UVC 1.1 (interfaces 2 and 3), grouped
+ *          by interface association descriptors. The UVC endpoint sends
+ *          H.264 access units as frame-based payloads, one isochronous
+ *          packet per microframe; the CDC bulk endpoint sends runs of
+ *          telemetry records. The OTG DMA reads both in their rings
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_usb.h"
+
+#if USB_STREAM_ENABLE
+
+#include "app_error.h"
+#include "app_periodic.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "app_venc.h"
+#include "stm32n6xx_hal.h"
+#include "usbd_core.h"
+#include "usbd_ctlreq.h"
+#include "usbd_ioreq.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#if !VENC_ENABLE
+#error "USB_STREAM_ENABLE streams the encoded access units: it needs VENC_ENABLE"
+#endif
+#if !TELEMETRY
+#error "USB_STREAM_ENABLE sends the telemetry records: it needs TELEMETRY"
+#endif
+#if ISP_TUNING_ENABLE
+#error "USB_STREAM_ENABLE and ISP_TUNING_ENABLE both need USB1"
+#endif
+
+/* Feeder thread: the ISP tool's slot, the two never run together */
+#define USB_THREAD_STACK_SIZE 2048
+
+#define USB_EVENT_WAKE 0x01U
+#define USB_EVENT_POLL 0x02U /* Every USB_POLL_MS (app_periodic.c) */
+
+/* Not ST's virtual COM port product: its driver would claim the whole device */
+#define USB_VID 0x0483U
+#define USB_PID 0x5750U
+#define USB_MANUFACTURER_STRING "STMicroelectronics"
+#define USB_PRODUCT_STRING "STM32N6 people detector"
+
+/* Interfaces and endpoints; a TX FIFO per IN endpoint (usbd_conf.c) */
+#define USB_ITF_CDC_COMM 0U
+#define USB_ITF_CDC_DATA 1U
+#define USB_ITF_VC 2U
+#define USB_ITF_VS 3U
+#define USB_ITF_NB 4U
+#define USB_CDC_IN_EP 0x81U
+#define USB_CDC_OUT_EP 0x01U
+#define USB_CDC_NOTIFY_EP 0x82U
+#define USB_UVC_EP 0x83U
+#define USB_BULK_PACKET_SIZE 512U
+#define USB_NOTIFY_PACKET_SIZE 8U
+
+/* UVC payload header: length, flags, PTS (4 bytes) and SCR (6 bytes). A
+ * multiple of 4 of payload per packet keeps every in-place header, and so
+ * every DMA start address, word aligned in the 8-byte aligned access unit */
+#define USB_UVC_HEADER_SIZE 12U
+#define USB_UVC_PAYLOAD (USB_UVC_PACKET_SIZE - USB_UVC_HEADER_SIZE)
+#define USB_UVC_BFH_FID 0x01U
+#define USB_UVC_BFH_EOF 0x02U
+#define USB_UVC_BFH_PTS 0x04U
+#define USB_UVC_BFH_SCR 0x08U
+#define USB_UVC_BFH_EOH 0x80U
+#define USB_UVC_CLOCK_HZ 1000000U /* PTS and SCR: Time_GetUs() */
+#define USB_UVC_FRAME_INTERVAL (10000000U * VENC_FRAME_DECIMATION / CAMERA_FPS) /* 100 ns units */
+#define USB_UVC_FRAME_MAX (VENC_FRAME_MAX + VENC_HEADER_MAX)
+
+_Static_assert(USB_UVC_PACKET_SIZE <= 1024 && USB_UVC_PAYLOAD % 4U == 0 &&
+                   USB_UVC_PAYLOAD >= VENC_HEADER_MAX + USB_UVC_HEADER_SIZE + 4U,
+               "USB_UVC_PACKET_SIZE: at most 1024, a multiple of 4, room for the stream header");
+_Static_assert(USB_CDC_BATCH >= 1 && USB_CDC_BATCH <= TELEMETRY_RECORDS, "USB_CDC_BATCH out of range");
+
+/* Class-specific codes (CDC 1.2, UVC 1.1) */
+#define USB_DESC_IAD 0x0BU
+#define USB_DESC_CS_INTERFACE 0x24U
+#define USB_CDC_SET_LINE_CODING 0x20U
+#define USB_CDC_GET_LINE_CODING 0x21U
+#define USB_CDC_SET_CONTROL_LINE_STATE 0x22U
+#define USB_CDC_DTR 0x0001U
+#define USB_UVC_SET_CUR 0x01U
+#define USB_UVC_GET_CUR 0x81U
+#define USB_UVC_GET_MIN 0x82U
+#define USB_UVC_GET_MAX 0x83U
+#define USB_UVC_GET_LEN 0x85U
+#define USB_UVC_GET_INFO 0x86U
+#define USB_UVC_GET_DEF 0x87U
+#define USB_UVC_VS_PROBE 0x01U
+#define USB_UVC_VS_COMMIT 0x02U
+
+#define USB_LE16(v) (uint8_t)(v), (uint8_t)((v) >> 8)
+#define USB_LE32(v) (uint8_t)(v), (uint8_t)((v) >> 8), (uint8_t)((v) >> 16), (uint8_t)((v) >> 24)
+
+/* Video streaming probe and commit controls, UVC 1.1 */
+typedef struct __attribute__((packed)) {
+  uint16_t bmHint;
+  uint8_t bFormatIndex;
+  uint8_t bFrameIndex;
+  uint32_t dwFrameInterval;
+  uint16_t wKeyFrameRate;
+  uint16_t wPFrameRate;
+  uint16_t wCompQuality;
+  uint16_t wCompWindowSize;
+  uint16_t wDelay;
+  uint32_t dwMaxVideoFrameSize;
+  uint32_t dwMaxPayloadTransferSize;
+  uint32_t dwClockFrequency;
+  uint8_t bmFramingInfo;
+  uint8_t bPreferedVersion;
+  uint8_t bMinVersion;
+  uint8_t bMaxVersion;
+} usb_uvc_probe_t;
+
+_Static_assert(sizeof(usb_uvc_probe_t) == 34, "UVC 1.1 probe control is 34 bytes");
+
+/* One format, one frame, one interval: every GET answers the same */
+static const usb_uvc_probe_t usb_uvc_probe = {
+    .bFormatIndex = 1,
+    .bFrameIndex = 1,
+    .dwFrameInterval = USB_UVC_FRAME_INTERVAL,
+    .dwMaxVideoFrameSize = USB_UVC_FRAME_MAX,
+    .dwMaxPayloadTransferSize = USB_UVC_PACKET_SIZE,
+    .dwClockFrequency = USB_UVC_CLOCK_HZ,
+    .bmFramingInfo = USB_UVC_BFH_FID | USB_UVC_BFH_EOF,
+};
+
+static const uint8_t usb_device_desc[USB_LEN_DEV_DESC] = {
+    USB_LEN_DEV_DESC, USB_DESC_TYPE_DEVICE, USB_LE16(0x0200),
+    0xEF, 0x02, 0x01, /* Miscellaneous, interface associations */
+    USB_MAX_EP0_SIZE, USB_LE16(USB_VID), USB_LE16(USB_PID), USB_LE16(0x0100),
+    USBD_IDX_MFC_STR, USBD_IDX_PRODUCT_STR, USBD_IDX_SERIAL_STR, 1,
+};
+
+/* High speed only: no configuration at the other speed */
+static const uint8_t usb_qualifier_desc[USB_LEN_DEV_QUALIFIER_DESC] = {
+    USB_LEN_DEV_QUALIFIER_DESC, USB_DESC_TYPE_DEVICE_QUALIFIER, USB_LE16(0x0200),
+    0xEF, 0x02, 0x01, USB_MAX_EP0_SIZE, 0, 0,
+};
+
+static const uint8_t usb_langid_desc[USB_LEN_LANGID_STR_DESC] = {
+    USB_LEN_LANGID_STR_DESC, USB_DESC_TYPE_STRING, USB_LE16(0x0409),
+};
+
+#define USB_UVC_VC_SIZE (13U + 18U + 9U)
+#define USB_UVC_VS_SIZE (14U + 28U + 30U + 6U)
+#define USB_CONFIG_SIZE (9U + 66U + 8U + 9U + USB_UVC_VC_SIZE + 9U + USB_UVC_VS_SIZE + 9U + 7U)
+
+static const uint8_t usb_config_desc[USB_CONFIG_SIZE] = {
+    9, USB_DESC_TYPE_CONFIGURATION, USB_LE16(USB_CONFIG_SIZE), USB_ITF_NB, 1, 0,
+    0xC0, 50, /* Self powered, 100 mA */
+
+    /* CDC-ACM function */
+    8, USB_DESC_IAD, USB_ITF_CDC_COMM, 2, 0x02, 0x02, 0x01, 0,
+    9, USB_DESC_TYPE_INTERFACE, USB_ITF_CDC_COMM, 0, 1, 0x02, 0x02, 0x01, 0,
+    5, USB_DESC_CS_INTERFACE, 0x00, USB_LE16(0x0120),   /* Header */
+    5, USB_DESC_CS_INTERFACE, 0x01, 0x00, USB_ITF_CDC_DATA, /* Call management */
+    4, USB_DESC_CS_INTERFACE, 0x02, 0x02,               /* ACM: line coding, line state */
+    5, USB_DESC_CS_INTERFACE, 0x06, USB_ITF_CDC_COMM, USB_ITF_CDC_DATA, /* Union */
+    7, USB_DESC_TYPE_ENDPOINT, USB_CDC_NOTIFY_EP, USBD_EP_TYPE_INTR, USB_LE16(USB_NOTIFY_PACKET_SIZE), 16,
+    9, USB_DESC_TYPE_INTERFACE, USB_ITF_CDC_DATA, 0, 2, 0x0A, 0x00, 0x00, 0,
+    7, USB_DESC_TYPE_ENDPOINT, USB_CDC_OUT_EP, USBD_EP_TYPE_BULK, USB_LE16(USB_BULK_PACKET_SIZE), 0,
+    7, USB_DESC_TYPE_ENDPOINT, USB_CDC_IN_EP, USBD_EP_TYPE_BULK, USB_LE16(USB_BULK_PACKET_SIZE), 0,
+
+    /* UVC function: camera terminal 1 -> streaming output terminal 2 */
+    8, USB_DESC_IAD, USB_ITF_VC, 2, 0x0E, 0x03, 0x00, USBD_IDX_PRODUCT_STR,
+    9, USB_DESC_TYPE_INTERFACE, USB_ITF_VC, 0, 0, 0x0E, 0x01, 0x00, USBD_IDX_PRODUCT_STR,
+    13, USB_DESC_CS_INTERFACE, 0x01, USB_LE16(0x0110), USB_LE16(USB_UVC_VC_SIZE),
+    USB_LE32(USB_UVC_CLOCK_HZ), 1, USB_ITF_VS,
+    18, USB_DESC_CS_INTERFACE, 0x02, 1, USB_LE16(0x0201), 0, 0,
+    USB_LE16(0), USB_LE16(0), USB_LE16(0), 3, 0, 0, 0, /* No camera controls */
+    9, USB_DESC_CS_INTERFACE, 0x03, 2, USB_LE16(0x0101), 0, 1, 0,
+
+    /* Streaming interface, alternate 0: no bandwidth */
+    9, USB_DESC_TYPE_INTERFACE, USB_ITF_VS, 0, 0, 0x0E, 0x02, 0x00, 0,
+    14, USB_DESC_CS_INTERFACE, 0x01, 1, USB_LE16(USB_UVC_VS_SIZE), USB_UVC_EP, 0, 2, 0, 0, 0, 1, 0,
+    28, USB_DESC_CS_INTERFACE, 0x10, 1, 1, /* Frame-based format, H.264 GUID */
+    'H', '2', '6', '4', 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71,
+    16, 1, 0, 0, 0, 0, 1, /* Default frame 1, variable size */
+    30, USB_DESC_CS_INTERFACE, 0x11, 1, 0, USB_LE16(DISPLAY_LETTERBOX_WIDTH), USB_LE16(DISPLAY_LETTERBOX_HEIGHT),
+    USB_LE32(VENC_BITRATE), USB_LE32(VENC_BITRATE), USB_LE32(USB_UVC_FRAME_INTERVAL), 1,
+    USB_LE32(0), USB_LE32(USB_UVC_FRAME_INTERVAL),
+    6, USB_DESC_CS_INTERFACE, 0x0D, 1, 1, 4, /* BT.709 primaries and transfer, BT.601 matrix */
+
+    /* Alternate 1: one packet per microframe */
+    9, USB_DESC_TYPE_INTERFACE, USB_ITF_VS, 1, 1, 0x0E, 0x02, 0x00, 0,
+    7, USB_DESC_TYPE_ENDPOINT, USB_UVC_EP, 0x05, USB_LE16(USB_UVC_PACKET_SIZE), 1, /* Isochronous, asynchronous */
+};
+
+/* EP0 and DMA buffers: the OTG DMA neither sees the D-cache nor is kept
+ * coherent with it, so every buffer it reads or writes outside the rings
+ * lives here. Not initialized at load: filled before use */
+static struct {
+  uint8_t desc[USBD_MAX_STR_DESC_SIZ]; /* Descriptor being sent */
+  usb_uvc_probe_t probe;               /* GET reply */
+  usb_uvc_probe_t probe_rx;            /* SET_CUR data, ignored: one setting */
+  uint8_t line_coding[8];              /* Kept for GET_LINE_CODING, unused */
+  uint8_t reply[4];                    /* GET_INFO, GET_LEN, GET_STATUS, GET_INTERFACE */
+  uint8_t cdc_rx[USB_BULK_PACKET_SIZE]; /* Host to device CDC data: telemetry requests */
+  uint8_t stage[USB_UVC_PACKET_SIZE];  /* First packet of a frame: header, SPS and PPS */
+} usb_dma __attribute__((section(".noncacheable"), aligned(32)));
+
+/* Core handle: the core sends its GET_STATUS and GET_CONFIGURATION replies from it */
+static USBD_HandleTypeDef usb_device __attribute__((section(".noncacheable"), aligned(32)));
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[USB_THREAD_STACK_SIZE];
+  TX_EVENT_FLAGS_GROUP events;
+  char serial[9];
+
+  /* Written in the USB interrupt, read by the thread */
+  volatile uint8_t configured;
+  volatile uint8_t streaming; /* Alternate 1 of the streaming interface */
+  volatile uint8_t dtr;       /* Host has the CDC port open */
+  volatile uint8_t need_idr;  /* Next frame sent is a keyframe */
+
+  /* UVC: the frame being sent, owned by the interrupt while busy */
+  venc_au_t au;
+  uint8_t holding; /* au acquired, not released */
+  volatile uint8_t uvc_busy;
+  uint8_t fid;
+  uint32_t off;      /* Access unit bytes queued */
+  uint8_t *pkt;      /* Packet in flight, repeated when missed */
+  uint32_t pkt_len;
+
+  /* CDC: one bulk transfer in flight */
+  uint8_t cdc_attached;
+  volatile uint8_t cdc_busy;
+  uint32_t cdc_nb; /* Records released on completion */
+
+  usb_stats_t stats;
+} usb_ctx;
+
+/**
+ * @brief  Copy a descriptor where the DMA can read it
+ */
+static uint8_t *Usb_Desc(const uint8_t *desc, uint16_t size, uint16_t *length) {
+  memcpy(usb_dma.desc, desc, size);
+  *length = size;
+  return usb_dma.desc;
+}
+
+static uint8_t *Usb_String(const char *str, uint16_t *length) {
+  USBD_GetString((uint8_t *)str, usb_dma.desc, length);
+  return usb_dma.desc;
+}
+
+static uint8_t *Usb_GetDeviceDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_Desc(usb_device_desc, sizeof(usb_device_desc), length);
+}
+
+static uint8_t *Usb_GetLangIdDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_Desc(usb_langid_desc, sizeof(usb_langid_desc), length);
+}
+
+static uint8_t *Usb_GetManufacturerDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_String(USB_MANUFACTURER_STRING, length);
+}
+
+static uint8_t *Usb_GetProductDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_String(USB_PRODUCT_STRING, length);
+}
+
+static uint8_t *Usb_GetSerialDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_String(usb_ctx.serial, length);
+}
+
+static uint8_t *Usb_GetNoStringDesc(USBD_SpeedTypeDef speed, uint16_t *length) {
+  UNUSED(speed);
+  return Usb_String("", length);
+}
+
+static USBD_DescriptorsTypeDef usb_descriptors = {
+    .GetDeviceDescriptor = Usb_GetDeviceDesc,
+    .GetLangIDStrDescriptor = Usb_GetLangIdDesc,
+    .GetManufacturerStrDescriptor = Usb_GetManufacturerDesc,
+    .GetProductStrDescriptor = Usb_GetProductDesc,
+    .GetSerialStrDescriptor = Usb_GetSerialDesc,
+    .GetConfigurationStrDescriptor = Usb_GetNoStringDesc,
+    .GetInterfaceStrDescriptor = Usb_GetNoStringDesc,
+};
+
+static uint8_t *Usb_GetConfigDesc(uint16_t *length) {
+  return Usb_Desc(usb_config_desc, sizeof(usb_config_desc), length);
+}
+
+static uint8_t *Usb_GetQualifierDesc(uint16_t *length) {
+  return Usb_Desc(usb_qualifier_desc, sizeof(usb_qualifier_desc), length);
+}
+
+static void Usb_Wake(void) {
+  tx_event_flags_set(&usb_ctx.events, USB_EVENT_WAKE, TX_OR);
+}
+
+/**
+ * @brief  Write the payload header of a packet
+ * @param  hdr: USB_UVC_HEADER_SIZE bytes before the packet payload
+ * @param  eof: Last packet of the frame
+ */
+static void Usb_UvcHeader(uint8_t *hdr, int eof) {
+  USB_OTG_DeviceTypeDef *dev = (USB_OTG_DeviceTypeDef *)((uint32_t)USB1_OTG_HS + USB_OTG_DEVICE_BASE);
+  /* Microframe number: the SOF counter is the frame, 11 bits */
+  uint32_t sof = ((dev->DSTS & USB_OTG_DSTS_FNSOF) >> USB_OTG_DSTS_FNSOF_Pos) >> 3;
+  uint32_t stc = (uint32_t)Time_GetUs();
+  uint32_t pts = usb_ctx.au.time_us;
+
+  hdr[0] = USB_UVC_HEADER_SIZE;
+  hdr[1] = USB_UVC_BFH_EOH | USB_UVC_BFH_SCR | USB_UVC_BFH_PTS | (eof ? USB_UVC_BFH_EOF : 0U) | usb_ctx.fid;
+  hdr[2] = (uint8_t)pts;
+  hdr[3] = (uint8_t)(pts >> 8);
+  hdr[4] = (uint8_t)(pts >> 16);
+  hdr[5] = (uint8_t)(pts >> 24);
+  hdr[6] = (uint8_t)stc;
+  hdr[7] = (uint8_t)(stc >> 8);
+  hdr[8] = (uint8_t)(stc >> 16);
+  hdr[9] = (uint8_t)(stc >> 24);
+  hdr[10] = (uint8_t)sof;
+  hdr[11] = (uint8_t)((sof >> 8) & 0x07U);
+}
+
+static void Usb_UvcSend(uint8_t *pkt, uint32_t len) {
+  usb_ctx.pkt = pkt;
+  usb_ctx.pkt_len = len;
+  (void)USBD_LL_Transmit(&usb_device, USB_UVC_EP, pkt, len);
+}
+
+/**
+ * @brief  Queue the next packet of the frame in flight, in place
+ * @note   USB interrupt: the previous packet is on the wire, so its last
+ *         USB_UVC_HEADER_SIZE bytes take this packet's header
+ */
+static void Usb_UvcNextPacket(void) {
+  uint32_t len;
+  uint8_t *pkt;
+
+  if (usb_ctx.off == usb_ctx.au.size) {
+    usb_ctx.stats.frames++;
+    usb_ctx.stats.video_bytes += usb_ctx.au.size;
+    usb_ctx.fid ^= USB_UVC_BFH_FID;
+    usb_ctx.uvc_busy = 0;
+    Usb_Wake();
+    return;
+  }
+
+  /* Owned until released: the consumer may overwrite the bytes it sent */
+  pkt = (uint8_t *)usb_ctx.au.data + usb_ctx.off - USB_UVC_HEADER_SIZE;
+  len = MIN(USB_UVC_PAYLOAD, usb_ctx.au.size - usb_ctx.off);
+  usb_ctx.off += len;
+  Usb_UvcHeader(pkt, usb_ctx.off == usb_ctx.au.size);
+  Usb_UvcSend(pkt, USB_UVC_HEADER_SIZE + len);
+}
+
+/**
+ * @brief  Send the held access unit as one frame
+ * @note   Feeder thread. The first packet is staged: a keyframe gets the
+ *         stream header in front for hosts joining late, and the offset of
+ *         the in-place headers that follow stays word aligned
+ */
+static void Usb_UvcStartFrame(void) {
+  const uint8_t *hdr = NULL;
+  uint32_t hdr_size = usb_ctx.au.keyframe ? Venc_GetHeader(&hdr) : 0U;
+  uint32_t room = USB_UVC_PAYLOAD - hdr_size;
+  uint32_t first = usb_ctx.au.size <= room ? usb_ctx.au.size : (room & ~3U);
+  uint32_t primask;
+
+  memcpy(usb_dma.stage + USB_UVC_HEADER_SIZE, hdr, hdr_size);
+  memcpy(usb_dma.stage + USB_UVC_HEADER_SIZE + hdr_size, usb_ctx.au.data, first);
+  usb_ctx.off = first;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (usb_ctx.streaming) {
+    usb_ctx.need_idr = 0;
+    usb_ctx.uvc_busy = 1;
+    Usb_UvcHeader(usb_dma.stage, first == usb_ctx.au.size);
+    Usb_UvcSend(usb_dma.stage, USB_UVC_HEADER_SIZE + hdr_size + first);
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Give the sent frame back and start the next one
+ * @note   Feeder thread. Not streaming, every access unit is released at
+ *         once so the encoder keeps its ring
+ */
+static void Usb_ServiceVideo(void) {
+  venc_au_t au;
+
+  if (usb_ctx.uvc_busy) {
+    return;
+  }
+  if (usb_ctx.holding) {
+    Venc_Release();
+    usb_ctx.holding = 0;
+  }
+
+  while (Venc_Acquire(&au, TX_NO_WAIT)) {
+    /* Stream headers go out with every keyframe instead */
+    if (au.header || !usb_ctx.streaming || (usb_ctx.need_idr && !au.keyframe)) {
+      Venc_Release();
+      if (!au.header) {
+        usb_ctx.stats.drained++;
+      }
+      continue;
+    }
+    usb_ctx.au = au;
+    usb_ctx.holding = 1;
+    Usb_UvcStartFrame();
+    return;
+  }
+}
+
+/**
+ * @brief  Hold the telemetry ring while the port is open and send what is ready
+ * @note   Feeder thread
+ */
+static void Usb_ServiceCdc(void) {
+  int want = usb_ctx.configured && usb_ctx.dtr;
+  const telemetry_record_t *records;
+  uint32_t primask;
+  uint32_t nb;
+
+  if (want && !usb_ctx.cdc_attached) {
+    Telemetry_ReaderAttach(TELEMETRY_READER_USB, 1);
+    usb_ctx.cdc_attached = 1;
+  } else if (!want && usb_ctx.cdc_attached && !usb_ctx.cdc_busy) {
+    Telemetry_ReaderAttach(TELEMETRY_READER_USB, 0);
+    usb_ctx.cdc_attached = 0;
+  }
+  if (!want || !usb_ctx.cdc_attached || usb_ctx.cdc_busy) {
+    return;
+  }
+
+  nb = Telemetry_ReaderAcquire(TELEMETRY_READER_USB, &records, USB_CDC_BATCH);
+  if (nb == 0) {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (usb_ctx.configured) {
+    usb_ctx.cdc_nb = nb;
+    usb_ctx.cdc_busy = 1;
+    (void)USBD_LL_Transmit(&usb_device, USB_CDC_IN_EP, (uint8_t *)records, nb * TELEMETRY_RECORD_SIZE);
+  } else {
+    Telemetry_ReaderRelease(TELEMETRY_READER_USB, nb);
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Drop the transfers in flight: stream stopped, bus reset or unplugged
+ * @note   USB interrupt, endpoints closed
+ */
+static void Usb_Abort(void) {
+  if (usb_ctx.uvc_busy) {
+    usb_ctx.uvc_busy = 0;
+    usb_ctx.stats.aborted++;
+  }
+  usb_ctx.need_idr = 1;
+  if (usb_ctx.cdc_busy) {
+    if (usb_ctx.cdc_nb > 0) {
+      Telemetry_ReaderRelease(TELEMETRY_READER_USB, usb_ctx.cdc_nb);
+      usb_ctx.cdc_nb = 0;
+    }
+    usb_ctx.cdc_busy = 0;
+  }
+  Usb_Wake();
+}
+
+static uint8_t Usb_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx) {
+  UNUSED(cfgidx);
+
+  (void)USBD_LL_OpenEP(pdev, USB_CDC_IN_EP, USBD_EP_TYPE_BULK, USB_BULK_PACKET_SIZE);
+  (void)USBD_LL_OpenEP(pdev, USB_CDC_OUT_EP, USBD_EP_TYPE_BULK, USB_BULK_PACKET_SIZE);
+  (void)USBD_LL_OpenEP(pdev, USB_CDC_NOTIFY_EP, USBD_EP_TYPE_INTR, USB_NOTIFY_PACKET_SIZE);
+  pdev->ep_in[USB_CDC_IN_EP & 0x0FU].is_used = 1U;
+  pdev->ep_out[USB_CDC_OUT_EP & 0x0FU].is_used = 1U;
+  pdev->ep_in[USB_CDC_NOTIFY_EP & 0x0FU].is_used = 1U;
+  (void)USBD_LL_PrepareReceive(pdev, USB_CDC_OUT_EP, usb_dma.cdc_rx, USB_BULK_PACKET_SIZE);
+
+  usb_ctx.configured = 1;
+  Usb_Wake();
+  return (uint8_t)USBD_OK;
+}
+
+static uint8_t Usb_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx) {
+  UNUSED(cfgidx);
+
+  (void)USBD_LL_CloseEP(pdev, USB_CDC_IN_EP);
+  (void)USBD_LL_CloseEP(pdev, USB_CDC_OUT_EP);
+  (void)USBD_LL_CloseEP(pdev, USB_CDC_NOTIFY_EP);
+  pdev->ep_in[USB_CDC_IN_EP & 0x0FU].is_used = 0U;
+  pdev->ep_out[USB_CDC_OUT_EP & 0x0FU].is_used = 0U;
+  pdev->ep_in[USB_CDC_NOTIFY_EP & 0x0FU].is_used = 0U;
+  if (usb_ctx.streaming) {
+    (void)USBD_LL_CloseEP(pdev, USB_UVC_EP);
+    pdev->ep_in[USB_UVC_EP & 0x0FU].is_used = 0U;
+  }
+
+  usb_ctx.configured = 0;
+  usb_ctx.streaming = 0;
+  usb_ctx.dtr = 0;
+  Usb_Abort();
+  return (uint8_t)USBD_OK;
+}
+
+/**
+ * @brief  Streaming interface alternate: 1 opens the isochronous endpoint
+ */
+static void Usb_SetStreaming(USBD_HandleTypeDef *pdev, uint8_t alt) {
+  if (alt != 0U && !usb_ctx.streaming) {
+    (void)USBD_LL_OpenEP(pdev, USB_UVC_EP, USBD_EP_TYPE_ISOC, USB_UVC_PACKET_SIZE);
+    pdev->ep_in[USB_UVC_EP & 0x0FU].is_used = 1U;
+    usb_ctx.streaming = 1;
+  } else if (alt == 0U && usb_ctx.streaming) {
+    usb_ctx.streaming = 0;
+    (void)USBD_LL_FlushEP(pdev, USB_UVC_EP);
+    (void)USBD_LL_CloseEP(pdev, USB_UVC_EP);
+    pdev->ep_in[USB_UVC_EP & 0x0FU].is_used = 0U;
+    Usb_Abort();
+  }
+}
+
+static uint8_t Usb_StandardRequest(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) {
+  uint8_t itf = LOBYTE(req->wIndex);
+
+  /* Endpoint requests were served by the core */
+  if ((req->bmRequest & 0x1FU) != 0x01U) {
+    return (uint8_t)USBD_OK;
+  }
+
+  switch (req->bRequest) {
+  case USB_REQ_GET_STATUS:
+    usb_dma.reply[0] = 0;
+    usb_dma.reply[1] = 0;
+    (void)USBD_CtlSendData(pdev, usb_dma.reply, 2U);
+    return (uint8_t)USBD_OK;
+  case USB_REQ_GET_INTERFACE:
+    usb_dma.reply[0] = (itf == USB_ITF_VS) ? usb_ctx.streaming : 0U;
+    (void)USBD_CtlSendData(pdev, usb_dma.reply, 1U);
+    return (uint8_t)USBD_OK;
+  case USB_REQ_SET_INTERFACE:
+    if (itf == USB_ITF_VS && req->wValue <= 1U) {
+      Usb_SetStreaming(pdev, (uint8_t)req->wValue);
+      return (uint8_t)USBD_OK;
+    }
+    if (itf < USB_ITF_NB && req->wValue == 0U) {
+      return (uint8_t)USBD_OK;
+    }
+    break;
+  case USB_REQ_CLEAR_FEATURE:
+    return (uint8_t)USBD_OK;
+  default:
+    break;
+  }
+  USBD_CtlError(pdev, req);
+  return (uint8_t)USBD_FAIL;
+}
+
+static uint8_t Usb_CdcRequest(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) {
+  switch (req->bRequest) {
+  case USB_CDC_SET_LINE_CODING:
+    (void)USBD_CtlPrepareRx(pdev, usb_dma.line_coding, MIN(req->wLength, 7U));
+    return (uint8_t)USBD_OK;
+  case USB_CDC_GET_LINE_CODING:
+    (void)USBD_CtlSendData(pdev, usb_dma.line_coding, MIN(req->wLength, 7U));
+    return (uint8_t)USBD_OK;
+  case USB_CDC_SET_CONTROL_LINE_STATE:
+    usb_ctx.dtr = (req->wValue & USB_CDC_DTR) ? 1U : 0U;
+    Usb_Wake();
+    return (uint8_t)USBD_OK;
+  default:
+    /* Break and the rest: nothing to do, no data stage */
+    if (req->wLength == 0U) {
+      return (uint8_t)USBD_OK;
+    }
+    break;
+  }
+  USBD_CtlError(pdev, req);
+  return (uint8_t)USBD_FAIL;
+}
+
+static uint8_t Usb_UvcRequest(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) {
+  uint8_t cs = HIBYTE(req->wValue);
+
+  if (cs == USB_UVC_VS_PROBE || cs == USB_UVC_VS_COMMIT) {
+    switch (req->bRequest) {
+    case USB_UVC_SET_CUR:
+      (void)USBD_CtlPrepareRx(pdev, (uint8_t *)&usb_dma.probe_rx, MIN(req->wLength, sizeof(usb_uvc_probe_t)));
+      return (uint8_t)USBD_OK;
+    case USB_UVC_GET_CUR:
+    case USB_UVC_GET_MIN:
+    case USB_UVC_GET_MAX:
+    case USB_UVC_GET_DEF:
+      usb_dma.probe = usb_uvc_probe;
+      (void)USBD_CtlSendData(pdev, (uint8_t *)&usb_dma.probe, MIN(req->wLength, sizeof(usb_uvc_probe_t)));
+      return (uint8_t)USBD_OK;
+    case USB_UVC_GET_LEN:
+      usb_dma.reply[0] = (uint8_t)sizeof(usb_uvc_probe_t);
+      usb_dma.reply[1] = 0;
+      (void)USBD_CtlSendData(pdev, usb_dma.reply, MIN(req->wLength, 2U));
+      return (uint8_t)USBD_OK;
+    case USB_UVC_GET_INFO:
+      usb_dma.reply[0] = 0x03; /* GET and SET */
+      (void)USBD_CtlSendData(pdev, usb_dma.reply, 1U);
+      return (uint8_t)USBD_OK;
+    default:
+      break;
+    }
+  }
+  USBD_CtlError(pdev, req);
+  return (uint8_t)USBD_FAIL;
+}
+
+static uint8_t Usb_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) {
+  uint8_t itf = LOBYTE(req->wIndex);
+
+  switch (req->bmRequest & USB_REQ_TYPE_MASK) {
+  case USB_REQ_TYPE_STANDARD:
+    return Usb_StandardRequest(pdev, req);
+  case USB_REQ_TYPE_CLASS:
+    if (itf == USB_ITF_CDC_COMM) {
+      return Usb_CdcRequest(pdev, req);
+    }
+    if (itf == USB_ITF_VS) {
+      return Usb_UvcRequest(pdev, req);
+    }
+    break;
+  default:
+    break;
+  }
+  /* Video control requests included: the camera has no control */
+  USBD_CtlError(pdev, req);
+  return (uint8_t)USBD_FAIL;
+}
+
+static uint8_t Usb_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum) {
+  if (epnum == (USB_UVC_EP & 0x0FU)) {
+    if (usb_ctx.uvc_busy) {
+      Usb_UvcNextPacket();
+    }
+  } else if (epnum == (USB_CDC_IN_EP & 0x0FU) && usb_ctx.cdc_busy) {
+    if (usb_ctx.cdc_nb > 0) {
+      uint32_t len = usb_ctx.cdc_nb * TELEMETRY_RECORD_SIZE;
+
+      Telemetry_ReaderRelease(TELEMETRY_READER_USB, usb_ctx.cdc_nb);
+      usb_ctx.stats.records += usb_ctx.cdc_nb;
+      usb_ctx.cdc_nb = 0;
+      /* A whole number of packets: a zero-length one ends the transfer */
+      if (len % USB_BULK_PACKET_SIZE == 0U) {
+        (void)USBD_LL_Transmit(pdev, USB_CDC_IN_EP, NULL, 0U);
+        return (uint8_t)USBD_OK;
+      }
+    }
+    usb_ctx.cdc_busy = 0;
+    Usb_Wake();
+  }
+  return (uint8_t)USBD_OK;
+}
+
+static uint8_t Usb_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum) {
+  if (epnum == USB_CDC_OUT_EP) {
+    uint32_t len = USBD_LL_GetRxDataSize(pdev, epnum);
+
+    /* Host requests, as on the telemetry UART */
+    for (uint32_t i = 0; i < MIN(len, USB_BULK_PACKET_SIZE); i++) {
+      Telemetry_Command(usb_dma.cdc_rx[i]);
+    }
+    (void)USBD_LL_PrepareReceive(pdev, USB_CDC_OUT_EP, usb_dma.cdc_rx, USB_BULK_PACKET_SIZE);
+  }
+  return (uint8_t)USBD_OK;
+}
+
+static uint8_t Usb_IsoInIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum) {
+  /* The host polled before the packet was armed: send it again */
+  if (epnum == (USB_UVC_EP & 0x0FU) && usb_ctx.uvc_busy) {
+    usb_ctx.stats.incompletes++;
+    (void)USBD_LL_FlushEP(pdev, USB_UVC_EP);
+    Usb_UvcSend(usb_ctx.pkt, usb_ctx.pkt_len);
+  }
+  return (uint8_t)USBD_OK;
+}
+
+static USBD_ClassTypeDef usb_class = {
+    .Init = Usb_Init,
+    .DeInit = Usb_DeInit,
+    .Setup = Usb_Setup,
+    .DataIn = Usb_DataIn,
+    .DataOut = Usb_DataOut,
+    .IsoINIncomplete = Usb_IsoInIncomplete,
+    .GetHSConfigDescriptor = Usb_GetConfigDesc,
+    .GetFSConfigDescriptor = Usb_GetConfigDesc,
+    .GetDeviceQualifierDescriptor = Usb_GetQualifierDesc,
+};
+
+static void usb_thread_entry(ULONG arg) {
+  UNUSED(arg);
+
+  for (;;) {
+    ULONG flags;
+
+    tx_event_flags_get(&usb_ctx.events, USB_EVENT_WAKE | USB_EVENT_POLL, TX_OR_CLEAR, &flags, TX_WAIT_FOREVER);
+    Usb_ServiceVideo();
+    Usb_ServiceCdc();
+  }
+}
+
+void Thread_Usb_Init(VOID *memory_ptr) {
+  uint32_t uid[3] = {HAL_GetUIDw0(), HAL_GetUIDw1(), HAL_GetUIDw2()};
+  uint32_t hash = 2166136261U;
+
+  UNUSED(memory_ptr);
+
+  /* Serial number from the device UID (FNV-1a), as the Ethernet unit ID */
+  for (uint32_t i = 0; i < sizeof(uid); i++) {
+    hash = (hash ^ ((const uint8_t *)uid)[i]) * 16777619U;
+  }
+  snprintf(usb_ctx.serial, sizeof(usb_ctx.serial), "%08lX", (unsigned long)hash);
+
+  /* 8N1 at 115200 until the host sets its own; the port has no baud rate */
+  memset(usb_dma.line_coding, 0, sizeof(usb_dma.line_coding));
+  usb_dma.line_coding[0] = (uint8_t)115200U;
+  usb_dma.line_coding[1] = (uint8_t)(115200U >> 8);
+  usb_dma.line_coding[2] = (uint8_t)(115200U >> 16);
+  usb_dma.line_coding[6] = 8;
+  usb_ctx.need_idr = 1;
+
+  APP_REQUIRE_EQ(tx_event_flags_create(&usb_ctx.events, "usb"), TX_SUCCESS);
+  Periodic_Register(&usb_ctx.events, USB_EVENT_POLL, USB_POLL_MS);
+  APP_REQUIRE_EQ(tx_thread_create(&usb_ctx.thread, "usb",
+                                  usb_thread_entry, 0,
+                                  usb_ctx.stack, USB_THREAD_STACK_SIZE,
+                                  USB_THREAD_PRIORITY, USB_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+
+  memset(&usb_device, 0, sizeof(usb_device));
+  APP_REQUIRE_EQ(USBD_Init(&usb_device, &usb_descriptors, DEVICE_HS), USBD_OK);
+  APP_REQUIRE_EQ(USBD_RegisterClass(&usb_device, &usb_class), USBD_OK);
+  APP_REQUIRE_EQ(USBD_Start(&usb_device), USBD_OK);
+  printf("usb: UVC H.264 %ux%u and CDC telemetry, serial %s\r\n", DISPLAY_LETTERBOX_WIDTH,
+         DISPLAY_LETTERBOX_HEIGHT, usb_ctx.serial);
+}
+
+void Usb_GetStats(usb_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = usb_ctx.stats;
+}
+
+#endif /* USB_STREAM_ENABLE */
@@ -0,0 +1,497 @@
+/**
+ ******************************************************************************
+ * @file    app_venc.c
+ * @author  Long Liangmao
+ * @brief   Hardware H.264 recording for STM32N6570-DK (VENC_ENABLE)
+ *          The recording thread lends the displayed Pipe1 frame to a job
+ *          pipeline: its DMA2D stage composes the UI layer over it, its
+ *          VENC stage encodes it straight into a ring of access units
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_venc.h"
+
+#if VENC_ENABLE
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "app_jobs.h"
+#include "app_lcd.h"
+#include "app_overlay.h"
+#include "app_time.h"
+#include "ewl.h"
+#include "h264encapi.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6xx_hal_rif.h"
+#include "stm32n6xx_ll_venc.h"
+#include "utils.h"
+#include <string.h>
+
+#if DISPLAY_SINGLE_PIPE
+#error "VENC_ENABLE encodes the Pipe1 display frames: not available with DISPLAY_SINGLE_PIPE"
+#endif
+
+#if VENC_FRAME_DECIMATION < 1
+#error "VENC_FRAME_DECIMATION must be at least 1"
+#endif
+
+_Static_assert(DISPLAY_LETTERBOX_WIDTH % 16 == 0 && DISPLAY_LETTERBOX_HEIGHT % 16 == 0,
+               "Encoded frame is not a whole number of macroblocks");
+_Static_assert(VENC_STREAM_SIZE >= 2 * (VENC_FRAME_MAX + VENC_HEADER_MAX),
+               "Bitstream ring holds less than two frames");
+
+#if VENC_OVERLAY
+#if VENC_PIPELINE_DEPTH < 1 || VENC_PIPELINE_DEPTH > JOBS_SLOTS_MAX
+#error "VENC_PIPELINE_DEPTH must be 1 to JOBS_SLOTS_MAX"
+#endif
+#define VENC_JOB_NB VENC_PIPELINE_DEPTH
+#else
+/* The VENC reads the lent display slot itself: one frame in flight */
+#define VENC_JOB_NB 1
+#endif
+
+/* Recording thread (lends the frames), then the pipeline lanes at
+ * JOBS_LANE_PRIORITY: below the NN and post-processing threads, above the UI */
+#define VENC_THREAD_STACK_SIZE 4096
+
+/* Product number in the high half of the ASIC id register: Hantro H1 */
+#define VENC_ASIC_PRODUCT_H1 0x4831U
+
+/* Output buffers start on a 64-bit boundary */
+#define VENC_OUT_ALIGN 8U
+
+/* Frame carried by a pipeline slot */
+typedef struct {
+  int display_slot;        /* Lent display slot, returned once read */
+  buffer_frame_tag_t tag;
+  uint64_t start_us;       /* Submitted to the pipeline */
+} venc_job_t;
+
+static struct {
+  TX_THREAD thread;
+  UCHAR stack[VENC_THREAD_STACK_SIZE];
+  H264EncInst inst;
+
+  jobs_pipeline_t pipeline;
+  venc_job_t job[VENC_JOB_NB];
+  TX_SEMAPHORE lend_sem; /* Free while no slot is lent to BUFFER_LENDER_VENC */
+
+  uint8_t started;       /* Header written for the current encoder instance */
+  uint8_t has_last;      /* last_frame is set */
+  uint8_t force_idr;     /* Next frame intra: first, after a lost frame or a restart */
+  uint32_t gop_pos;      /* Frames since the last IDR frame */
+  uint32_t first_frame;  /* Sensor frame the presentation times count from */
+  uint32_t prev_frame;   /* Sensor frame last encoded (time increment) */
+  uint32_t last_frame;   /* Sensor frame last considered (decimation) */
+
+  /* Access unit ring: the recording thread queues at head, the consumer
+   * releases at tail; every access unit is contiguous in the stream buffer */
+  venc_au_t au[VENC_AU_NB];
+  uint32_t wr; /* Stream buffer offset the next access unit goes to */
+  uint32_t head;
+  volatile uint32_t tail;
+  TX_SEMAPHORE au_sem; /* One count per queued access unit */
+
+  uint8_t header[VENC_HEADER_MAX];
+  uint32_t header_size;
+  venc_stats_t stats;
+} venc_ctx;
+
+/**
+ * @brief  Find room for the next frame and its header
+ * @retval Stream buffer offset, -1 while the consumer holds too much of it
+ * @note   Wraps to the start when the top is short: the frame is never split
+ */
+static int32_t Venc_ReserveRoom(void) {
+  const uint32_t need = VENC_FRAME_MAX + VENC_HEADER_MAX;
+  uint32_t tail = venc_ctx.tail;
+  uint32_t oldest;
+
+  if (venc_ctx.head - tail >= VENC_AU_NB) {
+    return -1;
+  }
+  if (venc_ctx.head == tail) {
+    /* All released: start over from the bottom */
+    venc_ctx.wr = 0;
+    return 0;
+  }
+
+  oldest = (uint32_t)(venc_ctx.au[tail % VENC_AU_NB].data - venc_stream_buffer[0]);
+  if (venc_ctx.wr > oldest) {
+    if (VENC_STREAM_SIZE - venc_ctx.wr >= need) {
+      return (int32_t)venc_ctx.wr;
+    }
+    if (oldest > need) {
+      venc_ctx.wr = 0;
+      return 0;
+    }
+    return -1;
+  }
+
+  /* Wrapped: strictly more than needed, so wr never catches up with oldest */
+  return (oldest - venc_ctx.wr > need) ? (int32_t)venc_ctx.wr : -1;
+}
+
+/**
+ * @brief  Queue the access unit just written at the reserved offset
+ */
+static void Venc_Queue(uint32_t size, uint32_t frame_id, uint8_t keyframe, uint8_t header) {
+  venc_au_t *au = &venc_ctx.au[venc_ctx.head % VENC_AU_NB];
+
+  au->data = venc_stream_buffer[0] + venc_ctx.wr;
+  au->size = size;
+  au->frame_id = frame_id;
+  au->time_us = (uint32_t)((uint64_t)(frame_id - venc_ctx.first_frame) * 1000000U / CAMERA_FPS);
+  au->keyframe = keyframe;
+  au->header = header;
+
+  venc_ctx.wr = (venc_ctx.wr + size + VENC_OUT_ALIGN - 1U) & ~(VENC_OUT_ALIGN - 1U);
+  venc_ctx.stats.encoded++;
+  venc_ctx.stats.bytes += size;
+
+  /* Descriptor complete before the consumer can see it */
+  __DMB();
+  venc_ctx.head++;
+  APP_REQUIRE_EQ(tx_semaphore_put(&venc_ctx.au_sem), TX_SUCCESS);
+}
+
+/**
+ * @brief  Create an encoder instance for the display frames
+ * @note   Rate control and RGB565 input conversion in the VENC pre-processor
+ */
+static void Venc_Open(void) {
+  H264EncConfig cfg;
+  H264EncRateCtrl rc;
+  H264EncPreProcessingCfg pp;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.streamType = H264ENC_BYTE_STREAM;
+  cfg.viewMode = H264ENC_BASE_VIEW_DOUBLE_BUFFER;
+  cfg.level = H264ENC_LEVEL_3;
+  cfg.width = DISPLAY_LETTERBOX_WIDTH;
+  cfg.height = DISPLAY_LETTERBOX_HEIGHT;
+  cfg.frameRateNum = CAMERA_FPS; /* Time increments count sensor frames */
+  cfg.frameRateDenom = 1;
+  cfg.refFrameAmount = 1;
+  APP_REQUIRE_EQ(H264EncInit(&cfg, &venc_ctx.inst), H264ENC_OK);
+
+  APP_REQUIRE_EQ(H264EncGetRateCtrl(venc_ctx.inst, &rc), H264ENC_OK);
+  rc.pictureRc = 1;
+  rc.mbRc = 1;
+  rc.pictureSkip = 0;
+  rc.hrd = 0;
+  rc.qpHdr = -1; /* Initial QP from the bit rate */
+  rc.qpMin = 10;
+  rc.qpMax = 51;
+  rc.bitPerSecond = VENC_BITRATE;
+  rc.gopLen = VENC_GOP_LENGTH;
+  APP_REQUIRE_EQ(H264EncSetRateCtrl(venc_ctx.inst, &rc), H264ENC_OK);
+
+  APP_REQUIRE_EQ(H264EncGetPreProcessing(venc_ctx.inst, &pp), H264ENC_OK);
+  pp.origWidth = DISPLAY_LETTERBOX_WIDTH;
+  pp.origHeight = DISPLAY_LETTERBOX_HEIGHT;
+  pp.xOffset = 0;
+  pp.yOffset = 0;
+  pp.inputType = H264ENC_RGB565;
+  pp.rotation = H264ENC_ROTATE_0;
+  pp.colorConversion.type = H264ENC_RGBTOYUV_BT601;
+  APP_REQUIRE_EQ(H264EncSetPreProcessing(venc_ctx.inst, &pp), H264ENC_OK);
+
+  venc_ctx.started = 0;
+  venc_ctx.force_idr = 1;
+}
+
+/**
+ * @brief  Replace an encoder instance left in error by the hardware
+ */
+static void Venc_Restart(void) {
+  (void)H264EncRelease(venc_ctx.inst);
+  Venc_Open();
+  venc_ctx.stats.restarts++;
+}
+
+/**
+ * @brief  Write and queue the stream header (SPS and PPS)
+ * @retval 1 when queued, 0 on a hardware error (instance restarted)
+ */
+static int Venc_StartStream(uint32_t frame_id) {
+  uint8_t *dst = venc_stream_buffer[0] + venc_ctx.wr;
+  H264EncIn in;
+  H264EncOut out;
+
+  memset(&in, 0, sizeof(in));
+  memset(&out, 0, sizeof(out));
+  in.pOutBuf = (u32 *)(void *)dst;
+  in.busOutBuf = (uint32_t)dst;
+  in.outBufSize = VENC_HEADER_MAX;
+
+  if (H264EncStrmStart(venc_ctx.inst, &in, &out) != H264ENC_OK || out.streamSize > VENC_HEADER_MAX) {
+    Venc_Restart();
+    return 0;
+  }
+
+  memcpy(venc_ctx.header, dst, out.streamSize);
+  venc_ctx.header_size = out.streamSize;
+  if (venc_ctx.stats.encoded == 0) {
+    venc_ctx.first_frame = frame_id;
+  }
+  venc_ctx.prev_frame = frame_id;
+  venc_ctx.started = 1;
+
+  Venc_Queue(out.streamSize, frame_id, 0, 1);
+  return 1;
+}
+
+/**
+ * @brief  Encode one frame into the ring at the write offset
+ * @param  frame: RGB565 frame, DISPLAY_LETTERBOX_WIDTH x DISPLAY_LETTERBOX_HEIGHT
+ */
+static void Venc_EncodeFrame(const uint8_t *frame, uint32_t frame_id) {
+  uint8_t *dst = venc_stream_buffer[0] + venc_ctx.wr;
+  H264EncIn in;
+  H264EncOut out;
+  H264EncRet ret;
+
+  memset(&in, 0, sizeof(in));
+  memset(&out, 0, sizeof(out));
+  in.busLuma = (uint32_t)frame; /* Interleaved RGB: one plane */
+  in.pOutBuf = (u32 *)(void *)dst;
+  in.busOutBuf = (uint32_t)dst;
+  in.outBufSize = VENC_FRAME_MAX;
+  in.timeIncrement = frame_id - venc_ctx.prev_frame;
+  in.codingType = (venc_ctx.force_idr || venc_ctx.gop_pos == 0) ? H264ENC_INTRA_FRAME : H264ENC_PREDICTED_FRAME;
+  in.ipf = H264ENC_REFERENCE_AND_REFRESH;
+  in.ltrf = H264ENC_REFERENCE;
+
+  ret = H264EncStrmEncode(venc_ctx.inst, &in, &out, NULL, NULL);
+
+  if (ret == H264ENC_FRAME_READY) {
+    Venc_Queue(out.streamSize, frame_id, out.codingType == H264ENC_INTRA_FRAME, 0);
+    venc_ctx.prev_frame = frame_id;
+    venc_ctx.force_idr = 0;
+    venc_ctx.gop_pos = (out.codingType == H264ENC_INTRA_FRAME) ? 1U : (venc_ctx.gop_pos + 1U) % VENC_GOP_LENGTH;
+  } else if (ret == H264ENC_OUTPUT_BUFFER_OVERFLOW) {
+    /* Frame lost: the decoder no longer has its reference */
+    venc_ctx.stats.overflows++;
+    venc_ctx.force_idr = 1;
+  } else {
+    Venc_Restart();
+  }
+}
+
+/**
+ * @brief  Give the lent display slot back and let the next frame be lent
+ */
+static void Venc_ReturnDisplay(void) {
+  Buffer_CameraDisplay_Return(BUFFER_LENDER_VENC);
+  APP_REQUIRE_EQ(tx_semaphore_put(&venc_ctx.lend_sem), TX_SUCCESS);
+}
+
+#if VENC_OVERLAY
+/**
+ * @brief  DMA2D stage: compose the UI layer over the lent frame
+ * @note   The display slot is free again after it, while the VENC may still
+ *         encode the frame before
+ */
+static void Venc_ComposeStage(uint32_t slot) {
+  const venc_job_t *job = &venc_ctx.job[slot];
+  uint32_t shown_cycles;
+
+  /* Burn in the UI buffer on screen; a redraw racing the blend only tears
+   * the overlay of that frame */
+  Overlay_ComposeRGB565(venc_input_buffer[slot], Buffer_GetCameraDisplayBuffer(job->display_slot),
+                        LCD_GetUILayerShown(&shown_cycles), DISPLAY_LETTERBOX_X0, DISPLAY_LETTERBOX_WIDTH,
+                        DISPLAY_LETTERBOX_HEIGHT);
+  Overlay_WaitFence(Overlay_Submit());
+  Venc_ReturnDisplay();
+}
+#endif
+
+/**
+ * @brief  VENC stage: encode one frame into the access unit ring
+ * @note   The only stage touching the encoder and the ring head
+ */
+static void Venc_EncodeStage(uint32_t slot) {
+  const venc_job_t *job = &venc_ctx.job[slot];
+#if VENC_OVERLAY
+  const uint8_t *frame = venc_input_buffer[slot];
+#else
+  const uint8_t *frame = Buffer_GetCameraDisplayBuffer(job->display_slot);
+#endif
+
+  if (Venc_ReserveRoom() < 0) {
+    venc_ctx.stats.skipped++;
+  } else if (venc_ctx.started || Venc_StartStream(job->tag.frame_id)) {
+    Venc_EncodeFrame(frame, job->tag.frame_id);
+  }
+
+#if !VENC_OVERLAY
+  Venc_ReturnDisplay();
+#endif
+
+  venc_ctx.stats.encode_us = (uint32_t)(Time_GetUs() - job->start_us);
+}
+
+static const jobs_stage_t venc_stages[] = {
+#if VENC_OVERLAY
+    {"venc_compose", JOBS_ENGINE_DMA2D, Venc_ComposeStage},
+#endif
+    {"venc_encode", JOBS_ENGINE_VENC, Venc_EncodeStage},
+};
+
+/**
+ * @brief  Lend the displayed frame when it is the next one to record
+ * @retval Display slot, -1 when none is due (nothing is lent)
+ */
+static int Venc_LendNext(buffer_frame_tag_t *tag) {
+  int slot = Buffer_CameraDisplay_Lend(BUFFER_LENDER_VENC, tag);
+
+  if (slot < 0) {
+    return -1;
+  }
+  if (venc_ctx.has_last && (int32_t)(tag->frame_id - venc_ctx.last_frame) < VENC_FRAME_DECIMATION) {
+    Buffer_CameraDisplay_Return(BUFFER_LENDER_VENC);
+    return -1;
+  }
+  venc_ctx.last_frame = tag->frame_id;
+  venc_ctx.has_last = 1;
+  return slot;
+}
+
+/**
+ * @brief  Recording thread: feed one displayed frame in VENC_FRAME_DECIMATION
+ *         to the pipeline
+ * @param  arg: Unused
+ */
+static void venc_thread_entry(ULONG arg) {
+  buffer_frame_tag_t tag;
+  uint32_t job_slot;
+  int slot;
+
+  UNUSED(arg);
+
+  while (1) {
+    /* One lent slot at a time: back once the frame before was read */
+    APP_REQUIRE_EQ(tx_semaphore_get(&venc_ctx.lend_sem, TX_WAIT_FOREVER), TX_SUCCESS);
+
+    /* A new front at most every few ticks at CAMERA_FPS: poll it per tick */
+    do {
+      tx_thread_sleep(1);
+      slot = Venc_LendNext(&tag);
+    } while (slot < 0);
+
+    if (!Jobs_Acquire(&venc_ctx.pipeline, &job_slot, TX_NO_WAIT)) {
+      /* Every slot in flight: the encoder fell behind */
+      venc_ctx.stats.skipped++;
+      Venc_ReturnDisplay();
+      continue;
+    }
+    venc_ctx.job[job_slot] = (venc_job_t){
+        .display_slot = slot,
+        .tag = tag,
+        .start_us = Time_GetUs(),
+    };
+    Jobs_Submit(&venc_ctx.pipeline, job_slot);
+  }
+}
+
+/**
+ * @brief  Power the VENC, open the encoder and start the recording thread
+ */
+void Thread_Venc_Init(VOID *memory_ptr) {
+  RIMC_MasterConfig_t master = {0};
+
+  UNUSED(memory_ptr);
+
+  LL_VENC_Init();
+  __HAL_RCC_VENC_FORCE_RESET();
+  __HAL_RCC_VENC_RELEASE_RESET();
+  /* Kept clocked in WFI, like the rest of the camera and display pipeline */
+  __HAL_RCC_VENC_CLK_SLEEP_ENABLE();
+  __HAL_RCC_VENCRAM_MEM_CLK_SLEEP_ENABLE();
+
+  /* Reads the display ring and writes the PSRAM streams: the DMA2D attributes */
+  master.MasterCID = RIF_CID_1;
+  master.SecPriv = RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV;
+  HAL_RIF_RIMC_ConfigMasterAttributes(RIF_MASTER_INDEX_VENC, &master);
+  HAL_RIF_RISC_SetSlaveSecureAttributes(RIF_RISC_PERIPH_INDEX_VENC, RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV);
+
+  APP_REQUIRE_EQ(EWLReadAsicID() >> 16, VENC_ASIC_PRODUCT_H1);
+
+  HAL_NVIC_SetPriority(VENC_IRQn, VENC_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(VENC_IRQn);
+
+  APP_REQUIRE_EQ(tx_semaphore_create(&venc_ctx.au_sem, "venc_au", 0), TX_SUCCESS);
+  APP_REQUIRE_EQ(tx_semaphore_create(&venc_ctx.lend_sem, "venc_lend", 1), TX_SUCCESS);
+  Venc_Open();
+
+  venc_ctx.pipeline = (jobs_pipeline_t){
+      .name = "venc",
+      .stages = venc_stages,
+      .stage_nb = sizeof(venc_stages) / sizeof(venc_stages[0]),
+      .slot_nb = VENC_JOB_NB,
+  };
+  Jobs_Register(&venc_ctx.pipeline);
+
+  APP_REQUIRE_EQ(tx_thread_create(&venc_ctx.thread, "venc",
+                                  venc_thread_entry, 0,
+                                  venc_ctx.stack, VENC_THREAD_STACK_SIZE,
+                                  VENC_THREAD_PRIORITY, VENC_THREAD_PRIORITY,
+                                  TX_NO_TIME_SLICE, TX_AUTO_START),
+                 TX_SUCCESS);
+}
+
+/**
+ * @brief  Take the oldest access unit of the ring
+ */
+int Venc_Acquire(venc_au_t *au, ULONG wait_ticks) {
+  APP_REQUIRE(au != NULL);
+
+  if (tx_semaphore_get(&venc_ctx.au_sem, wait_ticks) != TX_SUCCESS) {
+    return 0;
+  }
+  *au = venc_ctx.au[venc_ctx.tail % VENC_AU_NB];
+  return 1;
+}
+
+/**
+ * @brief  Give the access unit taken by Venc_Acquire() back to the ring
+ */
+void Venc_Release(void) {
+  APP_REQUIRE(venc_ctx.tail != venc_ctx.head);
+
+  /* Done reading before the recording thread may overwrite it */
+  __DMB();
+  venc_ctx.tail++;
+}
+
+/**
+ * @brief  Get the SPS and PPS of the running stream
+ */
+uint32_t Venc_GetHeader(const uint8_t **data) {
+  APP_REQUIRE(data != NULL);
+
+  *data = venc_ctx.header;
+  return venc_ctx.header_size;
+}
+
+/**
+ * @brief  Copy the encoder counters
+ */
+void Venc_GetStats(venc_stats_t *stats) {
+  APP_REQUIRE(stats != NULL);
+
+  *stats = venc_ctx.stats;
+}
+
+#endif /* VENC_ENABLE */
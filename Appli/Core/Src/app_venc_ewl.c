@@ -0,0 +1,243 @@
+/**
+ ******************************************************************************
+ * @file    app_venc_ewl.c
+ * @author  Long Liangmao
+ * @brief   ThreadX wrapper layer (EWL) of the VENC H.264 library (VENC_ENABLE)
+ *          Register access, interrupt-driven ready wait and memory for the
+ *          one encoder instance of app_venc.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_venc.h"
+
+#if VENC_ENABLE
+
+#include "app_buffers.h"
+#include "app_error.h"
+#include "ewl.h"
+#include "stm32n6xx_hal.h"
+#include "tx_api.h"
+#include <string.h>
+
+/* A frame encodes in a few ms at VGA: this means the VENC hung */
+#define VENC_HW_TIMEOUT_TICKS ((100U * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U)
+
+/* Encoder instance and rate control state (EWLmalloc) */
+#define VENC_HEAP_SIZE (16U * 1024U)
+
+/* Reference frames and internal tables: the VENC bursts on 64-bit words */
+#define VENC_LINEAR_ALIGN 8U
+
+#define VENC_REG(offset) (*(volatile uint32_t *)(VENC_BASE + (offset)))
+
+/* Interrupt status register, IRQ line flag */
+#define VENC_REG_IRQ 0x04U
+#define VENC_IRQ_LINE 0x01U
+
+/* Synthesis configuration register */
+#define VENC_REG_CONFIG 0xFCU
+
+static struct {
+  TX_SEMAPHORE hw_sem;   /* Put by the VENC interrupt */
+  TX_BYTE_POOL heap;
+  uint8_t created;
+  uint32_t linear_used;  /* Bump offset in venc_ewl_pool */
+  ULONG heap_mem[VENC_HEAP_SIZE / sizeof(ULONG)];
+} ewl_ctx;
+
+/* Any non-NULL handle: there is a single instance */
+#define EWL_INSTANCE ((const void *)&ewl_ctx)
+
+u32 EWLReadAsicID(void) {
+  return VENC_REG(0x00U);
+}
+
+EWLHwConfig_t EWLReadAsicConfig(void) {
+  uint32_t cfg = VENC_REG(VENC_REG_CONFIG);
+  EWLHwConfig_t hw;
+
+  memset(&hw, 0, sizeof(hw));
+  hw.maxEncodedWidth = cfg & 0xFFFU;
+  hw.busWidth = (cfg >> 12) & 0x0FU;
+  hw.synthesisLanguage = (cfg >> 16) & 0x0FU;
+  hw.busType = (cfg >> 20) & 0x0FU;
+  hw.vsEnabled = (cfg >> 24) & 1U;
+  hw.jpegEnabled = (cfg >> 25) & 1U;
+  hw.vp8Enabled = (cfg >> 26) & 1U;
+  hw.h264Enabled = (cfg >> 27) & 1U;
+  hw.rgbEnabled = (cfg >> 28) & 1U;
+  hw.searchAreaSmall = (cfg >> 29) & 1U;
+  hw.scalingEnabled = (cfg >> 30) & 1U;
+  return hw;
+}
+
+const void *EWLInit(EWLInitParam_t *param) {
+  UNUSED(param);
+
+  if (!ewl_ctx.created) {
+    APP_REQUIRE_EQ(tx_semaphore_create(&ewl_ctx.hw_sem, "venc_hw", 0), TX_SUCCESS);
+    APP_REQUIRE_EQ(tx_byte_pool_create(&ewl_ctx.heap, "venc_heap", ewl_ctx.heap_mem, sizeof(ewl_ctx.heap_mem)),
+                   TX_SUCCESS);
+    ewl_ctx.created = 1;
+  }
+  ewl_ctx.linear_used = 0;
+  return EWL_INSTANCE;
+}
+
+i32 EWLRelease(const void *inst) {
+  APP_REQUIRE(inst == EWL_INSTANCE);
+
+  /* Linear buffers all go with the instance */
+  ewl_ctx.linear_used = 0;
+  return EWL_OK;
+}
+
+void EWLWriteReg(const void *inst, u32 offset, u32 val) {
+  UNUSED(inst);
+  VENC_REG(offset) = val;
+}
+
+void EWLEnableHW(const void *inst, u32 offset, u32 val) {
+  UNUSED(inst);
+  /* Stale completion of an encode that timed out */
+  while (tx_semaphore_get(&ewl_ctx.hw_sem, TX_NO_WAIT) == TX_SUCCESS) {
+  }
+  VENC_REG(offset) = val;
+}
+
+void EWLDisableHW(const void *inst, u32 offset, u32 val) {
+  UNUSED(inst);
+  VENC_REG(offset) = val;
+}
+
+u32 EWLReadReg(const void *inst, u32 offset) {
+  UNUSED(inst);
+  return VENC_REG(offset);
+}
+
+i32 EWLMallocLinear(const void *inst, u32 size, EWLLinearMem_t *info) {
+  uint32_t offset = (ewl_ctx.linear_used + VENC_LINEAR_ALIGN - 1U) & ~(VENC_LINEAR_ALIGN - 1U);
+
+  UNUSED(inst);
+
+  if (offset + size > VENC_EWL_POOL_SIZE) {
+    info->virtualAddress = NULL;
+    info->busAddress = 0;
+    info->size = 0;
+    return EWL_ERROR;
+  }
+
+  ewl_ctx.linear_used = offset + size;
+  info->virtualAddress = (u32 *)(void *)(venc_ewl_pool[0] + offset);
+  info->busAddress = (ptr_t)(venc_ewl_pool[0] + offset); /* Flat: CPU and bus addresses match */
+  info->size = size;
+  return EWL_OK;
+}
+
+void EWLFreeLinear(const void *inst, EWLLinearMem_t *info) {
+  /* Freed all at once by EWLRelease() */
+  UNUSED(inst);
+  UNUSED(info);
+}
+
+i32 EWLMallocRefFrm(const void *inst, u32 size, EWLLinearMem_t *info) {
+  return EWLMallocLinear(inst, size, info);
+}
+
+void EWLFreeRefFrm(const void *inst, EWLLinearMem_t *info) {
+  EWLFreeLinear(inst, info);
+}
+
+void EWLDCacheRangeFlush(const void *inst, EWLLinearMem_t *info) {
+  /* venc_ewl_pool is in the non-cacheable PSRAM stream bank */
+  UNUSED(inst);
+  UNUSED(info);
+}
+
+void EWLDCacheRangeRefresh(const void *inst, EWLLinearMem_t *info) {
+  UNUSED(inst);
+  UNUSED(info);
+}
+
+i32 EWLReserveHw(const void *inst) {
+  /* Only the recording thread encodes */
+  UNUSED(inst);
+  return EWL_OK;
+}
+
+void EWLReleaseHw(const void *inst) {
+  UNUSED(inst);
+}
+
+i32 EWLWaitHwRdy(const void *inst, u32 *slicesReady) {
+  UNUSED(inst);
+
+  if (slicesReady != NULL) {
+    *slicesReady = 0;
+  }
+  if (tx_semaphore_get(&ewl_ctx.hw_sem, VENC_HW_TIMEOUT_TICKS) != TX_SUCCESS) {
+    return EWL_HW_WAIT_TIMEOUT;
+  }
+  return EWL_HW_WAIT_OK;
+}
+
+void *EWLmalloc(u32 n) {
+  void *p;
+
+  if (tx_byte_allocate(&ewl_ctx.heap, &p, n, TX_NO_WAIT) != TX_SUCCESS) {
+    return NULL;
+  }
+  return p;
+}
+
+void *EWLcalloc(u32 n, u32 s) {
+  void *p = EWLmalloc(n * s);
+
+  if (p != NULL) {
+    memset(p, 0, n * s);
+  }
+  return p;
+}
+
+void EWLfree(void *p) {
+  if (p != NULL) {
+    APP_REQUIRE_EQ(tx_byte_release(p), TX_SUCCESS);
+  }
+}
+
+void *EWLmemcpy(void *d, const void *s, u32 n) {
+  return memcpy(d, s, n);
+}
+
+void *EWLmemset(void *d, i32 c, u32 n) {
+  return memset(d, c, n);
+}
+
+int EWLmemcmp(const void *s1, const void *s2, u32 n) {
+  return memcmp(s1, s2, n);
+}
+
+/**
+ * @brief  VENC interrupt handler (call from VENC_IRQHandler)
+ * @note   Clears the IRQ line only: the library reads the status bits
+ */
+void Venc_IRQHandler(void) {
+  uint32_t status = VENC_REG(VENC_REG_IRQ);
+
+  if ((status & VENC_IRQ_LINE) != 0U) {
+    VENC_REG(VENC_REG_IRQ) = status & ~VENC_IRQ_LINE;
+    tx_semaphore_put(&ewl_ctx.hw_sem);
+  }
+}
+
+#endif /* VENC_ENABLE */
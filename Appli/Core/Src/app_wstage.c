@@ -0,0 +1,234 @@
+/**
+ ******************************************************************************
+ * @file    app_wstage.c
+ * @author  Long Liangmao
+ * @brief   Boot-time NPU weight staging implementation for STM32N6570-DK
+ *
+ *          The generated epochs read the weights from the octoFlash (8-bit
+ *          xSPI2, 1/6 of the NPU clock). At boot, HPDMA copies the weight
+ *          span of every registered network to a boot-only area of the
+ *          hyperRAM (16-bit xSPI1, 1/5); from the stream engine hook
+ *          (app_npu_cache.c), every read starting in a span is moved to the
+ *          copy. Offsets stay relative
+ *          to the base, so only the base moves. Networks sharing weights
+ *          (NN_SHARED_LAYOUT, or a common backbone at the same octoFlash
+ *          offsets) have their overlapping spans merged and copied once.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_wstage.h"
+
+#if WEIGHT_STAGE_ENABLE
+
+#include "app_error.h"
+#include "app_time.h"
+#include "app_x-cube-ai.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+
+#if NN_EPOCH_CONTROLLER
+#error "WEIGHT_STAGE_ENABLE rebases CPU-programmed stream engines: the epoch controller blob sets its own"
+#endif
+
+/* Copy DMA: one HPDMA channel, memory to memory, unused by the BSP */
+#define WSTAGE_DMA_CHANNEL HPDMA1_Channel13
+
+/* xSPI2 memory-mapped window, holding the octoFlash pool of the network */
+#define WSTAGE_FLASH_START 0x70000000U
+#define WSTAGE_FLASH_END 0x80000000U
+
+/* Copies keep the 32-byte phase of their flash source (stream engine bursts) */
+#define WSTAGE_ALIGN 32U
+#define WSTAGE_DMA_BLOCK (32U * 1024U) /* Under the 64 KB HPDMA block limit */
+#define WSTAGE_DMA_TIMEOUT_MS 100U
+
+#if (WEIGHT_STAGE_SIZE % WSTAGE_ALIGN) != 0
+#error "WEIGHT_STAGE_SIZE must be a multiple of 32 bytes"
+#endif
+
+/* Weights of one or more networks: [flash, flash + len) copied to stage */
+typedef struct {
+  uint32_t flash;
+  uint32_t len;
+  uint32_t stage;
+} wstage_span_t;
+
+/* Copies, after the NPU pool in the hyperRAM (STM32N657XX_LRUN.ld) */
+static uint8_t staging[WEIGHT_STAGE_SIZE] ALIGN_PSRAM_ROW IN_PSRAM_STAGE;
+
+static struct {
+  DMA_HandleTypeDef hdma;
+  wstage_span_t spans[MX_X_CUBE_AI_NET_NB];
+  uint32_t nb;
+  uint8_t disabled; /* Weights read in place, see WStage_SetEnabled() */
+  wstage_stats_t stats;
+} ws_ctx;
+
+/**
+ * @brief  OctoFlash extent of the weights of a network
+ * @retval 0 if it has no weights in the octoFlash
+ */
+static int WStage_FindSpan(const NN_Instance_TypeDef *instance, wstage_span_t *span) {
+  const LL_Buffer_InfoTypeDef *info = LL_ATON_Internal_Buffers_Info(instance);
+  uint32_t lo = UINT32_MAX, hi = 0;
+
+  APP_REQUIRE(info != NULL);
+
+  for (; info->name != NULL; info++) {
+    uint32_t start = (uint32_t)LL_Buffer_addr_start(info);
+    uint32_t end = (uint32_t)LL_Buffer_addr_end(info);
+
+    if (!info->is_param || start < WSTAGE_FLASH_START || end > WSTAGE_FLASH_END) {
+      continue;
+    }
+    lo = MIN(lo, start);
+    hi = MAX(hi, end);
+  }
+  if (lo >= hi) {
+    return 0;
+  }
+
+  span->flash = lo & ~(WSTAGE_ALIGN - 1U);
+  span->len = ((hi + WSTAGE_ALIGN - 1U) & ~(WSTAGE_ALIGN - 1U)) - span->flash;
+  return 1;
+}
+
+/**
+ * @brief  Add the span of one network, merged with those it overlaps
+ */
+static void WStage_AddSpan(wstage_span_t span) {
+  uint32_t i = 0;
+
+  while (i < ws_ctx.nb) {
+    const wstage_span_t *other = &ws_ctx.spans[i];
+    uint32_t lo = MAX(span.flash, other->flash);
+    uint32_t hi = MIN(span.flash + span.len, other->flash + other->len);
+
+    if (lo >= hi) {
+      i++;
+      continue;
+    }
+    lo = MIN(span.flash, other->flash);
+    hi = MAX(span.flash + span.len, other->flash + other->len);
+    span.flash = lo;
+    span.len = hi - lo;
+    ws_ctx.spans[i] = ws_ctx.spans[--ws_ctx.nb]; /* The union may reach the others */
+    i = 0;
+  }
+  ws_ctx.spans[ws_ctx.nb++] = span;
+}
+
+/**
+ * @brief  Copy one span, block by block, polling the DMA
+ */
+static void WStage_Copy(const wstage_span_t *span) {
+  for (uint32_t done = 0; done < span->len; done += WSTAGE_DMA_BLOCK) {
+    uint32_t len = MIN(WSTAGE_DMA_BLOCK, span->len - done);
+
+    APP_REQUIRE_EQ(HAL_DMA_Start(&ws_ctx.hdma, span->flash + done, span->stage + done, len), HAL_OK);
+    APP_REQUIRE_EQ(HAL_DMA_PollForTransfer(&ws_ctx.hdma, HAL_DMA_FULL_TRANSFER, WSTAGE_DMA_TIMEOUT_MS), HAL_OK);
+  }
+}
+
+/**
+ * @brief  Copy the weights of every registered network to the hyperRAM
+ */
+void WStage_Init(void) {
+  uint32_t next = 0;
+  uint64_t start;
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  ws_ctx.hdma.Instance = WSTAGE_DMA_CHANNEL;
+  ws_ctx.hdma.Init.Request = DMA_REQUEST_SW;
+  ws_ctx.hdma.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  ws_ctx.hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  ws_ctx.hdma.Init.SrcInc = DMA_SINC_INCREMENTED;
+  ws_ctx.hdma.Init.DestInc = DMA_DINC_INCREMENTED;
+  ws_ctx.hdma.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_DOUBLEWORD;
+  ws_ctx.hdma.Init.DestDataWidth = DMA_DEST_DATAWIDTH_DOUBLEWORD;
+  ws_ctx.hdma.Init.Priority = DMA_HIGH_PRIORITY; /* Nothing else runs on the NPU yet */
+  ws_ctx.hdma.Init.SrcBurstLength = 4;            /* 4 x 64-bit: one 32-byte line */
+  ws_ctx.hdma.Init.DestBurstLength = 4;
+  ws_ctx.hdma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  ws_ctx.hdma.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  ws_ctx.hdma.Init.Mode = DMA_NORMAL;
+  APP_REQUIRE_EQ(HAL_DMA_Init(&ws_ctx.hdma), HAL_OK);
+  APP_REQUIRE_EQ(HAL_DMA_ConfigChannelAttributes(&ws_ctx.hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                                   DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC),
+                 HAL_OK);
+
+  start = Time_GetUs();
+  for (uint32_t id = 0; id < MX_X_CUBE_AI_NET_NB; id++) {
+    NN_Instance_TypeDef *instance = MX_X_CUBE_AI_GetNetwork(id);
+    wstage_span_t span;
+
+    if (instance == NULL || !WStage_FindSpan(instance, &span)) {
+      continue;
+    }
+    ws_ctx.stats.shared += span.len;
+    WStage_AddSpan(span);
+  }
+
+  for (uint32_t i = 0; i < ws_ctx.nb; i++) {
+    wstage_span_t *span = &ws_ctx.spans[i];
+
+    APP_REQUIRE(span->len <= WEIGHT_STAGE_SIZE - next);
+    span->stage = (uint32_t)&staging[next];
+    next += span->len;
+
+    WStage_Copy(span);
+    ws_ctx.stats.bytes += span->len;
+  }
+  ws_ctx.stats.shared -= ws_ctx.stats.bytes;
+  ws_ctx.stats.us = (uint32_t)(Time_GetUs() - start);
+  ws_ctx.stats.nb_spans = ws_ctx.nb;
+
+  APP_REQUIRE_EQ(HAL_DMA_DeInit(&ws_ctx.hdma), HAL_OK);
+}
+
+/**
+ * @brief  Point a stream engine read of staged weights at the copy
+ */
+void WStage_Rebase(LL_Streng_TensorInitTypeDef *conf) {
+  uint32_t addr = conf->addr_base.i + conf->offset_start;
+
+  if (ws_ctx.disabled || conf->dir != 0) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < ws_ctx.nb; i++) {
+    const wstage_span_t *span = &ws_ctx.spans[i];
+
+    if (addr - span->flash < span->len) {
+      conf->addr_base.i += span->stage - span->flash;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief  Read the weights from the copy or in place
+ */
+void WStage_SetEnabled(int enable) {
+  ws_ctx.disabled = !enable;
+}
+
+/**
+ * @brief  Copy the boot copy figures
+ */
+void WStage_GetStats(wstage_stats_t *stats) {
+  *stats = ws_ctx.stats;
+}
+
+#endif /* WEIGHT_STAGE_ENABLE */
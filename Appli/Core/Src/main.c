@@ -32,7 +32,10 @@
 #include "tx_api.h"
 
 #include "stm32n6570_discovery_xspi.h"
+#include "app_config.h"
 #include "app_lcd.h"
+#include "app_boottime.h"
+#include "app_crashlog.h"
 
 /* USER CODE END Includes */
 
@@ -55,6 +58,9 @@
 /* USER CODE BEGIN PV */
 volatile uint8_t *g_error_file = NULL;
 volatile uint32_t g_error_line = 0;
+
+/* PSRAM DMA stream rings (STM32N657XX_LRUN.ld) */
+extern uint8_t __psram_stream_start[], __psram_stream_end[];
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -77,7 +83,11 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+#if BOOT_PROFILER
+  BootTime_AppEntry();
+#endif
   SystemClock_Config();
+  BOOT_MARK(BOOT_PHASE_APP_CLOCKS);
 
   MEMSYSCTL->MSCR |= MEMSYSCTL_MSCR_ICACTIVE_Msk;
   MEMSYSCTL->MSCR |= MEMSYSCTL_MSCR_DCACTIVE_Msk;
@@ -110,6 +120,7 @@ int main(void)
   MX_RAMCFG_Init();
   SystemIsolation_Config();
   /* USER CODE BEGIN 2 */
+  BOOT_MARK(BOOT_PHASE_APP_HAL);
   /* USER CODE END 2 */
 
   MX_ThreadX_Init();
@@ -376,14 +387,39 @@ void MPU_Config(void)
 
   HAL_MPU_ConfigRegion(&MPU_InitStruct);
 
-  /** Initializes and configures the Region 1 and the memory to be protected
+#if PSRAM_MPU_MODE == PSRAM_MPU_STREAMS_UNCACHED
+  /** Region 1: PSRAM DMA stream rings (camera display, ML capture), non-cacheable
   */
   MPU_InitStruct.Number = MPU_REGION_NUMBER1;
-  MPU_InitStruct.BaseAddress = 0x91000000;
+  MPU_InitStruct.BaseAddress = (uint32_t)__psram_stream_start;
+  MPU_InitStruct.LimitAddress = (uint32_t)__psram_stream_end - 1;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+  /** Region 2: rest of PSRAM (UI, NN outputs) to the end of the device, cached write-back
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER2;
+  MPU_InitStruct.BaseAddress = (uint32_t)__psram_stream_end;
   MPU_InitStruct.LimitAddress = 0x91FFFFFF;
+  MPU_InitStruct.AttributesIndex = MPU_ATTRIBUTES_NUMBER1;
 
   HAL_MPU_ConfigRegion(&MPU_InitStruct);
 
+  MPU_AttributesInit.Number = MPU_ATTRIBUTES_NUMBER1;
+  MPU_AttributesInit.Attributes = INNER_OUTER(MPU_WRITE_BACK | MPU_NON_TRANSIENT | MPU_RW_ALLOCATE);
+
+  HAL_MPU_ConfigMemoryAttributes(&MPU_AttributesInit);
+#else
+  /** Region 1: every PSRAM buffer, non-cacheable; the NPU pool and the
+   *  boot-only areas ahead of them keep the default map
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER1;
+  MPU_InitStruct.BaseAddress = (uint32_t)__psram_stream_start;
+  MPU_InitStruct.LimitAddress = 0x91FFFFFF;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+#endif
+
   /** Initializes and configures the Attribute 0 and the memory to be protected
   */
   MPU_AttributesInit.Number = MPU_ATTRIBUTES_NUMBER0;
@@ -405,6 +441,10 @@ void MPU_Config(void)
 void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
+#if CRASH_LOG
+  __disable_irq();
+  CrashLog_RecordPanic((const char *)g_error_file, g_error_line);
+#endif
   BSP_LED_Init(LED_GREEN);
   BSP_LED_Init(LED_RED);
 
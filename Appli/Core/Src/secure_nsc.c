@@ -22,6 +22,15 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "secure_nsc.h"
+#include "app_npu_cipher.h"
+#include "app_nsshare.h"
+#if NS_SPLIT
+#include <arm_cmse.h>
+#include <string.h>
+#include "app_buffers.h"
+#include "app_cam.h"
+#include "app_x-cube-ai.h"
+#endif
 /** @addtogroup STM32N6xx_HAL_Examples
 
   * @{
@@ -39,6 +48,9 @@ void *pSecureErrorCallback = NULL;   /* Pointer to secure error callback in Non-
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if NS_SPLIT
+static uint32_t ns_rejected;   /* Commands refused since start */
+#endif
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -67,6 +79,91 @@ void *pSecureErrorCallback = NULL;   /* Pointer to secure error callback in Non-
       }
   }
 
+#if NPU_WEIGHT_CIPHER
+/**
+  * @brief  Secure provisioning of the NPU weights key for a non-secure caller.
+  * @retval None
+  */
+  CMSE_NS_ENTRY void SECURE_NPU_LoadWeightKeys(void)
+  {
+    NPUCipher_LoadKeys();
+  }
+#endif
+
+#if NS_SPLIT
+/**
+  * @brief  Hand the shared result block to the non-secure side.
+  * @retval Non-secure alias of the block (ns_shared_t)
+  */
+  CMSE_NS_ENTRY void *SECURE_NS_Attach(void)
+  {
+    return NSShare_GetNsAlias();
+  }
+
+/**
+  * @brief  Apply a batch of non-secure controls in one transition.
+  * @param  cmds  commands, in non-secure memory
+  * @param  nb    number of commands, at most NS_SPLIT_CMD_MAX
+  * @retval Commands applied; the first invalid one ends the batch
+  */
+  CMSE_NS_ENTRY uint32_t SECURE_NS_Submit(const SECURE_NS_CommandTypeDef *cmds, uint32_t nb)
+  {
+    SECURE_NS_CommandTypeDef batch[NS_SPLIT_CMD_MAX];
+    uint32_t done;
+
+    if(nb > NS_SPLIT_CMD_MAX ||
+       cmse_check_address_range((void *)cmds, nb * sizeof(*cmds), CMSE_NONSECURE) == NULL)
+    {
+      ns_rejected += nb;
+      return 0;
+    }
+    /* Checked once, read once: the caller may rewrite its buffer meanwhile */
+    memcpy(batch, cmds, nb * sizeof(*cmds));
+
+    for(done = 0; done < nb; done++)
+    {
+      const SECURE_NS_CommandTypeDef *cmd = &batch[done];
+
+      if(cmd->id == SECURE_NS_CMD_SELECT_NETWORK && cmd->arg >= 0 &&
+         MX_X_CUBE_AI_GetNetwork((uint32_t)cmd->arg) != NULL)
+      {
+        NN_RequestNetwork((uint32_t)cmd->arg);
+      }
+      else if(cmd->id == SECURE_NS_CMD_SET_FRAME_RATE && cmd->arg > 0 && cmd->arg <= CAMERA_FPS)
+      {
+        CAM_SetFrameRate(cmd->arg);
+      }
+      else
+      {
+        break;
+      }
+    }
+    ns_rejected += nb - done;
+    return done;
+  }
+
+/**
+  * @brief  Secure-side counters for the non-secure telemetry, once per period.
+  * @param  telemetry  output, in non-secure memory
+  * @retval None
+  */
+  CMSE_NS_ENTRY void SECURE_NS_GetTelemetry(SECURE_NS_TelemetryTypeDef *telemetry)
+  {
+    buffer_display_stats_t display;
+
+    if(cmse_check_address_range(telemetry, sizeof(*telemetry), CMSE_NONSECURE | CMSE_MPU_READWRITE) == NULL)
+    {
+      return;
+    }
+    Buffer_CameraDisplay_GetStats(&display);
+    telemetry->display_frame_id = display.front_frame_id;
+    telemetry->display_age_us = display.age_us;
+    telemetry->display_dropped = display.dropped;
+    telemetry->display_repeated = display.repeated;
+    telemetry->rejected = ns_rejected;
+  }
+#endif
+
 /**
   * @}
   */
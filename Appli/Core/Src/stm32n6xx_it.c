@@ -24,6 +24,23 @@
 /* USER CODE BEGIN Includes */
 #include "stm32n6xx_hal.h"
 #include "cmw_camera.h"
+#include "app_dataset.h"
+#include "app_eth.h"
+#include "app_isrprof.h"
+#include "app_lcd.h"
+#include "app_overlay.h"
+#include "app_pcprof.h"
+#include "app_prefetch.h"
+#include "app_scrub.h"
+#include "app_sdlog.h"
+#include "app_sensor_cmd.h"
+#include "app_snapshot.h"
+#include "app_telemetry.h"
+#include "app_time.h"
+#include "app_threadprof.h"
+#include "app_trace.h"
+#include "app_venc.h"
+#include "app_config.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -59,7 +76,9 @@
 /* External variables --------------------------------------------------------*/
 
 /* USER CODE BEGIN EV */
-
+#if ISP_TUNING_ENABLE || USB_STREAM_ENABLE
+extern PCD_HandleTypeDef hpcd_USB1_OTG_HS;
+#endif
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -182,9 +201,15 @@ void DCMIPP_IRQHandler(void)
 {
   /* USER CODE BEGIN DCMIPP_IRQn 0 */
   DCMIPP_HandleTypeDef *hdcmipp_ptr = CMW_CAMERA_GetDCMIPPHandle();
+  ISRPROF_ENTER(ISRPROF_IRQ_DCMIPP);
+  THREADPROF_ISR_ENTER();
+  TRACE_BEGIN(DCMIPP_IRQ);
   if (hdcmipp_ptr != NULL) {
     HAL_DCMIPP_IRQHandler(hdcmipp_ptr);
   }
+  TRACE_END(DCMIPP_IRQ);
+  THREADPROF_ISR_EXIT();
+  ISRPROF_EXIT(ISRPROF_IRQ_DCMIPP);
   /* USER CODE END DCMIPP_IRQn 0 */
   /* USER CODE BEGIN DCMIPP_IRQn 1 */
 
@@ -198,9 +223,13 @@ void CSI_IRQHandler(void)
 {
   /* USER CODE BEGIN CSI_IRQn 0 */
   DCMIPP_HandleTypeDef *hdcmipp_ptr = CMW_CAMERA_GetDCMIPPHandle();
+  ISRPROF_ENTER(ISRPROF_IRQ_CSI);
+  THREADPROF_ISR_ENTER();
   if (hdcmipp_ptr != NULL) {
     HAL_DCMIPP_CSI_IRQHandler(hdcmipp_ptr);
   }
+  THREADPROF_ISR_EXIT();
+  ISRPROF_EXIT(ISRPROF_IRQ_CSI);
 
   /* USER CODE END CSI_IRQn 0 */
   /* USER CODE BEGIN CSI_IRQn 1 */
@@ -210,6 +239,229 @@ void CSI_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+ * @brief This function handles DMA2D global interrupt.
+ */
+void DMA2D_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Overlay_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
+/**
+ * @brief This function handles LTDC low-layer global interrupt.
+ */
+void LTDC_LO_IRQHandler(void)
+{
+  ISRPROF_ENTER(ISRPROF_IRQ_LTDC_LO);
+  THREADPROF_ISR_ENTER();
+  LCD_IRQHandler();
+  THREADPROF_ISR_EXIT();
+  ISRPROF_EXIT(ISRPROF_IRQ_LTDC_LO);
+}
+
+/**
+ * @brief This function handles LTDC up-layer global interrupt.
+ */
+void LTDC_UP_IRQHandler(void)
+{
+  ISRPROF_ENTER(ISRPROF_IRQ_LTDC_UP);
+  THREADPROF_ISR_ENTER();
+  LCD_IRQHandler();
+  THREADPROF_ISR_EXIT();
+  ISRPROF_EXIT(ISRPROF_IRQ_LTDC_UP);
+}
+
+#if WEIGHT_PREFETCH_ENABLE
+/**
+ * @brief This function handles HPDMA1 channel 12 interrupt (weight prefetch).
+ */
+void HPDMA1_Channel12_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Prefetch_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if SCRUB_ENABLE
+/**
+ * @brief This function handles HPDMA1 channel 14 interrupt (weight scrubbing).
+ */
+void HPDMA1_Channel14_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Scrub_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if SNAPSHOT_ENABLE
+/**
+ * @brief This function handles JPEG global interrupt (snapshots).
+ */
+void JPEG_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Snapshot_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
+/**
+ * @brief This function handles HPDMA1 channel 10 interrupt (JPEG input).
+ */
+void HPDMA1_Channel10_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Snapshot_DmaInIRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
+/**
+ * @brief This function handles HPDMA1 channel 11 interrupt (JPEG output).
+ */
+void HPDMA1_Channel11_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Snapshot_DmaOutIRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if TELEMETRY
+/**
+ * @brief This function handles GPDMA1 channel 0 interrupt (telemetry TX).
+ */
+void GPDMA1_Channel0_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Telemetry_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
+/**
+ * @brief This function handles USART1 global interrupt (telemetry requests).
+ */
+void USART1_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Telemetry_UartIRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if PC_PROFILER
+/**
+ * @brief This function handles TIM2 global interrupt (PC sampler).
+ *        Naked: the stack pointer of the interrupted context, untouched,
+ *        points at its exception frame; EXC_RETURN stays in LR
+ */
+__attribute__((naked)) void TIM2_IRQHandler(void)
+{
+  __asm volatile(
+      "tst lr, #4\n"
+      "ite eq\n"
+      "mrseq r0, msp\n"
+      "mrsne r0, psp\n"
+      "mov r1, lr\n"
+      "b PcProf_IRQHandler\n");
+}
+#endif
+
+#if ETH_PUBLISH
+/**
+ * @brief This function handles ETH1 global interrupt (UDP publisher).
+ */
+void ETH1_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Eth_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if VENC_ENABLE
+/**
+ * @brief This function handles VENC global interrupt (H.264 encoder).
+ */
+void VENC_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Venc_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if SD_LOG
+/**
+ * @brief This function handles SDMMC2 global interrupt (microSD log).
+ */
+void SDMMC2_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  SdLog_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if DATASET_ENABLE
+/**
+ * @brief This function handles SDMMC2 global interrupt (dataset capture).
+ */
+void SDMMC2_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Dataset_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if SENSOR_CMD_ENABLE
+/**
+ * @brief This function handles I2C1 event interrupt (sensor commands).
+ */
+void I2C1_EV_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  SensorCmd_EvIRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
+/**
+ * @brief This function handles I2C1 error interrupt (sensor commands).
+ */
+void I2C1_ER_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  SensorCmd_ErIRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+#if ISP_TUNING_ENABLE || USB_STREAM_ENABLE
+/**
+ * @brief This function handles USB1 OTG HS global interrupt (ISP tuning link
+ *        or composite video and telemetry device).
+ */
+void USB1_OTG_HS_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  HAL_PCD_IRQHandler(&hpcd_USB1_OTG_HS);
+  THREADPROF_ISR_EXIT();
+}
+#endif
+
+/**
+ * @brief This function handles TIM5 global interrupt (timebase).
+ */
+void TIM5_IRQHandler(void)
+{
+  THREADPROF_ISR_ENTER();
+  Time_IRQHandler();
+  THREADPROF_ISR_EXIT();
+}
+
 
 /**
  * @brief This function handles IAC global interrupt.
@@ -0,0 +1,541 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_conf.c
+  * @version        : v2.0_Cube
+  * @brief          : This file implements the board support package for the
+  *                   USB device library of the remote ISP tuning link
+  *                   (ISP_TUNING_ENABLE) or of the composite video and
+  *                   telemetry device (USB_STREAM_ENABLE): USB1 OTG HS,
+  *                   embedded HS PHY
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 Long Liangmao.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_config.h"
+
+#if ISP_TUNING_ENABLE || USB_STREAM_ENABLE
+#include "stm32n6xx.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6xx_hal_rif.h"
+#include "usbd_def.h"
+#include "usbd_core.h"
+#if ISP_TUNING_ENABLE
+#include "usbd_cdc.h"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+
+/* Embedded PHY reference: HSE (48 MHz) through the oscillator divider by 2 */
+#define USB_PHY_FSEL_24MHZ          USB_USBPHYC_CR_FSEL_1
+
+/* Private variables ---------------------------------------------------------*/
+#if USB_STREAM_ENABLE
+/* The OTG DMA writes the SETUP packets into the handle */
+PCD_HandleTypeDef hpcd_USB1_OTG_HS __attribute__((section(".noncacheable"), aligned(32)));
+#else
+PCD_HandleTypeDef hpcd_USB1_OTG_HS;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static USBD_StatusTypeDef USBD_Get_USB_Status(HAL_StatusTypeDef hal_status);
+
+/*******************************************************************************
+                       LL Driver Callbacks (PCD -> USB Device Library)
+*******************************************************************************/
+/* MSP Init */
+
+void HAL_PCD_MspInit(PCD_HandleTypeDef* pcdHandle)
+{
+  RCC_PeriphCLKInitTypeDef PeriphClkInitStruct = {0};
+#if USB_STREAM_ENABLE
+  RIMC_MasterConfig_t master = {0};
+#endif
+
+  if (pcdHandle->Instance == USB1_OTG_HS)
+  {
+    /** Initializes the peripherals clock
+    */
+    PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_USBPHY1 | RCC_PERIPHCLK_USBOTGHS1;
+    PeriphClkInitStruct.UsbPhy1ClockSelection = RCC_USBPHY1CLKSOURCE_HSE_DIRECT;
+    PeriphClkInitStruct.UsbOtgHs1ClockSelection = RCC_USBOTGHS1CLKSOURCE_HSE_DIRECT;
+    if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    /* Enable the VDD33USB independent USB 33 voltage monitor */
+    HAL_PWREx_EnableVddUSBVMEN();
+
+    /* Wait until VDD33USB is ready */
+    while (__HAL_PWR_GET_FLAG(PWR_FLAG_USB33RDY) == 0U)
+    {
+    }
+
+    /* Enable VDDUSB supply */
+    HAL_PWREx_EnableVddUSB();
+
+    /* Peripheral clock enable */
+    __HAL_RCC_USB1_OTG_HS_CLK_ENABLE();
+
+    /* Required few clock cycles before accessing USB PHY Controller Registers */
+    HAL_Delay(1);
+
+    /* Select the 24 MHz PHY reference */
+    USB1_HS_PHYC->USBPHYC_CR &= ~USB_USBPHYC_CR_FSEL;
+    USB1_HS_PHYC->USBPHYC_CR |= USB_PHY_FSEL_24MHZ;
+
+    __HAL_RCC_USB1_OTG_HS_PHY_RELEASE_RESET();
+
+    /* Required few clock cycles before Releasing Reset */
+    HAL_Delay(1);
+
+    __HAL_RCC_USB1_OTG_HS_RELEASE_RESET();
+
+    __HAL_RCC_USB1_OTG_HS_PHY_CLK_ENABLE();
+
+#if USB_STREAM_ENABLE
+    /* The OTG DMA reads the access unit and telemetry rings: secure privileged */
+    master.MasterCID = RIF_CID_1;
+    master.SecPriv = RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV;
+    HAL_RIF_RIMC_ConfigMasterAttributes(RIF_MASTER_INDEX_OTG1, &master);
+    HAL_RIF_RISC_SetSlaveSecureAttributes(RIF_RISC_PERIPH_INDEX_OTG1HS, RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV);
+#endif
+
+    /* Peripheral interrupt init */
+    HAL_NVIC_SetPriority(USB1_OTG_HS_IRQn, USB_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USB1_OTG_HS_IRQn);
+  }
+}
+
+void HAL_PCD_MspDeInit(PCD_HandleTypeDef* pcdHandle)
+{
+  if (pcdHandle->Instance == USB1_OTG_HS)
+  {
+    /* Disable peripheral interrupt */
+    HAL_NVIC_DisableIRQ(USB1_OTG_HS_IRQn);
+
+    /* Peripheral clock disable */
+    __HAL_RCC_USB1_OTG_HS_CLK_DISABLE();
+    __HAL_RCC_USB1_OTG_HS_PHY_CLK_DISABLE();
+  }
+}
+
+/**
+  * @brief  Setup stage callback
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_SetupStage((USBD_HandleTypeDef*)hpcd->pData, (uint8_t *)hpcd->Setup);
+}
+
+/**
+  * @brief  Data Out stage callback.
+  * @param  hpcd: PCD handle
+  * @param  epnum: Endpoint number
+  * @retval None
+  */
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+  USBD_LL_DataOutStage((USBD_HandleTypeDef*)hpcd->pData, epnum, hpcd->OUT_ep[epnum].xfer_buff);
+}
+
+/**
+  * @brief  Data In stage callback.
+  * @param  hpcd: PCD handle
+  * @param  epnum: Endpoint number
+  * @retval None
+  */
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+  USBD_LL_DataInStage((USBD_HandleTypeDef*)hpcd->pData, epnum, hpcd->IN_ep[epnum].xfer_buff);
+}
+
+/**
+  * @brief  SOF callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_SOFCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_SOF((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/**
+  * @brief  Reset callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_SpeedTypeDef speed = USBD_SPEED_FULL;
+
+  if (hpcd->Init.speed == PCD_SPEED_HIGH)
+  {
+    speed = USBD_SPEED_HIGH;
+  }
+
+  /* Set Speed. */
+  USBD_LL_SetSpeed((USBD_HandleTypeDef*)hpcd->pData, speed);
+
+  /* Reset Device. */
+  USBD_LL_Reset((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/**
+  * @brief  Suspend callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_Suspend((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/**
+  * @brief  Resume callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_Resume((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/**
+  * @brief  ISOOUTIncomplete callback.
+  * @param  hpcd: PCD handle
+  * @param  epnum: Endpoint number
+  * @retval None
+  */
+void HAL_PCD_ISOOUTIncompleteCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+  USBD_LL_IsoOUTIncomplete((USBD_HandleTypeDef*)hpcd->pData, epnum);
+}
+
+/**
+  * @brief  ISOINIncomplete callback.
+  * @param  hpcd: PCD handle
+  * @param  epnum: Endpoint number
+  * @retval None
+  */
+void HAL_PCD_ISOINIncompleteCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+  USBD_LL_IsoINIncomplete((USBD_HandleTypeDef*)hpcd->pData, epnum);
+}
+
+/**
+  * @brief  Connect callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_ConnectCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_DevConnected((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/**
+  * @brief  Disconnect callback.
+  * @param  hpcd: PCD handle
+  * @retval None
+  */
+void HAL_PCD_DisconnectCallback(PCD_HandleTypeDef *hpcd)
+{
+  USBD_LL_DevDisconnected((USBD_HandleTypeDef*)hpcd->pData);
+}
+
+/*******************************************************************************
+                       LL Driver Interface (USB Device Library --> PCD)
+*******************************************************************************/
+
+/**
+  * @brief  Initializes the low level portion of the device driver.
+  * @param  pdev: Device handle
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
+{
+  if (pdev->id != DEVICE_HS)
+  {
+    return USBD_FAIL;
+  }
+
+#if USB_STREAM_ENABLE
+  /* Not zeroed at load (.noncacheable): HAL_PCD_Init() needs the reset state */
+  memset(&hpcd_USB1_OTG_HS, 0, sizeof(hpcd_USB1_OTG_HS));
+#endif
+
+  /* Link the driver to the stack. */
+  hpcd_USB1_OTG_HS.pData = pdev;
+  pdev->pData = &hpcd_USB1_OTG_HS;
+
+  hpcd_USB1_OTG_HS.Instance = USB1_OTG_HS;
+  hpcd_USB1_OTG_HS.Init.dev_endpoints = 9;
+  hpcd_USB1_OTG_HS.Init.speed = PCD_SPEED_HIGH;
+#if USB_STREAM_ENABLE
+  /* Zero copy: the endpoints read the rings in place */
+  hpcd_USB1_OTG_HS.Init.dma_enable = ENABLE;
+#else
+  hpcd_USB1_OTG_HS.Init.dma_enable = DISABLE;
+#endif
+  hpcd_USB1_OTG_HS.Init.phy_itface = USB_OTG_HS_EMBEDDED_PHY;
+  hpcd_USB1_OTG_HS.Init.Sof_enable = DISABLE;
+  hpcd_USB1_OTG_HS.Init.low_power_enable = DISABLE;
+  hpcd_USB1_OTG_HS.Init.lpm_enable = DISABLE;
+  hpcd_USB1_OTG_HS.Init.vbus_sensing_enable = DISABLE;
+  hpcd_USB1_OTG_HS.Init.use_dedicated_ep1 = DISABLE;
+  if (HAL_PCD_Init(&hpcd_USB1_OTG_HS) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+#if USB_STREAM_ENABLE
+  /* FIFOs, in words: control, CDC data IN, CDC notification IN, and one
+   * whole isochronous packet of the UVC endpoint */
+  HAL_PCDEx_SetRxFiFo(&hpcd_USB1_OTG_HS, 0x200);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 0, 0x40);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 1, 0x80);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 2, 0x10);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 3, USB_UVC_PACKET_SIZE / 4);
+#else
+  /* FIFOs, in words: control and CDC data IN, CDC notification IN */
+  HAL_PCDEx_SetRxFiFo(&hpcd_USB1_OTG_HS, 0x200);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 0, 0x80);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 1, 0x174);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB1_OTG_HS, 2, 0x10);
+#endif
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  De-Initializes the low level portion of the device driver.
+  * @param  pdev: Device handle
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_DeInit(USBD_HandleTypeDef *pdev)
+{
+  return USBD_Get_USB_Status(HAL_PCD_DeInit(pdev->pData));
+}
+
+/**
+  * @brief  Starts the low level portion of the device driver.
+  * @param  pdev: Device handle
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_Start(USBD_HandleTypeDef *pdev)
+{
+  return USBD_Get_USB_Status(HAL_PCD_Start(pdev->pData));
+}
+
+/**
+  * @brief  Stops the low level portion of the device driver.
+  * @param  pdev: Device handle
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_Stop(USBD_HandleTypeDef *pdev)
+{
+  return USBD_Get_USB_Status(HAL_PCD_Stop(pdev->pData));
+}
+
+/**
+  * @brief  Opens an endpoint of the low level driver.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @param  ep_type: Endpoint type
+  * @param  ep_mps: Endpoint max packet size
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_Open(pdev->pData, ep_addr, ep_mps, ep_type));
+}
+
+/**
+  * @brief  Closes an endpoint of the low level driver.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_Close(pdev->pData, ep_addr));
+}
+
+/**
+  * @brief  Flushes an endpoint of the Low Level Driver.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_Flush(pdev->pData, ep_addr));
+}
+
+/**
+  * @brief  Sets a Stall condition on an endpoint of the Low Level Driver.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_SetStall(pdev->pData, ep_addr));
+}
+
+/**
+  * @brief  Clears a Stall condition on an endpoint of the Low Level Driver.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_ClrStall(pdev->pData, ep_addr));
+}
+
+/**
+  * @brief  Returns Stall condition.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval Stall (1: Yes, 0: No)
+  */
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  PCD_HandleTypeDef *hpcd = (PCD_HandleTypeDef*) pdev->pData;
+
+  if ((ep_addr & 0x80) == 0x80)
+  {
+    return hpcd->IN_ep[ep_addr & 0x7F].is_stall;
+  }
+  else
+  {
+    return hpcd->OUT_ep[ep_addr & 0x7F].is_stall;
+  }
+}
+
+/**
+  * @brief  Assigns a USB address to the device.
+  * @param  pdev: Device handle
+  * @param  dev_addr: Device address
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_SetUSBAddress(USBD_HandleTypeDef *pdev, uint8_t dev_addr)
+{
+  return USBD_Get_USB_Status(HAL_PCD_SetAddress(pdev->pData, dev_addr));
+}
+
+/**
+  * @brief  Transmits data over an endpoint.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @param  pbuf: Pointer to data to be sent
+  * @param  size: Data size
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint32_t size)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_Transmit(pdev->pData, ep_addr, pbuf, size));
+}
+
+/**
+  * @brief  Prepares an endpoint for reception.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @param  pbuf: Pointer to data to be received
+  * @param  size: Data size
+  * @retval USBD status
+  */
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint32_t size)
+{
+  return USBD_Get_USB_Status(HAL_PCD_EP_Receive(pdev->pData, ep_addr, pbuf, size));
+}
+
+/**
+  * @brief  Returns the last transferred packet size.
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint number
+  * @retval Received Data Size
+  */
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return HAL_PCD_EP_GetRxCount((PCD_HandleTypeDef*) pdev->pData, ep_addr);
+}
+
+/**
+  * @brief  Delays routine for the USB device library.
+  * @param  Delay: Delay in ms
+  * @retval None
+  */
+void USBD_LL_Delay(uint32_t Delay)
+{
+  HAL_Delay(Delay);
+}
+
+/**
+  * @brief  Static single allocation.
+  * @param  size: Size of allocated memory
+  * @retval None
+  */
+void *USBD_static_malloc(uint32_t size)
+{
+#if ISP_TUNING_ENABLE
+  /* The CDC class is the only one registered */
+  static uint32_t mem[(sizeof(USBD_CDC_HandleTypeDef) / 4) + 1];
+
+  if (size > sizeof(mem))
+  {
+    return NULL;
+  }
+
+  return mem;
+#else
+  /* The composite class of app_usb.c keeps its state statically */
+  UNUSED(size);
+  return NULL;
+#endif
+}
+
+/**
+  * @brief  Dummy memory free
+  * @param  p: Pointer to allocated  memory address
+  * @retval None
+  */
+void USBD_static_free(void *p)
+{
+  UNUSED(p);
+}
+
+/**
+  * @brief  Returns the USB status depending on the HAL status:
+  * @param  hal_status: HAL status
+  * @retval USB status
+  */
+static USBD_StatusTypeDef USBD_Get_USB_Status(HAL_StatusTypeDef hal_status)
+{
+  switch (hal_status)
+  {
+    case HAL_OK :
+      return USBD_OK;
+    case HAL_BUSY :
+      return USBD_BUSY;
+    default :
+      return USBD_FAIL;
+  }
+}
+
+#endif /* ISP_TUNING_ENABLE || USB_STREAM_ENABLE */
@@ -62,6 +62,32 @@ Reset_Handler:
 /* Call the clock system initialization function.*/
   bl  SystemInit
 
+/* Copy the ITCM code and the DTCM data from their load image, clear the
+ * DTCM bss (STM32N657XX_LRUN.ld) */
+  ldr r0, =__itcm_start
+  ldr r1, =__itcm_end
+  ldr r2, =__itcm_load
+  bl CopyTcm
+  ldr r0, =__dtcm_data_start
+  ldr r1, =__dtcm_data_end
+  ldr r2, =__dtcm_data_load
+  bl CopyTcm
+  ldr r2, =__dtcm_bss_start
+  ldr r4, =__dtcm_bss_end
+  movs r3, #0
+  b LoopFillZeroDtcm
+
+FillZeroDtcm:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroDtcm:
+  cmp r2, r4
+  bcc FillZeroDtcm
+/* The ITCM code is executed next: complete the stores first */
+  dsb
+  isb
+
 /* Copy the data segment initializers from flash to SRAM */
   ldr r0, =_sdata
   ldr r1, =_edata
@@ -103,6 +129,23 @@ LoopForever:
 
   .size Reset_Handler, .-Reset_Handler
 
+/* Copy words from r2 to [r0, r1) */
+  .section .text.CopyTcm
+  .type CopyTcm, %function
+CopyTcm:
+  b LoopCopyTcm
+
+CopyTcmWord:
+  ldr r3, [r2], #4
+  str r3, [r0], #4
+
+LoopCopyTcm:
+  cmp r0, r1
+  bcc CopyTcmWord
+  bx lr
+
+  .size CopyTcm, .-CopyTcm
+
 /**
  * @brief  This is the code that gets called when the processor receives an
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
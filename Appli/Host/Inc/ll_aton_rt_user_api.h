@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ * @file    ll_aton_rt_user_api.h
+ * @author  Long Liangmao
+ * @brief   NPU runtime subset of the host replay (Firmware_HostReplay)
+ *          Enough of the LL_ATON network interface for app_postprocess.h:
+ *          the replay never runs a network, recorded outputs stand in
+ *          for the NPU
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LL_ATON_RT_USER_API_H
+#define LL_ATON_RT_USER_API_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Values of ll_aton_NN_interface.h */
+typedef enum {
+  DataType_FLOAT = 1,
+  DataType_INT8 = 7,
+} Buffer_DataType_TypeDef;
+
+/* The fields app_postprocess.h reads */
+typedef struct {
+  const char *name;
+  Buffer_DataType_TypeDef type;
+  const float *scale;
+  const int16_t *offset;
+} LL_Buffer_InfoTypeDef;
+
+typedef struct __nn_instance_struct NN_Instance_TypeDef;
+
+const LL_Buffer_InfoTypeDef *LL_ATON_Output_Buffers_Info(const NN_Instance_TypeDef *nn_instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LL_ATON_RT_USER_API_H */
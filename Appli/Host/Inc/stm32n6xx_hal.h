@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    stm32n6xx_hal.h
+ * @author  Long Liangmao
+ * @brief   HAL subset of the host replay (Firmware_HostReplay)
+ *          DWT stamps are simulated cycles of a SystemCoreClock CPU, advanced
+ *          by the event clock of host_replay.c. No cache to maintain and no
+ *          interrupt to mask: the replay runs every module on one thread
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef STM32N6XX_HAL_H
+#define STM32N6XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define UNUSED(X) (void)X
+
+#define __NVIC_PRIO_BITS 4U
+
+typedef struct {
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern uint32_t SystemCoreClock;
+extern DWT_Type HostReplay_Dwt;
+
+#define DWT (&HostReplay_Dwt)
+
+static inline void SCB_CleanDCache_by_Addr(void *addr, int32_t dsize) {
+  (void)addr;
+  (void)dsize;
+}
+
+static inline void SCB_InvalidateDCache_by_Addr(void *addr, int32_t dsize) {
+  (void)addr;
+  (void)dsize;
+}
+
+static inline void SCB_CleanInvalidateDCache_by_Addr(void *addr, int32_t dsize) {
+  (void)addr;
+  (void)dsize;
+}
+
+static inline uint32_t __get_BASEPRI(void) {
+  return 0;
+}
+
+static inline void __set_BASEPRI(uint32_t basepri) {
+  (void)basepri;
+}
+
+static inline void __set_BASEPRI_MAX(uint32_t basepri) {
+  (void)basepri;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32N6XX_HAL_H */
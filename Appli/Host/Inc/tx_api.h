@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file    tx_api.h
+ * @author  Long Liangmao
+ * @brief   ThreadX subset of the host replay (Firmware_HostReplay)
+ *          The replay runs the application modules it builds on one
+ *          thread, so a mutex never blocks and is never contended
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef TX_API_H
+#define TX_API_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef void VOID;
+typedef char CHAR;
+typedef unsigned int UINT;
+typedef unsigned long ULONG;
+
+#define TX_SUCCESS 0x00U
+#define TX_WAIT_FOREVER 0xFFFFFFFFUL
+#define TX_NO_WAIT 0UL
+#define TX_INHERIT 1U
+#define TX_NO_INHERIT 0U
+
+typedef struct {
+  const CHAR *name;
+  UINT owned; /* Nesting count of the one thread */
+} TX_MUTEX;
+
+static inline UINT tx_mutex_create(TX_MUTEX *mutex, const CHAR *name, UINT inherit) {
+  (void)inherit;
+  mutex->name = name;
+  mutex->owned = 0;
+  return TX_SUCCESS;
+}
+
+static inline UINT tx_mutex_get(TX_MUTEX *mutex, ULONG wait_option) {
+  (void)wait_option;
+  mutex->owned++;
+  return TX_SUCCESS;
+}
+
+static inline UINT tx_mutex_put(TX_MUTEX *mutex) {
+  mutex->owned--;
+  return TX_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_API_H */
@@ -0,0 +1,49 @@
+/**
+ ******************************************************************************
+ * @file    utils.h
+ * @author  Long Liangmao
+ * @brief   Target utils.h for the host replay (Firmware_HostReplay)
+ *          The placements of STM32N657XX_LRUN.ld are dropped: on the host a
+ *          named section is stored zero-filled in the executable, and the
+ *          PSRAM frame rings would make it tens of megabytes
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_UTILS_H
+#define HOST_UTILS_H
+
+#include_next "utils.h"
+
+#undef SHARED_STATE
+#undef IN_PSRAM
+#undef IN_PSRAM_DISPLAY
+#undef IN_PSRAM_ML
+#undef IN_PSRAM_UI
+#undef IN_PSRAM_NN
+#undef IN_PSRAM_STAGE
+#undef IN_PSRAM_TRACE
+#undef IN_AXISRAM3
+#undef IN_AXISRAM6
+
+#define SHARED_STATE
+#define IN_PSRAM
+#define IN_PSRAM_DISPLAY
+#define IN_PSRAM_ML
+#define IN_PSRAM_UI
+#define IN_PSRAM_NN
+#define IN_PSRAM_STAGE
+#define IN_PSRAM_TRACE
+#define IN_AXISRAM3
+#define IN_AXISRAM6
+
+#endif /* HOST_UTILS_H */
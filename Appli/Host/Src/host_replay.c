@@ -0,0 +1,678 @@
+/**
+ ******************************************************************************
+ * @file    host_replay.c
+ * @author  Long Liangmao
+ * @brief   Host replay of the detection back end and the frame rings
+ *          (Firmware_HostReplay)
+ *
+ *          Replays a recorded scenes blob (the PP_BENCH layout of
+ *          app_ppbench.h, the file flash.ps1 writes at
+ *          PPBENCH_SCENES_FLASH_ADDR) on a simulated timeline. Timed stubs
+ *          stand in for the sensor and DCMIPP (vsync and frame events at the
+ *          camera rate), the NPU (a fixed inference time) and the LTDC
+ *          (vblanks at the panel rate), and drive the unchanged camera
+ *          display and ML capture rings of app_buffers.c in the order
+ *          app_cam.c and app_nn.c call them: DISPLAY_POLICY, drops, repeats
+ *          and display age follow the target. Each inference takes the next
+ *          scene as its NPU outputs, through the ST YOLOX post processor and
+ *          the unchanged app_tracker.c and app_arena.c.
+ *
+ *          Not replayed: app_cam.c, app_nn.c and app_ui.c themselves (their
+ *          thread entries need the camera middleware, the ISP, the LL_ATON
+ *          runtime and the BSP LCD), UI rendering and ThreadX scheduling: a
+ *          stub thread is never preempted and only the NPU and the
+ *          post-processing take time.
+ *
+ *          One line per inference: sensor frame, capture to detections
+ *          latency, host microseconds per post-processing stage,
+ *          candidates, detections and confirmed track IDs; a summary with
+ *          the ring statistics closes the run.
+ *
+ *          Usage: Firmware_HostReplay <scenes.bin> [-l loops] [-f fps]
+ *                 [-n npu_us] [-p pp_us]
+ *          -p 0 (default) puts the host post-processing time on the
+ *          timeline. A mismatched scene shape is an APP_REQUIRE panic,
+ *          reported with its file and line
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_postprocess.h"
+#include "app_config.h"
+#include "app_arena.h"
+#include "app_buffers.h"
+#include "app_error.h"
+#include "app_nn.h"
+#include "app_ppbench.h"
+#include "app_tracker.h"
+#include "od_pp_loc.h"
+#include "stm32n6xx_hal.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !TRACKER_ENABLE
+#error "The host replay runs the tracker: needs TRACKER_ENABLE"
+#endif
+#if DISPLAY_SINGLE_PIPE
+#error "The host replay drives the Pipe1 camera display ring: needs !DISPLAY_SINGLE_PIPE"
+#endif
+
+/* ST YoloX outputs of the configured network, S/L/M in network output order */
+#define HOSTREPLAY_ST_YOLOX_STRIDE (AI_OD_ST_YOLOX_PP_NB_CLASSES + AI_YOLOV2_PP_CLASSPROB)
+#define HOSTREPLAY_ST_YOLOX_VALUES(w, h) ((w) * (h) * AI_OD_ST_YOLOX_PP_NB_ANCHORS * HOSTREPLAY_ST_YOLOX_STRIDE)
+
+/* Per-frame arena: the tracker scratch, as the post-processing thread takes it */
+#define HOSTREPLAY_ARENA_SIZE TRACKER_SCRATCH_SIZE
+
+#define HOSTREPLAY_NS_PER_US 1000ULL
+
+/* Stub timing: panel refresh, DCMIPP frame event after its vsync (the rest
+ * of the period is vertical blanking), default inference time (-n, the
+ * board's figure belongs there) */
+#define HOSTREPLAY_LCD_HZ 60U
+#define HOSTREPLAY_READOUT_PCT 90U
+#define HOSTREPLAY_NPU_US 25000U
+
+/* Snapshot requested as the inference starts, as NN_SNAPSHOT_AHEAD in app_nn.c */
+#define HOSTREPLAY_SNAPSHOT_AHEAD (ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT && !ML_INPUT_ALIAS)
+
+#define HOSTREPLAY_NEVER UINT64_MAX
+
+typedef struct {
+  uint64_t sum;
+  uint64_t max;
+} hostreplay_stat_t;
+
+static struct {
+  uint64_t stamps[AI_OD_POSTPROCESS_STAGE_NB]; /* CLOCK_MONOTONIC ns of each stage start */
+  hostreplay_stat_t stages[AI_OD_POSTPROCESS_STAGE_NB];
+  hostreplay_stat_t tracker;
+  uint32_t frames;
+  uint32_t skipped;
+  uint32_t max_tracks;
+  uint32_t snapshots;
+} replay_ctx;
+
+/* Stub hardware and threads around the rings, times in simulated cycles */
+static struct {
+  uint64_t now;
+  uint64_t period;      /* Sensor frame */
+  uint64_t vsync;       /* Next sensor vsync */
+  uint64_t frame_event; /* Next DCMIPP frame event, HOSTREPLAY_NEVER in blanking */
+  uint64_t vblank;      /* Next LTDC vblank */
+  uint64_t nn_done;     /* End of the running inference, HOSTREPLAY_NEVER when idle */
+  uint64_t pp_done;     /* End of the running post-processing, HOSTREPLAY_NEVER when idle */
+  uint64_t npu_cycles;
+  uint64_t pp_cycles;   /* 0: the host post-processing time */
+  uint32_t vsyncs;
+  int display_slot[2];  /* Pipe1 address registers */
+  uint32_t display_bank; /* Register the current frame is written through */
+  const uint8_t *reload; /* Camera layer staged for the next vblank, NULL if none */
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  int ml_slot;          /* Armed snapshot, -1 if none */
+  uint32_t ml_vsync;    /* Sensor frame it captures */
+  uint32_t ml_since_arm;
+  uint64_t ml_deadline;
+  uint8_t ml_requested;
+#else
+  int ml_slot[2];       /* Pipe2 address registers */
+  uint32_t ml_bank;
+#endif
+  uint8_t frame_ready;  /* NN_EVENT_FRAME */
+  uint8_t nn_slot;      /* The inference thread holds an output slot */
+  uint32_t free_slots;  /* Output slots neither inferred into nor post-processed */
+  uint32_t nn_count;
+  uint64_t nn_start;
+  uint64_t busy_cycles; /* Frame taken to ready for the next one, last frame */
+  buffer_frame_tag_t nn_tag;
+  buffer_frame_tag_t ready[NN_OUTPUT_BUFFER_NB]; /* Outputs waiting for post-processing, oldest first */
+  uint32_t ready_head;
+  uint32_t ready_nb;
+  uint32_t ready_max;
+  buffer_frame_tag_t pp_tag;
+  hostreplay_stat_t latency; /* Capture vsync to published detections, us */
+  hostreplay_stat_t age;     /* Capture vsync to the vblank that latched the frame, us */
+  uint32_t latched;
+} pipe_ctx;
+
+static od_pp_outBuffer_t replay_out[APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB];
+static od_st_yolox_pp_lut_is8_t replay_lut[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+static nn_detection_t replay_dets[NN_MAX_DETECTIONS];
+static nn_detection_t replay_tracks[TRACKER_MAX_TRACKS];
+static uint32_t replay_ids[TRACKER_MAX_TRACKS];
+static uint8_t replay_arena_storage[HOSTREPLAY_ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+/* Each output as large as the L level, the largest grid */
+static uint8_t replay_tensors[3][HOSTREPLAY_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_L_GRID_WIDTH,
+                                                            AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT) * sizeof(float)]
+    __attribute__((aligned(32)));
+
+static uint64_t HostReplay_Now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void HostReplay_Accumulate(hostreplay_stat_t *stat, uint64_t ns) {
+  stat->sum += ns;
+  stat->max = MAX(stat->max, ns);
+}
+
+static uint64_t HostReplay_UsToCycles(uint64_t us) {
+  return us * (SystemCoreClock / 1000000U);
+}
+
+static uint32_t HostReplay_CyclesToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief  Stamp the start of a post-processing stage
+ * @note   AI_OD_POSTPROCESS_STAGE_HOOK of the host replay
+ */
+void HostReplay_Stage(int32_t stage) {
+  replay_ctx.stamps[stage] = HostReplay_Now();
+}
+
+/**
+ * @brief  Sensor frame the snapshot thread would photograph a track on
+ * @note   SNAPSHOT_ENABLE: the tracker itself calls it, counted only
+ */
+void Snapshot_Trigger(uint32_t track_id) {
+  UNUSED(track_id);
+  replay_ctx.snapshots++;
+}
+
+/**
+ * @brief  Whole blob file in memory
+ */
+static const ppbench_blob_t *HostReplay_Load(const char *path, long *size) {
+  FILE *f = fopen(path, "rb");
+  void *blob;
+
+  if (f == NULL) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  fseek(f, 0, SEEK_END);
+  *size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  blob = malloc((size_t)*size);
+  APP_REQUIRE(blob != NULL);
+  APP_REQUIRE_EQ(fread(blob, 1, (size_t)*size, f), (size_t)*size);
+  fclose(f);
+  return (const ppbench_blob_t *)blob;
+}
+
+/**
+ * @brief  One inference frame: post-processing, then the tracker at its vsync
+ * @retval Simulated cycles it takes on the post-processing thread
+ */
+static uint64_t HostReplay_Frame(const ppbench_blob_t *blob, const ppbench_scene_t *scene,
+                                 const buffer_frame_tag_t *tag, arena_t *arena) {
+  static const uint32_t grid_values[3] = {
+      HOSTREPLAY_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_S_GRID_WIDTH, AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT),
+      HOSTREPLAY_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_L_GRID_WIDTH, AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT),
+      HOSTREPLAY_ST_YOLOX_VALUES(AI_OD_ST_YOLOX_PP_M_GRID_WIDTH, AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT),
+  };
+  uint32_t elem = (scene->type == POSTPROCESS_OD_ST_YOLOX_UF) ? sizeof(float) : 1U;
+  od_st_yolox_pp_static_param_t params = {
+      .nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES,
+      .nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS,
+      .grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH,
+      .grid_height_L = AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT,
+      .grid_width_M = AI_OD_ST_YOLOX_PP_M_GRID_WIDTH,
+      .grid_height_M = AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT,
+      .grid_width_S = AI_OD_ST_YOLOX_PP_S_GRID_WIDTH,
+      .grid_height_S = AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT,
+      .max_boxes_limit = AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT,
+      .max_candidates = AI_OD_ST_YOLOX_PP_MAX_CANDIDATES,
+      .conf_threshold = AI_OD_ST_YOLOX_PP_CONF_THRESHOLD,
+      .iou_threshold = AI_OD_ST_YOLOX_PP_IOU_THRESHOLD,
+      .pAnchors_L = AI_OD_ST_YOLOX_PP_L_ANCHORS,
+      .pAnchors_M = AI_OD_ST_YOLOX_PP_M_ANCHORS,
+      .pAnchors_S = AI_OD_ST_YOLOX_PP_S_ANCHORS,
+      .raw_s_scale = scene->tensors[0].scale,
+      .raw_s_zero_point = (int8_t)scene->tensors[0].zero_point,
+      .raw_l_scale = scene->tensors[1].scale,
+      .raw_l_zero_point = (int8_t)scene->tensors[1].zero_point,
+      .raw_m_scale = scene->tensors[2].scale,
+      .raw_m_zero_point = (int8_t)scene->tensors[2].zero_point,
+      .pLut = (scene->type == POSTPROCESS_OD_ST_YOLOX_UI) ? replay_lut : NULL,
+  };
+  od_pp_out_t out = {.pOutBuff = replay_out, .nb_detect = 0};
+  od_st_yolox_pp_in_t pp_in = {
+      .pRaw_detections_S = replay_tensors[0],
+      .pRaw_detections_L = replay_tensors[1],
+      .pRaw_detections_M = replay_tensors[2],
+  };
+  char name[PPBENCH_SCENE_NAME_LEN + 1];
+  uint64_t stage_ns[AI_OD_POSTPROCESS_STAGE_NB];
+  uint64_t start;
+  uint64_t tracker_ns;
+  uint64_t cycles;
+  uint32_t nb_tracks;
+
+  memcpy(name, scene->name, PPBENCH_SCENE_NAME_LEN);
+  name[PPBENCH_SCENE_NAME_LEN] = '\0';
+
+  /* The NPU model: the recorded outputs land where the network writes them */
+  APP_REQUIRE_EQ(scene->nb_tensors, 3U);
+  for (uint32_t t = 0; t < 3U; t++) {
+    APP_REQUIRE_EQ(scene->tensors[t].size, grid_values[t] * elem);
+    memcpy(replay_tensors[t], (const uint8_t *)blob + scene->tensors[t].offset, scene->tensors[t].size);
+  }
+
+  APP_REQUIRE_EQ(od_st_yolox_pp_reset(&params), AI_OD_POSTPROCESS_ERROR_NO);
+  params.nb_detect = 0;
+
+  start = HostReplay_Now();
+  if (scene->type == POSTPROCESS_OD_ST_YOLOX_UF) {
+    APP_REQUIRE_EQ(od_st_yolox_pp_process(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+  } else {
+    APP_REQUIRE_EQ(od_st_yolox_pp_process_int8(&pp_in, &out, &params), AI_OD_POSTPROCESS_ERROR_NO);
+  }
+  HostReplay_Stage(AI_OD_POSTPROCESS_STAGE_END);
+
+  for (int32_t s = 0; s < AI_OD_POSTPROCESS_STAGE_END; s++) {
+    stage_ns[s] = replay_ctx.stamps[s + 1] - replay_ctx.stamps[s];
+    HostReplay_Accumulate(&replay_ctx.stages[s], stage_ns[s]);
+  }
+  stage_ns[AI_OD_POSTPROCESS_STAGE_END] = replay_ctx.stamps[AI_OD_POSTPROCESS_STAGE_END] - start;
+  HostReplay_Accumulate(&replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_END], stage_ns[AI_OD_POSTPROCESS_STAGE_END]);
+
+  /* Published as app_nn.c does, then tracked on the post-processing thread */
+  out.nb_detect = MIN(out.nb_detect, (int32_t)NN_MAX_DETECTIONS);
+  for (int32_t i = 0; i < out.nb_detect; i++) {
+    replay_dets[i] = (nn_detection_t){
+        .x_center = replay_out[i].x_center,
+        .y_center = replay_out[i].y_center,
+        .width = replay_out[i].width,
+        .height = replay_out[i].height,
+        .conf = replay_out[i].conf,
+        .class_index = replay_out[i].class_index,
+    };
+  }
+  start = HostReplay_Now();
+  Arena_Reset(arena);
+  Tracker_Update(replay_dets, (uint32_t)out.nb_detect, tag->vsync_cycles, arena);
+  tracker_ns = HostReplay_Now() - start;
+  HostReplay_Accumulate(&replay_ctx.tracker, tracker_ns);
+
+  cycles = pipe_ctx.pp_cycles;
+  if (cycles == 0U) {
+    cycles = (stage_ns[AI_OD_POSTPROCESS_STAGE_END] + tracker_ns) * (SystemCoreClock / 1000000U) /
+             HOSTREPLAY_NS_PER_US;
+  }
+
+  /* What the display shows once the detections are out */
+  nb_tracks = Tracker_Predict(replay_tracks, replay_ids, TRACKER_MAX_TRACKS, (uint32_t)(pipe_ctx.now + cycles));
+  replay_ctx.max_tracks = MAX(replay_ctx.max_tracks, nb_tracks);
+
+  printf("%5lu frame %5lu %6lu us %-12s %s decode %6llu nms %6llu score %6llu pp %6llu us, cand %4ld det %3ld "
+         "tracks %2lu:",
+         (unsigned long)replay_ctx.frames, (unsigned long)tag->frame_id,
+         (unsigned long)HostReplay_CyclesToUs((uint32_t)(pipe_ctx.now + cycles) - tag->vsync_cycles), name,
+         (scene->type == POSTPROCESS_OD_ST_YOLOX_UF) ? "uf" : "ui",
+         (unsigned long long)(stage_ns[AI_OD_POSTPROCESS_STAGE_DECODE] / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(stage_ns[AI_OD_POSTPROCESS_STAGE_NMS] / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(stage_ns[AI_OD_POSTPROCESS_STAGE_SCORE] / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(stage_ns[AI_OD_POSTPROCESS_STAGE_END] / HOSTREPLAY_NS_PER_US), (long)params.nb_detect,
+         (long)out.nb_detect, (unsigned long)nb_tracks);
+  for (uint32_t i = 0; i < nb_tracks; i++) {
+    printf(" %lu", (unsigned long)replay_ids[i]);
+  }
+  printf("\n");
+  replay_ctx.frames++;
+  return cycles;
+}
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+/**
+ * @brief  Arm a Pipe2 snapshot: it captures the frame after the next vsync
+ */
+static void HostReplay_MLArm(int slot) {
+  pipe_ctx.ml_slot = slot;
+  pipe_ctx.ml_vsync = pipe_ctx.vsyncs + 1U;
+  pipe_ctx.ml_since_arm = 0;
+  pipe_ctx.ml_requested = 0;
+}
+
+/**
+ * @brief  Snapshot due as CAM_MLPipe_SnapshotDue(): at most one every
+ *         NN_FRAME_DECIMATION frames, and not earlier than the deadline needs
+ */
+static int HostReplay_MLDue(void) {
+  return pipe_ctx.ml_since_arm >= NN_FRAME_DECIMATION &&
+         (int64_t)(pipe_ctx.now + 2U * pipe_ctx.period - pipe_ctx.ml_deadline) >= 0;
+}
+
+/**
+ * @brief  CAM_MLPipe_RequestSnapshot() of the inference thread
+ */
+static void HostReplay_MLRequest(uint64_t deadline) {
+  if (pipe_ctx.ml_slot >= 0) {
+    return;
+  }
+  pipe_ctx.ml_deadline = deadline;
+  if (HostReplay_MLDue()) {
+    HostReplay_MLArm(Buffer_MLCapture_NextCapture(-1));
+  } else {
+    pipe_ctx.ml_requested = 1;
+  }
+}
+#endif
+
+/**
+ * @brief  Sensor vsync: CMW_CAMERA_PIPE_VsyncEventCallback()
+ */
+static void HostReplay_Vsync(void) {
+  Buffer_Camera_FrameStart();
+  pipe_ctx.vsyncs++;
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  if (pipe_ctx.ml_since_arm < NN_FRAME_DECIMATION) {
+    pipe_ctx.ml_since_arm++;
+  }
+  if (pipe_ctx.ml_requested && HostReplay_MLDue()) {
+    HostReplay_MLArm(Buffer_MLCapture_NextCapture(-1));
+  }
+#endif
+  pipe_ctx.frame_event = pipe_ctx.now + pipe_ctx.period * HOSTREPLAY_READOUT_PCT / 100U;
+  pipe_ctx.vsync += pipe_ctx.period;
+}
+
+/**
+ * @brief  End of the frame on both pipes: CAM_DisplayPipe_FrameEvent() and
+ *         CAM_MLPipe_FrameEvent()
+ */
+static void HostReplay_FrameEvent(void) {
+  int show = Buffer_CameraDisplay_Complete(pipe_ctx.display_slot[pipe_ctx.display_bank]);
+
+  pipe_ctx.display_slot[pipe_ctx.display_bank] = Buffer_CameraDisplay_NextCapture();
+  pipe_ctx.display_bank ^= 1U;
+  if (show >= 0) {
+    pipe_ctx.reload = Buffer_GetCameraDisplayBuffer(show);
+  }
+
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  if (pipe_ctx.ml_slot >= 0 && pipe_ctx.ml_vsync == pipe_ctx.vsyncs) {
+    Buffer_MLCapture_Complete(pipe_ctx.ml_slot);
+    pipe_ctx.ml_slot = -1;
+    pipe_ctx.frame_ready = 1;
+  }
+#else
+  /* DCMIPP frame rate decimation: only some frames reach the pipe */
+  if (pipe_ctx.vsyncs % NN_FRAME_DECIMATION == 0U) {
+    int completed = pipe_ctx.ml_slot[pipe_ctx.ml_bank];
+
+    Buffer_MLCapture_Complete(completed);
+    pipe_ctx.ml_slot[pipe_ctx.ml_bank] = Buffer_MLCapture_NextCapture(pipe_ctx.ml_slot[pipe_ctx.ml_bank ^ 1U]);
+    pipe_ctx.ml_bank ^= 1U;
+    pipe_ctx.frame_ready = 1;
+  }
+#endif
+  pipe_ctx.frame_event = HOSTREPLAY_NEVER;
+}
+
+/**
+ * @brief  LTDC vblank: the staged camera layer is latched
+ */
+static void HostReplay_Vblank(void) {
+  buffer_display_stats_t stats;
+
+  if (pipe_ctx.reload != NULL) {
+    Buffer_CameraDisplay_Shown(pipe_ctx.reload);
+    pipe_ctx.reload = NULL;
+    Buffer_CameraDisplay_GetStats(&stats);
+    HostReplay_Accumulate(&pipe_ctx.age, stats.age_us);
+    pipe_ctx.latched++;
+  }
+  pipe_ctx.vblank += SystemCoreClock / HOSTREPLAY_LCD_HZ;
+}
+
+/**
+ * @brief  Inference done: the outputs go to the post-processing thread
+ */
+static void HostReplay_NNDone(void) {
+  pipe_ctx.ready[(pipe_ctx.ready_head + pipe_ctx.ready_nb) % NN_OUTPUT_BUFFER_NB] = pipe_ctx.nn_tag;
+  pipe_ctx.ready_nb++;
+  pipe_ctx.ready_max = MAX(pipe_ctx.ready_max, pipe_ctx.ready_nb);
+  pipe_ctx.nn_count++;
+  pipe_ctx.nn_done = HOSTREPLAY_NEVER;
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT && ML_INPUT_ALIAS
+  HostReplay_MLRequest(pipe_ctx.now);
+#endif
+}
+
+/**
+ * @brief  Detections published: the display may show their frame
+ */
+static void HostReplay_PPDone(void) {
+  Buffer_CameraDisplay_SetSyncFrame(pipe_ctx.pp_tag.frame_id);
+  HostReplay_Accumulate(&pipe_ctx.latency, HostReplay_CyclesToUs(DWT->CYCCNT - pipe_ctx.pp_tag.vsync_cycles));
+  pipe_ctx.free_slots++;
+  pipe_ctx.pp_done = HOSTREPLAY_NEVER;
+}
+
+/**
+ * @brief  The inference thread between inferences: an output slot first,
+ *         then the newest frame (nn_thread_entry())
+ */
+static void HostReplay_NNThread(void) {
+  int capture_idx;
+
+  if (pipe_ctx.nn_done != HOSTREPLAY_NEVER) {
+    return;
+  }
+  if (!pipe_ctx.nn_slot) {
+    if (pipe_ctx.free_slots == 0U) {
+      return;
+    }
+    pipe_ctx.free_slots--;
+    pipe_ctx.nn_slot = 1;
+    pipe_ctx.busy_cycles = (pipe_ctx.nn_count > 0U) ? pipe_ctx.now - pipe_ctx.nn_start : 0U;
+  }
+  if (!pipe_ctx.frame_ready) {
+    return;
+  }
+  pipe_ctx.frame_ready = 0;
+  capture_idx = Buffer_MLCapture_Acquire();
+  if (capture_idx < 0) {
+    return;
+  }
+
+  pipe_ctx.nn_start = pipe_ctx.now;
+  pipe_ctx.nn_tag = Buffer_MLCapture_GetTag(capture_idx);
+  /* Copied into the network input: the slot goes back at once */
+  Buffer_MLCapture_Release();
+#if HOSTREPLAY_SNAPSHOT_AHEAD
+  HostReplay_MLRequest(pipe_ctx.nn_start + pipe_ctx.busy_cycles);
+#endif
+  pipe_ctx.nn_slot = 0;
+  pipe_ctx.nn_done = pipe_ctx.now + pipe_ctx.npu_cycles;
+}
+
+/**
+ * @brief  The post-processing thread: the oldest outputs, through the
+ *         post processor and the tracker
+ * @retval 1 if it took outputs, 0 if busy or nothing waits
+ */
+static int HostReplay_PPThread(const ppbench_blob_t *blob, const ppbench_scene_t *scene, arena_t *arena) {
+  if (pipe_ctx.pp_done != HOSTREPLAY_NEVER || pipe_ctx.ready_nb == 0U) {
+    return 0;
+  }
+  pipe_ctx.pp_tag = pipe_ctx.ready[pipe_ctx.ready_head];
+  pipe_ctx.ready_head = (pipe_ctx.ready_head + 1U) % NN_OUTPUT_BUFFER_NB;
+  pipe_ctx.ready_nb--;
+  pipe_ctx.pp_done = pipe_ctx.now + HostReplay_Frame(blob, scene, &pipe_ctx.pp_tag, arena);
+  return 1;
+}
+
+/**
+ * @brief  Rings and stubs as App_Init() and CAM_*Pipe_Start() leave them
+ */
+static void HostReplay_PipeInit(uint32_t fps, uint32_t npu_us, uint32_t pp_us) {
+  memset(&pipe_ctx, 0, sizeof(pipe_ctx));
+  Buffer_Init();
+
+  pipe_ctx.period = SystemCoreClock / fps;
+  pipe_ctx.vsync = pipe_ctx.period;
+  pipe_ctx.frame_event = HOSTREPLAY_NEVER;
+  pipe_ctx.vblank = SystemCoreClock / HOSTREPLAY_LCD_HZ;
+  pipe_ctx.nn_done = HOSTREPLAY_NEVER;
+  pipe_ctx.pp_done = HOSTREPLAY_NEVER;
+  pipe_ctx.npu_cycles = HostReplay_UsToCycles(npu_us);
+  pipe_ctx.pp_cycles = HostReplay_UsToCycles(pp_us);
+  pipe_ctx.free_slots = NN_OUTPUT_BUFFER_NB;
+
+  pipe_ctx.display_slot[0] = Buffer_GetCameraCaptureIndex();
+  pipe_ctx.display_slot[1] = Buffer_CameraDisplay_NextCapture();
+#if ML_CAPTURE_MODE == ML_CAPTURE_SNAPSHOT
+  HostReplay_MLArm(Buffer_GetMLCaptureIndex());
+#else
+  pipe_ctx.ml_slot[0] = Buffer_GetMLCaptureIndex();
+  pipe_ctx.ml_slot[1] = Buffer_MLCapture_NextCapture(pipe_ctx.ml_slot[0]);
+#endif
+}
+
+/**
+ * @brief  Run the timeline until every inference frame is post-processed
+ */
+static void HostReplay_Run(const ppbench_blob_t *blob, const ppbench_scene_t *const *scenes, uint32_t nb_frames,
+                           arena_t *arena) {
+  uint32_t started = 0;
+
+  while (replay_ctx.frames < nb_frames || pipe_ctx.pp_done != HOSTREPLAY_NEVER) {
+    pipe_ctx.now = MIN(MIN(pipe_ctx.vsync, pipe_ctx.frame_event), pipe_ctx.vblank);
+    pipe_ctx.now = MIN(pipe_ctx.now, MIN(pipe_ctx.nn_done, pipe_ctx.pp_done));
+    DWT->CYCCNT = (uint32_t)pipe_ctx.now;
+
+    /* Simultaneous events: the threads first, then the interrupts */
+    if (pipe_ctx.pp_done == pipe_ctx.now) {
+      HostReplay_PPDone();
+    } else if (pipe_ctx.nn_done == pipe_ctx.now) {
+      HostReplay_NNDone();
+    } else if (pipe_ctx.frame_event == pipe_ctx.now) {
+      HostReplay_FrameEvent();
+    } else if (pipe_ctx.vsync == pipe_ctx.now) {
+      HostReplay_Vsync();
+    } else {
+      HostReplay_Vblank();
+    }
+
+    HostReplay_NNThread();
+    if (started < nb_frames && HostReplay_PPThread(blob, scenes[started], arena)) {
+      started++;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  const ppbench_blob_t *blob;
+  const ppbench_scene_t *scenes;
+  const ppbench_scene_t **frames;
+  buffer_display_stats_t display;
+  buffer_ml_stats_t ml;
+  uint32_t loops = 1;
+  uint32_t fps = CAMERA_FPS;
+  uint32_t npu_us = HOSTREPLAY_NPU_US;
+  uint32_t pp_us = 0;
+  uint32_t nb_frames = 0;
+  arena_t arena;
+  long size;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <scenes.bin> [-l loops] [-f fps] [-n npu_us] [-p pp_us]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  for (int i = 2; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "-l") == 0) {
+      loops = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+    } else if (strcmp(argv[i], "-f") == 0) {
+      fps = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+    } else if (strcmp(argv[i], "-n") == 0) {
+      npu_us = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+    } else if (strcmp(argv[i], "-p") == 0) {
+      pp_us = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+    }
+  }
+  APP_REQUIRE(loops > 0 && fps > 0 && npu_us > 0);
+
+  blob = HostReplay_Load(argv[1], &size);
+  APP_REQUIRE_EQ(blob->magic, PPBENCH_BLOB_MAGIC);
+  APP_REQUIRE((long)(sizeof(*blob) + blob->nb_scenes * sizeof(ppbench_scene_t)) <= size);
+  scenes = (const ppbench_scene_t *)(blob + 1);
+  for (uint32_t i = 0; i < blob->nb_scenes; i++) {
+    for (uint32_t t = 0; t < scenes[i].nb_tensors && t < PPBENCH_MAX_TENSORS; t++) {
+      APP_REQUIRE((long)scenes[i].tensors[t].offset + (long)scenes[i].tensors[t].size <= size);
+    }
+  }
+
+  /* The inference frames, in order: every ST YOLOX scene, loops times */
+  frames = malloc((size_t)blob->nb_scenes * loops * sizeof(*frames));
+  APP_REQUIRE(frames != NULL || blob->nb_scenes == 0);
+  for (uint32_t loop = 0; loop < loops; loop++) {
+    for (uint32_t i = 0; i < blob->nb_scenes; i++) {
+      if (scenes[i].type != POSTPROCESS_OD_ST_YOLOX_UF && scenes[i].type != POSTPROCESS_OD_ST_YOLOX_UI) {
+        replay_ctx.skipped++;
+        continue;
+      }
+      frames[nb_frames++] = &scenes[i];
+    }
+  }
+  if (nb_frames == 0) {
+    printf("hostreplay: no ST YOLOX scene in %s\n", argv[1]);
+    return EXIT_SUCCESS;
+  }
+
+  Tracker_Init();
+  Arena_Init(&arena, replay_arena_storage, sizeof(replay_arena_storage));
+  HostReplay_PipeInit(fps, npu_us, pp_us);
+
+  printf("hostreplay: %lu scenes x %lu, %lu fps, 1/%d to the ML pipe, NPU %lu us, %lu MHz simulated\n",
+         (unsigned long)blob->nb_scenes, (unsigned long)loops, (unsigned long)fps, NN_FRAME_DECIMATION,
+         (unsigned long)npu_us, (unsigned long)(SystemCoreClock / 1000000U));
+  HostReplay_Run(blob, frames, nb_frames, &arena);
+
+  Buffer_CameraDisplay_GetStats(&display);
+  Buffer_MLCapture_GetStats(&ml);
+  printf("hostreplay: %lu frames, %lu skipped; us mean/max decode %llu/%llu nms %llu/%llu score %llu/%llu "
+         "pp %llu/%llu tracker %llu/%llu; tracks max %lu, snapshot triggers %lu, arena peak %lu\n",
+         (unsigned long)replay_ctx.frames, (unsigned long)replay_ctx.skipped,
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_DECODE].sum / replay_ctx.frames /
+                              HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_DECODE].max / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_NMS].sum / replay_ctx.frames /
+                              HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_NMS].max / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_SCORE].sum / replay_ctx.frames /
+                              HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_SCORE].max / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_END].sum / replay_ctx.frames /
+                              HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.stages[AI_OD_POSTPROCESS_STAGE_END].max / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.tracker.sum / replay_ctx.frames / HOSTREPLAY_NS_PER_US),
+         (unsigned long long)(replay_ctx.tracker.max / HOSTREPLAY_NS_PER_US), (unsigned long)replay_ctx.max_tracks,
+         (unsigned long)replay_ctx.snapshots, (unsigned long)arena.peak);
+  printf("hostreplay: %lu sensor frames; ML ring %lu consumed, %lu skipped; display ring %lu dropped, "
+         "%lu repeated, age mean/max %llu/%llu us; outputs waiting max %lu; capture to detections mean/max "
+         "%llu/%llu us\n",
+         (unsigned long)pipe_ctx.vsyncs, (unsigned long)ml.consumed, (unsigned long)ml.skipped,
+         (unsigned long)display.dropped, (unsigned long)display.repeated,
+         (unsigned long long)(pipe_ctx.latched ? pipe_ctx.age.sum / pipe_ctx.latched : 0U),
+         (unsigned long long)pipe_ctx.age.max, (unsigned long)pipe_ctx.ready_max,
+         (unsigned long long)(pipe_ctx.latency.sum / replay_ctx.frames), (unsigned long long)pipe_ctx.latency.max);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/**
+ ******************************************************************************
+ * @file    host_shim.c
+ * @author  Long Liangmao
+ * @brief   Target services of the host replay (Firmware_HostReplay)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_error.h"
+#include "app_params.h"
+#include "stm32n6xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* CPU with overdrive, as SystemClock_Config() sets it */
+uint32_t SystemCoreClock = 800000000U;
+
+/* Simulated cycle counter, set by the event clock of host_replay.c */
+DWT_Type HostReplay_Dwt;
+
+volatile uint8_t *g_error_file = NULL;
+volatile uint32_t g_error_line = 0;
+
+/**
+ * @brief  APP_Panic() target: the failing location, then a failed exit
+ */
+void Error_Handler(void) {
+  fprintf(stderr, "panic at %s:%lu\n", (const char *)g_error_file, (unsigned long)g_error_line);
+  exit(EXIT_FAILURE);
+}
+
+#if PARAMS_ENABLE
+/**
+ * @brief  Parameters stay at their defaults: no store, no telemetry
+ */
+int32_t Params_GetInt(param_id_t id) {
+  static const int32_t defaults[PARAM_NB] = {
+#define PARAM_DEFAULT(id, name, type, min, max, step, def, keep) [PARAM_##id] = (int32_t)(def),
+      PARAMS_TABLE(PARAM_DEFAULT)
+#undef PARAM_DEFAULT
+  };
+
+  APP_REQUIRE((unsigned)id < PARAM_NB);
+  return defaults[id];
+}
+#endif
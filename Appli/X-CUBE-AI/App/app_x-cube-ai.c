@@ -47,11 +47,122 @@
 #include "main.h"
 
 /* USER CODE BEGIN includes */
+#include "app_config.h"
+#if HEALTH_MONITOR
+#include "app_health.h"
+#include "app_npu_cipher.h"
+#include "app_time.h"
+#include "ll_aton_osal_user_impl.h"
+#endif
 /* USER CODE END includes */
 
 /* Entry points --------------------------------------------------------------*/
 
 LL_ATON_DECLARE_NAMED_NN_INSTANCE_AND_INTERFACE(od_yolo_x_person)
+/* USER CODE BEGIN networks */
+#if NN_SHARED_LAYOUT
+/* Generated alike (checked by CMake), object_detection_yolo_x.c is not built:
+ * an execution state of its own over the od_yolo_x_person code and tables */
+LL_ATON_DECLARE_NAMED_NN_INSTANCE(object_detection_yolo_x, &NN_Interface_od_yolo_x_person);
+#else
+LL_ATON_DECLARE_NAMED_NN_INSTANCE_AND_INTERFACE(object_detection_yolo_x)
+#endif
+
+#if defined(LL_ATON_RT_RELOC)
+/* Installed relocatable network; network stays NULL until installed */
+static NN_Instance_TypeDef NN_Instance_reloc;
+
+/* Data/bss of the installed binary (XIP mode: code and weights stay in flash) */
+static uint8_t reloc_exec_ram[NN_RELOC_EXEC_RAM_SIZE] __attribute__((aligned(32)));
+
+/*
+ * The binary only carries the network name in its interface. These routes
+ * let the LL_ATON_* user API (buffer info, user I/O) reach it like a
+ * statically linked network; the runtime dispatches epochs on inst_reloc.
+ */
+static bool reloc_ec_network_init(void)
+{
+    return ai_rel_network_ec_network_init(NN_Instance_reloc.exec_state.inst_reloc);
+}
+
+static bool reloc_ec_inference_init(void)
+{
+    return ai_rel_network_ec_inference_init(NN_Instance_reloc.exec_state.inst_reloc);
+}
+
+static LL_ATON_User_IO_Result_t reloc_set_input(uint32_t num, void *buffer, uint32_t size)
+{
+    return ll_aton_reloc_set_input(&NN_Instance_reloc, num, buffer, size);
+}
+
+static void *reloc_get_input(uint32_t num)
+{
+    return ll_aton_reloc_get_input(&NN_Instance_reloc, num);
+}
+
+static LL_ATON_User_IO_Result_t reloc_set_output(uint32_t num, void *buffer, uint32_t size)
+{
+    return ll_aton_reloc_set_output(&NN_Instance_reloc, num, buffer, size);
+}
+
+static void *reloc_get_output(uint32_t num)
+{
+    return ll_aton_reloc_get_output(&NN_Instance_reloc, num);
+}
+
+static const EpochBlock_ItemTypeDef *reloc_epoch_block_items(void)
+{
+    return ai_rel_network_get_epoch_items(NN_Instance_reloc.exec_state.inst_reloc);
+}
+
+static const LL_Buffer_InfoTypeDef *reloc_output_buffers_info(void)
+{
+    return ll_aton_reloc_get_output_buffers_info(&NN_Instance_reloc, -1);
+}
+
+static const LL_Buffer_InfoTypeDef *reloc_input_buffers_info(void)
+{
+    return ll_aton_reloc_get_input_buffers_info(&NN_Instance_reloc, -1);
+}
+
+static const LL_Buffer_InfoTypeDef *reloc_internal_buffers_info(void)
+{
+    return ll_aton_reloc_get_internal_buffers_info(&NN_Instance_reloc);
+}
+
+static NN_Interface_TypeDef reloc_interface = {
+    .ec_network_init = reloc_ec_network_init,
+    .ec_inference_init = reloc_ec_inference_init,
+    .input_setter = reloc_set_input,
+    .input_getter = reloc_get_input,
+    .output_setter = reloc_set_output,
+    .output_getter = reloc_get_output,
+    .epoch_block_items = reloc_epoch_block_items,
+    .output_buffers_info = reloc_output_buffers_info,
+    .input_buffers_info = reloc_input_buffers_info,
+    .internal_buffers_info = reloc_internal_buffers_info,
+};
+#endif
+
+/*
+ * Network registry, indexed by MX_X_CUBE_AI_Network_t. Activation pools of
+ * all entries overlap by design (same AXISRAM reservations), so exactly one
+ * network is initialized at a time; weights are read in place from flash.
+ * With NN_SHARED_LAYOUT the two YOLOX entries share one interface too.
+ */
+static NN_Instance_TypeDef *const networks[MX_X_CUBE_AI_NET_NB] = {
+    [MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON] = &NN_Instance_od_yolo_x_person,
+    [MX_X_CUBE_AI_NET_OBJECT_DETECTION_YOLO_X] = &NN_Instance_object_detection_yolo_x,
+#if defined(LL_ATON_RT_RELOC)
+    [MX_X_CUBE_AI_NET_RELOC] = &NN_Instance_reloc,
+#endif
+};
+static uint32_t active_network = MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON;
+#if NPU_SCHED_ENABLE
+/* Initialized alongside the active network, see MX_X_CUBE_AI_SetCompanion() */
+static uint32_t companion_network = MX_X_CUBE_AI_NET_NB;
+#endif
+/* USER CODE END networks */
 uint8_t *buffer_in;
 uint8_t *buffer_out;
 
@@ -113,14 +224,214 @@ void MX_X_CUBE_AI_Init(void)
     npu_cache_init();
     /* USER CODE BEGIN 5 */
     npu_cache_enable();
+    LL_ATON_RT_RuntimeInit();
+    LL_ATON_RT_Init_Network(networks[active_network]);
     /* USER CODE END 5 */
 }
 
 void MX_X_CUBE_AI_Process(void)
 {
     /* USER CODE BEGIN 6 */
+    (void)MX_X_CUBE_AI_Run();
     /* USER CODE END 6 */
 }
+
+#if HEALTH_MONITOR
+/* An epoch block that never signalled: reset the NPU and bring the runtime
+ * and the active network back up in place. Weights, activations and the
+ * cache setup are kept; the keys live in the bus interfaces and are lost */
+void MX_X_CUBE_AI_RecoverNPU(void)
+{
+    uint64_t start_us = Time_GetUs();
+
+#if NPU_SCHED_ENABLE
+    if (companion_network != MX_X_CUBE_AI_NET_NB) {
+      LL_ATON_RT_DeInit_Network(networks[companion_network]);
+    }
+#endif
+    LL_ATON_RT_DeInit_Network(networks[active_network]);
+    LL_ATON_RT_RuntimeDeInit();
+    __HAL_RCC_NPU_FORCE_RESET();
+    __HAL_RCC_NPU_RELEASE_RESET();
+    npu_cache_invalidate();
+#if NPU_WEIGHT_CIPHER
+    NPUCipher_LoadKeys();
+#endif
+    LL_ATON_RT_RuntimeInit();
+    LL_ATON_RT_Init_Network(networks[active_network]);
+#if NPU_SCHED_ENABLE
+    if (companion_network != MX_X_CUBE_AI_NET_NB) {
+      LL_ATON_RT_Init_Network(networks[companion_network]);
+    }
+#endif
+    Health_RecordRecovery(HEALTH_STAGE_NPU, (uint32_t)(Time_GetUs() - start_us));
+}
+#endif
+
+#if NPU_IDLE_GATE_ENABLE
+/* Only activations in these banks, no initializers (use4initializers=NO):
+ * nothing to keep between inferences. AXISRAM3 also holds the prefetch
+ * ring, refilled per inference; AXISRAM6 the output slots with NN_OUTPUT_INT8 */
+static RAMCFG_TypeDef *const idle_banks[] = {
+    RAMCFG_SRAM3_AXI,
+    RAMCFG_SRAM4_AXI,
+    RAMCFG_SRAM5_AXI,
+#if !NN_OUTPUT_INT8
+    RAMCFG_SRAM6_AXI,
+#endif
+};
+
+void MX_X_CUBE_AI_Suspend(void)
+{
+    /* Registers (clock gates, stream engines, cipher keys) are retained */
+    __HAL_RCC_NPU_CLK_DISABLE();
+    for (uint32_t i = 0; i < sizeof(idle_banks) / sizeof(idle_banks[0]); i++) {
+      idle_banks[i]->CR |= RAMCFG_CR_SRAMSD;
+    }
+    __HAL_RCC_AXISRAM3_MEM_CLK_DISABLE();
+    __HAL_RCC_AXISRAM4_MEM_CLK_DISABLE();
+    __HAL_RCC_AXISRAM5_MEM_CLK_DISABLE();
+#if !NN_OUTPUT_INT8
+    __HAL_RCC_AXISRAM6_MEM_CLK_DISABLE();
+#endif
+}
+
+void MX_X_CUBE_AI_Resume(void)
+{
+    __HAL_RCC_AXISRAM3_MEM_CLK_ENABLE();
+    __HAL_RCC_AXISRAM4_MEM_CLK_ENABLE();
+    __HAL_RCC_AXISRAM5_MEM_CLK_ENABLE();
+#if !NN_OUTPUT_INT8
+    __HAL_RCC_AXISRAM6_MEM_CLK_ENABLE();
+#endif
+    for (uint32_t i = 0; i < sizeof(idle_banks) / sizeof(idle_banks[0]); i++) {
+      idle_banks[i]->CR &= ~RAMCFG_CR_SRAMSD;
+      /* Read back: the bank is powered before the NPU can reach it */
+      (void)idle_banks[i]->CR;
+    }
+    __DSB();
+    __HAL_RCC_NPU_CLK_ENABLE();
+}
+#endif
+
+int MX_X_CUBE_AI_Run(void)
+{
+    LL_ATON_RT_RetValues_t ll_aton_rt_ret;
+
+#if HEALTH_MONITOR
+    Health_Arm(HEALTH_STAGE_NPU);
+#endif
+    /* Run one inference on the current input buffer */
+    do {
+      ll_aton_rt_ret = LL_ATON_RT_RunEpochBlock(networks[active_network]);
+      if (ll_aton_rt_ret == LL_ATON_RT_WFE) {
+        LL_ATON_OSAL_WFE();
+#if HEALTH_MONITOR
+        if (NPU_OSAL_TakeTimeout()) {
+          MX_X_CUBE_AI_RecoverNPU();
+          Health_Disarm(HEALTH_STAGE_NPU);
+          return 0;
+        }
+#endif
+      }
+    } while (ll_aton_rt_ret != LL_ATON_RT_DONE);
+
+    LL_ATON_RT_Reset_Network(networks[active_network]);
+#if HEALTH_MONITOR
+    Health_Disarm(HEALTH_STAGE_NPU);
+#endif
+    return 1;
+}
+
+NN_Instance_TypeDef *MX_X_CUBE_AI_GetInstance(void)
+{
+    return networks[active_network];
+}
+
+NN_Instance_TypeDef *MX_X_CUBE_AI_GetNetwork(uint32_t id)
+{
+    /* Uninstalled entries have no interface */
+    return (id < MX_X_CUBE_AI_NET_NB && networks[id]->network != NULL) ? networks[id] : NULL;
+}
+
+uint32_t MX_X_CUBE_AI_GetActiveNetwork(void)
+{
+    return active_network;
+}
+
+void MX_X_CUBE_AI_SelectNetwork(uint32_t id)
+{
+    if (MX_X_CUBE_AI_GetNetwork(id) == NULL || id == active_network) {
+      return;
+    }
+#if NPU_SCHED_ENABLE
+    /* Already initialized, and owned by the second stage */
+    if (id == companion_network) {
+      return;
+    }
+#endif
+
+    /* Only epoch-block pointers are (re)set: no weights or activations move */
+    LL_ATON_RT_DeInit_Network(networks[active_network]);
+    active_network = id;
+    LL_ATON_RT_Init_Network(networks[active_network]);
+}
+
+#if NPU_SCHED_ENABLE
+void MX_X_CUBE_AI_SetCompanion(uint32_t id)
+{
+    if (MX_X_CUBE_AI_GetNetwork(id) == NULL || id == active_network || id == companion_network) {
+      return;
+    }
+
+    if (companion_network != MX_X_CUBE_AI_NET_NB) {
+      LL_ATON_RT_DeInit_Network(networks[companion_network]);
+    }
+    companion_network = id;
+    LL_ATON_RT_Init_Network(networks[companion_network]);
+}
+#endif
+
+#if defined(LL_ATON_RT_RELOC)
+int MX_X_CUBE_AI_InstallReloc(uintptr_t file_ptr)
+{
+    const ll_aton_reloc_config config = {
+        .exec_ram_addr = (uintptr_t)reloc_exec_ram,
+        .exec_ram_size = sizeof(reloc_exec_ram),
+        .ext_param_addr = 0, /* Weights are read in place from the binary */
+        .mode = AI_RELOC_RT_LOAD_MODE_XIP,
+    };
+    TraceEpochBlock_FuncPtr_t epoch_callback = NN_Instance_reloc.exec_state.epoch_callback_function;
+    ll_aton_reloc_info info;
+    int ret;
+
+    if (active_network == MX_X_CUBE_AI_NET_RELOC) {
+      return AI_RELOC_RT_ERR_NOT_SUPPORTED;
+    }
+
+    ret = ll_aton_reloc_get_info(file_ptr, &info);
+    if (ret != AI_RELOC_RT_ERR_NONE) {
+      return ret;
+    }
+    /* No external pool: activations live in the AXISRAM reservations */
+    if (info.rt_ram_xip > sizeof(reloc_exec_ram) || info.ext_ram_sz != 0) {
+      return AI_RELOC_RT_ERR_MEMORY;
+    }
+
+    ret = ll_aton_reloc_install(file_ptr, &config, &NN_Instance_reloc);
+    if (ret != AI_RELOC_RT_ERR_NONE) {
+      memset(&NN_Instance_reloc, 0, sizeof(NN_Instance_reloc));
+      return ret;
+    }
+
+    reloc_interface.network_name = NN_Instance_reloc.network->network_name;
+    NN_Instance_reloc.network = &reloc_interface;
+    /* Installing resets the execution state */
+    NN_Instance_reloc.exec_state.epoch_callback_function = epoch_callback;
+
+    return AI_RELOC_RT_ERR_NONE;
+}
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,56 @@ extern "C" {
 void MX_X_CUBE_AI_Init(void);
 void MX_X_CUBE_AI_Process(void);
 /* USER CODE BEGIN includes */
+#include "app_config.h"
+#if defined(LL_ATON_RT_RELOC)
+#include "ll_aton_reloc_network.h"
+#endif
+
+/* Registered networks (activation pools overlap: one is active at a time) */
+typedef enum {
+  MX_X_CUBE_AI_NET_OD_YOLO_X_PERSON = 0,
+  MX_X_CUBE_AI_NET_OBJECT_DETECTION_YOLO_X,
+#if defined(LL_ATON_RT_RELOC)
+  MX_X_CUBE_AI_NET_RELOC, /* Installed from external flash, see MX_X_CUBE_AI_InstallReloc() */
+#endif
+  MX_X_CUBE_AI_NET_NB
+} MX_X_CUBE_AI_Network_t;
+
+/* One inference on the active network, as MX_X_CUBE_AI_Process(); returns 0
+ * when an epoch block timed out (HEALTH_MONITOR): the NPU was reset and the
+ * outputs are not valid, the next run starts afresh */
+int MX_X_CUBE_AI_Run(void);
+/* Active network instance */
+NN_Instance_TypeDef *MX_X_CUBE_AI_GetInstance(void);
+/* Registered network instance, NULL if id is out of range */
+NN_Instance_TypeDef *MX_X_CUBE_AI_GetNetwork(uint32_t id);
+uint32_t MX_X_CUBE_AI_GetActiveNetwork(void);
+/* Make id the active network; call only between inferences */
+void MX_X_CUBE_AI_SelectNetwork(uint32_t id);
+#if NPU_SCHED_ENABLE
+/* Keep id initialized alongside the active network, for the interleaved
+ * second stage (app_npu_sched.h); it cannot be selected meanwhile. Its
+ * buffers must not overlap the active network's */
+void MX_X_CUBE_AI_SetCompanion(uint32_t id);
+#endif
+#if HEALTH_MONITOR
+/* Reset the NPU after an epoch block timed out and bring the runtime and the
+ * initialized networks back up, as a failed MX_X_CUBE_AI_Run() does */
+void MX_X_CUBE_AI_RecoverNPU(void);
+#endif
+#if NPU_IDLE_GATE_ENABLE
+/* Stop the NPU clock and shut the activation-only AXISRAM banks down, NPU
+ * idle; their contents are lost. MX_X_CUBE_AI_Resume() before the next
+ * inference, then the networks run as initialized */
+void MX_X_CUBE_AI_Suspend(void);
+void MX_X_CUBE_AI_Resume(void);
+#endif
+#if defined(LL_ATON_RT_RELOC)
+/* Install the relocatable binary at file_ptr as MX_X_CUBE_AI_NET_RELOC (not
+ * while it is the active network); returns AI_RELOC_RT_ERR_NONE or an
+ * AI_RELOC_RT_ERR_* code, leaving the entry unregistered on failure */
+int MX_X_CUBE_AI_InstallReloc(uintptr_t file_ptr);
+#endif
 /* USER CODE END includes */
 #ifdef __cplusplus
 }
@@ -99790,7 +99790,7 @@ const EpochBlock_ItemTypeDef *LL_ATON_EpochBlockItems_object_detection_yolo_x(vo
       .start_epoch_block = NULL,
       .end_epoch_block = LL_ATON_End_EpochBlock_195,
       .wait_mask = 0x00000000,
-      .flags = EpochBlock_Flags_epoch_start | EpochBlock_Flags_epoch_end | EpochBlock_Flags_pure_sw,
+      .flags = EpochBlock_Flags_epoch_start | EpochBlock_Flags_epoch_end | EpochBlock_Flags_pure_sw | EpochBlock_Flags_sw_overlap,
 #ifdef LL_ATON_EB_DBG_INFO
       .epoch_num = 195,
       .last_epoch_num = 195,
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file    fsbl_boot.h
+ * @author  Long Liangmao
+ * @brief   Load-and-run boot of the application for STM32N6570-DK FSBL
+ *          HPDMA copy of the signed image from the memory-mapped octoFlash,
+ *          sized from its v2.3 header, checked against the slot manifest
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FSBL_BOOT_H
+#define FSBL_BOOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "boot/stm32_boot_lrun.h"
+
+/**
+ * @brief  Map the external memories, copy the application and jump to it
+ * @retval Error status. The function does not return on success
+ * @note   Replaces BOOT_Application(): same steps, with the image copied by
+ *         HPDMA1 in large bursts while a second channel feeds what already
+ *         landed to the HASH unit. The SHA-256 is checked against the slot
+ *         manifest, itself checked by its HMAC tag, before the jump; a slot
+ *         without a manifest is summed by the CPU against the header
+ *         checksum instead. Without a memory-mapped source it falls back to
+ *         the ExtMem copy
+ */
+BOOTStatus_TypeDef FSBL_BootApplication(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FSBL_BOOT_H */
@@ -47,7 +47,7 @@ extern "C" {
 /*#define HAL_FDCAN_MODULE_ENABLED   */
 /*#define HAL_GFXMMU_MODULE_ENABLED   */
 /*#define HAL_GFXTIM_MODULE_ENABLED   */
-/*#define HAL_HASH_MODULE_ENABLED   */
+#define HAL_HASH_MODULE_ENABLED
 /*#define HAL_HCD_MODULE_ENABLED   */
 /*#define HAL_I2C_MODULE_ENABLED   */
 /*#define HAL_I2S_MODULE_ENABLED   */
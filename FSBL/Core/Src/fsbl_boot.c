@@ -0,0 +1,433 @@
+/**
+ ******************************************************************************
+ * @file    fsbl_boot.c
+ * @author  Long Liangmao
+ * @brief   Load-and-run boot of the application for STM32N6570-DK FSBL
+ *          A/B slot pick from the slot table, HPDMA copy of the signed image
+ *          from the memory-mapped octoFlash, sized from its v2.3 header and
+ *          checked against the slot manifest by the HASH unit as it lands
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "fsbl_boot.h"
+#include "boot_slots.h"
+#include "boot_timeline.h"
+#include "extmem_manager.h"
+#include "stm32n6xx_hal.h"
+#include <stddef.h>
+#include <string.h>
+
+#if !defined(EXTMEM_LRUN_DESTINATION_INTERNAL)
+#error "FSBL_BootApplication() copies into internal RAM (EXTMEM_LRUN_DESTINATION_INTERNAL)"
+#endif
+
+/* STM32 signing tool header v2.3, EXTMEM_HEADER_OFFSET bytes before the
+ * vector table */
+#define FSBL_HEADER_MAGIC 0x324D5453U /* "STM2" */
+#define FSBL_HEADER_CHECKSUM_OFFSET 100U /* Byte sum of the payload */
+
+/* Application ROM + header: AXISRAM1 up to the application RAM, one slot
+ * but its manifest */
+#define FSBL_IMAGE_MAX_SIZE (BOOT_SLOTS_APP_SIZE - BOOT_SLOTS_MANIFEST_SIZE)
+
+/* Manifest key (HMAC-SHA256), shared with flash.ps1 $ManifestKey. The FSBL
+ * is authenticated by the boot ROM, so the key cannot be swapped without
+ * signing it again; a product keeps it out of the image (BSEC OTP) */
+#ifndef FSBL_MANIFEST_KEY
+#define FSBL_MANIFEST_KEY "stm32n6-dk-development-manifest"
+#endif
+/* 1: a slot without a manifest is not booted (0: its header checksum is
+ * checked instead, as flashed before manifests) */
+#ifndef FSBL_MANIFEST_REQUIRED
+#define FSBL_MANIFEST_REQUIRED 0
+#endif
+
+/* Copy chunk: the CPU sums chunk n while the DMA moves chunk n + 1. A
+ * block is at most 64 KB; 32 KB keeps it cache-line and burst aligned */
+#define FSBL_CHUNK_SIZE 0x8000U
+#define FSBL_CHUNK_TIMEOUT_MS 100U
+
+#define FSBL_DMA_CHANNEL HPDMA1_Channel0
+#define FSBL_HASH_DMA_CHANNEL HPDMA1_Channel1
+
+/* ExtMem boot layer steps, not exported by its header */
+BOOTStatus_TypeDef MapMemory(void);
+BOOTStatus_TypeDef CopyApplication(void);
+BOOTStatus_TypeDef JumpToApplication(void);
+
+/* The generated CopyApplication() fallback boots slot A */
+_Static_assert(EXTMEM_LRUN_SOURCE_ADDRESS == BOOT_SLOTS_APP_OFFSET(BOOT_SLOT_A),
+               "EXTMEM_LRUN_SOURCE_ADDRESS is not application slot A");
+
+/* Slots of this boot, and the pair to fall back to */
+typedef struct {
+  uint32_t app;
+  uint32_t model;
+  uint32_t prev_app;
+  uint32_t prev_model;
+  uint32_t flags; /* BOOT_SLOTS_ROLLED_BACK */
+} fsbl_slots_t;
+
+static DMA_HandleTypeDef hdma_boot;
+static DMA_HandleTypeDef hdma_hash;
+
+/**
+ * @brief  Set up the copy channel: memory to memory, 64-bit beats, long bursts
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef FSBL_DmaInit(void) {
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  hdma_boot.Instance = FSBL_DMA_CHANNEL;
+  hdma_boot.Init.Request = DMA_REQUEST_SW;
+  hdma_boot.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma_boot.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  hdma_boot.Init.SrcInc = DMA_SINC_INCREMENTED;
+  hdma_boot.Init.DestInc = DMA_DINC_INCREMENTED;
+  hdma_boot.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_DOUBLEWORD;
+  hdma_boot.Init.DestDataWidth = DMA_DEST_DATAWIDTH_DOUBLEWORD;
+  hdma_boot.Init.Priority = DMA_HIGH_PRIORITY; /* Nothing else runs yet */
+  hdma_boot.Init.SrcBurstLength = 16;          /* 16 x 64-bit: 128-byte xSPI reads */
+  hdma_boot.Init.DestBurstLength = 16;
+  hdma_boot.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  hdma_boot.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_boot.Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(&hdma_boot) != HAL_OK) {
+    return HAL_ERROR;
+  }
+
+  /* The FSBL runs secure: both the octoFlash and AXISRAM1 aliases are */
+  return HAL_DMA_ConfigChannelAttributes(&hdma_boot, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                                         DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC);
+}
+
+/**
+ * @brief  Check a manifest: magic and HMAC-SHA256 tag, on the HASH unit
+ * @retval 1 when it names the image of its slot
+ */
+static int FSBL_ManifestValid(const boot_app_manifest_t *manifest) {
+  static const uint8_t key[] = FSBL_MANIFEST_KEY;
+  HASH_HandleTypeDef hhash = {0};
+  uint8_t tag[BOOT_SLOTS_DIGEST_SIZE];
+  uint8_t diff = 0;
+  HAL_StatusTypeDef status;
+
+  __HAL_RCC_HASH_CLK_ENABLE();
+  hhash.Instance = HASH;
+  hhash.Init.DataType = HASH_BYTE_SWAP;
+  hhash.Init.Algorithm = HASH_ALGOSELECTION_SHA256;
+  hhash.Init.pKey = (uint8_t *)key;
+  hhash.Init.KeySize = sizeof(key) - 1U;
+  status = HAL_HASH_Init(&hhash);
+  if (status == HAL_OK) {
+    status = HAL_HASH_HMAC_Start(&hhash, (const uint8_t *)manifest, offsetof(boot_app_manifest_t, tag), tag,
+                                 FSBL_CHUNK_TIMEOUT_MS);
+  }
+  (void)HAL_HASH_DeInit(&hhash);
+  if (status != HAL_OK) {
+    return 0;
+  }
+
+  /* Whole compare: the time does not tell how much of the tag matched */
+  for (uint32_t i = 0; i < BOOT_SLOTS_DIGEST_SIZE; i++) {
+    diff |= tag[i] ^ manifest->tag[i];
+  }
+  return diff == 0U;
+}
+
+/**
+ * @brief  Set up SHA-256 of the image fed by DMA, several buffers per
+ *         message, and its channel: RAM to the HASH input FIFO on its request
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef FSBL_HashInit(void) {
+  __HAL_RCC_HASH_CLK_ENABLE();
+  HASH->CR = HASH_ALGOSELECTION_SHA256 | HASH_BYTE_SWAP | HASH_CR_DMAE | HASH_CR_MDMAT;
+  HASH->STR = 0;
+  HASH->CR |= HASH_CR_INIT;
+
+  hdma_hash.Instance = FSBL_HASH_DMA_CHANNEL;
+  hdma_hash.Init.Request = HPDMA1_REQUEST_HASH_IN;
+  hdma_hash.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma_hash.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_hash.Init.SrcInc = DMA_SINC_INCREMENTED;
+  hdma_hash.Init.DestInc = DMA_DINC_FIXED;
+  hdma_hash.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_WORD;
+  hdma_hash.Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+  hdma_hash.Init.Priority = DMA_HIGH_PRIORITY;
+  hdma_hash.Init.SrcBurstLength = 1;
+  hdma_hash.Init.DestBurstLength = 1;
+  hdma_hash.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1; /* AHB: the HASH */
+  hdma_hash.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_hash.Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(&hdma_hash) != HAL_OK) {
+    return HAL_ERROR;
+  }
+  return HAL_DMA_ConfigChannelAttributes(&hdma_hash, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC | DMA_CHANNEL_SRC_SEC |
+                                                         DMA_CHANNEL_DEST_SEC);
+}
+
+/**
+ * @brief  Feed a copied range to the HASH unit; the last one closes the
+ *         message and starts the final digest as its DMA ends
+ */
+static HAL_StatusTypeDef FSBL_HashFeed(const uint8_t *data, uint32_t len, int last) {
+  if (last) {
+    HASH->CR &= ~HASH_CR_MDMAT;
+    MODIFY_REG(HASH->STR, HASH_STR_NBLW, 8U * (len % 4U));
+  }
+  /* A partial last word is read whole; its extra bytes are not hashed */
+  return HAL_DMA_Start(&hdma_hash, (uint32_t)data, (uint32_t)&HASH->DIN, (len + 3U) & ~3U);
+}
+
+/**
+ * @brief  Wait for the final digest and compare it with the manifest
+ * @retval 1 when equal
+ */
+static int FSBL_HashMatch(const boot_app_manifest_t *manifest) {
+  uint32_t start = HAL_GetTick();
+  uint32_t diff = 0;
+
+  while ((HASH->SR & HASH_SR_DCIS) == 0U) {
+    if (HAL_GetTick() - start > FSBL_CHUNK_TIMEOUT_MS) {
+      return 0;
+    }
+  }
+  for (uint32_t i = 0; i < BOOT_SLOTS_DIGEST_SIZE / 4U; i++) {
+    uint32_t word;
+
+    memcpy(&word, &manifest->digest[4U * i], sizeof(word));
+    diff |= HASH_DIGEST->HR[i] ^ __REV(word); /* Digest words big endian */
+  }
+  return diff == 0U;
+}
+
+/**
+ * @brief  Leave the HASH unit and its channel as reset for the application
+ */
+static void FSBL_HashDeInit(void) {
+  (void)HAL_DMA_DeInit(&hdma_hash);
+  __HAL_RCC_HASH_FORCE_RESET();
+  __HAL_RCC_HASH_RELEASE_RESET();
+  __HAL_RCC_HASH_CLK_DISABLE();
+}
+
+/**
+ * @brief  Byte sum of a copied range, read back from the destination
+ */
+static uint32_t FSBL_Sum(const uint8_t *data, uint32_t len) {
+  const uint32_t *words = (const uint32_t *)data;
+  uint32_t sum = 0;
+
+  /* The DMA wrote behind the D-cache */
+  SCB_InvalidateDCache_by_Addr((void *)data, (int32_t)len);
+
+  for (uint32_t i = 0; i < len / 4U; i++) {
+    uint32_t w = words[i];
+
+    sum += (w & 0xFFU) + ((w >> 8) & 0xFFU) + ((w >> 16) & 0xFFU) + (w >> 24);
+  }
+  for (uint32_t i = len & ~3U; i < len; i++) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief  Copy the signed image and check it: the SHA-256 of the copy
+ *         against its manifest, else the payload checksum of its header
+ * @param  source: Image header in the memory-mapped octoFlash
+ * @param  destination: Load address of the header
+ * @param  manifest: Checked manifest of the slot, NULL without one
+ * @retval Error status
+ * @note   Chunk n is hashed (by DMA, header included) or summed (by the
+ *         CPU, payload only) while chunk n + 1 is copied: the digest is
+ *         ready one chunk after the copy
+ */
+static BOOTStatus_TypeDef FSBL_CopyImage(const uint8_t *source, uint8_t *destination,
+                                         const boot_app_manifest_t *manifest) {
+  uint32_t image, size, checksum, sum = 0;
+  uint32_t done = 0, summed = manifest != NULL ? 0U : EXTMEM_HEADER_OFFSET;
+  BOOTStatus_TypeDef status = BOOT_OK;
+
+  if (*(const uint32_t *)source != FSBL_HEADER_MAGIC) {
+    return BOOT_ERROR_COPY;
+  }
+  image = BOOT_GetApplicationSize((uint32_t)source);
+  checksum = *(const uint32_t *)(source + FSBL_HEADER_CHECKSUM_OFFSET);
+  if (image <= EXTMEM_HEADER_OFFSET || image > FSBL_IMAGE_MAX_SIZE ||
+      (manifest != NULL && manifest->image_size != image)) {
+    return BOOT_ERROR_COPY;
+  }
+
+  if (FSBL_DmaInit() != HAL_OK || (manifest != NULL && FSBL_HashInit() != HAL_OK)) {
+    status = BOOT_ERROR_COPY;
+  }
+
+  /* Whole 64-bit beats: the tail rounds up into the unused ROM space */
+  size = (image + 7U) & ~7U;
+
+  while (status == BOOT_OK && done < size) {
+    uint32_t len = size - done < FSBL_CHUNK_SIZE ? size - done : FSBL_CHUNK_SIZE;
+    int hashing = 0;
+
+    if (HAL_DMA_Start(&hdma_boot, (uint32_t)(source + done), (uint32_t)(destination + done), len) != HAL_OK) {
+      status = BOOT_ERROR_COPY;
+      break;
+    }
+
+    /* The previous chunk landed: hash or sum it while this one is in flight */
+    if (done > summed) {
+      if (manifest != NULL) {
+        hashing = FSBL_HashFeed(destination + summed, done - summed, 0) == HAL_OK;
+        status = hashing ? BOOT_OK : BOOT_ERROR_COPY;
+      } else {
+        sum += FSBL_Sum(destination + summed, done - summed);
+      }
+      summed = done;
+    }
+
+    if (HAL_DMA_PollForTransfer(&hdma_boot, HAL_DMA_FULL_TRANSFER, FSBL_CHUNK_TIMEOUT_MS) != HAL_OK ||
+        (hashing && HAL_DMA_PollForTransfer(&hdma_hash, HAL_DMA_FULL_TRANSFER, FSBL_CHUNK_TIMEOUT_MS) != HAL_OK)) {
+      status = BOOT_ERROR_COPY;
+    }
+    done += len;
+  }
+
+  /* Last chunk; the rounding bytes lie past the header's image length */
+  if (status == BOOT_OK) {
+    if (manifest != NULL) {
+      if (FSBL_HashFeed(destination + summed, image - summed, 1) != HAL_OK ||
+          HAL_DMA_PollForTransfer(&hdma_hash, HAL_DMA_FULL_TRANSFER, FSBL_CHUNK_TIMEOUT_MS) != HAL_OK ||
+          !FSBL_HashMatch(manifest)) {
+        status = BOOT_ERROR_COPY;
+      }
+      /* The DMA wrote behind the D-cache */
+      SCB_InvalidateDCache_by_Addr((void *)destination, (int32_t)size);
+    } else if (sum + FSBL_Sum(destination + summed, image - summed) != checksum) {
+      status = BOOT_ERROR_COPY;
+    }
+  }
+
+  /* Leave HPDMA1 as reset for the application */
+  if (manifest != NULL) {
+    FSBL_HashDeInit();
+  }
+  (void)HAL_DMA_DeInit(&hdma_boot);
+  __HAL_RCC_HPDMA1_FORCE_RESET();
+  __HAL_RCC_HPDMA1_RELEASE_RESET();
+  __HAL_RCC_HPDMA1_CLK_DISABLE();
+
+  return status;
+}
+
+/**
+ * @brief  Copy and check the image of an application slot
+ * @param  map_address: Memory-mapped octoFlash base
+ * @param  slot: BOOT_SLOT_A / _B
+ * @retval Error status; a manifest that fails its tag fails the slot
+ */
+static BOOTStatus_TypeDef FSBL_BootSlot(uint32_t map_address, uint32_t slot) {
+  const boot_app_manifest_t *manifest =
+      (const boot_app_manifest_t *)(map_address + BOOT_SLOTS_MANIFEST_OFFSET(slot));
+
+  if (manifest->magic != BOOT_SLOTS_MANIFEST_MAGIC) {
+    if (FSBL_MANIFEST_REQUIRED) {
+      return BOOT_ERROR_COPY;
+    }
+    manifest = NULL;
+  } else if (!FSBL_ManifestValid(manifest)) {
+    return BOOT_ERROR_COPY;
+  }
+  return FSBL_CopyImage((const uint8_t *)(map_address + BOOT_SLOTS_APP_OFFSET(slot)),
+                        (uint8_t *)EXTMEM_LRUN_DESTINATION_ADDRESS, manifest);
+}
+
+/**
+ * @brief  Pick the slots of this boot from the slot table
+ * @note   Constant time: one table read and the backup registers, no scan
+ *         of the slots. Boots of an unconfirmed generation are counted; past
+ *         BOOT_SLOTS_MAX_TRIALS the previous pair is taken until the table
+ *         changes. Without a valid table, slot A (the layout before slots)
+ */
+static void FSBL_SelectSlots(const boot_slots_table_t *table, fsbl_slots_t *sel) {
+  volatile uint32_t *trial = BootSlots_Bkp(BOOT_SLOTS_BKP_TRIAL);
+  uint32_t generation, boots;
+
+  sel->flags = 0;
+  if (!BootSlots_TableValid(table)) {
+    sel->app = sel->prev_app = BOOT_SLOT_A;
+    sel->model = sel->prev_model = BOOT_SLOT_A;
+    return;
+  }
+  sel->app = table->app_slot;
+  sel->model = table->model_slot;
+  sel->prev_app = table->prev_app_slot;
+  sel->prev_model = table->prev_model_slot;
+
+  if (table->confirmed || *BootSlots_Bkp(BOOT_SLOTS_BKP_CONFIRM) == table->generation) {
+    return;
+  }
+
+  generation = table->generation & 0x00FFFFFFU;
+  boots = (*trial >> 8) == generation ? (*trial & 0xFFU) : 0U;
+  if (boots >= BOOT_SLOTS_MAX_TRIALS) {
+    sel->app = sel->prev_app;
+    sel->model = sel->prev_model;
+    sel->flags = BOOT_SLOTS_ROLLED_BACK;
+    return;
+  }
+  *trial = (generation << 8) | (boots + 1U);
+}
+
+/**
+ * @brief  Map the external memories, copy the application and jump to it
+ */
+BOOTStatus_TypeDef FSBL_BootApplication(void) {
+  BOOTStatus_TypeDef status;
+  uint32_t map_address;
+  fsbl_slots_t sel = {BOOT_SLOT_A, BOOT_SLOT_A, BOOT_SLOT_A, BOOT_SLOT_A, 0};
+
+  status = MapMemory();
+  if (status != BOOT_OK) {
+    return status;
+  }
+
+  BootSlots_BkpEnable();
+
+  if (EXTMEM_GetMapAddress(EXTMEM_LRUN_SOURCE, &map_address) == EXTMEM_OK) {
+    FSBL_SelectSlots((const boot_slots_table_t *)(map_address + BOOT_SLOTS_TABLE_OFFSET), &sel);
+    status = FSBL_BootSlot(map_address, sel.app);
+    if (status != BOOT_OK && sel.prev_app != sel.app) {
+      /* Damaged or partly written slot: the previous pair at once */
+      sel.app = sel.prev_app;
+      sel.model = sel.prev_model;
+      sel.flags = BOOT_SLOTS_ROLLED_BACK;
+      status = FSBL_BootSlot(map_address, sel.app);
+    }
+  } else {
+    status = CopyApplication();
+  }
+  if (status != BOOT_OK) {
+    return status;
+  }
+
+  /* The application binds its model slot to this */
+  *BootSlots_Bkp(BOOT_SLOTS_BKP_SELECTED) = BOOT_SLOTS_SELECTED(sel.app, sel.model, sel.flags);
+
+  /* Hand the profile over; JumpToApplication() cleans the D-cache */
+  BootTimeline_Mark(BOOT_PHASE_FSBL_COPY);
+  BootTimeline_Get()->state = BOOT_TIMELINE_HANDOFF;
+
+  return JumpToApplication();
+}
@@ -25,6 +25,8 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "boot_timeline.h"
+#include "fsbl_boot.h"
 #include "stm32n6570_discovery.h"
 /* USER CODE END Includes */
 
@@ -70,6 +72,9 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+  /* Time zero of the boot profile, at the clock left by the boot ROM */
+  SystemCoreClockUpdate();
+  BootTimeline_Start(BOOT_TIMELINE_FSBL, BOOT_PHASE_FSBL_ENTRY);
   /* USER CODE END 1 */
 
   /* MPU Configuration--------------------------------------------------------*/
@@ -99,6 +104,7 @@ int main(void)
   if(OTP_Config() != 0){
     Error_Handler();
   }
+  BootTimeline_Mark(BOOT_PHASE_FSBL_CLOCKS);
 
   /* USER CODE END SysInit */
 
@@ -109,6 +115,14 @@ int main(void)
   MX_EXTMEM_MANAGER_Init();
   /* USER CODE BEGIN 2 */
   LED_Config();
+  BootTimeline_Mark(BOOT_PHASE_FSBL_XSPI);
+
+  /* HPDMA copy of the signed application; the generated BOOT_Application()
+   * below is never reached: FSBL_BootApplication() only returns on error */
+  if (BOOT_OK != FSBL_BootApplication())
+  {
+    Error_Handler();
+  }
 
   // TODO: ThreadX should not be generated as part of this FSBL project.
   // This appears to be an STM32CubeMX/STM32Cube_FW_N6 v1.3.0 generation bug.
@@ -54,6 +54,7 @@ extern "C"
 #define POSTPROCESS_OD_ST_YOLOX_UF      (105)  /* ST YoloX postprocessing; Input model: uint8; output: float32       */
 #define POSTPROCESS_OD_ST_YOLOX_UI      (106)  /* ST YoloX postprocessing; Input model: uint8; output: int8          */
 #define POSTPROCESS_OD_ST_SSD_UF        (107)  /* ST SSD postprocessing; Input model: uint8; output: float32         */
+#define POSTPROCESS_OD_ST_YOLOX_UH      (108)  /* ST YoloX postprocessing; Input model: uint8; output: int8 split heads */
 #define POSTPROCESS_OD_FD_BLAZEFACE_UF  (110)  /* blazeface postprocessing; Input model: uint8; output: float32      */
 #define POSTPROCESS_OD_FD_BLAZEFACE_UU  (111)  /* blazeface postprocessing; Input model: uint8; output: uint8        */
 #define POSTPROCESS_OD_FD_BLAZEFACE_UI  (112)  /* blazeface postprocessing; Input model: uint8; output: int8         */
@@ -67,7 +68,122 @@ extern "C"
 #define POSTPROCESS_SSEG_DEEPLAB_V3_UI  (401)  /* Deeplabv3 Seg postprocessing; Input model: uint8; output: int8     */
 #define POSTPROCESS_CUSTOM              (1000) /* Custom post processing which needs to be implemented by user       */
 
+/* Post processor operations ------------------------------------------------ */
+/* Runtime-selectable post processing: every operation works on a state
+ * allocated by the caller, so several post processors, and several instances
+ * of one, coexist in an image. The output buffer of each instance is a scratch
+ * arena given by the caller with its state. */
+typedef struct
+{
+  const char *name;
+  int32_t type;     /* POSTPROCESS_* */
+  int nb_input;     /* Network outputs consumed by run */
+  int32_t (*init)(void *state, NN_Instance_TypeDef *NN_Instance);
+  int32_t (*run)(void *state, void *pInput[], int nb_input, void *pOutput);
+  int32_t (*reset)(void *state);
+} app_postprocess_ops_t;
+
+/* Post processor instance */
+typedef struct
+{
+  const app_postprocess_ops_t *ops;
+  void *state;      /* State type of ops */
+} app_postprocess_t;
+
+/* ST YoloX state (POSTPROCESS_OD_ST_YOLOX_UF / _UI / _UH). The scratch arena holds
+ * the candidates kept ahead of NMS: the AI_OD_ST_YOLOX_PP_MAX_CANDIDATES
+ * strongest ones, or every grid cell when it is 0 */
+#define APP_POSTPROCESS_OD_ST_YOLOX_GRID_NB                                                              \
+  (((AI_OD_ST_YOLOX_PP_L_GRID_WIDTH * AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT +                              \
+     AI_OD_ST_YOLOX_PP_M_GRID_WIDTH * AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT +                              \
+     AI_OD_ST_YOLOX_PP_S_GRID_WIDTH * AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT) * AI_OD_ST_YOLOX_PP_NB_ANCHORS) \
+       > AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT                                                          \
+   ? ((AI_OD_ST_YOLOX_PP_L_GRID_WIDTH * AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT +                            \
+       AI_OD_ST_YOLOX_PP_M_GRID_WIDTH * AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT +                            \
+       AI_OD_ST_YOLOX_PP_S_GRID_WIDTH * AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT) * AI_OD_ST_YOLOX_PP_NB_ANCHORS) \
+   : AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT)
+
+#define APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB                                                           \
+  ((AI_OD_ST_YOLOX_PP_MAX_CANDIDATES > 0) ? AI_OD_ST_YOLOX_PP_MAX_CANDIDATES                           \
+                                          : APP_POSTPROCESS_OD_ST_YOLOX_GRID_NB)
+
+typedef struct
+{
+  od_st_yolox_pp_static_param_t params;
+  od_pp_outBuffer_t *pOutBuff;  /* Scratch arena, APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB entries */
+  uint32_t out_nb;
+  /* Cells left out of the decode per level (AI_OD_ST_YOLOX_PP_LEVEL_), NULL:
+   * none, and the room for their per-anchor copies
+   * (AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB entries each), given by the caller with
+   * pOutBuff. Read at init */
+  const uint8_t *pCellMask[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+  uint16_t *pAnchorMask[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+  /* int8 decode tables, built at init: one per level, two with split heads */
+  od_st_yolox_pp_lut_is8_t lut[AI_OD_ST_YOLOX_PP_HEADS_LUT_NB];
+  /* Split heads: network output of each level's box, objectness and class
+   * tensor (AI_OD_ST_YOLOX_PP_LEVEL_, AI_OD_ST_YOLOX_PP_HEAD_), found at init */
+  uint8_t head_output[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS];
+} app_postprocess_od_st_yolox_state_t;
+
+/* Movenet state (POSTPROCESS_SPE_MOVENET_UF / _UI) */
+#define APP_POSTPROCESS_SPE_MOVENET_SCRATCH_NB (AI_POSE_PP_POSE_KEYPOINTS_NB)
+
+typedef struct
+{
+  spe_movenet_pp_static_param_t params;
+  spe_pp_outBuffer_t *pOutBuff; /* Scratch arena, APP_POSTPROCESS_SPE_MOVENET_SCRATCH_NB entries */
+  uint32_t out_nb;
+} app_postprocess_spe_movenet_state_t;
+
+/* Post processors built with their configuration in app_config.h */
+extern const app_postprocess_ops_t app_postprocess_od_st_yolox_uf_ops;
+extern const app_postprocess_ops_t app_postprocess_od_st_yolox_ui_ops;
+extern const app_postprocess_ops_t app_postprocess_od_st_yolox_uh_ops;
+extern const app_postprocess_ops_t app_postprocess_spe_movenet_uf_ops;
+extern const app_postprocess_ops_t app_postprocess_spe_movenet_ui_ops;
+
+/* Bind an instance to its operations and state, then initialize it */
+static inline int32_t app_postprocess_instance_init(app_postprocess_t *pp, const app_postprocess_ops_t *ops,
+                                                    void *state, NN_Instance_TypeDef *NN_Instance)
+{
+  pp->ops = ops;
+  pp->state = state;
+  return ops->init(state, NN_Instance);
+}
+
+static inline int32_t app_postprocess_instance_run(const app_postprocess_t *pp, void *pInput[], int nb_input,
+                                                   void *pOutput)
+{
+  return pp->ops->run(pp->state, pInput, nb_input, pOutput);
+}
+
+static inline int32_t app_postprocess_instance_reset(const app_postprocess_t *pp)
+{
+  return pp->ops->reset(pp->state);
+}
+
+/* ST YoloX post processor matching the output tensors of a network: int8
+ * split heads when it has one output per head of every level, else the
+ * concatenated levels in their tensor type */
+static inline const app_postprocess_ops_t *app_postprocess_od_st_yolox_select(NN_Instance_TypeDef *NN_Instance)
+{
+  const LL_Buffer_InfoTypeDef *buffers_info = LL_ATON_Output_Buffers_Info(NN_Instance);
+  int nb_output = 0;
+
+  while (buffers_info[nb_output].name != NULL)
+  {
+    nb_output++;
+  }
+  if ((buffers_info[0].type == DataType_INT8) && (nb_output == AI_OD_ST_YOLOX_PP_NB_LEVELS * AI_OD_ST_YOLOX_PP_NB_HEADS))
+  {
+    return &app_postprocess_od_st_yolox_uh_ops;
+  }
+  return (buffers_info[0].type == DataType_INT8) ? &app_postprocess_od_st_yolox_ui_ops
+                                                 : &app_postprocess_od_st_yolox_uf_ops;
+}
+
 /* Exported functions ------------------------------------------------------- */
+/* Single post processor selected by POSTPROCESS_TYPE at build time */
 int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance);
 int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param);
 
@@ -21,17 +21,10 @@
 #include "app_config.h"
 #include <assert.h>
 
-#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UF
-#define MAX(a,b) (((a)>(b))?(a):(b))
-static od_pp_outBuffer_t out_detections[MAX(AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT,
-                                            AI_OD_ST_YOLOX_PP_L_GRID_WIDTH * AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT +
-                                            AI_OD_ST_YOLOX_PP_M_GRID_WIDTH * AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT +
-                                            AI_OD_ST_YOLOX_PP_S_GRID_WIDTH * AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT)];
-
-int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+#if defined(AI_OD_ST_YOLOX_PP_NB_CLASSES)
+static void od_st_yolox_uf_set_params(od_st_yolox_pp_static_param_t *params, NN_Instance_TypeDef *NN_Instance)
 {
-  int32_t error = AI_OD_POSTPROCESS_ERROR_NO;
-  od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
+  (void) NN_Instance;
   params->nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES;
   params->nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS;
   params->grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH;
@@ -44,26 +37,76 @@ int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_I
   params->pAnchors_M = AI_OD_ST_YOLOX_PP_M_ANCHORS;
   params->pAnchors_S = AI_OD_ST_YOLOX_PP_S_ANCHORS;
   params->max_boxes_limit = AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT;
+  params->max_candidates = AI_OD_ST_YOLOX_PP_MAX_CANDIDATES;
   params->conf_threshold = AI_OD_ST_YOLOX_PP_CONF_THRESHOLD;
   params->iou_threshold = AI_OD_ST_YOLOX_PP_IOU_THRESHOLD;
-  error = od_st_yolox_pp_reset(params);
-  return error;
 }
 
-int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+static int32_t od_st_yolox_uf_process(void *pInput[], int nb_input, od_pp_out_t *pObjDetOutput,
+                                       od_pp_outBuffer_t *pOutBuff, od_st_yolox_pp_static_param_t *params)
 {
   assert(nb_input == 3);
-  int32_t error = AI_OD_POSTPROCESS_ERROR_NO;
-  ((od_st_yolox_pp_static_param_t *) pInput_param)->nb_detect = 0;
-  od_pp_out_t *pObjDetOutput = (od_pp_out_t *) pOutput;
-  pObjDetOutput->pOutBuff = out_detections;
+  params->nb_detect = 0;
+  pObjDetOutput->pOutBuff = pOutBuff;
   od_st_yolox_pp_in_t pp_input = {
       .pRaw_detections_S = (float32_t *) pInput[0],
       .pRaw_detections_L = (float32_t *) pInput[1],
       .pRaw_detections_M = (float32_t *) pInput[2],
   };
-  error = od_st_yolox_pp_process(&pp_input, pObjDetOutput,
-                                 (od_st_yolox_pp_static_param_t *) pInput_param);
-  return error;
+  return od_st_yolox_pp_process(&pp_input, pObjDetOutput, params);
+}
+
+static int32_t od_st_yolox_uf_init(void *state, NN_Instance_TypeDef *NN_Instance)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  if ((st->pOutBuff == NULL) || (st->out_nb < APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB))
+  {
+    return AI_OD_POSTPROCESS_ERROR;
+  }
+  od_st_yolox_uf_set_params(&st->params, NN_Instance);
+  st->params.pLut = NULL; /* Float outputs: no int8 tables */
+  for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+  {
+    st->params.pCellMask[level] = st->pCellMask[level];
+    st->params.pAnchorMask[level] = st->pAnchorMask[level];
+  }
+  return od_st_yolox_pp_reset(&st->params);
+}
+
+static int32_t od_st_yolox_uf_run(void *state, void *pInput[], int nb_input, void *pOutput)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  return od_st_yolox_uf_process(pInput, nb_input, (od_pp_out_t *) pOutput, st->pOutBuff, &st->params);
+}
+
+static int32_t od_st_yolox_uf_reset(void *state)
+{
+  return od_st_yolox_pp_reset(&((app_postprocess_od_st_yolox_state_t *) state)->params);
+}
+
+const app_postprocess_ops_t app_postprocess_od_st_yolox_uf_ops = {
+  .name = "od_st_yolox_uf",
+  .type = POSTPROCESS_OD_ST_YOLOX_UF,
+  .nb_input = 3,
+  .init = od_st_yolox_uf_init,
+  .run = od_st_yolox_uf_run,
+  .reset = od_st_yolox_uf_reset,
+};
+#endif
+
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UF
+static od_pp_outBuffer_t out_detections[APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB];
+
+int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+{
+  od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
+  od_st_yolox_uf_set_params(params, NN_Instance);
+  return od_st_yolox_pp_reset(params);
+}
+
+int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+{
+  return od_st_yolox_uf_process(pInput, nb_input, (od_pp_out_t *) pOutput, out_detections,
+                                   (od_st_yolox_pp_static_param_t *) pInput_param);
 }
 #endif
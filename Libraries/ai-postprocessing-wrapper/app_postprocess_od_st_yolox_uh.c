@@ -0,0 +1,212 @@
+ /**
+ ******************************************************************************
+ * @file    app_postprocess_od_st_yolox_uh.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+
+#include "app_postprocess.h"
+#include "app_config.h"
+#include <assert.h>
+
+#if defined(AI_OD_ST_YOLOX_PP_NB_CLASSES)
+#define OD_ST_YOLOX_UH_NB_INPUT (AI_OD_ST_YOLOX_PP_NB_LEVELS * AI_OD_ST_YOLOX_PP_NB_HEADS)
+#define OD_ST_YOLOX_UH_NONE     (0xFF)
+
+/* Level of an output tensor from its grid, -1 when it matches none */
+static int32_t od_st_yolox_uh_level(const od_st_yolox_pp_static_param_t *params, uint32_t h, uint32_t w)
+{
+  if ((h == (uint32_t) params->grid_height_L) && (w == (uint32_t) params->grid_width_L))
+  {
+    return AI_OD_ST_YOLOX_PP_LEVEL_L;
+  }
+  if ((h == (uint32_t) params->grid_height_M) && (w == (uint32_t) params->grid_width_M))
+  {
+    return AI_OD_ST_YOLOX_PP_LEVEL_M;
+  }
+  if ((h == (uint32_t) params->grid_height_S) && (w == (uint32_t) params->grid_width_S))
+  {
+    return AI_OD_ST_YOLOX_PP_LEVEL_S;
+  }
+  return -1;
+}
+
+/* Find the output of every head and take its quantization. Per level, the
+ * box tensor has 4 values per anchor; of the two others, the first in network
+ * order is the objectness, as in the Concat of the exported graph, unless the
+ * class tensor is told apart by its channel count */
+static int32_t od_st_yolox_uh_set_params(od_st_yolox_pp_static_param_t *params,
+                                         uint8_t head_output[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS],
+                                         NN_Instance_TypeDef *NN_Instance)
+{
+  const LL_Buffer_InfoTypeDef *buffers_info = LL_ATON_Output_Buffers_Info(NN_Instance);
+  uint32_t nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS;
+  uint32_t nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES;
+
+  params->nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES;
+  params->nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS;
+  params->grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH;
+  params->grid_height_L = AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT;
+  params->grid_width_M = AI_OD_ST_YOLOX_PP_M_GRID_WIDTH;
+  params->grid_height_M = AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT;
+  params->grid_width_S = AI_OD_ST_YOLOX_PP_S_GRID_WIDTH;
+  params->grid_height_S = AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT;
+  params->pAnchors_L = AI_OD_ST_YOLOX_PP_L_ANCHORS;
+  params->pAnchors_M = AI_OD_ST_YOLOX_PP_M_ANCHORS;
+  params->pAnchors_S = AI_OD_ST_YOLOX_PP_S_ANCHORS;
+  params->max_boxes_limit = AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT;
+  params->max_candidates = AI_OD_ST_YOLOX_PP_MAX_CANDIDATES;
+  params->conf_threshold = AI_OD_ST_YOLOX_PP_CONF_THRESHOLD;
+  params->iou_threshold = AI_OD_ST_YOLOX_PP_IOU_THRESHOLD;
+  params->split_heads = 1;
+
+  for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+  {
+    for (int32_t head = 0; head < AI_OD_ST_YOLOX_PP_NB_HEADS; head++)
+    {
+      head_output[level][head] = OD_ST_YOLOX_UH_NONE;
+    }
+  }
+
+  for (int32_t i = 0; i < OD_ST_YOLOX_UH_NB_INPUT; i++)
+  {
+    const LL_Buffer_InfoTypeDef *info = &buffers_info[i];
+    int32_t level;
+    int32_t head;
+    uint32_t channels;
+
+    /* [1, h, w, c] int8, quantized per tensor */
+    if ((info->name == NULL) || (info->type != DataType_INT8) || (info->mem_ndims != 4) || info->per_channel)
+    {
+      return AI_OD_POSTPROCESS_ERROR;
+    }
+    level = od_st_yolox_uh_level(params, info->mem_shape[1], info->mem_shape[2]);
+    if (level < 0)
+    {
+      return AI_OD_POSTPROCESS_ERROR;
+    }
+    channels = info->mem_shape[3];
+    if (channels == 4U * nb_anchors)
+    {
+      head = AI_OD_ST_YOLOX_PP_HEAD_BOX;
+    }
+    else if ((channels == nb_anchors * nb_classes) &&
+             ((nb_classes != 1U) || (head_output[level][AI_OD_ST_YOLOX_PP_HEAD_OBJ] != OD_ST_YOLOX_UH_NONE)))
+    {
+      head = AI_OD_ST_YOLOX_PP_HEAD_CLS;
+    }
+    else if (channels == nb_anchors)
+    {
+      head = AI_OD_ST_YOLOX_PP_HEAD_OBJ;
+    }
+    else
+    {
+      return AI_OD_POSTPROCESS_ERROR;
+    }
+    if (head_output[level][head] != OD_ST_YOLOX_UH_NONE)
+    {
+      return AI_OD_POSTPROCESS_ERROR;
+    }
+    head_output[level][head] = (uint8_t) i;
+    params->head_scale[level][head] = *(info->scale);
+    params->head_zero_point[level][head] = (int8_t) *(info->offset);
+  }
+
+  /* Nine outputs, no duplicate: every head is found */
+  return AI_OD_POSTPROCESS_ERROR_NO;
+}
+
+static int32_t od_st_yolox_uh_process(void *pInput[], int nb_input, od_pp_out_t *pObjDetOutput,
+                                       od_pp_outBuffer_t *pOutBuff, od_st_yolox_pp_static_param_t *params,
+                                       uint8_t head_output[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS])
+{
+  od_st_yolox_pp_in_heads_t pp_input;
+
+  assert(nb_input == OD_ST_YOLOX_UH_NB_INPUT);
+  params->nb_detect = 0;
+  pObjDetOutput->pOutBuff = pOutBuff;
+  for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+  {
+    pp_input.level[level].pBox = (int8_t *) pInput[head_output[level][AI_OD_ST_YOLOX_PP_HEAD_BOX]];
+    pp_input.level[level].pObj = (int8_t *) pInput[head_output[level][AI_OD_ST_YOLOX_PP_HEAD_OBJ]];
+    pp_input.level[level].pCls = (int8_t *) pInput[head_output[level][AI_OD_ST_YOLOX_PP_HEAD_CLS]];
+  }
+  return od_st_yolox_pp_process_heads_int8(&pp_input, pObjDetOutput, params);
+}
+
+static int32_t od_st_yolox_uh_init(void *state, NN_Instance_TypeDef *NN_Instance)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  if ((st->pOutBuff == NULL) || (st->out_nb < APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB))
+  {
+    return AI_OD_POSTPROCESS_ERROR;
+  }
+  if (od_st_yolox_uh_set_params(&st->params, st->head_output, NN_Instance) != AI_OD_POSTPROCESS_ERROR_NO)
+  {
+    return AI_OD_POSTPROCESS_ERROR;
+  }
+  st->params.pLut = st->lut;
+  for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+  {
+    st->params.pCellMask[level] = st->pCellMask[level];
+    st->params.pAnchorMask[level] = st->pAnchorMask[level];
+  }
+  return od_st_yolox_pp_reset(&st->params);
+}
+
+static int32_t od_st_yolox_uh_run(void *state, void *pInput[], int nb_input, void *pOutput)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  return od_st_yolox_uh_process(pInput, nb_input, (od_pp_out_t *) pOutput, st->pOutBuff, &st->params,
+                                st->head_output);
+}
+
+static int32_t od_st_yolox_uh_reset(void *state)
+{
+  return od_st_yolox_pp_reset(&((app_postprocess_od_st_yolox_state_t *) state)->params);
+}
+
+const app_postprocess_ops_t app_postprocess_od_st_yolox_uh_ops = {
+  .name = "od_st_yolox_uh",
+  .type = POSTPROCESS_OD_ST_YOLOX_UH,
+  .nb_input = OD_ST_YOLOX_UH_NB_INPUT,
+  .init = od_st_yolox_uh_init,
+  .run = od_st_yolox_uh_run,
+  .reset = od_st_yolox_uh_reset,
+};
+#endif
+
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UH
+static od_pp_outBuffer_t out_detections[APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB];
+static od_st_yolox_pp_lut_is8_t out_lut[AI_OD_ST_YOLOX_PP_HEADS_LUT_NB];
+static uint8_t out_head_output[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS];
+
+int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+{
+  od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
+  if (od_st_yolox_uh_set_params(params, out_head_output, NN_Instance) != AI_OD_POSTPROCESS_ERROR_NO)
+  {
+    return AI_OD_POSTPROCESS_ERROR;
+  }
+  params->pLut = out_lut;
+  return od_st_yolox_pp_reset(params);
+}
+
+int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+{
+  return od_st_yolox_uh_process(pInput, nb_input, (od_pp_out_t *) pOutput, out_detections,
+                                   (od_st_yolox_pp_static_param_t *) pInput_param, out_head_output);
+}
+#endif
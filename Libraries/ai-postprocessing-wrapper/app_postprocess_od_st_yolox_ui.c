@@ -1,6 +1,6 @@
  /**
  ******************************************************************************
- * @file    app_postprocess_od_st_yolox_uf.c
+ * @file    app_postprocess_od_st_yolox_ui.c
  * @author  GPM Application Team
  *
  ******************************************************************************
@@ -19,26 +19,45 @@
 
 #include "app_postprocess.h"
 #include "app_config.h"
+#include "nn_output_params.h"
 #include <assert.h>
 
-#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UI
-#define MAX(a,b) (((a)>(b))?(a):(b))
-static od_pp_outBuffer_t out_detections[MAX(AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT,
-                                            AI_OD_ST_YOLOX_PP_L_GRID_WIDTH * AI_OD_ST_YOLOX_PP_L_GRID_HEIGHT +
-                                            AI_OD_ST_YOLOX_PP_M_GRID_WIDTH * AI_OD_ST_YOLOX_PP_M_GRID_HEIGHT +
-                                            AI_OD_ST_YOLOX_PP_S_GRID_WIDTH * AI_OD_ST_YOLOX_PP_S_GRID_HEIGHT)];
+#if defined(AI_OD_ST_YOLOX_PP_NB_CLASSES)
+#if NN_GEN_OUTPUT_INT8
+/* Outputs quantized as the network nn_output_params.h was generated from: the
+ * decode then takes the build-time scales and zero points. Any other network
+ * (cascade second stage) keeps the values of its own tensor info */
+static int od_st_yolox_ui_is_generated(const LL_Buffer_InfoTypeDef *buffers_info)
+{
+  return (*(buffers_info[0].scale) == NN_GEN_OUTPUT_0_SCALE) && (*(buffers_info[0].offset) == NN_GEN_OUTPUT_0_ZERO_POINT) &&
+         (*(buffers_info[1].scale) == NN_GEN_OUTPUT_1_SCALE) && (*(buffers_info[1].offset) == NN_GEN_OUTPUT_1_ZERO_POINT) &&
+         (*(buffers_info[2].scale) == NN_GEN_OUTPUT_2_SCALE) && (*(buffers_info[2].offset) == NN_GEN_OUTPUT_2_ZERO_POINT);
+}
+#endif
 
-int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+static void od_st_yolox_ui_set_params(od_st_yolox_pp_static_param_t *params, NN_Instance_TypeDef *NN_Instance)
 {
-  int32_t error = AI_OD_POSTPROCESS_ERROR_NO;
-  od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
   const LL_Buffer_InfoTypeDef *buffers_info = LL_ATON_Output_Buffers_Info(NN_Instance);
-  params->raw_s_scale = *(buffers_info[0].scale);
-  params->raw_s_zero_point = *(buffers_info[0].offset);
-  params->raw_l_scale = *(buffers_info[1].scale);
-  params->raw_l_zero_point = *(buffers_info[1].offset);
-  params->raw_m_scale = *(buffers_info[2].scale);
-  params->raw_m_zero_point = *(buffers_info[2].offset);
+#if NN_GEN_OUTPUT_INT8
+  if (od_st_yolox_ui_is_generated(buffers_info))
+  {
+    params->raw_s_scale = NN_GEN_OUTPUT_0_SCALE;
+    params->raw_s_zero_point = NN_GEN_OUTPUT_0_ZERO_POINT;
+    params->raw_l_scale = NN_GEN_OUTPUT_1_SCALE;
+    params->raw_l_zero_point = NN_GEN_OUTPUT_1_ZERO_POINT;
+    params->raw_m_scale = NN_GEN_OUTPUT_2_SCALE;
+    params->raw_m_zero_point = NN_GEN_OUTPUT_2_ZERO_POINT;
+  }
+  else
+#endif
+  {
+    params->raw_s_scale = *(buffers_info[0].scale);
+    params->raw_s_zero_point = *(buffers_info[0].offset);
+    params->raw_l_scale = *(buffers_info[1].scale);
+    params->raw_l_zero_point = *(buffers_info[1].offset);
+    params->raw_m_scale = *(buffers_info[2].scale);
+    params->raw_m_zero_point = *(buffers_info[2].offset);
+  }
   params->nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES;
   params->nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS;
   params->grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH;
@@ -51,26 +70,79 @@ int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_I
   params->pAnchors_M = AI_OD_ST_YOLOX_PP_M_ANCHORS;
   params->pAnchors_S = AI_OD_ST_YOLOX_PP_S_ANCHORS;
   params->max_boxes_limit = AI_OD_ST_YOLOX_PP_MAX_BOXES_LIMIT;
+  params->max_candidates = AI_OD_ST_YOLOX_PP_MAX_CANDIDATES;
   params->conf_threshold = AI_OD_ST_YOLOX_PP_CONF_THRESHOLD;
   params->iou_threshold = AI_OD_ST_YOLOX_PP_IOU_THRESHOLD;
-  error = od_st_yolox_pp_reset(params);
-  return error;
+  params->split_heads = 0;
 }
 
-int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+static int32_t od_st_yolox_ui_process(void *pInput[], int nb_input, od_pp_out_t *pObjDetOutput,
+                                       od_pp_outBuffer_t *pOutBuff, od_st_yolox_pp_static_param_t *params)
 {
   assert(nb_input == 3);
-  int32_t error = AI_OD_POSTPROCESS_ERROR_NO;
-  ((od_st_yolox_pp_static_param_t *) pInput_param)->nb_detect = 0;
-  od_pp_out_t *pObjDetOutput = (od_pp_out_t *) pOutput;
-  pObjDetOutput->pOutBuff = out_detections;
+  params->nb_detect = 0;
+  pObjDetOutput->pOutBuff = pOutBuff;
   od_st_yolox_pp_in_t pp_input = {
       .pRaw_detections_S = (float32_t *) pInput[0],
       .pRaw_detections_L = (float32_t *) pInput[1],
       .pRaw_detections_M = (float32_t *) pInput[2],
   };
-  error = od_st_yolox_pp_process_int8(&pp_input, pObjDetOutput,
-                                 (od_st_yolox_pp_static_param_t *) pInput_param);
-  return error;
+  return od_st_yolox_pp_process_int8(&pp_input, pObjDetOutput, params);
+}
+
+static int32_t od_st_yolox_ui_init(void *state, NN_Instance_TypeDef *NN_Instance)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  if ((st->pOutBuff == NULL) || (st->out_nb < APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB))
+  {
+    return AI_OD_POSTPROCESS_ERROR;
+  }
+  od_st_yolox_ui_set_params(&st->params, NN_Instance);
+  st->params.pLut = st->lut;
+  for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+  {
+    st->params.pCellMask[level] = st->pCellMask[level];
+    st->params.pAnchorMask[level] = st->pAnchorMask[level];
+  }
+  return od_st_yolox_pp_reset(&st->params);
+}
+
+static int32_t od_st_yolox_ui_run(void *state, void *pInput[], int nb_input, void *pOutput)
+{
+  app_postprocess_od_st_yolox_state_t *st = (app_postprocess_od_st_yolox_state_t *) state;
+  return od_st_yolox_ui_process(pInput, nb_input, (od_pp_out_t *) pOutput, st->pOutBuff, &st->params);
+}
+
+static int32_t od_st_yolox_ui_reset(void *state)
+{
+  return od_st_yolox_pp_reset(&((app_postprocess_od_st_yolox_state_t *) state)->params);
+}
+
+const app_postprocess_ops_t app_postprocess_od_st_yolox_ui_ops = {
+  .name = "od_st_yolox_ui",
+  .type = POSTPROCESS_OD_ST_YOLOX_UI,
+  .nb_input = 3,
+  .init = od_st_yolox_ui_init,
+  .run = od_st_yolox_ui_run,
+  .reset = od_st_yolox_ui_reset,
+};
+#endif
+
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UI
+static od_pp_outBuffer_t out_detections[APP_POSTPROCESS_OD_ST_YOLOX_SCRATCH_NB];
+static od_st_yolox_pp_lut_is8_t out_lut[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+
+int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+{
+  od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
+  od_st_yolox_ui_set_params(params, NN_Instance);
+  params->pLut = out_lut;
+  return od_st_yolox_pp_reset(params);
+}
+
+int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+{
+  return od_st_yolox_ui_process(pInput, nb_input, (od_pp_out_t *) pOutput, out_detections,
+                                   (od_st_yolox_pp_static_param_t *) pInput_param);
 }
 #endif
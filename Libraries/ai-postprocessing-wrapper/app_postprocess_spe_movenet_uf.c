@@ -22,32 +22,72 @@
 #include <assert.h>
 
 
-#if POSTPROCESS_TYPE == POSTPROCESS_SPE_MOVENET_UF
-static spe_pp_outBuffer_t out_detections[AI_POSE_PP_POSE_KEYPOINTS_NB];
-
-int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+#if defined(AI_SPE_MOVENET_POSTPROC_HEATMAP_WIDTH)
+static void spe_movenet_uf_set_params(spe_movenet_pp_static_param_t *params, NN_Instance_TypeDef *NN_Instance)
 {
-  int32_t error = AI_SPE_POSTPROCESS_ERROR_NO;
-  spe_movenet_pp_static_param_t *params = (spe_movenet_pp_static_param_t *) params_postprocess;
+  (void) NN_Instance;
   params->heatmap_width = AI_SPE_MOVENET_POSTPROC_HEATMAP_WIDTH;
   params->heatmap_height = AI_SPE_MOVENET_POSTPROC_HEATMAP_HEIGHT;
   params->nb_keypoints = AI_POSE_PP_POSE_KEYPOINTS_NB;
-  error = spe_movenet_pp_reset(params);
-  return error;
 }
 
-int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+static int32_t spe_movenet_uf_process(void *pInput[], int nb_input, spe_pp_out_t *pPoseOutput,
+                                       spe_pp_outBuffer_t *pOutBuff, spe_movenet_pp_static_param_t *params)
 {
   assert(nb_input == 1);
-  int32_t error = AI_SPE_POSTPROCESS_ERROR_NO;
-  spe_pp_out_t *pPoseOutput = (spe_pp_out_t *) pOutput;
-  pPoseOutput->pOutBuff = out_detections;
+  pPoseOutput->pOutBuff = pOutBuff;
   spe_movenet_pp_in_t pp_input =
   {
       .inBuff = (float32_t *) pInput[0]
   };
-  error = spe_movenet_pp_process(&pp_input, pPoseOutput,
-                                 (spe_movenet_pp_static_param_t *) pInput_param);
-  return error;
+  return spe_movenet_pp_process(&pp_input, pPoseOutput, params);
+}
+
+static int32_t spe_movenet_uf_init(void *state, NN_Instance_TypeDef *NN_Instance)
+{
+  app_postprocess_spe_movenet_state_t *st = (app_postprocess_spe_movenet_state_t *) state;
+  if ((st->pOutBuff == NULL) || (st->out_nb < APP_POSTPROCESS_SPE_MOVENET_SCRATCH_NB))
+  {
+    return AI_SPE_POSTPROCESS_ERROR_BAD_HW;
+  }
+  spe_movenet_uf_set_params(&st->params, NN_Instance);
+  return spe_movenet_pp_reset(&st->params);
+}
+
+static int32_t spe_movenet_uf_run(void *state, void *pInput[], int nb_input, void *pOutput)
+{
+  app_postprocess_spe_movenet_state_t *st = (app_postprocess_spe_movenet_state_t *) state;
+  return spe_movenet_uf_process(pInput, nb_input, (spe_pp_out_t *) pOutput, st->pOutBuff, &st->params);
+}
+
+static int32_t spe_movenet_uf_reset(void *state)
+{
+  return spe_movenet_pp_reset(&((app_postprocess_spe_movenet_state_t *) state)->params);
+}
+
+const app_postprocess_ops_t app_postprocess_spe_movenet_uf_ops = {
+  .name = "spe_movenet_uf",
+  .type = POSTPROCESS_SPE_MOVENET_UF,
+  .nb_input = 1,
+  .init = spe_movenet_uf_init,
+  .run = spe_movenet_uf_run,
+  .reset = spe_movenet_uf_reset,
+};
+#endif
+
+#if POSTPROCESS_TYPE == POSTPROCESS_SPE_MOVENET_UF
+static spe_pp_outBuffer_t out_detections[APP_POSTPROCESS_SPE_MOVENET_SCRATCH_NB];
+
+int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_Instance)
+{
+  spe_movenet_pp_static_param_t *params = (spe_movenet_pp_static_param_t *) params_postprocess;
+  spe_movenet_uf_set_params(params, NN_Instance);
+  return spe_movenet_pp_reset(params);
+}
+
+int32_t app_postprocess_run(void *pInput[], int nb_input, void *pOutput, void *pInput_param)
+{
+  return spe_movenet_uf_process(pInput, nb_input, (spe_pp_out_t *) pOutput, out_detections,
+                                   (spe_movenet_pp_static_param_t *) pInput_param);
 }
 #endif
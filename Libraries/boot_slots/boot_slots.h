@@ -0,0 +1,152 @@
+/**
+ ******************************************************************************
+ * @file    boot_slots.h
+ * @author  Long Liangmao
+ * @brief   A/B slot layout of the octoFlash shared by the FSBL and the
+ *          application: two application slots, two model slots, the slot
+ *          table naming the active pair and the trial state kept in the
+ *          TAMP backup registers
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef BOOT_SLOTS_H
+#define BOOT_SLOTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32n6xx_hal.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* octoFlash offsets (memory-mapped at 0x70000000). The slot table takes the
+ * last 64 KB block below the first application slot, past the FSBL. The
+ * static network's weights stay at 0x71000000 and the benchmark scenes at
+ * 0x71C00000: model slots hold relocatable networks (cmake -DNN_RELOC=ON) */
+#define BOOT_SLOTS_FLASH_BASE 0x70000000U
+#define BOOT_SLOTS_TABLE_OFFSET 0x000F0000U
+#define BOOT_SLOTS_APP_SIZE 0x00080000U /* Signed image, header included */
+#define BOOT_SLOTS_APP_OFFSET(slot) (0x00100000U + (uint32_t)(slot) * BOOT_SLOTS_APP_SIZE)
+#define BOOT_SLOTS_MODEL_SIZE 0x00400000U
+#define BOOT_SLOTS_MODEL_OFFSET(slot) ((slot) == BOOT_SLOT_A ? 0x01800000U : 0x02000000U)
+
+#define BOOT_SLOT_A 0U
+#define BOOT_SLOT_B 1U
+#define BOOT_SLOT_NB 2U
+
+#define BOOT_SLOTS_TABLE_MAGIC 0x544F4C53U /* "SLOT" */
+#define BOOT_SLOTS_MODEL_MAGIC 0x4C444F4DU /* "MODL" */
+#define BOOT_SLOTS_MANIFEST_MAGIC 0x5453464DU /* "MFST" */
+
+/* Application manifest: the last 4 KB sector of an application slot, so the
+ * signed image takes at most BOOT_SLOTS_APP_SIZE - BOOT_SLOTS_MANIFEST_SIZE */
+#define BOOT_SLOTS_MANIFEST_SIZE 0x00001000U
+#define BOOT_SLOTS_MANIFEST_OFFSET(slot) (BOOT_SLOTS_APP_OFFSET(slot) + BOOT_SLOTS_APP_SIZE - BOOT_SLOTS_MANIFEST_SIZE)
+#define BOOT_SLOTS_DIGEST_SIZE 32U /* SHA-256 */
+
+/* Boots of an unconfirmed table before the FSBL falls back to the previous
+ * pair: the application confirms once it has published an inference */
+#define BOOT_SLOTS_MAX_TRIALS 3U
+
+/* Written by the host tool on every update. A new generation with confirmed
+ * clear is a trial: the pair before it stays named as the fallback */
+typedef struct {
+  uint32_t magic;
+  uint32_t generation;
+  uint8_t app_slot;
+  uint8_t model_slot;
+  uint8_t prev_app_slot;
+  uint8_t prev_model_slot;
+  uint8_t confirmed; /* Known good: no trial counting */
+  uint8_t reserved[3];
+  uint32_t app_version[BOOT_SLOT_NB];
+  uint32_t model_version[BOOT_SLOT_NB];
+  uint32_t checksum; /* Byte sum of the fields above */
+} boot_slots_table_t;
+
+/* Start of a model slot; the relocatable network binary follows at
+ * weights_offset. A slot without this header holds the binary at its start
+ * (flashed before the slotted layout) */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t weights_offset;  /* From the slot start */
+  uint32_t size;            /* Binary length */
+  uint32_t checksum;        /* Byte sum of the binary */
+  uint32_t header_checksum; /* Byte sum of the fields above */
+} boot_model_header_t;
+
+/* Written by the host tool after the signed image of its slot. A slot
+ * without one is checked by the header checksum alone */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;    /* Application version */
+  uint32_t image_size; /* Signed image length, header included */
+  uint32_t reserved;
+  uint8_t digest[BOOT_SLOTS_DIGEST_SIZE]; /* SHA-256 of the signed image */
+  uint8_t tag[BOOT_SLOTS_DIGEST_SIZE];    /* HMAC-SHA256 of the fields above */
+} boot_app_manifest_t;
+
+/* TAMP backup registers: kept over resets while VDD or VBAT is present */
+#define BOOT_SLOTS_BKP_TRIAL 0U    /* Generation (bits 31:8), boots counted (7:0) */
+#define BOOT_SLOTS_BKP_CONFIRM 1U  /* Generation the application confirmed */
+#define BOOT_SLOTS_BKP_SELECTED 2U /* BOOT_SLOTS_SELECTED() of this boot */
+
+#define BOOT_SLOTS_SELECTED_TAG 0xB5000000U
+#define BOOT_SLOTS_ROLLED_BACK (1U << 16)
+#define BOOT_SLOTS_SELECTED(app, model, flags) \
+  (BOOT_SLOTS_SELECTED_TAG | (flags) | ((uint32_t)(model) << 8) | (uint32_t)(app))
+
+static inline uint32_t BootSlots_Sum(const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t sum = 0;
+
+  for (uint32_t i = 0; i < len; i++) {
+    sum += bytes[i];
+  }
+  return sum;
+}
+
+static inline const boot_slots_table_t *BootSlots_GetTable(void) {
+  return (const boot_slots_table_t *)(BOOT_SLOTS_FLASH_BASE + BOOT_SLOTS_TABLE_OFFSET);
+}
+
+/**
+ * @brief  Check a slot table: magic, checksum and slot numbers
+ * @retval 1 when usable
+ */
+static inline int BootSlots_TableValid(const boot_slots_table_t *table) {
+  return table->magic == BOOT_SLOTS_TABLE_MAGIC &&
+         table->checksum == BootSlots_Sum(table, offsetof(boot_slots_table_t, checksum)) &&
+         table->app_slot < BOOT_SLOT_NB && table->model_slot < BOOT_SLOT_NB &&
+         table->prev_app_slot < BOOT_SLOT_NB && table->prev_model_slot < BOOT_SLOT_NB;
+}
+
+static inline volatile uint32_t *BootSlots_Bkp(uint32_t index) {
+  return &TAMP->BKP0R + index;
+}
+
+/**
+ * @brief  Make the backup registers writable
+ */
+static inline void BootSlots_BkpEnable(void) {
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_SLOTS_H */
@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * @file    boot_timeline.h
+ * @author  Long Liangmao
+ * @brief   Boot phase markers shared by the FSBL and the application
+ *          DWT cycle timestamps kept in a no-init block of AXISRAM1 that
+ *          survives the load-and-run jump
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32n6xx.h"
+#include <stdint.h>
+
+/* Top 256 bytes of the application RAM, outside every section of both
+ * images (BOOTLOG region of STM32N657XX_LRUN.ld) */
+#define BOOT_TIMELINE_ADDR 0x340FFF00U
+#define BOOT_TIMELINE_SIZE 256U
+
+#define BOOT_TIMELINE_MAGIC 0x544F4F42U /* "BOOT" */
+#define BOOT_TIMELINE_MAX_MARKS 28
+
+/* Who wrote the record last: the application keeps an FSBL record only when
+ * the FSBL handed it over on this boot */
+#define BOOT_TIMELINE_FSBL 1U
+#define BOOT_TIMELINE_HANDOFF 2U
+#define BOOT_TIMELINE_APP 3U
+
+/* Phase ends, in boot order. A mark closes the phase since the previous one;
+ * the camera bring-up runs in its own thread, alongside NPU and UI */
+typedef enum {
+  BOOT_PHASE_FSBL_ENTRY = 0, /* Time zero; the boot ROM before it is not seen */
+  BOOT_PHASE_FSBL_CLOCKS,
+  BOOT_PHASE_FSBL_XSPI,
+  BOOT_PHASE_FSBL_COPY,
+  BOOT_PHASE_APP_ENTRY,      /* Startup code: .data copy and .bss clear */
+  BOOT_PHASE_APP_CLOCKS,
+  BOOT_PHASE_APP_HAL,        /* MPU, caches, HAL, GPIO, RIF */
+  BOOT_PHASE_APP_BUFFERS,    /* SMPS, XSPI, memory self-test, PSRAM buffers */
+  BOOT_PHASE_APP_LCD,        /* LTDC */
+  BOOT_PHASE_APP_NPU,        /* Runtime, network and post processing */
+  BOOT_PHASE_APP_UI,         /* UI layer buffers cleared, UI thread */
+  BOOT_PHASE_APP_CAMERA,     /* Sensor probe and ISP */
+  BOOT_PHASE_APP_PIPES,      /* Threads created, pipes started */
+  BOOT_PHASE_FIRST_FRAME,    /* First camera frame latched by the LTDC */
+  BOOT_PHASE_FIRST_INFERENCE,
+  BOOT_PHASE_NB
+} boot_phase_t;
+
+typedef struct {
+  uint16_t phase;
+  uint16_t reserved;
+  uint32_t us; /* Since BOOT_PHASE_FSBL_ENTRY */
+} boot_mark_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t state;
+  uint32_t cycles_last; /* DWT CYCCNT at the previous mark */
+  uint32_t hz_last;     /* Core clock at the previous mark */
+  uint32_t us;
+  uint32_t nb;
+  boot_mark_t marks[BOOT_TIMELINE_MAX_MARKS];
+} boot_timeline_t;
+
+_Static_assert(sizeof(boot_timeline_t) <= BOOT_TIMELINE_SIZE, "Boot timeline record overflows its block");
+
+static inline boot_timeline_t *BootTimeline_Get(void) {
+  return (boot_timeline_t *)BOOT_TIMELINE_ADDR;
+}
+
+/**
+ * @brief  Record the end of a phase
+ * @param  phase: Phase that ends now (boot_phase_t)
+ * @note   The interval since the previous mark is converted to microseconds
+ *         at the core clock in force when it started, so a clock switch costs
+ *         at most the switch itself and the 32-bit counter only has to cover
+ *         one phase (5.3 s at 800 MHz), not the whole boot. Marks past the
+ *         table are dropped. Callable from threads and interrupts
+ */
+static inline void BootTimeline_Mark(uint32_t phase) {
+  boot_timeline_t *tl = BootTimeline_Get();
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now, mhz;
+
+  __disable_irq();
+  now = DWT->CYCCNT;
+  mhz = tl->hz_last / 1000000U;
+  if (mhz != 0U) {
+    tl->us += (now - tl->cycles_last) / mhz;
+  }
+  tl->cycles_last = now;
+  tl->hz_last = SystemCoreClock;
+  if (tl->nb < BOOT_TIMELINE_MAX_MARKS) {
+    tl->marks[tl->nb].phase = (uint16_t)phase;
+    tl->marks[tl->nb].reserved = 0;
+    tl->marks[tl->nb].us = tl->us;
+    tl->nb++;
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  Start a new record at time zero
+ * @param  state: Writer of the record (BOOT_TIMELINE_FSBL or _APP)
+ * @param  phase: First mark
+ * @note   Enables the DWT cycle counter, which then runs on: the application
+ *         only ever enables it again (Time_Init(), UI_InitCycleCounter())
+ */
+static inline void BootTimeline_Start(uint32_t state, uint32_t phase) {
+  boot_timeline_t *tl = BootTimeline_Get();
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  tl->magic = BOOT_TIMELINE_MAGIC;
+  tl->state = state;
+  tl->cycles_last = 0;
+  tl->hz_last = SystemCoreClock;
+  tl->us = 0;
+  tl->nb = 0;
+  BootTimeline_Mark(phase);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TIMELINE_H */
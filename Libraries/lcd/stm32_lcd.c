@@ -124,6 +124,15 @@
 
 #define CONVERTARGB88882RGB888(Color)(Color & 0x00FFFFFFU)
 
+#define CONVERTARGB88882ARGB8888(Color)(Color)
+
+/* Store of one native color in a DrawChar line buffer */
+#define STOREPIXEL32(pLine, Index, Color) (((uint32_t *)(pLine))[(Index)] = (Color))
+#define STOREPIXEL16(pLine, Index, Color) (((uint16_t *)(pLine))[(Index)] = (uint16_t)(Color))
+#define STOREPIXEL24(pLine, Index, Color) do { (pLine)[3U * (Index)]      = (uint8_t)(Color);         \
+                                               (pLine)[3U * (Index) + 1U] = (uint8_t)((Color) >> 8);  \
+                                               (pLine)[3U * (Index) + 2U] = (uint8_t)((Color) >> 16); } while (0)
+
 /**
   * @}
   */
@@ -141,6 +150,21 @@ typedef struct
   uint32_t y3;
 }Triangle_Positions_t;
 
+/**
+  * @brief  Drawing primitives specialized for one layer pixel format: colors
+  *         come in ARGB8888 and are converted inline, without a format test
+  */
+typedef struct
+{
+  void     (*DrawHLine)(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color);
+  void     (*DrawVLine)(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color);
+  void     (*FillRect)(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color);
+  void     (*SetPixel)(uint16_t Xpos, uint16_t Ypos, uint32_t Color);
+  void     (*GetPixel)(uint16_t Xpos, uint16_t Ypos, uint32_t *Color);
+  uint32_t (*ToNative)(uint32_t Color);
+  void     (*FillCharLine)(uint8_t *pLine, uint32_t Bits, uint32_t Width, uint32_t TextColor, uint32_t BackColor);
+} UTIL_LCD_Format_t;
+
 /**
   * @}
   */
@@ -154,6 +178,7 @@ typedef struct
   */
 static UTIL_LCD_Ctx_t DrawProp[UTIL_LCD_MAX_LAYERS_NBR];
 static LCD_UTILS_Drv_t FuncDriver;
+static const UTIL_LCD_Format_t *pFormat;
 
 /**
   * @}
@@ -164,6 +189,88 @@ static LCD_UTILS_Drv_t FuncDriver;
   */
 static void DrawChar(uint32_t Xpos, uint32_t Ypos, const uint8_t *pData);
 static void FillTriangle(Triangle_Positions_t *Positions, uint32_t Color);
+static const UTIL_LCD_Format_t *SelectFormat(uint32_t PixelFormat);
+/**
+  * @}
+  */
+
+/** @defgroup UTIL_LCD_Private_Format_Functions STM32 LCD Utility Private Format Functions
+  * @{
+  */
+
+/**
+  * @brief  Instantiates the primitives of one pixel format
+  * @param  Name      Format suffix of the generated functions
+  * @param  TO_NATIVE ARGB8888 to layer color conversion
+  * @param  TO_ARGB   Layer color to ARGB8888 conversion
+  * @param  STORE     Store of one layer color in a line buffer
+  * @note   FillCharLine expands font row bits, MSB first, into Width pixels
+  */
+#define UTIL_LCD_FORMAT_TEMPLATE(Name, TO_NATIVE, TO_ARGB, STORE)                                   \
+static void DrawHLine_##Name(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)          \
+{                                                                                                     \
+  FuncDriver.DrawHLine(DrawProp->LcdDevice, Xpos, Ypos, Length, TO_NATIVE(Color));                    \
+}                                                                                                     \
+static void DrawVLine_##Name(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)          \
+{                                                                                                     \
+  FuncDriver.DrawVLine(DrawProp->LcdDevice, Xpos, Ypos, Length, TO_NATIVE(Color));                    \
+}                                                                                                     \
+static void FillRect_##Name(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color) \
+{                                                                                                     \
+  FuncDriver.FillRect(DrawProp->LcdDevice, Xpos, Ypos, Width, Height, TO_NATIVE(Color));              \
+}                                                                                                     \
+static void SetPixel_##Name(uint16_t Xpos, uint16_t Ypos, uint32_t Color)                            \
+{                                                                                                     \
+  FuncDriver.SetPixel(DrawProp->LcdDevice, Xpos, Ypos, TO_NATIVE(Color));                             \
+}                                                                                                     \
+static void GetPixel_##Name(uint16_t Xpos, uint16_t Ypos, uint32_t *Color)                           \
+{                                                                                                     \
+  FuncDriver.GetPixel(DrawProp->LcdDevice, Xpos, Ypos, Color);                                        \
+  *Color = TO_ARGB(*Color);                                                                           \
+}                                                                                                     \
+static uint32_t ToNative_##Name(uint32_t Color)                                                      \
+{                                                                                                     \
+  return TO_NATIVE(Color);                                                                            \
+}                                                                                                     \
+static void FillCharLine_##Name(uint8_t *pLine, uint32_t Bits, uint32_t Width,                       \
+                                uint32_t TextColor, uint32_t BackColor)                               \
+{                                                                                                     \
+  for (uint32_t j = 0; j < Width; j++)                                                                \
+  {                                                                                                   \
+    STORE(pLine, j, (Bits & (1UL << (Width - j - 1U))) ? TextColor : BackColor);                      \
+  }                                                                                                   \
+}                                                                                                     \
+static const UTIL_LCD_Format_t Format_##Name =                                                       \
+{                                                                                                     \
+  DrawHLine_##Name, DrawVLine_##Name, FillRect_##Name, SetPixel_##Name, GetPixel_##Name,              \
+  ToNative_##Name, FillCharLine_##Name                                                                \
+};
+
+UTIL_LCD_FORMAT_TEMPLATE(ARGB8888, CONVERTARGB88882ARGB8888, CONVERTARGB88882ARGB8888, STOREPIXEL32)
+UTIL_LCD_FORMAT_TEMPLATE(RGB888,   CONVERTARGB88882RGB888,   CONVERTRGB8882ARGB8888,   STOREPIXEL24)
+UTIL_LCD_FORMAT_TEMPLATE(RGB565,   CONVERTARGB88882RGB565,   CONVERTRGB5652ARGB8888,   STOREPIXEL16)
+UTIL_LCD_FORMAT_TEMPLATE(ARGB4444, CONVERTARGB88882ARGB4444, CONVERTARGB44442ARGB8888, STOREPIXEL16)
+
+/**
+  * @brief  Primitives of a layer pixel format
+  * @param  PixelFormat LCD_PIXEL_FORMAT_xxx reported by the driver
+  * @retval Format table; other formats are drawn as ARGB8888, as before
+  */
+static const UTIL_LCD_Format_t *SelectFormat(uint32_t PixelFormat)
+{
+  switch (PixelFormat)
+  {
+  case LCD_PIXEL_FORMAT_RGB888:
+    return &Format_RGB888;
+  case LCD_PIXEL_FORMAT_RGB565:
+    return &Format_RGB565;
+  case LCD_PIXEL_FORMAT_ARGB4444:
+    return &Format_ARGB4444;
+  default:
+    return &Format_ARGB8888;
+  }
+}
+
 /**
   * @}
   */
@@ -195,6 +302,7 @@ void UTIL_LCD_SetFuncDriver(const LCD_UTILS_Drv_t *pDrv)
   FuncDriver.GetXSize(0, &DrawProp[DrawProp->LcdLayer].LcdXsize);
   FuncDriver.GetYSize(0, &DrawProp[DrawProp->LcdLayer].LcdYsize);
   FuncDriver.GetFormat(0, &DrawProp[DrawProp->LcdLayer].LcdPixelFormat);
+  pFormat = SelectFormat(DrawProp[DrawProp->LcdLayer].LcdPixelFormat);
 }
 
 /**
@@ -211,6 +319,7 @@ void UTIL_LCD_SetLayer(uint32_t Layer)
       FuncDriver.GetXSize(DrawProp->LcdDevice, &DrawProp[DrawProp->LcdLayer].LcdXsize);
       FuncDriver.GetYSize(DrawProp->LcdDevice, &DrawProp[DrawProp->LcdLayer].LcdYsize);
       FuncDriver.GetFormat(DrawProp->LcdDevice, &DrawProp[DrawProp->LcdLayer].LcdPixelFormat);
+      pFormat = SelectFormat(DrawProp[DrawProp->LcdLayer].LcdPixelFormat);
     }
   }
 }
@@ -303,22 +412,7 @@ void UTIL_LCD_FillRGBRect(uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t
 void UTIL_LCD_DrawHLine(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
 {
   /* Write line */
-  if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-  {
-    FuncDriver.DrawHLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882RGB565(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-  {
-    FuncDriver.DrawHLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882RGB888(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-  {
-    FuncDriver.DrawHLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882ARGB4444(Color));
-  }
-  else /*LCD_PIXEL_FORMAT_ARGB8888*/
-  {
-    FuncDriver.DrawHLine(DrawProp->LcdDevice, Xpos, Ypos, Length, Color);
-  }
+  pFormat->DrawHLine(Xpos, Ypos, Length, Color);
 }
 
 /**
@@ -331,22 +425,7 @@ void UTIL_LCD_DrawHLine(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t
 void UTIL_LCD_DrawVLine(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
 {
   /* Write line */
-  if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-  {
-    FuncDriver.DrawVLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882RGB565(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-  {
-    FuncDriver.DrawVLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882RGB888(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-  {
-    FuncDriver.DrawVLine(DrawProp->LcdDevice, Xpos, Ypos, Length, CONVERTARGB88882ARGB4444(Color));
-  }
-  else /*LCD_PIXEL_FORMAT_ARGB888*/
-  {
-    FuncDriver.DrawVLine(DrawProp->LcdDevice, Xpos, Ypos, Length, Color);
-  }
+  pFormat->DrawVLine(Xpos, Ypos, Length, Color);
 }
 
 /**
@@ -358,19 +437,7 @@ void UTIL_LCD_DrawVLine(uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t
 void UTIL_LCD_GetPixel(uint16_t Xpos, uint16_t Ypos, uint32_t *Color)
 {
   /* Get Pixel */
-  FuncDriver.GetPixel(DrawProp->LcdDevice, Xpos, Ypos, Color);
-  if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-  {
-    *Color = CONVERTRGB5652ARGB8888(*Color);
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-  {
-    *Color = CONVERTRGB8882ARGB8888(*Color);
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-  {
-    *Color = CONVERTARGB44442ARGB8888(*Color);
-  }
+  pFormat->GetPixel(Xpos, Ypos, Color);
 }
 
 /**
@@ -382,22 +449,7 @@ void UTIL_LCD_GetPixel(uint16_t Xpos, uint16_t Ypos, uint32_t *Color)
 void UTIL_LCD_SetPixel(uint16_t Xpos, uint16_t Ypos, uint32_t Color)
 {
   /* Set Pixel */
-  if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-  {
-    FuncDriver.SetPixel(DrawProp->LcdDevice, Xpos, Ypos, CONVERTARGB88882RGB565(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-  {
-    FuncDriver.SetPixel(DrawProp->LcdDevice, Xpos, Ypos, CONVERTARGB88882RGB888(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-  {
-    FuncDriver.SetPixel(DrawProp->LcdDevice, Xpos, Ypos, CONVERTARGB88882ARGB4444(Color));
-  }
-  else /*LCD_PIXEL_FORMAT_ARGB888*/
-  {
-    FuncDriver.SetPixel(DrawProp->LcdDevice, Xpos, Ypos, Color);
-  }
+  pFormat->SetPixel(Xpos, Ypos, Color);
 }
 
 /**
@@ -774,22 +826,7 @@ void UTIL_LCD_DrawBitmap(uint32_t Xpos, uint32_t Ypos, uint8_t *pData)
 void UTIL_LCD_FillRect(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color)
 {
   /* Fill the rectangle */
-  if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-  {
-    FuncDriver.FillRect(DrawProp->LcdDevice, Xpos, Ypos, Width, Height, CONVERTARGB88882RGB565(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-  {
-    FuncDriver.FillRect(DrawProp->LcdDevice, Xpos, Ypos, Width, Height, CONVERTARGB88882RGB888(Color));
-  }
-  else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-  {
-    FuncDriver.FillRect(DrawProp->LcdDevice, Xpos, Ypos, Width, Height, CONVERTARGB88882ARGB4444(Color));
-  }
-  else /*LCD_PIXEL_FORMAT_ARGB8888*/
-  {
-    FuncDriver.FillRect(DrawProp->LcdDevice, Xpos, Ypos, Width, Height, Color);
-  }
+  pFormat->FillRect(Xpos, Ypos, Width, Height, Color);
 }
 
 /**
@@ -998,21 +1035,23 @@ void UTIL_LCD_FillEllipse(int Xpos, int Ypos, int XRadius, int YRadius, uint32_t
   */
 static void DrawChar(uint32_t Xpos, uint32_t Ypos, const uint8_t *pData)
 {
-  uint32_t i = 0, j = 0, offset;
+  uint32_t i = 0, offset;
   uint32_t height, width;
   uint8_t  *pchar;
   uint32_t line;
+  uint32_t text_color, back_color;
 
   height = DrawProp[DrawProp->LcdLayer].pFont->Height;
   width  = DrawProp[DrawProp->LcdLayer].pFont->Width;
 
   uint8_t rgb8[24*4];
-  uint16_t* rgb16 = (uint16_t*)rgb8;
-  uint32_t* argb32 = (uint32_t*)rgb8;
-  uint16_t* argb4444 = (uint16_t*)rgb8;
 
   offset =  8 *((width + 7)/8) -  width ;
 
+  /* Layer colors once per character */
+  text_color = pFormat->ToNative(DrawProp[DrawProp->LcdLayer].TextColor);
+  back_color = pFormat->ToNative(DrawProp[DrawProp->LcdLayer].BackColor);
+
   for(i = 0; i < height; i++)
   {
     pchar = ((uint8_t *)pData + (width + 7)/8 * i);
@@ -1034,71 +1073,8 @@ static void DrawChar(uint32_t Xpos, uint32_t Ypos, const uint8_t *pData)
       break;
     }
 
-    if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB565)
-    {
-      for (j = 0; j < width; j++)
-      {
-        if(line & (1 << (width- j + offset- 1)))
-        {
-          rgb16[j] = CONVERTARGB88882RGB565(DrawProp[DrawProp->LcdLayer].TextColor);
-        }
-        else
-        {
-          rgb16[j] = CONVERTARGB88882RGB565(DrawProp[DrawProp->LcdLayer].BackColor);
-        }
-      }
-      UTIL_LCD_FillRGBRect(Xpos,  Ypos++, &rgb8[0], width, 1);
-    }
-    else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_RGB888)
-    {
-      for (j = 0; j < width*3; j = j+ 3)
-      {
-        if(line & (1 << (width- j/3 + offset- 1)))
-        {
-          rgb8[j] = CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].TextColor)) & 0xFFU;
-          rgb8[j + 1U] = (CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].TextColor)) >> 8) & 0xFFU;
-          rgb8[j + 2U] = (CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].TextColor)) >> 16) & 0xFFU;
-        }
-        else
-        {
-          rgb8[j] = CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].BackColor)) & 0xFFU;
-          rgb8[j + 1U] = (CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].BackColor)) >> 8) & 0xFFU;
-          rgb8[j + 2U] = (CONVERTARGB88882RGB888((DrawProp[DrawProp->LcdLayer].BackColor)) >> 16) & 0xFFU;
-        }
-      }
-
-      UTIL_LCD_FillRGBRect(Xpos,  Ypos++, &rgb8[0], width, 1);
-    }
-    else if(DrawProp[DrawProp->LcdLayer].LcdPixelFormat == LCD_PIXEL_FORMAT_ARGB4444)
-    {
-      for (j = 0; j < width; j++)
-      {
-        if(line & (1 << (width- j + offset- 1)))
-        {
-          argb4444[j] = CONVERTARGB88882ARGB4444(DrawProp[DrawProp->LcdLayer].TextColor);
-        }
-        else
-        {
-          argb4444[j] = CONVERTARGB88882ARGB4444(DrawProp[DrawProp->LcdLayer].BackColor);
-        }
-      }
-      UTIL_LCD_FillRGBRect(Xpos,  Ypos++, (uint8_t*)&argb4444[0], width, 1);
-    }
-    else /*LCD_PIXEL_FORMAT_ARGB888*/
-    {
-      for (j = 0; j < width; j++)
-      {
-        if(line & (1 << (width- j + offset- 1)))
-        {
-          argb32[j] = DrawProp[DrawProp->LcdLayer].TextColor;
-        }
-        else
-        {
-          argb32[j] = DrawProp[DrawProp->LcdLayer].BackColor;
-        }
-      }
-      UTIL_LCD_FillRGBRect(Xpos,  Ypos++, &rgb8[0], width, 1);
-    }
+    pFormat->FillCharLine(&rgb8[0], line >> offset, width, text_color, back_color);
+    UTIL_LCD_FillRGBRect(Xpos,  Ypos++, &rgb8[0], width, 1);
   }
 }
 
@@ -0,0 +1,1200 @@
+/**
+ ******************************************************************************
+ * @file    vision_models_pp_bench.c
+ * @author  Long Liangmao
+ * @brief   Host micro-benchmark of lib_vision_models_pp
+ *
+ *          Each benchmark is a post processor on a deterministic synthetic
+ *          output tensor: empty, sparse and crowded scenes for the object
+ *          detectors, one random tensor for pose and segmentation. Like
+ *          Google Benchmark, the iteration count grows until a run lasts
+ *          --benchmark_min_time; only the post processor call is timed and
+ *          the inputs are checked to be left untouched. The object
+ *          detectors also report decode, NMS and score filtering through
+ *          the library stage hook. The digest hashes the
+ *          outputs of the last iteration; it and the detection count are
+ *          checked against the golden values below, and the exit status is
+ *          1 on any mismatch. A change meant to move the outputs updates
+ *          them in the same commit.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "iseg_yolov8_pp_if.h"
+#include "od_centernet_pp_if.h"
+#include "od_fd_blazeface_pp_if.h"
+#include "od_pp_loc.h"
+#include "od_ssd_st_pp_if.h"
+#include "od_st_yolox_pp_if.h"
+#include "od_yolov2_pp_if.h"
+#include "od_yolov5_pp_if.h"
+#include "od_yolov8_pp_if.h"
+#include "spe_movenet_pp_if.h"
+#include "sseg_deeplabv3_pp_if.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_INPUTS 9
+#define BENCH_MIN_TIME_S 0.5
+#define BENCH_MAX_ITERATIONS 1000000000ULL
+
+/* ST YoloX as configured by the application (app_config.h) */
+#define BENCH_ST_YOLOX_NB_CLASSES 1
+#define BENCH_ST_YOLOX_NB_ANCHORS 3
+#define BENCH_ST_YOLOX_STRIDE (BENCH_ST_YOLOX_NB_CLASSES + AI_YOLOV2_PP_CLASSPROB)
+#define BENCH_ST_YOLOX_MAX_CANDIDATES (4 * BENCH_MAX_BOXES_LIMIT * BENCH_ST_YOLOX_NB_CLASSES)
+
+/* YOLOv8 and YOLOv5 at 640x640, COCO */
+#define BENCH_COCO_NB_CLASSES 80
+#define BENCH_YOLOV8_NB_BOXES 8400
+#define BENCH_YOLOV5_NB_BOXES 25200
+
+/* Tiny YOLOv2 VOC */
+#define BENCH_YOLOV2_GRID 13
+#define BENCH_YOLOV2_NB_ANCHORS 5
+#define BENCH_YOLOV2_NB_CLASSES 20
+
+/* ST SSD person detection: background and person, MobileNet at 300x300 */
+#define BENCH_SSD_ST_NB_CLASSES 2
+#define BENCH_SSD_ST_NB_ANCHORS 1917
+
+/* BlazeFace front model at 128x128: 16x16 cells of 2 anchors, 8x8 cells of 6 */
+#define BENCH_BLAZEFACE_IN_SIZE 128
+#define BENCH_BLAZEFACE_NB_KEYPOINTS 6
+#define BENCH_BLAZEFACE_NB_0 512
+#define BENCH_BLAZEFACE_NB_1 384
+
+/* CenterNet at 512x512, COCO */
+#define BENCH_CENTERNET_GRID 128
+
+/* YOLOv8n-seg at 256x256: 32 prototypes at a quarter of the input */
+#define BENCH_ISEG_NB_BOXES 1344
+#define BENCH_ISEG_NB_MASKS 32
+#define BENCH_ISEG_MASK_SIZE 64
+
+#define BENCH_MOVENET_HEATMAP 48
+#define BENCH_MOVENET_KEYPOINTS 17
+
+#define BENCH_SSEG_SIZE 256
+#define BENCH_SSEG_NB_CLASSES 21
+
+#define BENCH_MAX_BOXES_LIMIT 100
+
+static const float32_t bench_st_yolox_anchors_l[] = {30.0f, 30.0f, 4.2f, 15.0f, 13.8f, 42.0f};
+static const float32_t bench_st_yolox_anchors_m[] = {15.0f, 15.0f, 2.1f, 7.5f, 6.9f, 21.0f};
+static const float32_t bench_st_yolox_anchors_s[] = {7.5f, 7.5f, 1.05f, 3.75f, 3.45f, 10.5f};
+static const float32_t bench_yolov2_anchors[] = {1.08f, 1.19f, 3.42f, 4.41f, 6.63f, 11.38f, 9.42f, 5.11f, 16.62f, 10.52f};
+
+typedef enum {
+  BENCH_F32,
+  BENCH_S8,
+  BENCH_U8,
+} bench_type_t;
+
+typedef struct bench_case bench_case_t;
+
+/* A post processor: allocates and fills its inputs, then runs once */
+typedef struct {
+  const char *name;
+  bench_type_t type;
+  void (*setup)(bench_case_t *c);
+  int32_t (*run)(bench_case_t *c);
+} bench_pp_t;
+
+struct bench_case {
+  const bench_pp_t *pp;
+  const char *scene;
+  float density; /* Share of box records above the confidence threshold */
+
+  int nb_inputs;
+  void *inputs[BENCH_MAX_INPUTS];
+  void *pristine[BENCH_MAX_INPUTS]; /* Copy of the inputs, to catch in-place work */
+  size_t sizes[BENCH_MAX_INPUTS];
+  void *out;     /* Output records */
+  void *scratch; /* Candidates, for the post processors asking for one */
+  void (*prepare)(bench_case_t *c); /* Set by setup: untimed, before each run */
+  uint32_t seed;
+
+  /* Last run */
+  int32_t nb_detect;
+  size_t out_bytes; /* Of out, hashed into the digest */
+};
+
+static struct {
+  uint64_t stamps[AI_OD_POSTPROCESS_STAGE_NB];
+  uint64_t stage_ns[AI_OD_POSTPROCESS_STAGE_END];
+  int staged;
+} bench_stages;
+
+static uint64_t Bench_Now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  Stage hook of the library (AI_OD_POSTPROCESS_STAGE_HOOK)
+ */
+void vision_models_pp_bench_stage(int32_t stage) {
+  bench_stages.stamps[stage] = Bench_Now();
+}
+
+static uint32_t Bench_Random(bench_case_t *c) {
+  /* xorshift32 */
+  c->seed ^= c->seed << 13;
+  c->seed ^= c->seed >> 17;
+  c->seed ^= c->seed << 5;
+  return c->seed;
+}
+
+static float Bench_Uniform(bench_case_t *c, float lo, float hi) {
+  return lo + (hi - lo) * (float)(Bench_Random(c) >> 8) * (1.0f / 16777216.0f);
+}
+
+static int Bench_Hot(bench_case_t *c) {
+  return Bench_Uniform(c, 0.0f, 1.0f) < c->density;
+}
+
+static void *Bench_Alloc(size_t size) {
+  void *p = calloc(1, size);
+
+  if (p == NULL) {
+    fprintf(stderr, "out of memory (%zu bytes)\n", size);
+    exit(1);
+  }
+  return p;
+}
+
+static void Bench_AddInput(bench_case_t *c, size_t size) {
+  c->sizes[c->nb_inputs] = size;
+  c->inputs[c->nb_inputs] = Bench_Alloc(size);
+  c->nb_inputs++;
+}
+
+/**
+ * @brief  Store a value, quantized for the integer post processors
+ */
+static void Bench_Put(const bench_case_t *c, int t, size_t index, float value, float scale, int32_t zp) {
+  int32_t q;
+
+  switch (c->pp->type) {
+  case BENCH_F32:
+    ((float32_t *)c->inputs[t])[index] = value;
+    break;
+  case BENCH_S8:
+    q = (int32_t)lrintf(value / scale) + zp;
+    ((int8_t *)c->inputs[t])[index] = (int8_t)MIN(MAX(q, -128), 127);
+    break;
+  case BENCH_U8:
+    q = (int32_t)lrintf(value / scale) + zp;
+    ((uint8_t *)c->inputs[t])[index] = (uint8_t)MIN(MAX(q, 0), 255);
+    break;
+  }
+}
+
+static size_t Bench_ElemSize(const bench_case_t *c) {
+  return (c->pp->type == BENCH_F32) ? sizeof(float32_t) : 1;
+}
+
+/* ST YoloX ------------------------------------------------------------------ */
+
+#define BENCH_ST_YOLOX_SCALE 0.0625f
+
+static const int32_t bench_st_yolox_grids[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {15, 60, 30}; /* S, L, M */
+/* Levels of bench_st_yolox_grids, in AI_OD_ST_YOLOX_PP_LEVEL_ order */
+static const int bench_st_yolox_levels[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {AI_OD_ST_YOLOX_PP_LEVEL_S,
+                                                                       AI_OD_ST_YOLOX_PP_LEVEL_L,
+                                                                       AI_OD_ST_YOLOX_PP_LEVEL_M};
+
+/* Reset once, as the application does: the int8 decode tables are built there */
+static od_st_yolox_pp_static_param_t bench_st_yolox_params;
+static od_st_yolox_pp_lut_is8_t bench_st_yolox_lut[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+
+static void Bench_StYoloxSetup(bench_case_t *c) {
+  for (int t = 0; t < AI_OD_ST_YOLOX_PP_NB_LEVELS; t++) {
+    size_t records = (size_t)bench_st_yolox_grids[t] * bench_st_yolox_grids[t] * BENCH_ST_YOLOX_NB_ANCHORS;
+
+    Bench_AddInput(c, records * BENCH_ST_YOLOX_STRIDE * Bench_ElemSize(c));
+    for (size_t r = 0; r < records; r++) {
+      size_t i = r * BENCH_ST_YOLOX_STRIDE;
+      int hot = Bench_Hot(c);
+
+      Bench_Put(c, t, i + AI_YOLOV2_PP_XCENTER, Bench_Uniform(c, -2.0f, 2.0f), BENCH_ST_YOLOX_SCALE, 0);
+      Bench_Put(c, t, i + AI_YOLOV2_PP_YCENTER, Bench_Uniform(c, -2.0f, 2.0f), BENCH_ST_YOLOX_SCALE, 0);
+      Bench_Put(c, t, i + AI_YOLOV2_PP_WIDTHREL, Bench_Uniform(c, -1.0f, 1.0f), BENCH_ST_YOLOX_SCALE, 0);
+      Bench_Put(c, t, i + AI_YOLOV2_PP_HEIGHTREL, Bench_Uniform(c, -1.0f, 1.0f), BENCH_ST_YOLOX_SCALE, 0);
+      Bench_Put(c, t, i + AI_YOLOV2_PP_OBJECTNESS, hot ? Bench_Uniform(c, 1.0f, 4.0f) : Bench_Uniform(c, -8.0f, -2.0f),
+                BENCH_ST_YOLOX_SCALE, 0);
+      for (int k = 0; k < BENCH_ST_YOLOX_NB_CLASSES; k++) {
+        Bench_Put(c, t, i + AI_YOLOV2_PP_CLASSPROB + k, Bench_Uniform(c, -4.0f, 4.0f), BENCH_ST_YOLOX_SCALE, 0);
+      }
+    }
+  }
+  c->out = Bench_Alloc(BENCH_ST_YOLOX_MAX_CANDIDATES * sizeof(od_pp_outBuffer_t));
+
+  bench_st_yolox_params = (od_st_yolox_pp_static_param_t){
+      .nb_classes = BENCH_ST_YOLOX_NB_CLASSES,
+      .nb_anchors = BENCH_ST_YOLOX_NB_ANCHORS,
+      .grid_width_S = bench_st_yolox_grids[0],
+      .grid_height_S = bench_st_yolox_grids[0],
+      .grid_width_L = bench_st_yolox_grids[1],
+      .grid_height_L = bench_st_yolox_grids[1],
+      .grid_width_M = bench_st_yolox_grids[2],
+      .grid_height_M = bench_st_yolox_grids[2],
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .max_candidates = BENCH_ST_YOLOX_MAX_CANDIDATES,
+      .conf_threshold = 0.6f,
+      .iou_threshold = 0.5f,
+      .pAnchors_L = bench_st_yolox_anchors_l,
+      .pAnchors_M = bench_st_yolox_anchors_m,
+      .pAnchors_S = bench_st_yolox_anchors_s,
+      .raw_l_scale = BENCH_ST_YOLOX_SCALE,
+      .raw_m_scale = BENCH_ST_YOLOX_SCALE,
+      .raw_s_scale = BENCH_ST_YOLOX_SCALE,
+      .pLut = (c->pp->type == BENCH_S8) ? bench_st_yolox_lut : NULL,
+  };
+  od_st_yolox_pp_reset(&bench_st_yolox_params);
+}
+
+/* Masked: the top third of every level left out, a ceiling or a window */
+static uint8_t bench_st_yolox_cells[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_CELL_MASK_BYTES(60, 60)];
+static uint16_t bench_st_yolox_anchor_mask[AI_OD_ST_YOLOX_PP_NB_LEVELS]
+                                          [AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB(60, 60, BENCH_ST_YOLOX_NB_ANCHORS)];
+
+static void Bench_StYoloxMaskedSetup(bench_case_t *c) {
+  Bench_StYoloxSetup(c);
+  memset(bench_st_yolox_cells, 0, sizeof(bench_st_yolox_cells));
+  for (int t = 0; t < AI_OD_ST_YOLOX_PP_NB_LEVELS; t++) {
+    int level = bench_st_yolox_levels[t];
+    int32_t grid = bench_st_yolox_grids[t];
+
+    for (int32_t cell = 0; cell < grid * grid / 3; cell++) {
+      bench_st_yolox_cells[level][cell >> 3] |= (uint8_t)(1U << (cell & 7));
+    }
+    bench_st_yolox_params.pCellMask[level] = bench_st_yolox_cells[level];
+    bench_st_yolox_params.pAnchorMask[level] = bench_st_yolox_anchor_mask[level];
+  }
+  od_st_yolox_pp_reset(&bench_st_yolox_params);
+}
+
+static int32_t Bench_StYoloxRun(bench_case_t *c) {
+  od_st_yolox_pp_in_t in = {
+      .pRaw_detections_S = c->inputs[0],
+      .pRaw_detections_L = c->inputs[1],
+      .pRaw_detections_M = c->inputs[2],
+  };
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  bench_st_yolox_params.nb_detect = 0;
+  error = (c->pp->type == BENCH_F32) ? od_st_yolox_pp_process(&in, &out, &bench_st_yolox_params)
+                                     : od_st_yolox_pp_process_int8(&in, &out, &bench_st_yolox_params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* Split heads: the int8 scene, each level cut into the box, objectness and
+ * class tensors the convolutions give ahead of the Concat */
+static od_st_yolox_pp_lut_is8_t bench_st_yolox_heads_lut[AI_OD_ST_YOLOX_PP_HEADS_LUT_NB];
+
+static void Bench_StYoloxHeadsSetup(bench_case_t *c) {
+  void *concat[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+
+  Bench_StYoloxSetup(c);
+  memcpy(concat, c->inputs, sizeof(concat));
+  c->nb_inputs = 0;
+  for (int t = 0; t < AI_OD_ST_YOLOX_PP_NB_LEVELS; t++) {
+    size_t records = (size_t)bench_st_yolox_grids[t] * bench_st_yolox_grids[t] * BENCH_ST_YOLOX_NB_ANCHORS;
+    const int8_t *src = (const int8_t *)concat[t];
+    int8_t *box, *obj, *cls;
+
+    /* Three inputs per level, in AI_OD_ST_YOLOX_PP_HEAD_ order */
+    Bench_AddInput(c, records * AI_YOLOV2_PP_OBJECTNESS);
+    Bench_AddInput(c, records);
+    Bench_AddInput(c, records * BENCH_ST_YOLOX_NB_CLASSES);
+    box = (int8_t *)c->inputs[c->nb_inputs - 3];
+    obj = (int8_t *)c->inputs[c->nb_inputs - 2];
+    cls = (int8_t *)c->inputs[c->nb_inputs - 1];
+    for (size_t r = 0; r < records; r++) {
+      const int8_t *rec = &src[r * BENCH_ST_YOLOX_STRIDE];
+
+      memcpy(&box[r * AI_YOLOV2_PP_OBJECTNESS], &rec[AI_YOLOV2_PP_XCENTER], AI_YOLOV2_PP_OBJECTNESS);
+      obj[r] = rec[AI_YOLOV2_PP_OBJECTNESS];
+      memcpy(&cls[r * BENCH_ST_YOLOX_NB_CLASSES], &rec[AI_YOLOV2_PP_CLASSPROB], BENCH_ST_YOLOX_NB_CLASSES);
+    }
+    free(concat[t]);
+  }
+
+  /* One quantization for every tensor, as the concatenated scene has */
+  bench_st_yolox_params.split_heads = 1;
+  for (int l = 0; l < AI_OD_ST_YOLOX_PP_NB_LEVELS; l++) {
+    for (int h = 0; h < AI_OD_ST_YOLOX_PP_NB_HEADS; h++) {
+      bench_st_yolox_params.head_scale[l][h] = BENCH_ST_YOLOX_SCALE;
+      bench_st_yolox_params.head_zero_point[l][h] = 0;
+    }
+  }
+  bench_st_yolox_params.pLut = bench_st_yolox_heads_lut;
+  od_st_yolox_pp_reset(&bench_st_yolox_params);
+}
+
+static int32_t Bench_StYoloxHeadsRun(bench_case_t *c) {
+  od_st_yolox_pp_in_heads_t in;
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  for (int t = 0; t < AI_OD_ST_YOLOX_PP_NB_LEVELS; t++) {
+    in.level[bench_st_yolox_levels[t]] = (od_st_yolox_pp_head_in_t){
+        .pBox = c->inputs[3 * t + AI_OD_ST_YOLOX_PP_HEAD_BOX],
+        .pObj = c->inputs[3 * t + AI_OD_ST_YOLOX_PP_HEAD_OBJ],
+        .pCls = c->inputs[3 * t + AI_OD_ST_YOLOX_PP_HEAD_CLS],
+    };
+  }
+  bench_st_yolox_params.nb_detect = 0;
+  error = od_st_yolox_pp_process_heads_int8(&in, &out, &bench_st_yolox_params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* YOLOv8 -------------------------------------------------------------------- */
+
+#define BENCH_YOLOV8_SCALE (1.0f / 255.0f)
+#define BENCH_YOLOV8_ZERO_POINT (-128)
+
+static void Bench_Yolov8Setup(bench_case_t *c) {
+  const size_t n = BENCH_YOLOV8_NB_BOXES;
+
+  /* Channel-major: box coordinates, then one score row per class */
+  Bench_AddInput(c, (AI_YOLOV8_PP_CLASSPROB + BENCH_COCO_NB_CLASSES) * n * Bench_ElemSize(c));
+  for (size_t b = 0; b < n; b++) {
+    int hot = Bench_Hot(c);
+    int hot_class = (int)(Bench_Random(c) % BENCH_COCO_NB_CLASSES);
+
+    for (int k = 0; k < AI_YOLOV8_PP_CLASSPROB; k++) {
+      Bench_Put(c, 0, k * n + b, Bench_Uniform(c, 0.0f, 1.0f), BENCH_YOLOV8_SCALE, BENCH_YOLOV8_ZERO_POINT);
+    }
+    for (int k = 0; k < BENCH_COCO_NB_CLASSES; k++) {
+      float score = (hot && k == hot_class) ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.1f);
+
+      Bench_Put(c, 0, (AI_YOLOV8_PP_CLASSPROB + k) * n + b, score, BENCH_YOLOV8_SCALE, BENCH_YOLOV8_ZERO_POINT);
+    }
+  }
+  c->out = Bench_Alloc(n * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_Yolov8Run(bench_case_t *c) {
+  od_yolov8_pp_static_param_t params = {
+      .nb_classes = BENCH_COCO_NB_CLASSES,
+      .nb_total_boxes = BENCH_YOLOV8_NB_BOXES,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.5f,
+      .iou_threshold = 0.5f,
+      .raw_output_scale = BENCH_YOLOV8_SCALE,
+      .raw_output_zero_point = BENCH_YOLOV8_ZERO_POINT,
+  };
+  od_yolov8_pp_in_centroid_t in = {.pRaw_detections = c->inputs[0]};
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  od_yolov8_pp_reset(&params);
+  error = (c->pp->type == BENCH_F32) ? od_yolov8_pp_process(&in, &out, &params)
+                                     : od_yolov8_pp_process_int8(&in, &out, &params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* YOLOv5 -------------------------------------------------------------------- */
+
+#define BENCH_YOLOV5_STRIDE (AI_YOLOV5_PP_CLASSPROB + BENCH_COCO_NB_CLASSES)
+#define BENCH_YOLOV5_SCALE (1.0f / 255.0f)
+
+static void Bench_Yolov5Setup(bench_case_t *c) {
+  Bench_AddInput(c, (size_t)BENCH_YOLOV5_NB_BOXES * BENCH_YOLOV5_STRIDE * Bench_ElemSize(c));
+  for (size_t b = 0; b < BENCH_YOLOV5_NB_BOXES; b++) {
+    size_t i = b * BENCH_YOLOV5_STRIDE;
+    int hot = Bench_Hot(c);
+    int hot_class = (int)(Bench_Random(c) % BENCH_COCO_NB_CLASSES);
+
+    for (int k = 0; k < AI_YOLOV5_PP_CONFIDENCE; k++) {
+      Bench_Put(c, 0, i + k, Bench_Uniform(c, 0.0f, 1.0f), BENCH_YOLOV5_SCALE, 0);
+    }
+    Bench_Put(c, 0, i + AI_YOLOV5_PP_CONFIDENCE, hot ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.2f),
+              BENCH_YOLOV5_SCALE, 0);
+    for (int k = 0; k < BENCH_COCO_NB_CLASSES; k++) {
+      float score = (hot && k == hot_class) ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.1f);
+
+      Bench_Put(c, 0, i + AI_YOLOV5_PP_CLASSPROB + k, score, BENCH_YOLOV5_SCALE, 0);
+    }
+  }
+  c->out = Bench_Alloc(BENCH_YOLOV5_NB_BOXES * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_Yolov5Run(bench_case_t *c) {
+  od_yolov5_pp_static_param_t params = {
+      .nb_classes = BENCH_COCO_NB_CLASSES,
+      .nb_total_boxes = BENCH_YOLOV5_NB_BOXES,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.5f,
+      .iou_threshold = 0.5f,
+      .raw_output_scale = BENCH_YOLOV5_SCALE,
+      .raw_output_zero_point = 0,
+  };
+  od_yolov5_pp_in_centroid_t in = {.pRaw_detections = c->inputs[0]};
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  od_yolov5_pp_reset(&params);
+  error = od_yolov5_pp_process_uint8(&in, &out, &params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* YOLOv2 -------------------------------------------------------------------- */
+
+#define BENCH_YOLOV2_STRIDE (AI_YOLOV2_PP_CLASSPROB + BENCH_YOLOV2_NB_CLASSES)
+#define BENCH_YOLOV2_NB_BOXES (BENCH_YOLOV2_GRID * BENCH_YOLOV2_GRID * BENCH_YOLOV2_NB_ANCHORS)
+
+static void Bench_Yolov2Setup(bench_case_t *c) {
+  Bench_AddInput(c, (size_t)BENCH_YOLOV2_NB_BOXES * BENCH_YOLOV2_STRIDE * Bench_ElemSize(c));
+  for (size_t b = 0; b < BENCH_YOLOV2_NB_BOXES; b++) {
+    size_t i = b * BENCH_YOLOV2_STRIDE;
+    int hot = Bench_Hot(c);
+    int hot_class = (int)(Bench_Random(c) % BENCH_YOLOV2_NB_CLASSES);
+
+    for (int k = 0; k < AI_YOLOV2_PP_OBJECTNESS; k++) {
+      Bench_Put(c, 0, i + k, Bench_Uniform(c, -1.0f, 1.0f), 1.0f, 0);
+    }
+    Bench_Put(c, 0, i + AI_YOLOV2_PP_OBJECTNESS, hot ? Bench_Uniform(c, 2.0f, 6.0f) : Bench_Uniform(c, -8.0f, -2.0f),
+              1.0f, 0);
+    for (int k = 0; k < BENCH_YOLOV2_NB_CLASSES; k++) {
+      float logit = (hot && k == hot_class) ? Bench_Uniform(c, 6.0f, 8.0f) : Bench_Uniform(c, -2.0f, 2.0f);
+
+      Bench_Put(c, 0, i + AI_YOLOV2_PP_CLASSPROB + k, logit, 1.0f, 0);
+    }
+  }
+  c->scratch = Bench_Alloc(BENCH_YOLOV2_NB_BOXES * sizeof(od_pp_outBuffer_t));
+  c->out = Bench_Alloc(BENCH_YOLOV2_NB_BOXES * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_Yolov2Run(bench_case_t *c) {
+  od_yolov2_pp_static_param_t params = {
+      .nb_classes = BENCH_YOLOV2_NB_CLASSES,
+      .nb_anchors = BENCH_YOLOV2_NB_ANCHORS,
+      .grid_width = BENCH_YOLOV2_GRID,
+      .grid_height = BENCH_YOLOV2_GRID,
+      .nb_input_boxes = BENCH_YOLOV2_NB_BOXES,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.6f,
+      .iou_threshold = 0.3f,
+      .pAnchors = bench_yolov2_anchors,
+      .pScratchBuffer = c->scratch,
+  };
+  od_yolov2_pp_in_t in = {.pRaw_detections = c->inputs[0]};
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  od_yolov2_pp_reset(&params);
+  error = od_yolov2_pp_process(&in, &out, &params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* ST SSD -------------------------------------------------------------------- */
+
+#define BENCH_SSD_ST_SCORE_SCALE (1.0f / 255.0f)
+#define BENCH_SSD_ST_SCORE_ZP (-128)
+#define BENCH_SSD_ST_BOXE_SCALE (1.0f / 512.0f)
+#define BENCH_SSD_ST_ANCHOR_SCALE (1.0f / 255.0f)
+#define BENCH_SSD_ST_ANCHOR_ZP (-128)
+
+static void Bench_SsdStPrepare(bench_case_t *c) {
+  memcpy(c->scratch, c->inputs[0], c->sizes[0]);
+  memcpy((uint8_t *)c->scratch + c->sizes[0], c->inputs[1], c->sizes[1]);
+}
+
+static void Bench_SsdStSetup(bench_case_t *c) {
+  Bench_AddInput(c, (size_t)BENCH_SSD_ST_NB_ANCHORS * BENCH_SSD_ST_NB_CLASSES * Bench_ElemSize(c));
+  Bench_AddInput(c, (size_t)BENCH_SSD_ST_NB_ANCHORS * AI_SSD_ST_PP_BOX_STRIDE * Bench_ElemSize(c));
+  Bench_AddInput(c, (size_t)BENCH_SSD_ST_NB_ANCHORS * AI_SSD_ST_PP_BOX_STRIDE * Bench_ElemSize(c));
+  for (size_t a = 0; a < BENCH_SSD_ST_NB_ANCHORS; a++) {
+    float person = Bench_Hot(c) ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.4f);
+    float x = Bench_Uniform(c, 0.0f, 0.7f);
+    float y = Bench_Uniform(c, 0.0f, 0.7f);
+    float w = Bench_Uniform(c, 0.05f, 0.3f);
+    float h = Bench_Uniform(c, 0.05f, 0.3f);
+    size_t i = a * AI_SSD_ST_PP_BOX_STRIDE;
+
+    Bench_Put(c, 0, a * BENCH_SSD_ST_NB_CLASSES, 1.0f - person, BENCH_SSD_ST_SCORE_SCALE, BENCH_SSD_ST_SCORE_ZP);
+    Bench_Put(c, 0, a * BENCH_SSD_ST_NB_CLASSES + 1, person, BENCH_SSD_ST_SCORE_SCALE, BENCH_SSD_ST_SCORE_ZP);
+    for (int k = 0; k < AI_SSD_ST_PP_BOX_STRIDE; k++) {
+      Bench_Put(c, 1, i + k, Bench_Uniform(c, -0.2f, 0.2f), BENCH_SSD_ST_BOXE_SCALE, 0);
+    }
+    Bench_Put(c, 2, i + AI_SSD_ST_PP_XMIN, x, BENCH_SSD_ST_ANCHOR_SCALE, BENCH_SSD_ST_ANCHOR_ZP);
+    Bench_Put(c, 2, i + AI_SSD_ST_PP_YMIN, y, BENCH_SSD_ST_ANCHOR_SCALE, BENCH_SSD_ST_ANCHOR_ZP);
+    Bench_Put(c, 2, i + AI_SSD_ST_PP_XMAX, x + w, BENCH_SSD_ST_ANCHOR_SCALE, BENCH_SSD_ST_ANCHOR_ZP);
+    Bench_Put(c, 2, i + AI_SSD_ST_PP_YMAX, y + h, BENCH_SSD_ST_ANCHOR_SCALE, BENCH_SSD_ST_ANCHOR_ZP);
+  }
+  if (c->pp->type == BENCH_F32) {
+    /* Too few classes for the scores to hold the candidates: the float post
+     * processor works in place on scores and boxes, from a fresh copy (prepare) */
+    c->scratch = Bench_Alloc(c->sizes[0] + c->sizes[1]);
+    c->prepare = Bench_SsdStPrepare;
+  } else {
+    c->scratch = Bench_Alloc(BENCH_SSD_ST_NB_ANCHORS * sizeof(od_pp_outBuffer_t));
+  }
+  c->out = Bench_Alloc(BENCH_SSD_ST_NB_ANCHORS * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_SsdStRun(bench_case_t *c) {
+  od_ssd_st_pp_static_param_t params = {
+      .nb_classes = BENCH_SSD_ST_NB_CLASSES,
+      .nb_detections = BENCH_SSD_ST_NB_ANCHORS,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.6f,
+      .iou_threshold = 0.5f,
+      .boxe_scale = BENCH_SSD_ST_BOXE_SCALE,
+      .anchor_scale = BENCH_SSD_ST_ANCHOR_SCALE,
+      .score_scale = BENCH_SSD_ST_SCORE_SCALE,
+      .boxe_zero_point = 0,
+      .anchor_zero_point = BENCH_SSD_ST_ANCHOR_ZP,
+      .score_zero_point = BENCH_SSD_ST_SCORE_ZP,
+  };
+  od_ssd_st_pp_in_centroid_t in = {.pScores = c->inputs[0], .pBoxes = c->inputs[1], .pAnchors = c->inputs[2]};
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  if (c->pp->type == BENCH_F32) {
+    in.pScores = c->scratch;
+    in.pBoxes = (uint8_t *)c->scratch + c->sizes[0];
+  } else {
+    params.scratchBuffer = c->scratch;
+  }
+
+  od_ssd_st_pp_reset(&params);
+  error = (c->pp->type == BENCH_F32) ? od_ssd_st_pp_process(&in, &out, &params)
+                                     : od_ssd_st_pp_process_int8(&in, &out, &params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* BlazeFace ---------------------------------------------------------------- */
+
+#define BENCH_BLAZEFACE_STRIDE (AI_FD_BLAZEFACE_PP_KEYPOINTS + 2 * BENCH_BLAZEFACE_NB_KEYPOINTS)
+#define BENCH_BLAZEFACE_BOXE_SCALE 0.5f
+#define BENCH_BLAZEFACE_PROBA_SCALE 0.0625f
+
+static float32_t bench_blazeface_anchors_0[BENCH_BLAZEFACE_NB_0 * 2];
+static float32_t bench_blazeface_anchors_1[BENCH_BLAZEFACE_NB_1 * 2];
+
+static void Bench_BlazefaceAnchors(float32_t *pAnchors, int grid, int per_cell) {
+  for (int a = 0; a < grid * grid * per_cell; a++) {
+    int cell = a / per_cell;
+
+    pAnchors[2 * a] = ((float32_t)(cell % grid) + 0.5f) / (float32_t)grid;
+    pAnchors[2 * a + 1] = ((float32_t)(cell / grid) + 0.5f) / (float32_t)grid;
+  }
+}
+
+static void Bench_BlazefaceSetup(bench_case_t *c) {
+  static const int32_t nb[2] = {BENCH_BLAZEFACE_NB_0, BENCH_BLAZEFACE_NB_1};
+  int32_t zp = (c->pp->type == BENCH_U8) ? 128 : 0;
+
+  Bench_BlazefaceAnchors(bench_blazeface_anchors_0, 16, 2);
+  Bench_BlazefaceAnchors(bench_blazeface_anchors_1, 8, 6);
+  for (int l = 0; l < 2; l++) {
+    Bench_AddInput(c, (size_t)nb[l] * BENCH_BLAZEFACE_STRIDE * Bench_ElemSize(c));
+  }
+  for (int l = 0; l < 2; l++) {
+    Bench_AddInput(c, (size_t)nb[l] * Bench_ElemSize(c));
+  }
+  for (int l = 0; l < 2; l++) {
+    for (size_t a = 0; a < (size_t)nb[l]; a++) {
+      size_t i = a * BENCH_BLAZEFACE_STRIDE;
+      float side = Bench_Uniform(c, 8.0f, 48.0f);
+
+      Bench_Put(c, l, i + AI_FD_BLAZEFACE_PP_XCENTER, Bench_Uniform(c, -6.0f, 6.0f), BENCH_BLAZEFACE_BOXE_SCALE, zp);
+      Bench_Put(c, l, i + AI_FD_BLAZEFACE_PP_YCENTER, Bench_Uniform(c, -6.0f, 6.0f), BENCH_BLAZEFACE_BOXE_SCALE, zp);
+      Bench_Put(c, l, i + AI_FD_BLAZEFACE_PP_WIDTHREL, side, BENCH_BLAZEFACE_BOXE_SCALE, zp);
+      Bench_Put(c, l, i + AI_FD_BLAZEFACE_PP_HEIGHTREL, side * Bench_Uniform(c, 1.0f, 1.3f), BENCH_BLAZEFACE_BOXE_SCALE,
+                zp);
+      for (int k = AI_FD_BLAZEFACE_PP_KEYPOINTS; k < BENCH_BLAZEFACE_STRIDE; k++) {
+        Bench_Put(c, l, i + k, Bench_Uniform(c, -20.0f, 20.0f), BENCH_BLAZEFACE_BOXE_SCALE, zp);
+      }
+      Bench_Put(c, 2 + l, a, Bench_Hot(c) ? Bench_Uniform(c, 1.0f, 6.0f) : Bench_Uniform(c, -7.0f, -1.0f),
+                BENCH_BLAZEFACE_PROBA_SCALE, zp);
+    }
+  }
+  c->out = Bench_Alloc((BENCH_BLAZEFACE_NB_0 + BENCH_BLAZEFACE_NB_1) * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_BlazefaceRun(bench_case_t *c) {
+  uint8_t zp = (c->pp->type == BENCH_U8) ? 128 : 0;
+  od_fd_blazeface_pp_static_param_t params = {
+      .nb_classes = 1,
+      .nb_keypoints = BENCH_BLAZEFACE_NB_KEYPOINTS,
+      .nb_detections_0 = BENCH_BLAZEFACE_NB_0,
+      .nb_detections_1 = BENCH_BLAZEFACE_NB_1,
+      .in_size = BENCH_BLAZEFACE_IN_SIZE,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.6f,
+      .iou_threshold = 0.3f,
+      .pAnchors_0 = bench_blazeface_anchors_0,
+      .pAnchors_1 = bench_blazeface_anchors_1,
+      .boxe_0_scale = BENCH_BLAZEFACE_BOXE_SCALE,
+      .proba_0_scale = BENCH_BLAZEFACE_PROBA_SCALE,
+      .boxe_1_scale = BENCH_BLAZEFACE_BOXE_SCALE,
+      .proba_1_scale = BENCH_BLAZEFACE_PROBA_SCALE,
+      .boxe_0_zero_point = zp,
+      .proba_0_zero_point = zp,
+      .boxe_1_zero_point = zp,
+      .proba_1_zero_point = zp,
+  };
+  od_fd_blazeface_pp_in_t in = {
+      .pRawDetections_0 = c->inputs[0],
+      .pRawDetections_1 = c->inputs[1],
+      .pScores_0 = c->inputs[2],
+      .pScores_1 = c->inputs[3],
+  };
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  od_fd_blazeface_pp_reset(&params);
+  switch (c->pp->type) {
+  case BENCH_F32:
+    error = od_fd_blazeface_pp_process(&in, &out, &params);
+    break;
+  case BENCH_S8:
+    error = od_fd_blazeface_pp_process_int8(&in, &out, &params);
+    break;
+  default:
+    error = od_fd_blazeface_pp_process_uint8(&in, &out, &params);
+    break;
+  }
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* CenterNet ----------------------------------------------------------------- */
+
+#define BENCH_CENTERNET_STRIDE (AI_CENTERNET_PP_CLASSPROB + BENCH_COCO_NB_CLASSES + AI_CENTERNET_PP_MAPSEG_NEXTOFFSET)
+#define BENCH_CENTERNET_CELLS (BENCH_CENTERNET_GRID * BENCH_CENTERNET_GRID)
+#define BENCH_CENTERNET_SCALE (1.0f / 32.0f)
+
+static void Bench_CenternetPrepare(bench_case_t *c) {
+  memcpy(c->scratch, c->inputs[0], c->sizes[0]);
+}
+
+static void Bench_CenternetSetup(bench_case_t *c) {
+  size_t size = (size_t)BENCH_CENTERNET_CELLS * BENCH_CENTERNET_STRIDE * Bench_ElemSize(c);
+
+  Bench_AddInput(c, size);
+  for (size_t b = 0; b < BENCH_CENTERNET_CELLS; b++) {
+    size_t i = b * BENCH_CENTERNET_STRIDE;
+    int hot = Bench_Hot(c);
+    int hot_class = (int)(Bench_Random(c) % BENCH_COCO_NB_CLASSES);
+
+    Bench_Put(c, 0, i + AI_CENTERNET_PP_CONFCENTER, hot ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.4f),
+              BENCH_CENTERNET_SCALE, 0);
+    Bench_Put(c, 0, i + AI_CENTERNET_PP_WIDTH, Bench_Uniform(c, 0.5f, 3.5f), BENCH_CENTERNET_SCALE, 0);
+    Bench_Put(c, 0, i + AI_CENTERNET_PP_HEIGHT, Bench_Uniform(c, 0.5f, 3.5f), BENCH_CENTERNET_SCALE, 0);
+    Bench_Put(c, 0, i + AI_CENTERNET_PP_XOFFSET, Bench_Uniform(c, 0.0f, 1.0f), BENCH_CENTERNET_SCALE, 0);
+    Bench_Put(c, 0, i + AI_CENTERNET_PP_YOFFSET, Bench_Uniform(c, 0.0f, 1.0f), BENCH_CENTERNET_SCALE, 0);
+    for (int k = 0; k < BENCH_COCO_NB_CLASSES; k++) {
+      float score = (k == hot_class) ? Bench_Uniform(c, 0.6f, 1.0f) : Bench_Uniform(c, 0.0f, 0.1f);
+
+      Bench_Put(c, 0, i + AI_CENTERNET_PP_CLASSPROB + k, score, BENCH_CENTERNET_SCALE, 0);
+    }
+  }
+  /* The post processor works in place: each run takes a fresh copy (prepare) */
+  c->scratch = Bench_Alloc(size);
+  c->prepare = Bench_CenternetPrepare;
+  c->out = Bench_Alloc(BENCH_CENTERNET_CELLS * sizeof(od_pp_outBuffer_t));
+}
+
+static int32_t Bench_CenternetRun(bench_case_t *c) {
+  od_centernet_pp_static_param_t params = {
+      .nb_classifs = BENCH_COCO_NB_CLASSES,
+      .grid_width = BENCH_CENTERNET_GRID,
+      .grid_height = BENCH_CENTERNET_GRID,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.5f,
+      .iou_threshold = 0.5f,
+      .optim = AI_OD_CENTERNET_PP_OPTIM_NORMAL,
+      .raw_scale = BENCH_CENTERNET_SCALE,
+      .raw_zp = 0,
+  };
+  od_centernet_pp_in_t in = {.pRaw_detections = c->scratch};
+  od_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  od_centernet_pp_reset(&params);
+  error = od_centernet_pp_process_int8(&in, &out, &params);
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = (size_t)out.nb_detect * sizeof(od_pp_outBuffer_t);
+  return error;
+}
+
+/* YOLOv8 seg ---------------------------------------------------------------- */
+
+#define BENCH_ISEG_STRIDE (AI_YOLOV8_PP_CLASSPROB + BENCH_COCO_NB_CLASSES + BENCH_ISEG_NB_MASKS)
+#define BENCH_ISEG_MASK_PIXELS (BENCH_ISEG_MASK_SIZE * BENCH_ISEG_MASK_SIZE)
+#define BENCH_ISEG_MASK_BYTES (BENCH_MAX_BOXES_LIMIT * BENCH_ISEG_MASK_PIXELS)
+#define BENCH_ISEG_SCALE (1.0f / 128.0f)
+#define BENCH_ISEG_MASK_SCALE (1.0f / 32.0f)
+
+static iseg_yolov8_pp_scratchBuffer_s8_t bench_iseg_scratch[BENCH_ISEG_NB_BOXES];
+static int8_t bench_iseg_coefs[BENCH_ISEG_NB_BOXES * BENCH_ISEG_NB_MASKS];
+static int32_t bench_iseg_mask_tmp[BENCH_ISEG_NB_MASKS];
+
+/* Out: the masks, then the records pointing at them */
+static void Bench_IsegPrepare(bench_case_t *c) {
+  iseg_pp_outBuffer_t *pOut = (iseg_pp_outBuffer_t *)((uint8_t *)c->out + BENCH_ISEG_MASK_BYTES);
+
+  for (int d = 0; d < BENCH_MAX_BOXES_LIMIT; d++) {
+    pOut[d].pMask = (uint8_t *)c->out + d * BENCH_ISEG_MASK_PIXELS;
+  }
+}
+
+static void Bench_IsegSetup(bench_case_t *c) {
+  const size_t n = BENCH_ISEG_NB_BOXES;
+
+  /* Channel-major: box coordinates, class scores, then mask coefficients */
+  Bench_AddInput(c, BENCH_ISEG_STRIDE * n);
+  Bench_AddInput(c, (size_t)BENCH_ISEG_MASK_PIXELS * BENCH_ISEG_NB_MASKS);
+  for (size_t b = 0; b < n; b++) {
+    int hot = Bench_Hot(c);
+    int hot_class = (int)(Bench_Random(c) % BENCH_COCO_NB_CLASSES);
+
+    Bench_Put(c, 0, AI_YOLOV8_PP_XCENTER * n + b, Bench_Uniform(c, 0.1f, 0.9f), BENCH_ISEG_SCALE, 0);
+    Bench_Put(c, 0, AI_YOLOV8_PP_YCENTER * n + b, Bench_Uniform(c, 0.1f, 0.9f), BENCH_ISEG_SCALE, 0);
+    Bench_Put(c, 0, AI_YOLOV8_PP_WIDTHREL * n + b, Bench_Uniform(c, 0.05f, 0.4f), BENCH_ISEG_SCALE, 0);
+    Bench_Put(c, 0, AI_YOLOV8_PP_HEIGHTREL * n + b, Bench_Uniform(c, 0.05f, 0.4f), BENCH_ISEG_SCALE, 0);
+    for (int k = 0; k < BENCH_COCO_NB_CLASSES; k++) {
+      float score = (hot && k == hot_class) ? Bench_Uniform(c, 0.6f, 0.99f) : Bench_Uniform(c, 0.0f, 0.1f);
+
+      Bench_Put(c, 0, (AI_YOLOV8_PP_CLASSPROB + k) * n + b, score, BENCH_ISEG_SCALE, 0);
+    }
+    for (int k = 0; k < BENCH_ISEG_NB_MASKS; k++) {
+      Bench_Put(c, 0, (AI_YOLOV8_PP_CLASSPROB + BENCH_COCO_NB_CLASSES + k) * n + b, Bench_Uniform(c, -0.9f, 0.9f),
+                BENCH_ISEG_SCALE, 0);
+    }
+  }
+  /* Prototypes, pixel-major */
+  for (size_t i = 0; i < (size_t)BENCH_ISEG_MASK_PIXELS * BENCH_ISEG_NB_MASKS; i++) {
+    Bench_Put(c, 1, i, Bench_Uniform(c, -3.5f, 3.5f), BENCH_ISEG_MASK_SCALE, 3);
+  }
+  for (size_t b = 0; b < n; b++) {
+    bench_iseg_scratch[b].pMask = &bench_iseg_coefs[b * BENCH_ISEG_NB_MASKS];
+  }
+  c->out = Bench_Alloc(BENCH_ISEG_MASK_BYTES + BENCH_MAX_BOXES_LIMIT * sizeof(iseg_pp_outBuffer_t));
+  c->prepare = Bench_IsegPrepare;
+}
+
+static int32_t Bench_IsegRun(bench_case_t *c) {
+  iseg_yolov8_pp_static_param_t params = {
+      .nb_classes = BENCH_COCO_NB_CLASSES,
+      .nb_total_boxes = BENCH_ISEG_NB_BOXES,
+      .max_boxes_limit = BENCH_MAX_BOXES_LIMIT,
+      .conf_threshold = 0.5f,
+      .iou_threshold = 0.5f,
+      .nb_masks = BENCH_ISEG_NB_MASKS,
+      .size_masks = BENCH_ISEG_MASK_SIZE,
+      .raw_output_scale = BENCH_ISEG_SCALE,
+      .raw_output_zero_point = 0,
+      .mask_raw_output_scale = BENCH_ISEG_MASK_SCALE,
+      .mask_raw_output_zero_point = 3,
+      .pMask = bench_iseg_mask_tmp,
+      .pTmpBuff = bench_iseg_scratch,
+  };
+  iseg_yolov8_pp_in_centroid_t in = {.pRaw_detections = c->inputs[0], .pRaw_masks = c->inputs[1]};
+  iseg_pp_out_t out = {.pOutBuff = (iseg_pp_outBuffer_t *)((uint8_t *)c->out + BENCH_ISEG_MASK_BYTES)};
+  int32_t error;
+
+  iseg_yolov8_pp_reset(&params);
+  error = iseg_yolov8_pp_process_int8(&in, &out, &params);
+  /* Addresses stay out of the digest: prepare points the records back */
+  for (int32_t d = 0; d < out.nb_detect; d++) {
+    out.pOutBuff[d].pMask = NULL;
+  }
+  c->nb_detect = out.nb_detect;
+  c->out_bytes = BENCH_ISEG_MASK_BYTES + (size_t)out.nb_detect * sizeof(iseg_pp_outBuffer_t);
+  return error;
+}
+
+/* MoveNet ------------------------------------------------------------------- */
+
+static void Bench_MovenetSetup(bench_case_t *c) {
+  size_t n = (size_t)BENCH_MOVENET_HEATMAP * BENCH_MOVENET_HEATMAP * BENCH_MOVENET_KEYPOINTS;
+
+  Bench_AddInput(c, n * Bench_ElemSize(c));
+  for (size_t i = 0; i < n; i++) {
+    Bench_Put(c, 0, i, Bench_Uniform(c, 0.0f, 1.0f), 1.0f, 0);
+  }
+  c->out = Bench_Alloc(BENCH_MOVENET_KEYPOINTS * sizeof(spe_pp_outBuffer_t));
+}
+
+static int32_t Bench_MovenetRun(bench_case_t *c) {
+  spe_movenet_pp_static_param_t params = {
+      .heatmap_width = BENCH_MOVENET_HEATMAP,
+      .heatmap_height = BENCH_MOVENET_HEATMAP,
+      .nb_keypoints = BENCH_MOVENET_KEYPOINTS,
+  };
+  spe_movenet_pp_in_t in = {.inBuff = c->inputs[0]};
+  spe_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  spe_movenet_pp_reset(&params);
+  error = spe_movenet_pp_process(&in, &out, &params);
+  c->nb_detect = BENCH_MOVENET_KEYPOINTS;
+  c->out_bytes = BENCH_MOVENET_KEYPOINTS * sizeof(spe_pp_outBuffer_t);
+  return error;
+}
+
+/* DeepLabV3 ----------------------------------------------------------------- */
+
+#define BENCH_SSEG_PIXELS (BENCH_SSEG_SIZE * BENCH_SSEG_SIZE)
+
+static void Bench_SsegSetup(bench_case_t *c) {
+  size_t n = (size_t)BENCH_SSEG_PIXELS * BENCH_SSEG_NB_CLASSES;
+
+  Bench_AddInput(c, n * Bench_ElemSize(c));
+  for (size_t i = 0; i < n; i++) {
+    Bench_Put(c, 0, i, Bench_Uniform(c, -8.0f, 8.0f), BENCH_ST_YOLOX_SCALE, 0);
+  }
+  /* The argmax writes whole vectors */
+  c->out = Bench_Alloc(BENCH_SSEG_PIXELS + 16);
+}
+
+static int32_t Bench_SsegRun(bench_case_t *c) {
+  sseg_deeplabv3_pp_static_param_t params = {
+      .width = BENCH_SSEG_SIZE,
+      .height = BENCH_SSEG_SIZE,
+      .nb_classes = BENCH_SSEG_NB_CLASSES,
+  };
+  sseg_deeplabv3_pp_in_t in = {.pRawData = c->inputs[0]};
+  sseg_pp_out_t out = {.pOutBuff = c->out};
+  int32_t error;
+
+  sseg_deeplabv3_pp_reset(&params);
+  error = (c->pp->type == BENCH_F32) ? sseg_deeplabv3_pp_process(&in, &out, &params)
+                                     : sseg_deeplabv3_pp_process_int8(&in, &out, &params);
+  c->nb_detect = 0;
+  c->out_bytes = BENCH_SSEG_PIXELS;
+  return error;
+}
+
+/* Benchmarks ---------------------------------------------------------------- */
+
+static const bench_pp_t bench_st_yolox_f32 = {"od_st_yolox_f32", BENCH_F32, Bench_StYoloxSetup, Bench_StYoloxRun};
+static const bench_pp_t bench_st_yolox_s8 = {"od_st_yolox_s8", BENCH_S8, Bench_StYoloxSetup, Bench_StYoloxRun};
+static const bench_pp_t bench_st_yolox_uh_s8 = {"od_st_yolox_uh_s8", BENCH_S8, Bench_StYoloxHeadsSetup,
+                                                Bench_StYoloxHeadsRun};
+static const bench_pp_t bench_st_yolox_masked_f32 = {"od_st_yolox_masked_f32", BENCH_F32, Bench_StYoloxMaskedSetup,
+                                                     Bench_StYoloxRun};
+static const bench_pp_t bench_st_yolox_masked_s8 = {"od_st_yolox_masked_s8", BENCH_S8, Bench_StYoloxMaskedSetup,
+                                                    Bench_StYoloxRun};
+static const bench_pp_t bench_yolov8_f32 = {"od_yolov8_f32", BENCH_F32, Bench_Yolov8Setup, Bench_Yolov8Run};
+static const bench_pp_t bench_yolov8_s8 = {"od_yolov8_s8", BENCH_S8, Bench_Yolov8Setup, Bench_Yolov8Run};
+static const bench_pp_t bench_yolov5_u8 = {"od_yolov5_u8", BENCH_U8, Bench_Yolov5Setup, Bench_Yolov5Run};
+static const bench_pp_t bench_yolov2_f32 = {"od_yolov2_f32", BENCH_F32, Bench_Yolov2Setup, Bench_Yolov2Run};
+static const bench_pp_t bench_ssd_st_f32 = {"od_ssd_st_f32", BENCH_F32, Bench_SsdStSetup, Bench_SsdStRun};
+static const bench_pp_t bench_ssd_st_s8 = {"od_ssd_st_s8", BENCH_S8, Bench_SsdStSetup, Bench_SsdStRun};
+static const bench_pp_t bench_blazeface_f32 = {"od_fd_blazeface_f32", BENCH_F32, Bench_BlazefaceSetup,
+                                               Bench_BlazefaceRun};
+static const bench_pp_t bench_blazeface_s8 = {"od_fd_blazeface_s8", BENCH_S8, Bench_BlazefaceSetup, Bench_BlazefaceRun};
+static const bench_pp_t bench_blazeface_u8 = {"od_fd_blazeface_u8", BENCH_U8, Bench_BlazefaceSetup, Bench_BlazefaceRun};
+static const bench_pp_t bench_centernet_s8 = {"od_centernet_s8", BENCH_S8, Bench_CenternetSetup, Bench_CenternetRun};
+static const bench_pp_t bench_iseg_yolov8_s8 = {"iseg_yolov8_s8", BENCH_S8, Bench_IsegSetup, Bench_IsegRun};
+static const bench_pp_t bench_movenet_f32 = {"spe_movenet_f32", BENCH_F32, Bench_MovenetSetup, Bench_MovenetRun};
+static const bench_pp_t bench_sseg_f32 = {"sseg_deeplabv3_f32", BENCH_F32, Bench_SsegSetup, Bench_SsegRun};
+static const bench_pp_t bench_sseg_s8 = {"sseg_deeplabv3_s8", BENCH_S8, Bench_SsegSetup, Bench_SsegRun};
+
+#define BENCH_CASE(p, s, d) {.pp = &(p), .scene = (s), .density = (d)}
+#define BENCH_OD_SCENES(p) BENCH_CASE(p, "empty", 0.0f), BENCH_CASE(p, "sparse", 0.002f), BENCH_CASE(p, "crowded", 0.03f)
+
+static bench_case_t bench_cases[] = {
+    BENCH_OD_SCENES(bench_st_yolox_f32),
+    BENCH_OD_SCENES(bench_st_yolox_s8),
+    BENCH_OD_SCENES(bench_st_yolox_uh_s8),
+    BENCH_OD_SCENES(bench_st_yolox_masked_f32),
+    BENCH_OD_SCENES(bench_st_yolox_masked_s8),
+    BENCH_OD_SCENES(bench_yolov8_f32),
+    BENCH_OD_SCENES(bench_yolov8_s8),
+    BENCH_OD_SCENES(bench_yolov5_u8),
+    BENCH_OD_SCENES(bench_yolov2_f32),
+    BENCH_OD_SCENES(bench_ssd_st_f32),
+    BENCH_OD_SCENES(bench_ssd_st_s8),
+    BENCH_OD_SCENES(bench_blazeface_f32),
+    BENCH_OD_SCENES(bench_blazeface_s8),
+    BENCH_OD_SCENES(bench_blazeface_u8),
+    BENCH_OD_SCENES(bench_centernet_s8),
+    BENCH_OD_SCENES(bench_iseg_yolov8_s8),
+    BENCH_CASE(bench_movenet_f32, "random", 0.0f),
+    BENCH_CASE(bench_sseg_f32, "random", 0.0f),
+    BENCH_CASE(bench_sseg_s8, "random", 0.0f),
+};
+
+/* Outputs of the benchmarks, from this build (x86-64, GCC, Release): float
+ * results depend on the compiler and its flags, a mismatch elsewhere is
+ * not necessarily a regression */
+static const struct {
+  const char *name;
+  int32_t nb_detect;
+  uint64_t digest;
+} bench_golden[] = {
+    {"od_st_yolox_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_st_yolox_f32/sparse", 23, 0x038126ed7801102fULL},
+    {"od_st_yolox_f32/crowded", 100, 0xca8eae0635f45b31ULL},
+    {"od_st_yolox_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_st_yolox_s8/sparse", 23, 0x7332903d3d95d283ULL},
+    {"od_st_yolox_s8/crowded", 100, 0xc33b0efdaf61a63eULL},
+    {"od_st_yolox_masked_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_st_yolox_masked_f32/sparse", 14, 0x04882791936d317eULL},
+    {"od_st_yolox_masked_f32/crowded", 100, 0xaa5ae85432de1be6ULL},
+    {"od_st_yolox_masked_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_st_yolox_masked_s8/sparse", 14, 0x30ec1bc4807ae5c7ULL},
+    {"od_st_yolox_masked_s8/crowded", 100, 0xac2f2618df5d4aa3ULL},
+    {"od_yolov8_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_yolov8_f32/sparse", 19, 0x232396473ac22fc4ULL},
+    {"od_yolov8_f32/crowded", 232, 0x8f03f27470e41eecULL},
+    {"od_yolov8_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_yolov8_s8/sparse", 19, 0xd47acabc80b6625eULL},
+    {"od_yolov8_s8/crowded", 232, 0x93da6c3055dba395ULL},
+    {"od_yolov5_u8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_yolov5_u8/sparse", 44, 0xa6462dbe32889fd5ULL},
+    {"od_yolov5_u8/crowded", 710, 0x6e2321e5897ecb38ULL},
+    {"od_yolov2_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_yolov2_f32/sparse", 3, 0x50497ef75cdfc6e8ULL},
+    {"od_yolov2_f32/crowded", 17, 0xfaab24914743b9b0ULL},
+    {"od_ssd_st_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_ssd_st_f32/sparse", 2, 0x954ee32035df4ff3ULL},
+    {"od_ssd_st_f32/crowded", 33, 0x36a488be65b65ff2ULL},
+    {"od_ssd_st_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_ssd_st_s8/sparse", 2, 0x10ef9f29eb9a5fd0ULL},
+    {"od_ssd_st_s8/crowded", 33, 0x3c54988971424925ULL},
+    {"od_fd_blazeface_f32/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_fd_blazeface_f32/sparse", 4, 0x4ee49112161d66f1ULL},
+    {"od_fd_blazeface_f32/crowded", 22, 0x43aba87007e8882aULL},
+    {"od_fd_blazeface_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_fd_blazeface_s8/sparse", 4, 0xfd70789a833e7ef2ULL},
+    {"od_fd_blazeface_s8/crowded", 22, 0x1ab83c13c3a42a04ULL},
+    {"od_fd_blazeface_u8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_fd_blazeface_u8/sparse", 4, 0xfd70789a833e7ef2ULL},
+    {"od_fd_blazeface_u8/crowded", 22, 0x1ab83c13c3a42a04ULL},
+    {"od_centernet_s8/empty", 0, 0x4d25767f9dce13f5ULL},
+    {"od_centernet_s8/sparse", 27, 0x8b23a660f517c3c8ULL},
+    {"od_centernet_s8/crowded", 426, 0x0e7f962f095fd114ULL},
+    {"iseg_yolov8_s8/empty", 0, 0x545e1ec4c7fb13f5ULL},
+    {"iseg_yolov8_s8/sparse", 2, 0xd6748258881c2247ULL},
+    {"iseg_yolov8_s8/crowded", 45, 0x08b98c64743213f6ULL},
+    {"spe_movenet_f32/random", 17, 0xeebf97ae200a10fcULL},
+    {"sseg_deeplabv3_f32/random", 0, 0x9215f678e99f2323ULL},
+    {"sseg_deeplabv3_s8/random", 0, 0xc5f4f829fe5b32d1ULL},
+};
+
+/* Post processors checked against the golden values of another one */
+static const struct {
+  const char *name;
+  const char *golden;
+} bench_golden_alias[] = {
+    /* The split heads decode the same records as the concatenated tensors */
+    {"od_st_yolox_uh_s8", "od_st_yolox_s8"},
+};
+
+static uint64_t Bench_Digest(uint64_t h, const void *data, size_t size) {
+  const uint8_t *p = (const uint8_t *)data;
+
+  /* FNV-1a */
+  for (size_t i = 0; i < size; i++) {
+    h = (h ^ p[i]) * 0x100000001B3ULL;
+  }
+  return h;
+}
+
+/**
+ * @brief  Time iterations runs of a benchmark
+ * @retval Nanoseconds in the post processor
+ */
+static uint64_t Bench_Run(bench_case_t *c, uint64_t iterations) {
+  uint64_t total = 0;
+
+  memset(bench_stages.stage_ns, 0, sizeof(bench_stages.stage_ns));
+  bench_stages.staged = 0;
+
+  for (uint64_t it = 0; it < iterations; it++) {
+    uint64_t start;
+
+    memset(bench_stages.stamps, 0, sizeof(bench_stages.stamps));
+    if (c->prepare != NULL) {
+      c->prepare(c);
+    }
+
+    start = Bench_Now();
+    if (c->pp->run(c) != 0) {
+      fprintf(stderr, "%s/%s: post processing error\n", c->pp->name, c->scene);
+      exit(1);
+    }
+    total += Bench_Now() - start;
+
+    if (bench_stages.stamps[AI_OD_POSTPROCESS_STAGE_END] != 0) {
+      bench_stages.staged = 1;
+      for (int s = 0; s < AI_OD_POSTPROCESS_STAGE_END; s++) {
+        bench_stages.stage_ns[s] += bench_stages.stamps[s + 1] - bench_stages.stamps[s];
+      }
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief  Compare the last run with the golden values of golden
+ * @retval 1 if they match, 0 otherwise
+ */
+static int Bench_Check(const char *name, const char *golden, int32_t nb_detect, uint64_t digest) {
+  for (size_t i = 0; i < sizeof(bench_golden) / sizeof(bench_golden[0]); i++) {
+    if (strcmp(bench_golden[i].name, golden) != 0) {
+      continue;
+    }
+    if (bench_golden[i].nb_detect == nb_detect && bench_golden[i].digest == digest) {
+      return 1;
+    }
+    fprintf(stderr, "%s: %ld detections, digest %016llx; expected %ld, %016llx\n", name, (long)nb_detect,
+            (unsigned long long)digest, (long)bench_golden[i].nb_detect, (unsigned long long)bench_golden[i].digest);
+    return 0;
+  }
+  fprintf(stderr, "%s: no golden values\n", name);
+  return 0;
+}
+
+/**
+ * @retval 1 if the outputs match the golden values, 0 otherwise
+ */
+static int Bench_Case(bench_case_t *c, double min_time) {
+  uint64_t iterations = 1;
+  uint64_t total;
+  uint64_t digest;
+  char name[64];
+  char golden[64];
+  int match;
+
+  c->seed = 0x9E3779B9U;
+  c->nb_inputs = 0;
+  c->pp->setup(c);
+  for (int t = 0; t < c->nb_inputs; t++) {
+    c->pristine[t] = Bench_Alloc(c->sizes[t]);
+    memcpy(c->pristine[t], c->inputs[t], c->sizes[t]);
+  }
+
+  /* Grow the run until it lasts min_time, as Google Benchmark does */
+  for (;;) {
+    double seconds;
+
+    total = Bench_Run(c, iterations);
+    seconds = (double)total * 1e-9;
+    if (seconds >= min_time || iterations >= BENCH_MAX_ITERATIONS) {
+      break;
+    }
+    if (seconds <= 0.0) {
+      iterations *= 10;
+    } else {
+      double next = (double)iterations * min_time * 1.4 / seconds;
+
+      iterations = MIN((uint64_t)next + 1, iterations * 10);
+    }
+  }
+
+  for (int t = 0; t < c->nb_inputs; t++) {
+    if (memcmp(c->inputs[t], c->pristine[t], c->sizes[t]) != 0) {
+      fprintf(stderr, "%s/%s: input %d modified\n", c->pp->name, c->scene, t);
+      exit(1);
+    }
+  }
+
+  digest = Bench_Digest(0xCBF29CE484222325ULL, &c->nb_detect, sizeof(c->nb_detect));
+  digest = Bench_Digest(digest, c->out, c->out_bytes);
+
+  snprintf(name, sizeof(name), "%s/%s", c->pp->name, c->scene);
+  printf("%-30s %10llu %12.0f", name, (unsigned long long)iterations, (double)total / (double)iterations);
+  if (bench_stages.staged) {
+    for (int s = 0; s < AI_OD_POSTPROCESS_STAGE_END; s++) {
+      printf(" %12.0f", (double)bench_stages.stage_ns[s] / (double)iterations);
+    }
+  } else {
+    printf(" %12s %12s %12s", "-", "-", "-");
+  }
+  printf(" %6ld %016llx\n", (long)c->nb_detect, (unsigned long long)digest);
+  snprintf(golden, sizeof(golden), "%s", name);
+  for (size_t i = 0; i < sizeof(bench_golden_alias) / sizeof(bench_golden_alias[0]); i++) {
+    if (strcmp(bench_golden_alias[i].name, c->pp->name) == 0) {
+      snprintf(golden, sizeof(golden), "%s/%s", bench_golden_alias[i].golden, c->scene);
+    }
+  }
+  match = Bench_Check(name, golden, c->nb_detect, digest);
+
+  for (int t = 0; t < c->nb_inputs; t++) {
+    free(c->inputs[t]);
+    free(c->pristine[t]);
+  }
+  free(c->out);
+  free(c->scratch);
+  c->out = NULL;
+  c->scratch = NULL;
+  c->prepare = NULL;
+  return match;
+}
+
+int main(int argc, char **argv) {
+  const char *filter = NULL;
+  double min_time = BENCH_MIN_TIME_S;
+  int mismatches = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--benchmark_filter=", 19) == 0) {
+      filter = argv[i] + 19;
+    } else if (strncmp(argv[i], "--benchmark_min_time=", 21) == 0) {
+      min_time = atof(argv[i] + 21);
+    } else {
+      fprintf(stderr, "usage: %s [--benchmark_filter=<substring>] [--benchmark_min_time=<seconds>]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  printf("%-30s %10s %12s %12s %12s %12s %6s %s\n", "Benchmark", "Iterations", "Time (ns)", "Decode (ns)",
+         "NMS (ns)", "Score (ns)", "Det", "Digest");
+  for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+    bench_case_t *c = &bench_cases[i];
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s/%s", c->pp->name, c->scene);
+    if (filter != NULL && strstr(name, filter) == NULL) {
+      continue;
+    }
+    if (!Bench_Case(c, min_time)) {
+      mismatches++;
+    }
+  }
+  if (mismatches != 0) {
+    fprintf(stderr, "%d benchmark(s) off their golden outputs\n", mismatches);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#ifndef __DET_PP_IF_H__
+#define __DET_PP_IF_H__
+
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "od_pp_output_if.h"
+#include "mpe_pp_output_if.h"
+#include "iseg_pp_output_if.h"
+#include "pd_pp_output_if.h"
+
+/* Error return codes */
+#define AI_DET_PP_ERROR_NO      (0)
+#define AI_DET_PP_ERROR         (-1)
+
+/* track_id of a detection no tracker has claimed yet */
+#define AI_DET_PP_NO_TRACK      (0)
+
+/* Fixed-point formats of the record */
+#define AI_DET_PP_Q15_ONE       (32768.0f)
+#define AI_DET_PP_Q8_ONE        (256.0f)
+
+/*
+ * One packed detection record for every detector: the object detection,
+ * pose, instance segmentation and palm detection post processors all give
+ * the same 16-byte record through the adapters below, so that whatever
+ * consumes detections (tracker, overlay, telemetry, storage) reads one array.
+ * Keypoints and masks stay in the buffers of the post processor.
+ */
+
+
+/* I/O structures for packed detections */
+/* ------------------------------------ */
+typedef struct det_pp_record
+{
+  int16_t  x_center;      /* Q15, normalized: slightly out of frame boxes keep their sign */
+  int16_t  y_center;
+  int16_t  width;
+  int16_t  height;
+  uint8_t  conf;          /* Q8, saturated to 255 */
+  uint8_t  class_index;   /* Saturated to 255 */
+  uint16_t track_id;      /* AI_DET_PP_NO_TRACK until a tracker sets it */
+  uint32_t frame_id;
+} det_pp_record_t;
+
+typedef struct det_pp_out
+{
+  det_pp_record_t *pRecords;
+  int32_t nb_detect;
+} det_pp_out_t;
+
+
+/* Exported functions ------------------------------------------------------- */
+
+/*!
+ * @brief Packs object detection results
+ *
+ * @param [IN] Post processor output
+ *             Packed records, nb_detect entries: can be the pOutBuff array itself
+ *             Frame the detections were computed on
+ * @retval Error code
+ */
+int32_t det_pp_from_od(const od_pp_out_t *pInput,
+                       det_pp_out_t *pOutput,
+                       uint32_t frame_id);
+
+
+/*!
+ * @brief Packs the boxes of pose estimation results, keypoints left out
+ *
+ * @param [IN] Post processor output
+ *             Packed records, nb_detect entries: can be the pOutBuff array itself
+ *             Frame the detections were computed on
+ * @retval Error code
+ */
+int32_t det_pp_from_mpe(const mpe_pp_out_t *pInput,
+                        det_pp_out_t *pOutput,
+                        uint32_t frame_id);
+
+
+/*!
+ * @brief Packs the boxes of instance segmentation results, masks left out
+ *
+ * @param [IN] Post processor output
+ *             Packed records, nb_detect entries: can be the pOutBuff array itself
+ *             Frame the detections were computed on
+ * @retval Error code
+ */
+int32_t det_pp_from_iseg(const iseg_pp_out_t *pInput,
+                         det_pp_out_t *pOutput,
+                         uint32_t frame_id);
+
+
+/*!
+ * @brief Packs palm detection results as class 0, keypoints left out
+ *
+ * @param [IN] Post processor output
+ *             Packed records, box_nb entries: can be the pOutData array itself
+ *             Frame the detections were computed on
+ * @retval Error code
+ */
+int32_t det_pp_from_pd(const pd_pp_out_t *pInput,
+                       det_pp_out_t *pOutput,
+                       uint32_t frame_id);
+
+
+/*!
+ * @brief Unpacks records into float object detection results, for the
+ *        consumers still on od_pp_outBuffer_t
+ *
+ * @param [IN] Packed records
+ *             Float results, nb_detect entries: must not overlap the records
+ * @retval Error code
+ */
+int32_t det_pp_to_od(const det_pp_out_t *pInput,
+                     od_pp_out_t *pOutput);
+
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif      /* __DET_PP_IF_H__  */
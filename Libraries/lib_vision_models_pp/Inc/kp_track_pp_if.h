@@ -0,0 +1,130 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#ifndef __KP_TRACK_PP_IF_H__
+#define __KP_TRACK_PP_IF_H__
+
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "mpe_pp_output_if.h"
+
+/* Error return codes */
+#define AI_KP_TRACK_PP_ERROR_NO     (0)
+#define AI_KP_TRACK_PP_ERROR        (-1)
+
+/*
+ * Temporal keypoint tracking, for the pose and landmark models that run on a
+ * crop of the frame (YOLOv8 pose on one subject, hand landmarks after the palm
+ * detector). A detector seeds the region of interest once; from then on each
+ * frame's keypoints are smoothed with a One-Euro filter and give the region
+ * the model runs on next frame. The detector runs again only when the mean
+ * keypoint confidence drops below track_threshold (redetect in the output).
+ * Keypoints from a palm detector carry no confidence: set conf to 1.
+ */
+
+
+/* I/O structures for keypoint tracking */
+/* ------------------------------------ */
+typedef struct kp_track_pp_roi
+{
+  float32_t x_center;     /* Normalized to the frame */
+  float32_t y_center;
+  float32_t width;
+  float32_t height;
+} kp_track_pp_roi_t;
+
+typedef struct kp_track_pp_in
+{
+  const mpe_pp_keyPoints_t *pKeyPoints; /* [nb_keypoints], normalized to the ROI the model ran on */
+  float32_t timestamp;                  /* Of the frame, in seconds */
+} kp_track_pp_in_t;
+
+typedef struct kp_track_pp_out
+{
+  mpe_pp_keyPoints_t *pKeyPoints;       /* [nb_keypoints], filtered, normalized to the frame */
+  kp_track_pp_roi_t roi;                /* Where the model runs next frame */
+  int32_t redetect;                     /* Tracking lost: run the detector, then kp_track_pp_seed() */
+} kp_track_pp_out_t;
+
+/* One-Euro filter state of one keypoint */
+typedef struct kp_track_pp_filter
+{
+  float32_t x;
+  float32_t y;
+  float32_t dx;           /* Filtered speed, per second */
+  float32_t dy;
+} kp_track_pp_filter_t;
+
+
+/* Static parameters */
+/* ----------------- */
+typedef struct kp_track_pp_static_param
+{
+  int32_t   nb_keypoints;
+  float32_t min_cutoff;         /* Cutoff at rest, in Hz: lower for less jitter */
+  float32_t beta;               /* Cutoff growth with speed: higher for less lag */
+  float32_t d_cutoff;           /* Cutoff of the speed estimate, in Hz */
+  float32_t kp_conf_threshold;  /* Keypoints below do not shape the ROI */
+  float32_t track_threshold;    /* Mean keypoint confidence below which tracking is lost */
+  float32_t roi_scale;          /* ROI side over the extent of the keypoints or detected box */
+  float32_t aspect_ratio;       /* Frame width over height in pixels: the ROI is square in pixels */
+  kp_track_pp_filter_t *pFilters; /* [nb_keypoints] */
+  /* Internal */
+  int32_t   tracking;
+  int32_t   primed;             /* Filters hold a first sample */
+  float32_t timestamp;
+  kp_track_pp_roi_t roi;
+} kp_track_pp_static_param_t;
+
+
+/* Exported functions ------------------------------------------------------- */
+
+/*!
+ * @brief Resets keypoint tracking: not tracking until seeded
+ *
+ * @param [IN] Input static parameters
+ * @retval Error code
+ */
+int32_t kp_track_pp_reset(kp_track_pp_static_param_t *pInput_static_param);
+
+
+/*!
+ * @brief Starts tracking from a detected box (pose box, palm box): the ROI is
+ *        the box squared and grown by roi_scale, the filters start over
+ *
+ * @param [IN] Detected box, normalized to the frame
+ *             pointer on static parameters
+ * @retval Error code
+ */
+int32_t kp_track_pp_seed(const kp_track_pp_roi_t *pBox,
+                         kp_track_pp_static_param_t *pInput_static_param);
+
+
+/*!
+ * @brief Keypoint tracking : maps the keypoints of the model run on the ROI
+ *        back to the frame, filters them and propagates the ROI.
+ *
+ * @param [IN] Pointer on input data
+ *             Pointer on output data
+ *             pointer on static parameters
+ * @retval Error code, AI_KP_TRACK_PP_ERROR when not seeded
+ */
+int32_t kp_track_pp_process(kp_track_pp_in_t *pInput,
+                            kp_track_pp_out_t *pOutput,
+                            kp_track_pp_static_param_t *pInput_static_param);
+
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif      /* __KP_TRACK_PP_IF_H__  */
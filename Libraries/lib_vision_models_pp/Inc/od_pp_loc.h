@@ -16,6 +16,7 @@
 #endif
 
 #include "arm_math.h"
+#include "od_pp_output_if.h"
 
 /*-----------------------------     YOLO_V2      -----------------------------*/
 /* Offsets to access YoloV2 input data */
@@ -35,6 +36,10 @@
 #define AI_YOLOV8_PP_CLASSPROB    (4)
 #define AI_YOLOV8_PP_CLASSID      (5)
 #define AI_YOLOV8_PP_BOX_STRIDE   (4)
+/* Channel-major decode tile: this many bytes of every channel row are
+ * consumed before moving on. (4 + nb_classes) rows of it stay in a 32 KB
+ * L1 (10.5 KB for 80 classes), each row read as whole cache lines */
+#define AI_YOLOV8_PP_TILE_BYTES   (128)
 
 /*-----------------------------     YOLO_V4      -----------------------------*/
 /* Offsets to access YoloV4 input data */
@@ -94,6 +99,52 @@
 #define AI_FD_BLAZEFACE_PP_HEIGHTREL    (3)
 #define AI_FD_BLAZEFACE_PP_KEYPOINTS    (4)
 
+/*-------------------------   Quantized thresholds   -------------------------*/
+/*!
+ * @brief Smallest quantized value q with (q - zp) * scale >= value, i.e.
+ *        ceil(value / scale + zp), saturated to [q_min, q_max + 1] before the
+ *        conversion so an out-of-range threshold cannot wrap: q_max + 1 means
+ *        no input passes.
+ *
+ * @retval Threshold to compare the quantized inputs against with >=
+ */
+static inline int32_t od_pp_threshold_q(float32_t value, float32_t scale, int32_t zp,
+                                        int32_t q_min, int32_t q_max)
+{
+  float32_t q = ceilf(value / scale + zp);
+
+  if (q < (float32_t)q_min)
+  {
+    return q_min;
+  }
+  if (!(q <= (float32_t)q_max))
+  {
+    return q_max + 1;
+  }
+  return (int32_t)q;
+}
+
+/*-----------------------------       NMS        -----------------------------*/
+/* Shared per-class NMS on centroid boxes (od_pp_nms.c) */
+#define OD_PP_NMS_MAX_KEPT        (128)  /* Kept boxes per class held as SoA; past it, tested from the records */
+
+/*!
+ * @brief Per-class greedy NMS: one stable sort groups the boxes by decreasing class
+ *        and orders each class by decreasing confidence, ties in input order, then
+ *        each class is suppressed against its kept boxes only. Suppressed boxes
+ *        get conf = 0 in place: the array is left in the order the per-class qsort
+ *        passes of the original post-processors gave.
+ *        Reentrant: no global state.
+ *
+ * @retval Error code
+ */
+int32_t od_pp_nms_centroid(od_pp_outBuffer_t *pBoxes,
+                           int32_t nb_boxes,
+                           int32_t nb_classes,
+                           float32_t iou_threshold,
+                           int32_t max_boxes_limit);
+
+
 #ifdef __cplusplus
   }
 #endif
@@ -15,6 +15,15 @@
 #define AI_OD_POSTPROCESS_ERROR_BAD_HW   (-1)
 #define AI_OD_POSTPROCESS_ERROR          (-2)
 
+/* Stages of the object detector process functions. Define
+ * AI_OD_POSTPROCESS_STAGE_HOOK to the name of a void (int32_t) function to have
+ * it called as each stage starts, and with AI_OD_POSTPROCESS_STAGE_END once done */
+#define AI_OD_POSTPROCESS_STAGE_DECODE   (0)
+#define AI_OD_POSTPROCESS_STAGE_NMS      (1)
+#define AI_OD_POSTPROCESS_STAGE_SCORE    (2)
+#define AI_OD_POSTPROCESS_STAGE_END      (3)
+#define AI_OD_POSTPROCESS_STAGE_NB       (4)
+
 #ifdef __cplusplus
  extern "C" {
 #endif
@@ -40,6 +49,13 @@ typedef struct
 	int32_t nb_detect;
 } od_pp_out_t;
 
+#ifdef AI_OD_POSTPROCESS_STAGE_HOOK
+void AI_OD_POSTPROCESS_STAGE_HOOK(int32_t stage);
+#define AI_OD_POSTPROCESS_STAGE(stage)   AI_OD_POSTPROCESS_STAGE_HOOK(stage)
+#else
+#define AI_OD_POSTPROCESS_STAGE(stage)
+#endif
+
 
 #ifdef __cplusplus
   }
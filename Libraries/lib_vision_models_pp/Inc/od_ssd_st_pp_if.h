@@ -72,6 +72,20 @@ int32_t od_ssd_st_pp_process(od_ssd_st_pp_in_centroid_t *pInput,
                              od_ssd_st_pp_static_param_t *pInput_static_param);
 
 
+/*!
+ * @brief Object detector post processing : includes output detector remapping,
+ *        nms and score filtering for SSD, from int8 raw outputs.
+ *
+ * @param [IN] Pointer on input data
+ *             Pointer on output data
+ *             pointer on static parameters
+ * @retval Error code
+ */
+int32_t od_ssd_st_pp_process_int8(od_ssd_st_pp_in_centroid_t *pInput,
+                                  od_pp_out_t *pOutput,
+                                  od_ssd_st_pp_static_param_t *pInput_static_param);
+
+
 #ifdef __cplusplus
  }
 #endif
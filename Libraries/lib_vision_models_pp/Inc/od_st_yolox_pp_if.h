@@ -28,6 +28,56 @@ typedef struct od_st_yolox_pp_in
 } od_st_yolox_pp_in_t;
 
 
+/* Activations of one int8 output level, indexed by raw value - INT8_MIN */
+#define AI_OD_ST_YOLOX_PP_LUT_SIZE  (256)
+#define AI_OD_ST_YOLOX_PP_LUT_INDEX(q)  ((int32_t)(q) - INT8_MIN)
+
+/* Levels of pLut, in decode order */
+#define AI_OD_ST_YOLOX_PP_LEVEL_L   (0)
+#define AI_OD_ST_YOLOX_PP_LEVEL_M   (1)
+#define AI_OD_ST_YOLOX_PP_LEVEL_S   (2)
+#define AI_OD_ST_YOLOX_PP_NB_LEVELS (3)
+
+/* Tensors of a split level, in head_scale / head_zero_point order */
+#define AI_OD_ST_YOLOX_PP_HEAD_BOX  (0)
+#define AI_OD_ST_YOLOX_PP_HEAD_OBJ  (1)
+#define AI_OD_ST_YOLOX_PP_HEAD_CLS  (2)
+#define AI_OD_ST_YOLOX_PP_NB_HEADS  (3)
+
+/* Split heads: two tables per level in pLut, the box one (sigmoid and exp of
+ * the box quantization) and the score one (objectness sigmoid, class exp) */
+#define AI_OD_ST_YOLOX_PP_HEADS_LUT_NB          (2 * AI_OD_ST_YOLOX_PP_NB_LEVELS)
+#define AI_OD_ST_YOLOX_PP_HEADS_LUT_BOX(level)   (2 * (level))
+#define AI_OD_ST_YOLOX_PP_HEADS_LUT_SCORE(level) (2 * (level) + 1)
+
+/* Split heads of one level (int8), the convolution outputs before the
+ * level's Concat: box [cell][anchor][4], objectness [cell][anchor] and class
+ * scores [cell][anchor][nb_classes], cells row-major */
+typedef struct od_st_yolox_pp_head_in
+{
+  void* pBox;
+  void* pObj;
+  void* pCls;
+} od_st_yolox_pp_head_in_t;
+
+typedef struct od_st_yolox_pp_in_heads
+{
+  od_st_yolox_pp_head_in_t level[AI_OD_ST_YOLOX_PP_NB_LEVELS]; /* AI_OD_ST_YOLOX_PP_LEVEL_ order */
+} od_st_yolox_pp_in_heads_t;
+
+/* Cell masks: one bit per grid cell, LSB first, in the cell order of the
+ * output tensor (row-major); a set bit leaves the cell out of the decode */
+#define AI_OD_ST_YOLOX_PP_CELL_MASK_BYTES(w, h)  (((w) * (h) + 7) / 8)
+
+/* The per-anchor copy reset builds of one level, in whole 64-anchor blocks */
+#define AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB(w, h, a)  ((((w) * (h) * (a) + 63) / 64) * 4)
+
+typedef struct od_st_yolox_pp_lut_is8 {
+  float32_t sigmoid[AI_OD_ST_YOLOX_PP_LUT_SIZE]; /* Objectness and centre offsets */
+  float32_t exp[AI_OD_ST_YOLOX_PP_LUT_SIZE];     /* Width, height and class scores */
+} od_st_yolox_pp_lut_is8_t;
+
+
 
 /* Generic Static parameters */
 /* ------------------------- */
@@ -43,6 +93,9 @@ typedef struct od_st_yolox_pp_static_param {
   int32_t  grid_height_S;
   int32_t  nb_input_boxes;
   int32_t  max_boxes_limit;
+  int32_t  max_candidates;  /* Top-K bound on the candidates kept ahead of NMS, all classes together, 0 = every
+                               cell above threshold. Exact while no more cells pass the threshold; keep it at
+                               least nb_classes * max_boxes_limit (app default: 4x that) */
   float32_t	conf_threshold;
   float32_t	iou_threshold;
   const float32_t *pAnchors_L;
@@ -55,6 +108,21 @@ typedef struct od_st_yolox_pp_static_param {
   int8_t raw_l_zero_point;
   int8_t raw_m_zero_point;
   int8_t raw_s_zero_point;
+  /* 1: the input is split heads (od_st_yolox_pp_process_heads_int8), quantized
+   * per tensor as head_scale / head_zero_point [AI_OD_ST_YOLOX_PP_LEVEL_][AI_OD_ST_YOLOX_PP_HEAD_];
+   * the raw_ scales and zero points are then unused */
+  int32_t split_heads;
+  float32_t head_scale[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS];
+  int8_t head_zero_point[AI_OD_ST_YOLOX_PP_NB_LEVELS][AI_OD_ST_YOLOX_PP_NB_HEADS];
+  /* int8 decode tables, filled by od_st_yolox_pp_reset from the scales and zero
+   * points: AI_OD_ST_YOLOX_PP_NB_LEVELS, or AI_OD_ST_YOLOX_PP_HEADS_LUT_NB with
+   * split_heads. NULL: activations computed per cell */
+  od_st_yolox_pp_lut_is8_t *pLut;
+  /* Excluded cells of each level (AI_OD_ST_YOLOX_PP_LEVEL_), NULL: none. Read
+   * by od_st_yolox_pp_reset into pAnchorMask, AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB
+   * entries for the level grid, where the decode skips them before any activation */
+  const uint8_t *pCellMask[AI_OD_ST_YOLOX_PP_NB_LEVELS];
+  uint16_t *pAnchorMask[AI_OD_ST_YOLOX_PP_NB_LEVELS];
 } od_st_yolox_pp_static_param_t;
 
 
@@ -62,7 +130,9 @@ typedef struct od_st_yolox_pp_static_param {
 /* Exported functions ------------------------------------------------------- */
 
 /*!
- * @brief Resets object detection ST_YoloX post processing
+ * @brief Resets object detection ST_YoloX post processing, and builds the int8
+ *        decode tables when pLut is set and the anchor masks of the levels
+ *        with a cell mask
  *
  * @param [IN] Input static parameters
  * @retval Error code
@@ -96,6 +166,20 @@ int32_t od_st_yolox_pp_process_int8(od_st_yolox_pp_in_t *pInput,
                                     od_pp_out_t *pOutput,
                                     od_st_yolox_pp_static_param_t *pInput_static_param);
 
+/*!
+ * @brief Object detector post processing for ST_YoloX on the int8 split
+ *        heads of each level, read in place (split_heads set): no Concat of
+ *        the box, objectness and class tensors ahead of it
+ *
+ * @param [IN] Pointer on input data
+ *             Pointer on output data
+ *             pointer on static parameters
+ * @retval Error code
+ */
+int32_t od_st_yolox_pp_process_heads_int8(od_st_yolox_pp_in_heads_t *pInput,
+                                          od_pp_out_t *pOutput,
+                                          od_st_yolox_pp_static_param_t *pInput_static_param);
+
 
 
 
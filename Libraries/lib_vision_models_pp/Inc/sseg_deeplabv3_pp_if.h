@@ -46,6 +46,26 @@ typedef struct {
 int32_t sseg_deeplabv3_pp_reset(sseg_deeplabv3_pp_static_param_t *pInput_static_param);
 
 
+/*!
+ * @brief Builds the ARGB8888 color look-up table of a class index map
+ *
+ *        The argmax writes one class index per pixel (8 bits below 255
+ *        classes): that map is directly an L8 image, shown through this CLUT
+ *        by the DMA2D or LTDC instead of being expanded to RGB in software.
+ *
+ * @param [IN]  pColor_map: nb_classes RGB888 triplets
+ *              nb_classes: Classes of the model, at most 256
+ *              alpha: Alpha of every class color
+ *              transparent_class: Class given alpha 0 (background), -1 for none
+ *        [OUT] pClut: nb_classes ARGB8888 entries
+ * @retval Error code
+ */
+int32_t sseg_deeplabv3_pp_build_clut(const uint8_t *pColor_map,
+                                     uint32_t nb_classes,
+                                     uint8_t alpha,
+                                     int32_t transparent_class,
+                                     uint32_t *pClut);
+
 /*!
  * @brief semantic segmentation processing for DeepLabv3 model.
  *
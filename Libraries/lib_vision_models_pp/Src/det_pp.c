@@ -0,0 +1,167 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#include "det_pp_if.h"
+#include "vision_models_pp.h"
+#include <string.h>
+
+
+_Static_assert(sizeof(det_pp_record_t) == 16, "det_pp_record_t is one 16-byte record");
+
+/* Every float result is at least one record wide: packing in place runs forward */
+_Static_assert(sizeof(od_pp_outBuffer_t) >= sizeof(det_pp_record_t), "od_pp_outBuffer_t packs in place");
+_Static_assert(sizeof(mpe_pp_outBuffer_t) >= sizeof(det_pp_record_t), "mpe_pp_outBuffer_t packs in place");
+_Static_assert(sizeof(iseg_pp_outBuffer_t) >= sizeof(det_pp_record_t), "iseg_pp_outBuffer_t packs in place");
+_Static_assert(sizeof(pd_pp_box_t) >= sizeof(det_pp_record_t), "pd_pp_box_t packs in place");
+
+
+/* Rounded and saturated to [lo, hi] */
+static int32_t det_pp_fixed(float32_t value, float32_t one, float32_t lo, float32_t hi)
+{
+  float32_t q = MIN(MAX(value * one, lo), hi);
+
+  return (int32_t)(q + ((q >= 0) ? 0.5f : -0.5f));
+}
+
+/*
+ * One record from the fields of one result. The caller reads the whole
+ * result before this writes over it (in place packing), so the fields come
+ * by value.
+ */
+static void det_pp_pack(det_pp_record_t *pRecord,
+                        float32_t x_center,
+                        float32_t y_center,
+                        float32_t width,
+                        float32_t height,
+                        float32_t conf,
+                        int32_t class_index,
+                        uint32_t frame_id)
+{
+  det_pp_record_t record;
+
+  record.x_center    = (int16_t)det_pp_fixed(x_center, AI_DET_PP_Q15_ONE, INT16_MIN, INT16_MAX);
+  record.y_center    = (int16_t)det_pp_fixed(y_center, AI_DET_PP_Q15_ONE, INT16_MIN, INT16_MAX);
+  record.width       = (int16_t)det_pp_fixed(width, AI_DET_PP_Q15_ONE, INT16_MIN, INT16_MAX);
+  record.height      = (int16_t)det_pp_fixed(height, AI_DET_PP_Q15_ONE, INT16_MIN, INT16_MAX);
+  record.conf        = (uint8_t)det_pp_fixed(conf, AI_DET_PP_Q8_ONE, 0, UINT8_MAX);
+  record.class_index = (uint8_t)MIN(MAX(class_index, 0), UINT8_MAX);
+  record.track_id    = AI_DET_PP_NO_TRACK;
+  record.frame_id    = frame_id;
+
+  /* Byte copy: the record may sit over the result it came from */
+  memcpy(pRecord, &record, sizeof(record));
+}
+
+/* Packs nb results of one float type, each read whole before its record is written */
+#define DET_PP_PACK_ALL(type, pIn, nb, pOutput, frame_id, conf_field, class_expr)   \
+  do                                                                                 \
+  {                                                                                  \
+    for (int32_t i = 0; i < (nb); i++)                                               \
+    {                                                                                \
+      type result;                                                                   \
+                                                                                     \
+      memcpy(&result, &(pIn)[i], sizeof(result));                                    \
+      det_pp_pack(&(pOutput)->pRecords[i], result.x_center, result.y_center,         \
+                  result.width, result.height, result.conf_field, (class_expr),      \
+                  (frame_id));                                                       \
+    }                                                                                \
+    (pOutput)->nb_detect = (nb);                                                     \
+  } while (0)
+
+
+/* ----------------------       Exported routines      ---------------------- */
+
+int32_t det_pp_from_od(const od_pp_out_t *pInput,
+                       det_pp_out_t *pOutput,
+                       uint32_t frame_id)
+{
+  if ((pInput->nb_detect < 0) || (pOutput->pRecords == NULL))
+  {
+    return (AI_DET_PP_ERROR);
+  }
+
+  DET_PP_PACK_ALL(od_pp_outBuffer_t, pInput->pOutBuff, pInput->nb_detect, pOutput, frame_id,
+                  conf, result.class_index);
+
+  return (AI_DET_PP_ERROR_NO);
+}
+
+
+int32_t det_pp_from_mpe(const mpe_pp_out_t *pInput,
+                        det_pp_out_t *pOutput,
+                        uint32_t frame_id)
+{
+  if ((pInput->nb_detect < 0) || (pOutput->pRecords == NULL))
+  {
+    return (AI_DET_PP_ERROR);
+  }
+
+  DET_PP_PACK_ALL(mpe_pp_outBuffer_t, pInput->pOutBuff, pInput->nb_detect, pOutput, frame_id,
+                  conf, result.class_index);
+
+  return (AI_DET_PP_ERROR_NO);
+}
+
+
+int32_t det_pp_from_iseg(const iseg_pp_out_t *pInput,
+                         det_pp_out_t *pOutput,
+                         uint32_t frame_id)
+{
+  if ((pInput->nb_detect < 0) || (pOutput->pRecords == NULL))
+  {
+    return (AI_DET_PP_ERROR);
+  }
+
+  DET_PP_PACK_ALL(iseg_pp_outBuffer_t, pInput->pOutBuff, pInput->nb_detect, pOutput, frame_id,
+                  conf, result.class_index);
+
+  return (AI_DET_PP_ERROR_NO);
+}
+
+
+int32_t det_pp_from_pd(const pd_pp_out_t *pInput,
+                       det_pp_out_t *pOutput,
+                       uint32_t frame_id)
+{
+  if ((pInput->box_nb > INT32_MAX) || (pOutput->pRecords == NULL))
+  {
+    return (AI_DET_PP_ERROR);
+  }
+
+  DET_PP_PACK_ALL(pd_pp_box_t, pInput->pOutData, (int32_t)pInput->box_nb, pOutput, frame_id,
+                  prob, 0);
+
+  return (AI_DET_PP_ERROR_NO);
+}
+
+
+int32_t det_pp_to_od(const det_pp_out_t *pInput,
+                     od_pp_out_t *pOutput)
+{
+  if ((pInput->nb_detect < 0) || (pOutput->pOutBuff == NULL))
+  {
+    return (AI_DET_PP_ERROR);
+  }
+
+  for (int32_t i = 0; i < pInput->nb_detect; i++)
+  {
+    const det_pp_record_t *pRecord = &pInput->pRecords[i];
+    od_pp_outBuffer_t *pOut = &pOutput->pOutBuff[i];
+
+    pOut->x_center    = pRecord->x_center * (1.0f / AI_DET_PP_Q15_ONE);
+    pOut->y_center    = pRecord->y_center * (1.0f / AI_DET_PP_Q15_ONE);
+    pOut->width       = pRecord->width    * (1.0f / AI_DET_PP_Q15_ONE);
+    pOut->height      = pRecord->height   * (1.0f / AI_DET_PP_Q15_ONE);
+    pOut->conf        = pRecord->conf     * (1.0f / AI_DET_PP_Q8_ONE);
+    pOut->class_index = pRecord->class_index;
+  }
+  pOutput->nb_detect = pInput->nb_detect;
+
+  return (AI_DET_PP_ERROR_NO);
+}
@@ -9,48 +9,39 @@
 
 #include "iseg_yolov8_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 #include "iseg_pp_loc.h"
+#include <string.h>
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV8_SEG_PP_SORT_CLASS;
 
-static int32_t iseg_yolov8_nms_comparator_s8(const void *pa, const void *pb)
-{
-    iseg_yolov8_pp_scratchBuffer_s8_t a = *(iseg_yolov8_pp_scratchBuffer_s8_t *)pa;
-    iseg_yolov8_pp_scratchBuffer_s8_t b = *(iseg_yolov8_pp_scratchBuffer_s8_t *)pb;
-
-    int16_t diff = 0;
-    int8_t a_weighted_conf = -128;
-    int8_t b_weighted_conf = -128;
-
-    if (a.class_index == AI_YOLOV8_SEG_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
+/* Class k first, by decreasing confidence */
+#define ISEG_YOLOV8_PP_SORT_KEY_S8(p, k) (((p)->class_index == (k)) ? (p)->conf : INT8_MIN)
+VISION_MODELS_SORT_S8_DESC_DEFINE(iseg_yolov8_pp_sort_s8, iseg_yolov8_pp_scratchBuffer_s8_t, ISEG_YOLOV8_PP_SORT_KEY_S8)
 
-    if (b.class_index == AI_YOLOV8_SEG_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
+/* Kept boxes whose masks come out of one pass over the prototypes */
+#define ISEG_YOLOV8_PP_MASK_BATCH  (8)
 
-    diff = (int16_t)a_weighted_conf - (int16_t)b_weighted_conf;
+/* A kept box in the prototype x coefficient product */
+typedef struct
+{
+  const int8_t *pCoefs;       /* Raw mask coefficients [nb_masks] */
+  int32_t bias;               /* Per box terms of the product, less the mask threshold */
+  int32_t x0, x1, y0, y1;     /* Crop window in the mask grid, ends excluded */
+  uint8_t *pMask;
+} iseg_yolov8_pp_mask_box_t;
 
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
 
 static
 int32_t iseg_yolov8_pp_nmsFiltering_centroid_is8os8(iseg_yolov8_pp_static_param_t *pInput_static_param)
 {
   int32_t j, k, limit_counter, detections_per_class;//, limit_type;
+  int32_t iou_threshold_q16 = vision_models_iou_threshold_q16(pInput_static_param->iou_threshold);
   iseg_yolov8_pp_scratchBuffer_s8_t *pOutBuff_s8 = pInput_static_param->pTmpBuff;
 
     for (k = 0; k < pInput_static_param->nb_classes; ++k)
     {
         limit_counter = 0;
         detections_per_class = 0;
-        AI_YOLOV8_SEG_PP_SORT_CLASS = k;
 
 
         /* Counts the number of detections with class k */
@@ -65,10 +56,7 @@ int32_t iseg_yolov8_pp_nmsFiltering_centroid_is8os8(iseg_yolov8_pp_static_param_
         if (detections_per_class > 0)
         {
             /* Sorts detections based on class k */
-            qsort(pOutBuff_s8,
-                  pInput_static_param->nb_detect,
-                  sizeof(iseg_yolov8_pp_scratchBuffer_s8_t),
-                  iseg_yolov8_nms_comparator_s8);
+            iseg_yolov8_pp_sort_s8(pOutBuff_s8, pInput_static_param->nb_detect, k);
 
             for (int32_t i = 0; i < detections_per_class ; i ++)
             {
@@ -78,8 +66,7 @@ int32_t iseg_yolov8_pp_nmsFiltering_centroid_is8os8(iseg_yolov8_pp_static_param_
                 {
                     if (pOutBuff_s8[j].conf == -128) continue;
                     int8_t * b = &pOutBuff_s8[j].x_center;
-                    float32_t f_iou = vision_models_box_iou_is8(a, b, pInput_static_param->raw_output_zero_point);
-                    if (f_iou > pInput_static_param->iou_threshold)
+                    if (vision_models_box_iou_gt_is8(a, b, pInput_static_param->raw_output_zero_point, iou_threshold_q16))
                     {
                         pOutBuff_s8[j].conf = -128;
                     }
@@ -104,6 +91,118 @@ int32_t iseg_yolov8_pp_nmsFiltering_centroid_is8os8(iseg_yolov8_pp_static_param_
 
     return (AI_ISEG_POSTPROCESS_ERROR_NO);
 }
+/* Sum of n int8 values */
+static inline int32_t iseg_yolov8_pp_sum_is8(const int8_t *pIn, int32_t n)
+{
+  int32_t sum = 0;
+#ifdef VISION_MODELS_ISEG_YOLOV8_MASK_IS8_MVE
+  for (int32_t k = 0; k < n; k += 16)
+  {
+    sum = vaddvaq_s8(sum, vldrbq_z_s8(&pIn[k], vctp8q(n - k)));
+  }
+#else
+  for (int32_t k = 0; k < n; k++)
+  {
+    sum += pIn[k];
+  }
+#endif
+  return (sum);
+}
+
+/* Dot product of n int8 pairs */
+static inline int32_t iseg_yolov8_pp_dot_is8(const int8_t *pA, const int8_t *pB, int32_t n)
+{
+  int32_t sum = 0;
+#ifdef VISION_MODELS_ISEG_YOLOV8_MASK_IS8_MVE
+  for (int32_t k = 0; k < n; k += 16)
+  {
+    mve_pred16_t p = vctp8q(n - k);
+
+    sum = vmladavaq_s8(sum, vldrbq_z_s8(&pA[k], p), vldrbq_z_s8(&pB[k], p));
+  }
+#else
+  for (int32_t k = 0; k < n; k++)
+  {
+    sum += (int32_t)pA[k] * pB[k];
+  }
+#endif
+  return (sum);
+}
+
+/*
+ * Masks of up to ISEG_YOLOV8_PP_MASK_BATCH kept boxes in one pass over the
+ * prototypes: each prototype pixel is read once for all the boxes whose crop
+ * window holds it, and nothing is computed outside the windows.
+ * With c the raw coefficients and p the raw prototype pixel,
+ *   sum((c - raw_zp) * (p - mask_zp)) = dot(c, p) - raw_zp * sum(p) - mask_zp * sum(c - raw_zp)
+ * the last term is per box (bias), the middle one per pixel, so the inner
+ * product runs on the raw int8 values.
+ */
+static void iseg_yolov8_pp_masks_is8(const int8_t *pRaw_masks,
+                                     const iseg_yolov8_pp_mask_box_t *pBoxes,
+                                     int32_t nb_boxes,
+                                     const iseg_yolov8_pp_static_param_t *pInput_static_param)
+{
+  int32_t nb_masks   = pInput_static_param->nb_masks;
+  int32_t size_masks = pInput_static_param->size_masks;
+  int32_t raw_zp     = pInput_static_param->raw_output_zero_point;
+  int32_t y_min = size_masks, y_max = 0;
+
+  for (int32_t b = 0; b < nb_boxes; b++)
+  {
+    memset(pBoxes[b].pMask, 0, (size_t)size_masks * size_masks);
+    if (pBoxes[b].y0 < pBoxes[b].y1)
+    {
+      y_min = MIN(y_min, pBoxes[b].y0);
+      y_max = MAX(y_max, pBoxes[b].y1);
+    }
+  }
+
+  for (int32_t y = y_min; y < y_max; y++)
+  {
+    const iseg_yolov8_pp_mask_box_t *pRow[ISEG_YOLOV8_PP_MASK_BATCH];
+    int32_t nb_row = 0, x_min = size_masks, x_max = 0;
+
+    for (int32_t b = 0; b < nb_boxes; b++)
+    {
+      if ((pBoxes[b].y0 <= y) && (y < pBoxes[b].y1))
+      {
+        pRow[nb_row++] = &pBoxes[b];
+        x_min = MIN(x_min, pBoxes[b].x0);
+        x_max = MAX(x_max, pBoxes[b].x1);
+      }
+    }
+
+    for (int32_t x = x_min; x < x_max; x++)
+    {
+      int32_t pixel = y * size_masks + x;
+      const int8_t *pPixel = &pRaw_masks[pixel * nb_masks];
+      int32_t offset = raw_zp * iseg_yolov8_pp_sum_is8(pPixel, nb_masks);
+
+      for (int32_t r = 0; r < nb_row; r++)
+      {
+        if ((pRow[r]->x0 <= x) && (x < pRow[r]->x1))
+        {
+          int32_t sum = iseg_yolov8_pp_dot_is8(pRow[r]->pCoefs, pPixel, nb_masks) + pRow[r]->bias;
+
+          pRow[r]->pMask[pixel] = (sum >= offset) ? 1 : 0;
+        }
+      }
+    }
+  }
+}
+
+/* Crop window of a box along one axis of the mask grid, ends excluded */
+static void iseg_yolov8_pp_crop(float32_t center, float32_t size, int32_t size_masks,
+                                int32_t *pStart, int32_t *pEnd)
+{
+  float32_t start = floorf((center - size / 2) * size_masks);
+  float32_t end   = ceilf((center + size / 2) * size_masks);
+
+  *pStart = (int32_t)MIN(MAX(start, 0), size_masks);
+  *pEnd   = (int32_t)MIN(MAX(end, 0), size_masks);
+}
+
 static
 int32_t iseg_yolov8_pp_scoreFiltering_centroid_is8(iseg_yolov8_pp_in_centroid_t *pInput,
                                                    iseg_pp_out_t *pOutput,
@@ -111,9 +210,13 @@ int32_t iseg_yolov8_pp_scoreFiltering_centroid_is8(iseg_yolov8_pp_in_centroid_t
 {
   int32_t det_count = 0;
   iseg_yolov8_pp_scratchBuffer_s8_t *pOutBuff_s8 = pInput_static_param->pTmpBuff;
+  iseg_yolov8_pp_mask_box_t boxes[ISEG_YOLOV8_PP_MASK_BATCH];
+  int32_t nb_boxes = 0;
   pOutput->nb_detect = MIN(pInput_static_param->nb_detect, pInput_static_param->max_boxes_limit);
 
   // get masks
+  int32_t nb_masks     = pInput_static_param->nb_masks;
+  int32_t size_masks   = pInput_static_param->size_masks;
   int8_t mask_zp       = pInput_static_param->mask_raw_output_zero_point;
   float32_t mask_scale = pInput_static_param->mask_raw_output_scale;
   int8_t raw_zp        = pInput_static_param->raw_output_zero_point;
@@ -123,87 +226,46 @@ int32_t iseg_yolov8_pp_scoreFiltering_centroid_is8(iseg_yolov8_pp_in_centroid_t
   float32_t threshold_check = 0.5f / (mask_scale * raw_scale);
   int32_t threshold_check_s32 = (int32_t)(threshold_check+0.5f);
 
-#ifdef ARM_MATH_MVEF
-  uint32x4_t offset = vidupq_n_u32(0,1);
-  offset *= (uint32_t)pInput_static_param->nb_masks;
-#endif
-
   for (int32_t d = 0; d < pInput_static_param->nb_detect; d++)
   {
     if (pOutBuff_s8[d].conf >= threshold_s8 && det_count < pInput_static_param->max_boxes_limit)
     {
-      int32_t *detection_mask = (int32_t *)pInput_static_param->pMask;
-      uint8_t *binary_mask    = pOutput->pOutBuff[det_count].pMask;
-      int8_t  *Raw_masks      = pInput->pRaw_masks;//(64x64x32)
-
-      pOutput->pOutBuff[det_count].x_center    = ((int32_t)pOutBuff_s8[d].x_center - raw_zp) * raw_scale;
-      pOutput->pOutBuff[det_count].y_center    = ((int32_t)pOutBuff_s8[d].y_center - raw_zp) * raw_scale;
-      pOutput->pOutBuff[det_count].width       = ((int32_t)pOutBuff_s8[d].width    - raw_zp) * raw_scale;
-      pOutput->pOutBuff[det_count].height      = ((int32_t)pOutBuff_s8[d].height   - raw_zp) * raw_scale;
-      pOutput->pOutBuff[det_count].conf        = ((int32_t)pOutBuff_s8[d].conf     - raw_zp) * raw_scale;
-      pOutput->pOutBuff[det_count].class_index =  (int32_t)pOutBuff_s8[d].class_index;
-
-      for (int32_t k = 0; k < pInput_static_param->nb_masks ; k++)
+      iseg_pp_outBuffer_t *pDet = &pOutput->pOutBuff[det_count];
+      iseg_yolov8_pp_mask_box_t *pBox = &boxes[nb_boxes];
+      int32_t coef_sum;
+
+      pDet->x_center    = ((int32_t)pOutBuff_s8[d].x_center - raw_zp) * raw_scale;
+      pDet->y_center    = ((int32_t)pOutBuff_s8[d].y_center - raw_zp) * raw_scale;
+      pDet->width       = ((int32_t)pOutBuff_s8[d].width    - raw_zp) * raw_scale;
+      pDet->height      = ((int32_t)pOutBuff_s8[d].height   - raw_zp) * raw_scale;
+      pDet->conf        = ((int32_t)pOutBuff_s8[d].conf     - raw_zp) * raw_scale;
+      pDet->class_index =  (int32_t)pOutBuff_s8[d].class_index;
+
+      /* Mask pixels outside the box are background */
+      iseg_yolov8_pp_crop(pDet->x_center, pDet->width, size_masks, &pBox->x0, &pBox->x1);
+      iseg_yolov8_pp_crop(pDet->y_center, pDet->height, size_masks, &pBox->y0, &pBox->y1);
+      if (pBox->x0 >= pBox->x1)
       {
-        detection_mask[k] = ((int32_t)pOutBuff_s8[d].pMask[k] - raw_zp);
+        pBox->y1 = pBox->y0;
       }
 
-      // Perform matrix multiplication
-      for (int32_t i = 0; i < pInput_static_param->size_masks; i++)
+      coef_sum    = iseg_yolov8_pp_sum_is8(pOutBuff_s8[d].pMask, nb_masks) - nb_masks * raw_zp;
+      pBox->bias  = -(int32_t)mask_zp * coef_sum - threshold_check_s32;
+      pBox->pCoefs = pOutBuff_s8[d].pMask;
+      pBox->pMask  = pDet->pMask;
+
+      if (++nb_boxes == ISEG_YOLOV8_PP_MASK_BATCH)
       {
-#ifdef ARM_MATH_MVEF
-          int32_t iter_loop = pInput_static_param->size_masks >> 2;
-          while(iter_loop--)
-          {
-            // Read for 4 ouputs
-              int32x4_t sum_product_s32x4 = vdupq_n_s32(0);
-
-              for (int32_t k = 0; k < pInput_static_param->nb_masks ; k++)
-              {
-                // Load 4 int8_t in int32x4_t register
-                int32x4_t rawMask = vldrbq_gather_offset_s32(Raw_masks, offset);
-                sum_product_s32x4 += detection_mask[k] * (rawMask - (int32_t)mask_zp);
-
-                Raw_masks++;
-              }
-              // Compare and store 4 results
-              mve_pred16_t p0 = vcmpgeq_n_s32(sum_product_s32x4, threshold_check_s32);
-              uint32x4_t outBinary = vpselq_u32(vdupq_n_u32(1), vdupq_n_u32(0), p0);
-              vstrbq_u32(binary_mask, outBinary);
-
-              binary_mask+=4;
-              Raw_masks+=3*pInput_static_param->nb_masks;
-          }
-          // Remaining
-          iter_loop = pInput_static_param->size_masks & 3;
-          while(iter_loop--)
-          {
-              int32_t sum_product = 0;
-              for (int32_t k = 0; k < pInput_static_param->nb_masks; k++)
-              {
-                sum_product += detection_mask[k] * ((int32_t)(*Raw_masks) - (int32_t)mask_zp);
-
-                Raw_masks++;
-              }
-              *binary_mask++ = (sum_product >= threshold_check_s32)?1:0;
-          }
-#else
-          for (int32_t j = 0; j < pInput_static_param->size_masks; j++)
-          {
-              int32_t sum_product = 0;
-              for (int32_t k = 0; k < pInput_static_param->nb_masks ; k++)
-              {
-                sum_product += detection_mask[k] * ((int32_t)(*Raw_masks) - (int32_t)mask_zp);
-
-                Raw_masks++;
-              }
-              *binary_mask++ = (sum_product >= threshold_check_s32)?1:0;
-          }
-#endif
+        iseg_yolov8_pp_masks_is8(pInput->pRaw_masks, boxes, nb_boxes, pInput_static_param);
+        nb_boxes = 0;
       }
       det_count++;
     }
   }
+  if (nb_boxes > 0)
+  {
+    iseg_yolov8_pp_masks_is8(pInput->pRaw_masks, boxes, nb_boxes, pInput_static_param);
+  }
 
   pOutput->nb_detect = det_count;
 
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#include "kp_track_pp_if.h"
+#include "vision_models_pp.h"
+#include <float.h>
+
+
+/* Shortest frame interval the filters take, in seconds: repeated timestamps */
+#define KP_TRACK_PP_MIN_DT      (1.0e-3f)
+
+/* Confident keypoints it takes to place the ROI */
+#define KP_TRACK_PP_MIN_KEYPOINTS (2)
+
+
+/* Smoothing factor of a first order low-pass at cutoff Hz, over dt seconds */
+static float32_t kp_track_pp_alpha(float32_t cutoff, float32_t dt)
+{
+  float32_t tau = 1.0f / (2.0f * PI * cutoff);
+
+  return 1.0f / (1.0f + tau / dt);
+}
+
+/* One-Euro step: the cutoff follows the filtered speed, jitter at rest, no lag in motion */
+static void kp_track_pp_one_euro(float32_t *pValue,
+                                 float32_t *pSpeed,
+                                 float32_t sample,
+                                 float32_t dt,
+                                 const kp_track_pp_static_param_t *pInput_static_param)
+{
+  float32_t speed = (sample - *pValue) / dt;
+  float32_t cutoff;
+
+  *pSpeed += kp_track_pp_alpha(pInput_static_param->d_cutoff, dt) * (speed - *pSpeed);
+  cutoff = pInput_static_param->min_cutoff + pInput_static_param->beta * fabsf(*pSpeed);
+  *pValue += kp_track_pp_alpha(cutoff, dt) * (sample - *pValue);
+}
+
+/* ROI around a box: square in pixels, grown by roi_scale */
+static void kp_track_pp_set_roi(kp_track_pp_static_param_t *pInput_static_param,
+                                float32_t x_center,
+                                float32_t y_center,
+                                float32_t width,
+                                float32_t height)
+{
+  float32_t aspect = pInput_static_param->aspect_ratio;
+  float32_t side = MAX(width * aspect, height) * pInput_static_param->roi_scale;
+
+  pInput_static_param->roi.x_center = x_center;
+  pInput_static_param->roi.y_center = y_center;
+  pInput_static_param->roi.width    = side / aspect;
+  pInput_static_param->roi.height   = side;
+}
+
+
+/* ----------------------       Exported routines      ---------------------- */
+
+int32_t kp_track_pp_reset(kp_track_pp_static_param_t *pInput_static_param)
+{
+  if (   (pInput_static_param->nb_keypoints <= 0)
+      || (pInput_static_param->pFilters == NULL)
+      || (pInput_static_param->min_cutoff <= 0)
+      || (pInput_static_param->d_cutoff <= 0)
+      || (pInput_static_param->aspect_ratio <= 0))
+  {
+    return (AI_KP_TRACK_PP_ERROR);
+  }
+
+  pInput_static_param->tracking = 0;
+  pInput_static_param->primed = 0;
+
+  return (AI_KP_TRACK_PP_ERROR_NO);
+}
+
+
+int32_t kp_track_pp_seed(const kp_track_pp_roi_t *pBox,
+                         kp_track_pp_static_param_t *pInput_static_param)
+{
+  if ((pBox->width <= 0) || (pBox->height <= 0))
+  {
+    return (AI_KP_TRACK_PP_ERROR);
+  }
+
+  kp_track_pp_set_roi(pInput_static_param, pBox->x_center, pBox->y_center, pBox->width, pBox->height);
+  pInput_static_param->tracking = 1;
+  pInput_static_param->primed = 0;
+
+  return (AI_KP_TRACK_PP_ERROR_NO);
+}
+
+
+int32_t kp_track_pp_process(kp_track_pp_in_t *pInput,
+                            kp_track_pp_out_t *pOutput,
+                            kp_track_pp_static_param_t *pInput_static_param)
+{
+  const mpe_pp_keyPoints_t *pIn = pInput->pKeyPoints;
+  mpe_pp_keyPoints_t *pOut = pOutput->pKeyPoints;
+  kp_track_pp_filter_t *pFilters = pInput_static_param->pFilters;
+  kp_track_pp_roi_t roi = pInput_static_param->roi;
+  int32_t nb_keypoints = pInput_static_param->nb_keypoints;
+  float32_t dt = MAX(pInput->timestamp - pInput_static_param->timestamp, KP_TRACK_PP_MIN_DT);
+  float32_t conf_sum = 0;
+  float32_t x_min = FLT_MAX, y_min = FLT_MAX, x_max = -FLT_MAX, y_max = -FLT_MAX;
+  int32_t nb_confident = 0;
+
+  if (!pInput_static_param->tracking)
+  {
+    return (AI_KP_TRACK_PP_ERROR);
+  }
+
+  for (int32_t i = 0; i < nb_keypoints; i++)
+  {
+    /* From the ROI the model ran on to the frame */
+    float32_t x = roi.x_center + (pIn[i].x - 0.5f) * roi.width;
+    float32_t y = roi.y_center + (pIn[i].y - 0.5f) * roi.height;
+
+    if (pInput_static_param->primed)
+    {
+      kp_track_pp_one_euro(&pFilters[i].x, &pFilters[i].dx, x, dt, pInput_static_param);
+      kp_track_pp_one_euro(&pFilters[i].y, &pFilters[i].dy, y, dt, pInput_static_param);
+    }
+    else
+    {
+      pFilters[i].x  = x;
+      pFilters[i].y  = y;
+      pFilters[i].dx = 0;
+      pFilters[i].dy = 0;
+    }
+
+    pOut[i].x    = pFilters[i].x;
+    pOut[i].y    = pFilters[i].y;
+    pOut[i].conf = pIn[i].conf;
+    conf_sum += pIn[i].conf;
+
+    if (pIn[i].conf >= pInput_static_param->kp_conf_threshold)
+    {
+      x_min = MIN(x_min, pOut[i].x);
+      y_min = MIN(y_min, pOut[i].y);
+      x_max = MAX(x_max, pOut[i].x);
+      y_max = MAX(y_max, pOut[i].y);
+      nb_confident++;
+    }
+  }
+  pInput_static_param->primed = 1;
+  pInput_static_param->timestamp = pInput->timestamp;
+
+  /* Lost: the subject left, turned away or got occluded */
+  if (   (conf_sum < pInput_static_param->track_threshold * nb_keypoints)
+      || (nb_confident < KP_TRACK_PP_MIN_KEYPOINTS)
+      || ((x_max - x_min) + (y_max - y_min) <= 0))
+  {
+    pInput_static_param->tracking = 0;
+    pOutput->roi = roi;
+    pOutput->redetect = 1;
+    return (AI_KP_TRACK_PP_ERROR_NO);
+  }
+
+  kp_track_pp_set_roi(pInput_static_param,
+                      (x_min + x_max) / 2,
+                      (y_min + y_max) / 2,
+                      x_max - x_min,
+                      y_max - y_min);
+
+  /* Out of the frame */
+  roi = pInput_static_param->roi;
+  if (   (roi.x_center < 0) || (roi.x_center > 1.0f)
+      || (roi.y_center < 0) || (roi.y_center > 1.0f))
+  {
+    pInput_static_param->tracking = 0;
+  }
+
+  pOutput->roi = roi;
+  pOutput->redetect = !pInput_static_param->tracking;
+
+  return (AI_KP_TRACK_PP_ERROR_NO);
+}
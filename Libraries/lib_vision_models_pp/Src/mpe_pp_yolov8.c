@@ -10,79 +10,19 @@
 #include "od_pp_loc.h"
 #include "mpe_yolov8_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV8_POSE_PP_SORT_CLASS;
 
 
-int32_t mpe_yolov8_nms_comparator(const void *pa, const void *pb)
-{
-    mpe_pp_outBuffer_t a = *(mpe_pp_outBuffer_t *)pa;
-    mpe_pp_outBuffer_t b = *(mpe_pp_outBuffer_t *)pb;
-
-    float32_t diff = 0.0;
-    float32_t a_weighted_conf = 0.0;
-    float32_t b_weighted_conf = 0.0;
-
-    if (a.class_index == AI_YOLOV8_POSE_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
-    {
-         a_weighted_conf = 0.0;
-    }
-
-    if (b.class_index == AI_YOLOV8_POSE_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
-    else
-    {
-         b_weighted_conf = 0.0;
-    }
-
-    diff = a_weighted_conf - b_weighted_conf;
-
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
-
-int32_t mpe_yolov8_nms_comparator_is8(const void *pa, const void *pb)
-{
-    mpe_pp_scratchBuffer_s8_t a = *(mpe_pp_scratchBuffer_s8_t *)pa;
-    mpe_pp_scratchBuffer_s8_t b = *(mpe_pp_scratchBuffer_s8_t *)pb;
-
-    int32_t diff = 0;
-    int8_t a_weighted_conf = -128;
-    int8_t b_weighted_conf = -128;
-
-    if (a.class_index == AI_YOLOV8_POSE_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
-    {
-         a_weighted_conf = -128;
-    }
+/* Class k first, by decreasing confidence */
+#define MPE_YOLOV8_PP_SORT_KEY(p, k) (((p)->class_index == (k)) ? (p)->conf : 0.0f)
+VISION_MODELS_SORT_DESC_DEFINE(mpe_yolov8_pp_sort, mpe_pp_outBuffer_t, float32_t, MPE_YOLOV8_PP_SORT_KEY)
 
-    if (b.class_index == AI_YOLOV8_POSE_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
-    else
-    {
-         b_weighted_conf = -128;
-    }
 
-    diff = a_weighted_conf - b_weighted_conf;
+#define MPE_YOLOV8_PP_SORT_KEY_IS8(p, k) (((p)->class_index == (k)) ? (p)->conf : INT8_MIN)
+VISION_MODELS_SORT_S8_DESC_DEFINE(mpe_yolov8_pp_sort_is8, mpe_pp_scratchBuffer_s8_t, MPE_YOLOV8_PP_SORT_KEY_IS8)
 
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
 
 
 int32_t mpe_yolo_pp_nmsFiltering_centroid(mpe_pp_out_t *pOutput,
@@ -94,7 +34,6 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid(mpe_pp_out_t *pOutput,
     {
         limit_counter = 0;
         detections_per_class = 0;
-        AI_YOLOV8_POSE_PP_SORT_CLASS = k;
 
 
         /* Counts the number of detections with class k */
@@ -109,10 +48,7 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid(mpe_pp_out_t *pOutput,
         if (detections_per_class > 0)
         {
             /* Sorts detections based on class k */
-            qsort(pOutput->pOutBuff,
-                  pInput_static_param->nb_detect,
-                  sizeof(mpe_pp_outBuffer_t),
-                  mpe_yolov8_nms_comparator);
+            mpe_yolov8_pp_sort(pOutput->pOutBuff, pInput_static_param->nb_detect, k);
 
             for (int32_t i = 0; i < detections_per_class ; i ++)
             {
@@ -122,7 +58,7 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid(mpe_pp_out_t *pOutput,
                 {
                     if (pOutput->pOutBuff[j].conf == 0) continue;
                     float32_t *b = &(pOutput->pOutBuff[j].x_center);
-                    if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
+                    if (vision_models_box_iou_gt(a, b, pInput_static_param->iou_threshold))
                     {
                         pOutput->pOutBuff[j].conf = 0;
                     }
@@ -151,12 +87,12 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid_is8(mpe_pp_scratchBuffer_s8_t *pScratc
                                               mpe_yolov8_pp_static_param_t *pInput_static_param)
 {
     int32_t j, k, limit_counter, detections_per_class;
+    int32_t iou_threshold_q16 = vision_models_iou_threshold_q16(pInput_static_param->iou_threshold);
 
     for (k = 0; k < pInput_static_param->nb_classes; ++k)
     {
         limit_counter = 0;
         detections_per_class = 0;
-        AI_YOLOV8_POSE_PP_SORT_CLASS = k;
 
 
         /* Counts the number of detections with class k */
@@ -171,10 +107,7 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid_is8(mpe_pp_scratchBuffer_s8_t *pScratc
         if (detections_per_class > 0)
         {
           /* Sorts detections based on class k */
-          qsort(pScratchBuffer,
-                  pInput_static_param->nb_detect,
-                  sizeof(mpe_pp_scratchBuffer_s8_t),
-                  mpe_yolov8_nms_comparator_is8);
+          mpe_yolov8_pp_sort_is8(pScratchBuffer, pInput_static_param->nb_detect, k);
 
             for (int32_t i = 0; i < detections_per_class ; i ++)
             {
@@ -184,7 +117,7 @@ int32_t mpe_yolo_pp_nmsFiltering_centroid_is8(mpe_pp_scratchBuffer_s8_t *pScratc
                 for (j = i + 1; j < detections_per_class; j ++)
                 {
                     int8_t *b = &(pScratchBuffer[j].x_center);
-                    if (vision_models_box_iou_is8(a, b, pInput_static_param->raw_output_zero_point) > pInput_static_param->iou_threshold)
+                    if (vision_models_box_iou_gt_is8(a, b, pInput_static_param->raw_output_zero_point, iou_threshold_q16))
                     {
                         pScratchBuffer[j].conf = -128;
                     }
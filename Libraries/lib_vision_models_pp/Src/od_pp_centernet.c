@@ -10,6 +10,10 @@
 #include "od_pp_loc.h"
 #include "od_centernet_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
+
+/* Widest int8 heatmap: the peak search keeps three rows of it on the stack */
+#define CENTERNET_PP_MAX_GRID_WIDTH (256)
 
 
 /* Trick to have this structure representation overlapped with real output representation */
@@ -66,17 +70,10 @@ float32_t centernet_box_iou(centernet_pp_tmp_outBuffer_t *a, centernet_pp_tmp_ou
 }
 
 
-int32_t centernet_nms_comparator(const void *pa, const void *pb)
-{
-    od_pp_outBuffer_t *a = (od_pp_outBuffer_t *)pa;
-    od_pp_outBuffer_t *b = (od_pp_outBuffer_t *)pb;
-    float32_t diff = 0;
-    diff = b->conf - a->conf;
-
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
+/* Increasing confidence: of two overlapping boxes the NMS below drops the first */
+#define CENTERNET_PP_SORT_KEY(p, arg) (-(p)->conf)
+VISION_MODELS_SORT_DESC_DEFINE(centernet_pp_sort, od_pp_outBuffer_t, float32_t, CENTERNET_PP_SORT_KEY)
+
 
 
 int32_t centernet_pp_nmsFiltering_centroid(centernet_pp_tmp_outBuffer_t  *pInput,
@@ -86,15 +83,11 @@ int32_t centernet_pp_nmsFiltering_centroid(centernet_pp_tmp_outBuffer_t  *pInput
     int32_t i, j, k, limit_counter;
     int32_t error   = AI_VISION_MODELS_PP_ERROR_NO;
     int32_t det_count = 0;
-    int32_t conf_stride = sizeof(od_pp_outBuffer_t);
     centernet_pp_tmp_outBuffer_t *pInbuff = (centernet_pp_tmp_outBuffer_t *)pInput;
     od_pp_outBuffer_t *pOutbuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
 
-    /* First sorts by confidence scores */
-    qsort((float32_t *)pInbuff,
-           pInput_static_param->nb_detect,
-           conf_stride,
-           (_Cmpfun *)centernet_nms_comparator);
+    /* First sorts by increasing confidence scores */
+    centernet_pp_sort((od_pp_outBuffer_t *)pInbuff, pInput_static_param->nb_detect, 0);
 
     /* Applies NMS per class */
     for (k = 0; k < pInput_static_param->nb_classifs; ++k)
@@ -286,6 +279,27 @@ int32_t centernet_pp_getNNBoxes_centroid(od_centernet_pp_in_t *pInput,
 }
 
 
+/* Center channel of one heatmap row, made contiguous */
+static void centernet_pp_gather_row_is8(const int8_t *pRow, int32_t width, int32_t stride, int8_t *pDst)
+{
+#ifdef VISION_MODELS_PEAKS_3X3_IS8_MVE
+  if (15 * stride < UCHAR_MAX) {
+    uint8x16_t u8x16_offset = vidupq_n_u8(0, 1) * (uint8_t)stride;
+
+    for (int32_t x = 0; x < width; x += 16)
+    {
+      mve_pred16_t p = vctp8q(width - x);
+      vstrbq_p_s8(pDst + x, vldrbq_gather_offset_z_s8(pRow + x * stride, u8x16_offset, p), p);
+    }
+    return;
+  }
+#endif
+  for (int32_t x = 0; x < width; x++)
+  {
+    pDst[x] = pRow[x * stride];
+  }
+}
+
 int32_t centernet_pp_getNNBoxes_centroid_int8(od_centernet_pp_in_t *pInput,
                                          od_centernet_pp_static_param_t *pInput_static_param)
 {
@@ -304,7 +318,6 @@ int32_t centernet_pp_getNNBoxes_centroid_int8(od_centernet_pp_in_t *pInput,
   int8_t *pConf_13     = (int8_t *)pConf_12     + conf_stride_right;
   int8_t *pConf_21     = (int8_t *)pConf_11     + conf_stride_bottom;
 	int8_t *pConf_center = (int8_t *)pConf_21     + conf_stride_right;
-  int8_t *pConf_23     = (int8_t *)pConf_center + conf_stride_right;
   int8_t *pConf_31     = (int8_t *)pConf_21     + conf_stride_bottom;
   int8_t *pConf_32     = (int8_t *)pConf_31     + conf_stride_right;
   int8_t *pConf_33     = (int8_t *)pConf_32     + conf_stride_right;
@@ -340,98 +353,75 @@ int32_t centernet_pp_getNNBoxes_centroid_int8(od_centernet_pp_in_t *pInput,
 		}
 	}
 
-  /* Searches center detection everywhere but on the external border */
-  pConf_11     = (int8_t *)pInput->pRaw_detections + AI_CENTERNET_PP_CONFCENTER;
-  pConf_12     = (int8_t *)pConf_11     + conf_stride_right;
-  pConf_13     = (int8_t *)pConf_12     + conf_stride_right;
-  pConf_21     = (int8_t *)pConf_11     + conf_stride_bottom;
-	pConf_center = (int8_t *)pConf_21     + conf_stride_right;
-  pConf_23     = (int8_t *)pConf_center + conf_stride_right;
-  pConf_31     = (int8_t *)pConf_21     + conf_stride_bottom;
-  pConf_32     = (int8_t *)pConf_31     + conf_stride_right;
-  pConf_33     = (int8_t *)pConf_32     + conf_stride_right;
+  /* Searches center detection everywhere but on the external border: the
+   * center channel of three rows at a time, gathered contiguous for the
+   * shared peak kernel */
+  int8_t conf_rows[3][CENTERNET_PP_MAX_GRID_WIDTH];
+  uint16_t peak_cols[CENTERNET_PP_MAX_GRID_WIDTH];
+  int8_t *pConf_map = (int8_t *)pInput->pRaw_detections + AI_CENTERNET_PP_CONFCENTER;
   const int8_t conf_threshold_s8 = (int8_t)(pInput_static_param->conf_threshold / raw_scale + 0.5f) + raw_zp;
 
+  if (pInput_static_param->grid_width > CENTERNET_PP_MAX_GRID_WIDTH)
+  {
+    return (AI_VISION_MODELS_PP_ERROR);
+  }
+  if (pInput_static_param->grid_height >= 3)
+  {
+    centernet_pp_gather_row_is8(pConf_map, pInput_static_param->grid_width, conf_stride_right, conf_rows[0]);
+    centernet_pp_gather_row_is8(pConf_map + conf_stride_bottom, pInput_static_param->grid_width, conf_stride_right,
+                                conf_rows[1]);
+  }
+
   for (int32_t col = 1; col < pInput_static_param->grid_height - 1; ++col)
   {
-      for (int32_t row = 1; row < pInput_static_param->grid_width - 1; ++row)
+      const int8_t *pTop = conf_rows[(col - 1) % 3];
+      const int8_t *pMid = conf_rows[col % 3];
+      int8_t *pBot = conf_rows[(col + 1) % 3];
+
+      centernet_pp_gather_row_is8(pConf_map + (col + 1) * conf_stride_bottom, pInput_static_param->grid_width,
+                                  conf_stride_right, pBot);
+      /* Get Peaks: higher than or equal to their 8 neighbors and above the threshold */
+      uint32_t nb_peaks = vision_models_peaks_3x3_is8(pTop, pMid, pBot, pInput_static_param->grid_width,
+                                                      conf_threshold_s8, peak_cols);
+
+      for (uint32_t k = 0; k < nb_peaks; ++k)
       {
-          /* Get Peaks */
+          int32_t row = peak_cols[k];
+          pConf_center = pConf_map + col * conf_stride_bottom + row * conf_stride_right;
+
           score_center = *pConf_center;
-          if ((score_center >= *pConf_11) &&
-              (score_center >= *pConf_12) &&
-              (score_center >= *pConf_13) &&
-              (score_center >= *pConf_21) &&
-              (score_center >= *pConf_23) &&
-              (score_center >= *pConf_31) &&
-              (score_center >= *pConf_32) &&
-              (score_center >= *pConf_33) &&
-              (score_center > conf_threshold_s8 /*pInput_static_param->conf_threshold*/))
+          /* A detection center is kept since higher than its 8 neighbors and the threshold */
+          float32_t x_offset = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_XOFFSET] - raw_zp ) * raw_scale * grid_width_inv;
+          float32_t y_offset = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_YOFFSET] - raw_zp ) * raw_scale * grid_height_inv;
+          float32_t b_x = row * grid_width_inv + x_offset;
+          float32_t b_y = col * grid_height_inv + y_offset;
+          float32_t b_w = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_WIDTH] - raw_zp ) * raw_scale * grid_width_inv;
+          float32_t b_h = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_HEIGHT] - raw_zp ) * raw_scale * grid_height_inv;
+          float32_t x1 = b_x - b_w / 2.0f;
+          float32_t y1 = b_y - b_h / 2.0f;
+          float32_t x2 = b_x + b_w / 2.0f;
+          float32_t y2 = b_y + b_h / 2.0f;
+          if ((y2 > y1) &&
+              (x2 > x1))
           {
-              /* A detection center is kept since higher than its 8 neighbors and the threshold */
-              float32_t x_offset = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_XOFFSET] - raw_zp ) * raw_scale * grid_width_inv;
-              float32_t y_offset = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_YOFFSET] - raw_zp ) * raw_scale * grid_height_inv;
-              float32_t b_x = row * grid_width_inv + x_offset;
-              float32_t b_y = col * grid_height_inv + y_offset;
-              float32_t b_w = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_WIDTH] - raw_zp ) * raw_scale * grid_width_inv;
-              float32_t b_h = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_HEIGHT] - raw_zp ) * raw_scale * grid_height_inv;
-              float32_t x1 = b_x - b_w / 2.0f;
-              float32_t y1 = b_y - b_h / 2.0f;
-              float32_t x2 = b_x + b_w / 2.0f;
-              float32_t y2 = b_y + b_h / 2.0f;
-              if ((y2 > y1) &&
-                  (x2 > x1))
-              {
-                  count_detect++;
-                  pOutput->top_left_x = x1;
-                  pOutput->top_left_y = y1;
-                  pOutput->bottom_right_x = x2;
-                  pOutput->bottom_right_y = y2;
-                  pOutput->conf = (float32_t)((int32_t)score_center - raw_zp ) * raw_scale;
-                  /*
-                  float32_t max_classifs = (float32_t)((int32_t)pConf_center[AI_CENTERNET_PP_CLASSPROB] - raw_zp ) * raw_scale;
-                  int32_t class_idx = 0;
-                  for (int i = 1; i < pInput_static_param->nb_classifs; i++)
-                  {
-                      if (pConf_center[AI_CENTERNET_PP_CLASSPROB + i] > max_classifs)
-                      {
-                          max_classifs = pConf_center[AI_CENTERNET_PP_CLASSPROB + i];
-                          class_idx = i;
-                      }
-                  }*/
-                  int8_t max_classifs;
-                  uint8_t class_idx;
-                  vision_models_maxi_p_is8ou8(&pConf_center[AI_CENTERNET_PP_CLASSPROB],
-                                              pInput_static_param->nb_classifs,
-                                              AI_CENTERNET_PP_CLASSPROB + pInput_static_param->nb_classifs,
-                                              &max_classifs,
-                                              &class_idx,
-                                              1);
-                  pOutput->class_index = class_idx;
-                  pOutput++;
-              }
+              count_detect++;
+              pOutput->top_left_x = x1;
+              pOutput->top_left_y = y1;
+              pOutput->bottom_right_x = x2;
+              pOutput->bottom_right_y = y2;
+              pOutput->conf = (float32_t)((int32_t)score_center - raw_zp ) * raw_scale;
+              int8_t max_classifs;
+              uint8_t class_idx;
+              vision_models_maxi_p_is8ou8(&pConf_center[AI_CENTERNET_PP_CLASSPROB],
+                                          pInput_static_param->nb_classifs,
+                                          AI_CENTERNET_PP_CLASSPROB + pInput_static_param->nb_classifs,
+                                          &max_classifs,
+                                          &class_idx,
+                                          1);
+              pOutput->class_index = class_idx;
+              pOutput++;
           }
-          pConf_11 += conf_stride_right;
-          pConf_12 += conf_stride_right;
-          pConf_13 += conf_stride_right;
-          pConf_21 += conf_stride_right;
-          pConf_center += conf_stride_right;
-          pConf_23 += conf_stride_right;
-          pConf_31 += conf_stride_right;
-          pConf_32 += conf_stride_right;
-          pConf_33 += conf_stride_right;
       }
-
-      /* Shifts twice to bypass feature map border */
-      pConf_11 += (conf_stride_right * 2);
-      pConf_12 += (conf_stride_right * 2);
-      pConf_13 += (conf_stride_right * 2);
-      pConf_21 += (conf_stride_right * 2);
-      pConf_center += (conf_stride_right * 2);
-      pConf_23 += (conf_stride_right * 2);
-      pConf_31 += (conf_stride_right * 2);
-      pConf_32 += (conf_stride_right * 2);
-      pConf_33 += (conf_stride_right * 2);
   }
 
   pInput_static_param->nb_detect = count_detect;
@@ -10,45 +10,15 @@
 #include "od_pp_loc.h"
 #include "od_fd_blazeface_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_FD_PP_SORT_CLASS;
 
 
-int32_t fd_nms_comparator(const void *pa, const void *pb)
-{
-    od_pp_outBuffer_t a = *(od_pp_outBuffer_t *)pa;
-    od_pp_outBuffer_t b = *(od_pp_outBuffer_t *)pb;
-
-    float32_t diff = 0.0;
-    float32_t a_weighted_conf = 0.0;
-    float32_t b_weighted_conf = 0.0;
-
-    if (a.class_index == AI_FD_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
-    {
-         a_weighted_conf = 0.0;
-    }
-
-    if (b.class_index == AI_FD_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
-    else
-    {
-         b_weighted_conf = 0.0;
-    }
-
-    diff = a_weighted_conf - b_weighted_conf;
+/* Class k first, by decreasing confidence */
+#define FD_PP_SORT_KEY(p, k) (((p)->class_index == (k)) ? (p)->conf : 0.0f)
+VISION_MODELS_SORT_DESC_DEFINE(fd_pp_sort, od_pp_outBuffer_t, float32_t, FD_PP_SORT_KEY)
 
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
 
 int32_t fd_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
                                     od_fd_blazeface_pp_static_param_t *pInput_static_param)
@@ -58,7 +28,6 @@ int32_t fd_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
     {
         limit_counter = 0;
         detections_per_class = 0;
-        AI_FD_PP_SORT_CLASS = k;
 
 
         /* Counts the number of detections with class k */
@@ -73,10 +42,7 @@ int32_t fd_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
         if (detections_per_class > 0)
         {
             /* Sorts detections based on class k */
-            qsort(pOutput->pOutBuff,
-                  pInput_static_param->nb_detect,
-                  sizeof(od_pp_outBuffer_t),
-                  fd_nms_comparator);
+            fd_pp_sort(pOutput->pOutBuff, pInput_static_param->nb_detect, k);
 
             for (int32_t i = 0; i < detections_per_class ; i ++)
             {
@@ -86,7 +52,7 @@ int32_t fd_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
                 {
                     if (pOutput->pOutBuff[j].conf == 0) continue;
                     float32_t *b = &(pOutput->pOutBuff[j].x_center);
-                    if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
+                    if (vision_models_box_iou_gt(a, b, pInput_static_param->iou_threshold))
                     {
                         pOutput->pOutBuff[j].conf = 0;
                     }
@@ -136,6 +102,201 @@ int32_t fd_pp_scoreFiltering_centroid(od_pp_out_t *pOutput,
 }
 
 
+/* Anchors the score scan hands to the box decode at once */
+#define FD_PP_SCAN_BLOCK (64)
+
+/* Decoding is split in two: a scan of the scores alone yields the anchors at
+ * or above threshold, 16 (int8) or 4 (float) per vector compare; only those
+ * get their box read. A box is decoded in one 4-lane pass, x_center, y_center,
+ * width and height side by side as od_pp_outBuffer_t keeps them: anchors are
+ * unit sized, so only their (x, y) centers, one 8-byte pair, are read. */
+
+static int32_t fd_pp_scan_f32(const float32_t *pProbas,
+                              int32_t n,
+                              int32_t nb,
+                              float32_t threshold,
+                              int32_t *pIdx)
+{
+  int32_t nb_keep = 0;
+
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  for (int32_t i = 0; i < nb; i += 4)
+  {
+    mve_pred16_t p = vctp32q(nb - i);
+    float32x4_t f32x4_prob = vldrwq_z_f32(&pProbas[n + i], p);
+    /* Four predicate bits per 32-bit lane: keep the lowest */
+    uint32_t keep = vcmpgeq_m_n_f32(f32x4_prob, threshold, p) & 0x1111U;
+
+    while (keep != 0)
+    {
+      pIdx[nb_keep++] = n + i + (int32_t)(__builtin_ctz(keep) >> 2);
+      keep &= keep - 1;
+    }
+  }
+#else
+  for (int32_t i = n; i < n + nb; i++)
+  {
+    if (pProbas[i] >= threshold)
+    {
+      pIdx[nb_keep++] = i;
+    }
+  }
+#endif
+  return nb_keep;
+}
+
+static int32_t fd_pp_scan_is8(const int8_t *pProbas,
+                              int32_t n,
+                              int32_t nb,
+                              int32_t threshold_s8,
+                              int32_t *pIdx)
+{
+  int32_t nb_keep = 0;
+
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  for (int32_t i = 0; i < nb; i += 16)
+  {
+    mve_pred16_t p = vctp8q(nb - i);
+    int8x16_t s8x16_prob = vldrbq_z_s8(&pProbas[n + i], p);
+    uint32_t keep = vcmpgeq_m_n_s8(s8x16_prob, (int8_t)threshold_s8, p);
+
+    while (keep != 0)
+    {
+      pIdx[nb_keep++] = n + i + (int32_t)__builtin_ctz(keep);
+      keep &= keep - 1;
+    }
+  }
+#else
+  for (int32_t i = n; i < n + nb; i++)
+  {
+    if ((int32_t)pProbas[i] >= threshold_s8)
+    {
+      pIdx[nb_keep++] = i;
+    }
+  }
+#endif
+  return nb_keep;
+}
+
+static int32_t fd_pp_scan_iu8(const uint8_t *pProbas,
+                              int32_t n,
+                              int32_t nb,
+                              int32_t threshold_u8,
+                              int32_t *pIdx)
+{
+  int32_t nb_keep = 0;
+
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  for (int32_t i = 0; i < nb; i += 16)
+  {
+    mve_pred16_t p = vctp8q(nb - i);
+    uint8x16_t u8x16_prob = vldrbq_z_u8(&pProbas[n + i], p);
+    uint32_t keep = vcmpcsq_m_n_u8(u8x16_prob, (uint8_t)threshold_u8, p);
+
+    while (keep != 0)
+    {
+      pIdx[nb_keep++] = n + i + (int32_t)__builtin_ctz(keep);
+      keep &= keep - 1;
+    }
+  }
+#else
+  for (int32_t i = n; i < n + nb; i++)
+  {
+    if ((int32_t)pProbas[i] >= threshold_u8)
+    {
+      pIdx[nb_keep++] = i;
+    }
+  }
+#endif
+  return nb_keep;
+}
+
+/* Score threshold in the quantized domain: (q - zp) * scale >= logit(conf) */
+static int32_t fd_pp_threshold_q(float32_t conf_threshold, float32_t proba_scale, int32_t proba_zp,
+                                 int32_t q_min, int32_t q_max)
+{
+  return od_pp_threshold_q(-logf( 1 / conf_threshold - 1), proba_scale, proba_zp, q_min, q_max);
+}
+
+/* Box of an anchor: (raw - zp) * box_scale * inv_size, plus the anchor center for x and y */
+static inline void fd_pp_decode_box(od_pp_outBuffer_t *pOut,
+                                    const float32_t *pRaw,
+                                    const float32_t *pAnchor,
+                                    float32_t inv_size)
+{
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  float32x4_t f32x4_anchor = vldrwq_z_f32(pAnchor, vctp32q(2));
+
+  vst1q_f32(&pOut->x_center, vfmaq_n_f32(f32x4_anchor, vld1q_f32(pRaw), inv_size));
+#else
+  pOut->x_center   = pRaw[AI_FD_BLAZEFACE_PP_XCENTER]   * inv_size + pAnchor[0];
+  pOut->y_center   = pRaw[AI_FD_BLAZEFACE_PP_YCENTER]   * inv_size + pAnchor[1];
+  pOut->width      = pRaw[AI_FD_BLAZEFACE_PP_WIDTHREL]  * inv_size;
+  pOut->height     = pRaw[AI_FD_BLAZEFACE_PP_HEIGHTREL] * inv_size;
+#endif
+}
+
+static inline void fd_pp_decode_box_is8(od_pp_outBuffer_t *pOut,
+                                        const int8_t *pRaw,
+                                        const float32_t *pAnchor,
+                                        float32_t inv_size,
+                                        float32_t raw_scale,
+                                        int32_t raw_zp)
+{
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  float32x4_t f32x4_anchor = vldrwq_z_f32(pAnchor, vctp32q(2));
+  int32x4_t s32x4_raw = vsubq_n_s32(vldrbq_s32(pRaw), raw_zp);
+  float32x4_t f32x4_dequant = vmulq_n_f32(vcvtq_f32_s32(s32x4_raw), raw_scale);
+
+  vst1q_f32(&pOut->x_center, vfmaq_n_f32(f32x4_anchor, f32x4_dequant, inv_size));
+#else
+  float32_t dequant;
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_XCENTER] - raw_zp) * raw_scale;
+  pOut->x_center   = dequant * inv_size + pAnchor[0];
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_YCENTER] - raw_zp) * raw_scale;
+  pOut->y_center   = dequant * inv_size + pAnchor[1];
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_WIDTHREL] - raw_zp) * raw_scale;
+  pOut->width      = dequant * inv_size;
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_HEIGHTREL] - raw_zp) * raw_scale;
+  pOut->height     = dequant * inv_size;
+#endif
+}
+
+static inline void fd_pp_decode_box_iu8(od_pp_outBuffer_t *pOut,
+                                        const uint8_t *pRaw,
+                                        const float32_t *pAnchor,
+                                        float32_t inv_size,
+                                        float32_t raw_scale,
+                                        int32_t raw_zp)
+{
+#ifdef VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
+  float32x4_t f32x4_anchor = vldrwq_z_f32(pAnchor, vctp32q(2));
+  int32x4_t s32x4_raw = vsubq_n_s32(vreinterpretq_s32_u32(vldrbq_u32(pRaw)), raw_zp);
+  float32x4_t f32x4_dequant = vmulq_n_f32(vcvtq_f32_s32(s32x4_raw), raw_scale);
+
+  vst1q_f32(&pOut->x_center, vfmaq_n_f32(f32x4_anchor, f32x4_dequant, inv_size));
+#else
+  float32_t dequant;
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_XCENTER] - raw_zp) * raw_scale;
+  pOut->x_center   = dequant * inv_size + pAnchor[0];
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_YCENTER] - raw_zp) * raw_scale;
+  pOut->y_center   = dequant * inv_size + pAnchor[1];
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_WIDTHREL] - raw_zp) * raw_scale;
+  pOut->width      = dequant * inv_size;
+
+  dequant = (float32_t)((int32_t)pRaw[AI_FD_BLAZEFACE_PP_HEIGHTREL] - raw_zp) * raw_scale;
+  pOut->height     = dequant * inv_size;
+#endif
+}
+
+
 int32_t fd_pp_level_decode_and_store(float32_t *pRawBoxes,
                                      float32_t *pProbas,
                                      od_pp_out_t *pOutput,
@@ -149,31 +310,27 @@ int32_t fd_pp_level_decode_and_store(float32_t *pRawBoxes,
     int32_t boxe_stride = pInput_static_param->nb_keypoints * 2 + AI_FD_BLAZEFACE_PP_KEYPOINTS;
     int32_t det_count = pInput_static_param->nb_detect;
     od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
+    int32_t keep_idx[FD_PP_SCAN_BLOCK];
 
     if ( 1 == pInput_static_param->nb_classes) {
       float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
-      for (int32_t det = 0; det < (int32_t)inDetection; ++det)
+      for (int32_t n = 0; n < (int32_t)inDetection; n += FD_PP_SCAN_BLOCK)
       {
-        if ( *pProbas >= computedThreshold) {
+        int32_t nb_keep = fd_pp_scan_f32(pProbas, n, MIN(FD_PP_SCAN_BLOCK, (int32_t)inDetection - n),
+                                         computedThreshold, keep_idx);
 
-          /* read and activate objectness */
-          float32_t prob = vision_models_sigmoid_f(*pProbas);
+        for (int32_t k = 0; k < nb_keep; k++)
+        {
+          int32_t det = keep_idx[k];
 
-          pOutBuff[det_count].conf = prob;
+          /* read and activate objectness */
+          pOutBuff[det_count].conf = vision_models_sigmoid_f(pProbas[det]);
           pOutBuff[det_count].class_index = 0;
-
-          pOutBuff[det_count].x_center   = pRawBoxes[AI_FD_BLAZEFACE_PP_XCENTER]   * inv_size + pAnchors[0];
-          pOutBuff[det_count].y_center   = pRawBoxes[AI_FD_BLAZEFACE_PP_YCENTER]   * inv_size + pAnchors[1];
-          pOutBuff[det_count].width      = pRawBoxes[AI_FD_BLAZEFACE_PP_WIDTHREL]  * inv_size;
-          pOutBuff[det_count].height     = pRawBoxes[AI_FD_BLAZEFACE_PP_HEIGHTREL] * inv_size;
+          fd_pp_decode_box(&pOutBuff[det_count], &pRawBoxes[det * boxe_stride], &pAnchors[2 * det], inv_size);
 
           det_count++;
         }
-        pProbas++;
-        pRawBoxes+=boxe_stride;
-        pAnchors+=2;
-
-      } // for det
+      } // for n
     } // if nb_classes == 1
     pInput_static_param->nb_detect = det_count;
 
@@ -199,42 +356,36 @@ int32_t fd_pp_level_decode_and_store_iu8(uint8_t *pRawBoxes,
 
   int32_t det_count = pInput_static_param->nb_detect;
   od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
+  int32_t keep_idx[FD_PP_SCAN_BLOCK];
 
   if ( 1 == pInput_static_param->nb_classes) {
 
-    float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
-    uint8_t threshold_u8  = (uint8_t)(computedThreshold / proba_scale + proba_zp);
+    int32_t threshold_u8 = fd_pp_threshold_q(pInput_static_param->conf_threshold, proba_scale, proba_zp, 0, UINT8_MAX);
 
-    for (int32_t det = 0; det < (int32_t)inDetection; ++det)
+    if (threshold_u8 > UINT8_MAX)
     {
-      if ( *pProbas > threshold_u8) {
-        /* read and activate objectness */
-        float32_t dequant;
-        //float32_t anchor;
-        dequant = (float32_t)((int32_t)*pProbas - proba_zp) * proba_scale;
-        float32_t prob = vision_models_sigmoid_f(dequant);
-        pOutBuff[det_count].conf = prob;
-        pOutBuff[det_count].class_index = 0;
-
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_XCENTER] - raw_zp) * raw_scale;
-        pOutBuff[det_count].x_center   = dequant * inv_size + pAnchors[0];
+      return det_count;
+    }
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_YCENTER] - raw_zp) * raw_scale;
-        pOutBuff[det_count].y_center   = dequant * inv_size + pAnchors[1];
+    for (int32_t n = 0; n < (int32_t)inDetection; n += FD_PP_SCAN_BLOCK)
+    {
+      int32_t nb_keep = fd_pp_scan_iu8(pProbas, n, MIN(FD_PP_SCAN_BLOCK, (int32_t)inDetection - n),
+                                       threshold_u8, keep_idx);
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_WIDTHREL] - raw_zp) * raw_scale;
-        pOutBuff[det_count].width      = dequant * inv_size;
+      for (int32_t k = 0; k < nb_keep; k++)
+      {
+        int32_t det = keep_idx[k];
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_HEIGHTREL] - raw_zp) * raw_scale;
-        pOutBuff[det_count].height     = dequant * inv_size;
+        /* read and activate objectness */
+        float32_t dequant = (float32_t)((int32_t)pProbas[det] - proba_zp) * proba_scale;
+        pOutBuff[det_count].conf = vision_models_sigmoid_f(dequant);
+        pOutBuff[det_count].class_index = 0;
+        fd_pp_decode_box_iu8(&pOutBuff[det_count], &pRawBoxes[det * boxe_stride], &pAnchors[2 * det],
+                             inv_size, raw_scale, raw_zp);
 
         det_count++;
       }
-      pProbas++;
-      pRawBoxes+=boxe_stride;
-      pAnchors+=2;
-
-    } // for anchh
+    } // for n
   } // if nb_classes == 1
   pInput_static_param->nb_detect = det_count;
 
@@ -260,42 +411,36 @@ int32_t fd_pp_level_decode_and_store_is8(int8_t *pRawBoxes,
 
   int32_t det_count = pInput_static_param->nb_detect;
   od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
+  int32_t keep_idx[FD_PP_SCAN_BLOCK];
 
   if ( 1 == pInput_static_param->nb_classes) {
 
-    float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
-    int8_t threshold_s8  = (int8_t)(computedThreshold / proba_scale + proba_zp);
+    int32_t threshold_s8 = fd_pp_threshold_q(pInput_static_param->conf_threshold, proba_scale, proba_zp, INT8_MIN, INT8_MAX);
 
-    for (int32_t det = 0; det < (int32_t)inDetection; ++det)
+    if (threshold_s8 > INT8_MAX)
     {
-      if ( *pProbas > threshold_s8) {
-        /* read and activate objectness */
-        float32_t dequant;
-        //float32_t anchor;
-        dequant = (float32_t)((int32_t)*pProbas - proba_zp) * proba_scale;
-        float32_t prob = vision_models_sigmoid_f(dequant);
-        pOutBuff[det_count].conf = prob;
-        pOutBuff[det_count].class_index = 0;
-
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_XCENTER] - raw_zp) * raw_scale;
-        pOutBuff[det_count].x_center   = dequant * inv_size + pAnchors[0];
+      return det_count;
+    }
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_YCENTER] - raw_zp) * raw_scale;
-        pOutBuff[det_count].y_center   = dequant * inv_size + pAnchors[1];
+    for (int32_t n = 0; n < (int32_t)inDetection; n += FD_PP_SCAN_BLOCK)
+    {
+      int32_t nb_keep = fd_pp_scan_is8(pProbas, n, MIN(FD_PP_SCAN_BLOCK, (int32_t)inDetection - n),
+                                       threshold_s8, keep_idx);
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_WIDTHREL] - raw_zp) * raw_scale;
-        pOutBuff[det_count].width      = dequant * inv_size;
+      for (int32_t k = 0; k < nb_keep; k++)
+      {
+        int32_t det = keep_idx[k];
 
-        dequant = (float32_t)((int32_t)pRawBoxes[AI_FD_BLAZEFACE_PP_HEIGHTREL] - raw_zp) * raw_scale;
-        pOutBuff[det_count].height     = dequant * inv_size;
+        /* read and activate objectness */
+        float32_t dequant = (float32_t)((int32_t)pProbas[det] - proba_zp) * proba_scale;
+        pOutBuff[det_count].conf = vision_models_sigmoid_f(dequant);
+        pOutBuff[det_count].class_index = 0;
+        fd_pp_decode_box_is8(&pOutBuff[det_count], &pRawBoxes[det * boxe_stride], &pAnchors[2 * det],
+                             inv_size, raw_scale, raw_zp);
 
         det_count++;
       }
-      pProbas++;
-      pRawBoxes+=boxe_stride;
-      pAnchors+=2;
-
-    } // for anchh
+    } // for n
   } // if nb_classes == 1
   pInput_static_param->nb_detect = det_count;
 
@@ -0,0 +1,281 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#include "od_pp_loc.h"
+#include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
+
+
+/* Decreasing confidence; ties keep their input order */
+#define OD_PP_NMS_SORT_KEY_CONF(p, arg) ((p)->conf)
+VISION_MODELS_SORT_DESC_DEFINE(od_pp_nms_sort_conf, od_pp_outBuffer_t, float32_t, OD_PP_NMS_SORT_KEY_CONF)
+
+/* Decreasing class, then decreasing confidence: the order the per-class qsort passes left */
+#define OD_PP_NMS_SORT_KEY_CLASS_CONF(p, arg) \
+  ((int64_t)(p)->class_index * 4294967296LL + (int64_t)vision_models_sort_key_f32((p)->conf))
+VISION_MODELS_SORT_DESC_DEFINE(od_pp_nms_sort_class_conf, od_pp_outBuffer_t, int64_t, OD_PP_NMS_SORT_KEY_CLASS_CONF)
+
+
+#ifdef VISION_MODELS_NMS_IOU_FIXED
+/* Kept corners in Q15 of the largest extent of the call, areas in 64 bits */
+typedef int32_t od_pp_nms_coord_t;
+typedef int64_t od_pp_nms_area_t;
+
+/*!
+ * @brief Scale mapping every box corner of the call into [-2^15, 2^15]
+ */
+static float32_t od_pp_nms_fixed_scale(const od_pp_outBuffer_t *pBoxes, int32_t nb_boxes)
+{
+  float32_t extent = 0;
+
+  for (int32_t i = 0; i < nb_boxes; i++)
+  {
+    float32_t ex = fabsf(pBoxes[i].x_center) + 0.5f * fabsf(pBoxes[i].width);
+    float32_t ey = fabsf(pBoxes[i].y_center) + 0.5f * fabsf(pBoxes[i].height);
+    extent = MAX(extent, MAX(ex, ey));
+  }
+
+  return (extent > 0) ? (32767.0f / extent) : 1.0f;
+}
+#else
+typedef float32_t od_pp_nms_coord_t;
+typedef float32_t od_pp_nms_area_t;
+#endif
+
+
+/* Corners and area of a box, as the candidate and the kept boxes hold them */
+typedef struct
+{
+  od_pp_nms_coord_t x1;
+  od_pp_nms_coord_t y1;
+  od_pp_nms_coord_t x2;
+  od_pp_nms_coord_t y2;
+  od_pp_nms_area_t area;
+} od_pp_nms_rect_t;
+
+static inline od_pp_nms_rect_t od_pp_nms_rect(const od_pp_outBuffer_t *pBox, float32_t coord_scale)
+{
+  od_pp_nms_rect_t r;
+  float32_t half_w = 0.5f * pBox->width;
+  float32_t half_h = 0.5f * pBox->height;
+
+#ifdef VISION_MODELS_NMS_IOU_FIXED
+  r.x1 = (od_pp_nms_coord_t)((pBox->x_center - half_w) * coord_scale);
+  r.y1 = (od_pp_nms_coord_t)((pBox->y_center - half_h) * coord_scale);
+  r.x2 = (od_pp_nms_coord_t)((pBox->x_center + half_w) * coord_scale);
+  r.y2 = (od_pp_nms_coord_t)((pBox->y_center + half_h) * coord_scale);
+  r.area = (od_pp_nms_area_t)(r.x2 - r.x1) * (r.y2 - r.y1);
+#else
+  (void)coord_scale;
+  r.x1 = pBox->x_center - half_w;
+  r.y1 = pBox->y_center - half_h;
+  r.x2 = pBox->x_center + half_w;
+  r.y2 = pBox->y_center + half_h;
+  r.area = pBox->width * pBox->height;
+#endif
+  return r;
+}
+
+/* IoU > threshold, without the division */
+static inline int32_t od_pp_nms_overlaps(const od_pp_nms_rect_t *pCand,
+                                         od_pp_nms_coord_t x1,
+                                         od_pp_nms_coord_t y1,
+                                         od_pp_nms_coord_t x2,
+                                         od_pp_nms_coord_t y2,
+                                         od_pp_nms_area_t area,
+                                         float32_t iou_threshold,
+                                         int64_t t_q16,
+                                         int64_t one_t_q16)
+{
+  od_pp_nms_coord_t w = MIN(pCand->x2, x2) - MAX(pCand->x1, x1);
+  od_pp_nms_coord_t h = MIN(pCand->y2, y2) - MAX(pCand->y1, y1);
+
+  if ((w <= 0) || (h <= 0)) return 0;
+#ifdef VISION_MODELS_NMS_IOU_FIXED
+  (void)iou_threshold;
+  od_pp_nms_area_t inter = (od_pp_nms_area_t)w * h;
+  return (inter * one_t_q16 > t_q16 * (pCand->area + area));
+#else
+  (void)t_q16;
+  (void)one_t_q16;
+  od_pp_nms_area_t inter = w * h;
+  return (inter > iou_threshold * (pCand->area + area - inter));
+#endif
+}
+
+
+/*!
+ * @brief Greedy NMS over the boxes of a single class
+ *
+ *        Candidates are only compared against the boxes already kept, held as
+ *        corner SoA so the IoU loop streams through contiguous values. With
+ *        VISION_MODELS_NMS_IOU_FIXED the corners are converted once per
+ *        candidate and the loop is integer only: I * (1 + t) > t * (A + B).
+ *        With MVE the boxes overlapping the candidate at all are found four
+ *        kept boxes at a time. Past OD_PP_NMS_MAX_KEPT kept boxes, the SoA is
+ *        full: the later kept boxes are tested from the records, which
+ *        costs their corners again but bounds max_kept by nothing.
+ */
+static void od_pp_nms_class(od_pp_outBuffer_t *pBoxes,
+                            int32_t nb_boxes,
+                            float32_t iou_threshold,
+                            float32_t coord_scale,
+                            int32_t max_kept,
+                            int32_t is_sorted)
+{
+  od_pp_nms_coord_t kept_x1[OD_PP_NMS_MAX_KEPT];
+  od_pp_nms_coord_t kept_y1[OD_PP_NMS_MAX_KEPT];
+  od_pp_nms_coord_t kept_x2[OD_PP_NMS_MAX_KEPT];
+  od_pp_nms_coord_t kept_y2[OD_PP_NMS_MAX_KEPT];
+  od_pp_nms_area_t kept_area[OD_PP_NMS_MAX_KEPT];
+  int32_t nb_kept = 0;
+  int32_t spill = -1; /* First kept box past the SoA, -1 while it has room */
+  int32_t i;
+#ifdef VISION_MODELS_NMS_IOU_FIXED
+  int64_t t_q16 = vision_models_iou_threshold_q16(iou_threshold);
+  int64_t one_t_q16 = VISION_MODELS_IOU_Q16_ONE + t_q16;
+#else
+  int64_t t_q16 = 0;
+  int64_t one_t_q16 = 0;
+#endif
+
+  if (!is_sorted && (nb_boxes > 1))
+  {
+    od_pp_nms_sort_conf(pBoxes, nb_boxes, 0);
+  }
+
+  for (i = 0; (i < nb_boxes) && (nb_kept < max_kept); i++)
+  {
+    od_pp_outBuffer_t *pBox = &pBoxes[i];
+    if (pBox->conf == 0) continue;
+
+    od_pp_nms_rect_t cand = od_pp_nms_rect(pBox, coord_scale);
+    od_pp_nms_coord_t x1 = cand.x1;
+    od_pp_nms_coord_t y1 = cand.y1;
+    od_pp_nms_coord_t x2 = cand.x2;
+    od_pp_nms_coord_t y2 = cand.y2;
+    od_pp_nms_area_t area = cand.area;
+    int32_t nb_soa = MIN(nb_kept, OD_PP_NMS_MAX_KEPT);
+    int32_t suppressed = 0;
+
+#ifdef VISION_MODELS_NMS_OVERLAP_MVE
+    /* Four kept boxes at a time: most do not touch the candidate at all, the
+     * exact IoU test only runs on the lanes that do */
+    for (int32_t k = 0; (k < nb_soa) && !suppressed; k += 4)
+    {
+      mve_pred16_t p = vctp32q(nb_soa - k);
+      int32x4_t w = vsubq_s32(vminq_s32(vdupq_n_s32(x2), vldrwq_z_s32(&kept_x2[k], p)),
+                              vmaxq_s32(vdupq_n_s32(x1), vldrwq_z_s32(&kept_x1[k], p)));
+      int32x4_t h = vsubq_s32(vminq_s32(vdupq_n_s32(y2), vldrwq_z_s32(&kept_y2[k], p)),
+                              vmaxq_s32(vdupq_n_s32(y1), vldrwq_z_s32(&kept_y1[k], p)));
+      uint32_t overlap = vcmpgtq_m_n_s32(h, 0, vcmpgtq_m_n_s32(w, 0, p));
+
+      while (overlap && !suppressed)
+      {
+        int32_t j = k + (__builtin_ctz(overlap) >> 2);
+        od_pp_nms_area_t inter = (od_pp_nms_area_t)(MIN(x2, kept_x2[j]) - MAX(x1, kept_x1[j]))
+                               * (MIN(y2, kept_y2[j]) - MAX(y1, kept_y1[j]));
+
+        suppressed = (inter * one_t_q16 > t_q16 * (area + kept_area[j]));
+        overlap &= ~(0xFU << ((j - k) * 4));
+      }
+    }
+#else
+    for (int32_t k = 0; k < nb_soa; k++)
+    {
+      if (od_pp_nms_overlaps(&cand, kept_x1[k], kept_y1[k], kept_x2[k], kept_y2[k], kept_area[k],
+                             iou_threshold, t_q16, one_t_q16))
+      {
+        suppressed = 1;
+        break;
+      }
+    }
+#endif
+
+    /* Kept boxes past the SoA: every box left with a confidence since the spill */
+    for (int32_t k = spill; (k >= 0) && (k < i) && !suppressed; k++)
+    {
+      od_pp_nms_rect_t kept;
+
+      if (pBoxes[k].conf == 0) continue;
+      kept = od_pp_nms_rect(&pBoxes[k], coord_scale);
+      suppressed = od_pp_nms_overlaps(&cand, kept.x1, kept.y1, kept.x2, kept.y2, kept.area,
+                                      iou_threshold, t_q16, one_t_q16);
+    }
+
+    if (suppressed)
+    {
+      pBox->conf = 0;
+      continue;
+    }
+
+    if (nb_kept < OD_PP_NMS_MAX_KEPT)
+    {
+      kept_x1[nb_kept] = x1;
+      kept_y1[nb_kept] = y1;
+      kept_x2[nb_kept] = x2;
+      kept_y2[nb_kept] = y2;
+      kept_area[nb_kept] = area;
+    }
+    else if (spill < 0)
+    {
+      spill = i;
+    }
+    nb_kept++;
+  }
+
+  /* Early exit: everything past the limit is dropped without IoU tests */
+  for (; i < nb_boxes; i++)
+  {
+    pBoxes[i].conf = 0;
+  }
+}
+
+
+int32_t od_pp_nms_centroid(od_pp_outBuffer_t *pBoxes,
+                           int32_t nb_boxes,
+                           int32_t nb_classes,
+                           float32_t iou_threshold,
+                           int32_t max_boxes_limit)
+{
+  int32_t max_kept = max_boxes_limit;
+  float32_t coord_scale = 1.0f;
+
+  if ((nb_boxes <= 0) || (nb_classes <= 0))
+  {
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+  }
+
+#ifdef VISION_MODELS_NMS_IOU_FIXED
+  coord_scale = od_pp_nms_fixed_scale(pBoxes, nb_boxes);
+#endif
+
+  if (nb_classes == 1)
+  {
+    od_pp_nms_class(pBoxes, nb_boxes, iou_threshold, coord_scale, max_kept, 0);
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+  }
+
+  /* One stable sort groups the classes and orders each by confidence, then
+   * the class runs are walked */
+  od_pp_nms_sort_class_conf(pBoxes, nb_boxes, 0);
+  for (int32_t i = 0, j; i < nb_boxes; i = j)
+  {
+    int32_t k = pBoxes[i].class_index;
+
+    if ((k < 0) || (k >= nb_classes))
+    {
+      return (AI_OD_POSTPROCESS_ERROR);
+    }
+    for (j = i + 1; (j < nb_boxes) && (pBoxes[j].class_index == k); j++);
+    od_pp_nms_class(&pBoxes[i], j - i, iou_threshold, coord_scale, max_kept, 1);
+  }
+
+  return (AI_OD_POSTPROCESS_ERROR_NO);
+}
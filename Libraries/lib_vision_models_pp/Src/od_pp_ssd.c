@@ -11,23 +11,6 @@
 #include "od_ssd_pp_if.h"
 #include "vision_models_pp.h"
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_SSD_PP_SORT_CLASS;
-
-int32_t ssd_nms_comparator(const void *pa, const void *pb)
-{
-  od_pp_outBuffer_t *pa_s = (od_pp_outBuffer_t *)pa;
-  od_pp_outBuffer_t *pb_s = (od_pp_outBuffer_t *)pb;
-  float32_t a = (pa_s->class_index == AI_SSD_PP_SORT_CLASS) ? pa_s->conf : 0;
-  float32_t b = (pb_s->class_index == AI_SSD_PP_SORT_CLASS) ? pb_s->conf : 0;
-  float32_t diff = 0;
-
-  diff = a - b;
-
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
 
 static int32_t SSD_quick_sort_partition(float32_t *pScores,
                                         float32_t *pBoxes,
@@ -302,14 +285,13 @@ int32_t ssd_pp_nms_filtering(od_ssd_pp_in_centroid_t *pInput,
     for (k = 0; k < pInput_static_param->nb_classes; ++k)
     {
         limit_counter = 0;
-        AI_SSD_PP_SORT_CLASS = k;
 
         SSD_quick_sort_core(pScores,
                             pBoxes,
                             0,
                             pInput_static_param->nb_detect - 1,
                             0,
-                            AI_SSD_PP_SORT_CLASS,
+                            k,
                             pInput_static_param->nb_classes);
 
         for (i = 0; i < pInput_static_param->nb_detect; ++i)
@@ -322,7 +304,7 @@ int32_t ssd_pp_nms_filtering(od_ssd_pp_in_centroid_t *pInput,
             for (j = i + 1; j < pInput_static_param->nb_detect; ++j)
             {
                 float32_t *pB = &(pBoxes[AI_SSD_PP_BOX_STRIDE * j + AI_SSD_PP_CENTROID_YCENTER]);
-                if (vision_models_box_iou(pA, pB) > pInput_static_param->iou_threshold)
+                if (vision_models_box_iou_gt(pA, pB, pInput_static_param->iou_threshold))
                 {
                     pScores[j * pInput_static_param->nb_classes + k] = 0;
                 }
@@ -349,68 +331,11 @@ int32_t ssd_pp_nms_filtering(od_ssd_pp_in_centroid_t *pInput,
 int32_t ssd_pp_nms_filtering_scratchBuffer(od_pp_outBuffer_t *pScratchBuffer,
                                           od_ssd_pp_static_param_t *pInput_static_param)
 {
-  int32_t i, j, k, limit_counter;
-
-    for (k = 0; k < pInput_static_param->nb_classes; ++k)
-    {
-        limit_counter = 0;
-        int32_t detections_per_class = 0;
-        AI_SSD_PP_SORT_CLASS = k;
-
-        /* Counts the number of detections with class k */
-        for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
-        {
-            if(pScratchBuffer[i].class_index == k)
-            {
-                detections_per_class++;
-            }
-        }
-
-        if (detections_per_class > 0)
-        {
-
-          qsort(pScratchBuffer,
-              pInput_static_param->nb_detect,
-              sizeof(od_pp_outBuffer_t),
-              (_Cmpfun *)ssd_nms_comparator);
-        for (i = 0; i < detections_per_class; i++)
-        {
-            if (pScratchBuffer[i].conf == 0)
-            {
-                continue;
-            }
-            float32_t *pA = &(pScratchBuffer[i].x_center);
-            for (j = i + 1; j < detections_per_class; j++)
-            {
-                if (pScratchBuffer[j].conf == 0)
-                {
-                  continue;
-                }
-                float32_t *pB = &(pScratchBuffer[j].x_center);
-                if (vision_models_box_iou(pA, pB) > pInput_static_param->iou_threshold)
-                {
-                    pScratchBuffer[j].conf = 0;
-                }
-            }
-        }
-
-        for (int32_t it = 0; it < detections_per_class; ++it)
-        {
-            if ((pScratchBuffer[it].conf != 0) &&
-                (limit_counter < pInput_static_param->max_boxes_limit))
-            {
-                limit_counter++;
-            }
-            else
-            {
-
-                pScratchBuffer[it].conf = 0;
-            }
-        }
-        } // if detections
-    } // for k in classes
-
-    return (AI_OD_POSTPROCESS_ERROR_NO);
+  return od_pp_nms_centroid(pScratchBuffer,
+                            pInput_static_param->nb_detect,
+                            pInput_static_param->nb_classes,
+                            pInput_static_param->iou_threshold,
+                            pInput_static_param->max_boxes_limit);
 }
 
 
@@ -11,128 +11,30 @@
 #include "od_ssd_st_pp_if.h"
 #include "vision_models_pp.h"
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_SSD_ST_PP_SORT_CLASS;
 
-int32_t ssd_st_nms_comparator(const void *pa, const void *pb)
-{
-  od_pp_outBuffer_t *pa_s = (od_pp_outBuffer_t *)pa;
-  od_pp_outBuffer_t *pb_s = (od_pp_outBuffer_t *)pb;
-  float32_t a = (pa_s->class_index == AI_SSD_ST_PP_SORT_CLASS) ? pa_s->conf : 0;
-  float32_t b = (pb_s->class_index == AI_SSD_ST_PP_SORT_CLASS) ? pb_s->conf : 0;
-  float32_t diff = 0;
-
-  diff = a - b;
-
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
-
-static int32_t SSD_quick_sort_partition(float32_t *pScores,
-                                        float32_t *pBoxes,
-                                        int32_t first,
-                                        int32_t last,
-                                        int32_t dir,
-                                        int32_t ssd_sort_class,
-                                        int32_t ssd_nb_classes)
-{
-    int32_t i, j, pivot_index;
-    float32_t pivot;
-    pivot_index = first;
-    pivot = pScores[pivot_index * ssd_nb_classes + ssd_sort_class];
-    i = first - 1;
-    j = last + 1;
-
-    while (i < j)
-    {
-        if (dir)
-        {
-            do
-            {
-                i++;
-            } while ((pScores[i * ssd_nb_classes + ssd_sort_class] < pivot) &&
-                     (i < last));
-            do
-            {
-                j--;
-            } while (pScores[j * ssd_nb_classes + ssd_sort_class] > pivot);
-        }
-        else
-        {
-            do
-            {
-                i++;
-            } while ((pScores[i * ssd_nb_classes + ssd_sort_class] > pivot) &&
-                     (i < last));
-            do
-            {
-                j--;
-            } while (pScores[j * ssd_nb_classes + ssd_sort_class] < pivot);
-        }
+#include "vision_models_pp_sort.h"
 
-        if (i < j)
-        {
-            for (int _i = 0; _i < ssd_nb_classes; _i++){
-              float32_t _tmp = pScores[i * ssd_nb_classes + _i];
-              pScores[i * ssd_nb_classes + _i] = pScores[j * ssd_nb_classes + _i];
-              pScores[j * ssd_nb_classes + _i] = _tmp;
-            }
-            for (int _i = 0; _i < AI_SSD_ST_PP_BOX_STRIDE; _i++){
-              float32_t _tmp = pBoxes[i * AI_SSD_ST_PP_BOX_STRIDE + _i];
-              pBoxes[i * AI_SSD_ST_PP_BOX_STRIDE + _i] = pBoxes[j * AI_SSD_ST_PP_BOX_STRIDE + _i];
-              pBoxes[j * AI_SSD_ST_PP_BOX_STRIDE + _i] = _tmp;
-            }
-        }
-    }
-    return j;
-}
 
-static void SSD_quick_sort_core(float32_t *pScores,
-                                float32_t *pBoxes,
-                                int32_t first,
-                                int32_t last,
-                                int32_t dir,
-                                int32_t ssd_sort_class,
-                                int32_t ssd_nb_classes)
+/*
+ * Without a scratch buffer, candidates are sparse records over the scores:
+ * one per anchor whose best non-background class reaches conf_threshold,
+ * appended in the single pass over the scores. A record takes no more than
+ * the score row it replaces (2 classes or more) and its box is decoded down
+ * into the matching row of pBoxes. Only the records get sorted, suppressed
+ * and written out: past the score scan, the work follows the detections.
+ */
+typedef struct
 {
-  /*
-  dir 0  : descending
-  dir 1  : ascending
-  */
-  if (first < last)
-  {
-    int32_t pivot;
-    pivot = SSD_quick_sort_partition(pScores,
-                                     pBoxes,
-                                     first,
-                                     last,
-                                     dir,
-                                     ssd_sort_class,
-                                     ssd_nb_classes);
-    SSD_quick_sort_core(pScores,
-                        pBoxes,
-                        first,
-                        pivot,
-                        dir,
-                        ssd_sort_class,
-                        ssd_nb_classes);
-
-    SSD_quick_sort_core(pScores,
-                        pBoxes,
-                        pivot + 1,
-                        last,
-                        dir,
-                        ssd_sort_class,
-                        ssd_nb_classes);
-  }
-}
+  float32_t conf;
+  uint16_t  box;         /* Row of the decoded box in pBoxes */
+  uint16_t  class_index;
+} ssd_st_pp_cand_t;
 
+/* Class runs in increasing class order, each by decreasing confidence */
+#define SSD_ST_PP_SORT_KEY_CLASS_CONF(p, arg) \
+  ((int64_t)(-(int64_t)(p)->class_index) * 4294967296LL + (int64_t)vision_models_sort_key_f32((p)->conf))
+VISION_MODELS_SORT_DESC_DEFINE(ssd_st_pp_sort_cand, ssd_st_pp_cand_t, int64_t, SSD_ST_PP_SORT_KEY_CLASS_CONF)
 
-void ignore_background(float32_t *arr)
-{
-  arr[0] = 0.0;
-}
 
 /**
  *
@@ -145,12 +47,11 @@ int32_t ssd_st_pp_getNNBoxes(od_ssd_st_pp_in_centroid_t *pInput,
   float32_t *pScores  = (float32_t *)pInput->pScores;
   float32_t *pBoxes   = (float32_t *)pInput->pBoxes;
   float32_t *pAnchors = (float32_t *)pInput->pAnchors;
+  ssd_st_pp_cand_t *pCands = (ssd_st_pp_cand_t *)pInput->pScores;
   uint32_t nb_detect = 0;
 
   for (int32_t i = 0; i < pInput_static_param->nb_detections; i+=4)
   {
-    /*ignore_background(&(pInput->pScores[i * pInput_static_param->nb_classes]));*/
-
     float32_t best_score[4];
     uint32_t class_index[4];
 
@@ -165,30 +66,32 @@ int32_t ssd_st_pp_getNNBoxes(od_ssd_st_pp_in_centroid_t *pInput,
 
       if (best_score[_i] >= pInput_static_param->conf_threshold)
       {
-        ignore_background(&(pScores[nb_detect * pInput_static_param->nb_classes]));
-        for (int32_t k = 1; k < pInput_static_param->nb_classes; ++k)
-        {
-          pScores[nb_detect * pInput_static_param->nb_classes + k] = pScores[(i + _i) * pInput_static_param->nb_classes + k];
-        }
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN] = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN] * (pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] - pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN]);
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] * (pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] - pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN]);
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN] = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN] * (pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] - pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN]);
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] * (pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] - pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN]);
-
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN] += pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN];
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN] += pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN];
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] += pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX];
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] += pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX];
-
-        float32_t w = pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMAX] - pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN];
-        float32_t h = pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMAX] - pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN];
-        float32_t y_center = h/2 + pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_YMIN];
-        float32_t x_center = w/2 + pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_XMIN];
-
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_YCENTER]   = y_center;
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_XCENTER]   = x_center;
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_HEIGHTREL] = h;
-        pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_WIDTHREL]  = w;
+        const float32_t *pAnchor = &(pAnchors[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE]);
+        const float32_t *pBox = &(pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE]);
+        float32_t *pDecoded = &(pBoxes[nb_detect * AI_SSD_ST_PP_BOX_STRIDE]);
+
+        float32_t x_min = pBox[AI_SSD_ST_PP_XMIN] * (pAnchor[AI_SSD_ST_PP_XMAX] - pAnchor[AI_SSD_ST_PP_XMIN]);
+        float32_t x_max = pBox[AI_SSD_ST_PP_XMAX] * (pAnchor[AI_SSD_ST_PP_XMAX] - pAnchor[AI_SSD_ST_PP_XMIN]);
+        float32_t y_min = pBox[AI_SSD_ST_PP_YMIN] * (pAnchor[AI_SSD_ST_PP_YMAX] - pAnchor[AI_SSD_ST_PP_YMIN]);
+        float32_t y_max = pBox[AI_SSD_ST_PP_YMAX] * (pAnchor[AI_SSD_ST_PP_YMAX] - pAnchor[AI_SSD_ST_PP_YMIN]);
+
+        x_min += pAnchor[AI_SSD_ST_PP_XMIN];
+        y_min += pAnchor[AI_SSD_ST_PP_YMIN];
+        x_max += pAnchor[AI_SSD_ST_PP_XMAX];
+        y_max += pAnchor[AI_SSD_ST_PP_YMAX];
+
+        float32_t w = x_max - x_min;
+        float32_t h = y_max - y_min;
+
+        pDecoded[AI_SSD_ST_PP_CENTROID_YCENTER]   = h/2 + y_min;
+        pDecoded[AI_SSD_ST_PP_CENTROID_XCENTER]   = w/2 + x_min;
+        pDecoded[AI_SSD_ST_PP_CENTROID_HEIGHTREL] = h;
+        pDecoded[AI_SSD_ST_PP_CENTROID_WIDTHREL]  = w;
+
+        /* Past the score row of anchor i + _i: already read */
+        pCands[nb_detect].conf        = best_score[_i];
+        pCands[nb_detect].box         = (uint16_t)nb_detect;
+        pCands[nb_detect].class_index = (uint16_t)(class_index[_i] + 1); // +1 as starting from 1
 
         nb_detect++;
       }
@@ -271,6 +174,16 @@ int32_t ssd_st_pp_getNNBoxes_int8_scratchBuffer(od_ssd_st_pp_in_centroid_t *pInp
 
   uint32_t nb_detect = 0;
 
+  /* Threshold in the quantized domain: (q - zp) * scale >= conf */
+  int32_t conf_threshold_s8 = od_pp_threshold_q(pInput_static_param->conf_threshold, score_scale, score_zp,
+                                                INT8_MIN, INT8_MAX);
+
+  if (conf_threshold_s8 > INT8_MAX)
+  {
+    pInput_static_param->nb_detect = 0;
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+  }
+
   for (int32_t i = 0; i < pInput_static_param->nb_detections; i+=16)
   {
     int8_t best_score[16];
@@ -284,7 +197,7 @@ int32_t ssd_st_pp_getNNBoxes_int8_scratchBuffer(od_ssd_st_pp_in_centroid_t *pInp
 
     for (int _i = 0; _i < MIN(16, pInput_static_param->nb_detections-i); _i++)
     {
-      if (best_score[_i] >= pInput_static_param->conf_threshold)
+      if (best_score[_i] >= conf_threshold_s8)
       {
         float32_t value, anchor_x_min, anchor_x_max, anchor_y_min, anchor_y_max;
         pScratchBuffer[nb_detect].class_index = class_index[_i]+1; // +1 as starting from 1
@@ -327,112 +240,56 @@ int32_t ssd_st_pp_getNNBoxes_int8_scratchBuffer(od_ssd_st_pp_in_centroid_t *pInp
 int32_t ssd_st_pp_nms_filtering_scratchBuffer(od_pp_outBuffer_t *pScratchBuffer,
                                           od_ssd_st_pp_static_param_t *pInput_static_param)
 {
-  int32_t i, j, k, limit_counter;
-
-    for (k = 0; k < pInput_static_param->nb_classes; ++k)
-    {
-      limit_counter = 0;
-      int32_t detections_per_class = 0;
-      AI_SSD_ST_PP_SORT_CLASS = k;
-
-      /* Counts the number of detections with class k */
-      for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
-      {
-          if(pScratchBuffer[i].class_index == k)
-          {
-              detections_per_class++;
-          }
-      }
-
-      if (detections_per_class > 0)
-      {
-
-        qsort(pScratchBuffer,
-              pInput_static_param->nb_detect,
-              sizeof(od_pp_outBuffer_t),
-              (_Cmpfun *)ssd_st_nms_comparator);
-
-        for (i = 0; i < detections_per_class; i++)
-        {
-          if (pScratchBuffer[i].conf == 0) continue;
-          float32_t *pA = &(pScratchBuffer[i].x_center);
-          for (j = i + 1; j < detections_per_class; j++)
-          {
-            if (pScratchBuffer[j].conf == 0) continue;
-            float32_t *pB = &(pScratchBuffer[j].x_center);
-            if (vision_models_box_iou(pA, pB) > pInput_static_param->iou_threshold)
-            {
-              pScratchBuffer[j].conf = 0;
-            }
-          }
-        } // for i
-
-        for (int32_t it = 0; it < detections_per_class; ++it)
-        {
-          if ((pScratchBuffer[it].conf != 0) &&
-              (limit_counter < pInput_static_param->max_boxes_limit))
-          {
-            limit_counter++;
-          }
-          else
-          {
-            pScratchBuffer[it].conf = 0;
-          }
-        } // for it
-      } // if detections
-    } // for k in classes
-
-    return (AI_OD_POSTPROCESS_ERROR_NO);
+  return od_pp_nms_centroid(pScratchBuffer,
+                            pInput_static_param->nb_detect,
+                            pInput_static_param->nb_classes,
+                            pInput_static_param->iou_threshold,
+                            pInput_static_param->max_boxes_limit);
 }
 
 
 int32_t ssd_st_pp_nms_filtering(od_ssd_st_pp_in_centroid_t *pInput,
                                 od_ssd_st_pp_static_param_t *pInput_static_param)
 {
-  int32_t i, j, k, limit_counter;
-  float32_t *pScores = (float32_t *)pInput->pScores;
+  ssd_st_pp_cand_t *pCands = (ssd_st_pp_cand_t *)pInput->pScores;
   float32_t *pBoxes = (float32_t *)pInput->pBoxes;
+  int32_t nb_cands = pInput_static_param->nb_detect;
+  int32_t first = 0;
+
+  ssd_st_pp_sort_cand(pCands, nb_cands, 0);
 
-  for (k = 0; k < pInput_static_param->nb_classes; ++k)
+  while (first < nb_cands)
   {
-    limit_counter = 0;
-    AI_SSD_ST_PP_SORT_CLASS = k;
-
-    SSD_quick_sort_core(pInput->pScores,
-                        pInput->pBoxes,
-                        0,
-                        pInput_static_param->nb_detect - 1,
-                        0,
-                        AI_SSD_ST_PP_SORT_CLASS,
-                        pInput_static_param->nb_classes);
-
-    for (i = 0; i < pInput_static_param->nb_detect; ++i)
+    int32_t last = first + 1; /* One past the class run */
+    int32_t limit_counter = 0;
+
+    while ((last < nb_cands) && (pCands[last].class_index == pCands[first].class_index))
     {
-      if (pScores[i * pInput_static_param->nb_classes + k] == 0) continue;
-      float32_t *pA = &(pBoxes[AI_SSD_ST_PP_BOX_STRIDE * i + AI_SSD_ST_PP_CENTROID_YCENTER]);
-      for (j = i + 1; j < pInput_static_param->nb_detect; ++j)
-      {
-        if (pScores[j * pInput_static_param->nb_classes + k] == 0) continue;
-        float32_t *pB = &(pBoxes[AI_SSD_ST_PP_BOX_STRIDE * j + AI_SSD_ST_PP_CENTROID_YCENTER]);
-        if (vision_models_box_iou(pA, pB) > pInput_static_param->iou_threshold)
-        {
-          pScores[j * pInput_static_param->nb_classes + k] = 0;
-        }
-      }
+      last++;
     }
 
-    for (int32_t it = 0; it < pInput_static_param->nb_detect; ++it)
+    for (int32_t i = first; i < last; ++i)
     {
-      if ((pScores[it * pInput_static_param->nb_classes + k] != 0) &&
-          (limit_counter < pInput_static_param->max_boxes_limit))
+      if (pCands[i].conf == 0) continue;
+      if (limit_counter == pInput_static_param->max_boxes_limit)
       {
-        limit_counter++;
+        pCands[i].conf = 0;
+        continue;
       }
-      else
+      limit_counter++;
+
+      float32_t *pA = &(pBoxes[AI_SSD_ST_PP_BOX_STRIDE * pCands[i].box + AI_SSD_ST_PP_CENTROID_YCENTER]);
+      for (int32_t j = i + 1; j < last; ++j)
       {
-        pScores[it * pInput_static_param->nb_classes + k] = 0;
+        if (pCands[j].conf == 0) continue;
+        float32_t *pB = &(pBoxes[AI_SSD_ST_PP_BOX_STRIDE * pCands[j].box + AI_SSD_ST_PP_CENTROID_YCENTER]);
+        if (vision_models_box_iou_gt(pA, pB, pInput_static_param->iou_threshold))
+        {
+          pCands[j].conf = 0;
+        }
       }
     }
+    first = last;
   }
 
   return (AI_OD_POSTPROCESS_ERROR_NO);
@@ -468,35 +325,26 @@ int32_t ssd_st_pp_score_filtering(od_ssd_st_pp_in_centroid_t *pInput,
                                   od_pp_out_t *pOutput,
                                   od_ssd_st_pp_static_param_t *pInput_static_param)
 {
-  float32_t *pScores = (float32_t *)pInput->pScores;
+  ssd_st_pp_cand_t *pCands = (ssd_st_pp_cand_t *)pInput->pScores;
   float32_t *pBoxes = (float32_t *)pInput->pBoxes;
   int32_t count = 0;
-  for (int32_t i = 0; i < pInput_static_param->nb_detect; i+=4)
-  {
-    uint32_t class_index[4];
-    float32_t best_score[4];
-    vision_models_maxi_p_if32ou32(&(pScores[i * pInput_static_param->nb_classes]),
-                                  pInput_static_param->nb_classes,
-                                  pInput_static_param->nb_classes,
-                                  best_score,
-                                  class_index,
-                                  pInput_static_param->nb_detect - i);
 
-    for (int _i = 0; _i < MIN(4,pInput_static_param->nb_detect-i); _i++)
+  for (int32_t i = 0; i < pInput_static_param->nb_detect; i++)
+  {
+    if (pCands[i].conf)
     {
-      if (best_score[_i] >= pInput_static_param->conf_threshold)
-      {
-        pOutput->pOutBuff[count].class_index = class_index[_i];
-        pOutput->pOutBuff[count].conf        = best_score[_i];
-        pOutput->pOutBuff[count].x_center    = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_XCENTER];
-        pOutput->pOutBuff[count].y_center    = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_YCENTER];
-        pOutput->pOutBuff[count].width       = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_WIDTHREL];
-        pOutput->pOutBuff[count].height      = pBoxes[(i + _i) * AI_SSD_ST_PP_BOX_STRIDE + AI_SSD_ST_PP_CENTROID_HEIGHTREL];
+      float32_t *pBox = &(pBoxes[pCands[i].box * AI_SSD_ST_PP_BOX_STRIDE]);
 
-        count++;
-      } // if
-    } // for _i
-  } // for i+=4
+      pOutput->pOutBuff[count].class_index = pCands[i].class_index;
+      pOutput->pOutBuff[count].conf        = pCands[i].conf;
+      pOutput->pOutBuff[count].x_center    = pBox[AI_SSD_ST_PP_CENTROID_XCENTER];
+      pOutput->pOutBuff[count].y_center    = pBox[AI_SSD_ST_PP_CENTROID_YCENTER];
+      pOutput->pOutBuff[count].width       = pBox[AI_SSD_ST_PP_CENTROID_WIDTHREL];
+      pOutput->pOutBuff[count].height      = pBox[AI_SSD_ST_PP_CENTROID_HEIGHTREL];
+
+      count++;
+    }
+  }
 
   pOutput->nb_detect = count;
   return (AI_OD_POSTPROCESS_ERROR_NO);
@@ -563,6 +411,12 @@ int32_t od_ssd_st_pp_process(od_ssd_st_pp_in_centroid_t *pInput,
     }
     else
     {
+      /* Sparse candidates over the scores and boxes */
+      if (   (pInput_static_param->nb_classes * sizeof(float32_t) < sizeof(ssd_st_pp_cand_t))
+          || (pInput_static_param->nb_detections > UINT16_MAX + 1))
+      {
+        return AI_OD_POSTPROCESS_ERROR;
+      }
 
       /* Calls Get NN boxes first */
       error = ssd_st_pp_getNNBoxes(pInput,
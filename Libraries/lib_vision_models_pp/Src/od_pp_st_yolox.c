@@ -10,129 +10,375 @@
 #include "od_pp_loc.h"
 #include "od_st_yolox_pp_if.h"
 #include "vision_models_pp.h"
+#include <string.h>
+#if defined(VISION_MODELS_ST_YOLOX_DECODE_IF32_MVE) || defined(VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE)
+#include "arm_vec_math.h"
+#endif
 
+/* Anchors scanned per phase 1 of the int8 decode: whole 16-bit words of the anchor masks */
+#define ST_YOLOX_PP_SCAN_BLOCK (64)
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_ST_YOLOX_PP_SORT_CLASS;
 
-
-int32_t st_yolox_nms_comparator(const void *pa, const void *pb)
+int32_t st_yolox_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
+                                          od_st_yolox_pp_static_param_t *pInput_static_param)
 {
-    od_pp_outBuffer_t a = *(od_pp_outBuffer_t *)pa;
-    od_pp_outBuffer_t b = *(od_pp_outBuffer_t *)pb;
+    return od_pp_nms_centroid(pOutput->pOutBuff,
+                              pInput_static_param->nb_detect,
+                              pInput_static_param->nb_classes,
+                              pInput_static_param->iou_threshold,
+                              pInput_static_param->max_boxes_limit);
+}
 
-    float32_t diff = 0.0;
-    float32_t a_weighted_conf = 0.0;
-    float32_t b_weighted_conf = 0.0;
 
-    if (a.class_index == AI_ST_YOLOX_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
+int32_t st_yolox_pp_scoreFiltering_centroid(od_pp_out_t *pOutput,
+                                            od_st_yolox_pp_static_param_t *pInput_static_param)
+{
+    int32_t det_count = 0;
+
+    for (int32_t i = 0; i < pInput_static_param->nb_detect; i++)
     {
-         a_weighted_conf = 0.0;
+        if (pOutput->pOutBuff[i].conf >= pInput_static_param->conf_threshold)
+        {
+            pOutput->pOutBuff[det_count].x_center = pOutput->pOutBuff[i].x_center;
+            pOutput->pOutBuff[det_count].y_center = pOutput->pOutBuff[i].y_center;
+            pOutput->pOutBuff[det_count].width = pOutput->pOutBuff[i].width;
+            pOutput->pOutBuff[det_count].height = pOutput->pOutBuff[i].height;
+            pOutput->pOutBuff[det_count].conf = pOutput->pOutBuff[i].conf;
+            pOutput->pOutBuff[det_count].class_index = pOutput->pOutBuff[i].class_index;
+            det_count++;
+        }
     }
+    pOutput->nb_detect = det_count;
+
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+}
+
+
+/* Candidate store. Unbounded (max_cand <= 0), candidates are appended. Bounded,
+ * pOutBuff is a min-heap on conf of at most max_cand entries: once full, a
+ * candidate only goes in by evicting the weakest one, so the store never
+ * outgrows max_cand entries and NMS never sees more. The heap spans every
+ * class, NMS keeps max_boxes_limit per class: with more than max_cand cells
+ * above threshold the result may differ from the unbounded store's, and it
+ * can lose boxes NMS would keep once max_cand < nb_classes * max_boxes_limit. */
 
-    if (b.class_index == AI_ST_YOLOX_PP_SORT_CLASS)
+/* Slot to write a candidate of confidence conf to, -1 to drop it */
+static inline int32_t st_yolox_pp_cand_reserve(const od_pp_outBuffer_t *pOutBuff,
+                                               int32_t det_count,
+                                               int32_t max_cand,
+                                               float32_t conf)
+{
+  if ((max_cand <= 0) || (det_count < max_cand))
+  {
+    return det_count;
+  }
+  return (conf > pOutBuff[0].conf) ? 0 : -1;
+}
+
+/* Restore the heap after a candidate was written to slot; returns the new count */
+static int32_t st_yolox_pp_cand_commit(od_pp_outBuffer_t *pOutBuff,
+                                       int32_t det_count,
+                                       int32_t max_cand,
+                                       int32_t slot)
+{
+  od_pp_outBuffer_t tmp;
+
+  if (max_cand <= 0)
+  {
+    return det_count + 1;
+  }
+
+  if (slot == det_count)
+  {
+    /* Appended: sift up */
+    tmp = pOutBuff[slot];
+    while (slot > 0)
     {
-        b_weighted_conf = b.conf;
+      int32_t parent = (slot - 1) / 2;
+      if (pOutBuff[parent].conf <= tmp.conf) break;
+      pOutBuff[slot] = pOutBuff[parent];
+      slot = parent;
     }
-    else
+    pOutBuff[slot] = tmp;
+    return det_count + 1;
+  }
+
+  /* Root replaced: sift down */
+  tmp = pOutBuff[0];
+  slot = 0;
+  for (;;)
+  {
+    int32_t child = 2 * slot + 1;
+    if (child >= det_count) break;
+    if ((child + 1 < det_count) && (pOutBuff[child + 1].conf < pOutBuff[child].conf)) child++;
+    if (tmp.conf <= pOutBuff[child].conf) break;
+    pOutBuff[slot] = pOutBuff[child];
+    slot = child;
+  }
+  pOutBuff[slot] = tmp;
+  return det_count;
+}
+
+
+/* Activations of an int8 raw value: a level table load, computed when there is no table */
+static inline float32_t st_yolox_pp_sigmoid_is8(int8_t q,
+                                                const od_st_yolox_pp_lut_is8_t *pLut,
+                                                float32_t raw_scale,
+                                                int8_t raw_zp)
+{
+  if (pLut != NULL)
+  {
+    return pLut->sigmoid[AI_OD_ST_YOLOX_PP_LUT_INDEX(q)];
+  }
+  return vision_models_sigmoid_f((float32_t)((int32_t)q - raw_zp) * raw_scale);
+}
+
+static inline float32_t st_yolox_pp_exp_is8(int8_t q,
+                                            const od_st_yolox_pp_lut_is8_t *pLut,
+                                            float32_t raw_scale,
+                                            int8_t raw_zp)
+{
+  if (pLut != NULL)
+  {
+    return pLut->exp[AI_OD_ST_YOLOX_PP_LUT_INDEX(q)];
+  }
+  return expf((float32_t)((int32_t)q - raw_zp) * raw_scale);
+}
+
+/* Decode the box of an int8 anchor record of cell (row, col) */
+static inline void st_yolox_pp_store_box_is8(od_pp_outBuffer_t *pOut,
+                                             const int8_t *pAnch,
+                                             const od_st_yolox_pp_lut_is8_t *pLut,
+                                             int32_t row,
+                                             int32_t col,
+                                             const float32_t *pAnchor,
+                                             float32_t grid_width_inv,
+                                             float32_t grid_height_inv,
+                                             float32_t raw_scale,
+                                             int8_t raw_zp)
+{
+  pOut->x_center = (col + st_yolox_pp_sigmoid_is8(pAnch[AI_YOLOV2_PP_XCENTER], pLut, raw_scale, raw_zp)) * grid_width_inv;
+  pOut->y_center = (row + st_yolox_pp_sigmoid_is8(pAnch[AI_YOLOV2_PP_YCENTER], pLut, raw_scale, raw_zp)) * grid_height_inv;
+  pOut->width    = (pAnchor[0] * st_yolox_pp_exp_is8(pAnch[AI_YOLOV2_PP_WIDTHREL], pLut, raw_scale, raw_zp)) * grid_width_inv;
+  pOut->height   = (pAnchor[1] * st_yolox_pp_exp_is8(pAnch[AI_YOLOV2_PP_HEIGHTREL], pLut, raw_scale, raw_zp)) * grid_height_inv;
+}
+
+/* Fill a table pair with the activations of every int8 raw value: the
+ * sigmoids of one tensor quantization, the exponentials of another (the
+ * same one for a concatenated level) */
+static void st_yolox_pp_lut_build_is8(od_st_yolox_pp_lut_is8_t *pLut,
+                                      float32_t sigmoid_scale,
+                                      int8_t sigmoid_zp,
+                                      float32_t exp_scale,
+                                      int8_t exp_zp)
+{
+  for (int32_t q = INT8_MIN; q <= INT8_MAX; q++)
+  {
+    pLut->sigmoid[AI_OD_ST_YOLOX_PP_LUT_INDEX(q)] = st_yolox_pp_sigmoid_is8((int8_t)q, NULL, sigmoid_scale, sigmoid_zp);
+    pLut->exp[AI_OD_ST_YOLOX_PP_LUT_INDEX(q)]     = st_yolox_pp_exp_is8((int8_t)q, NULL, exp_scale, exp_zp);
+  }
+}
+
+
+/* Expand the cell mask of a level to one bit per anchor, in the flat anchor
+ * order of the decode. The bits past the last anchor are set: a block whose
+ * anchors are all excluded is skipped whole */
+static void st_yolox_pp_anchor_mask_build(uint16_t *pMask,
+                                          const uint8_t *pCells,
+                                          int32_t nb_cells,
+                                          int32_t nb_anchors)
+{
+  int32_t nb_total = nb_cells * nb_anchors;
+  int32_t nb_bits = AI_OD_ST_YOLOX_PP_ANCHOR_MASK_NB(nb_cells, 1, nb_anchors) * 16;
+
+  memset(pMask, 0, (size_t)nb_bits / 8);
+  for (int32_t n = 0; n < nb_bits; n++)
+  {
+    int32_t cell = n / nb_anchors;
+
+    if ((n >= nb_total) || ((pCells[cell >> 3] >> (cell & 7)) & 1U))
     {
-         b_weighted_conf = 0.0;
+      pMask[n >> 4] |= (uint16_t)(1U << (n & 15));
     }
+  }
+}
 
-    diff = a_weighted_conf - b_weighted_conf;
+/* Anchor n of a level is left out of the decode */
+static inline int32_t st_yolox_pp_masked(const uint16_t *pMask, int32_t n)
+{
+  return (pMask != NULL) && ((pMask[n >> 4] >> (n & 15)) & 1U);
+}
 
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
+/* Every anchor of the scan block at n (a multiple of ST_YOLOX_PP_SCAN_BLOCK) is left out */
+static inline int32_t st_yolox_pp_block_masked(const uint16_t *pMask, int32_t n)
+{
+  uint16_t all = UINT16_MAX;
+
+  if (pMask == NULL)
+  {
     return 0;
+  }
+  for (int32_t w = 0; w < ST_YOLOX_PP_SCAN_BLOCK / 16; w++)
+  {
+    all &= pMask[(n >> 4) + w];
+  }
+  return all == UINT16_MAX;
 }
 
-int32_t st_yolox_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
-                                          od_st_yolox_pp_static_param_t *pInput_static_param)
+/* Mask of a level for the decode: NULL when every cell is decoded */
+static inline const uint16_t *st_yolox_pp_level_mask(const od_st_yolox_pp_static_param_t *pInput_static_param,
+                                                     int32_t level)
 {
-    int32_t j, k, limit_counter, detections_per_class;
-    for (k = 0; k < pInput_static_param->nb_classes; ++k)
-    {
-        limit_counter = 0;
-        detections_per_class = 0;
-        AI_ST_YOLOX_PP_SORT_CLASS = k;
+  return (pInput_static_param->pCellMask[level] != NULL) ? pInput_static_param->pAnchorMask[level] : NULL;
+}
 
 
-        /* Counts the number of detections with class k */
-        for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
-        {
-            if(pOutput->pOutBuff[i].class_index == k)
-            {
-                detections_per_class++;
-            }
-        }
+#if defined(VISION_MODELS_ST_YOLOX_DECODE_IF32_MVE) || defined(VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE)
+/* Activate one raw box [x, y, w, h] in a single vector: sigmoid on the centre, exp on the size */
+static inline float32x4_t st_yolox_pp_activate_box_mve(float32x4_t f32x4_raw)
+{
+  static const float32_t sign[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+  float32x4_t f32x4_exp = vexpq_f32(vmulq_f32(f32x4_raw, vld1q_f32(sign)));
+  float32x4_t f32x4_sig = vrecip_hiprec_f32(vaddq_n_f32(f32x4_exp, 1.0f));
 
-        if (detections_per_class > 0)
-        {
-            /* Sorts detections based on class k */
-            qsort(pOutput->pOutBuff,
-                  pInput_static_param->nb_detect,
-                  sizeof(od_pp_outBuffer_t),
-                  st_yolox_nms_comparator);
-
-            for (int32_t i = 0; i < detections_per_class ; i ++)
-            {
-                if (pOutput->pOutBuff[i].conf == 0) continue;
-                float32_t *a = &(pOutput->pOutBuff[i].x_center);
-                for (j = i + 1; j < detections_per_class; j ++)
-                {
-                    if (pOutput->pOutBuff[j].conf == 0) continue;
-                    float32_t *b = &(pOutput->pOutBuff[j].x_center);
-                    if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
-                    {
-                        pOutput->pOutBuff[j].conf = 0;
-                    }
-                }
-            }
+  /* Lanes 0-1 (predicate bytes 0-7) take the sigmoid, lanes 2-3 keep exp */
+  return vpselq_f32(f32x4_sig, f32x4_exp, 0x00FF);
+}
 
-            /* Limits detections count */
-            for (int32_t i = 0; i < detections_per_class; i++)
-            {
-                if ((limit_counter < pInput_static_param->max_boxes_limit) &&
-                    (pOutput->pOutBuff[i].conf != 0))
-                {
-                    limit_counter++;
-                }
-                else
-                {
-                    pOutput->pOutBuff[i].conf = 0;
-                }
-            }
-        }
-    }
-    return (AI_OD_POSTPROCESS_ERROR_NO);
+/* Store an activated box for flat anchor index n of a level */
+static inline void st_yolox_pp_store_box_mve(od_pp_outBuffer_t *pOut,
+                                             float32x4_t f32x4_box,
+                                             int32_t n,
+                                             const float32_t *pAnchors,
+                                             int32_t grid_height,
+                                             int32_t nb_anchors,
+                                             float32_t grid_width_inv,
+                                             float32_t grid_height_inv)
+{
+  /* Same traversal as the scalar loops: row, then col (< grid_height), then anchor */
+  int32_t anch = n % nb_anchors;
+  int32_t cell = n / nb_anchors;
+  int32_t row  = cell / grid_height;
+  int32_t col  = cell % grid_height;
+
+  pOut->x_center    = (col + vgetq_lane_f32(f32x4_box, 0)) * grid_width_inv;
+  pOut->y_center    = (row + vgetq_lane_f32(f32x4_box, 1)) * grid_height_inv;
+  pOut->width       = (pAnchors[2 * anch + 0] * vgetq_lane_f32(f32x4_box, 2)) * grid_width_inv;
+  pOut->height      = (pAnchors[2 * anch + 1] * vgetq_lane_f32(f32x4_box, 3)) * grid_height_inv;
+  pOut->class_index = 0;
 }
+#endif
+
+#ifdef VISION_MODELS_ST_YOLOX_DECODE_IF32_MVE
+/* Single-class float decode: objectness of 4 anchors gathered per compare, boxes decoded only for survivors */
+static int32_t st_yolox_pp_level_decode_1c_if32_mve(float32_t *pInbuff,
+                                                    od_pp_outBuffer_t *pOutBuff,
+                                                    int32_t det_count,
+                                                    int32_t max_cand,
+                                                    float32_t *pAnchors,
+                                                    int32_t grid_width,
+                                                    int32_t grid_height,
+                                                    int32_t nb_anchors,
+                                                    float32_t threshold,
+                                                    const uint16_t *pMask)
+{
+  /* 4 anchor mask bits to the predicate of 4 32-bit lanes */
+  static const uint16_t lane_pred[16] = {
+    0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+    0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF,
+  };
+  const int32_t anch_stride = AI_YOLOV2_PP_CLASSPROB + 1;
+  const int32_t nb_total = grid_width * grid_height * nb_anchors;
+  float32_t grid_width_inv = 1.0f / grid_width;
+  float32_t grid_height_inv = 1.0f / grid_height;
+  uint32x4_t u32x4_offs = vaddq_n_u32(vmulq_n_u32(vidupq_n_u32(0, 1), anch_stride), AI_YOLOV2_PP_OBJECTNESS);
+
+  for (int32_t n = 0; n < nb_total; n += 4)
+  {
+    mve_pred16_t p = vctp32q(nb_total - n);
 
+    if (pMask != NULL)
+    {
+      p &= ~lane_pred[(pMask[n >> 4] >> (n & 15)) & 0xFU];
+      if (p == 0) continue;
+    }
+    float32x4_t f32x4_obj = vldrwq_gather_shifted_offset_z_f32(&pInbuff[n * anch_stride], u32x4_offs, p);
+    mve_pred16_t p_keep = vcmpgeq_m_n_f32(f32x4_obj, threshold, p);
 
-int32_t st_yolox_pp_scoreFiltering_centroid(od_pp_out_t *pOutput,
-                                            od_st_yolox_pp_static_param_t *pInput_static_param)
+    if (p_keep == 0) continue;
+
+    for (int32_t lane = 0; lane < 4; lane++)
+    {
+      if ((p_keep & (1U << (4 * lane))) == 0) continue;
+
+      float32_t *pAnch = &pInbuff[(n + lane) * anch_stride];
+      float32_t conf = vision_models_sigmoid_f(pAnch[AI_YOLOV2_PP_OBJECTNESS]);
+      int32_t slot = st_yolox_pp_cand_reserve(pOutBuff, det_count, max_cand, conf);
+      if (slot < 0) continue;
+
+      float32x4_t f32x4_box = st_yolox_pp_activate_box_mve(vld1q_f32(pAnch));
+      st_yolox_pp_store_box_mve(&pOutBuff[slot], f32x4_box, n + lane, pAnchors,
+                                grid_height, nb_anchors, grid_width_inv, grid_height_inv);
+      pOutBuff[slot].conf = conf;
+      det_count = st_yolox_pp_cand_commit(pOutBuff, det_count, max_cand, slot);
+    }
+  }
+
+  return det_count;
+}
+#endif
+
+/* Phase 1 of the int8 decode: the flat indices, within [n, n + nb), of the
+ * anchors whose objectness (pObj[i * anch_stride] for anchor i) reaches
+ * threshold_s8. conf = objectness x class score <= objectness, so no other
+ * anchor can pass conf_threshold. */
+static int32_t st_yolox_pp_scan_objectness_is8(const int8_t *pObj,
+                                               int32_t n,
+                                               int32_t nb,
+                                               int32_t anch_stride,
+                                               int32_t threshold_s8,
+                                               const uint16_t *pMask,
+                                               int32_t *pIdx)
 {
-    int32_t det_count = 0;
+  int32_t nb_keep = 0;
 
-    for (int32_t i = 0; i < pInput_static_param->nb_detect; i++)
+#ifdef VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE
+  /* Objectness of 16 anchors gathered per integer compare, as long as the byte offsets fit */
+  if (15 * anch_stride <= UINT8_MAX)
+  {
+    uint8x16_t u8x16_offs = vmulq_n_u8(vidupq_n_u8(0, 1), anch_stride);
+
+    for (int32_t i = 0; i < nb; i += 16)
     {
-        if (pOutput->pOutBuff[i].conf >= pInput_static_param->conf_threshold)
-        {
-            pOutput->pOutBuff[det_count].x_center = pOutput->pOutBuff[i].x_center;
-            pOutput->pOutBuff[det_count].y_center = pOutput->pOutBuff[i].y_center;
-            pOutput->pOutBuff[det_count].width = pOutput->pOutBuff[i].width;
-            pOutput->pOutBuff[det_count].height = pOutput->pOutBuff[i].height;
-            pOutput->pOutBuff[det_count].conf = pOutput->pOutBuff[i].conf;
-            pOutput->pOutBuff[det_count].class_index = pOutput->pOutBuff[i].class_index;
-            det_count++;
-        }
+      mve_pred16_t p = vctp8q(nb - i);
+
+      /* n + i is a multiple of 16: one mask word, one bit per lane */
+      if (pMask != NULL)
+      {
+        p &= ~pMask[(n + i) >> 4];
+      }
+      int8x16_t s8x16_obj = vldrbq_gather_offset_z_s8(&pObj[(n + i) * anch_stride], u8x16_offs, p);
+      uint32_t keep = vcmpgeq_m_n_s8(s8x16_obj, (int8_t)threshold_s8, p);
+
+      while (keep != 0)
+      {
+        pIdx[nb_keep++] = n + i + (int32_t)__builtin_ctz(keep);
+        keep &= keep - 1;
+      }
     }
-    pOutput->nb_detect = det_count;
+    return nb_keep;
+  }
+#endif
 
-    return (AI_OD_POSTPROCESS_ERROR_NO);
+  for (int32_t i = n; i < n + nb; i++)
+  {
+    if (   ((int32_t)pObj[i * anch_stride] >= threshold_s8)
+        && !st_yolox_pp_masked(pMask, i))
+    {
+      pIdx[nb_keep++] = i;
+    }
+  }
+  return nb_keep;
 }
 
 
@@ -141,48 +387,61 @@ int32_t st_yolox_pp_level_decode_and_store(float32_t *pInbuff,
                                            float32_t *pAnchors,
                                            int32_t grid_width,
                                            int32_t grid_height,
-                                           od_st_yolox_pp_static_param_t *pInput_static_param)
+                                           od_st_yolox_pp_static_param_t *pInput_static_param,
+                                           const uint16_t *pMask)
 
 {
     int32_t el_offset    = 0;
+    int32_t n            = 0;
     float32_t best_score = 0;
     uint32_t class_index;
     int32_t anch_stride = (pInput_static_param->nb_classes + AI_YOLOV2_PP_CLASSPROB);
     float32_t grid_width_inv = 1.0f / grid_width;
     float32_t grid_height_inv = 1.0f / grid_height;
     int32_t det_count = pInput_static_param->nb_detect;
+    int32_t max_cand = pInput_static_param->max_candidates;
     od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
 
     if ( 1 == pInput_static_param->nb_classes) {
       float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
+#ifdef VISION_MODELS_ST_YOLOX_DECODE_IF32_MVE
+      det_count = st_yolox_pp_level_decode_1c_if32_mve(pInbuff, pOutBuff, det_count, max_cand, pAnchors,
+                                                       grid_width, grid_height,
+                                                       pInput_static_param->nb_anchors,
+                                                       computedThreshold, pMask);
+#else
       for (int32_t row = 0; row < grid_width; ++row)
       {
         for (int32_t col = 0; col < grid_height; ++col)
         {
           for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch)
           {
-            if ( pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS] >= computedThreshold) {
+            if ((pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS] >= computedThreshold) && !st_yolox_pp_masked(pMask, n)) {
 
               /* read and activate objectness */
               float32_t prob = vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS]);
+              int32_t slot = st_yolox_pp_cand_reserve(pOutBuff, det_count, max_cand, prob);
 
               /* activate array of classes pred */
+              if (slot >= 0) {
+                pOutBuff[slot].conf = prob;
+                pOutBuff[slot].class_index = 0;
 
-              pOutBuff[det_count].conf = prob;
-              pOutBuff[det_count].class_index = 0;
-
-              pOutBuff[det_count].x_center   = (col + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_XCENTER]))   * grid_width_inv;
-              pOutBuff[det_count].y_center   = (row + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_YCENTER]))   * grid_height_inv;
-              pOutBuff[det_count].width      = (pAnchors[2 * anch + 0] * expf(pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL]))  * grid_width_inv;
-              pOutBuff[det_count].height     = (pAnchors[2 * anch + 1] * expf(pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL])) * grid_height_inv;
+                pOutBuff[slot].x_center   = (col + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_XCENTER]))   * grid_width_inv;
+                pOutBuff[slot].y_center   = (row + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_YCENTER]))   * grid_height_inv;
+                pOutBuff[slot].width      = (pAnchors[2 * anch + 0] * expf(pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL]))  * grid_width_inv;
+                pOutBuff[slot].height     = (pAnchors[2 * anch + 1] * expf(pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL])) * grid_height_inv;
 
-              det_count++;
+                det_count = st_yolox_pp_cand_commit(pOutBuff, det_count, max_cand, slot);
+              }
             }
 
              el_offset += anch_stride;
+             n++;
           } // for anchh
         } // for col
       } // for row
+#endif
     } // if nb_classes == 1
     else
     {
@@ -190,8 +449,13 @@ int32_t st_yolox_pp_level_decode_and_store(float32_t *pInbuff,
       {
           for (int32_t col = 0; col < grid_height; ++col)
           {
-              for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch)
+              for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch, ++n)
               {
+                  if (st_yolox_pp_masked(pMask, n))
+                  {
+                      el_offset += anch_stride;
+                      continue;
+                  }
                   vision_models_maxi_p_if32ou32(&pInbuff[el_offset + AI_YOLOV2_PP_CLASSPROB],
                                               pInput_static_param->nb_classes,
                                               anch_stride,
@@ -210,17 +474,20 @@ int32_t st_yolox_pp_level_decode_and_store(float32_t *pInbuff,
                   best_score = expf(best_score) / sumf;
                   best_score *= prob;
 
-                  if (best_score >= pInput_static_param->conf_threshold)
+                  int32_t slot = (best_score >= pInput_static_param->conf_threshold)
+                               ? st_yolox_pp_cand_reserve(pOutBuff, det_count, max_cand, best_score)
+                               : -1;
+                  if (slot >= 0)
                   {
 
-                      pOutBuff[det_count].x_center    = (col + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_XCENTER]))   * grid_width_inv;
-                      pOutBuff[det_count].y_center    = (row + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_YCENTER]))   * grid_height_inv;
-                      pOutBuff[det_count].width       = (pAnchors[2 * anch + 0] * expf(pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL]))  * grid_width_inv;
-                      pOutBuff[det_count].height      = (pAnchors[2 * anch + 1] * expf(pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL])) * grid_height_inv;
-                      pOutBuff[det_count].conf        = best_score;
-                      pOutBuff[det_count].class_index = class_index;
+                      pOutBuff[slot].x_center       = (col + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_XCENTER]))   * grid_width_inv;
+                      pOutBuff[slot].y_center       = (row + vision_models_sigmoid_f(pInbuff[el_offset + AI_YOLOV2_PP_YCENTER]))   * grid_height_inv;
+                      pOutBuff[slot].width          = (pAnchors[2 * anch + 0] * expf(pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL]))  * grid_width_inv;
+                      pOutBuff[slot].height         = (pAnchors[2 * anch + 1] * expf(pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL])) * grid_height_inv;
+                      pOutBuff[slot].conf           = best_score;
+                      pOutBuff[slot].class_index    = class_index;
 
-                      det_count++;
+                      det_count = st_yolox_pp_cand_commit(pOutBuff, det_count, max_cand, slot);
                   }
 
                   el_offset += anch_stride;
@@ -240,126 +507,235 @@ int32_t st_yolox_pp_level_decode_and_store_is8(int8_t *pInbuff,
                                                int32_t grid_width,
                                                int32_t grid_height,
                                                od_st_yolox_pp_static_param_t *pInput_static_param,
+                                               const od_st_yolox_pp_lut_is8_t *pLut,
                                                float32_t raw_scale,
-                                               int8_t raw_zp)
+                                               int8_t raw_zp,
+                                               const uint16_t *pMask)
 
 {
-  int32_t el_offset    = 0;
-  int32_t anch_stride = (pInput_static_param->nb_classes + AI_YOLOV2_PP_CLASSPROB);
+  int32_t nb_classes = pInput_static_param->nb_classes;
+  int32_t nb_anchors = pInput_static_param->nb_anchors;
+  int32_t anch_stride = (nb_classes + AI_YOLOV2_PP_CLASSPROB);
+  int32_t nb_total = grid_width * grid_height * nb_anchors;
   float32_t grid_width_inv = 1.0f / grid_width;
   float32_t grid_height_inv = 1.0f / grid_height;
+  int32_t keep_idx[ST_YOLOX_PP_SCAN_BLOCK];
 
 
   int32_t det_count = pInput_static_param->nb_detect;
+  int32_t max_cand = pInput_static_param->max_candidates;
   od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
 
-  if ( 1 == pInput_static_param->nb_classes) {
+  /* Objectness threshold in the quantized domain: sigmoid(x) >= conf  <=>  x >= logit(conf) */
+  float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
+  int32_t threshold_s8  = od_pp_threshold_q(computedThreshold, raw_scale, raw_zp, INT8_MIN, INT8_MAX);
+
+  if (threshold_s8 > INT8_MAX)
+  {
+    return det_count;
+  }
+
+  for (int32_t n = 0; n < nb_total; n += ST_YOLOX_PP_SCAN_BLOCK)
+  {
+    if (st_yolox_pp_block_masked(pMask, n))
+    {
+      continue;
+    }
 
-    float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
-    int8_t threshold_s8  = (int8_t)(computedThreshold / raw_scale + 0.5 + raw_zp);
+    int32_t nb_keep = st_yolox_pp_scan_objectness_is8(&pInbuff[AI_YOLOV2_PP_OBJECTNESS], n,
+                                                      MIN(ST_YOLOX_PP_SCAN_BLOCK, nb_total - n),
+                                                      anch_stride, threshold_s8, pMask, keep_idx);
 
-    for (int32_t row = 0; row < grid_width; ++row)
+    /* Phase 2: geometry and class of the survivors only */
+    for (int32_t k = 0; k < nb_keep; k++)
     {
-      for (int32_t col = 0; col < grid_height; ++col)
+      /* Same traversal as the float loops: row, then col (< grid_height), then anchor */
+      int32_t anch = keep_idx[k] % nb_anchors;
+      int32_t cell = keep_idx[k] / nb_anchors;
+      int8_t *pAnch = &pInbuff[keep_idx[k] * anch_stride];
+      float32_t prob = st_yolox_pp_sigmoid_is8(pAnch[AI_YOLOV2_PP_OBJECTNESS], pLut, raw_scale, raw_zp);
+      uint8_t class_index_u8 = 0;
+      float32_t best_score = prob;
+
+      if (nb_classes != 1)
       {
-        for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch)
+        int8_t best_score_s8;
+
+        vision_models_maxi_p_is8ou8(&pAnch[AI_YOLOV2_PP_CLASSPROB],
+                                    nb_classes,
+                                    anch_stride,
+                                    &best_score_s8,
+                                    &class_index_u8,
+                                    1);
+
+        /* activate array of classes pred */
+        /* in placce softmax */
+        float32_t sumf = 0.0;
+        for (int _i = 0; _i < nb_classes; _i++) {
+            sumf+= st_yolox_pp_exp_is8(pAnch[AI_YOLOV2_PP_CLASSPROB + _i], pLut, raw_scale, raw_zp);
+        }
+        best_score = st_yolox_pp_exp_is8(best_score_s8, pLut, raw_scale, raw_zp) / sumf;
+        best_score *= prob;
+
+        if (best_score < pInput_static_param->conf_threshold)
         {
-          if ( pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS] >= threshold_s8) {
+          continue;
+        }
+      }
 
-            /* read and activate objectness */
-            float32_t dequant;
-            float32_t anchor;
-            dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS] - raw_zp) * raw_scale;
-            float32_t prob = vision_models_sigmoid_f(dequant);
-            pOutBuff[det_count].conf = prob;
-            pOutBuff[det_count].class_index = 0;
+      int32_t slot = st_yolox_pp_cand_reserve(pOutBuff, det_count, max_cand, best_score);
+      if (slot < 0)
+      {
+        continue;
+      }
 
-            dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_XCENTER] - raw_zp) * raw_scale;
-            pOutBuff[det_count].x_center   = (col + vision_models_sigmoid_f(dequant)) * grid_width_inv;
+#ifdef VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE
+      if (pLut == NULL)
+      {
+        float32x4_t f32x4_raw = vmulq_n_f32(vcvtq_f32_s32(vsubq_n_s32(vldrbq_s32(pAnch), raw_zp)), raw_scale);
+        float32x4_t f32x4_box = st_yolox_pp_activate_box_mve(f32x4_raw);
+        st_yolox_pp_store_box_mve(&pOutBuff[slot], f32x4_box, keep_idx[k], pAnchors,
+                                  grid_height, nb_anchors, grid_width_inv, grid_height_inv);
+      }
+      else
+#endif
+      {
+        st_yolox_pp_store_box_is8(&pOutBuff[slot], pAnch, pLut, cell / grid_height, cell % grid_height,
+                                  &pAnchors[2 * anch], grid_width_inv, grid_height_inv, raw_scale, raw_zp);
+      }
+      pOutBuff[slot].conf           = best_score;
+      pOutBuff[slot].class_index    = class_index_u8;
 
-            dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_YCENTER] - raw_zp) * raw_scale;
-            pOutBuff[det_count].y_center   = (row + vision_models_sigmoid_f(dequant)) * grid_height_inv;
+      det_count = st_yolox_pp_cand_commit(pOutBuff, det_count, max_cand, slot);
+    }
+  }
+  pInput_static_param->nb_detect = det_count;
 
-            dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL] - raw_zp) * raw_scale;
-            anchor                          = (float32_t)(pAnchors[2 * anch + 0]);
-            pOutBuff[det_count].width      = (anchor * expf(dequant)) * grid_width_inv;
+  return det_count;
 
-            dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL] - raw_zp) * raw_scale;
-            anchor                          = (float32_t)(pAnchors[2 * anch + 1]);
-            pOutBuff[det_count].height     = (anchor * expf(dequant)) * grid_height_inv;
+}
 
-            det_count++;
-          }
-
-           el_offset += anch_stride;
-        } // for anchh
-      } // for col
-    } // for row
-  } // if nb_classes == 1
-  else
-  {
-    int8_t best_score_s8;
-    uint8_t class_index_u8;
-    float32_t best_score;
 
+/* int8 decode of one level given as its split head tensors, each read in
+ * place with its own quantization: box [cell][anchor][4], objectness
+ * [cell][anchor] and class scores [cell][anchor][nb_classes] */
+int32_t st_yolox_pp_level_decode_and_store_heads_is8(const od_st_yolox_pp_head_in_t *pHead,
+                                                     od_pp_out_t *pOutput,
+                                                     const float32_t *pAnchors,
+                                                     int32_t grid_width,
+                                                     int32_t grid_height,
+                                                     od_st_yolox_pp_static_param_t *pInput_static_param,
+                                                     int32_t level,
+                                                     const uint16_t *pMask)
 
-    for (int32_t row = 0; row < grid_width; ++row)
-    {
-      for (int32_t col = 0; col < grid_height; ++col)
-      {
-        for (int32_t anch = 0; anch < pInput_static_param->nb_anchors; ++anch)
-        {
-          vision_models_maxi_p_is8ou8(&pInbuff[el_offset + AI_YOLOV2_PP_CLASSPROB],
-                                    pInput_static_param->nb_classes,
-                                    anch,
-                                    &best_score_s8,
-                                    &class_index_u8,
-                                    1);
-          /* read and activate objectness */
-          float32_t dequant;
-          dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_OBJECTNESS] - raw_zp) * raw_scale;
-          float32_t prob = vision_models_sigmoid_f(dequant);
-
-          /* activate array of classes pred */
-          /* in placce softmax */
-          float32_t sumf = 0.0;
-          for (int _i = 0; _i < pInput_static_param->nb_classes; _i++) {
-              dequant = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_CLASSPROB + _i] - raw_zp) * raw_scale;
-              sumf+= expf(dequant);
-          }
-          dequant = (float32_t)((int32_t)best_score_s8 - raw_zp) * raw_scale;
-          best_score = expf(dequant) / sumf;
-          best_score *= prob;
-
-          if (best_score >= pInput_static_param->conf_threshold)
-          {
-            float32_t anchor;
+{
+  int32_t nb_classes = pInput_static_param->nb_classes;
+  int32_t nb_anchors = pInput_static_param->nb_anchors;
+  int32_t nb_total = grid_width * grid_height * nb_anchors;
+  float32_t grid_width_inv = 1.0f / grid_width;
+  float32_t grid_height_inv = 1.0f / grid_height;
+  const float32_t *scale = pInput_static_param->head_scale[level];
+  const int8_t *zp = pInput_static_param->head_zero_point[level];
+  int8_t *pBox = (int8_t *)pHead->pBox;
+  int8_t *pObj = (int8_t *)pHead->pObj;
+  int8_t *pCls = (int8_t *)pHead->pCls;
+  const od_st_yolox_pp_lut_is8_t *pBoxLut = NULL;
+  const od_st_yolox_pp_lut_is8_t *pScoreLut = NULL;
+  int32_t keep_idx[ST_YOLOX_PP_SCAN_BLOCK];
 
-            dequant                         = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_XCENTER] - raw_zp) * raw_scale;
-            pOutBuff[det_count].x_center    = (col + vision_models_sigmoid_f(dequant)) * grid_width_inv;
 
-            dequant                         = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_YCENTER] - raw_zp) * raw_scale;
-            pOutBuff[det_count].y_center    = (row + vision_models_sigmoid_f(dequant)) * grid_height_inv;
+  int32_t det_count = pInput_static_param->nb_detect;
+  int32_t max_cand = pInput_static_param->max_candidates;
+  od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
 
-            dequant                         = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_WIDTHREL] - raw_zp) * raw_scale;
-            anchor                          = (float32_t)pAnchors[2 * anch + 0];
-            pOutBuff[det_count].width       = (anchor * expf(dequant)) * grid_width_inv;
+  if (pInput_static_param->pLut != NULL)
+  {
+    pBoxLut = &pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_HEADS_LUT_BOX(level)];
+    pScoreLut = &pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_HEADS_LUT_SCORE(level)];
+  }
 
-            dequant                         = (float32_t)((int32_t)pInbuff[el_offset + AI_YOLOV2_PP_HEIGHTREL] - raw_zp) * raw_scale;
-            anchor                          = (float32_t)pAnchors[2 * anch + 1];
-            pOutBuff[det_count].height      = (anchor * expf(dequant)) * grid_height_inv;
+  /* Objectness threshold in the quantized domain of the objectness tensor */
+  float32_t computedThreshold = -logf( 1 / pInput_static_param->conf_threshold - 1);
+  int32_t threshold_s8  = od_pp_threshold_q(computedThreshold, scale[AI_OD_ST_YOLOX_PP_HEAD_OBJ],
+                                            zp[AI_OD_ST_YOLOX_PP_HEAD_OBJ], INT8_MIN, INT8_MAX);
 
-            pOutBuff[det_count].conf        = best_score;
-            pOutBuff[det_count].class_index = class_index_u8;
+  if (threshold_s8 > INT8_MAX)
+  {
+    return det_count;
+  }
 
-            det_count++;
-          }
+  for (int32_t n = 0; n < nb_total; n += ST_YOLOX_PP_SCAN_BLOCK)
+  {
+    if (st_yolox_pp_block_masked(pMask, n))
+    {
+      continue;
+    }
+
+    /* Objectness alone in its tensor: one byte per anchor */
+    int32_t nb_keep = st_yolox_pp_scan_objectness_is8(pObj, n, MIN(ST_YOLOX_PP_SCAN_BLOCK, nb_total - n),
+                                                      1, threshold_s8, pMask, keep_idx);
+
+    for (int32_t k = 0; k < nb_keep; k++)
+    {
+      int32_t i = keep_idx[k];
+      int32_t anch = i % nb_anchors;
+      int32_t cell = i / nb_anchors;
+      int8_t *pAnchBox = &pBox[i * AI_YOLOV2_PP_OBJECTNESS];
+      float32_t prob = st_yolox_pp_sigmoid_is8(pObj[i], pScoreLut, scale[AI_OD_ST_YOLOX_PP_HEAD_OBJ],
+                                               zp[AI_OD_ST_YOLOX_PP_HEAD_OBJ]);
+      uint8_t class_index_u8 = 0;
+      float32_t best_score = prob;
+
+      if (nb_classes != 1)
+      {
+        int8_t *pAnchCls = &pCls[i * nb_classes];
+        int8_t best_score_s8;
+        float32_t sumf = 0.0f;
+
+        vision_models_maxi_p_is8ou8(pAnchCls, nb_classes, 1, &best_score_s8, &class_index_u8, 1);
+        for (int _i = 0; _i < nb_classes; _i++) {
+            sumf += st_yolox_pp_exp_is8(pAnchCls[_i], pScoreLut, scale[AI_OD_ST_YOLOX_PP_HEAD_CLS],
+                                        zp[AI_OD_ST_YOLOX_PP_HEAD_CLS]);
+        }
+        best_score = st_yolox_pp_exp_is8(best_score_s8, pScoreLut, scale[AI_OD_ST_YOLOX_PP_HEAD_CLS],
+                                         zp[AI_OD_ST_YOLOX_PP_HEAD_CLS]) / sumf;
+        best_score *= prob;
 
-          el_offset += anch_stride;
-        } // for anch
-      } // for col
-    } // for row
-  } //  else (nb_classes != 1)
+        if (best_score < pInput_static_param->conf_threshold)
+        {
+          continue;
+        }
+      }
+
+      int32_t slot = st_yolox_pp_cand_reserve(pOutBuff, det_count, max_cand, best_score);
+      if (slot < 0)
+      {
+        continue;
+      }
+
+#ifdef VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE
+      if (pBoxLut == NULL)
+      {
+        float32x4_t f32x4_raw = vmulq_n_f32(vcvtq_f32_s32(vsubq_n_s32(vldrbq_s32(pAnchBox),
+                                                                      zp[AI_OD_ST_YOLOX_PP_HEAD_BOX])),
+                                            scale[AI_OD_ST_YOLOX_PP_HEAD_BOX]);
+        float32x4_t f32x4_box = st_yolox_pp_activate_box_mve(f32x4_raw);
+        st_yolox_pp_store_box_mve(&pOutBuff[slot], f32x4_box, i, pAnchors,
+                                  grid_height, nb_anchors, grid_width_inv, grid_height_inv);
+      }
+      else
+#endif
+      {
+        st_yolox_pp_store_box_is8(&pOutBuff[slot], pAnchBox, pBoxLut, cell / grid_height, cell % grid_height,
+                                  &pAnchors[2 * anch], grid_width_inv, grid_height_inv,
+                                  scale[AI_OD_ST_YOLOX_PP_HEAD_BOX], zp[AI_OD_ST_YOLOX_PP_HEAD_BOX]);
+      }
+      pOutBuff[slot].conf           = best_score;
+      pOutBuff[slot].class_index    = class_index_u8;
+
+      det_count = st_yolox_pp_cand_commit(pOutBuff, det_count, max_cand, slot);
+    }
+  }
   pInput_static_param->nb_detect = det_count;
 
   return det_count;
@@ -391,7 +767,8 @@ int32_t st_yolox_pp_getNNBoxes_centroid(od_st_yolox_pp_in_t *pInput,
     grid_height = pInput_static_param->grid_height_L;
     pInbuff = (float32_t *)pInput->pRaw_detections_L;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_L;
-    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param);
+    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param,
+                                       st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_L));
 
     //==============================================================================================================================================================
 
@@ -401,13 +778,15 @@ int32_t st_yolox_pp_getNNBoxes_centroid(od_st_yolox_pp_in_t *pInput,
     pInbuff = (float32_t *)pInput->pRaw_detections_M;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_M;
 
-    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param);
+    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param,
+                                       st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_M));
     //level S
     grid_width = pInput_static_param->grid_width_S;
     grid_height = pInput_static_param->grid_height_S;
     pInbuff = (float32_t *)pInput->pRaw_detections_S;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_S;
-    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param);
+    st_yolox_pp_level_decode_and_store(pInbuff, pOut, pAnchors, grid_width, grid_height, pInput_static_param,
+                                       st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_S));
 
     return (error);
 }
@@ -424,53 +803,139 @@ int32_t st_yolox_pp_getNNBoxes_centroid_is8(od_st_yolox_pp_in_t *pInput,
     int32_t grid_width, grid_height;
     int8_t *pInbuff;
     float32_t *pAnchors;
+    od_st_yolox_pp_lut_is8_t *pLut;
 
   //==============================================================================================================================================================
 
     //level L
     float32_t scale = pInput_static_param->raw_l_scale;
     int8_t zp = pInput_static_param->raw_l_zero_point;
+    pLut = (pInput_static_param->pLut != NULL) ? &pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_L] : NULL;
     grid_width = pInput_static_param->grid_width_L;
     grid_height = pInput_static_param->grid_height_L;
     pInbuff = (int8_t *)pInput->pRaw_detections_L;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_L;
-    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, scale, zp);
+    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, pLut, scale, zp,
+                                           st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_L));
 
     //==============================================================================================================================================================
 
     //level M
     scale = pInput_static_param->raw_m_scale;
     zp = pInput_static_param->raw_m_zero_point;
+    pLut = (pInput_static_param->pLut != NULL) ? &pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_M] : NULL;
     grid_width = pInput_static_param->grid_width_M;
     grid_height = pInput_static_param->grid_height_M;
     pInbuff = (int8_t *)pInput->pRaw_detections_M;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_M;
 
 
-    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, scale, zp);
+    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, pLut, scale, zp,
+                                           st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_M));
 
     //level S
     scale = pInput_static_param->raw_s_scale;
     zp = pInput_static_param->raw_s_zero_point;
+    pLut = (pInput_static_param->pLut != NULL) ? &pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_S] : NULL;
     grid_width = pInput_static_param->grid_width_S;
     grid_height = pInput_static_param->grid_height_S;
     pInbuff = (int8_t *)pInput->pRaw_detections_S;
     pAnchors = (float32_t *)pInput_static_param->pAnchors_S;
 
-    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, scale, zp);
+    st_yolox_pp_level_decode_and_store_is8(pInbuff, pOut, pAnchors, grid_width, grid_height,pInput_static_param, pLut, scale, zp,
+                                           st_yolox_pp_level_mask(pInput_static_param, AI_OD_ST_YOLOX_PP_LEVEL_S));
 
     return (error);
 }
 
 
 
+int32_t st_yolox_pp_getNNBoxes_centroid_heads_is8(od_st_yolox_pp_in_heads_t *pInput,
+                                                  od_pp_out_t *pOut,
+                                                  od_st_yolox_pp_static_param_t *pInput_static_param)
+{
+    const int32_t grid_width[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {
+      pInput_static_param->grid_width_L, pInput_static_param->grid_width_M, pInput_static_param->grid_width_S,
+    };
+    const int32_t grid_height[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {
+      pInput_static_param->grid_height_L, pInput_static_param->grid_height_M, pInput_static_param->grid_height_S,
+    };
+    const float32_t *pAnchors[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {
+      pInput_static_param->pAnchors_L, pInput_static_param->pAnchors_M, pInput_static_param->pAnchors_S,
+    };
+
+    if (!pInput_static_param->split_heads)
+    {
+      return (AI_OD_POSTPROCESS_ERROR);
+    }
+
+    /* Same level order as the concatenated decode: L, M, S */
+    for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+    {
+      st_yolox_pp_level_decode_and_store_heads_is8(&pInput->level[level], pOut, pAnchors[level], grid_width[level],
+                                                   grid_height[level], pInput_static_param, level,
+                                                   st_yolox_pp_level_mask(pInput_static_param, level));
+    }
+
+    return (AI_OD_POSTPROCESS_ERROR_NO);
+}
+
+
 /* ----------------------       Exported routines      ---------------------- */
 
 int32_t od_st_yolox_pp_reset(od_st_yolox_pp_static_param_t *pInput_static_param)
 {
+    int32_t nb_cells[AI_OD_ST_YOLOX_PP_NB_LEVELS] = {
+      pInput_static_param->grid_width_L * pInput_static_param->grid_height_L,
+      pInput_static_param->grid_width_M * pInput_static_param->grid_height_M,
+      pInput_static_param->grid_width_S * pInput_static_param->grid_height_S,
+    };
+
     /* Initializations */
     pInput_static_param->nb_detect = 0;
 
+    for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+    {
+      if (pInput_static_param->pCellMask[level] == NULL)
+      {
+        continue;
+      }
+      if (pInput_static_param->pAnchorMask[level] == NULL)
+      {
+        return (AI_OD_POSTPROCESS_ERROR);
+      }
+      st_yolox_pp_anchor_mask_build(pInput_static_param->pAnchorMask[level], pInput_static_param->pCellMask[level],
+                                    nb_cells[level], pInput_static_param->nb_anchors);
+    }
+
+    if ((pInput_static_param->pLut != NULL) && pInput_static_param->split_heads)
+    {
+      for (int32_t level = 0; level < AI_OD_ST_YOLOX_PP_NB_LEVELS; level++)
+      {
+        const float32_t *scale = pInput_static_param->head_scale[level];
+        const int8_t *zp = pInput_static_param->head_zero_point[level];
+
+        st_yolox_pp_lut_build_is8(&pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_HEADS_LUT_BOX(level)],
+                                  scale[AI_OD_ST_YOLOX_PP_HEAD_BOX], zp[AI_OD_ST_YOLOX_PP_HEAD_BOX],
+                                  scale[AI_OD_ST_YOLOX_PP_HEAD_BOX], zp[AI_OD_ST_YOLOX_PP_HEAD_BOX]);
+        st_yolox_pp_lut_build_is8(&pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_HEADS_LUT_SCORE(level)],
+                                  scale[AI_OD_ST_YOLOX_PP_HEAD_OBJ], zp[AI_OD_ST_YOLOX_PP_HEAD_OBJ],
+                                  scale[AI_OD_ST_YOLOX_PP_HEAD_CLS], zp[AI_OD_ST_YOLOX_PP_HEAD_CLS]);
+      }
+    }
+    else if (pInput_static_param->pLut != NULL)
+    {
+      st_yolox_pp_lut_build_is8(&pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_L],
+                                pInput_static_param->raw_l_scale, pInput_static_param->raw_l_zero_point,
+                                pInput_static_param->raw_l_scale, pInput_static_param->raw_l_zero_point);
+      st_yolox_pp_lut_build_is8(&pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_M],
+                                pInput_static_param->raw_m_scale, pInput_static_param->raw_m_zero_point,
+                                pInput_static_param->raw_m_scale, pInput_static_param->raw_m_zero_point);
+      st_yolox_pp_lut_build_is8(&pInput_static_param->pLut[AI_OD_ST_YOLOX_PP_LEVEL_S],
+                                pInput_static_param->raw_s_scale, pInput_static_param->raw_s_zero_point,
+                                pInput_static_param->raw_s_scale, pInput_static_param->raw_s_zero_point);
+    }
+
 	return (AI_OD_POSTPROCESS_ERROR_NO);
 }
 
@@ -481,21 +946,25 @@ int32_t od_st_yolox_pp_process(od_st_yolox_pp_in_t *pInput,
 {
     int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
     /* Call Get NN boxes first */
     error = st_yolox_pp_getNNBoxes_centroid(pInput,
                                             pOutput,
                                             pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
     /* Then NMS */
     error = st_yolox_pp_nmsFiltering_centroid(pOutput,
                                               pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
     /* And score re-filtering */
     error = st_yolox_pp_scoreFiltering_centroid(pOutput,
                                                 pInput_static_param);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_END);
     return (error);
 }
 
@@ -505,21 +974,52 @@ int32_t od_st_yolox_pp_process_int8(od_st_yolox_pp_in_t *pInput,
 {
     int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
     /* Call Get NN boxes first */
     error = st_yolox_pp_getNNBoxes_centroid_is8(pInput,
                                             pOutput,
                                             pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
     /* Then NMS */
     error = st_yolox_pp_nmsFiltering_centroid(pOutput,
                                               pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
     /* And score re-filtering */
     error = st_yolox_pp_scoreFiltering_centroid(pOutput,
                                                 pInput_static_param);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_END);
     return (error);
 }
 
+int32_t od_st_yolox_pp_process_heads_int8(od_st_yolox_pp_in_heads_t *pInput,
+                                          od_pp_out_t *pOutput,
+                                          od_st_yolox_pp_static_param_t *pInput_static_param)
+{
+    int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
+
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
+    /* Call Get NN boxes first */
+    error = st_yolox_pp_getNNBoxes_centroid_heads_is8(pInput,
+                                                      pOutput,
+                                                      pInput_static_param);
+    if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
+
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
+    /* Then NMS */
+    error = st_yolox_pp_nmsFiltering_centroid(pOutput,
+                                              pInput_static_param);
+    if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
+
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
+    /* And score re-filtering */
+    error = st_yolox_pp_scoreFiltering_centroid(pOutput,
+                                                pInput_static_param);
+
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_END);
+    return (error);
+}
@@ -10,26 +10,15 @@
 #include "od_pp_loc.h"
 #include "od_yolov2_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV2_PP_SORT_CLASS;
 
 
-int32_t yolov2_nms_comparator(const void *pa, const void *pb)
-{
-  od_pp_outBuffer_t *pa_s = (od_pp_outBuffer_t *)pa;
-  od_pp_outBuffer_t *pb_s = (od_pp_outBuffer_t *)pb;
-  float32_t a = (pa_s->class_index == AI_YOLOV2_PP_SORT_CLASS) ? pa_s->conf : 0;
-  float32_t b = (pb_s->class_index == AI_YOLOV2_PP_SORT_CLASS) ? pb_s->conf : 0;
-  float32_t diff = 0;
-
-  diff = a - b;
+/* Class k first, by decreasing confidence */
+#define YOLOV2_PP_SORT_KEY(p, k) (((p)->class_index == (k)) ? (p)->conf : 0.0f)
+VISION_MODELS_SORT_DESC_DEFINE(yolov2_pp_sort, od_pp_outBuffer_t, float32_t, YOLOV2_PP_SORT_KEY)
 
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
 
 
 int32_t yolov2_pp_nmsFiltering_centroid(od_pp_outBuffer_t *pScratchBuffer,
@@ -40,12 +29,8 @@ int32_t yolov2_pp_nmsFiltering_centroid(od_pp_outBuffer_t *pScratchBuffer,
   for (k = 0; k < pInput_static_param->nb_classes; ++k)
   {
     limit_counter = 0;
-    AI_YOLOV2_PP_SORT_CLASS = k;
 
-    qsort(pScratchBuffer,
-          pInput_static_param->nb_detect,
-          sizeof(od_pp_outBuffer_t),
-          (_Cmpfun *)yolov2_nms_comparator);
+    yolov2_pp_sort(pScratchBuffer, pInput_static_param->nb_detect, k);
 
     for (i = 0; i < (pInput_static_param->nb_detect) ; i ++)
     {
@@ -55,7 +40,7 @@ int32_t yolov2_pp_nmsFiltering_centroid(od_pp_outBuffer_t *pScratchBuffer,
       {
         if (pScratchBuffer[j].conf == 0) continue;
         float32_t *b = &(pScratchBuffer[j].x_center);
-        if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
+        if (vision_models_box_iou_gt(a, b, pInput_static_param->iou_threshold))
         {
           pScratchBuffer[j].conf = 0;
         }
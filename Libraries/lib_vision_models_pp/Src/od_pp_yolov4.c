@@ -10,10 +10,9 @@
 #include "od_pp_loc.h"
 #include "od_yolov4_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV4_PP_SORT_CLASS;
 
 typedef struct
 {
@@ -27,73 +26,14 @@ typedef struct
 
 
 
-int32_t yolov4_nms_comparator(const void *pa, const void *pb)
-{
-    od_pp_outBuffer_t a = *(od_pp_outBuffer_t *)pa;
-    od_pp_outBuffer_t b = *(od_pp_outBuffer_t *)pb;
-
-    float32_t diff = 0.0;
-    float32_t a_weighted_conf = 0.0;
-    float32_t b_weighted_conf = 0.0;
-
-    if (a.class_index == AI_YOLOV4_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
-    {
-         a_weighted_conf = 0.0;
-    }
-
-    if (b.class_index == AI_YOLOV4_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
-    else
-    {
-         b_weighted_conf = 0.0;
-    }
-
-    diff = a_weighted_conf - b_weighted_conf;
-
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
+/* Class k first, by decreasing confidence */
+#define YOLOV4_PP_SORT_KEY(p, k) (((p)->class_index == (k)) ? (p)->conf : 0.0f)
+VISION_MODELS_SORT_DESC_DEFINE(yolov4_pp_sort, od_pp_outBuffer_t, float32_t, YOLOV4_PP_SORT_KEY)
 
-int32_t yolov4_nms_comparator_is8(const void *pa, const void *pb)
-{
-    od_yolov4_pp_scratch_s8_t a = *(od_yolov4_pp_scratch_s8_t *)pa;
-    od_yolov4_pp_scratch_s8_t b = *(od_yolov4_pp_scratch_s8_t *)pb;
 
-    int16_t diff = 0;
-    int8_t a_weighted_conf = INT8_MIN;
-    int8_t b_weighted_conf = INT8_MIN;
+#define YOLOV4_PP_SORT_KEY_IS8(p, k) (((p)->class_index == (k)) ? (p)->conf : INT8_MIN)
+VISION_MODELS_SORT_S8_DESC_DEFINE(yolov4_pp_sort_is8, od_yolov4_pp_scratch_s8_t, YOLOV4_PP_SORT_KEY_IS8)
 
-    if (a.class_index == AI_YOLOV4_PP_SORT_CLASS)
-    {
-        a_weighted_conf = a.conf;
-    }
-    else
-    {
-         a_weighted_conf = INT8_MIN;
-    }
-
-    if (b.class_index == AI_YOLOV4_PP_SORT_CLASS)
-    {
-        b_weighted_conf = b.conf;
-    }
-    else
-    {
-         b_weighted_conf = INT8_MIN;
-    }
-
-    diff = a_weighted_conf - b_weighted_conf;
-
-    if (diff < 0) return 1;
-    else if (diff > 0) return -1;
-    return 0;
-}
 
 
 int32_t yolov4_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
@@ -105,7 +45,6 @@ int32_t yolov4_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
     {
         limit_counter = 0;
         detections_per_class = 0;
-        AI_YOLOV4_PP_SORT_CLASS = k;
 
 
         /* Counts the number of detections with class k */
@@ -120,10 +59,7 @@ int32_t yolov4_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
         if (detections_per_class > 0)
         {
            /* Sorts detections based on class k */
-            qsort(pOutput->pOutBuff,
-                  pInput_static_param->nb_detect,
-                  sizeof(od_pp_outBuffer_t),
-                  yolov4_nms_comparator);
+            yolov4_pp_sort(pOutput->pOutBuff, pInput_static_param->nb_detect, k);
 
             for (int32_t i = 0; i < detections_per_class ; i ++)
             {
@@ -134,9 +70,7 @@ int32_t yolov4_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
                     if (pOutput->pOutBuff[j].conf == 0) continue;
 
                     float32_t *b = &(pOutput->pOutBuff[j].x_center);
-                    float32_t iou = vision_models_box_iou(a, b);
-
-                    if (iou > pInput_static_param->iou_threshold)
+                    if (vision_models_box_iou_gt(a, b, pInput_static_param->iou_threshold))
                     {
 
                         pOutput->pOutBuff[j].conf = 0;
@@ -166,12 +100,12 @@ int32_t yolov4_pp_nmsFiltering_centroid_is8(od_yolov4_pp_scratch_s8_t *ptrScratc
                                             od_yolov4_pp_static_param_t *pInput_static_param)
 {
   int32_t j, k, limit_counter, detections_per_class;
+  int32_t iou_threshold_q16 = vision_models_iou_threshold_q16(pInput_static_param->iou_threshold);
 
   for (k = 0; k < pInput_static_param->nb_classes; ++k)
   {
     limit_counter = 0;
     detections_per_class = 0;
-    AI_YOLOV4_PP_SORT_CLASS = k;
 
 
     /* Counts the number of detections with class k */
@@ -186,10 +120,7 @@ int32_t yolov4_pp_nmsFiltering_centroid_is8(od_yolov4_pp_scratch_s8_t *ptrScratc
     if (detections_per_class > 0)
     {
       /* Sorts detections based on class k */
-      qsort(ptrScratch,
-            pInput_static_param->nb_detect,
-            sizeof(od_yolov4_pp_scratch_s8_t),
-            yolov4_nms_comparator_is8);
+      yolov4_pp_sort_is8(ptrScratch, pInput_static_param->nb_detect, k);
 
       for (int32_t i = 0; i < detections_per_class ; i ++)
       {
@@ -199,9 +130,7 @@ int32_t yolov4_pp_nmsFiltering_centroid_is8(od_yolov4_pp_scratch_s8_t *ptrScratc
         {
           if (ptrScratch[j].conf == INT8_MIN) continue;
           int8_t *b = &(ptrScratch[j].x_center);
-          float32_t iou = vision_models_box_iou_is8(a, b, pInput_static_param->boxe_zero_point);
-
-          if ( iou > pInput_static_param->iou_threshold)
+          if (vision_models_box_iou_gt_is8(a, b, pInput_static_param->boxe_zero_point, iou_threshold_q16))
           {
               ptrScratch[j].conf = INT8_MIN;
           }
@@ -12,105 +12,14 @@
 #include "vision_models_pp.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV5_PP_SORT_CLASS;
-
-
-int32_t yolov5_nms_comparator(const void *pa, const void *pb)
-{
-  od_pp_outBuffer_t a = *(od_pp_outBuffer_t *)pa;
-  od_pp_outBuffer_t b = *(od_pp_outBuffer_t *)pb;
-
-  float32_t diff = 0.0;
-  float32_t a_weighted_conf = 0.0;
-  float32_t b_weighted_conf = 0.0;
-
-  if (a.class_index == AI_YOLOV5_PP_SORT_CLASS)
-  {
-    a_weighted_conf = a.conf;
-  }
-  else
-  {
-    a_weighted_conf = 0.0;
-  }
-
-  if (b.class_index == AI_YOLOV5_PP_SORT_CLASS)
-  {
-    b_weighted_conf = b.conf;
-  }
-  else
-  {
-    b_weighted_conf = 0.0;
-  }
-
-  diff = a_weighted_conf - b_weighted_conf;
-
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
-
-
 int32_t yolov5_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
                                         od_yolov5_pp_static_param_t *pInput_static_param)
 {
-  int32_t j, k, limit_counter, detections_per_class;
-
-  for (k = 0; k < pInput_static_param->nb_classes; ++k)
-  {
-    limit_counter = 0;
-    detections_per_class = 0;
-    AI_YOLOV5_PP_SORT_CLASS = k;
-
-
-    /* Counts the number of detections with class k */
-    for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
-    {
-      if(pOutput->pOutBuff[i].class_index == k)
-      {
-        detections_per_class++;
-      }
-    }
-
-    if (detections_per_class > 0)
-    {
-      /* Sorts detections based on class k */
-      qsort(pOutput->pOutBuff,
-            pInput_static_param->nb_detect,
-            sizeof(od_pp_outBuffer_t),
-            yolov5_nms_comparator);
-
-      for (int32_t i = 0; i < detections_per_class ; i ++)
-      {
-        if (pOutput->pOutBuff[i].conf == 0) continue;
-        float32_t *a = &(pOutput->pOutBuff[i].x_center);
-        for (j = i + 1; j < detections_per_class; j ++)
-        {
-          if (pOutput->pOutBuff[j].conf == 0) continue;
-          float32_t *b = &(pOutput->pOutBuff[j].x_center);
-          if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
-          {
-            pOutput->pOutBuff[j].conf = 0;
-          }
-        }
-      }
-
-      /* Limits detections count */
-      for (int32_t i = 0; i < detections_per_class; i++)
-      {
-        if ((limit_counter < pInput_static_param->max_boxes_limit) &&
-            (pOutput->pOutBuff[i].conf != 0))
-        {
-          limit_counter++;
-        }
-        else
-        {
-          pOutput->pOutBuff[i].conf = 0;
-        }
-      }
-    } // if detections_per_class
-  } // for nb_classes
-  return (AI_OD_POSTPROCESS_ERROR_NO);
+  return od_pp_nms_centroid(pOutput->pOutBuff,
+                            pInput_static_param->nb_detect,
+                            pInput_static_param->nb_classes,
+                            pInput_static_param->iou_threshold,
+                            pInput_static_param->max_boxes_limit);
 }
 
 
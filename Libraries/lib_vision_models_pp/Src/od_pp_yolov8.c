@@ -10,10 +10,9 @@
 #include "od_pp_loc.h"
 #include "od_yolov8_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 
 
-/* Can't be removed if qsort is not re-written... */
-static int32_t AI_YOLOV8_PP_SORT_CLASS;
 
 typedef struct
 {
@@ -25,146 +24,32 @@ typedef struct
   uint8_t class_index;
 } od_yolov8_pp_scratch_s8_t;
 
-int32_t yolov8_nms_comparator(const void *pa, const void *pb)
-{
-  od_pp_outBuffer_t a = *(od_pp_outBuffer_t *)pa;
-  od_pp_outBuffer_t b = *(od_pp_outBuffer_t *)pb;
-
-  float32_t diff = 0.0;
-  float32_t a_weighted_conf = 0.0;
-  float32_t b_weighted_conf = 0.0;
-
-  if (a.class_index == AI_YOLOV8_PP_SORT_CLASS)
-  {
-    a_weighted_conf = a.conf;
-  }
-  else
-  {
-    a_weighted_conf = 0.0;
-  }
-
-  if (b.class_index == AI_YOLOV8_PP_SORT_CLASS)
-  {
-    b_weighted_conf = b.conf;
-  }
-  else
-  {
-    b_weighted_conf = 0.0;
-  }
-
-  diff = a_weighted_conf - b_weighted_conf;
-
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
-
-int32_t yolov8_nms_comparator_is8(const void *pa, const void *pb)
-{
-  od_yolov8_pp_scratch_s8_t a = *(od_yolov8_pp_scratch_s8_t *)pa;
-  od_yolov8_pp_scratch_s8_t b = *(od_yolov8_pp_scratch_s8_t *)pb;
-
-  int16_t diff = 0;
-  int8_t a_weighted_conf = INT8_MIN;
-  int8_t b_weighted_conf = INT8_MIN;
-
-  if (a.class_index == AI_YOLOV8_PP_SORT_CLASS)
-  {
-    a_weighted_conf = a.conf;
-  }
-  else
-  {
-    a_weighted_conf = INT8_MIN;
-  }
-
-  if (b.class_index == AI_YOLOV8_PP_SORT_CLASS)
-  {
-    b_weighted_conf = b.conf;
-  }
-  else
-  {
-    b_weighted_conf = INT8_MIN;
-  }
-
-  diff = a_weighted_conf - b_weighted_conf;
+/* Class k first, by decreasing confidence */
+#define YOLOV8_PP_SORT_KEY_IS8(p, k) (((p)->class_index == (k)) ? (p)->conf : INT8_MIN)
+VISION_MODELS_SORT_S8_DESC_DEFINE(yolov8_pp_sort_is8, od_yolov8_pp_scratch_s8_t, YOLOV8_PP_SORT_KEY_IS8)
 
-  if (diff < 0) return 1;
-  else if (diff > 0) return -1;
-  return 0;
-}
 
 
 int32_t yolov8_pp_nmsFiltering_centroid(od_pp_out_t *pOutput,
                                         od_yolov8_pp_static_param_t *pInput_static_param)
 {
-  int32_t j, k, limit_counter, detections_per_class;
-
-  for (k = 0; k < pInput_static_param->nb_classes; ++k)
-  {
-    limit_counter = 0;
-    detections_per_class = 0;
-    AI_YOLOV8_PP_SORT_CLASS = k;
-
-    /* Counts the number of detections with class k */
-    for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
-    {
-      if(pOutput->pOutBuff[i].class_index == k)
-      {
-          detections_per_class++;
-      }
-    }
-
-    if (detections_per_class > 0)
-    {
-      /* Sorts detections based on class k */
-      qsort(pOutput->pOutBuff,
-            pInput_static_param->nb_detect,
-            sizeof(od_pp_outBuffer_t),
-            yolov8_nms_comparator);
-
-      for (int32_t i = 0; i < detections_per_class ; i ++)
-      {
-        if (pOutput->pOutBuff[i].conf == 0) continue; // Already filtered
-        float32_t *a = &(pOutput->pOutBuff[i].x_center);
-        for (j = i + 1; j < detections_per_class; j ++)
-        {
-          if (pOutput->pOutBuff[j].conf == 0) continue; // Already filtered
-          float32_t *b = &(pOutput->pOutBuff[j].x_center);
-          if (vision_models_box_iou(a, b) > pInput_static_param->iou_threshold)
-          {
-            pOutput->pOutBuff[j].conf = 0;
-          }
-        }
-      }
-
-      /* Limits detections count */
-      for (int32_t i = 0; i < detections_per_class; i++)
-      {
-        if ((limit_counter < pInput_static_param->max_boxes_limit) &&
-            (pOutput->pOutBuff[i].conf != 0))
-        {
-          limit_counter++;
-        }
-        else
-        {
-          pOutput->pOutBuff[i].conf = 0;
-        }
-      } // for detection_per_class
-    } // if detection_per_class
-  } // for nb_classes
-  return (AI_OD_POSTPROCESS_ERROR_NO);
+  return od_pp_nms_centroid(pOutput->pOutBuff,
+                            pInput_static_param->nb_detect,
+                            pInput_static_param->nb_classes,
+                            pInput_static_param->iou_threshold,
+                            pInput_static_param->max_boxes_limit);
 }
 
 int32_t yolov8_pp_nmsFiltering_centroid_is8(od_yolov8_pp_scratch_s8_t *ptrScratch,
                                             od_yolov8_pp_static_param_t *pInput_static_param)
 {
   int32_t j, k, limit_counter, detections_per_class;
+  int32_t iou_threshold_q16 = vision_models_iou_threshold_q16(pInput_static_param->iou_threshold);
 
   for (k = 0; k < pInput_static_param->nb_classes; ++k)
   {
     limit_counter = 0;
     detections_per_class = 0;
-    AI_YOLOV8_PP_SORT_CLASS = k;
 
     /* Counts the number of detections with class k */
     for (int32_t i = 0; i < pInput_static_param->nb_detect ; i ++)
@@ -178,10 +63,7 @@ int32_t yolov8_pp_nmsFiltering_centroid_is8(od_yolov8_pp_scratch_s8_t *ptrScratc
     if (detections_per_class > 0)
     {
       /* Sorts detections based on class k */
-      qsort(ptrScratch,
-            pInput_static_param->nb_detect,
-            sizeof(od_yolov8_pp_scratch_s8_t),
-            yolov8_nms_comparator_is8);
+      yolov8_pp_sort_is8(ptrScratch, pInput_static_param->nb_detect, k);
 
       for (int32_t i = 0; i < detections_per_class ; i ++)
       {
@@ -191,7 +73,7 @@ int32_t yolov8_pp_nmsFiltering_centroid_is8(od_yolov8_pp_scratch_s8_t *ptrScratc
         {
           if (ptrScratch[j].conf == INT8_MIN) continue; // Already filtered
           int8_t *b = &(ptrScratch[j].x_center);
-          if (vision_models_box_iou_is8(a, b, pInput_static_param->raw_output_zero_point) > pInput_static_param->iou_threshold)
+          if (vision_models_box_iou_gt_is8(a, b, pInput_static_param->raw_output_zero_point, iou_threshold_q16))
           {
             ptrScratch[j].conf = INT8_MIN;
           }
@@ -266,6 +148,92 @@ int32_t yolov8_pp_scoreFiltering_centroid_is8(od_yolov8_pp_scratch_s8_t *ptrScra
   return (AI_OD_POSTPROCESS_ERROR_NO);
 }
 
+/* Anchors per decode tile */
+#define YOLOV8_PP_TILE_F32  (AI_YOLOV8_PP_TILE_BYTES / sizeof(float32_t))
+#define YOLOV8_PP_TILE_S8   (AI_YOLOV8_PP_TILE_BYTES)
+
+/*!
+ * @brief Best class of nb consecutive anchors, channel-major scores
+ *
+ *        Row by row over the tile: every class row is read once as nb
+ *        contiguous values, instead of all rows being strided through for
+ *        each group of 4 anchors. Ties keep the lowest class.
+ */
+static void yolov8_pp_tile_maxi_if32(const float32_t *pScores,
+                                     int32_t nb_classes,
+                                     int32_t stride,
+                                     int32_t nb,
+                                     float32_t *pBest,
+                                     uint32_t *pIdx)
+{
+  memcpy(pBest, pScores, nb * sizeof(float32_t));
+  memset(pIdx, 0, nb * sizeof(uint32_t));
+
+  for (int32_t c = 1; c < nb_classes; c++)
+  {
+    const float32_t *pRow = &pScores[c * stride];
+#ifdef VISION_MODELS_MAXI_TR_P_IF32OU32_MVE
+    uint32x4_t u32x4_idx = vdupq_n_u32(c);
+    for (int32_t t = 0; t < nb; t += 4)
+    {
+      mve_pred16_t p = vctp32q(nb - t);
+      float32x4_t f32x4_val = vld1q_z_f32(&pRow[t], p);
+      mve_pred16_t p0 = vcmpgtq_m_f32(f32x4_val, vld1q_z_f32(&pBest[t], p), p);
+      vstrwq_p_f32(&pBest[t], f32x4_val, p0);
+      vstrwq_p_u32(&pIdx[t], u32x4_idx, p0);
+    }
+#else
+    for (int32_t t = 0; t < nb; t++)
+    {
+      if (pRow[t] > pBest[t])
+      {
+        pBest[t] = pRow[t];
+        pIdx[t] = c;
+      }
+    }
+#endif
+  }
+}
+
+/*!
+ * @brief Best class of nb consecutive anchors, int8 channel-major scores (< 256 classes)
+ */
+static void yolov8_pp_tile_maxi_is8(const int8_t *pScores,
+                                    int32_t nb_classes,
+                                    int32_t stride,
+                                    int32_t nb,
+                                    int8_t *pBest,
+                                    uint8_t *pIdx)
+{
+  memcpy(pBest, pScores, nb);
+  memset(pIdx, 0, nb);
+
+  for (int32_t c = 1; c < nb_classes; c++)
+  {
+    const int8_t *pRow = &pScores[c * stride];
+#ifdef VISION_MODELS_MAXI_TR_P_IS8OU8_MVE
+    uint8x16_t u8x16_idx = vdupq_n_u8(c);
+    for (int32_t t = 0; t < nb; t += 16)
+    {
+      mve_pred16_t p = vctp8q(nb - t);
+      int8x16_t s8x16_val = vld1q_z_s8(&pRow[t], p);
+      mve_pred16_t p0 = vcmpgtq_m_s8(s8x16_val, vld1q_z_s8(&pBest[t], p), p);
+      vstrbq_p_s8(&pBest[t], s8x16_val, p0);
+      vstrbq_p_u8(&pIdx[t], u8x16_idx, p0);
+    }
+#else
+    for (int32_t t = 0; t < nb; t++)
+    {
+      if (pRow[t] > pBest[t])
+      {
+        pBest[t] = pRow[t];
+        pIdx[t] = c;
+      }
+    }
+#endif
+  }
+}
+
 int32_t yolov8_pp_getNNBoxes_centroid(od_yolov8_pp_in_centroid_t *pInput,
                                       od_pp_out_t *pOutput,
                                       od_yolov8_pp_static_param_t *pInput_static_param)
@@ -274,23 +242,23 @@ int32_t yolov8_pp_getNNBoxes_centroid(od_yolov8_pp_in_centroid_t *pInput,
   int32_t nb_classes = pInput_static_param->nb_classes;
   int32_t nb_total_boxes = pInput_static_param->nb_total_boxes;
   float32_t *pRaw_detections = (float32_t *)pInput->pRaw_detections;
-  int32_t remaining_boxes = nb_total_boxes;
-
   int32_t nb_detect = 0;
   od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
+  float32_t best_score_array[YOLOV8_PP_TILE_F32];
+  uint32_t class_index_array[YOLOV8_PP_TILE_F32];
 
-  for (int32_t i = 0; i < nb_total_boxes; i+=4)
+  for (int32_t i = 0; i < nb_total_boxes; i += YOLOV8_PP_TILE_F32)
   {
-    float32_t best_score_array[4];
-    uint32_t class_index_array[4];
-
-    vision_models_maxi_tr_p_if32ou32(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
-                                     nb_classes,
-                                     nb_total_boxes,
-                                     best_score_array,
-                                     class_index_array,
-                                     remaining_boxes);
-    for (int _i = 0; _i < ((remaining_boxes>4)?4:remaining_boxes); _i++)
+    int32_t nb = MIN((int32_t)YOLOV8_PP_TILE_F32, nb_total_boxes - i);
+
+    yolov8_pp_tile_maxi_if32(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
+                             nb_classes,
+                             nb_total_boxes,
+                             nb,
+                             best_score_array,
+                             class_index_array);
+    /* Box rows of this tile: read while the tile is still in L1 */
+    for (int _i = 0; _i < nb; _i++)
     {
       if (best_score_array[_i] >= pInput_static_param->conf_threshold)
       {
@@ -303,7 +271,6 @@ int32_t yolov8_pp_getNNBoxes_centroid(od_yolov8_pp_in_centroid_t *pInput,
         nb_detect++;
       }
     }
-    remaining_boxes-=4;
   } // for nb_total_boxes
   pInput_static_param->nb_detect = nb_detect;
 
@@ -329,17 +296,19 @@ int32_t yolov8_pp_getNNBoxes_centroid_int8(od_yolov8_pp_in_centroid_t *pInput,
 
   od_pp_outBuffer_t *pOutBuff = (od_pp_outBuffer_t *)pOutput->pOutBuff;
   if (nb_classes < 256) {
-    int8_t best_score_array[16];
-    uint8_t class_index_array[16];
-    for (int32_t i = 0; i < nb_total_boxes; i+=16)
+    int8_t best_score_array[YOLOV8_PP_TILE_S8];
+    uint8_t class_index_array[YOLOV8_PP_TILE_S8];
+    for (int32_t i = 0; i < nb_total_boxes; i += YOLOV8_PP_TILE_S8)
     {
-      vision_models_maxi_tr_p_is8ou8(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
-                                     nb_classes,
-                                     nb_total_boxes,
-                                     best_score_array,
-                                     class_index_array,
-                                     remaining_boxes);
-      for (int _i = 0; _i < ((remaining_boxes>16)?16:remaining_boxes); _i++)
+      int32_t nb = MIN((int32_t)YOLOV8_PP_TILE_S8, nb_total_boxes - i);
+
+      yolov8_pp_tile_maxi_is8(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
+                              nb_classes,
+                              nb_total_boxes,
+                              nb,
+                              best_score_array,
+                              class_index_array);
+      for (int _i = 0; _i < nb; _i++)
       {
           if ( best_score_array[_i] >= conf_threshold_s8)
           {
@@ -354,7 +323,6 @@ int32_t yolov8_pp_getNNBoxes_centroid_int8(od_yolov8_pp_in_centroid_t *pInput,
             nb_detect++;
           }
       }
-      remaining_boxes-=16;
     } // for nb_total_boxes
   } // if nb_classes < 256
   else
@@ -376,10 +344,10 @@ int32_t yolov8_pp_getNNBoxes_centroid_int8(od_yolov8_pp_in_centroid_t *pInput,
         {
           best_score_f = scale * (float32_t)(best_score_array[_i] - zero_point);
           class_index = class_index_array[_i];
-          pOutBuff[nb_detect].x_center    = scale * (float32_t)((int32_t)pRaw_detections[i + AI_YOLOV8_PP_XCENTER   * nb_total_boxes] - (int32_t)zero_point);
-          pOutBuff[nb_detect].y_center    = scale * (float32_t)((int32_t)pRaw_detections[i + AI_YOLOV8_PP_YCENTER   * nb_total_boxes] - (int32_t)zero_point);
-          pOutBuff[nb_detect].width       = scale * (float32_t)((int32_t)pRaw_detections[i + AI_YOLOV8_PP_WIDTHREL  * nb_total_boxes] - (int32_t)zero_point);
-          pOutBuff[nb_detect].height      = scale * (float32_t)((int32_t)pRaw_detections[i + AI_YOLOV8_PP_HEIGHTREL * nb_total_boxes] - (int32_t)zero_point);
+          pOutBuff[nb_detect].x_center    = scale * (float32_t)((int32_t)pRaw_detections[i + _i + AI_YOLOV8_PP_XCENTER   * nb_total_boxes] - (int32_t)zero_point);
+          pOutBuff[nb_detect].y_center    = scale * (float32_t)((int32_t)pRaw_detections[i + _i + AI_YOLOV8_PP_YCENTER   * nb_total_boxes] - (int32_t)zero_point);
+          pOutBuff[nb_detect].width       = scale * (float32_t)((int32_t)pRaw_detections[i + _i + AI_YOLOV8_PP_WIDTHREL  * nb_total_boxes] - (int32_t)zero_point);
+          pOutBuff[nb_detect].height      = scale * (float32_t)((int32_t)pRaw_detections[i + _i + AI_YOLOV8_PP_HEIGHTREL * nb_total_boxes] - (int32_t)zero_point);
           pOutBuff[nb_detect].conf        = best_score_f;
           pOutBuff[nb_detect].class_index = class_index;
           nb_detect++;
@@ -405,21 +373,22 @@ int32_t yolov8_pp_getNNBoxes_centroid_is8os8(od_yolov8_pp_in_centroid_t *pInput,
   float32_t scale = pInput_static_param->raw_output_scale;
 
   pInput_static_param->nb_detect =0;
-  int32_t remaining_boxes = nb_total_boxes;
   int8_t conf_threshold_s8 = (int8_t)(pInput_static_param->conf_threshold / scale + 0.5f) + zero_point;
 
-  int8_t best_score_array[16];
-  uint8_t class_index_array[16];
+  int8_t best_score_array[YOLOV8_PP_TILE_S8];
+  uint8_t class_index_array[YOLOV8_PP_TILE_S8];
 
-  for (int32_t i = 0; i < nb_total_boxes; i+=16)
+  for (int32_t i = 0; i < nb_total_boxes; i += YOLOV8_PP_TILE_S8)
   {
-    vision_models_maxi_tr_p_is8ou8(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
-                                  nb_classes,
-                                  nb_total_boxes,
-                                  best_score_array,
-                                  class_index_array,
-                                  remaining_boxes);
-    for (int _i = 0; _i < ((remaining_boxes>16)?16:remaining_boxes); _i++)
+    int32_t nb = MIN((int32_t)YOLOV8_PP_TILE_S8, nb_total_boxes - i);
+
+    yolov8_pp_tile_maxi_is8(&pRaw_detections[i + AI_YOLOV8_PP_CLASSPROB * nb_total_boxes],
+                            nb_classes,
+                            nb_total_boxes,
+                            nb,
+                            best_score_array,
+                            class_index_array);
+    for (int _i = 0; _i < nb; _i++)
     {
       if ( best_score_array[_i] >= conf_threshold_s8)
       {
@@ -432,7 +401,6 @@ int32_t yolov8_pp_getNNBoxes_centroid_is8os8(od_yolov8_pp_in_centroid_t *pInput,
         pInput_static_param->nb_detect++;
       }
     }
-    remaining_boxes-=16;
   } // for nb_total_boxes
   return (error);
 }
@@ -454,21 +422,25 @@ int32_t od_yolov8_pp_process(od_yolov8_pp_in_centroid_t *pInput,
 {
   int32_t error   = AI_OD_POSTPROCESS_ERROR_NO;
 
+  AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
   /* Call Get NN boxes first */
   error = yolov8_pp_getNNBoxes_centroid(pInput,
                                         pOutput,
                                         pInput_static_param);
   if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+  AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
   /* Then NMS */
   error = yolov8_pp_nmsFiltering_centroid(pOutput,
                                           pInput_static_param);
   if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+  AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
   /* And score re-filtering */
   error = yolov8_pp_scoreFiltering_centroid(pOutput,
                                             pInput_static_param);
 
+  AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_END);
   return (error);
 }
 
@@ -482,18 +454,21 @@ int32_t od_yolov8_pp_process_int8(od_yolov8_pp_in_centroid_t *pInput,
 
   if (ptrScratch)
   {
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
     /* Call Get NN boxes first */
     error = yolov8_pp_getNNBoxes_centroid_is8os8(pInput,
                                                  ptrScratch,
                                                  pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
     /* Then NMS */
 
     error = yolov8_pp_nmsFiltering_centroid_is8(ptrScratch,
                                                 pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
     /* And score re-filtering */
     error = yolov8_pp_scoreFiltering_centroid_is8(ptrScratch,
                                                   pOutput,
@@ -501,22 +476,26 @@ int32_t od_yolov8_pp_process_int8(od_yolov8_pp_in_centroid_t *pInput,
   }
   else
   {
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_DECODE);
     /* Call Get NN boxes first */
     error = yolov8_pp_getNNBoxes_centroid_int8(pInput,
                                                pOutput,
                                                pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_NMS);
     /* Then NMS */
 
     error = yolov8_pp_nmsFiltering_centroid(pOutput,
                                             pInput_static_param);
     if (error != AI_OD_POSTPROCESS_ERROR_NO) return (error);
 
+    AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_SCORE);
     /* And score re-filtering */
     error = yolov8_pp_scoreFiltering_centroid(pOutput,
                                               pInput_static_param);
   }
+  AI_OD_POSTPROCESS_STAGE(AI_OD_POSTPROCESS_STAGE_END);
   return (error);
 }
 
@@ -17,22 +17,13 @@
 
 #include "pd_model_pp_if.h"
 #include "vision_models_pp.h"
+#include "vision_models_pp_sort.h"
 #include "pd_pp_loc.h"
 
 
-static int32_t pd_pp_nms_comparator(const void *arg1, const void *arg2)
-{
-  const pd_pp_box_t *box1 = arg1;
-  const pd_pp_box_t *box2 = arg2;
-
-  if (box1->prob < box2->prob)
-    return 1;
-
-  if (box1->prob > box2->prob)
-    return -1;
-
-  return 0;
-}
+/* Decreasing probability */
+#define PD_PP_SORT_KEY(p, arg) ((p)->prob)
+VISION_MODELS_SORT_DESC_DEFINE(pd_pp_sort, pd_pp_box_t, float32_t, PD_PP_SORT_KEY)
 
 static void pd_pp_compute_opposite_corners_from_box(pd_pp_box_t *box, pd_pp_point_t corners[2])
 {
@@ -206,7 +197,7 @@ static int pd_pp_nms(pd_pp_out_t *pOutput,
   size_t box_nb =  pOutput->box_nb;
 
   /* first sort boxes by higher probability */
-  qsort(pd_boxes, box_nb, sizeof(pd_pp_box_t), pd_pp_nms_comparator);
+  pd_pp_sort(pd_boxes, (int32_t)box_nb, 0);
 
   /* then apply iou to filter them */
   for (size_t i = 0; i < box_nb; i++) {
@@ -232,6 +232,25 @@ int32_t sseg_deeplabv3_pp_apply_color_map(sseg_deeplabv3_pp_in_t *pInput,
 
 /* ----------------------       Exported routines      ---------------------- */
 
+int32_t sseg_deeplabv3_pp_build_clut(const uint8_t *pColor_map,
+                                     uint32_t nb_classes,
+                                     uint8_t alpha,
+                                     int32_t transparent_class,
+                                     uint32_t *pClut)
+{
+  if (nb_classes > 256) {
+    return (AI_SSEG_POSTPROCESS_ERROR);
+  }
+
+  for (uint32_t k = 0; k < nb_classes; k++) {
+    uint32_t a = ((int32_t)k == transparent_class) ? 0 : alpha;
+    pClut[k] = (a << 24) | ((uint32_t)pColor_map[3 * k] << 16) |
+               ((uint32_t)pColor_map[3 * k + 1] << 8) | pColor_map[3 * k + 2];
+  }
+
+  return (AI_SSEG_POSTPROCESS_ERROR_NO);
+}
+
 int32_t sseg_deeplabv3_pp_reset(sseg_deeplabv3_pp_static_param_t *pInput_static_param)
 {
     /* Initializations */
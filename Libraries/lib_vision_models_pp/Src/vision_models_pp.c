@@ -17,21 +17,15 @@ float32_t vision_models_sigmoid_f(float32_t x)
 }
 
 
+/* The exponentials, their sum and the normalization run on the CMSIS-DSP
+ * Helium kernels; tmp_x holds len_x exponentials */
 void vision_models_softmax_f(float32_t *input_x, float32_t *output_x, int32_t len_x, float32_t *tmp_x)
 {
-  float32_t sum = 0;
+  float32_t sum;
 
-  for (int32_t i = 0; i < len_x; ++i)
-  {
-    tmp_x[i] = expf(input_x[i]);
-    sum = sum + tmp_x[i];
-  }
-  sum = 1.0f / sum;
-  for (int32_t i = 0; i < len_x; ++i)
-  {
-    tmp_x[i] *= sum;
-  }
-  memcpy(output_x, tmp_x, len_x * sizeof(float32_t));
+  arm_vexp_f32(input_x, tmp_x, (uint32_t)len_x);
+  arm_accumulate_f32(tmp_x, (uint32_t)len_x, &sum);
+  arm_scale_f32(tmp_x, 1.0f / sum, output_x, (uint32_t)len_x);
 }
 
 
@@ -121,6 +115,32 @@ float32_t vision_models_box_iou_is8(int8_t *a, int8_t *b, int8_t zp)
   float32_t ret = ((float32_t)I / (float32_t)U);
   return ret;
 }
+
+/* IoU threshold to Q16, computed once per NMS rather than per pair */
+int32_t vision_models_iou_threshold_q16(float32_t iou_threshold)
+{
+  return (int32_t)(iou_threshold * VISION_MODELS_IOU_Q16_ONE + 0.5f);
+}
+
+/* IoU(a, b) > t without the division: I > t * (A + B - I) */
+int32_t vision_models_box_iou_gt(float32_t *a, float32_t *b, float32_t iou_threshold)
+{
+  float32_t I = box_intersection(a, b);
+  if (I == 0) return 0;
+  return (I > iou_threshold * (a[2] * a[3] + b[2] * b[3] - I));
+}
+
+/* IoU(a, b) > t in integers only: I * (1 + t) > t * (A + B), t in Q16.
+ * I and A + B stay below 2^20 for int8 boxes, so the products fit in 64 bits */
+int32_t vision_models_box_iou_gt_is8(int8_t *a, int8_t *b, int8_t zp, int32_t iou_threshold_q16)
+{
+  int32_t a_z[4] = {a[0]-zp, a[1]-zp, a[2]-zp, a[3]-zp};
+  int32_t b_z[4] = {b[0]-zp, b[1]-zp, b[2]-zp, b[3]-zp};
+  int32_t I = box_intersection_is8(a_z, b_z);
+  if (I == 0) return 0;
+  int32_t S = 4 * (a_z[2] * a_z[3] + b_z[2] * b_z[3]);
+  return ((int64_t)I * (VISION_MODELS_IOU_Q16_ONE + iou_threshold_q16) > (int64_t)iou_threshold_q16 * S);
+}
 void transpose_flattened_2D(float32_t *arr, int32_t rows, int32_t cols, float32_t *tmp_x)
 {
   int32_t i, j, k;
@@ -142,11 +162,11 @@ void transpose_flattened_2D(float32_t *arr, int32_t rows, int32_t cols, float32_
 }
 
 
+/* (arr - zero_point) * scale as arr * scale - zero_point * scale: the Q31
+ * conversion takes out 2^31, which the scale puts back exactly */
 void dequantize(int32_t* arr, float32_t* tmp, int32_t n, int32_t zero_point, float32_t scale)
 {
-  for (int32_t i = 0; i < n; i++)
-  {
-    tmp[i] = (float32_t)(arr[i] - zero_point) * scale;
-  }
+  arm_q31_to_float((const q31_t *)arr, tmp, (uint32_t)n);
+  arm_scale_f32(tmp, scale * 2147483648.0f, tmp, (uint32_t)n);
+  arm_offset_f32(tmp, -(float32_t)zero_point * scale, tmp, (uint32_t)n);
 }
-
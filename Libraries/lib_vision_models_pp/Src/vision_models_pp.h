@@ -32,6 +32,11 @@
 #define VISION_MODELS_MAXI_P_IF32OU8_MVE
 #define VISION_MODELS_MAXI_P_IF32OU16_MVE
 #define VISION_MODELS_MAXI_P_IF32OU32_MVE
+/* ST YoloX single-class decode (the int8 variant dequantizes survivors in float, so both need MVEF) */
+#define VISION_MODELS_ST_YOLOX_DECODE_IF32_MVE
+#define VISION_MODELS_ST_YOLOX_DECODE_IS8_MVE
+/* BlazeFace score scan and 4-lane box decode (the quantized variants dequantize in float) */
+#define VISION_MODELS_FD_BLAZEFACE_DECODE_MVE
 #endif
 #ifdef ARM_MATH_MVEI
 #define VISION_MODELS_MAXI_P_IS8OU8_MVE
@@ -44,8 +49,22 @@
 #define VISION_MODELS_MAXI_P_IU8OU16_MVE
 #define VISION_MODELS_MAXI_TR_P_IS8OU16_MVE
 #define VISION_MODELS_MAXI_TR_P_IS8OU32_MVE
+#define VISION_MODELS_PEAKS_3X3_IS8_MVE
+#define VISION_MODELS_ISEG_YOLOV8_MASK_IS8_MVE
 #endif
 
+/* Shared centroid NMS (od_pp_nms.c): IoU tests on Q15 box corners against a
+ * Q16 threshold, integer only. Define VISION_MODELS_NMS_IOU_FLOAT for the float path */
+#ifndef VISION_MODELS_NMS_IOU_FLOAT
+#define VISION_MODELS_NMS_IOU_FIXED
+#endif
+#if defined(VISION_MODELS_NMS_IOU_FIXED) && defined(ARM_MATH_MVEI)
+#define VISION_MODELS_NMS_OVERLAP_MVE
+#endif
+
+/* IoU threshold in Q16, for the divide-free IoU tests */
+#define VISION_MODELS_IOU_Q16_ONE       (65536)
+
 #ifndef MIN
   #define MIN(x,y) ((x) < (y) ? (x) : (y))
 #endif
@@ -54,8 +73,6 @@
   #define MAX(x,y) ((x) > (y) ? (x) : (y))
 #endif
 
-typedef int32_t _Cmpfun(const void *, const void *);
-extern void qsort(void *, size_t, size_t, _Cmpfun *);
 
 // Float32 input
 void vision_models_maxi_if32ou32(float32_t *arr, uint32_t len_arr, float32_t *maxim, uint32_t *index);
@@ -98,11 +115,21 @@ void vision_models_maxi_tr_p_is8ou32(int8_t *arr, uint32_t len_arr, uint32_t off
 void vision_models_maxi_tr_is8ou8(int8_t *arr, uint32_t len_arr, uint32_t nb_total_boxes, int8_t *maxim, uint8_t *index);
 void vision_models_maxi_tr_is8ou16(int8_t *arr, uint32_t len_arr, uint32_t nb_total_boxes, int8_t *maxim, uint16_t *index);
 
+/* Heatmap peaks: columns 1 to width - 2 of the middle row whose value is
+ * above threshold and the max of their 3x3 neighborhood (ties kept), in
+ * increasing order. Rows are contiguous; pCols holds up to width - 2.
+ * Returns the number of peaks */
+uint32_t vision_models_peaks_3x3_is8(const int8_t *pTop, const int8_t *pMid, const int8_t *pBot,
+                                     uint32_t width, int8_t threshold, uint16_t *pCols);
+
 
 float32_t vision_models_sigmoid_f(float32_t x);
 void vision_models_softmax_f(float32_t *input_x, float32_t *output_x, int32_t len_x, float32_t *tmp_x);
 float32_t vision_models_box_iou(float32_t *a, float32_t *b);
 float32_t vision_models_box_iou_is8(int8_t *a, int8_t *b, int8_t zp);
+int32_t vision_models_iou_threshold_q16(float32_t iou_threshold);
+int32_t vision_models_box_iou_gt(float32_t *a, float32_t *b, float32_t iou_threshold);
+int32_t vision_models_box_iou_gt_is8(int8_t *a, int8_t *b, int8_t zp, int32_t iou_threshold_q16);
 
 void transpose_flattened_2D(float32_t *arr, int32_t rows, int32_t cols, float32_t *tmp_x);
 void dequantize(int32_t* arr, float32_t* tmp, int32_t n, int32_t zero_point, float32_t scale);
@@ -0,0 +1,59 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#include "vision_models_pp.h"
+
+
+uint32_t vision_models_peaks_3x3_is8(const int8_t *pTop, const int8_t *pMid, const int8_t *pBot,
+                                     uint32_t width, int8_t threshold, uint16_t *pCols)
+{
+  uint32_t nb_peaks = 0;
+
+  if (width < 3) {
+    return 0;
+  }
+#ifdef VISION_MODELS_PEAKS_3X3_IS8_MVE
+  int8x16_t s8x16_threshold = vdupq_n_s8(threshold);
+
+  /* Columns 1 to width - 2, 16 at a time: the 3x3 max equals the center */
+  for (uint32_t x = 1; x < width - 1; x += 16)
+  {
+    mve_pred16_t p = vctp8q(width - 1 - x);
+    int8x16_t s8x16_center = vld1q_z_s8(pMid + x, p);
+    int8x16_t s8x16_max = vmaxq_x_s8(vld1q_z_s8(pMid + x - 1, p), vld1q_z_s8(pMid + x + 1, p), p);
+
+    s8x16_max = vmaxq_x_s8(s8x16_max, vmaxq_x_s8(vld1q_z_s8(pTop + x - 1, p), vld1q_z_s8(pTop + x, p), p), p);
+    s8x16_max = vmaxq_x_s8(s8x16_max, vmaxq_x_s8(vld1q_z_s8(pTop + x + 1, p), vld1q_z_s8(pBot + x - 1, p), p), p);
+    s8x16_max = vmaxq_x_s8(s8x16_max, vmaxq_x_s8(vld1q_z_s8(pBot + x, p), vld1q_z_s8(pBot + x + 1, p), p), p);
+    s8x16_max = vmaxq_x_s8(s8x16_max, s8x16_center, p);
+
+    /* One predicate bit per byte lane: compact the set ones */
+    uint32_t peaks = vcmpgtq_m_s8(s8x16_center, s8x16_threshold, vcmpeqq_m_s8(s8x16_center, s8x16_max, p));
+    while (peaks != 0)
+    {
+      pCols[nb_peaks++] = (uint16_t)(x + __builtin_ctz(peaks));
+      peaks &= peaks - 1;
+    }
+  }
+#else
+  for (uint32_t x = 1; x < width - 1; x++)
+  {
+    int8_t center = pMid[x];
+
+    if ((center > threshold) &&
+        (center >= pTop[x - 1]) && (center >= pTop[x]) && (center >= pTop[x + 1]) &&
+        (center >= pMid[x - 1]) && (center >= pMid[x + 1]) &&
+        (center >= pBot[x - 1]) && (center >= pBot[x]) && (center >= pBot[x + 1]))
+    {
+      pCols[nb_peaks++] = (uint16_t)x;
+    }
+  }
+#endif
+  return nb_peaks;
+}
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------------------------
+ * Copyright (c) 2026 Long Liangmao.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file in
+ * the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *--------------------------------------------------------------------------------------------*/
+
+#ifndef __VISION_MODELS_PP_SORT_H__
+#define __VISION_MODELS_PP_SORT_H__
+
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "arm_math.h"
+
+/*
+ * Sorts specialized per record type, in place of qsort: no allocation, no
+ * global comparator state, the key inlined in every comparison.
+ *
+ *   VISION_MODELS_SORT_DESC_DEFINE(name, type, key_t, KEY)
+ *   VISION_MODELS_SORT_S8_DESC_DEFINE(name, type, KEY)
+ *
+ * define static void name(type *arr, int32_t n, int32_t arg), ordering arr by
+ * decreasing KEY(const type *p, arg). arg carries what the qsort comparators
+ * read from globals (the class being sorted). Both are stable: records of
+ * equal keys keep their input order, the order the merge sort of the host C
+ * library gave before, and the same on every target. Insertion sort on runs
+ * of VISION_MODELS_SORT_SMALL records, then the runs are merged in place by
+ * rotations (SymMerge, Kim and Kutzner 2004): O(n log n) comparisons,
+ * O(n log^2 n) moves. The second is the first for int8 keys.
+ */
+
+#define VISION_MODELS_SORT_SMALL  (16)
+
+/* Key ordering a float32_t like the value itself, negative values included */
+static inline uint32_t vision_models_sort_key_f32(float32_t value)
+{
+  union { float32_t f; uint32_t u; } bits = {.f = value};
+
+  return bits.u ^ ((uint32_t)((int32_t)bits.u >> 31) | 0x80000000U);
+}
+
+#define VISION_MODELS_SORT_SWAP(type, a, b) \
+  do { type _tmp = (a); (a) = (b); (b) = _tmp; } while (0)
+
+#define VISION_MODELS_SORT_INSERTION_DEFINE(name, type, key_t, KEY)                         \
+static void name##_insertion(type *arr, int32_t n, int32_t arg)                             \
+{                                                                                           \
+  (void)arg;                                                                                \
+  for (int32_t i = 1; i < n; i++)                                                           \
+  {                                                                                         \
+    type tmp = arr[i];                                                                      \
+    key_t key = KEY(&tmp, arg);                                                             \
+    int32_t j = i;                                                                          \
+    for (; (j > 0) && (KEY(&arr[j - 1], arg) < key); j--)                                   \
+    {                                                                                       \
+      arr[j] = arr[j - 1];                                                                  \
+    }                                                                                       \
+    arr[j] = tmp;                                                                           \
+  }                                                                                         \
+}
+
+#define VISION_MODELS_SORT_DESC_DEFINE(name, type, key_t, KEY)                              \
+VISION_MODELS_SORT_INSERTION_DEFINE(name, type, key_t, KEY)                                 \
+                                                                                            \
+/* [a, m) and [m, b) exchanged in place */                                                  \
+static void name##_rotate(type *arr, int32_t a, int32_t m, int32_t b)                       \
+{                                                                                           \
+  int32_t i = m - a;                                                                        \
+  int32_t j = b - m;                                                                        \
+  while (i != j)                                                                            \
+  {                                                                                         \
+    if (i > j)                                                                              \
+    {                                                                                       \
+      for (int32_t k = 0; k < j; k++) VISION_MODELS_SORT_SWAP(type, arr[m - i + k], arr[m + k]); \
+      i -= j;                                                                               \
+    }                                                                                       \
+    else                                                                                    \
+    {                                                                                       \
+      for (int32_t k = 0; k < i; k++) VISION_MODELS_SORT_SWAP(type, arr[m - i + k], arr[m + j - i + k]); \
+      j -= i;                                                                               \
+    }                                                                                       \
+  }                                                                                         \
+  for (int32_t k = 0; k < i; k++) VISION_MODELS_SORT_SWAP(type, arr[m - i + k], arr[m + k]); \
+}                                                                                           \
+                                                                                            \
+/* Stable merge of the sorted runs [a, m) and [m, b); equal keys: [a, m) first */           \
+static void name##_merge(type *arr, int32_t a, int32_t m, int32_t b, int32_t arg)           \
+{                                                                                           \
+  int32_t mid;                                                                              \
+  int32_t n;                                                                                \
+  int32_t start;                                                                            \
+  int32_t r;                                                                                \
+  int32_t end;                                                                              \
+                                                                                            \
+  (void)arg;                                                                                \
+  if (m - a == 1)                                                                           \
+  {                                                                                         \
+    /* arr[a] goes before the first record of [m, b) with a lower key */                   \
+    int32_t i = m;                                                                          \
+    int32_t j = b;                                                                          \
+    while (i < j)                                                                           \
+    {                                                                                       \
+      int32_t h = (i + j) >> 1;                                                             \
+      if (KEY(&arr[a], arg) < KEY(&arr[h], arg)) i = h + 1; else j = h;                     \
+    }                                                                                       \
+    for (int32_t k = a; k < i - 1; k++) VISION_MODELS_SORT_SWAP(type, arr[k], arr[k + 1]);  \
+    return;                                                                                 \
+  }                                                                                         \
+  if (b - m == 1)                                                                           \
+  {                                                                                         \
+    /* arr[m] goes after the last record of [a, m) with a key not lower */                 \
+    int32_t i = a;                                                                          \
+    int32_t j = m;                                                                          \
+    while (i < j)                                                                           \
+    {                                                                                       \
+      int32_t h = (i + j) >> 1;                                                             \
+      if (!(KEY(&arr[h], arg) < KEY(&arr[m], arg))) i = h + 1; else j = h;                  \
+    }                                                                                       \
+    for (int32_t k = m; k > i; k--) VISION_MODELS_SORT_SWAP(type, arr[k], arr[k - 1]);      \
+    return;                                                                                 \
+  }                                                                                         \
+                                                                                            \
+  mid = (a + b) >> 1;                                                                       \
+  n = mid + m;                                                                              \
+  if (m > mid)                                                                              \
+  {                                                                                         \
+    start = n - b;                                                                          \
+    r = mid;                                                                                \
+  }                                                                                         \
+  else                                                                                      \
+  {                                                                                         \
+    start = a;                                                                              \
+    r = m;                                                                                  \
+  }                                                                                         \
+  while (start < r)                                                                         \
+  {                                                                                         \
+    int32_t c = (start + r) >> 1;                                                           \
+    if (!(KEY(&arr[c], arg) < KEY(&arr[n - 1 - c], arg))) start = c + 1; else r = c;        \
+  }                                                                                         \
+  end = n - start;                                                                          \
+  if ((start < m) && (m < end)) name##_rotate(arr, start, m, end);                          \
+  if ((a < start) && (start < mid)) name##_merge(arr, a, start, mid, arg);                  \
+  if ((mid < end) && (end < b)) name##_merge(arr, mid, end, b, arg);                        \
+}                                                                                           \
+                                                                                            \
+static void name(type *arr, int32_t n, int32_t arg)                                         \
+{                                                                                           \
+  int32_t a = 0;                                                                            \
+                                                                                            \
+  for (; a + VISION_MODELS_SORT_SMALL <= n; a += VISION_MODELS_SORT_SMALL)                  \
+  {                                                                                         \
+    name##_insertion(&arr[a], VISION_MODELS_SORT_SMALL, arg);                               \
+  }                                                                                         \
+  name##_insertion(&arr[a], n - a, arg);                                                    \
+                                                                                            \
+  for (int32_t run = VISION_MODELS_SORT_SMALL; run < n; run *= 2)                           \
+  {                                                                                         \
+    for (a = 0; a + 2 * run <= n; a += 2 * run)                                             \
+    {                                                                                       \
+      name##_merge(arr, a, a + run, a + 2 * run, arg);                                      \
+    }                                                                                       \
+    if (a + run < n)                                                                        \
+    {                                                                                       \
+      name##_merge(arr, a, a + run, n, arg);                                                \
+    }                                                                                       \
+  }                                                                                         \
+}
+
+#define VISION_MODELS_SORT_S8_DESC_DEFINE(name, type, KEY)                                  \
+VISION_MODELS_SORT_DESC_DEFINE(name, type, int32_t, KEY)
+
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif      /* __VISION_MODELS_PP_SORT_H__  */
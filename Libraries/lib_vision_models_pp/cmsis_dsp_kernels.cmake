@@ -0,0 +1,16 @@
+#
+# CMSIS-DSP kernels the post-processing helpers call (vision_models_pp.c):
+# softmax (arm_vexp_f32, arm_accumulate_f32, arm_scale_f32) and dequantize
+# (arm_q31_to_float, arm_scale_f32, arm_offset_f32). The tables hold the vexp
+# polynomial. One list for every build of the library: set CMSIS_DSP_DIR to
+# Drivers/CMSIS/DSP, include this file, use VISION_MODELS_PP_CMSIS_DSP_Src.
+#
+
+set(VISION_MODELS_PP_CMSIS_DSP_Src
+    ${CMSIS_DSP_DIR}/Source/BasicMathFunctions/arm_offset_f32.c
+    ${CMSIS_DSP_DIR}/Source/BasicMathFunctions/arm_scale_f32.c
+    ${CMSIS_DSP_DIR}/Source/CommonTables/arm_common_tables.c
+    ${CMSIS_DSP_DIR}/Source/FastMathFunctions/arm_vexp_f32.c
+    ${CMSIS_DSP_DIR}/Source/StatisticsFunctions/arm_accumulate_f32.c
+    ${CMSIS_DSP_DIR}/Source/SupportFunctions/arm_q31_to_float.c
+)
@@ -90,7 +90,10 @@ extern "C"
     EpochBlock_Flags_pure_sw = (0x1 << 5),       /**< Pure SW EpochBlock */
     EpochBlock_Flags_hybrid = (0x1 << 6),        /**< Hybrid EpochBlock (i.e. mixed HW/SW) */
     EpochBlock_Flags_internal = (0x1 << 7),      /**< ATON lib internal EpochBlock (used to implement hybrid epochs) */
-    EpochBlock_Flags_blob_encrypted = (0x1 << 8) /**< The blob is encrypted and must be decrypted on the fly */
+    EpochBlock_Flags_blob_encrypted = (0x1 << 8), /**< The blob is encrypted and must be decrypted on the fly */
+    EpochBlock_Flags_sw_overlap = (0x1 << 9)      /**< Pure SW EpochBlock which may run on the MCU while the following
+                                                   *   pure HW EpochBlock executes: it neither reads nor writes any
+                                                   *   buffer that EpochBlock writes, nor writes one it reads */
   } EpochBlock_Flags_t;
 
   typedef struct
@@ -175,6 +178,12 @@ extern "C"
    */
   static inline bool EpochBlock_IsEpochInternal(const EpochBlock_ItemTypeDef *eb);
 
+  /**
+   * @brief Checks if the pointed element is a pure SW epoch which may overlap the following HW epoch
+   *
+   */
+  static inline bool EpochBlock_IsEpochSWOverlap(const EpochBlock_ItemTypeDef *eb);
+
   /**
    * @brief Returns the Epoch controller id to use
    *
@@ -464,6 +473,12 @@ extern "C"
     return ((eb->flags & EpochBlock_Flags_internal) != 0);
   }
 
+  static inline bool EpochBlock_IsEpochSWOverlap(const EpochBlock_ItemTypeDef *eb)
+  {
+    return ((eb->flags & (EpochBlock_Flags_pure_sw | EpochBlock_Flags_sw_overlap)) ==
+            (EpochBlock_Flags_pure_sw | EpochBlock_Flags_sw_overlap));
+  }
+
   static inline uint32_t EpochBlock_EpochControllerUnit(const EpochBlock_ItemTypeDef *eb)
   {
     LL_ATON_ASSERT(EpochBlock_IsEpochBlob(eb));
@@ -41,6 +41,9 @@
  *                                                  (to be defined as `0` or `1`)
  *      optional  LL_ATON_ENABLE_CLOCK_GATING       used to enable/disable clock gating of the ATON units not involved
  *                                                  during epoch execution (to be defined as `0` or `1`)
+ *      optional  LL_ATON_RT_SW_OVERLAP             run pure SW epoch blocks flagged `EpochBlock_Flags_sw_overlap`
+ *                                                  while the following HW epoch block executes (asynchronous mode
+ *                                                  only, to be defined as `0` or `1`)
  *
  *      NOTE: `mandatory` means that these macros must be predefined using `-D` options in the command-line of the
  *            C compiler a/o preprocessor!
@@ -123,6 +126,10 @@
 #define LL_ATON_ENABLE_CLOCK_GATING 1
 #endif
 
+#ifndef LL_ATON_RT_SW_OVERLAP
+#define LL_ATON_RT_SW_OVERLAP 1
+#endif
+
 /* Check if selected values are valid */
 #if (LL_ATON_PLATFORM != LL_ATON_PLAT_NCSIM)
 #if (LL_ATON_PLATFORM != LL_ATON_PLAT_STICE4)
@@ -397,16 +397,49 @@ static void __ll_lib_outputs_memcpy_start(const void *epoch_block, uint8_t *_dst
 
 /** Epoch start/end functions and epoch block arrays **/
 
-static void __LL_LIB_Concat_Case3_Start_EpochBlock(const void *epoch_block)
+/* Input `g_idx` is written in chunks of `shape[axis] * jump_base` bytes, `jump` bytes apart: one transfer per input,
+ * the output engine repeating the chunk frame */
+static inline uint32_t __ll_lib_concat_strided_chunk(__ll_lib_params_t *params)
+{
+  const LL_LIB_TensorInfo_TypeDef *in = ((const LL_LIB_TensorInfo_TypeDef *)params->g_tensors) + params->g_idx;
+  return in->shape[params->special.concat_strided.axis] * params->special.concat_strided.jump_base;
+}
+
+static void __LL_LIB_Concat_Strided_Start_EpochBlock(const void *epoch_block)
 {
   __ll_lib_params_t *params = __ll_lib_get_params();
-  LL_ATON_ASSERT((params->special.concat_case3.outer_idx < params->g_num_tensors) &&
-                 (params->g_idx < params->special.concat_case3.in_fheight)); // must be checked before
+  LL_ATON_ASSERT(params->g_idx < params->g_num_tensors); // must be checked before
+
+  const LL_LIB_TensorInfo_TypeDef *in = ((const LL_LIB_TensorInfo_TypeDef *)params->g_tensors) + params->g_idx;
+  uint32_t chunk = __ll_lib_concat_strided_chunk(params);
+  uint32_t n = LL_Buffer_len(in);
+
+  if ((n > 0) && (chunk > 0))
+  {
+    LL_ATON_ASSERT((n % chunk) == 0);
 
-  __ll_lib_inputs_memcpy_start(epoch_block, (uint8_t *)params->special.concat_case3.in_curr);
+    params->g_dma_in.addr_base.p = LL_Buffer_addr_start(in);
+    params->g_dma_in.offset_start = 0;
+    params->g_dma_in.offset_end = n;
+    params->g_dma_in.offset_limit = in->offset_limit;
+
+    params->g_dma_out.addr_base.p = params->g_dst_o_src;
+    params->g_dma_out.offset_start = 0;
+    params->g_dma_out.offset_end = chunk;
+    params->g_dma_out.frame_offset = params->special.concat_strided.jump;
+    params->g_dma_out.frame_tot_cnt = n / chunk;
+
+    __ll_lib_set_wait_mask((LL_ATON_RT_EpochBlockItem_t *)epoch_block, params->g_wait_mask);
+    __ll_lib_start_transfer(params);
+  }
+  else
+  {
+    /* do not start any transfer and wait, just proceed to end function */
+    __ll_lib_set_wait_mask((LL_ATON_RT_EpochBlockItem_t *)epoch_block, 0);
+  }
 }
 
-static void __LL_LIB_Concat_Case3_End_EpochBlock(const void *epoch_block)
+static void __LL_LIB_Concat_Strided_End_EpochBlock(const void *epoch_block)
 {
   __ll_lib_params_t *params = __ll_lib_get_params();
 
@@ -415,41 +448,17 @@ static void __LL_LIB_Concat_Case3_End_EpochBlock(const void *epoch_block)
     __ll_lib_stop_transfer();
   }
 
+  params->g_dst_o_src += __ll_lib_concat_strided_chunk(params);
   params->g_idx++;
 
-  if (params->g_idx < params->special.concat_case3.in_fheight)
+  if (params->g_idx < params->g_num_tensors)
   {
-    params->g_dst_o_src += params->special.concat_case3.out_line_size;
-    params->special.concat_case3.in_curr += params->g_size;
-
     /* loop back one epoch block */
     LL_ATON_RT_DecCurrEpochBlock(1);
   }
   else
   {
-    params->special.concat_case3.outer_idx++;
-
-    if (params->special.concat_case3.outer_idx < params->g_num_tensors)
-    {
-      int in_ndims = ((LL_LIB_TensorInfo_TypeDef *)params->g_tensors)[params->special.concat_case3.outer_idx].ndims;
-      unsigned int pix_size = params->special.concat_case3.nbytes *
-                              ((LL_LIB_TensorInfo_TypeDef *)params->g_tensors)[params->special.concat_case3.outer_idx]
-                                  .shape[(in_ndims - 4) + TDIM_NCHANNELS];
-      params->g_size =
-          pix_size * ((LL_LIB_TensorInfo_TypeDef *)params->g_tensors)[params->special.concat_case3.outer_idx]
-                         .shape[(in_ndims - 4) + TDIM_FWIDTH];
-      params->g_dst_o_src += params->g_size;
-      params->special.concat_case3.in_curr = LL_Buffer_addr_start(((LL_LIB_TensorInfo_TypeDef *)params->g_tensors) +
-                                                                  params->special.concat_case3.outer_idx);
-      params->g_idx = 0;
-
-      /* loop back one epoch block */
-      LL_ATON_RT_DecCurrEpochBlock(1);
-    }
-    else
-    {
-      /* proceed to next epoch block */
-    }
+    /* proceed to next epoch block */
   }
 }
 
@@ -1029,11 +1038,11 @@ static void __LL_LIB_DMA_Transfer_End_EpochBlock(const void *epoch_block)
   /* proceed to next epoch block */
 }
 
-static LL_ATON_RT_EpochBlockItem_t _concat_case3_epoch_block_array[] = {
+static LL_ATON_RT_EpochBlockItem_t _concat_strided_epoch_block_array[] = {
     // REMEMBER: static variables are not suited for multithreaded etc. environments
     {
-        .start_epoch_block = __LL_LIB_Concat_Case3_Start_EpochBlock,
-        .end_epoch_block = __LL_LIB_Concat_Case3_End_EpochBlock,
+        .start_epoch_block = __LL_LIB_Concat_Strided_Start_EpochBlock,
+        .end_epoch_block = __LL_LIB_Concat_Strided_End_EpochBlock,
         .flags = EpochBlock_Flags_internal,
 #ifdef LL_ATON_EB_DBG_INFO
         .epoch_num = -1,
@@ -1289,6 +1298,46 @@ static void __LL_ATON_LIB_DMA_Inputs_Batched_Memcpy(const LL_LIB_TensorInfo_Type
   }
 }
 
+/**
+ * @brief  performs a concatenation copy from `ninputs` inputs to one output using stream engines `dma_in` and `dma_out`:
+ * each input is written in chunks of `shape[axis] * jump_base` bytes, `jump` bytes apart, one transfer per input
+ * @param  inputs list of input tensor info structures
+ * @param  ninputs number of inputs
+ * @param  dst destination address of the first chunk of the first input
+ * @param  axis concatenation axis (ATON order)
+ * @param  jump_base number of bytes per index of the concatenation axis
+ * @param  jump number of bytes between two consecutive chunks of the output
+ */
+static void __LL_ATON_LIB_DMA_Inputs_Strided_Memcpy(const LL_LIB_TensorInfo_TypeDef *inputs, unsigned int ninputs,
+                                                    unsigned char *dst, unsigned int axis, uint32_t jump_base,
+                                                    uint32_t jump, int dma_in, int dma_out)
+{
+  /* start epoch block sequence */
+  if (ninputs > 0)
+  {
+    /* widest channel dividing every chunk and the output jump (no alignment needed in raw mode) */
+    uint8_t nbits = ((jump_base % 3) == 0) ? 24 : (((jump_base % 2) == 0) ? 16 : 8);
+    __ll_lib_params_t *params = __ll_lib_get_params();
+
+    /* prepare epoch */
+    __ll_lib_prepare_inputs_epoch(inputs, ninputs, &_static_const_dma_in, &_static_const_dma_out, dst, -1);
+    params->g_dma_in.nbits_in = params->g_dma_in.nbits_out = nbits;
+    params->g_dma_out.nbits_in = params->g_dma_out.nbits_out = nbits;
+    params->special.concat_strided.axis = axis;
+    params->special.concat_strided.jump_base = jump_base;
+    params->special.concat_strided.jump = jump;
+
+    /* configure stream switch */
+    __ll_lib_strswitch_set_dmas(dma_in, dma_out, _concat_strided_epoch_block_array);
+
+    LL_ATON_RT_Insert_LibEpochBlockArray(_concat_strided_epoch_block_array);
+  }
+  else
+  {
+    /* proceed to next epoch block */
+  }
+}
+
 /**
  * @brief  performs a memory copy operation from one input to `noutputs` outputs using stream engines `dma_in` and
  * `dma_out`
@@ -2155,27 +2204,11 @@ LL_ATON_PRINTF("out: b=%d w=%d g=%d c=%d ndims=%d\n",out_batches,out_fwidth,out_
 
 #if _LL_LIB_Concat_Cast_USE_ATON_HW
       {
-        unsigned int pix_size = nbytes * inputs[0].shape[(in_ndims - 4) + TDIM_NCHANNELS];
-        unsigned int line_size = pix_size * inputs[0].shape[(in_ndims - 4) + TDIM_FWIDTH];
-
-        __ll_lib_params_t *params = __ll_lib_get_params();
-        params->special.concat_case3.outer_idx = 0;
-        params->special.concat_case3.in_fheight = in_fheight;
-        params->special.concat_case3.nbytes = nbytes;
-        params->special.concat_case3.out_line_size = out_line_size;
-        params->special.concat_case3.in_curr = LL_Buffer_addr_start((LL_LIB_TensorInfo_TypeDef *)params->g_tensors);
-
-        /* start epoch block sequence */
-        if ((ninputs > 0) && (in_fheight > 0))
+        /* one strided transfer per input (chunks are the input lines) */
+        if (in_fheight > 0)
         {
-          /* prepare epoch */
-          __ll_lib_prepare_inputs_epoch(inputs, ninputs, &_static_const_dma_in, &_static_const_dma_out,
-                                        (void *)out_start, line_size);
-
-          /* configure stream switch */
-          __ll_lib_strswitch_set_dmas(dma_in, dma_out, _concat_case3_epoch_block_array);
-
-          LL_ATON_RT_Insert_LibEpochBlockArray(_concat_case3_epoch_block_array);
+          __LL_ATON_LIB_DMA_Inputs_Strided_Memcpy(inputs, ninputs, out_start, atonn_axis, out_pix_size, out_line_size,
+                                                  dma_in, dma_out);
         }
         else
         {
@@ -2256,6 +2289,15 @@ LL_ATON_PRINTF("out: b=%d w=%d g=%d c=%d ndims=%d\n",out_batches,out_fwidth,out_
   uint32_t jump = jump_base * output->shape[atonn_axis];
   // LL_ATON_PRINTF("jump_base=%d, jump=%d\n", jump_base, jump);
 
+#if _LL_LIB_Concat_Cast_USE_ATON_HW
+  if (tot_size >= __LL_DMA_MIN_BUFF_LEN)
+  {
+    __LL_ATON_LIB_DMA_Inputs_Strided_Memcpy(inputs, ninputs, LL_Buffer_addr_start(output), atonn_axis, jump_base, jump,
+                                            dma_in, dma_out);
+    return LL_ATON_OK;
+  }
+#endif // _LL_LIB_Concat_Cast_USE_ATON_HW
+
   for (i = 0; i < ninputs; i++)
   {
     uint32_t copy_val = inputs[i].shape[atonn_axis] * jump_base;
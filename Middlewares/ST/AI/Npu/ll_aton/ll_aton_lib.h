@@ -173,15 +173,13 @@ int LL_LIB_TENSOR_ELEMENTS(const LL_LIB_TensorInfo_TypeDef *t);
     /* Special field(s) for single cases */
     union
     {
-      /* Concat_Case3 */
+      /* Concat_Strided */
       struct
       {
-        unsigned int outer_idx;
-        unsigned int in_fheight;
-        unsigned int nbytes;
-        unsigned int out_line_size;
-        unsigned char *in_curr;
-      } concat_case3;
+        unsigned int axis;      // concatenation axis (ATON order)
+        unsigned int jump_base; // bytes per index of the concatenation axis
+        unsigned int jump;      // bytes between two consecutive chunks of the output
+      } concat_strided;
       /* Pad */
       __ll_pad_sw_params_t pad;
     } special;
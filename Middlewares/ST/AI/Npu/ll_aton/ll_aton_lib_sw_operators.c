@@ -26,6 +26,11 @@
 #include "ll_aton_lib_sw_operators.h"
 #include "ll_aton_runtime.h"
 
+#if defined(__ARM_FEATURE_MVE) && !defined(DUMP_DEBUG_SW_OPS)
+#include <arm_mve.h>
+#define LL_ATON_LIB_MVE 1
+#endif
+
 /* Common data structure(s) */
 typedef struct __ll_stack_lnklst
 {
@@ -83,6 +88,69 @@ static inline void __ll_aton_lib_copy_element(uint8_t nbytes, int32_t index, int
   }
 }
 
+/**
+ * @brief  copies `nelems` consecutive input elements to output elements `out_stride` bytes apart
+ * @param  nbytes element size in bytes
+ * @param  out_target first output element
+ * @param  out_stride distance in bytes between output elements
+ * @param  in_target first input element
+ * @param  nelems number of elements
+ */
+static void __ll_aton_lib_copy_strided(uint8_t nbytes, int8_t *out_target, uint32_t out_stride,
+                                       const int8_t *in_target, uint32_t nelems)
+{
+#if defined(LL_ATON_LIB_MVE)
+  /* contiguous widening loads, scatter stores: four elements per iteration, tail predicated */
+  const uint32x4_t offsets = vmulq_n_u32(vidupq_n_u32(0, 1), out_stride);
+  const uint32_t out_step = 4 * out_stride;
+
+  switch (nbytes)
+  {
+  case 1:
+    for (int32_t left = (int32_t)nelems; left > 0; left -= 4)
+    {
+      mve_pred16_t p = vctp32q((uint32_t)left);
+      vstrbq_scatter_offset_p_s32(out_target, offsets, vldrbq_z_s32(in_target, p), p);
+      in_target += 4;
+      out_target += out_step;
+    }
+    return;
+
+  case 2:
+    LL_ATON_ASSERT((((uintptr_t)in_target) % 2) == 0);
+    LL_ATON_ASSERT((((uintptr_t)out_target) % 2) == 0);
+    for (int32_t left = (int32_t)nelems; left > 0; left -= 4)
+    {
+      mve_pred16_t p = vctp32q((uint32_t)left);
+      vstrhq_scatter_offset_p_s32((int16_t *)out_target, offsets, vldrhq_z_s32((const int16_t *)in_target, p), p);
+      in_target += 8;
+      out_target += out_step;
+    }
+    return;
+
+  case 4:
+    LL_ATON_ASSERT((((uintptr_t)in_target) % 4) == 0);
+    LL_ATON_ASSERT((((uintptr_t)out_target) % 4) == 0);
+    for (int32_t left = (int32_t)nelems; left > 0; left -= 4)
+    {
+      mve_pred16_t p = vctp32q((uint32_t)left);
+      vstrwq_scatter_offset_p_s32((int32_t *)out_target, offsets, vldrwq_z_s32((const int32_t *)in_target, p), p);
+      in_target += 16;
+      out_target += out_step;
+    }
+    return;
+
+  default:
+    break;
+  }
+#endif
+
+  for (uint32_t index = 0; index < nelems; index++)
+  {
+    __ll_aton_lib_copy_element(nbytes, index, out_target + (index * out_stride), (int8_t *)in_target + (index * nbytes));
+  }
+}
+
 static inline uint32_t __ll_aton_lib_calc_offset(uint32_t n, uint32_t c, uint32_t h, uint32_t w, uint32_t offset_0,
                                                  uint32_t offset_1, uint32_t offset_2, uint32_t offset_3)
 {
@@ -923,14 +991,7 @@ static void __ll_aton_lib_transpose(uint32_t curr_in_axis, uint32_t inner_out_ax
 
     if (byte_size != out_axes_offset)
     {
-      for (; linked_stack_list.index < end_index; linked_stack_list.index++)
-      {
-        /* determine input/output position */
-        int8_t *in_target = base_in_target + (linked_stack_list.index * byte_size);
-        int8_t *out_target = base_out_target + (linked_stack_list.index * out_axes_offset);
-
-        __ll_aton_lib_copy_element(byte_size, linked_stack_list.index, out_target, in_target);
-      }
+      __ll_aton_lib_copy_strided(byte_size, base_out_target, out_axes_offset, base_in_target, end_index);
     }
     else
     {
@@ -1021,14 +1082,7 @@ static void __ll_aton_lib_transpose_3or4(const __ll_transp_params_t *common_para
 
         if (byte_size != out_axes_offset)
         {
-          for (uint32_t index_w = 0; index_w < size_w; index_w++)
-          {
-            /* determine input/output position */
-            int8_t *in_target = base_in_target + (index_w * byte_size);
-            int8_t *out_target = base_out_target + (index_w * out_axes_offset);
-
-            __ll_aton_lib_copy_element(byte_size, index_w, out_target, in_target);
-          }
+          __ll_aton_lib_copy_strided(byte_size, base_out_target, out_axes_offset, base_in_target, size_w);
         }
         else
         {
@@ -243,6 +243,62 @@ static inline void __LL_ATON_RT_ExecEndEpochBlock(const LL_ATON_RT_EpochBlockIte
   }
 }
 
+#if (LL_ATON_RT_MODE == LL_ATON_RT_ASYNC) && (LL_ATON_RT_SW_OVERLAP == 1)
+/**
+ * @brief Returns the current epoch block if it is a SW epoch block to be overlapped with the next (HW) one, else NULL
+ * @note  Only in the main epoch block list, with the ATON IP free (another network may own it) and no epoch callback
+ *        installed: the callbacks expect the epoch blocks one at a time
+ */
+static inline const LL_ATON_RT_EpochBlockItem_t *__LL_ATON_RT_GetOverlapSWEpochBlock(NN_Instance_TypeDef *nn_instance)
+{
+  const LL_ATON_RT_EpochBlockItem_t *eb = nn_instance->exec_state.current_epoch_block;
+
+  if (!EpochBlock_IsEpochSWOverlap(eb) || (nn_instance->exec_state.saved_current_epoch_block != NULL) ||
+      (nn_instance->exec_state.epoch_callback_function != NULL) || (__ll_current_aton_ip_owner != NULL))
+  {
+    return NULL;
+  }
+  if (EpochBlock_IsLastEpochBlock(eb + 1) || !EpochBlock_IsEpochPureHW(eb + 1))
+  {
+    return NULL;
+  }
+  return eb;
+}
+
+/**
+ * @brief Executes a SW epoch block on the MCU while the following HW epoch block runs
+ * @note  No epoch callbacks: its time is accounted to the HW epoch block it overlaps
+ */
+static void __LL_ATON_RT_ExecOverlapSWEpochBlock(const LL_ATON_RT_EpochBlockItem_t *eb,
+                                                 NN_Instance_TypeDef *nn_instance)
+{
+  EpochBlock_FuncPtr_t funcs[2] = {eb->start_epoch_block, eb->end_epoch_block};
+#if !defined(LL_ATON_RT_RELOC)
+  LL_ATON_LIB_UNUSED(nn_instance);
+#endif
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (funcs[i] == NULL)
+    {
+      continue;
+    }
+#if defined(LL_ATON_RT_RELOC)
+    if (nn_instance->exec_state.inst_reloc != 0)
+    {
+      ai_rel_call_start_end_function(nn_instance->exec_state.inst_reloc, funcs[i], (const void *)eb);
+    }
+    else
+    {
+      funcs[i]((const void *)eb);
+    }
+#else
+    funcs[i]((const void *)eb);
+#endif
+  }
+}
+#endif // (LL_ATON_RT_MODE == LL_ATON_RT_ASYNC) && (LL_ATON_RT_SW_OVERLAP == 1)
+
 static void __LL_ATON_RT_DetermineNextEpochBlock(NN_Instance_TypeDef *nn_instance)
 {
   LL_ATON_ASSERT(nn_instance != NULL);
@@ -687,9 +743,26 @@ LL_ATON_RT_RetValues_t LL_ATON_RT_RunEpochBlock(NN_Instance_TypeDef *nn_instance
 
     if (!nn_instance->exec_state.current_epoch_block_started)
     {
+#if (LL_ATON_RT_SW_OVERLAP == 1)
+      /* A SW epoch block independent from the next HW one: start the latter first, then execute the SW epoch block
+       * on the MCU while the NPU runs */
+      const LL_ATON_RT_EpochBlockItem_t *overlap_sw = __LL_ATON_RT_GetOverlapSWEpochBlock(nn_instance);
+      if (overlap_sw != NULL)
+      {
+        nn_instance->exec_state.current_epoch_block++;
+      }
+#endif // (LL_ATON_RT_SW_OVERLAP == 1)
+
       nn_instance->exec_state.current_epoch_block_started = true;
 
       __LL_ATON_RT_ExecStartEpochBlock(nn_instance->exec_state.current_epoch_block, nn_instance);
+
+#if (LL_ATON_RT_SW_OVERLAP == 1)
+      if (overlap_sw != NULL)
+      {
+        __LL_ATON_RT_ExecOverlapSWEpochBlock(overlap_sw, nn_instance);
+      }
+#endif // (LL_ATON_RT_SW_OVERLAP == 1)
     }
 
     /* End epoch block and advance to next one */
@@ -33,6 +33,11 @@
 #include "layers.h"
 #include "ll_aton_util.h"
 
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+#include <arm_mve.h>
+#define LL_SW_MVE_FLOAT 1
+#endif
+
 #define FORMAT AI_ARRAY_FORMAT_FLOAT
 
 #define SHAPE_INIT(a_, b_, c_, d_) AI_SHAPE_INIT(4, (d_), (c_), (b_), (a_))
@@ -336,11 +341,101 @@ void ll_sw_forward_quantizelinear(/* int processor, */ void *sw_info_struct)
 }
 
 //##########################################################################################
+/** True when a tensor is packed in (b, h, w, c) order with no gaps */
+static bool helper_tensor_is_dense(const Tensor_info *t, uint32_t elem_size)
+{
+  const uint32_t c_stride = elem_size;
+  const uint32_t w_stride = c_stride * t->dim.tensor_c;
+  const uint32_t h_stride = w_stride * t->dim.tensor_w;
+  const uint32_t b_stride = h_stride * t->dim.tensor_h;
+
+  return (t->dim.num_elem == t->dim.tensor_b * t->dim.tensor_h * t->dim.tensor_w * t->dim.tensor_c) &&
+         (t->stride.c == c_stride) && (t->stride.w == w_stride) && (t->stride.h == h_stride) &&
+         ((t->stride.b == b_stride) || (t->dim.tensor_b <= 1));
+}
+
+/** Per-tensor DequantizeLinear of dense 8-bit data to dense float: out = (in - zp) * scale, one rounding as in the
+ * generic path. Returns false (nothing written) when the tensors do not qualify */
+static bool helper_dequantize_dense(const Dequantizelinear_sw_info *sw_info)
+{
+  const Tensor_info *in = &sw_info->general.input;
+  const Tensor_info *out = &sw_info->general.output;
+  const uint32_t n = in->dim.num_elem;
+
+  if ((sw_info->is.dim.num_elem != 1) || (sw_info->izp.dim.num_elem != 1) || (out->dim.num_elem != n) ||
+      (sw_info->is.format.is_signed != in->format.is_signed) || !helper_tensor_is_dense(in, 1) ||
+      !helper_tensor_is_dense(out, 4) || (((uintptr_t)out->mem.start_offset & 3) != 0))
+  {
+    return false;
+  }
+  // in place or overlapping buffers: leave them to the generic path
+  if ((out->mem.start_offset < in->mem.start_offset + n) && (in->mem.start_offset < out->mem.start_offset + 4 * n))
+  {
+    return false;
+  }
+
+  const float scale = *(const float *)sw_info->is.mem.start_offset;
+  const int32_t zp = in->format.is_signed ? (int32_t)(*(const int8_t *)sw_info->izp.mem.start_offset)
+                                          : (int32_t)(*(const uint8_t *)sw_info->izp.mem.start_offset);
+  float *dst = (float *)out->mem.start_offset;
+
+#if defined(LL_SW_MVE_FLOAT)
+  // four lanes per iteration: widening byte loads, tail predicated
+  if (in->format.is_signed)
+  {
+    const int8_t *src = (const int8_t *)in->mem.start_offset;
+    for (int32_t left = (int32_t)n; left > 0; left -= 4)
+    {
+      mve_pred16_t p = vctp32q((uint32_t)left);
+      int32x4_t v = vsubq_x_n_s32(vldrbq_z_s32(src, p), zp, p);
+      vstrwq_p_f32(dst, vmulq_x_n_f32(vcvtq_x_f32_s32(v, p), scale, p), p);
+      src += 4;
+      dst += 4;
+    }
+  }
+  else
+  {
+    const uint8_t *src = (const uint8_t *)in->mem.start_offset;
+    for (int32_t left = (int32_t)n; left > 0; left -= 4)
+    {
+      mve_pred16_t p = vctp32q((uint32_t)left);
+      int32x4_t v = vsubq_x_n_s32(vreinterpretq_s32_u32(vldrbq_z_u32(src, p)), zp, p);
+      vstrwq_p_f32(dst, vmulq_x_n_f32(vcvtq_x_f32_s32(v, p), scale, p), p);
+      src += 4;
+      dst += 4;
+    }
+  }
+#else
+  if (in->format.is_signed)
+  {
+    const int8_t *src = (const int8_t *)in->mem.start_offset;
+    for (uint32_t i = 0; i < n; i++)
+    {
+      dst[i] = (float)((int32_t)src[i] - zp) * scale;
+    }
+  }
+  else
+  {
+    const uint8_t *src = (const uint8_t *)in->mem.start_offset;
+    for (uint32_t i = 0; i < n; i++)
+    {
+      dst[i] = (float)((int32_t)src[i] - zp) * scale;
+    }
+  }
+#endif
+  return true;
+}
+
 /** Dequantizelinear forward function */
 void ll_sw_forward_dequantizelinear(/* int processor, */ void *sw_info_struct)
 {
   Dequantizelinear_sw_info *sw_info = (Dequantizelinear_sw_info *)sw_info_struct;
 
+  if (helper_dequantize_dense(sw_info))
+  {
+    return;
+  }
+
   // array init
   int32_t format = sw_info->general.input.format.is_signed ? (AI_ARRAY_FORMAT_S8 | AI_FMT_FLAG_IS_IO)
                                                            : (AI_ARRAY_FORMAT_U8 | AI_FMT_FLAG_IS_IO);
@@ -41,6 +41,10 @@ ISP_StatusTypeDef ISP_GetExposureTarget(ISP_HandleTypeDef *hIsp, ISP_ExposureCom
 ISP_StatusTypeDef ISP_ListWBRefModes(ISP_HandleTypeDef *hIsp, uint32_t RefColorTemp[]);
 ISP_StatusTypeDef ISP_SetAECState(ISP_HandleTypeDef *hIsp, uint8_t enable);
 ISP_StatusTypeDef ISP_GetAECState(ISP_HandleTypeDef *hIsp, uint8_t *pEnable);
+ISP_StatusTypeDef ISP_SetAECExposureMax(ISP_HandleTypeDef *hIsp, uint32_t ExposureMax);
+ISP_StatusTypeDef ISP_SetDeferredApply(ISP_HandleTypeDef *hIsp, uint8_t Enable);
+ISP_StatusTypeDef ISP_TakePending(ISP_HandleTypeDef *hIsp, ISP_PendingTypeDef *pPending);
+ISP_StatusTypeDef ISP_ApplyPending(ISP_HandleTypeDef *hIsp, const ISP_PendingTypeDef *pPending);
 ISP_StatusTypeDef ISP_SetWBRefMode(ISP_HandleTypeDef *hIsp, uint8_t Automatic, uint32_t RefColorTemp);
 ISP_StatusTypeDef ISP_GetWBRefMode(ISP_HandleTypeDef *hIsp, uint8_t *pAutomatic, uint32_t *pRefColorTemp);
 ISP_StatusTypeDef ISP_GetDecimationFactor(ISP_HandleTypeDef *hIsp, ISP_DecimationTypeDef *pDecimation);
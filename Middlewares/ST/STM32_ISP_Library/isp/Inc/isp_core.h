@@ -194,6 +194,14 @@ typedef struct
   ISP_StatusTypeDef (*GetSensorExposure)(uint32_t Instance, int32_t *Exposure);
   /* [OPTIONAL] Set sensor test pattern */
   ISP_StatusTypeDef (*SetSensorTestPattern)(uint32_t Instance, int32_t mode);
+  /* [OPTIONAL] Send a frame returned by DumpFrame to the remote tool. The parameters are:
+  *    pBuffer:   Dumped buffer
+  *    Size:      Size of the dump in bytes
+  *  Returns once the transfer is queued: the application sends the buffer with
+  *  ISP_ToolCom_SendDump(), the next command waiting until then. If NULL or
+  *  failing, the dump is sent from ISP_BackgroundProcess()
+  */
+  ISP_StatusTypeDef (*SendDump)(uint8_t *pBuffer, uint32_t Size);
 } ISP_AppliHelpersTypeDef;
 
 /* ISP Device handle structure */
@@ -208,6 +216,8 @@ typedef struct
   uint32_t AncillaryPipe_FrameCount;
   uint32_t DumpPipe_FrameCount;
   ISP_SensorInfoTypeDef sensorInfo;
+  uint32_t aecExposureMax; /* AEC exposure limit, 0 for sensorInfo.exposure_max */
+  uint8_t deferApply;      /* Gain, exposure and color writes held for ISP_ApplyPending() */
 } ISP_HandleTypeDef;
 
 /* ISP Demosaicing type */
@@ -377,6 +387,21 @@ typedef struct
   int32_t coeff[3][3];        /* 3x3 RGB to RGB matrix coefficients. Unit = 100000000 for "x1.0", -150000000 for "x-1.5". Range is "x-4.0" to "x4.0" */
 } ISP_ColorConvTypeDef;
 
+/* Writes held by ISP_SetDeferredApply(), flags of the valid members */
+#define ISP_PENDING_SENSOR_EXPOSURE  (1U << 0)
+#define ISP_PENDING_SENSOR_GAIN      (1U << 1)
+#define ISP_PENDING_ISP_GAIN         (1U << 2)
+#define ISP_PENDING_COLORCONV        (1U << 3)
+
+typedef struct
+{
+  uint32_t valid;             /* ISP_PENDING_ flags */
+  ISP_SensorExposureTypeDef sensorExposure;
+  ISP_SensorGainTypeDef sensorGain;
+  ISP_ISPGainTypeDef ispGain;
+  ISP_ColorConvTypeDef colorConv;
+} ISP_PendingTypeDef;
+
 typedef struct
 {
   uint8_t averageR;           /* Average of the red component */
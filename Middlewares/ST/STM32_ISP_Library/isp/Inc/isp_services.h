@@ -82,6 +82,11 @@ ISP_StatusTypeDef ISP_SVC_Sensor_SetExposure(ISP_HandleTypeDef *hIsp, ISP_Sensor
 ISP_StatusTypeDef ISP_SVC_Sensor_GetExposure(ISP_HandleTypeDef *hIsp, ISP_SensorExposureTypeDef *pConfig);
 ISP_StatusTypeDef ISP_SVC_Sensor_SetTestPattern(ISP_HandleTypeDef *hIsp, ISP_SensorTestPatternTypeDef *pConfig);
 
+/* Deferred apply services */
+ISP_StatusTypeDef ISP_SVC_Pending_SetDeferred(ISP_HandleTypeDef *hIsp, uint8_t Enable);
+ISP_StatusTypeDef ISP_SVC_Pending_Take(ISP_HandleTypeDef *hIsp, ISP_PendingTypeDef *pPending);
+ISP_StatusTypeDef ISP_SVC_Pending_Apply(ISP_HandleTypeDef *hIsp, const ISP_PendingTypeDef *pPending);
+
 /* Misc services */
 ISP_StatusTypeDef ISP_SVC_Misc_IsDCMIPPReady(ISP_HandleTypeDef *hIsp);
 ISP_StatusTypeDef ISP_SVC_Misc_GetDCMIPPVersion(ISP_HandleTypeDef *hIsp, uint32_t *pMajRev, uint32_t *pMinRev);
@@ -20,6 +20,7 @@
 #ifndef __ISP_TOOL_COM_H
 #define __ISP_TOOL_COM_H
 /* Includes ------------------------------------------------------------------*/
+#include "isp_core.h"
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -29,6 +30,8 @@ void ISP_ToolCom_Init(void);
 void ISP_ToolCom_ReceivedCb(uint8_t *buffer, uint32_t buffer_size);
 void ISP_ToolCom_SendData(uint8_t *buffer, uint32_t buffer_size, char *dump_start_msg,  char *dump_stop_msg);
 uint32_t ISP_ToolCom_CheckCommandReceived(uint8_t **block_cmd);
+ISP_StatusTypeDef ISP_ToolCom_QueueDump(ISP_HandleTypeDef *hIsp, uint8_t *buffer, uint32_t buffer_size);
+void ISP_ToolCom_SendDump(uint8_t *buffer, uint32_t buffer_size);
 void ISP_ToolCom_PrepareNextCommand();
 
 #endif
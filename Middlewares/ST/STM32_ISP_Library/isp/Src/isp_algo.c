@@ -406,6 +406,8 @@ ISP_StatusTypeDef ISP_Algo_AEC_Process(void *hIsp, void *pAlgo)
   ISP_SensorGainTypeDef gainConfig;
   ISP_SensorExposureTypeDef exposureConfig;
   uint32_t avgL;
+  uint32_t exposureMax;
+  uint8_t exposureStale = 0;
 #ifdef ALGO_AEC_DBG_LOGS
   static uint32_t currentL;
 #endif
@@ -444,6 +446,18 @@ ISP_StatusTypeDef ISP_Algo_AEC_Process(void *hIsp, void *pAlgo)
     /* Align on the anti-flicker frequency (may have been updated by IQTune)*/
     pIspAEprocess->hyper_params.compat_freq = IQParamConfig->AECAlgo.antiFlickerFreq;
 
+    /* Align on the exposure limit (may have been updated with ISP_SetAECExposureMax()) */
+    exposureMax = ((ISP_HandleTypeDef *)hIsp)->sensorInfo.exposure_max;
+    if ((((ISP_HandleTypeDef *)hIsp)->aecExposureMax != 0) && (((ISP_HandleTypeDef *)hIsp)->aecExposureMax < exposureMax))
+    {
+      exposureMax = ((ISP_HandleTypeDef *)hIsp)->aecExposureMax;
+      if (exposureMax < pIspAEprocess->hyper_params.exposure_min)
+      {
+        exposureMax = pIspAEprocess->hyper_params.exposure_min;
+      }
+    }
+    pIspAEprocess->hyper_params.exposure_max = exposureMax;
+
     avgL = stats.down.averageL;
 #ifdef ALGO_AEC_DBG_LOGS
     if (avgL != currentL)
@@ -465,6 +479,14 @@ ISP_StatusTypeDef ISP_Algo_AEC_Process(void *hIsp, void *pAlgo)
       return ret;
     }
 
+    /* Above a lowered limit: the algo restarts from the limit, which differs
+     * from the sensor exposure and is applied below */
+    if (exposureConfig.exposure > exposureMax)
+    {
+      exposureConfig.exposure = exposureMax;
+      exposureStale = 1;
+    }
+
     /* Store meta data */
     Meta.averageL = (uint8_t)avgL;
     Meta.exposureTarget = IQParamConfig->AECAlgo.exposureTarget;
@@ -489,7 +511,7 @@ ISP_StatusTypeDef ISP_Algo_AEC_Process(void *hIsp, void *pAlgo)
 #endif
       }
 
-      if (exposureConfig.exposure != pIspAEprocess->new_exposure)
+      if ((exposureConfig.exposure != pIspAEprocess->new_exposure) || exposureStale)
       {
         /* Set new exposure */
         exposureConfig.exposure = pIspAEprocess->new_exposure;
@@ -527,26 +549,68 @@ ISP_StatusTypeDef ISP_Algo_AEC_Process(void *hIsp, void *pAlgo)
 #endif /* ISP_MW_SW_AEC_ALGO_SUPPORT */
 
 #ifdef ISP_MW_SW_AWB_ALGO_SUPPORT
+/* Q16 fixed point of the AWB statistics math: single-cycle 32-bit products
+ * in place of 64-bit divisions on the ISP thread */
+#define ALGO_Q16_SHIFT               16
+#define ALGO_Q16_ONE                 (1 << ALGO_Q16_SHIFT)
+
+/* Gamma 1/2.2 of the 8-bit components, single precision, built at first use */
+static float GammaInverseLut[256];
+static uint8_t GammaInverseLutReady;
+
+/* Color conversion matrix in Q16, converted when the ISP one changes.
+ * Coefficients are within x-4.0 to x4.0: 3 x 255 x 4.0 in Q16 fits int32 */
+static int32_t CConvCoeff[3][3];
+static int32_t CConvCoeffQ16[3][3];
+static uint8_t CConvCoeffReady;
+
+/* Inverse ISP gains in Q16, converted when the gains change */
+static uint32_t UpStatGain[3];
+static uint32_t UpStatGainInvQ16[3];
+static uint8_t UpStatGainReady;
+
 /**
   * @brief  ISP_Algo_ApplyGammaInverse
   *         Apply Gamma 1/2.2 correction to a component value
   * @param  hIsp:  ISP device handle.
-  * @param  comp: component value
+  * @param  comp: component value, 0 to 255
   * @retval gamma corrected value
   */
-double ISP_Algo_ApplyGammaInverse(ISP_HandleTypeDef *hIsp, uint32_t comp)
+float ISP_Algo_ApplyGammaInverse(ISP_HandleTypeDef *hIsp, uint32_t comp)
 {
-  double out;
-
   /* Check if gamma is enabled */
-  if (ISP_SVC_Misc_IsGammaEnabled(hIsp, 1 /*main pipe*/) != 0) {
-    out = 255 * pow((float)comp / 255, 1.0 / 2.2);
+  if (ISP_SVC_Misc_IsGammaEnabled(hIsp, 1 /*main pipe*/) == 0)
+  {
+    return (float) comp;
   }
-  else
+
+  if (GammaInverseLutReady == 0)
+  {
+    for (uint32_t i = 0; i < 256; i++)
+    {
+      GammaInverseLut[i] = 255.0f * powf((float) i / 255.0f, 1.0f / 2.2f);
+    }
+    GammaInverseLutReady = 1;
+  }
+  return GammaInverseLut[(comp > 255U) ? 255U : comp];
+}
+
+/**
+  * @brief  ISP_Algo_GainInvQ16
+  *         Inverse of an ISP gain in Q16
+  * @param  gain: gain, unit ISP_GAIN_PRECISION_FACTOR
+  * @retval ISP_GAIN_PRECISION_FACTOR / gain in Q16, saturated
+  */
+static uint32_t ISP_Algo_GainInvQ16(uint32_t gain)
+{
+  uint64_t inv;
+
+  if (gain == 0)
   {
-    out = (double) comp;
+    return 0;
   }
-  return out;
+  inv = ((uint64_t) ISP_GAIN_PRECISION_FACTOR << ALGO_Q16_SHIFT) / gain;
+  return (inv > UINT32_MAX) ? UINT32_MAX : (uint32_t) inv;
 }
 
 /**
@@ -559,15 +623,27 @@ void ISP_Algo_GetUpStat(ISP_HandleTypeDef *hIsp, ISP_SVC_StatStateTypeDef *pStat
 {
   ISP_ISPGainTypeDef ISPGain;
   ISP_BlackLevelTypeDef BlackLevel;
-  int64_t upR, upG, upB;
+  uint64_t upR, upG, upB;
 
   if ((ISP_SVC_ISP_GetGain(hIsp, &ISPGain) == ISP_OK) && (ISPGain.enable == 1))
   {
+    if ((UpStatGainReady == 0) || (UpStatGain[0] != ISPGain.ispGainR) || (UpStatGain[1] != ISPGain.ispGainG)
+        || (UpStatGain[2] != ISPGain.ispGainB))
+    {
+      UpStatGain[0] = ISPGain.ispGainR;
+      UpStatGain[1] = ISPGain.ispGainG;
+      UpStatGain[2] = ISPGain.ispGainB;
+      for (uint32_t i = 0; i < 3; i++)
+      {
+        UpStatGainInvQ16[i] = ISP_Algo_GainInvQ16(UpStatGain[i]);
+      }
+      UpStatGainReady = 1;
+    }
 
-    /* reverse gain */
-    upR = (int64_t) pStats->down.averageR * ISP_GAIN_PRECISION_FACTOR / ISPGain.ispGainR;
-    upG = (int64_t) pStats->down.averageG * ISP_GAIN_PRECISION_FACTOR / ISPGain.ispGainG;
-    upB = (int64_t) pStats->down.averageB * ISP_GAIN_PRECISION_FACTOR / ISPGain.ispGainB;
+    /* reverse gain: 32 x 32 bit products, no division */
+    upR = ((uint64_t) pStats->down.averageR * UpStatGainInvQ16[0]) >> ALGO_Q16_SHIFT;
+    upG = ((uint64_t) pStats->down.averageG * UpStatGainInvQ16[1]) >> ALGO_Q16_SHIFT;
+    upB = ((uint64_t) pStats->down.averageB * UpStatGainInvQ16[2]) >> ALGO_Q16_SHIFT;
 
     pStats->up.averageR = (uint8_t) upR;
     pStats->up.averageG = (uint8_t) upG;
@@ -604,18 +680,32 @@ void ISP_Algo_GetUpStat(ISP_HandleTypeDef *hIsp, ISP_SVC_StatStateTypeDef *pStat
 void ISP_Algo_ApplyCConv(ISP_HandleTypeDef *hIsp, uint32_t inR, uint32_t inG, uint32_t inB, uint32_t *outR, uint32_t *outG, uint32_t *outB)
 {
   ISP_ColorConvTypeDef colorConv;
-  int64_t ccR, ccG, ccB;
+  int32_t ccR, ccG, ccB;
 
   if ((ISP_SVC_ISP_GetColorConv(hIsp, &colorConv) == ISP_OK) && (colorConv.enable == 1))
   {
+    if ((CConvCoeffReady == 0) || (memcmp(CConvCoeff, colorConv.coeff, sizeof(CConvCoeff)) != 0))
+    {
+      memcpy(CConvCoeff, colorConv.coeff, sizeof(CConvCoeff));
+      for (uint32_t i = 0; i < 3; i++)
+      {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+          CConvCoeffQ16[i][j] = (int32_t) (((int64_t) CConvCoeff[i][j] * ALGO_Q16_ONE) / ISP_CCM_PRECISION_FACTOR);
+        }
+      }
+      CConvCoeffReady = 1;
+    }
+
     /* Apply ColorConversion matrix to the input components */
-    ccR = (int64_t) inR * colorConv.coeff[0][0] + (int64_t) inG * colorConv.coeff[0][1] + (int64_t) inB * colorConv.coeff[0][2];
-    ccG = (int64_t) inR * colorConv.coeff[1][0] + (int64_t) inG * colorConv.coeff[1][1] + (int64_t) inB * colorConv.coeff[1][2];
-    ccB = (int64_t) inR * colorConv.coeff[2][0] + (int64_t) inG * colorConv.coeff[2][1] + (int64_t) inB * colorConv.coeff[2][2];
+    ccR = (int32_t) inR * CConvCoeffQ16[0][0] + (int32_t) inG * CConvCoeffQ16[0][1] + (int32_t) inB * CConvCoeffQ16[0][2];
+    ccG = (int32_t) inR * CConvCoeffQ16[1][0] + (int32_t) inG * CConvCoeffQ16[1][1] + (int32_t) inB * CConvCoeffQ16[1][2];
+    ccB = (int32_t) inR * CConvCoeffQ16[2][0] + (int32_t) inG * CConvCoeffQ16[2][1] + (int32_t) inB * CConvCoeffQ16[2][2];
 
-    ccR /= ISP_CCM_PRECISION_FACTOR;
-    ccG /= ISP_CCM_PRECISION_FACTOR;
-    ccB /= ISP_CCM_PRECISION_FACTOR;
+    /* Arithmetic shift: negative sums floor, then clamp to 0 below */
+    ccR >>= ALGO_Q16_SHIFT;
+    ccG >>= ALGO_Q16_SHIFT;
+    ccB >>= ALGO_Q16_SHIFT;
 
     /* Clamp values to 0-255 */
     ccR = (ccR < 0) ? 0 : (ccR > 255) ? 255 : ccR;
@@ -721,7 +811,7 @@ ISP_StatusTypeDef ISP_Algo_AWB_Process(void *hIsp, void *pAlgo)
   evision_return_t e_ret;
   uint32_t ccAvgR, ccAvgG, ccAvgB, colorTemp, i, j, profId, profNb;
   float cfaGains[4], ccmCoeffs[3][3], ccmOffsets[3] = { 0 };
-  double meas[3];
+  double meas[3]; /* evision API type: widened from the single precision LUT */
   static uint32_t statsHistory[3][3] = { 0 };
   static uint32_t colorTempHistory[2] = { 0 };
   static uint8_t skip_stat_check_count = ALGO_AWB_STAT_CHECK_SKIP_AFTER_INIT;
@@ -298,14 +298,10 @@ typedef union {
 } ISP_CMD_TypeDef;
 
 /* Private constants ---------------------------------------------------------*/
-#define ISP_MAX_DUMP_SIZE         4096
-#define ISP_DUMP_DATA_STR         "DUMP DATA"
-
 /* Private macro -------------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static ISP_StatusTypeDef ISP_CmdParser_SetConfig(ISP_HandleTypeDef *hIsp, uint8_t *cmd);
 static ISP_StatusTypeDef ISP_CmdParser_GetConfig(ISP_HandleTypeDef *hIsp, uint8_t *cmd);
-static void ISP_CmdParser_SendDumpData(uint8_t* pFrame, uint32_t size);
 static ISP_StatusTypeDef ISP_CmdParser_StatUpCb(ISP_AlgoTypeDef *pAlgo);
 static ISP_StatusTypeDef ISP_CmdParser_StatDownCb(ISP_AlgoTypeDef *pAlgo);
 
@@ -818,61 +814,12 @@ static ISP_StatusTypeDef ISP_CmdParser_GetConfig(ISP_HandleTypeDef *hIsp, uint8_
   /* Send dump buffer if requested  */
   if (((cmd_id == ISP_CMD_DUMP_PREVIEW_FRAME) || (cmd_id == ISP_CMD_DUMP_ISP_FRAME) || (cmd_id == ISP_CMD_DUMP_RAW_FRAME)) && (ret == ISP_OK))
   {
-    ISP_CmdParser_SendDumpData((uint8_t*)pFrame, c.dumpFrameMeta.data.size);
+    ISP_ToolCom_QueueDump(hIsp, (uint8_t*)pFrame, c.dumpFrameMeta.data.size);
   }
 
   return ret;
 }
 
-/**
-  * @brief  ISP_CmdParser_SendDumpData
-  *         Send dump frame data, splitting it in several parts if too large
-  * @param  pFrame: Pointer to data to send
-  * @param  size: Size of data to send
-  * @retval None
-  */
-static void ISP_CmdParser_SendDumpData(uint8_t* pFrame, uint32_t size)
-{
-  uint32_t sizeToSend, remaining = size;
-  uint8_t first = true;
-  char dump_start_msg[32];
-  char dump_stop_msg[32];
-
-  if (size > ISP_MAX_DUMP_SIZE) {
-    /* Split the data in several parts */
-    do {
-      if (first)
-      {
-        sprintf(dump_start_msg, "%s[", ISP_DUMP_DATA_STR);
-        sizeToSend = ISP_MAX_DUMP_SIZE;
-        first = false;
-        ISP_ToolCom_SendData((uint8_t*)pFrame, sizeToSend, dump_start_msg, NULL);
-      }
-      else if (remaining <= ISP_MAX_DUMP_SIZE)
-      {
-        sprintf(dump_stop_msg, "%s]", ISP_DUMP_DATA_STR);
-        sizeToSend = remaining;
-        ISP_ToolCom_SendData((uint8_t*)pFrame, sizeToSend, NULL, dump_stop_msg);
-      }
-      else
-      {
-        sizeToSend = ISP_MAX_DUMP_SIZE;
-        ISP_ToolCom_SendData((uint8_t*)pFrame, sizeToSend, NULL, NULL);
-      }
-
-      pFrame += sizeToSend;
-      remaining -= sizeToSend;
-    } while (remaining > 0);
-  }
-  else
-  {
-    /* Send all the data in one single part */
-    sprintf(dump_start_msg, "%s[", ISP_DUMP_DATA_STR);
-    sprintf(dump_stop_msg, "%s]", ISP_DUMP_DATA_STR);
-    ISP_ToolCom_SendData((uint8_t*)pFrame, size, dump_start_msg, dump_stop_msg);
-  }
-}
-
 /**
   * @brief  ISP_CmdParser_StatUpCb
   *         Callback called when statistics at Up are available
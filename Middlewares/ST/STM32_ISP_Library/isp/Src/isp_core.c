@@ -429,6 +429,67 @@ ISP_StatusTypeDef ISP_GetAECState(ISP_HandleTypeDef *hIsp, uint8_t *pEnable)
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SetAECExposureMax
+  *         Limit the exposure time the AEC algorithm may select, the gain
+  *         making up for it
+  * @param  hIsp: ISP device handle
+  * @param  ExposureMax: Exposure limit, 0 for the sensor maximum
+  * @retval Operation status
+  */
+ISP_StatusTypeDef ISP_SetAECExposureMax(ISP_HandleTypeDef *hIsp, uint32_t ExposureMax)
+{
+  if (hIsp == NULL)
+  {
+    return ISP_ERR_EINVAL;
+  }
+
+  hIsp->aecExposureMax = ExposureMax;
+
+  return ISP_OK;
+}
+
+/**
+  * @brief  ISP_SetDeferredApply
+  *         Split the background process: the sensor gain and exposure, ISP
+  *         gain and color conversion the algorithms compute are held, and
+  *         read back as held, until taken with ISP_TakePending() and written
+  *         with ISP_ApplyPending(), from another thread if need be
+  * @param  hIsp: ISP device handle
+  * @param  Enable: 1 to hold the writes, 0 to write them
+  * @retval Operation status
+  */
+ISP_StatusTypeDef ISP_SetDeferredApply(ISP_HandleTypeDef *hIsp, uint8_t Enable)
+{
+  return ISP_SVC_Pending_SetDeferred(hIsp, Enable);
+}
+
+/**
+  * @brief  ISP_TakePending
+  *         Move the writes held since the last call into a pending set,
+  *         merged over those it already holds
+  * @note   From the thread calling ISP_BackgroundProcess()
+  * @param  hIsp: ISP device handle
+  * @param  pPending: Pointer to the pending set
+  * @retval Operation status
+  */
+ISP_StatusTypeDef ISP_TakePending(ISP_HandleTypeDef *hIsp, ISP_PendingTypeDef *pPending)
+{
+  return ISP_SVC_Pending_Take(hIsp, pPending);
+}
+
+/**
+  * @brief  ISP_ApplyPending
+  *         Write the registers of a pending set
+  * @param  hIsp: ISP device handle
+  * @param  pPending: Pointer to the pending set
+  * @retval Operation status
+  */
+ISP_StatusTypeDef ISP_ApplyPending(ISP_HandleTypeDef *hIsp, const ISP_PendingTypeDef *pPending)
+{
+  return ISP_SVC_Pending_Apply(hIsp, pPending);
+}
+
 /**
   * @brief  ISP_ListWBRefModes
   *         List the reference modes (color temperature) that define a white balance configuration
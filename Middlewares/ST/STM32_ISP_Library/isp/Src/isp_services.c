@@ -79,6 +79,10 @@ static void To_Shift_Multiplier(uint32_t Factor, uint8_t *pShift, uint8_t *pMult
 static uint32_t From_Shift_Multiplier(uint8_t Shift, uint8_t Multiplier);
 static int16_t To_CConv_Reg(int32_t Coeff);
 static int32_t From_CConv_Reg(int16_t Reg);
+static ISP_StatusTypeDef ISP_SVC_ISP_WriteGain(ISP_HandleTypeDef *hIsp, const ISP_ISPGainTypeDef *pConfig);
+static ISP_StatusTypeDef ISP_SVC_ISP_WriteColorConv(ISP_HandleTypeDef *hIsp, const ISP_ColorConvTypeDef *pConfig);
+static ISP_StatusTypeDef ISP_SVC_Sensor_WriteGain(ISP_HandleTypeDef *hIsp, const ISP_SensorGainTypeDef *pConfig);
+static ISP_StatusTypeDef ISP_SVC_Sensor_WriteExposure(ISP_HandleTypeDef *hIsp, const ISP_SensorExposureTypeDef *pConfig);
 
 /* Private variables ---------------------------------------------------------*/
 static uint32_t ISP_ManualWBRefColorTemp = 0;
@@ -86,6 +90,9 @@ static ISP_DecimationTypeDef ISP_DecimationValue = {ISP_DECIM_FACTOR_1};
 static ISP_IQParamTypeDef ISP_IQParamCache;
 static ISP_SVC_StatEngineTypeDef ISP_SVC_StatEngine;
 static bool ISP_SensorDelayMeasureRun;
+/* While hIsp->deferApply: the latest value set of each member (what the
+ * getters return), valid flags for those not taken yet */
+static ISP_PendingTypeDef ISP_SVC_Pending;
 
 static const uint32_t avgRGBUp[] = {
     DCMIPP_STAT_EXT_SOURCE_PRE_BLKLVL_R, DCMIPP_STAT_EXT_SOURCE_PRE_BLKLVL_G, DCMIPP_STAT_EXT_SOURCE_PRE_BLKLVL_B
@@ -913,13 +920,13 @@ ISP_StatusTypeDef ISP_SVC_ISP_GetBlackLevel(ISP_HandleTypeDef *hIsp, ISP_BlackLe
 }
 
 /**
-  * @brief  ISP_SVC_ISP_SetGain
+  * @brief  ISP_SVC_ISP_WriteGain
   *         Set the ISP Exposure and White Balance gains
   * @param  hIsp: ISP device handle
   * @param  pConfig: Pointer to the ISP gain configuration
   * @retval operation result
   */
-ISP_StatusTypeDef ISP_SVC_ISP_SetGain(ISP_HandleTypeDef *hIsp, ISP_ISPGainTypeDef *pConfig)
+static ISP_StatusTypeDef ISP_SVC_ISP_WriteGain(ISP_HandleTypeDef *hIsp, const ISP_ISPGainTypeDef *pConfig)
 {
   HAL_StatusTypeDef halStatus;
   DCMIPP_ExposureConfTypeDef exposureConfig;
@@ -955,6 +962,26 @@ ISP_StatusTypeDef ISP_SVC_ISP_SetGain(ISP_HandleTypeDef *hIsp, ISP_ISPGainTypeDe
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SVC_ISP_SetGain
+  *         Set the ISP Exposure and White Balance gains
+  * @param  hIsp: ISP device handle
+  * @param  pConfig: Pointer to the ISP gain configuration
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_ISP_SetGain(ISP_HandleTypeDef *hIsp, ISP_ISPGainTypeDef *pConfig)
+{
+  /* Held for ISP_SVC_Pending_Apply() */
+  if ((hIsp != NULL) && (pConfig != NULL) && (hIsp->deferApply != 0))
+  {
+    ISP_SVC_Pending.ispGain = *pConfig;
+    ISP_SVC_Pending.valid |= ISP_PENDING_ISP_GAIN;
+    return ISP_OK;
+  }
+
+  return ISP_SVC_ISP_WriteGain(hIsp, pConfig);
+}
+
 /**
   * @brief  ISP_SVC_ISP_GetGain
   *         Get the ISP Exposure and White Balance gains
@@ -972,6 +999,13 @@ ISP_StatusTypeDef ISP_SVC_ISP_GetGain(ISP_HandleTypeDef *hIsp, ISP_ISPGainTypeDe
     return ISP_ERR_ISPGAIN_EINVAL;
   }
 
+  /* Held value */
+  if (hIsp->deferApply != 0)
+  {
+    *pConfig = ISP_SVC_Pending.ispGain;
+    return ISP_OK;
+  }
+
   pConfig->enable = (uint8_t) HAL_DCMIPP_PIPE_IsEnabledISPExposure(hIsp->hDcmipp, DCMIPP_PIPE1);
   HAL_DCMIPP_PIPE_GetISPExposureConfig(hIsp->hDcmipp, DCMIPP_PIPE1, &exposureConfig);
 
@@ -983,13 +1017,13 @@ ISP_StatusTypeDef ISP_SVC_ISP_GetGain(ISP_HandleTypeDef *hIsp, ISP_ISPGainTypeDe
 }
 
 /**
-  * @brief  ISP_SVC_ISP_SetColorConv
+  * @brief  ISP_SVC_ISP_WriteColorConv
   *         Set the ISP Color Conversion
   * @param  hIsp: ISP device handle
   * @param  pConfig: Pointer to the Color Conversion configuration
   * @retval operation result
   */
-ISP_StatusTypeDef ISP_SVC_ISP_SetColorConv(ISP_HandleTypeDef *hIsp, ISP_ColorConvTypeDef *pConfig)
+static ISP_StatusTypeDef ISP_SVC_ISP_WriteColorConv(ISP_HandleTypeDef *hIsp, const ISP_ColorConvTypeDef *pConfig)
 {
   HAL_StatusTypeDef halStatus;
   DCMIPP_ColorConversionConfTypeDef colorConvConfig;
@@ -1045,6 +1079,26 @@ ISP_StatusTypeDef ISP_SVC_ISP_SetColorConv(ISP_HandleTypeDef *hIsp, ISP_ColorCon
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SVC_ISP_SetColorConv
+  *         Set the ISP Color Conversion
+  * @param  hIsp: ISP device handle
+  * @param  pConfig: Pointer to the Color Conversion configuration
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_ISP_SetColorConv(ISP_HandleTypeDef *hIsp, ISP_ColorConvTypeDef *pConfig)
+{
+  /* Held for ISP_SVC_Pending_Apply() */
+  if ((hIsp != NULL) && (pConfig != NULL) && (hIsp->deferApply != 0))
+  {
+    ISP_SVC_Pending.colorConv = *pConfig;
+    ISP_SVC_Pending.valid |= ISP_PENDING_COLORCONV;
+    return ISP_OK;
+  }
+
+  return ISP_SVC_ISP_WriteColorConv(hIsp, pConfig);
+}
+
 /**
   * @brief  ISP_SVC_ISP_GetColorConv
   *         Get the ISP Color Conversion
@@ -1062,6 +1116,13 @@ ISP_StatusTypeDef ISP_SVC_ISP_GetColorConv(ISP_HandleTypeDef *hIsp, ISP_ColorCon
     return ISP_ERR_COLORCONV_EINVAL;
   }
 
+  /* Held value */
+  if (hIsp->deferApply != 0)
+  {
+    *pConfig = ISP_SVC_Pending.colorConv;
+    return ISP_OK;
+  }
+
   pConfig->enable = (uint8_t) HAL_DCMIPP_PIPE_IsEnabledISPColorConversion(hIsp->hDcmipp, DCMIPP_PIPE1);
 
   HAL_DCMIPP_PIPE_GetISPColorConversionConfig(hIsp->hDcmipp, DCMIPP_PIPE1, &colorConvConfig);
@@ -1106,13 +1167,13 @@ ISP_StatusTypeDef ISP_SVC_Sensor_GetInfo(ISP_HandleTypeDef *hIsp, ISP_SensorInfo
 }
 
 /**
-  * @brief  ISP_SVC_Sensor_SetGain
+  * @brief  ISP_SVC_Sensor_WriteGain
   *         Set the sensor gain
   * @param  hIsp: ISP device handle
   * @param  pConfig: Pointer to the sensor gain configuration
   * @retval operation result
   */
-ISP_StatusTypeDef ISP_SVC_Sensor_SetGain(ISP_HandleTypeDef *hIsp, ISP_SensorGainTypeDef *pConfig)
+static ISP_StatusTypeDef ISP_SVC_Sensor_WriteGain(ISP_HandleTypeDef *hIsp, const ISP_SensorGainTypeDef *pConfig)
 {
   /* Check handle validity */
   if ((hIsp == NULL) || (pConfig == NULL))
@@ -1133,6 +1194,26 @@ ISP_StatusTypeDef ISP_SVC_Sensor_SetGain(ISP_HandleTypeDef *hIsp, ISP_SensorGain
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SVC_Sensor_SetGain
+  *         Set the sensor gain
+  * @param  hIsp: ISP device handle
+  * @param  pConfig: Pointer to the sensor gain configuration
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_Sensor_SetGain(ISP_HandleTypeDef *hIsp, ISP_SensorGainTypeDef *pConfig)
+{
+  /* Held for ISP_SVC_Pending_Apply() */
+  if ((hIsp != NULL) && (pConfig != NULL) && (hIsp->deferApply != 0))
+  {
+    ISP_SVC_Pending.sensorGain = *pConfig;
+    ISP_SVC_Pending.valid |= ISP_PENDING_SENSOR_GAIN;
+    return ISP_OK;
+  }
+
+  return ISP_SVC_Sensor_WriteGain(hIsp, pConfig);
+}
+
 /**
   * @brief  ISP_SVC_Sensor_GetGain
   *         Get the sensor gain
@@ -1148,6 +1229,13 @@ ISP_StatusTypeDef ISP_SVC_Sensor_GetGain(ISP_HandleTypeDef *hIsp, ISP_SensorGain
     return ISP_ERR_SENSORGAIN_EINVAL;
   }
 
+  /* Held value */
+  if (hIsp->deferApply != 0)
+  {
+    *pConfig = ISP_SVC_Pending.sensorGain;
+    return ISP_OK;
+  }
+
   if (hIsp->appliHelpers.GetSensorGain != NULL)
   {
     if (hIsp->appliHelpers.GetSensorGain(hIsp->cameraInstance, (int32_t *)&pConfig->gain) != 0)
@@ -1160,13 +1248,13 @@ ISP_StatusTypeDef ISP_SVC_Sensor_GetGain(ISP_HandleTypeDef *hIsp, ISP_SensorGain
 }
 
 /**
-  * @brief  ISP_SVC_Sensor_SetExposure
+  * @brief  ISP_SVC_Sensor_WriteExposure
   *         Set the sensor exposure
   * @param  hIsp: ISP device handle
   * @param  pConfig: Pointer to the sensor exposure configuration
   * @retval operation result
   */
-ISP_StatusTypeDef ISP_SVC_Sensor_SetExposure(ISP_HandleTypeDef *hIsp, ISP_SensorExposureTypeDef *pConfig)
+static ISP_StatusTypeDef ISP_SVC_Sensor_WriteExposure(ISP_HandleTypeDef *hIsp, const ISP_SensorExposureTypeDef *pConfig)
 {
   /* Check handle validity */
   if ((hIsp == NULL) || (pConfig == NULL))
@@ -1187,6 +1275,26 @@ ISP_StatusTypeDef ISP_SVC_Sensor_SetExposure(ISP_HandleTypeDef *hIsp, ISP_Sensor
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SVC_Sensor_SetExposure
+  *         Set the sensor exposure
+  * @param  hIsp: ISP device handle
+  * @param  pConfig: Pointer to the sensor exposure configuration
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_Sensor_SetExposure(ISP_HandleTypeDef *hIsp, ISP_SensorExposureTypeDef *pConfig)
+{
+  /* Held for ISP_SVC_Pending_Apply() */
+  if ((hIsp != NULL) && (pConfig != NULL) && (hIsp->deferApply != 0))
+  {
+    ISP_SVC_Pending.sensorExposure = *pConfig;
+    ISP_SVC_Pending.valid |= ISP_PENDING_SENSOR_EXPOSURE;
+    return ISP_OK;
+  }
+
+  return ISP_SVC_Sensor_WriteExposure(hIsp, pConfig);
+}
+
 /**
   * @brief  ISP_SVC_Sensor_GetExposure
   *         Get the sensor exposure
@@ -1202,6 +1310,13 @@ ISP_StatusTypeDef ISP_SVC_Sensor_GetExposure(ISP_HandleTypeDef *hIsp, ISP_Sensor
     return ISP_ERR_SENSOREXPOSURE_EINVAL;
   }
 
+  /* Held value */
+  if (hIsp->deferApply != 0)
+  {
+    *pConfig = ISP_SVC_Pending.sensorExposure;
+    return ISP_OK;
+  }
+
   if (hIsp->appliHelpers.GetSensorExposure != NULL)
   {
     if (hIsp->appliHelpers.GetSensorExposure(hIsp->cameraInstance, (int32_t *)&pConfig->exposure) != 0)
@@ -1241,6 +1356,136 @@ ISP_StatusTypeDef ISP_SVC_Sensor_SetTestPattern(ISP_HandleTypeDef *hIsp, ISP_Sen
   return ISP_OK;
 }
 
+/**
+  * @brief  ISP_SVC_Pending_SetDeferred
+  *         Hold the sensor gain and exposure, ISP gain and color conversion
+  *         writes for ISP_SVC_Pending_Apply(), or write them again
+  * @param  hIsp: ISP device handle
+  * @param  Enable: 1 to hold the writes, 0 to write them
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_Pending_SetDeferred(ISP_HandleTypeDef *hIsp, uint8_t Enable)
+{
+  ISP_StatusTypeDef ret;
+
+  /* Check handle validity */
+  if (hIsp == NULL)
+  {
+    return ISP_ERR_EINVAL;
+  }
+
+  if ((Enable == 0) || (hIsp->deferApply != 0))
+  {
+    /* Writes held so far stay for ISP_SVC_Pending_Take() */
+    hIsp->deferApply = Enable;
+    return ISP_OK;
+  }
+
+  /* The getters return the held values from now on: start from the current ones */
+  ret = ISP_SVC_Sensor_GetExposure(hIsp, &ISP_SVC_Pending.sensorExposure);
+  if (ret == ISP_OK)
+  {
+    ret = ISP_SVC_Sensor_GetGain(hIsp, &ISP_SVC_Pending.sensorGain);
+  }
+  if (ret == ISP_OK)
+  {
+    ret = ISP_SVC_ISP_GetGain(hIsp, &ISP_SVC_Pending.ispGain);
+  }
+  if (ret == ISP_OK)
+  {
+    ret = ISP_SVC_ISP_GetColorConv(hIsp, &ISP_SVC_Pending.colorConv);
+  }
+  if (ret != ISP_OK)
+  {
+    return ret;
+  }
+
+  ISP_SVC_Pending.valid = 0;
+  hIsp->deferApply = 1;
+
+  return ISP_OK;
+}
+
+/**
+  * @brief  ISP_SVC_Pending_Take
+  *         Move the writes held since the last call into a pending set,
+  *         over those it holds
+  * @param  hIsp: ISP device handle
+  * @param  pPending: Pointer to the pending set, updated
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_Pending_Take(ISP_HandleTypeDef *hIsp, ISP_PendingTypeDef *pPending)
+{
+  uint32_t valid;
+
+  /* Check handle validity */
+  if ((hIsp == NULL) || (pPending == NULL))
+  {
+    return ISP_ERR_EINVAL;
+  }
+
+  valid = ISP_SVC_Pending.valid;
+
+  if ((valid & ISP_PENDING_SENSOR_EXPOSURE) != 0U)
+  {
+    pPending->sensorExposure = ISP_SVC_Pending.sensorExposure;
+  }
+  if ((valid & ISP_PENDING_SENSOR_GAIN) != 0U)
+  {
+    pPending->sensorGain = ISP_SVC_Pending.sensorGain;
+  }
+  if ((valid & ISP_PENDING_ISP_GAIN) != 0U)
+  {
+    pPending->ispGain = ISP_SVC_Pending.ispGain;
+  }
+  if ((valid & ISP_PENDING_COLORCONV) != 0U)
+  {
+    pPending->colorConv = ISP_SVC_Pending.colorConv;
+  }
+  pPending->valid |= valid;
+  ISP_SVC_Pending.valid = 0;
+
+  return ISP_OK;
+}
+
+/**
+  * @brief  ISP_SVC_Pending_Apply
+  *         Write a pending set: the sensor exposure and gain, then the ISP
+  *         gain and color conversion
+  * @param  hIsp: ISP device handle
+  * @param  pPending: Pointer to the pending set
+  * @retval operation result
+  */
+ISP_StatusTypeDef ISP_SVC_Pending_Apply(ISP_HandleTypeDef *hIsp, const ISP_PendingTypeDef *pPending)
+{
+  ISP_StatusTypeDef ret = ISP_OK;
+
+  /* Check handle validity */
+  if ((hIsp == NULL) || (pPending == NULL))
+  {
+    return ISP_ERR_EINVAL;
+  }
+
+  if ((pPending->valid & ISP_PENDING_SENSOR_EXPOSURE) != 0U)
+  {
+    ret = ISP_SVC_Sensor_WriteExposure(hIsp, &pPending->sensorExposure);
+  }
+  if ((ret == ISP_OK) && ((pPending->valid & ISP_PENDING_SENSOR_GAIN) != 0U))
+  {
+    ret = ISP_SVC_Sensor_WriteGain(hIsp, &pPending->sensorGain);
+  }
+  if ((ret == ISP_OK) && ((pPending->valid & ISP_PENDING_ISP_GAIN) != 0U))
+  {
+    ret = ISP_SVC_ISP_WriteGain(hIsp, &pPending->ispGain);
+  }
+  if ((ret == ISP_OK) && ((pPending->valid & ISP_PENDING_COLORCONV) != 0U))
+  {
+    ret = ISP_SVC_ISP_WriteColorConv(hIsp, &pPending->colorConv);
+  }
+
+  return ret;
+}
+
 /**
   * @brief  ISP_SVC_Misc_GetDCMIPPVersion
   *         Get the DCMIPP IP version
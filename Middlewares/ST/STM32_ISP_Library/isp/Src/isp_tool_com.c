@@ -25,6 +25,8 @@
 
 /* Private constants ---------------------------------------------------------*/
 #define RX_PACKET_SIZE 512
+#define ISP_MAX_DUMP_SIZE         4096
+#define ISP_DUMP_DATA_STR         "DUMP DATA"
 
 /* Private types -------------------------------------------------------------*/
 typedef struct {
@@ -36,6 +38,8 @@ ISP_ToolCom_packet_t;
 /* Private function prototypes -----------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 ISP_ToolCom_packet_t received_packet;
+/* A dump queued to the application is being sent: commands wait */
+static volatile uint8_t dump_pending;
 
 /* Private functions ---------------------------------------------------------*/
 /**
@@ -125,7 +129,7 @@ uint32_t ISP_ToolCom_CheckCommandReceived(uint8_t **block_cmd)
 {
   uint32_t payload_size = 0;
 
-  if (received_packet.payload_size > 0)
+  if ((received_packet.payload_size > 0) && (dump_pending == 0))
   {
     *block_cmd = (uint8_t*)received_packet.payload;
     payload_size = received_packet.payload_size;
@@ -134,6 +138,83 @@ uint32_t ISP_ToolCom_CheckCommandReceived(uint8_t **block_cmd)
   return payload_size;
 }
 
+/**
+  * @brief  ISP_ToolCom_QueueDump
+  *         Hand a dump buffer to the application SendDump helper, or send it
+  *         right away without one
+  * @param  hIsp: ISP device handle
+  * @param  buffer: Pointer to the dump buffer
+  * @param  buffer_size: Size of the dump
+  * @retval ISP status
+  */
+ISP_StatusTypeDef ISP_ToolCom_QueueDump(ISP_HandleTypeDef *hIsp, uint8_t *buffer, uint32_t buffer_size)
+{
+  if (hIsp->appliHelpers.SendDump != NULL)
+  {
+    dump_pending = 1;
+    if (hIsp->appliHelpers.SendDump(buffer, buffer_size) == ISP_OK)
+    {
+      return ISP_OK;
+    }
+    dump_pending = 0;
+  }
+
+  ISP_ToolCom_SendDump(buffer, buffer_size);
+  return ISP_OK;
+}
+
+/**
+  * @brief  ISP_ToolCom_SendDump
+  *         Send dump frame data, splitting it in several parts if too large.
+  *         The end of a queued dump lets the next command through.
+  * @param  buffer: Pointer to data to send
+  * @param  buffer_size: Size of data to send
+  * @retval None
+  */
+void ISP_ToolCom_SendDump(uint8_t *buffer, uint32_t buffer_size)
+{
+  uint32_t sizeToSend, remaining = buffer_size;
+  uint8_t first = true;
+  char dump_start_msg[32];
+  char dump_stop_msg[32];
+
+  if (buffer_size > ISP_MAX_DUMP_SIZE) {
+    /* Split the data in several parts */
+    do {
+      if (first)
+      {
+        sprintf(dump_start_msg, "%s[", ISP_DUMP_DATA_STR);
+        sizeToSend = ISP_MAX_DUMP_SIZE;
+        first = false;
+        ISP_ToolCom_SendData(buffer, sizeToSend, dump_start_msg, NULL);
+      }
+      else if (remaining <= ISP_MAX_DUMP_SIZE)
+      {
+        sprintf(dump_stop_msg, "%s]", ISP_DUMP_DATA_STR);
+        sizeToSend = remaining;
+        ISP_ToolCom_SendData(buffer, sizeToSend, NULL, dump_stop_msg);
+      }
+      else
+      {
+        sizeToSend = ISP_MAX_DUMP_SIZE;
+        ISP_ToolCom_SendData(buffer, sizeToSend, NULL, NULL);
+      }
+
+      buffer += sizeToSend;
+      remaining -= sizeToSend;
+    } while (remaining > 0);
+  }
+  else
+  {
+    /* Send all the data in one single part */
+    sprintf(dump_start_msg, "%s[", ISP_DUMP_DATA_STR);
+    sprintf(dump_stop_msg, "%s]", ISP_DUMP_DATA_STR);
+    ISP_ToolCom_SendData(buffer, buffer_size, dump_start_msg, dump_stop_msg);
+  }
+
+  dump_pending = 0;
+}
+
 /**
   * @brief  ISP_ToolCom_PrepareNextCommand
   *         Get prepared to receive a new packet, which more or less consists in releasing
@@ -75,10 +75,21 @@ static union
 
 } camera_bsp;
 
+/* Optional ISP application helpers, set by CMW_CAMERA_SetISPAppliHelpers() */
+static ISP_AppliHelpersTypeDef isp_optional_helpers;
+
+/* Sensor register access, replaced by CMW_CAMERA_SetRegisterIO() */
+static CMW_RegIO_Func cmw_read_reg = CMW_I2C_READREG16;
+static CMW_RegIO_Func cmw_write_reg = CMW_I2C_WRITEREG16;
+
 int is_camera_init = 0;
 int is_camera_started = 0;
 int is_pipe1_2_shared = 0;
 
+/* CSI-2 virtual channel of each pipe, replaced by CMW_CAMERA_SetPipeSource() */
+static uint32_t cmw_pipe_vc[DCMIPP_NUM_OF_PIPES] = {DCMIPP_VIRTUAL_CHANNEL0, DCMIPP_VIRTUAL_CHANNEL0,
+                                                    DCMIPP_VIRTUAL_CHANNEL0};
+
 #if defined(USE_IMX335_SENSOR)
 static int32_t CMW_CAMERA_IMX335_Init( CMW_Sensor_Init_t *initSensors_params);
 #endif
@@ -369,7 +380,7 @@ int32_t CMW_CAMERA_Start(uint32_t pipe, uint8_t *pbuff, uint32_t mode)
     return CMW_ERROR_WRONG_PARAM;
   }
 
-  ret = HAL_DCMIPP_CSI_PIPE_Start(&hcamera_dcmipp, pipe, DCMIPP_VIRTUAL_CHANNEL0, (uint32_t)pbuff, mode);
+  ret = HAL_DCMIPP_CSI_PIPE_Start(&hcamera_dcmipp, pipe, cmw_pipe_vc[pipe], (uint32_t)pbuff, mode);
   if (ret != HAL_OK)
   {
     return CMW_ERROR_PERIPH_FAILURE;
@@ -407,7 +418,7 @@ int32_t CMW_CAMERA_DoubleBufferStart(uint32_t pipe, uint8_t *pbuff1, uint8_t *pb
     return CMW_ERROR_WRONG_PARAM;
   }
 
-  if (HAL_DCMIPP_CSI_PIPE_DoubleBufferStart(&hcamera_dcmipp, pipe, DCMIPP_VIRTUAL_CHANNEL0, (uint32_t)pbuff1,
+  if (HAL_DCMIPP_CSI_PIPE_DoubleBufferStart(&hcamera_dcmipp, pipe, cmw_pipe_vc[pipe], (uint32_t)pbuff1,
                                             (uint32_t)pbuff2, Mode) != HAL_OK)
   {
     return CMW_ERROR_PERIPH_FAILURE;
@@ -454,7 +465,7 @@ int32_t CMW_CAMERA_DeInit(void)
 
   if (HAL_DCMIPP_PIPE_GetState(&hcamera_dcmipp, DCMIPP_PIPE1) != HAL_DCMIPP_PIPE_STATE_RESET)
   {
-    ret = HAL_DCMIPP_CSI_PIPE_Stop(&hcamera_dcmipp, DCMIPP_PIPE1, DCMIPP_VIRTUAL_CHANNEL0);
+    ret = HAL_DCMIPP_CSI_PIPE_Stop(&hcamera_dcmipp, DCMIPP_PIPE1, cmw_pipe_vc[DCMIPP_PIPE1]);
     if (ret != HAL_OK)
     {
       return CMW_ERROR_PERIPH_FAILURE;
@@ -463,7 +474,7 @@ int32_t CMW_CAMERA_DeInit(void)
 
   if (HAL_DCMIPP_PIPE_GetState(&hcamera_dcmipp, DCMIPP_PIPE2) != HAL_DCMIPP_PIPE_STATE_RESET)
   {
-    ret = HAL_DCMIPP_CSI_PIPE_Stop(&hcamera_dcmipp, DCMIPP_PIPE2, DCMIPP_VIRTUAL_CHANNEL0);
+    ret = HAL_DCMIPP_CSI_PIPE_Stop(&hcamera_dcmipp, DCMIPP_PIPE2, cmw_pipe_vc[DCMIPP_PIPE2]);
     if (ret != HAL_OK)
     {
       return CMW_ERROR_PERIPH_FAILURE;
@@ -607,6 +618,27 @@ int CMW_CAMERA_GetExposure(int32_t *exposure)
   return CMW_ERROR_NONE;
 }
 
+/**
+  * @brief  Open or close the sensor register hold group.
+  * @param  hold  1: the gain and exposure set until it is closed take effect
+  *         together, on the same frame; 0: close the group
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SetHold(uint8_t hold)
+{
+  if(Camera_Drv.SetHold == NULL)
+  {
+    return CMW_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+
+  if (Camera_Drv.SetHold(&camera_bsp, hold) != CMW_ERROR_NONE)
+  {
+    return CMW_ERROR_COMPONENT_FAILURE;
+  }
+
+  return CMW_ERROR_NONE;
+}
+
 /**
   * @brief  Set the camera exposure mode.
   * @param  exposureMode Exposure mode CMW_EXPOSUREMODE_AUTO, CMW_EXPOSUREMODE_AUTOFREEZE, CMW_EXPOSUREMODE_MANUAL
@@ -677,6 +709,32 @@ int32_t CMW_CAMERA_GetTestPattern(int32_t *mode)
   return CMW_ERROR_NONE;
 }
 
+/**
+  * @brief  Change the camera sensor frame rate while streaming.
+  * @param  framerate  frame rate in fps, one the sensor supports
+  * @note   The exposure is bounded by the frame length: the sensor clamps
+  *         longer exposures, the ISP keeps the bound read at its start
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SetFramerate(int32_t framerate)
+{
+  int32_t ret;
+
+  if(Camera_Drv.SetFramerate == NULL)
+  {
+    return CMW_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+
+  ret = Camera_Drv.SetFramerate(&camera_bsp, framerate);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return CMW_ERROR_COMPONENT_FAILURE;
+  }
+
+  camera_conf.fps = framerate;
+  return CMW_ERROR_NONE;
+}
+
 /**
   * @brief  Get the Camera Sensor info.
   * @param  info  pointer to sensor info
@@ -703,6 +761,160 @@ int32_t CMW_CAMERA_GetSensorInfo(ISP_SensorInfoTypeDef *info)
   return CMW_ERROR_NONE;
 }
 
+/**
+  * @brief  List the readout modes of the connected camera sensor.
+  * @param  modes  pointer to the modes to fill
+  * @param  nb  in: capacity of modes, out: number of modes
+  * @note   Usable before the init, once CMW_CAMERA_GetSensorName() probed the
+  *         sensor: the width and height of a mode select it in CMW_CAMERA_Init()
+  * @retval Component status
+  */
+int32_t CMW_CAMERA_GetSensorModes(CMW_Sensor_Mode_t *modes, uint32_t *nb)
+{
+  switch (connected_sensor)
+  {
+#if defined(USE_IMX335_SENSOR)
+    case CMW_IMX335_Sensor:
+      return CMW_IMX335_GetModes(modes, nb);
+#endif
+#if defined(USE_VD55G1_SENSOR)
+    case CMW_VD55G1_Sensor:
+      return CMW_VD55G1_GetModes(modes, nb);
+#endif
+#if defined(USE_VD66GY_SENSOR)
+    case CMW_VD66GY_Sensor:
+      return CMW_VD66GY_GetModes(modes, nb);
+#endif
+    default:
+      return CMW_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+}
+
+/**
+  * @brief  Register the optional ISP application helpers.
+  * @param  helpers  StartPreview, StopPreview, DumpFrame and SendDump are used,
+  *         the sensor helpers stay the camera middleware ones
+  * @note   Before CMW_CAMERA_Init(): the ISP copies its helpers when it starts
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SetISPAppliHelpers(const ISP_AppliHelpersTypeDef *helpers)
+{
+  if (helpers == NULL)
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
+  isp_optional_helpers = *helpers;
+  return CMW_ERROR_NONE;
+}
+
+/**
+  * @brief  Route the sensor register accesses through the application.
+  * @param  read_reg  Same contract as CMW_I2C_READREG16
+  * @param  write_reg Same contract as CMW_I2C_WRITEREG16, e.g. queuing the
+  *         writes of a hold group (CMW_CAMERA_SetHold()) for an interrupt
+  *         driven transfer
+  * @note   Before CMW_CAMERA_Init(): the sensor drivers copy them at probe
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SetRegisterIO(CMW_RegIO_Func read_reg, CMW_RegIO_Func write_reg)
+{
+  if ((read_reg == NULL) || (write_reg == NULL))
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
+  cmw_read_reg = read_reg;
+  cmw_write_reg = write_reg;
+  return CMW_ERROR_NONE;
+}
+
+/**
+  * @brief  Feed a pipe from another CSI-2 virtual channel, e.g. a second
+  *         sensor behind a serializer or an aggregator bridge.
+  * @param  pipe      DCMIPP_PIPE0, or DCMIPP_PIPE2 which then stops sharing
+  *                   the Pipe1 input and ISP (call after its
+  *                   CMW_CAMERA_SetPipeConfig())
+  * @param  vc        Virtual channel, other than the sensor's
+  *                   DCMIPP_VIRTUAL_CHANNEL0
+  * @param  data_type CSI-2 data type of the stream (DCMIPP_DT_xxx)
+  * @param  dt_format Word width of the virtual channel (DCMIPP_CSI_DT_BPPx)
+  * @note   After CMW_CAMERA_Init(), with the pipe stopped. The pipe is then
+  *         started, stopped and restarted on that channel
+  * @retval CMW status
+  */
+int32_t CMW_CAMERA_SetPipeSource(uint32_t pipe, uint32_t vc, uint32_t data_type, uint32_t dt_format)
+{
+  DCMIPP_CSI_PIPE_ConfTypeDef csi_pipe_conf = { 0 };
+
+  if ((pipe >= DCMIPP_NUM_OF_PIPES) || (pipe == DCMIPP_PIPE1) ||
+      (vc == DCMIPP_VIRTUAL_CHANNEL0) || (vc > DCMIPP_VIRTUAL_CHANNEL3))
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+  if (hcamera_dcmipp.PipeState[pipe] > HAL_DCMIPP_PIPE_STATE_READY)
+  {
+    return CMW_ERROR_PERIPH_FAILURE;
+  }
+
+  if (pipe == DCMIPP_PIPE2)
+  {
+    if (HAL_DCMIPP_PIPE_CSI_DisableShare(&hcamera_dcmipp, pipe) != HAL_OK)
+    {
+      return CMW_ERROR_PERIPH_FAILURE;
+    }
+  }
+
+  if (HAL_DCMIPP_CSI_SetVCConfig(&hcamera_dcmipp, vc, dt_format) != HAL_OK)
+  {
+    return CMW_ERROR_PERIPH_FAILURE;
+  }
+
+  csi_pipe_conf.DataTypeMode = DCMIPP_DTMODE_DTIDA;
+  csi_pipe_conf.DataTypeIDA = data_type;
+  csi_pipe_conf.DataTypeIDB = 0;
+  if (HAL_DCMIPP_CSI_PIPE_SetConfig(&hcamera_dcmipp, pipe, &csi_pipe_conf) != HAL_OK)
+  {
+    return CMW_ERROR_PERIPH_FAILURE;
+  }
+
+  cmw_pipe_vc[pipe] = vc;
+  return CMW_ERROR_NONE;
+}
+
+/**
+  * @brief  Get the CSI-2 virtual channel a pipe captures from.
+  * @param  pipe DCMIPP Pipe
+  * @retval Virtual channel (DCMIPP_VIRTUAL_CHANNELx)
+  */
+uint32_t CMW_CAMERA_GetPipeVirtualChannel(uint32_t pipe)
+{
+  return (pipe < DCMIPP_NUM_OF_PIPES) ? cmw_pipe_vc[pipe] : DCMIPP_VIRTUAL_CHANNEL0;
+}
+
+/**
+  * @brief  Get the ISP handle of the connected camera sensor.
+  * @note   To tune the ISP beyond the CMW_CAMERA API, from the thread
+  *         calling CMW_CAMERA_Run()
+  * @retval ISP handle, NULL for a sensor without ISP
+  */
+ISP_HandleTypeDef *CMW_CAMERA_GetISPHandle(void)
+{
+  switch (connected_sensor)
+  {
+#if defined(USE_IMX335_SENSOR)
+    case CMW_IMX335_Sensor:
+      return &camera_bsp.imx335_bsp.hIsp;
+#endif
+#if defined(USE_VD66GY_SENSOR)
+    case CMW_VD66GY_Sensor:
+      return &camera_bsp.vd66gy_bsp.hIsp;
+#endif
+    default:
+      return NULL;
+  }
+}
+
 
 
 int32_t CMW_CAMERA_Run()
@@ -738,6 +950,30 @@ __weak int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe)
   return HAL_OK;
 }
 
+/**
+ * @brief  Error callback on pipe (overrun)
+ * @param  Pipe  Pipe receiving the callback
+ * @retval None
+ */
+__weak int CMW_CAMERA_PIPE_ErrorCallback(uint32_t pipe)
+{
+  UNUSED(pipe);
+
+  return HAL_OK;
+}
+
+/**
+ * @brief  Limit Event callback on pipe
+ * @param  Pipe  Pipe receiving the callback
+ * @retval None
+ */
+__weak int CMW_CAMERA_PIPE_LimitEventCallback(uint32_t pipe)
+{
+  UNUSED(pipe);
+
+  return HAL_OK;
+}
+
 /**
  * @brief  Vsync Event callback on pipe
  * @param  hdcmipp DCMIPP device handle
@@ -770,6 +1006,30 @@ void HAL_DCMIPP_PIPE_FrameEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t
   CMW_CAMERA_PIPE_FrameEventCallback(Pipe);
 }
 
+/**
+ * @brief  Error callback on pipe
+ * @param  hdcmipp DCMIPP device handle
+ *         Pipe    Pipe receiving the callback
+ * @retval None
+ */
+void HAL_DCMIPP_PIPE_ErrorCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t Pipe)
+{
+  UNUSED(hdcmipp);
+  CMW_CAMERA_PIPE_ErrorCallback(Pipe);
+}
+
+/**
+ * @brief  Limit Event callback on pipe
+ * @param  hdcmipp DCMIPP device handle
+ *         Pipe    Pipe receiving the callback
+ * @retval None
+ */
+void HAL_DCMIPP_PIPE_LimitEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t Pipe)
+{
+  UNUSED(hdcmipp);
+  CMW_CAMERA_PIPE_LimitEventCallback(Pipe);
+}
+
 /**
   * @brief  Initializes the DCMIPP MSP.
   * @param  hdcmipp  DCMIPP handle
@@ -898,6 +1158,14 @@ static void CMW_CAMERA_EnablePin(int value)
 }
 
 #if defined(USE_VD66GY_SENSOR) || defined(USE_IMX335_SENSOR)
+static void CMW_CAMERA_SetOptionalHelpers(ISP_AppliHelpersTypeDef *helpers)
+{
+  helpers->StartPreview = isp_optional_helpers.StartPreview;
+  helpers->StopPreview = isp_optional_helpers.StopPreview;
+  helpers->DumpFrame = isp_optional_helpers.DumpFrame;
+  helpers->SendDump = isp_optional_helpers.SendDump;
+}
+
 static ISP_StatusTypeDef CB_ISP_SetSensorGain(uint32_t camera_instance, int32_t gain)
 {
   if (CMW_CAMERA_SetGain(gain) != CMW_ERROR_NONE)
@@ -952,8 +1220,8 @@ static int32_t CMW_CAMERA_VD55G1_Init( CMW_Sensor_Init_t *initSensors_params)
   camera_bsp.vd55g1_bsp.Address     = CAMERA_VD55G1_ADDRESS;
   camera_bsp.vd55g1_bsp.Init        = CMW_I2C_INIT;
   camera_bsp.vd55g1_bsp.DeInit      = CMW_I2C_DEINIT;
-  camera_bsp.vd55g1_bsp.WriteReg    = CMW_I2C_WRITEREG16;
-  camera_bsp.vd55g1_bsp.ReadReg     = CMW_I2C_READREG16;
+  camera_bsp.vd55g1_bsp.WriteReg    = cmw_write_reg;
+  camera_bsp.vd55g1_bsp.ReadReg     = cmw_read_reg;
   camera_bsp.vd55g1_bsp.Delay       = HAL_Delay;
   camera_bsp.vd55g1_bsp.ShutdownPin = CMW_CAMERA_ShutdownPin;
   camera_bsp.vd55g1_bsp.EnablePin   = CMW_CAMERA_EnablePin;
@@ -1028,8 +1296,8 @@ static int32_t CMW_CAMERA_VD66GY_Init( CMW_Sensor_Init_t *initSensors_params)
   camera_bsp.vd66gy_bsp.Address     = CAMERA_VD66GY_ADDRESS;
   camera_bsp.vd66gy_bsp.Init        = CMW_I2C_INIT;
   camera_bsp.vd66gy_bsp.DeInit      = CMW_I2C_DEINIT;
-  camera_bsp.vd66gy_bsp.ReadReg     = CMW_I2C_READREG16;
-  camera_bsp.vd66gy_bsp.WriteReg    = CMW_I2C_WRITEREG16;
+  camera_bsp.vd66gy_bsp.ReadReg     = cmw_read_reg;
+  camera_bsp.vd66gy_bsp.WriteReg    = cmw_write_reg;
   camera_bsp.vd66gy_bsp.Delay       = HAL_Delay;
   camera_bsp.vd66gy_bsp.ShutdownPin = CMW_CAMERA_ShutdownPin;
   camera_bsp.vd66gy_bsp.EnablePin   = CMW_CAMERA_EnablePin;
@@ -1039,6 +1307,7 @@ static int32_t CMW_CAMERA_VD66GY_Init( CMW_Sensor_Init_t *initSensors_params)
   camera_bsp.vd66gy_bsp.appliHelpers.SetSensorExposure = CB_ISP_SetSensorExposure;
   camera_bsp.vd66gy_bsp.appliHelpers.GetSensorExposure = CB_ISP_GetSensorExposure;
   camera_bsp.vd66gy_bsp.appliHelpers.GetSensorInfo = CB_ISP_GetSensorInfo;
+  CMW_CAMERA_SetOptionalHelpers(&camera_bsp.vd66gy_bsp.appliHelpers);
 
   ret = CMW_VD66GY_Probe(&camera_bsp.vd66gy_bsp, &Camera_Drv);
   if (ret != CMW_ERROR_NONE)
@@ -1110,8 +1379,8 @@ static int32_t CMW_CAMERA_IMX335_Init(CMW_Sensor_Init_t *initSensors_params)
   camera_bsp.imx335_bsp.Address     = CAMERA_IMX335_ADDRESS;
   camera_bsp.imx335_bsp.Init        = CMW_I2C_INIT;
   camera_bsp.imx335_bsp.DeInit      = CMW_I2C_DEINIT;
-  camera_bsp.imx335_bsp.ReadReg     = CMW_I2C_READREG16;
-  camera_bsp.imx335_bsp.WriteReg    = CMW_I2C_WRITEREG16;
+  camera_bsp.imx335_bsp.ReadReg     = cmw_read_reg;
+  camera_bsp.imx335_bsp.WriteReg    = cmw_write_reg;
   camera_bsp.imx335_bsp.GetTick     = BSP_GetTick;
   camera_bsp.imx335_bsp.Delay       = HAL_Delay;
   camera_bsp.imx335_bsp.ShutdownPin = CMW_CAMERA_ShutdownPin;
@@ -1122,6 +1391,7 @@ static int32_t CMW_CAMERA_IMX335_Init(CMW_Sensor_Init_t *initSensors_params)
   camera_bsp.imx335_bsp.appliHelpers.SetSensorExposure = CB_ISP_SetSensorExposure;
   camera_bsp.imx335_bsp.appliHelpers.GetSensorExposure = CB_ISP_GetSensorExposure;
   camera_bsp.imx335_bsp.appliHelpers.GetSensorInfo = CB_ISP_GetSensorInfo;
+  CMW_CAMERA_SetOptionalHelpers(&camera_bsp.imx335_bsp.appliHelpers);
 
   ret = CMW_IMX335_Probe(&camera_bsp.imx335_bsp, &Camera_Drv);
   if (ret != CMW_ERROR_NONE)
@@ -1203,6 +1473,12 @@ static int32_t CMW_CAMERA_SetPipe(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pipe,
   DCMIPP_CropConfTypeDef crop_conf = { 0 };
   int ret;
 
+  if ((p_conf->output_pitch % 16) != 0 ||
+      (p_conf->output_pitch != 0 && p_conf->output_pitch < p_conf->output_width * p_conf->output_bpp))
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
   /* specific case for pipe0 which is only a dump pipe */
   if (pipe == DCMIPP_PIPE0)
   {
@@ -1335,6 +1611,10 @@ static int32_t CMW_CAMERA_SetPipe(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pipe,
   pipe_conf.PixelPipePitch = p_conf->output_width * p_conf->output_bpp;
   /* Hardware constraint, pitch must be multiple of 16 */
   pipe_conf.PixelPipePitch = (pipe_conf.PixelPipePitch + 15) & (uint32_t) ~15;
+  if (p_conf->output_pitch != 0)
+  {
+    pipe_conf.PixelPipePitch = p_conf->output_pitch;
+  }
   pipe_conf.PixelPackerFormat = p_conf->output_format;
   if (hcamera_dcmipp.PipeState[pipe] == HAL_DCMIPP_PIPE_STATE_RESET)
   {
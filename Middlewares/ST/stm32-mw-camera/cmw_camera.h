@@ -110,6 +110,9 @@ typedef struct {
   int output_bpp;
   int enable_swap;
   int enable_gamma_conversion;
+  /* Bytes per output line, padding included: a multiple of 16 of at least
+   * output_width * output_bpp, or 0 for the packed line rounded up to 16 */
+  uint32_t output_pitch;
   /*Output buffer of the pipe*/
   int mode;
   /* You must fill manual_conf when mode is CMW_Aspect_ratio_manual_roi */
@@ -126,6 +129,9 @@ typedef struct {
 #define CMW_EXPOSUREMODE_AUTOFREEZE    0x01U   /* Stop the camera auto exposure functionnality and freeze the current value */
 #define CMW_EXPOSUREMODE_MANUAL        0x02U   /* Set the camera in manual exposure (exposure is control by a software algorithm) */
 
+/* Sensor register access: device address, register, data, length */
+typedef int32_t (*CMW_RegIO_Func)(uint16_t, uint16_t, uint8_t *, uint16_t);
+
 DCMIPP_HandleTypeDef* CMW_CAMERA_GetDCMIPPHandle();
 
 /**
@@ -178,12 +184,23 @@ int32_t CMW_CAMERA_GetExposureMode(int32_t *exposureMode);
 int32_t CMW_CAMERA_SetTestPattern(int32_t mode);
 int32_t CMW_CAMERA_GetTestPattern(int32_t *mode);
 
+int32_t CMW_CAMERA_SetFramerate(int32_t framerate);
+
 int32_t CMW_CAMERA_GetSensorInfo(ISP_SensorInfoTypeDef *info);
+int32_t CMW_CAMERA_GetSensorModes(CMW_Sensor_Mode_t *modes, uint32_t *nb);
+int32_t CMW_CAMERA_SetISPAppliHelpers(const ISP_AppliHelpersTypeDef *helpers);
+int32_t CMW_CAMERA_SetRegisterIO(CMW_RegIO_Func read_reg, CMW_RegIO_Func write_reg);
+int32_t CMW_CAMERA_SetHold(uint8_t hold);
+int32_t CMW_CAMERA_SetPipeSource(uint32_t pipe, uint32_t vc, uint32_t data_type, uint32_t dt_format);
+uint32_t CMW_CAMERA_GetPipeVirtualChannel(uint32_t pipe);
+ISP_HandleTypeDef *CMW_CAMERA_GetISPHandle(void);
 
 HAL_StatusTypeDef MX_DCMIPP_ClockConfig(DCMIPP_HandleTypeDef *hdcmipp);
 
 int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe);
 int CMW_CAMERA_PIPE_VsyncEventCallback(uint32_t pipe);
+int CMW_CAMERA_PIPE_ErrorCallback(uint32_t pipe);
+int CMW_CAMERA_PIPE_LimitEventCallback(uint32_t pipe);
 
 #ifdef __cplusplus
 }
@@ -33,15 +33,48 @@
 
 static int CMW_IMX335_GetResType(uint32_t width, uint32_t height, uint32_t*res)
 {
-  if (width == 2592 && height == 1944)
+  uint32_t nb;
+  const IMX335_Mode_t *modes = IMX335_GetModes(&nb);
+
+  for (uint32_t i = 0; i < nb; i++)
   {
-    *res = IMX335_R2592_1944;
+    if (width == modes[i].Width && height == modes[i].Height)
+    {
+      *res = modes[i].Resolution;
+      return 0;
+    }
   }
-  else
+  return CMW_ERROR_WRONG_PARAM;
+}
+
+/**
+  * @brief  List the sensor readout modes
+  * @param  modes  modes to fill, largest first
+  * @param  nb  in: capacity of modes, out: number of modes
+  * @retval Component status
+  */
+int32_t CMW_IMX335_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb)
+{
+  uint32_t count;
+  const IMX335_Mode_t *imx335_modes = IMX335_GetModes(&count);
+
+  if ((modes == NULL) || (nb == NULL) || (*nb < count))
   {
     return CMW_ERROR_WRONG_PARAM;
   }
-  return 0;
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    /* Windows are read out pixel for pixel */
+    modes[i].width = imx335_modes[i].Width;
+    modes[i].height = imx335_modes[i].Height;
+    modes[i].fov_width = imx335_modes[i].Width;
+    modes[i].fov_height = imx335_modes[i].Height;
+    modes[i].max_fps = imx335_modes[i].MaxFps;
+  }
+  *nb = count;
+
+  return CMW_ERROR_NONE;
 }
 
 static int32_t CMW_IMX335_getMirrorFlipConfig(uint32_t Config)
@@ -100,6 +133,11 @@ static int32_t CMW_IMX335_SetExposure(void *io_ctx, int32_t exposure)
   return IMX335_SetExposure(&((CMW_IMX335_t *)io_ctx)->ctx_driver, exposure);
 }
 
+static int32_t CMW_IMX335_SetHold(void *io_ctx, uint8_t hold)
+{
+  return IMX335_SetHold(&((CMW_IMX335_t *)io_ctx)->ctx_driver, hold);
+}
+
 /**
   * @brief  Set the sensor white balance mode
   * @param  io_ctx  pointer to component object
@@ -146,7 +184,7 @@ static int32_t CMW_IMX335_SetFrequency(void *io_ctx, int32_t frequency)
 
 static int32_t CMW_IMX335_SetFramerate(void *io_ctx, int32_t framerate)
 {
-  const int32_t available_imx335_fps[] = {10, 15, 20, 25, 30};
+  const int32_t available_imx335_fps[] = {10, 15, 20, 25, 30, 50, 60};
 
   for (int i = 0; i < ARRAY_SIZE(available_imx335_fps); i++)
     if (framerate == available_imx335_fps[i])
@@ -179,12 +217,24 @@ static int32_t CMW_IMX335_GetSensorInfo(void *io_ctx, ISP_SensorInfoTypeDef *inf
 
   info->bayer_pattern = IMX335_BAYER_PATTERN;
   info->color_depth = IMX335_COLOR_DEPTH;
-  info->width = IMX335_WIDTH;
-  info->height = IMX335_HEIGHT;
+  /* Full array until a mode is set */
+  const IMX335_Mode_t *mode = IMX335_GetMode(((CMW_IMX335_t *)io_ctx)->ctx_driver.Resolution);
+  info->width = mode ? mode->Width : IMX335_WIDTH;
+  info->height = mode ? mode->Height : IMX335_HEIGHT;
   info->gain_min = IMX335_GAIN_MIN;
   info->gain_max = IMX335_GAIN_MAX;
   info->exposure_min = IMX335_EXPOSURE_MIN;
+  /* The frame length bounds the exposure: 30fps until the sensor is up */
   info->exposure_max = IMX335_EXPOSURE_MAX;
+  if (((CMW_IMX335_t *)io_ctx)->ctx_driver.IsInitialized)
+  {
+    int32_t exposure_max;
+    if (IMX335_GetExposureMax(&((CMW_IMX335_t *)io_ctx)->ctx_driver, &exposure_max) != IMX335_OK)
+    {
+      return CMW_ERROR_COMPONENT_FAILURE;
+    }
+    info->exposure_max = (uint32_t) exposure_max;
+  }
 
   return CMW_ERROR_NONE;
 }
@@ -234,6 +284,25 @@ static int32_t CMW_IMX335_Start(void *io_ctx)
     return CMW_ERROR_COMPONENT_FAILURE;
   }
 
+  /* The tuning file area is set on the full array: same share of a window */
+  const IMX335_Mode_t *mode = IMX335_GetMode(((CMW_IMX335_t *)io_ctx)->ctx_driver.Resolution);
+  if ((mode != NULL) && (mode->Resolution != IMX335_R2592_1944))
+  {
+    const ISP_StatAreaTypeDef *full = &ISP_IQParamCacheInit_IMX335.statAreaStatic;
+    ISP_StatAreaTypeDef area = {
+      .X0 = full->X0 * mode->Width / IMX335_WIDTH,
+      .Y0 = full->Y0 * mode->Height / IMX335_HEIGHT,
+      .XSize = full->XSize * mode->Width / IMX335_WIDTH,
+      .YSize = full->YSize * mode->Height / IMX335_HEIGHT,
+    };
+
+    ret = ISP_SetStatArea(&((CMW_IMX335_t *)io_ctx)->hIsp, &area);
+    if (ret != ISP_OK)
+    {
+      return CMW_ERROR_COMPONENT_FAILURE;
+    }
+  }
+
   ret = ISP_Start(&((CMW_IMX335_t *)io_ctx)->hIsp);
   if (ret != ISP_OK)
   {
@@ -338,5 +407,6 @@ int CMW_IMX335_Probe(CMW_IMX335_t *io_ctx, CMW_Sensor_if_t *imx335_if)
   imx335_if->SetMirrorFlip = CMW_IMX335_SetMirrorFlip;
   imx335_if->GetSensorInfo = CMW_IMX335_GetSensorInfo;
   imx335_if->SetTestPattern = CMW_IMX335_SetTestPattern;
+  imx335_if->SetHold = CMW_IMX335_SetHold;
   return ret;
 }
@@ -48,6 +48,7 @@ typedef struct
 } CMW_IMX335_t;
 
 int CMW_IMX335_Probe(CMW_IMX335_t *io_ctx, CMW_Sensor_if_t *vd55g1_if);
+int32_t CMW_IMX335_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb);
 
 #ifdef __cplusplus
 }
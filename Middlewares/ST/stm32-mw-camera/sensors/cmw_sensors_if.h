@@ -38,6 +38,16 @@ typedef struct
   void *sensor_config; /* to pass specific config from application side*/
 } CMW_Sensor_Init_t;
 
+/* Sensor readout mode */
+typedef struct
+{
+  uint32_t width;
+  uint32_t height;
+  uint32_t fov_width;  /* Pixel array area read out, in sensor pixels */
+  uint32_t fov_height;
+  int max_fps;
+} CMW_Sensor_Mode_t;
+
 typedef struct
 {
   int32_t (*Init)(void *, CMW_Sensor_Init_t *);
@@ -66,6 +76,7 @@ typedef struct
   int32_t (*SetFlickerMode)(void *, int32_t);
   int32_t (*GetSensorInfo)(void *, ISP_SensorInfoTypeDef *);
   int32_t (*SetTestPattern)(void *, int32_t);
+  int32_t (*SetHold)(void *, uint8_t);
 } CMW_Sensor_if_t;
 
 #ifdef __cplusplus
@@ -190,6 +190,36 @@ static int32_t CMW_VD55G1_GetSensorInfo(void *io_ctx, ISP_SensorInfoTypeDef *inf
   return CMW_ERROR_NONE;
 }
 
+/* Resolutions of CMW_VD55G1_GetResType(): crops, QVGA a 2x2 binned VGA crop.
+ * The driver stretches the frame length to the rows read out */
+static const CMW_Sensor_Mode_t vd55g1_modes[] = {
+  {VD55G1_MAX_WIDTH, VD55G1_MAX_HEIGHT, VD55G1_MAX_WIDTH, VD55G1_MAX_HEIGHT, VD55G1_MAX_FPS},
+  {800, 600, 800, 600, VD55G1_MAX_FPS},
+  {640, 480, 640, 480, VD55G1_MAX_FPS},
+  {320, 240, 640, 480, VD55G1_MAX_FPS},
+};
+
+/**
+  * @brief  List the readout modes
+  * @param  modes  pointer to the modes to fill
+  * @param  nb  in: capacity of modes, out: number of modes
+  * @retval Component status
+  */
+int32_t CMW_VD55G1_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb)
+{
+  const uint32_t count = sizeof(vd55g1_modes) / sizeof(vd55g1_modes[0]);
+
+  if ((modes == NULL) || (nb == NULL) || (*nb < count))
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
+  memcpy(modes, vd55g1_modes, sizeof(vd55g1_modes));
+  *nb = count;
+
+  return CMW_ERROR_NONE;
+}
+
 static int CMW_VD55G1_GetResType(uint32_t width, uint32_t height, VD55G1_Res_t *res)
 {
   if (width == 320 && height == 240)
@@ -44,6 +44,7 @@ typedef struct
 } CMW_VD55G1_t;
 
 int CMW_VD55G1_Probe(CMW_VD55G1_t *io_ctx, CMW_Sensor_if_t *vd55g1_if);
+int32_t CMW_VD55G1_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb);
 void CMW_VD55G1_SetDefaultSensorValues(CMW_VD55G1_config_t *vd55g1_config);
 
 
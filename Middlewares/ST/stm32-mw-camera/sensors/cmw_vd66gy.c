@@ -176,6 +176,36 @@ static void VD6G_Log(struct VD6G_Ctx *ctx, int lvl, const char *format, va_list
 #endif
 }
 
+/* Resolutions of CMW_VD66GY_GetResType(): crops, QVGA a 2x2 binned VGA crop */
+static const CMW_Sensor_Mode_t vd66gy_modes[] = {
+  {VD6G_MAX_WIDTH, VD6G_MAX_HEIGHT, VD6G_MAX_WIDTH, VD6G_MAX_HEIGHT, VD6G_MAX_FPS},
+  {VD6G_MAX_WIDTH, 720, VD6G_MAX_WIDTH, 720, VD6G_MAX_FPS},
+  {1024, 768, 1024, 768, VD6G_MAX_FPS},
+  {640, 480, 640, 480, VD6G_MAX_FPS},
+  {320, 240, 640, 480, VD6G_MAX_FPS},
+};
+
+/**
+  * @brief  List the readout modes
+  * @param  modes  pointer to the modes to fill
+  * @param  nb  in: capacity of modes, out: number of modes
+  * @retval Component status
+  */
+int32_t CMW_VD66GY_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb)
+{
+  const uint32_t count = sizeof(vd66gy_modes) / sizeof(vd66gy_modes[0]);
+
+  if ((modes == NULL) || (nb == NULL) || (*nb < count))
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
+  memcpy(modes, vd66gy_modes, sizeof(vd66gy_modes));
+  *nb = count;
+
+  return CMW_ERROR_NONE;
+}
+
 static int CMW_VD66GY_GetResType(uint32_t width, uint32_t height, VD6G_Res_t *res)
 {
   if (width == 320 && height == 240)
@@ -52,6 +52,7 @@ typedef struct
 } CMW_VD66GY_t;
 
 int CMW_VD66GY_Probe(CMW_VD66GY_t *io_ctx, CMW_Sensor_if_t *vd6g_if);
+int32_t CMW_VD66GY_GetModes(CMW_Sensor_Mode_t *modes, uint32_t *nb);
 void CMW_VD66GY_SetDefaultSensorValues(CMW_VD66GY_config_t *vd66gy_config);
 
 #ifdef __cplusplus
@@ -217,6 +217,16 @@ static const struct regval framerate_30fps_regs[] = {
   {0x3031, 0x11},
 };
 
+static const struct regval framerate_50fps_regs[] = {
+  {0x3030, 0x8C},
+  {0x3031, 0x0A},
+};
+
+static const struct regval framerate_60fps_regs[] = {
+  {0x3030, 0xCA},
+  {0x3031, 0x08},
+};
+
 static const struct regval mirrorflip_mode_regs[][10] = {
   {
     {AREA3_ST_ADR_1_LSB, 0xc8}, //AREA3_ST_ADR_1 LSB
@@ -288,6 +298,17 @@ static const struct regval test_pattern_disable_regs[] = {
   {0x336c, 0x01},
 };
 
+/* Readout modes: windows are centered, so mirror and flip keep them in
+ * place, with even origins to keep the RGGB phase. Line timing is shared:
+ * fewer pixels per frame, same frame rates. Frame rates only change VMAX,
+ * 2250 lines at 60fps still cover the 1944 of the all-pixel readout */
+static const IMX335_Mode_t imx335_modes[] = {
+  {IMX335_R2592_1944, 2592, 1944,   0,   0, 60},
+  {IMX335_R1920_1440, 1920, 1440, 336, 252, 60},
+  {IMX335_R1296_972,  1296,  972, 648, 486, 60},
+  {IMX335_R648_486,    648,  486, 972, 728, 60},
+};
+
 #define IMX335_1H_PERIOD_USEC (1000000.0F / 4500 / 30)
 
 /**
@@ -301,6 +322,7 @@ static int32_t IMX335_WriteTable(IMX335_Object_t *pObj, const struct regval *reg
 static int32_t IMX335_ReadRegWrap(void *handle, uint16_t Reg, uint8_t* Data, uint16_t Length);
 static int32_t IMX335_WriteRegWrap(void *handle, uint16_t Reg, uint8_t* Data, uint16_t Length);
 static int32_t IMX335_Delay(IMX335_Object_t *pObj, uint32_t Delay);
+static int32_t IMX335_WriteWindow(IMX335_Object_t *pObj);
 
 /**
   * @}
@@ -328,6 +350,53 @@ static int32_t IMX335_WriteTable(IMX335_Object_t *pObj, const struct regval *reg
   return ret;
 }
 
+/**
+  * @brief  Program the crop window of a windowed mode
+  * @param  pObj  pointer to component object
+  * @retval Component status
+  * @note   Vertical reverse reads the lines bottom up: AREA3 then starts
+  *         from the last line of the window
+  */
+static int32_t IMX335_WriteWindow(IMX335_Object_t *pObj)
+{
+  const IMX335_Mode_t *mode = IMX335_GetMode(pObj->Resolution);
+  uint8_t vreverse;
+  uint16_t value;
+
+  if ((mode == NULL) || (imx335_read_reg(&pObj->Ctx, IMX335_REG_VREVERSE, &vreverse, 1) != IMX335_OK))
+  {
+    return IMX335_ERROR;
+  }
+
+  value = IMX335_HTRIMMING_START_ALL + mode->X0;
+  if (imx335_write_reg(&pObj->Ctx, IMX335_REG_HTRIMMING_START, (uint8_t *)&value, 2) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+  value = mode->Width;
+  if (imx335_write_reg(&pObj->Ctx, IMX335_REG_HNUM, (uint8_t *)&value, 2) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+  value = mode->Height;
+  if (imx335_write_reg(&pObj->Ctx, IMX335_REG_Y_OUT_SIZE, (uint8_t *)&value, 2) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+  value = 2U * mode->Height;
+  if (imx335_write_reg(&pObj->Ctx, IMX335_REG_AREA3_WIDTH_1, (uint8_t *)&value, 2) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+  value = IMX335_AREA3_ST_ADR_1_ALL + 2U * (vreverse ? mode->Y0 + mode->Height : mode->Y0);
+  if (imx335_write_reg(&pObj->Ctx, AREA3_ST_ADR_1_LSB, (uint8_t *)&value, 2) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+
+  return IMX335_OK;
+}
+
 /**
   * @brief This function provides accurate delay (in milliseconds)
   * @param pObj   pointer to component object
@@ -433,6 +502,8 @@ int32_t IMX335_Init(IMX335_Object_t *pObj, uint32_t Resolution, uint32_t PixelFo
 
   if(pObj->IsInitialized == 0U)
   {
+    pObj->Resolution = Resolution;
+    pObj->Vmax = 0;
     switch (Resolution)
     {
       case IMX335_R2592_1944:
@@ -441,6 +512,19 @@ int32_t IMX335_Init(IMX335_Object_t *pObj, uint32_t Resolution, uint32_t PixelFo
           ret = IMX335_ERROR;
         }
         break;
+      case IMX335_R1920_1440:
+      case IMX335_R1296_972:
+      case IMX335_R648_486:
+        /* All-pixel setup, then a smaller window */
+        if(IMX335_WriteTable(pObj, res_2592_1944_regs, ARRAY_SIZE(res_2592_1944_regs)) != IMX335_OK)
+        {
+          ret = IMX335_ERROR;
+        }
+        else if(IMX335_WriteWindow(pObj) != IMX335_OK)
+        {
+          ret = IMX335_ERROR;
+        }
+        break;
       /* Add new resolution here */
       default:
         /* Resolution not supported */
@@ -587,8 +671,9 @@ int32_t IMX335_SetGain(IMX335_Object_t *pObj, int32_t gain)
     /* Convert to IMX335 gain unit (0.3 dB = 300 mdB) */
     gain /= IMX335_GAIN_UNIT_MDB;
 
+    /* Within an open hold group the group latches it */
     hold = 1;
-    if(imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK)
+    if((pObj->Hold == 0U) && (imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK))
     {
       ret = IMX335_ERROR;
     }
@@ -601,7 +686,7 @@ int32_t IMX335_SetGain(IMX335_Object_t *pObj, int32_t gain)
       else
       {
         hold = 0;
-        if(imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK)
+        if((pObj->Hold == 0U) && (imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK))
         {
           ret = IMX335_ERROR;
         }
@@ -621,43 +706,46 @@ return ret;
 int32_t IMX335_SetExposure(IMX335_Object_t *pObj, int32_t exposure)
 {
   int32_t ret = IMX335_OK;
-  uint32_t vmax, shutter;
+  uint32_t vmax = 0, shutter;
   uint8_t hold;
 
+  /* VMAX only changes with the frame rate: read once per rate */
+  if ((pObj->Vmax == 0U) && (imx335_read_reg(&pObj->Ctx, IMX335_REG_VMAX, (uint8_t *)&vmax, 4) == IMX335_OK))
+  {
+    pObj->Vmax = vmax;
+  }
 
-  if (imx335_read_reg(&pObj->Ctx, IMX335_REG_VMAX, (uint8_t *)&vmax, 4) != IMX335_OK)
+  if (pObj->Vmax == 0U)
   {
     ret = IMX335_ERROR;
   }
   else
   {
-    shutter = (uint32_t) (vmax - (exposure / IMX335_1H_PERIOD_USEC));
+    uint32_t lines = (uint32_t) (exposure / IMX335_1H_PERIOD_USEC);
+
+    /* Longer than the frame at this rate: the longest exposure it allows */
+    vmax = pObj->Vmax;
+    shutter = (lines + IMX335_SHUTTER_MIN <= vmax) ? vmax - lines : IMX335_SHUTTER_MIN;
 
-    if (shutter < IMX335_SHUTTER_MIN)
+    /* Within an open hold group the group latches it */
+    hold = 1;
+    if((pObj->Hold == 0U) && (imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK))
     {
       ret = IMX335_ERROR;
     }
     else
     {
-      hold = 1;
-      if(imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK)
+      if(imx335_write_reg(&pObj->Ctx, IMX335_REG_SHUTTER, (uint8_t *)&shutter, 3) != IMX335_OK)
       {
         ret = IMX335_ERROR;
       }
       else
       {
-        if(imx335_write_reg(&pObj->Ctx, IMX335_REG_SHUTTER, (uint8_t *)&shutter, 3) != IMX335_OK)
+        hold = 0;
+        if((pObj->Hold == 0U) && (imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK))
         {
           ret = IMX335_ERROR;
         }
-        else
-        {
-          hold = 0;
-          if(imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK)
-          {
-            ret = IMX335_ERROR;
-          }
-        }
       }
     }
   }
@@ -665,6 +753,30 @@ int32_t IMX335_SetExposure(IMX335_Object_t *pObj, int32_t exposure)
   return ret;
 }
 
+/**
+  * @brief  Open or close a register hold group: the gain and exposure
+  *         written in between take effect together, on the same frame
+  * @param  pObj  pointer to component object
+  * @param  hold  1 to open the group, 0 to close it
+  * @retval Component status
+  */
+int32_t IMX335_SetHold(IMX335_Object_t *pObj, uint8_t hold)
+{
+  hold = (hold != 0U) ? 1U : 0U;
+  if (hold == pObj->Hold)
+  {
+    return IMX335_OK;
+  }
+
+  if(imx335_write_reg(&pObj->Ctx, IMX335_REG_HOLD, &hold, 1) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+
+  pObj->Hold = hold;
+  return IMX335_OK;
+}
+
 /**
   * @brief  Set the Frequency
   * @param  pObj  pointer to component object
@@ -716,12 +828,15 @@ int32_t IMX335_SetFrequency(IMX335_Object_t *pObj, int32_t frequency)
 /**
   * @brief  Set the Framerate
   * @param  pObj  pointer to component object
-  * @param  framerate 10, 15, 20, 25 or 30fps
+  * @param  framerate 10, 15, 20, 25, 30, 50 or 60fps
   * @retval Component status
   */
 int32_t IMX335_SetFramerate(IMX335_Object_t *pObj, int32_t framerate)
 {
   uint32_t ret = IMX335_OK;
+
+  /* New VMAX: the next exposure reads it */
+  pObj->Vmax = 0;
   switch (framerate)
   {
     case 10:
@@ -748,6 +863,18 @@ int32_t IMX335_SetFramerate(IMX335_Object_t *pObj, int32_t framerate)
         ret = IMX335_ERROR;
       }
       break;
+    case 50:
+      if(IMX335_WriteTable(pObj, framerate_50fps_regs, ARRAY_SIZE(framerate_50fps_regs)) != IMX335_OK)
+      {
+        ret = IMX335_ERROR;
+      }
+      break;
+    case 60:
+      if(IMX335_WriteTable(pObj, framerate_60fps_regs, ARRAY_SIZE(framerate_60fps_regs)) != IMX335_OK)
+      {
+        ret = IMX335_ERROR;
+      }
+      break;
     default:
       /* 30fps */
       if(IMX335_WriteTable(pObj, framerate_30fps_regs, ARRAY_SIZE(framerate_30fps_regs)) != IMX335_OK)
@@ -786,9 +913,62 @@ int32_t IMX335_MirrorFlipConfig(IMX335_Object_t *pObj, uint32_t Config)
       ret = IMX335_WriteTable(pObj, mirrorflip_mode_regs[0], ARRAY_SIZE(mirrorflip_mode_regs[0]));
       break;
   }
+
+  /* The tables hold the all-pixel AREA3 start */
+  if ((ret == IMX335_OK) && (pObj->IsInitialized == 1U) && (pObj->Resolution != IMX335_R2592_1944))
+  {
+    ret = IMX335_WriteWindow(pObj);
+  }
   return ret;
 }
 
+/**
+  * @brief  Get the longest exposure the current frame rate allows
+  * @param  pObj  pointer to component object
+  * @param  exposure  exposure in micro seconds
+  * @retval Component status
+  */
+int32_t IMX335_GetExposureMax(IMX335_Object_t *pObj, int32_t *exposure)
+{
+  uint32_t vmax = 0;
+
+  if (imx335_read_reg(&pObj->Ctx, IMX335_REG_VMAX, (uint8_t *)&vmax, 3) != IMX335_OK)
+  {
+    return IMX335_ERROR;
+  }
+
+  *exposure = (int32_t) ((vmax - IMX335_SHUTTER_MIN) * IMX335_1H_PERIOD_USEC);
+  return IMX335_OK;
+}
+
+/**
+  * @brief  List the readout modes
+  * @param  Count  number of modes
+  * @retval Modes, largest first
+  */
+const IMX335_Mode_t *IMX335_GetModes(uint32_t *Count)
+{
+  *Count = ARRAY_SIZE(imx335_modes);
+  return imx335_modes;
+}
+
+/**
+  * @brief  Get a readout mode
+  * @param  Resolution  Camera resolution
+  * @retval Mode, NULL if not supported
+  */
+const IMX335_Mode_t *IMX335_GetMode(uint32_t Resolution)
+{
+  for (uint32_t i = 0; i < ARRAY_SIZE(imx335_modes); i++)
+  {
+    if (imx335_modes[i].Resolution == Resolution)
+    {
+      return &imx335_modes[i];
+    }
+  }
+  return NULL;
+}
+
 /**
   * @brief  Set the Test Pattern Generator
   * @param  pObj  pointer to component object
@@ -66,8 +66,21 @@ typedef struct
   IMX335_IO_t         IO;
   imx335_ctx_t        Ctx;
   uint8_t             IsInitialized;
+  uint32_t            Resolution;
+  uint8_t             Hold;         /* Register hold group open (IMX335_SetHold) */
+  uint32_t            Vmax;         /* Frame length the exposure is set from, 0 to read it */
 } IMX335_Object_t;
 
+typedef struct
+{
+  uint32_t Resolution;
+  uint16_t Width;       /* Output pixels */
+  uint16_t Height;      /* Output lines */
+  uint16_t X0;          /* Window origin in the 2592x1944 all-pixel area */
+  uint16_t Y0;
+  int32_t  MaxFps;
+} IMX335_Mode_t;
+
 typedef struct
 {
   uint32_t Config_Resolution;
@@ -101,6 +114,9 @@ typedef struct
  */
 /* Camera resolutions */
 #define IMX335_R2592_1944                6U	/* 2592x1944 Resolution       */
+#define IMX335_R1920_1440                7U	/* 1920x1440 centered window  */
+#define IMX335_R1296_972                 8U	/* 1296x972 centered window   */
+#define IMX335_R648_486                  9U	/* 648x486 centered window    */
 
 /* Camera Pixel Format */
 #define IMX335_RAW_RGGB10               10U    /* Pixel Format RAW_RGGB10    */
@@ -133,10 +149,14 @@ int32_t IMX335_ReadID(IMX335_Object_t *pObj, uint32_t *Id);
 int32_t IMX335_GetCapabilities(IMX335_Object_t *pObj, IMX335_Capabilities_t *Capabilities);
 int32_t IMX335_SetGain(IMX335_Object_t *pObj, int32_t gain);
 int32_t IMX335_SetExposure(IMX335_Object_t *pObj, int32_t exposure);
+int32_t IMX335_SetHold(IMX335_Object_t *pObj, uint8_t hold);
 int32_t IMX335_SetFrequency(IMX335_Object_t *pObj, int32_t frequency);
 int32_t IMX335_SetFramerate(IMX335_Object_t *pObj, int32_t framerate);
 int32_t IMX335_MirrorFlipConfig(IMX335_Object_t *pObj, uint32_t Config);
 int32_t IMX335_SetTestPattern(IMX335_Object_t *pObj, int32_t mode);
+int32_t IMX335_GetExposureMax(IMX335_Object_t *pObj, int32_t *exposure);
+const IMX335_Mode_t *IMX335_GetModes(uint32_t *Count);
+const IMX335_Mode_t *IMX335_GetMode(uint32_t Resolution);
 
 /**
   * @}
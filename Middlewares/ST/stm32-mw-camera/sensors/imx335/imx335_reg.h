@@ -86,6 +86,14 @@
 #define AREA3_ST_ADR_1_LSB        0x3074U
 #define AREA3_ST_ADR_1_MSB        0x3075U
 
+/* Window cropping (WINMODE 4, set by the base table) */
+#define IMX335_REG_HTRIMMING_START 0x302CU
+#define IMX335_REG_HNUM           0x302EU
+#define IMX335_REG_Y_OUT_SIZE     0x3056U
+#define IMX335_REG_AREA3_WIDTH_1  0x3076U
+#define IMX335_HTRIMMING_START_ALL 60U   /* First column of the all-pixel readout */
+#define IMX335_AREA3_ST_ADR_1_ALL 200U   /* First line of the all-pixel readout, 2 units per line */
+
 /* For 2592x1944 */
 #define IMX335_WIDTH              2592
 #define IMX335_HEIGHT             1944
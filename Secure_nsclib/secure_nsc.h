@@ -35,10 +35,49 @@ typedef enum
 SECURE_FAULT_CB_ID     = 0x00U, /*!< System secure fault callback ID */
   IAC_ERROR_CB_ID       = 0x01U  /*!< Illegal access secure error callback ID */
 } SECURE_CallbackIDTypeDef;
+
+/**
+  * @brief  Controls a non-secure caller may batch in SECURE_NS_Submit()
+  */
+typedef enum
+{
+  SECURE_NS_CMD_SELECT_NETWORK = 0x00U, /*!< arg: registered network, applied before the next inference */
+  SECURE_NS_CMD_SET_FRAME_RATE = 0x01U  /*!< arg: sensor frame rate, fps */
+} SECURE_NS_CommandIDTypeDef;
+
+typedef struct
+{
+  uint32_t id;  /*!< SECURE_NS_CommandIDTypeDef */
+  int32_t arg;
+} SECURE_NS_CommandTypeDef;
+
+/**
+  * @brief  Secure-side counters fetched once per UI period
+  */
+typedef struct
+{
+  uint32_t display_frame_id; /*!< Sensor frame scanned out */
+  uint32_t display_age_us;   /*!< Capture vsync to the vblank that latched it */
+  uint32_t display_dropped;  /*!< Complete frames never shown */
+  uint32_t display_repeated; /*!< Frame events that kept the previous frame */
+  uint32_t rejected;         /*!< Commands refused since start */
+} SECURE_NS_TelemetryTypeDef;
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void SECURE_RegisterCallback(SECURE_CallbackIDTypeDef CallbackId, void *func);
+/* NPU_WEIGHT_CIPHER builds: the secure side writes the OTP weights key to
+ * the NPU bus interfaces; the key itself never reaches the caller */
+void SECURE_NPU_LoadWeightKeys(void);
+/* NS_SPLIT builds. Attach once: returns the non-secure alias of the shared
+ * result block (ns_shared_t, app_nsshare.h), then read the results in place
+ * with NSShare_Acquire(), without a gateway call per frame */
+void *SECURE_NS_Attach(void);
+/* Apply a batch of controls in one transition; returns the number accepted,
+ * the first invalid one ends the batch */
+uint32_t SECURE_NS_Submit(const SECURE_NS_CommandTypeDef *cmds, uint32_t nb);
+/* Once per UI period, alongside the batch of controls */
+void SECURE_NS_GetTelemetry(SECURE_NS_TelemetryTypeDef *telemetry);
 
 #endif /* SECURE_NSC_H */
 /* USER CODE END Non_Secure_CallLib_h */
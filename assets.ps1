@@ -0,0 +1,175 @@
+$ErrorActionPreference = "Stop"
+
+# Asset pack for ASSET_PACK_ENABLE builds (app_assets.h), flashed at
+# ASSET_PACK_FLASH_ADDR with flash.ps1 $AssetPack
+$ProjectRoot = $PSScriptRoot
+$OutFile = Join-Path $ProjectRoot "Appli/build/assets.bin"
+$PackSize = 1024 * 1024  # ASSET_PACK_SIZE in app_config.h
+# Overlay fonts, in the order of their ASSET_ID_ in app_assets.h
+$Fonts = @(
+    @{ Id = 1; Name = "Font16"; File = "Libraries/Fonts/font16.c" },
+    @{ Id = 2; Name = "Font12"; File = "Libraries/Fonts/font12.c" }
+)
+# 8-bit alpha images, binary PGM (P5, maxval 255), numbered from
+# ASSET_ID_IMAGE_FIRST in this order
+$Images = @()
+$ImageFirstId = 0x100
+
+$AssetTypeFont = 1
+$AssetTypeA8 = 2
+$EntrySize = 24
+
+# Function to compute the FNV-1a check word the firmware verifies
+function Get-Fnv1a {
+    param([byte[]]$Data)
+
+    # UInt64 throughout: mixed signed operands would go through Double
+    [uint64]$hash = 2166136261
+    [uint64]$prime = 16777619
+    [uint64]$modulus = 4294967296
+    foreach ($b in $Data) {
+        $hash = (($hash -bxor [uint64]$b) * $prime) % $modulus
+    }
+    return [uint32]$hash
+}
+
+# Function to append an LZ4 length past the 15 of its token nibble
+function Add-Lz4Length {
+    param($Out, [int]$Length)
+
+    if ($Length -lt 15) {
+        return
+    }
+    $rest = $Length - 15
+    while ($rest -ge 255) {
+        $Out.Add([byte]255)
+        $rest -= 255
+    }
+    $Out.Add([byte]$rest)
+}
+
+# Function to append one LZ4 sequence: literals, then a match unless last
+function Add-Lz4Sequence {
+    param($Out, [byte[]]$Data, [int]$Start, [int]$Literals, [int]$Offset, [int]$Match)
+
+    $extra = if ($Match) { $Match - 4 } else { 0 }
+    $Out.Add([byte]([Math]::Min($Literals, 15) * 16 + [Math]::Min($extra, 15)))
+    Add-Lz4Length $Out $Literals
+    for ($k = 0; $k -lt $Literals; $k++) {
+        $Out.Add($Data[$Start + $k])
+    }
+    if ($Match) {
+        $Out.Add([byte]($Offset -band 0xFF))
+        $Out.Add([byte]($Offset -shr 8))
+        Add-Lz4Length $Out $extra
+    }
+}
+
+# Function to compress into one LZ4 raw block: greedy, the last match leaving
+# 12 bytes before the end to start in and 5 literals to end with, as the
+# format requires
+function Compress-Lz4 {
+    param([byte[]]$Data)
+
+    $out = New-Object System.Collections.Generic.List[byte]
+    $last = @{}
+    $n = $Data.Length
+    $anchor = 0
+    $i = 0
+    while ($i -lt $n - 12) {
+        $key = [BitConverter]::ToUInt32($Data, $i)
+        $ref = if ($last.ContainsKey($key)) { $last[$key] } else { -1 }
+        $last[$key] = $i
+        if ($ref -lt 0 -or $i - $ref -gt 65535) {
+            $i++
+            continue
+        }
+        $length = 4
+        while ($i + $length -lt $n - 5 -and $Data[$ref + $length] -eq $Data[$i + $length]) {
+            $length++
+        }
+        Add-Lz4Sequence $out $Data $anchor ($i - $anchor) ($i - $ref) $length
+        $i += $length
+        $anchor = $i
+    }
+    Add-Lz4Sequence $out $Data $anchor ($n - $anchor) 0 0
+    return ,$out.ToArray()
+}
+
+# Function to read a UTIL_LCD font: its table bytes, width and height
+function Read-Font {
+    param([string]$Name, [string]$File)
+
+    $text = [System.IO.File]::ReadAllText((Join-Path $ProjectRoot $File))
+    $table = [regex]::Match($text, "$($Name)_Table\[\]\s*=\s*\{(.*?)\};", "Singleline")
+    $desc = [regex]::Match($text, "sFONT\s+$Name\s*=\s*\{\s*$($Name)_Table\s*,\s*(\d+)\s*,[^\d]*(\d+)")
+    if (-not $table.Success -or -not $desc.Success) {
+        throw "$Name not found in $File"
+    }
+    $bytes = [regex]::Matches($table.Groups[1].Value, "0x([0-9A-Fa-f]{2})") | ForEach-Object { [Convert]::ToByte($_.Groups[1].Value, 16) }
+    return @{ Data = [byte[]]$bytes; Width = [int]$desc.Groups[1].Value; Height = [int]$desc.Groups[2].Value }
+}
+
+# Function to read a binary PGM: its pixels, width and height
+function Read-Pgm {
+    param([string]$File)
+
+    $bytes = [System.IO.File]::ReadAllBytes($File)
+    $fields = @()
+    $i = 0
+    while ($fields.Count -lt 4) {
+        while ([char]$bytes[$i] -match "\s") { $i++ }
+        $start = $i
+        while ([char]$bytes[$i] -notmatch "\s") { $i++ }
+        $fields += [System.Text.Encoding]::ASCII.GetString($bytes, $start, $i - $start)
+    }
+    if ($fields[0] -ne "P5" -or $fields[3] -ne "255") {
+        throw "$File is not an 8-bit binary PGM"
+    }
+    $width = [int]$fields[1]
+    $height = [int]$fields[2]
+    return @{ Data = [byte[]]$bytes[($i + 1)..($i + $width * $height)]; Width = $width; Height = $height }
+}
+
+$assets = @()
+foreach ($font in $Fonts) {
+    $f = Read-Font -Name $font.Name -File $font.File
+    $count = $f.Data.Length / ($f.Height * [Math]::Floor(($f.Width + 7) / 8))
+    $assets += @{ Id = $font.Id; Type = $AssetTypeFont; Count = $count; Width = $f.Width; Height = $f.Height; Data = $f.Data }
+}
+for ($k = 0; $k -lt $Images.Count; $k++) {
+    $p = Read-Pgm -File $Images[$k]
+    $assets += @{ Id = $ImageFirstId + $k; Type = $AssetTypeA8; Count = 1; Width = $p.Width; Height = $p.Height; Data = $p.Data }
+}
+
+# Header, entries, then the blocks in the same order
+$pack = New-Object System.IO.MemoryStream
+$writer = New-Object System.IO.BinaryWriter($pack)
+$writer.Write([uint32]0x4B505341)  # ASSET_PACK_MAGIC
+$writer.Write([uint32]$assets.Count)
+$offset = 8 + $assets.Count * $EntrySize
+$blocks = @()
+foreach ($a in $assets) {
+    $block = Compress-Lz4 $a.Data
+    $writer.Write([uint16]$a.Id)
+    $writer.Write([byte]$a.Type)
+    $writer.Write([byte]$a.Count)
+    $writer.Write([uint16]$a.Width)
+    $writer.Write([uint16]$a.Height)
+    $writer.Write([uint32]$offset)
+    $writer.Write([uint32]$block.Length)
+    $writer.Write([uint32]$a.Data.Length)
+    $writer.Write([uint32](Get-Fnv1a $a.Data))
+    Write-Host ("Asset {0:X3}: {1}x{2} x{3}, {4} -> {5} bytes" -f $a.Id, $a.Width, $a.Height, $a.Count, $a.Data.Length, $block.Length)
+    $offset += $block.Length
+    $blocks += , $block
+}
+foreach ($block in $blocks) {
+    $writer.Write($block)
+}
+$writer.Flush()
+if ($pack.Length -gt $PackSize) {
+    throw "Asset pack of $($pack.Length) bytes exceeds $PackSize"
+}
+[System.IO.File]::WriteAllBytes($OutFile, $pack.ToArray())
+Write-Host "Asset pack: $($pack.Length) bytes -> $OutFile" -ForegroundColor Green
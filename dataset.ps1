@@ -0,0 +1,185 @@
+$ErrorActionPreference = "Stop"
+
+# Image of the microSD card (DATASET_ENABLE) to extract, e.g. read raw with dd
+$SdImage = "dataset.img"
+$SdFirstBlock = 2048
+# Directory written: one PPM (RGB888, or ML_YUV422 expanded) or PGM (Y8)
+# per record, the frame as the network read it, and a label file of the same name, one detection per
+# line: class, center x, center y, width, height (normalized), confidence
+$OutDir = "dataset"
+# Detections below this confidence left out of the labels (0: all stored)
+$MinConfidence = 0.0
+# ISP state of every record in this CSV file ("": not written)
+$MetaCsv = "dataset.csv"
+
+# Card layout (Appli/Core/Inc/app_dataset.h): two 32-byte index copies in
+# the first two blocks, record slots from the next 64 KB on, each the frame
+# then a 512-byte header block; FNV-1a check words
+$SdBlockSize = 512
+$SdAlignBlocks = 128
+$IndexMagic = 0x4944364E
+$RecordMagic = 0x5244364E
+$DetectionOffset = 60
+$DetectionSize = 24
+$FormatRgb888 = 2
+$FormatY8 = 5
+$FormatYuv422 = 6
+
+function Get-U16 { param([byte[]]$Data, [int]$Offset) [BitConverter]::ToUInt16($Data, $Offset) }
+function Get-U32 { param([byte[]]$Data, [int]$Offset) [BitConverter]::ToUInt32($Data, $Offset) }
+function Get-F32 { param([byte[]]$Data, [int]$Offset) [BitConverter]::ToSingle($Data, $Offset) }
+
+# Function to compute the check word of a byte range
+function Get-Fnv1a {
+    param([byte[]]$Data, [int]$Offset, [int]$Length)
+
+    # UInt64 throughout: mixed signed operands would go through Double
+    [uint64]$hash = 2166136261
+    [uint64]$prime = 16777619
+    [uint64]$modulus = 4294967296
+    for ($i = $Offset; $i -lt $Offset + $Length; $i++) {
+        $hash = (($hash -bxor [uint64]$Data[$i]) * $prime) % $modulus
+    }
+    return [uint32]$hash
+}
+
+# Function to write a frame without its line padding as a binary PPM or PGM
+function Save-Frame {
+    param([string]$Path, [byte[]]$Frame, [int]$Width, [int]$Height, [int]$Pitch, [int]$Bpp)
+
+    $kind = if ($Bpp -eq 1) { "P5" } else { "P6" }
+    $header = [System.Text.Encoding]::ASCII.GetBytes("$kind`n$Width $Height`n255`n")
+    $file = [System.IO.File]::Create($Path)
+    try {
+        $file.Write($header, 0, $header.Length)
+        for ($y = 0; $y -lt $Height; $y++) {
+            $file.Write($Frame, $y * $Pitch, $Width * $Bpp)
+        }
+    } finally {
+        $file.Close()
+    }
+}
+
+# Function to write a 4:2:2 frame as a binary PPM: the luma slot of every
+# pixel is its G, the chroma slots of its pair B (U) and R (V)
+function Save-Yuv422Frame {
+    param([string]$Path, [byte[]]$Frame, [int]$Width, [int]$Height, [int]$Pitch)
+
+    $header = [System.Text.Encoding]::ASCII.GetBytes("P6`n$Width $Height`n255`n")
+    $line = New-Object byte[] ($Width * 3)
+    $file = [System.IO.File]::Create($Path)
+    try {
+        $file.Write($header, 0, $header.Length)
+        for ($y = 0; $y -lt $Height; $y++) {
+            for ($x = 0; $x -lt $Width; $x += 2) {
+                $o = $y * $Pitch + $x * 2
+                $u = $Frame[$o + 1]
+                $v = $Frame[$o + 3]
+                $line[$x * 3] = $v
+                $line[$x * 3 + 1] = $Frame[$o]
+                $line[$x * 3 + 2] = $u
+                $line[$x * 3 + 3] = $v
+                $line[$x * 3 + 4] = $Frame[$o + 2]
+                $line[$x * 3 + 5] = $u
+            }
+            $file.Write($line, 0, $line.Length)
+        }
+    } finally {
+        $file.Close()
+    }
+}
+
+$image = [System.IO.File]::OpenRead($SdImage)
+try {
+    $blocks = New-Object byte[] (2 * $SdBlockSize)
+    [void]$image.Seek([int64]$SdFirstBlock * $SdBlockSize, [System.IO.SeekOrigin]::Begin)
+    [void]$image.Read($blocks, 0, $blocks.Length)
+
+    # The valid index copy with the highest generation: a torn one fails its check
+    $index = -1
+    foreach ($o in 0, $SdBlockSize) {
+        if ((Get-U32 $blocks $o) -ne $IndexMagic -or (Get-U32 $blocks ($o + 28)) -ne (Get-Fnv1a $blocks $o 28)) {
+            continue
+        }
+        if ($index -lt 0 -or (Get-U32 $blocks ($o + 8)) -gt (Get-U32 $blocks ($index + 8))) {
+            $index = $o
+        }
+    }
+    if ($index -lt 0) {
+        Write-Host "dataset: no dataset in $SdImage at block $SdFirstBlock" -ForegroundColor Red
+        return
+    }
+    $recordSize = [int64](Get-U16 $blocks ($index + 6)) * $SdBlockSize
+    [int64]$records = Get-U32 $blocks ($index + 12)
+    [int64]$capacity = Get-U32 $blocks ($index + 16)
+    $dataOffset = [int64]($SdFirstBlock + $SdAlignBlocks) * $SdBlockSize
+    $first = [Math]::Max(0, $records - $capacity)
+    Write-Host "Extracting $($records - $first) records of $SdImage, $(Get-U32 $blocks ($index + 20)) boots" -ForegroundColor Cyan
+
+    [void](New-Item -ItemType Directory -Force -Path $OutDir)
+    $rows = New-Object System.Collections.Generic.List[string]
+    $rows.Add("record,boot,frame_id,uptime_ms,exposure_us,gain_mdb,color_temp,average_luma,luma_target,detected,dropped")
+    $record = New-Object byte[] $recordSize
+    $written = 0
+    for ($n = $first; $n -lt $records; $n++) {
+        [void]$image.Seek($dataOffset + ($n % $capacity) * $recordSize, [System.IO.SeekOrigin]::Begin)
+        [void]$image.Read($record, 0, $recordSize)
+
+        # The header block follows the frame: a valid one has its frame whole
+        $h = -1
+        for ($b = 1; $b * $SdBlockSize -lt $recordSize; $b++) {
+            $o = $b * $SdBlockSize
+            if ((Get-U32 $record $o) -eq $RecordMagic -and (Get-U32 $record ($o + 8)) -eq $n -and
+                (Get-U32 $record ($o + 32)) -eq $b) {
+                $h = $o
+                break
+            }
+        }
+        if ($h -lt 0 -or (Get-U32 $record ($h + $SdBlockSize - 4)) -ne (Get-Fnv1a $record $h ($SdBlockSize - 4))) {
+            Write-Host "dataset: record $n corrupt, skipped" -ForegroundColor Yellow
+            continue
+        }
+
+        $width = Get-U16 $record ($h + 24)
+        $height = Get-U16 $record ($h + 26)
+        $pitch = Get-U16 $record ($h + 28)
+        $format = $record[$h + 30]
+        if ($format -ne $FormatRgb888 -and $format -ne $FormatY8 -and $format -ne $FormatYuv422) {
+            Write-Host "dataset: record $n of unknown format $format, skipped" -ForegroundColor Yellow
+            continue
+        }
+        $name = Join-Path $OutDir ("{0:D8}" -f $n)
+        if ($format -eq $FormatYuv422) {
+            Save-Yuv422Frame "$name.ppm" $record $width $height $pitch
+        } else {
+            $bpp = if ($format -eq $FormatY8) { 1 } else { 3 }
+            Save-Frame "$name.$(if ($bpp -eq 1) { 'pgm' } else { 'ppm' })" $record $width $height $pitch $bpp
+        }
+
+        $labels = New-Object System.Text.StringBuilder
+        $nb = Get-U16 $record ($h + 6)
+        for ($k = 0; $k -lt $nb; $k++) {
+            $o = $h + $DetectionOffset + $k * $DetectionSize
+            $conf = Get-F32 $record ($o + 16)
+            if ($conf -lt $MinConfidence) {
+                continue
+            }
+            [void]$labels.AppendLine(("{0} {1:F6} {2:F6} {3:F6} {4:F6} {5:F4}" -f
+                [BitConverter]::ToInt32($record, $o + 20), (Get-F32 $record $o), (Get-F32 $record ($o + 4)),
+                (Get-F32 $record ($o + 8)), (Get-F32 $record ($o + 12)), $conf))
+        }
+        [System.IO.File]::WriteAllText("$name.txt", $labels.ToString())
+
+        $rows.Add(("{0},{1},{2},{3},{4},{5},{6},{7},{8},{9},{10}" -f $n, (Get-U32 $record ($h + 12)),
+            (Get-U32 $record ($h + 16)), (Get-U32 $record ($h + 20)), (Get-U32 $record ($h + 36)),
+            (Get-U32 $record ($h + 40)), (Get-U32 $record ($h + 44)), $record[$h + 48], $record[$h + 49],
+            (Get-U16 $record ($h + 50)), (Get-U32 $record ($h + 56))))
+        $written++
+    }
+    if ($MetaCsv -ne "") {
+        [System.IO.File]::WriteAllLines($MetaCsv, $rows)
+    }
+    Write-Host "dataset: $written records in $OutDir" -ForegroundColor Green
+} finally {
+    $image.Close()
+}
@@ -5,6 +5,45 @@ $SigningTool = "STM32_SigningTool_CLI"
 $Flash = $true
 $FlashTool = "STM32_Programmer_CLI"
 $BuildType = "Release"
+# Relocatable network binary for NN_RELOC builds (empty: not flashed); it is
+# written with a model header into the model slot $ModelSlot
+$RelocModel = ""
+# A/B slots (Libraries/boot_slots/boot_slots.h): slots written and booted,
+# and the versions the slot table records for them. The other slots stay as
+# the fallback the FSBL rolls back to if the update never confirms. With
+# $ModelOnly only the model slot and the table are written: $AppSlot must
+# then name the application slot already in use
+$AppSlot = "A"
+$ModelSlot = "A"
+$AppVersion = 1
+$ModelVersion = 1
+$ModelOnly = $false
+$SlotTableAddress = "0x700F0000"  # BOOT_SLOTS_TABLE_OFFSET
+$AppSlotAddresses = @{ "A" = "0x70100000"; "B" = "0x70180000" }  # BOOT_SLOTS_APP_OFFSET()
+$ModelSlotAddresses = @{ "A" = "0x71800000"; "B" = "0x72000000" }  # BOOT_SLOTS_MODEL_OFFSET()
+$ModelWeightsOffset = 0x1000  # Keeps the binary sector aligned
+# Application manifest (boot_app_manifest_t), written after the signed
+# image into the last sector of its slot: the FSBL hashes the copy and
+# boots it only when the SHA-256 matches. $ManifestKey is FSBL_MANIFEST_KEY
+# in FSBL/Core/Src/fsbl_boot.c
+$ManifestKey = "stm32n6-dk-development-manifest"
+$ManifestOffset = 0x7F000  # BOOT_SLOTS_APP_SIZE - BOOT_SLOTS_MANIFEST_SIZE
+# Application image: "Firmware_PPBench" for the post-processing benchmark,
+# which replays the recorded scenes blob (empty: synthetic scenes only)
+$AppliProject = "Firmware_Appli"
+$PPBenchScenes = ""
+$PPBenchScenesAddress = "0x71C00000"  # PPBENCH_SCENES_FLASH_ADDR in app_config.h
+# Overlay font pack of an ASSET_PACK_ENABLE build, from assets.ps1 (empty:
+# not flashed)
+$AssetPack = ""
+$AssetPackAddress = "0x71F00000"  # ASSET_PACK_FLASH_ADDR in app_config.h
+# Golden vector of a SELFTEST_ENABLE build, from selftest.ps1 (empty: not
+# flashed)
+$SelfTestVector = ""
+$SelfTestVectorAddress = "0x71D00000"  # SELFTEST_FLASH_ADDR in app_config.h
+# Executed-in-place part of an APP_SPLIT_XIP build, flashed unsigned next to
+# the application when the build produced it
+$XipAddress = "0x70200000"  # ORIGIN(XIPROM) in STM32N657XX_LRUN.ld
 
 # Function to sign a binary
 function Sign-Binary {
@@ -54,6 +93,103 @@ function Sign-Binary {
     return $true
 }
 
+# Byte sum, as checked by the FSBL and the application
+function Get-ByteSum {
+    param([byte[]]$Bytes)
+
+    $sum = [uint64]0
+    foreach ($b in $Bytes) {
+        $sum += $b
+    }
+    return [uint32]($sum -band 0xFFFFFFFF)
+}
+
+function Get-SlotIndex {
+    param([string]$Slot)
+
+    if ($Slot -eq "A") { return 0 }
+    if ($Slot -eq "B") { return 1 }
+    throw "Slot must be A or B: $Slot"
+}
+
+# boot_model_header_t followed by the relocatable network binary
+function New-ModelSlotImage {
+    param(
+        [string]$BinFile,
+        [uint32]$Version,
+        [string]$OutFile
+    )
+
+    $binary = [System.IO.File]::ReadAllBytes($BinFile)
+    $header = New-Object System.IO.MemoryStream
+    $writer = New-Object System.IO.BinaryWriter($header)
+    $writer.Write([uint32]0x4C444F4D)  # BOOT_SLOTS_MODEL_MAGIC
+    $writer.Write([uint32]$Version)
+    $writer.Write([uint32]$ModelWeightsOffset)
+    $writer.Write([uint32]$binary.Length)
+    $writer.Write([uint32](Get-ByteSum $binary))
+    $writer.Write([uint32](Get-ByteSum $header.ToArray()))
+    $writer.Flush()
+
+    $image = New-Object byte[] ($ModelWeightsOffset + $binary.Length)
+    [System.Array]::Copy($header.ToArray(), $image, $header.Length)
+    [System.Array]::Copy($binary, 0, $image, $ModelWeightsOffset, $binary.Length)
+    [System.IO.File]::WriteAllBytes($OutFile, $image)
+}
+
+# boot_app_manifest_t of a signed image: its SHA-256 and the HMAC tag
+function New-AppManifest {
+    param(
+        [string]$SignedBinFile,
+        [uint32]$Version,
+        [string]$OutFile
+    )
+
+    $signed = [System.IO.File]::ReadAllBytes($SignedBinFile)
+    $imageSize = [BitConverter]::ToUInt32($signed, 108) + 1024  # BOOT_GetApplicationSize()
+    $sha = [System.Security.Cryptography.SHA256]::Create()
+    $digest = $sha.ComputeHash($signed, 0, $imageSize)
+
+    $manifest = New-Object System.IO.MemoryStream
+    $writer = New-Object System.IO.BinaryWriter($manifest)
+    $writer.Write([uint32]0x5453464D)  # BOOT_SLOTS_MANIFEST_MAGIC
+    $writer.Write([uint32]$Version)
+    $writer.Write([uint32]$imageSize)
+    $writer.Write([uint32]0)
+    $writer.Write($digest)
+    $writer.Flush()
+    $hmac = New-Object System.Security.Cryptography.HMACSHA256 (, [System.Text.Encoding]::ASCII.GetBytes($ManifestKey))
+    $writer.Write($hmac.ComputeHash($manifest.ToArray()))
+    $writer.Flush()
+    [System.IO.File]::WriteAllBytes($OutFile, $manifest.ToArray())
+}
+
+# boot_slots_table_t: a new generation, in trial until the application confirms
+function New-SlotTable {
+    param([string]$OutFile)
+
+    $app = Get-SlotIndex $AppSlot
+    $model = Get-SlotIndex $ModelSlot
+    $prevApp = if ($ModelOnly) { $app } else { 1 - $app }
+    $prevModel = if ($RelocModel) { 1 - $model } else { $model }
+    $appVersions = @(0, 0)
+    $modelVersions = @(0, 0)
+    $appVersions[$app] = $AppVersion
+    $modelVersions[$model] = $ModelVersion
+
+    $table = New-Object System.IO.MemoryStream
+    $writer = New-Object System.IO.BinaryWriter($table)
+    $writer.Write([uint32]0x544F4C53)  # BOOT_SLOTS_TABLE_MAGIC
+    $writer.Write([uint32]([DateTimeOffset]::UtcNow.ToUnixTimeSeconds() -band 0xFFFFFFFF))
+    $writer.Write([byte[]]@($app, $model, $prevApp, $prevModel, 0, 0, 0, 0))
+    $appVersions | ForEach-Object { $writer.Write([uint32]$_) }
+    $modelVersions | ForEach-Object { $writer.Write([uint32]$_) }
+    $writer.Flush()
+    $writer.Write([uint32](Get-ByteSum $table.ToArray()))
+    $writer.Flush()
+    [System.IO.File]::WriteAllBytes($OutFile, $table.ToArray())
+}
+
 # Function to find external loader
 function Get-ExternalLoader {
     # Try to find STM32CubeProgrammer installation
@@ -180,35 +316,105 @@ if (-not (Test-Path $fsblBinPath)) {
     $fsblBinPath = Join-Path $fsblBuildDir "Firmware_FSBL.bin"
 }
 
-$appliBinPath = Join-Path $appliBuildDir "$buildSubDir\Firmware_Appli.bin"
+$appliBinPath = Join-Path $appliBuildDir "$buildSubDir\$AppliProject.bin"
 if (-not (Test-Path $appliBinPath)) {
-    $appliBinPath = Join-Path $appliBuildDir "Firmware_Appli.bin"
+    $appliBinPath = Join-Path $appliBuildDir "$AppliProject.bin"
 }
 
-# Sign FSBL
-$fsblBin = $fsblBinPath
-$fsblSigned = Join-Path $fsblBuildDir "Firmware_FSBL-trusted.bin"
-    
-if (Sign-Binary -ProjectName "FSBL" -BuildDir (Join-Path $ProjectRoot "FSBL\build") -BinFile $fsblBin -SignedBinFile $fsblSigned) {
-    if ($Flash -and -not (Flash-Binary -ProjectName "FSBL" -SignedBinFile $fsblSigned -Address "0x70000000" -FlashToolPath $FlashTool)) {
+# Reject a slot name before anything is written
+$null = Get-SlotIndex $AppSlot
+$null = Get-SlotIndex $ModelSlot
+
+if (-not $ModelOnly) {
+    # Sign FSBL
+    $fsblBin = $fsblBinPath
+    $fsblSigned = Join-Path $fsblBuildDir "Firmware_FSBL-trusted.bin"
+
+    if (Sign-Binary -ProjectName "FSBL" -BuildDir (Join-Path $ProjectRoot "FSBL\build") -BinFile $fsblBin -SignedBinFile $fsblSigned) {
+        if ($Flash -and -not (Flash-Binary -ProjectName "FSBL" -SignedBinFile $fsblSigned -Address "0x70000000" -FlashToolPath $FlashTool)) {
+            $success = $false
+        }
+    }
+    else {
         $success = $false
     }
+
+    # Sign Appli, into application slot $AppSlot
+    $appliBin = $appliBinPath
+    $appliSigned = Join-Path $appliBuildDir "$AppliProject-trusted.bin"
+
+    if (Sign-Binary -ProjectName "Appli" -BuildDir (Join-Path $ProjectRoot "Appli\build") -BinFile $appliBin -SignedBinFile $appliSigned) {
+        if ((Get-Item $appliSigned).Length -gt $ManifestOffset) {
+            Write-Error "Signed application exceeds its slot (BOOT_SLOTS_APP_SIZE, less the manifest)"
+            $success = $false
+        }
+        elseif ($Flash -and -not (Flash-Binary -ProjectName "Appli (slot $AppSlot)" -SignedBinFile $appliSigned -Address $AppSlotAddresses[$AppSlot] -FlashToolPath $FlashTool)) {
+            $success = $false
+        }
+        else {
+            # Manifest after the image: a partly written slot has none that matches
+            $appliManifest = Join-Path $appliBuildDir "$AppliProject-manifest.bin"
+            New-AppManifest -SignedBinFile $appliSigned -Version $AppVersion -OutFile $appliManifest
+            $manifestAddress = "0x{0:X8}" -f ([Convert]::ToUInt32($AppSlotAddresses[$AppSlot], 16) + $ManifestOffset)
+            if ($Flash -and -not (Flash-Binary -ProjectName "Appli manifest (slot $AppSlot)" -SignedBinFile $appliManifest -Address $manifestAddress -FlashToolPath $FlashTool)) {
+                $success = $false
+            }
+        }
+    }
+    else {
+        $success = $false
+    }
+
+    # XIP part, same directory as the application binary; not slotted
+    $appliXipBin = [System.IO.Path]::ChangeExtension($appliBin, $null).TrimEnd('.') + "-xip.bin"
+    if ($Flash -and (Test-Path $appliXipBin)) {
+        if (-not (Flash-Binary -ProjectName "Appli XIP" -SignedBinFile $appliXipBin -Address $XipAddress -FlashToolPath $FlashTool)) {
+            $success = $false
+        }
+    }
 }
-else {
-    $success = $false
+
+# Relocatable network with its model header, into model slot $ModelSlot (not signed)
+if ($Flash -and $RelocModel) {
+    $modelImage = [System.IO.Path]::ChangeExtension($RelocModel, $null).TrimEnd('.') + "-slot.bin"
+    New-ModelSlotImage -BinFile $RelocModel -Version $ModelVersion -OutFile $modelImage
+    if ((Get-Item $modelImage).Length -gt 0x400000) {
+        Write-Error "Relocatable network exceeds its slot (BOOT_SLOTS_MODEL_SIZE)"
+        $success = $false
+    }
+    elseif (-not (Flash-Binary -ProjectName "Relocatable network (slot $ModelSlot)" -SignedBinFile $modelImage -Address $ModelSlotAddresses[$ModelSlot] -FlashToolPath $FlashTool)) {
+        $success = $false
+    }
 }
 
-# Sign Appli
-$appliBin = $appliBinPath
-$appliSigned = Join-Path $appliBuildDir "Firmware_Appli-trusted.bin"
-    
-if (Sign-Binary -ProjectName "Appli" -BuildDir (Join-Path $ProjectRoot "Appli\build") -BinFile $appliBin -SignedBinFile $appliSigned) {
-    if ($Flash -and -not (Flash-Binary -ProjectName "Appli" -SignedBinFile $appliSigned -Address "0x70100000" -FlashToolPath $FlashTool)) {
+# Slot table last: the FSBL only switches once both slots are written
+if ($Flash -and $success) {
+    $slotTable = Join-Path $appliBuildDir "boot_slots.bin"
+    New-SlotTable -OutFile $slotTable
+    if (-not (Flash-Binary -ProjectName "Slot table" -SignedBinFile $slotTable -Address $SlotTableAddress -FlashToolPath $FlashTool)) {
         $success = $false
     }
 }
-else {
-    $success = $false
+
+# Flash the recorded post-processing benchmark scenes (raw blob, not signed)
+if ($Flash -and $PPBenchScenes) {
+    if (-not (Flash-Binary -ProjectName "Benchmark scenes" -SignedBinFile $PPBenchScenes -Address $PPBenchScenesAddress -FlashToolPath $FlashTool)) {
+        $success = $false
+    }
+}
+
+# Flash the self-test golden vector (raw, not signed)
+if ($Flash -and $SelfTestVector) {
+    if (-not (Flash-Binary -ProjectName "Golden vector" -SignedBinFile $SelfTestVector -Address $SelfTestVectorAddress -FlashToolPath $FlashTool)) {
+        $success = $false
+    }
+}
+
+# Flash the asset pack (raw, not signed)
+if ($Flash -and $AssetPack) {
+    if (-not (Flash-Binary -ProjectName "Asset pack" -SignedBinFile $AssetPack -Address $AssetPackAddress -FlashToolPath $FlashTool)) {
+        $success = $false
+    }
 }
 
 # Check if the operation was successful
@@ -0,0 +1,131 @@
+$ErrorActionPreference = "Stop"
+
+# Golden vector of the boot self-test (SELFTEST_ENABLE, app_selftest.h),
+# flashed at SELFTEST_FLASH_ADDR with flash.ps1 $SelfTestVector
+$ProjectRoot = $PSScriptRoot
+$OutFile = Join-Path $ProjectRoot "Appli/build/selftest.bin"
+$VectorSize = 1024 * 1024  # SELFTEST_FLASH_SIZE in app_config.h
+# Reference input: a frame as the network reads it, e.g. a dataset.ps1 PPM
+# (P6 RGB888) or PGM (P5 Y8), or the raw input buffer (.bin)
+$InputFile = "dataset/000000.ppm"
+# Bytes per input line of the network buffer (ML_PITCH_PADDED builds), 0:
+# the frame lines back to back
+$InputPitch = 0
+# Golden record: the "selftest: record ..." line the board prints on a
+# vector without one, from "check=" on ("": vector without a record, to
+# flash first and read the line of a known-good build back)
+$Record = ""
+# Budget over the recorded inference time
+$BudgetMarginPct = 10
+# Model slot header version the record holds for (flash.ps1 $ModelVersion
+# of NN_RELOC builds), 0: any model
+$ModelVersion = 0
+
+# Vector layout: 136-byte header, then the input from $InputOffset
+$Magic = 0x54534C47
+$FlagRecorded = 0x01
+$TopNb = 4
+$InputOffset = 256
+
+# Function to compute the FNV-1a check word the firmware verifies
+function Get-Fnv1a {
+    param([byte[]]$Data)
+
+    # UInt64 throughout: mixed signed operands would go through Double
+    [uint64]$hash = 2166136261
+    [uint64]$prime = 16777619
+    [uint64]$modulus = 4294967296
+    foreach ($b in $Data) {
+        $hash = (($hash -bxor [uint64]$b) * $prime) % $modulus
+    }
+    return [uint32]$hash
+}
+
+# Function to read the input pixels, each line at $InputPitch bytes
+function Read-Input {
+    param([string]$Path)
+
+    $bytes = [System.IO.File]::ReadAllBytes($Path)
+    if ([System.IO.Path]::GetExtension($Path) -eq ".bin") {
+        return ,$bytes
+    }
+
+    # Binary PNM: magic, width, height, maxval, one whitespace, then pixels
+    $fields = @()
+    $i = 0
+    while ($fields.Count -lt 4) {
+        while ([char]$bytes[$i] -match '\s') {
+            $i++
+        }
+        $start = $i
+        while (-not ([char]$bytes[$i] -match '\s')) {
+            $i++
+        }
+        $fields += [System.Text.Encoding]::ASCII.GetString($bytes, $start, $i - $start)
+    }
+    $i++
+    $bpp = switch ($fields[0]) { "P6" { 3 } "P5" { 1 } default { throw "$Path is not a binary PPM or PGM" } }
+    $width = [int]$fields[1]
+    $height = [int]$fields[2]
+    $line = $width * $bpp
+    $pitch = if ($InputPitch -gt 0) { $InputPitch } else { $line }
+    $data = New-Object byte[] ($pitch * $height)
+    for ($y = 0; $y -lt $height; $y++) {
+        [Array]::Copy($bytes, $i + $y * $line, $data, $y * $pitch, $line)
+    }
+    return ,$data
+}
+
+$inputBytes = Read-Input $InputFile
+if ($InputOffset + $inputBytes.Length -gt $VectorSize) {
+    throw "Input of $($inputBytes.Length) bytes does not fit the $VectorSize-byte vector"
+}
+
+$header = New-Object System.IO.MemoryStream
+$writer = New-Object System.IO.BinaryWriter($header)
+$writer.Write([uint32]$Magic)
+$writer.Write([uint32]$ModelVersion)
+$writer.Write([uint32]$InputOffset)
+$writer.Write([uint32]$inputBytes.Length)
+$writer.Write([uint32](Get-Fnv1a $inputBytes))
+if ($Record -ne "") {
+    # Floats as the board printed their bits: the record is exact
+    if ($Record -notmatch 'check=0x([0-9A-Fa-f]{8}) us=(\d+) nb=(\d+)') {
+        throw "Record not understood: $Record"
+    }
+    $check = [Convert]::ToUInt32($Matches[1], 16)
+    $us = [uint32]$Matches[2]
+    $nb = [uint32]$Matches[3]
+    $dets = [regex]::Matches($Record, 'det=(-?\d+):([0-9A-Fa-f]{8}),([0-9A-Fa-f]{8}),([0-9A-Fa-f]{8}),([0-9A-Fa-f]{8}),([0-9A-Fa-f]{8})')
+    if ($dets.Count -ne [Math]::Min($nb, $TopNb)) {
+        throw "Record holds $($dets.Count) detections for nb=$nb"
+    }
+    $writer.Write([uint32]$FlagRecorded)
+    $writer.Write([uint32]$check)
+    $writer.Write([uint32][Math]::Ceiling($us * (100 + $BudgetMarginPct) / 100.0))
+    $writer.Write([uint32]$nb)
+    for ($k = 0; $k -lt $TopNb; $k++) {
+        if ($k -lt $dets.Count) {
+            for ($f = 2; $f -le 6; $f++) {
+                $writer.Write([uint32][Convert]::ToUInt32($dets[$k].Groups[$f].Value, 16))
+            }
+            $writer.Write([int32]$dets[$k].Groups[1].Value)
+        } else {
+            $writer.Write((New-Object byte[] 24))
+        }
+    }
+    Write-Host ("Golden record: check 0x{0:X8}, {1} detections, budget {2} us" -f $check, $nb,
+        [Math]::Ceiling($us * (100 + $BudgetMarginPct) / 100.0))
+} else {
+    $writer.Write((New-Object byte[] (4 * 4 + 24 * $TopNb)))
+    Write-Host "No golden record: the board prints the one to build the vector with" -ForegroundColor Yellow
+}
+$writer.Write([uint32](Get-Fnv1a $header.ToArray()))
+$writer.Flush()
+
+$vector = New-Object byte[] ($InputOffset + $inputBytes.Length)
+[Array]::Copy($header.ToArray(), 0, $vector, 0, $header.Length)
+[Array]::Copy($inputBytes, 0, $vector, $InputOffset, $inputBytes.Length)
+$null = New-Item -ItemType Directory -Force -Path (Split-Path $OutFile)
+[System.IO.File]::WriteAllBytes($OutFile, $vector)
+Write-Host "Self-test vector: $($vector.Length) bytes -> $OutFile" -ForegroundColor Green
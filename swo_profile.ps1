@@ -0,0 +1,281 @@
+$ErrorActionPreference = "Stop"
+
+# Raw SWO capture of a SWO_PROFILER build: the ITM byte stream, NRZ with the
+# formatter off, e.g. with OpenOCD on the ST-LINK:
+#   <target>.swo configure -protocol uart -formatter 0 -traceclk 800000000 -pin-freq 8000000 -output swo.bin
+#   <target>.swo enable
+$Capture = "swo.bin"
+# Image of the capture, for the symbols
+$Elf = Join-Path $PSScriptRoot "Appli/build/Release/Firmware_Appli.elf"
+$Nm = "arm-none-eabi-nm"
+$CpuHz = 800000000
+$TracePort = 1  # SWO_TRACE_PORT
+# PC samples profiled: inside this trace probe slice only (SWO_TRACE_EVENTS),
+# from its ($SkipSlices + 1)th one on, so boot and warm-up are left out; the
+# handler times start with it too ("": the whole capture)
+$Window = "nn.inference"
+$SkipSlices = 10
+# Folded stacks ("context;function samples" lines) for flamegraph.pl,
+# speedscope or inferno
+$Folded = "swo_profile.folded"
+# flamegraph.pl, to render $Folded to an SVG next to it ("": not rendered)
+$FlameGraph = ""
+$Top = 25
+
+# ITM packets (ARMv8-M): hardware source 1 is the exception trace (number,
+# 1 entered / 2 exited / 3 returned to), 2 the PC sample (1 byte: asleep);
+# software port $TracePort the probe words (Appli/Core/Inc/app_swo.h): id,
+# phase 0 'B' 1 'E' 2 'i' 3 'C', tid, int16 value
+$KindPc = 1
+$KindException = 2
+$KindProbe = 3
+$KindOverflow = 4
+
+$traceNames = @()
+$traceHeader = Join-Path $PSScriptRoot "Appli/Core/Inc/app_trace.h"
+if (Test-Path $traceHeader) {
+    foreach ($m in [regex]::Matches((Get-Content $traceHeader -Raw), 'X\((\w+), "([^"]+)"\)')) {
+        $traceNames += $m.Groups[2].Value
+    }
+}
+$windowId = -1
+if ($Window -ne "") {
+    $windowId = [array]::IndexOf($traceNames, $Window)
+    if ($windowId -lt 0) {
+        Write-Error "Trace probe not found in app_trace.h: $Window"
+    }
+}
+
+# Exception names: the core ones, then the device interrupts (IRQn + 16)
+$exceptionNames = @{ 0 = "thread"; 1 = "Reset"; 2 = "NMI"; 3 = "HardFault"; 4 = "MemManage"; 5 = "BusFault";
+    6 = "UsageFault"; 7 = "SecureFault"; 11 = "SVCall"; 12 = "DebugMonitor"; 14 = "PendSV"; 15 = "SysTick" }
+$deviceHeader = Join-Path $PSScriptRoot "Drivers/CMSIS/Device/ST/STM32N6xx/Include/stm32n657xx.h"
+if (Test-Path $deviceHeader) {
+    foreach ($m in [regex]::Matches((Get-Content $deviceHeader -Raw), '(\w+)_IRQn\s*=\s*(\d+)')) {
+        $exceptionNames[[int]$m.Groups[2].Value + 16] = $m.Groups[1].Value
+    }
+}
+function Get-ExceptionName {
+    param([int]$Number)
+    if ($exceptionNames.ContainsKey($Number)) { return $exceptionNames[$Number] }
+    return "exception$Number"
+}
+
+# Function symbols, sorted, for the PC lookups
+Write-Host "Reading the symbols of $Elf..." -ForegroundColor Cyan
+$symbolAddresses = New-Object System.Collections.Generic.List[uint32]
+$symbolEnds = New-Object System.Collections.Generic.List[uint64]
+$symbolNames = New-Object System.Collections.Generic.List[string]
+foreach ($line in & $Nm -n -S -C --defined-only $Elf) {
+    if ($line -match '^([0-9a-fA-F]+) (?:([0-9a-fA-F]+) )?[tTwW] (.+)$') {
+        $address = [Convert]::ToUInt32($Matches[1], 16)
+        $size = if ($Matches[2]) { [Convert]::ToUInt64($Matches[2], 16) } else { [uint64]1 }
+        $symbolAddresses.Add($address)
+        $symbolEnds.Add([uint64]$address + $size)
+        $symbolNames.Add($Matches[3])
+    }
+}
+if ($LASTEXITCODE -ne 0 -or $symbolAddresses.Count -eq 0) {
+    Write-Error "No function symbol read from $Elf"
+}
+$symbolArray = $symbolAddresses.ToArray()
+$symbolCache = @{}
+function Get-Symbol {
+    param([uint32]$Pc)
+    if ($symbolCache.ContainsKey($Pc)) { return $symbolCache[$Pc] }
+    $i = [array]::BinarySearch($symbolArray, $Pc)
+    if ($i -lt 0) { $i = (-bnot $i) - 1 }
+    $name = if ($i -ge 0 -and [uint64]$Pc -lt $symbolEnds[$i]) { $symbolNames[$i] } else { "0x{0:X8}" -f $Pc }
+    $symbolCache[$Pc] = $name
+    return $name
+}
+
+# Pass 1: packets, stamped by the local timestamp that follows them
+Write-Host "Decoding $Capture..." -ForegroundColor Cyan
+$data = [System.IO.File]::ReadAllBytes((Resolve-Path $Capture))
+$kinds = New-Object System.Collections.Generic.List[byte]
+$values = New-Object System.Collections.Generic.List[int64]
+$times = New-Object System.Collections.Generic.List[int64]
+$time = [int64]0
+$stamped = 0
+$zeros = 0
+$i = 0
+while ($i -lt $data.Length) {
+    $h = $data[$i++]
+    if ($h -eq 0x00) {
+        $zeros++
+        continue
+    }
+    if ($h -eq 0x80 -and $zeros -ge 5) {
+        # Synchronization
+        $zeros = 0
+        continue
+    }
+    $zeros = 0
+    if ($h -eq 0x70) {
+        $kinds.Add($KindOverflow); $values.Add(0); $times.Add($time)
+        continue
+    }
+    if (($h -band 0x03) -ne 0) {
+        # Source packet: 1, 2 or 4 payload bytes
+        $size = if (($h -band 0x03) -eq 3) { 4 } else { $h -band 0x03 }
+        if ($i + $size -gt $data.Length) { break }
+        $payload = [uint32]0
+        for ($b = 0; $b -lt $size; $b++) { $payload = $payload -bor ([uint32]$data[$i + $b] -shl (8 * $b)) }
+        $i += $size
+        $source = $h -shr 3
+        if (($h -band 0x04) -ne 0) {
+            if ($source -eq 1 -and $size -eq 2) {
+                $kinds.Add($KindException); $values.Add($payload); $times.Add($time)
+            } elseif ($source -eq 2) {
+                $kinds.Add($KindPc); $values.Add($(if ($size -eq 4) { $payload } else { -1 })); $times.Add($time)
+            }
+        } elseif ($source -eq $TracePort -and $size -eq 4) {
+            $kinds.Add($KindProbe); $values.Add($payload); $times.Add($time)
+        }
+        continue
+    }
+    if (($h -band 0x0F) -eq 0) {
+        # Local timestamp: the cycles since the previous one, applied to the
+        # packets in between
+        if (($h -band 0x80) -ne 0) {
+            $delta = [int64]0
+            for ($b = 0; $b -lt 4 -and $i -lt $data.Length; $b++) {
+                $c = $data[$i++]
+                $delta = $delta -bor ([int64]($c -band 0x7F) -shl (7 * $b))
+                if (($c -band 0x80) -eq 0) { break }
+            }
+        } else {
+            $delta = [int64](($h -shr 4) -band 0x07)
+        }
+        $time += $delta
+        for ($p = $stamped; $p -lt $times.Count; $p++) { $times[$p] = $time }
+        $stamped = $times.Count
+        continue
+    }
+    if ($h -eq 0x94 -or $h -eq 0xB4 -or (($h -band 0x0B) -eq 0x08 -and ($h -band 0x80) -ne 0)) {
+        # Global timestamp or extension: continuation bytes skipped
+        while ($i -lt $data.Length -and ($data[$i++] -band 0x80) -ne 0) { }
+    }
+}
+
+# Pass 2: the samples folded by context, the handler times
+$stacks = @{}
+$functions = @{}
+$handlers = @{}
+$active = New-Object System.Collections.Generic.List[object]
+$heldStart = [int64]-1
+$heldMax = [int64]0
+$windowDepth = 0
+$windowSeen = 0
+$windowCycles = [int64]0
+$windowStart = [int64]0
+$steadyStart = [int64]-1
+$samples = 0
+$profiled = 0
+$probes = 0
+$overflows = 0
+for ($p = 0; $p -lt $kinds.Count; $p++) {
+    $t = $times[$p]
+    $steady = ($Window -eq "") -or ($windowSeen -gt $SkipSlices)
+    switch ($kinds[$p]) {
+        $KindProbe {
+            $probes++
+            $word = [uint32]$values[$p]
+            if (($word -band 0xFF) -ne $windowId) { break }
+            $phase = ($word -shr 8) -band 0x03
+            if ($phase -eq 0) {
+                if ($windowDepth++ -eq 0) {
+                    $windowSeen++
+                    $windowStart = $t
+                }
+            } elseif ($phase -eq 1 -and $windowDepth -gt 0) {
+                if (--$windowDepth -eq 0 -and $windowSeen -gt $SkipSlices) {
+                    $windowCycles += $t - $windowStart
+                }
+            }
+        }
+        $KindPc {
+            $samples++
+            if (-not $steady -or ($Window -ne "" -and $windowDepth -eq 0)) { break }
+            $profiled++
+            $context = if ($active.Count -gt 0) { "irq:" + (Get-ExceptionName $active[$active.Count - 1][0]) } else { "thread" }
+            $function = if ($values[$p] -lt 0) { "(sleep)" } else { Get-Symbol ([uint32]$values[$p]) }
+            $stack = "$context;$function"
+            $stacks[$stack] = 1 + $(if ($stacks.ContainsKey($stack)) { $stacks[$stack] } else { 0 })
+            $functions[$function] = 1 + $(if ($functions.ContainsKey($function)) { $functions[$function] } else { 0 })
+        }
+        $KindException {
+            $number = [int]($values[$p] -band 0x1FF)
+            $fn = [int](($values[$p] -shr 12) -band 0x03)
+            if ($steady -and $steadyStart -lt 0) { $steadyStart = $t }
+            if ($fn -eq 1) {
+                if ($active.Count -eq 0) { $heldStart = $t }
+                $active.Add(@($number, $t))
+            } elseif ($fn -eq 2) {
+                if ($active.Count -gt 0 -and $active[$active.Count - 1][0] -eq $number) {
+                    $cycles = $t - $active[$active.Count - 1][1]
+                    $active.RemoveAt($active.Count - 1)
+                    if ($steady) {
+                        if (-not $handlers.ContainsKey($number)) { $handlers[$number] = @{ Count = 0; Cycles = [int64]0; Max = [int64]0 } }
+                        $handlers[$number].Count++
+                        $handlers[$number].Cycles += $cycles
+                        if ($cycles -gt $handlers[$number].Max) { $handlers[$number].Max = $cycles }
+                    }
+                }
+            } elseif ($fn -eq 3 -and $number -eq 0) {
+                # Back to thread mode: the end of the time threads were held off
+                if ($heldStart -ge 0 -and $steady -and $t - $heldStart -gt $heldMax) { $heldMax = $t - $heldStart }
+                $heldStart = -1
+                $active.Clear()
+            }
+        }
+        $KindOverflow {
+            # Packets lost: the handler nesting is unknown until thread mode
+            $overflows++
+            $active.Clear()
+            $heldStart = -1
+        }
+    }
+}
+
+function Format-Us { param([int64]$Cycles) "{0:N1}" -f ($Cycles * 1e6 / $CpuHz) }
+
+Write-Host "`n$($data.Length) bytes, $samples PC samples, $probes probe words, $overflows overflows" -ForegroundColor Green
+if ($Window -ne "") {
+    Write-Host "$Window slices: $windowSeen, $([Math]::Max($windowSeen - $SkipSlices, 0)) profiled over $(Format-Us $windowCycles) us"
+    if ($probes -eq 0) {
+        Write-Warning "No probe word on port ${TracePort}: build with SWO_TRACE_EVENTS, or set `$Window = `"`""
+    }
+}
+if ($profiled -eq 0) {
+    Write-Warning "No PC sample profiled"
+    return
+}
+
+Write-Host "`nTop functions ($profiled samples):" -ForegroundColor Cyan
+$functions.GetEnumerator() | Sort-Object Value -Descending | Select-Object -First $Top | ForEach-Object {
+    Write-Host ("{0,7} {1,6:N1}%  {2}" -f $_.Value, (100.0 * $_.Value / $profiled), $_.Key)
+}
+
+if ($handlers.Count -gt 0) {
+    $span = [Math]::Max($time - $steadyStart, 1)
+    Write-Host "`nHandlers (inclusive of the nested ones):" -ForegroundColor Cyan
+    Write-Host ("{0,-28} {1,8} {2,7} {3,10} {4,10}" -f "exception", "count", "load", "mean us", "max us")
+    $handlers.GetEnumerator() | Sort-Object { $_.Value.Cycles } -Descending | ForEach-Object {
+        Write-Host ("{0,-28} {1,8} {2,6:N2}% {3,10} {4,10}" -f (Get-ExceptionName $_.Key), $_.Value.Count,
+            (100.0 * $_.Value.Cycles / $span), (Format-Us ($_.Value.Cycles / $_.Value.Count)), (Format-Us $_.Value.Max))
+    }
+    Write-Host "Longest time threads were held off: $(Format-Us $heldMax) us"
+}
+
+$stacks.GetEnumerator() | Sort-Object Key | ForEach-Object { "$($_.Key) $($_.Value)" } | Set-Content -Path $Folded -Encoding ascii
+Write-Host "`nFolded stacks written to $Folded" -ForegroundColor Green
+if ($FlameGraph -ne "") {
+    $svg = [System.IO.Path]::ChangeExtension($Folded, ".svg")
+    & perl $FlameGraph --title "Cortex-M55, $Window" --countname samples $Folded | Set-Content -Path $svg -Encoding utf8
+    if ($LASTEXITCODE -ne 0) {
+        Write-Error "flamegraph.pl failed"
+    }
+    Write-Host "Flame graph written to $svg" -ForegroundColor Green
+}
@@ -0,0 +1,995 @@
+$ErrorActionPreference = "Stop"
+
+# ST-LINK virtual COM port of the board, at TELEMETRY_UART_BAUDRATE
+$Port = "COM3"
+$BaudRate = 921600
+# ETH_PUBLISH_PORT to read the Ethernet datagrams of every unit instead
+# (0: serial port)
+$UdpPort = 0
+# $Port is the CDC port of the USB device (USB_STREAM_ENABLE) instead:
+# records unencoded, sent while the port is open (DTR)
+$UsbCdc = $false
+# Image of the microSD card (SD_LOG) to decode instead, e.g. read raw with
+# dd: the whole log, oldest segment first ("": live stream)
+$SdImage = ""
+$SdFirstBlock = 2048
+# Records printed besides the console text and the system records
+$ShowResults = $true
+$ShowDetections = $false
+# Trace events (TRACE_ENABLE, TRACE_DRAIN) collected and written to this
+# Chrome trace JSON file on exit, for chrome://tracing or ui.perfetto.dev
+# ("": not collected)
+$TraceJson = ""
+# Debugger dump of the trace ring (TRACE_DRAIN 0) to export to $TraceJson
+# instead, e.g. (gdb) dump binary value trace.bin trace_ring
+$TraceDump = ""
+# PC sampler histograms (PC_PROFILER): requested every $PcProfileEverySec
+# seconds (0: once) on the serial or USB port, summed over the dumps,
+# symbolized from $Elf and written to this file on exit ("": not requested;
+# the dumps still decode, e.g. from $SdImage)
+$PcProfile = ""
+$PcProfileEverySec = 10
+$Elf = Join-Path $PSScriptRoot "Appli/build/Release/Firmware_Appli.elf"
+$Nm = "arm-none-eabi-nm"
+$PcProfileTop = 30
+# Runtime parameters (PARAMS_ENABLE), sent once on the serial or USB port:
+# $DefaultParams restores the built values first, then each of $SetParams
+# is set by name, e.g. @{ "pp.conf" = 0.5; "cam.fps" = 25 } or
+# @{ "power.profile" = "low-power" } (PROFILE_ENABLE), and
+# $StoreParams keeps the table in the octoFlash for the next boots. The
+# table is read back after any of them, or alone with $ShowParams
+$SetParams = @{}
+$DefaultParams = $false
+$StoreParams = $false
+$ShowParams = $false
+# Memory map and bandwidth budget (MEM_MAP_REPORT): requested on the serial
+# or USB port every $MemMapEverySec seconds (0: once) and printed as text;
+# each budget covers the time since the previous one
+$MemMap = $false
+$MemMapEverySec = 0
+# Preview thumbnail (PREVIEW_ENABLE): the tiles are applied to a local copy
+# and each complete thumbnail overwrites $PreviewFile, a binary PGM; the
+# first one is requested whole
+$PreviewFile = ""
+# Screenshot (SCREENSHOT_ENABLE): asked for once on connect; the unit
+# queues the screen as a JPEG for its snapshot consumer
+$Screenshot = $false
+# TraceX buffer (TRACEX): asked for once on connect and written to this
+# .trx file for Azure RTOS TraceX ("": not requested)
+$TraceX = ""
+# People analytics summaries (ANALYTICS_ENABLE) appended to this CSV file,
+# one row per interval ("": printed only)
+$AnalyticsCsv = ""
+# Console shell (SHELL_ENABLE) on the serial or USB port: each of
+# $ShellCommands is sent once on connect, e.g. @("stats", "mem"), and with
+# $Shell the lines typed here are sent on Enter; the answers print as text
+$Shell = $false
+$ShellCommands = @()
+
+# Record layout (Appli/Core/Inc/app_telemetry.h): 8-byte header, then the
+# payload; every record is COBS encoded and ends with a 0x00 delimiter
+$HeaderSize = 8
+$TypeText = 1
+$TypeResult = 2
+$TypeDetections = 3
+$TypeSystem = 4
+$TypeTrace = 5
+$TypePcProf = 6
+$TypeParams = 7
+$TypeIsr = 8
+$TypePreview = 9
+$TypeProfile = 10
+$TypeTraceX = 11
+$TypeAnalytics = 12
+$TypeThermal = 13
+$TypeNames = @("-", "text", "result", "detections", "system", "trace", "pcprof", "params", "isr", "preview", "profile", "tracex", "analytics", "thermal")
+# Performance profiles (Appli/Core/Inc/app_profile.h), by power.profile value
+$ProfileNames = @("max-fps", "balanced", "low-power")
+
+# Datagram layout (Appli/Core/Inc/app_eth.h): 12-byte unit header, then nb
+# records of 64 bytes each, unencoded
+$RecordSize = 64
+$PublishHeaderSize = 12
+$PublishMagic = 0x4D54364E
+
+# Card log layout (Appli/Core/Inc/app_sdlog.h): two 32-byte index copies in
+# the first two blocks, then segments of a 64-byte header and records of 64
+# bytes each, unencoded; FNV-1a check words
+$SdBlockSize = 512
+$SdIndexMagic = 0x4953364E
+$SdSegmentMagic = 0x4C53364E
+
+# Trace layout (Appli/Core/Inc/app_trace.h): 12-byte events; a trace record
+# holds up to 4 behind an 8-byte header, a ring dump 24 bytes of header then
+# the ring. Probe names from its table, track names from the thread
+# priorities (an event's tid is the priority + 1, 0 for interrupts)
+$TraceEventSize = 12
+$TraceRingMagic = 0x5254364E
+$script:TraceNames = @()
+$script:ThreadNames = @{ 0 = "interrupts"; 255 = "init" }
+$traceHeader = Join-Path $PSScriptRoot "Appli/Core/Inc/app_trace.h"
+if (Test-Path $traceHeader) {
+    foreach ($m in [regex]::Matches((Get-Content $traceHeader -Raw), 'X\((\w+), "([^"]+)"\)')) {
+        $script:TraceNames += $m.Groups[2].Value
+    }
+}
+foreach ($source in Get-ChildItem (Join-Path $PSScriptRoot "Appli/Core/Src/*.c") -ErrorAction SilentlyContinue) {
+    foreach ($m in [regex]::Matches((Get-Content $source.FullName -Raw), '#define (\w+)_THREAD_PRIORITY (\d+)')) {
+        $tid = [int]$m.Groups[2].Value + 1
+        $thread = $m.Groups[1].Value.ToLower()
+        $script:ThreadNames[$tid] = if ($script:ThreadNames.ContainsKey($tid)) { "$($script:ThreadNames[$tid])/$thread" } else { $thread }
+    }
+}
+# PC profile layout (Appli/Core/Inc/app_pcprof.h): 14-byte header, then
+# up to 7 entries of a 16-bit bucket and a 32-bit count; a request is one
+# byte on the port
+$PcProfEntrySize = 6
+$PcProfFlagLr = 0x01
+$PcProfFlagLast = 0x02
+$PcProfRequest = [byte][char]'P'
+# Parameter layout (Appli/Core/Inc/app_params.h): one 52-byte record per
+# parameter; ids and types from its table. A set is 'S', the id, the
+# 32-bit value and a check byte, 0xFF minus the sum of the five before it
+$ParamsSetByte = [byte][char]'S'
+$ParamsGetRequest = [byte][char]'G'
+$ParamsStoreRequest = [byte][char]'W'
+$ParamsDefaultsRequest = [byte][char]'D'
+$MemMapRequest = [byte][char]'M'
+# Preview layout (Appli/Core/Inc/app_preview.h): 8-byte header, then tiles
+# of a 16-bit number, a byte count and PackBits bytes for 32 tile bytes,
+# XORed over the local copy unless the number has bit 15 set
+$PreviewTileBytes = 32
+$PreviewTileWhole = 0x8000
+$PreviewFlagLast = 0x01
+$PreviewKeyRequest = [byte][char]'K'
+$ScreenshotRequest = [byte][char]'C'
+# TraceX layout (Appli/Core/Inc/app_tracex.h): 12-byte header, then up to
+# 44 bytes of the buffer at its offset
+$TraceXFlagLast = 0x01
+$TraceXRequest = [byte][char]'X'
+# Shell line (Appli/Core/Inc/app_shell.h): '>', then at most 47 characters
+# and a line feed
+$ShellByte = [byte][char]'>'
+$ShellLineMax = 47
+$ParamsFlagKeep = 0x01
+$ParamsFlagRejected = 0x02
+$ParamsFlagDirty = 0x04
+$ParamsFlagStored = 0x08
+$script:ParamIds = @{}
+$script:ParamTypes = @{}
+$paramsHeader = Join-Path $PSScriptRoot "Appli/Core/Inc/app_params.h"
+if (Test-Path $paramsHeader) {
+    foreach ($m in [regex]::Matches((Get-Content $paramsHeader -Raw), 'X\((\w+), "([^"]+)", PARAM_TYPE_(\w+)')) {
+        $script:ParamTypes[$m.Groups[2].Value] = $m.Groups[3].Value
+        $script:ParamIds[$m.Groups[2].Value] = $script:ParamIds.Count
+    }
+}
+$script:PcHist = @{}
+$script:PreviewTiles = @{}
+$script:TraceXBuffer = $null
+$script:LrHist = @{}
+$script:PcDumps = @{}
+$script:TraceEvents = New-Object System.Collections.Generic.List[string]
+$script:TraceTids = @{}
+$script:TraceEpochUs = [int64]0
+$script:TraceLastUs = [int64]-1
+
+# Function to undo the COBS encoding of one frame (delimiter stripped)
+function ConvertFrom-Cobs {
+    param([byte[]]$Frame)
+
+    $out = New-Object System.Collections.Generic.List[byte]
+    $i = 0
+    while ($i -lt $Frame.Length) {
+        $code = $Frame[$i]
+        if ($code -eq 0 -or $i + $code -gt $Frame.Length + 1) {
+            return $null
+        }
+        for ($j = 1; $j -lt $code; $j++) {
+            $out.Add($Frame[$i + $j])
+        }
+        $i += $code
+        if ($code -ne 0xFF -and $i -lt $Frame.Length) {
+            $out.Add(0)
+        }
+    }
+    return ,$out.ToArray()
+}
+
+function Get-U16 { param([byte[]]$Data, [int]$Offset) [BitConverter]::ToUInt16($Data, $Offset) }
+function Get-U32 { param([byte[]]$Data, [int]$Offset) [BitConverter]::ToUInt32($Data, $Offset) }
+
+# Function to compute the check word of a byte range
+function Get-Fnv1a {
+    param([byte[]]$Data, [int]$Offset, [int]$Length)
+
+    # UInt64 throughout: mixed signed operands would go through Double
+    [uint64]$hash = 2166136261
+    [uint64]$prime = 16777619
+    [uint64]$modulus = 4294967296
+    for ($i = $Offset; $i -lt $Offset + $Length; $i++) {
+        $hash = (($hash -bxor [uint64]$Data[$i]) * $prime) % $modulus
+    }
+    return [uint32]$hash
+}
+
+$script:LastSeq = -1
+$script:Line = New-Object System.Text.StringBuilder
+
+# Function to add one trace event at its time on the host timeline
+function Add-TraceEvent {
+    param([byte[]]$Data, [int]$Offset, [double]$TimeUs)
+
+    $id = $Data[$Offset + 8]
+    $phase = [char]$Data[$Offset + 9]
+    $tid = [int]$Data[$Offset + 10]
+    $value = [BitConverter]::ToInt32($Data, $Offset + 4)
+    $name = if ($id -lt $script:TraceNames.Count) { $script:TraceNames[$id] } else { "probe.$id" }
+    $head = '{{"name":"{0}","cat":"{1}","ph":"{2}","ts":{3},"pid":1,"tid":{4}' -f $name, $name.Split('.')[0], $phase,
+        $TimeUs.ToString("F3", [System.Globalization.CultureInfo]::InvariantCulture), $tid
+
+    $script:TraceTids[$tid] = $true
+    switch ($phase) {
+        'C' { $script:TraceEvents.Add($head + ',"args":{"value":' + $value + '}}') }
+        'i' { $script:TraceEvents.Add($head + ',"s":"t","args":{"arg":' + $value + '}}') }
+        'B' { $script:TraceEvents.Add($head + ',"args":{"arg":' + $value + '}}') }
+        default { $script:TraceEvents.Add($head + '}') }
+    }
+}
+
+# Function to write the collected trace events out as Chrome trace JSON
+function Save-Trace {
+    if ($TraceJson -eq "" -or $script:TraceEvents.Count -eq 0) {
+        return
+    }
+    $lines = New-Object System.Collections.Generic.List[string]
+    foreach ($tid in $script:TraceTids.Keys) {
+        $track = if ($script:ThreadNames.ContainsKey($tid)) { $script:ThreadNames[$tid] } else { "priority $($tid - 1)" }
+        $lines.Add('{"name":"thread_name","ph":"M","pid":1,"tid":' + $tid + ',"args":{"name":"' + $track + '"}}')
+    }
+    $lines.AddRange($script:TraceEvents)
+    $json = '{"traceEvents":[' + "`n" + ($lines -join ",`n") + "`n" + '],"displayTimeUnit":"ns"}'
+    [System.IO.File]::WriteAllText([System.IO.Path]::GetFullPath($TraceJson), $json)
+    Write-Host "telemetry: $($script:TraceEvents.Count) trace events written to $TraceJson" -ForegroundColor Cyan
+}
+
+# Function to write the summed PC sampler histograms out, by function
+function Save-PcProfile {
+    if ($PcProfile -eq "" -or $script:PcDumps.Count -eq 0) {
+        return
+    }
+    # Function symbols, sorted: a bucket goes to the one holding its start.
+    # The ITCM code is counted at its load image: its symbols move there
+    $addresses = New-Object System.Collections.Generic.List[uint32]
+    $names = New-Object System.Collections.Generic.List[string]
+    $layout = @{}
+    $nmLines = & $Nm -n -C --defined-only $Elf
+    foreach ($line in $nmLines) {
+        if ($line -match '^([0-9a-fA-F]+) \w (__itcm_start|__itcm_end|__itcm_load)$') {
+            $layout[$Matches[2]] = [Convert]::ToUInt32($Matches[1], 16)
+        }
+    }
+    foreach ($line in $nmLines) {
+        if ($line -match '^([0-9a-fA-F]+) [tTwW] (.+)$') {
+            $address = [Convert]::ToUInt32($Matches[1], 16)
+            if ($layout.Count -eq 3 -and $address -ge $layout["__itcm_start"] -and $address -lt $layout["__itcm_end"]) {
+                $address = [uint32]($address - $layout["__itcm_start"] + $layout["__itcm_load"])
+            }
+            $addresses.Add($address)
+            $names.Add($Matches[2])
+        }
+    }
+    $symbols = $addresses.ToArray()
+    $symbolNames = $names.ToArray()
+    [array]::Sort($symbols, $symbolNames)
+    $samples = [int64]0
+    foreach ($n in $script:PcDumps.Values) { $samples += $n }
+    $lines = New-Object System.Collections.Generic.List[string]
+    $lines.Add("$samples samples in $($script:PcDumps.Count) dumps, symbols of $Elf")
+
+    foreach ($table in @(@("PC (self)", $script:PcHist), @("LR (callers)", $script:LrHist))) {
+        $byFunction = @{}
+        $inside = [int64]0
+        foreach ($address in $table[1].Keys) {
+            $i = [array]::BinarySearch($symbols, [uint32]$address)
+            if ($i -lt 0) { $i = (-bnot $i) - 1 }
+            $name = if ($i -ge 0) { $symbolNames[$i] } else { "0x{0:X8}" -f $address }
+            $byFunction[$name] = $table[1][$address] + $(if ($byFunction.ContainsKey($name)) { $byFunction[$name] } else { 0 })
+            $inside += $table[1][$address]
+        }
+        $lines.Add("")
+        $lines.Add("$($table[0]): $($samples - $inside) samples outside the application code")
+        $byFunction.GetEnumerator() | Sort-Object Value -Descending | ForEach-Object {
+            $lines.Add(("{0,9} {1,6:N2}%  {2}" -f $_.Value, (100.0 * $_.Value / [Math]::Max($samples, 1)), $_.Key))
+        }
+    }
+    Set-Content -Path $PcProfile -Value $lines -Encoding ascii
+    $lines | Select-Object -First ($PcProfileTop + 2) | ForEach-Object { Write-Host $_ }
+    Write-Host "telemetry: PC profile written to $PcProfile" -ForegroundColor Cyan
+}
+
+# Function to print one decoded record
+function Show-Record {
+    param([byte[]]$Record)
+
+    if ($Record.Length -lt $HeaderSize -or $Record.Length -ne $HeaderSize + $Record[1]) {
+        Write-Host "telemetry: malformed record ($($Record.Length) bytes)" -ForegroundColor Yellow
+        return
+    }
+    $type = $Record[0]
+    $seq = Get-U16 $Record 2
+    $timeUs = Get-U32 $Record 4
+    $p = $HeaderSize
+
+    if ($script:LastSeq -ge 0) {
+        $gap = ($seq - $script:LastSeq - 1) -band 0xFFFF
+        if ($gap -ne 0) {
+            Write-Host "telemetry: $gap records dropped" -ForegroundColor Yellow
+        }
+    }
+    $script:LastSeq = $seq
+
+    switch ($type) {
+        $TypeText {
+            # Console lines arrive in chunks: print whole lines
+            $text = [System.Text.Encoding]::ASCII.GetString($Record, $p, $Record[1])
+            foreach ($c in $text.ToCharArray()) {
+                if ($c -eq "`n") {
+                    Write-Host $script:Line.ToString()
+                    [void]$script:Line.Clear()
+                } elseif ($c -ne "`r") {
+                    [void]$script:Line.Append($c)
+                }
+            }
+        }
+        $TypeResult {
+            if ($ShowResults) {
+                Write-Host ("[{0,10} us] result frame {1} #{2} net {3}: {4} det at conf {10:N2}, vsync->npu {5} us, npu {6} us, pp {7} us, vsync->result {8} us, period {9} us" -f
+                    $timeUs, (Get-U32 $Record $p), (Get-U32 $Record ($p + 4)), $Record[$p + 30],
+                    (Get-U16 $Record ($p + 28)), (Get-U32 $Record ($p + 8)), (Get-U32 $Record ($p + 12)),
+                    (Get-U32 $Record ($p + 16)), (Get-U32 $Record ($p + 20)), (Get-U32 $Record ($p + 24)),
+                    ($Record[$p + 31] / 255.0))
+                if ($Record.Length -gt $p + 32 -and $Record[$p + 32] -ne 0) {
+                    Write-Host ("[{0,10} us] result frame {1} from stream {2}" -f
+                        $timeUs, (Get-U32 $Record $p), $Record[$p + 32])
+                }
+            }
+        }
+        $TypeDetections {
+            if ($ShowDetections) {
+                $first = $Record[$p + 4]
+                $nb = $Record[$p + 5]
+                for ($k = 0; $k -lt $nb; $k++) {
+                    $b = $p + 8 + 10 * $k
+                    Write-Host ("[{0,10} us] det frame {1} {2}/{3}: class {4} conf {5:N2} at ({6:N3}, {7:N3}) size {8:N3} x {9:N3}" -f
+                        $timeUs, (Get-U32 $Record $p), ($first + $k + 1), $Record[$p + 6], $Record[$b + 9],
+                        ($Record[$b + 8] / 255.0), ((Get-U16 $Record $b) / 65535.0), ((Get-U16 $Record ($b + 2)) / 65535.0),
+                        ((Get-U16 $Record ($b + 4)) / 65535.0), ((Get-U16 $Record ($b + 6)) / 65535.0))
+                }
+            }
+        }
+        $TypeTrace {
+            if ($TraceJson -ne "") {
+                # Record time and drain_cycles are one instant: events are
+                # placed back from it. time_us wraps after 71 minutes
+                if ($script:TraceLastUs -ge 0 -and $timeUs -lt $script:TraceLastUs - 2147483648) {
+                    $script:TraceEpochUs += 4294967296
+                }
+                $script:TraceLastUs = $timeUs
+                $nb = $Record[$p]
+                $mhz = Get-U16 $Record ($p + 2)
+                [int64]$drainCycles = Get-U32 $Record ($p + 4)
+                if ($Record[$p + 1] -ne 0) {
+                    Write-Host "telemetry: $($Record[$p + 1]) trace events dropped" -ForegroundColor Yellow
+                }
+                for ($k = 0; $k -lt $nb; $k++) {
+                    $o = $p + 8 + $TraceEventSize * $k
+                    $age = ($drainCycles - [int64](Get-U32 $Record $o) + 4294967296) % 4294967296
+                    Add-TraceEvent $Record $o ($script:TraceEpochUs + $timeUs - $age / $mhz)
+                }
+            }
+        }
+        $TypePcProf {
+            # Summed by bucket address: dumps and bucket sizes may differ
+            $dump = Get-U16 $Record $p
+            $nb = $Record[$p + 2]
+            $flags = $Record[$p + 3]
+            [int64]$base = Get-U32 $Record ($p + 4)
+            $shift = $Record[$p + 12]
+            $hist = if ($flags -band $PcProfFlagLr) { $script:LrHist } else { $script:PcHist }
+            $script:PcDumps[$dump] = Get-U32 $Record ($p + 8)
+            for ($k = 0; $k -lt $nb; $k++) {
+                $o = $p + 14 + $PcProfEntrySize * $k
+                $address = $base + ([int64](Get-U16 $Record $o) -shl $shift)
+                $hist[$address] = (Get-U32 $Record ($o + 2)) + $(if ($hist.ContainsKey($address)) { $hist[$address] } else { 0 })
+            }
+            if ($flags -band $PcProfFlagLast) {
+                Write-Host ("[{0,10} us] PC profile dump {1}: {2} samples, {3}-byte buckets" -f
+                    $timeUs, $dump, $script:PcDumps[$dump], (1 -shl $shift)) -ForegroundColor Cyan
+            }
+        }
+        $TypePreview {
+            $thumb = Get-U16 $Record $p
+            $nb = $Record[$p + 2]
+            $flags = $Record[$p + 3]
+            $bits = $Record[$p + 4]
+            $tilesX = $Record[$p + 5]
+            $tilesY = $Record[$p + 6]
+            $o = $p + 8
+            for ($k = 0; $k -lt $nb; $k++) {
+                $number = Get-U16 $Record $o
+                $end = $o + 3 + $Record[$o + 2]
+                $o += 3
+                $bytes = New-Object System.Collections.Generic.List[byte]
+                while ($o -lt $end) {
+                    $c = $Record[$o++]
+                    if ($c -lt 0x80) {
+                        $bytes.AddRange([byte[]]$Record[$o..($o + $c)])
+                        $o += $c + 1
+                    } else {
+                        $bytes.AddRange([byte[]](@($Record[$o]) * ($c - 0x7E)))
+                        $o++
+                    }
+                }
+                $tile = $number -band ($PreviewTileWhole - 1)
+                if (-not ($number -band $PreviewTileWhole) -and $script:PreviewTiles.ContainsKey($tile)) {
+                    for ($b = 0; $b -lt $PreviewTileBytes; $b++) {
+                        $bytes[$b] = $bytes[$b] -bxor $script:PreviewTiles[$tile][$b]
+                    }
+                }
+                $script:PreviewTiles[$tile] = $bytes.ToArray()
+            }
+            if (($flags -band $PreviewFlagLast) -and $PreviewFile -ne "") {
+                # Tiles: 8 pixels wide, their lines in order, the left pixel
+                # in the high nibble at 4 bits
+                $tileHeight = $PreviewTileBytes * 8 / (8 * $bits)
+                $width = $tilesX * 8
+                $height = $tilesY * $tileHeight
+                $pixels = New-Object byte[] ($width * $height)
+                foreach ($tile in $script:PreviewTiles.Keys) {
+                    $x0 = ($tile % $tilesX) * 8
+                    $y0 = [Math]::Floor($tile / $tilesX) * $tileHeight
+                    for ($i = 0; $i -lt 8 * $tileHeight; $i++) {
+                        $level = if ($bits -eq 4) { (($script:PreviewTiles[$tile][$i -shr 1] -shr (4 * (1 - ($i -band 1)))) -band 0x0F) * 17 } else { $script:PreviewTiles[$tile][$i] }
+                        $pixels[($y0 + [Math]::Floor($i / 8)) * $width + $x0 + $i % 8] = $level
+                    }
+                }
+                $pgm = [System.Text.Encoding]::ASCII.GetBytes("P5`n$width $height`n255`n")
+                [System.IO.File]::WriteAllBytes($PreviewFile, [byte[]]($pgm + $pixels))
+                Write-Host ("[{0,10} us] preview {1}: {2}x{3} written to {4}" -f $timeUs, $thumb, $width, $height, $PreviewFile) -ForegroundColor Cyan
+            }
+        }
+        $TypeParams {
+            $float = $Record[$p + 6] -eq 1
+            $flags = $Record[$p + 7]
+            $values = @()
+            for ($k = 0; $k -lt 5; $k++) {
+                $values += if ($float) { [BitConverter]::ToSingle($Record, $p + 8 + 4 * $k) } else { [BitConverter]::ToInt32($Record, $p + 8 + 4 * $k) }
+            }
+            $name = [System.Text.Encoding]::ASCII.GetString($Record, $p + 28, 24).TrimEnd([char]0)
+            $notes = @("{0} to {1}" -f $values[1], $values[2])
+            if ($values[3] -ne 0) {
+                $notes += "step $($values[3])"
+            }
+            $notes += "default $($values[4])"
+            if ($flags -band $ParamsFlagKeep) {
+                $notes += "0 as built"
+            }
+            if ($flags -band $ParamsFlagDirty) {
+                $notes += "not stored"
+            }
+            Write-Host ("[{0,10} us] param {1} = {2} ({3})" -f $timeUs, $name, $values[0], ($notes -join ", ")) -ForegroundColor Cyan
+            if ($flags -band $ParamsFlagRejected) {
+                Write-Host "telemetry: $name refused the last value set" -ForegroundColor Yellow
+            }
+        }
+        $TypeIsr {
+            # isrprof_record_t (app_isrprof.h): one handler over a stats period
+            $count = Get-U32 $Record ($p + 4)
+            if ($count -ne 0) {
+                $mhz = [Math]::Max(1, (Get-U16 $Record ($p + 2)))
+                $irq = @("dcmipp", "csi", "ltdc_lo", "ltdc_up", "npu")[$Record[$p]]
+                $notes = @(("max {0:N1} us" -f ((Get-U32 $Record ($p + 8)) / $mhz)),
+                    ("self avg {0:N2} us" -f ((Get-U32 $Record ($p + 12)) / $mhz / $count)))
+                $latencyNb = Get-U16 $Record ($p + 28)
+                if ($latencyNb -ne 0) {
+                    $notes += "latency avg {0:N2} max {1:N2} us" -f ((Get-U32 $Record ($p + 20)) / $mhz / $latencyNb),
+                        ((Get-U32 $Record ($p + 16)) / $mhz)
+                }
+                $notes += "preempted $(Get-U16 $Record ($p + 24)), nested $(Get-U16 $Record ($p + 26)), depth $($Record[$p + 1])"
+                # Self time buckets by upper bound, the last one open ended
+                $hist = @()
+                for ($k = 0; $k -lt 13; $k++) {
+                    $n = Get-U16 $Record ($p + 30 + 2 * $k)
+                    if ($n -ne 0) {
+                        $bound = if ($k -eq 12) { ">=" + (1 -shl 18) } else { "<" + (1 -shl (7 + $k)) }
+                        $hist += "$bound $n"
+                    }
+                }
+                Write-Host ("[{0,10} us] isr {1}: {2} runs, {3}; self cycles {4}" -f
+                    $timeUs, $irq, $count, ($notes -join ", "), ($hist -join " ")) -ForegroundColor DarkCyan
+            }
+        }
+        $TypeSystem {
+            $fps = (Get-U16 $Record ($p + 4)) / 10.0
+            $dropped = @()
+            for ($t = 1; $t -lt $TypeNames.Length; $t++) {
+                $dropped += "$($TypeNames[$t]) $(Get-U16 $Record ($p + 10 + 2 * $t))"
+            }
+            $opp = switch ($Record[$p + 7]) { 0 { ", nominal" } 1 { ", overdrive" } default { "" } }
+            Write-Host ("[{0,10} us] system up {1} ms, {2:N1} fps, cpu {3}%{4}, sent {5}, dropped: {6}" -f
+                $timeUs, (Get-U32 $Record $p), $fps, $Record[$p + 6], $opp, (Get-U32 $Record ($p + 8)), ($dropped -join ", "))
+        }
+        $TypeProfile {
+            $active = $Record[$p]
+            $opp = if ($Record[$p + 2] -eq 1) { "overdrive" } else { "nominal" }
+            $profiles = @()
+            for ($k = 0; $k -lt $Record[$p + 1]; $k++) {
+                $o = $p + 8 + 8 * $k
+                $name = if ($k -lt $ProfileNames.Length) { $ProfileNames[$k] } else { "profile $k" }
+                if ((Get-U16 $Record $o) -eq 0) {
+                    $profiles += "$name -"
+                    continue
+                }
+                $profiles += ("{0} {1:N1} fps ~{2} mW {3} s" -f $name, ((Get-U16 $Record $o) / 10.0),
+                    (Get-U16 $Record ($o + 2)), [Math]::Floor((Get-U32 $Record ($o + 4)) / 1000))
+            }
+            $activeName = if ($active -lt $ProfileNames.Length) { $ProfileNames[$active] } else { "profile $active" }
+            Write-Host ("[{0,10} us] profile {1}: {2}, sensor {3} fps, 1/{4} inferred, {5} switches; {6}" -f
+                $timeUs, $activeName, $opp, (Get-U16 $Record ($p + 4)), $Record[$p + 3], (Get-U16 $Record ($p + 6)),
+                ($profiles -join ", ")) -ForegroundColor DarkGreen
+        }
+        $TypeTraceX {
+            $dump = Get-U16 $Record $p
+            $nb = $Record[$p + 2]
+            $flags = $Record[$p + 3]
+            $offset = Get-U32 $Record ($p + 4)
+            $size = Get-U32 $Record ($p + 8)
+            if ($null -eq $script:TraceXBuffer -or $script:TraceXBuffer.Length -ne $size) {
+                $script:TraceXBuffer = New-Object byte[] $size
+            }
+            [Array]::Copy($Record, $p + 12, $script:TraceXBuffer, $offset, $nb)
+            if (($flags -band $TraceXFlagLast) -and $TraceX -ne "") {
+                [System.IO.File]::WriteAllBytes($TraceX, $script:TraceXBuffer)
+                Write-Host ("[{0,10} us] TraceX dump {1}: {2} bytes to {3}" -f $timeUs, $dump, $size, $TraceX) -ForegroundColor Cyan
+            }
+        }
+        $TypeAnalytics {
+            # analytics_record_t (app_analytics.h): one interval; times in 0.1 s
+            $interval = Get-U32 $Record $p
+            $periodMs = Get-U16 $Record ($p + 4)
+            $nbLines = $Record[$p + 6]
+            $nbZones = $Record[$p + 7]
+            $newTracks = Get-U16 $Record ($p + 8)
+            $leftTracks = Get-U16 $Record ($p + 10)
+            $dwellMean = (Get-U16 $Record ($p + 12)) / 10.0
+            $dwellMax = (Get-U16 $Record ($p + 14)) / 10.0
+            $present = $Record[$p + 16]
+            $peak = $Record[$p + 17]
+            $updateNs = Get-U16 $Record ($p + 18)
+            $lines = @()
+            $zones = @()
+            $row = @($interval, $periodMs, $newTracks, $leftTracks, $present, $peak, $dwellMean, $dwellMax, $updateNs)
+            for ($k = 0; $k -lt $nbLines; $k++) {
+                $in = Get-U16 $Record ($p + 20 + 2 * $k)
+                $out = Get-U16 $Record ($p + 28 + 2 * $k)
+                $lines += "line$k in $in out $out"
+                $row += $in, $out
+            }
+            for ($k = 0; $k -lt $nbZones; $k++) {
+                $o = $p + 36 + 6 * $k
+                $entries = Get-U16 $Record $o
+                $occupancy = (Get-U16 $Record ($o + 2)) / 10.0
+                $zoneDwell = (Get-U16 $Record ($o + 4)) / 10.0
+                $zones += "zone$k $entries in, $occupancy s, dwell $zoneDwell s"
+                $row += $entries, $occupancy, $zoneDwell
+            }
+            Write-Host ("[{0,10} us] analytics {1} ({2} ms): {3} new, {4} left, {5} present (peak {6}), dwell {7}/{8} s; {9}; {10}; update max {11} ns" -f
+                $timeUs, $interval, $periodMs, $newTracks, $leftTracks, $present, $peak, $dwellMean, $dwellMax,
+                ($lines -join ", "), ($zones -join ", "), $updateNs) -ForegroundColor Green
+            if ($AnalyticsCsv -ne "") {
+                if (-not (Test-Path $AnalyticsCsv)) {
+                    $header = @("interval", "period_ms", "new", "left", "present", "peak", "dwell_mean_s", "dwell_max_s", "update_max_ns")
+                    for ($k = 0; $k -lt $nbLines; $k++) {
+                        $header += "line${k}_in", "line${k}_out"
+                    }
+                    for ($k = 0; $k -lt $nbZones; $k++) {
+                        $header += "zone${k}_entries", "zone${k}_occupancy_s", "zone${k}_dwell_mean_s"
+                    }
+                    Set-Content -Path $AnalyticsCsv -Value ($header -join ",")
+                }
+                Add-Content -Path $AnalyticsCsv -Value ($row -join ",")
+            }
+        }
+        $TypeThermal {
+            # thermal_record_t (app_thermal.h): temperatures in 0.1 C, -32768: none read
+            $temp = [BitConverter]::ToInt16($Record, $p)
+            $max = [BitConverter]::ToInt16($Record, $p + 2)
+            $limit = [BitConverter]::ToInt16($Record, $p + 4)
+            $floor = $Record[$p + 6]
+            $tempText = if ($temp -eq -32768) { "-" } else { "{0:N1} C" -f ($temp / 10.0) }
+            $maxText = if ($max -eq -32768) { "-" } else { "{0:N1} C" -f ($max / 10.0) }
+            $floorText = if ($floor -eq 0) { "not throttled" } elseif ($floor -lt $ProfileNames.Length) { "held at $($ProfileNames[$floor])" } else { "floor $floor" }
+            Write-Host ("[{0,10} us] thermal {1} (max {2}, limit {3:N0} C): {4}, {5} steps, {6} s throttled, {7} faults" -f
+                $timeUs, $tempText, $maxText, ($limit / 10.0), $floorText, (Get-U16 $Record ($p + 7)),
+                [Math]::Floor((Get-U32 $Record ($p + 11)) / 1000), (Get-U16 $Record ($p + 9))) -ForegroundColor $(if ($floor -eq 0) { "DarkGreen" } else { "Yellow" })
+        }
+        default {
+            Write-Host "telemetry: unknown record type $type" -ForegroundColor Yellow
+        }
+    }
+}
+
+if ($TraceDump -ne "") {
+    # Latest events of the ring, oldest first, on a timeline starting at 0
+    $dump = [System.IO.File]::ReadAllBytes($TraceDump)
+    if ($dump.Length -lt 24 -or (Get-U32 $dump 0) -ne $TraceRingMagic) {
+        Write-Host "telemetry: $TraceDump is not a trace ring dump" -ForegroundColor Red
+        return
+    }
+    [int64]$head = Get-U32 $dump 4
+    [int64]$nbEvents = Get-U32 $dump 20
+    $mhz = (Get-U32 $dump 16) / 1000000.0
+    [int64]$cycles = -1
+    for ($n = [Math]::Max(0, $head - $nbEvents); $n -lt $head; $n++) {
+        $o = 24 + ($n % $nbEvents) * $TraceEventSize
+        # An event outwritten or not finished at the halt has another lap
+        if ($o + $TraceEventSize -gt $dump.Length -or $dump[$o + 11] -ne ((([int64][Math]::Floor($n / $nbEvents)) + 1) % 256)) {
+            continue
+        }
+        [int64]$c = Get-U32 $dump $o
+        if ($cycles -lt 0) {
+            [int64]$last = $c
+            $cycles = 0
+        }
+        # Signed 32-bit steps: preempted stamps may go slightly back
+        $step = ($c - $last + 4294967296) % 4294967296
+        if ($step -ge 2147483648) {
+            $step -= 4294967296
+        }
+        $cycles += $step
+        $last = $c
+        Add-TraceEvent $dump $o ($cycles / $mhz)
+    }
+    Save-Trace
+    return
+}
+
+if ($SdImage -ne "") {
+    $image = [System.IO.File]::OpenRead($SdImage)
+    try {
+        $blocks = New-Object byte[] (2 * $SdBlockSize)
+        [void]$image.Seek([int64]$SdFirstBlock * $SdBlockSize, [System.IO.SeekOrigin]::Begin)
+        [void]$image.Read($blocks, 0, $blocks.Length)
+
+        # The valid index copy with the highest generation: a torn one fails its check
+        $index = -1
+        foreach ($o in 0, $SdBlockSize) {
+            if ((Get-U32 $blocks $o) -ne $SdIndexMagic -or (Get-U32 $blocks ($o + 28)) -ne (Get-Fnv1a $blocks $o 28)) {
+                continue
+            }
+            if ($index -lt 0 -or (Get-U32 $blocks ($o + 8)) -gt (Get-U32 $blocks ($index + 8))) {
+                $index = $o
+            }
+        }
+        if ($index -lt 0) {
+            Write-Host "telemetry: no log in $SdImage at block $SdFirstBlock" -ForegroundColor Red
+            return
+        }
+        $segmentSize = (Get-U16 $blocks ($index + 6)) * $SdBlockSize
+        [int64]$segments = Get-U32 $blocks ($index + 12)
+        [int64]$capacity = Get-U32 $blocks ($index + 16)
+        $dataOffset = [int64]$SdFirstBlock * $SdBlockSize + $segmentSize
+        $first = [Math]::Max(0, $segments - $capacity)
+        Write-Host "Reading $($segments - $first) segments of $SdImage, $(Get-U32 $blocks ($index + 20)) boots" -ForegroundColor Cyan
+
+        $segment = New-Object byte[] $segmentSize
+        $lastBoot = -1
+        for ($n = $first; $n -lt $segments; $n++) {
+            [void]$image.Seek($dataOffset + ($n % $capacity) * $segmentSize, [System.IO.SeekOrigin]::Begin)
+            [void]$image.Read($segment, 0, $segmentSize)
+            $nb = Get-U16 $segment 16
+            if ((Get-U32 $segment 0) -ne $SdSegmentMagic -or (Get-U32 $segment 4) -ne $n -or
+                ($nb + 1) * $RecordSize -gt $segmentSize -or
+                (Get-U32 $segment 20) -ne (Get-Fnv1a $segment $RecordSize ($nb * $RecordSize))) {
+                Write-Host "telemetry: segment $n corrupt, skipped" -ForegroundColor Yellow
+                continue
+            }
+            # Record numbering restarts with each boot
+            $boot = Get-U32 $segment 8
+            if ($boot -ne $lastBoot) {
+                Write-Host "telemetry: boot $boot" -ForegroundColor Cyan
+                $script:LastSeq = -1
+                $lastBoot = $boot
+            }
+            for ($k = 1; $k -le $nb; $k++) {
+                $o = $k * $RecordSize
+                $len = [Math]::Min($HeaderSize + $segment[$o + 1], $RecordSize)
+                $record = New-Object byte[] $len
+                [Array]::Copy($segment, $o, $record, 0, $len)
+                Show-Record $record
+            }
+        }
+    } finally {
+        $image.Close()
+        Save-Trace
+        Save-PcProfile
+    }
+    return
+}
+
+if ($UdpPort -ne 0) {
+    $udp = New-Object System.Net.Sockets.UdpClient $UdpPort
+    $from = New-Object System.Net.IPEndPoint ([System.Net.IPAddress]::Any), 0
+    $units = @{}
+    Write-Host "Reading telemetry datagrams on UDP port $UdpPort (Ctrl+C to stop)" -ForegroundColor Cyan
+
+    try {
+        while ($true) {
+            $datagram = $udp.Receive([ref]$from)
+            if ($datagram.Length -lt $PublishHeaderSize -or (Get-U32 $datagram 0) -ne $PublishMagic) {
+                continue
+            }
+            $unit = "{0:X8}" -f (Get-U32 $datagram 4)
+            $nb = $datagram[11]
+            if ($datagram.Length -lt $PublishHeaderSize + $nb * $RecordSize) {
+                Write-Host "telemetry: short datagram from $unit" -ForegroundColor Yellow
+                continue
+            }
+            if (-not $units.ContainsKey($unit)) {
+                Write-Host "telemetry: unit $unit at $($from.Address)" -ForegroundColor Cyan
+                $units[$unit] = -1
+            }
+            # Drops are counted per unit
+            $script:LastSeq = $units[$unit]
+            for ($k = 0; $k -lt $nb; $k++) {
+                $o = $PublishHeaderSize + $k * $RecordSize
+                $len = [Math]::Min($HeaderSize + $datagram[$o + 1], $RecordSize)
+                $record = New-Object byte[] $len
+                [Array]::Copy($datagram, $o, $record, 0, $len)
+                Show-Record $record
+            }
+            $units[$unit] = $script:LastSeq
+        }
+    } finally {
+        $udp.Close()
+        Save-Trace
+        Save-PcProfile
+    }
+    return
+}
+
+$serial = New-Object System.IO.Ports.SerialPort $Port, $BaudRate, ([System.IO.Ports.Parity]::None), 8, ([System.IO.Ports.StopBits]::One)
+$serial.ReadTimeout = 500
+$script:PcRequestTimer = $null
+
+# Function to ask for a PC profile dump when one is due
+function Send-PcRequest {
+    if ($PcProfile -eq "") {
+        return
+    }
+    if ($null -ne $script:PcRequestTimer -and ($PcProfileEverySec -eq 0 -or $script:PcRequestTimer.Elapsed.TotalSeconds -lt $PcProfileEverySec)) {
+        return
+    }
+    $serial.Write([byte[]]@($PcProfRequest), 0, 1)
+    $script:PcRequestTimer = [System.Diagnostics.Stopwatch]::StartNew()
+}
+
+$script:MemMapTimer = $null
+
+# Function to ask for a memory map when one is due
+function Send-MemMapRequest {
+    if (-not $MemMap) {
+        return
+    }
+    if ($null -ne $script:MemMapTimer -and ($MemMapEverySec -eq 0 -or $script:MemMapTimer.Elapsed.TotalSeconds -lt $MemMapEverySec)) {
+        return
+    }
+    $serial.Write([byte[]]@($MemMapRequest), 0, 1)
+    $script:MemMapTimer = [System.Diagnostics.Stopwatch]::StartNew()
+}
+
+$script:PreviewKeySent = $false
+
+# Function to ask for one whole thumbnail, once
+function Send-PreviewKeyRequest {
+    if ($PreviewFile -eq "" -or $script:PreviewKeySent) {
+        return
+    }
+    $serial.Write([byte[]]@($PreviewKeyRequest), 0, 1)
+    $script:PreviewKeySent = $true
+}
+
+$script:ScreenshotSent = $false
+
+# Function to ask for one screenshot, once
+function Send-ScreenshotRequest {
+    if (-not $Screenshot -or $script:ScreenshotSent) {
+        return
+    }
+    $serial.Write([byte[]]@($ScreenshotRequest), 0, 1)
+    $script:ScreenshotSent = $true
+}
+
+$script:TraceXSent = $false
+
+# Function to ask for one TraceX buffer, once
+function Send-TraceXRequest {
+    if ($TraceX -eq "" -or $script:TraceXSent) {
+        return
+    }
+    $serial.Write([byte[]]@($TraceXRequest), 0, 1)
+    $script:TraceXSent = $true
+}
+
+$script:ShellSent = $false
+$script:ShellLine = ""
+
+# Function to send one line to the shell
+function Send-ShellLine {
+    param([string]$Line)
+    if ($Line.Length -gt $ShellLineMax) {
+        Write-Host "telemetry: shell line longer than $ShellLineMax characters" -ForegroundColor Yellow
+        return
+    }
+    $bytes = [byte[]](@($ShellByte) + [System.Text.Encoding]::ASCII.GetBytes($Line) + @([byte]10))
+    $serial.Write($bytes, 0, $bytes.Length)
+}
+
+# Function to send the shell commands once, then the lines typed
+function Send-Shell {
+    if (-not $script:ShellSent) {
+        $script:ShellSent = $true
+        foreach ($line in $ShellCommands) {
+            Send-ShellLine $line
+        }
+    }
+    if (-not $Shell) {
+        return
+    }
+    while ([Console]::KeyAvailable) {
+        $key = [Console]::ReadKey($true)
+        if ($key.Key -eq [ConsoleKey]::Enter) {
+            Write-Host "> $($script:ShellLine)" -ForegroundColor Cyan
+            if ($script:ShellLine -ne "") {
+                Send-ShellLine $script:ShellLine
+            }
+            $script:ShellLine = ""
+        } elseif ($key.Key -eq [ConsoleKey]::Backspace) {
+            if ($script:ShellLine.Length -gt 0) {
+                $script:ShellLine = $script:ShellLine.Substring(0, $script:ShellLine.Length - 1)
+            }
+        } elseif ($key.KeyChar -ge ' ' -and $key.KeyChar -le '~') {
+            $script:ShellLine += $key.KeyChar
+        }
+    }
+}
+
+$script:ParamsSent = $false
+
+# Function to send the parameter commands, once
+function Send-ParamRequests {
+    if ($script:ParamsSent) {
+        return
+    }
+    $script:ParamsSent = $true
+    if ($DefaultParams) {
+        # Taken on the next UI wake: the sets must come after it
+        $serial.Write([byte[]]@($ParamsDefaultsRequest), 0, 1)
+        Start-Sleep -Milliseconds 500
+    }
+    $bytes = New-Object System.Collections.Generic.List[byte]
+    foreach ($name in $SetParams.Keys) {
+        if (-not $script:ParamIds.ContainsKey($name)) {
+            Write-Host "telemetry: unknown parameter $name" -ForegroundColor Yellow
+            continue
+        }
+        if ($name -eq "power.profile" -and $SetParams[$name] -is [string]) {
+            $SetParams[$name] = [Array]::IndexOf($ProfileNames, $SetParams[$name])
+            if ($SetParams[$name] -lt 0) {
+                Write-Host "telemetry: unknown profile, one of $($ProfileNames -join ', ')" -ForegroundColor Yellow
+                continue
+            }
+        }
+        $value = if ($script:ParamTypes[$name] -eq "FLOAT") { [BitConverter]::GetBytes([single]$SetParams[$name]) } else { [BitConverter]::GetBytes([int32]$SetParams[$name]) }
+        $command = [byte[]](@([byte]$script:ParamIds[$name]) + $value)
+        $check = 0xFF
+        foreach ($b in $command) {
+            $check = ($check - $b) -band 0xFF
+        }
+        $bytes.Add($ParamsSetByte)
+        $bytes.AddRange($command)
+        $bytes.Add([byte]$check)
+    }
+    if ($StoreParams) {
+        $bytes.Add($ParamsStoreRequest)
+    }
+    if ($DefaultParams -or $bytes.Count -gt 0 -or $ShowParams) {
+        $bytes.Add($ParamsGetRequest)
+    }
+    if ($bytes.Count -gt 0) {
+        $serial.Write($bytes.ToArray(), 0, $bytes.Count)
+    }
+}
+
+if ($UsbCdc) {
+    # Sending starts at DTR on a packet boundary, so on a record boundary
+    $serial.DtrEnable = $true
+    $serial.Open()
+    Write-Host "Reading telemetry on USB port $Port (Ctrl+C to stop)" -ForegroundColor Cyan
+
+    try {
+        $record = New-Object byte[] $RecordSize
+        $fill = 0
+        $buffer = New-Object byte[] 4096
+
+        while ($true) {
+            Send-PcRequest
+            Send-ParamRequests
+            Send-MemMapRequest
+            Send-PreviewKeyRequest
+            Send-ScreenshotRequest
+            Send-TraceXRequest
+            Send-Shell
+            try {
+                $n = $serial.Read($buffer, 0, $buffer.Length)
+            } catch [System.TimeoutException] {
+                continue
+            }
+            for ($i = 0; $i -lt $n; $i++) {
+                $record[$fill++] = $buffer[$i]
+                if ($fill -eq $RecordSize) {
+                    $len = [Math]::Min($HeaderSize + $record[1], $RecordSize)
+                    Show-Record $record[0..($len - 1)]
+                    $fill = 0
+                }
+            }
+        }
+    } finally {
+        $serial.Close()
+        Save-Trace
+        Save-PcProfile
+    }
+    return
+}
+
+$serial.Open()
+Write-Host "Reading telemetry on $Port at $BaudRate baud (Ctrl+C to stop)" -ForegroundColor Cyan
+
+try {
+    $frame = New-Object System.Collections.Generic.List[byte]
+    $buffer = New-Object byte[] 4096
+
+    while ($true) {
+        Send-PcRequest
+        Send-ParamRequests
+        Send-MemMapRequest
+        Send-PreviewKeyRequest
+        Send-ScreenshotRequest
+        Send-TraceXRequest
+        Send-Shell
+        try {
+            $n = $serial.Read($buffer, 0, $buffer.Length)
+        } catch [System.TimeoutException] {
+            continue
+        }
+        for ($i = 0; $i -lt $n; $i++) {
+            if ($buffer[$i] -ne 0) {
+                $frame.Add($buffer[$i])
+                continue
+            }
+            # Delimiter: a frame is complete (a partial first one is skipped)
+            if ($frame.Count -gt 0) {
+                $record = ConvertFrom-Cobs $frame.ToArray()
+                if ($null -ne $record) {
+                    Show-Record $record
+                }
+                $frame.Clear()
+            }
+        }
+    }
+} finally {
+    $serial.Close()
+    Save-Trace
+    Save-PcProfile
+}